@@ -3,6 +3,7 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "DebugTimeManager.h"
+#include "logtracer.h"
 #include <QDateTime>
 #include <QDebug>
 #include <QLoggingCategory>
@@ -37,6 +38,7 @@ void DebugTimeManager::beginPointLinux(const QString &point, const QString &stat
         return;
     }
     info.time = beginTime;
+    info.allocs = LogAllocCounter::process();
     m_MapLinuxPoint.insert(point, info);
 
 }
@@ -50,7 +52,21 @@ void DebugTimeManager::endPointLinux(const QString &point, const QString &status
             return;
         }
         timespec diffTime =  diff(m_MapLinuxPoint[point].time, endTime);
+        //开启追踪时同时记录为一段耗时,打点可能跨函数,不要求在同一作用域
+        if (LogTracer::isEnabled()) {
+            const timespec &beginTime = m_MapLinuxPoint[point].time;
+            qint64 begin = static_cast<qint64>(beginTime.tv_sec) * 1000000 + beginTime.tv_nsec / 1000;
+            qint64 end = static_cast<qint64>(endTime.tv_sec) * 1000000 + endTime.tv_nsec / 1000;
+            LogTracer::instance()->record("point", point, begin, end, QString("%1 %2").arg(m_MapLinuxPoint[point].desc).arg(status).trimmed());
+        }
         qCInfo(logDebugTime) << QString("[GRABPOINT] %1 %2 %3 time=%4s").arg(point).arg(m_MapLinuxPoint[point].desc).arg(status).arg(QString::number((diffTime.tv_sec * 1000 + (diffTime.tv_nsec) / 1000000) / 1000.0, 'g', 4));
+        //打点可能跨线程,这里是整个进程的分配;各线程热点的每行分配数见作用域汇总
+        if (LogAllocCounter::isEnabled()) {
+            const LogAllocStats endAllocs = LogAllocCounter::process();
+            const LogAllocStats &beginAllocs = m_MapLinuxPoint[point].allocs;
+            qCInfo(logDebugTime).noquote() << QString("[GRABPOINT] %1 allocs=%2 bytes=%3").arg(point).arg(endAllocs.allocs - beginAllocs.allocs).arg(endAllocs.bytes - beginAllocs.bytes);
+            LogAllocCounter::dump();
+        }
         m_MapLinuxPoint.remove(point);
     }
 }
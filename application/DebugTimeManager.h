@@ -9,6 +9,7 @@
 #include <QMap>
 #include <QString>
 #include "config.h"
+#include "logalloccounter.h"
 #define PERF_ON
 #ifdef PERF_ON
 #define PERF_PRINT_BEGIN(point, dsec) DebugTimeManager::getInstance()->beginPointLinux(point,dsec)
@@ -27,8 +28,14 @@ struct PointInfo {
 struct PointInfoLinux {
     QString desc;
     timespec  time;
+    //打点开始时整个进程的分配计数,分配计数插桩构建中有效
+    LogAllocStats allocs;
 };
 
+/**
+ * @brief The DebugTimeManager class 性能打点,结束时输出耗时日志;开启LogTracer时同时写入trace,
+ * 分配计数插桩构建中同时输出打点期间的分配次数和各PERF_ALLOC_SCOPE的汇总
+ */
 class DebugTimeManager
 {
 public:
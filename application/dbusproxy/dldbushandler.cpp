@@ -3,7 +3,17 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "dldbushandler.h"
+#include "logtracer.h"
+#include "logingestmetrics.h"
+#include "logdbusstats.h"
+#include "logcanceltoken.h"
+#include "logbytesanitizer.h"
 #include <QDebug>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFile>
+#include <QUuid>
+#include <QVector>
 #include <QStandardPaths>
 #include <QLoggingCategory>
 
@@ -15,14 +25,64 @@ Q_LOGGING_CATEGORY(logDBusHandler, "org.deepin.log.viewer.dbus.handler", QtInfoM
 
 DLDBusHandler *DLDBusHandler::m_statichandeler = nullptr;
 
+namespace {
+//当前线程的加载已被取消,不再发起新的调用
+bool loadCancelled()
+{
+    return LogCancelToken::current().isCancelled();
+}
+
+//回复经过总线的大小,字符串按UTF-8传输,这里按字符数估计
+qint64 payloadOf(const QString &data)
+{
+    return data.size();
+}
+
+qint64 payloadOf(const QStringList &list)
+{
+    qint64 bytes = 0;
+    for (const QString &item : list)
+        bytes += item.size();
+    return bytes;
+}
+}
+
 DLDBusHandler *DLDBusHandler::instance(QObject *parent)
 {
     if (parent != nullptr && m_statichandeler == nullptr) {
-        m_statichandeler = new DLDBusHandler(parent);
+        //多个加载线程可能同时第一次调用
+        static QMutex mutex;
+        QMutexLocker locker(&mutex);
+        if (m_statichandeler == nullptr)
+            m_statichandeler = new DLDBusHandler(parent);
     }
     return m_statichandeler;
 }
 
+/*!
+ * \~chinese \brief DLDBusHandler::warmUp 启动时建立到服务的连接,并异步ping一次服务,让总线提前激活服务进程,
+ * \~chinese 第一次读取需要提权的日志(内核、审计日志等)时不再等待服务启动;不等待结果
+ * \~chinese \param parent 单例的父对象
+ */
+void DLDBusHandler::warmUp(QObject *parent)
+{
+    DLDBusHandler *handler = instance(parent);
+    if (handler == nullptr)
+        return;
+    QDBusMessage ping = QDBusMessage::createMethodCall(handler->m_dbus->service(), handler->m_dbus->path(),
+                                                       "org.freedesktop.DBus.Peer", "Ping");
+    QElapsedTimer timer;
+    timer.start();
+    QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(handler->m_dbus->connection().asyncCall(ping), handler);
+    connect(watcher, &QDBusPendingCallWatcher::finished, handler, [timer](QDBusPendingCallWatcher *call) {
+        if (call->isError())
+            qCWarning(logDBusHandler) << "warm up com.deepin.logviewer failed:" << call->error().message();
+        else
+            qCInfo(logDBusHandler) << "com.deepin.logviewer ready in" << timer.elapsed() << "ms";
+        call->deleteLater();
+    });
+}
+
 DLDBusHandler::~DLDBusHandler()
 {
     quit();
@@ -31,6 +91,9 @@ DLDBusHandler::~DLDBusHandler()
 DLDBusHandler::DLDBusHandler(QObject *parent)
     : QObject(parent)
 {
+    qDBusRegisterMetaType<LogRecordBatch>();
+    qDBusRegisterMetaType<LogFileStat>();
+    qDBusRegisterMetaType<QList<LogFileStat>>();
     m_dbus = new DeepinLogviewerInterface("com.deepin.logviewer",
                                           "/com/deepin/logviewer",
                                           QDBusConnection::systemBus(),
@@ -49,17 +112,329 @@ DLDBusHandler::DLDBusHandler(QObject *parent)
  */
 QString DLDBusHandler::readLog(const QString &filePath)
 {
-    return m_dbus->readLog(filePath);
+    PERF_TRACE_SCOPE("dbus", "readLog");
+    const LogCancelToken cancel = LogCancelToken::current();
+    if (cancel.isCancelled())
+        return QString();
+    //通过描述符读取时包括本进程中读取文件的时间,回复大小为读到的字节数
+    PERF_DBUS_CALL(call, "readLog", filePath);
+    //普通文件优先通过服务打开的描述符在本进程读取,内容不经过总线
+    if (filePath.startsWith("/")) {
+        QDBusUnixFileDescriptor descriptor = openLogFile(filePath);
+        QFile file;
+        if (descriptor.isValid() && file.open(descriptor.fileDescriptor(), QIODevice::ReadOnly)) {
+            //分块读取,加载被取消时不用读完整个文件
+            QByteArray byte;
+            if (!cancel.readAll(&file, byte))
+                return QString();
+            //和服务端一致,0x00替换为空格,避免转换QString时被截断
+            LogByteSanitizer::sanitize(byte, LogByteSanitizer::ReplaceNul);
+            call.setPayload(byte.size());
+            return QString::fromUtf8(byte);
+        }
+    }
+    LogIngestDBusScope ingest;
+    //不能传递描述符时内容经过总线,优先使用压缩传输
+    if (m_compressedTransfer.load(std::memory_order_relaxed)) {
+        QDBusPendingReply<QByteArray> compressed = m_dbus->readLogCompressed(filePath);
+        if (!cancel.waitForReply(compressed))
+            return QString();
+        if (!compressed.isError()) {
+            const QByteArray bytes = compressed.value();
+            call.setPayload(bytes.size());
+            return decodeTransfer(bytes);
+        }
+        if (keepCompressedTransfer(compressed.error()))
+            return QString();
+    }
+    QDBusPendingReply<QString> reply = m_dbus->readLog(filePath);
+    if (!cancel.waitForReply(reply))
+        return QString();
+    const QString data = reply.value();
+    call.setPayload(payloadOf(data));
+    return data;
 }
 
 QString DLDBusHandler::openLogStream(const QString &filePath)
 {
-    return m_dbus->openLogStream(filePath);
+    if (loadCancelled())
+        return QString();
+    LogIngestDBusScope ingest;
+    PERF_DBUS_CALL(call, "openLogStream", filePath);
+    QDBusPendingReply<QString> reply = m_dbus->openLogStream(filePath);
+    if (!LogCancelToken::current().waitForReply(reply))
+        return QString();
+    return registerStream(reply.value());
+}
+
+QString DLDBusHandler::readLogInStream(const QString &handle)
+{
+    PERF_TRACE_SCOPE("dbus", "readLogInStream");
+    if (loadCancelled())
+        return QString();
+    const QString token = serviceToken(handle);
+    if (token.isEmpty())
+        return QString();
+    LogIngestDBusScope ingest;
+    //预先请求的下一块已经到达时只有取回的耗时
+    PERF_DBUS_CALL(call, "readLogInStream", token);
+    if (m_compressedTransfer.load(std::memory_order_relaxed)) {
+        QDBusPendingReply<QByteArray> compressed;
+        {
+            QMutexLocker locker(&m_aheadMutex);
+            compressed = m_compressedAhead.contains(handle) ? m_compressedAhead.take(handle) : m_dbus->readLogInStreamCompressed(token);
+        }
+        if (!LogCancelToken::current().waitForReply(compressed))
+            return QString();
+        if (!compressed.isError()) {
+            const QByteArray bytes = compressed.value();
+            call.setPayload(bytes.size());
+            //下一块在服务端读取和压缩时,本线程解压当前一块
+            if (!bytes.isEmpty()) {
+                QMutexLocker locker(&m_aheadMutex);
+                //通道已被关闭时不再预取
+                if (m_streamTokens.contains(handle))
+                    m_compressedAhead.insert(handle, m_dbus->readLogInStreamCompressed(token));
+            } else {
+                releaseStream(handle);
+            }
+            return decodeTransfer(bytes);
+        }
+        //和未压缩的调用一样,其他错误按读取结束处理,这一块可能已从通道中取走
+        if (keepCompressedTransfer(compressed.error()))
+            return QString();
+    }
+    QDBusPendingReply<QString> reply;
+    {
+        QMutexLocker locker(&m_aheadMutex);
+        reply = m_streamAhead.contains(handle) ? m_streamAhead.take(handle) : m_dbus->readLogInStream(token);
+    }
+    if (!LogCancelToken::current().waitForReply(reply))
+        return QString();
+    const QString data = reply.value();
+    call.setPayload(payloadOf(data));
+    //读取结束之前先请求下一块,服务端的读取和调用者的处理重叠;结束时的空回复也由这次请求取回
+    if (!data.isEmpty()) {
+        QMutexLocker locker(&m_aheadMutex);
+        //通道已被关闭时不再预取
+        if (m_streamTokens.contains(handle))
+            m_streamAhead.insert(handle, m_dbus->readLogInStream(token));
+    } else if (!reply.isError()) {
+        releaseStream(handle);
+    }
+    return data;
+}
+
+/*!
+ * \~chinese \brief DLDBusHandler::decodeTransfer 解压服务压缩传输的UTF-8数据,在调用者所在的加载线程中进行
+ * \~chinese \param data qCompress格式的数据,为空时表示读取结束
+ * \~chinese \return 日志内容,数据损坏时为空
+ */
+QString DLDBusHandler::decodeTransfer(const QByteArray &data)
+{
+    if (data.isEmpty())
+        return QString();
+    const QByteArray bytes = qUncompress(data);
+    if (bytes.isEmpty())
+        qCWarning(logDBusHandler) << "uncompress transfer data failed, size:" << data.size();
+    return QString::fromUtf8(bytes);
+}
+
+/*!
+ * \~chinese \brief DLDBusHandler::keepCompressedTransfer 压缩传输的调用失败后是否继续使用压缩传输
+ * \~chinese 旧版服务没有压缩接口时之后都使用未压缩的接口,本次调用由调用者改用未压缩的接口重试
+ * \~chinese \param error 调用的错误
+ * \~chinese \return true表示是其他错误,调用者按失败处理,不再重试
+ */
+bool DLDBusHandler::keepCompressedTransfer(const QDBusError &error)
+{
+    if (error.type() != QDBusError::UnknownMethod) {
+        qCWarning(logDBusHandler) << "call dbus iterface compressed transfer failed. error info:" << error.message();
+        return true;
+    }
+    if (m_compressedTransfer.exchange(false))
+        qCInfo(logDBusHandler) << "com.deepin.logviewer does not support compressed transfer, use plain text";
+    return false;
+}
+
+/*!
+ * \~chinese \brief DLDBusHandler::openReverseLogStream 打开从文件末尾向前读取的流式通道,通过readLogInStream逐块读取
+ * \~chinese \param filePath 文件路径
+ * \~chinese \return 通道句柄，返回空时表示文件路径无效
+ */
+QString DLDBusHandler::openReverseLogStream(const QString &filePath)
+{
+    if (loadCancelled())
+        return QString();
+    LogIngestDBusScope ingest;
+    PERF_DBUS_CALL(call, "openReverseLogStream", filePath);
+    QDBusPendingReply<QString> reply = m_dbus->openReverseLogStream(filePath);
+    if (!LogCancelToken::current().waitForReply(reply))
+        return QString();
+    return registerStream(reply.value());
+}
+
+/*!
+ * \~chinese \brief DLDBusHandler::openFilteredLogStream 打开带筛选条件的倒序通道,服务端只返回匹配的行
+ * \~chinese \param filePath 文件路径
+ * \~chinese \param filter 筛选条件,见LogLineFilter::toVariantMap
+ * \~chinese \return 通道句柄，服务不支持该接口或文件路径无效时为空
+ */
+QString DLDBusHandler::openFilteredLogStream(const QString &filePath, const QVariantMap &filter)
+{
+    if (loadCancelled())
+        return QString();
+    LogIngestDBusScope ingest;
+    PERF_DBUS_CALL(call, "openFilteredLogStream", filePath);
+    QDBusPendingReply<QString> reply = m_dbus->openFilteredLogStream(filePath, filter);
+    if (!LogCancelToken::current().waitForReply(reply))
+        return QString();
+    if (reply.isError()) {
+        qCDebug(logDBusHandler) << "call dbus iterface 'openFilteredLogStream()' failed. error info:" << reply.error().message();
+        return QString();
+    }
+    return registerStream(reply.value());
+}
+
+/*!
+ * \~chinese \brief DLDBusHandler::openRecordStream 打开在服务端解析成定长列的记录通道
+ * \~chinese \param filePath 文件路径
+ * \~chinese \param format 记录格式,见LogRecordBatch::Format
+ * \~chinese \param filter 筛选条件,见LogLineFilter::toVariantMap
+ * \~chinese \return 通道句柄，服务不支持该接口、格式或文件路径无效时为空
+ */
+QString DLDBusHandler::openRecordStream(const QString &filePath, int format, const QVariantMap &filter)
+{
+    PERF_TRACE_SCOPE("dbus", "openRecordStream");
+    if (loadCancelled())
+        return QString();
+    LogIngestDBusScope ingest;
+    PERF_DBUS_CALL(call, "openRecordStream", filePath);
+    QDBusPendingReply<QString> reply = m_dbus->openRecordStream(filePath, format, filter);
+    if (!LogCancelToken::current().waitForReply(reply))
+        return QString();
+    if (reply.isError()) {
+        qCDebug(logDBusHandler) << "call dbus iterface 'openRecordStream()' failed. error info:" << reply.error().message();
+        return QString();
+    }
+    return registerStream(reply.value());
+}
+
+/*!
+ * \~chinese \brief DLDBusHandler::readRecordBatch 从记录通道读取下一批记录
+ * \~chinese \param handle 通道句柄
+ * \~chinese \return 一批记录，为空时表示读取结束，调用失败时isValid()为false
+ */
+LogRecordBatch DLDBusHandler::readRecordBatch(const QString &handle)
+{
+    PERF_TRACE_SCOPE("dbus", "readRecordBatch");
+    //被取消时和调用失败一样返回无效的批次
+    LogRecordBatch invalid;
+    invalid.version = 0;
+    if (loadCancelled())
+        return invalid;
+    const QString token = serviceToken(handle);
+    if (token.isEmpty())
+        return invalid;
+    LogIngestDBusScope ingest;
+    PERF_DBUS_CALL(call, "readRecordBatch", token);
+    QDBusPendingReply<LogRecordBatch> reply;
+    {
+        QMutexLocker locker(&m_aheadMutex);
+        reply = m_batchAhead.contains(handle) ? m_batchAhead.take(handle) : m_dbus->readRecordBatch(token);
+    }
+    if (!LogCancelToken::current().waitForReply(reply))
+        return invalid;
+    if (reply.isError()) {
+        qCWarning(logDBusHandler) << "call dbus iterface 'readRecordBatch()' failed. error info:" << reply.error().message();
+        return invalid;
+    }
+    const LogRecordBatch batch = reply.value();
+    call.setPayload(batch.blob.size() + batch.size() * qint64(sizeof(qint64) + sizeof(qint32)) + batch.offsets.size() * qint64(sizeof(qint32)));
+    //和readLogInStream一样预先请求下一批
+    if (batch.isValid() && batch.size() > 0) {
+        QMutexLocker locker(&m_aheadMutex);
+        //通道已被关闭时不再预取
+        if (m_streamTokens.contains(handle))
+            m_batchAhead.insert(handle, m_dbus->readRecordBatch(token));
+    } else if (batch.isValid()) {
+        releaseStream(handle);
+    }
+    return batch;
 }
 
-QString DLDBusHandler::readLogInStream(const QString &token)
+/*!
+ * \~chinese \brief DLDBusHandler::closeLogStream 没有读完就不再读取时关闭服务端的通道,释放服务端缓存的数据
+ * \~chinese 不等待结果,旧版服务没有该接口时由服务端的空闲超时回收;已经读完的通道服务端已释放,不再调用
+ * \~chinese \param handle open*返回的通道句柄
+ */
+void DLDBusHandler::closeLogStream(const QString &handle)
+{
+    const QString token = releaseStream(handle);
+    if (!token.isEmpty())
+        m_dbus->closeLogStream(token);
+}
+
+/*!
+ * \~chinese \brief DLDBusHandler::registerStream 为服务返回的通道生成本进程内唯一的句柄
+ * \~chinese 预先请求的下一块按句柄保存,旧版服务对同一文件返回相同的token时,各读取者的预取也不会互相取走
+ * \~chinese \param token 服务返回的通道token
+ * \~chinese \return 通道句柄,token为空时为空
+ */
+QString DLDBusHandler::registerStream(const QString &token)
 {
-    return m_dbus->readLogInStream(token);
+    if (token.isEmpty())
+        return QString();
+    const QString handle = QUuid::createUuid().toString();
+    QMutexLocker locker(&m_aheadMutex);
+    m_streamTokens.insert(handle, token);
+    return handle;
+}
+
+/*!
+ * \~chinese \brief DLDBusHandler::serviceToken 句柄对应的服务端通道token,已关闭或读完时为空
+ */
+QString DLDBusHandler::serviceToken(const QString &handle)
+{
+    QMutexLocker locker(&m_aheadMutex);
+    return m_streamTokens.value(handle);
+}
+
+/*!
+ * \~chinese \brief DLDBusHandler::releaseStream 删除句柄和它预先请求的下一块,回复到达后丢弃
+ * \~chinese \return 句柄对应的服务端通道token,句柄已释放时为空
+ */
+QString DLDBusHandler::releaseStream(const QString &handle)
+{
+    QMutexLocker locker(&m_aheadMutex);
+    m_streamAhead.remove(handle);
+    m_batchAhead.remove(handle);
+    m_compressedAhead.remove(handle);
+    return m_streamTokens.take(handle);
+}
+
+/*!
+ * \~chinese \brief DLDBusHandler::openLogFile 通过服务以root权限打开日志文件,取得只读的文件描述符
+ * \~chinese \param filePath 文件路径
+ * \~chinese \return 文件描述符，总线不支持传递描述符、服务不支持该接口或文件路径无效时为无效描述符
+ */
+QDBusUnixFileDescriptor DLDBusHandler::openLogFile(const QString &filePath)
+{
+    LogIngestDBusScope ingest;
+    PERF_DBUS_CALL(call, "openLogFile", filePath);
+    if (!m_dbus->connection().connectionCapabilities().testFlag(QDBusConnection::UnixFileDescriptorPassing))
+        return QDBusUnixFileDescriptor();
+
+    if (loadCancelled())
+        return QDBusUnixFileDescriptor();
+    QDBusPendingReply<QDBusUnixFileDescriptor> reply = m_dbus->openLogFile(filePath);
+    if (!LogCancelToken::current().waitForReply(reply))
+        return QDBusUnixFileDescriptor();
+    if (reply.isError()) {
+        qCDebug(logDBusHandler) << "call dbus iterface 'openLogFile()' failed. error info:" << reply.error().message();
+        return QDBusUnixFileDescriptor();
+    }
+    return reply.value();
 }
 
 /*!
@@ -81,41 +456,251 @@ void DLDBusHandler::quit()
 
 QStringList DLDBusHandler::getFileInfo(const QString &flag, bool unzip)
 {
+    PERF_TRACE_SCOPE("dbus", "getFileInfo");
+    LogIngestDBusScope ingest;
+    PERF_DBUS_CALL(call, "getFileInfo", flag);
     QDBusPendingReply<QStringList> reply = m_dbus->getFileInfo(flag, unzip);
-    reply.waitForFinished();
+    if (!LogCancelToken::current().waitForReply(reply))
+        return QStringList();
     if (reply.isError()) {
         qCWarning(logDBusHandler) << "call dbus iterface 'getFileInfo()' failed. error info:" << reply.error().message();
-    } else {
-        filePath = reply.value();
+        return QStringList();
     }
-    return filePath;
+    const QStringList files = reply.value();
+    call.setPayload(payloadOf(files));
+    return files;
 }
 
 QStringList DLDBusHandler::getOtherFileInfo(const QString &flag, bool unzip)
 {
+    PERF_TRACE_SCOPE("dbus", "getOtherFileInfo");
+    LogIngestDBusScope ingest;
+    PERF_DBUS_CALL(call, "getOtherFileInfo", flag);
     QDBusPendingReply<QStringList> reply = m_dbus->getOtherFileInfo(flag, unzip);
-    reply.waitForFinished();
+    if (!LogCancelToken::current().waitForReply(reply))
+        return QStringList();
     QStringList filePathList;
     if (reply.isError()) {
         qCWarning(logDBusHandler) << "call dbus iterface 'getOtherFileInfo()' failed. error info:" << reply.error().message();
     } else {
         filePathList = reply.value();
     }
+    call.setPayload(payloadOf(filePathList));
     return filePathList;
 }
 
 
 bool DLDBusHandler::exportLog(const QString &outDir, const QString &in, bool isFile)
 {
+    PERF_DBUS_CALL(call, "exportLog", in);
     return m_dbus->exportLog(outDir, in, isFile);
 }
 
+/*!
+ * \~chinese \brief DLDBusHandler::exportJournalSince 增量导出journal,只导出cursor之后的记录
+ * \~chinese 旧版服务没有该接口时用exportLog全部导出,返回空,调用者不更新水位
+ * \~chinese \param outDir 导出目录
+ * \~chinese \param in journal的导出命令名
+ * \~chinese \param cursor 上次导出的最后一条记录的cursor
+ * \~chinese \return 本次导出的最后一条记录的cursor,失败时为空
+ */
+QString DLDBusHandler::exportJournalSince(const QString &outDir, const QString &in, const QString &cursor)
+{
+    PERF_TRACE_SCOPE("dbus", "exportJournalSince");
+    PERF_DBUS_CALL(call, "exportJournalSince", in);
+    QDBusPendingReply<QString> reply = m_dbus->exportJournalSince(outDir, in, cursor);
+    reply.waitForFinished();
+    if (reply.isError()) {
+        qCWarning(logDBusHandler) << "call dbus iterface 'exportJournalSince()' failed, export all. error info:" << reply.error().message();
+        exportLog(outDir, in, false);
+        return QString();
+    }
+    return reply.value();
+}
+
+/*!
+ * \~chinese \brief DLDBusHandler::exportJournal 按时间范围、等级和输出格式导出journal,只读取和写入要求的范围
+ * \~chinese 旧版服务没有该接口时用exportLog全部导出
+ * \~chinese \param outDir 导出目录
+ * \~chinese \param in journal的导出命令名
+ * \~chinese \param options 导出参数,见LogViewerService::exportJournal
+ * \~chinese \return 是否导出成功
+ */
+bool DLDBusHandler::exportJournal(const QString &outDir, const QString &in, const QVariantMap &options)
+{
+    PERF_TRACE_SCOPE("dbus", "exportJournal");
+    PERF_DBUS_CALL(call, "exportJournal", in);
+    QDBusPendingReply<bool> reply = m_dbus->exportJournal(outDir, in, options);
+    reply.waitForFinished();
+    if (reply.isError()) {
+        qCWarning(logDBusHandler) << "call dbus iterface 'exportJournal()' failed, export all. error info:" << reply.error().message();
+        return exportLog(outDir, in, false);
+    }
+    return reply.value();
+}
+
+/*!
+ * \~chinese \brief DLDBusHandler::exportLogFiles 批量导出文件,服务在进程内复制,不再为每个文件启动shell
+ * \~chinese 每EXPORT_LOG_FILES_BATCH个文件调用一次服务,等待时在调用者线程中处理服务的进度信号,
+ * \~chinese 回复之后补上没有收到信号的文件,progress对每个文件只调用一次且都在调用者线程中;旧版服务没有该接口时逐个调用exportLog
+ * \~chinese \param outDir 导出目录
+ * \~chinese \param files 要导出的文件路径
+ * \~chinese \param progress 每个文件导出完成的回调
+ * \~chinese \return 导出成功的文件数
+ */
+int DLDBusHandler::exportLogFiles(const QString &outDir, const QStringList &files, const ExportProgress &progress)
+{
+    PERF_TRACE_SCOPE("dbus", "exportLogFiles");
+    int succeeded = 0;
+    bool proceed = true;
+    for (int begin = 0; begin < files.size() && proceed; begin += EXPORT_LOG_FILES_BATCH) {
+        const QStringList batch = files.mid(begin, EXPORT_LOG_FILES_BATCH);
+        const QString jobId = QUuid::createUuid().toString();
+        QVector<bool> reported(batch.size(), false);
+        auto report = [&](int index, bool success) {
+            if (index < 0 || index >= batch.size() || reported.at(index))
+                return;
+            reported[index] = true;
+            if (success)
+                ++succeeded;
+            if (progress && !progress(begin + index, success))
+                proceed = false;
+        };
+
+        //receiver在调用者线程中,信号排队到本线程的事件循环处理
+        QObject receiver;
+        connect(m_dbus, &DeepinLogviewerInterface::exportProgress, &receiver, [&](const QString &id, int index, bool success) {
+            if (id == jobId)
+                report(index, success);
+        });
+        PERF_DBUS_CALL(call, "exportLogFiles", outDir);
+        QEventLoop loop;
+        QDBusPendingCallWatcher watcher(m_dbus->exportLogFiles(outDir, batch, jobId));
+        connect(&watcher, &QDBusPendingCallWatcher::finished, &loop, &QEventLoop::quit);
+        if (!watcher.isFinished())
+            loop.exec();
+
+        QDBusPendingReply<QList<bool>> reply = watcher;
+        if (reply.isError()) {
+            qCWarning(logDBusHandler) << "call dbus iterface 'exportLogFiles()' failed, export one by one. error info:" << reply.error().message();
+            for (int i = 0; i < batch.size() && proceed; ++i)
+                report(i, exportLog(outDir, batch.at(i), true));
+        } else {
+            const QList<bool> results = reply.value();
+            for (int i = 0; i < batch.size() && proceed; ++i)
+                report(i, i < results.size() && results.at(i));
+        }
+    }
+    return succeeded;
+}
+
+/*!
+ * \~chinese \brief DLDBusHandler::hashExportFiles 计算一组待导出文件的内容摘要
+ * \~chinese 当前用户能读取的文件在本进程计算,其余的一次交给服务;旧版服务没有该接口时这些文件的摘要为空
+ * \~chinese \param stats statFiles得到的文件元数据
+ * \~chinese \return 和stats顺序一致的十六进制摘要,无法计算时为空
+ */
+QStringList DLDBusHandler::hashExportFiles(const QList<LogFileStat> &stats)
+{
+    PERF_TRACE_SCOPE("dbus", "hashExportFiles");
+    const LogCancelToken token = LogCancelToken::current();
+    QStringList hashes;
+    QStringList remotePaths;
+    for (const LogFileStat &stat : stats) {
+        hashes.append(stat.readable && !token.isCancelled() ? LogFileStat::contentHash(stat.path) : QString());
+        if (!stat.readable)
+            remotePaths.append(stat.path);
+    }
+    if (remotePaths.isEmpty() || token.isCancelled())
+        return hashes;
+
+    QDBusPendingReply<QStringList> reply;
+    {
+        PERF_DBUS_CALL(call, "hashExportFiles", remotePaths.first());
+        reply = m_dbus->hashExportFiles(remotePaths);
+        if (!token.waitForReply(reply))
+            return hashes;
+    }
+    if (reply.isError()) {
+        qCWarning(logDBusHandler) << "call dbus iterface 'hashExportFiles()' failed, export without deduplication. error info:" << reply.error().message();
+        return hashes;
+    }
+
+    const QStringList remoteHashes = reply.value();
+    int next = 0;
+    for (int i = 0; i < stats.size(); ++i) {
+        if (!stats.at(i).readable)
+            hashes[i] = remoteHashes.value(next++);
+    }
+    return hashes;
+}
+
 bool DLDBusHandler::isFileExist(const QString &filePath)
 {
+    LogIngestDBusScope ingest;
+    PERF_DBUS_CALL(call, "isFileExist", filePath);
     return m_dbus->isFileExist(filePath);
 }
 
 quint64 DLDBusHandler::getFileSize(const QString &filePath)
 {
+    LogIngestDBusScope ingest;
+    PERF_DBUS_CALL(call, "getFileSize", filePath);
     return m_dbus->getFileSize(filePath);
 }
+
+/*!
+ * \~chinese \brief DLDBusHandler::statFiles 一次总线往返取得一组文件的元数据
+ * \~chinese 当前用户可以访问的文件直接在本进程读取,都可以访问时不调用服务;readable总是在本进程判断
+ * \~chinese 旧版服务没有该接口时逐个调用isFileExist/getFileSize
+ * \~chinese \param paths 文件或目录的绝对路径
+ * \~chinese \return 和paths顺序一致的元数据
+ */
+QList<LogFileStat> DLDBusHandler::statFiles(const QStringList &paths)
+{
+    PERF_TRACE_SCOPE("dbus", "statFiles");
+    LogIngestDBusScope ingest;
+    QList<LogFileStat> stats;
+    QStringList remotePaths;
+    for (const QString &path : paths) {
+        stats.append(LogFileStat::fromPath(path));
+        //不存在可能只是当前用户没有目录的访问权限,交给服务判断
+        if (!stats.last().exists)
+            remotePaths.append(path);
+    }
+    if (remotePaths.isEmpty())
+        return stats;
+
+    QList<LogFileStat> remoteStats;
+    QDBusPendingReply<QList<LogFileStat>> reply;
+    {
+        PERF_DBUS_CALL(call, "statFiles", remotePaths.first());
+        reply = m_dbus->statFiles(remotePaths);
+        //被取消时服务端的结果不再需要,不存在的文件按不存在返回
+        if (!LogCancelToken::current().waitForReply(reply))
+            return stats;
+    }
+    if (reply.isError()) {
+        qCWarning(logDBusHandler) << "call dbus iterface 'statFiles()' failed, query one by one. error info:" << reply.error().message();
+        for (const QString &path : remotePaths) {
+            LogFileStat stat;
+            stat.path = path;
+            stat.exists = isFileExist(path);
+            stat.size = stat.exists ? static_cast<qint64>(getFileSize(path)) : 0;
+            remoteStats.append(stat);
+        }
+    } else {
+        remoteStats = reply.value();
+    }
+
+    int next = 0;
+    for (LogFileStat &stat : stats) {
+        if (stat.exists || next >= remoteStats.size())
+            continue;
+        //服务返回的结果和请求的顺序一致
+        const bool readable = stat.readable;
+        stat = remoteStats.at(next++);
+        stat.readable = readable;
+    }
+    return stats;
+}
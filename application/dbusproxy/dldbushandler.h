@@ -7,12 +7,31 @@
 
 #include "dldbusinterface.h"
 #include <QObject>
+#include <QDBusUnixFileDescriptor>
+#include <QHash>
+#include <QMutex>
 
+#include <atomic>
+#include <functional>
+
+//每次exportLogFiles调用导出的文件数,批次之间可以取消
+#define EXPORT_LOG_FILES_BATCH 32
+
+/**
+ * @brief The DLDBusHandler class 后台服务的调用,整个进程共用一个到系统总线的连接;
+ * 调用都是异步发出后再等待回复,多个加载线程可以同时调用,流式通道的下一块在处理当前一块时就已请求
+ */
 class DLDBusHandler : public QObject
 {
     Q_OBJECT
 public:
+    /**
+     * @brief ExportProgress 每个文件导出完成的回调,参数为文件序号和是否成功,返回false时不再导出之后的批次
+     */
+    typedef std::function<bool(int, bool)> ExportProgress;
+
     static DLDBusHandler *instance(QObject *parent = nullptr);
+    static void warmUp(QObject *parent);
     ~DLDBusHandler();
     QString readLog(const QString &filePath);
     QStringList getFileInfo(const QString &flag, bool unzip = true);
@@ -20,18 +39,53 @@ public:
     int exitCode();
     void quit();
     bool exportLog(const QString &outDir, const QString &in, bool isFile);
+    int exportLogFiles(const QString &outDir, const QStringList &files, const ExportProgress &progress = ExportProgress());
+    QStringList hashExportFiles(const QList<LogFileStat> &stats);
+    QString exportJournalSince(const QString &outDir, const QString &in, const QString &cursor);
+    bool exportJournal(const QString &outDir, const QString &in, const QVariantMap &options);
     bool isFileExist(const QString &filePath);
     quint64 getFileSize(const QString &filePath);
+    QList<LogFileStat> statFiles(const QStringList &paths);
     QString openLogStream(const QString &filePath);
-    QString readLogInStream(const QString &token);
+    QString readLogInStream(const QString &handle);
+    QString openReverseLogStream(const QString &filePath);
+    QString openFilteredLogStream(const QString &filePath, const QVariantMap &filter);
+    QDBusUnixFileDescriptor openLogFile(const QString &filePath);
+    QString openRecordStream(const QString &filePath, int format, const QVariantMap &filter);
+    LogRecordBatch readRecordBatch(const QString &handle);
+    void closeLogStream(const QString &handle);
+
+    static QString decodeTransfer(const QByteArray &data);
 
 private:
     explicit DLDBusHandler(QObject *parent = nullptr);
+    bool keepCompressedTransfer(const QDBusError &error);
+    QString registerStream(const QString &token);
+    QString serviceToken(const QString &handle);
+    QString releaseStream(const QString &handle);
 
 private:
     static DLDBusHandler *m_statichandeler;
+    /**
+     * @brief m_dbus 服务的代理,构造后只用来生成调用,各线程可以同时通过它发起异步调用
+     */
     DeepinLogviewerInterface *m_dbus;
-    QStringList filePath;
+    /**
+     * @brief m_streamTokens 通道句柄到服务端token的对应,open*返回句柄,每次打开都不同
+     */
+    QHash<QString, QString> m_streamTokens;
+    /**
+     * @brief m_streamAhead/m_batchAhead 各通道已经发出、还没有取走的下一块的调用,按通道句柄保存,
+     * 调用者处理当前一块时服务端同时准备下一块
+     */
+    QHash<QString, QDBusPendingReply<QString>> m_streamAhead;
+    QHash<QString, QDBusPendingReply<LogRecordBatch>> m_batchAhead;
+    QHash<QString, QDBusPendingReply<QByteArray>> m_compressedAhead;
+    QMutex m_aheadMutex;
+    /**
+     * @brief m_compressedTransfer 服务是否支持压缩传输,第一次调用时假定支持,旧版服务返回没有该接口后不再尝试
+     */
+    std::atomic_bool m_compressedTransfer {true};
 };
 
 #endif // DLDBUSHANDLER_H
@@ -19,6 +19,11 @@
 #include <QtCore/QStringList>
 #include <QtCore/QVariant>
 #include <QtDBus/QtDBus>
+#include "logfilestat.h"
+#include "logrecordbatch.h"
+
+//exportLogFiles的调用超时,毫秒
+#define EXPORT_LOG_FILES_TIMEOUT (30 * 60 * 1000)
 
 /*
  * Proxy class for interface com.deepin.logviewer
@@ -51,6 +56,45 @@ public Q_SLOTS: // METHODS
         return asyncCallWithArgumentList(QStringLiteral("exportLog"), argumentList);
     }
 
+    inline QDBusPendingReply<QList<bool>> exportLogFiles(const QString &outDir, const QStringList &files, const QString &jobId)
+    {
+        QList<QVariant> argumentList;
+        argumentList << QVariant::fromValue(outDir) << QVariant::fromValue(files) << QVariant::fromValue(jobId);
+        //一批文件的复制可能超过默认的25秒超时
+        QDBusMessage message = QDBusMessage::createMethodCall(service(), path(), interface(), QStringLiteral("exportLogFiles"));
+        message.setArguments(argumentList);
+        return connection().asyncCall(message, EXPORT_LOG_FILES_TIMEOUT);
+    }
+
+    inline QDBusPendingReply<QStringList> hashExportFiles(const QStringList &files)
+    {
+        QList<QVariant> argumentList;
+        argumentList << QVariant::fromValue(files);
+        //读取几个GB的core计算摘要同样可能超过默认超时
+        QDBusMessage message = QDBusMessage::createMethodCall(service(), path(), interface(), QStringLiteral("hashExportFiles"));
+        message.setArguments(argumentList);
+        return connection().asyncCall(message, EXPORT_LOG_FILES_TIMEOUT);
+    }
+
+    inline QDBusPendingReply<QString> exportJournalSince(const QString &outDir, const QString &in, const QString &cursor)
+    {
+        QList<QVariant> argumentList;
+        argumentList << QVariant::fromValue(outDir) << QVariant::fromValue(in) << QVariant::fromValue(cursor);
+        //和exportLogFiles一样,导出整个journal时可能超过默认超时
+        QDBusMessage message = QDBusMessage::createMethodCall(service(), path(), interface(), QStringLiteral("exportJournalSince"));
+        message.setArguments(argumentList);
+        return connection().asyncCall(message, EXPORT_LOG_FILES_TIMEOUT);
+    }
+
+    inline QDBusPendingReply<bool> exportJournal(const QString &outDir, const QString &in, const QVariantMap &options)
+    {
+        QList<QVariant> argumentList;
+        argumentList << QVariant::fromValue(outDir) << QVariant::fromValue(in) << QVariant::fromValue(options);
+        QDBusMessage message = QDBusMessage::createMethodCall(service(), path(), interface(), QStringLiteral("exportJournal"));
+        message.setArguments(argumentList);
+        return connection().asyncCall(message, EXPORT_LOG_FILES_TIMEOUT);
+    }
+
     inline QDBusPendingReply<QStringList> getFileInfo(const QString &file, bool unzip)
     {
         QList<QVariant> argumentList;
@@ -92,6 +136,62 @@ public Q_SLOTS: // METHODS
         return asyncCallWithArgumentList(QStringLiteral("readLogInStream"), argumentList);
     }
 
+    inline QDBusPendingReply<QByteArray> readLogCompressed(const QString &filePath)
+    {
+        QList<QVariant> argumentList;
+        argumentList << QVariant::fromValue(filePath);
+        return asyncCallWithArgumentList(QStringLiteral("readLogCompressed"), argumentList);
+    }
+
+    inline QDBusPendingReply<QByteArray> readLogInStreamCompressed(const QString &token)
+    {
+        QList<QVariant> argumentList;
+        argumentList << QVariant::fromValue(token);
+        return asyncCallWithArgumentList(QStringLiteral("readLogInStreamCompressed"), argumentList);
+    }
+
+    inline QDBusPendingReply<QString> openReverseLogStream(const QString &filePath)
+    {
+        QList<QVariant> argumentList;
+        argumentList << QVariant::fromValue(filePath);
+        return asyncCallWithArgumentList(QStringLiteral("openReverseLogStream"), argumentList);
+    }
+
+    inline QDBusPendingReply<QString> openFilteredLogStream(const QString &filePath, const QVariantMap &filter)
+    {
+        QList<QVariant> argumentList;
+        argumentList << QVariant::fromValue(filePath) << QVariant::fromValue(filter);
+        return asyncCallWithArgumentList(QStringLiteral("openFilteredLogStream"), argumentList);
+    }
+
+    inline QDBusPendingReply<QString> openRecordStream(const QString &filePath, int format, const QVariantMap &filter)
+    {
+        QList<QVariant> argumentList;
+        argumentList << QVariant::fromValue(filePath) << QVariant::fromValue(format) << QVariant::fromValue(filter);
+        return asyncCallWithArgumentList(QStringLiteral("openRecordStream"), argumentList);
+    }
+
+    inline QDBusPendingReply<LogRecordBatch> readRecordBatch(const QString &token)
+    {
+        QList<QVariant> argumentList;
+        argumentList << QVariant::fromValue(token);
+        return asyncCallWithArgumentList(QStringLiteral("readRecordBatch"), argumentList);
+    }
+
+    inline QDBusPendingReply<bool> closeLogStream(const QString &token)
+    {
+        QList<QVariant> argumentList;
+        argumentList << QVariant::fromValue(token);
+        return asyncCallWithArgumentList(QStringLiteral("closeLogStream"), argumentList);
+    }
+
+    inline QDBusPendingReply<QDBusUnixFileDescriptor> openLogFile(const QString &filePath)
+    {
+        QList<QVariant> argumentList;
+        argumentList << QVariant::fromValue(filePath);
+        return asyncCallWithArgumentList(QStringLiteral("openLogFile"), argumentList);
+    }
+
     inline QDBusPendingReply<bool> isFileExist(const QString &filePath)
     {
         QList<QVariant> argumentList;
@@ -105,7 +205,15 @@ public Q_SLOTS: // METHODS
         argumentList << QVariant::fromValue(filePath);
         return asyncCallWithArgumentList(QStringLiteral("getFileSize"), argumentList);
     }
+
+    inline QDBusPendingReply<QList<LogFileStat>> statFiles(const QStringList &paths)
+    {
+        QList<QVariant> argumentList;
+        argumentList << QVariant::fromValue(paths);
+        return asyncCallWithArgumentList(QStringLiteral("statFiles"), argumentList);
+    }
 Q_SIGNALS: // SIGNALS
+    void exportProgress(const QString &jobId, int index, bool success);
 };
 
 namespace com {
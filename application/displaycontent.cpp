@@ -6,9 +6,29 @@
 #include "logapplicationhelper.h"
 #include "logexportthread.h"
 #include "logfileparser.h"
+#include "journalreader.h"
+#include "logcoredumpstackwork.h"
+#include "loglongmessage.h"
+#include "logscrollbar.h"
+#include "logtablemodel.h"
+#include "logiconcache.h"
+#include "logsearchwork.h"
+#include "logtemplatework.h"
+#include "logrecordfilter.h"
+#include "logparsematchers.h"
 #include "exportprogressdlg.h"
+#include "logmemorydlg.h"
+#include "logsummarydlg.h"
+#include "logjournalcatalog.h"
 #include "utils.h"
 #include "DebugTimeManager.h"
+#include "logtracer.h"
+#include "logalloccounter.h"
+#include "logdbusstats.h"
+#include "logworkscheduler.h"
+#include "logchangenotifier.h"
+#include "logmemorygovernor.h"
+#include "loglevel.h"
 
 #include <DApplication>
 #include <DApplicationHelper>
@@ -17,9 +37,9 @@
 #include <DHorizontalLine>
 #include <DSplitter>
 #include <DScrollBar>
-#include <DStandardItem>
 #include <DStandardPaths>
 #include <DMessageManager>
+#include <DFloatingMessage>
 #include <DDesktopServices>
 
 #include <QAbstractItemView>
@@ -31,15 +51,18 @@
 #include <QPainter>
 #include <QProcess>
 #include <QProgressDialog>
+#include <QPushButton>
 #include <QThread>
 #include <QVBoxLayout>
 #include <QElapsedTimer>
 #include <QDateTime>
 #include <QFileIconProvider>
+#include <QFileInfo>
 #include <QMenu>
 #include <QLoggingCategory>
 
 #include <sys/utsname.h>
+#include <limits>
 #include "malloc.h"
 DWIDGET_USE_NAMESPACE
 
@@ -49,16 +72,67 @@ Q_LOGGING_CATEGORY(logDisplaycontent, "org.deepin.log.viewer.display.content")
 Q_LOGGING_CATEGORY(logDisplaycontent, "org.deepin.log.viewer.display.content", QtInfoMsg)
 #endif
 
-#define SINGLE_LOAD 300
-
 #define NAME_WIDTH 470
 #define LEVEL_WIDTH 80
 #define STATUS_WIDTH 90
 #define DATETIME_WIDTH 175
 #define DEAMON_WIDTH 100
+//搜索的字段条件变化后重新读取系统日志的延迟,单位毫秒
+#define JOURNAL_QUERY_DELAY 300
+
+namespace {
+//syslog等级对应的图标文件名,下标为PRIORITY,为空时显示等级文字
+const char *const levelIcons[LogLevel::SyslogCount] = {"warning2.svg", "warning3.svg", "warning2.svg", "wrong.svg", "warning.svg", "warning.svg", "", ""};
+//dnf等级对应的图标文件名,下标为DNFPRIORITY - TRACE
+const char *const dnfLevelIcons[LogLevel::DnfCount] = {"", "", "", "", "", "warning.svg", "wrong.svg", "warning2.svg", "warning3.svg"};
+
+//只有文字的列
+template <typename T>
+LogTableModel::Column<T> textColumn(QString T::*field)
+{
+    return [field](const T &record, int role) -> QVariant {
+        return role == Qt::DisplayRole ? QVariant(record.*field) : QVariant();
+    };
+}
+
+//时间列:按时间文本中的数字排序
+template <typename T>
+LogTableModel::Column<T> dateTimeColumn(QString T::*field)
+{
+    return LogTableModel::sortKeyColumn<T>(textColumn(field), [field](const T &record) {
+        return LogTableModel::dateTimeKey(record.*field);
+    });
+}
+
+//数字列:进程号、用户id等按数值排序,不是数字的排在最前
+template <typename T>
+LogTableModel::Column<T> numberColumn(QString T::*field)
+{
+    return LogTableModel::sortKeyColumn<T>(textColumn(field), [field](const T &record) -> qint64 {
+        bool ok = false;
+        const qint64 value = (record.*field).toLongLong(&ok);
+        return ok ? value : -1;
+    });
+}
+
+//等级列:有对应图标时只显示图标,levelRole保存等级文字
+QVariant levelData(const QString &iconPrefix, const QString &iconName, const QString &text, const QString &level, int role)
+{
+    switch (role) {
+    case Qt::DisplayRole:
+        return iconName.isEmpty() ? QVariant(text) : QVariant();
+    case Qt::DecorationRole:
+        return LogIconCache::instance()->icon(iconPrefix, iconName);
+    case Log_Item_SPACE::levelRole:
+        return level;
+    default:
+        return QVariant();
+    }
+}
+}
 
 /**
- * @brief DisplayContent::DisplayContent 初始化界面\等级数据和实际显示文字转换的数据结构\信号槽连接
+ * @brief DisplayContent::DisplayContent 初始化界面\信号槽连接
  * @param parent
  */
 DisplayContent::DisplayContent(QWidget *parent)
@@ -66,8 +140,22 @@ DisplayContent::DisplayContent(QWidget *parent)
 
 {
     initUI();
-    initMap();
     initConnections();
+    m_journalQueryTimer.setSingleShot(true);
+    m_journalQueryTimer.setInterval(JOURNAL_QUERY_DELAY);
+    //界面插入慢时让获取线程等待,不在事件队列中堆积数据
+    m_logFileParse.setDeliveryCredits(true);
+    m_prefetcher = new LogPrefetcher(&m_logFileParse, this);
+    m_fileChanges = new LogChangeNotifier(this);
+    connect(m_fileChanges, &LogChangeNotifier::changed, this, [this]() {
+        //上一次刷新还没有结束时不打断,结束后的下一次变化会再触发
+        if (m_journalFollow && m_isDataLoadComplete)
+            emit followRefreshRequested();
+    });
+    //内存紧张时逐级降级,而不是一直增长到被OOM结束
+    connect(LogMemoryGovernor::instance(), &LogMemoryGovernor::levelChanged, this, &DisplayContent::slot_memoryLevelChanged);
+    LogMemoryGovernor::instance()->start();
+    slot_memoryLevelChanged(LogMemoryGovernor::currentLevel());
 }
 
 /**
@@ -75,6 +163,8 @@ DisplayContent::DisplayContent(QWidget *parent)
  */
 DisplayContent::~DisplayContent()
 {
+    cancelSearch();
+    cancelSearchIndex();
     malloc_trim(0);
 }
 /**
@@ -86,6 +176,226 @@ LogTreeView *DisplayContent::mainLogTableView()
     return m_treeView;
 }
 
+/**
+ * @brief DisplayContent::setPrefetchPaused 导出期间暂停后台预取
+ */
+void DisplayContent::setPrefetchPaused(bool paused)
+{
+    if (m_prefetcher)
+        m_prefetcher->setPaused(paused);
+}
+
+/**
+ * @brief DisplayContent::saveSnapshot 把已加载过的类别写入快照文件,结果以toast提示
+ */
+void DisplayContent::saveSnapshot(const QString &path)
+{
+    QString titleIcon = ICONPREFIX;
+    if (m_logFileParse.saveSnapshot(path))
+        DMessageManager::instance()->sendMessage(this->window(), QIcon(titleIcon + "ok.svg"), DApplication::translate("Snapshot", "Snapshot saved"));
+    else
+        DMessageManager::instance()->sendMessage(this->window(), QIcon(titleIcon + "warning_info.svg"), DApplication::translate("Snapshot", "Failed to save the snapshot"));
+}
+
+/**
+ * @brief DisplayContent::openArchive 打开全部导出的zip包,在其他日志的列表中显示包中的类别,调用者需要先选中其他日志
+ * 再次打开同一个包时沿用已建立的索引
+ * @return 是否打开成功
+ */
+bool DisplayContent::openArchive(const QString &zipPath)
+{
+    QString titleIcon = ICONPREFIX;
+    LogArchivePtr archive = m_archive && m_archive->zipPath() == zipPath ? m_archive : std::make_shared<LogArchive>(zipPath);
+    if ((archive != m_archive && !archive->open()) || archive->categories().isEmpty()) {
+        DMessageManager::instance()->sendMessage(this->window(), QIcon(titleIcon + "warning_info.svg"), DApplication::translate("Archive", "Not a valid log archive"));
+        return false;
+    }
+    m_archive = archive;
+    m_flag = OtherLog;
+    generateArchiveLogs();
+    return true;
+}
+
+/**
+ * @brief DisplayContent::startExportServer 接收命令行的系统日志导出请求,类别缓存能满足筛选条件时直接导出
+ * 缓存只在界面线程中读取,增量读取新日志和写文件在导出线程池中进行
+ */
+void DisplayContent::startExportServer()
+{
+    if (!m_exportServer)
+        m_exportServer = new LogExportServer(this);
+    m_exportServer->listen([this](const LogExportRequest &request, const LogExportServer::Reply &reply) {
+        QList<LOG_MSG_JOURNAL> records;
+        QString cursor;
+        if (!m_logFileParse.cachedJournal(request.arg, &records, &cursor)) {
+            reply(LogExportServer::Unanswerable);
+            return;
+        }
+        QFutureWatcher<LogExportServer::Status> *watcher = new QFutureWatcher<LogExportServer::Status>(this);
+        connect(watcher, &QFutureWatcher<LogExportServer::Status>::finished, this, [watcher, reply]() {
+            reply(watcher->result());
+            watcher->deleteLater();
+        });
+        watcher->setFuture(LogWorkScheduler::instance()->run(LogWorkScheduler::Export, [request, records, cursor]() {
+            return LogExportServer::exportJournal(request, records, cursor);
+        }));
+    });
+}
+
+/**
+ * @brief DisplayContent::openSnapshot 打开快照文件,之后各类别只显示快照中的日志,调用者需要重新加载当前类别
+ * @return 是否打开成功
+ */
+bool DisplayContent::openSnapshot(const QString &path)
+{
+    QString titleIcon = ICONPREFIX;
+    if (!m_logFileParse.openSnapshot(path)) {
+        DMessageManager::instance()->sendMessage(this->window(), QIcon(titleIcon + "warning_info.svg"), DApplication::translate("Snapshot", "Not a valid snapshot file"));
+        return false;
+    }
+    //快照中的日志不会再增加,停止跟踪本机日志
+    emit m_logFileParse.stopJournalFollow();
+    m_journalFollowIndex = -1;
+    DMessageManager::instance()->sendMessage(this->window(), QIcon(titleIcon + "ok.svg"), DApplication::translate("Snapshot", "Snapshot opened"));
+    return true;
+}
+
+/**
+ * @brief appendMemoryUsage 统计一个类别的存储和筛选视图,没有数据的类别不列出
+ */
+template <typename Store, typename T>
+static void appendMemoryUsage(QList<LogMemoryUsage> &usages, QSet<const void *> &seen, const QString &category,
+                              const Store &store, const LogRecordView<T> &view)
+{
+    LogMemoryUsage usage = LogMemoryAccounting::measure(category, store);
+    LogMemoryAccounting::addView(usage, view, seen);
+    if (usage.records > 0 || usage.viewBytes > 0)
+        usages.append(usage);
+}
+
+/**
+ * @brief DisplayContent::memoryUsage 统计各类别的记录存储、筛选视图、表格model和类别缓存的内存占用
+ * 视图和model共享的下标数组只算在视图上;缓存和界面共享的批次按缓存自己的估计单独列出,可能和类别的统计重叠
+ */
+QList<LogMemoryUsage> DisplayContent::memoryUsage() const
+{
+    QList<LogMemoryUsage> usages;
+    QSet<const void *> seen;
+    appendMemoryUsage(usages, seen, "journal", jListOrigin, jList);
+    appendMemoryUsage(usages, seen, "journalBoot", jBootListOrigin, jBootList);
+    appendMemoryUsage(usages, seen, "kern", kListOrigin, kList);
+    appendMemoryUsage(usages, seen, "dpkg", dListOrigin, dList);
+    appendMemoryUsage(usages, seen, "xorg", xListOrigin, xList);
+    appendMemoryUsage(usages, seen, "boot", bList, currentBootList);
+    appendMemoryUsage(usages, seen, "other", oListOrigin, oList);
+    appendMemoryUsage(usages, seen, "custom", cListOrigin, cList);
+    appendMemoryUsage(usages, seen, "audit", aListOrigin, aList);
+    appendMemoryUsage(usages, seen, "app", appListOrigin, appList);
+    appendMemoryUsage(usages, seen, "normal", norList, nortempList);
+    appendMemoryUsage(usages, seen, "kwin", m_kwinList, m_currentKwinList);
+    appendMemoryUsage(usages, seen, "coredump", m_coredumpList, m_currentCoredumpList);
+    appendMemoryUsage(usages, seen, "dnf", dnfListOrigin, dnfList);
+    appendMemoryUsage(usages, seen, "dmesg", dmesgListOrigin, dmesgList);
+    if (!m_journalIncrementList.isEmpty())
+        usages.append(LogMemoryAccounting::measure("journalIncrement", m_journalIncrementList));
+
+    LogMemoryUsage model;
+    model.category = "model";
+    model.records = m_pModel->rowCount();
+    model.modelBytes = m_pModel->memoryBytes(seen);
+    usages.append(model);
+
+    if (m_trigramIndex.ready) {
+        LogMemoryUsage index;
+        index.category = "searchIndex";
+        index.records = m_trigramIndex.index->rowCount();
+        index.recordBytes = m_trigramIndex.index->memoryBytes();
+        usages.append(index);
+    }
+
+    LogMemoryUsage cache;
+    cache.category = "cache";
+    cache.records = m_logFileParse.categoryCache().size();
+    cache.recordBytes = m_logFileParse.categoryCache().cost();
+    usages.append(cache);
+    return usages;
+}
+
+/**
+ * @brief DisplayContent::showMemoryUsage 打开内存占用调试面板
+ */
+void DisplayContent::showMemoryUsage()
+{
+    LogMemoryDlg *dlg = new LogMemoryDlg([this]() {
+        return memoryUsage();
+    }, this);
+    dlg->setAttribute(Qt::WA_DeleteOnClose);
+    dlg->show();
+}
+
+/**
+ * @brief DisplayContent::journalExportOptions 系统日志当前的时间和等级筛选,转换为导出journal的参数
+ * 搜索框的条件不加入,导出的仍是所选时间段和等级的全部日志;还没有加载过系统日志时为空
+ */
+QVariantMap DisplayContent::journalExportOptions() const
+{
+    QVariantMap options;
+    //字段匹配在前三个参数之后,只取等级和时间范围
+    const JournalReadOptions read = JournalReadOptions::fromArgs(m_journalArgs.mid(0, 3));
+    if (read.priorityMatch.startsWith("PRIORITY="))
+        options.insert("priority", read.priorityMatch.mid(9).toInt());
+    if (read.hasTimeRange) {
+        options.insert("since", static_cast<qint64>(read.beginTime));
+        options.insert("until", static_cast<qint64>(read.endTime));
+    }
+    return options;
+}
+
+/**
+ * @brief DisplayContent::showSummary 打开当前类别的统计面板,已打开时只激活
+ */
+void DisplayContent::showSummary()
+{
+    if (m_summaryDlg) {
+        m_summaryDlg->refresh();
+        m_summaryDlg->activateWindow();
+        return;
+    }
+    m_summaryDlg = new LogSummaryDlg(&m_aggregates, this);
+    m_summaryDlg->setAttribute(Qt::WA_DeleteOnClose);
+    connect(m_summaryDlg, &LogSummaryDlg::termActivated, this, &DisplayContent::searchTermRequested);
+    m_summaryDlg->show();
+}
+
+/**
+ * @brief DisplayContent::addAggregates 累加一批新加载的记录,统计面板打开时随之刷新
+ */
+void DisplayContent::addAggregates(const QList<LOG_MSG_JOURNAL> &list, int begin, int end)
+{
+    m_aggregates.add(list, begin, end);
+    if (m_summaryDlg)
+        m_summaryDlg->refresh();
+}
+
+/**
+ * @brief DisplayContent::finishIngest 一次加载结束,输出读取、解析、总线调用、插入model和第一行显示的耗时
+ * 设置DEEPIN_LOG_VIEWER_METRICS=<文件路径>时同时追加到指标文件,之后追加一行各总线接口的耗时和回复大小直方图
+ * @param kept 加载得到的记录数
+ */
+void DisplayContent::finishIngest(qint64 kept)
+{
+    //加载完成时类别已确定,开始监视它的日志文件
+    updateFileFollow();
+    if (!m_ingest.isActive())
+        return;
+    const LogIngestReport report = m_ingest.finish(kept);
+    qCInfo(logDisplaycontent).noquote() << report.toLogLine();
+    LogIngestMetrics::appendMetricsFile(report);
+    //总线调用的直方图从启动开始累计,和各次加载的指标对照
+    qCDebug(logDisplaycontent).noquote() << LogDBusStats::format(LogDBusStats::snapshot());
+    LogDBusStats::appendMetricsFile();
+}
+
 /**
  * @brief DisplayContent::initUI 初始化布局及界面
  */
@@ -166,42 +476,22 @@ void DisplayContent::initUI()
     m_act_openForder = m_menu->addAction(/*tr("在文件管理器中显示")*/ DApplication::translate("Action", "Display in file manager"));
     m_act_refresh = m_menu->addAction(/*tr("刷新")*/ DApplication::translate("Action", "Refresh"));
 
-    //setLoadState
-    setLoadState(DATA_COMPLETE);
-}
-
-/**
- * @brief DisplayContent::initMap 初始化等级数据和实际显示文字转换的数据结构
- */
-void DisplayContent::initMap()
-{
-    m_transDict.clear();
-    m_transDict.insert("Warning", DApplication::translate("Level", "Warning")); //add by Airy for bug 19167 and 19161
-    m_transDict.insert("Debug", DApplication::translate("Level", "Debug")); //add by Airy for bug 19167 and 19161
-    m_transDict.insert("Info", DApplication::translate("Level", "Info"));
-    m_transDict.insert("Error", DApplication::translate("Level", "Error"));
+    m_similarMenu = new QMenu(m_treeView);
+    m_similarMenu->setAccessibleName("similar_menu");
+    m_act_collapseSimilar = m_similarMenu->addAction(DApplication::translate("Action", "Collapse similar messages"));
+    m_act_collapseSimilar->setCheckable(true);
+    connect(m_act_collapseSimilar, &QAction::triggered, this, &DisplayContent::setCollapseSimilar);
+    m_act_summary = m_similarMenu->addAction(DApplication::translate("Action", "Summary"));
+    connect(m_act_summary, &QAction::triggered, this, &DisplayContent::showSummary);
 
-    // icon <==> level
-    m_icon_name_map.clear();
-    m_icon_name_map.insert(DApplication::translate("Level", "Emergency"), "warning2.svg");
-    m_icon_name_map.insert(DApplication::translate("Level", "Alert"), "warning3.svg");
-    m_icon_name_map.insert(DApplication::translate("Level", "Critical"), "warning2.svg");
-    m_icon_name_map.insert(DApplication::translate("Level", "Error"), "wrong.svg");
-    m_icon_name_map.insert(DApplication::translate("Level", "Warning"), "warning.svg");
-    m_icon_name_map.insert(DApplication::translate("Level", "Notice"), "warning.svg");
-    m_icon_name_map.insert(DApplication::translate("Level", "Info"), "");
-    m_icon_name_map.insert(DApplication::translate("Level", "Debug"), "");
-    m_icon_name_map.insert("Warning", "warning.svg");
-    m_icon_name_map.insert("Debug", "");
-    m_icon_name_map.insert("Error", "wrong.svg");
+    m_dpkgMenu = new QMenu(m_treeView);
+    m_dpkgMenu->setAccessibleName("dpkg_menu");
+    m_act_groupTransactions = m_dpkgMenu->addAction(DApplication::translate("Action", "Group by transaction"));
+    m_act_groupTransactions->setCheckable(true);
+    connect(m_act_groupTransactions, &QAction::triggered, this, &DisplayContent::setGroupTransactions);
 
-    m_dnfIconNameMap.insert(Dtk::Widget::DApplication::translate("Level", "Trace"), "");
-    m_dnfIconNameMap.insert(Dtk::Widget::DApplication::translate("Level", "Debug"), "");
-    m_dnfIconNameMap.insert(Dtk::Widget::DApplication::translate("Level", "Info"), "");
-    m_dnfIconNameMap.insert(Dtk::Widget::DApplication::translate("Level", "Warning"), "warning.svg");
-    m_dnfIconNameMap.insert(Dtk::Widget::DApplication::translate("Level", "Error"), "wrong.svg");
-    m_dnfIconNameMap.insert(Dtk::Widget::DApplication::translate("Level", "Critical"), "warning2.svg");
-    m_dnfIconNameMap.insert(Dtk::Widget::DApplication::translate("Level", "Super critical"), "warning3.svg");
+    //setLoadState
+    setLoadState(DATA_COMPLETE);
 }
 
 /**
@@ -212,87 +502,181 @@ void DisplayContent::initTableView()
     m_treeView = new LogTreeView(this);
     m_treeView->setObjectName("mainLogTable");
     m_treeView->setAccessibleName("mainLogTable");
-    m_pModel = new QStandardItemModel(this);
+    m_pModel = new LogTableModel(this);
     m_treeView->setModel(m_pModel);
+    //滚动条上按当前类别的时间列显示日志密集的区段和搜索命中的位置
+    m_treeView->logScrollBar()->setMinimapModel(m_pModel, [this]() { return timeColumn(); });
     m_treeView->setContextMenuPolicy(Qt::CustomContextMenu);
+    //点击表头按列排序,默认保持读取顺序;切换日志类型时model被清空,恢复为未排序
+    m_treeView->header()->setSortIndicator(-1, Qt::DescendingOrder);
+    m_treeView->setSortingEnabled(true);
+    connect(m_pModel, &LogTableModel::modelReset, this, [this]() {
+        m_treeView->header()->setSortIndicator(-1, Qt::DescendingOrder);
+    });
+}
+
+/**
+ * @brief DisplayContent::timeColumn 当前类别表格中的时间列,没有时为-1
+ */
+int DisplayContent::timeColumn() const
+{
+    switch (m_flag) {
+    case JOURNAL:
+    case BOOT_KLU:
+        return JOURNAL_SPACE::journalDateTimeColumn;
+    case KERN:
+        return KERN_SPACE::kernDateTimeColumn;
+    case DPKG:
+        return DKPG_SPACE::dkpgDateTimeColumn;
+    case XORG:
+        return XORG_SPACE::xorgDateTimeColumn;
+    case APP:
+        return APP_SPACE::appDateTimeColumn;
+    case Normal:
+        return NORMAL_SPACE::normalDateTimeColumn;
+    case Dnf:
+        return DNF_SPACE::dnfDateTimeColumn;
+    case Dmesg:
+        return DMESG_SPACE::dmesgDateTimeColumn;
+    case Audit:
+        return AUDIT_SPACE::auditDateTimeColumn;
+    case COREDUMP:
+        return COREDUMP_SPACE::COREDUMP_TIME_COLUMN;
+    default:
+        return -1;
+    }
 }
 
 /**
- * @brief DisplayContent::initConnections 初始化槽函数信号连接
+ * @brief DisplayContent::initConnections 初始化各类日志共用的槽函数信号连接,各类日志自己的获取信号见ensureTypeSetup
  */
 void DisplayContent::initConnections()
 {
     connect(m_treeView, SIGNAL(pressed(const QModelIndex &)), this,
             SLOT(slot_tableItemClicked(const QModelIndex &)));
+    connect(m_treeView, &LogTreeView::doubleClicked, this, &DisplayContent::slot_tableItemDoubleClicked);
 
     connect(this, &DisplayContent::sigDetailInfo, m_detailWgt, &logDetailInfoWidget::slot_DetailInfo);
-    connect(&m_logFileParse, &LogFileParser::dpkgFinished, this, &DisplayContent::slot_dpkgFinished,
-            Qt::QueuedConnection);
-    connect(&m_logFileParse, &LogFileParser::dpkgData, this, &DisplayContent::slot_dpkgData,
-            Qt::QueuedConnection);
-    connect(&m_logFileParse, &LogFileParser::xlogFinished, this, &DisplayContent::slot_XorgFinished,
-            Qt::QueuedConnection);
-    connect(&m_logFileParse, &LogFileParser::xlogData, this, &DisplayContent::slot_xorgData,
-            Qt::QueuedConnection);
-
-    connect(&m_logFileParse, &LogFileParser::bootFinished, this, &DisplayContent::slot_bootFinished,
-            Qt::QueuedConnection);
-    connect(&m_logFileParse, &LogFileParser::bootData, this, &DisplayContent::slot_bootData,
-            Qt::QueuedConnection);
-
-    connect(&m_logFileParse, &LogFileParser::kernFinished, this, &DisplayContent::slot_kernFinished,
-            Qt::QueuedConnection);
-    connect(&m_logFileParse, &LogFileParser::kernData, this, &DisplayContent::slot_kernData,
-            Qt::QueuedConnection);
-
-    connect(&m_logFileParse, &LogFileParser::journalFinished, this, &DisplayContent::slot_journalFinished,
-            Qt::QueuedConnection);
-    connect(&m_logFileParse, &LogFileParser::journalData, this, &DisplayContent::slot_journalData,
-            Qt::QueuedConnection);
-    connect(&m_logFileParse, &LogFileParser::journaBootlData, this, &DisplayContent::slot_journalBootData,
-            Qt::QueuedConnection);
-    connect(&m_logFileParse, &LogFileParser::appFinished, this,
-            &DisplayContent::slot_applicationFinished);
-    connect(&m_logFileParse, &LogFileParser::appData, this,
-            &DisplayContent::slot_applicationData);
-
-    connect(&m_logFileParse, &LogFileParser::kwinFinished, this, &DisplayContent::slot_kwinFinished,
-            Qt::QueuedConnection);
-    connect(&m_logFileParse, &LogFileParser::kwinData, this, &DisplayContent::slot_kwinData,
-            Qt::QueuedConnection);
-
-    connect(&m_logFileParse, &LogFileParser::normalData, this, &DisplayContent::slot_normalData,
-            Qt::QueuedConnection);
-    connect(&m_logFileParse, &LogFileParser::normalFinished, this, &DisplayContent::slot_normalFinished,
-            Qt::QueuedConnection);
-    connect(&m_logFileParse, &LogFileParser::journalBootFinished, this, &DisplayContent::slot_journalBootFinished);
-
-    connect(m_treeView->verticalScrollBar(), &QScrollBar::valueChanged, this,
-            &DisplayContent::slot_vScrollValueChanged);
     connect(&m_logFileParse, &LogFileParser::proccessError, this, &DisplayContent::slot_logLoadFailed,
             Qt::QueuedConnection);
-    connect(&m_logFileParse, SIGNAL(dnfFinished(QList<LOG_MSG_DNF>)), this, SLOT(slot_dnfFinished(QList<LOG_MSG_DNF>)));
-    connect(&m_logFileParse, &LogFileParser::dmesgFinished, this, &DisplayContent::slot_dmesgFinished,
-            Qt::QueuedConnection);
-    connect(&m_logFileParse, &LogFileParser::OOCData, this, &DisplayContent::slot_OOCData,
-            Qt::QueuedConnection);
-    connect(&m_logFileParse, &LogFileParser::OOCFinished, this, &DisplayContent::slot_OOCFinished,
-            Qt::QueuedConnection);
-
-    connect(&m_logFileParse, &LogFileParser::auditData, this, &DisplayContent::slot_auditData,
-            Qt::QueuedConnection);
-    connect(&m_logFileParse, &LogFileParser::auditFinished, this, &DisplayContent::slot_auditFinished,
-            Qt::QueuedConnection);
-
-    connect(&m_logFileParse, &LogFileParser::coredumpData, this, &DisplayContent::slot_coredumpData,
-            Qt::QueuedConnection);
-    connect(&m_logFileParse, &LogFileParser::coredumpFinished, this, &DisplayContent::slot_coredumpFinished,
-            Qt::QueuedConnection);
-
     connect(m_treeView, &LogTreeView::customContextMenuRequested, this, &DisplayContent::slot_requestShowRightMenu);
+    connect(&m_journalQueryTimer, &QTimer::timeout, this, [this] {
+        if (m_flag != JOURNAL || LogQuery(m_currentSearchStr).journalMatches() == m_loadedJournalMatches)
+            return;
+        //同一筛选条件下的重新读取不受防抖限制
+        m_lastJournalGetTime = QDateTime::fromTime_t(0);
+        generateJournalFile(m_journalFilter.timeFilter, m_journalFilter.eventTypeFilter, m_currentSearchStr);
+    });
     connect(LogApplicationHelper::instance(), &LogApplicationHelper::sigValueChanged, this, &DisplayContent::slot_valueChanged_dConfig_or_gSetting);
 }
 
+/**
+ * @brief DisplayContent::ensureTypeSetup 第一次显示某类日志时才连接它的获取信号,
+ * 启动和首次绘制只为实际显示的类别付出代价;之后再调用不做任何事
+ * @param flag 日志类别,其他日志和自定义日志共用一组信号
+ */
+void DisplayContent::ensureTypeSetup(LOG_FLAG flag)
+{
+    const LOG_FLAG key = flag == CustomLog ? OtherLog : flag;
+    if (m_setupTypes.contains(key))
+        return;
+    m_setupTypes.insert(key);
+
+    switch (key) {
+    case DPKG:
+        connect(&m_logFileParse, &LogFileParser::dpkgFinished, this, &DisplayContent::slot_dpkgFinished,
+                Qt::QueuedConnection);
+        connect(&m_logFileParse, &LogFileParser::dpkgData, this, &DisplayContent::slot_dpkgData,
+                Qt::QueuedConnection);
+        break;
+    case XORG:
+        connect(&m_logFileParse, &LogFileParser::xlogFinished, this, &DisplayContent::slot_XorgFinished,
+                Qt::QueuedConnection);
+        connect(&m_logFileParse, &LogFileParser::xlogData, this, &DisplayContent::slot_xorgData,
+                Qt::QueuedConnection);
+        break;
+    case BOOT:
+        connect(&m_logFileParse, &LogFileParser::bootFinished, this, &DisplayContent::slot_bootFinished,
+                Qt::QueuedConnection);
+        connect(&m_logFileParse, &LogFileParser::bootData, this, &DisplayContent::slot_bootData,
+                Qt::QueuedConnection);
+        break;
+    case KERN:
+        connect(&m_logFileParse, &LogFileParser::kernFinished, this, &DisplayContent::slot_kernFinished,
+                Qt::QueuedConnection);
+        connect(&m_logFileParse, &LogFileParser::kernData, this, &DisplayContent::slot_kernData,
+                Qt::QueuedConnection);
+        break;
+    case JOURNAL:
+        connect(&m_logFileParse, &LogFileParser::journalFinished, this, &DisplayContent::slot_journalFinished,
+                Qt::QueuedConnection);
+        connect(&m_logFileParse, &LogFileParser::journalData, this, &DisplayContent::slot_journalData,
+                Qt::QueuedConnection);
+        connect(&m_logFileParse, &LogFileParser::journalCursor, this, &DisplayContent::slot_journalCursor,
+                Qt::QueuedConnection);
+        connect(&m_logFileParse, &LogFileParser::journalFollowData, this, &DisplayContent::slot_journalFollowData,
+                Qt::QueuedConnection);
+        connect(&m_logFileParse, &LogFileParser::journalFollowFinished, this, &DisplayContent::slot_journalFollowFinished,
+                Qt::QueuedConnection);
+        break;
+    case BOOT_KLU:
+        connect(&m_logFileParse, &LogFileParser::journaBootlData, this, &DisplayContent::slot_journalBootData,
+                Qt::QueuedConnection);
+        connect(&m_logFileParse, &LogFileParser::journalBootFinished, this, &DisplayContent::slot_journalBootFinished);
+        break;
+    case APP:
+        connect(&m_logFileParse, &LogFileParser::appFinished, this,
+                &DisplayContent::slot_applicationFinished);
+        connect(&m_logFileParse, &LogFileParser::appData, this,
+                &DisplayContent::slot_applicationData);
+        break;
+    case Kwin:
+        connect(&m_logFileParse, &LogFileParser::kwinFinished, this, &DisplayContent::slot_kwinFinished,
+                Qt::QueuedConnection);
+        connect(&m_logFileParse, &LogFileParser::kwinData, this, &DisplayContent::slot_kwinData,
+                Qt::QueuedConnection);
+        break;
+    case Normal:
+        connect(&m_logFileParse, &LogFileParser::normalData, this, &DisplayContent::slot_normalData,
+                Qt::QueuedConnection);
+        connect(&m_logFileParse, &LogFileParser::normalFinished, this, &DisplayContent::slot_normalFinished,
+                Qt::QueuedConnection);
+        break;
+    case Dnf:
+        connect(&m_logFileParse, &LogFileParser::dnfData, this, &DisplayContent::slot_dnfData,
+                Qt::QueuedConnection);
+        connect(&m_logFileParse, &LogFileParser::dnfFinished, this, &DisplayContent::slot_dnfFinished,
+                Qt::QueuedConnection);
+        break;
+    case Dmesg:
+        connect(&m_logFileParse, &LogFileParser::dmesgData, this, &DisplayContent::slot_dmesgData,
+                Qt::QueuedConnection);
+        connect(&m_logFileParse, &LogFileParser::dmesgFinished, this, &DisplayContent::slot_dmesgFinished,
+                Qt::QueuedConnection);
+        break;
+    case OtherLog:
+        connect(&m_logFileParse, &LogFileParser::OOCData, this, &DisplayContent::slot_OOCData,
+                Qt::QueuedConnection);
+        connect(&m_logFileParse, &LogFileParser::OOCFinished, this, &DisplayContent::slot_OOCFinished,
+                Qt::QueuedConnection);
+        break;
+    case Audit:
+        connect(&m_logFileParse, &LogFileParser::auditData, this, &DisplayContent::slot_auditData,
+                Qt::QueuedConnection);
+        connect(&m_logFileParse, &LogFileParser::auditFinished, this, &DisplayContent::slot_auditFinished,
+                Qt::QueuedConnection);
+        break;
+    case COREDUMP:
+        connect(&m_logFileParse, &LogFileParser::coredumpData, this, &DisplayContent::slot_coredumpData,
+                Qt::QueuedConnection);
+        connect(&m_logFileParse, &LogFileParser::coredumpFinished, this, &DisplayContent::slot_coredumpFinished,
+                Qt::QueuedConnection);
+        break;
+    default:
+        break;
+    }
+}
+
 /**
  * @brief DisplayContent::generateJournalFile 获取系统日志
  * @param id 时间筛选id 对应BUTTONID枚举,0表示全部,1是今天,2是3天内,3是筛选1周内数据,4是筛选一个月内的,5是三个月
@@ -305,11 +689,11 @@ void DisplayContent::initConnections()
  * 5  NOTICE（注意）：不会影响系统但值得注意
  * 6  INFO（信息）：一般信息
  * 7  DEBUG（调试）：程序或系统调试信息等
- * @param iSearchStr 搜索关键字,现阶段不用,保留参数
+ * @param iSearchStr 搜索关键字,其中的字段条件下推给sd_journal,只读取满足条件的日志
  */
 void DisplayContent::generateJournalFile(int id, int lId, const QString &iSearchStr)
 {
-    Q_UNUSED(iSearchStr)
+    ensureTypeSetup(JOURNAL);
     //系统日志上次获取的时间,和筛选条件一起判断,防止获取过于频繁
     if (m_lastJournalGetTime.msecsTo(QDateTime::currentDateTime()) < 500 && m_journalFilter.timeFilter == id && m_journalFilter.eventTypeFilter == lId) {
         qCWarning(logDisplaycontent) << "load journal log: repeat refrsh journal too fast!";
@@ -320,10 +704,12 @@ void DisplayContent::generateJournalFile(int id, int lId, const QString &iSearch
         return;
     }
     m_lastJournalGetTime = QDateTime::currentDateTime();
+    m_ingest.begin("journal");
     m_journalFilter.timeFilter = id;
     m_journalFilter.eventTypeFilter = lId;
     m_firstLoadPageData = true;
     clearAllFilter();
+    m_currentSearchStr = iSearchStr;
     clearAllDatalist();
     m_isDataLoadComplete = false;
     jList.clear();
@@ -340,16 +726,13 @@ void DisplayContent::generateJournalFile(int id, int lId, const QString &iSearch
         arg.append("all");
     }
     switch (id) {
-    case ALL: {
-        m_journalCurrentIndex = m_logFileParse.parseByJournal(arg);
-    }
-    break;
+    case ALL:
+        break;
     case ONE_DAY: {
         QDateTime dtStart = dt;
         QDateTime dtEnd = dt;
         dtEnd.setTime(QTime(23, 59, 59, 999));
         arg << QString::number(dtStart.toMSecsSinceEpoch() * 1000) << QString::number(dtEnd.toMSecsSinceEpoch() * 1000);
-        m_journalCurrentIndex = m_logFileParse.parseByJournal(arg);
     }
     break;
     case THREE_DAYS: {
@@ -357,7 +740,6 @@ void DisplayContent::generateJournalFile(int id, int lId, const QString &iSearch
         QDateTime dtEnd = dt;
         dtEnd.setTime(QTime(23, 59, 59, 999));
         arg << QString::number(dtStart.addDays(-2).toMSecsSinceEpoch() * 1000) << QString::number(dtEnd.toMSecsSinceEpoch() * 1000);
-        m_journalCurrentIndex = m_logFileParse.parseByJournal(arg);
     }
     break;
     case ONE_WEEK: {
@@ -365,7 +747,6 @@ void DisplayContent::generateJournalFile(int id, int lId, const QString &iSearch
         QDateTime dtEnd = dt;
         dtEnd.setTime(QTime(23, 59, 59, 999));
         arg << QString::number(dtStart.addDays(-6).toMSecsSinceEpoch() * 1000) << QString::number(dtEnd.toMSecsSinceEpoch() * 1000);
-        m_journalCurrentIndex = m_logFileParse.parseByJournal(arg);
     }
     break;
     case ONE_MONTH: {
@@ -373,7 +754,6 @@ void DisplayContent::generateJournalFile(int id, int lId, const QString &iSearch
         QDateTime dtEnd = dt;
         dtEnd.setTime(QTime(23, 59, 59, 999));
         arg << QString::number(dtStart.addMonths(-1).toMSecsSinceEpoch() * 1000) << QString::number(dtEnd.toMSecsSinceEpoch() * 1000);
-        m_journalCurrentIndex = m_logFileParse.parseByJournal(arg);
     }
     break;
     case THREE_MONTHS: {
@@ -381,12 +761,19 @@ void DisplayContent::generateJournalFile(int id, int lId, const QString &iSearch
         QDateTime dtEnd = dt;
         dtEnd.setTime(QTime(23, 59, 59, 999));
         arg << QString::number(dtStart.addMonths(-3).toMSecsSinceEpoch() * 1000) << QString::number(dtEnd.toMSecsSinceEpoch() * 1000);
-        m_journalCurrentIndex = m_logFileParse.parseByJournal(arg);
     }
     break;
     default:
         break;
     }
+    m_loadedJournalMatches = LogQuery(iSearchStr).journalMatches();
+    //来源下拉框的匹配和搜索条件求与,sd_journal只读取所选来源的日志
+    arg << LogJournalCatalog::applyMatch(m_loadedJournalMatches, m_journalFieldMatch);
+    m_journalArgs = arg;
+    m_journalLoadDate = dt.date();
+    m_journalNewestCursor.clear();
+    m_journalFollowIndex = -1;
+    m_journalCurrentIndex = m_logFileParse.parseByJournal(arg);
     m_treeView->setColumnWidth(JOURNAL_SPACE::journalLevelColumn, LEVEL_WIDTH);
     m_treeView->setColumnWidth(JOURNAL_SPACE::journalDaemonNameColumn, DEAMON_WIDTH);
     m_treeView->setColumnWidth(JOURNAL_SPACE::journalDateTimeColumn, DATETIME_WIDTH);
@@ -395,23 +782,221 @@ void DisplayContent::generateJournalFile(int id, int lId, const QString &iSearch
  * @brief DisplayContent::createJournalTableStart 获取系统日志完成时第一次加载数据的第一页到treeview中
  * @param list 获得的系统日志数据list
  */
-void DisplayContent::createJournalTableStart(const QList<LOG_MSG_JOURNAL> &list)
+void DisplayContent::createJournalTableStart(const LogRecordView<LOG_MSG_JOURNAL> &list)
 {
-    m_limitTag = 0;
     setLoadState(DATA_COMPLETE);
-    int end = list.count() > SINGLE_LOAD ? SINGLE_LOAD : list.count();
-    insertJournalTable(list, 0, end);
+    insertJournalTable(list, 0, list.count());
     QItemSelectionModel *p = m_treeView->selectionModel();
     if (p)
         p->select(m_pModel->index(0, 0), QItemSelectionModel::Rows | QItemSelectionModel::Select);
     slot_tableItemClicked(m_pModel->index(0, 0));
 }
 
+/**
+ * @brief DisplayContent::generateJournalIncrement 增量刷新系统日志,只读取上次最新游标之后的新日志并插入到列表头部
+ */
+void DisplayContent::generateJournalIncrement()
+{
+    m_journalIncremental = true;
+    m_journalIncrementList.clear();
+    m_journalFollowIndex = -1;
+    m_lastJournalGetTime = QDateTime::currentDateTime();
+    m_journalCurrentIndex = m_logFileParse.parseByJournal(m_journalArgs, m_journalNewestCursor);
+}
+
+/**
+ * @brief DisplayContent::mergeJournalIncrement 把增量刷新或实时跟踪获得的新日志插入到数据列表和model的头部
+ * @param list 按从新到旧排列的新日志
+ */
+void DisplayContent::mergeJournalIncrement(const QList<LOG_MSG_JOURNAL> &list)
+{
+    if (list.isEmpty())
+        return;
+
+    //新日志一般都比已加载的新,放在存储头部,已有记录的下标都要后移;
+    //时钟回调等原因和已加载的记录时间重叠时按时间归并,下标都变了,按新的数据重新筛选
+    addAggregates(list);
+    const bool wasEmpty = jListOrigin.isEmpty();
+    if (jListOrigin.ingest(list, LogRecordStore<LOG_MSG_JOURNAL>::NewestFirst, [](const LOG_MSG_JOURNAL &msg) { return msg.timestamp; })
+            != LogRecordStore<LOG_MSG_JOURNAL>::Prepended && !wasEmpty) {
+        slot_searchResult(m_currentSearchStr);
+        return;
+    }
+    jList.offsetRows(list.size());
+    m_pModel->offsetRecords<LOG_MSG_JOURNAL>(list.size());
+    //正在进行的搜索返回的是旧下标,按新的数据重新搜索
+    if (m_searchIndex >= 0) {
+        slot_searchResult(m_currentSearchStr);
+        return;
+    }
+    bool undecided = false;
+    const LogRecordView<LOG_MSG_JOURNAL> filterList = filterJournal(m_currentSearchStr, LogRecordView<LOG_MSG_JOURNAL>::range(&jListOrigin, 0, list.size()), &undecided);
+    //有被截断的新日志需要读取完整信息时,在搜索线程中重新搜索
+    if (undecided) {
+        slot_searchResult(m_currentSearchStr);
+        return;
+    }
+    if (filterList.isEmpty())
+        return;
+
+    bool isEmptyBefore = jList.isEmpty();
+    jList.insert(0, filterList, 0, filterList.size());
+    if (isEmptyBefore) {
+        createJournalTableStart(jList);
+        return;
+    }
+
+    insertJournalTable(jList, 0, filterList.count(), 0);
+}
+
+/**
+ * @brief DisplayContent::startJournalFollow 系统日志加载完成后,开启实时跟踪时从最新游标开始跟踪新日志
+ */
+void DisplayContent::startJournalFollow()
+{
+    if (!m_journalFollow || m_flag != JOURNAL || m_journalOlderWindow)
+        return;
+    m_journalFollowIndex = m_logFileParse.parseByJournalFollow(m_journalArgs, m_journalNewestCursor);
+}
+
+/**
+ * @brief DisplayContent::capJournalWindow 内存极度紧张时停止系统日志的加载,只保留已加载的最新一段,提示用户按需加载更早的日志
+ */
+void DisplayContent::capJournalWindow()
+{
+    m_journalWindowEnd = jListOrigin.at(jListOrigin.size() - 1).timestamp;
+    qCWarning(logDisplaycontent) << "memory critical, journal capped at" << jListOrigin.size() << "records";
+    m_logFileParse.stopAllLoad();
+    slot_journalFinished(m_journalCurrentIndex);
+
+    DFloatingMessage *message = new DFloatingMessage(DFloatingMessage::ResidentType, this->window());
+    message->setIcon(QIcon(QString(ICONPREFIX) + "warning_info.svg"));
+    message->setMessage(DApplication::translate("Warning", "Memory is low, only the latest %1 logs are loaded").arg(jListOrigin.size()));
+    QPushButton *button = new QPushButton(DApplication::translate("Button", "Load older logs"), message);
+    connect(button, &QPushButton::clicked, this, &DisplayContent::loadOlderJournal);
+    message->setWidget(button);
+    m_journalWindowMessage = message;
+    DMessageManager::instance()->sendMessage(this->window(), message);
+}
+
+/**
+ * @brief DisplayContent::loadOlderJournal 用已加载的最早记录之前的一段系统日志替换当前数据,同样受内存限制
+ */
+void DisplayContent::loadOlderJournal()
+{
+    if (m_flag != JOURNAL || m_journalWindowEnd <= 0)
+        return;
+    //原来的时间范围起点不变,终点移到已加载的最早记录之前
+    QStringList arg;
+    arg << m_journalArgs.value(0, "all");
+    bool timed = false;
+    if (m_journalArgs.size() >= 3) {
+        m_journalArgs.at(2).toULongLong(&timed);
+        if (timed)
+            m_journalArgs.at(1).toULongLong(&timed);
+    }
+    arg << (timed ? m_journalArgs.at(1) : QString("0")) << QString::number(m_journalWindowEnd - 1);
+    arg << m_loadedJournalMatches;
+
+    m_ingest.begin("journal");
+    m_firstLoadPageData = true;
+    clearAllDatalist();
+    m_journalOlderWindow = true;
+    m_isDataLoadComplete = false;
+    createJournalTableForm();
+    setLoadState(DATA_LOADING);
+    m_journalCurrentIndex = m_logFileParse.parseByJournal(arg);
+}
+
+/**
+ * @brief DisplayContent::setJournalFollow 开启或关闭系统日志实时跟踪
+ * @param follow 是否开启
+ */
+void DisplayContent::setJournalFollow(bool follow)
+{
+    m_journalFollow = follow;
+    updateFileFollow();
+    if (!follow) {
+        m_journalFollowIndex = -1;
+        emit m_logFileParse.stopJournalFollow();
+        return;
+    }
+    //当前系统日志已加载完成则立即开始跟踪,否则等加载完成后开始
+    if (m_flag == JOURNAL && m_isDataLoadComplete && !m_journalIncremental && m_journalFollowIndex < 0)
+        startJournalFollow();
+}
+
+/**
+ * @brief DisplayContent::journalFollowActive 当前是否正在实时跟踪系统日志,此时不需要定时刷新
+ */
+bool DisplayContent::journalFollowActive() const
+{
+    return m_journalFollow && m_flag == JOURNAL && m_journalFollowIndex > 0;
+}
+
+/**
+ * @brief DisplayContent::fileFollowActive 当前是否正在监视文本日志的变化,此时同样不需要定时刷新
+ */
+bool DisplayContent::fileFollowActive() const
+{
+    return m_journalFollow && m_fileChanges->isActive() && m_fileChanges->paths() == followPaths();
+}
+
+/**
+ * @brief DisplayContent::followPaths 当前类别写入的日志文件,实时跟踪时监视它们的变化;
+ * 不是从文本文件读取的类别(系统日志、dmesg、崩溃日志等)为空,仍按定时刷新
+ */
+QStringList DisplayContent::followPaths() const
+{
+    QString path;
+    switch (m_flag) {
+    case KERN:
+        if (!LogFileParser::kernFromJournal(QFileInfo::exists(KERN_TREE_DATA) ? QStringList() << KERN_TREE_DATA : QStringList()))
+            path = KERN_TREE_DATA;
+        break;
+    case DPKG:
+        path = DPKG_TREE_DATA;
+        break;
+    case XORG:
+        path = XORG_TREE_DATA;
+        break;
+    case Kwin:
+        path = KWIN_TREE_DATA;
+        break;
+    case BOOT:
+        path = BOOT_TREE_DATA;
+        break;
+    case Dnf:
+        path = DNF_TREE_DATA;
+        break;
+    case Audit:
+        path = AUDIT_TREE_DATA;
+        break;
+    case APP:
+        //应用日志也可能来自journal,只监视存在的文件
+        if (QFileInfo(m_curAppLog).isFile())
+            path = m_curAppLog;
+        break;
+    default:
+        break;
+    }
+    return path.isEmpty() ? QStringList() : QStringList() << path;
+}
+
+/**
+ * @brief DisplayContent::updateFileFollow 按当前类别和是否实时跟踪更新监视的文件
+ */
+void DisplayContent::updateFileFollow()
+{
+    m_fileChanges->setPaths(m_journalFollow ? followPaths() : QStringList());
+}
+
 /**
  * @brief DisplayContent::createJournalTableForm 系统日志表头项目创建和重置
  */
 void DisplayContent::createJournalTableForm()
 {
+    cancelCollapseSimilar();
     m_pModel->clear();
 
     m_pModel->setHorizontalHeaderLabels(
@@ -433,11 +1018,13 @@ void DisplayContent::createJournalTableForm()
  */
 void DisplayContent::generateDpkgFile(int id, const QString &iSearchStr)
 {
+    ensureTypeSetup(DPKG);
     Q_UNUSED(iSearchStr)
     dList.clear();
     dListOrigin.clear();
     clearAllFilter();
     clearAllDatalist();
+    m_ingest.begin("dpkg");
     setLoadState(DATA_LOADING);
     createDpkgTableForm();
     m_firstLoadPageData = true;
@@ -504,12 +1091,13 @@ void DisplayContent::generateDpkgFile(int id, const QString &iSearchStr)
  * @brief DisplayContent::createDpkgTable 获取系统日志完成时第一次加载数据的第一页到treeview中
  * @param list 获得的DPKG日志数据list
  */
-void DisplayContent::createDpkgTableStart(const QList<LOG_MSG_DPKG> &list)
+void DisplayContent::createDpkgTableStart(const LogRecordView<LOG_MSG_DPKG> &list)
 {
-    m_limitTag = 0;
     setLoadState(DATA_COMPLETE);
-    int end = list.count() > SINGLE_LOAD ? SINGLE_LOAD : list.count();
-    insertDpkgTable(list, 0, end);
+    //重新加载或重新搜索,dList从头开始,事务重新归纳
+    m_dpkgTransactions.clear();
+    m_dpkgExpanded.clear();
+    insertDpkgTable(list, 0, list.count());
     QItemSelectionModel *p = m_treeView->selectionModel();
     if (p)
         p->select(m_pModel->index(0, 0), QItemSelectionModel::Rows | QItemSelectionModel::Select);
@@ -519,13 +1107,12 @@ void DisplayContent::createDpkgTableStart(const QList<LOG_MSG_DPKG> &list)
 void DisplayContent::createDpkgTableForm()
 {
     m_pModel->clear();
-    m_pModel->setColumnCount(3);
-    m_treeView->setColumnWidth(0, DATETIME_WIDTH);
-    m_treeView->hideColumn(2);
     m_pModel->setHorizontalHeaderLabels(QStringList()
                                         << DApplication::translate("Table", "Date and Time")
                                         << DApplication::translate("Table", "Info")
                                         << DApplication::translate("Table", "Action"));
+    m_treeView->setColumnWidth(0, DATETIME_WIDTH);
+    m_treeView->hideColumn(2);
 }
 
 /**
@@ -535,11 +1122,13 @@ void DisplayContent::createDpkgTableForm()
  */
 void DisplayContent::generateKernFile(int id, const QString &iSearchStr)
 {
+    ensureTypeSetup(KERN);
     Q_UNUSED(iSearchStr)
     kList.clear();
     kListOrigin.clear();
     clearAllFilter();
     clearAllDatalist();
+    m_ingest.begin("kern");
     m_firstLoadPageData = true;
     m_isDataLoadComplete = false;
     setLoadState(DATA_LOADING);
@@ -599,6 +1188,70 @@ void DisplayContent::generateKernFile(int id, const QString &iSearchStr)
     default:
         break;
     }
+    m_kernFilter = kernFilter;
+    m_kernFilterId = id;
+    m_kernLoadDate = dt.date();
+}
+
+/**
+ * @brief DisplayContent::generateKernIncrement 增量刷新内核日志,只读取不早于已加载最新记录的日志,结束后插入到列表头部
+ */
+void DisplayContent::generateKernIncrement()
+{
+    m_kernIncremental = true;
+    m_kernIncrementList.clear();
+    KERN_FILTERS filter = m_kernFilter;
+    filter.timeFilterBegin = kListOrigin.at(0).timestamp / 1000;
+    if (filter.timeFilterEnd <= 0)
+        filter.timeFilterEnd = std::numeric_limits<qint64>::max();
+    m_kernCurrentIndex = m_logFileParse.parseByKern(filter);
+}
+
+/**
+ * @brief DisplayContent::mergeKernIncrement 去掉增量结果中已加载的记录后插入到头部,
+ * 时间只精确到秒,和最新记录同一秒的已加载记录也在结果中,位于结果末尾;对不上时(文件被轮转或改写)重新加载
+ * @param list 按从新到旧排列的增量结果
+ */
+void DisplayContent::mergeKernIncrement(const QList<LOG_MSG_JOURNAL> &list)
+{
+    const qint64 newest = kListOrigin.at(0).timestamp;
+    int same = 0;
+    while (same < kListOrigin.size() && kListOrigin.at(same).timestamp == newest)
+        ++same;
+    const int count = list.size() - same;
+    bool matched = count >= 0;
+    for (int i = 0; matched && i < same; ++i) {
+        const LOG_MSG_JOURNAL &loaded = kListOrigin.at(i);
+        const LOG_MSG_JOURNAL &read = list.at(count + i);
+        matched = read.timestamp == loaded.timestamp && read.msg == loaded.msg && read.daemonName == loaded.daemonName;
+    }
+    if (!matched) {
+        generateKernFile(m_kernFilterId);
+        return;
+    }
+    if (count == 0)
+        return;
+
+    kListOrigin.prepend(list.mid(0, count));
+    addAggregates(list, 0, count);
+    kList.offsetRows(count);
+    m_pModel->offsetRecords<LOG_MSG_JOURNAL>(count);
+    //正在进行的搜索返回的是旧下标,按新的数据重新搜索
+    if (m_searchIndex >= 0) {
+        slot_searchResult(m_currentSearchStr);
+        return;
+    }
+    const LogRecordView<LOG_MSG_JOURNAL> filterList = filterKern(m_currentSearchStr, LogRecordView<LOG_MSG_JOURNAL>::range(&kListOrigin, 0, count));
+    if (filterList.isEmpty())
+        return;
+
+    const bool isEmptyBefore = kList.isEmpty();
+    kList.insert(0, filterList, 0, filterList.size());
+    if (isEmptyBefore) {
+        createKernTable(kList);
+        return;
+    }
+    insertKernTable(kList, 0, filterList.count(), 0);
 }
 
 /**
@@ -606,6 +1259,7 @@ void DisplayContent::generateKernFile(int id, const QString &iSearchStr)
  */
 void DisplayContent::createKernTableForm()
 {
+    cancelCollapseSimilar();
     m_pModel->clear();
     m_pModel->setHorizontalHeaderLabels(QStringList()
                                         << DApplication::translate("Table", "Date and Time")
@@ -622,13 +1276,11 @@ void DisplayContent::createKernTableForm()
  * @param list 获得的内核日志数据list
  */
 // modified by Airy for bug  12263
-void DisplayContent::createKernTable(const QList<LOG_MSG_JOURNAL> &list)
+void DisplayContent::createKernTable(const LogRecordView<LOG_MSG_JOURNAL> &list)
 {
     setLoadState(DATA_COMPLETE);
 
-    m_limitTag = 0;
-    int end = list.count() > SINGLE_LOAD ? SINGLE_LOAD : list.count();
-    insertKernTable(list, 0, end);
+    insertKernTable(list, 0, list.count());
     QItemSelectionModel *p = m_treeView->selectionModel();
     if (p)
         p->select(m_pModel->index(0, 0), QItemSelectionModel::Rows | QItemSelectionModel::Select);
@@ -640,14 +1292,21 @@ void DisplayContent::createKernTable(const QList<LOG_MSG_JOURNAL> &list)
  * @param list 当前筛选状态下所有符合条件的内核日志数据结构
  * @param start 分页开始的数组下标
  * @param end 分页结束的数组下标
+ * @param row 插入到model中的位置,-1表示追加到末尾
  */
-void DisplayContent::insertKernTable(const QList<LOG_MSG_JOURNAL> &list, int start, int end)
+void DisplayContent::insertKernTable(const LogRecordView<LOG_MSG_JOURNAL> &list, int start, int end, int row)
 {
-    QList<LOG_MSG_JOURNAL> midList = list;
+    PERF_TRACE_SCOPE("model", "insertKernTable");
+    //折叠显示时新到的记录重新归纳
+    if (m_collapseSimilar) {
+        startCollapseSimilar();
+        return;
+    }
+    LogRecordView<LOG_MSG_JOURNAL> midList = list;
     if (end >= start) {
         midList = midList.mid(start, end - start);
     }
-    parseListToModel(midList, m_pModel);
+    parseListToModel(midList, m_pModel, row);
 }
 
 /**
@@ -656,72 +1315,86 @@ void DisplayContent::insertKernTable(const QList<LOG_MSG_JOURNAL> &list, int sta
  * @param start 分页开始的数组下标
  * @param end 分页结束的数组下标
  */
-void DisplayContent::insertDpkgTable(const QList<LOG_MSG_DPKG> &list, int start, int end)
+void DisplayContent::insertDpkgTable(const LogRecordView<LOG_MSG_DPKG> &list, int start, int end)
 {
-    QList<LOG_MSG_DPKG> midList = list;
+    PERF_TRACE_SCOPE("model", "insertDpkgTable");
+    //新追加到dList的行逐批归入事务,归组显示时重新显示摘要
+    m_dpkgTransactions.update(dList);
+    if (m_dpkgGrouped) {
+        showDpkgTransactions();
+        return;
+    }
+    LogRecordView<LOG_MSG_DPKG> midList = list;
     if (end >= start) {
         midList = midList.mid(start, end - start);
     }
     parseListToModel(midList, m_pModel);
 }
 
-void DisplayContent::insertXorgTable(const QList<LOG_MSG_XORG> &list, int start, int end)
+void DisplayContent::insertXorgTable(const LogRecordView<LOG_MSG_XORG> &list, int start, int end)
 {
-    QList<LOG_MSG_XORG> midList = list;
+    PERF_TRACE_SCOPE("model", "insertXorgTable");
+    LogRecordView<LOG_MSG_XORG> midList = list;
     if (end >= start) {
         midList = midList.mid(start, end - start);
     }
     parseListToModel(midList, m_pModel);
 }
 
-void DisplayContent::insertBootTable(const QList<LOG_MSG_BOOT> &list, int start, int end)
+void DisplayContent::insertBootTable(const LogRecordView<LOG_MSG_BOOT> &list, int start, int end)
 {
-    QList<LOG_MSG_BOOT> midList = list;
+    PERF_TRACE_SCOPE("model", "insertBootTable");
+    LogRecordView<LOG_MSG_BOOT> midList = list;
     if (end >= start) {
         midList = midList.mid(start, end - start);
     }
     parseListToModel(midList, m_pModel);
 }
 
-void DisplayContent::insertKwinTable(const QList<LOG_MSG_KWIN> &list, int start, int end)
+void DisplayContent::insertKwinTable(const LogRecordView<LOG_MSG_KWIN> &list, int start, int end, int row)
 {
-    QList<LOG_MSG_KWIN> midList = list;
+    PERF_TRACE_SCOPE("model", "insertKwinTable");
+    LogRecordView<LOG_MSG_KWIN> midList = list;
     if (end >= start) {
         midList = midList.mid(start, end - start);
     }
-    parseListToModel(midList, m_pModel);
+    parseListToModel(midList, m_pModel, row);
 }
 
-void DisplayContent::insertNormalTable(const QList<LOG_MSG_NORMAL> &list, int start, int end)
+void DisplayContent::insertNormalTable(const LogRecordView<LOG_MSG_NORMAL> &list, int start, int end)
 {
-    QList<LOG_MSG_NORMAL> midList = list;
+    PERF_TRACE_SCOPE("model", "insertNormalTable");
+    LogRecordView<LOG_MSG_NORMAL> midList = list;
     if (end >= start) {
         midList = midList.mid(start, end - start);
     }
     parseListToModel(midList, m_pModel);
 }
 
-void DisplayContent::insertOOCTable(const QList<LOG_FILE_OTHERORCUSTOM> &list, int start, int end)
+void DisplayContent::insertOOCTable(const LogRecordView<LOG_FILE_OTHERORCUSTOM> &list, int start, int end)
 {
-    QList<LOG_FILE_OTHERORCUSTOM> midList = list;
+    PERF_TRACE_SCOPE("model", "insertOOCTable");
+    LogRecordView<LOG_FILE_OTHERORCUSTOM> midList = list;
     if (end >= start) {
         midList = midList.mid(start, end - start);
     }
     parseListToModel(midList, m_pModel);
 }
 
-void DisplayContent::insertAuditTable(const QList<LOG_MSG_AUDIT> &list, int start, int end)
+void DisplayContent::insertAuditTable(const LogRecordView<LOG_MSG_AUDIT> &list, int start, int end)
 {
-    QList<LOG_MSG_AUDIT> midList = list;
+    PERF_TRACE_SCOPE("model", "insertAuditTable");
+    LogRecordView<LOG_MSG_AUDIT> midList = list;
     if (end >= start) {
         midList = midList.mid(start, end - start);
     }
     parseListToModel(midList, m_pModel);
 }
 
-void DisplayContent::insertCoredumpTable(const QList<LOG_MSG_COREDUMP> &list, int start, int end)
+void DisplayContent::insertCoredumpTable(const LogRecordView<LOG_MSG_COREDUMP> &list, int start, int end)
 {
-    QList<LOG_MSG_COREDUMP> midList = list;
+    PERF_TRACE_SCOPE("model", "insertCoredumpTable");
+    LogRecordView<LOG_MSG_COREDUMP> midList = list;
     if (end >= start) {
         midList = midList.mid(start, end - start);
     }
@@ -737,11 +1410,13 @@ void DisplayContent::insertCoredumpTable(const QList<LOG_MSG_COREDUMP> &list, in
  */
 void DisplayContent::generateAppFile(const QString &path, int id, int lId, const QString &iSearchStr)
 {
+    ensureTypeSetup(APP);
     Q_UNUSED(iSearchStr)
     appList.clear();
     appListOrigin.clear();
     clearAllFilter();
     clearAllDatalist();
+    m_ingest.begin("app");
     setLoadState(DATA_LOADING);
     m_firstLoadPageData = true;
     m_isDataLoadComplete = false;
@@ -826,12 +1501,10 @@ void DisplayContent::createAppTableForm()
  * @brief DisplayContent::createAppTable 获取应用日志完成时第一次加载数据的第一页到treeview中
  * @param list 获得的应用日志数据list
  */
-void DisplayContent::createAppTable(const QList<LOG_MSG_APPLICATOIN> &list)
+void DisplayContent::createAppTable(const LogRecordView<LOG_MSG_APPLICATOIN> &list)
 {
-    m_limitTag = 0;
     setLoadState(DATA_COMPLETE);
-    int end = list.count() > SINGLE_LOAD ? SINGLE_LOAD : list.count();
-    insertApplicationTable(list, 0, end);
+    insertApplicationTable(list, 0, list.count());
     QItemSelectionModel *p = m_treeView->selectionModel();
     if (p)
         p->select(m_pModel->index(0, 0), QItemSelectionModel::Rows | QItemSelectionModel::Select);
@@ -842,13 +1515,10 @@ void DisplayContent::createAppTable(const QList<LOG_MSG_APPLICATOIN> &list)
  * @brief DisplayContent::createBootTable 获取启动日志完成时加载所有数据到treeview中
  * @param list 获得的启动日志数据list
  */
-void DisplayContent::createBootTable(const QList<LOG_MSG_BOOT> &list)
+void DisplayContent::createBootTable(const LogRecordView<LOG_MSG_BOOT> &list)
 {
-    m_limitTag = 0;
-
     setLoadState(DATA_COMPLETE);
-    int end = list.count() > SINGLE_LOAD ? SINGLE_LOAD : list.count();
-    insertBootTable(list, 0, end);
+    insertBootTable(list, 0, list.count());
     QItemSelectionModel *p = m_treeView->selectionModel();
     if (p)
         p->select(m_pModel->index(0, 0), QItemSelectionModel::Rows | QItemSelectionModel::Select);
@@ -857,11 +1527,13 @@ void DisplayContent::createBootTable(const QList<LOG_MSG_BOOT> &list)
 
 void DisplayContent::generateBootFile()
 {
+    ensureTypeSetup(BOOT);
     bList.clear();
     currentBootList.clear();
     setLoadState(DATA_LOADING);
     clearAllFilter();
     clearAllDatalist();
+    m_ingest.begin("boot");
     m_firstLoadPageData = true;
     m_isDataLoadComplete = false;
     createBootTableForm();
@@ -871,7 +1543,6 @@ void DisplayContent::generateBootFile()
 void DisplayContent::createXorgTableForm()
 {
     m_pModel->clear();
-    m_pModel->setColumnCount(2);
     m_pModel->setHorizontalHeaderLabels(QStringList()
                                         << DApplication::translate("Table", "Offset")
                                         << DApplication::translate("Table", "Info"));
@@ -882,12 +1553,10 @@ void DisplayContent::createXorgTableForm()
  * @brief DisplayContent::createXorgTable 获取Xorg日志完成时加载所有数据到treeview中
  * @param list 获得的Xorg日志数据list
  */
-void DisplayContent::createXorgTable(const QList<LOG_MSG_XORG> &list)
+void DisplayContent::createXorgTable(const LogRecordView<LOG_MSG_XORG> &list)
 {
-    m_limitTag = 0;
     setLoadState(DATA_COMPLETE);
-    int end = list.count() > SINGLE_LOAD ? SINGLE_LOAD : list.count();
-    insertXorgTable(list, 0, end);
+    insertXorgTable(list, 0, list.count());
     QItemSelectionModel *p = m_treeView->selectionModel();
     if (p)
         p->select(m_pModel->index(0, 0), QItemSelectionModel::Rows | QItemSelectionModel::Select);
@@ -900,9 +1569,11 @@ void DisplayContent::createXorgTable(const QList<LOG_MSG_XORG> &list)
  */
 void DisplayContent::generateXorgFile(int id)
 {
+    ensureTypeSetup(XORG);
     clearAllFilter();
     xList.clear();
     clearAllDatalist();
+    m_ingest.begin("xorg");
     xListOrigin.clear();
     setLoadState(DATA_LOADING);
     QDateTime dt = QDateTime::currentDateTime();
@@ -968,7 +1639,6 @@ void DisplayContent::generateXorgFile(int id)
 void DisplayContent::createKwinTableForm()
 {
     m_pModel->clear();
-    m_pModel->setColumnCount(1);
     m_pModel->setHorizontalHeaderLabels(QStringList()
                                         << DApplication::translate("Table", "Info"));
 }
@@ -977,39 +1647,101 @@ void DisplayContent::createKwinTableForm()
  * @brief DisplayContent::creatKwinTable 获取kwin日志完成时加载所有数据到treeview中
  * @param list 获得的kwin日志数据list
  */
-void DisplayContent::creatKwinTable(const QList<LOG_MSG_KWIN> &list)
+void DisplayContent::creatKwinTable(const LogRecordView<LOG_MSG_KWIN> &list)
 {
-    m_limitTag = 0;
     setLoadState(DATA_COMPLETE);
-    int end = list.count() > SINGLE_LOAD ? SINGLE_LOAD : list.count();
-    insertKwinTable(list, 0, end);
+    insertKwinTable(list, 0, list.count());
     QItemSelectionModel *p = m_treeView->selectionModel();
     if (p)
         p->select(m_pModel->index(0, 0), QItemSelectionModel::Rows | QItemSelectionModel::Select);
     slot_tableItemClicked(m_pModel->index(0, 0));
 }
 
-/**
- * @brief DisplayContent::generateKwinFile 触发获取Kwin日志数据线程
- * @param iFilters 获取线程筛选条件结构体
- */
-void DisplayContent::generateKwinFile(const KWIN_FILTERS &iFilters)
-{
-    clearAllFilter();
-    clearAllDatalist();
-    m_kwinList.clear();
-    m_currentKwinList.clear();
-    m_firstLoadPageData = true;
-    m_isDataLoadComplete = false;
-    setLoadState(DATA_LOADING);
-    createKwinTableForm();
-    m_kwinCurrentIndex = m_logFileParse.parseByKwin(iFilters);
+/**
+ * @brief DisplayContent::generateKwinFile 触发获取Kwin日志数据线程
+ * @param iFilters 获取线程筛选条件结构体
+ */
+void DisplayContent::generateKwinFile(const KWIN_FILTERS &iFilters)
+{
+    ensureTypeSetup(Kwin);
+    clearAllFilter();
+    clearAllDatalist();
+    m_ingest.begin("kwin");
+    m_kwinList.clear();
+    m_currentKwinList.clear();
+    m_firstLoadPageData = true;
+    m_isDataLoadComplete = false;
+    setLoadState(DATA_LOADING);
+    createKwinTableForm();
+    //从头读取,记下读取到的位置供之后增量刷新
+    KWIN_FILTERS filter = iFilters;
+    m_kwinTail = std::make_shared<LogTailPosition>();
+    filter.tail = m_kwinTail;
+    m_kwinCurrentIndex = m_logFileParse.parseByKwin(filter);
+}
+
+/**
+ * @brief DisplayContent::generateKwinIncrement 增量刷新kwin日志,只读取上次读取位置之后追加的行,结束后插入到列表头部
+ */
+void DisplayContent::generateKwinIncrement()
+{
+    m_kwinIncremental = true;
+    m_kwinIncrementList.clear();
+    KWIN_FILTERS filter = m_currentKwinFilter;
+    filter.tail = m_kwinTail;
+    m_kwinCurrentIndex = m_logFileParse.parseByKwin(filter);
+}
+
+/**
+ * @brief DisplayContent::mergeKwinIncrement 把增量结果插入到头部;文件被轮转或截断时获取线程已从头读取,此时用结果替换全部日志
+ * @param list 按从新到旧排列的新追加的日志,从头读取时为整个文件的日志
+ */
+void DisplayContent::mergeKwinIncrement(const QList<LOG_MSG_KWIN> &list)
+{
+    if (!m_kwinTail) {
+        generateKwinFile(m_currentKwinFilter);
+        return;
+    }
+    if (m_kwinTail->rescanned) {
+        //从头读取的结果就是完整的加载,不再重新读取一遍文件
+        const std::shared_ptr<LogTailPosition> tail = m_kwinTail;
+        clearAllDatalist();
+        m_kwinTail = tail;
+        m_kwinList.clear();
+        m_currentKwinList.clear();
+        createKwinTableForm();
+        m_kwinList.append(list);
+        m_currentKwinList = filterKwin(m_currentSearchStr, LogRecordView<LOG_MSG_KWIN>::all(&m_kwinList));
+        creatKwinTable(m_currentKwinList);
+        return;
+    }
+    const int count = list.size();
+    if (count == 0)
+        return;
+
+    m_kwinList.prepend(list);
+    m_currentKwinList.offsetRows(count);
+    m_pModel->offsetRecords<LOG_MSG_KWIN>(count);
+    if (m_searchIndex >= 0) {
+        slot_searchResult(m_currentSearchStr);
+        return;
+    }
+    const LogRecordView<LOG_MSG_KWIN> filterList = filterKwin(m_currentSearchStr, LogRecordView<LOG_MSG_KWIN>::range(&m_kwinList, 0, count));
+    if (filterList.isEmpty())
+        return;
+
+    const bool isEmptyBefore = m_currentKwinList.isEmpty();
+    m_currentKwinList.insert(0, filterList, 0, filterList.size());
+    if (isEmptyBefore) {
+        creatKwinTable(m_currentKwinList);
+        return;
+    }
+    insertKwinTable(m_currentKwinList, 0, filterList.count(), 0);
 }
 
 void DisplayContent::createNormalTableForm()
 {
     m_pModel->clear();
-    m_pModel->setColumnCount(4);
     m_pModel->setHorizontalHeaderLabels(QStringList()
                                         << DApplication::translate("Table", "Event Type")
                                         << DApplication::translate("Table", "Username")
@@ -1025,13 +1757,11 @@ void DisplayContent::createNormalTableForm()
  * @brief DisplayContent::createNormalTable 开关机日志表头项目创建和重置
  * @param list
  */
-void DisplayContent::createNormalTable(const QList<LOG_MSG_NORMAL> &list)
+void DisplayContent::createNormalTable(const LogRecordView<LOG_MSG_NORMAL> &list)
 {
     setLoadState(DATA_COMPLETE);
 
-    m_limitTag = 0;
-    int end = list.count() > SINGLE_LOAD ? SINGLE_LOAD : list.count();
-    insertNormalTable(list, 0, end);
+    insertNormalTable(list, 0, list.count());
     QItemSelectionModel *p = m_treeView->selectionModel();
     if (p)
         p->select(m_pModel->index(0, 0), QItemSelectionModel::Rows | QItemSelectionModel::Select);
@@ -1045,8 +1775,10 @@ void DisplayContent::createNormalTable(const QList<LOG_MSG_NORMAL> &list)
 // add by Airy
 void DisplayContent::generateNormalFile(int id)
 {
+    ensureTypeSetup(Normal);
     clearAllFilter();
     clearAllDatalist();
+    m_ingest.begin("normal");
     norList.clear();
     nortempList.clear();
     setLoadState(DATA_LOADING);
@@ -1098,7 +1830,7 @@ void DisplayContent::generateNormalFile(int id)
     default:
         break;
     }
-    nortempList = norList;
+    nortempList = LogRecordView<LOG_MSG_NORMAL>::all(&norList);
 }
 
 /**
@@ -1106,50 +1838,47 @@ void DisplayContent::generateNormalFile(int id)
  * @param logList 当前筛选状态下所有符合条件的系统日志数据结构
  * @param start 分页开始的数组下标
  * @param end 分页结束的数组下标
+ * @param row 插入到model中的行号,-1表示追加到末尾
  */
-void DisplayContent::insertJournalTable(QList<LOG_MSG_JOURNAL> logList, int start, int end)
-{
-    DStandardItem *item = nullptr;
-    QList<QStandardItem *> items;
-    for (int i = start; i < end; i++) {
-        items.clear();
-        item = new DStandardItem();
-        QString iconPath = m_iconPrefix + getIconByname(logList[i].level);
-
-        if (getIconByname(logList[i].level).isEmpty())
-            item->setText(logList[i].level);
-        item->setIcon(QIcon(iconPath));
-        item->setData(JOUR_TABLE_DATA);
-        item->setData(logList[i].level, Log_Item_SPACE::levelRole);
-        item->setAccessibleText(QString("treeview_context_%1_%2").arg(i).arg(0));
-        items << item;
-        item = new DStandardItem(logList[i].daemonName);
-        item->setData(JOUR_TABLE_DATA);
-        item->setAccessibleText(QString("treeview_context_%1_%2").arg(i).arg(1));
-        items << item;
-        item = new DStandardItem(logList[i].dateTime);
-        item->setData(JOUR_TABLE_DATA);
-//        item->setData(getTimeFromString(logList[i].dateTime), Qt::UserRole + 2);
-        item->setAccessibleText(QString("treeview_context_%1_%2").arg(i).arg(2));
-        items << item;
-        item = new DStandardItem(logList[i].msg);
-        item->setData(JOUR_TABLE_DATA);
-        item->setAccessibleText(QString("treeview_context_%1_%2").arg(i).arg(3));
-        items << item;
-        item = new DStandardItem(logList[i].hostName);
-        item->setData(JOUR_TABLE_DATA);
-        item->setAccessibleText(QString("treeview_context_%1_%2").arg(i).arg(4));
-        items << item;
-        item = new DStandardItem(logList[i].daemonId);
-        item->setData(JOUR_TABLE_DATA);
-        item->setAccessibleText(QString("treeview_context_%1_%2").arg(i).arg(5));
-        items << item;
-        m_pModel->insertRow(m_pModel->rowCount(), items);
+void DisplayContent::insertJournalTable(const LogRecordView<LOG_MSG_JOURNAL> &logList, int start, int end, int row)
+{
+    PERF_TRACE_SCOPE("model", "insertJournalTable");
+    if (m_collapseSimilar) {
+        startCollapseSimilar();
+        return;
     }
+    m_pModel->setColumns(JOUR_TABLE_DATA, journalColumns());
+    m_pModel->insertRecords(row, logList, start, end);
     m_treeView->hideColumn(JOURNAL_SPACE::journalHostNameColumn);
     m_treeView->hideColumn(JOURNAL_SPACE::journalDaemonIdColumn);
 }
 
+/**
+ * @brief DisplayContent::journalColumns 系统日志和klu下启动日志共用的列定义
+ * @return 等级、进程、时间、信息、用户、PID六列
+ */
+QVector<LogTableModel::Column<LOG_MSG_JOURNAL>> DisplayContent::journalColumns()
+{
+    return {
+        LogTableModel::sortKeyColumn<LOG_MSG_JOURNAL>([this](const LOG_MSG_JOURNAL &record, int role) -> QVariant {
+            const QString text = LogLevel::text(record.level);
+            return levelData(m_iconPrefix, levelIcon(record.level), text, text, role);
+        }, [](const LOG_MSG_JOURNAL &record) { return levelOrder(record.level); }),
+        textColumn(&LOG_MSG_JOURNAL::daemonName),
+        LogTableModel::sortKeyColumn<LOG_MSG_JOURNAL>(textColumn(&LOG_MSG_JOURNAL::dateTime), [](const LOG_MSG_JOURNAL &record) {
+            return record.timestamp;
+        }),
+        [](const LOG_MSG_JOURNAL &record, int role) -> QVariant {
+            //信息被截断时记下游标,选中时再读取完整内容
+            if (role == Log_Item_SPACE::journalCursorRole)
+                return record.cursor.isEmpty() ? QVariant() : QVariant(record.cursor);
+            return role == Qt::DisplayRole ? QVariant(record.message()) : QVariant();
+        },
+        textColumn(&LOG_MSG_JOURNAL::hostName),
+        numberColumn(&LOG_MSG_JOURNAL::daemonId)
+    };
+}
+
 /**
  * @brief DisplayContent::getAppName 获取当前选择的应用的日志路径对应的日志名称
  * @param filePath  当前选择的应用的日志路径
@@ -1192,10 +1921,12 @@ bool DisplayContent::isAuthProcessAlive()
  */
 void DisplayContent::generateJournalBootFile(int lId, const QString &iSearchStr)
 {
+    ensureTypeSetup(BOOT_KLU);
     Q_UNUSED(iSearchStr)
     m_firstLoadPageData = true;
     clearAllFilter();
     clearAllDatalist();
+    m_ingest.begin("journalBoot");
     m_isDataLoadComplete = false;
     createJournalBootTableForm();
     setLoadState(DATA_LOADING);
@@ -1208,7 +1939,7 @@ void DisplayContent::generateJournalBootFile(int lId, const QString &iSearchStr)
     } else {
         arg.append("all");
     }
-    m_journalBootCurrentIndex = m_logFileParse.parseByJournalBoot(arg);
+    m_journalBootCurrentIndex = m_logFileParse.parseByJournalBoot(arg, m_curBootId);
     // default first row select
     m_treeView->setColumnWidth(JOURNAL_SPACE::journalLevelColumn, LEVEL_WIDTH);
     m_treeView->setColumnWidth(JOURNAL_SPACE::journalDaemonNameColumn, DEAMON_WIDTH);
@@ -1219,12 +1950,10 @@ void DisplayContent::generateJournalBootFile(int lId, const QString &iSearchStr)
  * @brief DisplayContent::createJournalBootTableStart 获取klu下启动日志完成时第一次加载数据的第一页到treeview中
  * @param list klu下启动日志数据list
  */
-void DisplayContent::createJournalBootTableStart(const QList<LOG_MSG_JOURNAL> &list)
+void DisplayContent::createJournalBootTableStart(const LogRecordView<LOG_MSG_JOURNAL> &list)
 {
-    m_limitTag = 0;
     setLoadState(DATA_COMPLETE);
-    int end = list.count() > SINGLE_LOAD ? SINGLE_LOAD : list.count();
-    insertJournalBootTable(list, 0, end);
+    insertJournalBootTable(list, 0, list.count());
 }
 
 /**
@@ -1251,43 +1980,11 @@ void DisplayContent::createJournalBootTableForm()
  * @param start 分页开始的数组下标
  * @param end 分页结束的数组下标
  */
-void DisplayContent::insertJournalBootTable(QList<LOG_MSG_JOURNAL> logList, int start, int end)
-{
-    DStandardItem *item = new DStandardItem();
-    QList<QStandardItem *> items;
-    for (int i = start; i < end; i++) {
-        items.clear();
-        QString iconPath = m_iconPrefix + getIconByname(logList[i].level);
-
-        if (getIconByname(logList[i].level).isEmpty())
-            item->setText(logList[i].level);
-        item->setIcon(QIcon(iconPath));
-        item->setData(BOOT_KLU_TABLE_DATA);
-        item->setData(logList[i].level, Log_Item_SPACE::levelRole);
-        item->setAccessibleText(QString("treeview_context_%1_%2").arg(i).arg(0));
-        items << item;
-        item = new DStandardItem(logList[i].daemonName);
-        item->setData(BOOT_KLU_TABLE_DATA);
-        item->setAccessibleText(QString("treeview_context_%1_%2").arg(i).arg(1));
-        items << item;
-        item = new DStandardItem(logList[i].dateTime);
-        item->setData(BOOT_KLU_TABLE_DATA);
-        item->setAccessibleText(QString("treeview_context_%1_%2").arg(i).arg(2));
-        items << item;
-        item = new DStandardItem(logList[i].msg);
-        item->setData(BOOT_KLU_TABLE_DATA);
-        item->setAccessibleText(QString("treeview_context_%1_%2").arg(i).arg(3));
-        items << item;
-        item = new DStandardItem(logList[i].hostName);
-        item->setData(BOOT_KLU_TABLE_DATA);
-        item->setAccessibleText(QString("treeview_context_%1_%2").arg(i).arg(4));
-        items << item;
-        item = new DStandardItem(logList[i].daemonId);
-        item->setData(BOOT_KLU_TABLE_DATA);
-        item->setAccessibleText(QString("treeview_context_%1_%2").arg(i).arg(5));
-        items << item;
-        m_pModel->insertRow(m_pModel->rowCount(), items);
-    }
+void DisplayContent::insertJournalBootTable(const LogRecordView<LOG_MSG_JOURNAL> &logList, int start, int end)
+{
+    PERF_TRACE_SCOPE("model", "insertJournalBootTable");
+    m_pModel->setColumns(BOOT_KLU_TABLE_DATA, journalColumns());
+    m_pModel->insertRecords(-1, logList, start, end);
     m_treeView->hideColumn(JOURNAL_SPACE::journalHostNameColumn);
     m_treeView->hideColumn(JOURNAL_SPACE::journalDaemonIdColumn);
 
@@ -1300,8 +1997,12 @@ void DisplayContent::insertJournalBootTable(QList<LOG_MSG_JOURNAL> logList, int
 
 void DisplayContent::generateDnfFile(BUTTONID iDate, DNFPRIORITY iLevel)
 {
+    ensureTypeSetup(Dnf);
     clearAllFilter();
     clearAllDatalist();
+    m_ingest.begin("dnf");
+    m_firstLoadPageData = true;
+    m_isDataLoadComplete = false;
     setLoadState(DATA_LOADING);
     createDnfForm();
     QDateTime dt = QDateTime::currentDateTime();
@@ -1335,15 +2036,13 @@ void DisplayContent::generateDnfFile(BUTTONID iDate, DNFPRIORITY iLevel)
     default:
         break;
     }
-    m_logFileParse.parseByDnf(dnffilter);
+    m_dnfCurrentIndex = m_logFileParse.parseByDnf(dnffilter);
 }
 
-void DisplayContent::createDnfTable(const QList<LOG_MSG_DNF> &list)
+void DisplayContent::createDnfTable(const LogRecordView<LOG_MSG_DNF> &list)
 {
-    m_limitTag = 0;
     setLoadState(DATA_COMPLETE);
-    int end = list.count() > SINGLE_LOAD ? SINGLE_LOAD : list.count();
-    insertDnfTable(list, 0, end);
+    insertDnfTable(list, 0, list.count());
     QItemSelectionModel *p = m_treeView->selectionModel();
     if (p)
         p->select(m_pModel->index(0, 0), QItemSelectionModel::Rows | QItemSelectionModel::Select);
@@ -1352,8 +2051,12 @@ void DisplayContent::createDnfTable(const QList<LOG_MSG_DNF> &list)
 
 void DisplayContent::generateDmesgFile(BUTTONID iDate, PRIORITY iLevel)
 {
+    ensureTypeSetup(Dmesg);
     clearAllFilter();
     clearAllDatalist();
+    m_ingest.begin("dmesg");
+    m_firstLoadPageData = true;
+    m_isDataLoadComplete = false;
     setLoadState(DATA_LOADING);
     createDmesgForm();
     QDateTime dt = QDateTime::currentDateTime();
@@ -1387,15 +2090,13 @@ void DisplayContent::generateDmesgFile(BUTTONID iDate, PRIORITY iLevel)
     default:
         break;
     }
-    m_logFileParse.parseByDmesg(dmesgfilter);
+    m_dmesgCurrentIndex = m_logFileParse.parseByDmesg(dmesgfilter);
 }
 
-void DisplayContent::createDmesgTable(const QList<LOG_MSG_DMESG> &list)
+void DisplayContent::createDmesgTable(const LogRecordView<LOG_MSG_DMESG> &list)
 {
-    m_limitTag = 0;
     setLoadState(DATA_COMPLETE);
-    int end = list.count() > SINGLE_LOAD ? SINGLE_LOAD : list.count();
-    insertDmesgTable(list, 0, end);
+    insertDmesgTable(list, 0, list.count());
     QItemSelectionModel *p = m_treeView->selectionModel();
     if (p)
         p->select(m_pModel->index(0, 0), QItemSelectionModel::Rows | QItemSelectionModel::Select);
@@ -1426,18 +2127,20 @@ void DisplayContent::createDmesgForm()
     m_treeView->hideColumn(3);
 }
 
-void DisplayContent::insertDmesgTable(const QList<LOG_MSG_DMESG> &list, int start, int end)
+void DisplayContent::insertDmesgTable(const LogRecordView<LOG_MSG_DMESG> &list, int start, int end)
 {
-    QList<LOG_MSG_DMESG> midList = list;
+    PERF_TRACE_SCOPE("model", "insertDmesgTable");
+    LogRecordView<LOG_MSG_DMESG> midList = list;
     if (end >= start) {
         midList = midList.mid(start, end - start);
     }
     parseListToModel(midList, m_pModel);
 }
 
-void DisplayContent::insertDnfTable(const QList<LOG_MSG_DNF> &list, int start, int end)
+void DisplayContent::insertDnfTable(const LogRecordView<LOG_MSG_DNF> &list, int start, int end)
 {
-    QList<LOG_MSG_DNF> midList = list;
+    PERF_TRACE_SCOPE("model", "insertDnfTable");
+    LogRecordView<LOG_MSG_DNF> midList = list;
     if (end >= start) {
         midList = midList.mid(start, end - start);
     }
@@ -1461,11 +2164,89 @@ void DisplayContent::slot_tableItemClicked(const QModelIndex &index)
     m_curTreeIndex = index;
 
     if (m_flag == OtherLog || m_flag == CustomLog) {
-        QString path = m_pModel->item(index.row(), 0)->data(Qt::UserRole + 2).toString();
+        QString path = m_pModel->index(index.row(), 0).data(Qt::UserRole + 2).toString();
         generateOOCFile(path);
     } else {
+        if (m_flag == JOURNAL)
+            loadJournalMessage(index.row());
         emit sigDetailInfo(index, m_pModel, getAppName(m_curAppLog));
+        //字段先显示,堆栈读取后再显示在详情下方
+        if (m_flag == COREDUMP)
+            loadCoredumpStack(index.row());
+    }
+}
+
+/**
+ * @brief DisplayContent::loadJournalMessage 系统日志信息被截断时,在线程池中通过游标读取完整信息填入表格
+ * @param row 表格行号
+ */
+void DisplayContent::loadJournalMessage(int row)
+{
+    QModelIndex index = m_pModel->index(row, JOURNAL_SPACE::journalMsgColumn);
+    if (!index.isValid())
+        return;
+    const QByteArray cursor = index.data(Log_Item_SPACE::journalCursorRole).toByteArray();
+    if (cursor.isEmpty())
+        return;
+
+    QFutureWatcher<QString> *watcher = new QFutureWatcher<QString>(this);
+    connect(watcher, &QFutureWatcher<QString>::finished, this, [this, watcher, row, cursor]() {
+        const QString message = watcher->result();
+        watcher->deleteLater();
+        //读取期间表格被重建或在头部插入了新日志时,这一行已经不是这条记录
+        QModelIndex index = m_pModel->index(row, JOURNAL_SPACE::journalMsgColumn);
+        if (m_flag != JOURNAL || !index.isValid() || index.data(Log_Item_SPACE::journalCursorRole).toByteArray() != cursor)
+            return;
+        if (!message.isEmpty())
+            m_pModel->setData(index, message);
+        //用空游标覆盖,避免再次读取
+        m_pModel->setData(index, QByteArray(), Log_Item_SPACE::journalCursorRole);
+        //仍选中这条记录时用完整信息刷新详情
+        if (!message.isEmpty() && m_curTreeIndex.isValid() && m_curTreeIndex.row() == row)
+            emit sigDetailInfo(m_curTreeIndex, m_pModel, getAppName(m_curAppLog));
+    });
+    watcher->setFuture(LogWorkScheduler::instance()->run(LogWorkScheduler::Interactive, [cursor]() {
+        return JournalMessageResolver().message(cursor);
+    }));
+}
+
+/**
+ * @brief DisplayContent::loadCoredumpStack 打开崩溃日志详情时,在线程池中通过游标读取堆栈信息并按页显示
+ * 堆栈不存入表格,最近查看过的几条保留在m_coredumpStacks中
+ * @param row 表格行号
+ */
+void DisplayContent::loadCoredumpStack(int row)
+{
+    QModelIndex index = m_pModel->index(row, COREDUMP_SPACE::COREDUMP_EXE_COLUMN);
+    if (!index.isValid())
+        return;
+    const QByteArray cursor = index.data(Log_Item_SPACE::journalCursorRole).toByteArray();
+    if (cursor.isEmpty())
+        return;
+
+    if (m_coredumpStackCanRun)
+        *m_coredumpStackCanRun = false;
+    const int request = ++m_coredumpStackRequest;
+    for (const auto &cached : m_coredumpStacks) {
+        if (cached.first == cursor) {
+            m_detailWgt->showCoredumpStack(cached.second);
+            return;
+        }
     }
+
+    m_coredumpStackCanRun = std::make_shared<std::atomic_bool>(true);
+    LogCoredumpStackWork *work = new LogCoredumpStackWork(request, cursor, index.data(Qt::UserRole + 2).toString(), m_coredumpStackCanRun);
+    connect(work, &LogCoredumpStackWork::stackReady, this, [this](int request, QByteArray cursor, LogTextSourcePtr source) {
+        m_coredumpStacks.prepend(qMakePair(cursor, source));
+        while (m_coredumpStacks.size() > COREDUMP_STACK_CACHE_COUNT)
+            m_coredumpStacks.removeLast();
+        //读取期间选中了其他记录或切换了日志类型时只缓存,不显示
+        if (request != m_coredumpStackRequest || m_flag != COREDUMP || !m_curTreeIndex.isValid()
+                || m_pModel->index(m_curTreeIndex.row(), COREDUMP_SPACE::COREDUMP_EXE_COLUMN).data(Log_Item_SPACE::journalCursorRole).toByteArray() != cursor)
+            return;
+        m_detailWgt->showCoredumpStack(source);
+    });
+    LogWorkScheduler::instance()->start(work, LogWorkScheduler::Interactive);
 }
 
 /**
@@ -1617,6 +2398,7 @@ void DisplayContent::slot_logCatelogueClicked(const QModelIndex &index)
     } else if (itemData.contains(COREDUMP_TREE_DATA, Qt::CaseInsensitive)) {
         m_flag = COREDUMP;
     }
+    m_prefetcher->recordVisit(m_flag);
 }
 
 /**
@@ -1644,7 +2426,7 @@ void DisplayContent::slot_exportClicked()
         fileName = DFileDialog::getSaveFileName(
                     this, DApplication::translate("File", "Export File"),
                     path,
-                    tr("TEXT (*.txt);; Doc (*.doc);; Xls (*.xls);; Html (*.html))"), &selectFilter);
+                    tr("TEXT (*.txt);; TEXT gzip (*.txt.gz);; NDJSON (*.ndjson);; NDJSON gzip (*.ndjson.gz);; Doc (*.doc);; Xls (*.xls);; Html (*.html))"), &selectFilter);
     } else {
         path = QStandardPaths::writableLocation(QStandardPaths::DesktopLocation) + logName + ".zip";
         fileName = DFileDialog::getSaveFileName(
@@ -1670,8 +2452,9 @@ void DisplayContent::slot_exportClicked()
     //限制当导出文件为空和导出doc和xls时用户改动后缀名导致导出问题，提示导出失败
     QFileInfo exportFile(fileName);
 
-    QString exportSuffix = exportFile.suffix();
-    QString selectSuffix = selectFilter.mid(selectFilter.lastIndexOf(".") + 1, selectFilter.size() - selectFilter.lastIndexOf(".") - 2);
+    //过滤器的后缀可能有多段,如txt.gz
+    const int suffixStart = selectFilter.indexOf("*.") + 2;
+    QString selectSuffix = selectFilter.mid(suffixStart, selectFilter.indexOf(")", suffixStart) - suffixStart);
     if (fileName.isEmpty()) {
         exportThread->sigResult(false);
         delete exportThread;
@@ -1679,245 +2462,253 @@ void DisplayContent::slot_exportClicked()
     }
 
     //用户修改后缀名后添加默认的后缀
-    if (selectSuffix != exportSuffix) {
-        fileName.append(".").append(selectSuffix);
+    if (!exportFile.fileName().endsWith("." + selectSuffix)) {
+        //已有的后缀是所选后缀的前一段时只补上后面的部分,如a.txt选择txt.gz时为a.txt.gz
+        const QString exportSuffix = exportFile.suffix();
+        if (!exportSuffix.isEmpty() && selectSuffix.startsWith(exportSuffix + "."))
+            fileName.append(selectSuffix.mid(exportSuffix.size()));
+        else
+            fileName.append(".").append(selectSuffix);
     }
 
     m_exportDlg->show();
+    setPrefetchPaused(true);
     QStringList labels;
     for (int col = 0; col < m_pModel->columnCount(); ++col) {
-        labels.append(m_pModel->horizontalHeaderItem(col)->text());
+        labels.append(m_pModel->headerData(col, Qt::Horizontal).toString());
     }
     //根据导出格式判断执行逻辑
-    if (selectFilter.contains("(*.txt)")) {
+    //txt.gz、ndjson和txt的导出逻辑相同,按文件名后缀决定每行的格式和是否边导出边压缩
+    if (selectFilter.contains("(*.txt)") || selectFilter.contains("(*.txt.gz)")
+            || selectFilter.contains("(*.ndjson)") || selectFilter.contains("(*.ndjson.gz)")) {
         switch (m_flag) {
         //根据导出日志类型执行正确的导出逻辑
         case JOURNAL:
             PERF_PRINT_BEGIN("POINT-04", QString("format=txt count=%1").arg(jList.count()));
-            exportThread->exportToTxtPublic(fileName, jList, labels, m_flag);
+            exportThread->exportToTxtPublic(fileName, jList.snapshot(), labels, m_flag);
             break;
         case BOOT_KLU:
             PERF_PRINT_BEGIN("POINT-04", QString("format=txt count=%1").arg(jBootList.count()));
-            exportThread->exportToTxtPublic(fileName, jBootList, labels, JOURNAL);
+            exportThread->exportToTxtPublic(fileName, jBootList.snapshot(), labels, JOURNAL);
             break;
         case APP: {
             PERF_PRINT_BEGIN("POINT-04", QString("format=txt count=%1").arg(appList.count()));
             QString appName = getAppName(m_curAppLog);
-            exportThread->exportToTxtPublic(fileName, appList, labels, appName);
+            exportThread->exportToTxtPublic(fileName, appList.snapshot(), labels, appName);
             break;
         }
         case DPKG:
             PERF_PRINT_BEGIN("POINT-04", QString("format=txt count=%1").arg(dList.count()));
-            exportThread->exportToTxtPublic(fileName, dList, labels);
+            exportThread->exportToTxtPublic(fileName, dList.snapshot(), labels);
             break;
         case BOOT:
             PERF_PRINT_BEGIN("POINT-04", QString("format=txt count=%1").arg(currentBootList.count()));
-            exportThread->exportToTxtPublic(fileName, currentBootList, labels);
+            exportThread->exportToTxtPublic(fileName, currentBootList.snapshot(), labels);
             break;
         case XORG:
             PERF_PRINT_BEGIN("POINT-04", QString("format=txt count=%1").arg(xList.count()));
-            exportThread->exportToTxtPublic(fileName, xList, labels);
+            exportThread->exportToTxtPublic(fileName, xList.snapshot(), labels);
             break;
         case Normal:
             PERF_PRINT_BEGIN("POINT-04", QString("format=txt count=%1").arg(nortempList.count()));
-            exportThread->exportToTxtPublic(fileName, nortempList, labels);
+            exportThread->exportToTxtPublic(fileName, nortempList.snapshot(), labels);
             break;
         case KERN:
             PERF_PRINT_BEGIN("POINT-04", QString("format=txt count=%1").arg(kList.count()));
-            exportThread->exportToTxtPublic(fileName, kList, labels, m_flag);
+            exportThread->exportToTxtPublic(fileName, kList.snapshot(), labels, m_flag);
             break;
         case Kwin:
             PERF_PRINT_BEGIN("POINT-04", QString("format=txt count=%1").arg(m_currentKwinList.count()));
-            exportThread->exportToTxtPublic(fileName, m_currentKwinList, labels);
+            exportThread->exportToTxtPublic(fileName, m_currentKwinList.snapshot(), labels);
             break;
         case Dmesg:
             PERF_PRINT_BEGIN("POINT-04", QString("format=txt count=%1").arg(dmesgList.count()));
-            exportThread->exportToTxtPublic(fileName, dmesgList, labels);
+            exportThread->exportToTxtPublic(fileName, dmesgList.snapshot(), labels);
             break;
         case Dnf:
             PERF_PRINT_BEGIN("POINT-04", QString("format=txt count=%1").arg(dnfList.count()));
-            exportThread->exportToTxtPublic(fileName, dnfList, labels);
+            exportThread->exportToTxtPublic(fileName, dnfList.snapshot(), labels);
             break;
         case Audit:
             PERF_PRINT_BEGIN("POINT-04", QString("format=txt count=%1").arg(aList.count()));
-            exportThread->exportToTxtPublic(fileName, aList, labels);
+            exportThread->exportToTxtPublic(fileName, aList.snapshot(), labels);
             break;
         default:
             break;
         }
-        QThreadPool::globalInstance()->start(exportThread);
+        LogWorkScheduler::instance()->start(exportThread, LogWorkScheduler::Export);
     } else if (selectFilter.contains("(*.html)")) {
         switch (m_flag) {
         case JOURNAL:
             PERF_PRINT_BEGIN("POINT-04", QString("format=html count=%1").arg(jList.count()));
-            exportThread->exportToHtmlPublic(fileName, jList, labels, m_flag);
+            exportThread->exportToHtmlPublic(fileName, jList.snapshot(), labels, m_flag);
             break;
         case BOOT_KLU:
             PERF_PRINT_BEGIN("POINT-04", QString("format=html count=%1").arg(jBootList.count()));
-            exportThread->exportToHtmlPublic(fileName, jBootList, labels, JOURNAL);
+            exportThread->exportToHtmlPublic(fileName, jBootList.snapshot(), labels, JOURNAL);
             break;
         case APP: {
             PERF_PRINT_BEGIN("POINT-04", QString("format=html count=%1").arg(appList.count()));
             QString appName = getAppName(m_curAppLog);
-            exportThread->exportToHtmlPublic(fileName, appList, labels, appName);
+            exportThread->exportToHtmlPublic(fileName, appList.snapshot(), labels, appName);
             break;
         }
         case DPKG:
             PERF_PRINT_BEGIN("POINT-04", QString("format=html count=%1").arg(dList.count()));
-            exportThread->exportToHtmlPublic(fileName, dList, labels);
+            exportThread->exportToHtmlPublic(fileName, dList.snapshot(), labels);
             break;
         case BOOT:
             PERF_PRINT_BEGIN("POINT-04", QString("format=html count=%1").arg(currentBootList.count()));
-            exportThread->exportToHtmlPublic(fileName, currentBootList, labels);
+            exportThread->exportToHtmlPublic(fileName, currentBootList.snapshot(), labels);
             break;
         case XORG:
             PERF_PRINT_BEGIN("POINT-04", QString("format=html count=%1").arg(xList.count()));
-            exportThread->exportToHtmlPublic(fileName, xList, labels);
+            exportThread->exportToHtmlPublic(fileName, xList.snapshot(), labels);
             break;
         case Normal:
             PERF_PRINT_BEGIN("POINT-04", QString("format=html count=%1").arg(nortempList.count()));
-            exportThread->exportToHtmlPublic(fileName, nortempList, labels);
+            exportThread->exportToHtmlPublic(fileName, nortempList.snapshot(), labels);
             break;
         case KERN:
             PERF_PRINT_BEGIN("POINT-04", QString("format=html count=%1").arg(kList.count()));
-            exportThread->exportToHtmlPublic(fileName, kList, labels, m_flag);
+            exportThread->exportToHtmlPublic(fileName, kList.snapshot(), labels, m_flag);
             break;
         case Kwin:
             PERF_PRINT_BEGIN("POINT-04", QString("format=html count=%1").arg(m_currentKwinList.count()));
-            exportThread->exportToHtmlPublic(fileName, m_currentKwinList, labels);
+            exportThread->exportToHtmlPublic(fileName, m_currentKwinList.snapshot(), labels);
             break;
         case Dmesg:
             PERF_PRINT_BEGIN("POINT-04", QString("format=txt count=%1").arg(dmesgList.count()));
-            exportThread->exportToHtmlPublic(fileName, dmesgList, labels);
+            exportThread->exportToHtmlPublic(fileName, dmesgList.snapshot(), labels);
             break;
         case Dnf:
             PERF_PRINT_BEGIN("POINT-04", QString("format=txt count=%1").arg(dnfList.count()));
-            exportThread->exportToHtmlPublic(fileName, dnfList, labels);
+            exportThread->exportToHtmlPublic(fileName, dnfList.snapshot(), labels);
             break;
         case Audit:
             PERF_PRINT_BEGIN("POINT-04", QString("format=txt count=%1").arg(aList.count()));
-            exportThread->exportToHtmlPublic(fileName, aList, labels);
+            exportThread->exportToHtmlPublic(fileName, aList.snapshot(), labels);
             break;
         default:
             break;
         }
-        QThreadPool::globalInstance()->start(exportThread);
+        LogWorkScheduler::instance()->start(exportThread, LogWorkScheduler::Export);
     } else if (selectFilter.contains("(*.doc)")) {
         switch (m_flag) {
         case JOURNAL:
             PERF_PRINT_BEGIN("POINT-04", QString("format=doc count=%1").arg(jList.count()));
-            exportThread->exportToDocPublic(fileName, jList, labels, m_flag);
+            exportThread->exportToDocPublic(fileName, jList.snapshot(), labels, m_flag);
             break;
         case BOOT_KLU:
             PERF_PRINT_BEGIN("POINT-04", QString("format=doc count=%1").arg(jBootList.count()));
-            exportThread->exportToDocPublic(fileName, jBootList, labels, JOURNAL);
+            exportThread->exportToDocPublic(fileName, jBootList.snapshot(), labels, JOURNAL);
             break;
         case APP: {
             PERF_PRINT_BEGIN("POINT-04", QString("format=doc count=%1").arg(appList.count()));
             QString appName = getAppName(m_curAppLog);
-            exportThread->exportToDocPublic(fileName, appList, labels, appName);
+            exportThread->exportToDocPublic(fileName, appList.snapshot(), labels, appName);
             break;
         }
         case DPKG:
             PERF_PRINT_BEGIN("POINT-04", QString("format=doc count=%1").arg(dList.count()));
-            exportThread->exportToDocPublic(fileName, dList, labels);
+            exportThread->exportToDocPublic(fileName, dList.snapshot(), labels);
             break;
         case BOOT:
             PERF_PRINT_BEGIN("POINT-04", QString("format=doc count=%1").arg(currentBootList.count()));
-            exportThread->exportToDocPublic(fileName, currentBootList, labels);
+            exportThread->exportToDocPublic(fileName, currentBootList.snapshot(), labels);
             break;
         case XORG:
             PERF_PRINT_BEGIN("POINT-04", QString("format=doc count=%1").arg(xList.count()));
-            exportThread->exportToDocPublic(fileName, xList, labels);
+            exportThread->exportToDocPublic(fileName, xList.snapshot(), labels);
             break;
         case Normal:
             PERF_PRINT_BEGIN("POINT-04", QString("format=doc count=%1").arg(nortempList.count()));
-            exportThread->exportToDocPublic(fileName, nortempList, labels);
+            exportThread->exportToDocPublic(fileName, nortempList.snapshot(), labels);
             break;
         case KERN:
             PERF_PRINT_BEGIN("POINT-04", QString("format=doc count=%1").arg(kList.count()));
-            exportThread->exportToDocPublic(fileName, kList, labels, m_flag);
+            exportThread->exportToDocPublic(fileName, kList.snapshot(), labels, m_flag);
             break;
         case Kwin:
             PERF_PRINT_BEGIN("POINT-04", QString("format=doc count=%1").arg(m_currentKwinList.count()));
-            exportThread->exportToDocPublic(fileName, m_currentKwinList, labels);
+            exportThread->exportToDocPublic(fileName, m_currentKwinList.snapshot(), labels);
             break;
         case Dmesg:
             PERF_PRINT_BEGIN("POINT-04", QString("format=txt count=%1").arg(dmesgList.count()));
-            exportThread->exportToDocPublic(fileName, dmesgList, labels);
+            exportThread->exportToDocPublic(fileName, dmesgList.snapshot(), labels);
             break;
         case Dnf:
             PERF_PRINT_BEGIN("POINT-04", QString("format=txt count=%1").arg(dnfList.count()));
-            exportThread->exportToDocPublic(fileName, dnfList, labels);
+            exportThread->exportToDocPublic(fileName, dnfList.snapshot(), labels);
             break;
         case Audit:
             PERF_PRINT_BEGIN("POINT-04", QString("format=txt count=%1").arg(aList.count()));
-            exportThread->exportToDocPublic(fileName, aList, labels);
+            exportThread->exportToDocPublic(fileName, aList.snapshot(), labels);
             break;
         default:
             break;
         }
-        QThreadPool::globalInstance()->start(exportThread);
+        LogWorkScheduler::instance()->start(exportThread, LogWorkScheduler::Export);
     } else if (selectFilter.contains("(*.xls)")) {
         switch (m_flag) {
         case JOURNAL:
             PERF_PRINT_BEGIN("POINT-04", QString("format=xls count=%1").arg(jList.count()));
-            exportThread->exportToXlsPublic(fileName, jList, labels, m_flag);
+            exportThread->exportToXlsPublic(fileName, jList.snapshot(), labels, m_flag);
             break;
         case BOOT_KLU:
             PERF_PRINT_BEGIN("POINT-04", QString("format=xls count=%1").arg(jBootList.count()));
-            exportThread->exportToXlsPublic(fileName, jBootList, labels, JOURNAL);
+            exportThread->exportToXlsPublic(fileName, jBootList.snapshot(), labels, JOURNAL);
             break;
         case APP: {
             PERF_PRINT_BEGIN("POINT-04", QString("format=xls count=%1").arg(appList.count()));
             QString appName = getAppName(m_curAppLog);
-            exportThread->exportToXlsPublic(fileName, appList, labels, appName);
+            exportThread->exportToXlsPublic(fileName, appList.snapshot(), labels, appName);
             break;
         }
         case DPKG:
             PERF_PRINT_BEGIN("POINT-04", QString("format=xls count=%1").arg(dList.count()));
-            exportThread->exportToXlsPublic(fileName, dList, labels);
+            exportThread->exportToXlsPublic(fileName, dList.snapshot(), labels);
             break;
         case BOOT:
             PERF_PRINT_BEGIN("POINT-04", QString("format=xls count=%1").arg(currentBootList.count()));
-            exportThread->exportToXlsPublic(fileName, currentBootList, labels);
+            exportThread->exportToXlsPublic(fileName, currentBootList.snapshot(), labels);
             break;
         case XORG:
             PERF_PRINT_BEGIN("POINT-04", QString("format=xls count=%1").arg(xList.count()));
-            exportThread->exportToXlsPublic(fileName, xList, labels);
+            exportThread->exportToXlsPublic(fileName, xList.snapshot(), labels);
             break;
         case Normal:
             PERF_PRINT_BEGIN("POINT-04", QString("format=xls count=%1").arg(nortempList.count()));
-            exportThread->exportToXlsPublic(fileName, nortempList, labels);
+            exportThread->exportToXlsPublic(fileName, nortempList.snapshot(), labels);
             break;
         case KERN:
             PERF_PRINT_BEGIN("POINT-04", QString("format=xls count=%1").arg(kList.count()));
-            exportThread->exportToXlsPublic(fileName, kList, labels, m_flag);
+            exportThread->exportToXlsPublic(fileName, kList.snapshot(), labels, m_flag);
             break;
         case Kwin:
             PERF_PRINT_BEGIN("POINT-04", QString("format=xls count=%1").arg(m_currentKwinList.count()));
-            exportThread->exportToXlsPublic(fileName, m_currentKwinList, labels);
+            exportThread->exportToXlsPublic(fileName, m_currentKwinList.snapshot(), labels);
             break;
         case Dmesg:
             PERF_PRINT_BEGIN("POINT-04", QString("format=txt count=%1").arg(dmesgList.count()));
-            exportThread->exportToXlsPublic(fileName, dmesgList, labels);
+            exportThread->exportToXlsPublic(fileName, dmesgList.snapshot(), labels);
             break;
         case Dnf:
             PERF_PRINT_BEGIN("POINT-04", QString("format=txt count=%1").arg(dnfList.count()));
-            exportThread->exportToXlsPublic(fileName, dnfList, labels);
+            exportThread->exportToXlsPublic(fileName, dnfList.snapshot(), labels);
             break;
         case Audit:
             PERF_PRINT_BEGIN("POINT-04", QString("format=txt count=%1").arg(aList.count()));
-            exportThread->exportToXlsPublic(fileName, aList, labels);
+            exportThread->exportToXlsPublic(fileName, aList.snapshot(), labels);
             break;
         default:
             break;
         }
-        QThreadPool::globalInstance()->start(exportThread);
+        LogWorkScheduler::instance()->start(exportThread, LogWorkScheduler::Export);
     } else if (selectFilter.contains("(*.zip)") && m_flag == COREDUMP) {
         PERF_PRINT_BEGIN("POINT-04", QString("format=zip count=%1").arg(aList.count()));
-        exportThread->exportToZipPublic(fileName, m_currentCoredumpList, labels);
-        QThreadPool::globalInstance()->start(exportThread);
+        exportThread->exportToZipPublic(fileName, m_currentCoredumpList.toList(), labels);
+        LogWorkScheduler::instance()->start(exportThread, LogWorkScheduler::Export);
     }
 }
 
@@ -1928,7 +2719,7 @@ void DisplayContent::slot_exportClicked()
 void DisplayContent::slot_statusChagned(const QString &status)
 {
     m_bootFilter.statusFilter = status;
-    currentBootList = filterBoot(m_bootFilter, bList);
+    currentBootList = filterBoot(m_bootFilter, LogRecordView<LOG_MSG_BOOT>::all(&bList));
     createBootTableForm();
     createBootTable(currentBootList);
 }
@@ -1941,6 +2732,7 @@ void DisplayContent::slot_dpkgFinished(int index)
     if (m_flag != DPKG || index != m_dpkgCurrentIndex)
         return;
     m_isDataLoadComplete = true;
+    finishIngest(dListOrigin.size());
     if (dList.isEmpty()) {
         setLoadState(DATA_COMPLETE);
         createDpkgTableStart(dList);
@@ -1949,16 +2741,22 @@ void DisplayContent::slot_dpkgFinished(int index)
 
 void DisplayContent::slot_dpkgData(int index, QList<LOG_MSG_DPKG> list)
 {
+    //先归还发送额度,被丢弃的旧批次也要归还
+    m_logFileParse.releaseDelivery(index);
     if (m_flag != DPKG || index != m_dpkgCurrentIndex)
         return;
 
+    const int begin = dListOrigin.size();
     dListOrigin.append(list);
-    dList.append(filterDpkg(m_currentSearchStr, list));
-    //因为此槽会在同一次加载数据完成前触发数次,所以第一次收到数据需要更新界面状态,后面的话往model里塞数据就行
+    const LogRecordView<LOG_MSG_DPKG> filterList = filterDpkg(m_currentSearchStr, LogRecordView<LOG_MSG_DPKG>::range(&dListOrigin, begin, dListOrigin.size()));
+    dList.append(filterList);
+    //因为此槽会在同一次加载数据完成前触发数次,所以第一次收到数据需要更新界面状态,后面把新数据追加到model
     if (m_firstLoadPageData && !dList.isEmpty()) {
         createDpkgTableStart(dList);
         m_firstLoadPageData = false;
         PERF_PRINT_END("POINT-03", "type=dpkg");
+    } else if (!m_firstLoadPageData) {
+        insertDpkgTable(filterList, 0, filterList.count());
     }
 }
 
@@ -1970,6 +2768,7 @@ void DisplayContent::slot_XorgFinished(int index)
     if (m_flag != XORG || index != m_xorgCurrentIndex)
         return;
     m_isDataLoadComplete = true;
+    finishIngest(xListOrigin.size());
     if (xList.isEmpty()) {
         setLoadState(DATA_COMPLETE);
         createXorgTable(xList);
@@ -1978,15 +2777,21 @@ void DisplayContent::slot_XorgFinished(int index)
 
 void DisplayContent::slot_xorgData(int index, QList<LOG_MSG_XORG> list)
 {
+    //先归还发送额度,被丢弃的旧批次也要归还
+    m_logFileParse.releaseDelivery(index);
     if (m_flag != XORG || index != m_xorgCurrentIndex)
         return;
+    const int begin = xListOrigin.size();
     xListOrigin.append(list);
-    xList.append(filterXorg(m_currentSearchStr, list));
-    //因为此槽会在同一次加载数据完成前触发数次,所以第一次收到数据需要更新界面状态,后面的话往model里塞数据就行
+    const LogRecordView<LOG_MSG_XORG> filterList = filterXorg(m_currentSearchStr, LogRecordView<LOG_MSG_XORG>::range(&xListOrigin, begin, xListOrigin.size()));
+    xList.append(filterList);
+    //因为此槽会在同一次加载数据完成前触发数次,所以第一次收到数据需要更新界面状态,后面把新数据追加到model
     if (m_firstLoadPageData && !xList.isEmpty()) {
         createXorgTable(xList);
         m_firstLoadPageData = false;
         PERF_PRINT_END("POINT-03", "type=xorg");
+    } else if (!m_firstLoadPageData) {
+        insertXorgTable(filterList, 0, filterList.count());
     }
 }
 
@@ -1998,6 +2803,7 @@ void DisplayContent::slot_bootFinished(int index)
     if (m_flag != BOOT || index != m_bootCurrentIndex)
         return;
     m_isDataLoadComplete = true;
+    finishIngest(bList.size());
     if (currentBootList.isEmpty()) {
         setLoadState(DATA_COMPLETE);
         createBootTable(currentBootList);
@@ -2006,17 +2812,22 @@ void DisplayContent::slot_bootFinished(int index)
 
 void DisplayContent::slot_bootData(int index, QList<LOG_MSG_BOOT> list)
 {
+    //先归还发送额度,被丢弃的旧批次也要归还
+    m_logFileParse.releaseDelivery(index);
     if (m_flag != BOOT || index != m_bootCurrentIndex)
         return;
 
+    const int begin = bList.size();
     bList.append(list);
-
-    currentBootList.append(filterBoot(m_bootFilter, list));
-    //因为此槽会在同一次加载数据完成前触发数次,所以第一次收到数据需要更新界面状态,后面的话往model里塞数据就行
+    const LogRecordView<LOG_MSG_BOOT> filterList = filterBoot(m_bootFilter, LogRecordView<LOG_MSG_BOOT>::range(&bList, begin, bList.size()));
+    currentBootList.append(filterList);
+    //因为此槽会在同一次加载数据完成前触发数次,所以第一次收到数据需要更新界面状态,后面把新数据追加到model
     if (m_firstLoadPageData && !currentBootList.isEmpty()) {
         createBootTable(currentBootList);
         m_firstLoadPageData = false;
         PERF_PRINT_END("POINT-03", "type=boot");
+    } else if (!m_firstLoadPageData) {
+        insertBootTable(filterList, 0, filterList.count());
     }
 }
 
@@ -2028,25 +2839,46 @@ void DisplayContent::slot_kernFinished(int index)
 {
     if (m_flag != KERN || index != m_kernCurrentIndex)
         return;
+    if (m_kernIncremental) {
+        m_kernIncremental = false;
+        const QList<LOG_MSG_JOURNAL> list = m_kernIncrementList;
+        m_kernIncrementList.clear();
+        mergeKernIncrement(list);
+        return;
+    }
     m_isDataLoadComplete = true;
+    finishIngest(kListOrigin.size());
     if (kList.isEmpty()) {
         setLoadState(DATA_COMPLETE);
         createKernTable(kList);
     }
+    startSearchIndex();
 }
 
 void DisplayContent::slot_kernData(int index, QList<LOG_MSG_JOURNAL> list)
 {
+    //先归还发送额度,被丢弃的旧批次也要归还
+    m_logFileParse.releaseDelivery(index);
     if (m_flag != KERN || index != m_kernCurrentIndex)
         return;
+    //增量刷新的数据先缓存,获取结束后去掉已加载的部分再插入头部
+    if (m_kernIncremental) {
+        m_kernIncrementList.append(list);
+        return;
+    }
 
+    const int begin = kListOrigin.size();
     kListOrigin.append(list);
-    kList.append(filterKern(m_currentSearchStr, list));
-    //因为此槽会在同一次加载数据完成前触发数次,所以第一次收到数据需要更新界面状态,后面的话往model里塞数据就行
+    addAggregates(list);
+    const LogRecordView<LOG_MSG_JOURNAL> filterList = filterKern(m_currentSearchStr, LogRecordView<LOG_MSG_JOURNAL>::range(&kListOrigin, begin, kListOrigin.size()));
+    kList.append(filterList);
+    //因为此槽会在同一次加载数据完成前触发数次,所以第一次收到数据需要更新界面状态,后面把新数据追加到model
     if (m_firstLoadPageData && !kList.isEmpty()) {
         createKernTable(kList);
         m_firstLoadPageData = false;
         PERF_PRINT_END("POINT-03", "type=kern");
+    } else if (!m_firstLoadPageData) {
+        insertKernTable(filterList, 0, filterList.count());
     }
 }
 
@@ -2058,7 +2890,15 @@ void DisplayContent::slot_kwinFinished(int index)
 {
     if (m_flag != Kwin || index != m_kwinCurrentIndex)
         return;
+    if (m_kwinIncremental) {
+        m_kwinIncremental = false;
+        const QList<LOG_MSG_KWIN> list = m_kwinIncrementList;
+        m_kwinIncrementList.clear();
+        mergeKwinIncrement(list);
+        return;
+    }
     m_isDataLoadComplete = true;
+    finishIngest(m_kwinList.size());
     if (m_currentKwinList.isEmpty()) {
         setLoadState(DATA_COMPLETE);
         creatKwinTable(m_currentKwinList);
@@ -2067,14 +2907,26 @@ void DisplayContent::slot_kwinFinished(int index)
 
 void DisplayContent::slot_kwinData(int index, QList<LOG_MSG_KWIN> list)
 {
+    //先归还发送额度,被丢弃的旧批次也要归还
+    m_logFileParse.releaseDelivery(index);
     if (m_flag != Kwin || index != m_kwinCurrentIndex)
         return;
+    //增量刷新的数据先缓存,获取结束后插入头部
+    if (m_kwinIncremental) {
+        m_kwinIncrementList.append(list);
+        return;
+    }
+    const int begin = m_kwinList.size();
     m_kwinList.append(list);
-    m_currentKwinList.append(filterKwin(m_currentSearchStr, list));
+    const LogRecordView<LOG_MSG_KWIN> filterList = filterKwin(m_currentSearchStr, LogRecordView<LOG_MSG_KWIN>::range(&m_kwinList, begin, m_kwinList.size()));
+    m_currentKwinList.append(filterList);
+    //因为此槽会在同一次加载数据完成前触发数次,所以第一次收到数据需要更新界面状态,后面把新数据追加到model
     if (m_firstLoadPageData && !m_currentKwinList.isEmpty()) {
         creatKwinTable(m_currentKwinList);
         m_firstLoadPageData = false;
         PERF_PRINT_END("POINT-03", "type=kwin");
+    } else if (!m_firstLoadPageData) {
+        insertKwinTable(filterList, 0, filterList.count());
     }
 }
 
@@ -2082,52 +2934,178 @@ void DisplayContent::slot_journalFinished(int index)
 {
     if (m_flag != JOURNAL || index != m_journalCurrentIndex)
         return;
+    if (m_journalIncremental) {
+        m_journalIncremental = false;
+        mergeJournalIncrement(m_journalIncrementList);
+        m_journalIncrementList.clear();
+        startJournalFollow();
+        return;
+    }
     m_isDataLoadComplete = true;
-    if (jList.isEmpty()) {
+    finishIngest(jListOrigin.size());
+    if (m_journalSearchDeferred) {
+        slot_searchResult(m_currentSearchStr);
+    } else if (jList.isEmpty()) {
         setLoadState(DATA_COMPLETE);
         createJournalTableStart(jList);
     }
+    startSearchIndex();
+    //取自缓存的结果只到缓存时的游标,先增量读取之后的新日志,结束后再开始实时跟踪
+    if (m_logFileParse.isCachedLoad(index) && !m_journalNewestCursor.isEmpty()) {
+        generateJournalIncrement();
+        return;
+    }
+    startJournalFollow();
+}
+
+void DisplayContent::slot_dnfFinished(int index)
+{
+    if (m_flag != Dnf || index != m_dnfCurrentIndex)
+        return;
+    m_isDataLoadComplete = true;
+    finishIngest(dnfListOrigin.size());
+    if (dnfList.isEmpty()) {
+        setLoadState(DATA_COMPLETE);
+        createDnfTable(dnfList);
+    }
+}
+
+/**
+ * @brief DisplayContent::slot_dnfData dnf日志数据获取线程槽函数,每满一批(大小随读取速度调整)发出一次,追加到model中
+ * @param index 槽函数发出线程的标记量序号
+ * @param list 本次获取的一批数据
+ */
+void DisplayContent::slot_dnfData(int index, QList<LOG_MSG_DNF> list)
+{
+    //先归还发送额度,被丢弃的旧批次也要归还
+    m_logFileParse.releaseDelivery(index);
+    if (m_flag != Dnf || index != m_dnfCurrentIndex)
+        return;
+    const int begin = dnfListOrigin.size();
+    dnfListOrigin.append(list);
+    const LogRecordView<LOG_MSG_DNF> filterList = filterDnf(m_currentSearchStr, LogRecordView<LOG_MSG_DNF>::range(&dnfListOrigin, begin, dnfListOrigin.size()));
+    dnfList.append(filterList);
+    //因为此槽会在同一次加载数据完成前触发数次,所以第一次收到数据需要更新界面状态,后面把新数据追加到model
+    if (m_firstLoadPageData && !dnfList.isEmpty()) {
+        createDnfTable(dnfList);
+        m_firstLoadPageData = false;
+        PERF_PRINT_END("POINT-03", "type=dnf");
+    } else if (!m_firstLoadPageData) {
+        insertDnfTable(filterList, 0, filterList.count());
+    }
 }
 
-void DisplayContent::slot_dnfFinished(const QList<LOG_MSG_DNF> &list)
+void DisplayContent::slot_dmesgFinished(int index)
 {
-    if (m_flag != Dnf)
+    if (m_flag != Dmesg || index != m_dmesgCurrentIndex)
         return;
-    dnfList = list;
-    dnfListOrigin = list;
-    createDnfTable(dnfList);
-    PERF_PRINT_END("POINT-03", "type=dnf");
+    m_isDataLoadComplete = true;
+    finishIngest(dmesgListOrigin.size());
+    if (dmesgList.isEmpty()) {
+        setLoadState(DATA_COMPLETE);
+        createDmesgTable(dmesgList);
+    }
 }
 
-void DisplayContent::slot_dmesgFinished(const QList<LOG_MSG_DMESG> &list)
+/**
+ * @brief DisplayContent::slot_dmesgData dmesg日志数据获取线程槽函数,每满一批(大小随读取速度调整)发出一次,追加到model中
+ * @param index 槽函数发出线程的标记量序号
+ * @param list 本次获取的一批数据
+ */
+void DisplayContent::slot_dmesgData(int index, QList<LOG_MSG_DMESG> list)
 {
-    if (m_flag != Dmesg)
+    //先归还发送额度,被丢弃的旧批次也要归还
+    m_logFileParse.releaseDelivery(index);
+    if (m_flag != Dmesg || index != m_dmesgCurrentIndex)
         return;
-    dmesgList = list;
-    dmesgListOrigin = list;
-    createDmesgTable(dmesgList);
-    PERF_PRINT_END("POINT-03", "type=dmesg");
+    const int begin = dmesgListOrigin.size();
+    dmesgListOrigin.append(list);
+    const LogRecordView<LOG_MSG_DMESG> filterList = filterDmesg(m_currentSearchStr, LogRecordView<LOG_MSG_DMESG>::range(&dmesgListOrigin, begin, dmesgListOrigin.size()));
+    dmesgList.append(filterList);
+    //因为此槽会在同一次加载数据完成前触发数次,所以第一次收到数据需要更新界面状态,后面把新数据追加到model
+    if (m_firstLoadPageData && !dmesgList.isEmpty()) {
+        createDmesgTable(dmesgList);
+        m_firstLoadPageData = false;
+        PERF_PRINT_END("POINT-03", "type=dmesg");
+    } else if (!m_firstLoadPageData) {
+        insertDmesgTable(filterList, 0, filterList.count());
+    }
 }
 
 /**
- * @brief DisplayContent::slot_journalData 系统日志数据获取线程槽函数,系统日志为获取500条就会执行此信号,不是一次把所有数据传进来,所以执行槽函数应该为每次获取向现在的model中添加而不是重置
+ * @brief DisplayContent::slot_journalData 系统日志数据获取线程槽函数,系统日志每满一批(大小随读取速度调整)就会执行此信号,不是一次把所有数据传进来,所以执行槽函数应该为每次获取向现在的model中添加而不是重置
  * @param index 槽函数发出线程的标记量序号
- * @param list 本次获取的500个或以下的数据
+ * @param list 本次获取的一批数据
  */
 void DisplayContent::slot_journalData(int index, QList<LOG_MSG_JOURNAL> list)
 {
     //判断最近一次获取数据线程的标记量,和信号曹发来的sender的标记量作对比,如果相同才可以刷新,因为会出现上次的获取线程就算停下信号也发出来了
     if (m_flag != JOURNAL || index != m_journalCurrentIndex)
         return;
+    //增量刷新的数据先缓存,获取结束后统一插入头部
+    if (m_journalIncremental) {
+        m_journalIncrementList.append(list);
+        return;
+    }
+    //截断之后停止前已发出的数据不再加入
+    if (m_journalWindowEnd > 0)
+        return;
+    const int begin = jListOrigin.size();
     jListOrigin.append(list);
-    jList.append(filterJournal(m_currentSearchStr, list));
-    //因为此槽会在同一次加载数据完成前触发数次,所以第一次收到数据需要更新界面状态,后面的话往model里塞数据就行
+    addAggregates(list);
+    bool undecided = false;
+    const LogRecordView<LOG_MSG_JOURNAL> filterList = filterJournal(m_currentSearchStr, LogRecordView<LOG_MSG_JOURNAL>::range(&jListOrigin, begin, jListOrigin.size()), &undecided);
+    //被截断的信息读取完整内容后才能确定是否匹配,加载结束后在搜索线程中重新搜索
+    if (undecided)
+        m_journalSearchDeferred = true;
+    jList.append(filterList);
+    //因为此槽会在同一次加载数据完成前触发数次,所以第一次收到数据需要更新界面状态,后面把新数据追加到model
     if (m_firstLoadPageData && !jList.isEmpty()) {
         createJournalTableStart(jList);
         m_firstLoadPageData = false;
         PERF_PRINT_END("POINT-01", "");
         PERF_PRINT_END("POINT-03", "type=system");
+    } else if (!m_firstLoadPageData) {
+        insertJournalTable(filterList, 0, filterList.count());
     }
+    if (jListOrigin.size() >= LOG_MEMORY_WINDOW_RECORDS && LogMemoryGovernor::currentLevel() >= LogMemoryGovernor::Critical)
+        capJournalWindow();
+}
+
+/**
+ * @brief DisplayContent::slot_journalCursor 记录系统日志最新条目的游标,供下次增量刷新使用
+ * @param index 槽函数发出线程的标记量序号
+ * @param cursor 游标字符串
+ */
+void DisplayContent::slot_journalCursor(int index, const QString &cursor)
+{
+    if (m_flag != JOURNAL || index != m_journalCurrentIndex || m_journalOlderWindow)
+        return;
+    m_journalNewestCursor = cursor;
+}
+
+/**
+ * @brief DisplayContent::slot_journalFollowData 实时跟踪到的新日志,插入到列表头部
+ * @param index 槽函数发出线程的标记量序号
+ * @param list 按从新到旧排列的新日志
+ * @param cursor 其中最新一条日志的游标
+ */
+void DisplayContent::slot_journalFollowData(int index, QList<LOG_MSG_JOURNAL> list, const QString &cursor)
+{
+    if (m_flag != JOURNAL || index != m_journalFollowIndex)
+        return;
+    m_journalNewestCursor = cursor;
+    mergeJournalIncrement(list);
+}
+
+/**
+ * @brief DisplayContent::slot_journalFollowFinished 实时跟踪出错退出,之后恢复定时刷新
+ * @param index 槽函数发出线程的标记量序号
+ */
+void DisplayContent::slot_journalFollowFinished(int index)
+{
+    if (index == m_journalFollowIndex)
+        m_journalFollowIndex = -1;
 }
 
 void DisplayContent::slot_journalBootFinished(int index)
@@ -2135,6 +3113,7 @@ void DisplayContent::slot_journalBootFinished(int index)
     if (m_flag != BOOT_KLU || index != m_journalBootCurrentIndex)
         return;
     m_isDataLoadComplete = true;
+    finishIngest(jBootListOrigin.size());
     if (jBootList.isEmpty()) {
         setLoadState(DATA_COMPLETE);
         createJournalBootTableStart(jBootList);
@@ -2142,21 +3121,25 @@ void DisplayContent::slot_journalBootFinished(int index)
 }
 
 /**
- * @brief DisplayContent::slot_journalBootData klu下启动日志日志数据获取线程槽函数,系统日志为获取500条就会执行此信号,不是一次把所有数据传进来,所以执行槽函数应该为每次获取向现在的model中添加而不是重置
+ * @brief DisplayContent::slot_journalBootData klu下启动日志日志数据获取线程槽函数,系统日志每满一批(大小随读取速度调整)就会执行此信号,不是一次把所有数据传进来,所以执行槽函数应该为每次获取向现在的model中添加而不是重置
  * @param index 槽函数发出线程的标记量序号
- * @param list 本次获取的500个或以下的数据
+ * @param list 本次获取的一批数据
  */
 void DisplayContent::slot_journalBootData(int index, QList<LOG_MSG_JOURNAL> list)
 {
     if (m_flag != BOOT_KLU || index != m_journalBootCurrentIndex)
         return;
+    const int begin = jBootListOrigin.size();
     jBootListOrigin.append(list);
-    jBootList.append(filterJournalBoot(m_currentSearchStr, list));
-    //因为此槽会在同一次加载数据完成前触发数次,所以第一次收到数据需要更新界面状态,后面的话往model里塞数据就行
+    const LogRecordView<LOG_MSG_JOURNAL> filterList = filterJournalBoot(m_currentSearchStr, LogRecordView<LOG_MSG_JOURNAL>::range(&jBootListOrigin, begin, jBootListOrigin.size()));
+    jBootList.append(filterList);
+    //因为此槽会在同一次加载数据完成前触发数次,所以第一次收到数据需要更新界面状态,后面把新数据追加到model
     if (m_firstLoadPageData && !jBootList.isEmpty()) {
         createJournalBootTableStart(jBootList);
         m_firstLoadPageData = false;
         PERF_PRINT_END("POINT-03", "type=boot_klu");
+    } else if (!m_firstLoadPageData) {
+        insertJournalBootTable(filterList, 0, filterList.count());
     }
 }
 
@@ -2168,23 +3151,29 @@ void DisplayContent::slot_applicationFinished(int index)
     if (m_flag != APP || index != m_appCurrentIndex)
         return;
     m_isDataLoadComplete = true;
+    finishIngest(appListOrigin.size());
     if (appList.isEmpty()) {
         setLoadState(DATA_COMPLETE);
         createAppTable(appList);
     }
+    startSearchIndex();
 }
 
 void DisplayContent::slot_applicationData(int index, QList<LOG_MSG_APPLICATOIN> list)
 {
     if (m_flag != APP || index != m_appCurrentIndex)
         return;
+    const int begin = appListOrigin.size();
     appListOrigin.append(list);
-    appList.append(filterApp(m_currentSearchStr, list));
-    //因为此槽会在同一次加载数据完成前触发数次,所以第一次收到数据需要更新界面状态,后面的话往model里塞数据就行
+    const LogRecordView<LOG_MSG_APPLICATOIN> filterList = filterApp(m_currentSearchStr, LogRecordView<LOG_MSG_APPLICATOIN>::range(&appListOrigin, begin, appListOrigin.size()));
+    appList.append(filterList);
+    //因为此槽会在同一次加载数据完成前触发数次,所以第一次收到数据需要更新界面状态,后面把新数据追加到model
     if (m_firstLoadPageData && !appList.isEmpty()) {
         createAppTable(appList);
         m_firstLoadPageData = false;
         PERF_PRINT_END("POINT-03", "type=application");
+    } else if (!m_firstLoadPageData) {
+        insertApplicationTable(filterList, 0, filterList.count());
     }
 }
 
@@ -2193,6 +3182,7 @@ void DisplayContent::slot_normalFinished(int index)
     if (m_flag != Normal || index != m_normalCurrentIndex)
         return;
     m_isDataLoadComplete = true;
+    finishIngest(norList.size());
     if (nortempList.isEmpty()) {
         setLoadState(DATA_COMPLETE);
         createNormalTable(nortempList);
@@ -2201,24 +3191,31 @@ void DisplayContent::slot_normalFinished(int index)
 
 void DisplayContent::slot_normalData(int index, QList<LOG_MSG_NORMAL> list)
 {
+    //先归还发送额度,被丢弃的旧批次也要归还
+    m_logFileParse.releaseDelivery(index);
     if (m_flag != Normal || index != m_normalCurrentIndex)
         return;
+    const int begin = norList.size();
     norList.append(list);
-    nortempList.append(filterNomal(m_normalFilter, list));
-    //因为此槽会在同一次加载数据完成前触发数次,所以第一次收到数据需要更新界面状态,后面的话往model里塞数据就行
+    const LogRecordView<LOG_MSG_NORMAL> filterList = filterNomal(m_normalFilter, LogRecordView<LOG_MSG_NORMAL>::range(&norList, begin, norList.size()));
+    nortempList.append(filterList);
+    //因为此槽会在同一次加载数据完成前触发数次,所以第一次收到数据需要更新界面状态,后面把新数据追加到model
     if (m_firstLoadPageData && !nortempList.isEmpty()) {
         createNormalTable(nortempList);
         m_firstLoadPageData = false;
         PERF_PRINT_END("POINT-03", "type=on_off");
+    } else if (!m_firstLoadPageData) {
+        insertNormalTable(filterList, 0, filterList.count());
     }
 }
 
-void DisplayContent::slot_OOCData(int index, const QString &data)
+void DisplayContent::slot_OOCData(int index, LogTextSourcePtr source)
 {
     if ((m_flag != OtherLog && m_flag != CustomLog) || index != m_OOCCurrentIndex)
         return;
 
-    emit sigDetailInfo(m_treeView->selectionModel()->selectedRows().first(), m_pModel, data);
+    //各文件的内容依次追加到分页显示控件,只绘制可见的行
+    m_detailWgt->appendOOCSource(source);
 }
 
 void DisplayContent::slot_auditFinished(int index, bool bShowTip/* = false*/)
@@ -2226,6 +3223,7 @@ void DisplayContent::slot_auditFinished(int index, bool bShowTip/* = false*/)
     if (m_flag != Audit || index != m_auditCurrentIndex)
         return;
     m_isDataLoadComplete = true;
+    finishIngest(aListOrigin.size());
     if (aList.isEmpty()) {
         if (bShowTip) {
             createAuditTable(aList);
@@ -2243,16 +3241,22 @@ void DisplayContent::slot_auditFinished(int index, bool bShowTip/* = false*/)
 
 void DisplayContent::slot_auditData(int index, QList<LOG_MSG_AUDIT> list)
 {
+    //先归还发送额度,被丢弃的旧批次也要归还
+    m_logFileParse.releaseDelivery(index);
     if (m_flag != Audit || index != m_auditCurrentIndex)
         return;
 
+    const int begin = aListOrigin.size();
     aListOrigin.append(list);
-    aList.append(filterAudit(m_auditFilter, list));
-    //因为此槽会在同一次加载数据完成前触发数次,所以第一次收到数据需要更新界面状态,后面的话往model里塞数据就行
+    const LogRecordView<LOG_MSG_AUDIT> filterList = filterAudit(m_auditFilter, LogRecordView<LOG_MSG_AUDIT>::range(&aListOrigin, begin, aListOrigin.size()));
+    aList.append(filterList);
+    //因为此槽会在同一次加载数据完成前触发数次,所以第一次收到数据需要更新界面状态,后面把新数据追加到model
     if (m_firstLoadPageData && !aList.isEmpty()) {
         createAuditTable(aList);
         m_firstLoadPageData = false;
         PERF_PRINT_END("POINT-03", "type=audit");
+    } else if (!m_firstLoadPageData) {
+        insertAuditTable(filterList, 0, filterList.count());
     }
 }
 
@@ -2262,6 +3266,7 @@ void DisplayContent::slot_coredumpFinished(int index)
         return;
 
     m_isDataLoadComplete = true;
+    finishIngest(m_coredumpList.size());
     if (m_currentCoredumpList.isEmpty()) {
         setLoadState(DATA_COMPLETE);
         emit setExportEnable(false);
@@ -2270,16 +3275,22 @@ void DisplayContent::slot_coredumpFinished(int index)
 }
 void DisplayContent::slot_coredumpData(int index, QList<LOG_MSG_COREDUMP> list)
 {
+    //先归还发送额度,被丢弃的旧批次也要归还
+    m_logFileParse.releaseDelivery(index);
     if (m_flag != COREDUMP || index != m_coredumpCurrentIndex)
         return;
 
+    const int begin = m_coredumpList.size();
     m_coredumpList.append(list);
-    m_currentCoredumpList.append(filterCoredump(m_currentSearchStr, list));
-    //因为此槽会在同一次加载数据完成前触发数次,所以第一次收到数据需要更新界面状态,后面的话往model里塞数据就行
+    const LogRecordView<LOG_MSG_COREDUMP> filterList = filterCoredump(m_currentSearchStr, LogRecordView<LOG_MSG_COREDUMP>::range(&m_coredumpList, begin, m_coredumpList.size()));
+    m_currentCoredumpList.append(filterList);
+    //因为此槽会在同一次加载数据完成前触发数次,所以第一次收到数据需要更新界面状态,后面把新数据追加到model
     if (m_firstLoadPageData && !m_currentCoredumpList.isEmpty()) {
         createCoredumpTable(m_currentCoredumpList);
         m_firstLoadPageData = false;
         PERF_PRINT_END("POINT-03", "type=coredump");
+    } else if (!m_firstLoadPageData) {
+        insertCoredumpTable(filterList, 0, filterList.count());
     }
 }
 
@@ -2307,384 +3318,851 @@ void DisplayContent::slot_logLoadFailed(const QString &iError)
 }
 
 /**
- * @brief DisplayContent::slot_vScrollValueChanged 滚动条滚动实现分页加载数据槽函数
- * @param valuePixel 当前滑动的像素
+ * @brief DisplayContent::slot_memoryLevelChanged 内存压力等级变化:紧张时释放类别缓存、停止预取并归还空闲的堆内存,
+ * 极度紧张时正在加载且已超过上限的系统日志立即截断
+ * @param level LogMemoryGovernor::Level
  */
-void DisplayContent::slot_vScrollValueChanged(int valuePixel)
+void DisplayContent::slot_memoryLevelChanged(int level)
 {
-    if (!m_treeView) {
+    const bool pressure = level >= LogMemoryGovernor::Pressure;
+    if (pressure == m_logFileParse.memoryPressure() && level < LogMemoryGovernor::Critical)
         return;
-    }
-    if (m_treeView->singleRowHeight() < 0) {
+    m_logFileParse.setMemoryPressure(pressure);
+    if (pressure)
+        malloc_trim(0);
+    if (level >= LogMemoryGovernor::Critical && m_flag == JOURNAL && !m_isDataLoadComplete && !m_journalIncremental
+            && jListOrigin.size() >= LOG_MEMORY_WINDOW_RECORDS)
+        capJournalWindow();
+}
+
+/**
+ * @brief DisplayContent::searchInBackground 在线程池中搜索origin,匹配的记录分批追加到result和表格
+ * 被搜索的列表按值交给搜索线程,之后origin再追加数据也不影响本次搜索;
+ * 列表和其他筛选条件都没变、新关键字包含上一次的关键字时,只在上一次匹配的记录和上一次还没扫描到的记录中搜索
+ * @param origin 被搜索的全部记录
+ * @param result 当前显示的记录,是origin上的下标视图,先清空
+ * @param match 单条记录的匹配规则,为空表示不需要筛选,直接显示全部记录
+ * @param hitFields 要高亮关键字的列,搜索线程对匹配的记录记下关键字位置,绘制可见单元格时直接使用
+ * @param extra 关键字以外的筛选条件,不同时不复用上一次的结果
+ * @param createTable 显示第一批记录并选中第一行
+ * @param insertTable 追加后续批次
+ */
+template <typename T>
+void DisplayContent::searchInBackground(const LogRecordStore<T> &origin, LogRecordView<T> &result, const std::function<bool(const T &)> &match,
+                                        const LogSearchHits::Fields<T> &hitFields, const QString &extra,
+                                        const std::function<void(const LogRecordView<T> &)> &createTable,
+                                        const std::function<void(const LogRecordView<T> &)> &insertTable)
+{
+    cancelSearch();
+    m_searchHits.reset();
+    m_matchNavigator.clear();
+    m_treeView->logScrollBar()->setMinimapHits(QVector<int>());
+    if (!match) {
+        m_searchState = SearchState();
+        result = LogRecordView<T>::all(&origin);
+        createTable(result);
+        m_pModel->setSearchHits(nullptr);
+        updateSearchState();
+        emit searchMatchStatus(0, 0);
         return;
     }
-    //根据当前表格单行行高计算现在滑动了多少项
-    int value = valuePixel / m_treeView->singleRowHeight(); // m_treeView->singleRowHeight();
-    if (m_treeViewLastScrollValue == value) {
+    //有其他筛选条件的类别匹配规则中包含了这些条件,仍按搜索结果筛选
+    const bool highlightOnly = m_searchHighlightOnly && extra.isEmpty();
+
+    SearchState &state = m_searchState;
+    std::shared_ptr<LogRecordStore<T>> last = std::static_pointer_cast<LogRecordStore<T>>(state.origin);
+    //列表被修改过就不再和上一次的快照共享数据,首条记录的地址会不同
+    const bool sameOrigin = last && state.flag == m_flag && last->size() == origin.size()
+                            && (origin.isEmpty() || &last->at(0) == &origin.at(0));
+    const LogQuery query(m_currentSearchStr);
+    //有字段条件时新旧查询没有包含关系,不复用上一次的结果
+    const bool refine = sameOrigin && state.extra == extra && !state.text.isEmpty() && !state.regex && !m_searchRegex
+                        && !query.isStructured() && !LogQuery(state.text).isStructured()
+                        && m_currentSearchStr.contains(state.text, Qt::CaseInsensitive);
+    const QVector<LogRecordFilter::TextMatcher> matchers = query.textMatchers(searchMode());
+    //高亮第一个关键字
+    const LogRecordFilter::TextMatcher text = matchers.value(0);
+    QVector<int> candidates;
+    bool hasCandidates = refine;
+    if (refine) {
+        const int total = state.hasCandidates ? state.candidates.size() : origin.size();
+        candidates.reserve(state.matches.size() + total - state.scanned);
+        candidates += state.matches;
+        for (int i = state.scanned; i < total; ++i)
+            candidates.append(state.hasCandidates ? state.candidates.at(i) : i);
+    } else {
+        //有索引时只确认可能包含关键字的记录
+        QStringList literals;
+        for (const LogRecordFilter::TextMatcher &matcher : matchers)
+            literals += matcher.literals();
+        hasCandidates = indexCandidates(origin, literals, candidates);
+    }
+    state.flag = m_flag;
+    state.text = m_currentSearchStr;
+    state.regex = m_searchRegex;
+    state.extra = extra;
+    if (!sameOrigin)
+        state.origin = std::make_shared<LogRecordStore<T>>(origin);
+    state.candidates = candidates;
+    state.hasCandidates = hasCandidates;
+    state.scanned = 0;
+    state.matches.clear();
+
+    if (highlightOnly) {
+        //表格先显示全部记录,匹配的行号随批次加入m_matchNavigator
+        result = LogRecordView<T>::all(&origin);
+        createTable(result);
+    } else {
+        result = LogRecordView<T>(&origin);
+        setLoadState(DATA_COMPLETE);
+        m_detailWgt->cleanText();
+    }
+    emit searchMatchStatus(0, 0);
+    if (hasCandidates && candidates.isEmpty()) {
+        updateSearchState();
         return;
     }
-    m_treeViewLastScrollValue = value;
-    //算出现在滚动了多少页
-    int rateValue = (value + 25) / SINGLE_LOAD;
-    switch (m_flag) {
-    case JOURNAL: {
-        //如果快滚到页底了就加载下一页数据到表格中
-        if (value < SINGLE_LOAD * rateValue - 20 || value < SINGLE_LOAD * rateValue) {
-            if (m_limitTag >= rateValue)
-                return;
-
-            int leftCnt = jList.count() - SINGLE_LOAD * rateValue;
-            //如果在页尾部则只加载最后一页的数量,否则加载单页全部数量
-            int end = leftCnt > SINGLE_LOAD ? SINGLE_LOAD : leftCnt;
-            //把数据加入model中
-            insertJournalTable(jList, SINGLE_LOAD * rateValue, SINGLE_LOAD * rateValue + end);
-
-            m_limitTag = rateValue;
-            m_treeView->verticalScrollBar()->setValue(valuePixel);
+
+    m_searchCanRun = std::make_shared<std::atomic_bool>(true);
+    const LogRecordStore<T> list = *std::static_pointer_cast<LogRecordStore<T>>(state.origin);
+    LogSearchWork *work = new LogSearchWork(list.size(), [list, match](int row) {
+        return match(list.at(row));
+    }, m_searchCanRun);
+    if (hasCandidates)
+        work->setCandidates(candidates);
+    if (!text.isEmpty() && !hitFields.isEmpty()) {
+        work->setMarker([list, hitFields, text](int row, LogSearchHits &hits) {
+            hits.markRecord(row, list.at(row), hitFields, text);
+        });
+    }
+    m_searchHits = std::make_shared<LogSearchHits>();
+    m_pModel->setSearchHits(m_searchHits);
+    m_searchIndex = work->getIndex();
+    connect(work, &LogSearchWork::searchData, this, [this, &result, createTable, insertTable, highlightOnly](int index, QVector<int> rows, int scanned, LogSearchHits hits) {
+        //已被新的搜索或重新加载取消,丢弃还在队列中的结果
+        if (index != m_searchIndex)
+            return;
+        m_searchState.matches += rows;
+        m_searchState.scanned = scanned;
+        //先追加位置再插入行,新行第一次绘制时就能高亮
+        m_searchHits->append(hits);
+        if (highlightOnly) {
+            //全部记录都已显示,表格的行号就是存储中的下标
+            const bool first = m_matchNavigator.isEmpty();
+            m_matchNavigator.add(rows);
+            m_treeView->logScrollBar()->addMinimapHits(rows);
+            m_treeView->viewport()->update();
+            if (first && !m_matchNavigator.isEmpty())
+                jumpToMatch(m_matchNavigator.next(-1));
+            else
+                emit searchMatchStatus(m_matchNavigator.countBefore(m_treeView->currentIndex().row() + 1), m_matchNavigator.size());
+            return;
         }
-        update();
-    }
-    break;
-    case BOOT_KLU: {
-        if (value < SINGLE_LOAD * rateValue - 20 || value < SINGLE_LOAD * rateValue) {
-            if (m_limitTag >= rateValue)
-                return;
-            int leftCnt = jBootList.count() - SINGLE_LOAD * rateValue;
-            int end = leftCnt > SINGLE_LOAD ? SINGLE_LOAD : leftCnt;
-
-            insertJournalBootTable(jBootList, SINGLE_LOAD * rateValue, SINGLE_LOAD * rateValue + end);
-            m_limitTag = rateValue;
-            m_treeView->verticalScrollBar()->setValue(valuePixel);
+        //快照和搜索时的列表下标一致,结果只记录下标
+        QVector<quint32> batchRows;
+        batchRows.reserve(rows.size());
+        for (int row : rows)
+            batchRows.append(static_cast<quint32>(row));
+        const LogRecordView<T> batch = result.withRows(batchRows);
+        const bool first = m_pModel->rowCount() == 0;
+        result.append(batch);
+        if (first) {
+            createTable(batch);
+            m_detailWgt->hideLine(false);
+        } else {
+            insertTable(batch);
         }
-    }
-    break;
-    case APP: {
-        if (value < SINGLE_LOAD * rateValue - 20 || value < SINGLE_LOAD * rateValue) {
-            if (m_limitTag >= rateValue)
-                return;
-            int leftCnt = appList.count() - SINGLE_LOAD * rateValue;
-            int end = leftCnt > SINGLE_LOAD ? SINGLE_LOAD : leftCnt;
-            insertApplicationTable(appList, SINGLE_LOAD * rateValue, SINGLE_LOAD * rateValue + end);
-            m_limitTag = rateValue;
-            m_treeView->verticalScrollBar()->setValue(valuePixel);
+    });
+    connect(work, &LogSearchWork::searchFinished, this, [this](int index) {
+        if (index != m_searchIndex)
+            return;
+        m_searchIndex = -1;
+        m_searchState.scanned = m_searchState.hasCandidates ? m_searchState.candidates.size()
+                                                            : std::static_pointer_cast<LogRecordStore<T>>(m_searchState.origin)->size();
+        updateSearchState();
+    });
+    LogWorkScheduler::instance()->start(work, LogWorkScheduler::Search);
+}
+
+/**
+ * @brief DisplayContent::cancelSearch 取消正在进行的搜索
+ */
+void DisplayContent::cancelSearch()
+{
+    if (m_searchCanRun)
+        *m_searchCanRun = false;
+    m_searchCanRun.reset();
+    m_searchIndex = -1;
+}
+
+/**
+ * @brief DisplayContent::setCollapseSimilar 折叠或展开系统日志、内核日志中的相似信息
+ * 折叠时在后台按模板归纳当前筛选结果,每组只显示第一条,信息列显示模板和条数;展开时按当前筛选结果重新显示
+ */
+void DisplayContent::setCollapseSimilar(bool collapse)
+{
+    if ((m_flag != JOURNAL && m_flag != KERN) || collapse == m_collapseSimilar)
+        return;
+    if (!collapse) {
+        if (m_flag == JOURNAL) {
+            createJournalTableForm();
+            createJournalTableStart(jList);
+        } else {
+            createKernTableForm();
+            createKernTable(kList);
         }
+        m_pModel->setSearchHits(m_searchHits);
+        return;
     }
-    break;
-    case KERN: {
-        if (value < SINGLE_LOAD * rateValue - 20 || value < SINGLE_LOAD * rateValue) {
-            if (m_limitTag >= rateValue)
-                return;
-            int leftCnt = kList.count() - SINGLE_LOAD * rateValue;
-            int end = leftCnt > SINGLE_LOAD ? SINGLE_LOAD : leftCnt;
-
-            insertKernTable(kList, SINGLE_LOAD * rateValue, SINGLE_LOAD * rateValue + end);
-            m_limitTag = rateValue;
-            m_treeView->verticalScrollBar()->setValue(valuePixel);
-        }
+    m_collapseSimilar = true;
+    startCollapseSimilar();
+}
+
+/**
+ * @brief DisplayContent::startCollapseSimilar 按当前筛选结果重新归纳,之前未完成的归纳作废
+ */
+void DisplayContent::startCollapseSimilar()
+{
+    if (m_collapseCanRun)
+        *m_collapseCanRun = false;
+    //快照和归纳时的列表下标一致,之后的追加不影响它
+    const LogRecordView<LOG_MSG_JOURNAL> view = (m_flag == JOURNAL ? jList : kList).snapshot();
+    m_collapseCanRun = std::make_shared<std::atomic_bool>(true);
+    LogTemplateWork *work = new LogTemplateWork(view.size(), [view](int row) {
+        return view.at(row).msg;
+    }, m_collapseCanRun);
+    m_collapseIndex = work->getIndex();
+    const LOG_FLAG flag = m_flag;
+    connect(work, &LogTemplateWork::groupsReady, this, [this, view, flag](int index, QVector<LogTemplateGroup> groups) {
+        if (index != m_collapseIndex || !m_collapseSimilar || m_flag != flag)
+            return;
+        m_collapseIndex = -1;
+        showCollapsedGroups(view, groups);
+    });
+    LogWorkScheduler::instance()->start(work, LogWorkScheduler::Search);
+}
+
+/**
+ * @brief DisplayContent::cancelCollapseSimilar 取消正在进行的归纳并恢复为展开显示
+ */
+void DisplayContent::cancelCollapseSimilar()
+{
+    if (m_collapseCanRun)
+        *m_collapseCanRun = false;
+    m_collapseCanRun.reset();
+    m_collapseIndex = -1;
+    m_collapseSimilar = false;
+}
+
+/**
+ * @brief DisplayContent::showCollapsedGroups 每组显示第一条记录,多于一条时信息列为模板和条数
+ * @param view 归纳时的记录快照
+ * @param groups 按第一条出现顺序的各组
+ */
+void DisplayContent::showCollapsedGroups(const LogRecordView<LOG_MSG_JOURNAL> &view, const QVector<LogTemplateGroup> &groups)
+{
+    QList<LOG_MSG_JOURNAL> collapsed;
+    collapsed.reserve(groups.size());
+    for (const LogTemplateGroup &group : groups) {
+        LOG_MSG_JOURNAL record = view.at(group.first);
+        if (group.count > 1)
+            record.msg = DApplication::translate("Table", "%1 (%2 similar)").arg(group.pattern).arg(group.count);
+        collapsed.append(record);
     }
-    break;
-    case DPKG: {
-        if (value < SINGLE_LOAD * rateValue - 20 || value < SINGLE_LOAD * rateValue) {
-            if (m_limitTag >= rateValue)
-                return;
-            int leftCnt = dList.count() - SINGLE_LOAD * rateValue;
-            int end = leftCnt > SINGLE_LOAD ? SINGLE_LOAD : leftCnt;
 
-            insertDpkgTable(dList, SINGLE_LOAD * rateValue, SINGLE_LOAD * rateValue + end);
+    //重建表格会恢复为展开状态,之后再标记为折叠
+    if (m_flag == JOURNAL) {
+        createJournalTableForm();
+        m_collapseSimilar = true;
+        m_pModel->setColumns(JOUR_TABLE_DATA, journalColumns());
+        m_pModel->insertRecords(-1, LogRecordView<LOG_MSG_JOURNAL>(collapsed));
+        m_treeView->hideColumn(JOURNAL_SPACE::journalHostNameColumn);
+        m_treeView->hideColumn(JOURNAL_SPACE::journalDaemonIdColumn);
+    } else {
+        createKernTableForm();
+        m_collapseSimilar = true;
+        parseListToModel(LogRecordView<LOG_MSG_JOURNAL>(collapsed), m_pModel);
+    }
+    //高亮位置按原列表的下标记录,折叠后的记录不再对应
+    m_pModel->setSearchHits(nullptr);
+    QItemSelectionModel *p = m_treeView->selectionModel();
+    if (p)
+        p->select(m_pModel->index(0, 0), QItemSelectionModel::Rows | QItemSelectionModel::Select);
+    slot_tableItemClicked(m_pModel->index(0, 0));
+}
 
-            m_limitTag = rateValue;
-            m_treeView->verticalScrollBar()->setValue(valuePixel);
-        }
+/**
+ * @brief DisplayContent::setGroupTransactions dpkg日志按事务归组或恢复逐行显示
+ * 事务在加载时已经逐批归纳好,切换时不需要重新扫描
+ */
+void DisplayContent::setGroupTransactions(bool group)
+{
+    if (m_flag != DPKG || group == m_dpkgGrouped)
+        return;
+    m_dpkgGrouped = group;
+    m_dpkgExpanded.clear();
+    if (group) {
+        showDpkgTransactions();
+        return;
     }
-    break;
-    case XORG: {
-        if (value < SINGLE_LOAD * rateValue - 20 || value < SINGLE_LOAD * rateValue) {
-            if (m_limitTag >= rateValue)
-                return;
-            int leftCnt = xList.count() - SINGLE_LOAD * rateValue;
-            int end = leftCnt > SINGLE_LOAD ? SINGLE_LOAD : leftCnt;
-            insertXorgTable(xList, SINGLE_LOAD * rateValue, SINGLE_LOAD * rateValue + end);
-            m_limitTag = rateValue;
-            m_treeView->verticalScrollBar()->setValue(valuePixel);
-        }
+    m_dpkgSummaryRows.clear();
+    createDpkgTableForm();
+    createDpkgTableStart(dList);
+    m_pModel->setSearchHits(m_searchHits);
+}
+
+/**
+ * @brief DisplayContent::showDpkgTransactions 每个事务显示一行摘要,已展开的事务在摘要之后显示详细的行
+ * @param selectTransaction 显示后选中该事务的摘要行,为-1时保持当前选中的行号
+ */
+void DisplayContent::showDpkgTransactions(int selectTransaction)
+{
+    const int currentRow = m_treeView->currentIndex().row();
+    QList<LOG_MSG_DPKG> rows;
+    QVector<int> summaryRows;
+    const QVector<LogDpkgTransaction> &transactions = m_dpkgTransactions.transactions();
+    for (int i = 0; i < transactions.size(); ++i) {
+        const LogDpkgTransaction &transaction = transactions.at(i);
+        summaryRows.append(rows.size());
+        rows.append(dpkgTransactionSummary(transaction));
+        if (!m_dpkgExpanded.contains(i))
+            continue;
+        //只有展开的事务才从记录视图中取出详细的行
+        const LogRecordView<LOG_MSG_DPKG> detail = dList.mid(transaction.first, transaction.count);
+        for (int row = 0; row < detail.size(); ++row)
+            rows.append(detail.at(row));
     }
-    break;
-    case BOOT: {
-        if (value < SINGLE_LOAD * rateValue - 20 || value < SINGLE_LOAD * rateValue) {
-            if (m_limitTag >= rateValue)
-                return;
-            int leftCnt = currentBootList.count() - SINGLE_LOAD * rateValue;
-            int end = leftCnt > SINGLE_LOAD ? SINGLE_LOAD : leftCnt;
-            insertBootTable(currentBootList, SINGLE_LOAD * rateValue, SINGLE_LOAD * rateValue + end);
-            m_limitTag = rateValue;
-            m_treeView->verticalScrollBar()->setValue(valuePixel);
+
+    createDpkgTableForm();
+    m_dpkgSummaryRows.clear();
+    if (rows.isEmpty())
+        return;
+    parseListToModel(LogRecordView<LOG_MSG_DPKG>(rows), m_pModel);
+    for (int row : summaryRows)
+        m_dpkgSummaryRows.append(QPersistentModelIndex(m_pModel->index(row, 0)));
+    //高亮位置按dList的下标记录,摘要行不再对应
+    m_pModel->setSearchHits(nullptr);
+
+    const int selectRow = selectTransaction >= 0 ? summaryRows.value(selectTransaction) : qBound(0, currentRow, rows.size() - 1);
+    const QModelIndex index = m_pModel->index(selectRow, 0);
+    QItemSelectionModel *p = m_treeView->selectionModel();
+    if (p)
+        p->select(index, QItemSelectionModel::Rows | QItemSelectionModel::Select);
+    m_treeView->setCurrentIndex(index);
+    if (selectTransaction >= 0)
+        m_treeView->scrollTo(index);
+}
+
+/**
+ * @brief DisplayContent::dpkgTransactionSummary 事务的摘要行,时间为最早一行的时间,信息列为各动作的包数、前几个包名和行数
+ */
+LOG_MSG_DPKG DisplayContent::dpkgTransactionSummary(const LogDpkgTransaction &transaction) const
+{
+    LOG_MSG_DPKG record;
+    record.dateTime = transaction.beginText;
+    record.timestamp = transaction.beginTime;
+    QStringList actions;
+    int most = 0;
+    for (auto it = transaction.actions.cbegin(); it != transaction.actions.cend(); ++it) {
+        actions.append(QString("%1 %2").arg(it.key()).arg(it.value()));
+        if (it.value() > most) {
+            most = it.value();
+            record.action = it.key();
         }
     }
-    break;
-    case Kwin: {
-        if (value < SINGLE_LOAD * rateValue - 20 || value < SINGLE_LOAD * rateValue) {
-            if (m_limitTag >= rateValue)
-                return;
-            int leftCnt = m_currentKwinList.count() - SINGLE_LOAD * rateValue;
-            int end = leftCnt > SINGLE_LOAD ? SINGLE_LOAD : leftCnt;
-            insertKwinTable(m_currentKwinList, SINGLE_LOAD * rateValue, SINGLE_LOAD * rateValue + end);
-            m_limitTag = rateValue;
-            m_treeView->verticalScrollBar()->setValue(valuePixel);
-        }
+    if (actions.isEmpty()) {
+        record.msg = DApplication::translate("Table", "%1 lines").arg(transaction.count);
+        return record;
     }
-    break;
-    case Normal: {
-        if (value < SINGLE_LOAD * rateValue - 20 || value < SINGLE_LOAD * rateValue) {
-            if (m_limitTag >= rateValue)
-                return;
-            int leftCnt = nortempList.count() - SINGLE_LOAD * rateValue;
-            int end = leftCnt > SINGLE_LOAD ? SINGLE_LOAD : leftCnt;
-            insertNormalTable(nortempList, SINGLE_LOAD * rateValue, SINGLE_LOAD * rateValue + end);
-            m_limitTag = rateValue;
-            m_treeView->verticalScrollBar()->setValue(valuePixel);
+    QString packages = transaction.packages.join(", ");
+    if (transaction.packageCount > transaction.packages.size())
+        packages += ", ...";
+    record.msg = DApplication::translate("Table", "%1: %2 (%3 lines)").arg(actions.join(", ")).arg(packages).arg(transaction.count);
+    return record;
+}
+
+/**
+ * @brief DisplayContent::slot_tableItemDoubleClicked 归组显示的dpkg日志双击摘要行时展开或收起该事务的详细行
+ */
+void DisplayContent::slot_tableItemDoubleClicked(const QModelIndex &index)
+{
+    if (m_flag != DPKG || !m_dpkgGrouped || !index.isValid())
+        return;
+    int transaction = -1;
+    for (int i = 0; i < m_dpkgSummaryRows.size(); ++i) {
+        if (m_dpkgSummaryRows.at(i).row() == index.row()) {
+            transaction = i;
+            break;
         }
     }
-    break;
-    case Dnf: {
-        if (value < SINGLE_LOAD * rateValue - 20 || value < SINGLE_LOAD * rateValue) {
-            if (m_limitTag >= rateValue)
-                return;
-            int leftCnt = dnfList.count() - SINGLE_LOAD * rateValue;
-            int end = leftCnt > SINGLE_LOAD ? SINGLE_LOAD : leftCnt;
-            insertDnfTable(dnfList, SINGLE_LOAD * rateValue, SINGLE_LOAD * rateValue + end);
-            m_limitTag = rateValue;
-            m_treeView->verticalScrollBar()->setValue(value);
+    if (transaction < 0)
+        return;
+    if (!m_dpkgExpanded.remove(transaction))
+        m_dpkgExpanded.insert(transaction);
+    showDpkgTransactions(transaction);
+}
+
+/**
+ * @brief DisplayContent::updateSearchState 搜索结束后更新显示状态,搜索结果为空要显示无搜索结果提示
+ */
+void DisplayContent::updateSearchState()
+{
+    if (0 == m_pModel->rowCount()) {
+        if (m_currentSearchStr.isEmpty()) {
+            setLoadState(DATA_COMPLETE);
+        } else {
+            setLoadState(DATA_NO_SEARCH_RESULT);
         }
+        m_detailWgt->cleanText();
+        m_detailWgt->hideLine(true);
+    } else {
+        setLoadState(DATA_COMPLETE);
+        m_detailWgt->hideLine(false);
     }
-    break;
-    case Dmesg: {
-        if (value < SINGLE_LOAD * rateValue - 20 || value < SINGLE_LOAD * rateValue) {
-            if (m_limitTag >= rateValue)
-                return;
-            int leftCnt = dmesgList.count() - SINGLE_LOAD * rateValue;
-            int end = leftCnt > SINGLE_LOAD ? SINGLE_LOAD : leftCnt;
-
-            insertDmesgTable(dmesgList, SINGLE_LOAD * rateValue, SINGLE_LOAD * rateValue + end);
-            m_limitTag = rateValue;
-            m_treeView->verticalScrollBar()->setValue(value);
-        }
+}
+
+/**
+ * @brief DisplayContent::startSearchIndex 记录较多的类别加载完成后在后台建立搜索索引,各列和对应的match函数一致
+ */
+void DisplayContent::startSearchIndex()
+{
+    switch (m_flag) {
+    case JOURNAL:
+        buildSearchIndex<LOG_MSG_JOURNAL>(jListOrigin, [](const LOG_MSG_JOURNAL &msg, QStringList &fields) {
+            fields << msg.dateTime << msg.hostName << msg.daemonName << msg.daemonId << LogLevel::text(msg.level) << msg.msg;
+            //被截断的信息完整内容不在内存中
+            return msg.cursor.isEmpty();
+        });
+        break;
+    case KERN:
+        buildSearchIndex<LOG_MSG_JOURNAL>(kListOrigin, [](const LOG_MSG_JOURNAL &msg, QStringList &fields) {
+            fields << msg.dateTime << msg.hostName << msg.daemonName << msg.msg;
+            return true;
+        });
+        break;
+    case APP:
+        buildSearchIndex<LOG_MSG_APPLICATOIN>(appListOrigin, [](const LOG_MSG_APPLICATOIN &msg, QStringList &fields) {
+            fields << msg.dateTime << LogLevel::text(msg.level) << msg.src << msg.msg;
+            return true;
+        });
+        break;
+    default:
+        break;
     }
-    break;
-    case OtherLog: {
-        if (value < SINGLE_LOAD * rateValue - 20 || value < SINGLE_LOAD * rateValue) {
-            if (m_limitTag >= rateValue)
-                return;
+}
+
+/**
+ * @brief DisplayContent::buildSearchIndex 在线程池中为origin建立三元组索引,进度和内存占用通过searchIndexStatus显示
+ * @param origin 已加载的全部记录,按值交给建立线程
+ * @param fields 取出记录参与搜索的各列,返回false表示记录还有不在内存中的文本
+ */
+template <typename T>
+void DisplayContent::buildSearchIndex(const LogRecordStore<T> &origin, const std::function<bool(const T &, QStringList &)> &fields)
+{
+    cancelSearchIndex();
+    if (origin.size() < LOG_TRIGRAM_INDEX_MIN_ROWS)
+        return;
+
+    SearchIndexState &state = m_trigramIndex;
+    state.flag = m_flag;
+    state.index = std::make_shared<LogTrigramIndex>(static_cast<qint64>(LogPerformanceProfile::current().searchIndexMB) * 1024 * 1024);
+    state.canRun = std::make_shared<std::atomic_bool>(true);
+    state.first = &origin.at(0);
+    state.last = &origin.at(origin.size() - 1);
+    const LogRecordStore<T> list = origin;
+    LogTrigramIndexWork *work = new LogTrigramIndexWork(state.index, list.size(), [list, fields](int row, QStringList &out) {
+        return fields(list.at(row), out);
+    }, state.canRun);
+    state.work = work->getIndex();
+    connect(work, &LogTrigramIndexWork::buildProgress, this, [this](int index, int rows, int total) {
+        if (index != m_trigramIndex.work)
+            return;
+        emit searchIndexStatus(DApplication::translate("SearchBar", "Building search index: %1%")
+                               .arg(static_cast<int>(static_cast<qint64>(rows) * 100 / qMax(1, total))));
+    });
+    connect(work, &LogTrigramIndexWork::buildFinished, this, [this](int index, bool ok) {
+        if (index != m_trigramIndex.work)
+            return;
+        m_trigramIndex.work = -1;
+        m_trigramIndex.ready = ok;
+        const qint64 budgetMb = m_trigramIndex.index->budget() / (1024 * 1024);
+        if (ok) {
+            emit searchIndexStatus(DApplication::translate("SearchBar", "Search index ready: %1 MB of %2 MB budget")
+                                   .arg(qMax<qint64>(1, m_trigramIndex.index->memoryBytes() / (1024 * 1024))).arg(budgetMb));
+        } else {
+            emit searchIndexStatus(DApplication::translate("SearchBar", "Search index skipped: over the %1 MB memory budget").arg(budgetMb));
+            m_trigramIndex.index.reset();
+        }
+    });
+    emit searchIndexStatus(DApplication::translate("SearchBar", "Building search index: %1%").arg(0));
+    //和预取一样在低优先级线程中建立,不占用界面加载的线程
+    LogWorkScheduler::instance()->start(work, LogWorkScheduler::Prefetch);
+}
 
-            int leftCnt = oList.count() - SINGLE_LOAD * rateValue;
-            int end = leftCnt > SINGLE_LOAD ? SINGLE_LOAD : leftCnt;
+/**
+ * @brief DisplayContent::indexCandidates 用搜索索引得到当前关键字的候选记录
+ * 存储在建立索引之后只在末尾追加了记录时,追加的记录都作为候选
+ * @param origin 被搜索的全部记录
+ * @param literals 每处命中都包含的字面量,关键字搜索时为关键字本身,正则搜索时从表达式中提取
+ * @param rows 输出参数,从小到大的候选下标
+ * @return 是否可以只扫描候选记录
+ */
+template <typename T>
+bool DisplayContent::indexCandidates(const LogRecordStore<T> &origin, const QStringList &literals, QVector<int> &rows) const
+{
+    const SearchIndexState &state = m_trigramIndex;
+    if (!state.ready || state.flag != m_flag)
+        return false;
+    const int indexed = state.index->rowCount();
+    if (indexed == 0 || origin.size() < indexed || &origin.at(0) != state.first || &origin.at(indexed - 1) != state.last)
+        return false;
+    if (literals.isEmpty() || !state.index->candidates(literals, rows))
+        return false;
+    for (int i = indexed; i < origin.size(); ++i)
+        rows.append(i);
+    return true;
+}
 
-            insertOOCTable(oList, SINGLE_LOAD * rateValue, SINGLE_LOAD * rateValue + end);
-            m_limitTag = rateValue;
-            m_treeView->verticalScrollBar()->setValue(valuePixel);
-        }
-    }
-    break;
-    case CustomLog: {
-        if (value < SINGLE_LOAD * rateValue - 20 || value < SINGLE_LOAD * rateValue) {
-            if (m_limitTag >= rateValue)
-                return;
+/**
+ * @brief DisplayContent::cancelSearchIndex 停止正在建立的索引并释放已有的索引
+ */
+void DisplayContent::cancelSearchIndex()
+{
+    if (m_trigramIndex.canRun)
+        *m_trigramIndex.canRun = false;
+    const bool hadIndex = m_trigramIndex.index != nullptr;
+    m_trigramIndex = SearchIndexState();
+    if (hadIndex)
+        emit searchIndexStatus(QString());
+}
 
-            int leftCnt = cList.count() - SINGLE_LOAD * rateValue;
-            int end = leftCnt > SINGLE_LOAD ? SINGLE_LOAD : leftCnt;
+/**
+ * @brief DisplayContent::slot_searchRegexChanged 切换搜索框的正则模式,有关键字时按新模式重新搜索
+ * @param regex 关键字是否按正则表达式匹配
+ */
+void DisplayContent::slot_searchRegexChanged(bool regex)
+{
+    if (m_searchRegex == regex)
+        return;
+    m_searchRegex = regex;
+    if (!m_currentSearchStr.isEmpty())
+        slot_searchResult(m_currentSearchStr);
+}
 
-            insertOOCTable(cList, SINGLE_LOAD * rateValue, SINGLE_LOAD * rateValue + end);
-            m_limitTag = rateValue;
-            m_treeView->verticalScrollBar()->setValue(valuePixel);
-        }
-    }
-    break;
-    case Audit: {
-        if (value < SINGLE_LOAD * rateValue - 20 || value < SINGLE_LOAD * rateValue) {
-            if (m_limitTag >= rateValue)
-                return;
+/**
+ * @brief DisplayContent::slot_searchHighlightChanged 切换搜索时是筛选出匹配的记录还是保留全部记录只高亮匹配
+ * @param highlightOnly 是否只高亮不筛选
+ */
+void DisplayContent::slot_searchHighlightChanged(bool highlightOnly)
+{
+    if (m_searchHighlightOnly == highlightOnly)
+        return;
+    m_searchHighlightOnly = highlightOnly;
+    if (!m_currentSearchStr.isEmpty())
+        slot_searchResult(m_currentSearchStr);
+}
 
-            int leftCnt = aList.count() - SINGLE_LOAD * rateValue;
-            int end = leftCnt > SINGLE_LOAD ? SINGLE_LOAD : leftCnt;
+/**
+ * @brief DisplayContent::jumpToNextMatch 只高亮不筛选时跳到当前行之后的匹配,到末尾后回到第一个
+ */
+void DisplayContent::jumpToNextMatch()
+{
+    jumpToMatch(m_matchNavigator.next(m_treeView->currentIndex().row()));
+}
 
-            insertAuditTable(aList, SINGLE_LOAD * rateValue, SINGLE_LOAD * rateValue + end);
-            m_limitTag = rateValue;
-            m_treeView->verticalScrollBar()->setValue(valuePixel);
-        }
-    }
-    break;
-    case COREDUMP: {
-        if (value < SINGLE_LOAD * rateValue - 20 || value < SINGLE_LOAD * rateValue) {
-            if (m_limitTag >= rateValue)
-                return;
+/**
+ * @brief DisplayContent::jumpToPreviousMatch 只高亮不筛选时跳到当前行之前的匹配,到开头后回到最后一个
+ */
+void DisplayContent::jumpToPreviousMatch()
+{
+    jumpToMatch(m_matchNavigator.previous(m_treeView->currentIndex().row()));
+}
 
-            int leftCnt = m_currentCoredumpList.count() - SINGLE_LOAD * rateValue;
-            int end = leftCnt > SINGLE_LOAD ? SINGLE_LOAD : leftCnt;
+/**
+ * @brief DisplayContent::jumpToMatch 选中匹配的行并滚动到可见区域
+ * @param row 表格中的行号,小于0时不跳转
+ */
+void DisplayContent::jumpToMatch(int row)
+{
+    //折叠相似信息和dpkg事务显示时表格的行不再对应记录的下标
+    if (row < 0 || row >= m_pModel->rowCount() || m_collapseSimilar || m_dpkgGrouped)
+        return;
+    const QModelIndex index = m_pModel->index(row, 0);
+    QItemSelectionModel *p = m_treeView->selectionModel();
+    if (p)
+        p->select(index, QItemSelectionModel::ClearAndSelect | QItemSelectionModel::Rows);
+    m_treeView->setCurrentIndex(index);
+    m_treeView->scrollTo(index, QAbstractItemView::PositionAtCenter);
+    slot_tableItemClicked(index);
+    emit searchMatchStatus(m_matchNavigator.countBefore(row) + 1, m_matchNavigator.size());
+}
 
-            insertCoredumpTable(m_currentCoredumpList, SINGLE_LOAD * rateValue, SINGLE_LOAD * rateValue + end);
-            m_limitTag = rateValue;
-            m_treeView->verticalScrollBar()->setValue(valuePixel);
-        }
-    }
-    break;
-    default:
-        break;
-    }
+LogRecordFilter::TextMatcher::Mode DisplayContent::searchMode() const
+{
+    return m_searchRegex ? LogRecordFilter::TextMatcher::Regex : LogRecordFilter::TextMatcher::Keyword;
+}
+
+/**
+ * @brief DisplayContent::journalPushedDown 当前系统日志是否已按查询的字段条件读取
+ */
+bool DisplayContent::journalPushedDown(const LogQuery &query) const
+{
+    return m_flag == JOURNAL && !m_loadedJournalMatches.isEmpty() && query.journalMatches() == m_loadedJournalMatches;
+}
+
+/**
+ * @brief DisplayContent::searchPredicate 按搜索框的查询生成单条记录的匹配规则
+ * @param searchStr 搜索框的输入,可以包含字段条件
+ * @param textMatch 单个关键字的匹配规则
+ */
+template <typename T>
+std::function<bool(const T &)> DisplayContent::searchPredicate(const QString &searchStr,
+                                                               const std::function<bool(const LogRecordFilter::TextMatcher &, const T &)> &textMatch) const
+{
+    const LogQuery query(searchStr);
+    return query.predicate<T>(textMatch, searchMode(), journalPushedDown(query));
 }
 
 /**
  * @brief DisplayContent::slot_searchResult 搜索框执行搜索槽函数
+ * 在搜索线程中扫描已加载的数据,匹配结果分批显示,新的关键字会立即取消上一次搜索
  * @param str 要搜索的关键字
  */
 void DisplayContent::slot_searchResult(const QString &str)
 {
     m_currentSearchStr = str;
+    const LogQuery query(m_currentSearchStr);
+    QString error;
+    for (const LogRecordFilter::TextMatcher &text : query.textMatchers(searchMode())) {
+        if (!text.isValid()) {
+            error = text.errorString();
+            break;
+        }
+    }
+    emit searchPatternError(error);
     if (m_flag == NONE)
         return;
+    //字段条件变了时先在已读取的日志中筛选,停止输入后再按新条件重新读取
+    if (m_flag == JOURNAL && query.journalMatches() != m_loadedJournalMatches)
+        m_journalQueryTimer.start();
 
+    const QString searchStr = m_currentSearchStr;
     switch (m_flag) {
     case JOURNAL: {
-        jList = jListOrigin;
-        jList.clear();
-        jList = filterJournal(m_currentSearchStr, jListOrigin);
-        //清空model和分页重新加载
+        m_journalSearchDeferred = false;
         createJournalTableForm();
-        createJournalTableStart(jList);
+        std::function<bool(const LOG_MSG_JOURNAL &)> match;
+        if (!searchStr.isEmpty()) {
+            //被截断的信息在前缀中没有匹配时才读取完整内容,sd_journal在搜索线程中首次使用时打开
+            std::shared_ptr<JournalMessageResolver> resolver = std::make_shared<JournalMessageResolver>();
+            match = searchPredicate<LOG_MSG_JOURNAL>(searchStr, [resolver](const LogRecordFilter::TextMatcher &text, const LOG_MSG_JOURNAL &msg) { return LogRecordFilter::matchJournal(text, msg, *resolver); });
+        }
+        const LogSearchHits::Fields<LOG_MSG_JOURNAL> hitFields {
+            {JOURNAL_SPACE::journalDaemonNameColumn, &LOG_MSG_JOURNAL::daemonName},
+            {JOURNAL_SPACE::journalDateTimeColumn, &LOG_MSG_JOURNAL::dateTime},
+            {JOURNAL_SPACE::journalMsgColumn, &LOG_MSG_JOURNAL::msg}
+        };
+        searchInBackground<LOG_MSG_JOURNAL>(jListOrigin, jList, match, hitFields, QString(),
+                                            [this](const LogRecordView<LOG_MSG_JOURNAL> &list) { createJournalTableStart(list); },
+                                            [this](const LogRecordView<LOG_MSG_JOURNAL> &list) { insertJournalTable(list, 0, list.count()); });
     }
     break;
     case BOOT_KLU: {
-        jBootList.clear();
-        jBootList = filterJournalBoot(m_currentSearchStr, jBootListOrigin);
         createJournalBootTableForm();
-        createJournalBootTableStart(jBootList);
+        std::function<bool(const LOG_MSG_JOURNAL &)> match;
+        if (!searchStr.isEmpty())
+            match = searchPredicate<LOG_MSG_JOURNAL>(searchStr, [](const LogRecordFilter::TextMatcher &text, const LOG_MSG_JOURNAL &msg) { return LogRecordFilter::matchJournalBoot(text, msg); });
+        const LogSearchHits::Fields<LOG_MSG_JOURNAL> hitFields {
+            {JOURNAL_SPACE::journalDaemonNameColumn, &LOG_MSG_JOURNAL::daemonName},
+            {JOURNAL_SPACE::journalDateTimeColumn, &LOG_MSG_JOURNAL::dateTime},
+            {JOURNAL_SPACE::journalMsgColumn, &LOG_MSG_JOURNAL::msg}
+        };
+        searchInBackground<LOG_MSG_JOURNAL>(jBootListOrigin, jBootList, match, hitFields, QString(),
+                                            [this](const LogRecordView<LOG_MSG_JOURNAL> &list) { createJournalBootTableStart(list); },
+                                            [this](const LogRecordView<LOG_MSG_JOURNAL> &list) { insertJournalBootTable(list, 0, list.count()); });
     }
     break;
     case KERN: {
-        kList = filterKern(m_currentSearchStr, kListOrigin);
         createKernTableForm();
-        createKernTable(kList);
+        std::function<bool(const LOG_MSG_JOURNAL &)> match;
+        if (!searchStr.isEmpty())
+            match = searchPredicate<LOG_MSG_JOURNAL>(searchStr, [](const LogRecordFilter::TextMatcher &text, const LOG_MSG_JOURNAL &msg) { return LogRecordFilter::matchKern(text, msg); });
+        const LogSearchHits::Fields<LOG_MSG_JOURNAL> hitFields {
+            {KERN_SPACE::kernDateTimeColumn, &LOG_MSG_JOURNAL::dateTime},
+            {KERN_SPACE::kernDaemonNameColumn, &LOG_MSG_JOURNAL::daemonName},
+            {KERN_SPACE::kernMsgColumn, &LOG_MSG_JOURNAL::msg}
+        };
+        searchInBackground<LOG_MSG_JOURNAL>(kListOrigin, kList, match, hitFields, QString(),
+                                            [this](const LogRecordView<LOG_MSG_JOURNAL> &list) { createKernTable(list); },
+                                            [this](const LogRecordView<LOG_MSG_JOURNAL> &list) { insertKernTable(list, 0, list.count()); });
     }
     break;
     case BOOT: {
-        m_bootFilter.searchstr = m_currentSearchStr;
-        currentBootList = filterBoot(m_bootFilter, bList);
+        m_bootFilter.searchstr = searchStr;
         createBootTableForm();
-        createBootTable(currentBootList);
+        std::function<bool(const LOG_MSG_BOOT &)> match;
+        if (!m_bootFilter.statusFilter.isEmpty() || !searchStr.isEmpty()) {
+            const int statusFilter = LogParseMatchers::bootStatusFilter(m_bootFilter.statusFilter);
+            match = searchPredicate<LOG_MSG_BOOT>(searchStr, [statusFilter](const LogRecordFilter::TextMatcher &text, const LOG_MSG_BOOT &msg) { return LogRecordFilter::matchBoot(statusFilter, text, msg); });
+        }
+        const LogSearchHits::Fields<LOG_MSG_BOOT> hitFields {{0, &LOG_MSG_BOOT::status}, {1, &LOG_MSG_BOOT::msg}};
+        searchInBackground<LOG_MSG_BOOT>(bList, currentBootList, match, hitFields, m_bootFilter.statusFilter,
+                                         [this](const LogRecordView<LOG_MSG_BOOT> &list) { createBootTable(list); },
+                                         [this](const LogRecordView<LOG_MSG_BOOT> &list) { insertBootTable(list, 0, list.count()); });
     }
     break;
     case XORG: {
-        xList.clear();
-        xList = filterXorg(m_currentSearchStr, xListOrigin);
         createXorgTableForm();
-        createXorgTable(xList);
+        std::function<bool(const LOG_MSG_XORG &)> match;
+        if (!searchStr.isEmpty())
+            match = searchPredicate<LOG_MSG_XORG>(searchStr, [](const LogRecordFilter::TextMatcher &text, const LOG_MSG_XORG &msg) { return LogRecordFilter::matchXorg(text, msg); });
+        const LogSearchHits::Fields<LOG_MSG_XORG> hitFields {
+            {XORG_SPACE::xorgDateTimeColumn, &LOG_MSG_XORG::offset},
+            {XORG_SPACE::xorgMsgColumn, &LOG_MSG_XORG::msg}
+        };
+        searchInBackground<LOG_MSG_XORG>(xListOrigin, xList, match, hitFields, QString(),
+                                         [this](const LogRecordView<LOG_MSG_XORG> &list) { createXorgTable(list); },
+                                         [this](const LogRecordView<LOG_MSG_XORG> &list) { insertXorgTable(list, 0, list.count()); });
     }
     break;
     case DPKG: {
-        dList.clear();
-        dList = filterDpkg(m_currentSearchStr, dListOrigin);
         createDpkgTableForm();
-        createDpkgTableStart(dList);
+        std::function<bool(const LOG_MSG_DPKG &)> match;
+        if (!searchStr.isEmpty())
+            match = searchPredicate<LOG_MSG_DPKG>(searchStr, [](const LogRecordFilter::TextMatcher &text, const LOG_MSG_DPKG &msg) { return LogRecordFilter::matchDpkg(text, msg); });
+        const LogSearchHits::Fields<LOG_MSG_DPKG> hitFields {
+            {DKPG_SPACE::dkpgDateTimeColumn, &LOG_MSG_DPKG::dateTime},
+            {DKPG_SPACE::dkpgMsgColumn, &LOG_MSG_DPKG::msg}
+        };
+        searchInBackground<LOG_MSG_DPKG>(dListOrigin, dList, match, hitFields, QString(),
+                                         [this](const LogRecordView<LOG_MSG_DPKG> &list) { createDpkgTableStart(list); },
+                                         [this](const LogRecordView<LOG_MSG_DPKG> &list) { insertDpkgTable(list, 0, list.count()); });
     }
     break;
     case APP: {
-        appList.clear();
-        appList = filterApp(m_currentSearchStr, appListOrigin);
         createAppTableForm();
-        createAppTable(appList);
+        std::function<bool(const LOG_MSG_APPLICATOIN &)> match;
+        if (!searchStr.isEmpty())
+            match = searchPredicate<LOG_MSG_APPLICATOIN>(searchStr, [](const LogRecordFilter::TextMatcher &text, const LOG_MSG_APPLICATOIN &msg) { return LogRecordFilter::matchApp(text, msg); });
+        const LogSearchHits::Fields<LOG_MSG_APPLICATOIN> hitFields {
+            {APP_SPACE::appDateTimeColumn, &LOG_MSG_APPLICATOIN::dateTime},
+            {APP_SPACE::appMsgColumn, &LOG_MSG_APPLICATOIN::msg}
+        };
+        searchInBackground<LOG_MSG_APPLICATOIN>(appListOrigin, appList, match, hitFields, QString(),
+                                                [this](const LogRecordView<LOG_MSG_APPLICATOIN> &list) { createAppTable(list); },
+                                                [this](const LogRecordView<LOG_MSG_APPLICATOIN> &list) { insertApplicationTable(list, 0, list.count()); });
     }
     break;
     case Normal: {
-        m_normalFilter.searchstr = m_currentSearchStr;
-        nortempList = filterNomal(m_normalFilter, norList);
+        m_normalFilter.searchstr = searchStr;
         createNormalTableForm();
-        createNormalTable(nortempList);
+        std::function<bool(const LOG_MSG_NORMAL &)> match;
+        if (!searchStr.isEmpty() || m_normalFilter.eventTypeFilter >= 0) {
+            const int eventType = m_normalFilter.eventTypeFilter;
+            match = searchPredicate<LOG_MSG_NORMAL>(searchStr, [eventType](const LogRecordFilter::TextMatcher &text, const LOG_MSG_NORMAL &msg) { return LogRecordFilter::matchNormal(eventType, text, msg); });
+        }
+        const LogSearchHits::Fields<LOG_MSG_NORMAL> hitFields {
+            {NORMAL_SPACE::normalEventTypeColumn, &LOG_MSG_NORMAL::eventType},
+            {NORMAL_SPACE::normalUserNameColumn, &LOG_MSG_NORMAL::userName},
+            {NORMAL_SPACE::normalDateTimeColumn, &LOG_MSG_NORMAL::dateTime},
+            {NORMAL_SPACE::normalMsgColumn, &LOG_MSG_NORMAL::msg}
+        };
+        searchInBackground<LOG_MSG_NORMAL>(norList, nortempList, match, hitFields, QString::number(m_normalFilter.eventTypeFilter),
+                                           [this](const LogRecordView<LOG_MSG_NORMAL> &list) { createNormalTable(list); },
+                                           [this](const LogRecordView<LOG_MSG_NORMAL> &list) { insertNormalTable(list, 0, list.count()); });
     }
     break; // add by Airy
     case Kwin: {
-        m_currentKwinList.clear();
-        m_currentKwinList = filterKwin(m_currentSearchStr, m_kwinList);
         createKwinTableForm();
-        creatKwinTable(m_currentKwinList);
+        std::function<bool(const LOG_MSG_KWIN &)> match;
+        if (!searchStr.isEmpty())
+            match = searchPredicate<LOG_MSG_KWIN>(searchStr, [](const LogRecordFilter::TextMatcher &text, const LOG_MSG_KWIN &msg) { return LogRecordFilter::matchKwin(text, msg); });
+        const LogSearchHits::Fields<LOG_MSG_KWIN> hitFields {{0, &LOG_MSG_KWIN::msg}};
+        searchInBackground<LOG_MSG_KWIN>(m_kwinList, m_currentKwinList, match, hitFields, QString(),
+                                         [this](const LogRecordView<LOG_MSG_KWIN> &list) { creatKwinTable(list); },
+                                         [this](const LogRecordView<LOG_MSG_KWIN> &list) { insertKwinTable(list, 0, list.count()); });
     }
     break;
     case Dnf: {
-        dnfList = dnfListOrigin;
-        if (!m_currentSearchStr.isEmpty()) {
-            int cnt = dnfList.count();
-            for (int i = cnt - 1; i >= 0; --i) {
-                LOG_MSG_DNF msg = dnfList.at(i);
-                if (msg.dateTime.contains(m_currentSearchStr, Qt::CaseInsensitive)
-                        || msg.msg.contains(m_currentSearchStr, Qt::CaseInsensitive)
-                        || msg.level.contains(m_currentSearchStr, Qt::CaseInsensitive)) {
-                    continue;
-                } else {
-                    dnfList.removeAt(i);
-                }
-            }
-        }
         createDnfForm();
-        createDnfTable(dnfList);
+        std::function<bool(const LOG_MSG_DNF &)> match;
+        if (!searchStr.isEmpty())
+            match = searchPredicate<LOG_MSG_DNF>(searchStr, [](const LogRecordFilter::TextMatcher &text, const LOG_MSG_DNF &msg) { return LogRecordFilter::matchDnf(text, msg); });
+        const LogSearchHits::Fields<LOG_MSG_DNF> hitFields {
+            {DNF_SPACE::dnfDateTimeColumn, &LOG_MSG_DNF::dateTime},
+            {DNF_SPACE::dnfMsgColumn, &LOG_MSG_DNF::msg}
+        };
+        searchInBackground<LOG_MSG_DNF>(dnfListOrigin, dnfList, match, hitFields, QString(),
+                                        [this](const LogRecordView<LOG_MSG_DNF> &list) { createDnfTable(list); },
+                                        [this](const LogRecordView<LOG_MSG_DNF> &list) { insertDnfTable(list, 0, list.count()); });
     }
     break;
     case Dmesg: {
-        dmesgList = dmesgListOrigin;
-        if (!m_currentSearchStr.isEmpty()) {
-            int cnt = dmesgList.count();
-            for (int i = cnt - 1; i >= 0; --i) {
-                LOG_MSG_DMESG msg = dmesgList.at(i);
-                if (msg.dateTime.contains(m_currentSearchStr, Qt::CaseInsensitive) || msg.msg.contains(m_currentSearchStr, Qt::CaseInsensitive))
-                    continue;
-                dmesgList.removeAt(i);
-            }
-        }
         createDmesgForm();
-        createDmesgTable(dmesgList);
-    }
-    break;
-    case OtherLog: {
-        oList.clear();
-        oList = filterOOC(m_currentSearchStr, oListOrigin);
-        createOOCTableForm();
-        createOOCTable(oList);
+        std::function<bool(const LOG_MSG_DMESG &)> match;
+        if (!searchStr.isEmpty())
+            match = searchPredicate<LOG_MSG_DMESG>(searchStr, [](const LogRecordFilter::TextMatcher &text, const LOG_MSG_DMESG &msg) { return LogRecordFilter::matchDmesg(text, msg); });
+        const LogSearchHits::Fields<LOG_MSG_DMESG> hitFields {
+            {DMESG_SPACE::dmesgDateTimeColumn, &LOG_MSG_DMESG::dateTime},
+            {DMESG_SPACE::dmesgMsgColumn, &LOG_MSG_DMESG::msg}
+        };
+        searchInBackground<LOG_MSG_DMESG>(dmesgListOrigin, dmesgList, match, hitFields, QString(),
+                                          [this](const LogRecordView<LOG_MSG_DMESG> &list) { createDmesgTable(list); },
+                                          [this](const LogRecordView<LOG_MSG_DMESG> &list) { insertDmesgTable(list, 0, list.count()); });
     }
     break;
+    case OtherLog:
     case CustomLog: {
-        cList.clear();
-        cList = filterOOC(m_currentSearchStr, cListOrigin);
         createOOCTableForm();
-        createOOCTable(cList);
+        std::function<bool(const LOG_FILE_OTHERORCUSTOM &)> match;
+        if (!searchStr.isEmpty())
+            match = searchPredicate<LOG_FILE_OTHERORCUSTOM>(searchStr, [](const LogRecordFilter::TextMatcher &text, const LOG_FILE_OTHERORCUSTOM &msg) { return LogRecordFilter::matchOOC(text, msg); });
+        const LogSearchHits::Fields<LOG_FILE_OTHERORCUSTOM> hitFields {{0, &LOG_FILE_OTHERORCUSTOM::name}};
+        searchInBackground<LOG_FILE_OTHERORCUSTOM>(m_flag == OtherLog ? oListOrigin : cListOrigin, m_flag == OtherLog ? oList : cList, match, hitFields, QString(),
+                                                   [this](const LogRecordView<LOG_FILE_OTHERORCUSTOM> &list) { createOOCTable(list); },
+                                                   [this](const LogRecordView<LOG_FILE_OTHERORCUSTOM> &list) { insertOOCTable(list, 0, list.count()); });
     }
     break;
     case Audit: {
-        aList.clear();
-        m_auditFilter.searchstr = m_currentSearchStr;
-        aList = filterAudit(m_auditFilter, aListOrigin);
+        m_auditFilter.searchstr = searchStr;
         createAuditTableForm();
-        createAuditTable(aList);
+        std::function<bool(const LOG_MSG_AUDIT &)> match;
+        if (!searchStr.isEmpty() || m_auditFilter.auditTypeFilter >= -1) {
+            const int auditType = m_auditFilter.auditTypeFilter;
+            match = searchPredicate<LOG_MSG_AUDIT>(searchStr, [auditType](const LogRecordFilter::TextMatcher &text, const LOG_MSG_AUDIT &msg) { return LogRecordFilter::matchAudit(auditType, text, msg); });
+        }
+        const LogSearchHits::Fields<LOG_MSG_AUDIT> hitFields {
+            {AUDIT_SPACE::auditEventTypeColumn, &LOG_MSG_AUDIT::eventType},
+            {AUDIT_SPACE::auditDateTimeColumn, &LOG_MSG_AUDIT::dateTime},
+            {AUDIT_SPACE::auditProcessNameColumn, &LOG_MSG_AUDIT::processName},
+            {AUDIT_SPACE::auditStatusColumn, &LOG_MSG_AUDIT::status},
+            {AUDIT_SPACE::auditMsgColumn, &LOG_MSG_AUDIT::message}
+        };
+        searchInBackground<LOG_MSG_AUDIT>(aListOrigin, aList, match, hitFields, QString::number(m_auditFilter.auditTypeFilter),
+                                          [this](const LogRecordView<LOG_MSG_AUDIT> &list) { createAuditTable(list); },
+                                          [this](const LogRecordView<LOG_MSG_AUDIT> &list) { insertAuditTable(list, 0, list.count()); });
     }
     break;
     case COREDUMP: {
-        m_currentCoredumpList.clear();
-        m_currentCoredumpList = filterCoredump(m_currentSearchStr, m_coredumpList);
         createCoredumpTableForm();
-        createCoredumpTable(m_currentCoredumpList);
+        std::function<bool(const LOG_MSG_COREDUMP &)> match;
+        if (!searchStr.isEmpty())
+            match = searchPredicate<LOG_MSG_COREDUMP>(searchStr, [](const LogRecordFilter::TextMatcher &text, const LOG_MSG_COREDUMP &msg) { return LogRecordFilter::matchCoredump(text, msg); });
+        const LogSearchHits::Fields<LOG_MSG_COREDUMP> hitFields {
+            {COREDUMP_SPACE::COREDUMP_SIG_COLUMN, &LOG_MSG_COREDUMP::sig},
+            {COREDUMP_SPACE::COREDUMP_TIME_COLUMN, &LOG_MSG_COREDUMP::dateTime},
+            {COREDUMP_SPACE::COREDUMP_COREFILE_COLUMN, &LOG_MSG_COREDUMP::coreFile},
+            {COREDUMP_SPACE::COREDUMP_UNAME_COLUMN, &LOG_MSG_COREDUMP::uid},
+            {COREDUMP_SPACE::COREDUMP_EXE_COLUMN, &LOG_MSG_COREDUMP::exe}
+        };
+        searchInBackground<LOG_MSG_COREDUMP>(m_coredumpList, m_currentCoredumpList, match, hitFields, QString(),
+                                             [this](const LogRecordView<LOG_MSG_COREDUMP> &list) { createCoredumpTable(list); },
+                                             [this](const LogRecordView<LOG_MSG_COREDUMP> &list) { insertCoredumpTable(list, 0, list.count()); });
     }
     break;
     default:
         break;
     }
-    //如果搜索结果为空要显示无搜索结果提示
-    if (0 == m_pModel->rowCount()) {
-        if (m_currentSearchStr.isEmpty()) {
-            setLoadState(DATA_COMPLETE);
-        } else {
-            setLoadState(DATA_NO_SEARCH_RESULT);
-        }
-        m_detailWgt->cleanText();
-        m_detailWgt->hideLine(true);
-    } else {
-        setLoadState(DATA_COMPLETE);
-        m_detailWgt->hideLine(false);
-    }
 }
 
 /**
@@ -2693,27 +4171,60 @@ void DisplayContent::slot_searchResult(const QString &str)
  */
 void DisplayContent::slot_getLogtype(int tcbx)
 {
+    cancelSearch();
     m_normalFilter.eventTypeFilter = tcbx;
-    nortempList = filterNomal(m_normalFilter, norList);
+    nortempList = filterNomal(m_normalFilter, LogRecordView<LOG_MSG_NORMAL>::all(&norList));
     createNormalTableForm();
     createNormalTable(nortempList);
 }
 
 void DisplayContent::slot_getAuditType(int tcbx)
 {
+    cancelSearch();
     m_auditFilter.auditTypeFilter = tcbx;
-    aList = filterAudit(m_auditFilter, aListOrigin);
+    aList = filterAudit(m_auditFilter, LogRecordView<LOG_MSG_AUDIT>::all(&aListOrigin));
     createAuditTableForm();
     createAuditTable(aList);
 }
 
+/**
+ * @brief DisplayContent::slot_bootChanged klu启动日志切换启动,按新的bootid重新加载
+ * @param bootId 选择的bootid,为空表示当前启动
+ */
+void DisplayContent::slot_bootChanged(const QString &bootId)
+{
+    if (m_curBootId == bootId)
+        return;
+    m_curBootId = bootId;
+    if (m_flag == BOOT_KLU)
+        generateJournalBootFile(m_curLevel);
+}
+
+/**
+ * @brief DisplayContent::slot_journalFieldChanged 系统日志切换来源,按新的journal匹配重新加载,保留当前的搜索条件
+ * @param match 来源对应的journal匹配,为空表示全部来源
+ */
+void DisplayContent::slot_journalFieldChanged(const QString &match)
+{
+    if (m_journalFieldMatch == match)
+        return;
+    m_journalFieldMatch = match;
+    if (m_flag != JOURNAL)
+        return;
+    //筛选条件不变时不受防抖限制
+    m_lastJournalGetTime = QDateTime::fromTime_t(0);
+    generateJournalFile(m_journalFilter.timeFilter, m_journalFilter.eventTypeFilter, m_currentSearchStr);
+}
+
 /**
  * @brief DisplayContent::parseListToModel 把dpkglist加入model中以供treeview显示
  * @param iList 要加入model中的原始数据
  * @param oPModel 要增加数据的model指针
  */
-void DisplayContent::parseListToModel(const QList<LOG_MSG_DPKG> &iList, QStandardItemModel *oPModel)
+void DisplayContent::parseListToModel(const LogRecordView<LOG_MSG_DPKG> &iList, LogTableModel *oPModel)
 {
+    LogIngestSession::InsertScope ingest(m_ingest, iList.size());
+    PERF_ALLOC_SCOPE_UNITS("parseListToModel.dpkg", iList.size());
     if (!oPModel) {
         qCWarning(logDisplaycontent) << "dpkg parse model is empty";
         return;
@@ -2722,26 +4233,12 @@ void DisplayContent::parseListToModel(const QList<LOG_MSG_DPKG> &iList, QStandar
         qCWarning(logDisplaycontent) << "dpkg parse model data is empty";
         return;
     }
-    QList<LOG_MSG_DPKG> list = iList;
-    DStandardItem *item = nullptr;
-    QList<QStandardItem *> items;
-    //每次插一行，减少刷新次数，重写QStandardItemModel有问题
-    for (int i = 0; i < list.size(); i++) {
-        items.clear();
-        item = new DStandardItem(list[i].dateTime);
-        item->setData(DPKG_TABLE_DATA);
-        item->setAccessibleText(QString("treeview_context_%1_%2").arg(i).arg(0));
-        items << item;
-        item = new DStandardItem(list[i].msg);
-        item->setAccessibleText(QString("treeview_context_%1_%2").arg(i).arg(1));
-        item->setData(DPKG_TABLE_DATA);
-        items << item;
-        item = new DStandardItem(list[i].action);
-        item->setAccessibleText(QString("treeview_context_%1_%2").arg(i).arg(2));
-        item->setData(DPKG_TABLE_DATA);
-        items << item;
-        oPModel->insertRow(oPModel->rowCount(), items);
-    }
+    oPModel->setColumns<LOG_MSG_DPKG>(DPKG_TABLE_DATA, {
+        dateTimeColumn(&LOG_MSG_DPKG::dateTime),
+        textColumn(&LOG_MSG_DPKG::msg),
+        textColumn(&LOG_MSG_DPKG::action)
+    });
+    oPModel->appendRecords(iList);
 }
 
 /**
@@ -2749,32 +4246,23 @@ void DisplayContent::parseListToModel(const QList<LOG_MSG_DPKG> &iList, QStandar
  * @param iList 要加入model中的原始数据
  * @param oPModel 要增加数据的model指针
  */
-void DisplayContent::parseListToModel(const QList<LOG_MSG_BOOT> &iList, QStandardItemModel *oPModel)
+void DisplayContent::parseListToModel(const LogRecordView<LOG_MSG_BOOT> &iList, LogTableModel *oPModel)
 {
+    LogIngestSession::InsertScope ingest(m_ingest, iList.size());
+    PERF_ALLOC_SCOPE_UNITS("parseListToModel.boot", iList.size());
     if (!oPModel) {
         qCWarning(logDisplaycontent) << "boot parse model is empty";
         return;
     }
-
     if (iList.isEmpty()) {
         qCWarning(logDisplaycontent) << "boot parse model data is empty";
         return;
     }
-    QList<LOG_MSG_BOOT> list = iList;
-    DStandardItem *item = nullptr;
-    QList<QStandardItem *> items;
-    for (int i = 0; i < list.size(); i++) {
-        items.clear();
-        item = new DStandardItem(list[i].status);
-        item->setAccessibleText(QString("treeview_context_%1_%2").arg(i).arg(0));
-        item->setData(BOOT_TABLE_DATA);
-        items << item;
-        item = new DStandardItem(list[i].msg);
-        item->setAccessibleText(QString("treeview_context_%1_%2").arg(i).arg(1));
-        item->setData(BOOT_TABLE_DATA);
-        items << item;
-        oPModel->insertRow(oPModel->rowCount(), items);
-    }
+    oPModel->setColumns<LOG_MSG_BOOT>(BOOT_TABLE_DATA, {
+        textColumn(&LOG_MSG_BOOT::status),
+        textColumn(&LOG_MSG_BOOT::msg)
+    });
+    oPModel->appendRecords(iList);
 }
 
 /**
@@ -2782,48 +4270,36 @@ void DisplayContent::parseListToModel(const QList<LOG_MSG_BOOT> &iList, QStandar
  * @param iList 要加入model中的原始数据
  * @param oPModel 要增加数据的model指针
  */
-void DisplayContent::parseListToModel(QList<LOG_MSG_APPLICATOIN> iList, QStandardItemModel *oPModel)
+void DisplayContent::parseListToModel(const LogRecordView<LOG_MSG_APPLICATOIN> &iList, LogTableModel *oPModel)
 {
+    LogIngestSession::InsertScope ingest(m_ingest, iList.size());
+    PERF_ALLOC_SCOPE_UNITS("parseListToModel.app", iList.size());
     if (!oPModel) {
         qCWarning(logDisplaycontent) << "app log parse model is empty";
         return;
     }
-
     if (iList.isEmpty()) {
         qCWarning(logDisplaycontent) << "app log parse model data is empty";
         return;
     }
-    QList<QStandardItem *> items;
-    DStandardItem *item = nullptr;
-    int listCount = iList.size();
-    for (int i = 0; i < listCount; i++) {
-        items.clear();
-        QString CH_str = m_transDict.value(iList[i].level);
-        QString lvStr = CH_str.isEmpty() ? iList[i].level : CH_str;
-        item = new DStandardItem();
-        QString iconPath = m_iconPrefix + getIconByname(iList[i].level);
-        if (getIconByname(iList[i].level).isEmpty())
-            item->setText(lvStr);
-        item->setIcon(QIcon(iconPath));
-        item->setData(APP_TABLE_DATA);
-        item->setData(lvStr, Log_Item_SPACE::levelRole);
-        item->setAccessibleText(QString("treeview_context_%1_%2").arg(i).arg(0));
-        items << item;
-        item = new DStandardItem(iList[i].dateTime);
-        item->setData(APP_TABLE_DATA);
-        item->setAccessibleText(QString("treeview_context_%1_%2").arg(i).arg(1));
-        items << item;
-        item = new DStandardItem(getAppName(m_curAppLog));
-        item->setData(APP_TABLE_DATA);
-        item->setAccessibleText(QString("treeview_context_%1_%2").arg(i).arg(2));
-        items << item;
-        item = new DStandardItem(iList[i].msg);
-        item->setData(APP_TABLE_DATA);
-        item->setData(iList[i].detailInfo, Qt::UserRole + 99);
-        item->setAccessibleText(QString("treeview_context_%1_%2").arg(i).arg(3));
-        items << item;
-        oPModel->insertRow(oPModel->rowCount(), items);
-    }
+    const QString appName = getAppName(m_curAppLog);
+    oPModel->setColumns<LOG_MSG_APPLICATOIN>(APP_TABLE_DATA, {
+        LogTableModel::sortKeyColumn<LOG_MSG_APPLICATOIN>([this](const LOG_MSG_APPLICATOIN &record, int role) -> QVariant {
+            const QString text = LogLevel::text(record.level);
+            return levelData(m_iconPrefix, levelIcon(record.level), text, text, role);
+        }, [](const LOG_MSG_APPLICATOIN &record) { return levelOrder(record.level); }),
+        dateTimeColumn(&LOG_MSG_APPLICATOIN::dateTime),
+        [appName](const LOG_MSG_APPLICATOIN &, int role) -> QVariant {
+            return role == Qt::DisplayRole ? QVariant(appName) : QVariant();
+        },
+        [](const LOG_MSG_APPLICATOIN &record, int role) -> QVariant {
+            //详情中显示完整信息,被截断时在打开详情时读取
+            if (role == Qt::UserRole + 99)
+                return LogLongMessage().fullText(record);
+            return role == Qt::DisplayRole ? QVariant(record.msg) : QVariant();
+        }
+    });
+    oPModel->appendRecords(iList);
 }
 
 /**
@@ -2831,32 +4307,25 @@ void DisplayContent::parseListToModel(QList<LOG_MSG_APPLICATOIN> iList, QStandar
  * @param iList 要加入model中的原始数据
  * @param oPModel 要增加数据的model指针
  */
-void DisplayContent::parseListToModel(QList<LOG_MSG_XORG> iList, QStandardItemModel *oPModel)
+void DisplayContent::parseListToModel(const LogRecordView<LOG_MSG_XORG> &iList, LogTableModel *oPModel)
 {
+    LogIngestSession::InsertScope ingest(m_ingest, iList.size());
+    PERF_ALLOC_SCOPE_UNITS("parseListToModel.xorg", iList.size());
     if (!oPModel) {
         qCWarning(logDisplaycontent) << "xorg log parse model is empty";
         return;
     }
-
     if (iList.isEmpty()) {
         qCWarning(logDisplaycontent) << "xorg log parse model data is empty";
         return;
     }
-    DStandardItem *item = nullptr;
-    QList<QStandardItem *> items;
-    int listCount = iList.size();
-    for (int i = 0; i < listCount; i++) {
-        items.clear();
-        item = new DStandardItem(iList[i].offset);
-        item->setData(XORG_TABLE_DATA);
-        item->setAccessibleText(QString("treeview_context_%1_%2").arg(i).arg(0));
-        items << item;
-        item = new DStandardItem(iList[i].msg);
-        item->setData(XORG_TABLE_DATA);
-        item->setAccessibleText(QString("treeview_context_%1_%2").arg(i).arg(1));
-        items << item;
-        oPModel->insertRow(oPModel->rowCount(), items);
-    }
+    oPModel->setColumns<LOG_MSG_XORG>(XORG_TABLE_DATA, {
+        LogTableModel::sortKeyColumn<LOG_MSG_XORG>(textColumn(&LOG_MSG_XORG::offset), [](const LOG_MSG_XORG &record) {
+            return record.offsetUsec;
+        }),
+        textColumn(&LOG_MSG_XORG::msg)
+    });
+    oPModel->appendRecords(iList);
 }
 
 /**
@@ -2864,40 +4333,28 @@ void DisplayContent::parseListToModel(QList<LOG_MSG_XORG> iList, QStandardItemMo
  * @param iList 要加入model中的原始数据
  * @param oPModel 要增加数据的model指针
  */
-void DisplayContent::parseListToModel(QList<LOG_MSG_NORMAL> iList, QStandardItemModel *oPModel)
+void DisplayContent::parseListToModel(const LogRecordView<LOG_MSG_NORMAL> &iList, LogTableModel *oPModel)
 {
+    LogIngestSession::InsertScope ingest(m_ingest, iList.size());
+    PERF_ALLOC_SCOPE_UNITS("parseListToModel.normal", iList.size());
     if (!oPModel) {
         qCWarning(logDisplaycontent) << "boot-shutdown-event log parse model is empty";
         return;
     }
-
     if (iList.isEmpty()) {
         qCWarning(logDisplaycontent) << "boot-shutdown-event log parse model data is empty";
         return;
     }
-    DStandardItem *item = nullptr;
-    QList<QStandardItem *> items;
-    int listCount = iList.size();
-    for (int i = 0; i < listCount; i++) {
-        items.clear();
-        item = new DStandardItem(iList[i].eventType);
-        item->setData(LAST_TABLE_DATA);
-        item->setAccessibleText(QString("treeview_context_%1_%2").arg(i).arg(0));
-        items << item;
-        item = new DStandardItem(iList[i].userName);
-        item->setData(LAST_TABLE_DATA);
-        item->setAccessibleText(QString("treeview_context_%1_%2").arg(i).arg(1));
-        items << item;
-        item = new DStandardItem(iList[i].dateTime);
-        item->setData(LAST_TABLE_DATA);
-        item->setAccessibleText(QString("treeview_context_%1_%2").arg(i).arg(2));
-        items << item;
-        item = new DStandardItem(iList[i].msg);
-        item->setData(LAST_TABLE_DATA);
-        item->setAccessibleText(QString("treeview_context_%1_%2").arg(i).arg(3));
-        items << item;
-        oPModel->insertRow(oPModel->rowCount(), items);
-    }
+    oPModel->setColumns<LOG_MSG_NORMAL>(LAST_TABLE_DATA, {
+        textColumn(&LOG_MSG_NORMAL::eventType),
+        textColumn(&LOG_MSG_NORMAL::userName),
+        //按wtmp中的时间排序,不再解析时间文本
+        LogTableModel::sortKeyColumn<LOG_MSG_NORMAL>(textColumn(&LOG_MSG_NORMAL::dateTime), [](const LOG_MSG_NORMAL &record) {
+            return record.time;
+        }),
+        textColumn(&LOG_MSG_NORMAL::msg)
+    });
+    oPModel->appendRecords(iList);
 }
 
 /**
@@ -2905,213 +4362,157 @@ void DisplayContent::parseListToModel(QList<LOG_MSG_NORMAL> iList, QStandardItem
  * @param iList 要加入model中的原始数据
  * @param oPModel 要增加数据的model指针
  */
-void DisplayContent::parseListToModel(QList<LOG_MSG_KWIN> iList, QStandardItemModel *oPModel)
+void DisplayContent::parseListToModel(const LogRecordView<LOG_MSG_KWIN> &iList, LogTableModel *oPModel, int row)
 {
+    LogIngestSession::InsertScope ingest(m_ingest, iList.size());
+    PERF_ALLOC_SCOPE_UNITS("parseListToModel.kwin", iList.size());
     if (!oPModel) {
         qCWarning(logDisplaycontent) << "kwin log parse model is empty";
         return;
     }
-
     if (iList.isEmpty()) {
         qCWarning(logDisplaycontent) << "kwin log parse model data is empty";
         return;
     }
-    DStandardItem *item = nullptr;
-    QList<QStandardItem *> items;
-    int listCount = iList.size();
-    for (int i = 0; i < listCount; i++) {
-        items.clear();
-        item = new DStandardItem(iList[i].msg);
-        item->setData(KWIN_TABLE_DATA);
-        item->setAccessibleText(QString("treeview_context_%1_%2").arg(i).arg(0));
-        items << item;
-        oPModel->insertRow(oPModel->rowCount(), items);
-    }
+    oPModel->setColumns<LOG_MSG_KWIN>(KWIN_TABLE_DATA, {
+        textColumn(&LOG_MSG_KWIN::msg)
+    });
+    oPModel->insertRecords(row, iList);
 }
 
-void DisplayContent::parseListToModel(QList<LOG_MSG_DNF> iList, QStandardItemModel *oPModel)
+void DisplayContent::parseListToModel(const LogRecordView<LOG_MSG_DNF> &iList, LogTableModel *oPModel)
 {
+    LogIngestSession::InsertScope ingest(m_ingest, iList.size());
+    PERF_ALLOC_SCOPE_UNITS("parseListToModel.dnf", iList.size());
     if (!oPModel) {
         qCWarning(logDisplaycontent) << "dnf log parse model is empty";
         return;
     }
-
     if (iList.isEmpty()) {
         qCWarning(logDisplaycontent) << "dnf log parse model data is empty";
         return;
     }
-    QList<QStandardItem *> items;
-    DStandardItem *item = nullptr;
-    int listCount = iList.size();
-    for (int i = 0; i < listCount; i++) {
-        items.clear();
-        QString CH_str = m_transDict.value(iList[i].level);
-        QString lvStr = CH_str.isEmpty() ? iList[i].level : CH_str;
-        item = new DStandardItem();
-        QString iconPath = m_iconPrefix + m_dnfIconNameMap.value(iList[i].level);
-        if (m_dnfIconNameMap.value(iList[i].level).isEmpty())
-            item->setText(iList[i].level);
-        item->setIcon(QIcon(iconPath));
-        item->setData(DNF_TABLE_DATA);
-        item->setData(lvStr, Log_Item_SPACE::levelRole);
-        items << item;
-        item = new DStandardItem(iList[i].dateTime);
-        item->setData(DNF_TABLE_DATA);
-        items << item;
-        item = new DStandardItem(iList[i].msg);
-        item->setData(DNF_TABLE_DATA);
-        items << item;
-        oPModel->insertRow(oPModel->rowCount(), items);
-    }
-}
-
-void DisplayContent::parseListToModel(QList<LOG_MSG_DMESG> iList, QStandardItemModel *oPModel)
+    oPModel->setColumns<LOG_MSG_DNF>(DNF_TABLE_DATA, {
+        LogTableModel::sortKeyColumn<LOG_MSG_DNF>([this](const LOG_MSG_DNF &record, int role) -> QVariant {
+            const QString text = LogLevel::dnfText(record.level);
+            return levelData(m_iconPrefix, dnfLevelIcon(record.level), text, text, role);
+        }, [](const LOG_MSG_DNF &record) { return dnfLevelOrder(record.level); }),
+        dateTimeColumn(&LOG_MSG_DNF::dateTime),
+        textColumn(&LOG_MSG_DNF::msg)
+    });
+    oPModel->appendRecords(iList);
+}
+
+void DisplayContent::parseListToModel(const LogRecordView<LOG_MSG_DMESG> &iList, LogTableModel *oPModel)
 {
+    LogIngestSession::InsertScope ingest(m_ingest, iList.size());
+    PERF_ALLOC_SCOPE_UNITS("parseListToModel.dmesg", iList.size());
     if (!oPModel) {
         qCWarning(logDisplaycontent) << "dmesg log parse model is empty";
         return;
     }
-
     if (iList.isEmpty()) {
         qCWarning(logDisplaycontent) << "dmesg log parse model data is empty";
         return;
     }
-    QList<QStandardItem *> items;
-    DStandardItem *item = nullptr;
-    int listCount = iList.size();
-    for (int i = 0; i < listCount; i++) {
-        items.clear();
-        item = new DStandardItem();
-        QString iconPath = m_iconPrefix + getIconByname(iList[i].level);
-
-        if (getIconByname(iList[i].level).isEmpty())
-            item->setText(iList[i].level);
-        item->setIcon(QIcon(iconPath));
-        item->setData(DMESG_TABLE_DATA);
-        item->setData(iList[i].level, Log_Item_SPACE::levelRole);
-        items << item;
-        item = new DStandardItem(iList[i].dateTime);
-        item->setData(DMESG_TABLE_DATA);
-        items << item;
-        item = new DStandardItem(iList[i].msg);
-        item->setData(DMESG_TABLE_DATA);
-        items << item;
-        oPModel->insertRow(oPModel->rowCount(), items);
-    }
+    oPModel->setColumns<LOG_MSG_DMESG>(DMESG_TABLE_DATA, {
+        LogTableModel::sortKeyColumn<LOG_MSG_DMESG>([this](const LOG_MSG_DMESG &record, int role) -> QVariant {
+            const QString text = LogLevel::text(record.level);
+            return levelData(m_iconPrefix, levelIcon(record.level), text, text, role);
+        }, [](const LOG_MSG_DMESG &record) { return levelOrder(record.level); }),
+        dateTimeColumn(&LOG_MSG_DMESG::dateTime),
+        textColumn(&LOG_MSG_DMESG::msg)
+    });
+    oPModel->appendRecords(iList);
 }
 
-void DisplayContent::parseListToModel(QList<LOG_FILE_OTHERORCUSTOM> iList, QStandardItemModel *oPModel)
+void DisplayContent::parseListToModel(const LogRecordView<LOG_FILE_OTHERORCUSTOM> &iList, LogTableModel *oPModel)
 {
+    LogIngestSession::InsertScope ingest(m_ingest, iList.size());
+    PERF_ALLOC_SCOPE_UNITS("parseListToModel.ooc", iList.size());
     if (!oPModel) {
         qCWarning(logDisplaycontent) << "other log parse model is empty";
         return;
     }
-
     if (iList.isEmpty()) {
         qCWarning(logDisplaycontent) << "other log parse model data is empty";
         return;
     }
-    QList<QStandardItem *> items;
-    DStandardItem *item = nullptr;
-    int listCount = iList.size();
-    for (int i = 0; i < listCount; i++) {
-        items.clear();
-        item = new DStandardItem(QFileIconProvider().icon(QFileInfo(iList[i].path)), iList[i].name);
-        item->setData(iList[i].path, Qt::UserRole + 2);
-        item->setData(OOC_TABLE_DATA);
-        items << item;
-        item = new DStandardItem(iList[i].dateTimeModify);
-        item->setData(OOC_TABLE_DATA);
-        items << item;
-        oPModel->insertRow(oPModel->rowCount(), items);
-    }
+    oPModel->setColumns<LOG_FILE_OTHERORCUSTOM>(OOC_TABLE_DATA, {
+        [](const LOG_FILE_OTHERORCUSTOM &record, int role) -> QVariant {
+            switch (role) {
+            case Qt::DisplayRole:
+                return record.name;
+            case Qt::DecorationRole:
+                return QFileIconProvider().icon(QFileInfo(record.path));
+            case Qt::UserRole + 2:
+                return record.path;
+            default:
+                return QVariant();
+            }
+        },
+        dateTimeColumn(&LOG_FILE_OTHERORCUSTOM::dateTimeModify)
+    });
+    oPModel->appendRecords(iList);
 }
 
-void DisplayContent::parseListToModel(QList<LOG_MSG_AUDIT> iList, QStandardItemModel *oPModel)
+void DisplayContent::parseListToModel(const LogRecordView<LOG_MSG_AUDIT> &iList, LogTableModel *oPModel)
 {
+    LogIngestSession::InsertScope ingest(m_ingest, iList.size());
+    PERF_ALLOC_SCOPE_UNITS("parseListToModel.audit", iList.size());
     if (!oPModel) {
         qCWarning(logDisplaycontent) << "audit log parse model is empty";
         return;
     }
-
     if (iList.isEmpty()) {
         qCWarning(logDisplaycontent) << "audit log parse model data is empty";
         return;
     }
-    QList<QStandardItem *> items;
-    DStandardItem *item = nullptr;
-    int listCount = iList.size();
-    for (int i = 0; i < listCount; i++) {
-        items.clear();
-        item = new DStandardItem(iList[i].eventType);
-        item->setData(AUDIT_TABLE_DATA);
-        item->setAccessibleText(QString("treeview_context_%1_%2").arg(i).arg(0));
-        items << item;
-        item = new DStandardItem(iList[i].dateTime);
-        item->setData(AUDIT_TABLE_DATA);
-        item->setAccessibleText(QString("treeview_context_%1_%2").arg(i).arg(1));
-        items << item;
-        item = new DStandardItem(iList[i].processName);
-        item->setData(AUDIT_TABLE_DATA);
-        item->setAccessibleText(QString("treeview_context_%1_%2").arg(i).arg(2));
-        items << item;
-        item = new DStandardItem(iList[i].status);
-        item->setData(AUDIT_TABLE_DATA);
-        item->setAccessibleText(QString("treeview_context_%1_%2").arg(i).arg(3));
-        items << item;
-        item = new DStandardItem(iList[i].msg);
-        item->setData(AUDIT_TABLE_DATA);
-        item->setData(iList[i].origin, AUDIT_ORIGIN_DATAROLE);
-        item->setAccessibleText(QString("treeview_context_%1_%2").arg(i).arg(4));
-        items << item;
-        oPModel->insertRow(oPModel->rowCount(), items);
-    }
-}
-
-void DisplayContent::parseListToModel(QList<LOG_MSG_COREDUMP> iList, QStandardItemModel *oPModel)
+    oPModel->setColumns<LOG_MSG_AUDIT>(AUDIT_TABLE_DATA, {
+        textColumn(&LOG_MSG_AUDIT::eventType),
+        dateTimeColumn(&LOG_MSG_AUDIT::dateTime),
+        textColumn(&LOG_MSG_AUDIT::processName),
+        textColumn(&LOG_MSG_AUDIT::status),
+        [](const LOG_MSG_AUDIT &record, int role) -> QVariant {
+            if (role == AUDIT_ORIGIN_DATAROLE)
+                return record.origin;
+            return role == Qt::DisplayRole ? QVariant(record.msg) : QVariant();
+        }
+    });
+    oPModel->appendRecords(iList);
+}
+
+void DisplayContent::parseListToModel(const LogRecordView<LOG_MSG_COREDUMP> &iList, LogTableModel *oPModel)
 {
+    LogIngestSession::InsertScope ingest(m_ingest, iList.size());
+    PERF_ALLOC_SCOPE_UNITS("parseListToModel.coredump", iList.size());
     if (!oPModel) {
         qCWarning(logDisplaycontent) << "coredump log parse model is empty";
         return;
     }
-
     if (iList.isEmpty()) {
         qCWarning(logDisplaycontent) << "coredump log parse model data is empty";
         return;
     }
-    QList<QStandardItem *> items;
-    DStandardItem *item = nullptr;
-    int listCount = iList.size();
-    for (int i = 0; i < listCount; i++) {
-        items.clear();
-
-        item = new DStandardItem(iList[i].sig);
-        item->setData(COREDUMP_TABLE_DATA);
-        item->setAccessibleText(QString("treeview_context_%1_%2").arg(i).arg(0));
-        items << item;
-
-        item = new DStandardItem(iList[i].dateTime);
-        item->setData(COREDUMP_TABLE_DATA);
-        item->setAccessibleText(QString("treeview_context_%1_%2").arg(i).arg(1));
-        items << item;
-
-        item = new DStandardItem(iList[i].coreFile);
-        item->setData(COREDUMP_TABLE_DATA);
-        item->setAccessibleText(QString("treeview_context_%1_%2").arg(i).arg(2));
-        items << item;
-
-        item = new DStandardItem(iList[i].uid);
-        item->setData(COREDUMP_TABLE_DATA);
-        item->setAccessibleText(QString("treeview_context_%1_%2").arg(i).arg(3));
-        items << item;
-
-        item = new DStandardItem(iList[i].exe);
-        item->setData(iList[i].storagePath, Qt::UserRole + 2);
-        item->setData(COREDUMP_TABLE_DATA);
-        item->setAccessibleText(QString("treeview_context_%1_%2").arg(i).arg(4));
-        items << item;
-        oPModel->insertRow(oPModel->rowCount(), items);
-    }
+    oPModel->setColumns<LOG_MSG_COREDUMP>(COREDUMP_TABLE_DATA, {
+        textColumn(&LOG_MSG_COREDUMP::sig),
+        dateTimeColumn(&LOG_MSG_COREDUMP::dateTime),
+        textColumn(&LOG_MSG_COREDUMP::coreFile),
+        numberColumn(&LOG_MSG_COREDUMP::uid),
+        [](const LOG_MSG_COREDUMP &record, int role) -> QVariant {
+            switch (role) {
+            case Qt::DisplayRole:
+                return record.exe;
+            case Qt::UserRole + 2:
+                return record.storagePath;
+            case Log_Item_SPACE::journalCursorRole:
+                return record.cursor;
+            default:
+                return QVariant();
+            }
+        }
+    });
+    oPModel->appendRecords(iList);
 }
 
 /**
@@ -3200,6 +4601,10 @@ void DisplayContent::setLoadState(DisplayContent::LOAD_STATE iState)
     }
     }
     this->update();
+    if (!m_firstScreenShown && iState != DATA_LOADING && iState != DATA_LOADING_K) {
+        m_firstScreenShown = true;
+        emit firstScreenReady();
+    }
 }
 
 /**
@@ -3208,6 +4613,7 @@ void DisplayContent::setLoadState(DisplayContent::LOAD_STATE iState)
  */
 void DisplayContent::onExportResult(bool isSuccess)
 {
+    setPrefetchPaused(false);
     QString titleIcon = ICONPREFIX;
     if (m_exportDlg && !m_exportDlg->isHidden()) {
         m_exportDlg->hide();
@@ -3250,18 +4656,42 @@ void DisplayContent::clearAllFilter()
  */
 void DisplayContent::clearAllDatalist()
 {
+    cancelSearch();
+    cancelCollapseSimilar();
+    cancelSearchIndex();
+    m_aggregates.clear();
+    if (m_summaryDlg)
+        m_summaryDlg->refresh();
+    m_searchState = SearchState();
     m_detailWgt->cleanText();
     m_pModel->clear();
     jList.clear();
     jListOrigin.clear();
+    m_journalIncrementList.clear();
+    m_journalNewestCursor.clear();
+    m_journalIncremental = false;
+    m_journalFollowIndex = -1;
+    m_journalWindowEnd = -1;
+    m_journalSearchDeferred = false;
+    m_journalOlderWindow = false;
+    if (m_journalWindowMessage)
+        m_journalWindowMessage->close();
     dList.clear();
     dListOrigin.clear();
+    m_dpkgTransactions.clear();
+    m_dpkgExpanded.clear();
+    m_dpkgSummaryRows.clear();
     xList.clear();
     xListOrigin.clear();
     bList.clear();
     currentBootList.clear();
     kList.clear();
     kListOrigin.clear();
+    m_kernIncrementList.clear();
+    m_kernIncremental = false;
+    m_kwinTail.reset();
+    m_kwinIncrementList.clear();
+    m_kwinIncremental = false;
     appList.clear();
     appListOrigin.clear();
     norList.clear();
@@ -3272,6 +4702,8 @@ void DisplayContent::clearAllDatalist()
     jBootListOrigin.clear();
     dnfList.clear();
     dnfListOrigin.clear();
+    dmesgList.clear();
+    dmesgListOrigin.clear();
     oList.clear();
     oListOrigin.clear();
     cList.clear();
@@ -3283,217 +4715,131 @@ void DisplayContent::clearAllDatalist()
     malloc_trim(0);
 }
 
-QList<LOG_MSG_BOOT> DisplayContent::filterBoot(BOOT_FILTERS ibootFilter, const QList<LOG_MSG_BOOT> &iList)
+LogRecordView<LOG_MSG_BOOT> DisplayContent::filterBoot(BOOT_FILTERS ibootFilter, const LogRecordView<LOG_MSG_BOOT> &iList)
 {
-    QList<LOG_MSG_BOOT> rsList;
-    bool isStatusFilterEmpty = ibootFilter.statusFilter.isEmpty();
-    if (isStatusFilterEmpty && ibootFilter.searchstr.isEmpty()) {
+    if (ibootFilter.statusFilter.isEmpty() && ibootFilter.searchstr.isEmpty())
         return iList;
-    } else {
-        for (int i = 0; i < iList.size(); i++) {
-            LOG_MSG_BOOT msg = iList.at(i);
-            QString _statusStr = msg.status;
-            if ((_statusStr.compare(ibootFilter.statusFilter, Qt::CaseInsensitive) != 0) && !isStatusFilterEmpty)
-                continue;
-            if ((msg.status.contains(ibootFilter.searchstr, Qt::CaseInsensitive)) || (msg.msg.contains(ibootFilter.searchstr, Qt::CaseInsensitive))) {
-                rsList.append(iList[i]);
-            }
-        }
-    }
-    return rsList;
+    const int statusFilter = LogParseMatchers::bootStatusFilter(ibootFilter.statusFilter);
+    return LogRecordFilter::filter(iList, searchPredicate<LOG_MSG_BOOT>(ibootFilter.searchstr, [statusFilter](const LogRecordFilter::TextMatcher &text, const LOG_MSG_BOOT &msg) {
+        return LogRecordFilter::matchBoot(statusFilter, text, msg);
+    }));
 }
 
-QList<LOG_MSG_NORMAL> DisplayContent::filterNomal(NORMAL_FILTERS inormalFilter, QList<LOG_MSG_NORMAL> &iList)
+LogRecordView<LOG_MSG_NORMAL> DisplayContent::filterNomal(NORMAL_FILTERS inormalFilter, const LogRecordView<LOG_MSG_NORMAL> &iList)
 {
-    QList<LOG_MSG_NORMAL> rsList;
-    if (inormalFilter.searchstr.isEmpty() && inormalFilter.eventTypeFilter < 0) {
+    if (inormalFilter.searchstr.isEmpty() && inormalFilter.eventTypeFilter < 0)
         return iList;
-    }
-    int tcbx = inormalFilter.eventTypeFilter;
-    if (0 == tcbx) {
-        for (auto i = 0; i < iList.size(); i++) {
-            LOG_MSG_NORMAL msg = iList.at(i);
-            if (msg.eventType.contains(inormalFilter.searchstr, Qt::CaseInsensitive) || msg.userName.contains(inormalFilter.searchstr, Qt::CaseInsensitive) || msg.dateTime.contains(inormalFilter.searchstr, Qt::CaseInsensitive) || msg.msg.contains(inormalFilter.searchstr, Qt::CaseInsensitive)) {
-                rsList.append(msg);
-            }
-        }
-    } else if (1 == tcbx) {
-        for (auto i = 0; i < iList.size(); i++) {
-            LOG_MSG_NORMAL msg = iList.at(i);
-            if (msg.eventType.contains(inormalFilter.searchstr, Qt::CaseInsensitive) || msg.userName.contains(inormalFilter.searchstr, Qt::CaseInsensitive) || msg.dateTime.contains(inormalFilter.searchstr, Qt::CaseInsensitive) || msg.msg.contains(inormalFilter.searchstr, Qt::CaseInsensitive)) {
-                if (msg.eventType.compare("Boot", Qt::CaseInsensitive) != 0 && msg.eventType.compare("shutdown", Qt::CaseInsensitive) != 0 && msg.eventType.compare("runlevel", Qt::CaseInsensitive) != 0)
-                    rsList.append(msg);
-            }
-        }
-    } else if (2 == tcbx) {
-        for (auto i = 0; i < iList.size(); i++) {
-            LOG_MSG_NORMAL msg = iList.at(i);
-            if (msg.eventType.contains(inormalFilter.searchstr, Qt::CaseInsensitive) || msg.userName.contains(inormalFilter.searchstr, Qt::CaseInsensitive) || msg.dateTime.contains(inormalFilter.searchstr, Qt::CaseInsensitive) || msg.msg.contains(inormalFilter.searchstr, Qt::CaseInsensitive)) {
-                if (iList[i].eventType.compare("Boot", Qt::CaseInsensitive) == 0)
-                    rsList.append(iList[i]);
-            }
-        }
-    } else if (3 == tcbx) {
-        for (auto i = 0; i < iList.size(); i++) {
-            LOG_MSG_NORMAL msg = iList.at(i);
-            if (msg.eventType.contains(inormalFilter.searchstr, Qt::CaseInsensitive) || msg.userName.contains(inormalFilter.searchstr, Qt::CaseInsensitive) || msg.dateTime.contains(inormalFilter.searchstr, Qt::CaseInsensitive) || msg.msg.contains(inormalFilter.searchstr, Qt::CaseInsensitive)) {
-                if (iList[i].eventType.compare("shutdown", Qt::CaseInsensitive) == 0)
-                    rsList.append(iList[i]);
-            }
-        }
-    }
-    return rsList;
+    const int eventType = inormalFilter.eventTypeFilter;
+    return LogRecordFilter::filter(iList, searchPredicate<LOG_MSG_NORMAL>(inormalFilter.searchstr, [eventType](const LogRecordFilter::TextMatcher &text, const LOG_MSG_NORMAL &msg) {
+        return LogRecordFilter::matchNormal(eventType, text, msg);
+    }));
 }
 
-QList<LOG_MSG_DPKG> DisplayContent::filterDpkg(const QString &iSearchStr, const QList<LOG_MSG_DPKG> &iList)
+LogRecordView<LOG_MSG_DPKG> DisplayContent::filterDpkg(const QString &iSearchStr, const LogRecordView<LOG_MSG_DPKG> &iList)
 {
-    QList<LOG_MSG_DPKG> rsList;
-    if (iSearchStr.isEmpty()) {
+    if (iSearchStr.isEmpty())
         return iList;
-    }
-
-    for (int i = 0; i < iList.size(); i++) {
-        LOG_MSG_DPKG msg = iList.at(i);
-        if (msg.dateTime.contains(iSearchStr, Qt::CaseInsensitive) || msg.msg.contains(iSearchStr, Qt::CaseInsensitive)) {
-            rsList.append(msg);
-        }
-    }
-    return rsList;
+    return LogRecordFilter::filter(iList, searchPredicate<LOG_MSG_DPKG>(iSearchStr, [](const LogRecordFilter::TextMatcher &text, const LOG_MSG_DPKG &msg) { return LogRecordFilter::matchDpkg(text, msg); }));
 }
 
-QList<LOG_MSG_JOURNAL> DisplayContent::filterKern(const QString &iSearchStr, const QList<LOG_MSG_JOURNAL> &iList)
+LogRecordView<LOG_MSG_JOURNAL> DisplayContent::filterKern(const QString &iSearchStr, const LogRecordView<LOG_MSG_JOURNAL> &iList)
 {
-    QList<LOG_MSG_JOURNAL> rsList;
-    if (iSearchStr.isEmpty()) {
+    if (iSearchStr.isEmpty())
         return iList;
-    }
-    for (int i = 0; i < iList.size(); i++) {
-        LOG_MSG_JOURNAL msg = iList.at(i);
-        if (msg.dateTime.contains(iSearchStr, Qt::CaseInsensitive) || msg.hostName.contains(iSearchStr, Qt::CaseInsensitive) || msg.daemonName.contains(iSearchStr, Qt::CaseInsensitive) || msg.msg.contains(iSearchStr, Qt::CaseInsensitive)) {
-            rsList.append(msg);
-        }
-    }
-    return rsList;
+    return LogRecordFilter::filter(iList, searchPredicate<LOG_MSG_JOURNAL>(iSearchStr, [](const LogRecordFilter::TextMatcher &text, const LOG_MSG_JOURNAL &msg) { return LogRecordFilter::matchKern(text, msg); }));
 }
 
-QList<LOG_MSG_XORG> DisplayContent::filterXorg(const QString &iSearchStr, const QList<LOG_MSG_XORG> &iList)
+LogRecordView<LOG_MSG_XORG> DisplayContent::filterXorg(const QString &iSearchStr, const LogRecordView<LOG_MSG_XORG> &iList)
 {
-    QList<LOG_MSG_XORG> rsList;
-    if (iSearchStr.isEmpty()) {
+    if (iSearchStr.isEmpty())
         return iList;
-    }
-    for (int i = 0; i < iList.size(); i++) {
-        LOG_MSG_XORG msg = iList.at(i);
-        if (msg.offset.contains(iSearchStr, Qt::CaseInsensitive) || msg.msg.contains(iSearchStr, Qt::CaseInsensitive))
-            rsList.append(msg);
-    }
-    return rsList;
+    return LogRecordFilter::filter(iList, searchPredicate<LOG_MSG_XORG>(iSearchStr, [](const LogRecordFilter::TextMatcher &text, const LOG_MSG_XORG &msg) { return LogRecordFilter::matchXorg(text, msg); }));
 }
 
-QList<LOG_MSG_KWIN> DisplayContent::filterKwin(const QString &iSearchStr, const QList<LOG_MSG_KWIN> &iList)
+LogRecordView<LOG_MSG_KWIN> DisplayContent::filterKwin(const QString &iSearchStr, const LogRecordView<LOG_MSG_KWIN> &iList)
 {
-    QList<LOG_MSG_KWIN> rsList;
-    if (iSearchStr.isEmpty()) {
+    if (iSearchStr.isEmpty())
         return iList;
-    }
-    for (int i = 0; i < iList.size(); i++) {
-        LOG_MSG_KWIN msg = iList.at(i);
-        if (msg.msg.contains(iSearchStr, Qt::CaseInsensitive))
-            rsList.append(msg);
-    }
-    return rsList;
+    return LogRecordFilter::filter(iList, searchPredicate<LOG_MSG_KWIN>(iSearchStr, [](const LogRecordFilter::TextMatcher &text, const LOG_MSG_KWIN &msg) { return LogRecordFilter::matchKwin(text, msg); }));
 }
 
-QList<LOG_MSG_APPLICATOIN> DisplayContent::filterApp(const QString &iSearchStr, const QList<LOG_MSG_APPLICATOIN> &iList)
+LogRecordView<LOG_MSG_DNF> DisplayContent::filterDnf(const QString &iSearchStr, const LogRecordView<LOG_MSG_DNF> &iList)
 {
-    QList<LOG_MSG_APPLICATOIN> rsList;
-    if (iSearchStr.isEmpty()) {
+    if (iSearchStr.isEmpty())
         return iList;
-    }
-    for (int i = 0; i < iList.size(); i++) {
-        LOG_MSG_APPLICATOIN msg = iList.at(i);
-        if (msg.dateTime.contains(iSearchStr, Qt::CaseInsensitive) || msg.level.contains(iSearchStr, Qt::CaseInsensitive) || msg.src.contains(iSearchStr, Qt::CaseInsensitive) || msg.msg.contains(iSearchStr, Qt::CaseInsensitive))
-            rsList.append(msg);
-    }
-    return rsList;
+    return LogRecordFilter::filter(iList, searchPredicate<LOG_MSG_DNF>(iSearchStr, [](const LogRecordFilter::TextMatcher &text, const LOG_MSG_DNF &msg) { return LogRecordFilter::matchDnf(text, msg); }));
 }
 
-QList<LOG_MSG_JOURNAL> DisplayContent::filterJournal(const QString &iSearchStr, const QList<LOG_MSG_JOURNAL> &iList)
+LogRecordView<LOG_MSG_DMESG> DisplayContent::filterDmesg(const QString &iSearchStr, const LogRecordView<LOG_MSG_DMESG> &iList)
 {
-    QList<LOG_MSG_JOURNAL> rsList;
-    if (iSearchStr.isEmpty()) {
+    if (iSearchStr.isEmpty())
         return iList;
-    }
-    for (int i = 0; i < iList.size(); i++) {
-        LOG_MSG_JOURNAL msg = iList.at(i);
-        if (msg.dateTime.contains(iSearchStr, Qt::CaseInsensitive) || msg.hostName.contains(iSearchStr, Qt::CaseInsensitive) || msg.daemonName.contains(iSearchStr, Qt::CaseInsensitive) || msg.daemonId.contains(iSearchStr, Qt::CaseInsensitive) || msg.level.contains(iSearchStr, Qt::CaseInsensitive) || msg.msg.contains(iSearchStr, Qt::CaseInsensitive))
-            rsList.append(msg);
-    }
-    return rsList;
+    return LogRecordFilter::filter(iList, searchPredicate<LOG_MSG_DMESG>(iSearchStr, [](const LogRecordFilter::TextMatcher &text, const LOG_MSG_DMESG &msg) { return LogRecordFilter::matchDmesg(text, msg); }));
 }
 
-QList<LOG_MSG_JOURNAL> DisplayContent::filterJournalBoot(const QString &iSearchStr, const QList<LOG_MSG_JOURNAL> &iList)
+LogRecordView<LOG_MSG_APPLICATOIN> DisplayContent::filterApp(const QString &iSearchStr, const LogRecordView<LOG_MSG_APPLICATOIN> &iList)
 {
-    QList<LOG_MSG_JOURNAL> rsList;
-    if (iSearchStr.isEmpty()) {
+    if (iSearchStr.isEmpty())
         return iList;
-    }
-    for (int i = 0; i < iList.size(); i++) {
-        LOG_MSG_JOURNAL msg = iList.at(i);
-        if (msg.dateTime.contains(iSearchStr, Qt::CaseInsensitive) || msg.hostName.contains(iSearchStr, Qt::CaseInsensitive) || msg.daemonName.contains(iSearchStr, Qt::CaseInsensitive) || msg.daemonId.contains(iSearchStr, Qt::CaseInsensitive) || msg.level.contains(iSearchStr, Qt::CaseInsensitive) || msg.msg.contains(iSearchStr, Qt::CaseInsensitive))
-            rsList.append(msg);
-    }
-    return rsList;
+    return LogRecordFilter::filter(iList, searchPredicate<LOG_MSG_APPLICATOIN>(iSearchStr, [](const LogRecordFilter::TextMatcher &text, const LOG_MSG_APPLICATOIN &msg) { return LogRecordFilter::matchApp(text, msg); }));
 }
 
-QList<LOG_FILE_OTHERORCUSTOM> DisplayContent::filterOOC(const QString &iSearchStr, const QList<LOG_FILE_OTHERORCUSTOM> &iList)
+/**
+ * @brief DisplayContent::filterJournal 按关键字筛选系统日志
+ * @param undecided 不为空时返回是否有被截断的信息需要读取完整内容才能确定是否匹配
+ */
+LogRecordView<LOG_MSG_JOURNAL> DisplayContent::filterJournal(const QString &iSearchStr, const LogRecordView<LOG_MSG_JOURNAL> &iList, bool *undecided)
 {
-    QList<LOG_FILE_OTHERORCUSTOM> rsList;
-    if (iSearchStr.isEmpty()) {
+    if (undecided)
+        *undecided = false;
+    if (iSearchStr.isEmpty())
         return iList;
-    }
-    for (int i = 0; i < iList.size(); i++) {
-        LOG_FILE_OTHERORCUSTOM msg = iList.at(i);
-        if (msg.name.contains(iSearchStr, Qt::CaseInsensitive) || msg.path.contains(iSearchStr, Qt::CaseInsensitive))
-            rsList.append(msg);
-    }
-    return rsList;
+    const LogQuery query(iSearchStr);
+    //在界面线程中调用,只匹配已读取的前缀,不通过游标读取完整信息;
+    //被截断的信息前缀不匹配时结果不确定,由调用者交给后台搜索重新筛选
+    std::shared_ptr<std::atomic_bool> truncated = std::make_shared<std::atomic_bool>(false);
+    const LogRecordView<LOG_MSG_JOURNAL> result = LogRecordFilter::filter(iList, query.predicate<LOG_MSG_JOURNAL>([truncated](const LogRecordFilter::TextMatcher &text, const LOG_MSG_JOURNAL &msg) {
+        //前缀字段和启动日志的匹配范围相同
+        if (LogRecordFilter::matchJournalBoot(text, msg))
+            return true;
+        if (!msg.cursor.isEmpty())
+            *truncated = true;
+        return false;
+    }, searchMode(), journalPushedDown(query)));
+    if (undecided)
+        *undecided = *truncated;
+    return result;
+}
+
+LogRecordView<LOG_MSG_JOURNAL> DisplayContent::filterJournalBoot(const QString &iSearchStr, const LogRecordView<LOG_MSG_JOURNAL> &iList)
+{
+    if (iSearchStr.isEmpty())
+        return iList;
+    return LogRecordFilter::filter(iList, searchPredicate<LOG_MSG_JOURNAL>(iSearchStr, [](const LogRecordFilter::TextMatcher &text, const LOG_MSG_JOURNAL &msg) { return LogRecordFilter::matchJournalBoot(text, msg); }));
 }
 
-QList<LOG_MSG_AUDIT> DisplayContent::filterAudit(AUDIT_FILTERS auditFilter, const QList<LOG_MSG_AUDIT> &iList)
+LogRecordView<LOG_FILE_OTHERORCUSTOM> DisplayContent::filterOOC(const QString &iSearchStr, const LogRecordView<LOG_FILE_OTHERORCUSTOM> &iList)
 {
-    QList<LOG_MSG_AUDIT> rsList;
-    if (auditFilter.searchstr.isEmpty() && auditFilter.auditTypeFilter < -1) {
+    if (iSearchStr.isEmpty())
         return iList;
-    }
-    int nAuditType = auditFilter.auditTypeFilter - 1;
-    for (int i = 0; i < iList.size(); i++) {
-        LOG_MSG_AUDIT msg = iList.at(i);
-        if (msg.contains(auditFilter.searchstr) && (nAuditType == -1 || msg.filterAuditType(nAuditType))) {
-            rsList.append(msg);
-        }
-    }
-
-    return rsList;
+    return LogRecordFilter::filter(iList, searchPredicate<LOG_FILE_OTHERORCUSTOM>(iSearchStr, [](const LogRecordFilter::TextMatcher &text, const LOG_FILE_OTHERORCUSTOM &msg) { return LogRecordFilter::matchOOC(text, msg); }));
 }
-QList<LOG_MSG_COREDUMP> DisplayContent::filterCoredump(const QString &iSearchStr, const QList<LOG_MSG_COREDUMP> &iList)
+
+LogRecordView<LOG_MSG_AUDIT> DisplayContent::filterAudit(AUDIT_FILTERS auditFilter, const LogRecordView<LOG_MSG_AUDIT> &iList)
 {
-    QList<LOG_MSG_COREDUMP> rsList;
-    if (iSearchStr.isEmpty()) {
+    if (auditFilter.searchstr.isEmpty() && auditFilter.auditTypeFilter < -1)
         return iList;
-    }
-    for (int i = 0; i < iList.size(); i++) {
-        LOG_MSG_COREDUMP msg = iList.at(i);
-        if (msg.sig.contains(iSearchStr, Qt::CaseInsensitive)
-                || msg.dateTime.contains(iSearchStr, Qt::CaseInsensitive)
-                || msg.coreFile.contains(iSearchStr, Qt::CaseInsensitive)
-                || msg.uid.contains(iSearchStr, Qt::CaseInsensitive)
-                || msg.exe.contains(iSearchStr, Qt::CaseInsensitive)) {
-            rsList.append(msg);
-        }
-    }
+    const int auditType = auditFilter.auditTypeFilter;
+    return LogRecordFilter::filter(iList, searchPredicate<LOG_MSG_AUDIT>(auditFilter.searchstr, [auditType](const LogRecordFilter::TextMatcher &text, const LOG_MSG_AUDIT &msg) {
+        return LogRecordFilter::matchAudit(auditType, text, msg);
+    }));
+}
 
-    return rsList;
+LogRecordView<LOG_MSG_COREDUMP> DisplayContent::filterCoredump(const QString &iSearchStr, const LogRecordView<LOG_MSG_COREDUMP> &iList)
+{
+    if (iSearchStr.isEmpty())
+        return iList;
+    return LogRecordFilter::filter(iList, searchPredicate<LOG_MSG_COREDUMP>(iSearchStr, [](const LogRecordFilter::TextMatcher &text, const LOG_MSG_COREDUMP &msg) { return LogRecordFilter::matchCoredump(text, msg); }));
 }
 
 /**
@@ -3523,37 +4869,27 @@ void DisplayContent::onExportProgress(int nCur, int nTotal)
  * @brief DisplayContent::parseListToModel 把系统日志数据list加入model中以供treeview显示
  * @param iList 要加入model中的原始数据
  * @param oPModel 要增加数据的model指针
+ * @param row 插入位置,-1表示追加到末尾
  */
-void DisplayContent::parseListToModel(QList<LOG_MSG_JOURNAL> iList, QStandardItemModel *oPModel)
+void DisplayContent::parseListToModel(const LogRecordView<LOG_MSG_JOURNAL> &iList, LogTableModel *oPModel, int row)
 {
+    LogIngestSession::InsertScope ingest(m_ingest, iList.size());
+    PERF_ALLOC_SCOPE_UNITS("parseListToModel.journal", iList.size());
     if (!oPModel) {
         qCWarning(logDisplaycontent) << "system log parse model is empty";
         return;
     }
-
     if (iList.isEmpty()) {
         qCWarning(logDisplaycontent) << "system log parse model data is empty";
         return;
     }
-    DStandardItem *item = nullptr;
-    QList<QStandardItem *> items;
-    int listCount = iList.size();
-    for (int i = 0; i < listCount; i++) {
-        items.clear();
-        item = new DStandardItem(iList[i].dateTime);
-        item->setData(KERN_TABLE_DATA);
-        items << item;
-        item = new DStandardItem(iList[i].hostName);
-        item->setData(KERN_TABLE_DATA);
-        items << item;
-        item = new DStandardItem(iList[i].daemonName);
-        item->setData(KERN_TABLE_DATA);
-        items << item;
-        item = new DStandardItem(iList[i].msg);
-        item->setData(KERN_TABLE_DATA);
-        items << item;
-        oPModel->insertRow(oPModel->rowCount(), items);
-    }
+    oPModel->setColumns<LOG_MSG_JOURNAL>(KERN_TABLE_DATA, {
+        dateTimeColumn(&LOG_MSG_JOURNAL::dateTime),
+        textColumn(&LOG_MSG_JOURNAL::hostName),
+        textColumn(&LOG_MSG_JOURNAL::daemonName),
+        textColumn(&LOG_MSG_JOURNAL::msg)
+    });
+    oPModel->insertRecords(row, iList);
 }
 
 /**
@@ -3568,19 +4904,43 @@ void DisplayContent::resizeEvent(QResizeEvent *event)
 }
 
 /**
- * @brief DisplayContent::getIconByname 获取日志等级信息对应的图标文件名
- * @param str 日志等级字符串
- * @return 日志等级图标文件名
+ * @brief DisplayContent::levelIcon 获取syslog等级对应的图标文件名
+ * @param level 等级,PRIORITY的值
+ * @return 图标文件名,没有图标时为空
+ */
+QString DisplayContent::levelIcon(int level)
+{
+    return level >= 0 && level < LogLevel::SyslogCount ? QString(levelIcons[level]) : QString();
+}
+
+/**
+ * @brief DisplayContent::dnfLevelIcon 获取dnf等级对应的图标文件名
+ * @param level 等级,DNFPRIORITY的值
  */
-QString DisplayContent::getIconByname(const QString &str)
+QString DisplayContent::dnfLevelIcon(int level)
 {
-    return m_icon_name_map.value(str);
+    return level >= TRACE && level <= SUPERCRITICAL ? QString(dnfLevelIcons[level - TRACE]) : QString();
+}
+
+/**
+ * @brief DisplayContent::levelOrder syslog等级的排序键,越严重越小,没有等级的排在最后
+ */
+qint64 DisplayContent::levelOrder(int level)
+{
+    return level >= 0 ? level : std::numeric_limits<int>::max();
+}
+
+/**
+ * @brief DisplayContent::dnfLevelOrder dnf等级的排序键,DNFPRIORITY越大越严重,排序时和syslog等级一样越严重越小
+ */
+qint64 DisplayContent::dnfLevelOrder(int level)
+{
+    return level >= TRACE ? SUPERCRITICAL - level : std::numeric_limits<int>::max();
 }
 
 void DisplayContent::createBootTableForm()
 {
     m_pModel->clear();
-    m_pModel->setColumnCount(2);
     m_pModel->setHorizontalHeaderLabels(QStringList() << DApplication::translate("Table", "Status")
                                         << DApplication::translate("Table", "Info"));
     m_treeView->setColumnWidth(0, STATUS_WIDTH);
@@ -3592,15 +4952,27 @@ void DisplayContent::createBootTableForm()
  * @param start 分页开始的数组下标
  * @param end 分页结束的数组下标
  */
-void DisplayContent::insertApplicationTable(const QList<LOG_MSG_APPLICATOIN> &list, int start, int end)
+void DisplayContent::insertApplicationTable(const LogRecordView<LOG_MSG_APPLICATOIN> &list, int start, int end)
 {
-    QList<LOG_MSG_APPLICATOIN> midList = list;
+    PERF_TRACE_SCOPE("model", "insertApplicationTable");
+    LogRecordView<LOG_MSG_APPLICATOIN> midList = list;
     if (end >= start) {
         midList = midList.mid(start, end - start);
     }
     parseListToModel(midList, m_pModel);
 }
 
+/**
+ * @brief DisplayContent::slot_logCleared 日志被清空后只丢弃来自这些文件的缓存,其他类别再次打开时仍可直接取缓存
+ * @param files 被清空的文件
+ * @param freed 释放的字节数
+ */
+void DisplayContent::slot_logCleared(const QStringList &files, qint64 freed)
+{
+    qCInfo(logDisplaycontent) << "log cleared:" << files << freed << "bytes";
+    m_logFileParse.invalidateFiles(files);
+}
+
 /**
  * @author Airy
  * @brief DisplayContent::slot_refreshClicked for refresh日志类型listview右键刷新数据槽函数
@@ -3620,8 +4992,15 @@ void DisplayContent::slot_refreshClicked(const QModelIndex &index)
 
     if (itemData.contains(JOUR_TREE_DATA, Qt::CaseInsensitive)) {
         // default level is info so PRIORITY=6
-        m_flag = JOURNAL;
-        generateJournalFile(m_curBtnId, m_curLevel);
+        //筛选条件和日期未变且上次已加载完成时,只增量获取新产生的日志;过了零点时间段的范围变了,重新加载
+        if (m_flag == JOURNAL && m_isDataLoadComplete && !m_journalIncremental && !m_journalNewestCursor.isEmpty()
+                && m_journalFilter.timeFilter == m_curBtnId && m_journalFilter.eventTypeFilter == m_curLevel
+                && m_journalLoadDate == QDate::currentDate()) {
+            generateJournalIncrement();
+        } else {
+            m_flag = JOURNAL;
+            generateJournalFile(m_curBtnId, m_curLevel);
+        }
     } else if (itemData.contains(DPKG_TREE_DATA, Qt::CaseInsensitive)) {
         m_flag = DPKG;
         generateDpkgFile(m_curBtnId);
@@ -3633,8 +5012,14 @@ void DisplayContent::slot_refreshClicked(const QModelIndex &index)
         m_flag = BOOT;
         generateBootFile();
     } else if (itemData.contains(KERN_TREE_DATA, Qt::CaseInsensitive)) {
-        m_flag = KERN;
-        generateKernFile(m_curBtnId);
+        //筛选条件和日期未变且上次已加载完成时,只读取新追加的日志
+        if (m_flag == KERN && m_isDataLoadComplete && !m_kernIncremental && !kListOrigin.isEmpty()
+                && m_kernFilterId == m_curBtnId && m_kernLoadDate == QDate::currentDate()) {
+            generateKernIncrement();
+        } else {
+            m_flag = KERN;
+            generateKernFile(m_curBtnId);
+        }
     } else if (itemData.contains(".cache")) {
         clearAllDatalist();
     } else if (itemData.contains(APP_TREE_DATA, Qt::CaseInsensitive)) {
@@ -3644,10 +5029,15 @@ void DisplayContent::slot_refreshClicked(const QModelIndex &index)
         m_flag = Normal;
         generateNormalFile(m_curBtnId);
     } else if (itemData.contains(KWIN_TREE_DATA, Qt::CaseInsensitive)) {
-        m_flag = Kwin;
-        KWIN_FILTERS filter;
-        filter.msg = "";
-        generateKwinFile(filter);
+        //上次已加载完成时只读取新追加的行
+        if (m_flag == Kwin && m_isDataLoadComplete && !m_kwinIncremental && m_kwinTail && m_kwinTail->offset > 0) {
+            generateKwinIncrement();
+        } else {
+            m_flag = Kwin;
+            KWIN_FILTERS filter;
+            filter.msg = "";
+            generateKwinFile(filter);
+        }
     } else if (itemData.contains(BOOT_KLU_TREE_DATA, Qt::CaseInsensitive)) {
         m_flag = BOOT_KLU;
         generateJournalBootFile(m_curLevel);
@@ -3683,20 +5073,37 @@ void DisplayContent::slot_dnfLevel(DNFPRIORITY iLevel)
 
 void DisplayContent::generateOOCFile(const QString &path)
 {
+    ensureTypeSetup(OtherLog);
     setLoadState(DATA_LOADING);
     m_detailWgt->cleanText();
     m_isDataLoadComplete = false;
-    m_OOCCurrentIndex = m_logFileParse.parseByOOC(path);
+    //声明了行格式的自定义日志按记录显示,由表格自己在线程池中读取
+    if (m_flag == CustomLog) {
+        if (const LogLineFormatPtr format = LogApplicationHelper::instance()->customLogFormat(path)) {
+            m_OOCCurrentIndex = -1;
+            m_detailWgt->showCustomRecords(path, format);
+            m_isDataLoadComplete = true;
+            setLoadState(DATA_COMPLETE);
+            return;
+        }
+    }
+    //归档中的类别从包中解压,不读取本机文件
+    const QString archivePrefix = m_archive ? LogArchive::sourcePath(m_archive->zipPath(), QString()) : QString();
+    if (m_archive && path.startsWith(archivePrefix))
+        m_OOCCurrentIndex = m_logFileParse.parseByArchive(m_archive, path.mid(archivePrefix.size()));
+    else
+        m_OOCCurrentIndex = m_logFileParse.parseByOOC(path);
 }
 
 void DisplayContent::generateOOCLogs(const OOC_TYPE &type, const QString &iSearchStr/* = ""*/)
 {
+    ensureTypeSetup(OtherLog);
     clearAllFilter();
     clearAllDatalist();
 
     QList<QStringList> files;
-    QList<LOG_FILE_OTHERORCUSTOM>* pListOrigin = nullptr;
-    QList<LOG_FILE_OTHERORCUSTOM>* pList = nullptr;
+    LogRecordStore<LOG_FILE_OTHERORCUSTOM>* pListOrigin = nullptr;
+    LogRecordView<LOG_FILE_OTHERORCUSTOM>* pList = nullptr;
 
     if (type == OOC_OTHER) {
         files = LogApplicationHelper::instance()->getOtherLogList();
@@ -3717,12 +5124,38 @@ void DisplayContent::generateOOCLogs(const OOC_TYPE &type, const QString &iSearc
         pListOrigin->append(logFileInfo);
     }
 
-    *pList = filterOOC(iSearchStr, *pListOrigin);
+    *pList = filterOOC(iSearchStr, LogRecordView<LOG_FILE_OTHERORCUSTOM>::all(pListOrigin));
 
     createOOCTableForm();
     createOOCTable(*pList);
 }
 
+/**
+ * @brief DisplayContent::generateArchiveLogs 其他日志列表显示打开的归档中的各类别,选中时才解压
+ */
+void DisplayContent::generateArchiveLogs()
+{
+    ensureTypeSetup(OtherLog);
+    clearAllFilter();
+    clearAllDatalist();
+
+    const QString archiveName = QFileInfo(m_archive->zipPath()).fileName();
+    for (const QString &category : m_archive->categories()) {
+        LOG_FILE_OTHERORCUSTOM logFileInfo;
+        logFileInfo.name = category.isEmpty() ? archiveName : category;
+        logFileInfo.path = LogArchive::sourcePath(m_archive->zipPath(), category);
+        QDateTime modified;
+        for (const LogArchive::Member &member : m_archive->members(category))
+            modified = qMax(modified, member.modified);
+        logFileInfo.dateTimeModify = modified.toString("yyyy-MM-dd hh:mm:ss");
+        oListOrigin.append(logFileInfo);
+    }
+
+    oList = LogRecordView<LOG_FILE_OTHERORCUSTOM>::all(&oListOrigin);
+    createOOCTableForm();
+    createOOCTable(oList);
+}
+
 void DisplayContent::createOOCTableForm()
 {
     m_pModel->clear();
@@ -3733,13 +5166,11 @@ void DisplayContent::createOOCTableForm()
     m_treeView->setColumnWidth(1, DATETIME_WIDTH + 120);
 }
 
-void DisplayContent::createOOCTable(const QList<LOG_FILE_OTHERORCUSTOM> &list)
+void DisplayContent::createOOCTable(const LogRecordView<LOG_FILE_OTHERORCUSTOM> &list)
 {
     setLoadState(DATA_COMPLETE);
 
-    m_limitTag = 0;
-    int end = list.count() > SINGLE_LOAD ? SINGLE_LOAD : list.count();
-    insertOOCTable(list, 0, end);
+    insertOOCTable(list, 0, list.count());
     QItemSelectionModel *p = m_treeView->selectionModel();
     if (p)
         p->select(m_pModel->index(0, 0), QItemSelectionModel::Rows | QItemSelectionModel::Select);
@@ -3750,9 +5181,11 @@ void DisplayContent::createOOCTable(const QList<LOG_FILE_OTHERORCUSTOM> &list)
 
 void DisplayContent::generateAuditFile(int id, int lId, const QString &iSearchStr)
 {
+    ensureTypeSetup(Audit);
     Q_UNUSED(iSearchStr);
     clearAllFilter();
     clearAllDatalist();
+    m_ingest.begin("audit");
     m_firstLoadPageData = true;
     m_isDataLoadComplete = false;
     setLoadState(DATA_LOADING);
@@ -3842,13 +5275,11 @@ void DisplayContent::createAuditTableForm()
 #endif
 }
 
-void DisplayContent::createAuditTable(const QList<LOG_MSG_AUDIT> &list)
+void DisplayContent::createAuditTable(const LogRecordView<LOG_MSG_AUDIT> &list)
 {
     setLoadState(DATA_COMPLETE);
 
-    m_limitTag = 0;
-    int end = list.count() > SINGLE_LOAD ? SINGLE_LOAD : list.count();
-    insertAuditTable(list, 0, end);
+    insertAuditTable(list, 0, list.count());
     QItemSelectionModel *p = m_treeView->selectionModel();
     if (p)
         p->select(m_pModel->index(0, 0), QItemSelectionModel::Rows | QItemSelectionModel::Select);
@@ -3857,6 +5288,7 @@ void DisplayContent::createAuditTable(const QList<LOG_MSG_AUDIT> &list)
 
 void DisplayContent::generateCoredumpFile(int id, const QString &iSearchStr)
 {
+    ensureTypeSetup(COREDUMP);
     Q_UNUSED(iSearchStr)
 
     if (!Utils::isCoredumpctlExist()) {
@@ -3866,6 +5298,7 @@ void DisplayContent::generateCoredumpFile(int id, const QString &iSearchStr)
 
     clearAllFilter();
     clearAllDatalist();
+    m_ingest.begin("coredump");
     m_coredumpList.clear();
     m_firstLoadPageData = true;
     m_isDataLoadComplete = false;
@@ -3944,13 +5377,11 @@ void DisplayContent::createCoredumpTableForm()
     m_treeView->setColumnWidth(COREDUMP_SPACE::COREDUMP_UNAME_COLUMN, 100);
     m_treeView->setColumnWidth(COREDUMP_SPACE::COREDUMP_EXE_COLUMN, 135);
 }
-void DisplayContent::createCoredumpTable(const QList<LOG_MSG_COREDUMP> &list)
+void DisplayContent::createCoredumpTable(const LogRecordView<LOG_MSG_COREDUMP> &list)
 {
     setLoadState(DATA_COMPLETE);
 
-    m_limitTag = 0;
-    int end = list.count() > SINGLE_LOAD ? SINGLE_LOAD : list.count();
-    insertCoredumpTable(list, 0, end);
+    insertCoredumpTable(list, 0, list.count());
     QItemSelectionModel *p = m_treeView->selectionModel();
     if (p)
         p->select(m_pModel->index(0, 0), QItemSelectionModel::Rows | QItemSelectionModel::Select);
@@ -3958,6 +5389,20 @@ void DisplayContent::createCoredumpTable(const QList<LOG_MSG_COREDUMP> &list)
 }
 void DisplayContent::slot_requestShowRightMenu(const QPoint &pos)
 {
+    if (m_flag == DPKG) {
+        if (m_pModel->rowCount() > 0) {
+            m_act_groupTransactions->setChecked(m_dpkgGrouped);
+            m_dpkgMenu->exec(QCursor::pos());
+        }
+        return;
+    }
+    if (m_flag == JOURNAL || m_flag == KERN) {
+        if (m_pModel->rowCount() > 0) {
+            m_act_collapseSimilar->setChecked(m_collapseSimilar);
+            m_similarMenu->exec(QCursor::pos());
+        }
+        return;
+    }
     if (m_flag != OtherLog && m_flag != CustomLog && m_flag != COREDUMP) {
         return;
     }
@@ -3977,9 +5422,9 @@ void DisplayContent::slot_requestShowRightMenu(const QPoint &pos)
                 //coredump文件不需要刷新
                 m_act_refresh->setEnabled(false);
 
-                path = m_pModel->item(index.row(), 4)->data(Qt::UserRole + 2).toString();
+                path = m_pModel->index(index.row(), 4).data(Qt::UserRole + 2).toString();
             } else {
-                path = m_pModel->item(index.row(), 0)->data(Qt::UserRole + 2).toString();
+                path = m_pModel->index(index.row(), 0).data(Qt::UserRole + 2).toString();
             }
 
             //显示当前日志目录
@@ -5,11 +5,23 @@
 #ifndef DISPLAYCONTENT_H
 #define DISPLAYCONTENT_H
 #include "filtercontent.h" //add by Airy
+#include "logaggregates.h"
 #include "logdetailinfowidget.h"
+#include "logdpkgtransactions.h"
+#include "logexportipc.h"
 #include "logfileparser.h"
 #include "logiconbutton.h"
+#include "logingestmetrics.h"
+#include "logmatchnavigator.h"
+#include "logmemoryusage.h"
+#include "logprefetcher.h"
+#include "logquery.h"
+#include "logrecordview.h"
 #include "logspinnerwidget.h"
+#include "logtemplateminer.h"
+#include "logtablemodel.h"
 #include "logtreeview.h"
+#include "logtrigramindex.h"
 #include "structdef.h"
 
 #include <DApplicationHelper>
@@ -19,11 +31,19 @@
 #include <DTableView>
 #include <DTextBrowser>
 
-#include <QStandardItemModel>
+#include <QPointer>
+#include <QSet>
 #include <QWidget>
 #include <QDateTime>
+#include <QTimer>
+
+#include <atomic>
+#include <functional>
+#include <memory>
 
 class ExportProgressDlg;
+class LogChangeNotifier;
+class LogSummaryDlg;
 /**
  * @brief The DisplayContent class 主显示数据区域控件,包括数据表格和详情页
  */
@@ -51,91 +71,117 @@ public:
     explicit DisplayContent(QWidget *parent = nullptr);
     ~DisplayContent();
     LogTreeView *mainLogTableView();
+    void setJournalFollow(bool follow);
+    bool journalFollowActive() const;
+    bool fileFollowActive() const;
+    void setPrefetchPaused(bool paused);
+    void saveSnapshot(const QString &path);
+    bool openSnapshot(const QString &path);
+    bool openArchive(const QString &zipPath);
+    void startExportServer();
+    QList<LogMemoryUsage> memoryUsage() const;
+    void showMemoryUsage();
+    QVariantMap journalExportOptions() const;
 
 private:
     void initUI();
-    void initMap();
     void initTableView();
     void setTableViewData();
     void initConnections();
 
+    void finishIngest(qint64 kept);
+    void ensureTypeSetup(LOG_FLAG flag);
     void generateJournalFile(int id, int lId, const QString &iSearchStr = "");
-    void createJournalTableStart(const QList<LOG_MSG_JOURNAL> &list);
+    void createJournalTableStart(const LogRecordView<LOG_MSG_JOURNAL> &list);
     void createJournalTableForm();
+    void generateJournalIncrement();
+    void mergeJournalIncrement(const QList<LOG_MSG_JOURNAL> &list);
+    void generateKernIncrement();
+    void mergeKernIncrement(const QList<LOG_MSG_JOURNAL> &list);
+    void generateKwinIncrement();
+    void mergeKwinIncrement(const QList<LOG_MSG_KWIN> &list);
+    void startJournalFollow();
+    void capJournalWindow();
+    void loadOlderJournal();
+    QStringList followPaths() const;
+    void updateFileFollow();
+    void loadJournalMessage(int row);
+    void loadCoredumpStack(int row);
     void generateDpkgFile(int id, const QString &iSearchStr = "");
-    void createDpkgTableStart(const QList<LOG_MSG_DPKG> &list);
+    void createDpkgTableStart(const LogRecordView<LOG_MSG_DPKG> &list);
     void createDpkgTableForm();
 
     void generateKernFile(int id, const QString &iSearchStr = "");
     void createKernTableForm();
-    void createKernTable(const QList<LOG_MSG_JOURNAL> &list);
+    void createKernTable(const LogRecordView<LOG_MSG_JOURNAL> &list);
 
     void generateAppFile(const QString &path, int id, int lId, const QString &iSearchStr = "");
     void createAppTableForm();
-    void createAppTable(const QList<LOG_MSG_APPLICATOIN> &list);
+    void createAppTable(const LogRecordView<LOG_MSG_APPLICATOIN> &list);
 
     void createBootTableForm();
-    void createBootTable(const QList<LOG_MSG_BOOT> &list);
+    void createBootTable(const LogRecordView<LOG_MSG_BOOT> &list);
     void generateBootFile();
 
     void createXorgTableForm();
-    void createXorgTable(const QList<LOG_MSG_XORG> &list);
+    void createXorgTable(const LogRecordView<LOG_MSG_XORG> &list);
     void generateXorgFile(int id); // add by Airy for peroid
 
     void createKwinTableForm();
-    void creatKwinTable(const QList<LOG_MSG_KWIN> &list);
+    void creatKwinTable(const LogRecordView<LOG_MSG_KWIN> &list);
     void generateKwinFile(const KWIN_FILTERS &iFilters);
 
     void createNormalTableForm();
-    void createNormalTable(const QList<LOG_MSG_NORMAL> &list); // add by Airy
+    void createNormalTable(const LogRecordView<LOG_MSG_NORMAL> &list); // add by Airy
     void generateNormalFile(int id); // add by Airy for peroid
 
     //其他日志或者自定义日志
     void generateOOCFile(const QString &path);
     void generateOOCLogs(const OOC_TYPE &type, const QString &iSearchStr = "");
+    void generateArchiveLogs();
     void createOOCTableForm();
-    void createOOCTable(const QList<LOG_FILE_OTHERORCUSTOM> &list);
+    void createOOCTable(const LogRecordView<LOG_FILE_OTHERORCUSTOM> &list);
 
     // 审计日志
     void generateAuditFile(int id, int lId, const QString &iSearchStr = "");
     void createAuditTableForm();
-    void createAuditTable(const QList<LOG_MSG_AUDIT> &list);
+    void createAuditTable(const LogRecordView<LOG_MSG_AUDIT> &list);
 
     //coredump log
     void generateCoredumpFile(int id, const QString &iSearchStr = "");
     void createCoredumpTableForm();
-    void createCoredumpTable(const QList<LOG_MSG_COREDUMP> &list);
-
-    void insertJournalTable(QList<LOG_MSG_JOURNAL> logList, int start, int end);
-    void insertApplicationTable(const QList<LOG_MSG_APPLICATOIN> &list, int start, int end);
-    void insertKernTable(const QList<LOG_MSG_JOURNAL> &list, int start,
-                         int end); // add by Airy for bug 12263
-    void insertDpkgTable(const QList<LOG_MSG_DPKG> &list, int start, int end);
-    void insertXorgTable(const QList<LOG_MSG_XORG> &list, int start, int end);
-    void insertBootTable(const QList<LOG_MSG_BOOT> &list, int start, int end);
-    void insertKwinTable(const QList<LOG_MSG_KWIN> &list, int start, int end);
-    void insertNormalTable(const QList<LOG_MSG_NORMAL> &list, int start, int end);
-    void insertOOCTable(const QList<LOG_FILE_OTHERORCUSTOM> &list, int start, int end);
-    void insertAuditTable(const QList<LOG_MSG_AUDIT> &list, int start, int end);
-    void insertCoredumpTable(const QList<LOG_MSG_COREDUMP> &list, int start, int end);
+    void createCoredumpTable(const LogRecordView<LOG_MSG_COREDUMP> &list);
+
+    void insertJournalTable(const LogRecordView<LOG_MSG_JOURNAL> &logList, int start, int end, int row = -1);
+    void insertApplicationTable(const LogRecordView<LOG_MSG_APPLICATOIN> &list, int start, int end);
+    void insertKernTable(const LogRecordView<LOG_MSG_JOURNAL> &list, int start,
+                         int end, int row = -1); // add by Airy for bug 12263
+    void insertDpkgTable(const LogRecordView<LOG_MSG_DPKG> &list, int start, int end);
+    void insertXorgTable(const LogRecordView<LOG_MSG_XORG> &list, int start, int end);
+    void insertBootTable(const LogRecordView<LOG_MSG_BOOT> &list, int start, int end);
+    void insertKwinTable(const LogRecordView<LOG_MSG_KWIN> &list, int start, int end, int row = -1);
+    void insertNormalTable(const LogRecordView<LOG_MSG_NORMAL> &list, int start, int end);
+    void insertOOCTable(const LogRecordView<LOG_FILE_OTHERORCUSTOM> &list, int start, int end);
+    void insertAuditTable(const LogRecordView<LOG_MSG_AUDIT> &list, int start, int end);
+    void insertCoredumpTable(const LogRecordView<LOG_MSG_COREDUMP> &list, int start, int end);
     QString getAppName(const QString &filePath);
 
     bool isAuthProcessAlive();
 
     void generateJournalBootFile(int lId, const QString &iSearchStr = "");
-    void createJournalBootTableStart(const QList<LOG_MSG_JOURNAL> &list);
+    void createJournalBootTableStart(const LogRecordView<LOG_MSG_JOURNAL> &list);
     void createJournalBootTableForm();
-    void insertJournalBootTable(QList<LOG_MSG_JOURNAL> logList, int start, int end);
+    void insertJournalBootTable(const LogRecordView<LOG_MSG_JOURNAL> &logList, int start, int end);
 
     void generateDnfFile(BUTTONID iDate, DNFPRIORITY iLevel);
-    void createDnfTable(const QList<LOG_MSG_DNF> &list);
+    void createDnfTable(const LogRecordView<LOG_MSG_DNF> &list);
 
     void generateDmesgFile(BUTTONID iDate, PRIORITY iLevel);
-    void createDmesgTable(const QList<LOG_MSG_DMESG> &list);
+    void createDmesgTable(const LogRecordView<LOG_MSG_DMESG> &list);
     void createDnfForm();
     void createDmesgForm();
-    void insertDmesgTable(const QList<LOG_MSG_DMESG> &list, int start, int end);
-    void insertDnfTable(const QList<LOG_MSG_DNF> &list, int start, int end);
+    void insertDmesgTable(const LogRecordView<LOG_MSG_DMESG> &list, int start, int end);
+    void insertDnfTable(const LogRecordView<LOG_MSG_DNF> &list, int start, int end);
 
 signals:
     void loadMoreInfo();
@@ -145,7 +191,7 @@ signals:
      * @param pModel 当前的model指针
      * @param name 当前应用日志选择的日志名称
      */
-    void sigDetailInfo(QModelIndex index, QStandardItemModel *pModel, QString name, const int error = 0);
+    void sigDetailInfo(QModelIndex index, QAbstractItemModel *pModel, QString name, const int error = 0);
     /**
      * @brief setExportEnable 是否允许导出信号
      * @param iEnable 是否允许导出
@@ -153,11 +199,36 @@ signals:
     void setExportEnable(bool iEnable);
 
     void sigCoredumpDetailInfo(QList<LOG_MSG_COREDUMP> cList);
+    /**
+     * @brief searchIndexStatus 搜索索引的建立进度和内存占用,为空表示没有索引
+     */
+    void searchIndexStatus(const QString &status);
+    /**
+     * @brief searchPatternError 正则搜索的表达式有语法错误,为空表示表达式有效
+     */
+    void searchPatternError(const QString &error);
+    /**
+     * @brief searchMatchStatus 只高亮不筛选时当前所在的匹配和匹配总数,搜索框为空时两者都为0
+     */
+    void searchMatchStatus(int current, int total);
+    /**
+     * @brief searchTermRequested 统计面板中选中了某一项,把对应的查询条件加入搜索框
+     */
+    void searchTermRequested(const QString &term);
+    /**
+     * @brief followRefreshRequested 实时跟踪时当前类别的日志文件有了变化,需要刷新
+     */
+    void followRefreshRequested();
+    /**
+     * @brief firstScreenReady 启动后第一次显示出加载结果(数据或无结果等提示),只发出一次
+     */
+    void firstScreenReady();
 
 public slots:
     void slot_valueChanged_dConfig_or_gSetting(const QString &key);
     void slot_requestShowRightMenu(const QPoint &pos);
     void slot_tableItemClicked(const QModelIndex &index);
+    void slot_tableItemDoubleClicked(const QModelIndex &index);
     void slot_BtnSelected(int btnId, int lId, QModelIndex idx);
     void slot_appLogs(int btnId, const QString &path);
 
@@ -176,65 +247,111 @@ public slots:
     void slot_kernData(int index, QList<LOG_MSG_JOURNAL> list);
     void slot_kwinFinished(int index);
     void slot_kwinData(int index, QList<LOG_MSG_KWIN> list);
-    void slot_dnfFinished(const QList<LOG_MSG_DNF> &list);
-    void slot_dmesgFinished(const QList<LOG_MSG_DMESG> &list);
+    void slot_dnfFinished(int index);
+    void slot_dnfData(int index, QList<LOG_MSG_DNF> list);
+    void slot_dmesgFinished(int index);
+    void slot_dmesgData(int index, QList<LOG_MSG_DMESG> list);
     void slot_journalFinished(int index);
     void slot_journalBootFinished(int index);
     void slot_journalBootData(int index, QList<LOG_MSG_JOURNAL> list);
     void slot_journalData(int index, QList<LOG_MSG_JOURNAL> list);
+    void slot_journalCursor(int index, const QString &cursor);
+    void slot_journalFollowData(int index, QList<LOG_MSG_JOURNAL> list, const QString &cursor);
+    void slot_journalFollowFinished(int index);
     void slot_applicationFinished(int index);
     void slot_applicationData(int index, QList<LOG_MSG_APPLICATOIN> list);
     void slot_normalFinished(int index);
     void slot_normalData(int index, QList<LOG_MSG_NORMAL> list);
     void slot_OOCFinished(int index, int error = 0);
-    void slot_OOCData(int index, const QString & data);
+    void slot_OOCData(int index, LogTextSourcePtr source);
     void slot_auditFinished(int index, bool bShowTip = false);
     void slot_auditData(int index, QList<LOG_MSG_AUDIT> list);
     void slot_coredumpFinished(int index);
     void slot_coredumpData(int index, QList<LOG_MSG_COREDUMP> list);
 
     void slot_logLoadFailed(const QString &iError);
-    void slot_vScrollValueChanged(int valuePixel);
-
+    void slot_memoryLevelChanged(int level);
     void slot_searchResult(const QString &str);
+    void slot_searchRegexChanged(bool regex);
+    void slot_searchHighlightChanged(bool highlightOnly);
+    void jumpToNextMatch();
+    void jumpToPreviousMatch();
     void slot_getLogtype(int tcbx); // add by Airy
     void slot_getAuditType(int tcbx);
+    void slot_bootChanged(const QString &bootId);
+    void slot_journalFieldChanged(const QString &match);
     void slot_refreshClicked(const QModelIndex &index); //add by Airy for adding refresh
+    void slot_logCleared(const QStringList &files, qint64 freed);
     void slot_dnfLevel(DNFPRIORITY iLevel);
 
-    //导出前把当前要导出的当前信息的Qlist转换成QStandardItemModel便于导出
-    void parseListToModel(const QList<LOG_MSG_DPKG> &iList, QStandardItemModel *oPModel);
-    void parseListToModel(const QList<LOG_MSG_BOOT> &iList, QStandardItemModel *oPModel);
-    void parseListToModel(QList<LOG_MSG_APPLICATOIN> iList, QStandardItemModel *oPModel);
-    void parseListToModel(QList<LOG_MSG_XORG> iList, QStandardItemModel *oPModel);
-    void parseListToModel(QList<LOG_MSG_JOURNAL> iList, QStandardItemModel *oPModel);
-    void parseListToModel(QList<LOG_MSG_NORMAL> iList, QStandardItemModel *oPModel);
-    void parseListToModel(QList<LOG_MSG_KWIN> iList, QStandardItemModel *oPModel);
-    void parseListToModel(QList<LOG_MSG_DNF> iList, QStandardItemModel *oPModel);
-    void parseListToModel(QList<LOG_MSG_DMESG> iList, QStandardItemModel *oPModel);
-    void parseListToModel(QList<LOG_FILE_OTHERORCUSTOM> iList, QStandardItemModel *oPModel);
-    void parseListToModel(QList<LOG_MSG_AUDIT> iList, QStandardItemModel *oPModel);
-    void parseListToModel(QList<LOG_MSG_COREDUMP> iList, QStandardItemModel *oPModel);
-    QString getIconByname(const QString &str);
+    //把当前信息的Qlist设置为主表model的记录,按日志类型生成列定义
+    void parseListToModel(const LogRecordView<LOG_MSG_DPKG> &iList, LogTableModel *oPModel);
+    void parseListToModel(const LogRecordView<LOG_MSG_BOOT> &iList, LogTableModel *oPModel);
+    void parseListToModel(const LogRecordView<LOG_MSG_APPLICATOIN> &iList, LogTableModel *oPModel);
+    void parseListToModel(const LogRecordView<LOG_MSG_XORG> &iList, LogTableModel *oPModel);
+    void parseListToModel(const LogRecordView<LOG_MSG_JOURNAL> &iList, LogTableModel *oPModel, int row = -1);
+    void parseListToModel(const LogRecordView<LOG_MSG_NORMAL> &iList, LogTableModel *oPModel);
+    void parseListToModel(const LogRecordView<LOG_MSG_KWIN> &iList, LogTableModel *oPModel, int row = -1);
+    void parseListToModel(const LogRecordView<LOG_MSG_DNF> &iList, LogTableModel *oPModel);
+    void parseListToModel(const LogRecordView<LOG_MSG_DMESG> &iList, LogTableModel *oPModel);
+    void parseListToModel(const LogRecordView<LOG_FILE_OTHERORCUSTOM> &iList, LogTableModel *oPModel);
+    void parseListToModel(const LogRecordView<LOG_MSG_AUDIT> &iList, LogTableModel *oPModel);
+    void parseListToModel(const LogRecordView<LOG_MSG_COREDUMP> &iList, LogTableModel *oPModel);
+    QVector<LogTableModel::Column<LOG_MSG_JOURNAL>> journalColumns();
+    static QString levelIcon(int level);
+    static QString dnfLevelIcon(int level);
+    static qint64 levelOrder(int level);
+    static qint64 dnfLevelOrder(int level);
     void setLoadState(LOAD_STATE iState);
     void onExportProgress(int nCur, int nTotal);
     void onExportResult(bool isSuccess);
     void onExportFakeCloseDlg();
     void clearAllFilter();
     void clearAllDatalist();
-
-    QList<LOG_MSG_BOOT> filterBoot(BOOT_FILTERS ibootFilter, const QList<LOG_MSG_BOOT> &iList);
-    QList<LOG_MSG_NORMAL> filterNomal(NORMAL_FILTERS inormalFilter, QList<LOG_MSG_NORMAL> &iList);
-    QList<LOG_MSG_DPKG> filterDpkg(const QString &iSearchStr, const QList<LOG_MSG_DPKG> &iList);
-    QList<LOG_MSG_JOURNAL> filterKern(const QString &iSearchStr, const QList<LOG_MSG_JOURNAL> &iList);
-    QList<LOG_MSG_XORG> filterXorg(const QString &iSearchStr, const QList<LOG_MSG_XORG> &iList);
-    QList<LOG_MSG_KWIN> filterKwin(const QString &iSearchStr, const QList<LOG_MSG_KWIN> &iList);
-    QList<LOG_MSG_APPLICATOIN> filterApp(const QString &iSearchStr, const QList<LOG_MSG_APPLICATOIN> &iList);
-    QList<LOG_MSG_JOURNAL> filterJournal(const QString &iSearchStr, const QList<LOG_MSG_JOURNAL> &iList);
-    QList<LOG_MSG_JOURNAL> filterJournalBoot(const QString &iSearchStr, const QList<LOG_MSG_JOURNAL> &iList);
-    QList<LOG_FILE_OTHERORCUSTOM> filterOOC(const QString &iSearchStr, const QList<LOG_FILE_OTHERORCUSTOM> &iList);
-    QList<LOG_MSG_AUDIT> filterAudit(AUDIT_FILTERS auditFilter, const QList<LOG_MSG_AUDIT> &iList);
-    QList<LOG_MSG_COREDUMP> filterCoredump(const QString &iSearchStr, const QList<LOG_MSG_COREDUMP> &iList);
+    template <typename T>
+    void searchInBackground(const LogRecordStore<T> &origin, LogRecordView<T> &result, const std::function<bool(const T &)> &match,
+                            const LogSearchHits::Fields<T> &hitFields, const QString &extra,
+                            const std::function<void(const LogRecordView<T> &)> &createTable,
+                            const std::function<void(const LogRecordView<T> &)> &insertTable);
+    void cancelSearch();
+    void updateSearchState();
+    void jumpToMatch(int row);
+    int timeColumn() const;
+    void startSearchIndex();
+    template <typename T>
+    void buildSearchIndex(const LogRecordStore<T> &origin, const std::function<bool(const T &, QStringList &)> &fields);
+    template <typename T>
+    bool indexCandidates(const LogRecordStore<T> &origin, const QStringList &literals, QVector<int> &rows) const;
+    LogRecordFilter::TextMatcher::Mode searchMode() const;
+    bool journalPushedDown(const LogQuery &query) const;
+    template <typename T>
+    std::function<bool(const T &)> searchPredicate(const QString &searchStr,
+                                                   const std::function<bool(const LogRecordFilter::TextMatcher &, const T &)> &textMatch) const;
+    void cancelSearchIndex();
+    void setCollapseSimilar(bool collapse);
+    void startCollapseSimilar();
+    void cancelCollapseSimilar();
+    void showCollapsedGroups(const LogRecordView<LOG_MSG_JOURNAL> &view, const QVector<LogTemplateGroup> &groups);
+    void showSummary();
+    void setGroupTransactions(bool group);
+    void showDpkgTransactions(int selectTransaction = -1);
+    LOG_MSG_DPKG dpkgTransactionSummary(const LogDpkgTransaction &transaction) const;
+    void addAggregates(const QList<LOG_MSG_JOURNAL> &list, int begin = 0, int end = -1);
+
+    LogRecordView<LOG_MSG_BOOT> filterBoot(BOOT_FILTERS ibootFilter, const LogRecordView<LOG_MSG_BOOT> &iList);
+    LogRecordView<LOG_MSG_NORMAL> filterNomal(NORMAL_FILTERS inormalFilter, const LogRecordView<LOG_MSG_NORMAL> &iList);
+    LogRecordView<LOG_MSG_DPKG> filterDpkg(const QString &iSearchStr, const LogRecordView<LOG_MSG_DPKG> &iList);
+    LogRecordView<LOG_MSG_JOURNAL> filterKern(const QString &iSearchStr, const LogRecordView<LOG_MSG_JOURNAL> &iList);
+    LogRecordView<LOG_MSG_XORG> filterXorg(const QString &iSearchStr, const LogRecordView<LOG_MSG_XORG> &iList);
+    LogRecordView<LOG_MSG_KWIN> filterKwin(const QString &iSearchStr, const LogRecordView<LOG_MSG_KWIN> &iList);
+    LogRecordView<LOG_MSG_DNF> filterDnf(const QString &iSearchStr, const LogRecordView<LOG_MSG_DNF> &iList);
+    LogRecordView<LOG_MSG_DMESG> filterDmesg(const QString &iSearchStr, const LogRecordView<LOG_MSG_DMESG> &iList);
+    LogRecordView<LOG_MSG_APPLICATOIN> filterApp(const QString &iSearchStr, const LogRecordView<LOG_MSG_APPLICATOIN> &iList);
+    LogRecordView<LOG_MSG_JOURNAL> filterJournal(const QString &iSearchStr, const LogRecordView<LOG_MSG_JOURNAL> &iList, bool *undecided = nullptr);
+    LogRecordView<LOG_MSG_JOURNAL> filterJournalBoot(const QString &iSearchStr, const LogRecordView<LOG_MSG_JOURNAL> &iList);
+    LogRecordView<LOG_FILE_OTHERORCUSTOM> filterOOC(const QString &iSearchStr, const LogRecordView<LOG_FILE_OTHERORCUSTOM> &iList);
+    LogRecordView<LOG_MSG_AUDIT> filterAudit(AUDIT_FILTERS auditFilter, const LogRecordView<LOG_MSG_AUDIT> &iList);
+    LogRecordView<LOG_MSG_COREDUMP> filterCoredump(const QString &iSearchStr, const LogRecordView<LOG_MSG_COREDUMP> &iList);
 
 private:
     void resizeEvent(QResizeEvent *event);
@@ -247,7 +364,7 @@ private:
     /**
      * @brief m_pModel 主数据表的model
      */
-    QStandardItemModel *m_pModel;
+    LogTableModel *m_pModel;
 
     //分割布局
     Dtk::Widget::DSplitter *m_splitter;
@@ -263,10 +380,6 @@ private:
     QModelIndex m_curListIdx;
     //当前选中的treeview的index
     QModelIndex m_curTreeIndex;
-    //日志等级的显示文本和代码内文本的转换map
-    QMap<QString, QString> m_transDict;
-    //分页加载时,当前加载到的页数
-    int m_limitTag {0};
     /**
      * @brief m_spinnerWgt 加载数据时转轮控件
      */
@@ -280,6 +393,13 @@ private:
     QMenu *m_menu{ nullptr };
     QAction *m_act_openForder{ nullptr };
     QAction *m_act_refresh{ nullptr };
+    //系统日志和内核日志表格的右键菜单,折叠相似信息
+    QMenu *m_similarMenu{ nullptr };
+    QAction *m_act_collapseSimilar{ nullptr };
+    QAction *m_act_summary{ nullptr };
+    //dpkg日志表格的右键菜单,按事务归组
+    QMenu *m_dpkgMenu{ nullptr };
+    QAction *m_act_groupTransactions{ nullptr };
 
     /**
      * @brief m_curAppLog 当前选中的应用的日志文件路径
@@ -288,6 +408,11 @@ private:
 
     QString m_currentStatus;
 
+    //klu启动日志当前选择的bootid,为空表示当前启动
+    QString m_curBootId;
+    //系统日志来源下拉框选择的journal匹配,如"_SYSTEMD_UNIT=sshd.service",为空表示全部来源
+    QString m_journalFieldMatch;
+
     //当前选中的时间筛选选项
     int m_curBtnId {ALL};
     //当前选中的等级筛选选项
@@ -299,6 +424,12 @@ private:
      * @brief m_logFileParse 获取日志工具类对象
      */
     LogFileParser m_logFileParse;
+    /**
+     * @brief m_prefetcher 空闲时后台预取常用类别
+     */
+    LogPrefetcher *m_prefetcher {nullptr};
+    //实时跟踪时监视当前类别的日志文件,有变化才刷新
+    LogChangeNotifier *m_fileChanges {nullptr};
 
     /**
      * @brief jBootList 经过筛选完成的启动日志列表
@@ -306,7 +437,8 @@ private:
     /**
      * @brief jBootListOrigin 未经过筛选的启动日志数据 journalctl --boot cmd.
      */
-    QList<LOG_MSG_JOURNAL> jBootList, jBootListOrigin;
+    LogRecordStore<LOG_MSG_JOURNAL> jBootListOrigin;
+    LogRecordView<LOG_MSG_JOURNAL> jBootList {&jBootListOrigin};
 
     /**
      * @brief jList 经过筛选完成的系统日志数据
@@ -314,86 +446,165 @@ private:
     /**
      * @brief jListOrigin 未经过筛选的系统日志数据 journalctl cmd.
      */
-    QList<LOG_MSG_JOURNAL> jList, jListOrigin;
+    LogRecordStore<LOG_MSG_JOURNAL> jListOrigin;
+    LogRecordView<LOG_MSG_JOURNAL> jList {&jListOrigin};
     /**
      * @brief dList 经过筛选完成的dpkg日志数据
      */
     /**
      * @brief dListOrigin 未经过筛选的dpkg日志数据  dpkg.log
      */
-    QList<LOG_MSG_DPKG> dList, dListOrigin;
+    LogRecordStore<LOG_MSG_DPKG> dListOrigin;
+    LogRecordView<LOG_MSG_DPKG> dList {&dListOrigin};
     /**
      * @brief xList 经过筛选完成的xorg日志数据
      */
     /**
      * @brief xListOrigin 未经过筛选的xorg日志数据   Xorg.0.log
      */
-    QList<LOG_MSG_XORG> xList, xListOrigin;
+    LogRecordStore<LOG_MSG_XORG> xListOrigin;
+    LogRecordView<LOG_MSG_XORG> xList {&xListOrigin};
     /**
      * @brief currentBootList 经过筛选完成的启动日志数据
      */
     /**
      * @brief bList 未经过筛选的启动日志数据   boot.log
      */
-    QList<LOG_MSG_BOOT> bList, currentBootList;
+    QList<LOG_MSG_BOOT> bList;
+    LogRecordView<LOG_MSG_BOOT> currentBootList {&bList};
     /**
      * @brief kList 经过筛选完成的内核日志数据
      */
     /**
      * @brief kListOrigin 未经过筛选的内核日志数据   kern.log
      */
-    QList<LOG_MSG_JOURNAL> kList, kListOrigin;
+    LogRecordStore<LOG_MSG_JOURNAL> kListOrigin;
+    LogRecordView<LOG_MSG_JOURNAL> kList {&kListOrigin};
 
     /**
      * @brief oList未经过筛选的其他日志数据   other
      */
-    QList<LOG_FILE_OTHERORCUSTOM> oList, oListOrigin;
+    LogRecordStore<LOG_FILE_OTHERORCUSTOM> oListOrigin;
+    LogRecordView<LOG_FILE_OTHERORCUSTOM> oList {&oListOrigin};
 
     /**
      * @brief cList未经过筛选的自定义日志数据   custom
      */
-    QList<LOG_FILE_OTHERORCUSTOM> cList, cListOrigin;
+    LogRecordStore<LOG_FILE_OTHERORCUSTOM> cListOrigin;
+    LogRecordView<LOG_FILE_OTHERORCUSTOM> cList {&cListOrigin};
 
     /**
      * @brief aListOrigin 未经过筛选的审计日志数据   audit/audit.log
      */
-    QList<LOG_MSG_AUDIT> aList, aListOrigin;
+    LogRecordStore<LOG_MSG_AUDIT> aListOrigin;
+    LogRecordView<LOG_MSG_AUDIT> aList {&aListOrigin};
 
     /**
      * @brief appListOrigin 未经过筛选的内核日志数据   ~/.cache/deepin/xxx.log(.xxx)
      */
-    QList<LOG_MSG_APPLICATOIN> appList, appListOrigin;
+    LogRecordStore<LOG_MSG_APPLICATOIN> appListOrigin;
+    LogRecordView<LOG_MSG_APPLICATOIN> appList {&appListOrigin};
     /**
      * @brief norList add 未经过筛选完成的开关机日志数据 by Airy
      */
-    QList<LOG_MSG_NORMAL> norList;
+    LogRecordStore<LOG_MSG_NORMAL> norList;
     /**
      * @brief nortempList 经过筛选的开关机日志数据 add by Airy
      */
-    QList<LOG_MSG_NORMAL> nortempList;
+    LogRecordView<LOG_MSG_NORMAL> nortempList {&norList};
     /**
      * @brief m_currentKwinList add 经过筛选完成的kwin日志数据 by Airy /$HOME/.kwin.log
      */
-    QList<LOG_MSG_KWIN> m_currentKwinList;
+    LogRecordView<LOG_MSG_KWIN> m_currentKwinList {&m_kwinList};
     /**
      * @brief m_kwinList 未经过筛选的开关机日志数据
      */
-    QList<LOG_MSG_KWIN> m_kwinList;
+    LogRecordStore<LOG_MSG_KWIN> m_kwinList;
 
 
-    QList<LOG_MSG_COREDUMP> m_coredumpList;
-    QList<LOG_MSG_COREDUMP> m_currentCoredumpList;
+    LogRecordStore<LOG_MSG_COREDUMP> m_coredumpList;
+    LogRecordView<LOG_MSG_COREDUMP> m_currentCoredumpList {&m_coredumpList};
     /**
      * @brief m_iconPrefix 图标资源文件路径前缀
      */
     QString m_iconPrefix = ICONPREFIX;
-    /**
-     * @brief m_icon_name_map 日志等级对应图标资源文件名的map
-     */
-    QMap<QString, QString> m_icon_name_map;
 
     //当前搜索关键字
     QString m_currentSearchStr {""};
+    //搜索框中的关键字按正则表达式匹配
+    bool m_searchRegex = false;
+    //搜索时保留全部记录,只高亮匹配的记录,用上一个/下一个匹配跳转
+    bool m_searchHighlightOnly = false;
+    //只高亮不筛选时匹配记录的行号,随搜索批次追加
+    LogMatchNavigator m_matchNavigator;
+    //当前系统日志读取时下推给sd_journal的字段条件,和新查询的不同时重新读取
+    QStringList m_loadedJournalMatches;
+    //字段条件变化后延迟重新读取系统日志,输入过程中不反复读取
+    QTimer m_journalQueryTimer;
+    //相似信息是否折叠显示,切换日志类型、重新加载或搜索时恢复为展开
+    bool m_collapseSimilar {false};
+    //当前归纳相似信息的取消标记和线程标号
+    std::shared_ptr<std::atomic_bool> m_collapseCanRun;
+    int m_collapseIndex {-1};
+    //当前读取崩溃堆栈的取消标记和请求标号,切换选中的崩溃记录时作废之前的读取
+    std::shared_ptr<std::atomic_bool> m_coredumpStackCanRun;
+    int m_coredumpStackRequest {0};
+    //最近查看过的崩溃记录的游标和堆栈内容,新的在前
+    QList<QPair<QByteArray, LogTextSourcePtr>> m_coredumpStacks;
+    //加载dpkg日志时逐批归纳的事务,和dList的各行对应
+    LogDpkgTransactions m_dpkgTransactions;
+    //dpkg日志是否按事务归组显示,归组时只显示每个事务的摘要,双击展开的事务才显示详细的行
+    bool m_dpkgGrouped {false};
+    QSet<int> m_dpkgExpanded;
+    //归组显示时各事务摘要行在表格中的位置,按列排序后仍然有效
+    QVector<QPersistentModelIndex> m_dpkgSummaryRows;
+    //系统日志、内核日志加载时逐批累计的进程、等级和小时分布,切换类型或重新加载时清空
+    LogAggregates m_aggregates;
+    //打开着的统计面板,每批数据到达后刷新
+    QPointer<LogSummaryDlg> m_summaryDlg;
+    //当前搜索的取消标记,和搜索线程共享
+    std::shared_ptr<std::atomic_bool> m_searchCanRun;
+    //当前搜索线程标号,没有正在进行的搜索时为-1
+    int m_searchIndex {-1};
+    /**
+     * @brief The SearchState struct 最近一次搜索的范围和结果,关键字在此基础上追加字符时只在已匹配的记录中继续搜索
+     */
+    struct SearchState {
+        LOG_FLAG flag = NONE;
+        //关键字
+        QString text;
+        //关键字是正则表达式,不能按包含关系复用上一次的结果
+        bool regex = false;
+        //关键字以外的筛选条件
+        QString extra;
+        //被搜索存储的快照,实际类型为LogRecordStore<记录类型>,和存储共享各批次的数据
+        std::shared_ptr<void> origin;
+        //被扫描的下标,hasCandidates为false时扫描全部记录
+        QVector<int> candidates;
+        bool hasCandidates = false;
+        //已扫描的记录(或候选下标)个数,被取消的搜索只有这之前的结果是完整的
+        int scanned = 0;
+        //已扫描部分中匹配的下标
+        QVector<int> matches;
+    };
+    SearchState m_searchState;
+    /**
+     * @brief The SearchIndexState struct 当前类别加载完成后在后台建立的三元组索引
+     */
+    struct SearchIndexState {
+        LOG_FLAG flag = NONE;
+        std::shared_ptr<LogTrigramIndex> index;
+        std::shared_ptr<std::atomic_bool> canRun;
+        //建立索引时存储首末记录的地址,之后只在末尾追加记录时索引仍覆盖前rowCount条
+        const void *first = nullptr;
+        const void *last = nullptr;
+        bool ready = false;
+        //正在建立索引的线程标号,没有时为-1
+        int work = -1;
+    };
+    SearchIndexState m_trigramIndex;
+    //当前搜索结果中关键字的位置,和表格model共享,随批次追加
+    std::shared_ptr<LogSearchHits> m_searchHits;
     /**
      * @brief m_currentKwinFilter kwin日志当前筛选条件
      */
@@ -408,8 +619,6 @@ private:
      * @brief m_normalFilter 开关机日志当前筛选条件
      */
     NORMAL_FILTERS m_normalFilter;
-    //上次treeview滚筒条的值
-    int m_treeViewLastScrollValue = -1;
     //当前的显示加载状态
     DisplayContent::LOAD_STATE m_state;
     //系统日志上次获取的时间
@@ -418,13 +627,56 @@ private:
      * @brief m_journalFilter 当前系统日志筛选条件
      */
     JOURNAL_FILTERS m_journalFilter;
+    //当前系统日志获取参数,增量刷新时复用
+    QStringList m_journalArgs;
+    //系统日志的加载日期,时间段按这一天计算,日期变化后不能再增量刷新
+    QDate m_journalLoadDate;
+    //已加载系统日志中最新条目的游标
+    QString m_journalNewestCursor;
+    //是否正在增量刷新系统日志
+    bool m_journalIncremental {false};
+    //增量刷新获取到的新日志
+    QList<LOG_MSG_JOURNAL> m_journalIncrementList;
+    //当前内核日志的筛选条件、时间筛选id和加载日期,日期变化后时间范围要重新计算
+    KERN_FILTERS m_kernFilter;
+    int m_kernFilterId {-1};
+    QDate m_kernLoadDate;
+    //是否正在增量刷新内核日志
+    bool m_kernIncremental {false};
+    //增量刷新获取到的日志,包括和已加载的最新记录同一时刻的记录
+    QList<LOG_MSG_JOURNAL> m_kernIncrementList;
+    //kwin日志已读取到的文件位置,刷新时只读取之后追加的行
+    std::shared_ptr<LogTailPosition> m_kwinTail;
+    //是否正在增量刷新kwin日志
+    bool m_kwinIncremental {false};
+    //增量刷新获取到的新追加的日志
+    QList<LOG_MSG_KWIN> m_kwinIncrementList;
+    //是否开启系统日志实时跟踪
+    bool m_journalFollow {false};
+    //当前实时跟踪线程标号,未在跟踪时为-1
+    int m_journalFollowIndex {-1};
+    //内存紧张时系统日志只加载了最新的一段,为已加载的最早记录的时间(微秒),未截断时为-1
+    qint64 m_journalWindowEnd {-1};
+    //加载中有被截断的信息只按前缀筛选过,加载结束后需要在搜索线程中重新搜索
+    bool m_journalSearchDeferred {false};
+    //当前显示的是更早的一段系统日志,不增量刷新、不实时跟踪
+    bool m_journalOlderWindow {false};
+    //"加载更早的日志"提示
+    QPointer<QWidget> m_journalWindowMessage;
+    //是否已发出过firstScreenReady
+    bool m_firstScreenShown {false};
+    //当前加载的各阶段指标,加载结束时输出到日志和指标文件
+    LogIngestSession m_ingest;
     /**
      * @brief m_auditFilter 当前审计日志筛选条件
      */
     AUDIT_FILTERS m_auditFilter;
-    QList<LOG_MSG_DNF> dnfList, dnfListOrigin; //dnf.log
-    QList<LOG_MSG_DMESG> dmesgList, dmesgListOrigin; //dmesg cmd
-    QMap<QString, QString> m_dnfIconNameMap;
+    LogRecordStore<LOG_MSG_DNF> dnfListOrigin; //dnf.log
+    LogRecordView<LOG_MSG_DNF> dnfList {&dnfListOrigin};
+    LogRecordStore<LOG_MSG_DMESG> dmesgListOrigin; //dmesg cmd
+    LogRecordView<LOG_MSG_DMESG> dmesgList {&dmesgListOrigin};
+    //已连接获取信号的日志类别,见ensureTypeSetup
+    QSet<int> m_setupTypes;
     DNFPRIORITY m_curDnfLevel {INFO};
     //当前系统日志获取进程标记量
     int m_journalCurrentIndex {-1};
@@ -437,8 +689,18 @@ private:
     int m_normalCurrentIndex {-1};
     int m_xorgCurrentIndex {-1};
     int m_kwinCurrentIndex {-1};
+    int m_dnfCurrentIndex {-1};
+    int m_dmesgCurrentIndex {-1};
     int m_appCurrentIndex {-1};
     int m_OOCCurrentIndex {-1};
+    /**
+     * @brief m_archive 打开的全部导出包,其他日志的列表显示其中的类别,再次查看时不重新解压
+     */
+    LogArchivePtr m_archive;
+    /**
+     * @brief m_exportServer 接收命令行导出请求的服务,主窗口完成首屏后启动
+     */
+    LogExportServer *m_exportServer = nullptr;
     int m_auditCurrentIndex {-1};
     int m_coredumpCurrentIndex {-1};
     bool m_isDataLoadComplete {false};
@@ -8,6 +8,9 @@
 #include "logapplicationhelper.h"
 #include "logperiodbutton.h"
 #include "loglistview.h"
+#include "journalreader.h"
+#include "logjournalcatalog.h"
+#include "logworkscheduler.h"
 #include "structdef.h"
 
 #include <DApplication>
@@ -19,6 +22,7 @@
 #include <QAbstractItemView>
 #include <QDebug>
 #include <QDir>
+#include <QLocale>
 #include <QSizePolicy>
 #include <QFileInfo>
 #include <QFileInfoList>
@@ -28,6 +32,7 @@
 #include <QProcess>
 #include <QVBoxLayout>
 #include <QResizeEvent>
+#include <QStandardItemModel>
 #include <QPainterPath>
 
 #define BUTTON_WIDTH_MIN 68
@@ -50,7 +55,11 @@ FilterContent::FilterContent(QWidget *parent)
     initConnections();
 }
 
-FilterContent::~FilterContent() {}
+FilterContent::~FilterContent()
+{
+    if (m_volumeCanRun)
+        *m_volumeCanRun = false;
+}
 
 /**
  * @brief FilterContent::initUI 初始化界面
@@ -197,6 +206,24 @@ void FilterContent::initUI()
     hLayout_status->setSpacing(6);
     hLayout_all->addLayout(hLayout_auditType);  // end add
 
+    // klu启动日志启动选择下拉框
+    bootTxt = new DLabel(DApplication::translate("Label", "Boot:"), this);
+    bootCbx = new LogCombox(this);
+    bootCbx->setMinimumWidth(120);
+    bootCbx->setMinimumSize(QSize(120, BUTTON_HEIGHT_MIN));
+    hLayout_status->addWidget(bootTxt);
+    hLayout_status->addWidget(bootCbx, 1);
+
+    // 系统日志来源选择下拉框,选项来自journal的字段取值目录
+    journalFieldTxt = new DLabel(DApplication::translate("Label", "Source:"), this);
+    journalFieldCbx = new LogCombox(this);
+    journalFieldCbx->view()->setAccessibleName("combobox_journal_field_view");
+    journalFieldCbx->setMinimumWidth(160);
+    journalFieldCbx->setMinimumSize(QSize(160, BUTTON_HEIGHT_MIN));
+    journalFieldCbx->addItem(DApplication::translate("ComboBox", "All"), QString());
+    hLayout_status->addWidget(journalFieldTxt);
+    hLayout_status->addWidget(journalFieldCbx, 1);
+
     hLayout_all->addStretch(1);
     exportBtn = new LogNormalButton(DApplication::translate("Button", "Export", "button"), this);
     exportBtn->setContentsMargins(0, 0, 18, 18);
@@ -207,7 +234,7 @@ void FilterContent::initUI()
     vLayout->addLayout(hLayout_all);
     vLayout->setSpacing(16);
     this->setLayout(vLayout);
-    setSelectorVisible(true, false, false, true, false);
+    setSelectorVisible(true, false, false, true, false, false, false, false, false, true);
     m_currentType = JOUR_TREE_DATA;
     //设置初始筛选选项
 
@@ -236,6 +263,11 @@ void FilterContent::initConnections()
     connect(typeCbx, SIGNAL(currentIndexChanged(int)), this,
             SLOT(slot_cbxLogTypeChanged(int)));  // add by Airy
     connect(auditTypeCbx, SIGNAL(currentIndexChanged(int)), this, SLOT(slot_cbxAuditTypeChanged(int)));
+    connect(bootCbx, SIGNAL(currentIndexChanged(int)), this, SLOT(slot_cbxBootIdxChanged(int)));
+    connect(journalFieldCbx, SIGNAL(currentIndexChanged(int)), this, SLOT(slot_cbxJournalFieldIdxChanged(int)));
+    connect(LogJournalCatalog::instance(), &LogJournalCatalog::catalogChanged, this, &FilterContent::setJournalFieldComboBoxItem);
+    connect(LogJournalCatalog::instance(), &LogJournalCatalog::bootsChanged, this, &FilterContent::setBootComboBoxItem);
+    connect(LogApplicationHelper::instance(), &LogApplicationHelper::appLogsChanged, this, &FilterContent::slot_appLogsChanged);
 }
 
 /**
@@ -276,6 +308,97 @@ void FilterContent::setAppComboBoxItem()
 
 }
 
+/**
+ * @brief FilterContent::slot_appLogsChanged 应用日志后台扫描结束,正在查看应用日志时刷新下拉列表
+ * 原来选择的应用还在时只恢复选择,否则加载当前选项
+ */
+void FilterContent::slot_appLogsChanged()
+{
+    if (m_currentType != APP_TREE_DATA)
+        return;
+    const QString selected = cbx_app->itemData(cbx_app->currentIndex(), Qt::UserRole + 1).toString();
+    this->setAppComboBoxItem();
+    int index = cbx_app->findData(selected, Qt::UserRole + 1);
+    if (index >= 0) {
+        disconnect(cbx_app, SIGNAL(currentIndexChanged(int)), this, SLOT(slot_cbxAppIdxChanged(int)));
+        cbx_app->setCurrentIndex(index);
+        connect(cbx_app, SIGNAL(currentIndexChanged(int)), this, SLOT(slot_cbxAppIdxChanged(int)), Qt::UniqueConnection);
+    } else if (cbx_app->count() > 0) {
+        slot_cbxAppIdxChanged(cbx_app->currentIndex());
+    }
+}
+
+/**
+ * @brief FilterContent::setBootComboBoxItem 刷新klu启动日志的启动列表,保留之前选择的启动
+ * 列表在后台枚举,还没有结果时只有"当前启动"一项,枚举完成后再次调用本函数
+ */
+void FilterContent::setBootComboBoxItem()
+{
+    QString selected = bootCbx->currentData().toString();
+    disconnect(bootCbx, SIGNAL(currentIndexChanged(int)), this, SLOT(slot_cbxBootIdxChanged(int)));
+    bootCbx->clear();
+    //第一项固定为当前启动,数据为空,journal无法枚举时也能读取当前启动
+    bootCbx->addItem(DApplication::translate("ComboBox", "Current boot"), QString());
+    int selectedIndex = 0;
+    const QList<JournalBootInfo> boots = LogJournalCatalog::instance()->boots();
+    for (const JournalBootInfo &boot : boots) {
+        if (boot.current)
+            continue;
+        bootCbx->addItem(QString("%1 ~ %2").arg(JournalReaderBase::formatTime(boot.firstTime))
+                         .arg(JournalReaderBase::formatTime(boot.lastTime)), boot.bootId);
+        if (boot.bootId == selected)
+            selectedIndex = bootCbx->count() - 1;
+    }
+    bootCbx->setCurrentIndex(selectedIndex);
+    connect(bootCbx, SIGNAL(currentIndexChanged(int)), this, SLOT(slot_cbxBootIdxChanged(int)));
+    //之前选择的启动已不在journal中时回到当前启动,列表还没有枚举出来时保持选择
+    if (selectedIndex == 0 && !selected.isEmpty() && LogJournalCatalog::instance()->isBootsLoaded())
+        emit sigBootChanged(QString());
+}
+
+/**
+ * @brief FilterContent::setJournalFieldComboBoxItem 按journal的字段取值目录刷新系统日志的来源列表,保留之前选择的来源
+ * 目录在后台枚举,还没有结果时只有"全部"一项,枚举完成后再次调用本函数
+ */
+void FilterContent::setJournalFieldComboBoxItem()
+{
+    const QString selected = journalFieldCbx->currentData().toString();
+    disconnect(journalFieldCbx, SIGNAL(currentIndexChanged(int)), this, SLOT(slot_cbxJournalFieldIdxChanged(int)));
+    journalFieldCbx->clear();
+    journalFieldCbx->addItem(DApplication::translate("ComboBox", "All"), QString());
+    int selectedIndex = 0;
+    const struct {
+        LogJournalCatalog::Field field;
+        const char *title;
+    } groups[] = {
+        {LogJournalCatalog::Unit, QT_TRANSLATE_NOOP("ComboBox", "Units")},
+        {LogJournalCatalog::Identifier, QT_TRANSLATE_NOOP("ComboBox", "Identifiers")},
+        {LogJournalCatalog::Command, QT_TRANSLATE_NOOP("ComboBox", "Processes")},
+    };
+    QStandardItemModel *model = qobject_cast<QStandardItemModel *>(journalFieldCbx->model());
+    for (const auto &group : groups) {
+        const QStringList values = LogJournalCatalog::instance()->values(group.field);
+        if (values.isEmpty())
+            continue;
+        //分组标题不可选择,同名的标识符和进程名靠所在分组区分
+        journalFieldCbx->insertSeparator(journalFieldCbx->count());
+        journalFieldCbx->addItem(DApplication::translate("ComboBox", group.title), QString());
+        if (model)
+            model->item(journalFieldCbx->count() - 1)->setEnabled(false);
+        for (const QString &value : values) {
+            const QString match = LogJournalCatalog::match(group.field, value);
+            journalFieldCbx->addItem(value, match);
+            if (match == selected)
+                selectedIndex = journalFieldCbx->count() - 1;
+        }
+    }
+    journalFieldCbx->setCurrentIndex(selectedIndex);
+    connect(journalFieldCbx, SIGNAL(currentIndexChanged(int)), this, SLOT(slot_cbxJournalFieldIdxChanged(int)));
+    //之前选择的来源已不在journal中时回到全部来源;目录还没有枚举完时保留选择
+    if (selectedIndex == 0 && !selected.isEmpty() && LogJournalCatalog::instance()->isLoaded())
+        emit sigJournalFieldChanged(QString());
+}
+
 /**
  * @brief FilterContent::setSelectorVisible 设置筛选控件显示或不显示以适应各种日志类型的筛选情况
  * @param lvCbx 等级筛选下拉框是否显示
@@ -285,9 +408,12 @@ void FilterContent::setAppComboBoxItem()
  * @param needMove 如果筛选器只有单排布局,则需要移动导出按钮到上排布局,这个参数表示是否把导出按钮移动到上排的布局
  * @param typecbx 开关机日志日志种类筛选下拉框是否显示
  * @param auditcbx 审计日志审计类型筛选下拉框是否显示
+ * @param bootListCbx klu启动日志启动选择下拉框是否显示
+ * @param journalFieldList 系统日志来源选择下拉框是否显示
  */
 void FilterContent::setSelectorVisible(bool lvCbx, bool appListCbx, bool statusCbx, bool period,
-                                       bool needMove, bool typecbx, bool dnfCbx, bool auditCbx)
+                                       bool needMove, bool typecbx, bool dnfCbx, bool auditCbx,
+                                       bool bootListCbx, bool journalFieldList)
 {
     //先不立马更新界面,等全部更新好控件状态后再更新界面,否则会导致界面跳动
     setUpdatesEnabled(false);
@@ -307,6 +433,12 @@ void FilterContent::setSelectorVisible(bool lvCbx, bool appListCbx, bool statusC
     auditTypeTxt->setVisible(auditCbx);
     auditTypeCbx->setVisible(auditCbx);
 
+    bootTxt->setVisible(bootListCbx);
+    bootCbx->setVisible(bootListCbx);
+
+    journalFieldTxt->setVisible(journalFieldList);
+    journalFieldCbx->setVisible(journalFieldList);
+
     periodLabel->setVisible(period);
     //button的setVisible false会触发taborder到下一个可视控件,比如cbx_status,所以先设置button,再设置cbx_status可防止点击后时间筛选button后再切启动日志导致cbx_status自动进入tabfocus状态,但是这样会引起本窗口焦点重置,所以设置完后需要对loglist setfoucs
     for (int i = 0; i < 6; i++) {
@@ -629,7 +761,10 @@ void FilterContent::slot_logCatelogueClicked(const QModelIndex &index)
         this->setSelectorVisible(true, true, false, true, false);
     } else if (itemData.contains(JOUR_TREE_DATA, Qt::CaseInsensitive)) {
         m_currentType = JOUR_TREE_DATA;
-        this->setSelectorVisible(true, false, false, true, false);
+        //目录已过期时在后台重新枚举,完成后刷新列表
+        LogJournalCatalog::instance()->refresh();
+        this->setJournalFieldComboBoxItem();
+        this->setSelectorVisible(true, false, false, true, false, false, false, false, false, true);
     } else if (itemData.contains(BOOT_TREE_DATA)) {
         m_currentType = BOOT_TREE_DATA;
         this->setSelectorVisible(false, false, true, false, false);
@@ -652,7 +787,10 @@ void FilterContent::slot_logCatelogueClicked(const QModelIndex &index)
         this->setSelectorVisible(false, false, false, false, false);
     } else if (itemData.contains(BOOT_KLU_TREE_DATA)) {
         m_currentType = BOOT_KLU_TREE_DATA;
-        this->setSelectorVisible(true, false, false, false, false);
+        //启动列表已过期时在后台重新枚举,完成后刷新列表
+        LogJournalCatalog::instance()->refreshBoots();
+        this->setBootComboBoxItem();
+        this->setSelectorVisible(true, false, false, false, false, false, false, false, true);
     } else if (itemData.contains(DNF_TREE_DATA)) {
         m_currentType = DNF_TREE_DATA;
         this->setSelectorVisible(false, false, false, true, false, false, true);
@@ -676,6 +814,7 @@ void FilterContent::slot_logCatelogueClicked(const QModelIndex &index)
         this->setSelectorVisible(false, false, false, true, true, false, false, false);
     }
     updateDataState();
+    updateVolume();
     //必须需要,因为会丢失当前焦点顺序
     LogListView *logList =  qobject_cast<LogListView *>(sender());
     if (logList) {
@@ -684,6 +823,78 @@ void FilterContent::slot_logCatelogueClicked(const QModelIndex &index)
 
 }
 
+/**
+ * @brief FilterContent::updateVolume 切换类别后在后台更新该类别的数据量统计,完成后在时间筛选按钮的提示中显示各时间段的条目数
+ * 只统计系统日志、内核日志和dpkg日志,统计结果增量保存,再次切换时只统计新增的部分
+ */
+void FilterContent::updateVolume()
+{
+    QString source;
+    if (m_currentType == JOUR_TREE_DATA)
+        source = "journal";
+    else if (m_currentType == KERN_TREE_DATA)
+        source = "kern";
+    else if (m_currentType == DPKG_TREE_DATA)
+        source = "dpkg";
+    if (source == m_volumeSource && !m_volume.isEmpty()) {
+        updatePeriodTips();
+        return;
+    }
+
+    if (m_volumeCanRun)
+        *m_volumeCanRun = false;
+    m_volumeCanRun.reset();
+    m_volumeSource = source;
+    m_volume.clear();
+    updatePeriodTips();
+    if (source.isEmpty())
+        return;
+
+    m_volumeCanRun = std::make_shared<std::atomic_bool>(true);
+    LogVolumeWork *work = new LogVolumeWork(source, m_volumeCanRun);
+    connect(work, &LogVolumeWork::volumeReady, this, &FilterContent::onVolumeReady);
+    LogWorkScheduler::instance()->start(work, LogWorkScheduler::Prefetch);
+}
+
+void FilterContent::onVolumeReady(const QString &source, const LogVolumeHistogram &histogram)
+{
+    if (source != m_volumeSource)
+        return;
+    m_volume = histogram;
+    updatePeriodTips();
+}
+
+/**
+ * @brief FilterContent::updatePeriodTips 按当前等级在时间筛选按钮的提示中显示条目数,条目很多时提示加载较慢
+ */
+void FilterContent::updatePeriodTips()
+{
+    const QStringList names {
+        DApplication::translate("Button", "All"),
+        DApplication::translate("Button", "Today"),
+        DApplication::translate("Button", "3 days"),
+        DApplication::translate("Button", "1 week"),
+        DApplication::translate("Button", "1 month"),
+        DApplication::translate("Button", "3 months")
+    };
+    //只有系统日志按等级统计
+    const int level = m_volumeSource == "journal" ? m_curLvCbxId : -1;
+    for (int id = ALL; id <= THREE_MONTHS; ++id) {
+        QAbstractButton *button = m_btnGroup->button(id);
+        if (!button)
+            continue;
+        if (m_volume.isEmpty()) {
+            button->setToolTip(names.at(id));
+            continue;
+        }
+        const qint64 count = m_volume.count(LogVolumeHistogram::periodBegin(id), -1, level);
+        QString tip = names.at(id) + "\n" + DApplication::translate("Button", "About %1 entries").arg(QLocale().toString(count));
+        if (count >= LOG_VOLUME_HEAVY_ROWS)
+            tip += "\n" + DApplication::translate("Button", "Loading may take a while");
+        button->setToolTip(tip);
+    }
+}
+
 /**
  * @brief FilterContent::slot_logCatelogueRefresh 日志种类选择listview的右键菜单刷新时处理的槽函数
  * @param index 刷新对应的日志种类
@@ -776,6 +987,7 @@ void FilterContent::slot_cbxLvIdxChanged(int idx)
 {
     setChangedcomboxstate(true);
     m_curLvCbxId = idx - 1;
+    updatePeriodTips();
     FILTER_CONFIG curConfig = m_config.value(m_currentType);
     curConfig.levelCbx = idx;
     //变化时改变记录选择选项的数据结构,以便下次还原
@@ -842,6 +1054,26 @@ void FilterContent::slot_cbxAuditTypeChanged(int idx)
     emit sigAuditTypeChanged(idx);
 }
 
+/**
+ * @brief FilterContent::slot_cbxBootIdxChanged klu启动日志启动选择下拉框选择变化处理槽函数
+ * @param idx 当前选择的选项下标
+ */
+void FilterContent::slot_cbxBootIdxChanged(int idx)
+{
+    setChangedcomboxstate(true);
+    emit sigBootChanged(bootCbx->itemData(idx).toString());
+}
+
+/**
+ * @brief FilterContent::slot_cbxJournalFieldIdxChanged 系统日志来源下拉框选择变化处理槽函数
+ * @param idx 当前选择的下标
+ */
+void FilterContent::slot_cbxJournalFieldIdxChanged(int idx)
+{
+    setChangedcomboxstate(true);
+    emit sigJournalFieldChanged(journalFieldCbx->itemData(idx).toString());
+}
+
 /**
  * @brief FilterContent::setExportButtonEnable 导出按钮是否置灰
  * @param iEnable true 不置灰 false 置灰
@@ -5,6 +5,7 @@
 #ifndef FILTERCONTENT_H
 #define FILTERCONTENT_H
 #include "structdef.h"
+#include "logvolumehistogram.h"
 
 #include <DComboBox>
 #include <DFrame>
@@ -17,6 +18,9 @@
 #include <QHBoxLayout>
 #include <QWidget>
 
+#include <atomic>
+#include <memory>
+
 class LogCombox;
 class LogPeriodButton;
 class LogNormalButton;
@@ -65,9 +69,12 @@ protected:
 
 private:
     void setAppComboBoxItem();
+    void setBootComboBoxItem();
+    void setJournalFieldComboBoxItem();
 
     void setSelectorVisible(bool lvCbx, bool appListCbx, bool statusCbx, bool period, bool needMove,
-                            bool typecbx = false, bool dnfCbx = false, bool auditCbx = false); // modified by Airy
+                            bool typecbx = false, bool dnfCbx = false, bool auditCbx = false,
+                            bool bootListCbx = false, bool journalFieldList = false); // modified by Airy
     void setSelection(FILTER_CONFIG iConifg);
 
     void setUeButtonSytle();
@@ -76,6 +83,9 @@ private:
     void updateWordWrap();
     void updateDataState();
     void setCurrentConfig(FILTER_CONFIG iConifg);
+    void updateVolume();
+    void updatePeriodTips();
+    void onVolumeReady(const QString &source, const LogVolumeHistogram &histogram);
 
 
 signals:
@@ -110,6 +120,16 @@ signals:
      * @param tId 下拉框当前index
      */
     void sigAuditTypeChanged(int tId);
+    /**
+     * @brief sigBootChanged  klu启动日志启动选择下拉框触发信号
+     * @param bootId 选择的启动的bootid,为空表示当前启动
+     */
+    void sigBootChanged(const QString &bootId);
+    /**
+     * @brief sigJournalFieldChanged  系统日志来源下拉框触发信号
+     * @param match 选择的来源对应的journal匹配,如"_SYSTEMD_UNIT=sshd.service",为空表示全部来源
+     */
+    void sigJournalFieldChanged(const QString &match);
     /**
      * @brief sigResizeWidth  当前控件应有宽度信号
      * @param iWidth 计算宽度
@@ -126,8 +146,11 @@ public slots:
     void slot_cbxStatusChanged(int idx);
     void slot_cbxLogTypeChanged(int idx);  // add  by Airy
     void slot_cbxAuditTypeChanged(int idx);
+    void slot_cbxBootIdxChanged(int idx);
+    void slot_cbxJournalFieldIdxChanged(int idx);
     void setExportButtonEnable(bool iEnable);
     void slot_cbxDnfLvIdxChanged(int idx);
+    void slot_appLogsChanged();
 
 private:
     /**
@@ -186,6 +209,22 @@ private:
      * @brief typeCbx 审计日志审计类型筛选下拉框
      */
     LogCombox *auditTypeCbx;
+    /**
+     * @brief bootTxt klu启动日志启动选择下拉框前面的提示文字
+     */
+    Dtk::Widget::DLabel *bootTxt;
+    /**
+     * @brief bootCbx klu启动日志启动选择下拉框,选项数据为bootid
+     */
+    LogCombox *bootCbx;
+    /**
+     * @brief journalFieldTxt 系统日志来源下拉框前面的提示文字
+     */
+    Dtk::Widget::DLabel *journalFieldTxt;
+    /**
+     * @brief journalFieldCbx 系统日志来源下拉框,按服务单元、标识符、进程名分组,选项数据为journal匹配
+     */
+    LogCombox *journalFieldCbx;
     /**
      * @brief m_curTreeIndex 日志种类选择listview传进来的当前选择的日志种类信息
      */
@@ -227,6 +266,14 @@ private:
     bool isLeval = true;
     bool m_bIsClickLeftlistButton = false;
     bool m_bIsCombox = false;
+    /**
+     * @brief m_volumeSource 当前类别对应的数据量统计来源,为空表示不显示各时间段的条目数
+     */
+    QString m_volumeSource;
+    //当前来源的直方图,统计完成前为空
+    LogVolumeHistogram m_volume;
+    //正在进行的统计的取消标记
+    std::shared_ptr<std::atomic_bool> m_volumeCanRun;
 };
 
 #endif  // FILTERCONTENT_H
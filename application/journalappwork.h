@@ -6,6 +6,7 @@
 #define JOURNALAPPWORK_H
 
 #include "structdef.h"
+#include "logingestmetrics.h"
 
 #include <QMap>
 #include <QObject>
@@ -27,8 +28,11 @@ public:
     ~JournalAppWork();
 
     void setArg(QStringList arg);
+    void setApps(const QStringList &apps);
     void run() override;
 
+    static QMap<QString, QList<LOG_MSG_APPLICATOIN>> demultiplex(const QList<LOG_MSG_APPLICATOIN> &list);
+
 signals:
     /**
      * @brief journalData 把获取到的一部分数据传出去的信号
@@ -36,6 +40,13 @@ signals:
      * @param list 数据list
      */
     void journalAppData(int index, QList<LOG_MSG_APPLICATOIN> list);
+    /**
+     * @brief journalAppsData 多应用模式下按应用分发的一部分数据
+     * @param index 当前线程的数字标号
+     * @param app 数据所属应用的SYSLOG_IDENTIFIER
+     * @param list 数据list
+     */
+    void journalAppsData(int index, const QString &app, QList<LOG_MSG_APPLICATOIN> list);
     /**
      * @brief journalFinished 获取数据结束
      */
@@ -59,21 +70,21 @@ public:
     static int thread_index ;
 private:
     QString getDateTimeFromStamp(const QString &str);
-    void initMap();
-    QString i2str(int prio);
     /**
      * @brief m_arg 获取数据筛选参数
      */
     QStringList m_arg;
     /**
-     * @brief m_map 等级数字对应字符串
+     * @brief m_apps 多应用模式下要读取的应用SYSLOG_IDENTIFIER,为空时读取m_arg最后一项指定的单个应用
      */
-    QMap<int, QString> m_map;
+    QStringList m_apps;
     static std::mutex m_mutex;
     /**
      * @brief m_canRun  是否允许标记量，用于停止该线程
      */
     std::atomic_bool m_canRun = false;
+    //构造时(界面发起加载时)所属加载的指标计数,运行时安装到解析线程
+    LogIngestCountersPtr m_ingest {LogIngestMetrics::current()};
     /**
      * @brief m_threadIndex 当前线程标号
      */
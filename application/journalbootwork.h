@@ -6,6 +6,7 @@
 #define JOURNALBOOTWORK_H
 
 #include "structdef.h"
+#include "logingestmetrics.h"
 
 #include <QMap>
 #include <QObject>
@@ -44,6 +45,7 @@ public:
 
 
     void setArg(QStringList arg);
+    void setBootId(const QString &bootId);
     void run() override;
 
 signals:
@@ -81,16 +83,14 @@ public:
     static int thread_index ;
 private:
     QString getDateTimeFromStamp(const QString &str);
-    void initMap();
-    QString i2str(int prio);
     /**
      * @brief m_arg 获取数据筛选参数
      */
     QStringList m_arg;
     /**
-     * @brief m_map 等级数字对应字符串
+     * @brief m_bootId 要读取的启动的bootid,为空时读取当前启动
      */
-    QMap<int, QString> m_map;
+    QString m_bootId;
     static std::atomic<JournalBootWork *> m_instance;
     static std::mutex m_mutex;
     QEventLoop loop;
@@ -98,6 +98,8 @@ private:
      * @brief m_canRun  是否允许标记量，用于停止该线程
      */
     std::atomic_bool m_canRun = false;
+    //构造时(界面发起加载时)所属加载的指标计数,运行时安装到解析线程
+    LogIngestCountersPtr m_ingest {LogIngestMetrics::current()};
     /**
      * @brief m_threadIndex 当前线程标号
      */
@@ -0,0 +1,384 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "journalfielddecoder.h"
+
+#include <QByteArray>
+
+#include <string.h>
+
+/**
+ * @brief JournalFieldDecoder::decode 解析"字段名=值"格式的journal数据,返回'='之后的值
+ * @param data sd_journal_get_data返回的数据指针,不保证以'\0'结尾
+ * @param length 数据长度
+ * @return 清洗后的字段值,没有'='时返回空字符串
+ */
+QString JournalFieldDecoder::decode(const char *data, size_t length)
+{
+    if (!data || length == 0)
+        return QString();
+
+    //值中也可能含有'=',只按第一个'='切分
+    const char *eq = static_cast<const char *>(memchr(data, '=', length));
+    if (!eq)
+        return QString();
+
+    const char *value = eq + 1;
+    return sanitize(value, length - static_cast<size_t>(value - data));
+}
+
+/**
+ * @brief JournalFieldDecoder::sanitize 去掉空字符、\x01、\x02和终端颜色控制序列(ESC[n;n;nm)
+ * @param data 原始数据
+ * @param length 数据长度
+ * @return 清洗后的字符串
+ */
+QString JournalFieldDecoder::sanitize(const char *data, size_t length)
+{
+    if (!data || length == 0)
+        return QString();
+
+    //绝大多数字段不含控制字符,直接构造,不产生额外拷贝
+    size_t i = 0;
+    for (; i < length; ++i) {
+        const uchar c = static_cast<uchar>(data[i]);
+        if (c <= 0x02 || c == 0x1B)
+            break;
+    }
+    if (i == length)
+        return QString::fromUtf8(data, static_cast<int>(length));
+
+    QByteArray buffer;
+    buffer.reserve(static_cast<int>(length));
+    buffer.append(data, static_cast<int>(i));
+    while (i < length) {
+        const char c = data[i];
+        if (c == '\0' || c == '\x01' || c == '\x02') {
+            ++i;
+            continue;
+        }
+        if (c == '\x1B') {
+            size_t seqLength = colorSequenceLength(data + i, length - i);
+            if (seqLength > 0) {
+                i += seqLength;
+                continue;
+            }
+        }
+        buffer.append(c);
+        ++i;
+    }
+    return QString::fromUtf8(buffer);
+}
+
+/**
+ * @brief JournalFieldDecoder::field 获取当前条目指定字段的值
+ * @param j journal句柄
+ * @param name 字段名
+ * @param value 输出的字段值
+ * @return 是否获取成功
+ */
+bool JournalFieldDecoder::field(sd_journal *j, const char *name, QString &value)
+{
+    const void *data = nullptr;
+    size_t length = 0;
+    if (sd_journal_get_data(j, name, &data, &length) < 0)
+        return false;
+
+    value = decode(static_cast<const char *>(data), length);
+    return true;
+}
+
+/**
+ * @brief JournalFieldDecoder::field 获取当前条目指定字段的值,值经由字符串池共享,用于主机名、进程名等低基数字段
+ * @param j journal句柄
+ * @param name 字段名
+ * @param value 输出的字段值
+ * @param pool 字符串池,按'='之后的原始字节查找,命中时不再清洗和解码
+ * @return 是否获取成功
+ */
+bool JournalFieldDecoder::field(sd_journal *j, const char *name, QString &value, LogStringPool &pool)
+{
+    const void *data = nullptr;
+    size_t length = 0;
+    if (sd_journal_get_data(j, name, &data, &length) < 0)
+        return false;
+
+    const char *str = static_cast<const char *>(data);
+    const char *eq = str ? static_cast<const char *>(memchr(str, '=', length)) : nullptr;
+    if (!eq) {
+        value.clear();
+        return true;
+    }
+    const char *begin = eq + 1;
+    value = pool.intern(begin, length - static_cast<size_t>(begin - str), sanitize);
+    return true;
+}
+
+/**
+ * @brief JournalFieldDecoder::fieldPrefix 获取当前条目指定字段值的前一部分,超长的值不构造完整字符串
+ * @param j journal句柄
+ * @param name 字段名
+ * @param maxLength 最多保留的字节数,截断位置会回退到完整的UTF-8字符边界
+ * @param value 输出的字段值
+ * @param truncated 输出值是否被截断
+ * @return 是否获取成功
+ */
+bool JournalFieldDecoder::fieldPrefix(sd_journal *j, const char *name, size_t maxLength, QString &value, bool &truncated)
+{
+    const void *data = nullptr;
+    size_t length = 0;
+    truncated = false;
+    if (sd_journal_get_data(j, name, &data, &length) < 0)
+        return false;
+
+    const char *str = static_cast<const char *>(data);
+    if (!str || length == 0) {
+        value.clear();
+        return true;
+    }
+    const char *eq = static_cast<const char *>(memchr(str, '=', length));
+    if (!eq) {
+        value.clear();
+        return true;
+    }
+
+    const char *valueData = eq + 1;
+    value = prefix(valueData, length - static_cast<size_t>(valueData - str), maxLength, truncated);
+    return true;
+}
+
+/**
+ * @brief JournalFieldDecoder::fieldNumber 获取当前条目指定的数字字段(如PRIORITY),不构造中间字符串
+ * @param j journal句柄
+ * @param name 字段名
+ * @param value 输出的数值
+ * @return 是否获取成功且为合法数字
+ */
+bool JournalFieldDecoder::fieldNumber(sd_journal *j, const char *name, qint64 &value)
+{
+    const void *data = nullptr;
+    size_t length = 0;
+    if (sd_journal_get_data(j, name, &data, &length) < 0)
+        return false;
+
+    const char *str = static_cast<const char *>(data);
+    if (!str || length == 0)
+        return false;
+    const char *eq = static_cast<const char *>(memchr(str, '=', length));
+    if (!eq)
+        return false;
+    const char *valueData = eq + 1;
+    return parseNumber(valueData, length - static_cast<size_t>(valueData - str), value);
+}
+
+/**
+ * @brief JournalFieldDecoder::parseNumber 解析字段值开头的十进制数字
+ * @param data 字段值('='之后的部分)
+ * @param length 字段值长度
+ * @param value 输出的数值
+ * @return 是否以数字开头
+ */
+bool JournalFieldDecoder::parseNumber(const char *data, size_t length, qint64 &value)
+{
+    qint64 result = 0;
+    bool hasDigit = false;
+    for (const char *p = data; p < data + length; ++p) {
+        if (*p < '0' || *p > '9')
+            break;
+        result = result * 10 + (*p - '0');
+        hasDigit = true;
+    }
+    if (!hasDigit)
+        return false;
+
+    value = result;
+    return true;
+}
+
+/**
+ * @brief JournalFieldDecoder::prefix 清洗字段值后取前一部分,截断位置会回退到完整的UTF-8字符边界
+ * 先清洗再截断,截断位置不会落在颜色控制序列中间留下半个序列
+ * @param data 字段值('='之后的部分)
+ * @param length 字段值长度
+ * @param maxLength 清洗后最多保留的字节数
+ * @param truncated 输出值是否被截断
+ */
+QString JournalFieldDecoder::prefix(const char *data, size_t length, size_t maxLength, bool &truncated)
+{
+    truncated = false;
+    if (!data || length == 0)
+        return QString();
+
+    //多清洗出一个字节,用来判断后面是否还有内容
+    QByteArray buffer;
+    buffer.reserve(static_cast<int>(qMin(length, maxLength + 1)));
+    size_t i = 0;
+    while (i < length && static_cast<size_t>(buffer.size()) <= maxLength) {
+        const char c = data[i];
+        if (c == '\0' || c == '\x01' || c == '\x02') {
+            ++i;
+            continue;
+        }
+        if (c == '\x1B') {
+            size_t seqLength = colorSequenceLength(data + i, length - i);
+            if (seqLength > 0) {
+                i += seqLength;
+                continue;
+            }
+        }
+        buffer.append(c);
+        ++i;
+    }
+    if (static_cast<size_t>(buffer.size()) > maxLength) {
+        size_t cut = maxLength;
+        //不从多字节字符中间截断
+        while (cut > 0 && (static_cast<uchar>(buffer.at(static_cast<int>(cut))) & 0xC0) == 0x80)
+            --cut;
+        buffer.truncate(static_cast<int>(cut));
+        truncated = true;
+    }
+    return QString::fromUtf8(buffer);
+}
+
+/**
+ * @brief JournalFieldDecoder::colorSequenceLength 判断data开头是否为颜色控制序列 ESC[数字(;数字){0,2}m
+ * @param data 以ESC开头的数据
+ * @param length 剩余长度
+ * @return 序列长度,不是颜色序列时返回0
+ */
+size_t JournalFieldDecoder::colorSequenceLength(const char *data, size_t length)
+{
+    if (length < 4 || data[0] != '\x1B' || data[1] != '[')
+        return 0;
+
+    size_t i = 2;
+    int groups = 0;
+    while (groups < 3) {
+        size_t digitStart = i;
+        while (i < length && data[i] >= '0' && data[i] <= '9')
+            ++i;
+        if (i == digitStart)
+            return 0;
+        ++groups;
+        if (i >= length)
+            return 0;
+        if (data[i] == 'm')
+            return i + 1;
+        if (data[i] != ';' || groups == 3)
+            return 0;
+        ++i;
+    }
+    return 0;
+}
+
+JournalEntryFields::JournalEntryFields(const QList<QByteArray> &policyFields)
+{
+    const QList<QByteArray> names = QList<QByteArray>() << "_SOURCE_REALTIME_TIMESTAMP"
+                                                        << "PRIORITY" << policyFields;
+    m_slots.resize(names.size());
+    for (int i = 0; i < names.size(); ++i)
+        m_slots[i].name = names.at(i);
+}
+
+/**
+ * @brief JournalEntryFields::read 遍历当前条目的全部字段,记下需要的字段值
+ * 遍历中途出错(如条目损坏)时,没有取到的字段再逐个用sd_journal_get_data补取
+ */
+void JournalEntryFields::read(sd_journal *j)
+{
+    m_buffer.clear();
+    for (Slot &slot : m_slots)
+        slot.found = false;
+
+    const void *data = nullptr;
+    size_t length = 0;
+    int r = 0;
+    int remaining = m_slots.size();
+    sd_journal_restart_data(j);
+    while (remaining > 0 && (r = sd_journal_enumerate_data(j, &data, &length)) > 0) {
+        const char *str = static_cast<const char *>(data);
+        const char *eq = static_cast<const char *>(memchr(str, '=', length));
+        if (!eq)
+            continue;
+        const int nameLength = static_cast<int>(eq - str);
+        for (Slot &slot : m_slots) {
+            if (!slot.found && slot.name.size() == nameLength && memcmp(slot.name.constData(), str, static_cast<size_t>(nameLength)) == 0) {
+                store(slot, str, length);
+                --remaining;
+                break;
+            }
+        }
+    }
+    if (r >= 0)
+        return;
+
+    for (Slot &slot : m_slots) {
+        if (!slot.found && sd_journal_get_data(j, slot.name.constData(), &data, &length) >= 0)
+            store(slot, static_cast<const char *>(data), length);
+    }
+}
+
+/**
+ * @brief JournalEntryFields::store 把"字段名=值"中的值拷贝到缓冲中
+ */
+void JournalEntryFields::store(Slot &slot, const char *data, size_t length)
+{
+    const char *eq = data ? static_cast<const char *>(memchr(data, '=', length)) : nullptr;
+    slot.found = true;
+    slot.offset = m_buffer.size();
+    slot.length = eq ? length - static_cast<size_t>(eq + 1 - data) : 0;
+    if (slot.length > 0)
+        m_buffer.insert(m_buffer.end(), eq + 1, data + length);
+}
+
+bool JournalEntryFields::contains(int index) const
+{
+    return m_slots.at(index).found;
+}
+
+/**
+ * @brief JournalEntryFields::field 获取字段值,和JournalFieldDecoder::field一致
+ */
+bool JournalEntryFields::field(int index, QString &value) const
+{
+    const Slot &slot = m_slots.at(index);
+    if (!slot.found)
+        return false;
+    value = JournalFieldDecoder::sanitize(valueData(slot), slot.length);
+    return true;
+}
+
+/**
+ * @brief JournalEntryFields::field 获取字段值,值经由字符串池共享
+ */
+bool JournalEntryFields::field(int index, QString &value, LogStringPool &pool) const
+{
+    const Slot &slot = m_slots.at(index);
+    if (!slot.found)
+        return false;
+    if (slot.length == 0)
+        value.clear();
+    else
+        value = pool.intern(valueData(slot), slot.length, JournalFieldDecoder::sanitize);
+    return true;
+}
+
+bool JournalEntryFields::fieldNumber(int index, qint64 &value) const
+{
+    const Slot &slot = m_slots.at(index);
+    return slot.found && JournalFieldDecoder::parseNumber(valueData(slot), slot.length, value);
+}
+
+/**
+ * @brief JournalEntryFields::fieldPrefix 获取字段值的前一部分,和JournalFieldDecoder::fieldPrefix一致
+ */
+bool JournalEntryFields::fieldPrefix(int index, size_t maxLength, QString &value, bool &truncated) const
+{
+    const Slot &slot = m_slots.at(index);
+    truncated = false;
+    if (!slot.found)
+        return false;
+    value = JournalFieldDecoder::prefix(valueData(slot), slot.length, maxLength, truncated);
+    return true;
+}
@@ -0,0 +1,82 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef JOURNALFIELDDECODER_H
+#define JOURNALFIELDDECODER_H
+
+#include "logstringpool.h"
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+#include <QVector>
+
+#include <systemd/sd-journal.h>
+
+#include <vector>
+
+/**
+ * @brief The JournalFieldDecoder class journal字段解码工具,供所有journal获取线程共用
+ * 直接在sd_journal_get_data返回的(指针,长度)上截取'='之后的值,
+ * 只有字段中含有ESC/控制字符时才做一次线性清洗,最后只构造一次QString
+ */
+class JournalFieldDecoder
+{
+public:
+    static QString decode(const char *data, size_t length);
+    static QString sanitize(const char *data, size_t length);
+    static bool field(sd_journal *j, const char *name, QString &value);
+    static bool field(sd_journal *j, const char *name, QString &value, LogStringPool &pool);
+    static bool fieldNumber(sd_journal *j, const char *name, qint64 &value);
+    static bool fieldPrefix(sd_journal *j, const char *name, size_t maxLength, QString &value, bool &truncated);
+    static bool parseNumber(const char *data, size_t length, qint64 &value);
+    static QString prefix(const char *data, size_t length, size_t maxLength, bool &truncated);
+
+private:
+    static size_t colorSequenceLength(const char *data, size_t length);
+};
+
+/**
+ * @brief The JournalEntryFields class 一次遍历当前条目的全部字段,取出需要的字段值
+ * sd_journal_get_data每次都从头比对条目中的各个字段,每条取六七个字段时整条被走六七遍;
+ * 这里用sd_journal_enumerate_data只走一遍,按字段名分派。enumerate返回的指针在下一次调用时就可能失效
+ * (压缩字段共用同一个解压缓冲),所以命中的值先拷贝到复用的缓冲中,之后按下标解码
+ */
+class JournalEntryFields
+{
+public:
+    //所有读取都需要的字段的下标,各Policy的字段从PolicyField开始编号
+    enum CommonField {
+        SourceRealtime,
+        Priority,
+        PolicyField
+    };
+
+    explicit JournalEntryFields(const QList<QByteArray> &policyFields = QList<QByteArray>());
+
+    void read(sd_journal *j);
+    bool contains(int index) const;
+    bool field(int index, QString &value) const;
+    bool field(int index, QString &value, LogStringPool &pool) const;
+    bool fieldNumber(int index, qint64 &value) const;
+    bool fieldPrefix(int index, size_t maxLength, QString &value, bool &truncated) const;
+
+private:
+    struct Slot {
+        QByteArray name;
+        bool found = false;
+        //值('='之后的部分)在m_buffer中的位置
+        size_t offset = 0;
+        size_t length = 0;
+    };
+
+    void store(Slot &slot, const char *data, size_t length);
+    const char *valueData(const Slot &slot) const { return m_buffer.data() + slot.offset; }
+
+    QVector<Slot> m_slots;
+    //clear不释放容量,逐条读取时不再分配
+    std::vector<char> m_buffer;
+};
+
+#endif  // JOURNALFIELDDECODER_H
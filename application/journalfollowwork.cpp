@@ -0,0 +1,116 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "journalfollowwork.h"
+#include "journalreader.h"
+
+#include <DApplication>
+
+#include <QLoggingCategory>
+
+#ifdef QT_DEBUG
+Q_LOGGING_CATEGORY(logJournalFollow, "org.deepin.log.viewer.parse.system.journal.follow")
+#else
+Q_LOGGING_CATEGORY(logJournalFollow, "org.deepin.log.viewer.parse.system.journal.follow", QtInfoMsg)
+#endif
+
+DWIDGET_USE_NAMESPACE
+
+int JournalFollowWork::thread_index = 0;
+
+/**
+ * @brief JournalFollowWork::JournalFollowWork 线程构造函数
+ * @param parent 父对象
+ */
+JournalFollowWork::JournalFollowWork(QObject *parent)
+    : QObject(parent)
+    , QRunnable()
+{
+    qRegisterMetaType<QList<LOG_MSG_JOURNAL> >("QList<LOG_MSG_JOURNAL>");
+    //使用线程池启动该线程，跑完自己删自己
+    setAutoDelete(true);
+    //静态计数变量加一并赋值给本对象的成员变量，以供外部判断是否为最新线程发出的数据信号
+    thread_index++;
+    m_threadIndex = thread_index;
+}
+
+JournalFollowWork::~JournalFollowWork()
+{
+}
+
+/**
+ * @brief JournalFollowWork::setArg 设置筛选参数,和journalWork一致
+ * @param arg 筛选参数
+ */
+void JournalFollowWork::setArg(const QStringList &arg)
+{
+    m_arg = arg;
+}
+
+/**
+ * @brief JournalFollowWork::setStartCursor 设置起始游标
+ * @param cursor 已读取到的最新一条日志的游标
+ */
+void JournalFollowWork::setStartCursor(const QString &cursor)
+{
+    m_startCursor = cursor.toUtf8();
+}
+
+/**
+ * @brief JournalFollowWork::run 线程执行函数
+ */
+void JournalFollowWork::run()
+{
+    qCDebug(logJournalFollow) << "threadrun";
+    doWork();
+}
+
+/**
+ * @brief JournalFollowWork::doWork 阻塞跟踪新日志,直到被停止
+ */
+void JournalFollowWork::doWork()
+{
+    JournalReadOptions options = JournalReadOptions::fromArgs(m_arg);
+    options.stopCursor = m_startCursor;
+
+    //过长的信息只保留前缀,完整内容在选中或导出时通过游标读取
+    SystemJournalPolicy policy;
+    policy.lazyMessage = true;
+    JournalReader<SystemJournalPolicy> reader(policy, m_canRun);
+    int r = reader.follow(options, [this, &reader](QList<LOG_MSG_JOURNAL> &list) {
+        emit journalFollowData(m_threadIndex, list, reader.newestCursor());
+    });
+    //被停止时不再发出任何信号
+    if (r == -ECANCELED)
+        return;
+    qCWarning(logJournalFollow) << "follow journal failed:" << reader.errorString();
+    emit journalFollowFinished(m_threadIndex);
+}
+
+/**
+ * @brief JournalFollowWork::stopWork 停止该线程,最迟在一次等待超时后退出
+ */
+void JournalFollowWork::stopWork()
+{
+    qCDebug(logJournalFollow) << "stopWork";
+    m_canRun = false;
+}
+
+/**
+ * @brief JournalFollowWork::getIndex 获取当前对象的计数
+ * @return 当前对象的计数标号
+ */
+int JournalFollowWork::getIndex()
+{
+    return m_threadIndex;
+}
+
+/**
+ * @brief JournalFollowWork::getPublicIndex 获取现在此类产生对象的个数
+ * @return 此类产生对象的个数，静态成员变量
+ */
+int JournalFollowWork::getPublicIndex()
+{
+    return thread_index;
+}
@@ -0,0 +1,75 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef JOURNALFOLLOWWORK_H
+#define JOURNALFOLLOWWORK_H
+
+#include "structdef.h"
+
+#include <QMap>
+#include <QObject>
+#include <QRunnable>
+
+#include <atomic>
+
+/**
+ * @brief The JournalFollowWork class 系统日志实时跟踪线程,阻塞等待journal新追加的日志并只发出新日志
+ */
+class JournalFollowWork : public QObject, public QRunnable
+{
+    Q_OBJECT
+
+public:
+    explicit JournalFollowWork(QObject *parent = nullptr);
+    ~JournalFollowWork();
+
+    void setArg(const QStringList &arg);
+    void setStartCursor(const QString &cursor);
+    void run() override;
+
+signals:
+    /**
+     * @brief journalFollowData 新追加的日志
+     * @param index 当前线程的数字标号
+     * @param list 按从新到旧排列的新日志
+     * @param cursor 其中最新一条日志的游标
+     */
+    void journalFollowData(int index, QList<LOG_MSG_JOURNAL> list, const QString &cursor);
+    /**
+     * @brief journalFollowFinished 跟踪出错结束,被停止时不发出
+     */
+    void journalFollowFinished(int index);
+
+public slots:
+    void doWork();
+    void stopWork();
+    int getIndex();
+    static int getPublicIndex();
+
+public:
+    /**
+     * @brief thread_index 静态成员变量，用来每次构造时标记新的当前线程对象 m_threadIndex
+     */
+    static int thread_index;
+
+private:
+    /**
+     * @brief m_arg 获取数据筛选参数
+     */
+    QStringList m_arg;
+    /**
+     * @brief m_startCursor 起始游标,只跟踪其后的日志,为空则从当前尾部开始
+     */
+    QByteArray m_startCursor;
+    /**
+     * @brief m_canRun 是否允许标记量，用于停止该线程,构造时即置true,避免线程启动前的停止被覆盖
+     */
+    std::atomic_bool m_canRun {true};
+    /**
+     * @brief m_threadIndex 当前线程标号
+     */
+    int m_threadIndex;
+};
+
+#endif  // JOURNALFOLLOWWORK_H
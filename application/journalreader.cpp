@@ -0,0 +1,866 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "journalreader.h"
+#include "loglongmessage.h"
+#include "loglocaltime.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QLocale>
+#include <QLoggingCategory>
+#include <QPair>
+
+#include <algorithm>
+#include <string.h>
+
+#ifdef QT_DEBUG
+Q_LOGGING_CATEGORY(logJournalReader, "org.deepin.log.viewer.parse.journal.reader")
+#else
+Q_LOGGING_CATEGORY(logJournalReader, "org.deepin.log.viewer.parse.journal.reader", QtInfoMsg)
+#endif
+
+/**
+ * @brief JournalReadOptions::fromArgs 从journal获取线程的筛选参数转换读取参数
+ * @param args 第一个为等级筛选("PRIORITY=n"或"all"),第二、三个为可选的开始、结束时间(微秒),
+ * 之后按journalctl的写法可以跟"FIELD=value"形式的字段匹配,"+"分隔析取的各项
+ * @return 读取参数
+ */
+JournalReadOptions JournalReadOptions::fromArgs(const QStringList &args)
+{
+    JournalReadOptions options;
+    if (args.isEmpty())
+        return options;
+
+    if (args.at(0) != "all" && !args.at(0).isEmpty())
+        options.priorityMatch = args.at(0).toUtf8();
+
+    if (args.size() >= 3) {
+        bool beginOk = false;
+        bool endOk = false;
+        quint64 begin = args.at(1).toULongLong(&beginOk);
+        quint64 end = args.at(2).toULongLong(&endOk);
+        if (beginOk && endOk) {
+            options.hasTimeRange = true;
+            options.beginTime = begin;
+            options.endTime = end;
+        }
+    }
+
+    QByteArrayList term;
+    for (int i = 1; i < args.size(); ++i) {
+        const QString &arg = args.at(i);
+        if (!isMatchArg(arg))
+            continue;
+        if (arg == "+") {
+            if (!term.isEmpty())
+                options.matches.append(term);
+            term.clear();
+        } else {
+            term.append(arg.toUtf8());
+        }
+    }
+    if (!term.isEmpty())
+        options.matches.append(term);
+
+    //同一字段的匹配在sd_journal中为或,等级筛选直接加入会放宽搜索中的等级条件,
+    //所以和每一项中的等级条件求交集后并入该项
+    if (!options.priorityMatch.isEmpty() && !options.matches.isEmpty()) {
+        QList<QByteArrayList> merged;
+        for (const QByteArrayList &item : options.matches) {
+            QByteArrayList next;
+            bool hasPriority = false;
+            bool allowed = false;
+            for (const QByteArray &match : item) {
+                if (match.startsWith("PRIORITY=")) {
+                    hasPriority = true;
+                    allowed = allowed || match == options.priorityMatch;
+                } else {
+                    next.append(match);
+                }
+            }
+            if (hasPriority && !allowed)
+                continue;
+            next.append(options.priorityMatch);
+            merged.append(next);
+        }
+        //各项都和等级筛选冲突时用一个不存在的等级,读不到任何条目
+        if (merged.isEmpty())
+            merged.append(QByteArrayList() << QByteArray("PRIORITY=none"));
+        options.matches = merged;
+        options.priorityMatch.clear();
+    }
+    return options;
+}
+
+/**
+ * @brief JournalReadOptions::isMatchArg 参数是否为字段匹配"FIELD=value"或析取分隔符"+",
+ * 字段名只由大写字母、数字和下划线组成且不以数字开头,和应用名等位置参数区分
+ */
+bool JournalReadOptions::isMatchArg(const QString &arg)
+{
+    if (arg == "+")
+        return true;
+    const int eq = arg.indexOf('=');
+    if (eq <= 0 || arg.at(0).isDigit())
+        return false;
+    for (int i = 0; i < eq; ++i) {
+        const QChar c = arg.at(i);
+        if (!((c >= 'A' && c <= 'Z') || c.isDigit() || c == '_'))
+            return false;
+    }
+    return true;
+}
+
+/**
+ * @brief JournalReaderBase::formatTime 微秒时间戳转换为显示文本
+ * @param usec 微秒时间戳
+ * @return 格式化的时间显示文本
+ */
+QString JournalReaderBase::formatTime(quint64 usec)
+{
+    return LogLocalTime::formatSecs(static_cast<qint64>(usec / 1000000));
+}
+
+/**
+ * @brief JournalReaderBase::fail 记录错误信息
+ * @param what 出错的步骤
+ * @param r 系统接口返回的错误码
+ * @return 错误码
+ */
+int JournalReaderBase::fail(const char *what, int r)
+{
+    m_errorString = QString("%1: %2").arg(what).arg(strerror(-r));
+    qCWarning(logJournalReader) << m_errorString;
+    return r;
+}
+
+/**
+ * @brief JournalReaderBase::setError 记录错误信息
+ * @param error 错误描述
+ */
+void JournalReaderBase::setError(const QString &error)
+{
+    m_errorString = error;
+    qCWarning(logJournalReader) << m_errorString;
+}
+
+/**
+ * @brief JournalReaderBase::currentCursor 获取当前条目的游标
+ * @param j journal句柄
+ * @return 游标字符串,获取失败为空
+ */
+QString JournalReaderBase::currentCursor(sd_journal *j)
+{
+    QString result;
+    char *cursor = nullptr;
+    if (sd_journal_get_cursor(j, &cursor) >= 0 && cursor) {
+        result = QString::fromUtf8(cursor);
+        free(cursor);
+    }
+    return result;
+}
+
+/**
+ * @brief JournalReaderBase::bootCatalog 通过_BOOT_ID的唯一值枚举journal中记录的所有启动
+ * 每次启动只定位首尾两条日志获取时间范围,不遍历日志内容
+ * @return 启动列表,按最早日志时间从新到旧排序,打开journal失败时为空
+ */
+QList<JournalBootInfo> JournalReaderBase::bootCatalog()
+{
+    QList<JournalBootInfo> boots;
+    sd_journal *j = nullptr;
+    int r = openJournal(&j);
+    if (r < 0) {
+        qCWarning(logJournalReader) << "failed to open journal:" << strerror(-r);
+        return boots;
+    }
+
+    QStringList ids;
+    r = sd_journal_query_unique(j, "_BOOT_ID");
+    if (r < 0) {
+        qCWarning(logJournalReader) << "failed to query boot ids:" << strerror(-r);
+    } else {
+        const void *data = nullptr;
+        size_t length = 0;
+        SD_JOURNAL_FOREACH_UNIQUE(j, data, length) {
+            QString id = JournalFieldDecoder::decode(static_cast<const char *>(data), length);
+            if (id.size() == 32)
+                ids.append(id);
+        }
+    }
+
+    char current[33] = {0};
+    sd_id128_t currentId;
+    //读取收集来的日志时其中没有本机当前的启动
+    if (sourceDirectories().isEmpty() && sd_id128_get_boot(&currentId) >= 0)
+        sd_id128_to_string(currentId, current);
+
+    for (const QString &id : ids) {
+        QByteArray match = "_BOOT_ID=" + id.toLatin1();
+        sd_journal_flush_matches(j);
+        if (sd_journal_add_match(j, match.constData(), static_cast<size_t>(match.size())) < 0)
+            continue;
+        JournalBootInfo info;
+        info.bootId = id;
+        info.current = (id == QLatin1String(current));
+        uint64_t t = 0;
+        if (sd_journal_seek_head(j) >= 0 && sd_journal_next(j) > 0 && sd_journal_get_realtime_usec(j, &t) >= 0)
+            info.firstTime = t;
+        if (sd_journal_seek_tail(j) >= 0 && sd_journal_previous(j) > 0 && sd_journal_get_realtime_usec(j, &t) >= 0)
+            info.lastTime = t;
+        //匹配不到日志的bootid(文件已轮转删除)不展示
+        if (info.firstTime == 0 && info.lastTime == 0)
+            continue;
+        boots.append(info);
+    }
+    sd_journal_close(j);
+
+    std::sort(boots.begin(), boots.end(), [](const JournalBootInfo &a, const JournalBootInfo &b) {
+        return a.firstTime > b.firstTime;
+    });
+    return boots;
+}
+
+/**
+ * @brief JournalReaderBase::uniqueValues 通过sd_journal_query_unique枚举字段在journal中出现过的所有值,只读取字段数据对象,不遍历日志
+ * @param field 字段名,如"_SYSTEMD_UNIT"
+ * @param limit 最多返回的值数,超过时截断
+ * @param truncated 输出参数,是否因超过limit而截断
+ * @return 去掉空值后按字母排序的值,打开journal失败时为空
+ */
+QStringList JournalReaderBase::uniqueValues(const char *field, int limit, bool *truncated)
+{
+    QStringList values;
+    if (truncated)
+        *truncated = false;
+    sd_journal *j = nullptr;
+    int r = openJournal(&j);
+    if (r < 0) {
+        qCWarning(logJournalReader) << "failed to open journal:" << strerror(-r);
+        return values;
+    }
+    r = sd_journal_query_unique(j, field);
+    if (r < 0) {
+        qCWarning(logJournalReader) << "failed to query unique values of" << field << ":" << strerror(-r);
+    } else {
+        const void *data = nullptr;
+        size_t length = 0;
+        SD_JOURNAL_FOREACH_UNIQUE(j, data, length) {
+            if (values.size() >= limit) {
+                if (truncated)
+                    *truncated = true;
+                break;
+            }
+            const QString value = JournalFieldDecoder::decode(static_cast<const char *>(data), length);
+            if (!value.isEmpty())
+                values.append(value);
+        }
+    }
+    sd_journal_close(j);
+
+    //不同journal文件中的同一个值各返回一次
+    values.removeDuplicates();
+    std::sort(values.begin(), values.end(), [](const QString &a, const QString &b) {
+        return a.compare(b, Qt::CaseInsensitive) < 0;
+    });
+    return values;
+}
+
+/**
+ * @brief JournalReaderBase::journalFiles 枚举本机的journal文件,范围和SD_JOURNAL_LOCAL_ONLY一致
+ * @return journal文件路径列表
+ */
+QStringList JournalReaderBase::journalFiles()
+{
+    QStringList files;
+    sd_id128_t machineId;
+    if (sd_id128_get_machine(&machineId) < 0)
+        return files;
+    char machine[33] = {0};
+    sd_id128_to_string(machineId, machine);
+
+    //持久化日志和易失日志目录
+    const QStringList roots {"/var/log/journal", "/run/log/journal"};
+    for (const QString &root : roots) {
+        QDir dir(root + "/" + QString::fromLatin1(machine));
+        if (!dir.exists())
+            continue;
+        //*.journal~为systemd检测到损坏后改名的文件,sd_journal_open同样会读取
+        const QFileInfoList infos = dir.entryInfoList(QStringList() << "*.journal" << "*.journal~", QDir::Files | QDir::Readable);
+        for (const QFileInfo &info : infos)
+            files.append(info.absoluteFilePath());
+    }
+    return files;
+}
+
+/**
+ * @brief JournalReaderBase::openFiles 打开指定的一组journal文件
+ * @return sd_journal_open_files的返回值
+ */
+int JournalReaderBase::openFiles(sd_journal **j, const QStringList &files)
+{
+    std::vector<QByteArray> encoded;
+    std::vector<const char *> paths;
+    for (const QString &file : files)
+        encoded.push_back(file.toLocal8Bit());
+    for (const QByteArray &path : encoded)
+        paths.push_back(path.constData());
+    paths.push_back(nullptr);
+    return sd_journal_open_files(j, paths.data(), 0);
+}
+
+/**
+ * @brief JournalReaderBase::partitionFiles 按文件大小把journal文件均衡分成若干组,每组由一个线程读取
+ * @param files journal文件路径列表
+ * @param groups 组数
+ * @return 分组结果,不含空组
+ */
+QList<QStringList> JournalReaderBase::partitionFiles(const QStringList &files, int groups)
+{
+    QList<QStringList> result;
+    if (groups <= 0 || files.isEmpty())
+        return result;
+    groups = qMin(groups, files.size());
+
+    QList<QPair<qint64, QString>> sized;
+    for (const QString &file : files)
+        sized.append(qMakePair(QFileInfo(file).size(), file));
+    //从大到小依次放进当前总大小最小的组
+    std::stable_sort(sized.begin(), sized.end(), [](const QPair<qint64, QString> &a, const QPair<qint64, QString> &b) {
+        return a.first > b.first;
+    });
+
+    QVector<qint64> loads(groups, 0);
+    for (int i = 0; i < groups; ++i)
+        result.append(QStringList());
+    for (const QPair<qint64, QString> &item : sized) {
+        int target = static_cast<int>(std::min_element(loads.begin(), loads.end()) - loads.begin());
+        result[target].append(item.second);
+        //每个文件至少计1,大小相同时按个数均衡
+        loads[target] += item.first + 1;
+    }
+    return result;
+}
+
+namespace {
+
+QStringList &sourceDirectoryStorage()
+{
+    static QStringList dirs;
+    return dirs;
+}
+
+/**
+ * @brief isMachineId 是否为32位十六进制的机器ID
+ */
+bool isMachineId(const QString &name)
+{
+    if (name.size() != 32)
+        return false;
+    for (const QChar &c : name) {
+        if (!((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f')))
+            return false;
+    }
+    return true;
+}
+
+/**
+ * @brief appendDirectoryFiles 把一个目录中的journal文件按机器归组
+ * 机器ID目录(/var/log/journal/<machine-id>)中的文件归到该机器ID;
+ * systemd-journal-remote保存的remote-<host>.journal、remote-<host>@....journal按host归组;
+ * 其他目录中的文件归到目录路径
+ */
+void appendDirectoryFiles(const QDir &dir, QMap<QString, QStringList> &machines)
+{
+    const QFileInfoList infos = dir.entryInfoList(QStringList() << "*.journal" << "*.journal~", QDir::Files | QDir::Readable, QDir::Name);
+    const QString dirName = dir.dirName();
+    for (const QFileInfo &info : infos) {
+        QString machine = isMachineId(dirName) ? dirName : dir.absolutePath();
+        const QString name = info.fileName();
+        if (name.startsWith("remote-")) {
+            int end = name.indexOf('@');
+            if (end < 0)
+                end = name.indexOf(".journal");
+            machine = name.mid(7, end - 7);
+        }
+        machines[machine].append(info.absoluteFilePath());
+    }
+}
+
+} // namespace
+
+/**
+ * @brief JournalReaderBase::openJournal 打开要读取的journal
+ * @param files 不为空时只打开这些文件
+ * @return 指定了文件时打开这些文件;设置了来源目录时打开其中的全部文件,没有文件返回-ENOENT;否则打开本机日志
+ */
+int JournalReaderBase::openJournal(sd_journal **j, const QStringList &files)
+{
+    if (!files.isEmpty())
+        return openFiles(j, files);
+    const QStringList dirs = sourceDirectories();
+    if (dirs.isEmpty())
+        return sd_journal_open(j, SD_JOURNAL_LOCAL_ONLY);
+
+    QStringList sourceFiles;
+    const QMap<QString, QStringList> machines = directoryFiles(dirs);
+    for (auto it = machines.cbegin(); it != machines.cend(); ++it)
+        sourceFiles.append(it.value());
+    if (sourceFiles.isEmpty())
+        return -ENOENT;
+    return openFiles(j, sourceFiles);
+}
+
+/**
+ * @brief JournalReaderBase::setSourceDirectories 设置读取的journal目录,代替本机日志,需在获取线程开始之前调用
+ * @param dirs 从其他机器收集来的journal目录(如/srv/logs/node1/journal)或系统根目录(读取其中的var/log/journal),为空时读取本机日志
+ */
+void JournalReaderBase::setSourceDirectories(const QStringList &dirs)
+{
+    sourceDirectoryStorage() = dirs;
+    if (!dirs.isEmpty())
+        qCInfo(logJournalReader) << "journal source directories:" << dirs;
+}
+
+QStringList JournalReaderBase::sourceDirectories()
+{
+    return sourceDirectoryStorage();
+}
+
+/**
+ * @brief JournalReaderBase::directoryFiles 枚举目录中的journal文件,按机器归组
+ * @param dirs journal目录,可以是机器ID目录本身、其上一级目录(/var/log/journal),或系统根目录
+ * @return 机器(机器ID、远程主机名或目录路径)对应的文件列表,同一机器在多个目录中的文件合并在一起
+ */
+QMap<QString, QStringList> JournalReaderBase::directoryFiles(const QStringList &dirs)
+{
+    QMap<QString, QStringList> machines;
+    for (const QString &path : dirs) {
+        QDir dir(path);
+        //系统根目录,和sd_journal_open_directory的OS_ROOT方式一致读取其中的持久化和易失日志
+        if (dir.exists("var/log/journal") || dir.exists("run/log/journal")) {
+            QStringList roots;
+            for (const QString &sub : {QStringLiteral("var/log/journal"), QStringLiteral("run/log/journal")}) {
+                if (dir.exists(sub))
+                    roots.append(dir.absoluteFilePath(sub));
+            }
+            for (const QString &root : roots) {
+                appendDirectoryFiles(QDir(root), machines);
+                for (const QFileInfo &info : QDir(root).entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot | QDir::Readable, QDir::Name))
+                    appendDirectoryFiles(QDir(info.absoluteFilePath()), machines);
+            }
+            continue;
+        }
+        appendDirectoryFiles(dir, machines);
+        for (const QFileInfo &info : dir.entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot | QDir::Readable, QDir::Name))
+            appendDirectoryFiles(QDir(info.absoluteFilePath()), machines);
+    }
+    for (auto it = machines.begin(); it != machines.end(); ++it)
+        it.value().removeDuplicates();
+    return machines;
+}
+
+/**
+ * @brief JournalReaderBase::partitionMachines 把多台机器的journal文件均衡分成若干组,同一台机器的文件在同一组
+ * 每台机器的文件按游标顺序自成一体,不拆开读取,机器多于组数时按文件总大小放进当前最小的组
+ * @return 分组结果,不含空组
+ */
+QList<QStringList> JournalReaderBase::partitionMachines(const QMap<QString, QStringList> &machines, int groups)
+{
+    QList<QStringList> result;
+    if (groups <= 0 || machines.isEmpty())
+        return result;
+    groups = qMin(groups, machines.size());
+
+    QList<QPair<qint64, QStringList>> sized;
+    for (auto it = machines.cbegin(); it != machines.cend(); ++it) {
+        qint64 size = 0;
+        for (const QString &file : it.value())
+            size += QFileInfo(file).size() + 1;
+        sized.append(qMakePair(size, it.value()));
+    }
+    std::stable_sort(sized.begin(), sized.end(), [](const QPair<qint64, QStringList> &a, const QPair<qint64, QStringList> &b) {
+        return a.first > b.first;
+    });
+
+    QVector<qint64> loads(groups, 0);
+    for (int i = 0; i < groups; ++i)
+        result.append(QStringList());
+    for (const QPair<qint64, QStringList> &item : sized) {
+        int target = static_cast<int>(std::min_element(loads.begin(), loads.end()) - loads.begin());
+        result[target].append(item.second);
+        loads[target] += item.first;
+    }
+    return result;
+}
+
+/**
+ * @brief JournalTimeFormatter::JournalTimeFormatter
+ * @param dateFormat 日期前缀的格式,为空时只输出时间
+ * @param withSeconds 时间部分是否包含秒
+ */
+JournalTimeFormatter::JournalTimeFormatter(const QString &dateFormat, bool withSeconds)
+    : m_dateFormat(dateFormat)
+    , m_withSeconds(withSeconds)
+{
+}
+
+/**
+ * @brief JournalTimeFormatter::forThread 本线程的"yyyy-MM-dd hh:mm:ss"格式化实例,各读取线程各用一份
+ */
+JournalTimeFormatter &JournalTimeFormatter::forThread()
+{
+    static thread_local JournalTimeFormatter formatter;
+    return formatter;
+}
+
+/**
+ * @brief JournalTimeFormatter::format 微秒时间戳转换为"yyyy-MM-dd hh:mm:ss",结果和JournalReaderBase::formatTime一致
+ * @param usec 微秒时间戳
+ * @return 格式化的时间显示文本
+ */
+QString JournalTimeFormatter::format(quint64 usec)
+{
+    return formatSecs(static_cast<qint64>(usec / 1000000));
+}
+
+/**
+ * @brief JournalTimeFormatter::formatSecs 同format,时间戳单位为秒
+ */
+QString JournalTimeFormatter::formatSecs(qint64 secs)
+{
+    if (secs == m_lastSecs)
+        return m_lastText;
+    if (secs < m_rangeStart || secs >= m_rangeEnd)
+        rebuild(secs);
+
+    const qint64 inDay = secs - m_dayStart;
+    const int hour = static_cast<int>(inDay / 3600);
+    const int minute = static_cast<int>(inDay / 60 % 60);
+    const int second = static_cast<int>(inDay % 60);
+    const char text[8] = {
+        static_cast<char>('0' + hour / 10), static_cast<char>('0' + hour % 10), ':',
+        static_cast<char>('0' + minute / 10), static_cast<char>('0' + minute % 10), ':',
+        static_cast<char>('0' + second / 10), static_cast<char>('0' + second % 10)
+    };
+
+    m_lastSecs = secs;
+    m_lastText = m_datePrefix + QLatin1String(text, m_withSeconds ? 8 : 5);
+    return m_lastText;
+}
+
+/**
+ * @brief JournalTimeFormatter::rebuild 重新计算secs所在的当地日期和缓存区间
+ * @param secs UTC秒数
+ */
+void JournalTimeFormatter::rebuild(qint64 secs)
+{
+    qint64 offsetBegin = 0;
+    qint64 offsetEnd = 0;
+    const qint64 offset = LogLocalTime::offsetMSecs(secs * 1000, &offsetBegin, &offsetEnd) / 1000;
+    const qint64 localSecs = secs + offset;
+    //按当地时间取整到零点,负数时间戳向下取整
+    qint64 localDay = localSecs / 86400;
+    if (localSecs < 0 && localSecs % 86400 != 0)
+        --localDay;
+
+    m_dayStart = localDay * 86400 - offset;
+    //区间内时区偏移必须不变,否则时分秒不能直接由秒数算出;切换点都在整秒
+    m_rangeStart = qMax(m_dayStart, offsetBegin / 1000);
+    m_rangeEnd = qMin(m_dayStart + 86400, offsetEnd / 1000);
+    //月份和星期用英文名称,不随系统语言变化
+    m_datePrefix = QLocale::c().toString(LogLocalTime::dateOf(secs * 1000), m_dateFormat);
+}
+
+/**
+ * @brief JournalExeNameCache::daemonName 获取可执行文件路径对应的进程名
+ * @param exePath _EXE字段的值
+ * @return 文件名,文件不存在时为"unknown"
+ */
+QString JournalExeNameCache::daemonName(const QString &exePath)
+{
+    {
+        QReadLocker locker(&m_lock);
+        auto it = m_names.constFind(exePath);
+        if (it != m_names.constEnd())
+            return it.value();
+    }
+
+    //在锁外stat,多个线程同时未命中时最多重复判断一次
+    QFileInfo fi(exePath);
+    QString name;
+    if (fi.exists()) {
+        name = fi.fileName();
+    } else {
+        qCWarning(logJournalReader) << "unknown progressname, exe path: " << exePath;
+        name = "unknown";
+    }
+
+    QWriteLocker locker(&m_lock);
+    m_names.insert(exePath, name);
+    return name;
+}
+
+int SystemJournalPolicy::addMatches(sd_journal *j) const
+{
+    Q_UNUSED(j)
+    return 0;
+}
+
+QList<QByteArray> SystemJournalPolicy::fieldNames()
+{
+    return QList<QByteArray>() << "_HOSTNAME" << "_PID" << "SYSLOG_IDENTIFIER" << "_EXE" << "MESSAGE";
+}
+
+/**
+ * @brief SystemJournalPolicy::dataThreshold 延迟加载时只取出MESSAGE前缀(多取一个字节用于判断是否截断)
+ */
+size_t SystemJournalPolicy::dataThreshold() const
+{
+    if (!lazyMessage)
+        return 0;
+    return qMax(sizeof("MESSAGE=") + static_cast<size_t>(lazyPrefix), static_cast<size_t>(JOURNAL_DATA_THRESHOLD_MIN));
+}
+
+void SystemJournalPolicy::project(sd_journal *j, const JournalEntryFields &fields, Record &record, LogStringPool &strings) const
+{
+    //获取主机名
+    fields.field(Hostname, record.hostName, strings);
+    //获取进程号
+    fields.field(Pid, record.daemonId, strings);
+    //获取进程名
+    if (!fields.field(SyslogIdentifier, record.daemonName, strings)) {
+        QString exePath;
+        if (fields.field(Exe, exePath)) {
+            record.daemonName = exeNames->daemonName(exePath);
+        } else {
+            qCWarning(logJournalReader) << record.daemonId << "has no process name";
+            record.daemonName = "unknown";
+        }
+    }
+    //获取信息体,延迟加载时过长的内容只保留前缀,完整内容通过游标按需读取
+    if (lazyMessage) {
+        bool truncated = false;
+        fields.fieldPrefix(Message, static_cast<size_t>(lazyPrefix), record.msg, truncated);
+        if (truncated)
+            record.cursor = JournalReaderBase::currentCursor(j).toUtf8();
+    } else {
+        fields.field(Message, record.msg);
+    }
+}
+
+int BootJournalPolicy::addMatches(sd_journal *j) const
+{
+    char match[9 + 32 + 1] = "_BOOT_ID=";
+    int r = 0;
+    if (bootId.size() == 32) {
+        memcpy(match + 9, bootId.constData(), 32);
+    } else {
+        sd_id128_t current_id;
+        //获取当前最新的正在运行的bootid
+        r = sd_id128_get_boot(&current_id);
+        if (r < 0)
+            return r;
+        //拼接和把id转成字符串
+        sd_id128_to_string(current_id, match + 9);
+    }
+    qCDebug(logJournalReader) << "journal match condition:" << match;
+    r = sd_journal_add_match(j, match, sizeof(match) - 1);
+    if (r < 0)
+        return r;
+    //合并筛选条件 (等级和bootid)
+    return sd_journal_add_conjunction(j);
+}
+
+QList<QByteArray> BootJournalPolicy::fieldNames()
+{
+    return QList<QByteArray>() << "_HOSTNAME" << "_PID" << "_COMM" << "MESSAGE";
+}
+
+void BootJournalPolicy::project(sd_journal *j, const JournalEntryFields &fields, Record &record, LogStringPool &strings) const
+{
+    Q_UNUSED(j)
+    fields.field(Hostname, record.hostName, strings);
+    fields.field(Pid, record.daemonId, strings);
+    if (!fields.field(Comm, record.daemonName, strings)) {
+        qCWarning(logJournalReader) << record.daemonId << "has no _COMM";
+        record.daemonName = "unknown";
+    }
+    fields.field(Message, record.msg);
+}
+
+int KernJournalPolicy::addMatches(sd_journal *j) const
+{
+    int r = sd_journal_add_match(j, "_TRANSPORT=kernel", 0);
+    if (r < 0)
+        return r;
+    //合并筛选条件 (等级和内核来源)
+    return sd_journal_add_conjunction(j);
+}
+
+QList<QByteArray> KernJournalPolicy::fieldNames()
+{
+    return QList<QByteArray>() << "_HOSTNAME" << "SYSLOG_IDENTIFIER" << "MESSAGE";
+}
+
+void KernJournalPolicy::project(sd_journal *j, const JournalEntryFields &fields, Record &record, LogStringPool &strings) const
+{
+    Q_UNUSED(j)
+    fields.field(Hostname, record.hostName, strings);
+    //和kern.log中一致,进程名为kernel,没有进程号
+    if (!fields.field(SyslogIdentifier, record.daemonName, strings))
+        record.daemonName = QStringLiteral("kernel");
+    fields.field(Message, record.msg);
+}
+
+int AppJournalPolicy::addMatches(sd_journal *j) const
+{
+    for (const QByteArray &identifier : identifiers) {
+        const QByteArray match = "SYSLOG_IDENTIFIER=" + identifier;
+        int r = sd_journal_add_match(j, match.constData(), static_cast<size_t>(match.size()));
+        if (r < 0)
+            return r;
+    }
+    return 0;
+}
+
+QList<QByteArray> AppJournalPolicy::fieldNames()
+{
+    return QList<QByteArray>() << "SYSLOG_IDENTIFIER" << "MESSAGE";
+}
+
+/**
+ * @brief AppJournalPolicy::dataThreshold 列表只显示MESSAGE前缀,不必取出完整内容
+ */
+size_t AppJournalPolicy::dataThreshold() const
+{
+    return qMax(sizeof("MESSAGE=") + static_cast<size_t>(LOG_LONG_MESSAGE_PREFIX), static_cast<size_t>(JOURNAL_DATA_THRESHOLD_MIN));
+}
+
+void AppJournalPolicy::project(sd_journal *j, const JournalEntryFields &fields, Record &record, LogStringPool &strings) const
+{
+    //只读一个应用时不需要区分来源
+    if (identifiers.size() > 1)
+        fields.field(SyslogIdentifier, record.src, strings);
+    //如果日志太长就显示一部分,完整内容通过游标按需读取
+    bool truncated = false;
+    fields.fieldPrefix(Message, LOG_LONG_MESSAGE_PREFIX, record.msg, truncated);
+    if (truncated)
+        record.fullRef.cursor = JournalReaderBase::currentCursor(j).toUtf8();
+}
+
+int CoredumpJournalPolicy::addMatches(sd_journal *j) const
+{
+    //systemd-coredump写入的崩溃记录
+    static const char match[] = "MESSAGE_ID=fc2e22bc6ee647b6b90729ab34a250b1";
+    return sd_journal_add_match(j, match, sizeof(match) - 1);
+}
+
+QList<QByteArray> CoredumpJournalPolicy::fieldNames()
+{
+    return QList<QByteArray>() << "COREDUMP_PID" << "COREDUMP_UID" << "COREDUMP_SIGNAL"
+                               << "COREDUMP_EXE" << "COREDUMP_FILENAME" << "COREDUMP";
+}
+
+void CoredumpJournalPolicy::project(sd_journal *j, const JournalEntryFields &fields, Record &record, LogStringPool &strings) const
+{
+    fields.field(Pid, record.pid);
+    fields.field(Uid, record.uid, strings);
+    fields.field(Signal, record.sig, strings);
+    fields.field(Exe, record.exe, strings);
+
+    //和coredumpctl list的COREFILE列一致:外部存储看文件是否还在,内嵌在journal中的为journal
+    if (fields.field(Filename, record.storagePath)) {
+        record.coreFile = QFileInfo::exists(record.storagePath) ? "present" : "missing";
+    } else if (fields.contains(Coredump)) {
+        record.coreFile = "journal";
+        record.storagePath = "journal";
+    } else {
+        record.coreFile = "none";
+    }
+    if (record.coreFile == "missing" || record.coreFile == "none")
+        record.storagePath = QString("coredump file is missing");
+
+    record.cursor = JournalReaderBase::currentCursor(j).toUtf8();
+}
+
+JournalMessageResolver::JournalMessageResolver()
+{
+}
+
+JournalMessageResolver::~JournalMessageResolver()
+{
+    if (m_journal)
+        sd_journal_close(m_journal);
+}
+
+/**
+ * @brief JournalMessageResolver::message 读取游标对应条目的完整MESSAGE
+ * @param cursor 条目游标
+ * @return 完整信息,条目已不存在或读取失败时为空
+ */
+QString JournalMessageResolver::message(const QByteArray &cursor)
+{
+    return field(cursor, "MESSAGE");
+}
+
+/**
+ * @brief JournalMessageResolver::field 读取游标对应条目的指定字段
+ * @param cursor 条目游标
+ * @param name 字段名
+ * @return 字段值,条目已不存在、没有该字段或读取失败时为空
+ */
+QString JournalMessageResolver::field(const QByteArray &cursor, const char *name)
+{
+    if (cursor.isEmpty() || m_openFailed)
+        return QString();
+    if (!m_journal) {
+        int r = JournalReaderBase::openJournal(&m_journal);
+        if (r < 0) {
+            qCWarning(logJournalReader) << "Failed to open journal:" << strerror(-r);
+            m_journal = nullptr;
+            m_openFailed = true;
+            return QString();
+        }
+    }
+
+    //seek之后需要next才会定位到条目上,还要确认定位到的就是该条目(可能已被轮转删除)
+    if (sd_journal_seek_cursor(m_journal, cursor.constData()) < 0 || sd_journal_next(m_journal) <= 0
+            || sd_journal_test_cursor(m_journal, cursor.constData()) <= 0)
+        return QString();
+
+    QString result;
+    JournalFieldDecoder::field(m_journal, name, result);
+    return result;
+}
+
+/**
+ * @brief JournalMessageResolver::resolve 把延迟加载的记录补全为完整信息
+ * @param record 系统日志记录,读取失败时保留原有前缀
+ */
+void JournalMessageResolver::resolve(LOG_MSG_JOURNAL &record)
+{
+    if (record.cursor.isEmpty())
+        return;
+    QString full = message(record.cursor);
+    if (!full.isEmpty())
+        record.msg = full;
+    record.cursor.clear();
+}
+
+/**
+ * @brief JournalMessageResolver::messageContains 信息是否包含关键字,前缀中没有时再检查完整信息
+ * @param record 系统日志记录
+ * @param str 关键字
+ * @return 是否包含(不区分大小写)
+ */
+bool JournalMessageResolver::messageContains(const LOG_MSG_JOURNAL &record, const QString &str)
+{
+    if (record.msg.contains(str, Qt::CaseInsensitive))
+        return true;
+    if (record.cursor.isEmpty())
+        return false;
+    return message(record.cursor).contains(str, Qt::CaseInsensitive);
+}
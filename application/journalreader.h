@@ -0,0 +1,804 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef JOURNALREADER_H
+#define JOURNALREADER_H
+
+#include "structdef.h"
+#include "journalfielddecoder.h"
+#include "logingestmetrics.h"
+#include "logbatchsizer.h"
+#include "logperformanceprofile.h"
+#include "logparsecontext.h"
+
+#include <QByteArray>
+#include <QByteArrayList>
+#include <QHash>
+#include <QList>
+#include <QMap>
+#include <QMutex>
+#include <QQueue>
+#include <QReadWriteLock>
+#include <QSharedPointer>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QWaitCondition>
+
+#include <atomic>
+#include <errno.h>
+#include <limits>
+#include <stdlib.h>
+#include <string.h>
+#include <systemd/sd-journal.h>
+#include <thread>
+#include <typeinfo>
+#include <vector>
+
+//跟踪新日志时每读取多少条数据发送一次,随性能档位变化
+#define JOURNAL_BATCH_SIZE (LogPerformanceProfile::current().readBatchSize)
+//并行读取时每个线程每次交给合并端的条数
+#define JOURNAL_PARALLEL_CHUNK 256
+//并行读取时每个线程最多缓存的块数,读取快于合并时阻塞,避免占用过多内存
+#define JOURNAL_PARALLEL_QUEUE 8
+//并行读取的最大线程数
+#define JOURNAL_PARALLEL_MAX_THREADS 8
+//实时跟踪时单次等待新日志的最长时间(微秒),超时后检查是否被停止
+#define JOURNAL_FOLLOW_WAIT_USEC 500000
+//延迟加载模式下MESSAGE超过该字节数时只保留这么长的前缀和条目游标
+#define JOURNAL_LAZY_MESSAGE_PREFIX 256
+//内存紧张时延迟加载保留的MESSAGE前缀字节数
+#define JOURNAL_LAZY_MESSAGE_PRESSURE_PREFIX 128
+//设置了字段数据阈值时的最小值,保证路径、进程名等字段不被截断
+#define JOURNAL_DATA_THRESHOLD_MIN 4096
+
+/**
+ * @brief The JournalReadOptions struct journal读取参数
+ */
+struct JournalReadOptions {
+    //等级筛选条件,如"PRIORITY=3",为空表示不筛选
+    QByteArray priorityMatch;
+    //是否有时间范围,时间单位为微秒
+    bool hasTimeRange = false;
+    quint64 beginTime = 0;
+    quint64 endTime = 0;
+    //增量读取截止游标,倒序迭代到该条目时停止
+    QByteArray stopCursor;
+    //并行读取的线程数,大于1且有多个journal文件时按文件分组并行读取,再按时间归并,增量读取时不生效
+    int threads = 1;
+    //不为空时只读取这些journal文件(如由合成语料转换出的文件),不读取本机日志
+    QStringList files;
+    //搜索条件下推的字段匹配,析取范式:各项之间为或,项内不同字段为与、同一字段为或,等级筛选已并入每一项
+    QList<QByteArrayList> matches;
+
+    static JournalReadOptions fromArgs(const QStringList &args);
+    static bool isMatchArg(const QString &arg);
+};
+
+/**
+ * @brief The JournalTimeFormatter class 时间戳格式化,按天缓存"yyyy-MM-dd "前缀,当天内只计算时分秒
+ * 缓存区间同时以时区偏移变化(夏令时切换)为界,不能跨线程共用;
+ * 日期前缀的格式可以指定(按英文名称),如和last一致的"ddd MMM d ",也可以只输出时分
+ */
+class JournalTimeFormatter
+{
+public:
+    explicit JournalTimeFormatter(const QString &dateFormat = QStringLiteral("yyyy-MM-dd "), bool withSeconds = true);
+
+    QString format(quint64 usec);
+    QString formatSecs(qint64 secs);
+
+    static JournalTimeFormatter &forThread();
+
+private:
+    void rebuild(qint64 secs);
+
+    //当前缓存区间[m_rangeStart, m_rangeEnd),单位为秒(UTC)
+    qint64 m_rangeStart {0};
+    qint64 m_rangeEnd {0};
+    //区间内当地零点对应的UTC秒数
+    qint64 m_dayStart {0};
+    QString m_dateFormat;
+    bool m_withSeconds {true};
+    QString m_datePrefix;
+    //同一秒的连续日志直接复用
+    qint64 m_lastSecs {-1};
+    QString m_lastText;
+};
+
+/**
+ * @brief The JournalExeNameCache class _EXE路径到进程名的缓存,每个可执行文件每次加载只stat一次,可被并行读取线程共用
+ */
+class JournalExeNameCache
+{
+public:
+    QString daemonName(const QString &exePath);
+
+private:
+    QReadWriteLock m_lock;
+    //路径对应的进程名,文件不存在时为"unknown"
+    QHash<QString, QString> m_names;
+};
+
+/**
+ * @brief The SystemJournalPolicy struct 系统日志字段投影策略
+ */
+struct SystemJournalPolicy {
+    typedef LOG_MSG_JOURNAL Record;
+    //延迟加载过长的MESSAGE,见JournalMessageResolver
+    bool lazyMessage = false;
+    //延迟加载时保留的MESSAGE前缀字节数
+    int lazyPrefix = JOURNAL_LAZY_MESSAGE_PREFIX;
+    //Policy的拷贝共用同一个缓存
+    QSharedPointer<JournalExeNameCache> exeNames {new JournalExeNameCache};
+    enum Field {
+        Hostname = JournalEntryFields::PolicyField,
+        Pid,
+        SyslogIdentifier,
+        Exe,
+        Message
+    };
+    static QList<QByteArray> fieldNames();
+    size_t dataThreshold() const;
+    int addMatches(sd_journal *j) const;
+    void project(sd_journal *j, const JournalEntryFields &fields, Record &record, LogStringPool &strings) const;
+};
+
+/**
+ * @brief The BootJournalPolicy struct 启动日志(klu启动日志)字段投影策略,只读取一次启动的日志
+ */
+struct BootJournalPolicy {
+    typedef LOG_MSG_JOURNAL Record;
+    //要读取的bootid(32位十六进制),为空时读取当前启动
+    QByteArray bootId;
+    enum Field {
+        Hostname = JournalEntryFields::PolicyField,
+        Pid,
+        Comm,
+        Message
+    };
+    static QList<QByteArray> fieldNames();
+    size_t dataThreshold() const { return 0; }
+    int addMatches(sd_journal *j) const;
+    void project(sd_journal *j, const JournalEntryFields &fields, Record &record, LogStringPool &strings) const;
+};
+
+/**
+ * @brief The KernJournalPolicy struct 内核日志字段投影策略,读取_TRANSPORT=kernel的条目,列和kern.log解析结果一致
+ */
+struct KernJournalPolicy {
+    typedef LOG_MSG_JOURNAL Record;
+    enum Field {
+        Hostname = JournalEntryFields::PolicyField,
+        SyslogIdentifier,
+        Message
+    };
+    static QList<QByteArray> fieldNames();
+    size_t dataThreshold() const { return 0; }
+    int addMatches(sd_journal *j) const;
+    void project(sd_journal *j, const JournalEntryFields &fields, Record &record, LogStringPool &strings) const;
+};
+
+/**
+ * @brief The AppJournalPolicy struct 应用日志字段投影策略,按SYSLOG_IDENTIFIER筛选
+ * 有多个应用时各SYSLOG_IDENTIFIER匹配之间为或(同一字段的匹配由sd-journal自动析取),一次读取所有应用,
+ * 记录的src为所属应用的SYSLOG_IDENTIFIER,由调用方按它分发
+ */
+struct AppJournalPolicy {
+    typedef LOG_MSG_APPLICATOIN Record;
+    //要读取的应用的SYSLOG_IDENTIFIER,为空时不按应用筛选
+    QList<QByteArray> identifiers;
+    enum Field {
+        SyslogIdentifier = JournalEntryFields::PolicyField,
+        Message
+    };
+    static QList<QByteArray> fieldNames();
+    size_t dataThreshold() const;
+    int addMatches(sd_journal *j) const;
+    void project(sd_journal *j, const JournalEntryFields &fields, Record &record, LogStringPool &strings) const;
+};
+
+/**
+ * @brief The CoredumpJournalPolicy struct 崩溃日志字段投影策略,按systemd-coredump的MESSAGE_ID筛选
+ * 列表和元数据直接取自COREDUMP_*字段,sig/uid为原始数字,由调用方转换为名称;
+ * 堆栈信息在MESSAGE中,只保存条目游标,需要时通过JournalMessageResolver读取
+ */
+struct CoredumpJournalPolicy {
+    typedef LOG_MSG_COREDUMP Record;
+    enum Field {
+        Pid = JournalEntryFields::PolicyField,
+        Uid,
+        Signal,
+        Exe,
+        Filename,
+        Coredump
+    };
+    static QList<QByteArray> fieldNames();
+    //内嵌在journal中的COREDUMP动辄几十MB,只需知道它是否存在
+    size_t dataThreshold() const { return JOURNAL_DATA_THRESHOLD_MIN; }
+    int addMatches(sd_journal *j) const;
+    void project(sd_journal *j, const JournalEntryFields &fields, Record &record, LogStringPool &strings) const;
+};
+
+/**
+ * @brief The JournalBootInfo struct 一次启动的bootid和日志时间范围
+ */
+struct JournalBootInfo {
+    QString bootId;
+    quint64 firstTime = 0; //该次启动最早一条日志的时间(微秒)
+    quint64 lastTime = 0;  //该次启动最新一条日志的时间(微秒)
+    bool current = false;  //是否为当前正在运行的启动
+};
+
+/**
+ * @brief The JournalReaderBase class journal读取引擎的非模板部分
+ */
+class JournalReaderBase
+{
+public:
+    static QString formatTime(quint64 usec);
+    static QStringList journalFiles();
+    static int openFiles(sd_journal **j, const QStringList &files);
+    static int openJournal(sd_journal **j, const QStringList &files = QStringList());
+    static QList<QStringList> partitionFiles(const QStringList &files, int groups);
+    static void setSourceDirectories(const QStringList &dirs);
+    static QStringList sourceDirectories();
+    static QMap<QString, QStringList> directoryFiles(const QStringList &dirs);
+    static QList<QStringList> partitionMachines(const QMap<QString, QStringList> &machines, int groups);
+    static QString currentCursor(sd_journal *j);
+    static QList<JournalBootInfo> bootCatalog();
+    static QStringList uniqueValues(const char *field, int limit, bool *truncated = nullptr);
+    QString errorString() const { return m_errorString; }
+    QString newestCursor() const { return m_newestCursor; }
+
+protected:
+    /**
+     * @brief The EntryState enum 单条日志的读取结果
+     */
+    enum EntryState {
+        EntryAccepted,  //读取成功
+        EntrySkipped,   //晚于时间范围,跳过
+        EntryPastRange  //早于时间范围,之后的条目都更早,停止读取
+    };
+
+    int fail(const char *what, int r);
+    void setError(const QString &error);
+
+    QString m_errorString;
+    QString m_newestCursor;
+};
+
+/**
+ * @brief The JournalMessageResolver class 按游标读取延迟加载的完整MESSAGE等字段,同一对象内复用journal句柄
+ * 只在第一次需要时打开journal,不能跨线程使用
+ */
+class JournalMessageResolver
+{
+public:
+    JournalMessageResolver();
+    ~JournalMessageResolver();
+
+    QString message(const QByteArray &cursor);
+    QString field(const QByteArray &cursor, const char *name);
+    void resolve(LOG_MSG_JOURNAL &record);
+    bool messageContains(const LOG_MSG_JOURNAL &record, const QString &str);
+
+private:
+    Q_DISABLE_COPY(JournalMessageResolver)
+
+    sd_journal *m_journal {nullptr};
+    //打开失败后不再重试
+    bool m_openFailed {false};
+};
+
+/**
+ * @brief The JournalStream class 并行读取时单个读取线程到归并端的有界队列
+ * 读取线程按倒序压入分块数据,归并端逐块取出,队列满时读取线程阻塞等待
+ */
+template <typename Record>
+class JournalStream
+{
+public:
+    struct Chunk {
+        QList<Record> records;
+        //每条记录的journal接收时间(微秒),用于归并排序
+        QVector<quint64> times;
+    };
+
+    JournalStream(const std::atomic_bool &canRun, const std::atomic_bool &abort)
+        : m_canRun(canRun)
+        , m_abort(abort)
+    {
+    }
+
+    bool stopped() const { return !m_canRun || m_abort; }
+
+    /**
+     * @brief push 读取线程压入一块数据
+     * @return 被停止时返回false
+     */
+    bool push(Chunk &chunk)
+    {
+        QMutexLocker locker(&m_mutex);
+        //定时醒来检查是否被停止
+        while (m_queue.size() >= JOURNAL_PARALLEL_QUEUE && !stopped())
+            m_notFull.wait(&m_mutex, 100);
+        if (stopped())
+            return false;
+        m_queue.enqueue(chunk);
+        chunk = Chunk();
+        m_notEmpty.wakeOne();
+        return true;
+    }
+
+    /**
+     * @brief pop 归并端取出一块数据
+     * @return 读取线程已结束且没有数据或被停止时返回false
+     */
+    bool pop(Chunk &chunk)
+    {
+        QMutexLocker locker(&m_mutex);
+        while (m_queue.isEmpty() && !m_finished && !stopped())
+            m_notEmpty.wait(&m_mutex, 100);
+        if (m_queue.isEmpty() || stopped())
+            return false;
+        chunk = m_queue.dequeue();
+        m_notFull.wakeOne();
+        return true;
+    }
+
+    /**
+     * @brief finish 读取线程结束
+     * @param error 出错时的描述,正常结束为空
+     */
+    void finish(const QString &error = QString())
+    {
+        QMutexLocker locker(&m_mutex);
+        m_error = error;
+        m_finished = true;
+        m_notEmpty.wakeOne();
+    }
+
+    QString error()
+    {
+        QMutexLocker locker(&m_mutex);
+        return m_error;
+    }
+
+    //本组文件中最新一条的游标和时间,读取线程写入,线程结束后由归并端读取
+    QString newestCursor;
+    quint64 newestTime = 0;
+
+private:
+    const std::atomic_bool &m_canRun;
+    const std::atomic_bool &m_abort;
+    QMutex m_mutex;
+    QWaitCondition m_notEmpty;
+    QWaitCondition m_notFull;
+    QQueue<Chunk> m_queue;
+    bool m_finished = false;
+    QString m_error;
+};
+
+/**
+ * @brief The JournalReader class 统一的journal读取引擎,按Policy在编译期决定筛选条件和输出的数据结构
+ * 负责打开、定位、倒序迭代、时间范围截止、增量游标、取消和分批发送,各journal获取线程共用同一个热循环
+ */
+template <typename Policy>
+class JournalReader : public JournalReaderBase
+{
+public:
+    typedef typename Policy::Record Record;
+
+    JournalReader(const Policy &policy, const std::atomic_bool &canRun)
+        : m_policy(policy)
+        , m_fields(Policy::fieldNames())
+        , m_context(LogParseContextPool::instance().acquire(typeid(Policy).name()))
+        , m_canRun(canRun)
+    {
+    }
+
+    /**
+     * @brief read 读取日志
+     * @param options 读取参数
+     * @param batch 分批缓存,每满一批(大小由LogBatchSizer按读取速度调整)和读取结束时交给onBatch,之后清空
+     * @param onBatch 分批数据回调,参数为QList<Record>&
+     * @return 读取的条数;被取消返回-ECANCELED;其他负值为系统接口错误码,描述见errorString()
+     */
+    template <typename BatchHandler>
+    int read(const JournalReadOptions &options, QList<Record> &batch, BatchHandler onBatch)
+    {
+        m_errorString.clear();
+        m_newestCursor.clear();
+
+        //增量读取依赖单一的游标顺序,只走串行读取
+        if (options.threads > 1 && options.stopCursor.isEmpty()) {
+            const int maxGroups = qMin(options.threads, JOURNAL_PARALLEL_MAX_THREADS);
+            if (options.files.isEmpty() && !sourceDirectories().isEmpty()) {
+                //收集来的多台机器的日志,同一台机器的文件由一个线程读取
+                const QMap<QString, QStringList> machines = directoryFiles(sourceDirectories());
+                const int groups = qMin(maxGroups, machines.size());
+                if (groups > 1)
+                    return readParallel(options, partitionMachines(machines, groups), batch, onBatch);
+            } else {
+                QStringList files = options.files.isEmpty() ? journalFiles() : options.files;
+                const int groups = qMin(maxGroups, files.size());
+                if (groups > 1)
+                    return readParallel(options, partitionFiles(files, groups), batch, onBatch);
+            }
+        }
+
+        sd_journal *j = nullptr;
+        int r = openJournal(&j, options.files);
+        if (r < 0)
+            return fail("Failed to open journal", r);
+
+        r = prepare(j, options);
+        if (r < 0) {
+            sd_journal_close(j);
+            return r;
+        }
+
+        int cnt = 0;
+        qint64 visited = 0;
+        LogBatchSizer sizer;
+        while (m_canRun && sd_journal_previous(j) > 0) {
+            ++visited;
+            //增量读取,到达上次读取的最新条目即停止
+            if (!options.stopCursor.isEmpty() && sd_journal_test_cursor(j, options.stopCursor.constData()) > 0) {
+                if (m_newestCursor.isEmpty())
+                    m_newestCursor = QString::fromUtf8(options.stopCursor);
+                break;
+            }
+            if (m_newestCursor.isEmpty())
+                m_newestCursor = currentCursor(j);
+
+            Record record;
+            quint64 t = 0;
+            EntryState state = readEntry(j, options, record, t);
+            if (state == EntrySkipped)
+                continue;
+            if (state == EntryPastRange)
+                break;
+
+            batch.append(record);
+            ++cnt;
+            if (sizer.isFull(batch)) {
+                onBatch(batch);
+                batch.clear();
+                sizer.delivered();
+            }
+        }
+        sd_journal_close(j);
+        //journal条目没有原始行的字节数,只计条目数
+        LogIngestMetrics::addRead(0, visited);
+
+        if (!m_canRun)
+            return -ECANCELED;
+
+        //最后可能有余下不足一批的数据
+        onBatch(batch);
+        batch.clear();
+        return cnt;
+    }
+
+    /**
+     * @brief follow 持续读取新追加的日志,没有新日志时阻塞在sd_journal_wait上,直到被停止
+     * @param rangeOptions 读取参数,stopCursor为起始游标,只读取其后的日志,为空则从当前尾部开始;时间范围只保留开始时间
+     * @param onBatch 新日志回调,参数为按从新到旧排列的QList<Record>&,newestCursor()为其中最新一条的游标
+     * @return 被停止返回-ECANCELED;其他负值为系统接口错误码,描述见errorString()
+     */
+    template <typename BatchHandler>
+    int follow(const JournalReadOptions &rangeOptions, BatchHandler onBatch)
+    {
+        //跟踪的是之后新写入的日志,所选时间段的结束时间(如"今天"的24点)不再作为上限,开始时间仍然有效
+        JournalReadOptions options = rangeOptions;
+        if (options.hasTimeRange)
+            options.endTime = std::numeric_limits<quint64>::max();
+        m_errorString.clear();
+        m_newestCursor = QString::fromUtf8(options.stopCursor);
+
+        sd_journal *j = nullptr;
+        int r = openJournal(&j, options.files);
+        if (r < 0)
+            return fail("Failed to open journal", r);
+
+        setDataThreshold(j);
+        r = addMatches(j, options);
+        if (r < 0) {
+            sd_journal_close(j);
+            return r;
+        }
+
+        //定位到起始条目上,之后sd_journal_next返回的都是新日志
+        if (!options.stopCursor.isEmpty()) {
+            r = sd_journal_seek_cursor(j, options.stopCursor.constData());
+            if (r >= 0 && sd_journal_next(j) > 0 && sd_journal_test_cursor(j, options.stopCursor.constData()) <= 0) {
+                //游标对应的条目已不存在,停在了它之后的第一条上,回退一条以免漏掉这条
+                sd_journal_previous(j);
+            }
+        } else {
+            r = sd_journal_seek_tail(j);
+            if (r >= 0)
+                sd_journal_previous(j);
+        }
+        if (r < 0) {
+            sd_journal_close(j);
+            return fail("Failed to seek journal", r);
+        }
+
+        QList<Record> fresh;
+        while (m_canRun) {
+            while (m_canRun && (r = sd_journal_next(j)) > 0) {
+                m_newestCursor = currentCursor(j);
+                Record record;
+                quint64 t = 0;
+                if (readEntry(j, options, record, t) != EntryAccepted)
+                    continue;
+                fresh.prepend(record);
+                if (fresh.size() >= JOURNAL_BATCH_SIZE) {
+                    onBatch(fresh);
+                    fresh.clear();
+                }
+            }
+            if (r < 0) {
+                sd_journal_close(j);
+                return fail("Failed to iterate journal", r);
+            }
+            if (!fresh.isEmpty() && m_canRun) {
+                onBatch(fresh);
+                fresh.clear();
+            }
+            //定时醒来检查是否被停止
+            r = sd_journal_wait(j, JOURNAL_FOLLOW_WAIT_USEC);
+            if (r < 0) {
+                sd_journal_close(j);
+                return fail("Failed to wait journal", r);
+            }
+        }
+        sd_journal_close(j);
+        return -ECANCELED;
+    }
+
+private:
+    /**
+     * @brief addMatches 增加等级筛选、搜索条件下推的字段匹配和Policy决定的筛选条件
+     */
+    int addMatches(sd_journal *j, const JournalReadOptions &options)
+    {
+        int r = 0;
+        //增加日志等级筛选
+        if (!options.priorityMatch.isEmpty()) {
+            r = sd_journal_add_match(j, options.priorityMatch.constData(), 0);
+            if (r < 0)
+                return fail("Failed to add match journal", r);
+        }
+        //搜索条件下推的字段匹配,各项之间用析取连接,整体再和Policy的条件合取
+        for (int i = 0; i < options.matches.size(); ++i) {
+            if (i > 0 && (r = sd_journal_add_disjunction(j)) < 0)
+                return fail("Failed to add disjunction journal", r);
+            for (const QByteArray &match : options.matches.at(i)) {
+                r = sd_journal_add_match(j, match.constData(), static_cast<size_t>(match.size()));
+                if (r < 0)
+                    return fail("Failed to add match journal", r);
+            }
+        }
+        if (options.matches.size() > 1 && (r = sd_journal_add_conjunction(j)) < 0)
+            return fail("Failed to add conjunction journal", r);
+        r = m_policy.addMatches(j);
+        if (r < 0)
+            return fail("Failed to add match journal", r);
+        return 0;
+    }
+
+    /**
+     * @brief setDataThreshold 按Policy限制每个字段最多取出的字节数,只显示前缀的MESSAGE和不需要内容的大字段不再整个解压
+     * 为0时保持systemd的默认值
+     */
+    void setDataThreshold(sd_journal *j) const
+    {
+        const size_t threshold = m_policy.dataThreshold();
+        if (threshold > 0)
+            sd_journal_set_data_threshold(j, threshold);
+    }
+
+    /**
+     * @brief prepare 增加筛选条件并定位到读取起点
+     */
+    int prepare(sd_journal *j, const JournalReadOptions &options)
+    {
+        setDataThreshold(j);
+        int r = addMatches(j, options);
+        if (r < 0)
+            return r;
+
+        //有时间范围时直接定位到范围结束时间,否则从尾部开始读,出来数据是倒序
+        if (options.hasTimeRange)
+            r = sd_journal_seek_realtime_usec(j, options.endTime);
+        else
+            r = sd_journal_seek_tail(j);
+        if (r < 0)
+            return fail("Failed to seek journal", r);
+        return 0;
+    }
+
+    /**
+     * @brief readEntry 读取当前条目
+     * @param record 输出的记录
+     * @param realtime 输出的journal接收时间(微秒)
+     */
+    EntryState readEntry(sd_journal *j, const JournalReadOptions &options, Record &record, quint64 &realtime) const
+    {
+        uint64_t t = 0;
+        sd_journal_get_realtime_usec(j, &t);
+        realtime = t;
+        if (options.hasTimeRange) {
+            //定位点附近可能存在晚于结束时间的条目
+            if (t > options.endTime)
+                return EntrySkipped;
+            //已越过开始时间,之后的条目都更早
+            if (t < options.beginTime)
+                return EntryPastRange;
+        }
+
+        //一次遍历取出本条需要的全部字段
+        m_fields.read(j);
+
+        //优先使用日志产生时的时间,没有则使用journal接收时间
+        qint64 sourceTime = 0;
+        if (m_fields.fieldNumber(JournalEntryFields::SourceRealtime, sourceTime))
+            t = static_cast<uint64_t>(sourceTime);
+        record.timestamp = static_cast<qint64>(t);
+        //格式化的缓存不能跨线程共用,取本线程的实例,同一读取对象被多个线程调用时也不会竞争
+        record.dateTime = JournalTimeFormatter::forThread().format(t);
+
+        m_policy.project(j, m_fields, record, m_context->strings);
+
+        //没有等级的日志按调试处理，和journalctl 的筛选行为一致
+        qint64 prio = DEB;
+        if (!m_fields.fieldNumber(JournalEntryFields::Priority, prio) || prio < EMER || prio > DEB)
+            prio = DEB;
+        //只保存等级数字,显示文字由模型查表
+        record.level = static_cast<int>(prio);
+        return EntryAccepted;
+    }
+
+    /**
+     * @brief readGroup 并行读取线程函数,倒序读取一组journal文件并分块压入stream
+     */
+    void readGroup(const QStringList &files, const JournalReadOptions &options, JournalStream<Record> *stream) const
+    {
+        sd_journal *j = nullptr;
+        int r = openFiles(&j, files);
+        if (r < 0) {
+            stream->finish(QString("Failed to open journal files: %1").arg(strerror(-r)));
+            return;
+        }
+        JournalReader<Policy> worker(m_policy, m_canRun);
+        r = worker.prepare(j, options);
+        if (r < 0) {
+            sd_journal_close(j);
+            stream->finish(worker.errorString());
+            return;
+        }
+
+        typename JournalStream<Record>::Chunk chunk;
+        qint64 visited = 0;
+        while (!stream->stopped() && sd_journal_previous(j) > 0) {
+            ++visited;
+            if (stream->newestCursor.isEmpty()) {
+                stream->newestCursor = currentCursor(j);
+                uint64_t t = 0;
+                sd_journal_get_realtime_usec(j, &t);
+                stream->newestTime = t;
+            }
+
+            Record record;
+            quint64 t = 0;
+            //时间格式化和字符串池都不能跨线程共用,用本线程的worker读取
+            EntryState state = worker.readEntry(j, options, record, t);
+            if (state == EntrySkipped)
+                continue;
+            if (state == EntryPastRange)
+                break;
+
+            chunk.records.append(record);
+            chunk.times.append(t);
+            if (chunk.records.size() >= JOURNAL_PARALLEL_CHUNK && !stream->push(chunk))
+                break;
+        }
+        sd_journal_close(j);
+        LogIngestMetrics::addRead(0, visited);
+
+        if (!chunk.records.isEmpty())
+            stream->push(chunk);
+        stream->finish();
+    }
+
+    /**
+     * @brief readParallel 每组文件一个线程倒序读取,归并端按journal接收时间从新到旧k路归并后分批发出
+     */
+    template <typename BatchHandler>
+    int readParallel(const JournalReadOptions &options, const QList<QStringList> &groups, QList<Record> &batch, BatchHandler onBatch)
+    {
+        typedef JournalStream<Record> Stream;
+        std::atomic_bool abort(false);
+        std::vector<Stream *> streams;
+        std::vector<std::thread> threads;
+        //读取线程中的条目数计入调用者所属的加载
+        const LogIngestCountersPtr ingest = LogIngestMetrics::current();
+        for (const QStringList &files : groups) {
+            Stream *stream = new Stream(m_canRun, abort);
+            streams.push_back(stream);
+            threads.emplace_back([this, files, options, stream, ingest]() {
+                LogIngestScope ingestScope(ingest);
+                readGroup(files, options, stream);
+            });
+        }
+
+        const size_t k = streams.size();
+        std::vector<typename Stream::Chunk> heads(k);
+        std::vector<int> positions(k, 0);
+        std::vector<bool> alive(k, true);
+        for (size_t i = 0; i < k; ++i)
+            alive[i] = streams[i]->pop(heads[i]);
+
+        int cnt = 0;
+        LogBatchSizer sizer;
+        while (m_canRun) {
+            //线程数很少,线性查找当前最新的一条即可
+            int newest = -1;
+            for (size_t i = 0; i < k; ++i) {
+                if (alive[i] && (newest < 0 || heads[i].times.at(positions[i]) > heads[newest].times.at(positions[newest])))
+                    newest = static_cast<int>(i);
+            }
+            if (newest < 0)
+                break;
+
+            batch.append(heads[newest].records.at(positions[newest]));
+            if (++positions[newest] >= heads[newest].records.size()) {
+                positions[newest] = 0;
+                alive[newest] = streams[newest]->pop(heads[newest]);
+            }
+            ++cnt;
+            if (sizer.isFull(batch)) {
+                onBatch(batch);
+                batch.clear();
+                sizer.delivered();
+            }
+        }
+
+        abort = true;
+        for (std::thread &thread : threads)
+            thread.join();
+
+        quint64 newestTime = 0;
+        for (Stream *stream : streams) {
+            QString error = stream->error();
+            if (!error.isEmpty())
+                setError(error);
+            if (!stream->newestCursor.isEmpty() && (m_newestCursor.isEmpty() || stream->newestTime > newestTime)) {
+                m_newestCursor = stream->newestCursor;
+                newestTime = stream->newestTime;
+            }
+            delete stream;
+        }
+
+        if (!m_canRun)
+            return -ECANCELED;
+
+        onBatch(batch);
+        batch.clear();
+        return cnt;
+    }
+
+    Policy m_policy;
+    //当前条目的字段值,只在本读取线程内使用
+    mutable JournalEntryFields m_fields;
+    //主机名、进程名、进程号等低基数字段的字符串池,同样只在本读取线程内使用;同一Policy的读取之间复用
+    LogParseContextPool::Lease m_context;
+    const std::atomic_bool &m_canRun;
+};
+
+#endif  // JOURNALREADER_H
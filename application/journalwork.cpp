@@ -3,6 +3,12 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "journalwork.h"
+#include "journalfielddecoder.h"
+#include "journalreader.h"
+#include "logtracer.h"
+#include "logalloccounter.h"
+#include "logcanceltoken.h"
+#include "logmemorygovernor.h"
 #include "utils.h"
 
 #include <DApplication>
@@ -14,6 +20,7 @@
 #include <QJsonObject>
 #include <QProcess>
 #include <QLoggingCategory>
+#include <QThread>
 
 #ifdef QT_DEBUG
 Q_LOGGING_CATEGORY(logJournal, "org.deepin.log.viewer.parse.system.journal.work")
@@ -40,8 +47,6 @@ journalWork::journalWork(QStringList arg, QObject *parent)
     qRegisterMetaType<QList<LOG_MSG_JOURNAL> >("QList<LOG_MSG_JOURNAL>");
     //使用线程池启动该线程，跑完自己删自己
     setAutoDelete(true);
-    //初始化等级数字对应显示文本的map
-    initMap();
     //增加获取参数
     m_arg.append("-o");
     m_arg.append("json");
@@ -62,7 +67,6 @@ journalWork::journalWork(QObject *parent)
 
 {
     qRegisterMetaType<QList<LOG_MSG_JOURNAL> >("QList<LOG_MSG_JOURNAL>");
-    initMap();
     setAutoDelete(true);
     thread_index++;
     m_threadIndex = thread_index;
@@ -74,7 +78,6 @@ journalWork::journalWork(QObject *parent)
 journalWork::~journalWork()
 {
     logList.clear();
-    m_map.clear();
 }
 
 /**
@@ -116,6 +119,15 @@ void journalWork::setArg(QStringList arg)
         m_arg.append(arg);
 }
 
+/**
+ * @brief journalWork::setStopCursor 设置增量读取的截止游标
+ * @param cursor 上次读取到的最新一条日志的游标,为空则读取全部
+ */
+void journalWork::setStopCursor(const QString &cursor)
+{
+    m_stopCursor = cursor.toUtf8();
+}
+
 /**a
  * @brief journalWork::run 线程执行函数
  */
@@ -131,169 +143,48 @@ void journalWork::run()
  */
 void journalWork::doWork()
 {
+    PERF_TRACE_SCOPE("parse", "journalWork");
+    LogIngestScope ingest(m_ingest, true);
+    LogCancelScope cancel(m_canRun);
+    PERF_ALLOC_SCOPE("journalWork");
     //此线程刚开始把可以继续变量置true，不然下面没法跑
     m_canRun = true;
     mutex.lock();
     logList.clear();
     mutex.unlock();
-    if ((!m_canRun)) {
-        mutex.unlock();
-        return;
-    }
 
-    int r;
-
-    sd_journal *j ;
-    if ((!m_canRun)) {
-        mutex.unlock();
-        return;
+    JournalReadOptions options = JournalReadOptions::fromArgs(m_arg);
+    options.stopCursor = m_stopCursor;
+    //按journal文件分组并行读取,增量读取时读取引擎只走串行
+    const int profileThreads = LogPerformanceProfile::current().journalReadThreads;
+    options.threads = profileThreads > 0 ? profileThreads : QThread::idealThreadCount();
+    if (m_lowPriority) {
+        QThread::currentThread()->setPriority(QThread::IdlePriority);
+        options.threads = 1;
     }
-    //打开日志文件
-    r = sd_journal_open(&j, SD_JOURNAL_LOCAL_ONLY);
-    if ((!m_canRun)) {
-        mutex.unlock();
-        sd_journal_close(j);
-        return;
-    }
-    //r为系统借口返回值，小于0则表示失败，直接返回
-    if (r < 0) {
-        fprintf(stderr, "Failed to open journal: %s\n", strerror(-r));
-        return;
-    }
-    //从尾部开始读，这样出来数据是倒叙，符合需求
-    sd_journal_seek_tail(j);
-    if ((!m_canRun)) {
-        mutex.unlock();
-        sd_journal_close(j);
-        return;
-    }
-    //    sd_journal_add_match(j, "PRIORITY=3", 0);
 
-    if (!m_arg.isEmpty()) {
-        QString _priority = m_arg.at(0);
-        //增加日志等级筛选
-        if (_priority != "all")
-            sd_journal_add_match(j, m_arg.at(0).toStdString().c_str(), 0);
-    }
-    if ((!m_canRun)) {
-        mutex.unlock();
-        sd_journal_close(j);
+    //过长的信息只保留前缀,完整内容在选中或导出时通过游标读取,内存紧张时前缀更短
+    SystemJournalPolicy policy;
+    policy.lazyMessage = true;
+    if (LogMemoryGovernor::currentLevel() >= LogMemoryGovernor::Severe)
+        policy.lazyPrefix = JOURNAL_LAZY_MESSAGE_PRESSURE_PREFIX;
+    JournalReader<SystemJournalPolicy> reader(policy, m_canRun);
+    int r = reader.read(options, logList, [this](QList<LOG_MSG_JOURNAL> &list) {
+        //每满一批(大小由JournalReader按读取速度调整)就发出信号给控件加载
+        QMutexLocker locker(&mutex);
+        emit journalData(m_threadIndex, list);
+    });
+    //被停止时不再发出任何信号
+    if (r == -ECANCELED)
         return;
-    }
-    int cnt = 0;
-    //调用宏开始迭代
-    SD_JOURNAL_FOREACH_BACKWARDS(j) {
-        if ((!m_canRun)) {
-            mutex.unlock();
-            sd_journal_close(j);
-            return;
-        }
-        const char *d;
-        size_t l;
-
-        LOG_MSG_JOURNAL logMsg;
-        //获取时间
-        r = sd_journal_get_data(j, "_SOURCE_REALTIME_TIMESTAMP", reinterpret_cast<const void **>(&d), &l);
-        if (r < 0) {
-            r = sd_journal_get_data(j, "__REALTIME_TIMESTAMP", reinterpret_cast<const void **>(&d), &l);
-            if (r < 0) {
-                continue;
-            }
-        }
-        uint64_t t;
-        sd_journal_get_realtime_usec(j, &t);
-        //解锁返回字符串长度上限，默认是64k，写0为无限
-        // sd_journal_set_data_threshold(j, 0);
-        QString dt = getReplaceColorStr(d).split("=").value(1);
-        if (m_arg.size() == 3) {
-            if (t < static_cast<uint64_t>(m_arg.at(1).toLongLong()) || t > static_cast<uint64_t>(m_arg.at(2).toLongLong()))
-                continue;
-        }
-        logMsg.dateTime = getDateTimeFromStamp(dt);
-        //获取主机名
-        r = sd_journal_get_data(j, "_HOSTNAME", reinterpret_cast<const void **>(&d), &l);
-        if (r < 0)
-            logMsg.hostName = "";
-        else {
-            QStringList strList =    getReplaceColorStr(d).split("=");
-            strList.removeFirst();
-            logMsg.hostName = strList.join("=");
-        }
-        //获取进程号
-        r = sd_journal_get_data(j, "_PID", reinterpret_cast<const void **>(&d), &l);
-        if (r < 0)
-            logMsg.daemonId = "";
-        else {
-            QStringList strList =    getReplaceColorStr(d).split("=");
-            strList.removeFirst();
-            logMsg.daemonId = strList.join("=");
-        }
-        //获取进程名
-        r = sd_journal_get_data(j, "SYSLOG_IDENTIFIER", reinterpret_cast<const void **>(&d), &l);
-        if (r < 0) {
-            r = sd_journal_get_data(j, "_EXE", reinterpret_cast<const void **>(&d), &l);
-            if (r >= 0) {
-                QStringList strList =    getReplaceColorStr(d).split("=");
-                strList.removeFirst();
-                QFileInfo fi(strList.first());
-                if (fi.exists())
-                    logMsg.daemonName = fi.fileName();
-                else {
-                    qCWarning(logJournal) << "unknown progressname, exe path: " << strList.first();
-                    logMsg.daemonName = "unknown";
-                }
-            } else {
-                qCWarning(logJournal) << logMsg.daemonId << "error code" << r;
-                logMsg.daemonName = "unknown";
-            }
-        } else {
-            QStringList strList = getReplaceColorStr(d).split("=");
-            strList.removeFirst();
-            logMsg.daemonName = strList.join("=");
-        }
-
-        //获取信息体
-        r = sd_journal_get_data(j, "MESSAGE", reinterpret_cast<const void **>(&d), &l);
-        if (r < 0) {
-            logMsg.msg = "";
-        } else {
-            //出来的数据格式为 字段名= 信息体，但是因为信息体中也可能有=号，所以要把第一个去掉，后面的用=号拼起来
-            QStringList strList =    getReplaceColorStr(d).split("=");
-            strList.removeFirst();
-            logMsg.msg = strList.join("=");
-        }
-
-        //获取等级
-        r = sd_journal_get_data(j, "PRIORITY", reinterpret_cast<const void **>(&d), &l);
-        if (r < 0) {
-            //有些时候的确会产生没有等级的日志，按照需求此时一律按调试处理，和journalctl 的筛选行为一致
-            logMsg.level = i2str(7);
-        } else {
-            //获取等级为字段名= 数字 ，数字为0-7 ，对应紧急到调试，需要转换
-            logMsg.level = i2str(getReplaceColorStr(d).split("=").value(1).toInt());
-        }
-        cnt++;
-        mutex.lock();
-        logList.append(logMsg);
-        mutex.unlock();
-
-        //每获得500个数据就发出信号给控件加载
-        if (cnt % 500 == 0) {
-            mutex.lock();
-            emit journalData(m_threadIndex, logList);
-            logList.clear();
-            //sleep(100);
-            mutex.unlock();
-        }
-    }
-    //最后可能有余下不足500的数据
-    if (logList.count() >= 0) {
-        emit journalData(m_threadIndex, logList);
-    }
+    if (r < 0)
+        qCWarning(logJournal) << "read journal failed:" << reader.errorString();
+    else
+        qCInfo(logJournal).noquote() << QString("ingest stage=read records=%1 threads=%2").arg(r).arg(options.threads);
 
+    if (!reader.newestCursor().isEmpty())
+        emit journalCursor(m_threadIndex, reader.newestCursor());
     emit journalFinished(m_threadIndex);
-    //第一次加载时这个之后的代码都不执行?故放到最后
-    sd_journal_close(j);
 }
 
 /**
@@ -303,12 +194,7 @@ void journalWork::doWork()
  */
 QString journalWork::getReplaceColorStr(const char *d)
 {
-    QByteArray byteChar(d);
-    byteChar = Utils::replaceEmptyByteArray(byteChar);
-    QString d_str = QString(byteChar);
-    d_str.replace(QRegExp("\\x1B\\[\\d+(;\\d+){0,2}m"), "");
-    d_str.replace(QRegExp("\\002"), "");
-    return  d_str;
+    return JournalFieldDecoder::sanitize(d, d ? strlen(d) : 0);
 }
 
 
@@ -319,35 +205,5 @@ QString journalWork::getReplaceColorStr(const char *d)
  */
 QString journalWork::getDateTimeFromStamp(const QString &str)
 {
-    QString ret = "";
-    QString dtstr = str.left(str.length() - 6);
-    QDateTime dt = QDateTime::fromTime_t(dtstr.toUInt());
-    ret = dt.toString("yyyy-MM-dd hh:mm:ss");  // + QString(".%1").arg(ums);
-    return ret;
-}
-
-/**
- * @brief JournalBootWork::initMap 初始化等级数字和等级显示文本的map
- */
-void journalWork::initMap()
-{
-    m_map.clear();
-    m_map.insert(0, DApplication::translate("Level", "Emergency"));
-    m_map.insert(1, DApplication::translate("Level", "Alert"));
-    m_map.insert(2, DApplication::translate("Level", "Critical"));
-    m_map.insert(3, DApplication::translate("Level", "Error"));
-    m_map.insert(4, DApplication::translate("Level", "Warning"));
-    m_map.insert(5, DApplication::translate("Level", "Notice"));
-    m_map.insert(6, DApplication::translate("Level", "Info"));
-    m_map.insert(7, DApplication::translate("Level", "Debug"));
-}
-
-/**
- * @brief JournalBootWork::i2str 日志等级到等级显示文本的转换
- * @param prio 日志等级数字
- * @return 等级显示文
- */
-QString journalWork::i2str(int prio)
-{
-    return m_map.value(prio);
+    return JournalReaderBase::formatTime(str.toULongLong());
 }
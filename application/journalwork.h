@@ -6,6 +6,7 @@
 #define JOURNALWORK_H
 
 #include "structdef.h"
+#include "logingestmetrics.h"
 
 #include <QMap>
 #include <QObject>
@@ -46,6 +47,8 @@ public:
 
 
     void setArg(QStringList arg);
+    void setStopCursor(const QString &cursor);
+    void setLowPriority(bool lowPriority) { m_lowPriority = lowPriority; }
     void run() override;
 
 signals:
@@ -59,6 +62,12 @@ signals:
      * @brief journalFinished 获取数据结束
      */
     void journalFinished(int index);
+    /**
+     * @brief journalCursor 本次读取到的最新一条日志的游标,供增量刷新时作为截止位置
+     * @param index 当前线程的数字标号
+     * @param cursor sd_journal游标字符串
+     */
+    void journalCursor(int index, const QString &cursor);
 
 public slots:
     void doWork();
@@ -78,16 +87,10 @@ public:
     static int thread_index ;
 private:
     QString getDateTimeFromStamp(const QString &str);
-    void initMap();
-    QString i2str(int prio);
     /**
      * @brief m_arg 获取数据筛选参数
      */
     QStringList m_arg;
-    /**
-     * @brief m_map 等级数字对应字符串
-     */
-    QMap<int, QString> m_map;
     // sd_journal *j {nullptr};
     QProcess *proc {nullptr};
     static std::atomic<journalWork *> m_instance;
@@ -97,11 +100,20 @@ private:
      * @brief m_canRun  是否允许标记量，用于停止该线程
      */
     std::atomic_bool m_canRun = false;
+    //构造时(界面发起加载时)所属加载的指标计数,运行时安装到解析线程
+    LogIngestCountersPtr m_ingest {LogIngestMetrics::current()};
     /**
      * @brief m_threadIndex 当前线程标号
      */
     int m_threadIndex;
-
+    /**
+     * @brief m_stopCursor 增量读取截止游标,倒序迭代到该条目时停止,为空则读取全部
+     */
+    QByteArray m_stopCursor;
+    /**
+     * @brief m_lowPriority 后台预取时以最低优先级串行读取,只在预取专用的线程池中设置
+     */
+    bool m_lowPriority = false;
 
 };
 
@@ -0,0 +1,138 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logaggregates.h"
+#include "logquery.h"
+#include "loglevel.h"
+#include "loglocaltime.h"
+
+
+#include <algorithm>
+
+//一小时的毫秒数
+#define LOG_AGGREGATE_HOUR_MSECS (3600LL * 1000)
+
+void LogAggregates::add(const LOG_MSG_JOURNAL &msg)
+{
+    ++m_total;
+    if (!msg.daemonName.isEmpty())
+        ++m_daemons[msg.daemonName];
+    if (msg.level >= 0)
+        ++m_levels[msg.level];
+    //timestamp为微秒,没有时间的记录不计入小时分布
+    if (msg.timestamp > 0)
+        ++m_hours[hourBegin(msg.timestamp / 1000)];
+}
+
+/**
+ * @brief LogAggregates::add 累加一批记录
+ * @param list 本批记录
+ * @param begin 起始下标
+ * @param end 结束下标(不含),-1表示到末尾
+ */
+void LogAggregates::add(const QList<LOG_MSG_JOURNAL> &list, int begin, int end)
+{
+    if (end < 0 || end > list.size())
+        end = list.size();
+    for (int i = begin; i < end; ++i)
+        add(list.at(i));
+}
+
+void LogAggregates::clear()
+{
+    m_daemons.clear();
+    m_levels.clear();
+    m_hours.clear();
+    m_total = 0;
+}
+
+/**
+ * @brief LogAggregates::daemons 各进程的条数,从多到少
+ * @param limit 最多的项数,-1表示全部
+ */
+QList<LogAggregateEntry> LogAggregates::daemons(int limit) const
+{
+    QList<LogAggregateEntry> entries;
+    for (auto it = m_daemons.constBegin(); it != m_daemons.constEnd(); ++it) {
+        LogAggregateEntry entry;
+        entry.text = it.key();
+        entry.term = QString("ident:%1").arg(quoteValue(it.key()));
+        entry.count = it.value();
+        entries.append(entry);
+    }
+    std::sort(entries.begin(), entries.end(), [](const LogAggregateEntry &a, const LogAggregateEntry &b) {
+        return a.count != b.count ? a.count > b.count : a.text < b.text;
+    });
+    if (limit >= 0 && entries.size() > limit)
+        entries.erase(entries.begin() + limit, entries.end());
+    return entries;
+}
+
+/**
+ * @brief LogAggregates::levels 各等级的条数,从严重到轻微
+ */
+QList<LogAggregateEntry> LogAggregates::levels() const
+{
+    QList<LogAggregateEntry> entries;
+    for (auto it = m_levels.constBegin(); it != m_levels.constEnd(); ++it) {
+        LogAggregateEntry entry;
+        entry.text = LogLevel::text(it.key());
+        entry.term = QString("level:%1").arg(it.key());
+        entry.count = it.value();
+        entries.append(entry);
+    }
+    return entries;
+}
+
+/**
+ * @brief LogAggregates::hours 各小时的条数,从新到旧
+ * @param limit 最多的项数(最近的若干小时),-1表示全部
+ */
+QList<LogAggregateEntry> LogAggregates::hours(int limit) const
+{
+    QList<LogAggregateEntry> entries;
+    for (auto it = m_hours.constEnd(); it != m_hours.constBegin();) {
+        --it;
+        if (limit >= 0 && entries.size() >= limit)
+            break;
+        LogAggregateEntry entry;
+        entry.text = LogLocalTime::format(it.key()).left(13) + QLatin1String(":00");
+        entry.term = QString("hour:%1").arg(LogQuery::hourText(it.key()));
+        entry.count = it.value();
+        entries.append(entry);
+    }
+    return entries;
+}
+
+/**
+ * @brief LogAggregates::hourBegin 时间所在本地整点小时的起始时间
+ * 本地时间偏移取自LogLocalTime缓存的偏移不变区间
+ * @param msecs 毫秒时间戳
+ */
+qint64 LogAggregates::hourBegin(qint64 msecs)
+{
+    const qint64 offset = LogLocalTime::offsetMSecs(msecs);
+    const qint64 local = msecs + offset;
+    return local - local % LOG_AGGREGATE_HOUR_MSECS - offset;
+}
+
+/**
+ * @brief LogAggregates::quoteValue 含空白或引号的值加上引号,作为查询条件的值
+ */
+QString LogAggregates::quoteValue(const QString &value)
+{
+    bool plain = !value.isEmpty();
+    for (const QChar &ch : value) {
+        if (ch.isSpace() || ch == QLatin1Char('"')) {
+            plain = false;
+            break;
+        }
+    }
+    if (plain)
+        return value;
+    QString quoted = value;
+    quoted.replace(QLatin1Char('\\'), QLatin1String("\\\\"));
+    quoted.replace(QLatin1Char('"'), QLatin1String("\\\""));
+    return QLatin1Char('"') + quoted + QLatin1Char('"');
+}
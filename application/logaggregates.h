@@ -0,0 +1,54 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGAGGREGATES_H
+#define LOGAGGREGATES_H
+
+#include "structdef.h"
+
+#include <QHash>
+#include <QList>
+#include <QMap>
+#include <QString>
+
+/**
+ * @brief The LogAggregateEntry struct 一项统计:显示文本、点击时加入搜索框的查询条件和条数
+ */
+struct LogAggregateEntry {
+    QString text;
+    QString term;
+    int count = 0;
+};
+
+/**
+ * @brief The LogAggregates class 加载过程中逐批累计的进程、等级和小时分布
+ * 每批记录到达时只累加计数,不保存记录,取统计结果时才排序;小时按本地时间的整点划分,
+ * 同一UTC小时内的本地时间偏移只计算一次。查询条件使用LogQuery的ident:、level:和hour:写法
+ */
+class LogAggregates
+{
+public:
+    void add(const LOG_MSG_JOURNAL &msg);
+    void add(const QList<LOG_MSG_JOURNAL> &list, int begin = 0, int end = -1);
+    void clear();
+    int total() const { return m_total; }
+    bool isEmpty() const { return m_total == 0; }
+
+    QList<LogAggregateEntry> daemons(int limit = -1) const;
+    QList<LogAggregateEntry> levels() const;
+    QList<LogAggregateEntry> hours(int limit = -1) const;
+
+    static qint64 hourBegin(qint64 msecs);
+    static QString quoteValue(const QString &value);
+
+private:
+    QHash<QString, int> m_daemons;
+    //各等级(PRIORITY)的条数,按等级从严重到轻微排列
+    QMap<int, int> m_levels;
+    //各小时起始时间(毫秒时间戳)的条数
+    QMap<qint64, int> m_hours;
+    int m_total = 0;
+};
+
+#endif // LOGAGGREGATES_H
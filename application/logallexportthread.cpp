@@ -5,19 +5,38 @@
 #include "logallexportthread.h"
 #include "dbusproxy/dldbushandler.h"
 #include "logapplicationhelper.h"
+#include "logexportwatermark.h"
+#include "logzipwriter.h"
 #include "utils.h"
 
+#include <QFileInfo>
+#include <QQueue>
+#include <QScopedPointer>
+#include <QThreadPool>
+#include <QWaitCondition>
 #include <QLoggingCategory>
+#include <QtConcurrent>
+
+#include <vector>
+
 #ifdef QT_DEBUG
 Q_LOGGING_CATEGORY(logExportAll, "org.deepin.log.viewer.exportall.work")
 #else
 Q_LOGGING_CATEGORY(logExportAll, "org.deepin.log.viewer.exportall.work", QtInfoMsg)
 #endif
 
+//打包阶段最少占的进度数
+#define ALL_EXPORT_ZIP_MIN_PROCESS 10
+//增量导出时复制文件新增部分的缓冲大小
+#define ALL_EXPORT_COPY_CHUNK (1024 * 1024)
+//同时收集的种类数,收集主要在等待服务复制文件和执行命令,不需要占满所有核
+#define ALL_EXPORT_WORKERS 4
+
 LogAllExportThread::LogAllExportThread(const QStringList &types, const QString &outfile, QObject *parent)
     : QObject(parent)
     , m_types(types)
     , m_outfile(outfile)
+    , m_progress([this](int current, int) { emit updatecurrentProcess(current); })
 {
 }
 
@@ -70,7 +89,7 @@ void LogAllExportThread::run()
             data.files.append(KWIN_TREE_DATA);
         } else if (it.contains(APP_TREE_DATA, Qt::CaseInsensitive)) {
             data.logCategory = "apps";
-            QMap<QString, QString> appData = LogApplicationHelper::instance()->getMap();
+            QMap<QString, QString> appData = LogApplicationHelper::instance()->getMap(true);
             for (auto &it2 : appData.toStdMap()) {
                 QString appName = Utils::appName(it2.second);
                 if (appName.isEmpty())
@@ -148,73 +167,85 @@ void LogAllExportThread::run()
         return;
     }
 
-    int tolProcess = nCount + 10;
-    int currentProcess = 1;
-    emit updateTolProcess(tolProcess);
+    //打包阶段按已写入包中的种类推进,占的进度不少于复制阶段
+    const int zipProcess = qMax(ALL_EXPORT_ZIP_MIN_PROCESS, nCount);
+    ExportContext context;
+    context.collectSteps = nCount;
+    context.tolProcess = nCount + zipProcess;
+    emit updateTolProcess(context.tolProcess);
     QString tmpPath = Utils::getAppDataPath() + "/tmp/";
     QDir dir(tmpPath);
     //删除临时目录
     dir.removeRecursively();
     //创建临时目录
     Utils::mkMutiDir(tmpPath);
-    for (auto &it : eList) {
-        //复制文件到一级目录
-        QString tmpCategoryPath = QString("%1%2/").arg(tmpPath).arg(it.logCategory);
-        Utils::mkMutiDir(tmpCategoryPath);
-        for (auto &file : it.files) {
-            DLDBusHandler::instance(this)->exportLog(tmpCategoryPath, file, true);
-            emit updatecurrentProcess(currentProcess++);
-            if (m_cancel) {
-                break;
-            }
-        }
+    //增量导出时读取上次导出的水位,导出成功后更新
+    QScopedPointer<LogExportWatermark> watermark(m_incremental ? new LogExportWatermark : nullptr);
+    context.watermark = watermark.data();
 
-        // 复制文件到二级目录
-        if (!m_cancel) {
-            QMapIterator<QString, QStringList> itMap(it.dir2Files);
-            while (itMap.hasNext()) {
-                itMap.next();
-                if (m_cancel)
-                    break;
-
-                if (itMap.value().size() > 0) {
-                    QString tmpSubCategoryPath = QString("%1%2/").arg(tmpCategoryPath).arg(itMap.key());
-                    Utils::mkMutiDir(tmpSubCategoryPath);
-                    for (auto &path : itMap.value()) {
-                        DLDBusHandler::instance(this)->exportLog(tmpSubCategoryPath, path, path != "journalctl_app");
-                        emit updatecurrentProcess(currentProcess++);
-                        if (m_cancel) {
-                            break;
-                        }
-                    }
-                }
-            }
-        } else
-            break;
+    //各个种类互不依赖,在有限的线程中同时收集,每个种类使用单独的临时目录(dmesg和kern.log同属kernel);
+    //收集完的种类立即写入包中,总耗时接近最慢的种类而不是所有种类之和
+    LogZipWriter zip(m_outfile);
+    const int count = eList.size();
+    std::vector<ReadableFiles> readable(static_cast<size_t>(count));
+    QMutex doneMutex;
+    QWaitCondition doneChanged;
+    QQueue<int> doneQueue;
+    QThreadPool pool;
+    pool.setMaxThreadCount(qMin(ALL_EXPORT_WORKERS, count));
+    for (int i = 0; i < count; ++i) {
+        const QString taskDir = QString("%1%2/").arg(tmpPath).arg(i);
+        QtConcurrent::run(&pool, [this, i, taskDir, &eList, &context, &readable, &doneMutex, &doneChanged, &doneQueue]() {
+            Utils::mkMutiDir(taskDir);
+            if (!isCanceled())
+                readable[static_cast<size_t>(i)] = exportCategory(eList.at(i), taskDir, context);
+            QMutexLocker locker(&doneMutex);
+            doneQueue.enqueue(i);
+            doneChanged.wakeAll();
+        });
+    }
 
-        // 执行获取日志命令
-        if (!m_cancel) {
-            for (auto &command : it.commands) {
-                DLDBusHandler::instance(this)->exportLog(tmpCategoryPath, command, false);
-                emit updatecurrentProcess(currentProcess++);
-                if (m_cancel) {
-                    break;
-                }
-            }
-        } else
-            break;
+    bool zipped = zip.isOpen();
+    for (int finished = 0; finished < count; ++finished) {
+        int index = 0;
+        {
+            QMutexLocker locker(&doneMutex);
+            while (doneQueue.isEmpty())
+                doneChanged.wait(&doneMutex);
+            index = doneQueue.dequeue();
+        }
+        const QString taskDir = QString("%1%2/").arg(tmpPath).arg(index);
+        if (zipped && !isCanceled()) {
+            //当前用户能读取的文件直接打包,其余的在临时目录中,压缩进同一个包
+            for (const auto &file : readable[static_cast<size_t>(index)])
+                zip.addFile(file.second, file.first);
+            zip.addDirectory(taskDir, eList.at(index).logCategory);
+            zipped = zip.write([this, &context, finished, zipProcess, count](qint64 done, qint64 total) {
+                const qint64 part = total > 0 ? done * zipProcess / total : 0;
+                reportProgress(context, 0, static_cast<int>((finished * static_cast<qint64>(zipProcess) + part) / count));
+                return !isCanceled();
+            });
+            if (!zipped)
+                m_failed = true;
+        }
+        //写入包中后删除,临时文件不会同时占满所有种类的空间
+        QDir(taskDir).removeRecursively();
     }
+    pool.waitForDone();
 
     if (!m_cancel) {
-        //打包日志文件
-        QProcess procss;
-        procss.setWorkingDirectory(tmpPath);
-        QStringList arg = {"-c"};
-        arg.append(QString("chmod -R 777 '%1';zip -r tmp.zip ./*;mv tmp.zip '%2';chmod 777 '%3'").arg(Utils::getAppDataPath()).arg(m_outfile).arg(m_outfile));
-        procss.start("/bin/bash", arg);
-        procss.waitForFinished(-1);
-        currentProcess += 9;
-        emit updatecurrentProcess(currentProcess);
+        //打包失败时不留下不完整的包,成功时才更新增量导出的水位
+        if (!zip.close() || !zipped)
+            QFile::remove(m_outfile);
+        else if (watermark)
+            watermark->save();
+        //和原来的chmod 777一致,导出的包其他用户也能处理
+        QFile::setPermissions(m_outfile, QFileDevice::ReadOwner | QFileDevice::WriteOwner | QFileDevice::ExeOwner
+                                         | QFileDevice::ReadGroup | QFileDevice::WriteGroup | QFileDevice::ExeGroup
+                                         | QFileDevice::ReadOther | QFileDevice::WriteOther | QFileDevice::ExeOther);
+        m_progress.report(context.tolProcess, context.tolProcess);
+    } else {
+        zip.close();
     }
 
     //删除临时目录
@@ -225,3 +256,159 @@ void LogAllExportThread::run()
     }
     emit exportFinsh(!m_cancel && QFileInfo(m_outfile).exists());
 }
+
+/**
+ * @brief LogAllExportThread::exportCategory 收集一个种类的日志到临时目录,在收集线程中调用
+ * @param data 种类的文件和命令
+ * @param tmpDir 该种类单独使用的临时目录
+ * @return 当前用户能直接读取、不需要复制的文件
+ */
+LogAllExportThread::ReadableFiles LogAllExportThread::exportCategory(const EXPORTALL_DATA &data, const QString &tmpDir, ExportContext &context)
+{
+    ReadableFiles readable;
+    //文件由服务批量复制,每个文件完成时更新进度
+    auto onExported = [this, &context](int, bool) {
+        reportProgress(context, 1);
+        return !isCanceled();
+    };
+    DLDBusHandler::instance(nullptr)->exportLogFiles(tmpDir, splitReadable(data.files, data.logCategory + "/", tmpDir, context, readable), onExported);
+
+    // 复制文件到二级目录
+    for (auto itMap = data.dir2Files.constBegin(); itMap != data.dir2Files.constEnd() && !isCanceled(); ++itMap) {
+        if (itMap.value().isEmpty())
+            continue;
+
+        QString tmpSubCategoryPath = QString("%1%2/").arg(tmpDir).arg(itMap.key());
+        Utils::mkMutiDir(tmpSubCategoryPath);
+        QStringList files;
+        for (auto &path : itMap.value()) {
+            if (path != "journalctl_app") {
+                files.append(path);
+                continue;
+            }
+            exportCommand(tmpSubCategoryPath, path, QString("%1/%2").arg(path).arg(itMap.key()), context);
+            reportProgress(context, 1);
+            if (isCanceled())
+                break;
+        }
+        if (!isCanceled()) {
+            files = splitReadable(files, QString("%1/%2/").arg(data.logCategory).arg(itMap.key()), tmpSubCategoryPath, context, readable);
+            DLDBusHandler::instance(nullptr)->exportLogFiles(tmpSubCategoryPath, files, onExported);
+        }
+    }
+
+    // 执行获取日志命令
+    for (auto &command : data.commands) {
+        if (isCanceled())
+            break;
+        exportCommand(tmpDir, command, command, context);
+        reportProgress(context, 1);
+    }
+    return readable;
+}
+
+/**
+ * @brief LogAllExportThread::splitReadable 当前用户能读取的文件直接打包,不再复制,其余的返回由服务复制到临时目录
+ * 增量导出时没有新内容的跳过,上次导出过一部分的只导出新增部分,压缩文件不能只取后半部分
+ */
+QStringList LogAllExportThread::splitReadable(const QStringList &files, const QString &entryDir, const QString &tmpDir,
+                                              ExportContext &context, ReadableFiles &readable)
+{
+    QStringList unreadable;
+    const QList<LogFileStat> stats = context.watermark ? DLDBusHandler::instance(nullptr)->statFiles(files) : QList<LogFileStat>();
+    for (int i = 0; i < files.size(); ++i) {
+        const QString &path = files.at(i);
+        QFileInfo fileInfo(path);
+        if (i < stats.size() && stats.at(i).exists) {
+            const LogFileStat &stat = stats.at(i);
+            qint64 offset = 0;
+            {
+                QMutexLocker locker(&context.mutex);
+                offset = context.watermark->fileOffset(stat);
+                context.watermark->setFileOffset(stat, stat.size);
+            }
+            if (offset > 0 && offset < stat.size && fileInfo.suffix() == "gz")
+                offset = 0;
+            if (offset >= stat.size || (offset > 0 && copyFileTail(stat, offset, tmpDir + fileInfo.fileName()))) {
+                reportProgress(context, 1);
+                continue;
+            }
+        }
+        if (fileInfo.isFile() && fileInfo.isReadable()) {
+            readable.append(qMakePair(entryDir + fileInfo.fileName(), path));
+            reportProgress(context, 1);
+        } else {
+            unreadable.append(path);
+        }
+    }
+    return unreadable;
+}
+
+/**
+ * @brief LogAllExportThread::exportCommand 执行获取日志的命令
+ * 增量导出时journal记录按cursor只导出新增的,否则按设置的时间范围和等级导出;dmesg和last的输出不大,每次全部导出
+ * @param source 水位中的来源名
+ */
+void LogAllExportThread::exportCommand(const QString &outDir, const QString &command, const QString &source, ExportContext &context)
+{
+    if (context.watermark && command.startsWith("journalctl_")) {
+        QString cursor;
+        {
+            QMutexLocker locker(&context.mutex);
+            cursor = context.watermark->journalCursor(source);
+        }
+        const QString newest = DLDBusHandler::instance(nullptr)->exportJournalSince(outDir, command, cursor);
+        QMutexLocker locker(&context.mutex);
+        context.watermark->setJournalCursor(source, newest);
+        return;
+    }
+    if (m_journalOptions.contains(command)) {
+        DLDBusHandler::instance(nullptr)->exportJournal(outDir, command, m_journalOptions.value(command));
+        return;
+    }
+    DLDBusHandler::instance(nullptr)->exportLog(outDir, command, false);
+}
+
+/**
+ * @brief LogAllExportThread::reportProgress 收集线程和打包共用的进度,收集的步数不超过预计的总数
+ * @param collected 新完成的收集步数
+ * @param zipped 打包阶段的进度,小于0时不变
+ */
+void LogAllExportThread::reportProgress(ExportContext &context, int collected, int zipped)
+{
+    QMutexLocker locker(&context.mutex);
+    context.collected += collected;
+    if (zipped >= 0)
+        context.zipped = zipped;
+    m_progress.report(qMin(context.collected, context.collectSteps) + context.zipped, context.tolProcess);
+}
+
+/**
+ * @brief LogAllExportThread::copyFileTail 增量导出时把文件中offset到记录大小之间的新增内容写到target
+ * 当前用户不能读取的文件通过服务取得只读描述符,服务不支持时返回false,由调用者完整导出
+ */
+bool LogAllExportThread::copyFileTail(const LogFileStat &stat, qint64 offset, const QString &target)
+{
+    QDBusUnixFileDescriptor descriptor;
+    QFile source(stat.path);
+    if (!stat.readable || !source.open(QIODevice::ReadOnly)) {
+        descriptor = DLDBusHandler::instance(nullptr)->openLogFile(stat.path);
+        if (!descriptor.isValid() || !source.open(descriptor.fileDescriptor(), QIODevice::ReadOnly))
+            return false;
+    }
+    QFile out(target);
+    if (!source.seek(offset) || !out.open(QIODevice::WriteOnly))
+        return false;
+
+    QByteArray buffer(ALL_EXPORT_COPY_CHUNK, Qt::Uninitialized);
+    for (qint64 remain = stat.size - offset; remain > 0 && !isCanceled();) {
+        const qint64 size = source.read(buffer.data(), qMin<qint64>(remain, buffer.size()));
+        if (size <= 0 || out.write(buffer.constData(), size) != size) {
+            qCWarning(logExportAll) << "copy new content failed:" << stat.path;
+            out.remove();
+            return false;
+        }
+        remain -= size;
+    }
+    return !isCanceled();
+}
@@ -5,10 +5,20 @@
 #ifndef LOGALLEXPORTTHREAD_H
 #define LOGALLEXPORTTHREAD_H
 
+#include "logfilestat.h"
+#include "logprogressreporter.h"
 #include "structdef.h"
 
+#include <QMap>
+#include <QMutex>
 #include <QObject>
+#include <QPair>
 #include <QRunnable>
+#include <QVariantMap>
+
+#include <atomic>
+
+class LogExportWatermark;
 
 class LogAllExportThread : public QObject
     , public QRunnable
@@ -16,6 +26,10 @@ class LogAllExportThread : public QObject
     Q_OBJECT
 public:
     explicit LogAllExportThread(const QStringList &types, const QString &outfile, QObject *parent = nullptr);
+    //只导出上次成功导出之后新增的日志
+    void setIncremental(bool incremental) { m_incremental = incremental; }
+    //journal导出命令的时间范围、等级等参数,见DLDBusHandler::exportJournal;增量导出时按cursor导出,不使用这些参数
+    void setJournalOptions(const QString &command, const QVariantMap &options) { m_journalOptions.insert(command, options); }
 public slots:
     void slot_cancelExport() { m_cancel = true; }
 
@@ -27,10 +41,40 @@ signals:
     void exportFinsh(bool success = true);
 
 private:
+    /**
+     * @brief The ExportContext struct 各个种类并行收集时共用的水位和进度,由mutex保护
+     */
+    struct ExportContext {
+        LogExportWatermark *watermark = nullptr;
+        QMutex mutex;
+        //收集阶段的总步数,之后的进度属于打包
+        int collectSteps = 0;
+        int tolProcess = 0;
+        int collected = 1;
+        int zipped = 0;
+    };
+    //包中的路径和源文件路径
+    using ReadableFiles = QList<QPair<QString, QString>>;
+
+    ReadableFiles exportCategory(const EXPORTALL_DATA &data, const QString &tmpDir, ExportContext &context);
+    QStringList splitReadable(const QStringList &files, const QString &entryDir, const QString &tmpDir,
+                              ExportContext &context, ReadableFiles &readable);
+    void exportCommand(const QString &outDir, const QString &command, const QString &source, ExportContext &context);
+    void reportProgress(ExportContext &context, int collected, int zipped = -1);
+    bool copyFileTail(const LogFileStat &stat, qint64 offset, const QString &target);
+    bool isCanceled() const { return m_cancel || m_failed; }
+
     QStringList m_types;
     QString m_outfile {""};
 
-    bool m_cancel {false};
+    std::atomic_bool m_cancel {false};
+    //打包失败,停止还在收集的种类
+    std::atomic_bool m_failed {false};
+    bool m_incremental {false};
+    //各journal导出命令的导出参数
+    QMap<QString, QVariantMap> m_journalOptions;
+    //文件较多时合并进度通知
+    LogProgressReporter m_progress;
 };
 
 #endif // LOGALLEXPORTTHREAD_H
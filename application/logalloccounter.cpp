@@ -0,0 +1,240 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logalloccounter.h"
+#include "logingestmetrics.h"
+
+#include <QHash>
+#include <QLoggingCategory>
+#include <QStringList>
+
+#include <algorithm>
+#include <mutex>
+
+#ifdef QT_DEBUG
+Q_LOGGING_CATEGORY(logAlloc, "org.deepin.log.viewer.alloc")
+#else
+Q_LOGGING_CATEGORY(logAlloc, "org.deepin.log.viewer.alloc", QtInfoMsg)
+#endif
+
+//分配函数中访问的线程变量不能走__tls_get_addr,它本身可能调用malloc
+#ifdef LOG_ALLOC_COUNT
+#define LOG_ALLOC_TLS __attribute__((tls_model("initial-exec")))
+#else
+#define LOG_ALLOC_TLS
+#endif
+
+namespace {
+std::atomic<bool> s_hooked {false};
+std::atomic<quint64> s_allocs {0};
+std::atomic<quint64> s_frees {0};
+std::atomic<quint64> s_bytes {0};
+thread_local quint64 t_allocs LOG_ALLOC_TLS = 0;
+thread_local quint64 t_frees LOG_ALLOC_TLS = 0;
+thread_local quint64 t_bytes LOG_ALLOC_TLS = 0;
+thread_local int t_paused LOG_ALLOC_TLS = 0;
+
+std::mutex &scopeMutex()
+{
+    static std::mutex mutex;
+    return mutex;
+}
+
+QHash<QString, LogAllocScopeStats> &scopeStorage()
+{
+    static QHash<QString, LogAllocScopeStats> scopes;
+    return scopes;
+}
+
+bool moreAllocs(const LogAllocScopeStats &a, const LogAllocScopeStats &b)
+{
+    return a.allocs > b.allocs;
+}
+}
+
+double LogAllocScopeStats::allocsPerUnit() const
+{
+    return units > 0 ? static_cast<double>(allocs) / units : 0;
+}
+
+double LogAllocScopeStats::bytesPerUnit() const
+{
+    return units > 0 ? static_cast<double>(bytes) / units : 0;
+}
+
+/**
+ * @brief LogAllocCounter::isEnabled 本进程的分配函数是否已替换,未替换时计数没有意义
+ */
+bool LogAllocCounter::isEnabled()
+{
+    return s_hooked.load(std::memory_order_relaxed);
+}
+
+LogAllocStats LogAllocCounter::process()
+{
+    LogAllocStats stats;
+    stats.allocs = s_allocs.load(std::memory_order_relaxed);
+    stats.frees = s_frees.load(std::memory_order_relaxed);
+    stats.bytes = s_bytes.load(std::memory_order_relaxed);
+    return stats;
+}
+
+LogAllocStats LogAllocCounter::thread()
+{
+    LogAllocStats stats;
+    stats.allocs = t_allocs;
+    stats.frees = t_frees;
+    stats.bytes = t_bytes;
+    return stats;
+}
+
+/**
+ * @brief LogAllocCounter::addScope 累计一次作用域的结果,同名作用域(如各批次的parseListToModel)合并
+ */
+void LogAllocCounter::addScope(const char *name, const LogAllocStats &stats, quint64 units)
+{
+    Pause pause;
+    std::lock_guard<std::mutex> locker(scopeMutex());
+    LogAllocScopeStats &scope = scopeStorage()[QString::fromLatin1(name)];
+    if (scope.name.isEmpty())
+        scope.name = QString::fromLatin1(name);
+    ++scope.calls;
+    scope.allocs += stats.allocs;
+    scope.bytes += stats.bytes;
+    scope.units += units;
+}
+
+/**
+ * @brief LogAllocCounter::takeScopes 取出上次以来的汇总并清零,按分配次数从多到少排列
+ */
+QList<LogAllocScopeStats> LogAllocCounter::takeScopes()
+{
+    QList<LogAllocScopeStats> result;
+    {
+        std::lock_guard<std::mutex> locker(scopeMutex());
+        result = scopeStorage().values();
+        scopeStorage().clear();
+    }
+    std::sort(result.begin(), result.end(), moreAllocs);
+    return result;
+}
+
+/**
+ * @brief LogAllocCounter::format 每个作用域一行key=value,没有行数时每行的分配数为"-"
+ */
+QString LogAllocCounter::format(const QList<LogAllocScopeStats> &scopes)
+{
+    QStringList lines;
+    for (const LogAllocScopeStats &scope : scopes) {
+        QString line = QString("alloc scope=%1 calls=%2 allocs=%3 bytes=%4 lines=%5")
+                           .arg(scope.name)
+                           .arg(scope.calls)
+                           .arg(scope.allocs)
+                           .arg(scope.bytes)
+                           .arg(scope.units);
+        if (scope.units > 0)
+            line += QString(" allocsPerLine=%1 bytesPerLine=%2").arg(scope.allocsPerUnit(), 0, 'f', 2).arg(scope.bytesPerUnit(), 0, 'f', 1);
+        else
+            line += " allocsPerLine=- bytesPerLine=-";
+        lines.append(line);
+    }
+    return lines.join('\n');
+}
+
+/**
+ * @brief LogAllocCounter::dump 输出并清零各作用域的汇总,由PERF_PRINT_END的打点调用
+ */
+void LogAllocCounter::dump()
+{
+    if (!isEnabled())
+        return;
+    const QList<LogAllocScopeStats> scopes = takeScopes();
+    if (scopes.isEmpty())
+        return;
+    Pause pause;
+    for (const QString &line : format(scopes).split('\n'))
+        qCInfo(logAlloc).noquote() << line;
+}
+
+void LogAllocCounter::onAlloc(quint64 bytes)
+{
+    if (t_paused)
+        return;
+    ++t_allocs;
+    t_bytes += bytes;
+    s_allocs.fetch_add(1, std::memory_order_relaxed);
+    s_bytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void LogAllocCounter::onFree()
+{
+    if (t_paused)
+        return;
+    ++t_frees;
+    s_frees.fetch_add(1, std::memory_order_relaxed);
+}
+
+void LogAllocCounter::setHooked()
+{
+    s_hooked.store(true, std::memory_order_relaxed);
+}
+
+LogAllocCounter::Pause::Pause()
+{
+    ++t_paused;
+}
+
+LogAllocCounter::Pause::~Pause()
+{
+    --t_paused;
+}
+
+LogAllocScope::LogAllocScope(const char *name)
+    : m_name(name)
+    , m_hasUnits(false)
+    , m_units(0)
+    , m_beginLines(-1)
+{
+    LogIngestCounters *counters = LogIngestMetrics::current().get();
+    if (counters)
+        m_beginLines = counters->linesParsed.load(std::memory_order_relaxed);
+    m_begin = LogAllocCounter::thread();
+}
+
+LogAllocScope::LogAllocScope(const char *name, quint64 units)
+    : m_name(name)
+    , m_hasUnits(true)
+    , m_units(units)
+    , m_beginLines(-1)
+{
+    m_begin = LogAllocCounter::thread();
+}
+
+/**
+ * @brief LogAllocScope::~LogAllocScope 先取结束计数再记录,记录本身的分配不计入
+ */
+LogAllocScope::~LogAllocScope()
+{
+    const LogAllocStats end = LogAllocCounter::thread();
+    if (!LogAllocCounter::isEnabled())
+        return;
+    LogAllocStats stats;
+    stats.allocs = end.allocs - m_begin.allocs;
+    stats.frees = end.frees - m_begin.frees;
+    stats.bytes = end.bytes - m_begin.bytes;
+
+    quint64 units = m_units;
+    if (!m_hasUnits && m_beginLines >= 0) {
+        LogIngestCounters *counters = LogIngestMetrics::current().get();
+        if (counters)
+            units = static_cast<quint64>(qMax<qint64>(0, counters->linesParsed.load(std::memory_order_relaxed) - m_beginLines));
+    }
+    LogAllocCounter::addScope(m_name, stats, units);
+}
+
+void LogAllocScope::setUnits(quint64 units)
+{
+    m_hasUnits = true;
+    m_units = units;
+}
@@ -0,0 +1,113 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGALLOCCOUNTER_H
+#define LOGALLOCCOUNTER_H
+
+#include <QList>
+#include <QString>
+
+#include <atomic>
+
+#define LOG_ALLOC_CONCAT_IMPL(a, b) a##b
+#define LOG_ALLOC_CONCAT(a, b) LOG_ALLOC_CONCAT_IMPL(a, b)
+#ifdef LOG_ALLOC_COUNT
+/**
+ * @brief PERF_ALLOC_SCOPE 统计当前作用域的分配次数和字节数,name必须是字符串常量;
+ * 行数取当前线程加载计数中解析的行数,需要放在LogIngestScope之后
+ */
+#define PERF_ALLOC_SCOPE(name) \
+    LogAllocScope LOG_ALLOC_CONCAT(logAllocScope, __LINE__)(name)
+/**
+ * @brief PERF_ALLOC_SCOPE_UNITS 同PERF_ALLOC_SCOPE,处理的行数由调用者给出,如插入model的行数
+ */
+#define PERF_ALLOC_SCOPE_UNITS(name, units) \
+    LogAllocScope LOG_ALLOC_CONCAT(logAllocScope, __LINE__)(name, units)
+#else
+#define PERF_ALLOC_SCOPE(name)
+#define PERF_ALLOC_SCOPE_UNITS(name, units)
+#endif
+
+/**
+ * @brief The LogAllocStats struct 分配计数,bytes为申请的字节数
+ */
+struct LogAllocStats {
+    quint64 allocs = 0;
+    quint64 frees = 0;
+    quint64 bytes = 0;
+};
+
+/**
+ * @brief The LogAllocScopeStats struct 一个命名作用域的累计结果,units为处理的行数
+ */
+struct LogAllocScopeStats {
+    QString name;
+    quint64 calls = 0;
+    quint64 allocs = 0;
+    quint64 bytes = 0;
+    quint64 units = 0;
+
+    double allocsPerUnit() const;
+    double bytesPerUnit() const;
+};
+
+/**
+ * @brief The LogAllocCounter class 插桩构建(cmake -DALLOC_COUNT=ON,定义LOG_ALLOC_COUNT)时主程序替换malloc/free,
+ * QString、QList的数据和operator new都经过这里,按进程和线程累计分配次数和字节数;
+ * PERF_ALLOC_SCOPE按名称汇总,PERF_PRINT_END打点时输出汇总并清零。
+ * 普通构建和没有替换分配函数的进程(如插件的使用者)中所有计数为0
+ */
+class LogAllocCounter
+{
+public:
+    static bool isEnabled();
+    static LogAllocStats process();
+    static LogAllocStats thread();
+
+    static void addScope(const char *name, const LogAllocStats &stats, quint64 units);
+    static QList<LogAllocScopeStats> takeScopes();
+    static QString format(const QList<LogAllocScopeStats> &scopes);
+    static void dump();
+
+    //以下只由分配函数的替换(logallochooks.cpp)调用,其中不能再分配内存
+    static void onAlloc(quint64 bytes);
+    static void onFree();
+    static void setHooked();
+
+    /**
+     * @brief The Pause class 作用域内当前线程的分配不计数,用于计数本身的记录
+     */
+    class Pause
+    {
+    public:
+        Pause();
+        ~Pause();
+        Pause(const Pause &) = delete;
+        Pause &operator=(const Pause &) = delete;
+    };
+};
+
+/**
+ * @brief The LogAllocScope class 统计作用域内当前线程的分配,析构时按名称累计到LogAllocCounter
+ */
+class LogAllocScope
+{
+public:
+    explicit LogAllocScope(const char *name);
+    LogAllocScope(const char *name, quint64 units);
+    ~LogAllocScope();
+    LogAllocScope(const LogAllocScope &) = delete;
+    LogAllocScope &operator=(const LogAllocScope &) = delete;
+
+    void setUnits(quint64 units);
+
+private:
+    const char *m_name;
+    bool m_hasUnits;
+    quint64 m_units;
+    qint64 m_beginLines;
+    LogAllocStats m_begin;
+};
+
+#endif // LOGALLOCCOUNTER_H
@@ -0,0 +1,79 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logalloccounter.h"
+
+//只在插桩构建的可执行程序中替换分配函数,插件等动态库不包含本文件
+#ifdef LOG_ALLOC_COUNT
+
+#include <cerrno>
+#include <cstddef>
+
+/**
+ * glibc导出的原始分配函数,替换的malloc等计数后转给它们;
+ * 可执行程序中定义的malloc优先于libc,Qt和libstdc++的分配也经过这里
+ */
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+void *__libc_memalign(size_t alignment, size_t size);
+void __libc_free(void *ptr);
+
+void *malloc(size_t size)
+{
+    LogAllocCounter::setHooked();
+    LogAllocCounter::onAlloc(size);
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size)
+{
+    LogAllocCounter::onAlloc(static_cast<quint64>(count) * size);
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *ptr, size_t size)
+{
+    //原地扩展也算一次分配,频繁追加的QString/QByteArray由此可见
+    LogAllocCounter::onAlloc(size);
+    if (ptr && size == 0)
+        LogAllocCounter::onFree();
+    return __libc_realloc(ptr, size);
+}
+
+void *memalign(size_t alignment, size_t size)
+{
+    LogAllocCounter::onAlloc(size);
+    return __libc_memalign(alignment, size);
+}
+
+void *aligned_alloc(size_t alignment, size_t size)
+{
+    LogAllocCounter::onAlloc(size);
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void **ptr, size_t alignment, size_t size)
+{
+    if (alignment % sizeof(void *) != 0 || (alignment & (alignment - 1)) != 0)
+        return EINVAL;
+    LogAllocCounter::onAlloc(size);
+    void *result = __libc_memalign(alignment, size);
+    if (!result)
+        return ENOMEM;
+    *ptr = result;
+    return 0;
+}
+
+void free(void *ptr)
+{
+    if (!ptr)
+        return;
+    LogAllocCounter::onFree();
+    __libc_free(ptr);
+}
+}
+
+#endif // LOG_ALLOC_COUNT
@@ -4,6 +4,7 @@
 
 #include "logapplicationhelper.h"
 #include "utils.h"
+#include "journalreader.h"
 
 #include <QDebug>
 #include <QDir>
@@ -13,6 +14,10 @@
 #include <QJsonObject>
 #include <QLoggingCategory>
 #include <QDateTime>
+#include <QMutexLocker>
+#include <QSettings>
+#include <QThread>
+#include <QtConcurrent>
 
 #ifdef QT_DEBUG
 Q_LOGGING_CATEGORY(logAppHelper, "org.deepin.log.viewer.application.helper")
@@ -28,6 +33,38 @@ const QString APP_LOG_CONFIG_PATH = "/usr/share/deepin-log-viewer/deepin-log.con
 
 const QString COREDUMP_REPORT_TIME = "coredumpReportTime";
 const QString COREDUMP_REPORT_TIME_GSETTING = "coredumpreporttime";
+const QString COREDUMP_REPORT_CURSOR = "coredumpReportCursor";
+const QString COREDUMP_REPORT_CURSOR_GSETTING = "coredumpreportcursor";
+
+// 应用desktop文件目录
+const QString APP_DESKTOP_PATH = "/usr/share/applications";
+// 应用日志扫描结果缓存,格式变化时增加版本号
+const QString APP_LOG_CACHE_FILE = "applog-cache.conf";
+const int APP_LOG_CACHE_VERSION = 1;
+
+namespace {
+QVariantMap toVariantMap(const QMap<QString, QString> &map)
+{
+    QVariantMap ret;
+    for (auto it = map.constBegin(); it != map.constEnd(); ++it)
+        ret.insert(it.key(), it.value());
+    return ret;
+}
+
+QMap<QString, QString> toStringMap(const QVariantMap &map)
+{
+    QMap<QString, QString> ret;
+    for (auto it = map.constBegin(); it != map.constEnd(); ++it)
+        ret.insert(it.key(), it.value().toString());
+    return ret;
+}
+
+QString appLogHomePath()
+{
+    return Utils::homePath + "/.cache/deepin/";
+}
+}
+
 /**
  * @brief LogApplicationHelper::LogApplicationHelper 构造函数，获取日志文件路径和应用名称
  * @param parent 父对象
@@ -35,37 +72,286 @@ const QString COREDUMP_REPORT_TIME_GSETTING = "coredumpreporttime";
 LogApplicationHelper::LogApplicationHelper(QObject *parent)
     : QObject(parent)
 {
+    connect(&m_scanWatcher, &QFutureWatcher<AppLogScanResult>::finished, this, &LogApplicationHelper::onAppLogScanFinished);
     init();
 }
 
+LogApplicationHelper::~LogApplicationHelper()
+{
+    m_scanWatcher.waitForFinished();
+}
+
 /**
- * @brief LogApplicationHelper::init  初始化数据函数
+ * @brief LogApplicationHelper::init  初始化数据函数,应用日志优先使用有效的缓存,否则在后台扫描
  */
 void LogApplicationHelper::init()
 {
-    initAppLog();
     initOtherLog();
     initCustomLog();
+
+    AppLogScanResult cached;
+    if (loadAppLogCache(&cached))
+        applyAppLog(cached);
+    else
+        startAppLogScan();
 }
 
+/**
+ * @brief LogApplicationHelper::initAppLog 在当前线程同步扫描应用日志并更新缓存
+ */
 void LogApplicationHelper::initAppLog()
 {
-    m_desktop_files.clear();
-    m_log_files.clear();
+    const AppLogScanResult result = scanAppLog(m_other_log_list);
+    applyAppLog(result);
+    saveAppLogCache(result);
+}
+
+/**
+ * @brief LogApplicationHelper::refreshAppLog 依赖的目录有变化时重新扫描应用日志
+ * @param wait 为true时等待扫描结束;界面线程以外的调用方总是等待
+ */
+void LogApplicationHelper::refreshAppLog(bool wait)
+{
+    bool loaded = false;
+    QMap<QString, qint64> stamps;
+    QFuture<AppLogScanResult> future;
+    {
+        QMutexLocker locker(&m_appMutex);
+        loaded = m_appLoaded && m_current_system_language == QLocale::system().name();
+        stamps = m_appStamps;
+        future = m_scanFuture;
+    }
+    if (loaded && isStampValid(stamps))
+        return;
+
+    if (QThread::currentThread() != thread())
+        wait = true;
+    if (!wait) {
+        startAppLogScan();
+    } else if (future.isRunning()) {
+        future.waitForFinished();
+        applyAppLog(future.result());
+    } else {
+        initAppLog();
+    }
+}
+
+/**
+ * @brief LogApplicationHelper::ensureAppLog 还没有任何结果时同步获取,已有结果时直接使用
+ */
+void LogApplicationHelper::ensureAppLog()
+{
+    bool loaded = false;
+    {
+        QMutexLocker locker(&m_appMutex);
+        loaded = m_appLoaded;
+    }
+    if (!loaded)
+        refreshAppLog(true);
+}
+
+/**
+ * @brief LogApplicationHelper::startAppLogScan 在后台线程开始扫描,已在扫描时不重复开始
+ */
+void LogApplicationHelper::startAppLogScan()
+{
+    if (m_scanWatcher.isRunning())
+        return;
+    QFuture<AppLogScanResult> future = QtConcurrent::run(&LogApplicationHelper::scanAppLog, m_other_log_list);
+    {
+        QMutexLocker locker(&m_appMutex);
+        m_scanFuture = future;
+    }
+    m_scanWatcher.setFuture(future);
+}
+
+void LogApplicationHelper::onAppLogScanFinished()
+{
+    const AppLogScanResult result = m_scanWatcher.result();
+    applyAppLog(result);
+    saveAppLogCache(result);
+}
 
-    m_en_log_map.clear();
-    m_en_trans_map.clear();
-    m_trans_log_map.clear();
+/**
+ * @brief LogApplicationHelper::applyAppLog 使用扫描或缓存的结果,应用列表变化时通知界面
+ */
+void LogApplicationHelper::applyAppLog(const AppLogScanResult &result)
+{
+    bool changed = false;
+    {
+        QMutexLocker locker(&m_appMutex);
+        changed = !m_appLoaded || m_trans_log_map != result.transLogMap;
+        m_current_system_language = result.language;
+        m_appStamps = result.stamps;
+        m_desktop_files = result.desktopFiles;
+        m_log_files = result.logFiles;
+        m_en_log_map = result.enLogMap;
+        m_en_trans_map = result.enTransMap;
+        m_trans_log_map = result.transLogMap;
+        m_appLogConfigs = result.configs;
+        m_appLoaded = true;
+    }
+    if (changed)
+        emit appLogsChanged();
+}
 
+/**
+ * @brief LogApplicationHelper::scanAppLog 扫描desktop文件、json配置和日志目录,不访问成员,可在后台线程执行
+ * @param otherLogs 其他日志列表,与其路径相同的应用日志不显示
+ */
+AppLogScanResult LogApplicationHelper::scanAppLog(const QList<QStringList> &otherLogs)
+{
+    AppLogScanResult result;
     // get current system language shortname
-    m_current_system_language = QLocale::system().name();
+    result.language = QLocale::system().name();
+    result.desktop = qgetenv("XDG_CURRENT_DESKTOP");
+    result.stamps.insert(APP_DESKTOP_PATH, dirStamp(APP_DESKTOP_PATH));
+    result.stamps.insert(APP_LOG_CONFIG_PATH, dirStamp(APP_LOG_CONFIG_PATH));
+    result.stamps.insert(appLogHomePath(), dirStamp(appLogHomePath()));
 
     // 加载应用日志配置文件
-    loadAppLogConfigs();
+    result.configs = loadAppLogConfigs();
 
     // get desktop & log files
-    createDesktopFiles();
-    createLogFiles();
+    createDesktopFiles(result);
+    createLogFiles(result);
+
+    QMap<QString, QString>::const_iterator iter = result.enLogMap.constBegin();
+    while (iter != result.enLogMap.constEnd()) {
+        QString displayName = result.enTransMap.value(iter.key());
+        QString logPath = getLogFile(iter.value());
+
+        // 针对journal日志，使用logPath存储项目名称，便于后续解析流程处理
+        if (iter.key() == iter.value()) {
+            logPath = iter.key();
+        } else {
+            //日志目录中新建日志文件时只改变该目录的修改时间
+            result.stamps.insert(iter.value(), dirStamp(iter.value()));
+        }
+
+        //排除其他日志
+        bool bFind = false;
+        for (const QStringList &iterOther : otherLogs) {
+            if (iterOther.at(1) == logPath) {
+                bFind = true;
+                break;
+            }
+        }
+
+        if (!bFind) {
+            result.transLogMap.insert(displayName, logPath);
+        }
+        ++iter;
+    }
+    return result;
+}
+
+/**
+ * @brief LogApplicationHelper::dirStamp 目录的修改时间,不存在时为-1
+ */
+qint64 LogApplicationHelper::dirStamp(const QString &path)
+{
+    QFileInfo fi(path);
+    return fi.exists() ? fi.lastModified().toMSecsSinceEpoch() : -1;
+}
+
+/**
+ * @brief LogApplicationHelper::isStampValid 依赖的目录是否都没有变化
+ */
+bool LogApplicationHelper::isStampValid(const QMap<QString, qint64> &stamps)
+{
+    if (stamps.isEmpty())
+        return false;
+    for (auto it = stamps.constBegin(); it != stamps.constEnd(); ++it) {
+        if (dirStamp(it.key()) != it.value())
+            return false;
+    }
+    return true;
+}
+
+QString LogApplicationHelper::appLogCachePath()
+{
+    return QDir(Utils::getConfigPath()).filePath(APP_LOG_CACHE_FILE);
+}
+
+/**
+ * @brief LogApplicationHelper::loadAppLogCache 读取上次的扫描结果,语言、桌面环境或依赖的目录变化时无效
+ */
+bool LogApplicationHelper::loadAppLogCache(AppLogScanResult *result)
+{
+    if (!result || !QFile::exists(appLogCachePath()))
+        return false;
+
+    QSettings cache(appLogCachePath(), QSettings::IniFormat);
+    if (cache.value("version").toInt() != APP_LOG_CACHE_VERSION
+            || cache.value("language").toString() != QLocale::system().name()
+            || cache.value("desktop").toString() != QString(qgetenv("XDG_CURRENT_DESKTOP")))
+        return false;
+
+    QMap<QString, qint64> stamps;
+    const QVariantMap stampMap = cache.value("stamps").toMap();
+    for (auto it = stampMap.constBegin(); it != stampMap.constEnd(); ++it)
+        stamps.insert(it.key(), it.value().toLongLong());
+    if (!isStampValid(stamps))
+        return false;
+
+    result->language = cache.value("language").toString();
+    result->desktop = cache.value("desktop").toString();
+    result->stamps = stamps;
+    result->desktopFiles = cache.value("desktopFiles").toStringList();
+    result->logFiles = cache.value("logFiles").toStringList();
+    result->enLogMap = toStringMap(cache.value("enLogMap").toMap());
+    result->enTransMap = toStringMap(cache.value("enTransMap").toMap());
+    result->transLogMap = toStringMap(cache.value("transLogMap").toMap());
+    result->configs.clear();
+    for (const QVariant &value : cache.value("configs").toList()) {
+        const QVariantMap object = value.toMap();
+        AppLogConfig config;
+        config.name = object.value("name").toString();
+        config.execPath = object.value("exec").toString();
+        config.logPath = object.value("logPath").toString();
+        config.logType = object.value("logType").toString();
+        config.visible = object.value("visible", true).toBool();
+        result->configs.append(config);
+    }
+    return true;
+}
+
+void LogApplicationHelper::saveAppLogCache(const AppLogScanResult &result)
+{
+    QDir configDir(Utils::getConfigPath());
+    if (!configDir.exists())
+        configDir.mkpath(Utils::getConfigPath());
+
+    QVariantMap stamps;
+    for (auto it = result.stamps.constBegin(); it != result.stamps.constEnd(); ++it)
+        stamps.insert(it.key(), it.value());
+    QVariantList configs;
+    for (const AppLogConfig &config : result.configs) {
+        QVariantMap object;
+        object.insert("name", config.name);
+        object.insert("exec", config.execPath);
+        object.insert("logPath", config.logPath);
+        object.insert("logType", config.logType);
+        object.insert("visible", config.visible);
+        configs.append(object);
+    }
+
+    QSettings cache(appLogCachePath(), QSettings::IniFormat);
+    cache.clear();
+    cache.setValue("version", APP_LOG_CACHE_VERSION);
+    cache.setValue("language", result.language);
+    cache.setValue("desktop", result.desktop);
+    cache.setValue("stamps", stamps);
+    cache.setValue("desktopFiles", result.desktopFiles);
+    cache.setValue("logFiles", result.logFiles);
+    cache.setValue("enLogMap", toVariantMap(result.enLogMap));
+    cache.setValue("enTransMap", toVariantMap(result.enTransMap));
+    cache.setValue("transLogMap", toVariantMap(result.transLogMap));
+    cache.setValue("configs", configs);
+    cache.sync();
+    if (cache.status() != QSettings::NoError)
+        qCWarning(logAppHelper) << "save application log cache failed:" << appLogCachePath();
 }
 
 void LogApplicationHelper::initOtherLog()
@@ -153,6 +439,7 @@ void LogApplicationHelper::initOtherLog()
 void LogApplicationHelper::initCustomLog()
 {
     m_custom_log_list.clear();
+    m_customLogFormats.clear();
 
 #ifdef DTKCORE_CLASS_DConfigFile
     //初始化DConfig配置
@@ -188,10 +475,52 @@ void LogApplicationHelper::initCustomLog()
         }
         m_custom_log_list.append(QStringList() << QFileInfo(iter).fileName() << path);
     }
+    //自定义日志的行格式,路径到格式说明
+    if (m_pDConfig->keyList().contains("customLogFormats")) {
+        const QVariantMap formats = m_pDConfig->value("customLogFormats").toMap();
+        for (auto it = formats.cbegin(); it != formats.cend(); ++it) {
+            QString path = it.key();
+            if (path.startsWith("~/"))
+                path.replace(0, 1, Utils::homePath);
+            QString error;
+            const LogLineFormatPtr format = LogLineFormat::compile(it.value().toString(), &error);
+            if (!format) {
+                qCWarning(logAppHelper) << "invalid custom log format for" << path << ":" << error;
+                continue;
+            }
+            m_customLogFormats.insert(path, format);
+        }
+    }
 
     //需要查询是否是特殊机型，例如hw机型
     if(m_pDConfig->keyList().contains("specialComType"))
         Utils::specialComType = m_pDConfig->value("specialComType").toInt();
+    //性能档位只在启动时应用一次,获取线程运行中读取的批大小和线程数不能中途改变
+    static bool profileApplied = false;
+    if (!profileApplied) {
+        profileApplied = true;
+        const QString profileName = m_pDConfig->keyList().contains("performanceProfile")
+                                        ? m_pDConfig->value("performanceProfile").toString()
+                                        : QString(LOG_PERFORMANCE_DEFAULT_PROFILE);
+        const QVariantMap overrides = m_pDConfig->keyList().contains("performanceOverrides")
+                                          ? m_pDConfig->value("performanceOverrides").toMap()
+                                          : QVariantMap();
+        LogPerformanceProfile::setCurrent(LogPerformanceProfile::fromConfig(profileName, overrides));
+        LogPerformanceProfile::applyToScheduler();
+        //收集来的journal目录,命令行已经指定时不覆盖
+        if (m_pDConfig->keyList().contains("journalDirectories") && JournalReaderBase::sourceDirectories().isEmpty())
+            JournalReaderBase::setSourceDirectories(m_pDConfig->value("journalDirectories").toStringList());
+    }
+    //日志类别缓存的内存上限,小于0时跟随性能档位
+    Utils::categoryCacheSize = LogPerformanceProfile::current().categoryCacheMB;
+    if (m_pDConfig->keyList().contains("categoryCacheSize")) {
+        const int cacheSize = m_pDConfig->value("categoryCacheSize").toInt();
+        if (cacheSize >= 0)
+            Utils::categoryCacheSize = cacheSize;
+    }
+    //内核日志来源
+    if (m_pDConfig->keyList().contains("kernLogSource"))
+        Utils::kernLogSource = m_pDConfig->value("kernLogSource").toString();
 #endif
 
     //初始化gsetting配置
@@ -226,10 +555,10 @@ void LogApplicationHelper::initCustomLog()
 /**
  * @brief LogApplicationHelper::createDesktopFiles 通过所有符合条件的destop文件获得包名和对应的应用文本
  */
-void LogApplicationHelper::createDesktopFiles()
+void LogApplicationHelper::createDesktopFiles(AppLogScanResult &result)
 {
     //在该目录下遍历所有desktop文件
-    QString path = "/usr/share/applications";
+    QString path = APP_DESKTOP_PATH;
     QDir dir(path);
     if (!dir.exists())
         return;
@@ -277,7 +606,7 @@ void LogApplicationHelper::createDesktopFiles()
                     canDisplay = false;
                 }
             }
-            QString currentDesktop(qgetenv("XDG_CURRENT_DESKTOP"));
+            QString currentDesktop(result.desktop);
             if (lineStr.startsWith("OnlyShowIn")) {
                 QString onlyShowValue = lineStr.split("=", QString::SkipEmptyParts).value(1, "");
                 if (onlyShowValue.contains(currentDesktop)) {
@@ -297,7 +626,7 @@ void LogApplicationHelper::createDesktopFiles()
             }
 
             // 子应用日志可控制自己的日志的是否在日志收集工具中显示
-            AppLogConfig applogConfig = appLogConfig(Utils::appName(filePath));
+            AppLogConfig applogConfig = findAppLogConfig(result.configs, Utils::appName(filePath));
             if (applogConfig.isValid())
                 canDisplay = applogConfig.visible;
 
@@ -319,8 +648,8 @@ void LogApplicationHelper::createDesktopFiles()
         fi.close();
         //转换插入应用包名和应用显示文本到数据结构
         if (canDisplay) {
-            m_desktop_files.append(var);
-            parseField(filePath, var.split(QDir::separator()).last(), isDeepin, isGeneric, isName);
+            result.desktopFiles.append(var);
+            parseField(result, filePath, var.split(QDir::separator()).last(), isDeepin, isGeneric, isName);
         }
     }
 }
@@ -328,35 +657,35 @@ void LogApplicationHelper::createDesktopFiles()
 /**
  * @brief LogApplicationHelper::createLogFiles 根据找到的符合要求的desktop文件的应用去初始化应用日志文件路径
  */
-void LogApplicationHelper::createLogFiles()
+void LogApplicationHelper::createLogFiles(AppLogScanResult &result)
 {
     QString homePath = Utils::homePath;
     if (homePath.isEmpty()) {
         return;
     }
-    QString path = homePath + "/.cache/deepin/";
+    QString path = appLogHomePath();
     QDir appDir(path);
     if (!appDir.exists()) {
         return;
     }
 
-    m_log_files = appDir.entryList(QDir::AllDirs | QDir::NoDotAndDotDot);
+    result.logFiles = appDir.entryList(QDir::AllDirs | QDir::NoDotAndDotDot);
 
-    for (auto i = 0; i < m_desktop_files.count(); ++i) {
-        QString desktopName = m_desktop_files[i].split(QDir::separator()).last();
+    for (auto i = 0; i < result.desktopFiles.count(); ++i) {
+        QString desktopName = result.desktopFiles[i].split(QDir::separator()).last();
         QString _name = desktopName.mid(0, desktopName.lastIndexOf("."));
         // 默认在~/.cache/deepin目录下取自研应用日志路径
-        for (auto j = 0; j < m_log_files.count(); ++j) {
+        for (auto j = 0; j < result.logFiles.count(); ++j) {
             //desktop文件名和日志文件名比较，相同则符合条件
-            if (_name == m_log_files[j]) {
-                QString logPath = path + m_log_files[j];
-                m_en_log_map.insert(_name, logPath);
+            if (_name == result.logFiles[j]) {
+                QString logPath = path + result.logFiles[j];
+                result.enLogMap.insert(_name, logPath);
                 break;
             }
         }
 
         // 若该自研应用在json配置文件
-        AppLogConfig appConfig = appLogConfig(_name);
+        AppLogConfig appConfig = findAppLogConfig(result.configs, _name);
         if (appConfig.isValid()) {
             if (appConfig.logType == "file") {
                 // 若该自研应用在file方式下配置有有效的日志路径，则按自研应用的日志路径来加载日志
@@ -369,28 +698,28 @@ void LogApplicationHelper::createLogFiles()
                     QFileInfo fi(appConfig.logPath);
                     if (fi.exists()) {
                         if (fi.isDir())
-                            m_en_log_map.insert(_name, appConfig.logPath);
+                            result.enLogMap.insert(_name, appConfig.logPath);
                         else if (fi.isFile())
-                            m_en_log_map.insert(_name, fi.absolutePath());
+                            result.enLogMap.insert(_name, fi.absolutePath());
                     }
                 }
 
                 // 应用未配置有效的日志路径，并且配置文件中visible为真，遵循配置文件优先级最高原则，在"应用列表“显示该应用
-                if (m_en_log_map.find(_name) == m_en_log_map.end() && appConfig.visible) {
+                if (result.enLogMap.find(_name) == result.enLogMap.end() && appConfig.visible) {
                     if (appConfig.logPath.isEmpty())
-                        m_en_log_map.insert(_name, path + _name);
+                        result.enLogMap.insert(_name, path + _name);
                     else {
                         QString tmpText = appConfig.logPath.mid(appConfig.logPath.lastIndexOf('/') + 1);
                         if (tmpText.contains('.'))
-                            m_en_log_map.insert(_name, appConfig.logPath.mid(0, appConfig.logPath.lastIndexOf('/')));
+                            result.enLogMap.insert(_name, appConfig.logPath.mid(0, appConfig.logPath.lastIndexOf('/')));
                         else
-                            m_en_log_map.insert(_name, appConfig.logPath);
+                            result.enLogMap.insert(_name, appConfig.logPath);
                     }
                 }
             } else if (appConfig.logType == "journal") {
 #if (DTK_VERSION >= DTK_VERSION_CHECK(5, 6, 8, 0))
                 // 若该自研应用配置为journal方式解析，则将项目名填入log_map，便于后续解析流程处理
-                m_en_log_map.insert(_name, _name);
+                result.enLogMap.insert(_name, _name);
 #endif
             }
         }
@@ -405,7 +734,7 @@ void LogApplicationHelper::createLogFiles()
  * @param isGeneric 是否有GenericName字段
  * @param isName 是否有Name字段
  */
-void LogApplicationHelper::parseField(const QString &path, const QString &name, bool isDeepin, bool isGeneric,
+void LogApplicationHelper::parseField(AppLogScanResult &result, const QString &path, const QString &name, bool isDeepin, bool isGeneric,
                                       bool isName)
 {
     Q_UNUSED(isName)
@@ -413,7 +742,7 @@ void LogApplicationHelper::parseField(const QString &path, const QString &name,
     if (!fi.open(QIODevice::ReadOnly)) {
         return;
     }
-    m_en_trans_map.insert(name.mid(0, name.lastIndexOf(".")), name.mid(0, name.lastIndexOf("."))); // desktop name
+    result.enTransMap.insert(name.mid(0, name.lastIndexOf(".")), name.mid(0, name.lastIndexOf("."))); // desktop name
     if (name.contains("shutdown")) {
     }
     while (!fi.atEnd()) {
@@ -445,15 +774,15 @@ void LogApplicationHelper::parseField(const QString &path, const QString &name,
         QString leftStr = gNameList[0];
         QString genericName = gNameList[1];
         if (leftStr.split("_").count() == 2) {
-            if (leftStr.contains(m_current_system_language)) {
-                m_en_trans_map.insert(name.mid(0, name.lastIndexOf(".")), genericName);
+            if (leftStr.contains(result.language)) {
+                result.enTransMap.insert(name.mid(0, name.lastIndexOf(".")), genericName);
                 break;
             }
-        } else if (leftStr.contains(m_current_system_language.split("_")[0])) {
-            m_en_trans_map.insert(name.mid(0, name.lastIndexOf(".")), genericName);
+        } else if (leftStr.contains(result.language.split("_")[0])) {
+            result.enTransMap.insert(name.mid(0, name.lastIndexOf(".")), genericName);
             break;
         } else if (0 == leftStr.compare("GenericName", Qt::CaseInsensitive) || 0 == leftStr.compare("Name", Qt::CaseInsensitive)) {
-            m_en_trans_map.insert(name.mid(0, name.lastIndexOf(".")), genericName); // GenericName=xxxx
+            result.enTransMap.insert(name.mid(0, name.lastIndexOf(".")), genericName); // GenericName=xxxx
         }
     }
 }
@@ -482,14 +811,14 @@ QString LogApplicationHelper::getLogFile(const QString &path)
     return ret;
 }
 
-void LogApplicationHelper::loadAppLogConfigs()
+AppLogConfigList LogApplicationHelper::loadAppLogConfigs()
 {
-    m_appLogConfigs.clear();
+    AppLogConfigList configs;
 
     QDir dir(APP_LOG_CONFIG_PATH);
     if (!dir.exists()) {
         qCWarning(logAppHelper) << QString("%1 does not exist.").arg(APP_LOG_CONFIG_PATH);
-        return;
+        return configs;
     }
 
     dir.setFilter(QDir::Files);
@@ -532,40 +861,22 @@ void LogApplicationHelper::loadAppLogConfigs()
                     logConfig.logType = object.value("logType").toString();
                 }
 
-                m_appLogConfigs.push_back(logConfig);
+                configs.push_back(logConfig);
             }
         }
     }
+    return configs;
 }
 
-//刷新并返回所有显示文本对应的应用日志路径
-QMap<QString, QString> LogApplicationHelper::getMap()
+/**
+ * @brief LogApplicationHelper::getMap 返回所有显示文本对应的应用日志路径,依赖的目录有变化时重新扫描
+ * @param wait 为false时在后台扫描,先返回当前结果,扫描结束后发出appLogsChanged;为true时等待扫描结束
+ */
+QMap<QString, QString> LogApplicationHelper::getMap(bool wait)
 {
-    initAppLog();
-
-    QMap<QString, QString>::const_iterator iter = m_en_log_map.constBegin();
-    while (iter != m_en_log_map.constEnd()) {
-        QString displayName = m_en_trans_map.value(iter.key());
-        QString logPath = getLogFile(iter.value());
-
-        // 针对journal日志，使用logPath存储项目名称，便于后续解析流程处理
-        if (iter.key() == iter.value())
-            logPath = iter.key();
-
-        //排除其他日志
-        bool bFind = false;
-        for (QStringList iterOther : getOtherLogList()) {
-            if (iterOther.at(1) == logPath) {
-                bFind = true;
-                break;
-            }
-        }
+    refreshAppLog(wait);
 
-        if (!bFind) {
-            m_trans_log_map.insert(displayName, logPath);
-        }
-        ++iter;
-    }
+    QMutexLocker locker(&m_appMutex);
     return m_trans_log_map;
 }
 
@@ -581,16 +892,31 @@ QList<QStringList> LogApplicationHelper::getCustomLogList()
     return m_custom_log_list;
 }
 
+//获取自定义日志声明的行格式
+LogLineFormatPtr LogApplicationHelper::customLogFormat(const QString &path) const
+{
+    return m_customLogFormats.value(path);
+}
+
 AppLogConfig LogApplicationHelper::appLogConfig(const QString &app)
 {
     if (app.isEmpty())
         return AppLogConfig();
 
+    QMutexLocker locker(&m_appMutex);
     if (m_appLogConfigs.isEmpty()) {
-        loadAppLogConfigs();
+        m_appLogConfigs = loadAppLogConfigs();
     }
 
-    foreach (AppLogConfig config, m_appLogConfigs) {
+    return findAppLogConfig(m_appLogConfigs, app);
+}
+
+AppLogConfig LogApplicationHelper::findAppLogConfig(const AppLogConfigList &configs, const QString &app)
+{
+    if (app.isEmpty())
+        return AppLogConfig();
+
+    foreach (AppLogConfig config, configs) {
         if (config.contains(app)) {
             return config;
         }
@@ -601,6 +927,9 @@ AppLogConfig LogApplicationHelper::appLogConfig(const QString &app)
 
 bool LogApplicationHelper::isValidAppName(const QString &appName)
 {
+    ensureAppLog();
+
+    QMutexLocker locker(&m_appMutex);
     if (m_en_log_map.find(appName) != m_en_log_map.end())
         return true;
 
@@ -638,13 +967,47 @@ void LogApplicationHelper::saveLastRerportTime(const QDateTime &date)
 #endif
 }
 
+/**
+ * @brief LogApplicationHelper::getLastReportCursor 最近一次上报成功的最后一条崩溃记录的journal游标
+ */
+QString LogApplicationHelper::getLastReportCursor()
+{
+    QVariant cursor;
+
+#ifdef DTKCORE_CLASS_DConfigFile
+    cursor = m_pDConfig->value(COREDUMP_REPORT_CURSOR);
+#else
+    if (m_pGSettings) {
+        cursor = m_pGSettings->get(COREDUMP_REPORT_CURSOR_GSETTING);
+    }
+#endif
+
+    return cursor.toString();
+}
+
+void LogApplicationHelper::saveLastReportCursor(const QString &cursor)
+{
+#ifdef DTKCORE_CLASS_DConfigFile
+    m_pDConfig->setValue(COREDUMP_REPORT_CURSOR, cursor);
+#else
+    if (m_pGSettings)
+        m_pGSettings->set(COREDUMP_REPORT_CURSOR_GSETTING, cursor);
+#endif
+}
+
 //从应用包名转换为应用显示文本
 QString LogApplicationHelper::transName(const QString &str)
 {
+    ensureAppLog();
+
+    QMutexLocker locker(&m_appMutex);
     return m_en_trans_map.value(str);
 }
 
 QString LogApplicationHelper::getPathByAppId(const QString &str)
 {
+    ensureAppLog();
+
+    QMutexLocker locker(&m_appMutex);
     return m_en_log_map.value(str);
 }
@@ -6,19 +6,49 @@
 #define LOGAPPLICATIONHELPER_H
 
 #include "structdef.h"
+#include "loglineformat.h"
 #include "dtkcore_config.h"
 #ifdef DTKCORE_CLASS_DConfigFile
 #include <DConfig>
 #endif
 
+#include <QFuture>
+#include <QFutureWatcher>
 #include <QMap>
+#include <QMutex>
 #include <QObject>
 #include <QGSettings/QGSettings>
 
 #include <mutex>
 
+/**
+ * @brief The AppLogScanResult struct 一次应用日志扫描的结果,在后台线程中生成并持久化缓存
+ */
+struct AppLogScanResult {
+    /**
+     * @brief language 扫描时的系统语言,决定应用显示文本
+     */
+    QString language;
+    /**
+     * @brief desktop 扫描时的XDG_CURRENT_DESKTOP,决定OnlyShowIn/NotShowIn的结果
+     */
+    QString desktop;
+    /**
+     * @brief stamps 扫描依赖的目录-修改时间(毫秒),目录不存在时为-1,任一变化时缓存失效
+     */
+    QMap<QString, qint64> stamps;
+    QStringList desktopFiles;
+    QStringList logFiles;
+    QMap<QString, QString> enLogMap;
+    QMap<QString, QString> enTransMap;
+    QMap<QString, QString> transLogMap;
+    AppLogConfigList configs;
+};
+
 /**
  * @brief The LogApplicationHelper class 获取应用日志文件路径信息工具类
+ * 应用日志的扫描(desktop文件、json配置和日志目录)在后台进行,结果按目录修改时间缓存到配置目录,
+ * 启动时缓存有效则直接使用;扫描结果变化时发出appLogsChanged
  */
 class LogApplicationHelper : public QObject
 {
@@ -43,7 +73,7 @@ public:
         return sin;
     }
 
-    QMap<QString, QString> getMap();
+    QMap<QString, QString> getMap(bool wait = false);
 
     //根据包名获得显示名称
     QString transName(const QString &str);
@@ -56,6 +86,8 @@ public:
 
     //获取所有自定义日志文件列表(名称-路径)
     QList<QStringList> getCustomLogList();
+    //获取自定义日志声明的行格式,没有声明时为空
+    LogLineFormatPtr customLogFormat(const QString &path) const;
 
     AppLogConfig  appLogConfig(const QString& app);
 
@@ -64,26 +96,49 @@ public:
 
     QDateTime getLastReportTime();
     void saveLastRerportTime(const QDateTime& date);
+    QString getLastReportCursor();
+    void saveLastReportCursor(const QString& cursor);
 
 private:
     explicit LogApplicationHelper(QObject *parent = nullptr);
+    ~LogApplicationHelper() override;
 
     void init();
     void initAppLog();
     void initOtherLog();
     void initCustomLog();
 
-    void createDesktopFiles();
-    void createLogFiles();
+    void refreshAppLog(bool wait);
+    void ensureAppLog();
+    void startAppLogScan();
+    void applyAppLog(const AppLogScanResult &result);
 
-    void parseField(const QString &path, const QString &name, bool isDeepin, bool isGeneric, bool isName);
+    static AppLogScanResult scanAppLog(const QList<QStringList> &otherLogs);
+    static void createDesktopFiles(AppLogScanResult &result);
+    static void createLogFiles(AppLogScanResult &result);
 
-    QString getLogFile(const QString &path);
+    static void parseField(AppLogScanResult &result, const QString &path, const QString &name, bool isDeepin, bool isGeneric, bool isName);
 
-    void loadAppLogConfigs();
+    static QString getLogFile(const QString &path);
+
+    static AppLogConfigList loadAppLogConfigs();
+    static AppLogConfig findAppLogConfig(const AppLogConfigList &configs, const QString &app);
+
+    static qint64 dirStamp(const QString &path);
+    static bool isStampValid(const QMap<QString, qint64> &stamps);
+    static QString appLogCachePath();
+    static bool loadAppLogCache(AppLogScanResult *result);
+    static void saveAppLogCache(const AppLogScanResult &result);
 
 signals:
     void sigValueChanged(const QString &key);
+    /**
+     * @brief appLogsChanged 后台扫描结束且应用日志列表发生变化
+     */
+    void appLogsChanged();
+
+private slots:
+    void onAppLogScanFinished();
 
 public slots:
 
@@ -108,6 +163,10 @@ private:
      * @brief m_custom_log_list 所有自定义日志列表，每项包含名称、路径
      */
     QList<QStringList> m_custom_log_list;
+    /**
+     * @brief m_customLogFormats 自定义日志路径到编译好的行格式,来自配置customLogFormats
+     */
+    QMap<QString, LogLineFormatPtr> m_customLogFormats;
     /**
      * @brief m_desktop_files 所有符合条件的应用的desktop文件路径
      */
@@ -125,6 +184,23 @@ private:
      * @brief m_appLogConfigs 应用日志配置信息
      */
     AppLogConfigList m_appLogConfigs;
+    /**
+     * @brief m_appStamps 当前应用日志结果依赖的目录修改时间
+     */
+    QMap<QString, qint64> m_appStamps;
+    /**
+     * @brief m_appLoaded 是否已有扫描或缓存的应用日志结果
+     */
+    bool m_appLoaded = false;
+    /**
+     * @brief m_appMutex 保护应用日志结果,导出线程和命令行会在其他线程读取
+     */
+    mutable QMutex m_appMutex;
+    /**
+     * @brief m_scanFuture 正在进行的后台扫描,其他线程需要结果时等待它结束
+     */
+    QFuture<AppLogScanResult> m_scanFuture;
+    QFutureWatcher<AppLogScanResult> m_scanWatcher;
     /**
      * @brief m_instance 单例用的本类指针的原子性封装
      */
@@ -3,12 +3,20 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "logapplicationparsethread.h"
+#include "logcanceltoken.h"
 #include "utils.h"
 #include "dbusproxy/dldbushandler.h"
+#include "loglinestream.h"
+#include "loglongmessage.h"
+#include "logtimeindex.h"
+#include "logparsematchers.h"
+#include "loglevel.h"
+#include "loglocaltime.h"
+#include "logtracer.h"
+#include "logworkscheduler.h"
 
 #include <DMessageBox>
 
-#include <QDateTime>
 #include <QDebug>
 #include <QProcess>
 
@@ -34,7 +42,6 @@ LogApplicationParseThread::LogApplicationParseThread(QObject *parent)
 {
     qRegisterMetaType<QList<LOG_MSG_APPLICATOIN> >("QList<LOG_MSG_APPLICATOIN>");
 
-    initMap();
     //静态计数变量加一并赋值给本对象的成员变量，以供外部判断是否为最新线程发出的数据信号
     thread_count++;
     m_threadCount = thread_count;
@@ -80,36 +87,136 @@ int LogApplicationParseThread::getIndex()
 
 /**
  * @brief LogApplicationParseThread::doWork 获取数据线程逻辑
+ * 第一个(最新的)文件在本线程中边解析边发出,其余的转储、分割文件同时在界面加载的线程池中解析,
+ * 按文件顺序依次发出,结果和逐个解析一致
  */
 void LogApplicationParseThread::doWork()
 {
+    PERF_TRACE_SCOPE("parse", "LogApplicationParseThread");
+    LogIngestScope ingest(m_ingest, true);
+    LogCancelScope cancel(m_canRun);
     //此线程刚开始把可以继续变量置true，不然下面没法跑
     m_canRun = true;
     m_appList.clear();
+    m_batchSizer.reset();
     initProccess();
     //connect(m_process, SIGNAL(finished(int)), m_process, SLOT(deleteLater()));
     //因为筛选信息中含有日志文件路径，所以不能为空，否则无法获取
     if (m_AppFiler.path.isEmpty()) {  //modified by Airy for bug 20457::if path is empty,item is not empty
         emit appFinished(m_threadCount);
     } else {
-        QStringList filePath = DLDBusHandler::instance(this)->getFileInfo(m_AppFiler.path);
-        for (int i = 0; i < filePath.count(); i++) {
-            if (!m_canRun) {
+        QStringList filePath = DLDBusHandler::instance(this)->getFileInfo(m_AppFiler.path, false);
+        //同时在后台解析的文件数,最多占满界面加载的线程池
+        const int window = qMin(LOG_APP_PARSE_AHEAD, LogWorkScheduler::instance()->maxThreads(LogWorkScheduler::Interactive));
+        QVector<QFuture<QList<LOG_MSG_APPLICATOIN>>> pending(filePath.count());
+        auto startFile = [this, &filePath, &pending](int i) {
+            if (i >= filePath.count())
                 return;
+            const QString path = filePath.at(i);
+            pending[i] = LogWorkScheduler::instance()->run(LogWorkScheduler::Interactive, [this, path]() {
+                LogIngestScope ingest(m_ingest);
+                LogCancelScope cancel(m_canRun);
+                QList<LOG_MSG_APPLICATOIN> list;
+                parseFile(path, [&list](LOG_MSG_APPLICATOIN &msg) {
+                    list.append(msg);
+                });
+                return list;
+            });
+        };
+        //后台任务引用了本对象,被停止时也要等它们结束再返回
+        auto waitPending = [&pending]() {
+            for (auto &future : pending)
+                future.waitForFinished();
+        };
+        for (int i = 1; i <= window; ++i)
+            startFile(i);
+
+        auto append = [this](LOG_MSG_APPLICATOIN &msg) {
+            m_appList.append(msg);
+            //每满一批(大小随读取速度调整)就发出信号给控件加载
+            if (m_batchSizer.isFull(m_appList)) {
+                emit appData(m_threadCount, m_appList);
+                m_appList.clear();
+                m_batchSizer.delivered();
             }
-            //按行解析
-            QByteArray outByte = DLDBusHandler::instance(this)->readLog(filePath[i]).toUtf8();
-            QString output = Utils::replaceEmptyByteArray(outByte);
-            QStringList strList = QString(output ).split('\n', QString::SkipEmptyParts);
-            //开启贪婪匹配
-            QRegularExpression re("^(\\d{4}-[0-2]\\d-[0-3]\\d)\\D*([0-2]\\d:[0-5]\\d:[0-5]\\d.\\d*)[^A-Za-z]*([A-Za-z]*)[^\\[]*[^\\]]*\\]*\\s*(.*)$");
-
-            for (int j = strList.size() - 1; j >= 0; --j) {
-                if (!m_canRun) {
-                    return;
-                }
-                LOG_MSG_APPLICATOIN msg;
-                QString str = strList[j];
+        };
+        if (!filePath.isEmpty())
+            parseFile(filePath.first(), append);
+        for (int i = 1; i < filePath.count() && m_canRun; i++) {
+            //等待时优先在本线程中运行还没开始的任务,线程池占满时也不会互相等待
+            QList<LOG_MSG_APPLICATOIN> list = pending[i].result();
+            pending[i] = QFuture<QList<LOG_MSG_APPLICATOIN>>();
+            startFile(i + window);
+            for (LOG_MSG_APPLICATOIN &msg : list)
+                append(msg);
+        }
+        waitPending();
+        if (!m_canRun) {
+            return;
+        }
+        //最后可能有余下不足一批的数据
+        if (m_appList.count() >= 0) {
+            emit appData(m_threadCount, m_appList);
+        }
+
+        emit appFinished(m_threadCount);
+    }
+}
+
+/**
+ * @brief LogApplicationParseThread::parseFile 解析一个应用日志文件,可在多个线程中同时调用
+ * @param path 文件路径
+ * @param sink 按筛选条件保留下来的每一条记录,从新到旧
+ * @return 是否完整解析,被停止时返回false
+ */
+bool LogApplicationParseThread::parseFile(const QString &path, const std::function<void(LOG_MSG_APPLICATOIN &)> &sink)
+{
+    const bool timeFiltered = m_AppFiler.timeFilterBegin > 0 && m_AppFiler.timeFilterEnd > 0;
+    const bool levelFiltered = m_AppFiler.lvlFilter != LVALL;
+    //按块从新到旧解析,用户可读的应用日志直接在进程内映射读取
+    LogLineStream stream(path, this);
+    //过长的信息只保存前缀,记下行的位置用于读取完整内容
+    stream.setRecordSpans(true);
+    //DTK应用按时间顺序写日志,有时间段筛选时先二分定位到时间段所在的部分,只解析这一段
+    if (timeFiltered && stream.openDirect()) {
+        stream.seekTimeRange(m_AppFiler.timeFilterBegin, m_AppFiler.timeFilterEnd, [](const QString &line) {
+            LogLinePrefix prefix;
+            return LogParseMatchers::scanAppPrefix(line, prefix) ? prefix.time : qint64(-1);
+        }, LOG_TIME_INDEX_APP);
+    }
+    QStringList strList;
+    //开启贪婪匹配,只用于按位置识别不了的行
+    static const QRegularExpression re("^(\\d{4}-[0-2]\\d-[0-3]\\d)\\D*([0-2]\\d:[0-5]\\d:[0-5]\\d.\\d*)[^A-Za-z]*([A-Za-z]*)[^\\[]*[^\\]]*\\]*\\s*(.*)$");
+
+    while (stream.readChunk(strList)) {
+        for (int j = 0; j < strList.size(); ++j) {
+            if (!m_canRun) {
+                return false;
+            }
+            LOG_MSG_APPLICATOIN msg;
+            QString str = strList[j];
+            //行首到信息开始的字符数
+            int msgBegin = 0;
+
+            //DTK格式的行按位置取出时间、等级和信息,不做正则匹配和时间字符串解析
+            LogLinePrefix prefix;
+            if (LogParseMatchers::scanAppLine(str, prefix)) {
+                if (timeFiltered && (prefix.time < m_AppFiler.timeFilterBegin || prefix.time > m_AppFiler.timeFilterEnd))
+                    continue;
+                //行中的等级名直接比较,不构造中间字符串
+                const int level = LogLevel::fromName(prefix.level(str));
+                if (levelFiltered && level != m_AppFiler.lvlFilter)
+                    continue;
+                msg.dateTime = str.left(10);
+                msg.dateTime.append(QLatin1Char(' ')).append(str.midRef(prefix.timeBegin, prefix.timeEnd - prefix.timeBegin));
+                msg.level = level;
+                msgBegin = prefix.restBegin;
+                msg.msg = str.mid(msgBegin);
+            } else {
+                //其余的行按正则处理,有筛选条件时仍先按行首的等级过滤
+                if (levelFiltered && LogParseMatchers::scanAppPrefix(str, prefix)
+                        && LogLevel::fromName(prefix.level(str)) != m_AppFiler.lvlFilter)
+                    continue;
 
                 QRegularExpressionMatch match = re.match(str);
                 bool matchRes = match.hasMatch();
@@ -118,48 +225,41 @@ void LogApplicationParseThread::doWork()
                 }
 
                 QString dateTime = match.captured(1)+" "+match.captured(2);
-                qint64 dt = QDateTime::fromString(dateTime, "yyyy-MM-dd hh:mm:ss.zzz").toMSecsSinceEpoch();
+                qint64 dt = LogLocalTime::parse(dateTime);
                 //按筛选条件筛选时间段
-                if (m_AppFiler.timeFilterBegin > 0 && m_AppFiler.timeFilterEnd > 0) {
+                if (timeFiltered) {
                     if (dt < m_AppFiler.timeFilterBegin || dt > m_AppFiler.timeFilterEnd)
                         continue;
                 }
 
                 msg.dateTime = dateTime;
-                msg.level = match.captured(3);
+                msg.level = LogLevel::fromName(match.capturedRef(3));
                 //筛选日志等级
-                if (m_AppFiler.lvlFilter != LVALL) {
-                    if (m_levelDict.value(msg.level) != m_AppFiler.lvlFilter)
+                if (levelFiltered) {
+                    if (msg.level != m_AppFiler.lvlFilter)
                         continue;
                 }
                 //获取信息
-                msg.msg=match.captured(4);
-                msg.detailInfo=match.captured(4);
+                msgBegin = match.capturedStart(4);
+                msg.msg = match.captured(4);
+            }
 
-                //如果日志太长就显示一部分
-                if (msg.detailInfo.size() > 500) {
-                    msg.msg = msg.detailInfo.mid(0, 500);
-                }
-                m_appList.append(msg);
-                //每获得500个数据就发出信号给控件加载
-                if (m_appList.count() % SINGLE_READ_CNT == 0) {
-                    emit appData(m_threadCount, m_appList);
-                    m_appList.clear();
+            //如果日志太长就显示一部分
+            if (msg.msg.size() > LOG_LONG_MESSAGE_PREFIX) {
+                LOG_MESSAGE_REF ref;
+                const QVector<LogLineSpan> &spans = stream.lineSpans();
+                if (spans.size() == strList.size()) {
+                    ref.path = path;
+                    ref.offset = spans.at(j).offset;
+                    ref.length = spans.at(j).length;
+                    ref.skip = msgBegin;
                 }
+                LogLongMessage::shorten(msg, ref);
             }
-            if (!m_canRun) {
-                return;
-            }
-        }
-        //最后可能有余下不足500的数据
-        if (m_appList.count() >= 0) {
-            emit appData(m_threadCount, m_appList);
+            sink(msg);
         }
-
-        emit appFinished(m_threadCount);
     }
-
-
+    return m_canRun;
 }
 
 void LogApplicationParseThread::onProcFinished(int ret)
@@ -167,17 +267,6 @@ void LogApplicationParseThread::onProcFinished(int ret)
     Q_UNUSED(ret)
 }
 
-/**
- * @brief LogApplicationParseThread::initMap 初始化数据结构
- */
-void LogApplicationParseThread::initMap()
-{
-    m_levelDict.insert("Warning", WARN);
-    m_levelDict.insert("Debug", DEB);
-    m_levelDict.insert("Info", INF);
-    m_levelDict.insert("Error", ERR);
-}
-
 /**
  * @brief LogApplicationParseThread::initProccess 构造 QProcess成员指针
  */
@@ -5,13 +5,20 @@
 #ifndef LOGAPPLICATIONPARSETHREAD_H
 #define LOGAPPLICATIONPARSETHREAD_H
 #include "structdef.h"
+#include "logingestmetrics.h"
+#include "logbatchsizer.h"
 
 #include <QMap>
 #include <QObject>
 #include <QThread>
 
+#include <atomic>
+#include <functional>
 #include <mutex>
 
+//除正在发出的文件外,最多同时在后台解析的应用日志文件数
+#define LOG_APP_PARSE_AHEAD 4
+
 class QProcess;
 /**
  * @brief The LogApplicationParseThread class 应用日志获取线程
@@ -37,29 +44,30 @@ public slots:
     void stopProccess();
     int getIndex();
 protected:
-    void initMap();
     void initProccess();
     void run() override;
 
 private:
+    bool parseFile(const QString &path, const std::function<void(LOG_MSG_APPLICATOIN &)> &sink);
+
     /**
      * @brief m_AppFiler 筛选条件结构体
      */
     APP_FILTERS m_AppFiler;
     //获取数据用的cat命令的process
     QProcess *m_process = nullptr;
-    /**
-     * @brief m_levelDict example:warning=>4 等级字符串到等级数字的键值对
-     */
-    QMap<QString, int> m_levelDict;
     /**
      * @brief m_appList 获取的数据结果
      */
     QList<LOG_MSG_APPLICATOIN> m_appList;
+    //发送给界面的批次大小,按读取速度调整
+    LogBatchSizer m_batchSizer;
     /**
      * @brief m_canRun 是否可以继续运行的标记量，用于停止运行线程
      */
-    bool m_canRun = false;
+    std::atomic_bool m_canRun {false};
+    //构造时(界面发起加载时)所属加载的指标计数,运行时安装到解析线程
+    LogIngestCountersPtr m_ingest {LogIngestMetrics::current()};
     /**
      * @brief m_threadIndex 当前线程标号
      */
@@ -0,0 +1,231 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logarchive.h"
+#include "loggzipinflater.h"
+
+#include "minizip/unzip.h"
+
+#include <QBuffer>
+#include <QLoggingCategory>
+#include <QMutexLocker>
+#include <QtConcurrent/QtConcurrentMap>
+
+#include <functional>
+#include <limits>
+
+#ifdef QT_DEBUG
+Q_LOGGING_CATEGORY(logArchive, "org.deepin.log.viewer.archive")
+#else
+Q_LOGGING_CATEGORY(logArchive, "org.deepin.log.viewer.archive", QtInfoMsg)
+#endif
+
+//每次从zip成员读取的数据大小
+#define LOG_ARCHIVE_READ_BLOCK (256 * 1024)
+
+namespace {
+//zip中DOS格式的修改时间
+QDateTime dosTime(const tm_unz &tmu)
+{
+    return QDateTime(QDate(static_cast<int>(tmu.tm_year), static_cast<int>(tmu.tm_mon) + 1, static_cast<int>(tmu.tm_mday)),
+                     QTime(static_cast<int>(tmu.tm_hour), static_cast<int>(tmu.tm_min), static_cast<int>(tmu.tm_sec)));
+}
+}
+
+LogArchive::LogArchive(const QString &zipPath)
+    : m_zipPath(zipPath)
+{
+}
+
+/**
+ * @brief LogArchive::open 读取zip的中央目录,列出各文件,不解压
+ * @return 是否是可以读取的zip包
+ */
+bool LogArchive::open()
+{
+    unzFile zip = unzOpen64(m_zipPath.toLocal8Bit().constData());
+    if (!zip) {
+        qCWarning(logArchive) << "open archive failed:" << m_zipPath;
+        return false;
+    }
+    QList<Member> members;
+    bool ok = unzGoToFirstFile(zip) == UNZ_OK;
+    char name[4096];
+    while (ok && members.size() < LOG_ARCHIVE_MAX_MEMBERS) {
+        unz_file_info64 info;
+        ok = unzGetCurrentFileInfo64(zip, &info, name, sizeof(name), nullptr, 0, nullptr, 0) == UNZ_OK;
+        if (!ok)
+            break;
+        const QString entry = QString::fromUtf8(name);
+        if (!entry.endsWith('/')) {
+            Member member;
+            member.name = entry;
+            const int slash = entry.lastIndexOf('/');
+            member.category = slash > 0 ? entry.left(slash) : QString();
+            member.size = static_cast<qint64>(info.uncompressed_size);
+            member.modified = dosTime(info.tmu_date);
+            members.append(member);
+        }
+        const int next = unzGoToNextFile(zip);
+        if (next == UNZ_END_OF_LIST_OF_FILE)
+            break;
+        ok = next == UNZ_OK;
+    }
+    unzClose(zip);
+    if (!ok) {
+        qCWarning(logArchive) << "read archive directory failed:" << m_zipPath;
+        return false;
+    }
+    QMutexLocker locker(&m_mutex);
+    m_members = members;
+    m_sources.clear();
+    return true;
+}
+
+/**
+ * @brief LogArchive::categories 各类别,按在包中第一次出现的顺序
+ */
+QStringList LogArchive::categories() const
+{
+    QMutexLocker locker(&m_mutex);
+    QStringList categories;
+    for (const Member &member : m_members) {
+        if (!categories.contains(member.category))
+            categories.append(member.category);
+    }
+    return categories;
+}
+
+/**
+ * @brief LogArchive::members 一个类别中的文件,按在包中的顺序
+ */
+QList<LogArchive::Member> LogArchive::members(const QString &category) const
+{
+    QMutexLocker locker(&m_mutex);
+    QList<Member> members;
+    for (const Member &member : m_members) {
+        if (member.category == category)
+            members.append(member);
+    }
+    return members;
+}
+
+/**
+ * @brief LogArchive::index 类别中各文件的内容和行索引,未建立的成员在线程池中并行解压和建立,之后直接返回
+ * 每个任务单独打开zip,互不共享minizip的句柄
+ * @param category 类别
+ * @param canRun 为false时停止,未完成的成员不返回也不保留
+ * @return 按包中顺序的各文件,读取失败的文件跳过
+ */
+QList<LogTextSourcePtr> LogArchive::index(const QString &category, const std::atomic_bool &canRun)
+{
+    const QList<Member> list = members(category);
+    QList<Member> missing;
+    {
+        QMutexLocker locker(&m_mutex);
+        for (const Member &member : list) {
+            if (!m_sources.contains(member.name))
+                missing.append(member);
+        }
+    }
+
+    const QString zipPath = m_zipPath;
+    const std::function<LogTextSourcePtr(const Member &)> build = [zipPath, &canRun](const Member &member) {
+        QByteArray data;
+        if (!canRun || !read(zipPath, member.name, data))
+            return LogTextSourcePtr();
+        std::shared_ptr<LogTextSource> source = std::make_shared<LogTextSource>(sourcePath(zipPath, member.name));
+        source->setData(data);
+        if (!source->buildIndex(canRun))
+            return LogTextSourcePtr();
+        return LogTextSourcePtr(source);
+    };
+    const QList<LogTextSourcePtr> built = QtConcurrent::blockingMapped<QList<LogTextSourcePtr>>(missing, build);
+
+    QMutexLocker locker(&m_mutex);
+    for (int i = 0; i < missing.size(); ++i) {
+        if (built.at(i))
+            m_sources.insert(missing.at(i).name, built.at(i));
+    }
+    QList<LogTextSourcePtr> sources;
+    for (const Member &member : list) {
+        const LogTextSourcePtr source = m_sources.value(member.name);
+        if (source)
+            sources.append(source);
+    }
+    return sources;
+}
+
+/**
+ * @brief LogArchive::sourcePath 归档中一个文件的来源路径,用于显示和区分本机文件
+ */
+QString LogArchive::sourcePath(const QString &zipPath, const QString &member)
+{
+    return QString(LOG_ARCHIVE_PATH_PREFIX) + zipPath + "/" + member;
+}
+
+/**
+ * @brief LogArchive::read 把zip中的一个文件解压到内存,.gz文件再解压一层
+ * @param zipPath zip包路径
+ * @param member 文件在包中的完整路径
+ * @param out 输出参数,文件内容
+ * @param maxSize 解压后的大小上限,超过时不读取,防止压缩炸弹耗尽内存
+ * @return 是否读取成功,crc不符或超过大小上限时返回false
+ */
+bool LogArchive::read(const QString &zipPath, const QString &member, QByteArray &out, qint64 maxSize)
+{
+    out.clear();
+    //QByteArray的容量有限,每次多读一块
+    maxSize = qMin<qint64>(maxSize, std::numeric_limits<int>::max() - LOG_ARCHIVE_READ_BLOCK);
+    unzFile zip = unzOpen64(zipPath.toLocal8Bit().constData());
+    if (!zip)
+        return false;
+    bool ok = unzLocateFile(zip, member.toUtf8().constData(), 1) == UNZ_OK;
+    unz_file_info64 info;
+    ok = ok && unzGetCurrentFileInfo64(zip, &info, nullptr, 0, nullptr, 0, nullptr, 0) == UNZ_OK;
+    //目录中记录的大小可能不实,读取时仍按读到的字节数检查
+    bool tooLarge = ok && info.uncompressed_size > static_cast<ZPOS64_T>(maxSize);
+    ok = ok && !tooLarge && unzOpenCurrentFile(zip) == UNZ_OK;
+    if (ok) {
+        out.reserve(static_cast<int>(qMin<ZPOS64_T>(info.uncompressed_size, LOG_ARCHIVE_READ_BLOCK * 64)));
+        while (true) {
+            const int offset = out.size();
+            out.resize(offset + LOG_ARCHIVE_READ_BLOCK);
+            const int bytes = unzReadCurrentFile(zip, out.data() + offset, LOG_ARCHIVE_READ_BLOCK);
+            out.resize(offset + qMax(0, bytes));
+            if (bytes <= 0) {
+                ok = bytes == 0;
+                break;
+            }
+            if (out.size() > maxSize) {
+                tooLarge = true;
+                ok = false;
+                break;
+            }
+        }
+        //读完整个文件时才校验crc
+        ok = unzCloseCurrentFile(zip) == UNZ_OK && ok;
+    }
+    unzClose(zip);
+
+    if (ok && member.endsWith(".gz")) {
+        QByteArray compressed;
+        compressed.swap(out);
+        QBuffer buffer(&compressed);
+        QString error;
+        ok = buffer.open(QIODevice::ReadOnly) && LogGzipInflater::inflateDevice(&buffer, out, &error, maxSize);
+        tooLarge = !ok && error == LogGzipInflater::sizeLimitError();
+    }
+    if (tooLarge) {
+        qCWarning(logArchive) << "archive member exceeds size limit, skipped:" << zipPath << member << maxSize;
+        ok = false;
+    } else if (!ok) {
+        qCWarning(logArchive) << "read archive member failed:" << zipPath << member;
+    }
+    if (!ok) {
+        out.clear();
+        out.squeeze();
+    }
+    return ok;
+}
@@ -0,0 +1,74 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGARCHIVE_H
+#define LOGARCHIVE_H
+
+#include "logtextsource.h"
+
+#include <QDateTime>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+
+#include <atomic>
+#include <memory>
+
+//归档中文件路径的前缀,和成员名拼接后作为来源路径,区分本机文件
+#define LOG_ARCHIVE_PATH_PREFIX "archive:"
+//打开归档时最多列出的成员数,超出的成员忽略
+#define LOG_ARCHIVE_MAX_MEMBERS 100000
+//归档中一个文件解压到内存后的大小上限,超过时跳过该文件;各成员并行解压,比单个压缩日志的上限小
+#define LOG_ARCHIVE_MAX_MEMBER_SIZE (256 * 1024 * 1024LL)
+
+/**
+ * @brief The LogArchive class 全部导出(LogAllExportThread)生成的zip包的离线查看
+ * 打开时只读取zip的中央目录,按成员所在目录分为类别(如kernel、dpkg、apps/deepin-editor);
+ * 第一次查看一个类别时才解压其中的成员,各成员在线程池中并行解压(.gz轮转日志再在内存中解压)并建立行索引,
+ * 结果保留在内存中供再次查看和搜索,不解压到磁盘。可以在线程间共享,index可在任意线程调用
+ */
+class LogArchive
+{
+public:
+    /**
+     * @brief The Member struct 归档中的一个文件
+     */
+    struct Member {
+        //zip中的完整路径
+        QString name;
+        //所在目录,根目录下的文件为空
+        QString category;
+        qint64 size = 0;
+        QDateTime modified;
+    };
+
+    explicit LogArchive(const QString &zipPath);
+
+    bool open();
+    const QString &zipPath() const { return m_zipPath; }
+    QStringList categories() const;
+    QList<Member> members(const QString &category) const;
+    QList<LogTextSourcePtr> index(const QString &category, const std::atomic_bool &canRun);
+
+    static QString sourcePath(const QString &zipPath, const QString &member);
+    static bool read(const QString &zipPath, const QString &member, QByteArray &out,
+                     qint64 maxSize = LOG_ARCHIVE_MAX_MEMBER_SIZE);
+
+private:
+    Q_DISABLE_COPY(LogArchive)
+
+    QString m_zipPath;
+    QList<Member> m_members;
+    /**
+     * @brief m_sources 已建立行索引的成员,键为成员名
+     */
+    QHash<QString, LogTextSourcePtr> m_sources;
+    mutable QMutex m_mutex;
+};
+
+using LogArchivePtr = std::shared_ptr<LogArchive>;
+
+#endif // LOGARCHIVE_H
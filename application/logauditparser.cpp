@@ -0,0 +1,290 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logauditparser.h"
+#include "utils.h"
+#include "logusernames.h"
+#include "loglocaltime.h"
+
+#include <QStringRef>
+
+#include <string.h>
+
+/**
+ * @brief LogAuditParser::parseLine 解析一行审计记录
+ * 状态机依次读取key和value:value为"..."时取引号内的内容;
+ * msg='...'中是用户态程序上报的key=value,去掉单引号后继续按同样的规则切分
+ * @param line 一行日志
+ * @param record 输出参数,解析结果
+ * @return 是否为有效的审计记录(包含type=)
+ */
+bool LogAuditParser::parseLine(const QString &line, LogAuditRecord &record)
+{
+    record = LogAuditRecord();
+    const QChar *data = line.constData();
+    const int length = line.size();
+    int i = 0;
+    bool hasType = false;
+    while (i < length) {
+        //跳过分隔的空格
+        while (i < length && data[i].isSpace())
+            ++i;
+        //key
+        const int keyBegin = i;
+        while (i < length && data[i] != QLatin1Char('=') && !data[i].isSpace())
+            ++i;
+        if (i >= length || data[i] != QLatin1Char('='))
+            continue;
+        const QStringRef key(&line, keyBegin, i - keyBegin);
+        ++i;
+
+        if (key == QLatin1String("msg")) {
+            //msg=audit(1688526389.214:61): 事件时间和编号
+            if (QStringRef(&line, i, qMin(6, length - i)) == QLatin1String("audit(")) {
+                const int idBegin = i + 6;
+                const int idEnd = line.indexOf(QLatin1Char(')'), idBegin);
+                if (idEnd < 0)
+                    return false;
+                record.eventId = line.mid(idBegin, idEnd - idBegin);
+                record.time = record.eventId.left(record.eventId.indexOf(QLatin1Char('.'))).toUInt();
+                record.detailBegin = idEnd + 3;
+                i = idEnd + 1;
+                if (i < length && data[i] == QLatin1Char(':'))
+                    ++i;
+                continue;
+            }
+            //msg='op=... res=success' 继续解析单引号内的字段
+            if (i < length && data[i] == QLatin1Char('\''))
+                ++i;
+            continue;
+        }
+
+        //value
+        int valueBegin = i;
+        int valueEnd = i;
+        if (i < length && data[i] == QLatin1Char('"')) {
+            valueBegin = i + 1;
+            valueEnd = line.indexOf(QLatin1Char('"'), valueBegin);
+            if (valueEnd < 0)
+                valueEnd = length;
+            i = valueEnd + 1;
+        } else {
+            while (i < length && !data[i].isSpace())
+                ++i;
+            valueEnd = i;
+            //msg='...'的最后一个字段带着结束的单引号
+            if (valueEnd > valueBegin && data[valueEnd - 1] == QLatin1Char('\''))
+                --valueEnd;
+        }
+        const bool quoted = valueBegin > 0 && data[valueBegin - 1] == QLatin1Char('"');
+
+        QString *field = nullptr;
+        if (key == QLatin1String("type")) {
+            field = &record.type;
+            hasType = true;
+        } else if (key == QLatin1String("comm")) {
+            field = &record.comm;
+        } else if (key == QLatin1String("exe")) {
+            field = &record.exe;
+        } else if (key == QLatin1String("success")) {
+            field = &record.success;
+        } else if (key == QLatin1String("res")) {
+            field = &record.res;
+        } else if (key == QLatin1String("addr")) {
+            field = &record.addr;
+        } else if (key == QLatin1String("key")) {
+            field = &record.key;
+        }
+        //同名字段只取第一个
+        if (field != nullptr && field->isEmpty()) {
+            *field = line.mid(valueBegin, valueEnd - valueBegin);
+            //没有引号的进程名和路径是十六进制编码的
+            if (!quoted && (field == &record.comm || field == &record.exe))
+                *field = decodeValue(*field);
+        }
+    }
+
+    if (!hasType)
+        return false;
+    record.origin = line;
+    return true;
+}
+
+/**
+ * @brief LogAuditParser::buildEvent 把同一事件的多行记录合并为一个审计事件
+ * @param records 同一事件的记录,按读取顺序(从新到旧)排列,最后一条是事件的第一行(通常为SYSCALL)
+ * @param strings 事件类型和审计类型的字符串池,为空时不共享
+ * @return 审计事件
+ */
+LOG_MSG_AUDIT LogAuditParser::buildEvent(const QList<LogAuditRecord> &records, LogStringPool *strings)
+{
+    LOG_MSG_AUDIT msg;
+    if (records.isEmpty())
+        return msg;
+
+    const LogAuditRecord &primary = records.last();
+    msg.eventType = strings ? strings->intern(primary.type) : primary.type;
+    msg.dateTime = LogLocalTime::formatSecs(primary.time);
+
+    QString auditType;
+    QString comm;
+    QString exe;
+    QString success;
+    QString res;
+    QString addr;
+    QString key;
+    QStringList origins;
+    //按文件中的顺序合并,每个字段取第一个出现的值
+    for (int i = records.size() - 1; i >= 0; --i) {
+        const LogAuditRecord &record = records.at(i);
+        // 根据事件类型识别审计类型
+        if (auditType.isEmpty())
+            auditType = Utils::auditType(record.type);
+        if (comm.isEmpty())
+            comm = record.comm;
+        if (exe.isEmpty())
+            exe = record.exe;
+        if (success.isEmpty())
+            success = record.success;
+        if (res.isEmpty())
+            res = record.res;
+        if (addr.isEmpty())
+            addr = record.addr;
+        if (key.isEmpty())
+            key = record.key;
+        origins.append(record.origin);
+    }
+
+    // 根据事件类型未识别出审计类型
+    if (auditType.isEmpty()) {
+        // 判断是否为远程连接审计日志
+        if (isIPv4(addr))
+            auditType = Audit_Remote;
+        // 获取key值，识别出一些特殊的审计类型(主要为自定义的审计类型)
+        if (auditType.isEmpty() && !key.isEmpty())
+            auditType = Utils::auditType(key);
+    }
+    // 审计类型依然为空，归为其他类型
+    if (auditType.isEmpty())
+        auditType = Audit_Other;
+    msg.setAuditType(strings ? strings->intern(auditType) : auditType);
+
+    // 进程名
+    QString processName = comm;
+    if (processName.isEmpty())
+        processName = exe.mid(exe.lastIndexOf(QLatin1Char('/')) + 1);
+    if (processName.isEmpty())
+        processName = QStringLiteral("N/A");
+    msg.processName = processName;
+
+    // 状态,各事件共用同一份静态文字
+    bool ok = true;
+    if (!success.isEmpty())
+        ok = success == QLatin1String("yes");
+    else if (!res.isEmpty())
+        ok = res == QLatin1String("success");
+    msg.status = ok ? QStringLiteral("OK") : QStringLiteral("Failed");
+
+    //信息列由message()从原文截取,只有一行的事件直接共用读取到的那一行
+    msg.origin = origins.size() == 1 ? origins.first() : origins.join(QLatin1Char('\n'));
+    return msg;
+}
+
+/**
+ * @brief LogAuditParser::eventKey 不解码整行,直接取出原始字节中msg=audit(...)括号内的事件编号,
+ * 大文件分块时用来保证同一事件的多行记录不被切分到两块
+ * @return 事件编号,没有时为空
+ */
+QByteArray LogAuditParser::eventKey(const char *line, int length)
+{
+    static const char head[] = "msg=audit(";
+    const int headLength = static_cast<int>(sizeof(head)) - 1;
+    const char *begin = static_cast<const char *>(memmem(line, static_cast<size_t>(length), head, headLength));
+    if (!begin)
+        return QByteArray();
+    begin += headLength;
+    const char *end = static_cast<const char *>(memchr(begin, ')', static_cast<size_t>(line + length - begin)));
+    return end ? QByteArray(begin, static_cast<int>(end - begin)) : QByteArray();
+}
+
+/**
+ * @brief LogAuditParser::userText 取出审计记录中第一个auid=、uid=和gid=,附上用户名、组名,用于详情面板
+ * 用户名由LogUserNames缓存,打开同一用户的多条记录时不重复查询
+ * @param text 审计记录的内容
+ * @return 如"auid=1000(uos) uid=0(root) gid=0(root)",查询不到名称时只有数字,没有这些字段时为空
+ */
+QString LogAuditParser::userText(const QString &text)
+{
+    //auid未设置(没有经过登录)时为-1
+    static const uint unsetId = 4294967295u;
+    static const char *const keys[] = {"auid=", "uid=", "gid="};
+    QStringList parts;
+    for (const char *key : keys) {
+        const QLatin1String name(key);
+        int pos = -1;
+        do {
+            pos = text.indexOf(name, pos + 1);
+        } while (pos > 0 && !text.at(pos - 1).isSpace() && text.at(pos - 1) != QLatin1Char('\''));
+        if (pos < 0)
+            continue;
+        const int begin = pos + name.size();
+        int end = begin;
+        while (end < text.size() && text.at(end).isDigit())
+            ++end;
+        bool ok = false;
+        const uint id = text.midRef(begin, end - begin).toUInt(&ok);
+        if (!ok)
+            continue;
+        if (id == unsetId) {
+            parts.append(QString(key) + "unset");
+            continue;
+        }
+        const QString idName = name == QLatin1String("gid=") ? LogUserNames::groupName(id) : LogUserNames::userName(id);
+        parts.append(idName.isEmpty() ? QString(key) + QString::number(id) : QString("%1%2(%3)").arg(key).arg(id).arg(idName));
+    }
+    return parts.join(QLatin1Char(' '));
+}
+
+/**
+ * @brief LogAuditParser::isIPv4 是否为完整的点分十进制IPv4地址
+ * @param addr 地址
+ * @return 是否为IPv4地址
+ */
+bool LogAuditParser::isIPv4(const QString &addr)
+{
+    int parts = 0;
+    int digits = 0;
+    int value = 0;
+    for (const QChar &c : addr) {
+        if (c == QLatin1Char('.')) {
+            if (digits == 0 || ++parts > 3)
+                return false;
+            digits = 0;
+            value = 0;
+        } else if (c >= QLatin1Char('0') && c <= QLatin1Char('9')) {
+            value = value * 10 + (c.unicode() - '0');
+            if (++digits > 3 || value > 255)
+                return false;
+        } else {
+            return false;
+        }
+    }
+    return parts == 3 && digits > 0;
+}
+
+/**
+ * @brief LogAuditParser::decodeValue 解码auditd十六进制编码的值,不是十六进制时原样返回
+ * @param value 原始值
+ * @return 解码后的值
+ */
+QString LogAuditParser::decodeValue(const QString &value)
+{
+    if (value.isEmpty() || value.size() % 2 != 0)
+        return value;
+    for (const QChar &c : value) {
+        if (!((c >= QLatin1Char('0') && c <= QLatin1Char('9')) || (c >= QLatin1Char('A') && c <= QLatin1Char('F'))))
+            return value;
+    }
+    return QString::fromUtf8(QByteArray::fromHex(value.toLatin1()));
+}
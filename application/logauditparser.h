@@ -0,0 +1,55 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGAUDITPARSER_H
+#define LOGAUDITPARSER_H
+
+#include "structdef.h"
+#include "logstringpool.h"
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+
+/**
+ * @brief The LogAuditRecord struct audit.log中的一行记录,只保留解析审计事件需要的字段
+ */
+struct LogAuditRecord {
+    //记录类型,type=的值
+    QString type;
+    //事件编号,msg=audit(时间戳:序号)括号内的内容,同一事件的多行记录编号相同
+    QString eventId;
+    //事件时间,秒
+    uint time = 0;
+    QString comm;
+    QString exe;
+    QString success;
+    QString res;
+    QString addr;
+    QString key;
+    //"msg=audit(...): "之后的内容在原文中的开始位置,没有时为-1;不另外复制
+    int detailBegin = -1;
+    //原文
+    QString origin;
+};
+
+/**
+ * @brief The LogAuditParser class 审计日志的解析
+ * 每行只扫描一遍,按key=value切分出需要的字段;同一个msg=audit(时间戳:序号)的多行记录
+ * (如SYSCALL+CWD+PATH+PROCTITLE)合并为一个审计事件
+ */
+class LogAuditParser
+{
+public:
+    static bool parseLine(const QString &line, LogAuditRecord &record);
+    static LOG_MSG_AUDIT buildEvent(const QList<LogAuditRecord> &records, LogStringPool *strings = nullptr);
+    static bool isIPv4(const QString &addr);
+    static QByteArray eventKey(const char *line, int length);
+    static QString userText(const QString &text);
+
+private:
+    static QString decodeValue(const QString &value);
+};
+
+#endif // LOGAUDITPARSER_H
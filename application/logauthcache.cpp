@@ -0,0 +1,80 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logauthcache.h"
+#include "logcanceltoken.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QLoggingCategory>
+
+#include <chrono>
+
+#ifdef QT_DEBUG
+Q_LOGGING_CATEGORY(logAuthCache, "org.deepin.log.viewer.auth.cache")
+#else
+Q_LOGGING_CATEGORY(logAuthCache, "org.deepin.log.viewer.auth.cache", QtInfoMsg)
+#endif
+
+LogAuthCache *LogAuthCache::instance()
+{
+    static LogAuthCache cache;
+    return &cache;
+}
+
+/**
+ * @brief LogAuthCache::authorize 确认可以读取path,所在目录已经鉴权过时直接返回,否则执行一次提权
+ * 等待其他线程提权时按当前线程的取消令牌返回
+ * @param path 要读取的文件或目录
+ * @param elevate 执行提权鉴权
+ * @return 已鉴权或本次提权成功返回true
+ */
+bool LogAuthCache::authorize(const QString &path, const Elevate &elevate)
+{
+    const QString scope = scopeOf(path);
+    if (isAuthorized(path))
+        return true;
+
+    const LogCancelToken token = LogCancelToken::current();
+    while (!m_elevateMutex.try_lock_for(std::chrono::milliseconds(LOG_CANCEL_POLL_MSEC))) {
+        if (token.isCancelled())
+            return false;
+    }
+    std::unique_lock<std::timed_mutex> elevateLock(m_elevateMutex, std::adopt_lock);
+    //等待期间其他线程可能已经鉴权了同一目录
+    if (isAuthorized(path))
+        return true;
+    if (!elevate || !elevate())
+        return false;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_scopes.insert(scope);
+    qCInfo(logAuthCache) << "authorized:" << scope;
+    return true;
+}
+
+/**
+ * @brief LogAuthCache::isAuthorized path所在目录是否已经鉴权
+ */
+bool LogAuthCache::isAuthorized(const QString &path) const
+{
+    const QString scope = scopeOf(path);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_scopes.contains(scope);
+}
+
+void LogAuthCache::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_scopes.clear();
+}
+
+/**
+ * @brief LogAuthCache::scopeOf 鉴权的范围,目录为其本身,文件为所在目录
+ */
+QString LogAuthCache::scopeOf(const QString &path)
+{
+    const QFileInfo info(path);
+    return QDir::cleanPath(info.isDir() ? info.absoluteFilePath() : info.absolutePath());
+}
@@ -0,0 +1,47 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGAUTHCACHE_H
+#define LOGAUTHCACHE_H
+
+#include <QSet>
+#include <QString>
+
+#include <functional>
+#include <mutex>
+
+/**
+ * @brief The LogAuthCache class 本次运行中已经通过pkexec提权鉴权的目录
+ * 鉴权只是读取前的确认,数据随后都通过日志服务读取;同一目录下的日志(一组轮转文件、自定义日志目录中的文件)
+ * 鉴权一次后不再为每个文件启动logViewerAuth,也不会连续弹出多次密码框。
+ * 多个获取线程同时请求时依次提权,后到的线程直接使用先到线程的结果
+ */
+class LogAuthCache
+{
+public:
+    /**
+     * @brief Elevate 实际执行一次提权鉴权,成功返回true
+     */
+    typedef std::function<bool()> Elevate;
+
+    static LogAuthCache *instance();
+
+    bool authorize(const QString &path, const Elevate &elevate);
+    bool isAuthorized(const QString &path) const;
+    void clear();
+
+    static QString scopeOf(const QString &path);
+
+private:
+    LogAuthCache() = default;
+    LogAuthCache(const LogAuthCache &) = delete;
+    LogAuthCache &operator=(const LogAuthCache &) = delete;
+
+    mutable std::mutex m_mutex;
+    //同一时间只进行一次提权,避免同时弹出多个密码框
+    std::timed_mutex m_elevateMutex;
+    QSet<QString> m_scopes;
+};
+
+#endif // LOGAUTHCACHE_H
@@ -6,8 +6,24 @@
 #include "utils.h"
 #include "sharedmemorymanager.h"
 #include "sys/utsname.h"
-#include "wtmpparse.h"
+#include "wtmpsessionreader.h"
 #include "dbusproxy/dldbushandler.h"
+#include "loglinestream.h"
+#include "logauditparser.h"
+#include "logkmsgreader.h"
+#include "journalreader.h"
+#include "logparsematchers.h"
+#include "loglevel.h"
+#include "logrecordreader.h"
+#include "logchunkparser.h"
+#include "logtimeindex.h"
+#include "logstringpool.h"
+#include "logparsecontext.h"
+#include "logtracer.h"
+#include "logalloccounter.h"
+#include "logcanceltoken.h"
+#include "logsharedring.h"
+#include "logauthcache.h"
 #include "dbusmanager.h"
 
 #include <DGuiApplicationHelper>
@@ -15,10 +31,14 @@
 
 #include <QDebug>
 #include <QDateTime>
+#include <QLocale>
+#include <QSet>
+#include <QThread>
 #include <time.h>
 #include <utmp.h>
 #include <utmpx.h>
 #include <algorithm>
+#include <limits>
 #include <signal.h>
 #include <unistd.h>
 #include <pwd.h>
@@ -28,8 +48,23 @@ std::atomic<LogAuthThread *> LogAuthThread::m_instance;
 std::mutex LogAuthThread::m_mutex;
 int LogAuthThread::thread_count = 0;
 
-// DBUS传输文件大小阈值 100MB
-#define DBUS_THRESHOLD_MAX 100
+//增量读取kwin日志时比较上次读取位置之前的这么多字节,内容不同说明文件被改写
+#define KWIN_TAIL_CHECK_BYTES 256
+//在Xorg日志开头的这么多字节内查找记录启动时间的文件头
+#define XORG_HEAD_BYTES 8192
+
+namespace {
+/**
+ * @brief dmesgDateTime 内核日志的显示时间"yyyy-MM-dd hh:mm:ss.zzz",日期和时分秒由formatter按天缓存
+ */
+QString dmesgDateTime(JournalTimeFormatter &formatter, qint64 msecs)
+{
+    const int ms = static_cast<int>(msecs % 1000);
+    const char text[4] = {'.', static_cast<char>('0' + ms / 100), static_cast<char>('0' + ms / 10 % 10), static_cast<char>('0' + ms % 10)};
+    return formatter.formatSecs(msecs / 1000) + QLatin1String(text, 4);
+}
+}
+
 /**
  * @brief LogAuthThread::LogAuthThread 构造函数
  * @param parent 父对象
@@ -44,8 +79,6 @@ LogAuthThread::LogAuthThread(QObject *parent)
     //静态计数变量加一并赋值给本对象的成员变量，以供外部判断是否为最新线程发出的数据信号
     thread_count++;
     m_threadCount = thread_count;
-    initDnfLevelMap();
-    initLevelMap();
 }
 
 /**
@@ -55,41 +88,6 @@ LogAuthThread::~LogAuthThread()
 {
     stopProccess();
 }
-void LogAuthThread::initDnfLevelMap()
-{
-    m_dnfLevelDict.insert("TRACE", TRACE);
-    m_dnfLevelDict.insert("SUBDEBUG", DEBUG);
-    m_dnfLevelDict.insert("DDEBUG", DEBUG);
-    m_dnfLevelDict.insert("DEBUG", DEBUG);
-    m_dnfLevelDict.insert("INFO", INFO);
-    m_dnfLevelDict.insert("WARNING", WARNING);
-    m_dnfLevelDict.insert("ERROR", ERROR);
-    m_dnfLevelDict.insert("CRITICAL", CRITICAL);
-    m_dnfLevelDict.insert("SUPERCRITICAL", SUPERCRITICAL);
-
-    m_transDnfDict.insert("TRACE", Dtk::Widget::DApplication::translate("Level", "Trace"));
-    m_transDnfDict.insert("SUBDEBUG", Dtk::Widget::DApplication::translate("Level", "Debug"));
-    m_transDnfDict.insert("DDEBUG", Dtk::Widget::DApplication::translate("Level", "Debug"));
-    m_transDnfDict.insert("DEBUG", Dtk::Widget::DApplication::translate("Level", "Debug"));
-    m_transDnfDict.insert("INFO", Dtk::Widget::DApplication::translate("Level", "Info"));
-    m_transDnfDict.insert("WARNING", Dtk::Widget::DApplication::translate("Level", "Warning"));
-    m_transDnfDict.insert("ERROR", Dtk::Widget::DApplication::translate("Level", "Error"));
-    m_transDnfDict.insert("CRITICAL", Dtk::Widget::DApplication::translate("Level", "Critical"));
-    m_transDnfDict.insert("SUPERCRITICAL", Dtk::Widget::DApplication::translate("Level", "Super critical"));
-}
-
-void LogAuthThread::initLevelMap()
-{
-    m_levelMap.clear();
-    m_levelMap.insert(0, Dtk::Widget::DApplication::translate("Level", "Emergency"));
-    m_levelMap.insert(1, Dtk::Widget::DApplication::translate("Level", "Alert"));
-    m_levelMap.insert(2, Dtk::Widget::DApplication::translate("Level", "Critical"));
-    m_levelMap.insert(3, Dtk::Widget::DApplication::translate("Level", "Error"));
-    m_levelMap.insert(4, Dtk::Widget::DApplication::translate("Level", "Warning"));
-    m_levelMap.insert(5, Dtk::Widget::DApplication::translate("Level", "Notice"));
-    m_levelMap.insert(6, Dtk::Widget::DApplication::translate("Level", "Info"));
-    m_levelMap.insert(7, Dtk::Widget::DApplication::translate("Level", "Debug"));
-}
 
 /**
  * @brief LogAuthThread::stopProccess 停止日志数据获取进程并销毁
@@ -149,8 +147,14 @@ QString LogAuthThread::startTime()
  */
 void LogAuthThread::run()
 {
+    PERF_TRACE_SCOPE_ARGS("parse", "LogAuthThread", QString("type=%1").arg(m_type));
+    LogIngestScope ingest(m_ingest, true);
+    LogCancelScope cancel(m_canRun);
     //此线程刚开始把可以继续变量置true，不然下面没法跑
     m_canRun = true;
+    if (m_lowPriority)
+        QThread::currentThread()->setPriority(QThread::IdlePriority);
+    m_batchSizer.reset();
     //根据类型成员变量执行对应日志的获取逻辑
     switch (m_type) {
     case KERN:
@@ -196,78 +200,49 @@ void LogAuthThread::run()
  */
 void LogAuthThread::handleBoot()
 {
+    PERF_ALLOC_SCOPE("LogAuthThread::handleBoot");
     QList<LOG_MSG_BOOT> bList;
     for (int i = 0; i < m_FilePath.count(); i++) {
-        if (!m_FilePath.at(i).contains("txt")) {
-            QFile file(m_FilePath.at(i)); // add by Airy
-            if (!file.exists()) {
-                emit bootFinished(m_threadCount);
-                return;
-            }
-        }
         if (!m_canRun) {
             return;
         }
 
-        if (!Utils::runInCmd) {
-            initProccess();
-            m_process->setProcessChannelMode(QProcess::MergedChannels);
-            //共享内存对应变量置true，允许进程内部逻辑运行
-            ShareMemoryInfo shareInfo;
-            shareInfo.isStart = true;
-            SharedMemoryManager::instance()->setRunnableTag(shareInfo);
-            //启动日志需要提权获取，运行的时候把对应共享内存的名称传进去，方便获取进程拿标记量判断是否继续运行
-            m_process->start("pkexec", QStringList() << "logViewerAuth"
-                             << m_FilePath.at(i) << SharedMemoryManager::instance()->getRunnableKey());
-            m_process->waitForFinished(-1);
-            if (m_process->exitCode() != 0) {
-                emit bootFinished(m_threadCount);
-                return;
-            }
+        if (!Utils::runInCmd && !authorizeFile(m_FilePath.at(i))) {
+            emit bootFinished(m_threadCount);
+            return;
         }
 
-        QString byte = DLDBusHandler::instance(this)->readLog(m_FilePath.at(i));
-        byte.replace('\u0000', "").replace("\x01", "");
-        QStringList strList = byte.split('\n', QString::SkipEmptyParts);
-
-        //按换行分割
-        for (int j = strList.size() - 1; j >= 0; --j) {
-            QString lineStr = strList.at(j);
-            if (lineStr.startsWith("/dev") || lineStr.isEmpty())
-                continue;
-            //删除颜色格式字符
-            lineStr.replace(QRegExp("\\#033\\[\\d+(;\\d+){0,2}m"), "");
-            // remove Useless characters
-            lineStr.replace(QRegExp("\\x1B\\[\\d+(;\\d+){0,2}m"), "");
-            Utils::replaceColorfulFont(&lineStr);
-            QStringList retList;
-            LOG_MSG_BOOT bMsg;
-            retList = lineStr.split(" ", QString::SkipEmptyParts);
-            if (retList.size() == 1) {
-                bMsg.msg = lineStr.trimmed();
+        //按块从新到旧读取,每块解析完立即发出,不需要把整个文件读入内存
+        LogLineStream stream(m_FilePath.at(i), this);
+        QStringList strList;
+        while (stream.readChunk(strList)) {
+            for (int j = 0; j < strList.size(); ++j) {
+                QString lineStr = strList.at(j);
+                if (lineStr.startsWith("/dev") || lineStr.isEmpty())
+                    continue;
+                //删除颜色格式字符
+                LogParseMatchers::stripColorSequences(lineStr);
+                Utils::replaceColorfulFont(&lineStr);
+                //以[  OK  ]/[FAILED]开头的是一条记录的开头,否则整行作为信息,不再按空格拆分
+                LOG_MSG_BOOT bMsg;
+                int msgBegin = 0;
+                bMsg.statusCode = LogParseMatchers::scanBootStatus(lineStr, msgBegin);
+                bMsg.status = LogParseMatchers::bootStatusText(bMsg.statusCode);
+                bMsg.msg = lineStr.mid(msgBegin).trimmed();
                 bList.append(bMsg);
-            } else {
-                if (retList[1].compare("OK", Qt::CaseInsensitive) == 0 || retList[1].compare("Failed", Qt::CaseInsensitive) == 0) {
-                    //如果是以ok/failed开头，则认为是一条记录的开头，否则认为此行为上一条日志的信息体的后续
-                    bMsg.status = retList[1];
-                    QStringList leftList = retList.mid(3);
-                    bMsg.msg += leftList.join(" ");
-                    bList.append(bMsg);
-                } else {
-                    bMsg.msg = lineStr.trimmed();
-                    bList.append(bMsg);
-                }
-            }
 
-            //每获得500个数据就发出信号给控件加载
-            if (bList.count() % SINGLE_READ_CNT == 0) {
-                emit bootData(m_threadCount, bList);
-                bList.clear();
+                //每满一批(大小随读取速度调整)就发出信号给控件加载
+                if (m_batchSizer.isFull(bList)) {
+                    waitDelivery();
+                    emit bootData(m_threadCount, bList);
+                    bList.clear();
+                }
             }
         }
     }
-    //最后可能有余下不足500的数据
+    //最后可能有余下不足一批的数据
     if (bList.count() >= 0) {
+        waitDelivery();
         emit bootData(m_threadCount, bList);
     }
     emit bootFinished(m_threadCount);
@@ -278,6 +253,11 @@ void LogAuthThread::handleBoot()
  */
 void LogAuthThread::handleKern()
 {
+    PERF_ALLOC_SCOPE("LogAuthThread::handleKern");
+    if (m_kernFromJournal) {
+        handleKernJournal();
+        return;
+    }
     QList<LOG_MSG_JOURNAL> kList;
     for (int i = 0; i < m_FilePath.count(); i++) {
         if (!m_FilePath.at(i).contains("txt")) {
@@ -291,149 +271,124 @@ void LogAuthThread::handleKern()
             return;
         }
 
-        if (!Utils::runInCmd) {
-            initProccess();
-            if (!m_canRun) {
-                return;
-            }
-            m_process->setProcessChannelMode(QProcess::MergedChannels);
-            if (!m_canRun) {
-                return;
-            }
-            //共享内存对应变量置true，允许进程内部逻辑运行
-            ShareMemoryInfo shareInfo;
-            shareInfo.isStart = true;
-            SharedMemoryManager::instance()->setRunnableTag(shareInfo);
-            //启动日志需要提权获取，运行的时候把对应共享内存的名称传进去，方便获取进程拿标记量判断是否继续运行
-            m_process->start("pkexec", QStringList() << "logViewerAuth"
-                             << m_FilePath.at(i) << SharedMemoryManager::instance()->getRunnableKey());
-            m_process->waitForFinished(-1);
-            //有错则传出空数据
-            if (m_process->exitCode() != 0) {
-                emit kernFinished(m_threadCount);
-                return;
-            }
+        //有错则传出空数据
+        if (!Utils::runInCmd && !authorizeFile(m_FilePath.at(i))) {
+            emit kernFinished(m_threadCount);
+            return;
         }
 
         if (!m_canRun) {
             return;
         }
+    }
 
-        //如果是压缩文件，对其解压缩
-        QString filePath = m_FilePath.at(i);
-        if(QString::compare(QFileInfo(filePath).suffix(), "gz", Qt::CaseInsensitive) == 0){
-            QStringList filePathList = DLDBusHandler::instance(this)->getFileInfo(filePath);
-            if(filePathList.size()){
-                filePath = filePathList.at(0);
-            }else {
-                filePath = "";
-            }
+    //多个轮转文件在线程池中并行解析,按文件顺序(从新到旧)交付
+    LogOrderedParser<LOG_MSG_JOURNAL> parser(m_canRun);
+    bool completed = parser.run(m_FilePath.count(), LogOrderedParser<LOG_MSG_JOURNAL>::idealThreadCount(m_FilePath.count()),
+    [this](int index, const LogOrderedParser<LOG_MSG_JOURNAL>::Sink &sink) {
+        parseKernFile(m_FilePath.at(index), sink);
+    }, [this, &kList](QList<LOG_MSG_JOURNAL> &records) {
+        kList.append(records);
+        //每满一批(大小随读取速度调整)就发出信号给控件加载
+        if (m_batchSizer.isFull(kList)) {
+            waitDelivery();
+            emit kernData(m_threadCount, kList);
+            kList.clear();
         }
+    });
+    if (!completed) {
+        return;
+    }
+    //最后可能有余下不足一批的数据
+    if (kList.count() >= 0) {
+        waitDelivery();
+        emit kernData(m_threadCount, kList);
+    }
+    emit kernFinished(m_threadCount);
+}
 
-        auto token = DLDBusHandler::instance(this)->openLogStream(filePath);
-        QString byte;
-        while(1) {
-            auto temp = DLDBusHandler::instance(this)->readLogInStream(token);
+/**
+ * @brief LogAuthThread::handleKernJournal 从journal读取_TRANSPORT=kernel的内核日志,不需要鉴权和DBus传输文件,
+ * 按时间范围定位后倒序读取,等级条件作为journal匹配下推
+ */
+void LogAuthThread::handleKernJournal()
+{
+    JournalReadOptions options;
+    if (m_kernFilters.timeFilterBegin > 0 && m_kernFilters.timeFilterEnd > 0) {
+        options.hasTimeRange = true;
+        options.beginTime = static_cast<quint64>(m_kernFilters.timeFilterBegin) * 1000;
+        //结束时间可能是qint64最大值(增量刷新),换算为微秒时不能溢出
+        options.endTime = m_kernFilters.timeFilterEnd >= std::numeric_limits<qint64>::max() / 1000
+                          ? std::numeric_limits<quint64>::max()
+                          : static_cast<quint64>(m_kernFilters.timeFilterEnd) * 1000;
+    }
+    //同一字段的多个匹配为或
+    if (m_kernFilters.priority >= 0) {
+        QByteArrayList priorities;
+        for (int i = 0; i <= qMin(m_kernFilters.priority, 7); ++i)
+            priorities.append("PRIORITY=" + QByteArray::number(i));
+        options.matches.append(priorities);
+    }
 
-            if(temp.isEmpty()) {
-                break;
-            }
+    QList<LOG_MSG_JOURNAL> kList;
+    JournalReader<KernJournalPolicy> reader(KernJournalPolicy(), m_canRun);
+    int r = reader.read(options, kList, [this](QList<LOG_MSG_JOURNAL> &list) {
+        //每满一批(大小由JournalReader按读取速度调整)就发出信号给控件加载
+        waitDelivery();
+        emit kernData(m_threadCount, list);
+    });
+    //被停止时不再发出任何信号
+    if (r == -ECANCELED || !m_canRun)
+        return;
+    if (r < 0)
+        qWarning() << "read kernel journal failed:" << reader.errorString();
+    emit kernFinished(m_threadCount);
+}
 
-            byte += temp;
+/**
+ * @brief LogAuthThread::parseKernFile 解析一个文件,按从新到旧的顺序分批交出
+ * @param filePath 日志文件路径
+ * @param sink 交出一批数据,返回false时已被停止
+ */
+void LogAuthThread::parseKernFile(const QString &filePath, const LogOrderedParser<LOG_MSG_JOURNAL>::Sink &sink)
+{
+    QList<LOG_MSG_JOURNAL> kList;
+    //主机名、进程名和进程号在一个文件中重复很多次,每种值只保留一份;字符串池沿用上次加载收录的值
+    LogParseContextPool::Lease context = LogParseContextPool::instance().acquire("kern");
+    LogStringPool &strings = context->strings;
+    //按从新到旧读取,每批解析完立即发出,不需要把整个文件读入内存;没有读权限时由服务解析好再传回
+    LogRecordReader reader(filePath, LogRecordBatch::KernFormat, this);
+    //多个文件已并行解析,每个文件分到剩余的核
+    reader.setParseThreads(LogRecordReader::parseThreadsFor(m_FilePath.count()));
+    LogLineFilter filter = LogLineFilter::timeRange(m_kernFilters.timeFilterBegin, m_kernFilters.timeFilterEnd);
+    filter.keyword = m_kernFilters.keyword;
+    reader.setFilter(filter);
+    bool finished = reader.read(m_canRun, [this, &kList, &strings, &sink](qint64 lineTime, const QStringList &columns) {
+        //对时间筛选
+        if (m_kernFilters.timeFilterBegin > 0 && m_kernFilters.timeFilterEnd > 0) {
+            if (lineTime < m_kernFilters.timeFilterBegin || lineTime > m_kernFilters.timeFilterEnd)
+                return true;
         }
 
-        byte.replace('\u0000', "").replace("\x01", "");
-        QStringList strList = byte.split('\n', QString::SkipEmptyParts);
-        for (int j = strList.size() - 1; j >= 0; --j) {
-            if (!m_canRun) {
-                return;
-            }
-            QString str = strList.at(j);
-            LOG_MSG_JOURNAL msg;
-            //删除颜色格式字符
-            str.replace(QRegExp("\\#033\\[\\d+(;\\d+){0,2}m"), "");
-            QStringList list = str.split(" ", QString::SkipEmptyParts);
-            if (list.size() < 5)
-                continue;
-            //获取内核年份接口已添加，等待系统接口添加年份改变相关日志
-            QStringList timeList;
-            if (list[0].contains("-")) {
-                timeList.append(list[0]);
-                timeList.append(list[1]);
-                iTime = formatDateTime(list[0], list[1]);
-            } else {
-                timeList.append(list[0]);
-                timeList.append(list[1]);
-                timeList.append(list[2]);
-                iTime = formatDateTime(list[0], list[1], list[2]);
-            }
-
-            //对时间筛选
-            if (m_kernFilters.timeFilterBegin > 0 && m_kernFilters.timeFilterEnd > 0) {
-                if (iTime < m_kernFilters.timeFilterBegin || iTime > m_kernFilters.timeFilterEnd)
-                    continue;
-            }
-
-            msg.dateTime = timeList.join(" ");
-            QStringList tmpList;
-            if (list[0].contains("-")) {
-                msg.hostName = list[2];
-                tmpList = list[3].split("[");
-            } else {
-                msg.hostName = list[3];
-                tmpList = list[4].split("[");
-            }
-
-            int m = 0;
-            //内核日志存在年份，解析用户名和进程id
-            if (list[0].contains("-")) {
-                if (tmpList.size() != 2) {
-                    msg.daemonName = list[3].split(":")[0];
-                } else {
-                    msg.daemonName = list[3].split("[")[0];
-                    QString id = list[3].split("[")[1];
-                    id.chop(2);
-                    msg.daemonId = id;
-                }
-                m = 4;
-            } else {//内核日志不存在年份,解析用户名和进程id
-                if (tmpList.size() != 2) {
-                    msg.daemonName = list[4].split(":")[0];
-                } else {
-                    msg.daemonName = list[4].split("[")[0];
-                    QString id = list[4].split("[")[1];
-                    id.chop(2);
-                    msg.daemonId = id;
-                }
-                m = 5;
-            }
-
-            QString msgInfo;
-            for (int k = m; k < list.size(); k++) {
-                msgInfo.append(list[k] + " ");
-            }
-            msg.msg = msgInfo;
-
-            //            kList.append(msg);
-            kList.append(msg);
-            if (!m_canRun) {
-                return;
-            }
-            //每获得500个数据就发出信号给控件加载
-            if (kList.count() % SINGLE_READ_CNT == 0) {
-                emit kernData(m_threadCount, kList);
-                kList.clear();
-            }
-            if (!m_canRun) {
-                return;
-            }
+        LOG_MSG_JOURNAL msg;
+        msg.dateTime = columns.at(0);
+        //和系统日志一致为微秒,切换时间筛选时在内存中按时间戳筛选
+        msg.timestamp = lineTime * 1000;
+        msg.hostName = strings.intern(columns.at(1));
+        msg.daemonName = strings.intern(columns.at(2));
+        msg.daemonId = strings.intern(columns.at(3));
+        msg.msg = columns.at(4);
+        kList.append(msg);
+        //每解析出SINGLE_READ_CNT条交给sink,发往界面的批次大小由交付一侧按读取速度调整
+        if (kList.count() % SINGLE_READ_CNT == 0) {
+            if (!sink(kList))
+                return false;
         }
-    }
-    //最后可能有余下不足500的数据
-    if (kList.count() >= 0) {
-        emit kernData(m_threadCount, kList);
-    }
-    emit kernFinished(m_threadCount);
+        return true;
+    });
+    //最后交出余下不足SINGLE_READ_CNT条的数据
+    if (finished && !kList.isEmpty())
+        sink(kList);
 }
 
 /**
@@ -441,64 +396,113 @@ void LogAuthThread::handleKern()
  */
 void LogAuthThread::handleKwin()
 {
+    PERF_ALLOC_SCOPE("LogAuthThread::handleKwin");
     QFile file(KWIN_TREE_DATA);
     if (!m_canRun) {
         return;
     }
     QList<LOG_MSG_KWIN> kwinList;
     if (!file.exists()) {
+        if (m_kwinFilters.tail) {
+            *m_kwinFilters.tail = LogTailPosition();
+            m_kwinFilters.tail->rescanned = true;
+        }
         emit kwinFinished(m_threadCount);
         return;
     }
     if (!m_canRun) {
         return;
     }
-    initProccess();
-    m_process->start("cat", QStringList() << KWIN_TREE_DATA);
-    m_process->waitForFinished(-1);
-    if (!m_canRun) {
-        return;
-    }
-    QByteArray outByte = m_process->readAllStandardOutput();
-    if (!m_canRun) {
-        return;
-    }
-
-    QStringList strList =  QString(Utils::replaceEmptyByteArray(outByte)).split('\n', QString::SkipEmptyParts);
-
-    for (int i = strList.size() - 1; i >= 0 ; --i)  {
-        QString str = strList.at(i);
-        if (!m_canRun) {
-            return;
-        }
-        if (str.trimmed().isEmpty()) {
-            continue;
+    //kwin日志在家目录下,当前用户可读,直接在进程内映射读取
+    LogLineStream stream(KWIN_TREE_DATA, this);
+    if (m_kwinFilters.tail) {
+        if (stream.openDirect()) {
+            seekKwinTail(stream, *m_kwinFilters.tail);
+        } else {
+            //通过服务读取时不能定位,每次都从头读取
+            *m_kwinFilters.tail = LogTailPosition();
+            m_kwinFilters.tail->rescanned = true;
         }
-        LOG_MSG_KWIN kwinMsg;
-        kwinMsg.msg = str;
-        kwinList.append(kwinMsg);
-        //每获得500个数据就发出信号给控件加载
-        if (kwinList.count() % SINGLE_READ_CNT == 0) {
-            emit kwinData(m_threadCount, kwinList);
-            kwinList.clear();
+    }
+    QStringList strList;
+    while (stream.readChunk(strList)) {
+        for (int i = 0; i < strList.size(); ++i)  {
+            const QString &str = strList.at(i);
+            if (!m_canRun) {
+                return;
+            }
+            if (str.trimmed().isEmpty()) {
+                continue;
+            }
+            LOG_MSG_KWIN kwinMsg;
+            kwinMsg.msg = str;
+            kwinList.append(kwinMsg);
+            //每满一批(大小随读取速度调整)就发出信号给控件加载
+            if (m_batchSizer.isFull(kwinList)) {
+                waitDelivery();
+                emit kwinData(m_threadCount, kwinList);
+                kwinList.clear();
+            }
         }
     }
 
     if (!m_canRun) {
         return;
     }
-    //最后可能有余下不足500的数据
+    //最后可能有余下不足一批的数据
     if (kwinList.count() >= 0) {
+        waitDelivery();
         emit kwinData(m_threadCount, kwinList);
     }
     emit kwinFinished(m_threadCount);
 }
 
+/**
+ * @brief LogAuthThread::seekKwinTail 按上次读取到的位置只读取之后追加的完整行,并记下本次读取到的位置
+ * 设备号或inode变化(轮转)、文件比上次读取到的位置短(截断)、位置之前的内容变化(截断后又写入)时从头读取
+ * @param stream 已在进程内打开的kwin日志
+ * @param tail 读取位置,读取结束前更新,界面在kwinFinished之后读取
+ */
+void LogAuthThread::seekKwinTail(LogLineStream &stream, LogTailPosition &tail)
+{
+    //只用pread读取需要比较的部分,读取期间文件被截断也不会访问映射越界
+    const qint64 size = stream.mappedSize();
+    quint64 device = 0;
+    quint64 inode = 0;
+    const bool statOk = stream.fileIdentity(device, inode);
+
+    bool incremental = tail.offset > 0 && statOk && device == tail.device && inode == tail.inode && size >= tail.offset;
+    if (incremental) {
+        const qint64 tailSize = tail.tailBytes.size();
+        QByteArray tailBytes;
+        incremental = tailSize <= tail.offset && stream.readRange(tail.offset - tailSize, tail.offset, tailBytes)
+                      && tailBytes == tail.tailBytes;
+    }
+    if (incremental && !stream.setRangeBegin(tail.offset))
+        incremental = false;
+    const qint64 begin = incremental ? tail.offset : 0;
+
+    //末尾还没有换行的一行可能正在写入,留到下次读取
+    const qint64 newline = stream.lastNewline(begin, size);
+    const qint64 end = newline >= 0 ? newline + 1 : begin;
+    stream.setRangeEnd(end);
+
+    tail.device = device;
+    tail.inode = inode;
+    tail.offset = end;
+    if (!stream.readRange(end - qMin<qint64>(end, KWIN_TAIL_CHECK_BYTES), end, tail.tailBytes))
+        tail.tailBytes.clear();
+    //解压的内容是引用,复制一份保留到下次比较
+    tail.tailBytes.detach();
+    tail.rescanned = !incremental;
+}
+
 /**
  * @brief LogAuthThread::handleXorg 处理xorg日志获取逻辑
  */
 void LogAuthThread::handleXorg()
 {
+    PERF_ALLOC_SCOPE("LogAuthThread::handleXorg");
     QList<LOG_MSG_XORG> xList;
     for (int i = 0; i < m_FilePath.count(); i++) {
         if (!m_FilePath.at(i).contains("txt")) {
@@ -512,51 +516,154 @@ void LogAuthThread::handleXorg()
         if (!m_canRun) {
             return;
         }
-        QString m_Log = DLDBusHandler::instance(this)->readLog(m_FilePath.at(i));
-        QByteArray outByte = m_Log.toUtf8();
-        if (!m_canRun) {
-            return;
+    }
+
+    //各显示的Xorg.N.log及其.old文件在线程池中并行解析,按文件顺序交付
+    LogOrderedParser<LOG_MSG_XORG> parser(m_canRun);
+    bool completed = parser.run(m_FilePath.count(), LogOrderedParser<LOG_MSG_XORG>::idealThreadCount(m_FilePath.count()),
+    [this](int index, const LogOrderedParser<LOG_MSG_XORG>::Sink &sink) {
+        parseXorgFile(m_FilePath.at(index), sink);
+    }, [this, &xList](QList<LOG_MSG_XORG> &records) {
+        xList.append(records);
+        //每满一批(大小随读取速度调整)就发出信号给控件加载
+        if (m_batchSizer.isFull(xList)) {
+            waitDelivery();
+            emit xorgData(m_threadCount, xList);
+            xList.clear();
         }
-        if (!m_canRun) {
-            return;
+    });
+    if (!completed) {
+        return;
+    }
+    //最后可能有余下不足一批的数据
+    if (xList.count() >= 0) {
+        waitDelivery();
+        emit xorgData(m_threadCount, xList);
+    }
+    emit xorgFinished(m_threadCount);
+}
+
+/**
+ * @brief LogAuthThread::parseXorgFile 解析一个Xorg日志文件,按从新到旧的顺序分批交出
+ * 有时间范围时按文件头记录的启动时间换算为偏移量范围,偏移量随行递增,早于范围即停止读取;
+ * 文件头中没有启动时间(或通过服务读取)时不按时间筛选
+ * @param filePath 日志文件路径
+ * @param sink 交出一批数据,返回false时已被停止
+ */
+void LogAuthThread::parseXorgFile(const QString &filePath, const LogOrderedParser<LOG_MSG_XORG>::Sink &sink)
+{
+    //按块从新到旧读取,每块解析完立即发出,不需要把整个文件读入内存
+    LogLineStream stream(filePath, this);
+    qint64 beginUsec = std::numeric_limits<qint64>::min();
+    qint64 endUsec = std::numeric_limits<qint64>::max();
+    QByteArray head;
+    //文件头通过readRange读取,不访问映射;读取失败(文件被截断)时不按时间筛选
+    if (m_xorgFilters.timeFilterBegin > 0 && m_xorgFilters.timeFilterEnd > 0 && stream.openDirect()
+            && stream.readRange(0, qMin<qint64>(stream.mappedSize(), XORG_HEAD_BYTES), head)) {
+        const qint64 startTime = xorgStartTime(head.constData(), head.size());
+        if (startTime >= 0) {
+            beginUsec = (m_xorgFilters.timeFilterBegin - startTime) * 1000;
+            endUsec = (m_xorgFilters.timeFilterEnd - startTime) * 1000;
         }
-        QStringList fileInfoList = QString(Utils::replaceEmptyByteArray(outByte)).split('\n', QString::SkipEmptyParts);
-        QString tempStr = "";
-        for (QStringList::Iterator k = fileInfoList.end() - 1; k != fileInfoList.begin() - 1; --k) {
+    }
+
+    QList<LOG_MSG_XORG> xList;
+    QStringList strList;
+    //续行在记录行之前读到,跨块时也要保留
+    QString tempStr = "";
+    while (stream.readChunk(strList)) {
+        for (QStringList::Iterator k = strList.begin(); k != strList.end(); ++k) {
             QString &str = *k;
             //清除颜色格式字符
-            str.replace(QRegExp("\\x1B\\[\\d+(;\\d+){0,2}m"), "");
-            if (str.startsWith("[")) {
-                QStringList list = str.split("]", QString::SkipEmptyParts);
-                if (list.count() < 2)
+            LogParseMatchers::stripColorSequences(str);
+            if (!str.startsWith("[")) {
+                tempStr.prepend(" " + str);
+                continue;
+            }
+            LOG_MSG_XORG msg;
+            if (!parseXorgLine(str, msg))
+                continue;
+            msg.msg += tempStr;
+            tempStr.clear();
+            if (msg.offsetUsec >= 0) {
+                if (msg.offsetUsec > endUsec)
                     continue;
-                QString timeStr = list[0];
-                QString msgInfo = list.mid(1, list.length() - 1).join("]").trimmed();
-                // 仅显示时间偏移量（单位：秒
-                QString tStr = timeStr.split("[", QString::SkipEmptyParts)[0].trimmed();
-                LOG_MSG_XORG msg;
-                msg.offset = tStr;
-                msg.msg = msgInfo + tempStr;
-                tempStr.clear();
-                xList.append(msg);
-                //每获得500个数据就发出信号给控件加载
-                if (xList.count() % SINGLE_READ_CNT == 0) {
-                    emit xorgData(m_threadCount, xList);
-                    xList.clear();
+                //之前的行都更早,不再读取
+                if (msg.offsetUsec < beginUsec) {
+                    if (!xList.isEmpty())
+                        sink(xList);
+                    return;
                 }
-            } else {
-                tempStr.prepend(" " + str);
+            }
+            xList.append(msg);
+            if (xList.count() % SINGLE_READ_CNT == 0) {
+                if (!sink(xList))
+                    return;
             }
         }
+        if (!m_canRun)
+            return;
     }
-    if (!m_canRun) {
-        return;
-    }
-    //最后可能有余下不足500的数据
-    if (xList.count() >= 0) {
-        emit xorgData(m_threadCount, xList);
-    }
-    emit xorgFinished(m_threadCount);
+    //最后交出余下不足SINGLE_READ_CNT条的数据
+    if (!xList.isEmpty())
+        sink(xList);
+}
+
+/**
+ * @brief LogAuthThread::parseXorgLine 解析一行"[  1234.567] (II) ..."格式的Xorg日志
+ * @param line 以"["开头的行
+ * @param msg 输出,offset为显示的偏移量文本,offsetUsec为其数值(微秒),不是数字时为-1
+ * @return "]"之后没有内容时返回false
+ */
+bool LogAuthThread::parseXorgLine(const QString &line, LOG_MSG_XORG &msg)
+{
+    const int close = line.indexOf(']');
+    if (close < 0)
+        return false;
+    //跳过紧跟的"]",和按"]"切分时去掉空段一致
+    int msgStart = close + 1;
+    while (msgStart < line.size() && line.at(msgStart) == ']')
+        ++msgStart;
+    if (msgStart >= line.size())
+        return false;
+    // 仅显示时间偏移量（单位：秒
+    msg.offset = line.mid(1, close - 1).trimmed();
+    msg.msg = line.mid(msgStart).trimmed();
+    bool ok = false;
+    const double seconds = msg.offset.toDouble(&ok);
+    msg.offsetUsec = (ok && seconds >= 0) ? qRound64(seconds * 1000000) : -1;
+    return true;
+}
+
+/**
+ * @brief LogAuthThread::xorgStartTime 从文件头"(==) Log file: "...", Time: Mon Oct 14 09:00:00 2026"取出X服务的启动时间
+ * @param data 文件内容
+ * @param size 内容长度
+ * @return 偏移量为0时对应的时间(毫秒),找不到时返回-1
+ */
+qint64 LogAuthThread::xorgStartTime(const char *data, qint64 size)
+{
+    if (!data || size <= 0)
+        return -1;
+    //文件头在开始的几十行内
+    const int headBytes = static_cast<int>(qMin<qint64>(size, XORG_HEAD_BYTES));
+    const QString head = QString::fromLatin1(data, headBytes);
+    const int logFile = head.indexOf("Log file:");
+    if (logFile < 0)
+        return -1;
+    const int lineStart = head.lastIndexOf('\n', logFile) + 1;
+    int lineEnd = head.indexOf('\n', logFile);
+    if (lineEnd < 0)
+        lineEnd = head.size();
+    const QString line = head.mid(lineStart, lineEnd - lineStart);
+    const int time = line.indexOf("Time:");
+    LOG_MSG_XORG header;
+    if (time < 0 || !parseXorgLine(line, header) || header.offsetUsec < 0)
+        return -1;
+    const QDateTime dt = QLocale::c().toDateTime(line.mid(time + 5).simplified(), "ddd MMM d hh:mm:ss yyyy");
+    if (!dt.isValid())
+        return -1;
+    return dt.toMSecsSinceEpoch() - header.offsetUsec / 1000;
 }
 
 /**
@@ -564,212 +671,145 @@ void LogAuthThread::handleXorg()
  */
 void LogAuthThread::handleDkpg()
 {
+    PERF_ALLOC_SCOPE("LogAuthThread::handleDkpg");
     QList<LOG_MSG_DPKG> dList;
     for (int i = 0; i < m_FilePath.count(); i++) {
         if (!m_FilePath.at(i).contains("txt")) {
             QFile file(m_FilePath.at(i)); // if not,maybe crash
-            if (!file.exists())
+            if (!file.exists()) {
+                emit dnfFinished(m_threadCount);
                 return;
+            }
         }
         if (!m_canRun) {
             return;
         }
+    }
 
-        QString m_Log = DLDBusHandler::instance(this)->readLog(m_FilePath.at(i));
-        QByteArray outByte = m_Log.toUtf8();
-        if (!m_canRun) {
-            return;
-        }
-        QStringList strList = QString(Utils::replaceEmptyByteArray(outByte)).split('\n', QString::SkipEmptyParts);
-        for (int j = strList.size() - 1; j >= 0; --j) {
-            QString str = strList.at(j);
-            if (!m_canRun) {
-                return;
-            }
-            str.replace(QRegExp("\\x1B\\[\\d+(;\\d+){0,2}m"), "");
-            QStringList m_strList = str.split(" ", QString::SkipEmptyParts);
-            if (m_strList.size() < 3)
-                continue;
-
-            QString info;
-            for (auto k = 3; k < m_strList.size(); k++) {
-                info = info + m_strList[k] + " ";
-            }
-
-            LOG_MSG_DPKG dpkgLog;
-            dpkgLog.dateTime = m_strList[0] + " " + m_strList[1];
-            QDateTime dt = QDateTime::fromString(dpkgLog.dateTime, "yyyy-MM-dd hh:mm:ss");
-            //筛选时间
-            if (m_dkpgFilters.timeFilterBegin > 0 && m_dkpgFilters.timeFilterEnd > 0) {
-                if (dt.toMSecsSinceEpoch() < m_dkpgFilters.timeFilterBegin || dt.toMSecsSinceEpoch() > m_dkpgFilters.timeFilterEnd)
-                    continue;
-            }
-            dpkgLog.action = m_strList[2];
-            dpkgLog.msg = info;
-
-            //        dList.append(dpkgLog);
-            dList.append(dpkgLog);
-            if (!m_canRun) {
-                return;
-            }
-            //每获得500个数据就发出信号给控件加载
-            if (dList.count() % SINGLE_READ_CNT == 0) {
-                emit dpkgData(m_threadCount, dList);
-                dList.clear();
-            }
-            if (!m_canRun) {
-                return;
-            }
+    //多个轮转文件在线程池中并行解析,按文件顺序(从新到旧)交付
+    LogOrderedParser<LOG_MSG_DPKG> parser(m_canRun);
+    bool completed = parser.run(m_FilePath.count(), LogOrderedParser<LOG_MSG_DPKG>::idealThreadCount(m_FilePath.count()),
+    [this](int index, const LogOrderedParser<LOG_MSG_DPKG>::Sink &sink) {
+        parseDpkgFile(m_FilePath.at(index), sink);
+    }, [this, &dList](QList<LOG_MSG_DPKG> &records) {
+        dList.append(records);
+        //每满一批(大小随读取速度调整)就发出信号给控件加载
+        if (m_batchSizer.isFull(dList)) {
+            waitDelivery();
+            emit dpkgData(m_threadCount, dList);
+            dList.clear();
         }
+    });
+    if (!completed) {
+        return;
     }
-
-    //最后可能有余下不足500的数据
+    //最后可能有余下不足一批的数据
     if (dList.count() >= 0) {
+        waitDelivery();
         emit dpkgData(m_threadCount, dList);
     }
     emit dpkgFinished(m_threadCount);
 }
 
+/**
+ * @brief LogAuthThread::parseDpkgFile 解析一个文件,按从新到旧的顺序分批交出
+ * @param filePath 日志文件路径
+ * @param sink 交出一批数据,返回false时已被停止
+ */
+void LogAuthThread::parseDpkgFile(const QString &filePath, const LogOrderedParser<LOG_MSG_DPKG>::Sink &sink)
+{
+    QList<LOG_MSG_DPKG> dList;
+    //动作只有install、upgrade等少数几种
+    LogParseContextPool::Lease context = LogParseContextPool::instance().acquire("dpkg");
+    LogStringPool &strings = context->strings;
+    //按从新到旧读取,每批解析完立即发出,不需要把整个文件读入内存;没有读权限时由服务解析好再传回
+    LogRecordReader reader(filePath, LogRecordBatch::DpkgFormat, this);
+    //多个文件已并行解析,每个文件分到剩余的核
+    reader.setParseThreads(LogRecordReader::parseThreadsFor(m_FilePath.count()));
+    LogLineFilter filter = LogLineFilter::timeRange(m_dkpgFilters.timeFilterBegin, m_dkpgFilters.timeFilterEnd);
+    filter.keyword = m_dkpgFilters.keyword;
+    reader.setFilter(filter);
+    bool finished = reader.read(m_canRun, [this, &dList, &strings, &sink](qint64 lineTime, const QStringList &columns) {
+        //筛选时间
+        if (m_dkpgFilters.timeFilterBegin > 0 && m_dkpgFilters.timeFilterEnd > 0) {
+            if (lineTime < m_dkpgFilters.timeFilterBegin || lineTime > m_dkpgFilters.timeFilterEnd)
+                return true;
+        }
+
+        LOG_MSG_DPKG dpkgLog;
+        dpkgLog.dateTime = columns.at(0);
+        dpkgLog.action = strings.intern(columns.at(1));
+        dpkgLog.msg = columns.at(2);
+        dpkgLog.timestamp = lineTime;
+        dList.append(dpkgLog);
+        //每解析出SINGLE_READ_CNT条交给sink,发往界面的批次大小由交付一侧按读取速度调整
+        if (dList.count() % SINGLE_READ_CNT == 0) {
+            if (!sink(dList))
+                return false;
+        }
+        return true;
+    });
+    //最后交出余下不足SINGLE_READ_CNT条的数据
+    if (finished && !dList.isEmpty())
+        sink(dList);
+}
+
 void LogAuthThread::handleNormal()
 {
+    PERF_ALLOC_SCOPE("LogAuthThread::handleNormal");
     if (!m_canRun) {
         emit normalFinished(m_threadCount);
         return;
     }
 
-    struct utmp *utbufp;
-    if (wtmp_open(QString(WTMP_FILE).toLatin1().data()) == -1) {
-        printf("open WTMP_FILE file error\n");
-        return;  // exit(1) will exit this application
+    //映射wtmp文件并自行配对登录/注销和开关机记录,不再启动last进程
+    WtmpSessionReader reader;
+    if (!reader.open(WTMP_FILE)) {
+        return;
     }
-
-    NormalInfoTime();
-
+    QList<WtmpSession> sessions = reader.sessions(m_canRun);
     if (!m_canRun) {
         return;
     }
 
-    int count1 = 0;
-    QString a_name = "root";
-    QLocale locale = QLocale::English;
     QList<LOG_MSG_NORMAL> nList;
-    while ((utbufp = wtmp_next()) != (static_cast<struct utmp *>(nullptr))) {
+    nList.reserve(sessions.size());
+    //同一天的事件只格式化一次日期
+    JournalTimeFormatter formatter;
+    for (const WtmpSession &session : sessions) {
         if (!m_canRun) {
             return;
         }
-        if (utbufp->ut_type == RUN_LVL || utbufp->ut_type == BOOT_TIME || utbufp->ut_type == USER_PROCESS) {
-            QString strtmp = utbufp->ut_name;
-            if (strtmp.compare("runlevel") == 0 || (utbufp->ut_type == RUN_LVL && strtmp != "shutdown") || utbufp->ut_type == INIT_PROCESS || utbufp->ut_time <= 0) { // clear the runlevel
+        qint64 msecs = session.time * 1000;
+        if (m_normalFilters.timeFilterEnd > 0 && m_normalFilters.timeFilterBegin > 0) {
+            if (msecs < m_normalFilters.timeFilterBegin || msecs > m_normalFilters.timeFilterEnd) { // add by Airy
                 continue;
             }
-
-            LOG_MSG_NORMAL Nmsg;
-            if (utbufp->ut_type == USER_PROCESS) {
-                Nmsg.eventType = "Login";
-                Nmsg.userName = utbufp->ut_name;
-                a_name = Nmsg.userName;
-            } else {
-                Nmsg.eventType = utbufp->ut_name;
-                if (strtmp.compare("reboot") == 0) {
-                    Nmsg.eventType = "Boot";
-                }
-                Nmsg.userName = a_name;
-            }
-            if (Nmsg.eventType.compare("Login", Qt::CaseInsensitive) == 0) {
-                Nmsg.eventType = "Login";
-            }
-
-            QString strFormat = "ddd MMM dd hh:mm";
-
-            //修改时间格式转换方法，采用QDateTime 转换
-            QString start_str = locale.toString(QDateTime::fromTime_t(static_cast<uint>(utbufp->ut_time)), strFormat);
-            //截止时间解析
-            if (Nmsg.eventType == "Login" || Nmsg.eventType == "Boot") {
-                if (count1 <= TimeList.length() - 1) {
-                    Nmsg.msg = TimeList[count1];
-                    count1++;
-                }
-            } else {
-                Nmsg.msg = start_str + "  -  ";
-            }
-
-            QString n_time = QDateTime::fromTime_t(static_cast<uint>(utbufp->ut_time)).toString("yyyy-MM-dd hh:mm:ss");
-            Nmsg.dateTime = n_time;
-            QDateTime nn_time = QDateTime::fromString(Nmsg.dateTime, "yyyy-MM-dd hh:mm:ss");
-            if (m_normalFilters.timeFilterEnd > 0 && m_normalFilters.timeFilterBegin > 0) {
-                if (nn_time.toMSecsSinceEpoch() < m_normalFilters.timeFilterBegin || nn_time.toMSecsSinceEpoch() > m_normalFilters.timeFilterEnd) { // add by Airy
-                    continue;
-                }
-            }
-            //last -f /var/log/wtmp
-            nList.insert(0, Nmsg);
         }
+        LOG_MSG_NORMAL Nmsg;
+        Nmsg.eventType = session.eventType;
+        Nmsg.userName = session.userName;
+        Nmsg.time = session.time;
+        Nmsg.dateTime = formatter.formatSecs(session.time);
+        Nmsg.msg = session.msg;
+        nList.append(Nmsg);
     }
-    wtmp_close();
 
     if (nList.count() >= 0) {
+        waitDelivery();
         emit normalData(m_threadCount, nList);
     }
     emit normalFinished(m_threadCount);
 }
 
-void LogAuthThread::NormalInfoTime()
-{
-    if (!m_canRun) {
-        return;
-    }
-    initProccess();
-
-    if (!m_canRun) {
-        return;
-    }
-    //共享内存对应变量置true，允许进程内部逻辑运行
-    ShareMemoryInfo shareInfo;
-    shareInfo.isStart = true;
-    SharedMemoryManager::instance()->setRunnableTag(shareInfo);
-    m_process->setProcessChannelMode(QProcess::MergedChannels);
-    m_process->start("last", {"-f", "/var/log/wtmp"});
-    m_process->waitForFinished(-1);
-    QByteArray outByte = m_process->readAllStandardOutput();
-    QByteArray byte = Utils::replaceEmptyByteArray(outByte);
-    QTextStream stream(&byte);
-    QByteArray encode;
-    stream.setCodec(encode);
-    stream.readAll();
-    QStringList l = QString(byte).split('\n');
-    m_process->close();
-    TimeList.clear();
-    if (!m_canRun) {
-        return;
-    }
-    for (QString str : l) {
-        if (!m_canRun) {
-            return;
-        }
-        if (str == "") continue;
-        QString list = str.simplified();
-        if (list == "") continue;
-        int spacepos = list.indexOf(" ");
-        QString name = list.left(spacepos);
-        int spacepos2 = list.indexOf(" ", spacepos + 1);
-        int spacepos3 = list.indexOf(" ", spacepos2 + 1);
-        QString time1 = list.mid(spacepos3 + 1);
-        int spacepos4 = list.indexOf(" ", spacepos3 + 1);
-        QString time2 = list.mid(spacepos4 + 1);
-
-        if (name == "wtmp") continue;
-        if (name != "reboot" && name != "wtmp") {
-            TimeList << time1;
-        } else  if (name == "reboot") {
-            TimeList << time2;
-        }
-    }
-    std::reverse(TimeList.begin(), TimeList.end());
-}
-
 void LogAuthThread::handleDnf()
 {
+    PERF_ALLOC_SCOPE("LogAuthThread::handleDnf");
     QList<LOG_MSG_DNF> dList;
+    //已解析出的记录数,分批发出后dList会被清空
+    int count = 0;
+    //同一天的记录只格式化一次日期
+    JournalTimeFormatter formatter;
     for (int i = 0; i < m_FilePath.count(); i++) {
         if (!m_FilePath.at(i).contains("txt")) {
             QFile file(m_FilePath.at(i)); // if not,maybe crash
@@ -779,65 +819,109 @@ void LogAuthThread::handleDnf()
         if (!m_canRun) {
             return;
         }
-        QByteArray outByte = DLDBusHandler::instance(this)->readLog(m_FilePath.at(i)).toUtf8();
-        QString output = Utils::replaceEmptyByteArray(outByte);
-        QStringList allLog = output.split('\n');
+        //从文件末尾按块倒序读取,续行在所属记录之前读到,和原先从后往前遍历的顺序一致
+        LogLineStream stream(m_FilePath.at(i), this);
+        QStringList strList;
         //dnf日志数据结构
         LOG_MSG_DNF dnfLog;
         //多行多余信息
         QString multiLine;
-        //开启贪婪匹配，解析dnf全部字段:日期+事件+等级+主要内容
-        QRegularExpression re("^(\\d{4}-[0-2]\\d-[0-3]\\d)\\D*([0-2]\\d:[0-5]\\d:[0-5]\\d)\\S*\\s*(\\w*)\\s*(.*)$");
-        for (int j = allLog.size() - 1; j >= 0; --j) {
-            if (!m_canRun) {
-                return;
-            }
-            QString str = allLog.value(j);
-            QRegularExpressionMatch match = re.match(str);
-            bool matchRes = match.hasMatch();
-            if (matchRes) {
-                //时间搜索条件
-                QDateTime dt = QDateTime::fromString(match.captured(1) + match.captured(2), "yyyy-MM-ddhh:mm:ss");
-                QDateTime localdt = dt.toLocalTime();
-                //日志等级筛选条件
-                QString logLevel = match.captured(3);
-                //不满足条件的情况下继续搜索
-                if (dt.toMSecsSinceEpoch() < m_dnfFilters.timeFilter || (m_dnfFilters.levelfilter != DNFLVALL && m_dnfLevelDict.value(logLevel) != m_dnfFilters.levelfilter))
+        while (stream.readChunk(strList)) {
+            for (int j = 0; j < strList.size(); ++j) {
+                if (!m_canRun) {
+                    return;
+                }
+                QString str = strList.at(j);
+                //行首按位置识别出时间和等级:先比较时间,再按整数比较等级,不满足条件的行不再取字段
+                LogLinePrefix prefix;
+                if (LogParseMatchers::scanDnfPrefix(str, prefix)) {
+                    if (prefix.time < m_dnfFilters.timeFilter)
+                        continue;
+                    const int level = LogLevel::fromDnfName(prefix.level(str));
+                    if (m_dnfFilters.levelfilter != DNFLVALL && level != m_dnfFilters.levelfilter)
+                        continue;
+                    dnfLog.level = level;
+                    dnfLog.dateTime = formatter.formatSecs(prefix.time / 1000);
+                    dnfLog.msg = str.mid(prefix.restBegin) + multiLine;
+                    dList.append(dnfLog);
+                    multiLine.clear();
+                    ++count;
+                    //每满一批(大小随读取速度调整)就发出信号给控件加载
+                    if (m_batchSizer.isFull(dList)) {
+                        waitDelivery();
+                        emit dnfData(m_threadCount, dList);
+                        dList.clear();
+                    }
                     continue;
-                //记录日志等级，时间和主体信息
-                dnfLog.level = m_transDnfDict.value(logLevel);
-                dnfLog.dateTime = localdt.toString("yyyy-MM-dd hh:mm:ss");
-                dnfLog.msg = match.captured(4) + multiLine;
-                dList.append(dnfLog);
-                multiLine.clear();
-            } else {
-                //如果不匹配，认为是多条信息，添加换行符，在前一条信息后添加信息。
-                if (!str.trimmed().isEmpty() && !dList.isEmpty()) {
+                }
+                //不是记录行(含日期无效的行)时认为是多行信息，添加换行符，在前一条信息后添加信息。
+                if (!str.trimmed().isEmpty() && count > 0) {
                     multiLine.push_front("\n" + str);
                 }
-            }
-            if (!m_canRun) {
-                return;
+                if (!m_canRun) {
+                    return;
+                }
             }
         }
     }
-    emit dnfFinished(dList);
+    //最后可能有余下不足一批的数据
+    if (!dList.isEmpty()) {
+        waitDelivery();
+        emit dnfData(m_threadCount, dList);
+    }
+    emit dnfFinished(m_threadCount);
 }
 
 void LogAuthThread::handleDmesg()
 {
+    PERF_ALLOC_SCOPE("LogAuthThread::handleDmesg");
     QList<LOG_MSG_DMESG> dmesgList;
     if (!m_canRun) {
         return;
     }
-    QString startStr = startTime();
-    QDateTime curDt = QDateTime::currentDateTime();
-
-    if (startStr.isEmpty()) {
-        emit dmesgFinished(dmesgList);
-        return;
-    }
-    if (!m_canRun) {
+    //开机时刻只计算一次,记录的时间都按整数换算;时间段筛选换算为开机以来的微秒,二分查找起点
+    const qint64 bootMSecs = LogKmsgReader::bootMSecs();
+    const qint64 since = m_dmesgFilters.timeFilter > bootMSecs ? (m_dmesgFilters.timeFilter - bootMSecs) * 1000 : 0;
+    JournalTimeFormatter formatter;
+    //有读取权限时(kernel.dmesg_restrict为0)直接读取/dev/kmsg,不需要提权启动dmesg
+    LogKmsgReader kmsgReader;
+    if (kmsgReader.open()) {
+        //缓冲区从旧到新,显示从新到旧:先只取出原始记录,再从新到旧格式化并分批发出
+        QList<LogKmsgRecord> records;
+        LogKmsgRecord record;
+        while (kmsgReader.readRecord(record)) {
+            if (!m_canRun) {
+                return;
+            }
+            records.append(record);
+        }
+        const int first = LogKmsgReader::lowerBound(records.size(), since, [&records](int i) {
+            return static_cast<qint64>(records.at(i).timestamp);
+        });
+        for (int i = records.size() - 1; i >= first; --i) {
+            if (!m_canRun) {
+                return;
+            }
+            const LogKmsgRecord &item = records.at(i);
+            if (m_dmesgFilters.levelFilter != LVALL && item.level != m_dmesgFilters.levelFilter)
+                continue;
+            LOG_MSG_DMESG msg;
+            msg.dateTime = dmesgDateTime(formatter, bootMSecs + static_cast<qint64>(item.timestamp / 1000));
+            msg.msg = item.message.simplified();
+            msg.level = item.level;
+            dmesgList.append(msg);
+            //每满一批(大小随读取速度调整)就发出信号给控件加载
+            if (m_batchSizer.isFull(dmesgList)) {
+                waitDelivery();
+                emit dmesgData(m_threadCount, dmesgList);
+                dmesgList.clear();
+            }
+        }
+        if (!dmesgList.isEmpty()) {
+            waitDelivery();
+            emit dmesgData(m_threadCount, dmesgList);
+        }
+        emit dmesgFinished(m_threadCount);
         return;
     }
 
@@ -847,12 +931,25 @@ void LogAuthThread::handleDmesg()
     shareInfo.isStart = true;
     SharedMemoryManager::instance()->setRunnableTag(shareInfo);
     m_process->setProcessChannelMode(QProcess::MergedChannels);
+    //dmesg的输出经共享内存传回,标准输出只剩错误信息
+    LogSharedRing ring(LogSharedRing::uniqueKey());
+    if (!ring.create()) {
+        emit dmesgFinished(m_threadCount);
+        return;
+    }
     m_process->start("pkexec", QStringList() << "logViewerAuth"
-                                             << "dmesg" << SharedMemoryManager::instance()->getRunnableKey());
-    m_process->waitForFinished(-1);
-    QString errorStr(m_process->readAllStandardError());
+                                             << "dmesg" << SharedMemoryManager::instance()->getRunnableKey() << ring.key());
+    //边运行边接收dmesg的输出,输出从旧到新,结束后从新到旧解析并分批发出
+    QList<QByteArray> lines;
+    bool completed = LogCancelToken::current().readLines(m_process.data(), ring, [&](const QByteArray &line) {
+        if (!m_canRun)
+            return false;
+        lines.append(line);
+        return true;
+    });
+    QString errorStr(m_process->readAll());
     Utils::CommandErrorType commandErrorType = Utils::isErroCommand(errorStr);
-    if (!m_canRun) {
+    if (!m_canRun || !completed) {
         return;
     }
     if (commandErrorType != Utils::NoError) {
@@ -864,69 +961,83 @@ void LogAuthThread::handleDmesg()
         m_process->close();
         return;
     }
-    if (!m_canRun) {
-        return;
-    }
-    QByteArray outByte = m_process->readAllStandardOutput();
-    QByteArray byte = Utils::replaceEmptyByteArray(outByte);
-    QTextStream stream(&byte);
-    QByteArray encode;
-    stream.setCodec(encode);
-    stream.readAll();
-    QStringList l = QString(byte).split('\n');
     m_process->close();
-    if (!m_canRun) {
-        return;
-    }
-    qint64 curDtSecond = curDt.toMSecsSinceEpoch() - static_cast<int>(startStr.toDouble() * 1000);
-    for (QString str : l) {
+
+    const QRegularExpression &dmesgExp = LogParseMatchers::instance().dmesgLine;
+    //输出按时间递增,跳过时间段之前的行;续行没有时间,跟随前面的记录
+    const int first = LogKmsgReader::lowerBound(lines.size(), since, [&lines](int i) {
+        return LogKmsgReader::textTimestamp(lines.at(i));
+    });
+    //倒序遍历时续行先于所属的记录读到,暂存后接在记录的内容之后
+    QString continuation;
+    for (int i = lines.size() - 1; i >= first; --i) {
         if (!m_canRun) {
             return;
         }
-        str.replace(QRegExp("\\x1B\\[\\d+(;\\d+){0,2}m"), "");
-        QRegExp dmesgExp("^\\<([0-7])\\>\\[\\s*[+-]?(0|([1-9]\\d*))(\\.\\d+)?\\](.*)");
-        //启用贪婪匹配
-        dmesgExp.setMinimal(false);
-        int pos = dmesgExp.indexIn(str);
-        if (pos >= 0) {
-            QStringList list = dmesgExp.capturedTexts();
-            if (list.count() < 6)
-                continue;
-            QString timeStr = list[3] + list[4];
-            QString msgInfo = list[5].simplified();
-            int levelOrigin = list[1].toInt();
-            QString tStr = timeStr.split("[", QString::SkipEmptyParts)[0].trimmed();
-            qint64 realT = curDtSecond + qint64(tStr.toDouble() * 1000);
-            QDateTime realDt = QDateTime::fromMSecsSinceEpoch(realT);
-            if (realDt.toMSecsSinceEpoch() < m_dmesgFilters.timeFilter) // add by Airy
+        QString str = QString(Utils::replaceEmptyByteArray(lines.at(i)));
+        LogParseMatchers::stripColorSequences(str);
+        QRegularExpressionMatch dmesgMatch = dmesgExp.match(str);
+        if (!dmesgMatch.hasMatch()) {
+            continuation.prepend(str);
+            continue;
+        }
+        const QString tail = continuation;
+        continuation.clear();
+        QStringList list = dmesgMatch.capturedTexts();
+        if (list.count() < 6)
+            continue;
+        qint64 offset = LogKmsgReader::textTimestamp(lines.at(i));
+        //带颜色控制序列的行在去掉控制序列后再取时间
+        if (offset < 0)
+            offset = LogKmsgReader::textTimestamp(str.toUtf8());
+        QString msgInfo = list[5].simplified();
+        int levelOrigin = list[1].toInt();
+        qint64 realT = bootMSecs + qMax<qint64>(0, offset) / 1000;
+        if (m_dmesgFilters.levelFilter != LVALL) {
+            if (levelOrigin != m_dmesgFilters.levelFilter)
                 continue;
-            if (m_dmesgFilters.levelFilter != LVALL) {
-                if (levelOrigin != m_dmesgFilters.levelFilter)
-                    continue;
-            }
-            LOG_MSG_DMESG msg;
-            msg.dateTime = realDt.toString("yyyy-MM-dd hh:mm:ss.zzz");
-            msg.msg = msgInfo;
-            msg.level = m_levelMap.value(levelOrigin);
-            dmesgList.insert(0, msg);
-        } else {
-            if (dmesgList.length() > 0) {
-                dmesgList[0].msg += str;
-            }
         }
-        if (!m_canRun) {
-            return;
+        LOG_MSG_DMESG msg;
+        msg.dateTime = dmesgDateTime(formatter, realT);
+        msg.msg = msgInfo + tail;
+        msg.level = levelOrigin;
+        dmesgList.append(msg);
+        //每满一批(大小随读取速度调整)就发出信号给控件加载
+        if (m_batchSizer.isFull(dmesgList)) {
+            waitDelivery();
+            emit dmesgData(m_threadCount, dmesgList);
+            dmesgList.clear();
         }
     }
-    emit dmesgFinished(dmesgList);
+    //最后可能有余下不足一批的数据
+    if (!dmesgList.isEmpty()) {
+        waitDelivery();
+        emit dmesgData(m_threadCount, dmesgList);
+    }
+    emit dmesgFinished(m_threadCount);
 }
 
 void LogAuthThread::handleAudit()
 {
+    PERF_ALLOC_SCOPE("LogAuthThread::handleAudit");
     QList<LOG_MSG_AUDIT> aList;
+    //轮转的审计日志较多,一次查询所有文件是否存在
+    QStringList statPaths;
+    for (const QString &path : m_FilePath) {
+        if (!path.contains("txt"))
+            statPaths.append(path);
+    }
+    QSet<QString> missingPaths;
+    if (!statPaths.isEmpty()) {
+        const QList<LogFileStat> stats = DLDBusHandler::instance(this)->statFiles(statPaths);
+        for (const LogFileStat &stat : stats) {
+            if (!stat.exists)
+                missingPaths.insert(stat.path);
+        }
+    }
     for (int i = 0; i < m_FilePath.count(); i++) {
         if (!m_FilePath.at(i).contains("txt")) {
-            if (!DLDBusHandler::instance(this)->isFileExist(m_FilePath.at(i))) {
+            if (missingPaths.contains(m_FilePath.at(i))) {
                 emit kernFinished(m_threadCount);
                 return;
             }
@@ -959,14 +1070,7 @@ void LogAuthThread::handleAudit()
                 }
             } else {
                 // 未开启等保四，鉴权逻辑同内核日志
-                ShareMemoryInfo shareInfo;
-                shareInfo.isStart = true;
-                SharedMemoryManager::instance()->setRunnableTag(shareInfo);
-                //启动日志需要提权获取，运行的时候把对应共享内存的名称传进去，方便获取进程拿标记量判断是否继续运行
-                m_process->start("pkexec", QStringList() << "logViewerAuth"
-                                 << m_FilePath.at(i) << SharedMemoryManager::instance()->getRunnableKey());
-                m_process->waitForFinished(-1);
-                if (m_process->exitCode() != 0) {
+                if (!authorizeFile(m_FilePath.at(i))) {
                     emit auditFinished(m_threadCount);
                     return;
                 }
@@ -976,181 +1080,153 @@ void LogAuthThread::handleAudit()
         if (!m_canRun) {
             return;
         }
+    }
 
-        QString byte;
-        if (Utils::convertToMB(DLDBusHandler::instance(this)->getFileSize(m_FilePath.at(i))) > DBUS_THRESHOLD_MAX) {
-            // 日志文件超过100MB，使用文本流读取日志数据，避免DBUS接口被数据流量撑爆
-            auto token = DLDBusHandler::instance(this)->openLogStream(m_FilePath.at(i));
-            while(1) {
-                auto temp = DLDBusHandler::instance(this)->readLogInStream(token);
-
-                if(temp.isEmpty()) {
-                    break;
-                }
-
-                byte += temp;
-            }
-        } else {
-            byte = DLDBusHandler::instance(this)->readLog(m_FilePath.at(i));
+    //多个轮转文件在线程池中并行解析,按文件顺序(从新到旧)交付
+    LogOrderedParser<LOG_MSG_AUDIT> parser(m_canRun);
+    bool completed = parser.run(m_FilePath.count(), LogOrderedParser<LOG_MSG_AUDIT>::idealThreadCount(m_FilePath.count()),
+    [this](int index, const LogOrderedParser<LOG_MSG_AUDIT>::Sink &sink) {
+        parseAuditFile(m_FilePath.at(index), sink);
+    }, [this, &aList](QList<LOG_MSG_AUDIT> &records) {
+        aList.append(records);
+        //每满一批(大小随读取速度调整)就发出信号给控件加载
+        if (m_batchSizer.isFull(aList)) {
+            waitDelivery();
+            emit auditData(m_threadCount, aList);
+            aList.clear();
         }
+    });
+    if (!completed) {
+        return;
+    }
+    //最后可能有余下不足一批的数据
+    if (aList.count() >= 0) {
+        waitDelivery();
+        emit auditData(m_threadCount, aList);
+    }
+    emit auditFinished(m_threadCount);
+}
 
-        byte.replace('\u0000', "").replace("\x01", "");
-        QStringList strList = byte.split('\n', QString::SkipEmptyParts);
-
-        QRegularExpression re;
-        QRegularExpressionMatch match;
-        for (int j = strList.size() - 1; j >= 0; --j) {
-            if (!m_canRun) {
-                return;
-            }
-            QString str = strList.at(j);
-            if (str.isEmpty() || str.indexOf("type=") == -1)
-                continue;
-
-            LOG_MSG_AUDIT msg;
-            //删除颜色格式字符
-            str.replace(QRegExp("\\#033\\[\\d+(;\\d+){0,2}m"), "");
-            // remove Useless characters
-            str.replace(QRegExp("\\x1B\\[\\d+(;\\d+){0,2}m"), "");
-            QStringList list = str.split(" ", QString::SkipEmptyParts);
-            if (list.size() < 2)
-                continue;
-
-            // 事件类型
-            QString eventType = list[0].split("=").last();
-            msg.eventType = eventType;
-
-            // 审计类型
-            QString auditType = "";
-            // 根据事件类型识别审计类型
-            if (auditType.isEmpty())
-                auditType = Utils::auditType(msg.eventType);
-
-            // 根据事件类型未识别出审计类型
-            if (auditType.isEmpty()) {
-                // 判断是否为远程连接审计日志
-                re.setPattern("(?<=addr=)([^= \"]+|(\"(\\\\\"|[^\"])*\"))");
-                match = re.match(str);
-                if (match.hasMatch()) {
-                    QString addr = match.captured(0);
-                    if (QRegExp("\\b(?:(?:25[0-5]|2[0-4][0-9]|[01]?[0-9][0-9]?)\\.){3}(?:25[0-5]|2[0-4][0-9]|[01]?[0-9][0-9]?)\\b").exactMatch(addr))
-                        auditType = Audit_Remote;
-                }
-
-                if (auditType.isEmpty()) {
-                     // 获取key值，识别出一些特殊的审计类型(主要为自定义的审计类型)
-                    re.setPattern("(?<=key=)([^= \"]+|(\"(\\\\\"|[^\"])*\"))");
-                    match = re.match(str);
-                    if (match.hasMatch()) {
-                        QString key = match.captured(0);
-                        key.replace("\"","");
-                        if (!key.isEmpty())
-                            auditType = Utils::auditType(key);
-                    }
-                }
-            }
-
-            // 审计类型依然为空，归为其他类型
-            if (auditType.isEmpty())
-                auditType = Audit_Other;
-
-            msg.auditType = auditType;
-
-            // 时间"(?<=msg=audit\()[^\.]*(?=\.)"
-            re.setPattern("(?<=msg=audit\\()[^\\.]*(?=\\.)");
-            match = re.match(str);
-            if (match.hasMatch()) {
-                QDateTime dateTime = QDateTime::fromTime_t(match.captured(0).toUInt());
-                qint64 iTime = dateTime.toMSecsSinceEpoch();
-                //对时间筛选
-                if (m_auditFilters.timeFilterBegin > 0 && m_auditFilters.timeFilterEnd > 0) {
-                    if (iTime < m_auditFilters.timeFilterBegin || iTime > m_auditFilters.timeFilterEnd)
-                        continue;
-                }
-                msg.dateTime = dateTime.toString("yyyy-MM-dd hh:mm:ss");
-            }
-
-            // 进程名
-            QString processName = "";
-            re.setPattern("(?<=comm=\\\")([^= \"]+|(\"(\\\\\"|[^\"])*\"))");
-            match = re.match(str);
-            if (match.hasMatch()) {
-                processName = match.captured(0);
-                processName.replace("\"","");
-            }
-
-            if (processName.isEmpty()) {
-                re.setPattern("(?<=exe=\\\")([^= \"]+|(\"(\\\\\"|[^\"])*\"))");
-                match = re.match(str);
-                if (match.hasMatch()) {
-                    processName = match.captured(0);
-                    processName.replace("\"","");
-                    processName = processName.split("/").last();
-                }
-            }
-
-            if (processName.isEmpty())
-                processName = "N/A";
-            msg.processName = processName;
-
-            // 状态
-            QString status = "";
-            re.setPattern("(?<=success=)([^= \"]+|(\"(\\\\\"|[^\"])*\"))");
-            match = re.match(str);
-            if (match.hasMatch()) {
-                status = match.captured(0);
-                if (status == "yes")
-                    status = "OK";
-                else
-                    status = "Failed";
-            }
-
-            if (status.isEmpty()) {
-                re.setPattern("(?<=res=)([^= ']+|('(\\\\'|[^'])*'))");
-                match = re.match(str);
-                if (match.hasMatch()) {
-                    status = match.captured(0);
-                    if (status == "success")
-                        status = "OK";
-                    else
-                        status = "Failed";
+/**
+ * @brief LogAuthThread::parseAuditFile 解析一个文件,按从新到旧的顺序分批交出
+ * @param filePath 日志文件路径
+ * @param sink 交出一批数据,返回false时已被停止
+ */
+void LogAuthThread::parseAuditFile(const QString &filePath, const LogOrderedParser<LOG_MSG_AUDIT>::Sink &sink)
+{
+    QList<LOG_MSG_AUDIT> aList;
+    //按块从新到旧读取,每块解析完立即发出,不需要把整个文件读入内存,也避免DBUS接口被数据流量撑爆
+    LogLineStream stream(filePath, this);
+    stream.setFilter(LogLineFilter::timeRange(m_auditFilters.timeFilterBegin, m_auditFilters.timeFilterEnd));
+    //单个大文件在进程内读取时切分为多块并行解析,切分点不落在同一事件的多行记录之间
+    if (stream.openDirect()) {
+        //按时间顺序写入的大文件查时间索引,只读取时间段所在的部分
+        if (m_auditFilters.timeFilterBegin > 0 && m_auditFilters.timeFilterEnd > 0)
+            stream.seekTimeRange(m_auditFilters.timeFilterBegin, m_auditFilters.timeFilterEnd, &LogLineFilter::prefixTime, LOG_TIME_INDEX_LINE);
+        const QVector<qint64> bounds = stream.splitRange(LOG_CHUNK_BYTES, &LogAuditParser::eventKey);
+        if (bounds.size() > 2) {
+            LogChunkParser<LOG_MSG_AUDIT> parser(m_canRun);
+            parser.run(bounds.size() - 1, LogRecordReader::parseThreadsFor(m_FilePath.count()),
+            [this, &stream, &bounds](int index, QList<LOG_MSG_AUDIT> &events) {
+                //每块用pread读出后再解码,文件在读取期间被截断时停止
+                QByteArray data;
+                if (!stream.readRange(bounds.at(index + 1), bounds.at(index), data))
+                    return false;
+                //每块各取一个上下文,行缓冲和字符串池在块之间、加载之间复用
+                LogParseContextPool::Lease context = LogParseContextPool::instance().acquire("audit");
+                QStringList &lines = context->lines;
+                LogStringPool &strings = context->strings;
+                LogLineStream::decodeRange(data.constData(), 0, data.size(), lines);
+                QList<LogAuditRecord> eventRecords;
+                LogAuditRecord record;
+                for (const QString &line : lines) {
+                    if (!m_canRun)
+                        return false;
+                    addAuditLine(line, record, eventRecords, events, strings);
                 }
+                flushAuditEvent(eventRecords, events, strings);
+                return true;
+            }, [&aList, &sink](QList<LOG_MSG_AUDIT> &events) {
+                aList.append(events);
+                //每解析出SINGLE_READ_CNT条交给sink,发往界面的批次大小由交付一侧按读取速度调整
+                if (aList.count() >= SINGLE_READ_CNT && !sink(aList))
+                    return false;
+                return true;
+            });
+            if (m_canRun && !aList.isEmpty())
+                sink(aList);
+            return;
+        }
+    }
 
-                if (status.isEmpty())
-                    status = "OK";
-            }
-
-            msg.status = status;
-
-            // 信息，将“msg=audit(1688526389.214:61):”之后的内容作为详细信息
-            msg.msg = str.right(str.length() - str.indexOf("):") - 3);
-
-            // 原文
-            msg.origin = str;
-
-            aList.append(msg);
+    LogParseContextPool::Lease context = LogParseContextPool::instance().acquire("audit");
+    QStringList &strList = context->lines;
+    //同一事件的多行记录是连续的,编号变化时上一个事件的记录已经读全
+    QList<LogAuditRecord> eventRecords;
+    LogAuditRecord record;
+    LogStringPool &strings = context->strings;
+    while (stream.readChunk(strList)) {
+        for (int j = 0; j < strList.size(); ++j) {
             if (!m_canRun) {
                 return;
             }
-            //每获得500个数据就发出信号给控件加载
-            if (aList.count() % SINGLE_READ_CNT == 0) {
-                emit auditData(m_threadCount, aList);
-                aList.clear();
-            }
-            if (!m_canRun) {
-                return;
+            //每解析出SINGLE_READ_CNT条交给sink,发往界面的批次大小由交付一侧按读取速度调整
+            if (addAuditLine(strList.at(j), record, eventRecords, aList, strings) && aList.count() % SINGLE_READ_CNT == 0) {
+                if (!sink(aList))
+                    return;
             }
         }
     }
-    //最后可能有余下不足500的数据
-    if (aList.count() >= 0) {
-        emit auditData(m_threadCount, aList);
-    }
-    emit auditFinished(m_threadCount);
+    flushAuditEvent(eventRecords, aList, strings);
+    //最后交出余下不足SINGLE_READ_CNT条的数据
+    if (!aList.isEmpty())
+        sink(aList);
+}
+
+/**
+ * @brief LogAuthThread::addAuditLine 解析一行审计记录,事件编号变化时把上一个事件加入events
+ * @return 是否有事件加入了events
+ */
+bool LogAuthThread::addAuditLine(QString line, LogAuditRecord &record, QList<LogAuditRecord> &eventRecords,
+                                 QList<LOG_MSG_AUDIT> &events, LogStringPool &strings)
+{
+    if (line.isEmpty() || line.indexOf("type=") == -1)
+        return false;
+
+    //删除颜色格式字符
+    LogParseMatchers::stripColorSequences(line);
+    if (!LogAuditParser::parseLine(line, record))
+        return false;
+
+    bool added = false;
+    //没有事件编号的记录单独成为一个事件
+    if (!eventRecords.isEmpty() && (record.eventId.isEmpty() || record.eventId != eventRecords.first().eventId))
+        added = flushAuditEvent(eventRecords, events, strings);
+    eventRecords.append(record);
+    return added;
+}
+
+/**
+ * @brief LogAuthThread::flushAuditEvent 把已读全的一个事件按时间筛选后加入events
+ * @return 事件是否在筛选范围内
+ */
+bool LogAuthThread::flushAuditEvent(QList<LogAuditRecord> &eventRecords, QList<LOG_MSG_AUDIT> &events, LogStringPool &strings)
+{
+    if (eventRecords.isEmpty())
+        return true;
+    qint64 iTime = static_cast<qint64>(eventRecords.last().time) * 1000;
+    //对时间筛选,没有时间的记录不筛选
+    bool inRange = iTime == 0 || !(m_auditFilters.timeFilterBegin > 0 && m_auditFilters.timeFilterEnd > 0)
+                   || (iTime >= m_auditFilters.timeFilterBegin && iTime <= m_auditFilters.timeFilterEnd);
+    if (inRange)
+        events.append(LogAuditParser::buildEvent(eventRecords, &strings));
+    eventRecords.clear();
+    return inRange;
 }
 
 void LogAuthThread::handleCoredump()
 {
+    PERF_ALLOC_SCOPE("LogAuthThread::handleCoredump");
     QStringList sigList;
     sigList << "SIGHUP" << "SIGINT" << "SIGQUIT" << "SIGILL" << "SIGTRAP" << "SIGABRT" << "SIGBUS" << "SIGFPE" << "SIGKILL" << "SIGUSR1"
             << "SIGSEGV" << "SIGUSR2" << "SIGPIPE" << "SIGALRM" << "SIGTERM" << "SIGSTKFLT" << "SIGCHLD" << "SIGCONT" << "SIGSTOP" << "SIGTSTP"
@@ -1162,110 +1238,47 @@ void LogAuthThread::handleCoredump()
     }
     QList<LOG_MSG_COREDUMP> coredumpList;
 
-    QString byte;
-    initProccess();
-    if (Utils::runInCmd) {
-        byte = DLDBusHandler::instance()->readLog("coredump");
-        byte = byte.replace('\u0000', "").replace("\x01", "");
-    } else {
-        m_process->start("pkexec", QStringList() << "logViewerAuth" <<
-                         QStringList() << "coredumpctl-list" << SharedMemoryManager::instance()->getRunnableKey());
-        m_process->waitForFinished(-1);
-        QByteArray outByte = m_process->readAllStandardOutput();
-        byte = Utils::replaceEmptyByteArray(outByte);
+    //一次遍历journal中systemd-coredump的记录,元数据取自COREDUMP_*字段,堆栈和maps在打开详情或上报时再读取
+    JournalReadOptions options;
+    if (m_coredumpFilters.timeFilterBegin > 0 && m_coredumpFilters.timeFilterEnd > 0) {
+        options.hasTimeRange = true;
+        options.beginTime = static_cast<quint64>(m_coredumpFilters.timeFilterBegin) * 1000;
+        options.endTime = static_cast<quint64>(m_coredumpFilters.timeFilterEnd) * 1000;
+    } else if (m_coredumpFilters.timeFilterBegin > 0) {
+        //没有结束时间时读到最新,游标不会落在被跳过的条目上
+        options.hasTimeRange = true;
+        options.beginTime = static_cast<quint64>(m_coredumpFilters.timeFilterBegin) * 1000;
+        options.endTime = std::numeric_limits<quint64>::max();
     }
-
-    QStringList strList =  QString(byte).split('\n', QString::SkipEmptyParts);
-
-    QRegExp re("(Storage: )\\S+");
-    for (int i = strList.size() - 1; i >= 0 ; --i)  {
-        QString str = strList.at(i);
-        if (!m_canRun) {
-            return;
-        }
-        if (str.trimmed().isEmpty()) {
-            continue;
+    //增量上报时从最新的记录倒序读到上次上报的最后一条为止,时间范围只作为游标失效(已被轮转删除)时的下限
+    options.stopCursor = m_coredumpFilters.stopCursor.toUtf8();
+
+    JournalReader<CoredumpJournalPolicy> reader(CoredumpJournalPolicy(), m_canRun);
+    int r = reader.read(options, coredumpList, [&](QList<LOG_MSG_COREDUMP> &list) {
+        for (LOG_MSG_COREDUMP &coredumpMsg : list) {
+            // 获取信号名称
+            int sigId = coredumpMsg.sig.toInt();
+            if (sigId > 0 && sigId <= sigList.size())
+                coredumpMsg.sig = sigList[sigId - 1];
+            //获取用户名,同一用户的崩溃通常很多,由LogUserNames缓存;查询不到时保留uid
+            bool uidOk = false;
+            const uint uid = coredumpMsg.uid.toUInt(&uidOk);
+            const QString userName = uidOk ? Utils::getUserNamebyUID(uid) : QString();
+            if (!userName.isEmpty())
+                coredumpMsg.uid = userName;
         }
-        QStringList tmpList = str.split(" ", QString::SkipEmptyParts);
-        if (tmpList.count() < 10)
-            continue;
-
-        LOG_MSG_COREDUMP coredumpMsg;
-        coredumpMsg.dateTime = tmpList[1] + " " + tmpList[2];
-        QDateTime dt = QDateTime::fromString(coredumpMsg.dateTime, "yyyy-MM-dd hh:mm:ss");
-        if (m_coredumpFilters.timeFilterBegin > 0 && m_coredumpFilters.timeFilterEnd > 0) {
-            if (dt.toMSecsSinceEpoch() < m_coredumpFilters.timeFilterBegin
-                    || dt.toMSecsSinceEpoch() > m_coredumpFilters.timeFilterEnd)
-                continue;
-        }
-
-        // 获取信号名称
-        int sigId = tmpList[7].toInt();
-        if ( sigId <= sigList.size()) {
-            coredumpMsg.sig = sigList[sigId - 1];
-        } else {
-            coredumpMsg.sig = tmpList[7];
-        }
-        //获取用户名
-        coredumpMsg.uid = Utils::getUserNamebyUID(tmpList[5].toUInt());
-        coredumpMsg.coreFile = tmpList[8];
-        coredumpMsg.exe = tmpList[9];
-        coredumpMsg.pid = tmpList[4];
-        // 解析coredump文件保存位置
-        if (coredumpMsg.coreFile != "missing") {
-            // 若coreFile状态为missing，表示文件已丢失，不继续解析文件位置
-            QString outInfoByte;
-            if (Utils::runInCmd) {
-                outInfoByte = DLDBusHandler::instance()->readLog(QString("coredumpctl info %1").arg(coredumpMsg.pid));
-            } else {
-                m_process->start("pkexec", QStringList() << "logViewerAuth" << QStringList() << "coredumpctl-info"
-                                 << coredumpMsg.pid <<SharedMemoryManager::instance()->getRunnableKey());
-                m_process->waitForFinished(-1);
-                outInfoByte = m_process->readAllStandardOutput();
-            }
-            // 解析第一条堆栈信息
-            QStringList strList = outInfoByte.split("Stack trace of thread");
-            if (strList.size() > 1) {
-                coredumpMsg.stackInfo = "Stack trace of thread" + strList[1];
-            }
-            re.indexIn(outInfoByte);
-            coredumpMsg.storagePath = re.cap(0).replace("Storage: ", "");
-            
-            // get maps info
-            const QString &corePath =  QDir::homePath() + QString("/%1.dump").arg(QFileInfo(coredumpMsg.storagePath).fileName());
-            if (Utils::runInCmd) {
-                DLDBusHandler::instance()->readLog(QString("coredumpctl dump %1 -o %2").arg(coredumpMsg.pid).arg(corePath));
-                outInfoByte = DLDBusHandler::instance()->readLog(QString("readelf -n %1").arg(corePath));
-            } else {
-                m_process->start("pkexec", QStringList() << "logViewerAuth" << QStringList() << "coredumpctl-dump"
-                                 << coredumpMsg.pid << corePath << SharedMemoryManager::instance()->getRunnableKey());
-                m_process->waitForFinished(-1);
-                m_process->start("pkexec", QStringList() << "logViewerAuth" << QStringList() << "readelf"
-                                 << corePath << SharedMemoryManager::instance()->getRunnableKey());
-                m_process->waitForFinished(-1);
-                outInfoByte = m_process->readAllStandardOutput();
-            }
-            coredumpMsg.maps = outInfoByte;
-            QFile::remove(corePath);
-        } else {
-            coredumpMsg.storagePath = QString("coredump file is missing");
-        }
-
-        coredumpList.append(coredumpMsg);
-        //每获得500个数据就发出信号给控件加载
-        if (coredumpList.count() % SINGLE_READ_CNT == 0) {
-            emit coredumpData(m_threadCount, coredumpList);
-            coredumpList.clear();
-        }
-    }
-
-    if (!m_canRun) {
+        //每满一批(大小由JournalReader按读取速度调整)就发出信号给控件加载
+        waitDelivery();
+        emit coredumpData(m_threadCount, list);
+    });
+    //被停止时不再发出任何信号
+    if (r == -ECANCELED || !m_canRun)
         return;
-    }
-    //最后可能有余下不足500的数据
-    if (coredumpList.count() >= 0) {
-        emit coredumpData(m_threadCount, coredumpList);
-    }
+    if (r < 0)
+        qWarning() << "read coredump journal failed:" << reader.errorString();
+
+    if (!reader.newestCursor().isEmpty())
+        emit coredumpCursor(m_threadCount, reader.newestCursor());
     emit coredumpFinished(m_threadCount);
 }
 
@@ -1280,34 +1293,34 @@ void LogAuthThread::initProccess()
 }
 
 /**
- * @brief LogAuthThread::formatDateTime 内核日志没有年份 格式为Sep 29 15:53:34 所以需要特殊转换
- * @param m 月份字符串
- * @param d 日期字符串
- * @param t 时间字符串
- * @return 时间毫秒数
+ * @brief LogAuthThread::authorizeFile 读取受保护的日志前提权鉴权,同一目录在本次运行中只鉴权一次,
+ * 一组轮转日志只启动一次logViewerAuth
+ * @param path 日志文件
+ * @return 已鉴权或本次鉴权成功返回true
  */
-qint64 LogAuthThread::formatDateTime(QString m, QString d, QString t)
+bool LogAuthThread::authorizeFile(const QString &path)
 {
-    QLocale local(QLocale::English, QLocale::UnitedStates);
-
-    QDate curdt = QDate::currentDate();
-
-    QString tStr = QString("%1 %2 %3 %4").arg(m).arg(d).arg(curdt.year()).arg(t);
-    QDateTime dt = local.toDateTime(tStr, "MMM d yyyy hh:mm:ss");
-    return dt.toMSecsSinceEpoch();
+    return LogAuthCache::instance()->authorize(path, [this, &path]() {
+        initProccess();
+        m_process->setProcessChannelMode(QProcess::MergedChannels);
+        //共享内存对应变量置true，允许进程内部逻辑运行
+        ShareMemoryInfo shareInfo;
+        shareInfo.isStart = true;
+        SharedMemoryManager::instance()->setRunnableTag(shareInfo);
+        //运行的时候把对应共享内存的名称传进去，方便获取进程拿标记量判断是否继续运行
+        m_process->start("pkexec", QStringList() << "logViewerAuth"
+                         << path << SharedMemoryManager::instance()->getRunnableKey() << LOG_AUTH_NO_DATA);
+        return LogCancelToken::current().waitForProcess(m_process.data()) && m_process->exitCode() == 0;
+    });
 }
 
 /**
- * @brief LogAuthThread::formatDateTime 内核日志有年份 格式为2020-01-05 所以需要特殊转换
- * @param y 年月日
- * @param t 时间字符串
- * @return 时间毫秒数
+ * @brief LogAuthThread::waitDelivery 发出一批数据前等待界面的发送额度,界面插入慢时随之放慢解析
  */
-qint64 LogAuthThread::formatDateTime(QString y, QString t)
+void LogAuthThread::waitDelivery()
 {
-    //when /var/kern.log have the year
-    QLocale local(QLocale::English, QLocale::UnitedStates);
-    QString tStr = QString("%1 %2").arg(y).arg(t);
-    QDateTime dt = local.toDateTime(tStr, "yyyy-MM-dd hh:mm:ss");
-    return dt.toMSecsSinceEpoch();
+    if (m_credits)
+        m_credits->acquire(m_canRun);
+    //等待的时间计入发送周期,界面处理慢时之后的批次随之变大
+    m_batchSizer.delivered();
 }
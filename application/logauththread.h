@@ -5,12 +5,20 @@
 #ifndef LOGAUTHTHREAD_H
 #define LOGAUTHTHREAD_H
 #include "structdef.h"
+#include "logorderedparser.h"
+#include "logingestmetrics.h"
+#include "logdeliverycredits.h"
+#include "logbatchsizer.h"
 
 #include <QProcess>
 #include <QRunnable>
 #include <QMap>
 
 #include <mutex>
+
+struct LogAuditRecord;
+class LogLineStream;
+class LogStringPool;
 /**
  * @brief The LogAuthThread class 启动日志 内核日志 kwin日志 xorg日志 dpkg日志获取线程
  */
@@ -34,8 +42,6 @@ public:
         }
         return sin;
     }
-    void initDnfLevelMap();
-    void initLevelMap();
     QString getStandardOutput();
     QString getStandardError();
     void setType(LOG_FLAG flag) { m_type = flag; }
@@ -50,6 +56,9 @@ public:
     void setFileterParam(const COREDUMP_FILTERS &iFIlters) { m_coredumpFilters = iFIlters; }
     void stopProccess();
     void setFilePath(const QStringList &filePath);
+    void setLowPriority(bool lowPriority) { m_lowPriority = lowPriority; }
+    void setKernFromJournal(bool fromJournal) { m_kernFromJournal = fromJournal; }
+    void setDeliveryCredits(const LogDeliveryCreditsPtr &credits) { m_credits = credits; }
     int getIndex();
     QString startTime();
     /**
@@ -61,21 +70,28 @@ protected:
 
     void handleBoot();
     void handleKern();
+    void parseKernFile(const QString &filePath, const LogOrderedParser<LOG_MSG_JOURNAL>::Sink &sink);
+    void handleKernJournal();
     void handleKwin();
+    void seekKwinTail(LogLineStream &stream, LogTailPosition &tail);
     void handleXorg();
+    void parseXorgFile(const QString &filePath, const LogOrderedParser<LOG_MSG_XORG>::Sink &sink);
+    static bool parseXorgLine(const QString &line, LOG_MSG_XORG &msg);
+    static qint64 xorgStartTime(const char *data, qint64 size);
     void handleDkpg();
+    void parseDpkgFile(const QString &filePath, const LogOrderedParser<LOG_MSG_DPKG>::Sink &sink);
     void handleNormal();
-    /**
-     * @brief NormalInfoTime 开关机事件信息段解析
-     */
-    void NormalInfoTime();
     void handleDnf();
     void handleDmesg();
     void handleAudit();
+    void parseAuditFile(const QString &filePath, const LogOrderedParser<LOG_MSG_AUDIT>::Sink &sink);
+    bool addAuditLine(QString line, LogAuditRecord &record, QList<LogAuditRecord> &eventRecords,
+                      QList<LOG_MSG_AUDIT> &events, LogStringPool &strings);
+    bool flushAuditEvent(QList<LogAuditRecord> &eventRecords, QList<LOG_MSG_AUDIT> &events, LogStringPool &strings);
     void handleCoredump();
     void initProccess();
-    qint64 formatDateTime(QString m, QString d, QString t);
-    qint64 formatDateTime(QString y, QString t);
+    bool authorizeFile(const QString &path);
+    void waitDelivery();
 
 signals:
     void kernFinished(int index);
@@ -100,12 +116,18 @@ signals:
     void dpkgData(int index, QList<LOG_MSG_DPKG> iDataList);
     void normalFinished(int index);
     void normalData(int index, QList<LOG_MSG_NORMAL> iDataList);
-    void dnfFinished(QList<LOG_MSG_DNF> iKwinList);
-    void dmesgFinished(QList<LOG_MSG_DMESG> iKwinList);
+    void dnfFinished(int index);
+    void dnfData(int index, QList<LOG_MSG_DNF> iDataList);
+    void dmesgFinished(int index);
+    void dmesgData(int index, QList<LOG_MSG_DMESG> iDataList);
     void auditFinished(int index, bool bShowTip = false);
     void auditData(int index, QList<LOG_MSG_AUDIT> iDataList);
     void coredumpFinished(int index);
     void coredumpData(int index, QList<LOG_MSG_COREDUMP> iDataList);
+    /**
+     * @brief coredumpCursor 本次读取到的最新一条崩溃记录的游标,供增量上报时作为截止位置
+     */
+    void coredumpCursor(int index, const QString &cursor);
     void proccessError(const QString &iError);
 public slots:
     //    void onFinished(int exitCode);
@@ -155,20 +177,26 @@ private:
      * @brief m_canRun 是否可以继续运行的标记量，用于停止运行线程
      */
     std::atomic_bool m_canRun = false;
+    //构造时(界面发起加载时)所属加载的指标计数,运行时安装到解析线程
+    LogIngestCountersPtr m_ingest {LogIngestMetrics::current()};
     /**
      * @brief m_threadIndex 当前线程标号
      */
     int m_threadCount;
     //正在执行停止进程的变量，防止重复执行停止逻辑
     bool m_isStopProccess = false;
+    //后台预取时以最低优先级运行,只在预取专用的线程池中设置
+    bool m_lowPriority = false;
+    //内核日志从journal的内核来源读取,不解析kern.log
+    bool m_kernFromJournal = false;
+    //界面的发送额度,发出数据前等待界面处理完之前的批次;为空时不限制(命令行、预取等)
+    LogDeliveryCreditsPtr m_credits;
+    //发送给界面的批次大小,按读取速度和发送等待时间调整
+    LogBatchSizer m_batchSizer;
     //日志显示时间(毫秒)
     qint64 iTime;
     //所有日志文件路径
     QStringList m_FilePath;
-    QMap<int, QString> m_levelMap;
-    QMap<QString, int> m_dnfLevelDict;
-    QMap<QString, QString> m_transDnfDict;
-    QStringList TimeList;
 };
 
 #endif  // LOGAUTHTHREAD_H
@@ -5,25 +5,40 @@
 #include "logbackend.h"
 #include "logallexportthread.h"
 #include "logfileparser.h"
+#include "journalreader.h"
+#include "logrecordfilter.h"
+#include "logparsematchers.h"
+#include "loglocaltime.h"
+#include "logcoredumpdetail.h"
 #include "logexportthread.h"
+#include "logexportwriter.h"
+#include "logexportipc.h"
+#include "logrecordformatter.h"
 #include "logsettings.h"
 #include "utils.h"
 #include "dbusmanager.h"
 #include "dbusproxy/dldbushandler.h"
 #include "logapplicationhelper.h"
+#include "logcategoryprobe.h"
 #include "DebugTimeManager.h"
 #include "eventlogutils.h"
+#include "logworkscheduler.h"
+#include "logrecordparser.h"
 
 #include <sys/utsname.h>
+#include <unistd.h>
 
 #include <DSysInfo>
 
 #include <QDateTime>
+#include <QFile>
 #include <QStandardPaths>
-#include <QThreadPool>
 #include <QLoggingCategory>
 #include <QCoreApplication>
 
+#include <algorithm>
+#include <memory>
+
 #ifdef QT_DEBUG
 Q_LOGGING_CATEGORY(logBackend, "org.deepin.log.viewer.backend")
 #else
@@ -51,7 +66,7 @@ LogBackend::LogBackend(QObject *parent) : QObject(parent)
     getLogTypes();
 
     m_cmdWorkDir = QDir::currentPath();
-    Utils::m_mapAuditType2EventType = LogSettings::instance()->loadAuditMap();
+    Utils::setAuditMap(LogSettings::instance()->loadAuditMap());
 }
 
 void LogBackend::setCmdWorkDir(const QString &dirPath)
@@ -61,6 +76,21 @@ void LogBackend::setCmdWorkDir(const QString &dirPath)
         m_cmdWorkDir = dirPath;
 }
 
+void LogBackend::setCompressExport(bool compress)
+{
+    m_compressExport = compress;
+}
+
+void LogBackend::setJsonExport(bool json)
+{
+    m_jsonExport = json;
+}
+
+void LogBackend::setIncrementalExport(bool incremental)
+{
+    m_incrementalExport = incremental;
+}
+
 int LogBackend::exportAllLogs(const QString &outDir)
 {
     if(!getOutDirPath(outDir))
@@ -85,6 +115,7 @@ int LogBackend::exportAllLogs(const QString &outDir)
 
     LogAllExportThread *thread = new LogAllExportThread(m_logTypes, fileFullPath);
     thread->setAutoDelete(true);
+    thread->setIncremental(m_incrementalExport);
     connect(thread, &LogAllExportThread::exportFinsh, this, [ = ](bool ret) {
         if (ret) {
             qCInfo(logBackend) << "exporting all logs done.";
@@ -101,7 +132,7 @@ int LogBackend::exportAllLogs(const QString &outDir)
             qApp->exit(-1);
         }
     });
-    QThreadPool::globalInstance()->start(thread);
+    LogWorkScheduler::instance()->start(thread, LogWorkScheduler::Export);
 
     Utils::resetToNormalAuth(m_outPath);
 
@@ -145,8 +176,7 @@ int LogBackend::exportTypeLogs(const QString &outDir, const QString &type)
         if (logPaths.size() > 0) {
             resetCategoryOutputPath(categoryOutPath);
 
-            for (auto &file: logPaths)
-                DLDBusHandler::instance()->exportLog(categoryOutPath, file, true);
+            DLDBusHandler::instance()->exportLogFiles(categoryOutPath, logPaths);
         } else if (logPaths.size() == 0) {
             qCWarning(logBackend) << "/var/log has not kern.log";
             bSuccess = false;
@@ -164,8 +194,7 @@ int LogBackend::exportTypeLogs(const QString &outDir, const QString &type)
         if (!logPaths.isEmpty()) {
             resetCategoryOutputPath(categoryOutPath);
 
-            for (auto &file: logPaths)
-                DLDBusHandler::instance()->exportLog(categoryOutPath, file, true);
+            DLDBusHandler::instance()->exportLogFiles(categoryOutPath, logPaths);
         } else {
             qCWarning(logBackend) << "/var/log has not boot.log";
             bSuccess = false;
@@ -177,8 +206,7 @@ int LogBackend::exportTypeLogs(const QString &outDir, const QString &type)
         if (!logPaths.isEmpty()) {
             resetCategoryOutputPath(categoryOutPath);
 
-            for (auto &file: logPaths)
-                DLDBusHandler::instance()->exportLog(categoryOutPath, file, true);
+            DLDBusHandler::instance()->exportLogFiles(categoryOutPath, logPaths);
         } else {
             qCWarning(logBackend) << "/var/log has not dpkg.log";
             bSuccess = false;
@@ -190,8 +218,7 @@ int LogBackend::exportTypeLogs(const QString &outDir, const QString &type)
         if (!logPaths.isEmpty()) {
             resetCategoryOutputPath(categoryOutPath);
 
-            for (auto &file: logPaths)
-                DLDBusHandler::instance()->exportLog(categoryOutPath, file, true);
+            DLDBusHandler::instance()->exportLogFiles(categoryOutPath, logPaths);
         } else {
             qCWarning(logBackend) << "/var/log has not dnf.log";
             bSuccess = false;
@@ -209,8 +236,7 @@ int LogBackend::exportTypeLogs(const QString &outDir, const QString &type)
         if (!logPaths.isEmpty()) {
             resetCategoryOutputPath(categoryOutPath);
 
-            for (auto &file: logPaths)
-                DLDBusHandler::instance()->exportLog(categoryOutPath, file, true);
+            DLDBusHandler::instance()->exportLogFiles(categoryOutPath, logPaths);
         } else {
             qCWarning(logBackend) << "/var/log has not Xorg.log";
             bSuccess = false;
@@ -221,7 +247,7 @@ int LogBackend::exportTypeLogs(const QString &outDir, const QString &type)
         categoryOutPath = QString("%1/%2/").arg(m_outPath).arg("apps");
         resetCategoryOutputPath(categoryOutPath);
 
-        QMap<QString, QString> appData = LogApplicationHelper::instance()->getMap();
+        QMap<QString, QString> appData = LogApplicationHelper::instance()->getMap(true);
         for (auto &it2 : appData.toStdMap()) {
             QString appName = Utils::appName(it2.second);
             if (appName.isEmpty())
@@ -243,8 +269,7 @@ int LogBackend::exportTypeLogs(const QString &outDir, const QString &type)
             if (parseType == "file") {
                 QStringList logPaths = DLDBusHandler::instance(nullptr)->getFileInfo(it2.second);
                 logPaths.removeDuplicates();
-                for (auto &file: logPaths)
-                    DLDBusHandler::instance()->exportLog(tmpSubCategoryOutPath, file, true);
+                DLDBusHandler::instance()->exportLogFiles(tmpSubCategoryOutPath, logPaths);
             } else if (parseType == "journal") {
                 DLDBusHandler::instance()->exportLog(tmpSubCategoryOutPath, "journalctl_app", false);
             }
@@ -256,8 +281,7 @@ int LogBackend::exportTypeLogs(const QString &outDir, const QString &type)
         if (!logPaths.isEmpty()) {
             resetCategoryOutputPath(categoryOutPath);
 
-            for (auto &file: logPaths)
-                DLDBusHandler::instance()->exportLog(categoryOutPath, file, true);
+            DLDBusHandler::instance()->exportLogFiles(categoryOutPath, logPaths);
         } else {
             qCWarning(logBackend) << "/var/log has no coredump logs";
             bSuccess = false;
@@ -287,9 +311,7 @@ int LogBackend::exportTypeLogs(const QString &outDir, const QString &type)
             if (logPaths.size() > 1) {
                 QString tmpSubCategoryOutPath = QString("%1/%2/").arg(categoryOutPath).arg(it2.at(0));
                 Utils::mkMutiDir(tmpSubCategoryOutPath);
-                for (auto &file : logPaths) {
-                    DLDBusHandler::instance()->exportLog(tmpSubCategoryOutPath, file, true);
-                }
+                DLDBusHandler::instance()->exportLogFiles(tmpSubCategoryOutPath, logPaths);
             }
             else if (logPaths.size() == 1)
                  DLDBusHandler::instance()->exportLog(categoryOutPath, logPaths[0], true);
@@ -307,9 +329,7 @@ int LogBackend::exportTypeLogs(const QString &outDir, const QString &type)
             categoryOutPath = QString("%1/%2/").arg(m_outPath).arg("customized");
             resetCategoryOutputPath(categoryOutPath);
 
-            for (auto &file : logPaths) {
-                DLDBusHandler::instance()->exportLog(categoryOutPath, file, true);
-            }
+            DLDBusHandler::instance()->exportLogFiles(categoryOutPath, logPaths);
         } else {
             qCWarning(logBackend) << "no custom logs";
             bSuccess = false;
@@ -321,8 +341,7 @@ int LogBackend::exportTypeLogs(const QString &outDir, const QString &type)
         if (!logPaths.isEmpty()) {
             resetCategoryOutputPath(categoryOutPath);
 
-            for (auto &file: logPaths)
-                DLDBusHandler::instance()->exportLog(categoryOutPath, file, true);
+            DLDBusHandler::instance()->exportLogFiles(categoryOutPath, logPaths);
         } else {
             qCWarning(logBackend) << "/var/log has no audit logs";
             bSuccess = false;
@@ -348,6 +367,113 @@ bool LogBackend::LogBackend::exportTypeLogsByCondition(const QString &outDir, co
     if (!getOutDirPath(outDir))
         return false;
 
+    m_sessionType = Export;
+    return parseTypeLogsByCondition(type, period, condition, keyword);
+}
+
+/**
+ * @brief LogBackend::queryTypeLogsByCondition 按条件查询日志,解析出的每批数据过滤后直接写到标准输出
+ * 输出格式和导出的txt一致,设置setJsonExport时每条记录为一行json
+ */
+bool LogBackend::queryTypeLogsByCondition(const QString &type, const QString &period, const QString &condition, const QString &keyword)
+{
+    QString error;
+    const LOG_FLAG flag = type2Flag(type, error);
+    //应用日志按-d查询;崩溃日志导出为压缩包,没有文本格式
+    if (NONE == flag || APP == flag || COREDUMP == flag || exportLabels(flag).isEmpty()) {
+        qCWarning(logBackend) << (NONE == flag ? error : QString("query %1 logs is not supported.").arg(type));
+        return false;
+    }
+    if (!beginQuery())
+        return false;
+
+    m_sessionType = Query;
+    if (!parseTypeLogsByCondition(type, period, condition, keyword))
+        return false;
+    m_queryLabels = exportLabels(m_flag);
+    return true;
+}
+
+/**
+ * @brief LogBackend::queryAppLogsByCondition 按条件查询应用日志,输出方式同queryTypeLogsByCondition
+ */
+bool LogBackend::queryAppLogsByCondition(const QString &appName, const QString &period, const QString &level, const QString &keyword)
+{
+    if (!beginQuery())
+        return false;
+
+    m_sessionType = Query;
+    if (!parseAppLogsByCondition(appName, period, level, keyword))
+        return false;
+    m_queryLabels = exportLabels(APP);
+    m_queryAppName = LogApplicationHelper::instance()->transName(Utils::appName(m_curAppLog));
+    return true;
+}
+
+/**
+ * @brief LogBackend::followTypeLogs 实时跟踪日志,只输出启动之后新产生的日志,输出格式同queryTypeLogsByCondition
+ * 系统日志通过sd_journal_wait等待,kern.log、dpkg.log和kwin日志通过inotify跟踪追加的内容,dmesg直接跟踪/dev/kmsg
+ * @param type 日志种类,支持system、kernel、dmesg、dpkg和kwin
+ * @param level 等级筛选,文本日志没有等级,忽略该条件
+ * @param keyword 关键字
+ */
+bool LogBackend::followTypeLogs(const QString &type, const QString &level, const QString &keyword)
+{
+    QString error;
+    const LOG_FLAG flag = type2Flag(type, error);
+    if (JOURNAL != flag && KERN != flag && Dmesg != flag && DPKG != flag && Kwin != flag) {
+        qCWarning(logBackend) << (NONE == flag ? error : QString("follow %1 logs is not supported.").arg(type));
+        return false;
+    }
+
+    const int lId = level2Id(level);
+    if (-2 == lId) {
+        qCWarning(logBackend) << "invalid 'level' parameter: " << level << "\nUSEAGE: 0(emerg), 1(alert), 2(crit), 3(error), 4(warning), 5(notice), 6(info), 7(debug)";
+        return false;
+    }
+
+    initParser();
+    if (!m_pParser || !beginQuery())
+        return false;
+
+    m_sessionType = Follow;
+    m_flag = flag;
+    m_currentSearchStr = keyword;
+    m_queryLabels = exportLabels(flag);
+
+    qCInfo(logBackend) << "following ... type:" << type << "level:" << level << "keyword:" << keyword;
+
+    switch (flag) {
+    case JOURNAL: {
+        QStringList arg;
+        if (lId != LVALL)
+            arg.append(QString("PRIORITY=%1").arg(lId));
+        else
+            arg.append("all");
+        //起始游标为空时从journal当前尾部开始
+        m_followCurrentIndex = m_pParser->parseByJournalFollow(arg, QString());
+    }
+    break;
+    case KERN:
+        m_followCurrentIndex = m_pParser->parseByKernFollow();
+        break;
+    case Dmesg:
+        m_followCurrentIndex = m_pParser->parseByDmesgFollow(lId);
+        break;
+    case DPKG:
+        m_followCurrentIndex = m_pParser->parseByTextFollow(DPKG_TREE_DATA);
+        break;
+    case Kwin:
+        m_followCurrentIndex = m_pParser->parseByTextFollow(KWIN_TREE_DATA);
+        break;
+    default:
+        break;
+    }
+    return true;
+}
+
+bool LogBackend::parseTypeLogsByCondition(const QString &type, const QString &period, const QString &condition, const QString &keyword)
+{
     // 日志种类有效性验证
     QString error;
     m_flag = type2Flag(type, error);
@@ -366,7 +492,6 @@ bool LogBackend::LogBackend::exportTypeLogsByCondition(const QString &outDir, co
         return false;
     }
 
-    m_sessionType = Export;
     return true;
 }
 
@@ -409,8 +534,7 @@ int LogBackend::exportAppLogs(const QString &outDir, const QString &appName)
         if (logPaths.size() > 0) {
             resetCategoryOutputPath(categoryOutPath);
 
-            for (auto &file: logPaths)
-                DLDBusHandler::instance()->exportLog(categoryOutPath, file, true);
+            DLDBusHandler::instance()->exportLogFiles(categoryOutPath, logPaths);
         } else {
             qCWarning(logBackend) << QString("app:%1 not found log files.").arg(appName);
             bSuccess = false;
@@ -436,6 +560,12 @@ bool LogBackend::exportAppLogsByCondition(const QString &outDir, const QString &
     if(!getOutDirPath(outDir))
         return false;
 
+    m_sessionType = Export;
+    return parseAppLogsByCondition(appName, period, level, keyword);
+}
+
+bool LogBackend::parseAppLogsByCondition(const QString &appName, const QString &period, const QString &level, const QString &keyword)
+{
     if (appName.isEmpty())
         return false;
 
@@ -478,7 +608,6 @@ bool LogBackend::exportAppLogsByCondition(const QString &outDir, const QString &
 
     m_flag = APP;
     m_curAppLog = logPath;
-    m_sessionType = Export;
     m_currentSearchStr = keyword;
 
     APP_FILTERS appFilter;
@@ -491,42 +620,44 @@ bool LogBackend::exportAppLogsByCondition(const QString &outDir, const QString &
     return true;
 }
 
+/**
+ * @brief LogBackend::getLogTypes 可用的日志类别,依赖文件的类别按LogCategoryProbe的结果,目录未变化时使用缓存
+ */
 QStringList LogBackend::getLogTypes()
 {
     Dtk::Core::DSysInfo::UosEdition edition = Dtk::Core::DSysInfo::uosEditionType();
     //等于服务器行业版或欧拉版(centos)
     bool isCentos = Dtk::Core::DSysInfo::UosEuler == edition || Dtk::Core::DSysInfo::UosEnterpriseC == edition || Dtk::Core::DSysInfo::UosMilitaryS == edition;
-    if (QFile::exists("/var/log/journal") || isCentos) {
+    const LogCategoryProbeResult probe = LogCategoryProbe::instance()->result();
+    m_logTypes.clear();
+    if (probe.state(JOUR_TREE_DATA).available || isCentos) {
         m_logTypes.push_back(JOUR_TREE_DATA);
     }
 
     if (isCentos) {
         m_logTypes.push_back(DMESG_TREE_DATA);
-    } else {
-        if (QFile::exists("/var/log/kern.log")) {
-            m_logTypes.push_back(KERN_TREE_DATA);
-        }
+    } else if (probe.state(KERN_TREE_DATA).available) {
+        m_logTypes.push_back(KERN_TREE_DATA);
     }
-    if (DBusManager::isSpecialComType()) {
+    //w515是新版本内核的panguv返回值  panguV是老版本
+    const bool isSpecialComType = probe.state(BOOT_KLU_TREE_DATA).available;
+    if (isSpecialComType) {
         m_logTypes.push_back(BOOT_KLU_TREE_DATA);
     } else {
         m_logTypes.push_back(BOOT_TREE_DATA);
     }
     if (isCentos) {
         m_logTypes.push_back(DNF_TREE_DATA);
-    } else {
-        if (QFile::exists("/var/log/dpkg.log")) {
-            m_logTypes.push_back(DPKG_TREE_DATA);
-        }
+    } else if (probe.state(DPKG_TREE_DATA).available) {
+        m_logTypes.push_back(DPKG_TREE_DATA);
     }
-    //w515是新版本内核的panguv返回值  panguV是老版本
-    if (DBusManager::isSpecialComType()) {
+    if (isSpecialComType) {
         m_logTypes.push_back(KWIN_TREE_DATA);
     } else {
         m_logTypes.push_back(XORG_TREE_DATA);
     }
     auto *appHelper = LogApplicationHelper::instance();
-    QMap<QString, QString> appMap = appHelper->getMap();
+    QMap<QString, QString> appMap = appHelper->getMap(true);
     if (!appMap.isEmpty()) {
         m_logTypes.push_back(APP_TREE_DATA);
     }
@@ -534,7 +665,7 @@ QStringList LogBackend::getLogTypes()
     m_logTypes.push_back(COREDUMP_TREE_DATA);
 
     // add by Airy
-    if (QFile::exists("/var/log/wtmp")) {
+    if (probe.state(LAST_TREE_DATA).available) {
         m_logTypes.push_back(LAST_TREE_DATA);
     }
 
@@ -546,8 +677,8 @@ QStringList LogBackend::getLogTypes()
         m_logTypes.push_back(CUSTOM_TREE_DATA);
     }
 
-    // 审计日志文件存在，才加载和显示审计日志模块（审计日志文件需要root权限访问，因此在service服务中判断审计日志文件是否存在）
-    if (DLDBusHandler::instance(qApp)->isFileExist(AUDIT_TREE_DATA)) {
+    // 审计日志文件存在，才加载和显示审计日志模块（审计日志文件需要root权限访问，因此由服务判断审计日志文件是否存在）
+    if (probe.state(AUDIT_TREE_DATA).available) {
         m_logTypes.push_back(AUDIT_TREE_DATA);
     }
 
@@ -562,6 +693,8 @@ void LogBackend::slot_dpkgFinished(int index)
 
     if (Export == m_sessionType) {
         exportData();
+    } else if (Query == m_sessionType) {
+        finishQuery();
     }
 }
 
@@ -570,8 +703,11 @@ void LogBackend::slot_dpkgData(int index, QList<LOG_MSG_DPKG> list)
     if (m_flag != DPKG || index != m_dpkgCurrentIndex)
         return;
 
-    dListOrigin.append(list);
-    dList.append(filterDpkg(m_currentSearchStr, list));
+    //查询时每批数据过滤后直接输出,不保存
+    if (Query == m_sessionType)
+        writeQueryRecords<LogExportTraits<LOG_MSG_DPKG>>(filterDpkg(m_currentSearchStr, list));
+    else
+        dList.append(filterDpkg(m_currentSearchStr, list));
 }
 
 void LogBackend::slot_XorgFinished(int index)
@@ -582,6 +718,8 @@ void LogBackend::slot_XorgFinished(int index)
 
     if (Export == m_sessionType) {
         exportData();
+    } else if (Query == m_sessionType) {
+        finishQuery();
     }
 }
 
@@ -590,8 +728,11 @@ void LogBackend::slot_xorgData(int index, QList<LOG_MSG_XORG> list)
     if (m_flag != XORG || index != m_xorgCurrentIndex)
         return;
 
-    xListOrigin.append(list);
-    xList.append(filterXorg(m_currentSearchStr, list));
+    //查询时每批数据过滤后直接输出,不保存
+    if (Query == m_sessionType)
+        writeQueryRecords<LogExportTraits<LOG_MSG_XORG>>(filterXorg(m_currentSearchStr, list));
+    else
+        xList.append(filterXorg(m_currentSearchStr, list));
 }
 
 void LogBackend::slot_bootFinished(int index)
@@ -602,6 +743,8 @@ void LogBackend::slot_bootFinished(int index)
 
     if (Export == m_sessionType) {
         exportData();
+    } else if (Query == m_sessionType) {
+        finishQuery();
     }
 }
 
@@ -610,8 +753,11 @@ void LogBackend::slot_bootData(int index, QList<LOG_MSG_BOOT> list)
     if (m_flag != BOOT || index != m_bootCurrentIndex)
         return;
 
-    bList.append(list);
-    currentBootList.append(filterBoot(m_bootFilter, list));
+    //查询时每批数据过滤后直接输出,不保存
+    if (Query == m_sessionType)
+        writeQueryRecords<LogExportTraits<LOG_MSG_BOOT>>(filterBoot(m_bootFilter, list));
+    else
+        currentBootList.append(filterBoot(m_bootFilter, list));
 }
 
 void LogBackend::slot_kernFinished(int index)
@@ -622,6 +768,8 @@ void LogBackend::slot_kernFinished(int index)
 
     if (Export == m_sessionType) {
         exportData();
+    } else if (Query == m_sessionType) {
+        finishQuery();
     }
 }
 
@@ -630,8 +778,11 @@ void LogBackend::slot_kernData(int index, QList<LOG_MSG_JOURNAL> list)
     if (m_flag != KERN || index != m_kernCurrentIndex)
         return;
 
-    kListOrigin.append(list);
-    kList.append(filterKern(m_currentSearchStr, list));
+    //查询时每批数据过滤后直接输出,不保存
+    if (Query == m_sessionType)
+        writeQueryRecords<LogExportTraits<LOG_MSG_JOURNAL, KERN>>(filterKern(m_currentSearchStr, list));
+    else
+        kList.append(filterKern(m_currentSearchStr, list));
 }
 
 void LogBackend::slot_kwinFinished(int index)
@@ -642,6 +793,8 @@ void LogBackend::slot_kwinFinished(int index)
 
     if (Export == m_sessionType) {
         exportData();
+    } else if (Query == m_sessionType) {
+        finishQuery();
     }
 }
 
@@ -649,39 +802,61 @@ void LogBackend::slot_kwinData(int index, QList<LOG_MSG_KWIN> list)
 {
     if (m_flag != Kwin || index != m_kwinCurrentIndex)
         return;
-    m_kwinList.append(list);
-    m_currentKwinList.append(filterKwin(m_currentSearchStr, list));
+    //查询时每批数据过滤后直接输出,不保存
+    if (Query == m_sessionType)
+        writeQueryRecords<LogExportTraits<LOG_MSG_KWIN>>(filterKwin(m_currentSearchStr, list));
+    else
+        m_currentKwinList.append(filterKwin(m_currentSearchStr, list));
 }
 
-void LogBackend::slot_dnfFinished(const QList<LOG_MSG_DNF> &list)
+void LogBackend::slot_dnfFinished(int index)
 {
-    if (m_flag != Dnf)
+    if (m_flag != Dnf || index != m_dnfCurrentIndex)
         return;
-    dnfList = filterDnf(m_currentSearchStr, list);
-    dnfListOrigin = list;
-
     m_isDataLoadComplete = true;
 
     if (Export == m_sessionType) {
         exportData();
+    } else if (Query == m_sessionType) {
+        finishQuery();
     }
 }
 
-void LogBackend::slot_dmesgFinished(const QList<LOG_MSG_DMESG> &list)
+void LogBackend::slot_dnfData(int index, QList<LOG_MSG_DNF> list)
 {
-    if (m_flag != Dmesg)
+    if (m_flag != Dnf || index != m_dnfCurrentIndex)
         return;
+    //查询时每批数据过滤后直接输出,不保存
+    if (Query == m_sessionType)
+        writeQueryRecords<LogExportTraits<LOG_MSG_DNF>>(filterDnf(m_currentSearchStr, list));
+    else
+        dnfList.append(filterDnf(m_currentSearchStr, list));
+}
 
-    dmesgList = filterDmesg(m_currentSearchStr,list);
-    dmesgListOrigin = list;
-
+void LogBackend::slot_dmesgFinished(int index)
+{
+    if (m_flag != Dmesg || index != m_dmesgCurrentIndex)
+        return;
     m_isDataLoadComplete = true;
 
     if (Export == m_sessionType) {
         exportData();
+    } else if (Query == m_sessionType) {
+        finishQuery();
     }
 }
 
+void LogBackend::slot_dmesgData(int index, QList<LOG_MSG_DMESG> list)
+{
+    if (m_flag != Dmesg || index != m_dmesgCurrentIndex)
+        return;
+    //查询时每批数据过滤后直接输出,不保存
+    if (Query == m_sessionType)
+        writeQueryRecords<LogExportTraits<LOG_MSG_DMESG>>(filterDmesg(m_currentSearchStr, list));
+    else
+        dmesgList.append(filterDmesg(m_currentSearchStr, list));
+}
+
 void LogBackend::slot_journalFinished(int index)
 {
     if (m_flag != JOURNAL || index != m_journalCurrentIndex)
@@ -690,6 +865,8 @@ void LogBackend::slot_journalFinished(int index)
 
     if (Export == m_sessionType) {
         exportData();
+    } else if (Query == m_sessionType) {
+        finishQuery();
     }
 }
 
@@ -701,6 +878,8 @@ void LogBackend::slot_journalBootFinished(int index)
 
     if (Export == m_sessionType) {
         exportData();
+    } else if (Query == m_sessionType) {
+        finishQuery();
     }
 }
 
@@ -709,8 +888,11 @@ void LogBackend::slot_journalBootData(int index, QList<LOG_MSG_JOURNAL> list)
     if (m_flag != BOOT_KLU || index != m_journalBootCurrentIndex)
         return;
 
-    jBootListOrigin.append(list);
-    jBootList.append(filterJournalBoot(m_currentSearchStr, list));
+    //查询时每批数据过滤后直接输出,不保存
+    if (Query == m_sessionType)
+        writeQueryRecords<LogExportTraits<LOG_MSG_JOURNAL, JOURNAL>>(filterJournalBoot(m_currentSearchStr, list));
+    else
+        jBootList.append(filterJournalBoot(m_currentSearchStr, list));
 }
 
 void LogBackend::slot_journalData(int index, QList<LOG_MSG_JOURNAL> list)
@@ -719,8 +901,96 @@ void LogBackend::slot_journalData(int index, QList<LOG_MSG_JOURNAL> list)
     if (m_flag != JOURNAL || index != m_journalCurrentIndex)
         return;
 
-    jListOrigin.append(list);
-    jList.append(filterJournal(m_currentSearchStr, list));
+    //查询时每批数据过滤后直接输出,不保存
+    if (Query == m_sessionType)
+        writeQueryRecords<LogExportTraits<LOG_MSG_JOURNAL, JOURNAL>>(filterJournal(m_currentSearchStr, list));
+    else
+        jList.append(filterJournal(m_currentSearchStr, list));
+}
+
+/**
+ * @brief LogBackend::slot_journalFollowData 实时跟踪到的系统日志,过滤后按时间顺序写到标准输出
+ */
+void LogBackend::slot_journalFollowData(int index, QList<LOG_MSG_JOURNAL> list, const QString &cursor)
+{
+    Q_UNUSED(cursor)
+    if (Follow != m_sessionType || index != m_followCurrentIndex)
+        return;
+
+    //跟踪线程按从新到旧交出,终端上按时间顺序输出
+    std::reverse(list.begin(), list.end());
+    writeQueryRecords<LogExportTraits<LOG_MSG_JOURNAL, JOURNAL>>(filterJournal(m_currentSearchStr, list));
+}
+
+void LogBackend::slot_kernFollowData(int index, QList<LOG_MSG_JOURNAL> list)
+{
+    if (Follow != m_sessionType || index != m_followCurrentIndex)
+        return;
+
+    writeQueryRecords<LogExportTraits<LOG_MSG_JOURNAL, KERN>>(filterKern(m_currentSearchStr, list));
+}
+
+void LogBackend::slot_dmesgFollowData(int index, QList<LOG_MSG_DMESG> list)
+{
+    if (Follow != m_sessionType || index != m_followCurrentIndex)
+        return;
+
+    writeQueryRecords<LogExportTraits<LOG_MSG_DMESG>>(filterDmesg(m_currentSearchStr, list));
+}
+
+/**
+ * @brief LogBackend::slot_lineFollowData 文本日志新追加的行,按当前类别的格式解析后输出
+ * @param lines 按从旧到新排列
+ */
+void LogBackend::slot_lineFollowData(int index, QStringList lines)
+{
+    if (Follow != m_sessionType || index != m_followCurrentIndex)
+        return;
+
+    if (DPKG == m_flag) {
+        QList<LOG_MSG_DPKG> list;
+        qint64 lineTime = 0;
+        QStringList columns;
+        for (const QString &line : lines) {
+            if (!LogRecordParser::parseDpkg(line, lineTime, columns))
+                continue;
+            LOG_MSG_DPKG msg;
+            msg.dateTime = columns.at(0);
+            msg.action = columns.at(1);
+            msg.msg = columns.at(2);
+            msg.timestamp = lineTime;
+            list.append(msg);
+        }
+        writeQueryRecords<LogExportTraits<LOG_MSG_DPKG>>(filterDpkg(m_currentSearchStr, list));
+    } else if (Kwin == m_flag) {
+        QList<LOG_MSG_KWIN> list;
+        for (const QString &line : lines) {
+            if (line.trimmed().isEmpty())
+                continue;
+            LOG_MSG_KWIN msg;
+            msg.msg = line;
+            list.append(msg);
+        }
+        writeQueryRecords<LogExportTraits<LOG_MSG_KWIN>>(filterKwin(m_currentSearchStr, list));
+    }
+}
+
+/**
+ * @brief LogBackend::slot_followFinished 跟踪线程出错退出,正常情况下跟踪不会结束
+ */
+void LogBackend::slot_followFinished(int index)
+{
+    if (Follow != m_sessionType || index != m_followCurrentIndex)
+        return;
+
+    m_followCurrentIndex = -1;
+    if (m_queryOut) {
+        m_queryOut->flush();
+        m_queryOut.reset();
+        m_queryFile->close();
+    }
+    qCWarning(logBackend) << "follow stopped.";
+    qApp->exit(-1);
 }
 
 void LogBackend::slot_applicationFinished(int index)
@@ -731,6 +1001,8 @@ void LogBackend::slot_applicationFinished(int index)
 
     if (Export == m_sessionType) {
         exportData();
+    } else if (Query == m_sessionType) {
+        finishQuery();
     }
 }
 
@@ -739,8 +1011,11 @@ void LogBackend::slot_applicationData(int index, QList<LOG_MSG_APPLICATOIN> list
     if (m_flag != APP || index != m_appCurrentIndex)
         return;
 
-    appListOrigin.append(list);
-    appList.append(filterApp(m_currentSearchStr, list));
+    //查询时每批数据过滤后直接输出,不保存
+    if (Query == m_sessionType)
+        writeQueryRecords<LogExportTraits<LOG_MSG_APPLICATOIN>>(filterApp(m_currentSearchStr, list));
+    else
+        appList.append(filterApp(m_currentSearchStr, list));
 }
 
 void LogBackend::slot_normalFinished(int index)
@@ -751,6 +1026,8 @@ void LogBackend::slot_normalFinished(int index)
 
     if (Export == m_sessionType) {
         exportData();
+    } else if (Query == m_sessionType) {
+        finishQuery();
     }
 }
 
@@ -758,8 +1035,11 @@ void LogBackend::slot_normalData(int index, QList<LOG_MSG_NORMAL> list)
 {
     if (m_flag != Normal || index != m_normalCurrentIndex)
         return;
-    norList.append(list);
-    nortempList.append(filterNomal(m_normalFilter, list));
+    //查询时每批数据过滤后直接输出,不保存
+    if (Query == m_sessionType)
+        writeQueryRecords<LogExportTraits<LOG_MSG_NORMAL>>(filterNomal(m_normalFilter, list));
+    else
+        nortempList.append(filterNomal(m_normalFilter, list));
 }
 
 void LogBackend::slot_auditFinished(int index, bool bShowTip)
@@ -773,6 +1053,8 @@ void LogBackend::slot_auditFinished(int index, bool bShowTip)
 
     if (Export == m_sessionType) {
         exportData();
+    } else if (Query == m_sessionType) {
+        finishQuery();
     }
 }
 
@@ -781,8 +1063,11 @@ void LogBackend::slot_auditData(int index, QList<LOG_MSG_AUDIT> list)
     if (m_flag != Audit || index != m_auditCurrentIndex)
         return;
 
-    aListOrigin.append(list);
-    aList.append(filterAudit(m_auditFilter, list));
+    //查询时每批数据过滤后直接输出,不保存
+    if (Query == m_sessionType)
+        writeQueryRecords<LogExportTraits<LOG_MSG_AUDIT>>(filterAudit(m_auditFilter, list));
+    else
+        aList.append(filterAudit(m_auditFilter, list));
 }
 
 void LogBackend::slot_coredumpFinished(int index)
@@ -803,18 +1088,23 @@ void LogBackend::slot_coredumpFinished(int index)
             qApp->exit(-1);
         } else {
 
-            // 崩溃数据转json数据
+            // 崩溃数据转json数据,列表中只有元数据,堆栈和maps信息只为要上报的记录读取
             QJsonArray objList;
-            QDateTime latestCoredumpTime;
+            qint64 latestCoredumpMSecs = -1;
+            // 已上报过或本机查看过的记录详情取自缓存,其余的并行读取
+            std::atomic_bool canRun(true);
+            LogCoredumpDetailCache cache;
+            LogCoredumpDetail::loadAll(m_currentCoredumpList, cache, canRun);
+            cache.save();
             for (auto &data : m_currentCoredumpList) {
-                QDateTime coredumpTime = QDateTime::fromString(data.dateTime, "yyyy-MM-dd hh:mm:ss");
-                if (coredumpTime > latestCoredumpTime)
-                    latestCoredumpTime = coredumpTime;
+                latestCoredumpMSecs = qMax(latestCoredumpMSecs, LogLocalTime::parse(data.dateTime));
                 objList.append(data.toJson());
             }
 
             // 以最近的崩溃时间的下一秒作为下次上报的筛选起始时间
-            latestCoredumpTime = latestCoredumpTime.addSecs(1);
+            QDateTime latestCoredumpTime;
+            if (latestCoredumpMSecs >= 0)
+                latestCoredumpTime = QDateTime::fromMSecsSinceEpoch(latestCoredumpMSecs + 1000);
 
             // 先初始化埋点接口，延迟2秒后调用埋点接口，以便能正常写入埋点数据
             Eventlogutils::GetInstance();
@@ -831,6 +1121,8 @@ void LogBackend::slot_coredumpFinished(int index)
 
                 Eventlogutils::GetInstance()->writeLogs(objCoredumpEvent);
                 LogApplicationHelper::instance()->saveLastRerportTime(latestCoredumpTime);
+                if (!m_coredumpCursor.isEmpty())
+                    LogApplicationHelper::instance()->saveLastReportCursor(m_coredumpCursor);
                 qCInfo(logBackend) << QString("Successfully reported %1 crash messages in total.").arg(m_currentCoredumpList.size());
                 qApp->exit(0);
             });
@@ -843,10 +1135,75 @@ void LogBackend::slot_coredumpData(int index, QList<LOG_MSG_COREDUMP> list)
     if (m_flag != COREDUMP || index != m_coredumpCurrentIndex)
         return;
 
-    m_coredumpList.append(list);
     m_currentCoredumpList.append(filterCoredump(m_currentSearchStr, list));
 }
 
+/**
+ * @brief LogBackend::beginQuery 查询结果不经过缓冲直接写到标准输出,每批写完即可被管道另一端读到
+ */
+bool LogBackend::beginQuery()
+{
+    m_queryFile.reset(new QFile);
+    if (!m_queryFile->open(STDOUT_FILENO, QIODevice::WriteOnly | QIODevice::Unbuffered)) {
+        qCWarning(logBackend) << "open stdout failed:" << m_queryFile->errorString();
+        return false;
+    }
+    m_queryOut.reset(new LogExportWriter(m_queryFile.data()));
+    m_queryFormatter.reset(new LogRecordFormatter);
+    m_queryCount = 0;
+    return true;
+}
+
+/**
+ * @brief LogBackend::writeQueryRecords 把一批过滤后的记录按导出列格式化后写到标准输出
+ * 写入失败(如管道另一端已关闭)时停止查询
+ */
+template <typename Traits>
+void LogBackend::writeQueryRecords(const QList<typename Traits::Record> &list)
+{
+    if (!m_queryOut)
+        return;
+
+    LogRecordLoader<typename Traits::Record> loader;
+    try {
+        for (const typename Traits::Record &record : list) {
+            if (m_jsonExport)
+                m_queryFormatter->writeJsonLine<Traits>(*m_queryOut, loader.load(record), m_queryAppName);
+            else
+                m_queryFormatter->writeTextLine<Traits>(*m_queryOut, loader.load(record), m_queryLabels, m_queryAppName);
+        }
+        if (!m_queryOut->flush())
+            throw QString("write stdout failed");
+    } catch (const QString &error) {
+        qCWarning(logBackend) << "query stopped:" << error;
+        m_queryOut.reset();
+        qApp->exit(-1);
+        return;
+    }
+    m_queryCount += list.size();
+}
+
+/**
+ * @brief LogBackend::finishQuery 解析结束后退出,没有匹配的数据时和导出一样返回-1
+ */
+void LogBackend::finishQuery()
+{
+    if (!m_queryOut)
+        return;
+
+    const bool flushed = m_queryOut->flush();
+    m_queryOut.reset();
+    m_queryFile->close();
+    if (!flushed) {
+        qApp->exit(-1);
+    } else if (m_queryCount == 0) {
+        qCWarning(logBackend) << "No matching data..";
+        qApp->exit(-1);
+    } else {
+        qApp->quit();
+    }
+}
+
 void LogBackend::slot_logLoadFailed(const QString &iError)
 {
     qCWarning(logBackend) << "parse data failed. error: " << iError;
@@ -874,233 +1231,119 @@ void LogBackend::onExportResult(bool isSuccess)
 
 QList<LOG_MSG_BOOT> LogBackend::filterBoot(BOOT_FILTERS ibootFilter, const QList<LOG_MSG_BOOT> &iList)
 {
-    QList<LOG_MSG_BOOT> rsList;
-    bool isStatusFilterEmpty = ibootFilter.statusFilter.isEmpty();
-    if (isStatusFilterEmpty && ibootFilter.searchstr.isEmpty()) {
+    if (ibootFilter.statusFilter.isEmpty() && ibootFilter.searchstr.isEmpty())
         return iList;
-    } else {
-        for (int i = 0; i < iList.size(); i++) {
-            LOG_MSG_BOOT msg = iList.at(i);
-            QString _statusStr = msg.status;
-            if ((_statusStr.compare(ibootFilter.statusFilter, Qt::CaseInsensitive) != 0) && !isStatusFilterEmpty)
-                continue;
-            if ((msg.status.contains(ibootFilter.searchstr, Qt::CaseInsensitive)) || (msg.msg.contains(ibootFilter.searchstr, Qt::CaseInsensitive))) {
-                rsList.append(iList[i]);
-            }
-        }
-    }
-    return rsList;
+    const int statusFilter = LogParseMatchers::bootStatusFilter(ibootFilter.statusFilter);
+    const LogRecordFilter::TextMatcher text(ibootFilter.searchstr);
+    return LogRecordFilter::filter(iList, [statusFilter, text](const LOG_MSG_BOOT &msg) {
+        return LogRecordFilter::matchBoot(statusFilter, text, msg);
+    });
 }
 
 QList<LOG_MSG_NORMAL> LogBackend::filterNomal(NORMAL_FILTERS inormalFilter, QList<LOG_MSG_NORMAL> &iList)
 {
-    QList<LOG_MSG_NORMAL> rsList;
-    if (inormalFilter.searchstr.isEmpty() && inormalFilter.eventTypeFilter < 0) {
+    if (inormalFilter.searchstr.isEmpty() && inormalFilter.eventTypeFilter < 0)
         return iList;
-    }
-    int tcbx = inormalFilter.eventTypeFilter;
-    if (0 == tcbx) {
-        for (auto i = 0; i < iList.size(); i++) {
-            LOG_MSG_NORMAL msg = iList.at(i);
-            if (msg.eventType.contains(inormalFilter.searchstr, Qt::CaseInsensitive) || msg.userName.contains(inormalFilter.searchstr, Qt::CaseInsensitive) || msg.dateTime.contains(inormalFilter.searchstr, Qt::CaseInsensitive) || msg.msg.contains(inormalFilter.searchstr, Qt::CaseInsensitive)) {
-                rsList.append(msg);
-            }
-        }
-    } else if (1 == tcbx) {
-        for (auto i = 0; i < iList.size(); i++) {
-            LOG_MSG_NORMAL msg = iList.at(i);
-            if (msg.eventType.contains(inormalFilter.searchstr, Qt::CaseInsensitive) || msg.userName.contains(inormalFilter.searchstr, Qt::CaseInsensitive) || msg.dateTime.contains(inormalFilter.searchstr, Qt::CaseInsensitive) || msg.msg.contains(inormalFilter.searchstr, Qt::CaseInsensitive)) {
-                if (msg.eventType.compare("Boot", Qt::CaseInsensitive) != 0 && msg.eventType.compare("shutdown", Qt::CaseInsensitive) != 0 && msg.eventType.compare("runlevel", Qt::CaseInsensitive) != 0)
-                    rsList.append(msg);
-            }
-        }
-    } else if (2 == tcbx) {
-        for (auto i = 0; i < iList.size(); i++) {
-            LOG_MSG_NORMAL msg = iList.at(i);
-            if (msg.eventType.contains(inormalFilter.searchstr, Qt::CaseInsensitive) || msg.userName.contains(inormalFilter.searchstr, Qt::CaseInsensitive) || msg.dateTime.contains(inormalFilter.searchstr, Qt::CaseInsensitive) || msg.msg.contains(inormalFilter.searchstr, Qt::CaseInsensitive)) {
-                if (iList[i].eventType.compare("Boot", Qt::CaseInsensitive) == 0)
-                    rsList.append(iList[i]);
-            }
-        }
-    } else if (3 == tcbx) {
-        for (auto i = 0; i < iList.size(); i++) {
-            LOG_MSG_NORMAL msg = iList.at(i);
-            if (msg.eventType.contains(inormalFilter.searchstr, Qt::CaseInsensitive) || msg.userName.contains(inormalFilter.searchstr, Qt::CaseInsensitive) || msg.dateTime.contains(inormalFilter.searchstr, Qt::CaseInsensitive) || msg.msg.contains(inormalFilter.searchstr, Qt::CaseInsensitive)) {
-                if (iList[i].eventType.compare("shutdown", Qt::CaseInsensitive) == 0)
-                    rsList.append(iList[i]);
-            }
-        }
-    }
-    return rsList;
+    const int eventType = inormalFilter.eventTypeFilter;
+    const LogRecordFilter::TextMatcher text(inormalFilter.searchstr);
+    return LogRecordFilter::filter(iList, [eventType, text](const LOG_MSG_NORMAL &msg) {
+        return LogRecordFilter::matchNormal(eventType, text, msg);
+    });
 }
 
 QList<LOG_MSG_DPKG> LogBackend::filterDpkg(const QString &iSearchStr, const QList<LOG_MSG_DPKG> &iList)
 {
-    QList<LOG_MSG_DPKG> rsList;
-    if (iSearchStr.isEmpty()) {
+    if (iSearchStr.isEmpty())
         return iList;
-    }
-
-    for (int i = 0; i < iList.size(); i++) {
-        LOG_MSG_DPKG msg = iList.at(i);
-        if (msg.dateTime.contains(iSearchStr, Qt::CaseInsensitive) || msg.msg.contains(iSearchStr, Qt::CaseInsensitive)) {
-            rsList.append(msg);
-        }
-    }
-    return rsList;
+    const LogRecordFilter::TextMatcher text(iSearchStr);
+    return LogRecordFilter::filter(iList, [text](const LOG_MSG_DPKG &msg) { return LogRecordFilter::matchDpkg(text, msg); });
 }
 
 QList<LOG_MSG_JOURNAL> LogBackend::filterKern(const QString &iSearchStr, const QList<LOG_MSG_JOURNAL> &iList)
 {
-    QList<LOG_MSG_JOURNAL> rsList;
-    if (iSearchStr.isEmpty()) {
+    if (iSearchStr.isEmpty())
         return iList;
-    }
-    for (int i = 0; i < iList.size(); i++) {
-        LOG_MSG_JOURNAL msg = iList.at(i);
-        if (msg.dateTime.contains(iSearchStr, Qt::CaseInsensitive) || msg.hostName.contains(iSearchStr, Qt::CaseInsensitive) || msg.daemonName.contains(iSearchStr, Qt::CaseInsensitive) || msg.msg.contains(iSearchStr, Qt::CaseInsensitive)) {
-            rsList.append(msg);
-        }
-    }
-    return rsList;
+    const LogRecordFilter::TextMatcher text(iSearchStr);
+    return LogRecordFilter::filter(iList, [text](const LOG_MSG_JOURNAL &msg) { return LogRecordFilter::matchKern(text, msg); });
 }
 
 QList<LOG_MSG_XORG> LogBackend::filterXorg(const QString &iSearchStr, const QList<LOG_MSG_XORG> &iList)
 {
-    QList<LOG_MSG_XORG> rsList;
-    if (iSearchStr.isEmpty()) {
+    if (iSearchStr.isEmpty())
         return iList;
-    }
-    for (int i = 0; i < iList.size(); i++) {
-        LOG_MSG_XORG msg = iList.at(i);
-        if (msg.offset.contains(iSearchStr, Qt::CaseInsensitive) || msg.msg.contains(iSearchStr, Qt::CaseInsensitive))
-            rsList.append(msg);
-    }
-    return rsList;
+    const LogRecordFilter::TextMatcher text(iSearchStr);
+    return LogRecordFilter::filter(iList, [text](const LOG_MSG_XORG &msg) { return LogRecordFilter::matchXorg(text, msg); });
 }
 
 QList<LOG_MSG_KWIN> LogBackend::filterKwin(const QString &iSearchStr, const QList<LOG_MSG_KWIN> &iList)
 {
-    QList<LOG_MSG_KWIN> rsList;
-    if (iSearchStr.isEmpty()) {
+    if (iSearchStr.isEmpty())
         return iList;
-    }
-    for (int i = 0; i < iList.size(); i++) {
-        LOG_MSG_KWIN msg = iList.at(i);
-        if (msg.msg.contains(iSearchStr, Qt::CaseInsensitive))
-            rsList.append(msg);
-    }
-    return rsList;
+    const LogRecordFilter::TextMatcher text(iSearchStr);
+    return LogRecordFilter::filter(iList, [text](const LOG_MSG_KWIN &msg) { return LogRecordFilter::matchKwin(text, msg); });
 }
 
 QList<LOG_MSG_APPLICATOIN> LogBackend::filterApp(const QString &iSearchStr, const QList<LOG_MSG_APPLICATOIN> &iList)
 {
-    QList<LOG_MSG_APPLICATOIN> rsList;
-    if (iSearchStr.isEmpty()) {
+    if (iSearchStr.isEmpty())
         return iList;
-    }
-    for (int i = 0; i < iList.size(); i++) {
-        LOG_MSG_APPLICATOIN msg = iList.at(i);
-        if (msg.dateTime.contains(iSearchStr, Qt::CaseInsensitive) || msg.level.contains(iSearchStr, Qt::CaseInsensitive) || msg.src.contains(iSearchStr, Qt::CaseInsensitive) || msg.msg.contains(iSearchStr, Qt::CaseInsensitive))
-            rsList.append(msg);
-    }
-    return rsList;
+    const LogRecordFilter::TextMatcher text(iSearchStr);
+    return LogRecordFilter::filter(iList, [text](const LOG_MSG_APPLICATOIN &msg) { return LogRecordFilter::matchApp(text, msg); });
 }
 
 QList<LOG_MSG_DNF> LogBackend::filterDnf(const QString &iSearchStr, const QList<LOG_MSG_DNF> &iList)
 {
-    QList<LOG_MSG_DNF> rsList;
-    if (iSearchStr.isEmpty()) {
+    if (iSearchStr.isEmpty())
         return iList;
-    }
-    for (int i = 0; i < iList.size(); i++) {
-        LOG_MSG_DNF msg = iList.at(i);
-        if (msg.dateTime.contains(m_currentSearchStr, Qt::CaseInsensitive)
-                || msg.msg.contains(m_currentSearchStr, Qt::CaseInsensitive)
-                || msg.level.contains(m_currentSearchStr, Qt::CaseInsensitive))
-            rsList.append(msg);
-    }
-    return rsList;
+    const LogRecordFilter::TextMatcher text(iSearchStr);
+    return LogRecordFilter::filter(iList, [text](const LOG_MSG_DNF &msg) { return LogRecordFilter::matchDnf(text, msg); });
 }
 
 QList<LOG_MSG_DMESG> LogBackend::filterDmesg(const QString &iSearchStr, const QList<LOG_MSG_DMESG> &iList)
 {
-    QList<LOG_MSG_DMESG> rsList;
-    if (iSearchStr.isEmpty()) {
+    if (iSearchStr.isEmpty())
         return iList;
-    }
-
-    for (int i = 0; i < iList.size(); i++) {
-        LOG_MSG_DMESG msg = iList.at(i);
-        if (msg.dateTime.contains(m_currentSearchStr, Qt::CaseInsensitive) || msg.msg.contains(m_currentSearchStr, Qt::CaseInsensitive))
-            rsList.append(msg);
-    }
-
-    return rsList;
+    const LogRecordFilter::TextMatcher text(iSearchStr);
+    return LogRecordFilter::filter(iList, [text](const LOG_MSG_DMESG &msg) { return LogRecordFilter::matchDmesg(text, msg); });
 }
 
 QList<LOG_MSG_JOURNAL> LogBackend::filterJournal(const QString &iSearchStr, const QList<LOG_MSG_JOURNAL> &iList)
 {
-    QList<LOG_MSG_JOURNAL> rsList;
-    if (iSearchStr.isEmpty()) {
+    if (iSearchStr.isEmpty())
         return iList;
-    }
-    for (int i = 0; i < iList.size(); i++) {
-        LOG_MSG_JOURNAL msg = iList.at(i);
-        if (msg.dateTime.contains(iSearchStr, Qt::CaseInsensitive) || msg.hostName.contains(iSearchStr, Qt::CaseInsensitive) || msg.daemonName.contains(iSearchStr, Qt::CaseInsensitive) || msg.daemonId.contains(iSearchStr, Qt::CaseInsensitive) || msg.level.contains(iSearchStr, Qt::CaseInsensitive) || msg.msg.contains(iSearchStr, Qt::CaseInsensitive))
-            rsList.append(msg);
-    }
-    return rsList;
+    const LogRecordFilter::TextMatcher text(iSearchStr);
+    //每段各自打开读取完整信息的journal句柄
+    return LogRecordFilter::filterWith(iList, [text]() {
+        std::shared_ptr<JournalMessageResolver> resolver = std::make_shared<JournalMessageResolver>();
+        return [text, resolver](const LOG_MSG_JOURNAL &msg) { return LogRecordFilter::matchJournal(text, msg, *resolver); };
+    });
 }
 
 QList<LOG_MSG_JOURNAL> LogBackend::filterJournalBoot(const QString &iSearchStr, const QList<LOG_MSG_JOURNAL> &iList)
 {
-    QList<LOG_MSG_JOURNAL> rsList;
-    if (iSearchStr.isEmpty()) {
+    if (iSearchStr.isEmpty())
         return iList;
-    }
-    for (int i = 0; i < iList.size(); i++) {
-        LOG_MSG_JOURNAL msg = iList.at(i);
-        if (msg.dateTime.contains(iSearchStr, Qt::CaseInsensitive) || msg.hostName.contains(iSearchStr, Qt::CaseInsensitive) || msg.daemonName.contains(iSearchStr, Qt::CaseInsensitive) || msg.daemonId.contains(iSearchStr, Qt::CaseInsensitive) || msg.level.contains(iSearchStr, Qt::CaseInsensitive) || msg.msg.contains(iSearchStr, Qt::CaseInsensitive))
-            rsList.append(msg);
-    }
-    return rsList;
+    const LogRecordFilter::TextMatcher text(iSearchStr);
+    return LogRecordFilter::filter(iList, [text](const LOG_MSG_JOURNAL &msg) { return LogRecordFilter::matchJournalBoot(text, msg); });
 }
 
 QList<LOG_MSG_AUDIT> LogBackend::filterAudit(AUDIT_FILTERS auditFilter, const QList<LOG_MSG_AUDIT> &iList)
 {
-    QList<LOG_MSG_AUDIT> rsList;
-    if (auditFilter.searchstr.isEmpty() && auditFilter.auditTypeFilter < -1) {
+    if (auditFilter.searchstr.isEmpty() && auditFilter.auditTypeFilter < -1)
         return iList;
-    }
-    int nAuditType = auditFilter.auditTypeFilter - 1;
-    for (int i = 0; i < iList.size(); i++) {
-        LOG_MSG_AUDIT msg = iList.at(i);
-        if (msg.contains(auditFilter.searchstr) && (nAuditType == -1 || msg.filterAuditType(nAuditType))) {
-            rsList.append(msg);
-        }
-    }
-
-    return rsList;
+    const int auditType = auditFilter.auditTypeFilter;
+    const LogRecordFilter::TextMatcher text(auditFilter.searchstr);
+    return LogRecordFilter::filter(iList, [auditType, text](const LOG_MSG_AUDIT &msg) {
+        return LogRecordFilter::matchAudit(auditType, text, msg);
+    });
 }
+
 QList<LOG_MSG_COREDUMP> LogBackend::filterCoredump(const QString &iSearchStr, const QList<LOG_MSG_COREDUMP> &iList)
 {
-    QList<LOG_MSG_COREDUMP> rsList;
-    if (iSearchStr.isEmpty()) {
+    if (iSearchStr.isEmpty())
         return iList;
-    }
-    for (int i = 0; i < iList.size(); i++) {
-        LOG_MSG_COREDUMP msg = iList.at(i);
-        if (msg.sig.contains(iSearchStr, Qt::CaseInsensitive)
-                || msg.dateTime.contains(iSearchStr, Qt::CaseInsensitive)
-                || msg.coreFile.contains(iSearchStr, Qt::CaseInsensitive)
-                || msg.uid.contains(iSearchStr, Qt::CaseInsensitive)
-                || msg.exe.contains(iSearchStr, Qt::CaseInsensitive)) {
-            rsList.append(msg);
-        }
-    }
-
-    return rsList;
+    const LogRecordFilter::TextMatcher text(iSearchStr);
+    return LogRecordFilter::filter(iList, [text](const LOG_MSG_COREDUMP &msg) { return LogRecordFilter::matchCoredump(text, msg); });
 }
 
 bool LogBackend::parseData(const LOG_FLAG &flag, const QString &period, const QString &condition)
@@ -1205,6 +1448,9 @@ bool LogBackend::parseData(const LOG_FLAG &flag, const QString &period, const QS
             arg << QString::number(timeRange.begin * 1000) << QString::number(timeRange.end *1000);
         }
 
+        //已运行的图形界面加载过能满足筛选条件的日志时由其直接导出,不再重新读取
+        if (Export == m_sessionType && exportByRunningInstance(arg))
+            return true;
         m_journalCurrentIndex = m_pParser->parseByJournal(arg);
     }
     break;
@@ -1215,13 +1461,14 @@ bool LogBackend::parseData(const LOG_FLAG &flag, const QString &period, const QS
         if (periodId == ALL)
             dmesgfilter.timeFilter = 0;
 
-        m_pParser->parseByDmesg(dmesgfilter);
+        m_dmesgCurrentIndex = m_pParser->parseByDmesg(dmesgfilter);
     }
     break;
     case KERN: {
         KERN_FILTERS kernFilter;
         kernFilter.timeFilterBegin = timeRange.begin;
         kernFilter.timeFilterEnd = timeRange.end;
+        kernFilter.keyword = m_currentSearchStr;
 
         m_kernCurrentIndex = m_pParser->parseByKern(kernFilter);
     }
@@ -1249,6 +1496,7 @@ bool LogBackend::parseData(const LOG_FLAG &flag, const QString &period, const QS
         DKPG_FILTERS dpkgFilter;
         dpkgFilter.timeFilterBegin = timeRange.begin;
         dpkgFilter.timeFilterEnd = timeRange.end;
+        dpkgFilter.keyword = m_currentSearchStr;
         m_dpkgCurrentIndex = m_pParser->parseByDpkg(dpkgFilter);
     }
     break;
@@ -1259,7 +1507,7 @@ bool LogBackend::parseData(const LOG_FLAG &flag, const QString &period, const QS
         if (periodId == ALL)
             dnffilter.timeFilter = 0;
 
-        m_pParser->parseByDnf(dnffilter);
+        m_dnfCurrentIndex = m_pParser->parseByDnf(dnffilter);
     }
     break;
     case Kwin: {
@@ -1270,6 +1518,8 @@ bool LogBackend::parseData(const LOG_FLAG &flag, const QString &period, const QS
     break;
     case XORG: {
         XORG_FILTERS xorgFilter;
+        xorgFilter.timeFilterBegin = timeRange.begin;
+        xorgFilter.timeFilterEnd = timeRange.end;
         m_xorgCurrentIndex = m_pParser->parseByXlog(xorgFilter);
     }
     break;
@@ -1319,30 +1569,21 @@ void LogBackend::exportData()
     connect(exportThread, &LogExportThread::sigProgress, this, &LogBackend::onExportProgress);
 
     QString fileName = "";
-    QStringList labels;
+    const QStringList labels = exportLabels(m_flag);
     bool bMatchedData = false;
     switch (m_flag) {
     case JOURNAL: {
         if (!jList.isEmpty()) {
             bMatchedData = true;
-            fileName = outPath + "/system.txt";
-            labels << QCoreApplication::translate("Table", "Level")
-                   << QCoreApplication::translate("Table", "Process") // modified by Airy
-                   << QCoreApplication::translate("Table", "Date and Time")
-                   << QCoreApplication::translate("Table", "Info")
-                   << QCoreApplication::translate("Table", "User")
-                   << QCoreApplication::translate("Table", "PID");
-            exportThread->exportToTxtPublic(fileName, jList, labels, m_flag);
+            fileName = textExportPath("system");
+            exportThread->exportToTxtPublic(fileName, jList.toList(), labels, m_flag);
         }
     }
     break;
     case Dmesg: {
         if (!dmesgList.isEmpty()) {
             bMatchedData = true;
-            fileName = outPath + "/dmesg.txt";
-            labels  << QCoreApplication::translate("Table", "Level")
-                    << QCoreApplication::translate("Table", "Date and Time")
-                    << QCoreApplication::translate("Table", "Info");
+            fileName = textExportPath("dmesg");
             exportThread->exportToTxtPublic(fileName, dmesgList, labels);
         }
     }
@@ -1350,35 +1591,23 @@ void LogBackend::exportData()
     case KERN: {
         if (!kList.isEmpty()) {
             bMatchedData = true;
-            fileName = outPath + "/kernel.txt";
-            labels << QCoreApplication::translate("Table", "Date and Time")
-                   << QCoreApplication::translate("Table", "User")
-                   << QCoreApplication::translate("Table", "Process")
-                   << QCoreApplication::translate("Table", "Info");
-            exportThread->exportToTxtPublic(fileName, kList, labels, m_flag);
+            fileName = textExportPath("kernel");
+            exportThread->exportToTxtPublic(fileName, kList.toList(), labels, m_flag);
         }
     }
     break;
     case BOOT_KLU: {
         if (!jBootList.isEmpty()) {
             bMatchedData = true;
-            fileName = outPath + "/boot_klu.txt";
-            labels << QCoreApplication::translate("Table", "Level")
-                   << QCoreApplication::translate("Table", "Process")
-                   << QCoreApplication::translate("Table", "Date and Time")
-                   << QCoreApplication::translate("Table", "Info")
-                   << QCoreApplication::translate("Table", "User")
-                   << QCoreApplication::translate("Table", "PID");
-            exportThread->exportToTxtPublic(fileName, jBootList, labels, JOURNAL);
+            fileName = textExportPath("boot_klu");
+            exportThread->exportToTxtPublic(fileName, jBootList.toList(), labels, JOURNAL);
         }
     }
     break;
     case BOOT: {
         if (!currentBootList.isEmpty()) {
             bMatchedData = true;
-            fileName = outPath + "/boot.txt";
-            labels << QCoreApplication::translate("Table", "Status")
-                   << QCoreApplication::translate("Table", "Info");
+            fileName = textExportPath("boot");
             exportThread->exportToTxtPublic(fileName, currentBootList, labels);
         }
     }
@@ -1386,10 +1615,7 @@ void LogBackend::exportData()
     case DPKG: {
         if (!dList.isEmpty()) {
             bMatchedData = true;
-            fileName = outPath + "/dpkg.txt";
-            labels << QCoreApplication::translate("Table", "Date and Time")
-                   << QCoreApplication::translate("Table", "Info")
-                   << QCoreApplication::translate("Table", "Action");
+            fileName = textExportPath("dpkg");
             exportThread->exportToTxtPublic(fileName, dList, labels);
         }
     }
@@ -1397,10 +1623,7 @@ void LogBackend::exportData()
     case Dnf: {
         if (!dnfList.isEmpty()) {
             bMatchedData = true;
-            fileName = outPath + "/dnf.txt";
-            labels << QCoreApplication::translate("Table", "Level")
-                   << QCoreApplication::translate("Table", "Date and Time")
-                   << QCoreApplication::translate("Table", "Info");
+            fileName = textExportPath("dnf");
             exportThread->exportToTxtPublic(fileName, dnfList, labels);
         }
     }
@@ -1408,8 +1631,7 @@ void LogBackend::exportData()
     case Kwin: {
         if (!m_currentKwinList.isEmpty()) {
             bMatchedData = true;
-            fileName = outPath + "/kwin.txt";
-            labels << QCoreApplication::translate("Table", "Info");
+            fileName = textExportPath("kwin");
             exportThread->exportToTxtPublic(fileName, m_currentKwinList, labels);
         }
     }
@@ -1417,9 +1639,7 @@ void LogBackend::exportData()
     case XORG: {
         if (!xList.isEmpty()) {
             bMatchedData = true;
-            fileName = outPath + "/xorg.txt";
-            labels << QCoreApplication::translate("Table", "Offset")
-                   << QCoreApplication::translate("Table", "Info");
+            fileName = textExportPath("xorg");
             exportThread->exportToTxtPublic(fileName, xList, labels);
         }
     }
@@ -1429,11 +1649,7 @@ void LogBackend::exportData()
             bMatchedData = true;
             QString appName = Utils::appName(m_curAppLog);
             QString transAppName = LogApplicationHelper::instance()->transName(appName);
-            fileName = outPath + QString("/%1.txt").arg(appName);
-            labels << QCoreApplication::translate("Table", "Level")
-                   << QCoreApplication::translate("Table", "Date and Time")
-                   << QCoreApplication::translate("Table", "Source")
-                   << QCoreApplication::translate("Table", "Info");
+            fileName = textExportPath(appName);
             exportThread->exportToTxtPublic(fileName, appList, labels, transAppName);
         }
     }
@@ -1442,11 +1658,6 @@ void LogBackend::exportData()
         if (!m_currentCoredumpList.isEmpty()) {
             bMatchedData = true;
             fileName = outPath + "/coredump.zip";
-            labels << QCoreApplication::translate("Table", "SIG")
-                   << QCoreApplication::translate("Table", "Date and Time")
-                   << QCoreApplication::translate("Table", "Core File")
-                   << QCoreApplication::translate("Table", "User Name ")
-                   << QCoreApplication::translate("Table", "EXE");
             exportThread->exportToZipPublic(fileName, m_currentCoredumpList, labels);
         }
     }
@@ -1454,11 +1665,7 @@ void LogBackend::exportData()
     case Normal: {
         if (!nortempList.isEmpty()) {
             bMatchedData = true;
-            fileName = outPath + "/boot-shutdown-event.txt";
-            labels << QCoreApplication::translate("Table", "Event Type")
-                   << QCoreApplication::translate("Table", "Username")
-                   << QCoreApplication::translate("Tbble", "Date and Time")
-                   << QCoreApplication::translate("Table", "Info");
+            fileName = textExportPath("boot-shutdown-event");
             exportThread->exportToTxtPublic(fileName, nortempList, labels);
         }
     }
@@ -1466,12 +1673,7 @@ void LogBackend::exportData()
     case Audit: {
         if (!aList.isEmpty()) {
             bMatchedData = true;
-            fileName = outPath + "/audit.txt";
-            labels << QCoreApplication::translate("Table", "Event Type")
-                   << QCoreApplication::translate("Table", "Date and Time")
-                   << QCoreApplication::translate("Table", "Process")
-                   << QCoreApplication::translate("Table", "Status")
-                   << QCoreApplication::translate("Table", "Info");
+            fileName = textExportPath("audit");
             exportThread->exportToTxtPublic(fileName, aList, labels);
         }
     }
@@ -1486,10 +1688,120 @@ void LogBackend::exportData()
         return;
     }
 
-    QThreadPool::globalInstance()->start(exportThread);
+    LogWorkScheduler::instance()->start(exportThread, LogWorkScheduler::Export);
     qCInfo(logBackend) << "exporting ...";
 }
 
+/**
+ * @brief LogBackend::exportByRunningInstance 把系统日志的导出请求交给当前用户已运行的图形界面实例
+ * @param arg journal筛选参数
+ * @return 实例是否接手了请求;接手时按实例的结果退出,否则由命令行自行解析
+ */
+bool LogBackend::exportByRunningInstance(const QStringList &arg)
+{
+    LogExportRequest request;
+    request.arg = arg;
+    request.keyword = m_currentSearchStr;
+    request.fileName = textExportPath("system");
+    request.labels = exportLabels(JOURNAL);
+    const LogExportServer::Status status = LogExportServer::send(request);
+    if (LogExportServer::Unanswerable == status)
+        return false;
+
+    int code = -1;
+    if (LogExportServer::Exported == status) {
+        qCInfo(logBackend) << "export success by running instance.";
+        code = 0;
+    } else if (LogExportServer::NoData == status) {
+        qCWarning(logBackend) << "No matching data..";
+    } else {
+        qCWarning(logBackend) << "export failed.";
+    }
+    //命令行在exec之后才退出
+    QTimer::singleShot(0, qApp, [code]() { qApp->exit(code); });
+    return true;
+}
+
+/**
+ * @brief LogBackend::exportLabels 导出文本中各列的表头,顺序和LogExportTraits中的导出列一致
+ */
+QStringList LogBackend::exportLabels(LOG_FLAG flag)
+{
+    QStringList labels;
+    switch (flag) {
+    case JOURNAL:
+    case BOOT_KLU:
+        labels << QCoreApplication::translate("Table", "Level")
+               << QCoreApplication::translate("Table", "Process") // modified by Airy
+               << QCoreApplication::translate("Table", "Date and Time")
+               << QCoreApplication::translate("Table", "Info")
+               << QCoreApplication::translate("Table", "User")
+               << QCoreApplication::translate("Table", "PID");
+        break;
+    case Dmesg:
+        labels << QCoreApplication::translate("Table", "Level")
+               << QCoreApplication::translate("Table", "Date and Time")
+               << QCoreApplication::translate("Table", "Info");
+        break;
+    case KERN:
+        labels << QCoreApplication::translate("Table", "Date and Time")
+               << QCoreApplication::translate("Table", "User")
+               << QCoreApplication::translate("Table", "Process")
+               << QCoreApplication::translate("Table", "Info");
+        break;
+    case BOOT:
+        labels << QCoreApplication::translate("Table", "Status")
+               << QCoreApplication::translate("Table", "Info");
+        break;
+    case DPKG:
+        labels << QCoreApplication::translate("Table", "Date and Time")
+               << QCoreApplication::translate("Table", "Info")
+               << QCoreApplication::translate("Table", "Action");
+        break;
+    case Dnf:
+        labels << QCoreApplication::translate("Table", "Level")
+               << QCoreApplication::translate("Table", "Date and Time")
+               << QCoreApplication::translate("Table", "Info");
+        break;
+    case Kwin:
+        labels << QCoreApplication::translate("Table", "Info");
+        break;
+    case XORG:
+        labels << QCoreApplication::translate("Table", "Offset")
+               << QCoreApplication::translate("Table", "Info");
+        break;
+    case APP:
+        labels << QCoreApplication::translate("Table", "Level")
+               << QCoreApplication::translate("Table", "Date and Time")
+               << QCoreApplication::translate("Table", "Source")
+               << QCoreApplication::translate("Table", "Info");
+        break;
+    case COREDUMP:
+        labels << QCoreApplication::translate("Table", "SIG")
+               << QCoreApplication::translate("Table", "Date and Time")
+               << QCoreApplication::translate("Table", "Core File")
+               << QCoreApplication::translate("Table", "User Name ")
+               << QCoreApplication::translate("Table", "EXE");
+        break;
+    case Normal:
+        labels << QCoreApplication::translate("Table", "Event Type")
+               << QCoreApplication::translate("Table", "Username")
+               << QCoreApplication::translate("Tbble", "Date and Time")
+               << QCoreApplication::translate("Table", "Info");
+        break;
+    case Audit:
+        labels << QCoreApplication::translate("Table", "Event Type")
+               << QCoreApplication::translate("Table", "Date and Time")
+               << QCoreApplication::translate("Table", "Process")
+               << QCoreApplication::translate("Table", "Status")
+               << QCoreApplication::translate("Table", "Info");
+        break;
+    default:
+        break;
+    }
+    return labels;
+}
+
 void LogBackend::resetCategoryOutputPath(const QString &path)
 {
     // 先清空原有路径中的kernel日志文件
@@ -1532,6 +1844,18 @@ void LogBackend::initParser()
             Qt::QueuedConnection);
     connect(m_pParser, &LogFileParser::journaBootlData, this, &LogBackend::slot_journalBootData,
             Qt::QueuedConnection);
+    connect(m_pParser, &LogFileParser::journalFollowData, this, &LogBackend::slot_journalFollowData,
+            Qt::QueuedConnection);
+    connect(m_pParser, &LogFileParser::journalFollowFinished, this, &LogBackend::slot_followFinished,
+            Qt::QueuedConnection);
+    connect(m_pParser, &LogFileParser::kernFollowData, this, &LogBackend::slot_kernFollowData,
+            Qt::QueuedConnection);
+    connect(m_pParser, &LogFileParser::dmesgFollowData, this, &LogBackend::slot_dmesgFollowData,
+            Qt::QueuedConnection);
+    connect(m_pParser, &LogFileParser::lineFollowData, this, &LogBackend::slot_lineFollowData,
+            Qt::QueuedConnection);
+    connect(m_pParser, &LogFileParser::logFollowFinished, this, &LogBackend::slot_followFinished,
+            Qt::QueuedConnection);
     connect(m_pParser, &LogFileParser::appFinished, this,
             &LogBackend::slot_applicationFinished);
     connect(m_pParser, &LogFileParser::appData, this,
@@ -1551,7 +1875,12 @@ void LogBackend::initParser()
 
     connect(m_pParser, &LogFileParser::proccessError, this, &LogBackend::slot_logLoadFailed,
             Qt::QueuedConnection);
-    connect(m_pParser, SIGNAL(dnfFinished(QList<LOG_MSG_DNF>)), this, SLOT(slot_dnfFinished(QList<LOG_MSG_DNF>)));
+    connect(m_pParser, &LogFileParser::dnfData, this, &LogBackend::slot_dnfData,
+            Qt::QueuedConnection);
+    connect(m_pParser, &LogFileParser::dnfFinished, this, &LogBackend::slot_dnfFinished,
+            Qt::QueuedConnection);
+    connect(m_pParser, &LogFileParser::dmesgData, this, &LogBackend::slot_dmesgData,
+            Qt::QueuedConnection);
     connect(m_pParser, &LogFileParser::dmesgFinished, this, &LogBackend::slot_dmesgFinished,
             Qt::QueuedConnection);
 
@@ -1564,6 +1893,10 @@ void LogBackend::initParser()
             Qt::QueuedConnection);
     connect(m_pParser, &LogFileParser::coredumpFinished, this, &LogBackend::slot_coredumpFinished,
             Qt::QueuedConnection);
+    connect(m_pParser, &LogFileParser::coredumpCursor, this, [this](int index, const QString &cursor) {
+        if (index == m_coredumpCurrentIndex)
+            m_coredumpCursor = cursor;
+    }, Qt::QueuedConnection);
 }
 
 QString LogBackend::getOutDirPath() const
@@ -1571,6 +1904,16 @@ QString LogBackend::getOutDirPath() const
     return m_outPath;
 }
 
+/**
+ * @brief LogBackend::textExportPath 文本日志导出文件的路径,开启压缩时后缀加.gz,导出为ndjson时后缀为.ndjson
+ * @param baseName 不带后缀的文件名
+ */
+QString LogBackend::textExportPath(const QString &baseName) const
+{
+    const QString suffix = m_jsonExport ? "ndjson" : "txt";
+    return QString("%1/%2.%3").arg(m_outPath).arg(baseName).arg(m_compressExport ? suffix + ".gz" : suffix);
+}
+
 bool LogBackend::getOutDirPath(const QString &path)
 {
     QString tmpPath = QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation);
@@ -1680,9 +2023,18 @@ bool LogBackend::reportCoredumpInfo()
         coreFilter.timeFilterBegin = timeRange.begin;
         coreFilter.timeFilterEnd = timeRange.end;
     } else {
-        coreFilter.timeFilterBegin = lastTime.toMSecsSinceEpoch();
-        coreFilter.timeFilterEnd = QDateTime::currentDateTime().toMSecsSinceEpoch();
+        //有上次的游标时在journal中从最新记录倒序读到该游标即停止,只读取新增的崩溃;
+        //不限结束时间,避免读取期间产生的记录被跳过后又被游标越过
+        coreFilter.stopCursor = LogApplicationHelper::instance()->getLastReportCursor();
+        if (coreFilter.stopCursor.isEmpty()) {
+            coreFilter.timeFilterBegin = lastTime.toMSecsSinceEpoch();
+            coreFilter.timeFilterEnd = QDateTime::currentDateTime().toMSecsSinceEpoch();
+        } else {
+            //保存的时间为最后一条的下一秒,同一秒内游标之后的记录不能被下限截掉
+            coreFilter.timeFilterBegin = lastTime.addSecs(-1).toMSecsSinceEpoch();
+        }
     }
+    m_coredumpCursor.clear();
 
     if (!m_pParser)
         initParser();
@@ -1854,7 +2206,7 @@ TIME_RANGE LogBackend::getTimeRange(const BUTTONID &periodId)
 QString LogBackend::getApplogPath(const QString &appName)
 {
     QString logPath;
-    QMap<QString, QString> appData = LogApplicationHelper::instance()->getMap();
+    QMap<QString, QString> appData = LogApplicationHelper::instance()->getMap(true);
     for (auto &it2 : appData.toStdMap()) {
         if (it2.second.contains(appName)) {
             logPath = it2.second;
@@ -6,10 +6,15 @@
 #define LOGBACKEND_H
 
 #include "structdef.h"
+#include "logcompactrecords.h"
 
 #include <QObject>
+#include <QScopedPointer>
 
+class QFile;
+class LogExportWriter;
 class LogFileParser;
+class LogRecordFormatter;
 class LogBackend : public QObject
 {
     Q_OBJECT
@@ -19,7 +24,9 @@ public:
     {
         Unknown = -1,
         Export,
-        Report
+        Report,
+        Query,
+        Follow
     };
 
     static LogBackend *instance(QObject *parent = nullptr);
@@ -29,6 +36,15 @@ public:
     // 设置命令行当前工作目录
     void setCmdWorkDir(const QString &dirPath);
 
+    // 按条件导出的文本日志是否压缩为.txt.gz
+    void setCompressExport(bool compress);
+
+    // 按条件导出的文本日志是否每行写为一个json对象(.ndjson)
+    void setJsonExport(bool json);
+
+    // 导出全部日志时是否只导出上次成功导出之后新增的
+    void setIncrementalExport(bool incremental);
+
     // 导出全部日志到指定目录
     int exportAllLogs(const QString &outDir = "");
 
@@ -39,6 +55,15 @@ public:
     // condition 可能为级别、事件类型、状态、审计类型等条件
     bool exportTypeLogsByCondition(const QString &outDir, const QString &type, const QString &period, const QString &condition = "", const QString &keyword = "");
 
+    // 按条件查询日志,结果边解析边写到标准输出
+    bool queryTypeLogsByCondition(const QString &type, const QString &period, const QString &condition = "", const QString &keyword = "");
+
+    // 按条件查询应用日志,结果边解析边写到标准输出
+    bool queryAppLogsByCondition(const QString &appName, const QString &period, const QString &level = "", const QString &keyword = "");
+
+    // 实时跟踪日志,新产生的日志过滤后写到标准输出,直到进程被结束
+    bool followTypeLogs(const QString &type, const QString &level = "", const QString &keyword = "");
+
     // 按应用导出日志
     int exportAppLogs(const QString &outDir, const QString &appName = "");
 
@@ -68,12 +93,19 @@ private slots:
     void slot_kernData(int index, QList<LOG_MSG_JOURNAL> list);
     void slot_kwinFinished(int index);
     void slot_kwinData(int index, QList<LOG_MSG_KWIN> list);
-    void slot_dnfFinished(const QList<LOG_MSG_DNF> &list);
-    void slot_dmesgFinished(const QList<LOG_MSG_DMESG> &list);
+    void slot_dnfFinished(int index);
+    void slot_dnfData(int index, QList<LOG_MSG_DNF> list);
+    void slot_dmesgFinished(int index);
+    void slot_dmesgData(int index, QList<LOG_MSG_DMESG> list);
     void slot_journalFinished(int index);
     void slot_journalBootFinished(int index);
     void slot_journalBootData(int index, QList<LOG_MSG_JOURNAL> list);
     void slot_journalData(int index, QList<LOG_MSG_JOURNAL> list);
+    void slot_journalFollowData(int index, QList<LOG_MSG_JOURNAL> list, const QString &cursor);
+    void slot_kernFollowData(int index, QList<LOG_MSG_JOURNAL> list);
+    void slot_dmesgFollowData(int index, QList<LOG_MSG_DMESG> list);
+    void slot_lineFollowData(int index, QStringList lines);
+    void slot_followFinished(int index);
     void slot_applicationFinished(int index);
     void slot_applicationData(int index, QList<LOG_MSG_APPLICATOIN> list);
     void slot_normalFinished(int index);
@@ -108,8 +140,18 @@ private:
     bool parseData(const LOG_FLAG &flag, const QString &period, const QString &condition);
 
     void exportData();
+    bool exportByRunningInstance(const QStringList &arg);
+    QStringList exportLabels(LOG_FLAG flag);
+
+    bool parseTypeLogsByCondition(const QString &type, const QString &period, const QString &condition, const QString &keyword);
+    bool parseAppLogsByCondition(const QString &appName, const QString &period, const QString &level, const QString &keyword);
+    bool beginQuery();
+    template <typename Traits>
+    void writeQueryRecords(const QList<typename Traits::Record> &list);
+    void finishQuery();
 
     void resetCategoryOutputPath(const QString & path);
+    QString textExportPath(const QString &baseName) const;
     bool getOutDirPath(const QString &path);
     BUTTONID period2Enum(const QString &period);
     int level2Id(const QString &level);
@@ -135,62 +177,44 @@ private:
     //当前解析的日志类型
     LOG_FLAG m_flag {NONE};
 
+    //导出时只保留筛选后的数据,不另存未筛选的原始数据;journal和内核日志数据量最大,紧凑存储,导出时再取出
     /**
      * @brief jBootList 经过筛选完成的启动日志列表
      */
-    /**
-     * @brief jBootListOrigin 未经过筛选的启动日志数据 journalctl --boot cmd.
-     */
-    QList<LOG_MSG_JOURNAL> jBootList, jBootListOrigin;
+    LogCompactJournalList jBootList;
 
     // System log data
-    QList<LOG_MSG_JOURNAL> jList, jListOrigin;
+    LogCompactJournalList jList;
     // Dmesg log data
-    QList<LOG_MSG_DMESG> dmesgList, dmesgListOrigin;
+    QList<LOG_MSG_DMESG> dmesgList;
 
-    QList<LOG_MSG_DNF> dnfList, dnfListOrigin; //dnf.log
+    QList<LOG_MSG_DNF> dnfList; //dnf.log
     /**
      * @brief dList 经过筛选完成的dpkg日志数据
      */
-    /**
-     * @brief dListOrigin 未经过筛选的dpkg日志数据  dpkg.log
-     */
-    QList<LOG_MSG_DPKG> dList, dListOrigin;
+    QList<LOG_MSG_DPKG> dList;
     /**
      * @brief xList 经过筛选完成的xorg日志数据
      */
-    /**
-     * @brief xListOrigin 未经过筛选的xorg日志数据   Xorg.0.log
-     */
-    QList<LOG_MSG_XORG> xList, xListOrigin;
+    QList<LOG_MSG_XORG> xList;
     /**
      * @brief currentBootList 经过筛选完成的启动日志数据
      */
-    /**
-     * @brief bList 未经过筛选的启动日志数据   boot.log
-     */
-    QList<LOG_MSG_BOOT> bList, currentBootList;
+    QList<LOG_MSG_BOOT> currentBootList;
     /**
      * @brief kList 经过筛选完成的内核日志数据
      */
-    /**
-     * @brief kListOrigin 未经过筛选的内核日志数据   kern.log
-     */
-    QList<LOG_MSG_JOURNAL> kList, kListOrigin;
+    LogCompactJournalList kList;
 
     /**
-     * @brief aListOrigin 未经过筛选的审计日志数据   audit/audit.log
+     * @brief aList 经过筛选完成的审计日志数据   audit/audit.log
      */
-    QList<LOG_MSG_AUDIT> aList, aListOrigin;
+    QList<LOG_MSG_AUDIT> aList;
 
     /**
-     * @brief appListOrigin 未经过筛选的内核日志数据   ~/.cache/deepin/xxx.log(.xxx)
+     * @brief appList 经过筛选完成的应用日志数据   ~/.cache/deepin/xxx.log(.xxx)
      */
-    QList<LOG_MSG_APPLICATOIN> appList, appListOrigin;
-    /**
-     * @brief norList add 未经过筛选完成的开关机日志数据 by Airy
-     */
-    QList<LOG_MSG_NORMAL> norList;
+    QList<LOG_MSG_APPLICATOIN> appList;
     /**
      * @brief nortempList 经过筛选的开关机日志数据 add by Airy
      */
@@ -199,14 +223,10 @@ private:
      * @brief m_currentKwinList add 经过筛选完成的kwin日志数据 by Airy /$HOME/.kwin.log
      */
     QList<LOG_MSG_KWIN> m_currentKwinList;
-    /**
-     * @brief m_kwinList 未经过筛选的开关机日志数据
-     */
-    QList<LOG_MSG_KWIN> m_kwinList;
-
 
-    QList<LOG_MSG_COREDUMP> m_coredumpList;
     QList<LOG_MSG_COREDUMP> m_currentCoredumpList;
+    //本次上报读取到的最新一条崩溃记录的游标
+    QString m_coredumpCursor;
 
     //当前搜索关键字
     QString m_currentSearchStr {""};
@@ -241,14 +261,34 @@ private:
     int m_normalCurrentIndex {-1};
     int m_xorgCurrentIndex {-1};
     int m_kwinCurrentIndex {-1};
+    int m_dnfCurrentIndex {-1};
+    int m_dmesgCurrentIndex {-1};
     int m_appCurrentIndex {-1};
     int m_OOCCurrentIndex {-1};
     int m_auditCurrentIndex {-1};
     int m_coredumpCurrentIndex {-1};
+    //当前实时跟踪线程标记量
+    int m_followCurrentIndex {-1};
 
     bool m_isDataLoadComplete {false};
     bool m_bNeedExport {false};
     SessionType m_sessionType {Export};
+    //导出文本时边导出边压缩为gzip
+    bool m_compressExport {false};
+    //导出文本时每行写为一个json对象
+    bool m_jsonExport {false};
+    //导出全部日志时按水位增量导出
+    bool m_incrementalExport {false};
+
+    //查询模式的输出,不保存解析结果
+    QScopedPointer<QFile> m_queryFile;
+    QScopedPointer<LogExportWriter> m_queryOut;
+    QScopedPointer<LogRecordFormatter> m_queryFormatter;
+    QStringList m_queryLabels;
+    //应用日志的应用名称
+    QString m_queryAppName;
+    //已输出的记录数
+    int m_queryCount {0};
 
 private:
     LogFileParser *m_pParser {nullptr};
@@ -0,0 +1,71 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logbatchsizer.h"
+#include "logperformanceprofile.h"
+
+/**
+ * @brief LogBatchSizer::LogBatchSizer 构造函数
+ * @param maxRecords 一批的条数上限,小于等于0时使用性能档位的maxBatchSize
+ * @param maxBytes 一批的估算内存上限
+ * @param deliveriesPerSecond 每秒发送的批次数目标
+ */
+LogBatchSizer::LogBatchSizer(int maxRecords, qint64 maxBytes, int deliveriesPerSecond)
+    : m_maxRecords(maxRecords > 0 ? maxRecords : LogPerformanceProfile::current().maxBatchSize)
+    , m_maxBytes(qMax<qint64>(1, maxBytes))
+    , m_periodUsec(1000000 / qMax(1, deliveriesPerSecond))
+{
+    m_maxRecords = qMax(1, m_maxRecords);
+    reset();
+}
+
+/**
+ * @brief LogBatchSizer::reset 重新开始,下一批为第一批
+ */
+void LogBatchSizer::reset()
+{
+    m_target = qMin(LOG_BATCH_FIRST_RECORDS, m_maxRecords);
+    m_pending = 0;
+    m_bytes = 0;
+    m_fillUsec = -1;
+    m_timer.start();
+}
+
+bool LogBatchSizer::checkFull()
+{
+    if (m_pending <= 0)
+        return false;
+    if (m_pending < m_target && m_bytes < m_maxBytes)
+        return false;
+    if (m_fillUsec < 0)
+        m_fillUsec = m_timer.nsecsElapsed() / 1000;
+    return true;
+}
+
+/**
+ * @brief LogBatchSizer::delivered 一批数据发出之后调用,按本周期的读取速度和发送等待时间计算下一批的大小
+ */
+void LogBatchSizer::delivered()
+{
+    const qint64 cycleUsec = m_timer.nsecsElapsed() / 1000;
+    //没有读满就发出的(最后一批等)整个周期都算读取时间
+    const qint64 fillUsec = qMax<qint64>(1, m_fillUsec < 0 ? cycleUsec : m_fillUsec);
+    const qint64 waitUsec = qMax<qint64>(0, cycleUsec - fillUsec);
+
+    if (m_pending > 0) {
+        //一个周期(或更长的发送等待时间)内能读取的条数
+        const double rate = static_cast<double>(m_pending) / fillUsec;
+        const double wanted = rate * qMax(m_periodUsec, waitUsec);
+        qint64 next = qBound<qint64>(1, static_cast<qint64>(wanted), static_cast<qint64>(m_target) * LOG_BATCH_MAX_GROWTH);
+        //按本批的平均大小限制内存
+        const qint64 averageBytes = qMax<qint64>(1, m_bytes / m_pending);
+        next = qMin(next, qMax<qint64>(1, m_maxBytes / averageBytes));
+        m_target = static_cast<int>(qBound<qint64>(qMin(LOG_BATCH_FIRST_RECORDS, m_maxRecords), next, m_maxRecords));
+    }
+
+    m_pending = 0;
+    m_bytes = 0;
+    m_fillUsec = -1;
+    m_timer.restart();
+}
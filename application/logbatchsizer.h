@@ -0,0 +1,75 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGBATCHSIZER_H
+#define LOGBATCHSIZER_H
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QtGlobal>
+
+//第一批的条数,尽快显示出第一屏
+#define LOG_BATCH_FIRST_RECORDS 50
+//每秒向界面发送的批次数目标
+#define LOG_BATCH_DELIVERIES_PER_SEC 10
+//一批数据的估算内存上限,字节
+#define LOG_BATCH_MAX_BYTES (8 * 1024 * 1024)
+//每次调整时批大小最多放大的倍数,避免一次偶然的快速读取把批次放到上限
+#define LOG_BATCH_MAX_GROWTH 4
+
+/**
+ * @brief The LogBatchSizer class 获取线程向界面发送数据的分批大小
+ * 第一批只有LOG_BATCH_FIRST_RECORDS条,之后按读取速度调整,使每秒发送的批次数接近LOG_BATCH_DELIVERIES_PER_SEC:
+ * 读取快的来源批次变大,减少排队信号和插入的次数;读取慢的来源保持小批次,数据尽快显示。
+ * 发送等待的时间(界面插入慢、发送额度用完)超过一个发送周期时同比放大批次。
+ * 条数不超过性能档位的maxBatchSize,估算内存不超过LOG_BATCH_MAX_BYTES。
+ * 只在一个获取线程内使用
+ */
+class LogBatchSizer
+{
+public:
+    explicit LogBatchSizer(int maxRecords = -1, qint64 maxBytes = LOG_BATCH_MAX_BYTES,
+                           int deliveriesPerSecond = LOG_BATCH_DELIVERIES_PER_SEC);
+
+    /**
+     * @brief isFull 批次是否应当发出,只统计上次调用之后新追加的记录
+     * @param batch 当前批次,发出之前只追加不删除
+     */
+    template <typename T>
+    bool isFull(const QList<T> &batch)
+    {
+        for (int i = qMin(m_pending, batch.size()); i < batch.size(); ++i)
+            m_bytes += recordBytes(batch.at(i));
+        m_pending = batch.size();
+        return checkFull();
+    }
+
+    void delivered();
+    void reset();
+
+    int target() const { return m_target; }
+    int maxRecords() const { return m_maxRecords; }
+
+    template <typename T>
+    static qint64 recordBytes(const T &record)
+    {
+        return static_cast<qint64>(sizeof(T)) + static_cast<qint64>(record.msg.size()) * static_cast<qint64>(sizeof(QChar));
+    }
+
+private:
+    bool checkFull();
+
+    int m_maxRecords;
+    qint64 m_maxBytes;
+    //一个发送周期,微秒
+    qint64 m_periodUsec;
+    int m_target = LOG_BATCH_FIRST_RECORDS;
+    int m_pending = 0;
+    qint64 m_bytes = 0;
+    //本批次读满时距周期开始的时间,微秒,-1表示还未读满
+    qint64 m_fillUsec = -1;
+    QElapsedTimer m_timer;
+};
+
+#endif // LOGBATCHSIZER_H
@@ -0,0 +1,568 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logbenchmark.h"
+#include "logauththread.h"
+#include "logapplicationparsethread.h"
+#include "logexportcolumns.h"
+#include "logexportthread.h"
+#include "loglineindexer.h"
+#include "journalreader.h"
+#include "journalwork.h"
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLoggingCategory>
+#include <QThreadPool>
+
+
+#ifdef QT_DEBUG
+Q_LOGGING_CATEGORY(logBenchmark, "org.deepin.log.viewer.benchmark")
+#else
+Q_LOGGING_CATEGORY(logBenchmark, "org.deepin.log.viewer.benchmark", QtInfoMsg)
+#endif
+
+//统计行数时每次读取的块大小
+#define BENCH_COUNT_CHUNK (1024 * 1024)
+//输出json的格式版本,字段有不兼容的变化时增加
+#define BENCH_JSON_VERSION 1
+
+namespace {
+
+/**
+ * @brief exportLabels 导出表头,基准测试只关心耗时,直接使用ndjson的字段名
+ */
+template <typename Traits>
+QStringList exportLabels()
+{
+    QStringList labels;
+    for (const auto &column : Traits::columns)
+        labels << QString::fromLatin1(column.key);
+    return labels;
+}
+
+//各种记录的导出入口参数不同,系统/内核日志需要flag,应用日志需要应用名称
+template <typename T>
+void startExport(LogExportThread *thread, LogBenchmark::ExportFormat format, const QString &fileName, const QList<T> &list,
+                 const QStringList &labels, LOG_FLAG flag, const QString &appName)
+{
+    Q_UNUSED(flag)
+    Q_UNUSED(appName)
+    switch (format) {
+    case LogBenchmark::BenchHtml:
+        thread->exportToHtmlPublic(fileName, list, labels);
+        break;
+    case LogBenchmark::BenchDoc:
+        thread->exportToDocPublic(fileName, list, labels);
+        break;
+    case LogBenchmark::BenchXls:
+        thread->exportToXlsPublic(fileName, list, labels);
+        break;
+    default:
+        thread->exportToTxtPublic(fileName, list, labels);
+        break;
+    }
+}
+
+void startExport(LogExportThread *thread, LogBenchmark::ExportFormat format, const QString &fileName, const QList<LOG_MSG_JOURNAL> &list,
+                 const QStringList &labels, LOG_FLAG flag, const QString &appName)
+{
+    Q_UNUSED(appName)
+    switch (format) {
+    case LogBenchmark::BenchHtml:
+        thread->exportToHtmlPublic(fileName, list, labels, flag);
+        break;
+    case LogBenchmark::BenchDoc:
+        thread->exportToDocPublic(fileName, list, labels, flag);
+        break;
+    case LogBenchmark::BenchXls:
+        thread->exportToXlsPublic(fileName, list, labels, flag);
+        break;
+    default:
+        thread->exportToTxtPublic(fileName, list, labels, flag);
+        break;
+    }
+}
+
+void startExport(LogExportThread *thread, LogBenchmark::ExportFormat format, const QString &fileName, const QList<LOG_MSG_APPLICATOIN> &list,
+                 const QStringList &labels, LOG_FLAG flag, const QString &appName)
+{
+    Q_UNUSED(flag)
+    switch (format) {
+    case LogBenchmark::BenchHtml:
+        thread->exportToHtmlPublic(fileName, list, labels, appName);
+        break;
+    case LogBenchmark::BenchDoc:
+        thread->exportToDocPublic(fileName, list, labels, appName);
+        break;
+    case LogBenchmark::BenchXls:
+        thread->exportToXlsPublic(fileName, list, labels, appName);
+        break;
+    default:
+        thread->exportToTxtPublic(fileName, list, labels, appName);
+        break;
+    }
+}
+
+} // namespace
+
+LogBenchmark::LogBenchmark(QObject *parent)
+    : QObject(parent)
+{
+}
+
+/**
+ * @brief LogBenchmark::addPath 添加测试输入
+ * @param path 日志文件,或包含多个日志文件的目录(按文件名识别种类)
+ * @param type 文件的日志种类,和-t一致;为空时按文件名识别,system表示读取本机journal
+ * @return 是否有可以测试的输入
+ */
+bool LogBenchmark::addPath(const QString &path, const QString &type)
+{
+    if (type == TYPE_SYSTEM) {
+        m_journalEnabled = true;
+        return true;
+    }
+
+    QFileInfo info(path);
+    if (info.isDir()) {
+        bool added = false;
+        const QFileInfoList files = QDir(path).entryInfoList(QDir::Files | QDir::Readable, QDir::Name);
+        for (const QFileInfo &file : files) {
+            const LOG_FLAG flag = typeForFile(file.fileName());
+            if (flag == NONE)
+                continue;
+            m_inputs.append({flag, file.absoluteFilePath()});
+            added = true;
+        }
+        return added;
+    }
+    if (!info.isFile()) {
+        qCWarning(logBenchmark) << "bench input not found:" << path;
+        return false;
+    }
+
+    LOG_FLAG flag = NONE;
+    if (type.isEmpty())
+        flag = typeForFile(info.fileName());
+    else if (type == TYPE_KERNEL)
+        flag = KERN;
+    else if (type == TYPE_DPKG)
+        flag = DPKG;
+    else if (type == TYPE_BOOT)
+        flag = BOOT;
+    else if (type == TYPE_XORG)
+        flag = XORG;
+    else if (type == TYPE_DNF)
+        flag = Dnf;
+    else if (type == TYPE_AUDIT)
+        flag = Audit;
+    else if (type == TYPE_APP)
+        flag = APP;
+    if (flag == NONE) {
+        qCWarning(logBenchmark) << "unknown bench type for" << path << type;
+        return false;
+    }
+    m_inputs.append({flag, info.absoluteFilePath()});
+    return true;
+}
+
+/**
+ * @brief LogBenchmark::setJournalEnabled 是否测试系统日志,journalWork读取本机journal,不能指定文件
+ */
+void LogBenchmark::setJournalEnabled(bool enabled)
+{
+    m_journalEnabled = enabled;
+}
+
+/**
+ * @brief LogBenchmark::setExportFormats 只测试其中的导出格式,为空时不测试导出
+ */
+void LogBenchmark::setExportFormats(const QList<ExportFormat> &formats)
+{
+    m_exportFormats = formats;
+}
+
+/**
+ * @brief LogBenchmark::run 依次运行所有阶段,每个阶段单独计时,上一阶段的内存峰值不计入下一阶段
+ * @return 所有阶段是否都成功
+ */
+bool LogBenchmark::run()
+{
+    m_results.clear();
+    QDir tmp(QDir::tempPath());
+    m_tmpDir = tmp.filePath(QString("deepin-log-viewer-bench-%1").arg(QCoreApplication::applicationPid()));
+    QDir().mkpath(m_tmpDir);
+
+    for (const Input &input : m_inputs)
+        benchInput(input);
+    if (m_journalEnabled)
+        benchJournal();
+
+    QDir(m_tmpDir).removeRecursively();
+    bool ok = !m_results.isEmpty();
+    for (const LogBenchResult &result : m_results)
+        ok = ok && result.ok;
+    return ok;
+}
+
+QList<LogBenchResult> LogBenchmark::results() const
+{
+    return m_results;
+}
+
+/**
+ * @brief LogBenchmark::typeForFile 按文件名识别日志种类,轮转和压缩后的文件(如kern.log.1、dpkg.log.2.gz)同种
+ * @return 日志种类,不认识的文件为NONE
+ */
+LOG_FLAG LogBenchmark::typeForFile(const QString &fileName)
+{
+    if (fileName.startsWith("kern.log"))
+        return KERN;
+    if (fileName.startsWith("dpkg.log"))
+        return DPKG;
+    if (fileName.startsWith("boot.log"))
+        return BOOT;
+    if (fileName.startsWith("Xorg.") && fileName.contains(".log"))
+        return XORG;
+    if (fileName.startsWith("dnf.log"))
+        return Dnf;
+    if (fileName.startsWith("audit.log"))
+        return Audit;
+    //其余的.log按应用日志格式解析
+    if (fileName.endsWith(".log"))
+        return APP;
+    return NONE;
+}
+
+/**
+ * @brief LogBenchmark::toJson 结果转为json,吞吐按耗时换算,耗时为0时按1毫秒计
+ */
+QByteArray LogBenchmark::toJson(const QList<LogBenchResult> &results)
+{
+    QJsonArray array;
+    for (const LogBenchResult &result : results) {
+        const double seconds = qMax<qint64>(result.elapsedMs, 1) / 1000.0;
+        QJsonObject obj;
+        obj.insert("stage", result.stage);
+        obj.insert("name", result.name);
+        obj.insert("path", result.path);
+        obj.insert("ok", result.ok);
+        obj.insert("bytes", static_cast<double>(result.bytes));
+        obj.insert("lines", static_cast<double>(result.lines));
+        obj.insert("records", static_cast<double>(result.records));
+        obj.insert("elapsedMs", static_cast<double>(result.elapsedMs));
+        obj.insert("firstBatchMs", result.firstBatchMs < 0 ? QJsonValue() : QJsonValue(static_cast<double>(result.firstBatchMs)));
+        obj.insert("linesPerSec", result.lines / seconds);
+        obj.insert("mbPerSec", result.bytes / 1048576.0 / seconds);
+        obj.insert("peakRssKb", static_cast<double>(result.peakRssKb));
+        array.append(obj);
+    }
+    QJsonObject root;
+    root.insert("version", BENCH_JSON_VERSION);
+    root.insert("results", array);
+    return QJsonDocument(root).toJson(QJsonDocument::Indented);
+}
+
+/**
+ * @brief LogBenchmark::resetPeakRss 重置进程的峰值常驻内存(Linux 4.0起支持),失败时峰值为进程启动以来的值
+ */
+bool LogBenchmark::resetPeakRss()
+{
+    QFile file("/proc/self/clear_refs");
+    return file.open(QIODevice::WriteOnly) && file.write("5") == 1;
+}
+
+/**
+ * @brief LogBenchmark::peakRssKb 读取/proc/self/status中的VmHWM
+ */
+qint64 LogBenchmark::peakRssKb()
+{
+    QFile file("/proc/self/status");
+    if (!file.open(QIODevice::ReadOnly))
+        return 0;
+    const QList<QByteArray> lines = file.readAll().split('\n');
+    for (const QByteArray &line : lines) {
+        if (line.startsWith("VmHWM:"))
+            return line.mid(6).trimmed().split(' ').value(0).toLongLong();
+    }
+    return 0;
+}
+
+/**
+ * @brief LogBenchmark::countLines 统计文本文件的行数,压缩文件和无法读取的文件返回-1
+ */
+qint64 LogBenchmark::countLines(const QString &path)
+{
+    if (path.endsWith(".gz"))
+        return -1;
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return -1;
+    qint64 lines = 0;
+    QByteArray buffer(BENCH_COUNT_CHUNK, Qt::Uninitialized);
+    qint64 length;
+    bool endsWithNewline = true;
+    while ((length = file.read(buffer.data(), buffer.size())) > 0) {
+        lines += LogLineIndexer::count(buffer.constData(), length);
+        endsWithNewline = buffer.at(static_cast<int>(length - 1)) == '\n';
+    }
+    //最后一行没有换行符
+    if (!endsWithNewline)
+        ++lines;
+    return lines;
+}
+
+void LogBenchmark::benchInput(const Input &input)
+{
+    switch (input.flag) {
+    case KERN:
+        benchAuth<LogExportTraits<LOG_MSG_JOURNAL, KERN>>(input, "kern", KERN, [this](LogAuthThread *thread, QList<LOG_MSG_JOURNAL> *records) {
+            thread->setFileterParam(KERN_FILTERS());
+            connect(thread, &LogAuthThread::kernData, this, [this, records](int, QList<LOG_MSG_JOURNAL> list) {
+                onBatch(list.size());
+                records->append(list);
+            }, Qt::DirectConnection);
+        });
+        break;
+    case DPKG:
+        benchAuth<LogExportTraits<LOG_MSG_DPKG>>(input, "dpkg", DPKG, [this](LogAuthThread *thread, QList<LOG_MSG_DPKG> *records) {
+            thread->setFileterParam(DKPG_FILTERS());
+            connect(thread, &LogAuthThread::dpkgData, this, [this, records](int, QList<LOG_MSG_DPKG> list) {
+                onBatch(list.size());
+                records->append(list);
+            }, Qt::DirectConnection);
+        });
+        break;
+    case BOOT:
+        benchAuth<LogExportTraits<LOG_MSG_BOOT>>(input, "boot", BOOT, [this](LogAuthThread *thread, QList<LOG_MSG_BOOT> *records) {
+            connect(thread, &LogAuthThread::bootData, this, [this, records](int, QList<LOG_MSG_BOOT> list) {
+                onBatch(list.size());
+                records->append(list);
+            }, Qt::DirectConnection);
+        });
+        break;
+    case XORG:
+        benchAuth<LogExportTraits<LOG_MSG_XORG>>(input, "xorg", XORG, [this](LogAuthThread *thread, QList<LOG_MSG_XORG> *records) {
+            thread->setFileterParam(XORG_FILTERS());
+            connect(thread, &LogAuthThread::xorgData, this, [this, records](int, QList<LOG_MSG_XORG> list) {
+                onBatch(list.size());
+                records->append(list);
+            }, Qt::DirectConnection);
+        });
+        break;
+    case Dnf:
+        benchAuth<LogExportTraits<LOG_MSG_DNF>>(input, "dnf", Dnf, [this](LogAuthThread *thread, QList<LOG_MSG_DNF> *records) {
+            DNF_FILTERS filter;
+            filter.timeFilter = 0;
+            filter.levelfilter = DNFLVALL;
+            thread->setFileterParam(filter);
+            connect(thread, &LogAuthThread::dnfData, this, [this, records](int, QList<LOG_MSG_DNF> list) {
+                onBatch(list.size());
+                records->append(list);
+            }, Qt::DirectConnection);
+        });
+        break;
+    case Audit:
+        benchAuth<LogExportTraits<LOG_MSG_AUDIT>>(input, "audit", Audit, [this](LogAuthThread *thread, QList<LOG_MSG_AUDIT> *records) {
+            thread->setFileterParam(AUDIT_FILTERS());
+            connect(thread, &LogAuthThread::auditData, this, [this, records](int, QList<LOG_MSG_AUDIT> list) {
+                onBatch(list.size());
+                records->append(list);
+            }, Qt::DirectConnection);
+        });
+        break;
+    case APP:
+        benchApp(input.path);
+        break;
+    default:
+        break;
+    }
+}
+
+/**
+ * @brief LogBenchmark::benchAuth 用LogAuthThread解析一个文件,再把解析结果按各种格式导出
+ * @param setup 设置筛选条件,连接数据信号
+ */
+template <typename Traits>
+void LogBenchmark::benchAuth(const Input &input, const QString &name, LOG_FLAG exportFlag,
+                             const std::function<void(LogAuthThread *, QList<typename Traits::Record> *)> &setup)
+{
+    LogBenchResult result;
+    result.stage = "parse";
+    result.name = name;
+    result.path = input.path;
+    result.bytes = QFileInfo(input.path).size();
+
+    QList<typename Traits::Record> records;
+    LogAuthThread *thread = new LogAuthThread;
+    thread->setType(input.flag);
+    thread->setFilePath(QStringList() << input.path);
+    setup(thread, &records);
+
+    beginStage(result);
+    runRunnable(thread);
+    endStage(result);
+    result.ok = true;
+    m_results.append(result);
+
+    benchExports<Traits>(name, records, exportFlag);
+}
+
+/**
+ * @brief LogBenchmark::benchApp 用LogApplicationParseThread解析应用日志,文件列表由服务按路径查找
+ */
+void LogBenchmark::benchApp(const QString &path)
+{
+    LogBenchResult result;
+    result.stage = "parse";
+    result.name = "app";
+    result.path = path;
+    result.bytes = QFileInfo(path).size();
+
+    QList<LOG_MSG_APPLICATOIN> records;
+    LogApplicationParseThread thread;
+    APP_FILTERS filter;
+    filter.lvlFilter = LVALL;
+    filter.path = path;
+    thread.setParam(filter);
+    connect(&thread, &LogApplicationParseThread::appData, this, [this, &records](int, QList<LOG_MSG_APPLICATOIN> list) {
+        onBatch(list.size());
+        records.append(list);
+    }, Qt::DirectConnection);
+
+    beginStage(result);
+    thread.start();
+    thread.wait();
+    endStage(result);
+    result.ok = true;
+    m_results.append(result);
+
+    benchExports<LogExportTraits<LOG_MSG_APPLICATOIN>>("app", records, APP, QFileInfo(path).baseName());
+}
+
+/**
+ * @brief LogBenchmark::benchJournal 用journalWork读取本机全部系统日志,bytes为journal文件的总大小
+ */
+void LogBenchmark::benchJournal()
+{
+    LogBenchResult result;
+    result.stage = "parse";
+    result.name = "journal";
+    result.path = "journal";
+    for (const QString &file : JournalReaderBase::journalFiles())
+        result.bytes += QFileInfo(file).size();
+
+    QList<LOG_MSG_JOURNAL> records;
+    journalWork *work = new journalWork;
+    work->setArg(QStringList() << "all");
+    connect(work, &journalWork::journalData, this, [this, &records](int, QList<LOG_MSG_JOURNAL> list) {
+        onBatch(list.size());
+        records.append(list);
+    }, Qt::DirectConnection);
+
+    beginStage(result);
+    runRunnable(work);
+    endStage(result);
+    result.ok = true;
+    m_results.append(result);
+
+    benchExports<LogExportTraits<LOG_MSG_JOURNAL, JOURNAL>>("journal", records, JOURNAL);
+}
+
+/**
+ * @brief LogBenchmark::benchExports 把解析结果依次导出为txt、ndjson、html、doc、xls中选定的格式
+ */
+template <typename Traits>
+void LogBenchmark::benchExports(const QString &name, const QList<typename Traits::Record> &records, LOG_FLAG flag, const QString &appName)
+{
+    if (records.isEmpty())
+        return;
+
+    static const struct {
+        ExportFormat format;
+        const char *suffix;
+    } formats[] = {
+        {BenchTxt, "txt"},
+        {BenchNdjson, "ndjson"},
+        {BenchHtml, "html"},
+        {BenchDoc, "doc"},
+        {BenchXls, "xls"},
+    };
+    const QStringList labels = exportLabels<Traits>();
+    for (const auto &item : formats) {
+        if (!m_exportFormats.contains(item.format))
+            continue;
+        LogBenchResult result;
+        result.stage = "export";
+        result.name = QString("%1.%2").arg(name, item.suffix);
+        result.path = QDir(m_tmpDir).filePath(result.name);
+
+        bool ok = false;
+        LogExportThread *thread = new LogExportThread(true);
+        connect(thread, &LogExportThread::sigResult, this, [&ok](bool isSuccess) {
+            ok = isSuccess;
+        }, Qt::DirectConnection);
+        startExport(thread, item.format, result.path, records, labels, flag, appName);
+
+        beginStage(result);
+        runRunnable(thread);
+        endStage(result);
+        //导出阶段的记录数是输入,不是回调计数
+        result.records = records.size();
+        result.lines = records.size();
+        result.firstBatchMs = -1;
+        result.bytes = QFileInfo(result.path).size();
+        result.ok = ok;
+        QFile::remove(result.path);
+        m_results.append(result);
+    }
+}
+
+void LogBenchmark::beginStage(LogBenchResult &result)
+{
+    Q_UNUSED(result)
+    resetPeakRss();
+    m_firstBatch = -1;
+    m_records = 0;
+    m_timer.start();
+}
+
+void LogBenchmark::endStage(LogBenchResult &result)
+{
+    result.elapsedMs = m_timer.elapsed();
+    result.firstBatchMs = m_firstBatch;
+    result.records = m_records;
+    result.peakRssKb = peakRssKb();
+    if (result.stage == "parse") {
+        const qint64 lines = result.path == "journal" ? -1 : countLines(result.path);
+        result.lines = lines < 0 ? result.records : lines;
+    }
+}
+
+/**
+ * @brief LogBenchmark::onBatch 解析线程交出一批数据,在解析线程中调用
+ */
+void LogBenchmark::onBatch(int count)
+{
+    qint64 none = -1;
+    m_firstBatch.compare_exchange_strong(none, m_timer.elapsed());
+    m_records += count;
+}
+
+/**
+ * @brief LogBenchmark::runRunnable 在单独的线程池中运行并等待结束,运行结束后由线程池删除
+ */
+void LogBenchmark::runRunnable(QRunnable *runnable)
+{
+    QThreadPool pool;
+    pool.setMaxThreadCount(1);
+    pool.start(runnable);
+    pool.waitForDone();
+}
@@ -0,0 +1,107 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGBENCHMARK_H
+#define LOGBENCHMARK_H
+
+#include "structdef.h"
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QList>
+#include <QObject>
+#include <QStringList>
+
+#include <atomic>
+#include <functional>
+
+class QRunnable;
+class LogAuthThread;
+class LogExportThread;
+
+/**
+ * @brief The LogBenchResult struct 一个基准测试阶段的结果
+ */
+struct LogBenchResult {
+    //parse或export
+    QString stage;
+    //解析器或导出格式名称,如kern、journal、kern.txt
+    QString name;
+    QString path;
+    //解析时为输入字节数,导出时为输出文件大小
+    qint64 bytes = 0;
+    //输入行数,无法统计时和记录数相同
+    qint64 lines = 0;
+    qint64 records = 0;
+    qint64 elapsedMs = 0;
+    //第一批数据交出的耗时,-1表示没有分批
+    qint64 firstBatchMs = -1;
+    //阶段内的峰值常驻内存,KB
+    qint64 peakRssKb = 0;
+    bool ok = false;
+};
+
+/**
+ * @brief The LogBenchmark class 命令行--bench,在指定文件或目录上依次运行各个解析线程和各种导出格式,
+ * 统计吞吐、峰值内存和首批数据耗时,以json输出,用于比较不同版本的加载性能
+ */
+class LogBenchmark : public QObject
+{
+    Q_OBJECT
+public:
+    enum ExportFormat {
+        BenchTxt,
+        BenchNdjson,
+        BenchHtml,
+        BenchDoc,
+        BenchXls
+    };
+
+    explicit LogBenchmark(QObject *parent = nullptr);
+
+    bool addPath(const QString &path, const QString &type = QString());
+    void setJournalEnabled(bool enabled);
+    void setExportFormats(const QList<ExportFormat> &formats);
+    bool run();
+    QList<LogBenchResult> results() const;
+
+    static LOG_FLAG typeForFile(const QString &fileName);
+    static QByteArray toJson(const QList<LogBenchResult> &results);
+    static bool resetPeakRss();
+    static qint64 peakRssKb();
+    static qint64 countLines(const QString &path);
+
+private:
+    struct Input {
+        LOG_FLAG flag;
+        QString path;
+    };
+
+    void benchInput(const Input &input);
+    void benchJournal();
+    void benchApp(const QString &path);
+    template <typename Traits>
+    void benchAuth(const Input &input, const QString &name, LOG_FLAG exportFlag,
+                   const std::function<void(LogAuthThread *, QList<typename Traits::Record> *)> &setup);
+    template <typename Traits>
+    void benchExports(const QString &name, const QList<typename Traits::Record> &records, LOG_FLAG flag, const QString &appName = QString());
+    void beginStage(LogBenchResult &result);
+    void endStage(LogBenchResult &result);
+    void onBatch(int count);
+    void runRunnable(QRunnable *runnable);
+
+    QList<Input> m_inputs;
+    bool m_journalEnabled = false;
+    //要测试的导出格式,默认全部
+    QList<ExportFormat> m_exportFormats {BenchTxt, BenchNdjson, BenchHtml, BenchDoc, BenchXls};
+    QList<LogBenchResult> m_results;
+    //当前阶段的计时、首批时间和记录数,批次在解析线程中直接回调
+    QElapsedTimer m_timer;
+    std::atomic<qint64> m_firstBatch {-1};
+    std::atomic<qint64> m_records {0};
+    //导出文件的临时目录
+    QString m_tmpDir;
+};
+
+#endif // LOGBENCHMARK_H
@@ -0,0 +1,76 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logbytesanitizer.h"
+
+#include <string.h>
+
+namespace {
+//[data, data + length)中第一个要处理的字节,没有时返回nullptr
+const char *firstDirty(const char *data, int length, LogByteSanitizer::Mode mode)
+{
+    if (length <= 0)
+        return nullptr;
+    const char *nul = static_cast<const char *>(memchr(data, '\0', static_cast<size_t>(length)));
+    if (mode == LogByteSanitizer::ReplaceNul)
+        return nul;
+    //0x01只需要在第一个0x00之前查找
+    const int sohRange = nul ? static_cast<int>(nul - data) : length;
+    const char *soh = static_cast<const char *>(memchr(data, '\x01', static_cast<size_t>(sohRange)));
+    return soh ? soh : nul;
+}
+}
+
+/**
+ * @brief LogByteSanitizer::isClean 数据中是否没有需要处理的字节
+ */
+bool LogByteSanitizer::isClean(const char *data, int length, Mode mode)
+{
+    return firstDirty(data, length, mode) == nullptr;
+}
+
+/**
+ * @brief LogByteSanitizer::sanitize 原地处理控制字符
+ * @param data 数据,去掉字节时后面的内容前移
+ * @param length 数据长度
+ * @return 处理后的长度
+ */
+int LogByteSanitizer::sanitize(char *data, int length, Mode mode)
+{
+    const char *dirty = firstDirty(data, length, mode);
+    if (!dirty)
+        return length;
+
+    char *end = data + length;
+    char *p = data + (dirty - data);
+    if (mode == ReplaceNul) {
+        //逐段memchr,两个0x00之间的内容不逐字节检查
+        while (p) {
+            *p = ' ';
+            p = static_cast<char *>(memchr(p + 1, '\0', static_cast<size_t>(end - p - 1)));
+        }
+        return length;
+    }
+
+    char *out = p;
+    for (; p != end; ++p) {
+        const char c = *p;
+        if (c == '\x01' || (c == '\0' && mode == RemoveNulAndSoh))
+            continue;
+        *out++ = c == '\0' ? ' ' : c;
+    }
+    return static_cast<int>(out - data);
+}
+
+/**
+ * @brief LogByteSanitizer::sanitize 原地处理QByteArray,没有要处理的字节时不分离共享的数据
+ * @return 是否有改动
+ */
+bool LogByteSanitizer::sanitize(QByteArray &data, Mode mode)
+{
+    if (isClean(data.constData(), data.size(), mode))
+        return false;
+    data.truncate(sanitize(data.data(), data.size(), mode));
+    return true;
+}
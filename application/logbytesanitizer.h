@@ -0,0 +1,32 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGBYTESANITIZER_H
+#define LOGBYTESANITIZER_H
+
+#include <QByteArray>
+
+/**
+ * @brief The LogByteSanitizer class 日志原始字节中控制字符的原地处理,应用、提权服务和提权工具共用
+ * 0x00会让QString转换和std::cout提前截断,0x01出现于部分进程名的最后一个字符;
+ * 用memchr(glibc中为SIMD实现)查找要改写的字节,干净的数据只扫描不改写,QByteArray也不会因此分离出副本
+ */
+class LogByteSanitizer
+{
+public:
+    enum Mode {
+        //0x00替换为空格,长度不变,服务端读取文件时使用
+        ReplaceNul,
+        //去掉0x00和0x01,读取命令输出时使用
+        RemoveNulAndSoh,
+        //0x00替换为空格并去掉0x01,进程内逐行解码时使用
+        ReplaceNulRemoveSoh
+    };
+
+    static bool isClean(const char *data, int length, Mode mode);
+    static int sanitize(char *data, int length, Mode mode);
+    static bool sanitize(QByteArray &data, Mode mode);
+};
+
+#endif // LOGBYTESANITIZER_H
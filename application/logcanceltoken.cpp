@@ -0,0 +1,209 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logcanceltoken.h"
+#include "logsharedring.h"
+
+#include <QDBusPendingCallWatcher>
+#include <QEventLoop>
+#include <QLoggingCategory>
+#include <QProcess>
+#include <QTimer>
+
+#include <limits>
+
+#ifdef QT_DEBUG
+Q_LOGGING_CATEGORY(logCancel, "org.deepin.log.viewer.cancel")
+#else
+Q_LOGGING_CATEGORY(logCancel, "org.deepin.log.viewer.cancel", QtInfoMsg)
+#endif
+
+namespace {
+//当前线程安装的令牌,没有安装时为空
+thread_local const std::atomic_bool *t_canRun = nullptr;
+}
+
+LogCancelToken::LogCancelToken(const std::atomic_bool &canRun)
+    : m_canRun(&canRun)
+{
+}
+
+bool LogCancelToken::isCancelled() const
+{
+    return m_canRun && !m_canRun->load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief LogCancelToken::waitForReply 等待总线调用返回,回复到达时立即返回,取消时最迟LOG_CANCEL_POLL_MSEC返回
+ * 服务端的调用仍会执行完,回复到达后被丢弃;不可取消的令牌直接阻塞等待
+ * @return 回复已到达返回true,被取消返回false
+ */
+bool LogCancelToken::waitForReply(QDBusPendingCall &call) const
+{
+    if (!m_canRun) {
+        call.waitForFinished();
+        return true;
+    }
+    if (call.isFinished())
+        return true;
+    if (isCancelled())
+        return false;
+
+    //回复在本线程的事件循环中通知,和exportLogFiles等待进度信号的方式一致
+    QEventLoop loop;
+    QDBusPendingCallWatcher watcher(call);
+    QObject::connect(&watcher, &QDBusPendingCallWatcher::finished, &loop, &QEventLoop::quit);
+    QTimer timer;
+    QObject::connect(&timer, &QTimer::timeout, &loop, [this, &loop]() {
+        if (isCancelled())
+            loop.quit();
+    });
+    timer.start(LOG_CANCEL_POLL_MSEC);
+    if (!watcher.isFinished())
+        loop.exec(QEventLoop::ExcludeUserInputEvents);
+    if (watcher.isFinished())
+        return true;
+    qCDebug(logCancel) << "dbus call abandoned on cancel";
+    return false;
+}
+
+/**
+ * @brief LogCancelToken::waitForProcess 等待子进程结束,取消时在本线程结束子进程
+ * 提权的子进程由共享内存标记通知退出,这里只结束pkexec本身
+ * @return 子进程正常结束返回true,被取消返回false
+ */
+bool LogCancelToken::waitForProcess(QProcess *process) const
+{
+    if (!process)
+        return false;
+    if (!m_canRun)
+        return process->waitForFinished(-1);
+    while (process->state() != QProcess::NotRunning) {
+        if (isCancelled()) {
+            process->kill();
+            process->waitForFinished(LOG_CANCEL_POLL_MSEC);
+            qCDebug(logCancel) << "process killed on cancel:" << process->program();
+            return false;
+        }
+        if (process->waitForFinished(LOG_CANCEL_POLL_MSEC))
+            break;
+    }
+    return !isCancelled();
+}
+
+/**
+ * @brief LogCancelToken::readAll 分块读取到结尾,块之间检查取消,代替QIODevice::readAll读取大文件
+ * @return 读到结尾返回true,被取消或读取失败返回false
+ */
+bool LogCancelToken::readAll(QIODevice *device, QByteArray &data) const
+{
+    data.clear();
+    if (!device)
+        return false;
+    const qint64 size = device->size();
+    if (size > 0 && !device->isSequential())
+        data.reserve(static_cast<int>(qMin<qint64>(size, std::numeric_limits<int>::max())));
+    QByteArray chunk;
+    for (;;) {
+        if (isCancelled())
+            return false;
+        chunk = device->read(LOG_CANCEL_READ_CHUNK);
+        if (chunk.isEmpty())
+            return device->atEnd() || device->isSequential();
+        data.append(chunk);
+    }
+}
+
+/**
+ * @brief LogCancelToken::readLines 边运行边读取子进程的输出,每读到一行立即交给解析,
+ * 不等子进程退出、也不把全部输出缓存在内存中;取消或回调返回false时结束子进程
+ * @return 子进程输出读完返回true,被取消或停止返回false
+ */
+bool LogCancelToken::readLines(QProcess *process, const LineHandler &handler) const
+{
+    if (!process)
+        return false;
+    QByteArray line;
+    for (;;) {
+        while (process->canReadLine()) {
+            line = process->readLine();
+            line.chop(1);
+            if (isCancelled() || !handler(line)) {
+                process->kill();
+                process->waitForFinished(LOG_CANCEL_POLL_MSEC);
+                return false;
+            }
+        }
+        if (process->state() == QProcess::NotRunning)
+            break;
+        if (isCancelled()) {
+            process->kill();
+            process->waitForFinished(LOG_CANCEL_POLL_MSEC);
+            qCDebug(logCancel) << "process killed on cancel:" << process->program();
+            return false;
+        }
+        //不可取消时也按间隔醒来,子进程退出时返回false,下一轮读取剩余的输出
+        process->waitForReadyRead(LOG_CANCEL_POLL_MSEC);
+    }
+    //最后一行可能没有换行符
+    line = process->readAll();
+    if (!line.isEmpty() && !handler(line))
+        return false;
+    return !isCancelled();
+}
+
+/**
+ * @brief LogCancelToken::readLines 从共享内存数据通道按行读取提权子进程写入的数据,
+ * 子进程的标准输出只剩错误信息;取消或回调返回false时通知子进程停止并结束子进程
+ * @return 子进程写完且全部读完返回true,被取消、停止或子进程异常退出返回false
+ */
+bool LogCancelToken::readLines(QProcess *process, LogSharedRing &ring, const LineHandler &handler) const
+{
+    if (!process)
+        return false;
+    const bool completed = ring.readLines([&](const QByteArray &line) {
+        return !isCancelled() && handler(line);
+    }, [&]() {
+        //waitForFinished顺便读走子进程的错误输出,避免子进程阻塞在写标准输出上
+        return !isCancelled() && process->state() != QProcess::NotRunning && !process->waitForFinished(0);
+    });
+    if (!completed && process->state() != QProcess::NotRunning) {
+        process->kill();
+        process->waitForFinished(LOG_CANCEL_POLL_MSEC);
+        return false;
+    }
+    waitForProcess(process);
+    return completed && !isCancelled();
+}
+
+/**
+ * @brief LogCancelToken::current 当前线程安装的令牌,没有安装时返回不可取消的令牌
+ */
+LogCancelToken LogCancelToken::current()
+{
+    if (!t_canRun)
+        return LogCancelToken();
+    return LogCancelToken(*t_canRun);
+}
+
+LogCancelScope::LogCancelScope(const std::atomic_bool &canRun)
+    : m_previous(t_canRun)
+{
+    t_canRun = &canRun;
+}
+
+/**
+ * @brief LogCancelScope::LogCancelScope 安装另一线程的令牌,令牌不可取消时本线程也不可取消
+ * 令牌引用的标记由启动工作线程的获取线程持有,工作线程在它之前结束
+ */
+LogCancelScope::LogCancelScope(const LogCancelToken &token)
+    : m_previous(t_canRun)
+{
+    t_canRun = token.m_canRun;
+}
+
+LogCancelScope::~LogCancelScope()
+{
+    t_canRun = m_previous;
+}
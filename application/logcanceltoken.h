@@ -0,0 +1,72 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGCANCELTOKEN_H
+#define LOGCANCELTOKEN_H
+
+#include <QByteArray>
+
+#include <atomic>
+#include <functional>
+
+class LogSharedRing;
+class QDBusPendingCall;
+class QIODevice;
+class QProcess;
+
+//取消后等待中的总线调用、子进程最迟多久返回,毫秒
+#define LOG_CANCEL_POLL_MSEC 5
+//可取消的文件读取每次读取的字节数
+#define LOG_CANCEL_READ_CHUNK (4 * 1024 * 1024)
+
+/**
+ * @brief The LogCancelToken class 获取线程的取消标记,包装各线程已有的m_canRun
+ * 解析循环继续检查m_canRun;阻塞的总线调用、子进程和整文件读取通过当前线程的令牌等待,
+ * stopAllLoad置m_canRun为false后几毫秒内返回,线程可以立即处理下一次加载。
+ * 默认构造的令牌永远不会取消,界面线程中没有安装令牌时行为和原来一致
+ */
+class LogCancelToken
+{
+public:
+    LogCancelToken() = default;
+    explicit LogCancelToken(const std::atomic_bool &canRun);
+
+    bool isCancelled() const;
+    bool isCancellable() const { return m_canRun != nullptr; }
+
+    bool waitForReply(QDBusPendingCall &call) const;
+    bool waitForProcess(QProcess *process) const;
+    bool readAll(QIODevice *device, QByteArray &data) const;
+    /**
+     * @brief LineHandler 子进程输出的每一行(不含换行符),返回false时停止读取
+     */
+    typedef std::function<bool(const QByteArray &)> LineHandler;
+    bool readLines(QProcess *process, const LineHandler &handler) const;
+    bool readLines(QProcess *process, LogSharedRing &ring, const LineHandler &handler) const;
+
+    static LogCancelToken current();
+
+private:
+    friend class LogCancelScope;
+    const std::atomic_bool *m_canRun = nullptr;
+};
+
+/**
+ * @brief The LogCancelScope class 在当前线程安装取消令牌,析构时恢复,放在获取线程的run/doWork开头;
+ * 获取线程启动的工作线程用LogCancelToken::current()取得的令牌安装,和LogIngestScope一起放在线程函数开头
+ */
+class LogCancelScope
+{
+public:
+    explicit LogCancelScope(const std::atomic_bool &canRun);
+    explicit LogCancelScope(const LogCancelToken &token);
+    ~LogCancelScope();
+    LogCancelScope(const LogCancelScope &) = delete;
+    LogCancelScope &operator=(const LogCancelScope &) = delete;
+
+private:
+    const std::atomic_bool *m_previous;
+};
+
+#endif // LOGCANCELTOKEN_H
@@ -0,0 +1,164 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logcasematcher.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+//每次向量比较的UTF-16字符数
+#define LOG_CASE_MATCHER_LANES 8
+//折叠为k的开尔文符号
+#define LOG_CASE_KELVIN_SIGN 0x212a
+//折叠为s的长s
+#define LOG_CASE_LONG_S 0x017f
+
+LogCaseMatcher::LogCaseMatcher(const QString &pattern)
+    : m_pattern(pattern)
+    , m_fallback(pattern, Qt::CaseInsensitive)
+{
+    if (pattern.isEmpty())
+        return;
+    m_firstCount = variants(pattern.at(0).unicode(), m_first);
+    m_lastCount = variants(pattern.at(pattern.length() - 1).unicode(), m_last);
+}
+
+/**
+ * @brief LogCaseMatcher::variants 和ch按foldCase相等的所有字符,只处理ASCII
+ * 折叠到ASCII字母的非ASCII字符只有开尔文符号(k)和长s(s)两个
+ * @param ch 关键字中的字符
+ * @param out 输出各形式
+ * @return 形式个数,非ASCII字符返回0
+ */
+int LogCaseMatcher::variants(ushort ch, ushort *out)
+{
+    if (ch >= 0x80)
+        return 0;
+    if (ch >= 'A' && ch <= 'Z')
+        ch = static_cast<ushort>(ch - 'A' + 'a');
+    int count = 0;
+    out[count++] = ch;
+    if (ch >= 'a' && ch <= 'z') {
+        out[count++] = static_cast<ushort>(ch - 'a' + 'A');
+        if (ch == 'k')
+            out[count++] = LOG_CASE_KELVIN_SIGN;
+        else if (ch == 's')
+            out[count++] = LOG_CASE_LONG_S;
+    }
+    return count;
+}
+
+/**
+ * @brief LogCaseMatcher::verify 首尾已对上的位置逐字符不区分大小写比较
+ */
+bool LogCaseMatcher::verify(const QString &text, int pos) const
+{
+    return QStringRef(&text, pos, m_pattern.length()).compare(m_pattern, Qt::CaseInsensitive) == 0;
+}
+
+/**
+ * @brief LogCaseMatcher::scalarIndexIn 逐个位置比较首尾字符,用于向量处理不完的结尾
+ * @param end 候选开始位置的上界(不含)
+ */
+int LogCaseMatcher::scalarIndexIn(const QString &text, int from, int end) const
+{
+    const ushort *data = text.utf16();
+    const int tail = m_pattern.length() - 1;
+    for (int i = from; i < end; ++i) {
+        const ushort first = data[i];
+        const ushort last = data[i + tail];
+        bool hit = false;
+        for (int j = 0; j < m_firstCount && !hit; ++j)
+            hit = first == m_first[j];
+        if (!hit)
+            continue;
+        hit = false;
+        for (int j = 0; j < m_lastCount && !hit; ++j)
+            hit = last == m_last[j];
+        if (hit && verify(text, i))
+            return i;
+    }
+    return -1;
+}
+
+/**
+ * @brief LogCaseMatcher::indexIn 从from开始第一次出现关键字的位置
+ * @return 位置,没有时为-1;关键字为空时返回from
+ */
+int LogCaseMatcher::indexIn(const QString &text, int from) const
+{
+    if (m_pattern.isEmpty())
+        return m_fallback.indexIn(text, from);
+    if (!isVectorized())
+        return m_fallback.indexIn(text, from);
+    if (from < 0)
+        from = 0;
+    //最后一个可能的开始位置之后
+    const int end = text.length() - m_pattern.length() + 1;
+    if (from >= end)
+        return -1;
+
+    int i = from;
+#if defined(__SSE2__) || defined(__ARM_NEON)
+    const ushort *data = text.utf16();
+    const int tail = m_pattern.length() - 1;
+#endif
+#if defined(__SSE2__)
+    __m128i first[LOG_CASE_MATCHER_VARIANTS];
+    __m128i last[LOG_CASE_MATCHER_VARIANTS];
+    for (int j = 0; j < LOG_CASE_MATCHER_VARIANTS; ++j) {
+        //个数不足时重复第一个形式,结果不变
+        first[j] = _mm_set1_epi16(static_cast<short>(j < m_firstCount ? m_first[j] : m_first[0]));
+        last[j] = _mm_set1_epi16(static_cast<short>(j < m_lastCount ? m_last[j] : m_last[0]));
+    }
+    for (; i + LOG_CASE_MATCHER_LANES <= end; i += LOG_CASE_MATCHER_LANES) {
+        const __m128i head = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+        const __m128i back = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i + tail));
+        __m128i eqFirst = _mm_cmpeq_epi16(head, first[0]);
+        __m128i eqLast = _mm_cmpeq_epi16(back, last[0]);
+        for (int j = 1; j < LOG_CASE_MATCHER_VARIANTS; ++j) {
+            eqFirst = _mm_or_si128(eqFirst, _mm_cmpeq_epi16(head, first[j]));
+            eqLast = _mm_or_si128(eqLast, _mm_cmpeq_epi16(back, last[j]));
+        }
+        //每个字符占掩码中的两位
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_and_si128(eqFirst, eqLast)));
+        while (mask) {
+            const int lane = __builtin_ctz(mask) / 2;
+            if (verify(text, i + lane))
+                return i + lane;
+            mask &= ~(3u << (lane * 2));
+        }
+    }
+#elif defined(__ARM_NEON)
+    uint16x8_t first[LOG_CASE_MATCHER_VARIANTS];
+    uint16x8_t last[LOG_CASE_MATCHER_VARIANTS];
+    for (int j = 0; j < LOG_CASE_MATCHER_VARIANTS; ++j) {
+        first[j] = vdupq_n_u16(j < m_firstCount ? m_first[j] : m_first[0]);
+        last[j] = vdupq_n_u16(j < m_lastCount ? m_last[j] : m_last[0]);
+    }
+    for (; i + LOG_CASE_MATCHER_LANES <= end; i += LOG_CASE_MATCHER_LANES) {
+        const uint16x8_t head = vld1q_u16(data + i);
+        const uint16x8_t back = vld1q_u16(data + i + tail);
+        uint16x8_t eqFirst = vceqq_u16(head, first[0]);
+        uint16x8_t eqLast = vceqq_u16(back, last[0]);
+        for (int j = 1; j < LOG_CASE_MATCHER_VARIANTS; ++j) {
+            eqFirst = vorrq_u16(eqFirst, vceqq_u16(head, first[j]));
+            eqLast = vorrq_u16(eqLast, vceqq_u16(back, last[j]));
+        }
+        //每个字符压缩为掩码中的一个字节
+        const uint8x8_t narrowed = vshrn_n_u16(vandq_u16(eqFirst, eqLast), 4);
+        quint64 mask = vget_lane_u64(vreinterpret_u64_u8(narrowed), 0);
+        while (mask) {
+            const int lane = __builtin_ctzll(mask) / 8;
+            if (verify(text, i + lane))
+                return i + lane;
+            mask &= ~(static_cast<quint64>(0xff) << (lane * 8));
+        }
+    }
+#endif
+    return scalarIndexIn(text, i, end);
+}
@@ -0,0 +1,44 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGCASEMATCHER_H
+#define LOGCASEMATCHER_H
+
+#include <QString>
+#include <QStringMatcher>
+
+//首尾字符最多的大小写形式个数,如k、K和开尔文符号
+#define LOG_CASE_MATCHER_VARIANTS 3
+
+/**
+ * @brief The LogCaseMatcher class 不区分大小写的子串查找,结果和QStringMatcher(Qt::CaseInsensitive)一致
+ * 关键字只在构造时处理一次:记下首尾两个字符所有可能的大小写形式,查找时用SSE2/NEON一次比较8个UTF-16字符,
+ * 首尾都对上的位置才逐字符比较;首尾字符不是ASCII时大小写形式不好穷举,退回QStringMatcher
+ */
+class LogCaseMatcher
+{
+public:
+    explicit LogCaseMatcher(const QString &pattern = QString());
+
+    bool isEmpty() const { return m_pattern.isEmpty(); }
+    int length() const { return m_pattern.length(); }
+    QString pattern() const { return m_pattern; }
+    bool isVectorized() const { return m_firstCount > 0 && m_lastCount > 0; }
+    int indexIn(const QString &text, int from = 0) const;
+
+private:
+    static int variants(ushort ch, ushort *out);
+    bool verify(const QString &text, int pos) const;
+    int scalarIndexIn(const QString &text, int from, int end) const;
+
+    QString m_pattern;
+    QStringMatcher m_fallback;
+    ushort m_first[LOG_CASE_MATCHER_VARIANTS] = {0, 0, 0};
+    ushort m_last[LOG_CASE_MATCHER_VARIANTS] = {0, 0, 0};
+    //首、尾字符的大小写形式个数,为0时不能向量过滤
+    int m_firstCount = 0;
+    int m_lastCount = 0;
+};
+
+#endif // LOGCASEMATCHER_H
@@ -0,0 +1,449 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logcategorycache.h"
+
+namespace {
+//每个QString除字符外的额外开销,近似为数据头和指针
+const qint64 STRING_OVERHEAD = 24;
+
+qint64 textCost(const QString &text)
+{
+    return STRING_OVERHEAD + text.size() * static_cast<qint64>(sizeof(QChar));
+}
+}
+
+/**
+ * @brief LogCacheValidity::sameFiles 来源文件的路径、是否存在、大小、修改时间和inode都一致
+ */
+bool LogCacheValidity::sameFiles(const LogCacheValidity &other) const
+{
+    if (files.size() != other.files.size())
+        return false;
+    for (int i = 0; i < files.size(); ++i) {
+        const LogFileStat &a = files.at(i);
+        const LogFileStat &b = other.files.at(i);
+        if (a.path != b.path || a.exists != b.exists || a.size != b.size || a.mtime != b.mtime || a.inode != b.inode)
+            return false;
+    }
+    return true;
+}
+
+/**
+ * @brief LogCacheRange::covers 本范围的结果是否包含other范围的全部结果
+ */
+bool LogCacheRange::covers(const LogCacheRange &other) const
+{
+    if (!match.isEmpty() && match != other.match)
+        return false;
+    if (begin <= 0 || end <= 0)
+        return true;
+    return other.begin > 0 && other.end > 0 && other.begin >= begin && other.end <= end;
+}
+
+/**
+ * @brief logRecordCost 一条记录占用内存的估计值,用于缓存的内存上限,共享的字符串会被重复计算
+ */
+qint64 logRecordCost(const LOG_MSG_JOURNAL &record)
+{
+    return static_cast<qint64>(sizeof(record)) + textCost(record.dateTime) + textCost(record.hostName) + textCost(record.daemonName)
+           + textCost(record.daemonId) + textCost(record.msg) + record.cursor.size();
+}
+
+qint64 logRecordCost(const LOG_MSG_DPKG &record)
+{
+    return static_cast<qint64>(sizeof(record)) + textCost(record.dateTime) + textCost(record.action) + textCost(record.msg);
+}
+
+qint64 logRecordCost(const LOG_MSG_XORG &record)
+{
+    return static_cast<qint64>(sizeof(record)) + textCost(record.offset) + textCost(record.msg);
+}
+
+qint64 logRecordCost(const LOG_MSG_BOOT &record)
+{
+    return static_cast<qint64>(sizeof(record)) + textCost(record.status) + textCost(record.msg);
+}
+
+qint64 logRecordCost(const LOG_MSG_AUDIT &record)
+{
+    return static_cast<qint64>(sizeof(record)) + textCost(record.auditType) + textCost(record.eventType) + textCost(record.dateTime)
+           + textCost(record.processName) + textCost(record.processId) + textCost(record.status) + textCost(record.origin);
+}
+
+qint64 logRecordCost(const LOG_MSG_DNF &record)
+{
+    return static_cast<qint64>(sizeof(record)) + textCost(record.dateTime) + textCost(record.msg);
+}
+
+void logRecordWrite(QDataStream &out, const LOG_MSG_JOURNAL &record)
+{
+    out << record.dateTime << record.hostName << record.daemonName << record.daemonId << static_cast<qint32>(record.level)
+        << record.msg << record.timestamp << record.cursor;
+}
+
+void logRecordWrite(QDataStream &out, const LOG_MSG_DPKG &record)
+{
+    out << record.dateTime << record.action << record.msg << record.timestamp;
+}
+
+void logRecordWrite(QDataStream &out, const LOG_MSG_XORG &record)
+{
+    out << record.offset << record.msg << record.offsetUsec;
+}
+
+void logRecordWrite(QDataStream &out, const LOG_MSG_BOOT &record)
+{
+    out << record.status << record.msg << static_cast<qint32>(record.statusCode);
+}
+
+void logRecordWrite(QDataStream &out, const LOG_MSG_AUDIT &record)
+{
+    out << record.auditType << record.eventType << record.dateTime << record.processName << record.processId << record.status
+        << record.origin << record.auditTypeBit;
+}
+
+void logRecordWrite(QDataStream &out, const LOG_MSG_DNF &record)
+{
+    out << record.dateTime << static_cast<qint32>(record.level) << record.msg;
+}
+
+void logRecordRead(QDataStream &in, LOG_MSG_JOURNAL &record)
+{
+    qint32 level = -1;
+    in >> record.dateTime >> record.hostName >> record.daemonName >> record.daemonId >> level >> record.msg >> record.timestamp
+       >> record.cursor;
+    record.level = level;
+}
+
+void logRecordRead(QDataStream &in, LOG_MSG_DPKG &record)
+{
+    in >> record.dateTime >> record.action >> record.msg >> record.timestamp;
+}
+
+void logRecordRead(QDataStream &in, LOG_MSG_XORG &record)
+{
+    in >> record.offset >> record.msg >> record.offsetUsec;
+}
+
+void logRecordRead(QDataStream &in, LOG_MSG_BOOT &record)
+{
+    qint32 statusCode = BootStatusNone;
+    in >> record.status >> record.msg >> statusCode;
+    record.statusCode = statusCode;
+}
+
+void logRecordRead(QDataStream &in, LOG_MSG_AUDIT &record)
+{
+    in >> record.auditType >> record.eventType >> record.dateTime >> record.processName >> record.processId >> record.status
+       >> record.origin >> record.auditTypeBit;
+}
+
+void logRecordRead(QDataStream &in, LOG_MSG_DNF &record)
+{
+    qint32 level = DNFINVALID;
+    in >> record.dateTime >> level >> record.msg;
+    record.level = level;
+}
+
+LogCategoryCache::LogCategoryCache(qint64 budget)
+    : m_budget(budget)
+{
+}
+
+/**
+ * @brief LogCategoryCache::setBudget 设置内存上限,超出的部分立即淘汰
+ * @param budget 字节数,0表示不缓存
+ */
+void LogCategoryCache::setBudget(qint64 budget)
+{
+    m_budget = qMax<qint64>(0, budget);
+    evict();
+}
+
+/**
+ * @brief LogCategoryCache::begin 开始收集一次加载的结果,同一标号之前未结束的收集被丢弃
+ * @param key 类别和筛选条件
+ * @param index 加载线程的标号,只收集该标号的数据
+ * @param validity 加载开始前来源文件的元数据
+ * @param category 类别,不为空时之后范围更小的筛选可以从本次结果中筛出
+ * @param range 本次加载的筛选范围
+ */
+void LogCategoryCache::begin(const QString &key, int index, const LogCacheValidity &validity,
+                             const QString &category, const LogCacheRange &range)
+{
+    abort(index);
+    if (m_budget <= 0)
+        return;
+    Entry pending;
+    pending.key = key;
+    pending.validity = validity;
+    pending.category = category;
+    pending.range = range;
+    m_pending.insert(index, pending);
+}
+
+/**
+ * @brief LogCategoryCache::setCursor 记录系统日志最新条目的游标
+ */
+void LogCategoryCache::setCursor(int index, const QString &cursor)
+{
+    auto it = m_pending.find(index);
+    if (it != m_pending.end())
+        it->validity.cursor = cursor;
+}
+
+/**
+ * @brief LogCategoryCache::finish 加载正常结束,存入缓存并按上限淘汰最久未使用的类别
+ * 没有数据的结果不缓存,例如鉴权失败时下次仍需重新读取
+ */
+void LogCategoryCache::finish(int index)
+{
+    auto it = m_pending.find(index);
+    if (it == m_pending.end())
+        return;
+    Entry pending = it.value();
+    m_pending.erase(it);
+    if (pending.count > 0) {
+        remove(pending.key);
+        pending.tick = ++m_tick;
+        pending.rawCost = pending.cost;
+        m_cost += pending.cost;
+        m_entries.insert(pending.key, pending);
+        evict();
+    }
+}
+
+/**
+ * @brief LogCategoryCache::abort 丢弃所有正在收集的结果
+ */
+void LogCategoryCache::abort()
+{
+    m_pending.clear();
+}
+
+/**
+ * @brief LogCategoryCache::abort 丢弃index正在收集的结果
+ */
+void LogCategoryCache::abort(int index)
+{
+    m_pending.remove(index);
+}
+
+/**
+ * @brief LogCategoryCache::contains 是否有key的有效缓存,不标记为最近使用
+ */
+bool LogCategoryCache::contains(const QString &key, const LogCacheValidity &current) const
+{
+    auto it = m_entries.constFind(key);
+    return it != m_entries.constEnd() && it->validity.sameFiles(current);
+}
+
+void LogCategoryCache::remove(const QString &key)
+{
+    auto it = m_entries.find(key);
+    if (it == m_entries.end())
+        return;
+    m_cost -= it->cost;
+    m_entries.erase(it);
+}
+
+/**
+ * @brief LogCategoryCache::removeFiles 丢弃来源文件包含其中任一文件的缓存,例如这些日志被清空之后
+ * @param paths 文件路径
+ * @return 丢弃的缓存数
+ */
+int LogCategoryCache::removeFiles(const QStringList &paths)
+{
+    int removed = 0;
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        bool affected = false;
+        for (const LogFileStat &file : it->validity.files) {
+            if (paths.contains(file.path)) {
+                affected = true;
+                break;
+            }
+        }
+        if (affected) {
+            m_cost -= it->cost;
+            it = m_entries.erase(it);
+            ++removed;
+        } else {
+            ++it;
+        }
+    }
+    return removed;
+}
+
+void LogCategoryCache::clear()
+{
+    m_entries.clear();
+    m_cost = 0;
+    abort();
+}
+
+/**
+ * @brief LogCategoryCache::snapshotEntries 导出所有类别用于写入快照,未压缩的类别压缩一份副本,缓存本身不变
+ */
+QList<LogCategoryCache::SnapshotEntry> LogCategoryCache::snapshotEntries() const
+{
+    QList<SnapshotEntry> entries;
+    for (const Entry &entry : m_entries) {
+        const QByteArray type = recordTypeName(entry.type);
+        if (type.isEmpty() || (entry.chunks.isEmpty() && (!entry.batches || !entry.compress)))
+            continue;
+        SnapshotEntry item;
+        item.key = entry.key;
+        item.category = entry.category;
+        item.range = entry.range;
+        item.cursor = entry.validity.cursor;
+        item.type = type;
+        item.count = entry.count;
+        item.rawCost = entry.rawCost;
+        item.chunks = entry.chunks.isEmpty() ? entry.compress(entry.batches.get()) : entry.chunks;
+        entries.append(item);
+    }
+    return entries;
+}
+
+/**
+ * @brief LogCategoryCache::importSnapshot 用快照中的类别替换缓存内容,导入的类别保持压缩,第一次取出时解压
+ * 快照不记录来源文件,导入的类别只和空的文件列表匹配,见LogFileParser::openSnapshot
+ * @return 导入的类别数,记录类型不认识的类别被跳过
+ */
+int LogCategoryCache::importSnapshot(const QList<SnapshotEntry> &entries)
+{
+    clear();
+    for (const SnapshotEntry &item : entries) {
+        Entry entry;
+        if (item.chunks.isEmpty() || !recordType(item.type, &entry.type, &entry.compress))
+            continue;
+        entry.key = item.key;
+        entry.category = item.category;
+        entry.range = item.range;
+        entry.validity.cursor = item.cursor;
+        entry.count = item.count;
+        entry.rawCost = item.rawCost;
+        entry.chunks = item.chunks;
+        for (const QByteArray &chunk : entry.chunks)
+            entry.cost += STRING_OVERHEAD + chunk.size();
+        entry.tick = ++m_tick;
+        remove(entry.key);
+        m_cost += entry.cost;
+        m_entries.insert(entry.key, entry);
+    }
+    const int imported = m_entries.size();
+    evict();
+    return imported;
+}
+
+/**
+ * @brief LogCategoryCache::recordTypeName 缓存的记录类型在快照中的名字,不支持的类型为空
+ */
+QByteArray LogCategoryCache::recordTypeName(std::type_index type)
+{
+    if (type == std::type_index(typeid(LOG_MSG_JOURNAL)))
+        return "journal";
+    if (type == std::type_index(typeid(LOG_MSG_DPKG)))
+        return "dpkg";
+    if (type == std::type_index(typeid(LOG_MSG_XORG)))
+        return "xorg";
+    if (type == std::type_index(typeid(LOG_MSG_BOOT)))
+        return "boot";
+    if (type == std::type_index(typeid(LOG_MSG_AUDIT)))
+        return "audit";
+    if (type == std::type_index(typeid(LOG_MSG_DNF)))
+        return "dnf";
+    return QByteArray();
+}
+
+/**
+ * @brief LogCategoryCache::recordType 快照中的记录类型名对应的类型和压缩函数
+ * @return 是否认识该类型
+ */
+bool LogCategoryCache::recordType(const QByteArray &name, std::type_index *type, Compress *compress)
+{
+    if (name == "journal") {
+        *type = std::type_index(typeid(LOG_MSG_JOURNAL));
+        *compress = &LogCategoryCache::compressBatches<LOG_MSG_JOURNAL>;
+    } else if (name == "dpkg") {
+        *type = std::type_index(typeid(LOG_MSG_DPKG));
+        *compress = &LogCategoryCache::compressBatches<LOG_MSG_DPKG>;
+    } else if (name == "xorg") {
+        *type = std::type_index(typeid(LOG_MSG_XORG));
+        *compress = &LogCategoryCache::compressBatches<LOG_MSG_XORG>;
+    } else if (name == "boot") {
+        *type = std::type_index(typeid(LOG_MSG_BOOT));
+        *compress = &LogCategoryCache::compressBatches<LOG_MSG_BOOT>;
+    } else if (name == "audit") {
+        *type = std::type_index(typeid(LOG_MSG_AUDIT));
+        *compress = &LogCategoryCache::compressBatches<LOG_MSG_AUDIT>;
+    } else if (name == "dnf") {
+        *type = std::type_index(typeid(LOG_MSG_DNF));
+        *compress = &LogCategoryCache::compressBatches<LOG_MSG_DNF>;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief LogCategoryCache::compressedCount 已压缩的类别数
+ */
+int LogCategoryCache::compressedCount() const
+{
+    int count = 0;
+    for (const Entry &entry : m_entries)
+        count += entry.chunks.isEmpty() ? 0 : 1;
+    return count;
+}
+
+/**
+ * @brief LogCategoryCache::evict 超出上限时先依次压缩最久未使用的类别,最近使用的一个保持原样;
+ * 都已压缩仍超出时再依次淘汰最久未使用的类别
+ */
+void LogCategoryCache::evict()
+{
+    while (m_cost > m_budget && !m_entries.isEmpty()) {
+        auto newest = m_entries.begin();
+        for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+            if (it->tick > newest->tick)
+                newest = it;
+        }
+        auto coldest = m_entries.end();
+        for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+            if (it == newest || !it->chunks.isEmpty() || !it->compress)
+                continue;
+            if (coldest == m_entries.end() || it->tick < coldest->tick)
+                coldest = it;
+        }
+        if (coldest != m_entries.end()) {
+            compressEntry(coldest.value());
+            continue;
+        }
+
+        auto oldest = m_entries.begin();
+        for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+            if (it->tick < oldest->tick)
+                oldest = it;
+        }
+        m_cost -= oldest->cost;
+        m_entries.erase(oldest);
+    }
+}
+
+/**
+ * @brief LogCategoryCache::compressEntry 压缩一个类别的各批数据,占用改为压缩后的字节数
+ * 记录仍被界面引用时不会因此释放,但切换到其他类别后只剩压缩的数据
+ */
+void LogCategoryCache::compressEntry(Entry &entry)
+{
+    entry.chunks = entry.compress(entry.batches.get());
+    entry.batches.reset();
+    qint64 cost = 0;
+    for (const QByteArray &chunk : entry.chunks)
+        cost += STRING_OVERHEAD + chunk.size();
+    m_cost += cost - entry.cost;
+    entry.cost = cost;
+}
@@ -0,0 +1,298 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGCATEGORYCACHE_H
+#define LOGCATEGORYCACHE_H
+
+#include "logfilestat.h"
+#include "structdef.h"
+
+#include <QByteArray>
+#include <QDataStream>
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QtConcurrent/QtConcurrentMap>
+
+#include <functional>
+#include <memory>
+#include <typeindex>
+
+//缓存占用内存的默认上限,MB
+#define LOG_CATEGORY_CACHE_DEFAULT_MB 256
+//压缩不常用类别时zlib的压缩级别,速度优先
+#define LOG_CATEGORY_CACHE_COMPRESS_LEVEL 1
+
+/**
+ * @brief The LogCacheValidity struct 缓存的有效性依据
+ * 文件类日志为各来源文件的元数据,元数据都不变时缓存有效;系统日志没有文件,记录最新条目的游标供增量读取
+ */
+struct LogCacheValidity {
+    QList<LogFileStat> files;
+    QString cursor;
+
+    bool sameFiles(const LogCacheValidity &other) const;
+};
+
+/**
+ * @brief The LogCacheRange struct 一次加载的筛选范围,用于判断新的筛选条件能否从已缓存的结果中筛出
+ * begin、end有一个不大于0表示不限时间,单位由类别决定;match为空表示不限等级
+ */
+struct LogCacheRange {
+    qint64 begin = -1;
+    qint64 end = -1;
+    QString match;
+
+    bool covers(const LogCacheRange &other) const;
+};
+
+qint64 logRecordCost(const LOG_MSG_JOURNAL &record);
+qint64 logRecordCost(const LOG_MSG_DPKG &record);
+qint64 logRecordCost(const LOG_MSG_XORG &record);
+qint64 logRecordCost(const LOG_MSG_BOOT &record);
+qint64 logRecordCost(const LOG_MSG_AUDIT &record);
+qint64 logRecordCost(const LOG_MSG_DNF &record);
+
+void logRecordWrite(QDataStream &out, const LOG_MSG_JOURNAL &record);
+void logRecordWrite(QDataStream &out, const LOG_MSG_DPKG &record);
+void logRecordWrite(QDataStream &out, const LOG_MSG_XORG &record);
+void logRecordWrite(QDataStream &out, const LOG_MSG_BOOT &record);
+void logRecordWrite(QDataStream &out, const LOG_MSG_AUDIT &record);
+void logRecordWrite(QDataStream &out, const LOG_MSG_DNF &record);
+void logRecordRead(QDataStream &in, LOG_MSG_JOURNAL &record);
+void logRecordRead(QDataStream &in, LOG_MSG_DPKG &record);
+void logRecordRead(QDataStream &in, LOG_MSG_XORG &record);
+void logRecordRead(QDataStream &in, LOG_MSG_BOOT &record);
+void logRecordRead(QDataStream &in, LOG_MSG_AUDIT &record);
+void logRecordRead(QDataStream &in, LOG_MSG_DNF &record);
+
+/**
+ * @brief The LogCategoryCache class 最近查看过的日志类别的解析结果,按内存上限LRU淘汰
+ * 一次加载开始时begin,加载线程发出的每一批数据collect,正常结束时finish存入缓存,中途停止时abort丢弃,
+ * 按加载标号区分,后台预取和界面加载可以同时收集;
+ * 再次加载同一类别和筛选条件时find取出各批数据,和加载线程共享,不复制记录;不是线程安全的,只在GUI线程使用。
+ * 超出上限时先把最久未使用的类别按批压缩(最近使用的一个除外),仍然超出才淘汰,同样的上限下可以保留更多类别;
+ * 取出压缩的类别时各批在线程池中并行解压,之后恢复为未压缩的状态
+ */
+class LogCategoryCache
+{
+public:
+    /**
+     * @brief The SnapshotEntry struct 写入快照文件的一个类别,数据为各批压缩后的记录,不含来源文件的元数据
+     */
+    struct SnapshotEntry {
+        QString key;
+        QString category;
+        LogCacheRange range;
+        QString cursor;
+        //记录类型名,见recordTypeName
+        QByteArray type;
+        int count = 0;
+        qint64 rawCost = 0;
+        QVector<QByteArray> chunks;
+    };
+
+    explicit LogCategoryCache(qint64 budget = static_cast<qint64>(LOG_CATEGORY_CACHE_DEFAULT_MB) * 1024 * 1024);
+
+    void setBudget(qint64 budget);
+    qint64 budget() const { return m_budget; }
+    qint64 cost() const { return m_cost; }
+    int size() const { return m_entries.size(); }
+    int compressedCount() const;
+
+    void begin(const QString &key, int index, const LogCacheValidity &validity,
+               const QString &category = QString(), const LogCacheRange &range = LogCacheRange());
+    template <typename T>
+    void collect(int index, const QList<T> &batch);
+    void setCursor(int index, const QString &cursor);
+    void finish(int index);
+    void abort();
+    void abort(int index);
+
+    template <typename T>
+    bool find(const QString &key, const LogCacheValidity &current, QVector<QList<T>> *batches, QString *cursor = nullptr);
+    bool contains(const QString &key, const LogCacheValidity &current) const;
+    template <typename T>
+    bool findCovering(const QString &category, const LogCacheRange &range, const LogCacheValidity &current,
+                      QVector<QList<T>> *batches, QString *cursor = nullptr);
+    void remove(const QString &key);
+    int removeFiles(const QStringList &paths);
+    void clear();
+
+    QList<SnapshotEntry> snapshotEntries() const;
+    int importSnapshot(const QList<SnapshotEntry> &entries);
+
+private:
+    typedef QVector<QByteArray> (*Compress)(const void *batches);
+    struct Entry {
+        QString key;
+        std::shared_ptr<void> batches;
+        std::type_index type = std::type_index(typeid(void));
+        qint64 cost = 0;
+        int count = 0;
+        LogCacheValidity validity;
+        quint64 tick = 0;
+        QString category;
+        LogCacheRange range;
+        //压缩后的各批数据,不为空时batches为空,取出时解压
+        QVector<QByteArray> chunks;
+        //未压缩时的占用,解压后恢复为该值
+        qint64 rawCost = 0;
+        //把batches按批压缩的函数,由collect按记录类型设置
+        Compress compress = nullptr;
+    };
+    static QByteArray recordTypeName(std::type_index type);
+    static bool recordType(const QByteArray &name, std::type_index *type, Compress *compress);
+
+    void evict();
+    void compressEntry(Entry &entry);
+    template <typename T>
+    static QVector<QByteArray> compressBatches(const void *batches);
+    template <typename T>
+    void restore(Entry &entry);
+
+    QHash<QString, Entry> m_entries;
+    /**
+     * @brief m_pending 正在加载、尚未结束的结果,键为加载标号
+     */
+    QHash<int, Entry> m_pending;
+    qint64 m_budget;
+    qint64 m_cost = 0;
+    quint64 m_tick = 0;
+};
+
+template <typename T>
+void LogCategoryCache::collect(int index, const QList<T> &batch)
+{
+    auto it = m_pending.find(index);
+    if (it == m_pending.end() || batch.isEmpty())
+        return;
+    Entry &pending = it.value();
+    if (!pending.batches) {
+        pending.batches = std::make_shared<QVector<QList<T>>>();
+        pending.type = std::type_index(typeid(T));
+        pending.compress = &LogCategoryCache::compressBatches<T>;
+    } else if (pending.type != std::type_index(typeid(T))) {
+        return;
+    }
+    static_cast<QVector<QList<T>> *>(pending.batches.get())->append(batch);
+    pending.count += batch.size();
+    for (const T &record : batch)
+        pending.cost += logRecordCost(record);
+    //单次结果已超过上限时不再收集
+    if (pending.cost > m_budget)
+        m_pending.erase(it);
+}
+
+/**
+ * @brief LogCategoryCache::find 取出有效的缓存,同时标记为最近使用
+ * @param key 类别和筛选条件
+ * @param current 来源文件当前的元数据,和缓存时不一致则丢弃缓存
+ * @param batches 输出参数,按加载顺序的各批数据
+ * @param cursor 输出参数,缓存时最新条目的游标
+ * @return 是否命中
+ */
+template <typename T>
+bool LogCategoryCache::find(const QString &key, const LogCacheValidity &current, QVector<QList<T>> *batches, QString *cursor)
+{
+    auto it = m_entries.find(key);
+    if (it == m_entries.end())
+        return false;
+    if (it->type != std::type_index(typeid(T)) || !it->validity.sameFiles(current)) {
+        remove(key);
+        return false;
+    }
+    it->tick = ++m_tick;
+    restore<T>(it.value());
+    *batches = *static_cast<const QVector<QList<T>> *>(it->batches.get());
+    if (cursor)
+        *cursor = it->validity.cursor;
+    //解压后占用变大,按上限压缩其他类别
+    evict();
+    return true;
+}
+
+/**
+ * @brief LogCategoryCache::findCovering 查找同一类别中筛选范围包含range的有效缓存,有多个时取记录最少的,同时标记为最近使用
+ * 调用者需要再按range筛选取出的数据
+ * @param category 类别,为空时不查找
+ * @param range 新的筛选范围
+ * @param current 来源文件当前的元数据
+ * @param batches 输出参数,按加载顺序的各批数据
+ * @param cursor 输出参数,缓存时最新条目的游标
+ * @return 是否命中
+ */
+template <typename T>
+bool LogCategoryCache::findCovering(const QString &category, const LogCacheRange &range, const LogCacheValidity &current,
+                                    QVector<QList<T>> *batches, QString *cursor)
+{
+    if (category.isEmpty())
+        return false;
+    auto best = m_entries.end();
+    for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+        if (it->category != category || it->type != std::type_index(typeid(T)) || !it->range.covers(range)
+                || !it->validity.sameFiles(current))
+            continue;
+        if (best == m_entries.end() || it->count < best->count)
+            best = it;
+    }
+    if (best == m_entries.end())
+        return false;
+    best->tick = ++m_tick;
+    restore<T>(best.value());
+    *batches = *static_cast<const QVector<QList<T>> *>(best->batches.get());
+    if (cursor)
+        *cursor = best->validity.cursor;
+    evict();
+    return true;
+}
+
+/**
+ * @brief LogCategoryCache::compressBatches 各批记录分别序列化并压缩,在线程池中并行进行
+ */
+template <typename T>
+QVector<QByteArray> LogCategoryCache::compressBatches(const void *batches)
+{
+    const std::function<QByteArray(const QList<T> &)> pack = [](const QList<T> &batch) {
+        QByteArray data;
+        QDataStream out(&data, QIODevice::WriteOnly);
+        out << static_cast<qint32>(batch.size());
+        for (const T &record : batch)
+            logRecordWrite(out, record);
+        return qCompress(data, LOG_CATEGORY_CACHE_COMPRESS_LEVEL);
+    };
+    return QtConcurrent::blockingMapped<QVector<QByteArray>>(*static_cast<const QVector<QList<T>> *>(batches), pack);
+}
+
+/**
+ * @brief LogCategoryCache::restore 压缩的缓存并行解压为各批记录,占用恢复为压缩前的值
+ */
+template <typename T>
+void LogCategoryCache::restore(Entry &entry)
+{
+    if (entry.chunks.isEmpty())
+        return;
+    const std::function<QList<T>(const QByteArray &)> unpack = [](const QByteArray &chunk) {
+        const QByteArray data = qUncompress(chunk);
+        QDataStream in(data);
+        qint32 count = 0;
+        in >> count;
+        QList<T> batch;
+        batch.reserve(count);
+        for (qint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+            T record;
+            logRecordRead(in, record);
+            batch.append(record);
+        }
+        return batch;
+    };
+    entry.batches = std::make_shared<QVector<QList<T>>>(QtConcurrent::blockingMapped<QVector<QList<T>>>(entry.chunks, unpack));
+    entry.chunks.clear();
+    m_cost += entry.rawCost - entry.cost;
+    entry.cost = entry.rawCost;
+}
+
+#endif // LOGCATEGORYCACHE_H
@@ -0,0 +1,275 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logcategoryprobe.h"
+#include "structdef.h"
+#include "utils.h"
+#include "dbusmanager.h"
+#include "logfilestat.h"
+#include "dbusproxy/dldbushandler.h"
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QLoggingCategory>
+#include <QSettings>
+#include <QtConcurrent>
+
+#ifdef QT_DEBUG
+Q_LOGGING_CATEGORY(logCategoryProbe, "org.deepin.log.viewer.category.probe")
+#else
+Q_LOGGING_CATEGORY(logCategoryProbe, "org.deepin.log.viewer.category.probe", QtInfoMsg)
+#endif
+
+const QString LOG_CATEGORY_PROBE_FILE = "category-probe.conf";
+
+LogCategoryState LogCategoryProbeResult::state(const QString &type) const
+{
+    for (const LogCategoryState &state : states) {
+        if (state.type == type)
+            return state;
+    }
+    LogCategoryState state;
+    state.type = type;
+    return state;
+}
+
+LogCategoryProbe::LogCategoryProbe(QObject *parent)
+    : QObject(parent)
+{
+    qRegisterMetaType<LogCategoryState>("LogCategoryState");
+    connect(&m_watcher, &QFutureWatcher<LogCategoryState>::resultReadyAt, this, &LogCategoryProbe::onResultReady);
+    connect(&m_watcher, &QFutureWatcher<LogCategoryState>::finished, this, &LogCategoryProbe::onProbeFinished);
+}
+
+LogCategoryProbe *LogCategoryProbe::instance()
+{
+    static LogCategoryProbe *probe = new LogCategoryProbe(qApp);
+    return probe;
+}
+
+/**
+ * @brief LogCategoryProbe::probedTypes 需要探测的类别,其余类别总是显示或由其他模块决定
+ */
+QStringList LogCategoryProbe::probedTypes()
+{
+    return QStringList() << JOUR_TREE_DATA << KERN_TREE_DATA << BOOT_KLU_TREE_DATA << DPKG_TREE_DATA
+                         << LAST_TREE_DATA << AUDIT_TREE_DATA;
+}
+
+/**
+ * @brief LogCategoryProbe::probeCategory 探测一个类别,不访问成员,在线程池中执行
+ * 审计日志需要root权限访问,经服务判断;机器类型可能要执行dmidecode,也放在这里避免阻塞界面
+ */
+LogCategoryState LogCategoryProbe::probeCategory(const QString &type)
+{
+    LogCategoryState state;
+    state.type = type;
+    if (type == JOUR_TREE_DATA) {
+        state.available = QFileInfo::exists("/var/log/journal");
+        if (state.available)
+            state.size = approximateSize("/var/log/journal");
+    } else if (type == KERN_TREE_DATA) {
+        //没有kern.log时可以从journal读取内核日志,此时大小未知
+        if (QFileInfo::exists(KERN_TREE_DATA)) {
+            state.available = true;
+            state.size = approximateSize(KERN_TREE_DATA);
+        } else {
+            state.available = Utils::kernLogSource != "file" && QFileInfo::exists("/var/log/journal");
+        }
+    } else if (type == BOOT_KLU_TREE_DATA) {
+        state.available = DBusManager::isSpecialComType();
+    } else if (type == DPKG_TREE_DATA) {
+        state.available = QFileInfo::exists(DPKG_TREE_DATA);
+        if (state.available)
+            state.size = approximateSize(DPKG_TREE_DATA);
+    } else if (type == LAST_TREE_DATA) {
+        state.available = QFileInfo::exists("/var/log/wtmp");
+        if (state.available)
+            state.size = approximateSize("/var/log/wtmp");
+    } else if (type == AUDIT_TREE_DATA) {
+        const QList<LogFileStat> stats = DLDBusHandler::instance()->statFiles(QStringList() << AUDIT_TREE_DATA);
+        if (!stats.isEmpty() && stats.first().exists) {
+            state.available = true;
+            state.size = stats.first().size;
+        }
+    }
+    return state;
+}
+
+/**
+ * @brief LogCategoryProbe::probeAll 在当前线程同步探测所有类别,各类别仍并行执行
+ */
+LogCategoryProbeResult LogCategoryProbe::probeAll()
+{
+    LogCategoryProbeResult result;
+    result.stamps = currentStamps();
+    result.states = QtConcurrent::blockingMapped<QList<LogCategoryState>>(probedTypes(), &LogCategoryProbe::probeCategory);
+    return result;
+}
+
+/**
+ * @brief LogCategoryProbe::currentStamps 探测结果依赖的目录的修改时间,不存在时为-1
+ * 目录中新建、删除或轮转文件时修改时间改变,文件内容追加不改变,大小只是大致值
+ */
+QMap<QString, qint64> LogCategoryProbe::currentStamps()
+{
+    QMap<QString, qint64> stamps;
+    for (const QString &path : QStringList() << "/var/log" << "/var/log/journal" << "/var/log/audit") {
+        QFileInfo fi(path);
+        stamps.insert(path, fi.exists() ? fi.lastModified().toMSecsSinceEpoch() : -1);
+    }
+    return stamps;
+}
+
+bool LogCategoryProbe::isStampValid(const QMap<QString, qint64> &stamps)
+{
+    if (stamps.isEmpty())
+        return false;
+    for (auto it = stamps.constBegin(); it != stamps.constEnd(); ++it) {
+        QFileInfo fi(it.key());
+        const qint64 stamp = fi.exists() ? fi.lastModified().toMSecsSinceEpoch() : -1;
+        if (stamp != it.value())
+            return false;
+    }
+    return true;
+}
+
+/**
+ * @brief LogCategoryProbe::approximateSize 文件的大小,目录为其中所有文件大小之和,没有权限访问的文件不计入
+ */
+qint64 LogCategoryProbe::approximateSize(const QString &path)
+{
+    QFileInfo fi(path);
+    if (!fi.isDir())
+        return fi.exists() ? fi.size() : 0;
+
+    qint64 size = 0;
+    QDirIterator it(path, QDir::Files | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        it.next();
+        size += it.fileInfo().size();
+    }
+    return size;
+}
+
+QString LogCategoryProbe::cachePath()
+{
+    return QDir(Utils::getConfigPath()).filePath(LOG_CATEGORY_PROBE_FILE);
+}
+
+/**
+ * @brief LogCategoryProbe::cachedResult 读取上次的探测结果,依赖的目录或内核日志来源变化时无效
+ */
+bool LogCategoryProbe::cachedResult(LogCategoryProbeResult *result) const
+{
+    if (!result || !QFile::exists(cachePath()))
+        return false;
+
+    QSettings cache(cachePath(), QSettings::IniFormat);
+    if (cache.value("version").toInt() != LOG_CATEGORY_PROBE_VERSION
+            || cache.value("kernLogSource").toString() != Utils::kernLogSource)
+        return false;
+
+    QMap<QString, qint64> stamps;
+    const QVariantMap stampMap = cache.value("stamps").toMap();
+    for (auto it = stampMap.constBegin(); it != stampMap.constEnd(); ++it)
+        stamps.insert(it.key(), it.value().toLongLong());
+    if (!isStampValid(stamps))
+        return false;
+
+    QList<LogCategoryState> states;
+    for (const QVariant &value : cache.value("states").toList()) {
+        const QVariantMap object = value.toMap();
+        LogCategoryState state;
+        state.type = object.value("type").toString();
+        state.available = object.value("available").toBool();
+        state.size = object.value("size", -1).toLongLong();
+        states.append(state);
+    }
+    if (states.size() != probedTypes().size())
+        return false;
+
+    result->stamps = stamps;
+    result->states = states;
+    return true;
+}
+
+void LogCategoryProbe::saveCache(const LogCategoryProbeResult &result)
+{
+    QDir configDir(Utils::getConfigPath());
+    if (!configDir.exists())
+        configDir.mkpath(Utils::getConfigPath());
+
+    QVariantMap stamps;
+    for (auto it = result.stamps.constBegin(); it != result.stamps.constEnd(); ++it)
+        stamps.insert(it.key(), it.value());
+    QVariantList states;
+    for (const LogCategoryState &state : result.states) {
+        QVariantMap object;
+        object.insert("type", state.type);
+        object.insert("available", state.available);
+        object.insert("size", state.size);
+        states.append(object);
+    }
+
+    QSettings cache(cachePath(), QSettings::IniFormat);
+    cache.clear();
+    cache.setValue("version", LOG_CATEGORY_PROBE_VERSION);
+    cache.setValue("kernLogSource", Utils::kernLogSource);
+    cache.setValue("stamps", stamps);
+    cache.setValue("states", states);
+}
+
+/**
+ * @brief LogCategoryProbe::result 同步取得完整结果,缓存有效时直接使用,否则等待探测结束并更新缓存,供命令行使用
+ */
+LogCategoryProbeResult LogCategoryProbe::result()
+{
+    LogCategoryProbeResult result;
+    if (cachedResult(&result))
+        return result;
+    //后台探测正在进行时等待其结果,缓存在finished信号处理时写入
+    if (m_watcher.isRunning()) {
+        m_watcher.waitForFinished();
+        result.stamps = m_startStamps;
+        result.states = m_watcher.future().results();
+        if (result.states.size() == probedTypes().size())
+            return result;
+    }
+
+    result = probeAll();
+    saveCache(result);
+    return result;
+}
+
+/**
+ * @brief LogCategoryProbe::start 在线程池中开始探测,已在探测时不重复开始
+ */
+void LogCategoryProbe::start()
+{
+    if (m_watcher.isRunning())
+        return;
+    m_startStamps = currentStamps();
+    m_watcher.setFuture(QtConcurrent::mapped(probedTypes(), &LogCategoryProbe::probeCategory));
+}
+
+void LogCategoryProbe::onResultReady(int index)
+{
+    emit categoryProbed(m_watcher.resultAt(index));
+}
+
+void LogCategoryProbe::onProbeFinished()
+{
+    if (!m_watcher.isCanceled()) {
+        LogCategoryProbeResult result;
+        result.stamps = m_startStamps;
+        result.states = m_watcher.future().results();
+        saveCache(result);
+        qCDebug(logCategoryProbe) << "category probe finished," << result.states.size() << "categories";
+    }
+    emit probeFinished();
+}
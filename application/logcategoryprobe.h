@@ -0,0 +1,82 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGCATEGORYPROBE_H
+#define LOGCATEGORYPROBE_H
+
+#include <QFutureWatcher>
+#include <QList>
+#include <QMap>
+#include <QMetaType>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+
+//探测结果缓存文件的版本,格式变化时增加
+#define LOG_CATEGORY_PROBE_VERSION 1
+
+/**
+ * @brief The LogCategoryState struct 一个日志类别的探测结果
+ */
+struct LogCategoryState {
+    //类别,和日志类型列表项的ITEM_DATE_ROLE数据一致;BOOT_KLU_TREE_DATA表示机器类型,可用时为特殊机型
+    QString type;
+    bool available = false;
+    //来源文件的大致大小,字节,未知时为-1
+    qint64 size = -1;
+};
+
+Q_DECLARE_METATYPE(LogCategoryState)
+
+/**
+ * @brief The LogCategoryProbeResult struct 一次完整探测的结果和探测时依赖目录的修改时间
+ */
+struct LogCategoryProbeResult {
+    QMap<QString, qint64> stamps;
+    QList<LogCategoryState> states;
+
+    LogCategoryState state(const QString &type) const;
+};
+
+/**
+ * @brief The LogCategoryProbe class 探测依赖文件的日志类别是否可用及其大致大小
+ * 各类别在线程池中并行探测,每得到一个类别的结果就发出categoryProbed,界面可以先显示不需要探测的类别;
+ * 完整结果按/var/log等目录的修改时间缓存,目录都不变时直接使用缓存,不再访问文件和总线。
+ * 信号只在GUI线程发出;probeAll不访问成员,可在任意线程同步调用
+ */
+class LogCategoryProbe : public QObject
+{
+    Q_OBJECT
+public:
+    static LogCategoryProbe *instance();
+
+    static QStringList probedTypes();
+    static LogCategoryState probeCategory(const QString &type);
+    static LogCategoryProbeResult probeAll();
+    static QMap<QString, qint64> currentStamps();
+    static bool isStampValid(const QMap<QString, qint64> &stamps);
+    static qint64 approximateSize(const QString &path);
+
+    bool cachedResult(LogCategoryProbeResult *result) const;
+    LogCategoryProbeResult result();
+    void start();
+    bool isRunning() const { return m_watcher.isRunning(); }
+
+signals:
+    void categoryProbed(const LogCategoryState &state);
+    void probeFinished();
+
+private:
+    explicit LogCategoryProbe(QObject *parent = nullptr);
+    void onResultReady(int index);
+    void onProbeFinished();
+    static QString cachePath();
+    static void saveCache(const LogCategoryProbeResult &result);
+
+    QFutureWatcher<LogCategoryState> m_watcher;
+    //后台探测开始前取得的目录修改时间,探测期间目录变化时缓存在下次启动时失效
+    QMap<QString, qint64> m_startStamps;
+};
+
+#endif // LOGCATEGORYPROBE_H
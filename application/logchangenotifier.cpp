@@ -0,0 +1,143 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logchangenotifier.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QLoggingCategory>
+#include <QSocketNotifier>
+
+#include <errno.h>
+#include <string.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#ifdef QT_DEBUG
+Q_LOGGING_CATEGORY(logChangeNotifier, "org.deepin.log.viewer.file.notifier")
+#else
+Q_LOGGING_CATEGORY(logChangeNotifier, "org.deepin.log.viewer.file.notifier", QtInfoMsg)
+#endif
+
+//一次读取的inotify事件缓冲,足够容纳多条带文件名的事件
+#define LOG_CHANGE_EVENT_BUFFER 4096
+
+LogChangeNotifier::LogChangeNotifier(QObject *parent)
+    : QObject(parent)
+{
+    m_delay.setSingleShot(true);
+    m_delay.setInterval(LOG_CHANGE_NOTIFY_DELAY);
+    connect(&m_delay, &QTimer::timeout, this, [this]() {
+        const QStringList changedPaths = m_pending.values();
+        m_pending.clear();
+        if (!changedPaths.isEmpty())
+            emit changed(changedPaths);
+    });
+}
+
+LogChangeNotifier::~LogChangeNotifier()
+{
+    clearWatches();
+}
+
+/**
+ * @brief LogChangeNotifier::setPaths 设置监视的文件,和当前相同时不做任何事,为空时停止监视
+ * @param paths 当前写入的日志文件路径,如/var/log/kern.log
+ */
+void LogChangeNotifier::setPaths(const QStringList &paths)
+{
+    if (paths == m_paths)
+        return;
+    clearWatches();
+    m_paths = paths;
+    if (paths.isEmpty())
+        return;
+
+    m_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_fd < 0) {
+        qCWarning(logChangeNotifier) << "inotify unavailable:" << strerror(errno);
+        return;
+    }
+    for (const QString &path : paths) {
+        const QFileInfo info(path);
+        const QString dir = info.absolutePath();
+        if (!m_names.contains(dir)) {
+            const int wd = inotify_add_watch(m_fd, QFile::encodeName(dir).constData(),
+                                             IN_MODIFY | IN_CREATE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE | IN_CLOSE_WRITE);
+            if (wd < 0) {
+                //监视数量达到上限等情况,使用者退回到定时刷新
+                qCWarning(logChangeNotifier) << "watch" << dir << "failed:" << strerror(errno);
+                clearWatches();
+                m_paths = paths;
+                return;
+            }
+            m_dirs.insert(wd, dir);
+        }
+        m_names[dir].append(info.fileName());
+    }
+    m_notifier = new QSocketNotifier(m_fd, QSocketNotifier::Read, this);
+    connect(m_notifier, &QSocketNotifier::activated, this, &LogChangeNotifier::readEvents);
+}
+
+/**
+ * @brief LogChangeNotifier::isActive 是否正在监视,inotify不可用时为false
+ */
+bool LogChangeNotifier::isActive() const
+{
+    return m_notifier != nullptr;
+}
+
+/**
+ * @brief LogChangeNotifier::inRotationSet name是否为baseName本身或它的轮转文件(baseName.1、baseName.2.gz等)
+ */
+bool LogChangeNotifier::inRotationSet(const QString &name, const QString &baseName)
+{
+    if (name == baseName)
+        return true;
+    if (!name.startsWith(baseName + '.'))
+        return false;
+    QString suffix = name.mid(baseName.size() + 1);
+    if (suffix.endsWith(".gz"))
+        suffix.chop(3);
+    bool ok = false;
+    suffix.toUInt(&ok);
+    return ok;
+}
+
+void LogChangeNotifier::readEvents()
+{
+    alignas(struct inotify_event) char buffer[LOG_CHANGE_EVENT_BUFFER];
+    ssize_t n = 0;
+    while ((n = read(m_fd, buffer, sizeof(buffer))) > 0) {
+        for (char *p = buffer; p < buffer + n;) {
+            const struct inotify_event *event = reinterpret_cast<const struct inotify_event *>(p);
+            p += sizeof(struct inotify_event) + event->len;
+            if (event->len == 0)
+                continue;
+            const QString dir = m_dirs.value(event->wd);
+            const QString name = QFile::decodeName(event->name);
+            for (const QString &baseName : m_names.value(dir)) {
+                if (inRotationSet(name, baseName))
+                    m_pending.insert(dir + '/' + baseName);
+            }
+        }
+    }
+    if (!m_pending.isEmpty() && !m_delay.isActive())
+        m_delay.start();
+}
+
+void LogChangeNotifier::clearWatches()
+{
+    m_delay.stop();
+    m_pending.clear();
+    delete m_notifier;
+    m_notifier = nullptr;
+    if (m_fd >= 0) {
+        ::close(m_fd);
+        m_fd = -1;
+    }
+    m_dirs.clear();
+    m_names.clear();
+    m_paths.clear();
+}
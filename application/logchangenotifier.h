@@ -0,0 +1,60 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGCHANGENOTIFIER_H
+#define LOGCHANGENOTIFIER_H
+
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QStringList>
+#include <QTimer>
+
+class QSocketNotifier;
+
+//收到文件变化后等待这么久再通知,合并连续写入产生的多个事件,毫秒
+#define LOG_CHANGE_NOTIFY_DELAY 500
+
+/**
+ * @brief The LogChangeNotifier class 在界面线程中用inotify监视一组日志文件及其轮转文件(kern.log、kern.log.1、kern.log.2.gz...)
+ * 监视的是文件所在目录而不是文件本身,root才能读取的文件(目录可读)也能收到事件,轮转新建的同名文件不需要重新监视;
+ * 追加写入、copytruncate截断、改名轮转都会触发changed,由使用者增量或重新读取
+ */
+class LogChangeNotifier : public QObject
+{
+    Q_OBJECT
+public:
+    explicit LogChangeNotifier(QObject *parent = nullptr);
+    ~LogChangeNotifier() override;
+
+    void setPaths(const QStringList &paths);
+    QStringList paths() const { return m_paths; }
+    bool isActive() const;
+
+    static bool inRotationSet(const QString &name, const QString &baseName);
+
+signals:
+    /**
+     * @brief changed 监视的文件有了变化
+     * @param paths 发生变化的文件(轮转文件的变化归到对应的当前文件)
+     */
+    void changed(const QStringList &paths);
+
+private slots:
+    void readEvents();
+
+private:
+    void clearWatches();
+
+    QStringList m_paths;
+    int m_fd = -1;
+    QSocketNotifier *m_notifier = nullptr;
+    //监视描述符对应的目录,以及每个目录中关注的文件名
+    QHash<int, QString> m_dirs;
+    QHash<QString, QStringList> m_names;
+    QSet<QString> m_pending;
+    QTimer m_delay;
+};
+
+#endif // LOGCHANGENOTIFIER_H
@@ -0,0 +1,223 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGCHUNKPARSER_H
+#define LOGCHUNKPARSER_H
+
+#include "logcanceltoken.h"
+#include "logingestmetrics.h"
+
+#include <QList>
+#include <QMap>
+#include <QMutex>
+#include <QQueue>
+#include <QThread>
+#include <QVector>
+#include <QWaitCondition>
+
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <vector>
+
+//单个大文件按换行切分后每块的字节数
+#define LOG_CHUNK_BYTES (8 * 1024 * 1024)
+//分块解析的最大线程数
+#define LOG_CHUNK_MAX_THREADS 8
+//解析完、还没有交付的块数上限比线程数多出的块数,限制一次缓存的解析结果
+#define LOG_CHUNK_WINDOW_EXTRA 2
+//等待时定时醒来检查是否被停止,毫秒
+#define LOG_CHUNK_WAIT_MSEC 50
+
+/**
+ * @brief The LogChunkParser class 单个大文件的分块并行解析
+ * 文件在换行处切分为约LOG_CHUNK_BYTES的块,块按顺序号轮流分到各线程的任务队列;
+ * 线程先取自己队列中的块,自己的队列空了再从其它线程的队列窃取顺序号最小的块,
+ * 块的耗时不均(如某段多为长行)时不会有线程空等。调用者线程按顺序号依次交付,
+ * 只允许排在交付位置之后一个窗口内的块开始解析,内存中最多缓存窗口大小的结果
+ */
+template <typename Record>
+class LogChunkParser
+{
+public:
+    /**
+     * @brief Task 解析第index块,返回false时停止
+     */
+    typedef std::function<bool(int index, QList<Record> &records)> Task;
+    /**
+     * @brief Deliver 按顺序交付一块的记录,返回false时停止,只在调用者线程中调用
+     */
+    typedef std::function<bool(QList<Record> &records)> Deliver;
+
+    explicit LogChunkParser(const std::atomic_bool &canRun)
+        : m_canRun(canRun)
+    {
+    }
+
+    static int idealThreadCount()
+    {
+        return qBound(1, QThread::idealThreadCount(), LOG_CHUNK_MAX_THREADS);
+    }
+
+    /**
+     * @brief run 解析所有块
+     * @param chunkCount 块数
+     * @param threads 线程数,不超过1时在调用者线程依次解析
+     * @return 是否全部解析并交付
+     */
+    bool run(int chunkCount, int threads, const Task &task, const Deliver &deliver)
+    {
+        threads = qBound(1, threads, qMin(chunkCount, LOG_CHUNK_MAX_THREADS));
+        m_stolen = 0;
+        if (threads <= 1) {
+            QList<Record> records;
+            for (int i = 0; i < chunkCount; ++i) {
+                records.clear();
+                if (!m_canRun || !task(i, records) || !m_canRun)
+                    return false;
+                if (!records.isEmpty() && !deliver(records))
+                    return false;
+            }
+            return m_canRun;
+        }
+
+        m_queues = QVector<QQueue<int>>(threads);
+        for (int i = 0; i < chunkCount; ++i)
+            m_queues[i % threads].enqueue(i);
+        m_window = threads + LOG_CHUNK_WINDOW_EXTRA;
+        m_chunkCount = chunkCount;
+        m_delivered = 0;
+        m_stopped = false;
+        m_failed = false;
+        m_done.clear();
+
+        //工作线程沿用调用者的加载计数和取消令牌
+        const LogIngestCountersPtr ingest = LogIngestMetrics::current();
+        const LogCancelToken cancel = LogCancelToken::current();
+        std::vector<std::thread> workers;
+        for (int i = 0; i < threads; ++i) {
+            workers.emplace_back([this, i, &task, ingest, cancel]() {
+                LogIngestScope ingestScope(ingest);
+                LogCancelScope cancelScope(cancel);
+                work(i, task);
+            });
+        }
+        bool completed = deliverAll(deliver);
+        {
+            QMutexLocker locker(&m_mutex);
+            m_stopped = true;
+            m_progress.wakeAll();
+        }
+        for (std::thread &worker : workers)
+            worker.join();
+        return completed && !m_failed && m_canRun;
+    }
+
+    /**
+     * @brief stolen 上一次run中从其它线程窃取的块数
+     */
+    int stolen() const { return m_stolen; }
+
+private:
+    bool stopped() const { return m_stopped || !m_canRun; }
+
+    /**
+     * @brief take 取下一块:自己队列的块在窗口内时取自己的,否则窃取所有队列中顺序号最小的块;没有剩余的块时返回-1
+     */
+    int take(int worker) const
+    {
+        if (!m_queues.at(worker).isEmpty() && m_queues.at(worker).head() < m_delivered + m_window)
+            return m_queues.at(worker).head();
+        int index = -1;
+        for (const QQueue<int> &queue : m_queues) {
+            if (!queue.isEmpty() && (index < 0 || queue.head() < index))
+                index = queue.head();
+        }
+        return index;
+    }
+
+    void pop(int worker, int index)
+    {
+        if (!m_queues.at(worker).isEmpty() && m_queues.at(worker).head() == index) {
+            m_queues[worker].dequeue();
+            return;
+        }
+        for (QQueue<int> &queue : m_queues) {
+            if (!queue.isEmpty() && queue.head() == index) {
+                queue.dequeue();
+                ++m_stolen;
+                return;
+            }
+        }
+    }
+
+    void work(int worker, const Task &task)
+    {
+        for (;;) {
+            int index = -1;
+            {
+                QMutexLocker locker(&m_mutex);
+                for (;;) {
+                    if (stopped())
+                        return;
+                    index = take(worker);
+                    if (index < 0)
+                        return;
+                    //超出窗口的块等交付赶上来再解析
+                    if (index < m_delivered + m_window)
+                        break;
+                    m_progress.wait(&m_mutex, LOG_CHUNK_WAIT_MSEC);
+                }
+                pop(worker, index);
+            }
+            QList<Record> records;
+            const bool ok = task(index, records);
+            QMutexLocker locker(&m_mutex);
+            if (!ok) {
+                m_failed = true;
+                m_stopped = true;
+                m_progress.wakeAll();
+                return;
+            }
+            m_done.insert(index, records);
+            m_progress.wakeAll();
+        }
+    }
+
+    bool deliverAll(const Deliver &deliver)
+    {
+        while (m_delivered < m_chunkCount) {
+            QList<Record> records;
+            {
+                QMutexLocker locker(&m_mutex);
+                while (!m_done.contains(m_delivered) && !stopped())
+                    m_progress.wait(&m_mutex, LOG_CHUNK_WAIT_MSEC);
+                if (stopped())
+                    return false;
+                records = m_done.take(m_delivered);
+            }
+            if (!records.isEmpty() && !deliver(records))
+                return false;
+            QMutexLocker locker(&m_mutex);
+            ++m_delivered;
+            m_progress.wakeAll();
+        }
+        return true;
+    }
+
+    const std::atomic_bool &m_canRun;
+    QMutex m_mutex;
+    QWaitCondition m_progress;
+    //每个线程的任务队列,按顺序号递增
+    QVector<QQueue<int>> m_queues;
+    QMap<int, QList<Record>> m_done;
+    int m_window = 1;
+    int m_chunkCount = 0;
+    int m_delivered = 0;
+    int m_stolen = 0;
+    bool m_stopped = false;
+    bool m_failed = false;
+};
+
+#endif // LOGCHUNKPARSER_H
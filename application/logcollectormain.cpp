@@ -8,6 +8,10 @@
 #include "utils.h"
 #include "logallexportthread.h"
 #include "exportprogressdlg.h"
+#include "logworkscheduler.h"
+#include "eventlogutils.h"
+#include "logsnapshot.h"
+#include "logglobalsearchdlg.h"
 
 #include "dbusmanager.h"
 
@@ -20,6 +24,7 @@
 
 #include <QDateTime>
 #include <QDebug>
+#include <QFileInfo>
 #include <QHeaderView>
 #include <QStandardItem>
 #include <QStandardItemModel>
@@ -33,6 +38,8 @@
 //958+53+50 976
 //日志类型选择器宽度
 #define LEFT_LIST_WIDTH 200
+//首屏迟迟没有结果(如等待鉴权)时,最多等待这么久就进行延迟的初始化,毫秒
+#define LOG_STARTUP_DEFER_TIMEOUT 1500
 DWIDGET_USE_NAMESPACE
 
 //刷新间隔
@@ -48,14 +55,36 @@ LogCollectorMain::LogCollectorMain(QWidget *parent)
     initUI();
     initConnection();
 
-    initShortCut();
     //日志类型选择器选第一个
     m_logCatelogue->setDefaultSelect();
     //设置最小窗口尺寸
     setMinimumSize(MAINWINDOW_WIDTH, MAINWINDOW_HEIGHT);
     //恢复上次关闭时记录的窗口大小
     resize(LogSettings::instance()->getConfigWinSize());
-    Utils::m_mapAuditType2EventType = LogSettings::instance()->loadAuditMap();
+    //第一屏显示出结果即可操作,其余的初始化等这一屏绘制之后再进行
+    connect(m_midRightWgt, &DisplayContent::firstScreenReady, this, [this]() {
+        PERF_PRINT_END("POINT-06", "");
+        QTimer::singleShot(0, this, &LogCollectorMain::initDeferred);
+    });
+    QTimer::singleShot(LOG_STARTUP_DEFER_TIMEOUT, this, &LogCollectorMain::initDeferred);
+}
+
+/**
+ * @brief LogCollectorMain::initDeferred 不影响首屏的初始化:刷新菜单和配置、快捷键、审计类型配置和埋点接口,
+ * 在第一屏显示之后或等待超时后进行,只执行一次
+ */
+void LogCollectorMain::initDeferred()
+{
+    if (m_deferredDone)
+        return;
+    m_deferredDone = true;
+    initRefreshMenu();
+    initShortCut();
+    //审计类型配置只在解析审计日志时使用
+    Utils::setAuditMap(LogSettings::instance()->loadAuditMap());
+    Eventlogutils::GetInstance();
+    //命令行导出系统日志时可以直接使用已加载的日志
+    m_midRightWgt->startExportServer();
 }
 
 /**
@@ -89,7 +118,22 @@ void LogCollectorMain::initUI()
 
     m_searchEdt->setPlaceHolder(DApplication::translate("SearchBar", "Search"));
     m_searchEdt->setMaximumWidth(400);
-    titlebar()->setCustomWidget(m_searchEdt, true);
+    m_searchRegexBtn = new DToolButton();
+    m_searchRegexBtn->setText(".*");
+    m_searchRegexBtn->setCheckable(true);
+    m_searchRegexBtn->setToolTip(DApplication::translate("SearchBar", "Regular expression"));
+    m_searchHighlightBtn = new DToolButton();
+    m_searchHighlightBtn->setText(DApplication::translate("SearchBar", "Mark"));
+    m_searchHighlightBtn->setCheckable(true);
+    m_searchHighlightBtn->setToolTip(DApplication::translate("SearchBar", "Highlight matches without filtering (F3/Shift+F3 to jump)"));
+    QWidget *searchWgt = new QWidget();
+    QHBoxLayout *searchLayout = new QHBoxLayout(searchWgt);
+    searchLayout->setContentsMargins(0, 0, 0, 0);
+    searchLayout->setSpacing(4);
+    searchLayout->addWidget(m_searchEdt);
+    searchLayout->addWidget(m_searchRegexBtn);
+    searchLayout->addWidget(m_searchHighlightBtn);
+    titlebar()->setCustomWidget(searchWgt, true);
     /** add titleBar */
     titlebar()->setIcon(QIcon::fromTheme("deepin-log-viewer"));
     titlebar()->setTitle("");
@@ -166,6 +210,7 @@ void LogCollectorMain::initUI()
     this->centralWidget()->setLayout(m_hLayout);
     m_searchEdt->setObjectName("searchEdt");
     m_searchEdt->lineEdit()->setObjectName("searchChildEdt");
+    m_searchRegexBtn->setObjectName("searchRegexBtn");
     m_topRightWgt->setObjectName("FilterContent");
     m_midRightWgt->setObjectName("DisplayContent");
     titlebar()->setObjectName("titlebar");
@@ -176,7 +221,42 @@ void LogCollectorMain::initUI()
     m_originFilterWidth = m_topRightWgt->geometry().width();
 }
 
+/**
+ * @brief LogCollectorMain::initTitlebarExtensions 标题栏上的导出和刷新按钮,刷新间隔菜单见initRefreshMenu
+ */
 void LogCollectorMain::initTitlebarExtensions()
+{
+    DWidget *widget = new DWidget;
+    QHBoxLayout *layout = new QHBoxLayout(widget);
+    m_exportAllBtn = new DIconButton(widget);
+    m_exportAllBtn->setFixedSize(QSize(36, 36));
+    m_exportAllBtn->setIcon(QIcon::fromTheme("export"));
+    m_exportAllBtn->setIconSize(QSize(36, 36));
+    m_exportAllBtn->setToolTip(qApp->translate("titlebar", "Export All"));
+    m_exportAllBtn->setAccessibleName(qApp->translate("titlebar", "Export All"));
+    m_refreshBtn = new DIconButton(widget);
+    m_refreshBtn->setIcon(QIcon::fromTheme("refresh"));
+    m_refreshBtn->setFixedSize(QSize(36, 36));
+    m_refreshBtn->setIconSize(QSize(36, 36));
+    m_refreshBtn->setToolTip(qApp->translate("titlebar", "Refresh Now"));
+    m_refreshBtn->setAccessibleName(qApp->translate("titlebar", "Refresh Now"));
+    layout->addSpacing(115);
+    layout->addWidget(m_exportAllBtn);
+    layout->addSpacing(2);
+    layout->addWidget(m_refreshBtn);
+    titlebar()->addWidget(widget, Qt::AlignLeft);
+    connect(m_refreshBtn, &QPushButton::clicked, this, [ = ] {
+        m_topRightWgt->setLeftButtonState(true);
+        m_topRightWgt->setChangedcomboxstate(false);
+        emit m_logCatelogue->sigRefresh(m_logCatelogue->currentIndex());
+    });
+    connect(m_exportAllBtn, &QPushButton::clicked, this, &LogCollectorMain::exportAllLogs);
+}
+
+/**
+ * @brief LogCollectorMain::initRefreshMenu 标题栏菜单中的刷新间隔,读取配置并恢复上次的刷新间隔
+ */
+void LogCollectorMain::initRefreshMenu()
 {
     DMenu *refreshMenu = new DMenu(this);
     DMenu *menu = new DMenu(DApplication::translate("titlebar", "Refresh interval"), refreshMenu);
@@ -185,6 +265,10 @@ void LogCollectorMain::initTitlebarExtensions()
     m_refreshActions.push_back(menu->addAction(qApp->translate("titlebar", "1 min")));
     m_refreshActions.push_back(menu->addAction(qApp->translate("titlebar", "5 min")));
     m_refreshActions.push_back(menu->addAction(qApp->translate("titlebar", "No refresh")));
+    //实时跟踪显示在最前面,但序号放在最后以兼容已保存的刷新配置
+    QAction *followAction = new QAction(qApp->translate("titlebar", "Real time"), menu);
+    menu->insertAction(m_refreshActions.first(), followAction);
+    m_refreshActions.push_back(followAction);
 
     QActionGroup *group = new QActionGroup(menu);
     for (auto &it : m_refreshActions) {
@@ -195,6 +279,17 @@ void LogCollectorMain::initTitlebarExtensions()
     QObject::connect(group, &QActionGroup::triggered,
                      this, &LogCollectorMain::switchRefreshActionTriggered);
     refreshMenu->addMenu(menu);
+    //已加载的日志保存为快照,之后在本机或其他机器上直接打开
+    QAction *saveSnapshotAction = refreshMenu->addAction(DApplication::translate("titlebar", "Save snapshot"));
+    QAction *openSnapshotAction = refreshMenu->addAction(DApplication::translate("titlebar", "Open snapshot"));
+    connect(saveSnapshotAction, &QAction::triggered, this, &LogCollectorMain::saveSnapshot);
+    connect(openSnapshotAction, &QAction::triggered, this, &LogCollectorMain::openSnapshot);
+    //全部导出的包直接在其他日志中查看,不需要解压
+    QAction *openArchiveAction = refreshMenu->addAction(DApplication::translate("titlebar", "Open exported archive"));
+    connect(openArchiveAction, &QAction::triggered, this, &LogCollectorMain::openArchive);
+    //同一个关键字同时搜索所有类别,结果按时间合并显示
+    QAction *globalSearchAction = refreshMenu->addAction(DApplication::translate("titlebar", "Search all logs"));
+    connect(globalSearchAction, &QAction::triggered, this, &LogCollectorMain::showGlobalSearch);
     titlebar()->setMenu(refreshMenu);
     //获取配置
     initSettings();
@@ -205,31 +300,6 @@ void LogCollectorMain::initTitlebarExtensions()
         m_refreshActions[index]->setChecked(true);
         m_refreshActions[index]->triggered(true);
     }
-    DWidget *widget = new DWidget;
-    QHBoxLayout *layout = new QHBoxLayout(widget);
-    m_exportAllBtn = new DIconButton(widget);
-    m_exportAllBtn->setFixedSize(QSize(36, 36));
-    m_exportAllBtn->setIcon(QIcon::fromTheme("export"));
-    m_exportAllBtn->setIconSize(QSize(36, 36));
-    m_exportAllBtn->setToolTip(qApp->translate("titlebar", "Export All"));
-    m_exportAllBtn->setAccessibleName(qApp->translate("titlebar", "Export All"));
-    m_refreshBtn = new DIconButton(widget);
-    m_refreshBtn->setIcon(QIcon::fromTheme("refresh"));
-    m_refreshBtn->setFixedSize(QSize(36, 36));
-    m_refreshBtn->setIconSize(QSize(36, 36));
-    m_refreshBtn->setToolTip(qApp->translate("titlebar", "Refresh Now"));
-    m_refreshBtn->setAccessibleName(qApp->translate("titlebar", "Refresh Now"));
-    layout->addSpacing(115);
-    layout->addWidget(m_exportAllBtn);
-    layout->addSpacing(2);
-    layout->addWidget(m_refreshBtn);
-    titlebar()->addWidget(widget, Qt::AlignLeft);
-    connect(m_refreshBtn, &QPushButton::clicked, this, [ = ] {
-        m_topRightWgt->setLeftButtonState(true);
-        m_topRightWgt->setChangedcomboxstate(false);
-        emit m_logCatelogue->sigRefresh(m_logCatelogue->currentIndex());
-    });
-    connect(m_exportAllBtn, &QPushButton::clicked, this, &LogCollectorMain::exportAllLogs);
 }
 
 void LogCollectorMain::switchRefreshActionTriggered(QAction *action)
@@ -246,9 +316,14 @@ void LogCollectorMain::switchRefreshActionTriggered(QAction *action)
     case 2:
         timeInterval = 5 * 60 * 1000; //5分钟刷新
         break;
+    case 4:
+        //实时跟踪,系统日志由journal跟踪线程推送新日志,文本日志在文件变化时刷新,其他日志仍按10秒刷新
+        timeInterval = 10 * 1000;
+        break;
     default:
         break;
     }
+    m_midRightWgt->setJournalFollow(index == 4);
     //先停止刷新
     if (m_refreshTimer && m_refreshTimer->isActive()) {
         m_refreshTimer->stop();
@@ -258,6 +333,9 @@ void LogCollectorMain::switchRefreshActionTriggered(QAction *action)
         if (nullptr == m_refreshTimer) {
             m_refreshTimer = new QTimer(this);
             connect(m_refreshTimer, &QTimer::timeout, this, [ = ] {
+                //正在实时跟踪系统日志或监视文本日志的变化时不需要定时重新加载
+                if (m_midRightWgt->journalFollowActive() || m_midRightWgt->fileFollowActive())
+                    return;
                 m_topRightWgt->setLeftButtonState(true);
                 m_topRightWgt->setChangedcomboxstate(false);
                 //触发刷新信号
@@ -330,6 +408,8 @@ void LogCollectorMain::exportAllLogs()
     bool exportcomplete = false;
     LogAllExportThread *thread = new LogAllExportThread(m_logCatelogue->getLogTypes(), newPath);
     thread->setAutoDelete(true);
+    //系统日志只导出当前所选的时间段和等级
+    thread->setJournalOptions("journalctl_system", m_midRightWgt->journalExportOptions());
     connect(thread, &LogAllExportThread::updateTolProcess, this, [ = ](int tol) {
         m_exportDlg->setProgressBarRange(0, tol);
     });
@@ -341,20 +421,121 @@ void LogCollectorMain::exportAllLogs()
         m_exportDlg->close();
         m_midRightWgt->onExportResult(ret);
     });
-    QThreadPool::globalInstance()->start(thread);
+    m_midRightWgt->setPrefetchPaused(true);
+    LogWorkScheduler::instance()->start(thread, LogWorkScheduler::Export);
     m_exportDlg->exec();
     if (!exportcomplete) {
         thread->slot_cancelExport();
+        m_midRightWgt->setPrefetchPaused(false);
+    }
+}
+
+/**
+ * @brief LogCollectorMain::saveSnapshot 选择路径后把已加载过的类别写入快照文件
+ */
+void LogCollectorMain::saveSnapshot()
+{
+    const QString dateTime = QDateTime::currentDateTime().toString("yyyyMMddHHmmss");
+    utsname _utsname;
+    uname(&_utsname);
+    static QString defaultDir = QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation);
+    const QString fileFullPath = defaultDir + "/" + QString("%1_%2%3").arg(dateTime).arg(QString(_utsname.nodename)).arg(LOG_SNAPSHOT_SUFFIX);
+    QString newPath = DFileDialog::getSaveFileName(this, "", fileFullPath, "*" LOG_SNAPSHOT_SUFFIX);
+    if (newPath.isEmpty())
+        return;
+    if (!newPath.endsWith(LOG_SNAPSHOT_SUFFIX))
+        newPath += LOG_SNAPSHOT_SUFFIX;
+    defaultDir = QFileInfo(newPath).absolutePath();
+    m_midRightWgt->saveSnapshot(newPath);
+}
+
+/**
+ * @brief LogCollectorMain::openSnapshot 打开快照文件并重新加载当前类别
+ */
+void LogCollectorMain::openSnapshot()
+{
+    const QString path = DFileDialog::getOpenFileName(this, "", QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation),
+                                                      "*" LOG_SNAPSHOT_SUFFIX);
+    if (path.isEmpty() || !m_midRightWgt->openSnapshot(path))
+        return;
+    emit m_logCatelogue->sigRefresh(m_logCatelogue->currentIndex());
+}
+
+/**
+ * @brief LogCollectorMain::openArchive 选择全部导出的zip包,切换到其他日志并列出包中的类别
+ */
+void LogCollectorMain::openArchive()
+{
+    const QString path = DFileDialog::getOpenFileName(this, "", QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation), "*.zip");
+    if (path.isEmpty() || !m_logCatelogue->selectCategory(OTHER_TREE_DATA))
+        return;
+    m_midRightWgt->openArchive(path);
+}
+
+/**
+ * @brief LogCollectorMain::showGlobalSearch 打开全局搜索面板,以搜索框中的关键字开始搜索
+ */
+void LogCollectorMain::showGlobalSearch()
+{
+    if (!m_globalSearchDlg) {
+        m_globalSearchDlg = new LogGlobalSearchDlg(this);
+        m_globalSearchDlg->setAttribute(Qt::WA_DeleteOnClose);
+        m_globalSearchDlg->show();
+        if (!m_searchEdt->text().isEmpty())
+            m_globalSearchDlg->search(m_searchEdt->text());
+        return;
     }
+    m_globalSearchDlg->activateWindow();
 }
+
 /**
  * @brief LogCollectorMain::initConnection 连接信号槽
  */
 void LogCollectorMain::initConnection()
 {
+    //首屏显示前用户就切换了类别时先完成延迟的初始化,审计日志的解析依赖其中的配置;
+    //要先于数据展示控件连接,保证在开始加载之前执行
+    connect(m_logCatelogue, &LogListView::itemChanged, this, [this]() {
+        if (isVisible())
+            initDeferred();
+    });
     //! search
     connect(m_searchEdt, &DSearchEdit::textChanged, m_midRightWgt,
             &DisplayContent::slot_searchResult);
+    //搜索索引的建立进度和内存占用显示在搜索框的提示中
+    connect(m_midRightWgt, &DisplayContent::searchIndexStatus, this, [this](const QString &status) {
+        m_searchEdt->setToolTip(status);
+    });
+    //正则模式下表达式有误时在搜索框下提示
+    connect(m_searchRegexBtn, &DToolButton::toggled, m_midRightWgt, &DisplayContent::slot_searchRegexChanged);
+    //只高亮不筛选时在开关的提示中显示当前是第几个匹配
+    connect(m_searchHighlightBtn, &DToolButton::toggled, m_midRightWgt, &DisplayContent::slot_searchHighlightChanged);
+    connect(m_midRightWgt, &DisplayContent::searchMatchStatus, this, [this](int current, int total) {
+        QString tip = DApplication::translate("SearchBar", "Highlight matches without filtering (F3/Shift+F3 to jump)");
+        if (m_searchHighlightBtn->isChecked() && !m_searchEdt->text().isEmpty())
+            tip += "\n" + DApplication::translate("SearchBar", "Match %1 of %2").arg(current).arg(total);
+        m_searchHighlightBtn->setToolTip(tip);
+    });
+    connect(m_midRightWgt, &DisplayContent::searchPatternError, this, [this](const QString &error) {
+        m_searchEdt->setAlert(!error.isEmpty());
+        if (error.isEmpty())
+            m_searchEdt->hideAlertMessage();
+        else
+            m_searchEdt->showAlertMessage(error);
+    });
+    //统计面板中选中的条件追加到搜索框,已有时不重复添加
+    connect(m_midRightWgt, &DisplayContent::searchTermRequested, this, [this](const QString &term) {
+        const QString text = m_searchEdt->text().trimmed();
+        if (text.split(' ', QString::SkipEmptyParts).contains(term))
+            return;
+        m_searchEdt->setText(text.isEmpty() ? term : text + ' ' + term);
+    });
+    //实时跟踪时文本日志有变化,和定时刷新一样重新读取当前类别(内核、kwin日志只读取新追加的部分)
+    connect(m_midRightWgt, &DisplayContent::followRefreshRequested, this, [this]() {
+        m_topRightWgt->setLeftButtonState(true);
+        m_topRightWgt->setChangedcomboxstate(false);
+        emit m_logCatelogue->sigRefresh(m_logCatelogue->currentIndex());
+    });
 
     //! filter widget
     connect(m_topRightWgt, SIGNAL(sigButtonClicked(int, int, QModelIndex)), m_midRightWgt,
@@ -376,6 +557,12 @@ void LogCollectorMain::initConnection()
     connect(m_topRightWgt, &FilterContent::sigAuditTypeChanged, m_midRightWgt,
             &DisplayContent::slot_getAuditType);
 
+    connect(m_topRightWgt, &FilterContent::sigBootChanged, m_midRightWgt,
+            &DisplayContent::slot_bootChanged);
+
+    connect(m_topRightWgt, &FilterContent::sigJournalFieldChanged, m_midRightWgt,
+            &DisplayContent::slot_journalFieldChanged);
+
     connect(m_topRightWgt, &FilterContent::sigCbxAppIdxChanged, m_logCatelogue,
             &LogListView::slot_getAppPath); // add by Airy for getting app path
     connect(m_midRightWgt, &DisplayContent::setExportEnable, m_topRightWgt,
@@ -387,6 +574,7 @@ void LogCollectorMain::initConnection()
             SLOT(slot_logCatelogueRefresh(const QModelIndex &)));
 
     connect(m_logCatelogue, &LogListView::sigRefresh, this, &LogCollectorMain::slotClearInfoandFocus);
+    connect(m_logCatelogue, &LogListView::sigLogCleared, m_midRightWgt, &DisplayContent::slot_logCleared);
     //! treeView widget
 
     connect(m_logCatelogue, SIGNAL(itemChanged(const QModelIndex &)), m_midRightWgt,
@@ -463,6 +651,47 @@ void LogCollectorMain::initShortCut()
         connect(m_scExport, &QShortcut::activated, this,
                 [this] { this->m_topRightWgt->shortCutExport(); });
     }
+
+    // memory usage panel --> Ctrl+Alt+M
+    if (nullptr == m_scMemory) {
+        m_scMemory = new QShortcut(this);
+        m_scMemory->setKey(Qt::CTRL + Qt::ALT + Qt::Key_M);
+        m_scMemory->setContext(Qt::ApplicationShortcut);
+        m_scMemory->setAutoRepeat(false);
+
+        connect(m_scMemory, &QShortcut::activated, this,
+                [this] { this->m_midRightWgt->showMemoryUsage(); });
+    }
+
+    // next match --> F3
+    if (nullptr == m_scNextMatch) {
+        m_scNextMatch = new QShortcut(this);
+        m_scNextMatch->setKey(Qt::Key_F3);
+        m_scNextMatch->setContext(Qt::ApplicationShortcut);
+
+        connect(m_scNextMatch, &QShortcut::activated, this,
+                [this] { this->m_midRightWgt->jumpToNextMatch(); });
+    }
+
+    // previous match --> Shift+F3
+    if (nullptr == m_scPreviousMatch) {
+        m_scPreviousMatch = new QShortcut(this);
+        m_scPreviousMatch->setKey(Qt::SHIFT + Qt::Key_F3);
+        m_scPreviousMatch->setContext(Qt::ApplicationShortcut);
+
+        connect(m_scPreviousMatch, &QShortcut::activated, this,
+                [this] { this->m_midRightWgt->jumpToPreviousMatch(); });
+    }
+
+    // search all logs --> Ctrl+Shift+F
+    if (nullptr == m_scGlobalSearch) {
+        m_scGlobalSearch = new QShortcut(this);
+        m_scGlobalSearch->setKey(Qt::CTRL + Qt::SHIFT + Qt::Key_F);
+        m_scGlobalSearch->setContext(Qt::ApplicationShortcut);
+        m_scGlobalSearch->setAutoRepeat(false);
+
+        connect(m_scGlobalSearch, &QShortcut::activated, this, &LogCollectorMain::showGlobalSearch);
+    }
 }
 
 /**
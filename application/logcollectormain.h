@@ -12,11 +12,13 @@
 #include <DMainWindow>
 #include <DSearchEdit>
 #include <DSplitter>
+#include <DToolButton>
 #include <DTreeView>
 #include <DSettings>
 #include <qsettingbackend.h>
 
 #include <QHBoxLayout>
+#include <QPointer>
 #include <QShortcut>
 #include <QSplitter>
 #include <QVBoxLayout>
@@ -25,6 +27,7 @@ DCORE_USE_NAMESPACE
 
 class DSplitter;
 class ExportProgressDlg;
+class LogGlobalSearchDlg;
 /**
  * @brief The LogCollectorMain class 主窗口类
  */
@@ -39,7 +42,13 @@ public:
     void initSettings();
     void initShortCut();
     void initTitlebarExtensions();
+    void initRefreshMenu();
+    void initDeferred();
     void exportAllLogs();
+    void saveSnapshot();
+    void openSnapshot();
+    void openArchive();
+    void showGlobalSearch();
 public slots:
     bool handleApplicationTabEventNotify(QObject *obj, QKeyEvent *evt);
     void switchRefreshActionTriggered(QAction *action);
@@ -57,6 +66,14 @@ private:
      * @brief m_searchEdt titlebar上的搜索框
      */
     Dtk::Widget::DSearchEdit *m_searchEdt {nullptr};
+    /**
+     * @brief m_searchRegexBtn 搜索框旁的正则模式开关
+     */
+    Dtk::Widget::DToolButton *m_searchRegexBtn {nullptr};
+    /**
+     * @brief m_searchHighlightBtn 搜索框旁的只高亮不筛选开关
+     */
+    Dtk::Widget::DToolButton *m_searchHighlightBtn {nullptr};
     /**
      * @brief m_topRightWgt 筛选控件
      */
@@ -85,6 +102,13 @@ private:
     QShortcut *m_scFindFont {nullptr};
     // export file          --> Ctrl+E
     QShortcut *m_scExport {nullptr};
+    // memory usage panel --> Ctrl+Alt+M
+    QShortcut *m_scMemory {nullptr};
+    // next/previous match --> F3/Shift+F3
+    QShortcut *m_scNextMatch {nullptr};
+    QShortcut *m_scPreviousMatch {nullptr};
+    // search all logs --> Ctrl+Shift+F
+    QShortcut *m_scGlobalSearch {nullptr};
     int m_originFilterWidth = 0;
 
     QList<QAction *> m_refreshActions;
@@ -94,8 +118,12 @@ private:
     DIconButton *m_refreshBtn {nullptr};
     DIconButton *m_exportAllBtn {nullptr};
     ExportProgressDlg *m_exportDlg {nullptr};
+    //全局搜索面板,关闭时自动删除
+    QPointer<LogGlobalSearchDlg> m_globalSearchDlg;
 
     QSettingBackend  *m_backend {nullptr};
+    //不影响首屏的初始化是否已完成,见initDeferred
+    bool m_deferredDone {false};
 };
 
 #endif // LOGCOLLECTORMAIN_H
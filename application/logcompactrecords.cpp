@@ -0,0 +1,195 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logcompactrecords.h"
+#include "journalreader.h"
+
+/**
+ * @brief LogStringArena::add 把文本以UTF-8追加到字符区末尾
+ * @param text 文本
+ * @return 文本在字符区中的位置
+ */
+LogArenaString LogStringArena::add(const QString &text)
+{
+    if (text.isEmpty())
+        return LogArenaString();
+    return add(text.toUtf8());
+}
+
+LogArenaString LogStringArena::add(const QByteArray &data)
+{
+    LogArenaString str;
+    if (data.isEmpty())
+        return str;
+    str.offset = static_cast<quint32>(m_data.size());
+    str.length = static_cast<quint32>(data.size());
+    m_data.append(data);
+    return str;
+}
+
+QString LogStringArena::text(const LogArenaString &str) const
+{
+    if (str.length == 0)
+        return QString();
+    return QString::fromUtf8(m_data.constData() + str.offset, static_cast<int>(str.length));
+}
+
+QByteArray LogStringArena::bytes(const LogArenaString &str) const
+{
+    if (str.length == 0)
+        return QByteArray();
+    return QByteArray(m_data.constData() + str.offset, static_cast<int>(str.length));
+}
+
+/**
+ * @brief LogStringArena::view 不复制的UTF-8文本,字符区再次追加后失效
+ */
+LogUtf8View LogStringArena::view(const LogArenaString &str) const
+{
+    if (str.length == 0)
+        return LogUtf8View();
+    return LogUtf8View(m_data.constData() + str.offset, static_cast<int>(str.length));
+}
+
+int LogStringArena::size() const
+{
+    return m_data.size();
+}
+
+void LogStringArena::clear()
+{
+    m_data.clear();
+}
+
+LogCompactJournalList::LogCompactJournalList()
+    : m_timeFormatter(new JournalTimeFormatter)
+{
+}
+
+LogCompactJournalList::~LogCompactJournalList()
+{
+}
+
+int LogCompactJournalList::size() const
+{
+    return m_size;
+}
+
+bool LogCompactJournalList::isEmpty() const
+{
+    return m_size == 0;
+}
+
+/**
+ * @brief LogCompactJournalList::append 追加一条记录,字符串列写入最后一个批次的字符区
+ * @param record 记录
+ */
+void LogCompactJournalList::append(const LOG_MSG_JOURNAL &record)
+{
+    if (m_batches.isEmpty() || m_batches.last().entries.size() >= LOG_COMPACT_BATCH_SIZE) {
+        m_batches.append(Batch());
+        m_batches.last().entries.reserve(LOG_COMPACT_BATCH_SIZE);
+    }
+    Batch &batch = m_batches.last();
+
+    Entry e;
+    e.timestamp = record.timestamp;
+    e.level = static_cast<qint8>(record.level);
+    e.ownDateTime = record.timestamp <= 0 || m_timeFormatter->format(static_cast<quint64>(record.timestamp)) != record.dateTime;
+    if (e.ownDateTime)
+        e.dateTime = batch.arena.add(record.dateTime);
+    e.hostName = batch.arena.add(record.hostName);
+    e.daemonName = batch.arena.add(record.daemonName);
+    e.daemonId = batch.arena.add(record.daemonId);
+    e.msg = batch.arena.add(record.msg);
+    e.cursor = batch.arena.add(record.cursor);
+    batch.entries.append(e);
+    ++m_size;
+}
+
+void LogCompactJournalList::append(const QList<LOG_MSG_JOURNAL> &records)
+{
+    for (const LOG_MSG_JOURNAL &record : records)
+        append(record);
+}
+
+/**
+ * @brief LogCompactJournalList::at 取出第i条记录
+ * @param i 下标,需要在[0, size())范围内
+ * @return 重新构造的记录,各字段和追加时一致
+ */
+LOG_MSG_JOURNAL LogCompactJournalList::at(int i) const
+{
+    const Batch *batch = nullptr;
+    const Entry &e = entry(i, &batch);
+
+    LOG_MSG_JOURNAL record;
+    record.timestamp = e.timestamp;
+    record.dateTime = e.ownDateTime ? batch->arena.text(e.dateTime) : m_timeFormatter->format(static_cast<quint64>(e.timestamp));
+    record.level = e.level;
+    record.hostName = batch->arena.text(e.hostName);
+    record.daemonName = batch->arena.text(e.daemonName);
+    record.daemonId = batch->arena.text(e.daemonId);
+    record.msg = batch->arena.text(e.msg);
+    record.cursor = batch->arena.bytes(e.cursor);
+    return record;
+}
+
+qint64 LogCompactJournalList::timestamp(int i) const
+{
+    const Batch *batch = nullptr;
+    return entry(i, &batch).timestamp;
+}
+
+/**
+ * @brief LogCompactJournalList::message 第i条记录信息的UTF-8原文,按关键字判断时不需要构造整条记录
+ * 同一批次追加新记录后失效
+ */
+LogUtf8View LogCompactJournalList::message(int i) const
+{
+    const Batch *batch = nullptr;
+    const Entry &e = entry(i, &batch);
+    return batch->arena.view(e.msg);
+}
+
+int LogCompactJournalList::level(int i) const
+{
+    const Batch *batch = nullptr;
+    return entry(i, &batch).level;
+}
+
+/**
+ * @brief LogCompactJournalList::toList 取出全部记录,用于导出等需要完整结构的场景
+ */
+QList<LOG_MSG_JOURNAL> LogCompactJournalList::toList() const
+{
+    QList<LOG_MSG_JOURNAL> list;
+    list.reserve(m_size);
+    for (int i = 0; i < m_size; ++i)
+        list.append(at(i));
+    return list;
+}
+
+void LogCompactJournalList::clear()
+{
+    m_batches.clear();
+    m_size = 0;
+}
+
+/**
+ * @brief LogCompactJournalList::arenaSize 所有批次字符区的总字节数
+ */
+int LogCompactJournalList::arenaSize() const
+{
+    int size = 0;
+    for (const Batch &batch : m_batches)
+        size += batch.arena.size();
+    return size;
+}
+
+const LogCompactJournalList::Entry &LogCompactJournalList::entry(int i, const Batch **batch) const
+{
+    *batch = &m_batches.at(i / LOG_COMPACT_BATCH_SIZE);
+    return (*batch)->entries.at(i % LOG_COMPACT_BATCH_SIZE);
+}
@@ -0,0 +1,102 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGCOMPACTRECORDS_H
+#define LOGCOMPACTRECORDS_H
+
+#include "structdef.h"
+#include "logutf8view.h"
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+#include <QVector>
+
+#include <memory>
+
+//每个批次最多保存的记录数,每批使用独立的字符区,追加时不需要搬动之前的数据
+#define LOG_COMPACT_BATCH_SIZE 4096
+
+class JournalTimeFormatter;
+
+/**
+ * @brief The LogArenaString struct 字符区中的一段UTF-8文本
+ */
+struct LogArenaString {
+    quint32 offset = 0;
+    quint32 length = 0;
+};
+
+/**
+ * @brief The LogStringArena class 一批记录共用的UTF-8字符区,所有字符串列依次存放,记录中只保存偏移和长度
+ */
+class LogStringArena
+{
+public:
+    LogArenaString add(const QString &text);
+    LogArenaString add(const QByteArray &data);
+    QString text(const LogArenaString &str) const;
+    QByteArray bytes(const LogArenaString &str) const;
+    LogUtf8View view(const LogArenaString &str) const;
+    int size() const;
+    void clear();
+
+private:
+    QByteArray m_data;
+};
+
+/**
+ * @brief The LogCompactJournalList class 紧凑存储的journal/内核日志记录,只追加
+ * 每条记录为定长结构:时间戳、等级和各字符串列在所在批次字符区中的位置,
+ * 相比每条记录6个QString各自分配内存,占用小得多,顺序扫描时也更连续;
+ * 有时间戳的记录不保存时间文本,取出时由时间戳重新生成;
+ * at()取出的是重新构造的LOG_MSG_JOURNAL,不能跨线程共用
+ */
+class LogCompactJournalList
+{
+public:
+    LogCompactJournalList();
+    ~LogCompactJournalList();
+
+    int size() const;
+    bool isEmpty() const;
+    void append(const LOG_MSG_JOURNAL &record);
+    void append(const QList<LOG_MSG_JOURNAL> &records);
+    LOG_MSG_JOURNAL at(int i) const;
+    qint64 timestamp(int i) const;
+    int level(int i) const;
+    LogUtf8View message(int i) const;
+    QList<LOG_MSG_JOURNAL> toList() const;
+    void clear();
+    int arenaSize() const;
+
+private:
+    struct Entry {
+        qint64 timestamp = 0;
+        //等级,为PRIORITY的值,没有等级时为-1
+        qint8 level = -1;
+        //时间文本和时间戳生成的不一致(如内核日志没有时间戳)时才保存在dateTime中
+        bool ownDateTime = false;
+        LogArenaString dateTime;
+        LogArenaString hostName;
+        LogArenaString daemonName;
+        LogArenaString daemonId;
+        LogArenaString msg;
+        LogArenaString cursor;
+    };
+    struct Batch {
+        LogStringArena arena;
+        QVector<Entry> entries;
+    };
+
+    const Entry &entry(int i, const Batch **batch) const;
+
+    QVector<Batch> m_batches;
+    int m_size = 0;
+    std::unique_ptr<JournalTimeFormatter> m_timeFormatter;
+
+    Q_DISABLE_COPY(LogCompactJournalList)
+};
+
+#endif // LOGCOMPACTRECORDS_H
@@ -0,0 +1,265 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logcoredumpdetail.h"
+#include "utils.h"
+#include "sharedmemorymanager.h"
+#include "logcanceltoken.h"
+#include "dbusproxy/dldbushandler.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QLoggingCategory>
+#include <QMutexLocker>
+#include <QProcess>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QVector>
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#ifdef QT_DEBUG
+Q_LOGGING_CATEGORY(logCoredumpDetail, "org.deepin.log.viewer.coredump.detail")
+#else
+Q_LOGGING_CATEGORY(logCoredumpDetail, "org.deepin.log.viewer.coredump.detail", QtInfoMsg)
+#endif
+
+QDataStream &operator<<(QDataStream &out, const LogCoredumpDetailCache::Entry &entry)
+{
+    return out << entry.timestamp << entry.stackInfo << entry.maps;
+}
+
+QDataStream &operator>>(QDataStream &in, LogCoredumpDetailCache::Entry &entry)
+{
+    return in >> entry.timestamp >> entry.stackInfo >> entry.maps;
+}
+
+/**
+ * @brief LogCoredumpDetailCache::LogCoredumpDetailCache 读取缓存文件,文件不存在或版本不符时为空
+ * @param path 缓存文件路径
+ */
+LogCoredumpDetailCache::LogCoredumpDetailCache(const QString &path)
+    : m_path(path)
+{
+    QFile file(m_path);
+    if (!file.open(QIODevice::ReadOnly))
+        return;
+    QDataStream in(&file);
+    quint32 version = 0;
+    in >> version;
+    if (version != COREDUMP_DETAIL_CACHE_VERSION)
+        return;
+    in >> m_entries;
+    if (in.status() != QDataStream::Ok) {
+        qCWarning(logCoredumpDetail) << "coredump detail cache is corrupted:" << m_path;
+        m_entries.clear();
+    }
+}
+
+/**
+ * @brief LogCoredumpDetailCache::lookup 用缓存中的详情补全记录,补全后清空游标,和LogCoredumpDetail::load一致
+ * @return 是否命中
+ */
+bool LogCoredumpDetailCache::lookup(LOG_MSG_COREDUMP &record) const
+{
+    QMutexLocker locker(&m_mutex);
+    auto it = m_entries.constFind(record.cursor);
+    if (it == m_entries.constEnd())
+        return false;
+    record.stackInfo = it->stackInfo;
+    record.maps = it->maps;
+    record.cursor.clear();
+    return true;
+}
+
+/**
+ * @brief LogCoredumpDetailCache::insert 保存一条已读取详情的记录,需要maps但读取失败(如鉴权被取消)时不保存,下次再读取
+ * @param cursor 记录读取详情前的游标
+ */
+void LogCoredumpDetailCache::insert(const QByteArray &cursor, const LOG_MSG_COREDUMP &record)
+{
+    if (cursor.isEmpty() || (LogCoredumpDetail::needsMaps(record) && record.maps.isEmpty()))
+        return;
+    Entry entry;
+    entry.timestamp = record.timestamp;
+    entry.stackInfo = record.stackInfo;
+    entry.maps = record.maps;
+    QMutexLocker locker(&m_mutex);
+    m_entries.insert(cursor, entry);
+    m_dirty = true;
+}
+
+int LogCoredumpDetailCache::size() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_entries.size();
+}
+
+/**
+ * @brief LogCoredumpDetailCache::save 有新增时写回缓存文件,超过COREDUMP_DETAIL_CACHE_MAX条时先丢弃最早崩溃的记录
+ */
+bool LogCoredumpDetailCache::save()
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_dirty)
+        return true;
+    if (m_entries.size() > COREDUMP_DETAIL_CACHE_MAX) {
+        QVector<qint64> times;
+        times.reserve(m_entries.size());
+        for (const Entry &entry : m_entries)
+            times.append(entry.timestamp);
+        std::nth_element(times.begin(), times.end() - COREDUMP_DETAIL_CACHE_MAX, times.end());
+        const qint64 oldest = *(times.end() - COREDUMP_DETAIL_CACHE_MAX);
+        for (auto it = m_entries.begin(); it != m_entries.end();) {
+            if (it->timestamp < oldest)
+                it = m_entries.erase(it);
+            else
+                ++it;
+        }
+    }
+
+    QDir().mkpath(QFileInfo(m_path).absolutePath());
+    QSaveFile out(m_path);
+    if (!out.open(QIODevice::WriteOnly))
+        return false;
+    QDataStream stream(&out);
+    stream << static_cast<quint32>(COREDUMP_DETAIL_CACHE_VERSION) << m_entries;
+    if (!out.commit())
+        return false;
+    m_dirty = false;
+    return true;
+}
+
+QString LogCoredumpDetailCache::defaultPath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/coredump/details.dat";
+}
+
+LogCoredumpDetail::LogCoredumpDetail()
+{
+}
+
+/**
+ * @brief LogCoredumpDetail::stack 读取崩溃记录的堆栈信息
+ * @param cursor 崩溃记录的journal条目游标
+ * @return 第一个线程的堆栈,读取失败或没有堆栈时为空
+ */
+QString LogCoredumpDetail::stack(const QByteArray &cursor)
+{
+    return stackTrace(m_resolver.message(cursor));
+}
+
+/**
+ * @brief LogCoredumpDetail::load 补全崩溃记录的堆栈和maps信息
+ * @param record 崩溃记录,补全后清空游标
+ */
+void LogCoredumpDetail::load(LOG_MSG_COREDUMP &record)
+{
+    if (record.cursor.isEmpty())
+        return;
+    record.stackInfo = stack(record.cursor);
+    if (needsMaps(record))
+        record.maps = readMaps(record.pid, record.storagePath);
+    record.cursor.clear();
+}
+
+/**
+ * @brief LogCoredumpDetail::loadAll 补全一组崩溃记录的详情,先取缓存,其余的由最多threads个线程并行读取并存入缓存
+ * 每个线程使用自己的journal句柄,依次从队列中取下一条,有maps的记录耗时较长也不会让其他线程空等
+ * @param records 崩溃记录,补全后清空游标
+ * @param cache 详情缓存,调用者负责save
+ * @param canRun 是否继续,置false后正在导出core文件的子进程也被结束
+ * @param threads 最大并行数
+ */
+void LogCoredumpDetail::loadAll(QList<LOG_MSG_COREDUMP> &records, LogCoredumpDetailCache &cache, const std::atomic_bool &canRun, int threads)
+{
+    QVector<LOG_MSG_COREDUMP *> pending;
+    for (LOG_MSG_COREDUMP &record : records) {
+        if (record.cursor.isEmpty() || cache.lookup(record))
+            continue;
+        pending.append(&record);
+    }
+    if (pending.isEmpty())
+        return;
+
+    std::atomic_int next(0);
+    const int count = qBound(1, threads, pending.size());
+    std::vector<std::thread> workers;
+    for (int i = 0; i < count; ++i) {
+        workers.emplace_back([&pending, &next, &cache, &canRun]() {
+            LogCancelScope cancel(canRun);
+            LogCoredumpDetail detail;
+            for (int index = next++; index < pending.size() && canRun; index = next++) {
+                LOG_MSG_COREDUMP &record = *pending.at(index);
+                const QByteArray cursor = record.cursor;
+                detail.load(record);
+                cache.insert(cursor, record);
+            }
+        });
+    }
+    for (std::thread &worker : workers)
+        worker.join();
+}
+
+/**
+ * @brief LogCoredumpDetail::needsMaps 是否需要读取maps信息,coreFile为missing表示文件已丢失,不解析maps
+ */
+bool LogCoredumpDetail::needsMaps(const LOG_MSG_COREDUMP &record)
+{
+    return record.coreFile == "present" || record.coreFile == "journal";
+}
+
+/**
+ * @brief LogCoredumpDetail::stackTrace 从systemd-coredump的MESSAGE中截取第一个线程的堆栈
+ * @param message 崩溃记录的MESSAGE
+ * @return "Stack trace of thread"开头的第一段,没有时为空
+ */
+QString LogCoredumpDetail::stackTrace(const QString &message)
+{
+    static const QString head = "Stack trace of thread";
+    int begin = message.indexOf(head);
+    if (begin < 0)
+        return QString();
+    int end = message.indexOf(head, begin + head.size());
+    return message.mid(begin, end < 0 ? -1 : end - begin);
+}
+
+/**
+ * @brief LogCoredumpDetail::readMaps 导出core文件并用readelf -n解析其中的文件映射
+ * @param pid 崩溃进程的pid
+ * @param storagePath core文件的保存位置
+ * @return readelf的输出
+ */
+QString LogCoredumpDetail::readMaps(const QString &pid, const QString &storagePath)
+{
+    const QString &corePath = QDir::homePath() + QString("/%1.dump").arg(QFileInfo(storagePath).fileName());
+    QString outInfoByte;
+    if (Utils::runInCmd) {
+        DLDBusHandler::instance()->readLog(QString("coredumpctl dump %1 -o %2").arg(pid).arg(corePath));
+        outInfoByte = DLDBusHandler::instance()->readLog(QString("readelf -n %1").arg(corePath));
+    } else {
+        QProcess process;
+        process.start("pkexec", QStringList() << "logViewerAuth" << QStringList() << "coredumpctl-dump"
+                      << pid << corePath << SharedMemoryManager::instance()->getRunnableKey());
+        //在上报线程中调用时,停止上报后立即结束子进程
+        const LogCancelToken token = LogCancelToken::current();
+        if (token.waitForProcess(&process)) {
+            process.start("pkexec", QStringList() << "logViewerAuth" << QStringList() << "readelf"
+                          << corePath << SharedMemoryManager::instance()->getRunnableKey());
+            QStringList lines;
+            token.readLines(&process, [&lines](const QByteArray &line) {
+                lines.append(QString::fromUtf8(line));
+                return true;
+            });
+            outInfoByte = lines.join('\n');
+        }
+    }
+    if (outInfoByte.isEmpty())
+        qCWarning(logCoredumpDetail) << "read maps of" << pid << "failed";
+    QFile::remove(corePath);
+    return outInfoByte;
+}
@@ -0,0 +1,85 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGCOREDUMPDETAIL_H
+#define LOGCOREDUMPDETAIL_H
+
+#include "journalreader.h"
+#include "structdef.h"
+
+#include <QByteArray>
+#include <QDataStream>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QString>
+
+#include <atomic>
+
+//同时读取详情的崩溃记录数,每条maps信息要依次启动coredumpctl dump和readelf
+#define COREDUMP_DETAIL_THREADS 4
+//详情缓存最多保存的崩溃记录数,超过时丢弃最早崩溃的记录
+#define COREDUMP_DETAIL_CACHE_MAX 2000
+//详情缓存文件的格式版本,结构变化时递增,旧文件被忽略
+#define COREDUMP_DETAIL_CACHE_VERSION 1
+
+/**
+ * @brief The LogCoredumpDetailCache class 已解析的崩溃详情(堆栈、maps)的持久缓存,以journal条目游标为键
+ * 同一次崩溃的详情不会变化,解析过一次后以后的运行直接取用,core文件被清理后也能取到;可被并行读取线程共用
+ */
+class LogCoredumpDetailCache
+{
+public:
+    explicit LogCoredumpDetailCache(const QString &path = defaultPath());
+
+    bool lookup(LOG_MSG_COREDUMP &record) const;
+    void insert(const QByteArray &cursor, const LOG_MSG_COREDUMP &record);
+    int size() const;
+    bool save();
+
+    static QString defaultPath();
+
+private:
+    struct Entry {
+        //崩溃时间(微秒),超过上限时按它丢弃
+        qint64 timestamp = 0;
+        QString stackInfo;
+        QString maps;
+    };
+    friend QDataStream &operator<<(QDataStream &out, const Entry &entry);
+    friend QDataStream &operator>>(QDataStream &in, Entry &entry);
+
+    QString m_path;
+    mutable QMutex m_mutex;
+    QHash<QByteArray, Entry> m_entries;
+    bool m_dirty = false;
+};
+
+/**
+ * @brief The LogCoredumpDetail class 崩溃日志详情的延迟加载
+ * 列表只读取COREDUMP_*元数据,堆栈信息在打开详情时按游标从MESSAGE读取,
+ * maps信息需要导出core文件再用readelf解析,只在上报时读取
+ */
+class LogCoredumpDetail
+{
+public:
+    LogCoredumpDetail();
+
+    QString stack(const QByteArray &cursor);
+    void load(LOG_MSG_COREDUMP &record);
+
+    static void loadAll(QList<LOG_MSG_COREDUMP> &records, LogCoredumpDetailCache &cache, const std::atomic_bool &canRun,
+                        int threads = COREDUMP_DETAIL_THREADS);
+    static bool needsMaps(const LOG_MSG_COREDUMP &record);
+
+    static QString stackTrace(const QString &message);
+    static QString readMaps(const QString &pid, const QString &storagePath);
+
+private:
+    Q_DISABLE_COPY(LogCoredumpDetail)
+
+    JournalMessageResolver m_resolver;
+};
+
+#endif // LOGCOREDUMPDETAIL_H
@@ -0,0 +1,50 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logcoredumpstackwork.h"
+#include "logcoredumpdetail.h"
+
+/**
+ * @brief LogCoredumpStackWork::LogCoredumpStackWork 构造函数
+ * @param request 请求标号
+ * @param cursor 崩溃记录的journal条目游标
+ * @param header 显示在堆栈之前的文字(core文件位置)
+ * @param canRun 本次读取的取消标记
+ */
+LogCoredumpStackWork::LogCoredumpStackWork(int request, const QByteArray &cursor, const QString &header,
+                                           const std::shared_ptr<std::atomic_bool> &canRun, QObject *parent)
+    : QObject(parent)
+    , QRunnable()
+    , m_request(request)
+    , m_cursor(cursor)
+    , m_header(header)
+    , m_canRun(canRun)
+{
+    qRegisterMetaType<LogTextSourcePtr>("LogTextSourcePtr");
+    //使用线程池启动该线程，跑完自己删自己
+    setAutoDelete(true);
+}
+
+void LogCoredumpStackWork::run()
+{
+    const QString stack = LogCoredumpDetail().stack(m_cursor);
+    if (!*m_canRun)
+        return;
+    const LogTextSourcePtr source = buildSource(m_header, stack, *m_canRun);
+    if (source)
+        emit stackReady(m_request, m_cursor, source);
+}
+
+/**
+ * @brief LogCoredumpStackWork::buildSource 标题和堆栈之间空一行,转为UTF-8后建立行索引
+ * @return 内容,被取消时为空
+ */
+LogTextSourcePtr LogCoredumpStackWork::buildSource(const QString &header, const QString &stack, const std::atomic_bool &canRun)
+{
+    std::shared_ptr<LogTextSource> source = std::make_shared<LogTextSource>(QString());
+    source->setData(stack.isEmpty() ? header.toUtf8() : (header + "\n\n" + stack).toUtf8());
+    if (!source->buildIndex(canRun))
+        return LogTextSourcePtr();
+    return source;
+}
@@ -0,0 +1,53 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGCOREDUMPSTACKWORK_H
+#define LOGCOREDUMPSTACKWORK_H
+
+#include "logtextsource.h"
+
+#include <QByteArray>
+#include <QObject>
+#include <QRunnable>
+#include <QString>
+
+#include <atomic>
+#include <memory>
+
+//详情中最近查看过的堆栈保存的条数,来回点击时不再重新读取
+#define COREDUMP_STACK_CACHE_COUNT 8
+
+/**
+ * @brief The LogCoredumpStackWork class 在线程池中读取选中崩溃记录的堆栈信息,建立行索引后交给详情的分页显示控件
+ * 堆栈可能有几百KB,读取和分行都不在界面线程中进行;列表只保存游标,不保存堆栈文本
+ */
+class LogCoredumpStackWork : public QObject, public QRunnable
+{
+    Q_OBJECT
+
+public:
+    LogCoredumpStackWork(int request, const QByteArray &cursor, const QString &header,
+                         const std::shared_ptr<std::atomic_bool> &canRun, QObject *parent = nullptr);
+
+    void run() override;
+
+    static LogTextSourcePtr buildSource(const QString &header, const QString &stack, const std::atomic_bool &canRun);
+
+signals:
+    /**
+     * @brief stackReady 读取完成,被取消时不发出
+     * @param request 请求标号,旧请求的结果由接收方丢弃
+     * @param cursor 崩溃记录的journal条目游标
+     * @param source 标题和堆栈的内容
+     */
+    void stackReady(int request, QByteArray cursor, LogTextSourcePtr source);
+
+private:
+    int m_request;
+    QByteArray m_cursor;
+    QString m_header;
+    std::shared_ptr<std::atomic_bool> m_canRun;
+};
+
+#endif // LOGCOREDUMPSTACKWORK_H
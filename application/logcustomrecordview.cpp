@@ -0,0 +1,210 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logcustomrecordview.h"
+#include "loglevel.h"
+#include "logtablemodel.h"
+#include "logworkscheduler.h"
+#include "structdef.h"
+
+#include <DApplication>
+
+#include <QDateTime>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QVBoxLayout>
+
+namespace {
+QVariant recordDateTime(const LogCustomRecord &record, int role)
+{
+    if (role == LogTableModel::SortKeyRole)
+        return record.time;
+    return role == Qt::DisplayRole ? QVariant(record.dateTime) : QVariant();
+}
+
+QVariant recordLevel(const LogCustomRecord &record, int role)
+{
+    if (role == LogTableModel::SortKeyRole)
+        return record.level;
+    if (role != Qt::DisplayRole)
+        return QVariant();
+    //不认识的等级显示原文
+    return record.level >= 0 ? LogLevel::text(record.level) : record.columns.value(LogLineFormat::LevelColumn);
+}
+
+/**
+ * @brief recordText 字段和信息列,多行的信息在表格中只显示第一行,提示中显示全部
+ */
+QVariant recordText(const LogCustomRecord &record, int column, int role)
+{
+    const QString &text = record.columns.at(column);
+    if (role == Qt::ToolTipRole)
+        return text;
+    if (role != Qt::DisplayRole)
+        return QVariant();
+    const int newline = text.indexOf('\n');
+    return newline < 0 ? text : text.left(newline);
+}
+}
+
+/**
+ * @brief LogCustomRecordView::LogCustomRecordView 构造函数
+ * @param parent 父对象指针
+ */
+LogCustomRecordView::LogCustomRecordView(QWidget *parent)
+    : DWidget(parent)
+    , m_canRun(std::make_shared<std::atomic_bool>(false))
+{
+    m_pPeriodCbx = new DComboBox(this);
+    m_pPeriodCbx->setAccessibleName("custom_record_period_box");
+    m_pPeriodCbx->addItem(DApplication::translate("Button", "All"), ALL);
+    m_pPeriodCbx->addItem(DApplication::translate("Button", "Today"), ONE_DAY);
+    m_pPeriodCbx->addItem(DApplication::translate("Button", "3 days"), THREE_DAYS);
+    m_pPeriodCbx->addItem(DApplication::translate("Button", "1 week"), ONE_WEEK);
+    m_pPeriodCbx->addItem(DApplication::translate("Button", "1 month"), ONE_MONTH);
+    m_pPeriodCbx->addItem(DApplication::translate("Button", "3 months"), THREE_MONTHS);
+
+    m_pLevelCbx = new DComboBox(this);
+    m_pLevelCbx->setAccessibleName("custom_record_level_box");
+    m_pLevelCbx->addItem(DApplication::translate("ComboBox", "All"), LVALL);
+    const char *const levels[] = {"Emergency", "Alert", "Critical", "Error", "Warning", "Notice", "Info", "Debug"};
+    for (int i = 0; i < LogLevel::SyslogCount; ++i)
+        m_pLevelCbx->addItem(DApplication::translate("ComboBox", levels[i]), i);
+
+    m_pStatus = new DLabel(this);
+    m_pStatus->setAccessibleName("custom_record_status");
+
+    m_pView = new QTreeView(this);
+    m_pView->setAccessibleName("custom_record_view");
+    m_pView->setRootIsDecorated(false);
+    m_pView->setUniformRowHeights(true);
+    m_pView->setSortingEnabled(false);
+    m_pModel = new LogTableModel(this);
+    m_pView->setModel(m_pModel);
+
+    QHBoxLayout *pHLayout = new QHBoxLayout();
+    pHLayout->setContentsMargins(0, 0, 0, 0);
+    pHLayout->addWidget(m_pPeriodCbx);
+    pHLayout->addWidget(m_pLevelCbx);
+    pHLayout->addWidget(m_pStatus, 1);
+    QVBoxLayout *pVLayout = new QVBoxLayout(this);
+    pVLayout->setContentsMargins(0, 0, 0, 0);
+    pVLayout->addLayout(pHLayout);
+    pVLayout->addWidget(m_pView, 1);
+
+    connect(m_pPeriodCbx, QOverload<int>::of(&DComboBox::currentIndexChanged), this, &LogCustomRecordView::reload);
+    connect(m_pLevelCbx, QOverload<int>::of(&DComboBox::currentIndexChanged), this, &LogCustomRecordView::reload);
+}
+
+LogCustomRecordView::~LogCustomRecordView()
+{
+    //任务不持有控件,取消后迟到的信号随控件断开
+    cancel();
+}
+
+/**
+ * @brief LogCustomRecordView::load 按行格式读取文件,表格的列随格式变化
+ * @param filePath 日志文件路径
+ * @param format 编译好的行格式
+ */
+void LogCustomRecordView::load(const QString &filePath, const LogLineFormatPtr &format)
+{
+    m_filePath = filePath;
+    m_format = format;
+
+    QVector<LogTableModel::Column<LogCustomRecord>> columns {recordDateTime, recordLevel};
+    QStringList labels {DApplication::translate("Table", "Date and Time"), DApplication::translate("Table", "Level")};
+    for (int i = 0; i < format->fieldNames().size(); ++i) {
+        const int column = LogLineFormat::FirstFieldColumn + i;
+        columns.append([column](const LogCustomRecord &record, int role) {
+            return recordText(record, column, role);
+        });
+        labels.append(format->fieldNames().at(i));
+    }
+    const int messageColumn = format->messageColumn();
+    columns.append([messageColumn](const LogCustomRecord &record, int role) {
+        return recordText(record, messageColumn, role);
+    });
+    labels.append(DApplication::translate("Table", "Info"));
+    //格式不同时列数不同,按格式区分表格,切换文件时清空旧记录
+    m_pModel->setColumns<LogCustomRecord>("custom:" + format->spec(), columns);
+    m_pModel->setHorizontalHeaderLabels(labels);
+    m_pView->header()->setStretchLastSection(true);
+    reload();
+}
+
+/**
+ * @brief LogCustomRecordView::clear 停止读取并清空表格
+ */
+void LogCustomRecordView::clear()
+{
+    cancel();
+    m_pModel->removeRows(0, m_pModel->rowCount());
+    m_pStatus->clear();
+    m_filePath.clear();
+    m_format.reset();
+}
+
+void LogCustomRecordView::reload()
+{
+    cancel();
+    m_pModel->removeRows(0, m_pModel->rowCount());
+    if (!m_format)
+        return;
+
+    QDateTime dayStart = QDateTime::currentDateTime();
+    dayStart.setTime(QTime());
+    QDateTime dayEnd = dayStart;
+    dayEnd.setTime(QTime(23, 59, 59, 999));
+    QDateTime begin;
+    switch (m_pPeriodCbx->currentData().toInt()) {
+    case ONE_DAY:
+        begin = dayStart;
+        break;
+    case THREE_DAYS:
+        begin = dayStart.addDays(-2);
+        break;
+    case ONE_WEEK:
+        begin = dayStart.addDays(-6);
+        break;
+    case ONE_MONTH:
+        begin = dayStart.addMonths(-1);
+        break;
+    case THREE_MONTHS:
+        begin = dayStart.addMonths(-3);
+        break;
+    default:
+        break;
+    }
+
+    ++m_load;
+    m_canRun = std::make_shared<std::atomic_bool>(true);
+    LogCustomRecordWork *work = new LogCustomRecordWork(m_load, m_filePath, m_format, m_canRun);
+    if (begin.isValid())
+        work->setTimeRange(begin.toMSecsSinceEpoch(), dayEnd.toMSecsSinceEpoch());
+    work->setLevel(m_pLevelCbx->currentData().toInt());
+    connect(work, &LogCustomRecordWork::recordsReady, this, &LogCustomRecordView::onRecordsReady, Qt::QueuedConnection);
+    connect(work, &LogCustomRecordWork::finished, this, &LogCustomRecordView::onFinished, Qt::QueuedConnection);
+    m_pStatus->setText(DApplication::translate("Dialog", "Loading..."));
+    LogWorkScheduler::instance()->start(work, LogWorkScheduler::Interactive);
+}
+
+void LogCustomRecordView::cancel()
+{
+    *m_canRun = false;
+}
+
+void LogCustomRecordView::onRecordsReady(int load, QList<LogCustomRecord> records)
+{
+    if (load != m_load)
+        return;
+    m_pModel->appendRecords(records);
+}
+
+void LogCustomRecordView::onFinished(int load, int total)
+{
+    if (load != m_load)
+        return;
+    m_pStatus->setText(DApplication::translate("Dialog", "%1 results").arg(total));
+}
@@ -0,0 +1,59 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGCUSTOMRECORDVIEW_H
+#define LOGCUSTOMRECORDVIEW_H
+
+#include "logcustomrecordwork.h"
+#include "loglineformat.h"
+
+#include <DComboBox>
+#include <DLabel>
+#include <DWidget>
+
+#include <QTreeView>
+
+#include <atomic>
+#include <memory>
+
+DWIDGET_USE_NAMESPACE
+
+class LogTableModel;
+
+/**
+ * @brief The LogCustomRecordView class 声明了行格式的自定义日志的记录表格,显示在详情区域中代替原文
+ * 每个字段一列,按时间段和等级筛选;切换条件时取消上一次读取,在线程池中重新读取
+ */
+class LogCustomRecordView : public DWidget
+{
+    Q_OBJECT
+public:
+    explicit LogCustomRecordView(QWidget *parent = nullptr);
+    ~LogCustomRecordView() override;
+
+    void load(const QString &filePath, const LogLineFormatPtr &format);
+    void clear();
+
+private slots:
+    void onRecordsReady(int load, QList<LogCustomRecord> records);
+    void onFinished(int load, int total);
+
+private:
+    void reload();
+    void cancel();
+
+    DComboBox *m_pPeriodCbx;
+    DComboBox *m_pLevelCbx;
+    DLabel *m_pStatus;
+    QTreeView *m_pView;
+    LogTableModel *m_pModel;
+
+    QString m_filePath;
+    LogLineFormatPtr m_format;
+    std::shared_ptr<std::atomic_bool> m_canRun;
+    //加载标号,旧加载迟到的结果按标号丢弃
+    int m_load = 0;
+};
+
+#endif // LOGCUSTOMRECORDVIEW_H
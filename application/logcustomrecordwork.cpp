@@ -0,0 +1,103 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logcustomrecordwork.h"
+#include "journalreader.h"
+#include "logrecordreader.h"
+
+#include <QLoggingCategory>
+
+#ifdef QT_DEBUG
+Q_LOGGING_CATEGORY(logCustomRecord, "org.deepin.log.viewer.custom.record")
+#else
+Q_LOGGING_CATEGORY(logCustomRecord, "org.deepin.log.viewer.custom.record", QtInfoMsg)
+#endif
+
+/**
+ * @brief LogCustomRecordWork::LogCustomRecordWork 构造函数
+ * @param load 本次加载的标号
+ * @param filePath 日志文件路径
+ * @param format 编译好的行格式
+ * @param canRun 本次加载的取消标记
+ */
+LogCustomRecordWork::LogCustomRecordWork(int load, const QString &filePath, const LogLineFormatPtr &format,
+                                         const std::shared_ptr<std::atomic_bool> &canRun, QObject *parent)
+    : QObject(parent)
+    , QRunnable()
+    , m_load(load)
+    , m_filePath(filePath)
+    , m_format(format)
+    , m_canRun(canRun)
+{
+    qRegisterMetaType<QList<LogCustomRecord>>("QList<LogCustomRecord>");
+    //使用线程池启动该线程，跑完自己删自己
+    setAutoDelete(true);
+}
+
+/**
+ * @brief LogCustomRecordWork::setTimeRange 只读取时间段内的记录,两者都大于0时生效;没有时间的记录总是保留
+ */
+void LogCustomRecordWork::setTimeRange(qint64 begin, qint64 end)
+{
+    m_filter.timeBegin = begin;
+    m_filter.timeEnd = end;
+}
+
+/**
+ * @brief LogCustomRecordWork::matchesLevel 记录的等级是否满足筛选,和系统日志一致保留该等级及更严重的记录
+ * @param level 筛选的等级,小于0时不筛选;筛选时没有等级的记录不保留
+ */
+bool LogCustomRecordWork::matchesLevel(int recordLevel, int level)
+{
+    return level < 0 || (recordLevel >= 0 && recordLevel <= level);
+}
+
+void LogCustomRecordWork::run()
+{
+    m_timer.start();
+    LogRecordReader reader(m_filePath, m_format);
+    reader.setFilter(m_filter);
+    reader.setParseThreads(LogRecordReader::parseThreadsFor(1));
+    //同一天的记录只格式化一次日期
+    JournalTimeFormatter formatter;
+    const bool completed = reader.read(*m_canRun, [this, &formatter](qint64 time, const QStringList &columns) {
+        LogCustomRecord record;
+        record.level = LogLineFormat::levelOf(QStringRef(&columns.at(LogLineFormat::LevelColumn)));
+        if (!matchesLevel(record.level, m_level))
+            return bool(*m_canRun);
+        record.time = time;
+        record.dateTime = time >= 0 ? formatter.formatSecs(time / 1000) : columns.at(LogLineFormat::TimeColumn);
+        record.columns = columns;
+        return addRecord(record);
+    });
+    if (!*m_canRun)
+        return;
+    flush();
+    qCDebug(logCustomRecord) << "read" << m_filePath << "records" << m_total << "completed" << completed;
+    emit finished(m_load, m_total);
+}
+
+/**
+ * @brief LogCustomRecordWork::addRecord 记下一条记录,攒够一批或超过间隔时发出
+ * @return false表示已被取消,应停止读取
+ */
+bool LogCustomRecordWork::addRecord(const LogCustomRecord &record)
+{
+    if (!*m_canRun)
+        return false;
+    m_batch.append(record);
+    ++m_total;
+    if (m_batch.size() >= LOG_CUSTOM_RECORD_BATCH_COUNT || m_timer.elapsed() >= LOG_CUSTOM_RECORD_BATCH_INTERVAL)
+        flush();
+    return true;
+}
+
+void LogCustomRecordWork::flush()
+{
+    if (m_batch.isEmpty() || !*m_canRun)
+        return;
+    emit recordsReady(m_load, m_batch);
+    m_batch.clear();
+    m_timer.restart();
+}
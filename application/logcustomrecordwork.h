@@ -0,0 +1,86 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGCUSTOMRECORDWORK_H
+#define LOGCUSTOMRECORDWORK_H
+
+#include "loglinefilter.h"
+#include "loglineformat.h"
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QMetaType>
+#include <QObject>
+#include <QRunnable>
+#include <QString>
+#include <QStringList>
+
+#include <atomic>
+#include <memory>
+
+//攒够这么多条记录或距上次发出超过这么长时间(毫秒)就发出一批
+#define LOG_CUSTOM_RECORD_BATCH_COUNT 1000
+#define LOG_CUSTOM_RECORD_BATCH_INTERVAL 200
+
+/**
+ * @brief The LogCustomRecord struct 按声明的行格式解析出的一条自定义日志记录
+ */
+struct LogCustomRecord {
+    //毫秒时间戳,格式中没有时间时为-1
+    qint64 time = -1;
+    //等级,为PRIORITY的值,没有或不认识时为-1
+    int level = -1;
+    QString dateTime;
+    //各列文字,见LogLineFormat::Column
+    QStringList columns;
+};
+Q_DECLARE_METATYPE(LogCustomRecord)
+
+/**
+ * @brief The LogCustomRecordWork class 在线程池中按声明的行格式读取一个自定义日志,分批发出记录
+ * 时间段交给LogRecordReader按时间索引定位并在解析线程中先取时间跳过,等级在拆分字段后按数字比较
+ */
+class LogCustomRecordWork : public QObject, public QRunnable
+{
+    Q_OBJECT
+
+public:
+    LogCustomRecordWork(int load, const QString &filePath, const LogLineFormatPtr &format,
+                        const std::shared_ptr<std::atomic_bool> &canRun, QObject *parent = nullptr);
+
+    void setTimeRange(qint64 begin, qint64 end);
+    void setLevel(int level) { m_level = level; }
+    void run() override;
+
+    static bool matchesLevel(int recordLevel, int level);
+
+signals:
+    /**
+     * @brief recordsReady 一批记录,按从新到旧的顺序
+     * @param load 加载标号,旧加载的结果由接收方丢弃
+     */
+    void recordsReady(int load, QList<LogCustomRecord> records);
+    /**
+     * @brief finished 读取结束,被取消时不发出
+     * @param total 满足条件的记录数
+     */
+    void finished(int load, int total);
+
+private:
+    bool addRecord(const LogCustomRecord &record);
+    void flush();
+
+    int m_load;
+    QString m_filePath;
+    LogLineFormatPtr m_format;
+    std::shared_ptr<std::atomic_bool> m_canRun;
+    LogLineFilter m_filter;
+    //只保留等级数字不大于它的记录,小于0时不筛选
+    int m_level = -1;
+    int m_total = 0;
+    QList<LogCustomRecord> m_batch;
+    QElapsedTimer m_timer;
+};
+
+#endif // LOGCUSTOMRECORDWORK_H
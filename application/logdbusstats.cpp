@@ -0,0 +1,294 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logdbusstats.h"
+#include "logingestmetrics.h"
+#include "logtracer.h"
+
+#include <QDateTime>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLoggingCategory>
+#include <QStringList>
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#ifdef QT_DEBUG
+Q_LOGGING_CATEGORY(logDBusStats, "org.deepin.log.viewer.dbus.stats")
+#else
+Q_LOGGING_CATEGORY(logDBusStats, "org.deepin.log.viewer.dbus.stats", QtInfoMsg)
+#endif
+
+namespace {
+qint64 initialSlowThreshold()
+{
+    bool ok = false;
+    const qint64 ms = qgetenv(LOG_DBUS_SLOW_ENV).toLongLong(&ok);
+    return ok && ms >= 0 ? ms : -1;
+}
+
+//慢调用的阈值,毫秒,-1时不输出
+std::atomic<qint64> s_slowThresholdMs {initialSlowThreshold()};
+
+/**
+ * @brief registry 各接口的统计项,只增加不删除,PERF_DBUS_CALL缓存的指针一直有效
+ */
+std::mutex &registryMutex()
+{
+    static std::mutex mutex;
+    return mutex;
+}
+
+std::vector<std::unique_ptr<LogDBusMethodStats>> &registry()
+{
+    static std::vector<std::unique_ptr<LogDBusMethodStats>> methods;
+    return methods;
+}
+
+QJsonObject histogramJson(const QVector<quint64> &buckets, quint64 sum, quint64 max)
+{
+    //末尾的空桶不输出
+    int used = buckets.size();
+    while (used > 0 && buckets.at(used - 1) == 0)
+        --used;
+    QJsonArray counts;
+    for (int i = 0; i < used; ++i)
+        counts.append(static_cast<double>(buckets.at(i)));
+    QJsonObject obj;
+    obj.insert("sum", static_cast<double>(sum));
+    obj.insert("max", static_cast<double>(max));
+    obj.insert("p50", static_cast<double>(LogDBusHistogram::quantile(buckets, 0.5)));
+    obj.insert("p95", static_cast<double>(LogDBusHistogram::quantile(buckets, 0.95)));
+    obj.insert("p99", static_cast<double>(LogDBusHistogram::quantile(buckets, 0.99)));
+    obj.insert("buckets", counts);
+    return obj;
+}
+}
+
+void LogDBusHistogram::add(quint64 value)
+{
+    m_buckets[bucketOf(value)].fetch_add(1, std::memory_order_relaxed);
+    m_sum.fetch_add(value, std::memory_order_relaxed);
+    quint64 max = m_max.load(std::memory_order_relaxed);
+    while (value > max && !m_max.compare_exchange_weak(max, value, std::memory_order_relaxed)) {
+    }
+}
+
+void LogDBusHistogram::reset()
+{
+    for (std::atomic<quint64> &bucket : m_buckets)
+        bucket.store(0, std::memory_order_relaxed);
+    m_sum.store(0, std::memory_order_relaxed);
+    m_max.store(0, std::memory_order_relaxed);
+}
+
+QVector<quint64> LogDBusHistogram::buckets() const
+{
+    QVector<quint64> counts(LOG_DBUS_HISTOGRAM_BUCKETS);
+    for (int i = 0; i < LOG_DBUS_HISTOGRAM_BUCKETS; ++i)
+        counts[i] = m_buckets[i].load(std::memory_order_relaxed);
+    return counts;
+}
+
+/**
+ * @brief LogDBusHistogram::bucketOf 值所在的桶,0在第0个桶,[2^(i-1), 2^i)在第i个桶
+ */
+int LogDBusHistogram::bucketOf(quint64 value)
+{
+    if (value == 0)
+        return 0;
+    const int bits = 64 - __builtin_clzll(value);
+    return qMin(bits, LOG_DBUS_HISTOGRAM_BUCKETS - 1);
+}
+
+/**
+ * @brief LogDBusHistogram::bucketUpper 桶中的最大值,最后一个桶为其下界之后同样宽度的上界
+ */
+quint64 LogDBusHistogram::bucketUpper(int bucket)
+{
+    return bucket <= 0 ? 0 : (quint64(1) << bucket) - 1;
+}
+
+/**
+ * @brief LogDBusHistogram::quantile 分位数的近似值,取所在桶的上界,没有数据时为0
+ * @param q 0到1之间的分位
+ */
+quint64 LogDBusHistogram::quantile(const QVector<quint64> &buckets, double q)
+{
+    quint64 total = 0;
+    for (quint64 count : buckets)
+        total += count;
+    if (total == 0)
+        return 0;
+    const quint64 rank = qMax<quint64>(1, static_cast<quint64>(qBound(0.0, q, 1.0) * total + 0.999999));
+    quint64 seen = 0;
+    for (int i = 0; i < buckets.size(); ++i) {
+        seen += buckets.at(i);
+        if (seen >= rank)
+            return bucketUpper(i);
+    }
+    return bucketUpper(buckets.size() - 1);
+}
+
+/**
+ * @brief LogDBusStats::method 取得接口的统计项,第一次使用时创建
+ * @param name 接口名
+ */
+LogDBusMethodStats *LogDBusStats::method(const char *name)
+{
+    const QString method = QString::fromLatin1(name);
+    std::lock_guard<std::mutex> locker(registryMutex());
+    for (const std::unique_ptr<LogDBusMethodStats> &stats : registry()) {
+        if (stats->method == method)
+            return stats.get();
+    }
+    registry().emplace_back(new LogDBusMethodStats);
+    registry().back()->method = method;
+    return registry().back().get();
+}
+
+/**
+ * @brief LogDBusStats::snapshot 各接口当前的统计,只包括调用过的接口,按接口名排序
+ */
+QList<LogDBusMethodSnapshot> LogDBusStats::snapshot()
+{
+    QList<LogDBusMethodSnapshot> methods;
+    {
+        std::lock_guard<std::mutex> locker(registryMutex());
+        for (const std::unique_ptr<LogDBusMethodStats> &stats : registry()) {
+            LogDBusMethodSnapshot item;
+            item.method = stats->method;
+            item.calls = stats->calls.load(std::memory_order_relaxed);
+            if (item.calls == 0)
+                continue;
+            item.slowCalls = stats->slowCalls.load(std::memory_order_relaxed);
+            item.latencyBuckets = stats->latency.buckets();
+            item.latencySumUs = stats->latency.sum();
+            item.latencyMaxUs = stats->latency.max();
+            item.payloadBuckets = stats->payload.buckets();
+            item.payloadSum = stats->payload.sum();
+            item.payloadMax = stats->payload.max();
+            methods.append(item);
+        }
+    }
+    std::sort(methods.begin(), methods.end(), [](const LogDBusMethodSnapshot &a, const LogDBusMethodSnapshot &b) {
+        return a.method < b.method;
+    });
+    return methods;
+}
+
+/**
+ * @brief LogDBusStats::reset 清零所有接口的统计,统计项保留
+ */
+void LogDBusStats::reset()
+{
+    std::lock_guard<std::mutex> locker(registryMutex());
+    for (const std::unique_ptr<LogDBusMethodStats> &stats : registry()) {
+        stats->calls.store(0, std::memory_order_relaxed);
+        stats->slowCalls.store(0, std::memory_order_relaxed);
+        stats->latency.reset();
+        stats->payload.reset();
+    }
+}
+
+qint64 LogDBusStats::slowThresholdMs()
+{
+    return s_slowThresholdMs.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief LogDBusStats::setSlowThresholdMs 设置慢调用的阈值,小于0时不输出慢调用
+ */
+void LogDBusStats::setSlowThresholdMs(qint64 ms)
+{
+    s_slowThresholdMs.store(ms < 0 ? -1 : ms, std::memory_order_relaxed);
+}
+
+/**
+ * @brief LogDBusStats::format 每个接口一行key=value格式的统计,便于在日志中按字段检索
+ */
+QString LogDBusStats::format(const QList<LogDBusMethodSnapshot> &methods)
+{
+    QStringList lines;
+    for (const LogDBusMethodSnapshot &item : methods) {
+        lines << QString("dbus method=%1 calls=%2 slow=%3 sumUs=%4 p50Us=%5 p95Us=%6 p99Us=%7 maxUs=%8 payloadSum=%9 payloadP50=%10 payloadP95=%11 payloadMax=%12")
+                     .arg(item.method)
+                     .arg(item.calls)
+                     .arg(item.slowCalls)
+                     .arg(item.latencySumUs)
+                     .arg(item.latencyQuantileUs(0.5))
+                     .arg(item.latencyQuantileUs(0.95))
+                     .arg(item.latencyQuantileUs(0.99))
+                     .arg(item.latencyMaxUs)
+                     .arg(item.payloadSum)
+                     .arg(item.payloadQuantile(0.5))
+                     .arg(item.payloadQuantile(0.95))
+                     .arg(item.payloadMax);
+    }
+    return lines.join('\n');
+}
+
+QByteArray LogDBusStats::toJson(const QList<LogDBusMethodSnapshot> &methods)
+{
+    QJsonArray array;
+    for (const LogDBusMethodSnapshot &item : methods) {
+        QJsonObject obj;
+        obj.insert("method", item.method);
+        obj.insert("calls", static_cast<double>(item.calls));
+        obj.insert("slowCalls", static_cast<double>(item.slowCalls));
+        obj.insert("latencyUs", histogramJson(item.latencyBuckets, item.latencySumUs, item.latencyMaxUs));
+        obj.insert("payloadBytes", histogramJson(item.payloadBuckets, item.payloadSum, item.payloadMax));
+        array.append(obj);
+    }
+    QJsonObject root;
+    root.insert("time", QDateTime::currentDateTime().toString(Qt::ISODateWithMs));
+    root.insert("dbus", array);
+    return QJsonDocument(root).toJson(QJsonDocument::Compact);
+}
+
+/**
+ * @brief LogDBusStats::appendMetricsFile 指标文件中追加一行当前的总线统计,和加载指标写在同一个文件中
+ * @param path 文件路径,为空时使用DEEPIN_LOG_VIEWER_METRICS指定的路径,都没有或还没有调用过服务时不写入
+ */
+bool LogDBusStats::appendMetricsFile(const QString &path)
+{
+    const QString outPath = path.isEmpty() ? LogIngestMetrics::metricsPath() : path;
+    if (outPath.isEmpty())
+        return false;
+    const QList<LogDBusMethodSnapshot> methods = snapshot();
+    if (methods.isEmpty())
+        return false;
+    QFile file(outPath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        qCWarning(logDBusStats) << "open metrics file failed:" << outPath;
+        return false;
+    }
+    return file.write(toJson(methods) + '\n') > 0;
+}
+
+LogDBusCallScope::LogDBusCallScope(LogDBusMethodStats *method, const QString &arg)
+    : m_method(method)
+    , m_arg(arg)
+    , m_begin(LogTracer::now())
+{
+}
+
+LogDBusCallScope::~LogDBusCallScope()
+{
+    const qint64 us = qMax<qint64>(0, LogTracer::now() - m_begin);
+    m_method->calls.fetch_add(1, std::memory_order_relaxed);
+    m_method->latency.add(static_cast<quint64>(us));
+    m_method->payload.add(static_cast<quint64>(qMax<qint64>(0, m_payload)));
+    const qint64 slowMs = LogDBusStats::slowThresholdMs();
+    if (slowMs >= 0 && us >= slowMs * 1000) {
+        m_method->slowCalls.fetch_add(1, std::memory_order_relaxed);
+        qCWarning(logDBusStats).noquote() << QString("slow dbus call method=%1 ms=%2 payload=%3 arg=%4")
+                                             .arg(m_method->method).arg(us / 1000).arg(m_payload).arg(m_arg);
+    }
+}
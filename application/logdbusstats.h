@@ -0,0 +1,122 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGDBUSSTATS_H
+#define LOGDBUSSTATS_H
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+#include <QVector>
+
+#include <atomic>
+
+//环境变量,值为慢调用的阈值(毫秒),设置后超过阈值的总线调用输出一条警告
+#define LOG_DBUS_SLOW_ENV "DEEPIN_LOG_VIEWER_DBUS_SLOW_MS"
+//直方图的桶数,第i个桶为[2^(i-1), 2^i),最后一个桶包含更大的值
+#define LOG_DBUS_HISTOGRAM_BUCKETS 32
+
+#define LOG_DBUS_CONCAT_IMPL(a, b) a##b
+#define LOG_DBUS_CONCAT(a, b) LOG_DBUS_CONCAT_IMPL(a, b)
+/**
+ * @brief PERF_DBUS_CALL 统计当前作用域中一次总线调用的耗时,var为作用域对象的变量名,用于设置回复大小;
+ * name必须是字符串常量,每个调用位置只在第一次执行时查找一次统计项
+ */
+#define PERF_DBUS_CALL(var, name, arg) \
+    static LogDBusMethodStats *const LOG_DBUS_CONCAT(logDBusMethod, __LINE__) = LogDBusStats::method(name); \
+    LogDBusCallScope var(LOG_DBUS_CONCAT(logDBusMethod, __LINE__), arg)
+
+/**
+ * @brief The LogDBusHistogram class 按2的幂分桶的无锁直方图,多个线程可以同时累加
+ */
+class LogDBusHistogram
+{
+public:
+    void add(quint64 value);
+    void reset();
+    QVector<quint64> buckets() const;
+    quint64 sum() const { return m_sum.load(std::memory_order_relaxed); }
+    quint64 max() const { return m_max.load(std::memory_order_relaxed); }
+
+    static int bucketOf(quint64 value);
+    static quint64 bucketUpper(int bucket);
+    static quint64 quantile(const QVector<quint64> &buckets, double q);
+
+private:
+    std::atomic<quint64> m_buckets[LOG_DBUS_HISTOGRAM_BUCKETS] {};
+    std::atomic<quint64> m_sum {0};
+    std::atomic<quint64> m_max {0};
+};
+
+/**
+ * @brief The LogDBusMethodStats struct 一个服务接口的累计统计,耗时单位为微秒,回复大小单位为字节
+ */
+struct LogDBusMethodStats {
+    QString method;
+    std::atomic<quint64> calls {0};
+    std::atomic<quint64> slowCalls {0};
+    LogDBusHistogram latency;
+    LogDBusHistogram payload;
+};
+
+/**
+ * @brief The LogDBusMethodSnapshot struct 某一时刻一个接口的统计,桶的含义见LogDBusHistogram
+ */
+struct LogDBusMethodSnapshot {
+    QString method;
+    quint64 calls = 0;
+    quint64 slowCalls = 0;
+    QVector<quint64> latencyBuckets;
+    quint64 latencySumUs = 0;
+    quint64 latencyMaxUs = 0;
+    QVector<quint64> payloadBuckets;
+    quint64 payloadSum = 0;
+    quint64 payloadMax = 0;
+
+    quint64 latencyQuantileUs(double q) const { return LogDBusHistogram::quantile(latencyBuckets, q); }
+    quint64 payloadQuantile(double q) const { return LogDBusHistogram::quantile(payloadBuckets, q); }
+};
+
+/**
+ * @brief The LogDBusStats class DLDBusHandler各接口的调用耗时和回复大小的直方图,进程内从启动开始累计
+ * 耗时包括等待服务排队、服务处理和总线传输,和本地解析的耗时对照,可以看出类别加载慢在总线还是服务;
+ * 加载结束时写入DEEPIN_LOG_VIEWER_METRICS指定的指标文件,设置DEEPIN_LOG_VIEWER_DBUS_SLOW_MS时逐个输出慢调用
+ */
+class LogDBusStats
+{
+public:
+    static LogDBusMethodStats *method(const char *name);
+    static QList<LogDBusMethodSnapshot> snapshot();
+    static void reset();
+
+    static qint64 slowThresholdMs();
+    static void setSlowThresholdMs(qint64 ms);
+
+    static QString format(const QList<LogDBusMethodSnapshot> &methods);
+    static QByteArray toJson(const QList<LogDBusMethodSnapshot> &methods);
+    static bool appendMetricsFile(const QString &path = QString());
+};
+
+/**
+ * @brief The LogDBusCallScope class 构造时开始计时,析构时把耗时和回复大小计入接口的统计
+ */
+class LogDBusCallScope
+{
+public:
+    LogDBusCallScope(LogDBusMethodStats *method, const QString &arg = QString());
+    ~LogDBusCallScope();
+    LogDBusCallScope(const LogDBusCallScope &) = delete;
+    LogDBusCallScope &operator=(const LogDBusCallScope &) = delete;
+
+    void setPayload(qint64 bytes) { m_payload = bytes; }
+
+private:
+    LogDBusMethodStats *m_method;
+    //慢调用的日志中说明调用的对象,如文件路径
+    QString m_arg;
+    qint64 m_payload = 0;
+    qint64 m_begin;
+};
+
+#endif // LOGDBUSSTATS_H
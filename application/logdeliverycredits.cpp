@@ -0,0 +1,76 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logdeliverycredits.h"
+
+#include <QElapsedTimer>
+#include <QLoggingCategory>
+
+#ifdef QT_DEBUG
+Q_LOGGING_CATEGORY(logDelivery, "org.deepin.log.viewer.delivery")
+#else
+Q_LOGGING_CATEGORY(logDelivery, "org.deepin.log.viewer.delivery", QtInfoMsg)
+#endif
+
+//等待额度时定时醒来检查是否被停止,毫秒
+#define LOG_DELIVERY_POLL_MSEC 50
+
+LogDeliveryCredits::LogDeliveryCredits(int credits)
+    : m_available(qMax(1, credits))
+{
+}
+
+/**
+ * @brief LogDeliveryCredits::acquire 取得一个额度,没有额度时等待界面归还
+ * 超时或被停止时也扣除额度,对应的数据仍会发出并由界面归还,额度保持平衡
+ * @param canRun 获取线程是否继续
+ * @param timeoutMsec 最长等待时间
+ * @return 在超时前取得额度返回true
+ */
+bool LogDeliveryCredits::acquire(const std::atomic_bool &canRun, int timeoutMsec)
+{
+    QMutexLocker locker(&m_mutex);
+    QElapsedTimer timer;
+    timer.start();
+    bool timedOut = false;
+    while (m_available <= 0 && !m_aborted && canRun) {
+        if (timer.elapsed() >= timeoutMsec) {
+            timedOut = true;
+            break;
+        }
+        m_released.wait(&m_mutex, LOG_DELIVERY_POLL_MSEC);
+    }
+    if (m_aborted)
+        return false;
+    --m_available;
+    if (timedOut)
+        qCDebug(logDelivery) << "delivery credit wait timed out after" << timeoutMsec << "ms";
+    return !timedOut && canRun;
+}
+
+/**
+ * @brief LogDeliveryCredits::release 界面处理完一批数据后归还额度
+ */
+void LogDeliveryCredits::release()
+{
+    QMutexLocker locker(&m_mutex);
+    ++m_available;
+    m_released.wakeOne();
+}
+
+/**
+ * @brief LogDeliveryCredits::abort 加载被停止或替换时唤醒等待的线程,之后不再等待
+ */
+void LogDeliveryCredits::abort()
+{
+    QMutexLocker locker(&m_mutex);
+    m_aborted = true;
+    m_released.wakeAll();
+}
+
+int LogDeliveryCredits::available() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_available;
+}
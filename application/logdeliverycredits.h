@@ -0,0 +1,45 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGDELIVERYCREDITS_H
+#define LOGDELIVERYCREDITS_H
+
+#include <QMutex>
+#include <QWaitCondition>
+
+#include <atomic>
+#include <memory>
+
+//已发出、界面还没有处理的数据批次上限
+#define LOG_DELIVERY_CREDITS 4
+//等待界面处理的最长时间,毫秒,超时后仍然发出,界面卡住时不阻塞加载线程
+#define LOG_DELIVERY_WAIT_MSEC 2000
+
+/**
+ * @brief The LogDeliveryCredits class 获取线程和界面之间的发送额度
+ * 获取线程发出一批数据前取得额度,界面的数据槽函数处理时归还;界面插入慢时获取线程随之等待,
+ * 不在事件队列中堆积大量排队的列表拷贝
+ */
+class LogDeliveryCredits
+{
+public:
+    explicit LogDeliveryCredits(int credits = LOG_DELIVERY_CREDITS);
+
+    bool acquire(const std::atomic_bool &canRun, int timeoutMsec = LOG_DELIVERY_WAIT_MSEC);
+    void release();
+    void abort();
+    int available() const;
+
+private:
+    Q_DISABLE_COPY(LogDeliveryCredits)
+
+    mutable QMutex m_mutex;
+    QWaitCondition m_released;
+    int m_available;
+    bool m_aborted = false;
+};
+
+typedef std::shared_ptr<LogDeliveryCredits> LogDeliveryCreditsPtr;
+
+#endif // LOGDELIVERYCREDITS_H
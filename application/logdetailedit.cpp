@@ -3,6 +3,9 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "logdetailedit.h"
+#include "logsearchhits.h"
+
+#include <DApplicationHelper>
 
 #include <QAbstractTextDocumentLayout>
 #include <QTextDocumentFragment>
@@ -21,6 +24,32 @@ logDetailEdit::logDetailEdit(QWidget *parent)
     connect(this, &logDetailEdit::selectionChanged, this, &logDetailEdit::onSelectionArea);
 }
 
+/**
+ * @brief logDetailEdit::setSearchHits 高亮搜索关键字,位置由搜索线程记下,这里不再匹配文字
+ * 需要在设置文字之后调用,超出当前文字的部分忽略
+ * @param hits 纯文本中的位置和长度,两两一组,为空时清除高亮
+ */
+void logDetailEdit::setSearchHits(const QVector<int> &hits)
+{
+    QList<QTextEdit::ExtraSelection> selections;
+    const int size = document()->characterCount() - 1;
+    QColor color = DApplicationHelper::instance()->palette(this).color(DPalette::Highlight);
+    color.setAlpha(SEARCH_HIT_ALPHA);
+    for (int i = 0; i + 1 < hits.size(); i += 2) {
+        const int begin = hits.at(i);
+        const int end = qMin(size, begin + hits.at(i + 1));
+        if (begin >= end)
+            continue;
+        QTextEdit::ExtraSelection selection;
+        selection.cursor = QTextCursor(document());
+        selection.cursor.setPosition(begin);
+        selection.cursor.setPosition(end, QTextCursor::KeepAnchor);
+        selection.format.setBackground(color);
+        selections.append(selection);
+    }
+    setExtraSelections(selections);
+}
+
 /**
  * @brief logDetailEdit::onSelectionArea 选中文字
  */
@@ -134,6 +134,7 @@ class logDetailEdit : public DTextBrowser
     Q_OBJECT
 public:
     explicit logDetailEdit(QWidget *parent = nullptr);
+    void setSearchHits(const QVector<int> &hits);
 
     // QObject interface
 public:
@@ -18,8 +18,12 @@
 #include <QTreeView>
 #include <QVBoxLayout>
 #include <QPainterPath>
+#include <QTextDocument>
 
 #include "structdef.h"
+#include "logtablemodel.h"
+#include "logcustomrecordview.h"
+#include "logauditparser.h"
 #include <sys/utsname.h>
 
 DWIDGET_USE_NAMESPACE
@@ -46,29 +50,30 @@ void logDetailInfoWidget::cleanText()
 {
     m_dateTime->hide();
 
-    m_userName->hide();
-    m_userLabel->hide();
-
-    m_pid->hide();
-    m_pidLabel->hide();
-
-    m_action->hide();
-    m_actionLabel->hide();
-
-    m_status->hide();
-    m_statusLabel->hide();
+    hideField(m_userLabel, m_userName);
+    hideField(m_pidLabel, m_pid);
+    hideField(m_actionLabel, m_action);
+    hideField(m_statusLabel, m_status);
 
     m_level->hide();
 
     m_daemonName->hide();
 
     m_textBrowser->clear();
+    m_textBrowser->setSearchHits(QVector<int>());
+
+    if (m_oocView) {
+        m_oocView->clear();
+        m_oocView->hide();
+    }
+    if (m_customView) {
+        m_customView->clear();
+        m_customView->hide();
+    }
 
     // add by Airy
-    m_name->hide();
-    m_nameLabel->hide();
-    m_event->hide();
-    m_eventLabel->hide();
+    hideField(m_nameLabel, m_name);
+    hideField(m_eventLabel, m_event);
 
     m_errorLabel->hide();
 }
@@ -100,73 +105,15 @@ void logDetailInfoWidget::initUI()
     pa.setBrush(DPalette::WindowText, pa.color(DPalette::TextTips));
     DApplicationHelper::instance()->setPalette(m_dateTime, pa);
 
-    m_userName = new DLabel(this);
-    DFontSizeManager::instance()->bind(m_userName, DFontSizeManager::T8);
-    m_userName->setMinimumWidth(LABEL_MIN_WIDTH);
-    pa = DApplicationHelper::instance()->palette(m_userName);
-    pa.setBrush(DPalette::WindowText, pa.color(DPalette::TextTips));
-    DApplicationHelper::instance()->setPalette(m_userName, pa);
-
-    m_pid = new DLabel(this);
-    DFontSizeManager::instance()->bind(m_pid, DFontSizeManager::T8);
-    m_pid->setMinimumWidth(LABEL_MIN_WIDTH);
-    pa = DApplicationHelper::instance()->palette(m_pid);
-    pa.setBrush(DPalette::WindowText, pa.color(DPalette::TextTips));
-    DApplicationHelper::instance()->setPalette(m_pid, pa);
-
-    m_action = new DLabel(this);
-    DFontSizeManager::instance()->bind(m_action, DFontSizeManager::T8);
-    m_action->setMinimumWidth(LABEL_MIN_WIDTH);
-    pa = DApplicationHelper::instance()->palette(m_action);
-    pa.setBrush(DPalette::WindowText, pa.color(DPalette::TextTips));
-    DApplicationHelper::instance()->setPalette(m_action, pa);
-
-    m_status = new DLabel(this);
-    DFontSizeManager::instance()->bind(m_status, DFontSizeManager::T8);
-    m_status->setMinimumWidth(LABEL_MIN_WIDTH);
-    pa = DApplicationHelper::instance()->palette(m_status);
-    pa.setBrush(DPalette::WindowText, pa.color(DPalette::TextTips));
-    DApplicationHelper::instance()->setPalette(m_status, pa);
-
     m_level = new LogIconButton(this);
     DFontSizeManager::instance()->bind(m_level, DFontSizeManager::T8);
     pa = DApplicationHelper::instance()->palette(m_level);
     pa.setBrush(DPalette::ButtonText, pa.color(DPalette::TextTips));
     DApplicationHelper::instance()->setPalette(m_level, pa);
 
-    // add by Airy
-    m_event = new DLabel(this);
-    DFontSizeManager::instance()->bind(m_event, DFontSizeManager::T8);
-    m_event->setMinimumWidth(LABEL_MIN_WIDTH);
-    pa = DApplicationHelper::instance()->palette(m_event);
-    pa.setBrush(DPalette::WindowText, pa.color(DPalette::TextTips));
-    DApplicationHelper::instance()->setPalette(m_event, pa);
-
-    m_name = new DLabel(this);
-    DFontSizeManager::instance()->bind(m_name, DFontSizeManager::T8);
-    m_name->setMinimumWidth(LABEL_MIN_WIDTH);
-    pa = DApplicationHelper::instance()->palette(m_name);
-    pa.setBrush(DPalette::WindowText, pa.color(DPalette::TextTips));
-    DApplicationHelper::instance()->setPalette(m_name, pa);  // end
-
-    m_userLabel = new DLabel(DApplication::translate("Label", "User:"), this);
-    DFontSizeManager::instance()->bind(m_userLabel, DFontSizeManager::T7);
-    m_pidLabel = new DLabel(DApplication::translate("Label", "PID:"), this);
-    DFontSizeManager::instance()->bind(m_pidLabel, DFontSizeManager::T7);
-    m_statusLabel = new DLabel(DApplication::translate("Label", "Status:"), this);
-    DFontSizeManager::instance()->bind(m_statusLabel, DFontSizeManager::T7);
-    m_actionLabel = new DLabel(DApplication::translate("Label", "Action:"), this);
-    DFontSizeManager::instance()->bind(m_actionLabel, DFontSizeManager::T7);
-    m_eventLabel =
-        new DLabel(DApplication::translate("Label", "Event Type:"), this);          // add by Airy
-    DFontSizeManager::instance()->bind(m_eventLabel, DFontSizeManager::T7);
-    m_nameLabel = new DLabel(DApplication::translate("Label", "Username:"), this);  // add by Airy
-    DFontSizeManager::instance()->bind(m_nameLabel, DFontSizeManager::T7);
-
     m_errorLabel = new DLabel("", this);
     m_errorLabel->setMinimumWidth(70);
     m_errorLabel->setMinimumHeight(20);
-    DFontSizeManager::instance()->bind(m_userLabel, DFontSizeManager::T7);
     pa = DApplicationHelper::instance()->palette(m_errorLabel);
     // pa.setBrush(DPalette::WindowText, QColor(85,85,85,0.40));
     pa.setBrush(DPalette::WindowText, pa.color(DPalette::PlaceholderText));
@@ -194,42 +141,28 @@ void logDetailInfoWidget::initUI()
 
     QHBoxLayout *h2 = new QHBoxLayout();
 
-    QHBoxLayout *h21 = new QHBoxLayout();
-    h21->addWidget(m_userLabel);
-    h21->addWidget(m_userName, 1);
-    h21->setSpacing(0);
-    QHBoxLayout *h22 = new QHBoxLayout();
-    h22->addWidget(m_pidLabel);
-    h22->addWidget(m_pid, 1);
-    h22->setSpacing(0);
-    QHBoxLayout *h23 = new QHBoxLayout();
-    h23->addWidget(m_statusLabel);
-    h23->addWidget(m_status, 1);
-    h23->setSpacing(0);
-    QHBoxLayout *h24 = new QHBoxLayout();
-    h24->addWidget(m_actionLabel);
-    h24->addWidget(m_action, 1);
-    h24->setSpacing(0);
-
+    //各字段的标题和值控件在第一次有内容时才创建,见setField
+    m_userLayout = new QHBoxLayout();
+    m_userLayout->setSpacing(0);
+    m_pidLayout = new QHBoxLayout();
+    m_pidLayout->setSpacing(0);
+    m_statusLayout = new QHBoxLayout();
+    m_statusLayout->setSpacing(0);
+    m_actionLayout = new QHBoxLayout();
+    m_actionLayout->setSpacing(0);
     // add by Airy
-    QHBoxLayout *h25 = new QHBoxLayout();
-    h25->addWidget(m_eventLabel);
-    h25->addWidget(m_event, 1);
-    h25->setSpacing(8);
-
-    QHBoxLayout *h26 = new QHBoxLayout();
-    h26->addWidget(m_nameLabel);
-    h26->addWidget(m_name, 1);
-    h26->setSpacing(8);
-
+    m_eventLayout = new QHBoxLayout();
+    m_eventLayout->setSpacing(8);
+    m_nameLayout = new QHBoxLayout();
+    m_nameLayout->setSpacing(8);
     // end
 
-    h2->addLayout(h21);
-    h2->addLayout(h22);
-    h2->addLayout(h23);
-    h2->addLayout(h24);
-    h2->addLayout(h25);  // add by Airy
-    h2->addLayout(h26);  // add by Airy
+    h2->addLayout(m_userLayout);
+    h2->addLayout(m_pidLayout);
+    h2->addLayout(m_statusLayout);
+    h2->addLayout(m_actionLayout);
+    h2->addLayout(m_eventLayout);  // add by Airy
+    h2->addLayout(m_nameLayout);  // add by Airy
     h2->addStretch(1);
     h2->addWidget(m_level);
     h2->setSpacing(20);
@@ -336,59 +269,14 @@ void logDetailInfoWidget::fillDetailInfo(QString deamonName, QString usrName, QS
             m_dateTime->setText(dateTime);
     }
 
-    if (usrName.isEmpty()) {
-        m_userName->hide();
-        m_userLabel->hide();
-    } else {
-        m_userName->show();
-        m_userLabel->show();
-        m_userName->setText(usrName);
-    }
-
-    if (pid.isEmpty()) {
-        m_pid->hide();
-        m_pidLabel->hide();
-    } else {
-        m_pid->show();
-        m_pidLabel->show();
-        m_pid->setText(pid);
-    }
-
-    if (status.isEmpty()) {
-        m_status->hide();
-        m_statusLabel->hide();
-    } else {
-        m_status->show();
-        m_statusLabel->show();
-        m_status->setText(status);
-    }
-
-    if (action.isEmpty()) {
-        m_action->hide();
-        m_actionLabel->hide();
-    } else {
-        m_action->show();
-        m_actionLabel->show();
-        m_action->setText(action);
-    }
+    setField(m_userLabel, m_userName, m_userLayout, QT_TRANSLATE_NOOP("Label", "User:"), usrName);
+    setField(m_pidLabel, m_pid, m_pidLayout, QT_TRANSLATE_NOOP("Label", "PID:"), pid);
+    setField(m_statusLabel, m_status, m_statusLayout, QT_TRANSLATE_NOOP("Label", "Status:"), status);
+    setField(m_actionLabel, m_action, m_actionLayout, QT_TRANSLATE_NOOP("Label", "Action:"), action);
 
     // add by Airy
-    if (uname.isEmpty()) {
-        m_name->hide();
-        m_nameLabel->hide();
-    } else {
-        m_name->show();        // add by Airy
-        m_nameLabel->show();   // add by Airy
-        m_name->setText(uname);
-    }
-    if (event.isEmpty()) {
-        m_event->hide();
-        m_eventLabel->hide();
-    } else {
-        m_event->show();       // add by Airy
-        m_eventLabel->show();  // add by Airy
-        m_event->setText(event);
-    }
+    setField(m_nameLabel, m_name, m_nameLayout, QT_TRANSLATE_NOOP("Label", "Username:"), uname);
+    setField(m_eventLabel, m_event, m_eventLayout, QT_TRANSLATE_NOOP("Label", "Event Type:"), event);
     // end
 
     m_bottomLayer->setContentsMargins(20, 10, 20, 0);
@@ -396,27 +284,57 @@ void logDetailInfoWidget::fillDetailInfo(QString deamonName, QString usrName, QS
     m_textBrowser->show();
 }
 
-void logDetailInfoWidget::fillOOCDetailInfo(const QString &data, const int error)
+/**
+ * @brief logDetailInfoWidget::appendOOCSource 在分页显示控件末尾追加一个文件的内容
+ * @param source 已建立行索引的文件内容
+ */
+void logDetailInfoWidget::appendOOCSource(const LogTextSourcePtr &source)
 {
-    m_daemonName->hide();
-    m_dateTime->hide();
-    m_userName->hide();
-    m_pid->hide();
-    m_action->hide();
-    m_status->hide();
-    m_name->hide();
-    m_event->hide();
+    showOOCLayout();
+    m_textBrowser->hide();
+    m_errorLabel->hide();
+    if (m_customView)
+        m_customView->hide();
+    oocView()->appendSource(source);
+    m_oocView->show();
+}
 
-    m_hline->hide();
+/**
+ * @brief logDetailInfoWidget::showCoredumpStack 崩溃日志的core文件位置和堆栈按页显示,代替信息控件,字段保持不变
+ * 堆栈可能有几百KB,分页显示控件只排版可见的行
+ * @param source 已建立行索引的core文件位置和堆栈
+ */
+void logDetailInfoWidget::showCoredumpStack(const LogTextSourcePtr &source)
+{
+    m_textBrowser->hide();
+    oocView()->clear();
+    m_oocView->appendSource(source);
+    m_oocView->show();
+}
 
-    m_userLabel->hide();
-    m_pidLabel->hide();
-    m_statusLabel->hide();
-    m_actionLabel->hide();
-    m_nameLabel->hide();
-    m_eventLabel->hide();
+/**
+ * @brief logDetailInfoWidget::showCustomRecords 按声明的行格式把自定义日志显示为记录表格
+ * @param filePath 日志文件路径
+ * @param format 编译好的行格式
+ */
+void logDetailInfoWidget::showCustomRecords(const QString &filePath, const LogLineFormatPtr &format)
+{
+    showOOCLayout();
+    m_textBrowser->hide();
+    m_errorLabel->hide();
+    if (m_oocView)
+        m_oocView->hide();
+    customView()->load(filePath, format);
+    m_customView->show();
+}
 
-    m_bottomLayer->setContentsMargins(20, 10, 0, 0);
+void logDetailInfoWidget::fillOOCDetailInfo(const QString &data, const int error)
+{
+    showOOCLayout();
+    if (m_oocView)
+        m_oocView->hide();
+    if (m_customView)
+        m_customView->hide();
     if (error == 0) {
         m_textBrowser->setText(data);
         m_textBrowser->show();
@@ -428,13 +346,106 @@ void logDetailInfoWidget::fillOOCDetailInfo(const QString &data, const int error
     }
 }
 
+/**
+ * @brief logDetailInfoWidget::showOOCLayout 其他日志和自定义日志只显示内容,隐藏各字段
+ */
+void logDetailInfoWidget::showOOCLayout()
+{
+    m_daemonName->hide();
+    m_dateTime->hide();
+    hideField(m_userLabel, m_userName);
+    hideField(m_pidLabel, m_pid);
+    hideField(m_actionLabel, m_action);
+    hideField(m_statusLabel, m_status);
+    hideField(m_nameLabel, m_name);
+    hideField(m_eventLabel, m_event);
+
+    m_hline->hide();
+
+    m_bottomLayer->setContentsMargins(20, 10, 0, 0);
+}
+
+/**
+ * @brief logDetailInfoWidget::oocView 其他日志、自定义日志和崩溃堆栈的分页显示控件,第一次使用时创建并放在m_textBrowser之后
+ */
+LogPagedTextView *logDetailInfoWidget::oocView()
+{
+    if (m_oocView)
+        return m_oocView;
+    m_oocView = new LogPagedTextView(this);
+    DFontSizeManager::instance()->bind(m_oocView, DFontSizeManager::T8);
+    DPalette pa = DApplicationHelper::instance()->palette(m_oocView);
+    pa.setBrush(DPalette::Text, pa.color(DPalette::TextTips));
+    DApplicationHelper::instance()->setPalette(m_oocView, pa);
+    m_oocView->setFrameShape(QFrame::NoFrame);
+    m_oocView->viewport()->setAutoFillBackground(false);
+    m_bottomLayer->insertWidget(m_bottomLayer->indexOf(m_textBrowser) + 1, m_oocView, 3);
+    return m_oocView;
+}
+
+/**
+ * @brief logDetailInfoWidget::customView 自定义日志的记录表格,第一次使用时创建并放在m_textBrowser之后
+ */
+LogCustomRecordView *logDetailInfoWidget::customView()
+{
+    if (m_customView)
+        return m_customView;
+    m_customView = new LogCustomRecordView(this);
+    DFontSizeManager::instance()->bind(m_customView, DFontSizeManager::T8);
+    m_bottomLayer->insertWidget(m_bottomLayer->indexOf(m_textBrowser) + 1, m_customView, 3);
+    return m_customView;
+}
+
+/**
+ * @brief logDetailInfoWidget::setField 显示一个字段,内容为空时隐藏;标题和值控件在第一次有内容时创建
+ * @param label 标题控件
+ * @param value 值控件
+ * @param layout 字段所在的布局
+ * @param title 未翻译的标题,用QT_TRANSLATE_NOOP("Label", ...)标记
+ * @param text 字段内容
+ */
+void logDetailInfoWidget::setField(DLabel *&label, DLabel *&value, QHBoxLayout *layout,
+                                   const char *title, const QString &text)
+{
+    if (text.isEmpty()) {
+        hideField(label, value);
+        return;
+    }
+    if (!value) {
+        label = new DLabel(DApplication::translate("Label", title), this);
+        DFontSizeManager::instance()->bind(label, DFontSizeManager::T7);
+        value = new DLabel(this);
+        DFontSizeManager::instance()->bind(value, DFontSizeManager::T8);
+        value->setMinimumWidth(LABEL_MIN_WIDTH);
+        DPalette pa = DApplicationHelper::instance()->palette(value);
+        pa.setBrush(DPalette::WindowText, pa.color(DPalette::TextTips));
+        DApplicationHelper::instance()->setPalette(value, pa);
+        layout->addWidget(label);
+        layout->addWidget(value, 1);
+    }
+    label->show();
+    value->show();
+    value->setText(text);
+}
+
+/**
+ * @brief logDetailInfoWidget::hideField 隐藏一个字段,尚未创建时不做任何事
+ */
+void logDetailInfoWidget::hideField(DLabel *label, DLabel *value)
+{
+    if (label)
+        label->hide();
+    if (value)
+        value->hide();
+}
+
 /**
  * @brief logDetailInfoWidget::slot_DetailInfo 连接主表选择事件槽函数，显示信息
  * @param index 主表控件当前选择的index
  * @param pModel 主表控件的model
  * @param name 应用日志的应用名称
  */
-void logDetailInfoWidget::slot_DetailInfo(const QModelIndex &index, QStandardItemModel *pModel,
+void logDetailInfoWidget::slot_DetailInfo(const QModelIndex &index, QAbstractItemModel *pModel,
                                           const QString &data, const int error)
 {
     cleanText();
@@ -455,24 +466,30 @@ void logDetailInfoWidget::slot_DetailInfo(const QModelIndex &index, QStandardIte
     QString dataStr = index.data(Qt::UserRole + 1).toString();
     index.row();
     //按照选择的当前日志类型显示具体的信息
+    //信息体直接取自某一列时,按该列记下的位置高亮搜索关键字
+    int msgColumn = -1;
     if (dataStr.contains(DPKG_TABLE_DATA)) {
-
+        msgColumn = 1;
         fillDetailInfo("dpkg", hostname, "", index.siblingAtColumn(0).data().toString(), QModelIndex(),
                        index.siblingAtColumn(1).data().toString(), "",
                        index.siblingAtColumn(2).data().toString());
     } else if (dataStr.contains(XORG_TABLE_DATA)) {
+        msgColumn = 1;
         fillDetailInfo("Xorg", hostname, "", index.siblingAtColumn(0).data().toString(), QModelIndex(),
                        index.siblingAtColumn(1).data().toString());
     } else if (dataStr.contains(BOOT_TABLE_DATA)) {
+        msgColumn = 1;
         fillDetailInfo("Boot", hostname, "", "", QModelIndex(),
                        index.siblingAtColumn(1).data().toString(),
                        index.siblingAtColumn(0).data().toString());
     } else if (dataStr.contains(KERN_TABLE_DATA)) {
+        msgColumn = 3;
         fillDetailInfo(index.siblingAtColumn(2).data().toString(),
                        /*m_pModel->item(index.row(), 1)->text()*/ hostname, "",
                        index.siblingAtColumn(0).data().toString(), QModelIndex(),
                        index.siblingAtColumn(3).data().toString());
     } else if (dataStr.contains(JOUR_TABLE_DATA)) {
+        msgColumn = 3;
         fillDetailInfo(index.siblingAtColumn(1).data().toString(),
                        /*m_pModel->item(index.row(), 4)->text()*/ hostname,
                        index.siblingAtColumn(5).data().toString(),
@@ -496,36 +513,44 @@ void logDetailInfoWidget::slot_DetailInfo(const QModelIndex &index, QStandardIte
                    typeStr.compare("Boot") != 0) {
             str = DApplication::translate("Label", "Login record");
         }
+        msgColumn = 3;
         fillDetailInfo(str, hostname, "", index.siblingAtColumn(2).data().toString(), QModelIndex(),
                        index.siblingAtColumn(3).data().toString(), "", "",
                        index.siblingAtColumn(1).data().toString(),
                        index.siblingAtColumn(0).data().toString());
         // modified by Airy
     } else if (dataStr.contains(KWIN_TABLE_DATA)) {
+        msgColumn = 0;
         fillDetailInfo("Kwin", hostname, "", "", QModelIndex(),
                        index.siblingAtColumn(0).data().toString());
     } else if (dataStr.contains(BOOT_KLU_TABLE_DATA)) {
+        msgColumn = 3;
         fillDetailInfo(index.siblingAtColumn(1).data().toString(),
                        /*m_pModel->item(index.row(), 4)->text()*/ hostname,
                        index.siblingAtColumn(5).data().toString(),
                        index.siblingAtColumn(2).data().toString(), index,
                        index.siblingAtColumn(3).data().toString());
     } else if (dataStr.contains(DNF_TABLE_DATA)) {
+        msgColumn = 2;
         fillDetailInfo("dnf", hostname, "", index.siblingAtColumn(1).data().toString(), index,
                        index.siblingAtColumn(2).data().toString());
     } else if (dataStr.contains(DMESG_TABLE_DATA)) {
+        msgColumn = 2;
         fillDetailInfo("kernel", hostname, "", index.siblingAtColumn(1).data().toString(), index,
                        index.siblingAtColumn(2).data().toString());
     } else if (dataStr.contains(OOC_TABLE_DATA)) {
         fillOOCDetailInfo(data, error);
     } else if (dataStr.contains(AUDIT_TABLE_DATA)) {
+        msgColumn = 4;
+        const QString auditMsg = index.siblingAtColumn(4).data().toString();
         fillDetailInfo("audit", hostname, "", index.siblingAtColumn(1).data().toString(), QModelIndex(),
-                       index.siblingAtColumn(4).data().toString(),
+                       auditMsg,
                        index.siblingAtColumn(3).data().toString(),
                        "",
-                       "",
+                       LogAuditParser::userText(auditMsg),
                        index.siblingAtColumn(0).data().toString());
     } else if (dataStr.contains(COREDUMP_TABLE_DATA)) {
+        //堆栈信息读取后由showCoredumpStack显示,见DisplayContent::loadCoredumpStack
         fillDetailInfo(index.siblingAtColumn(3).data().toString(), hostname, "", index.siblingAtColumn(1).data().toString(), QModelIndex(),
                        index.siblingAtColumn(4).data(Qt::UserRole + 2).toString(),
                        index.siblingAtColumn(2).data().toString(),
@@ -533,4 +558,11 @@ void logDetailInfoWidget::slot_DetailInfo(const QModelIndex &index, QStandardIte
                        "",
                        "");
     }
+
+    if (msgColumn >= 0) {
+        const QModelIndex msgIndex = index.siblingAtColumn(msgColumn);
+        //按富文本显示时位置和纯文本不一致,不高亮
+        if (!Qt::mightBeRichText(msgIndex.data().toString()))
+            m_textBrowser->setSearchHits(msgIndex.data(LogTableModel::SearchHitsRole).value<QVector<int>>());
+    }
 }
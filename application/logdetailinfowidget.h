@@ -6,6 +6,8 @@
 #define LOGDETAILINFOWIDGET_H
 #include "logiconbutton.h"
 #include "logdetailedit.h"
+#include "logpagedtextview.h"
+#include "loglineformat.h"
 #include "structdef.h"
 
 #include <DHorizontalLine>
@@ -18,7 +20,9 @@
 
 DWIDGET_USE_NAMESPACE
 class QStandardItemModel;
+class QHBoxLayout;
 class QVBoxLayout;
+class LogCustomRecordView;
 /**
  * @brief The logDetailInfoWidget class 详情页控件
  */
@@ -31,10 +35,19 @@ public:
     void cleanText();
 
     void hideLine(bool isHidden);
+    void appendOOCSource(const LogTextSourcePtr &source);
+    void showCustomRecords(const QString &filePath, const LogLineFormatPtr &format);
+    void showCoredumpStack(const LogTextSourcePtr &source);
 
 private:
     void initUI();
     void setTextCustomSize(QWidget *w);
+    void showOOCLayout();
+    LogPagedTextView *oocView();
+    LogCustomRecordView *customView();
+    void setField(Dtk::Widget::DLabel *&label, Dtk::Widget::DLabel *&value, QHBoxLayout *layout,
+                  const char *title, const QString &text);
+    static void hideField(Dtk::Widget::DLabel *label, Dtk::Widget::DLabel *value);
 
     void fillDetailInfo(QString deamonName, QString usrName, QString pid, QString dateTime,
                         QModelIndex level, QString msg, QString status = "", QString action = "",
@@ -45,22 +58,37 @@ private:
 protected:
     void paintEvent(QPaintEvent *event) override;
 public slots:
-    void slot_DetailInfo(const QModelIndex &index, QStandardItemModel *pModel, const QString &data, const int error);
+    void slot_DetailInfo(const QModelIndex &index, QAbstractItemModel *pModel, const QString &data, const int error);
 
 private:
     //m_daemonName:进程名显示控件 m_dateTime:时间显示控件 m_userName：用户名显示控件  m_pid：进程号显示控件 m_action：动作显示控件  m_status：状态显示控件 m_name:开关机日志用户名显示控件 m_event: 开关机日志时间类型显示
-    Dtk::Widget::DLabel *m_daemonName, *m_dateTime, *m_userName, *m_pid, *m_action, *m_status,
-        *m_name, *m_event;  // modified by Airy
+    //各字段的标题和值控件在第一次有内容时才创建,之前为空,见setField
+    Dtk::Widget::DLabel *m_daemonName, *m_dateTime;
+    Dtk::Widget::DLabel *m_userName {nullptr}, *m_pid {nullptr}, *m_action {nullptr}, *m_status {nullptr},
+        *m_name {nullptr}, *m_event {nullptr};  // modified by Airy
     /**
      * @brief m_level 日志等级显示控件
      */
     LogIconButton *m_level;
-    Dtk::Widget::DLabel *m_userLabel, *m_pidLabel, *m_statusLabel, *m_actionLabel, *m_nameLabel,
-        *m_eventLabel, *m_errorLabel;  // modified by Airy
+    Dtk::Widget::DLabel *m_userLabel {nullptr}, *m_pidLabel {nullptr}, *m_statusLabel {nullptr}, *m_actionLabel {nullptr},
+        *m_nameLabel {nullptr}, *m_eventLabel {nullptr};  // modified by Airy
+    Dtk::Widget::DLabel *m_errorLabel;
+    /**
+     * @brief m_userLayout等 各字段的位置,字段控件创建后放入
+     */
+    QHBoxLayout *m_userLayout, *m_pidLayout, *m_statusLayout, *m_actionLayout, *m_eventLayout, *m_nameLayout;
     /**
      * @brief m_textBrowser 日志信息显示控件
      */
     logDetailEdit *m_textBrowser;
+    /**
+     * @brief m_oocView 其他日志、自定义日志和崩溃堆栈的分页显示控件,大文件只绘制可见的行;第一次使用时创建
+     */
+    LogPagedTextView *m_oocView {nullptr};
+    /**
+     * @brief m_customView 声明了行格式的自定义日志的记录表格;第一次显示这类日志时创建
+     */
+    LogCustomRecordView *m_customView {nullptr};
     /**
      * @brief m_hline 中间的分割线
      */
@@ -68,7 +96,7 @@ private:
     /**
      * @brief m_pModel 当前主表的model
      */
-    QStandardItemModel *m_pModel;
+    QAbstractItemModel *m_pModel;
     /**
      * @brief m_bottomLayer 底部框
      */
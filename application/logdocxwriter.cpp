@@ -0,0 +1,358 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logdocxwriter.h"
+
+#include "minizip/zip.h"
+#include "minizip/unzip.h"
+
+#include <QLoggingCategory>
+
+#ifdef QT_DEBUG
+Q_LOGGING_CATEGORY(logDocxWriter, "org.deepin.log.viewer.export.docx")
+#else
+Q_LOGGING_CATEGORY(logDocxWriter, "org.deepin.log.viewer.export.docx", QtInfoMsg)
+#endif
+
+//正文xml攒够这么多字节再压缩写入
+#define DOCX_WRITE_BLOCK_SIZE (512 * 1024)
+//复制模板部件时的读取块大小
+#define DOCX_COPY_BLOCK_SIZE (64 * 1024)
+//表格总宽度,和原模板一致,单位为1/20磅
+#define DOCX_TABLE_WIDTH 8522
+//正文部件在包中的路径,模板中的同名部件不复制
+#define DOCX_DOCUMENT_ENTRY "word/document.xml"
+
+namespace {
+const char *const kDocumentStart =
+    "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n"
+    "<w:document xmlns:w=\"http://schemas.openxmlformats.org/wordprocessingml/2006/main\" "
+    "xmlns:r=\"http://schemas.openxmlformats.org/officeDocument/2006/relationships\"><w:body>";
+//页面大小和边距沿用原模板
+const char *const kDocumentEnd =
+    "<w:p/><w:sectPr><w:pgSz w:w=\"11906\" w:h=\"16838\"/>"
+    "<w:pgMar w:top=\"1440\" w:right=\"1800\" w:bottom=\"1440\" w:left=\"1800\" w:header=\"851\" w:footer=\"992\" w:gutter=\"0\"/>"
+    "</w:sectPr></w:body></w:document>";
+const char *const kTableProperties =
+    "<w:tblPr><w:tblW w:w=\"" QT_STRINGIFY(DOCX_TABLE_WIDTH) "\" w:type=\"dxa\"/><w:tblBorders>"
+    "<w:top w:val=\"single\" w:color=\"auto\" w:sz=\"4\" w:space=\"0\"/>"
+    "<w:left w:val=\"single\" w:color=\"auto\" w:sz=\"4\" w:space=\"0\"/>"
+    "<w:bottom w:val=\"single\" w:color=\"auto\" w:sz=\"4\" w:space=\"0\"/>"
+    "<w:right w:val=\"single\" w:color=\"auto\" w:sz=\"4\" w:space=\"0\"/>"
+    "<w:insideH w:val=\"single\" w:color=\"auto\" w:sz=\"4\" w:space=\"0\"/>"
+    "<w:insideV w:val=\"single\" w:color=\"auto\" w:sz=\"4\" w:space=\"0\"/>"
+    "</w:tblBorders><w:tblLayout w:type=\"fixed\"/></w:tblPr>";
+//没有模板时只写最小的包结构
+const char *const kContentTypes =
+    "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n"
+    "<Types xmlns=\"http://schemas.openxmlformats.org/package/2006/content-types\">"
+    "<Default Extension=\"xml\" ContentType=\"application/xml\"/>"
+    "<Default Extension=\"rels\" ContentType=\"application/vnd.openxmlformats-package.relationships+xml\"/>"
+    "<Override PartName=\"/word/document.xml\" ContentType=\"application/vnd.openxmlformats-officedocument.wordprocessingml.document.main+xml\"/>"
+    "</Types>";
+const char *const kPackageRels =
+    "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n"
+    "<Relationships xmlns=\"http://schemas.openxmlformats.org/package/2006/relationships\">"
+    "<Relationship Id=\"rId1\" Type=\"http://schemas.openxmlformats.org/officeDocument/2006/relationships/officeDocument\" Target=\"word/document.xml\"/>"
+    "</Relationships>";
+}
+
+/**
+ * @brief LogDocxWriter::LogDocxWriter 创建docx包,复制模板部件并写入表头
+ * @param fileName 导出文件路径,已存在时覆盖
+ * @param templateFile DocxFactory的.dfw模板,提供样式、主题和字体表;为空时生成不带样式的最小文档
+ * @param labels 表头,也决定表格的列数
+ */
+LogDocxWriter::LogDocxWriter(const QString &fileName, const QString &templateFile, const QStringList &labels)
+    : m_columnCount(qMax(1, labels.size()))
+{
+    m_buffer.reserve(DOCX_WRITE_BLOCK_SIZE + DOCX_COPY_BLOCK_SIZE);
+    m_zip = zipOpen64(fileName.toLocal8Bit().constData(), APPEND_STATUS_CREATE);
+    if (!m_zip) {
+        qCWarning(logDocxWriter) << "create docx file failed:" << fileName;
+        return;
+    }
+    const bool packaged = templateFile.isEmpty()
+                          ? writeEntry("[Content_Types].xml", kContentTypes) && writeEntry("_rels/.rels", kPackageRels)
+                          : copyTemplate(templateFile);
+    if (!packaged || !openEntry(DOCX_DOCUMENT_ENTRY)) {
+        zipClose(m_zip, nullptr);
+        m_zip = nullptr;
+        return;
+    }
+    writeTableStart();
+    for (const QString &label : labels)
+        writeCell(label, true);
+    m_buffer.append("</w:tr>");
+    m_cellCount = 0;
+}
+
+/**
+ * @brief LogDocxWriter::~LogDocxWriter 没有调用close时(如导出被停止)也关闭zip,释放minizip的资源
+ */
+LogDocxWriter::~LogDocxWriter()
+{
+    close();
+}
+
+bool LogDocxWriter::isOpen() const
+{
+    return m_zip != nullptr;
+}
+
+/**
+ * @brief LogDocxWriter::operator<< 给当前行追加一个单元格
+ */
+LogDocxWriter &LogDocxWriter::operator<<(const QString &cell)
+{
+    if (m_cellCount == 0)
+        m_buffer.append("<w:tr>");
+    writeCell(cell, false);
+    return *this;
+}
+
+/**
+ * @brief LogDocxWriter::endRow 结束当前行,缓冲满时压缩写入,写入失败时抛出QString,和导出函数的异常处理一致
+ */
+void LogDocxWriter::endRow()
+{
+    if (!m_zip)
+        throw QString("docx file is not open");
+    if (m_cellCount == 0)
+        m_buffer.append("<w:tr>");
+    //单元格不足列数时补空,否则Word认为表格损坏
+    while (m_cellCount < m_columnCount)
+        writeCell(QString(), false);
+    m_buffer.append("</w:tr>");
+    m_cellCount = 0;
+    if (m_buffer.size() >= DOCX_WRITE_BLOCK_SIZE)
+        flush();
+}
+
+LogDocxWriter::Rows &LogDocxWriter::Rows::operator<<(const QString &cell)
+{
+    if (cellCount == 0)
+        xml.append("<w:tr>");
+    appendCell(xml, cell, false);
+    ++cellCount;
+    return *this;
+}
+
+/**
+ * @brief LogDocxWriter::Rows::appendEscaped 追加一个已经xml转义并编码为utf8的单元格,如预先生成的等级文字
+ */
+LogDocxWriter::Rows &LogDocxWriter::Rows::appendEscaped(const QByteArray &xml)
+{
+    if (cellCount == 0)
+        this->xml.append("<w:tr>");
+    appendEscapedCell(this->xml, xml);
+    ++cellCount;
+    return *this;
+}
+
+void LogDocxWriter::Rows::endRow()
+{
+    if (cellCount == 0)
+        xml.append("<w:tr>");
+    while (cellCount < columnCount) {
+        appendCell(xml, QString(), false);
+        ++cellCount;
+    }
+    xml.append("</w:tr>");
+    cellCount = 0;
+}
+
+/**
+ * @brief LogDocxWriter::writeRows 按顺序追加预先生成的各行,缓冲满时压缩写入,写入失败时抛出QString
+ */
+void LogDocxWriter::writeRows(const Rows &rows)
+{
+    if (!m_zip)
+        throw QString("docx file is not open");
+    m_buffer.append(rows.xml);
+    if (m_buffer.size() >= DOCX_WRITE_BLOCK_SIZE)
+        flush();
+}
+
+bool LogDocxWriter::close()
+{
+    if (!m_zip)
+        return false;
+    m_buffer.append("</w:tbl>");
+    m_buffer.append(kDocumentEnd);
+    bool ok = zipWriteInFileInZip(m_zip, m_buffer.constData(), static_cast<unsigned>(m_buffer.size())) == ZIP_OK;
+    ok = zipCloseFileInZip(m_zip) == ZIP_OK && ok;
+    ok = zipClose(m_zip, nullptr) == ZIP_OK && ok;
+    m_zip = nullptr;
+    m_buffer.resize(0);
+    if (!ok)
+        qCWarning(logDocxWriter) << "close docx file failed";
+    return ok;
+}
+
+/**
+ * @brief LogDocxWriter::appendEscaped 把text做xml转义并编码为utf8追加到out
+ * 日志中xml不允许的控制字符直接丢掉,落单的代理项按U+FFFD处理
+ */
+void LogDocxWriter::appendEscaped(QByteArray &out, const QString &text)
+{
+    const ushort *data = text.utf16();
+    const int size = text.size();
+    for (int i = 0; i < size; ++i) {
+        uint code = data[i];
+        if (QChar::isHighSurrogate(code) && i + 1 < size && QChar::isLowSurrogate(data[i + 1])) {
+            code = QChar::surrogateToUcs4(static_cast<ushort>(code), data[++i]);
+        } else if (QChar::isSurrogate(code) || code == 0xFFFE || code == 0xFFFF) {
+            code = QChar::ReplacementCharacter;
+        }
+        if (code < 0x80) {
+            switch (code) {
+            case '&':
+                out.append("&amp;");
+                break;
+            case '<':
+                out.append("&lt;");
+                break;
+            case '>':
+                out.append("&gt;");
+                break;
+            case '\t':
+            case '\n':
+            case '\r':
+                out.append(static_cast<char>(code));
+                break;
+            default:
+                if (code >= 0x20)
+                    out.append(static_cast<char>(code));
+                break;
+            }
+        } else if (code < 0x800) {
+            out.append(static_cast<char>(0xC0 | (code >> 6)));
+            out.append(static_cast<char>(0x80 | (code & 0x3F)));
+        } else if (code < 0x10000) {
+            out.append(static_cast<char>(0xE0 | (code >> 12)));
+            out.append(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+            out.append(static_cast<char>(0x80 | (code & 0x3F)));
+        } else {
+            out.append(static_cast<char>(0xF0 | (code >> 18)));
+            out.append(static_cast<char>(0x80 | ((code >> 12) & 0x3F)));
+            out.append(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+            out.append(static_cast<char>(0x80 | (code & 0x3F)));
+        }
+    }
+}
+
+/**
+ * @brief LogDocxWriter::copyTemplate 把模板中的docx部件复制进新包
+ * .dfw是DocxFactory编译后的模板,以'#'开头的是它自己的数据,正文由本类重新生成,都不复制
+ */
+bool LogDocxWriter::copyTemplate(const QString &templateFile)
+{
+    unzFile source = unzOpen64(templateFile.toLocal8Bit().constData());
+    if (!source) {
+        qCWarning(logDocxWriter) << "open docx template failed:" << templateFile;
+        return false;
+    }
+    bool ok = unzGoToFirstFile(source) == UNZ_OK;
+    QByteArray data;
+    char name[512];
+    while (ok) {
+        unz_file_info64 info;
+        ok = unzGetCurrentFileInfo64(source, &info, name, sizeof(name), nullptr, 0, nullptr, 0) == UNZ_OK;
+        if (!ok)
+            break;
+        const QByteArray entry(name);
+        if (!entry.startsWith('#') && !entry.endsWith('/') && entry != DOCX_DOCUMENT_ENTRY) {
+            ok = unzOpenCurrentFile(source) == UNZ_OK;
+            data.resize(0);
+            while (ok) {
+                const int offset = data.size();
+                data.resize(offset + DOCX_COPY_BLOCK_SIZE);
+                const int read = unzReadCurrentFile(source, data.data() + offset, DOCX_COPY_BLOCK_SIZE);
+                data.resize(offset + qMax(0, read));
+                if (read <= 0) {
+                    ok = read == 0;
+                    break;
+                }
+            }
+            ok = unzCloseCurrentFile(source) == UNZ_OK && ok;
+            ok = ok && writeEntry(name, data);
+            if (!ok)
+                break;
+        }
+        const int next = unzGoToNextFile(source);
+        if (next == UNZ_END_OF_LIST_OF_FILE)
+            break;
+        ok = next == UNZ_OK;
+    }
+    unzClose(source);
+    if (!ok)
+        qCWarning(logDocxWriter) << "copy docx template failed:" << templateFile;
+    return ok;
+}
+
+bool LogDocxWriter::writeEntry(const char *name, const QByteArray &data)
+{
+    if (!openEntry(name))
+        return false;
+    const bool ok = zipWriteInFileInZip(m_zip, data.constData(), static_cast<unsigned>(data.size())) == ZIP_OK;
+    return zipCloseFileInZip(m_zip) == ZIP_OK && ok;
+}
+
+bool LogDocxWriter::openEntry(const char *name)
+{
+    zip_fileinfo info = {};
+    //正文大小事先未知,按zip64写入
+    const int zip64 = qstrcmp(name, DOCX_DOCUMENT_ENTRY) == 0 ? 1 : 0;
+    const int error = zipOpenNewFileInZip64(m_zip, name, &info, nullptr, 0, nullptr, 0, nullptr,
+                                            Z_DEFLATED, Z_DEFAULT_COMPRESSION, zip64);
+    if (error != ZIP_OK)
+        qCWarning(logDocxWriter) << "open docx entry failed:" << name << error;
+    return error == ZIP_OK;
+}
+
+/**
+ * @brief LogDocxWriter::writeTableStart 正文开头、表格属性、等宽列定义和表头行的开始,表头行在每页重复
+ */
+void LogDocxWriter::writeTableStart()
+{
+    m_buffer.append(kDocumentStart);
+    m_buffer.append("<w:tbl>");
+    m_buffer.append(kTableProperties);
+    m_buffer.append("<w:tblGrid>");
+    const QByteArray column = QByteArray("<w:gridCol w:w=\"") + QByteArray::number(DOCX_TABLE_WIDTH / m_columnCount) + "\"/>";
+    for (int i = 0; i < m_columnCount; ++i)
+        m_buffer.append(column);
+    m_buffer.append("</w:tblGrid><w:tr><w:trPr><w:tblHeader/></w:trPr>");
+}
+
+void LogDocxWriter::writeCell(const QString &text, bool bold)
+{
+    appendCell(m_buffer, text, bold);
+    ++m_cellCount;
+}
+
+void LogDocxWriter::appendCell(QByteArray &out, const QString &text, bool bold)
+{
+    out.append(bold ? "<w:tc><w:p><w:r><w:rPr><w:b/></w:rPr><w:t xml:space=\"preserve\">"
+                    : "<w:tc><w:p><w:r><w:t xml:space=\"preserve\">");
+    appendEscaped(out, text);
+    out.append("</w:t></w:r></w:p></w:tc>");
+}
+
+void LogDocxWriter::appendEscapedCell(QByteArray &out, const QByteArray &xml)
+{
+    out.append("<w:tc><w:p><w:r><w:t xml:space=\"preserve\">");
+    out.append(xml);
+    out.append("</w:t></w:r></w:p></w:tc>");
+}
+
+void LogDocxWriter::flush()
+{
+    const int error = zipWriteInFileInZip(m_zip, m_buffer.constData(), static_cast<unsigned>(m_buffer.size()));
+    //resize(0)保留已分配的空间,下一块继续使用
+    m_buffer.resize(0);
+    if (error != ZIP_OK)
+        throw QString("write docx file failed");
+}
@@ -0,0 +1,70 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGDOCXWRITER_H
+#define LOGDOCXWRITER_H
+
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+
+/**
+ * @brief The LogDocxWriter class 逐行写入的docx导出,表格的WordprocessingML按顺序拼接后分块压缩进zip
+ * 模板(.dfw)中除正文外的部件(样式、主题、字体等)原样复制,正文word/document.xml由本类生成,
+ * 不再经过DocxFactory逐行paste,内存占用只有一个写入块,和行数无关
+ */
+class LogDocxWriter
+{
+public:
+    explicit LogDocxWriter(const QString &fileName, const QString &templateFile, const QStringList &labels);
+    ~LogDocxWriter();
+
+    bool isOpen() const;
+
+    /**
+     * @brief The Rows struct 在其他线程中预先生成的若干行表格xml,由writeRows按顺序写入,和逐个单元格写入的结果一致
+     */
+    struct Rows {
+        explicit Rows(int columnCount = 0)
+            : columnCount(columnCount)
+        {
+        }
+        Rows &operator<<(const QString &cell);
+        Rows &appendEscaped(const QByteArray &xml);
+        void endRow();
+
+        int columnCount;
+        //当前行已写入的单元格数
+        int cellCount = 0;
+        QByteArray xml;
+    };
+
+    LogDocxWriter &operator<<(const QString &cell);
+    void endRow();
+    void writeRows(const Rows &rows);
+    bool close();
+
+    int columnCount() const { return m_columnCount; }
+    static void appendEscaped(QByteArray &out, const QString &text);
+
+private:
+    static void appendCell(QByteArray &out, const QString &text, bool bold);
+    static void appendEscapedCell(QByteArray &out, const QByteArray &xml);
+    bool copyTemplate(const QString &templateFile);
+    bool writeEntry(const char *name, const QByteArray &data);
+    bool openEntry(const char *name);
+    void writeTableStart();
+    void writeCell(const QString &text, bool bold);
+    void flush();
+
+    //minizip的zipFile句柄
+    void *m_zip = nullptr;
+    int m_columnCount;
+    //当前行已写入的单元格数
+    int m_cellCount = 0;
+    //待压缩的正文xml
+    QByteArray m_buffer;
+};
+
+#endif // LOGDOCXWRITER_H
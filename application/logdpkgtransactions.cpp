@@ -0,0 +1,87 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logdpkgtransactions.h"
+#include "loglocaltime.h"
+
+/**
+ * @brief LogDpkgTransactions::update 处理视图中新追加的行
+ * @param view 当前显示的dpkg记录,从新到旧,只追加不修改;需要重新开始时先调用clear
+ * @return 第一个发生变化的事务下标,没有新行时为size()
+ */
+int LogDpkgTransactions::update(const LogRecordView<LOG_MSG_DPKG> &view)
+{
+    if (view.size() < m_rows)
+        clear();
+    const int changed = m_rows < view.size() ? qMax(0, m_transactions.size() - 1) : m_transactions.size();
+    for (; m_rows < view.size(); ++m_rows)
+        add(view.at(m_rows), m_rows);
+    return changed;
+}
+
+void LogDpkgTransactions::clear()
+{
+    m_transactions.clear();
+    m_rows = 0;
+    m_lastTime = -1;
+    m_lastStartup = false;
+    m_packages.clear();
+}
+
+/**
+ * @brief LogDpkgTransactions::recordTime 记录的时间(毫秒),解析时没有记下时按时间文本计算,无法解析时为-1
+ */
+qint64 LogDpkgTransactions::recordTime(const LOG_MSG_DPKG &record)
+{
+    if (record.timestamp > 0)
+        return record.timestamp;
+    return LogLocalTime::parse(record.dateTime);
+}
+
+/**
+ * @brief LogDpkgTransactions::isPackageAction 是否为对一个软件包的操作,status、configure、trigproc等中间步骤不计入摘要
+ */
+bool LogDpkgTransactions::isPackageAction(const QString &action)
+{
+    return action == "install" || action == "upgrade" || action == "remove" || action == "purge";
+}
+
+void LogDpkgTransactions::add(const LOG_MSG_DPKG &record, int row)
+{
+    const qint64 time = recordTime(record);
+    //较新的一行是startup时,它是一次dpkg调用的开始,这一行属于之前的调用
+    bool boundary = m_transactions.isEmpty();
+    if (!boundary && time >= 0 && m_lastTime >= 0) {
+        const qint64 gap = m_lastTime - time;
+        boundary = (m_lastStartup && gap > LOG_DPKG_STARTUP_GAP_SECS * 1000) || gap > LOG_DPKG_IDLE_GAP_SECS * 1000;
+    }
+    if (boundary) {
+        LogDpkgTransaction transaction;
+        transaction.first = row;
+        transaction.endTime = time;
+        m_transactions.append(transaction);
+        m_packages.clear();
+    }
+
+    LogDpkgTransaction &transaction = m_transactions.last();
+    ++transaction.count;
+    transaction.beginTime = time;
+    transaction.beginText = record.dateTime;
+    if (transaction.endTime < 0)
+        transaction.endTime = time;
+    if (isPackageAction(record.action)) {
+        const QString package = record.msg.section(' ', 0, 0, QString::SectionSkipEmpty);
+        if (!package.isEmpty() && !m_packages.contains(package)) {
+            m_packages.insert(package);
+            ++transaction.packageCount;
+            ++transaction.actions[record.action];
+            if (transaction.packages.size() < LOG_DPKG_SUMMARY_PACKAGES)
+                transaction.packages.append(package);
+        }
+    }
+
+    if (time >= 0)
+        m_lastTime = time;
+    m_lastStartup = record.action == "startup";
+}
@@ -0,0 +1,72 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGDPKGTRANSACTIONS_H
+#define LOGDPKGTRANSACTIONS_H
+
+#include "structdef.h"
+#include "logrecordview.h"
+
+#include <QMap>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+//startup行和上一次dpkg调用的最后一行相差超过这么多秒时开始新的事务,同一次apt操作中的多次dpkg调用间隔很短
+#define LOG_DPKG_STARTUP_GAP_SECS 5
+//没有startup行时相邻两行相差超过这么多秒也拆分为两个事务
+#define LOG_DPKG_IDLE_GAP_SECS 600
+//每个事务摘要中保留的包名数
+#define LOG_DPKG_SUMMARY_PACKAGES 5
+
+/**
+ * @brief The LogDpkgTransaction struct 一次软件包操作(一次apt安装、升级等)的摘要
+ */
+struct LogDpkgTransaction {
+    //在记录视图中的第一行(最新的一行)和行数,各行连续
+    int first = 0;
+    int count = 0;
+    //最早和最新一行的时间(毫秒),最早一行的时间文本
+    qint64 beginTime = -1;
+    qint64 endTime = -1;
+    QString beginText;
+    //install/upgrade/remove/purge各动作涉及的包数
+    QMap<QString, int> actions;
+    //前LOG_DPKG_SUMMARY_PACKAGES个包名和涉及的包总数
+    QStringList packages;
+    int packageCount = 0;
+};
+
+/**
+ * @brief The LogDpkgTransactions class 加载dpkg日志时按startup行和时间间隔把各行归为事务
+ * 记录按从新到旧的顺序逐批到达,每批只处理新追加的行,最后一个事务可能被后续批次继续扩展;
+ * 只保存每个事务的行范围和摘要,展开时再从记录视图中取出详细的行
+ */
+class LogDpkgTransactions
+{
+public:
+    int update(const LogRecordView<LOG_MSG_DPKG> &view);
+    void clear();
+    const QVector<LogDpkgTransaction> &transactions() const { return m_transactions; }
+    int size() const { return m_transactions.size(); }
+    int rows() const { return m_rows; }
+
+    static qint64 recordTime(const LOG_MSG_DPKG &record);
+    static bool isPackageAction(const QString &action);
+
+private:
+    void add(const LOG_MSG_DPKG &record, int row);
+
+    QVector<LogDpkgTransaction> m_transactions;
+    //已经处理的行数
+    int m_rows = 0;
+    //上一行(较新的一行)的时间和是否为startup行
+    qint64 m_lastTime = -1;
+    bool m_lastStartup = false;
+    //最后一个事务中出现过的包
+    QSet<QString> m_packages;
+};
+
+#endif // LOGDPKGTRANSACTIONS_H
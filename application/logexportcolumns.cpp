@@ -0,0 +1,18 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logexportcolumns.h"
+
+//列表在导出时按引用遍历,需要类外定义
+constexpr LogExportColumn<LOG_MSG_JOURNAL> LogExportTraits<LOG_MSG_JOURNAL, JOURNAL>::columns[];
+constexpr LogExportColumn<LOG_MSG_JOURNAL> LogExportTraits<LOG_MSG_JOURNAL, KERN>::columns[];
+constexpr LogExportColumn<LOG_MSG_APPLICATOIN> LogExportTraits<LOG_MSG_APPLICATOIN>::columns[];
+constexpr LogExportColumn<LOG_MSG_DPKG> LogExportTraits<LOG_MSG_DPKG>::columns[];
+constexpr LogExportColumn<LOG_MSG_BOOT> LogExportTraits<LOG_MSG_BOOT>::columns[];
+constexpr LogExportColumn<LOG_MSG_XORG> LogExportTraits<LOG_MSG_XORG>::columns[];
+constexpr LogExportColumn<LOG_MSG_NORMAL> LogExportTraits<LOG_MSG_NORMAL>::columns[];
+constexpr LogExportColumn<LOG_MSG_KWIN> LogExportTraits<LOG_MSG_KWIN>::columns[];
+constexpr LogExportColumn<LOG_MSG_DNF> LogExportTraits<LOG_MSG_DNF>::columns[];
+constexpr LogExportColumn<LOG_MSG_DMESG> LogExportTraits<LOG_MSG_DMESG>::columns[];
+constexpr LogExportColumn<LOG_MSG_AUDIT> LogExportTraits<LOG_MSG_AUDIT>::columns[];
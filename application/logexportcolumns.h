@@ -0,0 +1,183 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGEXPORTCOLUMNS_H
+#define LOGEXPORTCOLUMNS_H
+
+#include "structdef.h"
+
+#include <QString>
+
+/**
+ * @brief The LogExportColumnKind enum 导出列的取值方式
+ */
+enum LogExportColumnKind {
+    ExportField, //直接取记录中的字段
+    ExportLevel, //syslog等级,导出时转换为翻译后的显示文字
+    ExportDnfLevel, //dnf等级,导出时转换为翻译后的显示文字
+    ExportAppName, //应用名称,取导出时传入的值,不读记录
+    ExportText //由记录的成员函数得到,字段不单独保存
+};
+
+/**
+ * @brief The LogExportColumnFlag enum 导出列的附加选项
+ */
+enum LogExportColumnFlag {
+    ExportNoFlag = 0,
+    ExportPreLine = 0x1, //html中按原样保留换行
+    ExportNullIfEmpty = 0x2, //txt中空值写为Null
+    ExportTime = 0x4, //ndjson中另外写入微秒时间戳timestamp
+    ExportPriority = 0x8, //ndjson中另外写入数字等级priority
+    ExportNumber = 0x10 //ndjson中能转为整数时按数字写入
+};
+
+/**
+ * @brief The LogExportColumn struct 导出表格的一列,编译期确定取记录的哪个字段
+ */
+template <typename T>
+struct LogExportColumn {
+    QString T::*field;
+    LogExportColumnKind kind;
+    int flags;
+    //ndjson中的字段名
+    const char *key;
+    //等级列取的数字等级,其他列为空
+    int T::*level = nullptr;
+    //ExportText列取文字的成员函数
+    QString (T::*text)() const = nullptr;
+};
+
+/**
+ * @brief The LogExportTraits struct 每种日志记录的导出列表,txt/ndjson/html/doc/xlsx共用同一份列顺序,
+ * 和界面表头的顺序一致;系统日志和内核日志是同一种记录,按flag区分两套列
+ */
+template <typename T, LOG_FLAG Flag = NONE>
+struct LogExportTraits;
+
+template <>
+struct LogExportTraits<LOG_MSG_JOURNAL, JOURNAL> {
+    using Record = LOG_MSG_JOURNAL;
+    static constexpr LogExportColumn<Record> columns[] = {
+        {nullptr, ExportLevel, ExportPriority, "level", &Record::level},
+        {&Record::daemonName, ExportField, ExportNoFlag, "process"},
+        {&Record::dateTime, ExportField, ExportTime, "datetime"},
+        {&Record::msg, ExportField, ExportNullIfEmpty, "message"},
+        {&Record::hostName, ExportField, ExportNoFlag, "user"},
+        {&Record::daemonId, ExportField, ExportNumber, "pid"},
+    };
+    static constexpr int columnCount = sizeof(columns) / sizeof(columns[0]);
+};
+
+template <>
+struct LogExportTraits<LOG_MSG_JOURNAL, KERN> {
+    using Record = LOG_MSG_JOURNAL;
+    static constexpr LogExportColumn<Record> columns[] = {
+        {&Record::dateTime, ExportField, ExportTime, "datetime"},
+        {&Record::hostName, ExportField, ExportNoFlag, "user"},
+        {&Record::daemonName, ExportField, ExportNoFlag, "process"},
+        {&Record::msg, ExportField, ExportNoFlag, "message"},
+    };
+    static constexpr int columnCount = sizeof(columns) / sizeof(columns[0]);
+};
+
+template <>
+struct LogExportTraits<LOG_MSG_APPLICATOIN> {
+    using Record = LOG_MSG_APPLICATOIN;
+    static constexpr LogExportColumn<Record> columns[] = {
+        {nullptr, ExportLevel, ExportPriority, "level", &Record::level},
+        {&Record::dateTime, ExportField, ExportTime, "datetime"},
+        {nullptr, ExportAppName, ExportNoFlag, "source"},
+        {&Record::msg, ExportField, ExportNoFlag, "message"},
+    };
+    static constexpr int columnCount = sizeof(columns) / sizeof(columns[0]);
+};
+
+template <>
+struct LogExportTraits<LOG_MSG_DPKG> {
+    using Record = LOG_MSG_DPKG;
+    static constexpr LogExportColumn<Record> columns[] = {
+        {&Record::dateTime, ExportField, ExportTime, "datetime"},
+        {&Record::msg, ExportField, ExportNoFlag, "message"},
+        {&Record::action, ExportField, ExportNoFlag, "action"},
+    };
+    static constexpr int columnCount = sizeof(columns) / sizeof(columns[0]);
+};
+
+template <>
+struct LogExportTraits<LOG_MSG_BOOT> {
+    using Record = LOG_MSG_BOOT;
+    static constexpr LogExportColumn<Record> columns[] = {
+        {&Record::status, ExportField, ExportNoFlag, "status"},
+        {nullptr, ExportText, ExportNoFlag, "message", nullptr, &Record::message},
+    };
+    static constexpr int columnCount = sizeof(columns) / sizeof(columns[0]);
+};
+
+template <>
+struct LogExportTraits<LOG_MSG_XORG> {
+    using Record = LOG_MSG_XORG;
+    static constexpr LogExportColumn<Record> columns[] = {
+        {&Record::offset, ExportField, ExportNoFlag, "offset"},
+        {&Record::msg, ExportField, ExportNoFlag, "message"},
+    };
+    static constexpr int columnCount = sizeof(columns) / sizeof(columns[0]);
+};
+
+template <>
+struct LogExportTraits<LOG_MSG_NORMAL> {
+    using Record = LOG_MSG_NORMAL;
+    static constexpr LogExportColumn<Record> columns[] = {
+        {&Record::eventType, ExportField, ExportNoFlag, "event"},
+        {&Record::userName, ExportField, ExportNoFlag, "user"},
+        {&Record::dateTime, ExportField, ExportTime, "datetime"},
+        {&Record::msg, ExportField, ExportNoFlag, "message"},
+    };
+    static constexpr int columnCount = sizeof(columns) / sizeof(columns[0]);
+};
+
+template <>
+struct LogExportTraits<LOG_MSG_KWIN> {
+    using Record = LOG_MSG_KWIN;
+    static constexpr LogExportColumn<Record> columns[] = {
+        {&Record::msg, ExportField, ExportNoFlag, "message"},
+    };
+    static constexpr int columnCount = sizeof(columns) / sizeof(columns[0]);
+};
+
+template <>
+struct LogExportTraits<LOG_MSG_DNF> {
+    using Record = LOG_MSG_DNF;
+    static constexpr LogExportColumn<Record> columns[] = {
+        {nullptr, ExportDnfLevel, ExportPriority, "level", &Record::level},
+        {&Record::dateTime, ExportField, ExportTime, "datetime"},
+        {&Record::msg, ExportField, ExportPreLine, "message"},
+    };
+    static constexpr int columnCount = sizeof(columns) / sizeof(columns[0]);
+};
+
+template <>
+struct LogExportTraits<LOG_MSG_DMESG> {
+    using Record = LOG_MSG_DMESG;
+    static constexpr LogExportColumn<Record> columns[] = {
+        {nullptr, ExportLevel, ExportPriority, "level", &Record::level},
+        {&Record::dateTime, ExportField, ExportTime, "datetime"},
+        {&Record::msg, ExportField, ExportPreLine, "message"},
+    };
+    static constexpr int columnCount = sizeof(columns) / sizeof(columns[0]);
+};
+
+template <>
+struct LogExportTraits<LOG_MSG_AUDIT> {
+    using Record = LOG_MSG_AUDIT;
+    static constexpr LogExportColumn<Record> columns[] = {
+        {&Record::eventType, ExportField, ExportNoFlag, "event"},
+        {&Record::dateTime, ExportField, ExportTime, "datetime"},
+        {&Record::processName, ExportField, ExportNoFlag, "process"},
+        {&Record::status, ExportField, ExportNoFlag, "status"},
+        {&Record::msg, ExportField, ExportNoFlag, "message"},
+    };
+    static constexpr int columnCount = sizeof(columns) / sizeof(columns[0]);
+};
+
+#endif // LOGEXPORTCOLUMNS_H
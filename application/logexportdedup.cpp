@@ -0,0 +1,105 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logexportdedup.h"
+
+#include <QFileInfo>
+#include <QHash>
+#include <QPair>
+
+/**
+ * @brief LogExportDedup::payloads 每个文件的内容保存在哪个文件中
+ * @param stats 待导出文件的元数据
+ * @param hasher 只对大小相同、inode不同的文件调用一次
+ * @return 和stats顺序一致,为内容相同的文件中下标最小的那个,内容唯一时为自身;文件不存在时为-1
+ */
+QVector<int> LogExportDedup::payloads(const QList<LogFileStat> &stats, const Hasher &hasher)
+{
+    QVector<int> result(stats.size(), -1);
+    QHash<qint64, QVector<int>> bySize;
+    for (int i = 0; i < stats.size(); ++i) {
+        if (!stats.at(i).exists)
+            continue;
+        result[i] = i;
+        bySize[stats.at(i).size].append(i);
+    }
+
+    QVector<int> hashIndexes;
+    QList<LogFileStat> hashStats;
+    for (auto it = bySize.cbegin(); it != bySize.cend(); ++it) {
+        const QVector<int> &group = it.value();
+        if (group.size() < 2)
+            continue;
+        //硬链接到同一个inode的文件内容相同,每个inode只需要计算一次
+        QHash<quint64, int> byInode;
+        QVector<int> distinct;
+        for (int index : group) {
+            const quint64 inode = stats.at(index).inode;
+            if (inode != 0 && byInode.contains(inode)) {
+                result[index] = byInode.value(inode);
+                continue;
+            }
+            if (inode != 0)
+                byInode.insert(inode, index);
+            distinct.append(index);
+        }
+        if (distinct.size() < 2)
+            continue;
+        for (int index : distinct) {
+            hashIndexes.append(index);
+            hashStats.append(stats.at(index));
+        }
+    }
+
+    if (!hashIndexes.isEmpty() && hasher) {
+        const QStringList hashes = hasher(hashStats);
+        QHash<QPair<qint64, QString>, int> byHash;
+        for (int i = 0; i < hashIndexes.size(); ++i) {
+            const QString hash = hashes.value(i);
+            if (hash.isEmpty())
+                continue;
+            const int index = hashIndexes.at(i);
+            const QPair<qint64, QString> key(stats.at(index).size, hash);
+            auto found = byHash.constFind(key);
+            if (found != byHash.cend())
+                result[index] = found.value();
+            else
+                byHash.insert(key, index);
+        }
+    }
+
+    //硬链接的文件指向的文件可能又和更前面的文件内容相同,按下标从小到大解析到最终的文件
+    for (int i = 0; i < result.size(); ++i) {
+        if (result.at(i) >= 0 && result.at(i) != i)
+            result[i] = result.at(result.at(i));
+    }
+    return result;
+}
+
+/**
+ * @brief LogExportDedup::hasDuplicates 是否有文件和其他文件内容相同
+ */
+bool LogExportDedup::hasDuplicates(const QVector<int> &payloads)
+{
+    for (int i = 0; i < payloads.size(); ++i) {
+        if (payloads.at(i) >= 0 && payloads.at(i) != i)
+            return true;
+    }
+    return false;
+}
+
+/**
+ * @brief LogExportDedup::manifest 压缩包中的清单,每行为一个导出的文件名和保存其内容的文件名,以制表符分隔
+ * 文件不存在的不列出
+ */
+QString LogExportDedup::manifest(const QList<LogFileStat> &stats, const QVector<int> &payloads)
+{
+    QString text = QStringLiteral("# file\tstored as\n");
+    for (int i = 0; i < stats.size() && i < payloads.size(); ++i) {
+        if (payloads.at(i) < 0)
+            continue;
+        text += QFileInfo(stats.at(i).path).fileName() + QLatin1Char('\t') + QFileInfo(stats.at(payloads.at(i)).path).fileName() + QLatin1Char('\n');
+    }
+    return text;
+}
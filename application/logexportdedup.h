@@ -0,0 +1,37 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGEXPORTDEDUP_H
+#define LOGEXPORTDEDUP_H
+
+#include "logfilestat.h"
+
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include <functional>
+
+//打包导出时记录重复文件对应关系的清单,放在压缩包的根目录
+#define LOG_EXPORT_MANIFEST_NAME "manifest.txt"
+
+/**
+ * @brief The LogExportDedup class 打包导出时找出内容相同的文件,每份内容在压缩包中只保存一次
+ * 大小不同的文件内容必然不同,只有大小相同的文件才计算摘要;同一inode的文件不读取,直接视为相同
+ */
+class LogExportDedup
+{
+public:
+    /**
+     * @brief Hasher 计算一组文件的内容摘要,结果和参数顺序一致,无法计算时为空
+     */
+    using Hasher = std::function<QStringList(const QList<LogFileStat> &stats)>;
+
+    static QVector<int> payloads(const QList<LogFileStat> &stats, const Hasher &hasher);
+    static bool hasDuplicates(const QVector<int> &payloads);
+    static QString manifest(const QList<LogFileStat> &stats, const QVector<int> &payloads);
+};
+
+#endif // LOGEXPORTDEDUP_H
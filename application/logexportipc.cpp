@@ -0,0 +1,196 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logexportipc.h"
+#include "journalreader.h"
+#include "logexportthread.h"
+#include "logrecordfilter.h"
+
+#include <QDataStream>
+#include <QElapsedTimer>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QLoggingCategory>
+#include <QPointer>
+
+#include <unistd.h>
+
+#include <atomic>
+#include <memory>
+
+#ifdef QT_DEBUG
+Q_LOGGING_CATEGORY(logExportIpc, "org.deepin.log.viewer.export.ipc")
+#else
+Q_LOGGING_CATEGORY(logExportIpc, "org.deepin.log.viewer.export.ipc", QtInfoMsg)
+#endif
+
+namespace {
+void prepare(QDataStream &stream)
+{
+    //固定序列化版本,命令行和界面实例可能来自不同的构建
+    stream.setVersion(QDataStream::Qt_5_6);
+}
+}
+
+LogExportServer::LogExportServer(QObject *parent)
+    : QObject(parent)
+{
+}
+
+LogExportServer::~LogExportServer()
+{
+    if (m_server)
+        m_server->close();
+}
+
+/**
+ * @brief LogExportServer::listen 开始接收当前用户的命令行发来的导出请求
+ * @param handler 请求的处理函数
+ * @return 是否监听成功;上次异常退出遗留的套接字文件会先删除
+ */
+bool LogExportServer::listen(const Handler &handler)
+{
+    m_handler = handler;
+    if (!m_server) {
+        m_server = new QLocalServer(this);
+        m_server->setSocketOptions(QLocalServer::UserAccessOption);
+        connect(m_server, &QLocalServer::newConnection, this, [this]() {
+            while (QLocalSocket *socket = m_server->nextPendingConnection()) {
+                connect(socket, &QLocalSocket::disconnected, socket, &QObject::deleteLater);
+                connect(socket, &QLocalSocket::readyRead, this, [this, socket]() { readRequest(socket); });
+            }
+        });
+    }
+    if (m_server->isListening())
+        return true;
+    if (!m_server->listen(serverName())) {
+        QLocalServer::removeServer(serverName());
+        if (!m_server->listen(serverName())) {
+            qCWarning(logExportIpc) << "listen failed:" << m_server->errorString();
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief LogExportServer::serverName 按用户区分的服务名,命令行以其他用户(如sudo)运行时连接不到,自行解析
+ */
+QString LogExportServer::serverName()
+{
+    return QString("_d_deepin_logger_export_%1").arg(getuid());
+}
+
+/**
+ * @brief LogExportServer::send 命令行把导出请求交给图形界面实例,等待导出完成
+ * @return 没有实例或实例不能满足时为Unanswerable,由命令行自行解析;请求发出后超时为Failed,避免和实例同时写同一个文件
+ */
+LogExportServer::Status LogExportServer::send(const LogExportRequest &request)
+{
+    QLocalSocket socket;
+    socket.connectToServer(serverName());
+    if (!socket.waitForConnected(LOG_EXPORT_IPC_CONNECT_TIMEOUT))
+        return Unanswerable;
+
+    QDataStream stream(&socket);
+    prepare(stream);
+    stream << qint8(LOG_EXPORT_IPC_VERSION) << request.arg << request.keyword << request.fileName << request.labels;
+    socket.flush();
+
+    QElapsedTimer timer;
+    timer.start();
+    while (socket.bytesAvailable() < qint64(sizeof(qint8))) {
+        const qint64 remaining = LOG_EXPORT_IPC_EXPORT_TIMEOUT - timer.elapsed();
+        if (remaining <= 0) {
+            qCWarning(logExportIpc) << "wait for running instance timeout";
+            return Failed;
+        }
+        //实例在处理前退出,由命令行自行解析
+        if (!socket.waitForReadyRead(static_cast<int>(remaining)) && socket.state() != QLocalSocket::ConnectedState
+                && socket.bytesAvailable() < qint64(sizeof(qint8)))
+            return Unanswerable;
+    }
+    qint8 status = Unanswerable;
+    stream >> status;
+    return status >= Exported && status <= Failed ? static_cast<Status>(status) : Unanswerable;
+}
+
+/**
+ * @brief LogExportServer::exportJournal 在工作线程中导出实例缓存的系统日志
+ * @param records 缓存中满足筛选参数的记录,从新到旧排列
+ * @param cursor 缓存时最新条目的游标,之后产生的新日志按同样的筛选参数增量读取后放在最前
+ */
+LogExportServer::Status LogExportServer::exportJournal(const LogExportRequest &request, QList<LOG_MSG_JOURNAL> records, const QString &cursor)
+{
+    if (!cursor.isEmpty()) {
+        std::atomic_bool canRun(true);
+        JournalReadOptions options = JournalReadOptions::fromArgs(request.arg);
+        options.stopCursor = cursor.toUtf8();
+        SystemJournalPolicy policy;
+        policy.lazyMessage = true;
+        JournalReader<SystemJournalPolicy> reader(policy, canRun);
+        QList<LOG_MSG_JOURNAL> batch;
+        QList<LOG_MSG_JOURNAL> newer;
+        const int r = reader.read(options, batch, [&newer](QList<LOG_MSG_JOURNAL> &list) { newer.append(list); });
+        if (r < 0) {
+            qCWarning(logExportIpc) << "read journal failed:" << reader.errorString();
+            return Failed;
+        }
+        records = newer + records;
+    }
+
+    if (!request.keyword.isEmpty()) {
+        const LogRecordFilter::TextMatcher text(request.keyword);
+        //每段各自打开读取完整信息的journal句柄
+        records = LogRecordFilter::filterWith(records, [text]() {
+            std::shared_ptr<JournalMessageResolver> resolver = std::make_shared<JournalMessageResolver>();
+            return [text, resolver](const LOG_MSG_JOURNAL &msg) { return LogRecordFilter::matchJournal(text, msg, *resolver); };
+        });
+    }
+    if (records.isEmpty())
+        return NoData;
+
+    bool success = false;
+    LogExportThread exportThread(true);
+    exportThread.setAutoDelete(false);
+    connect(&exportThread, &LogExportThread::sigResult, [&success](bool isSuccess) { success = isSuccess; });
+    exportThread.exportToTxtPublic(request.fileName, records, request.labels, JOURNAL);
+    exportThread.run();
+    qCInfo(logExportIpc) << "exported" << records.size() << "records for command line to" << request.fileName;
+    return success ? Exported : Failed;
+}
+
+/**
+ * @brief LogExportServer::readRequest 读取完整的请求后交给处理函数,处理完成时回复状态并断开
+ */
+void LogExportServer::readRequest(QLocalSocket *socket)
+{
+    QDataStream stream(socket);
+    prepare(stream);
+    stream.startTransaction();
+    qint8 version = 0;
+    LogExportRequest request;
+    stream >> version;
+    if (version == LOG_EXPORT_IPC_VERSION)
+        stream >> request.arg >> request.keyword >> request.fileName >> request.labels;
+    if (!stream.commitTransaction())
+        return;
+
+    disconnect(socket, &QLocalSocket::readyRead, this, nullptr);
+    QPointer<QLocalSocket> guard(socket);
+    const Reply reply = [guard](Status status) {
+        if (!guard)
+            return;
+        QDataStream out(guard.data());
+        prepare(out);
+        out << qint8(status);
+        guard->flush();
+        guard->disconnectFromServer();
+    };
+    if (version != LOG_EXPORT_IPC_VERSION || request.fileName.isEmpty() || !m_handler) {
+        reply(Unanswerable);
+        return;
+    }
+    m_handler(request, reply);
+}
@@ -0,0 +1,76 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGEXPORTIPC_H
+#define LOGEXPORTIPC_H
+
+#include "structdef.h"
+
+#include <QObject>
+#include <QStringList>
+
+#include <functional>
+
+class QLocalServer;
+class QLocalSocket;
+
+//命令行和图形界面之间导出请求的协议版本,格式不兼容时递增
+#define LOG_EXPORT_IPC_VERSION 1
+//命令行连接图形界面实例的超时,毫秒,超时后由命令行自行解析
+#define LOG_EXPORT_IPC_CONNECT_TIMEOUT 300
+//等待图形界面导出完成的超时,毫秒
+#define LOG_EXPORT_IPC_EXPORT_TIMEOUT (5 * 60 * 1000)
+
+/**
+ * @brief The LogExportRequest struct 命令行按条件导出系统日志的请求
+ */
+struct LogExportRequest {
+    //journal筛选参数,和LogFileParser::parseByJournal一致
+    QStringList arg;
+    //关键字,为空时不筛选
+    QString keyword;
+    //导出文件的完整路径,后缀决定文本、压缩或ndjson格式
+    QString fileName;
+    //表头
+    QStringList labels;
+};
+
+/**
+ * @brief The LogExportServer class 图形界面运行时接收命令行的导出请求,用已加载在内存中的日志直接导出
+ * 命令行导出前先连接当前用户的图形界面实例:实例的类别缓存能覆盖筛选条件时,只增量读取缓存之后的新日志,
+ * 按关键字筛选后写出文件,命令行不再重新读取journal;不能满足或没有实例时由命令行自行解析
+ */
+class LogExportServer : public QObject
+{
+    Q_OBJECT
+public:
+    enum Status {
+        Exported = 0,
+        //实例中没有能满足筛选条件的数据
+        Unanswerable,
+        //筛选后没有数据,不生成文件
+        NoData,
+        Failed
+    };
+    typedef std::function<void(Status)> Reply;
+    //在界面线程中处理请求,完成后调用reply
+    typedef std::function<void(const LogExportRequest &, const Reply &)> Handler;
+
+    explicit LogExportServer(QObject *parent = nullptr);
+    ~LogExportServer();
+
+    bool listen(const Handler &handler);
+
+    static QString serverName();
+    static Status send(const LogExportRequest &request);
+    static Status exportJournal(const LogExportRequest &request, QList<LOG_MSG_JOURNAL> records, const QString &cursor);
+
+private:
+    void readRequest(QLocalSocket *socket);
+
+    QLocalServer *m_server = nullptr;
+    Handler m_handler;
+};
+
+#endif // LOGEXPORTIPC_H
@@ -3,23 +3,28 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "logexportthread.h"
+#include "logexportwriter.h"
+#include "journalreader.h"
 #include "utils.h"
-#include "xlsxwriter.h"
-#include "WordProcessingMerger.h"
-#include "WordProcessingCompiler.h"
+#include "logxlsxwriter.h"
+#include "logdocxwriter.h"
+#include "logzipwriter.h"
+#include "logexportdedup.h"
+#include "loggzipwriter.h"
+#include "logrecordformatter.h"
+#include "logworkscheduler.h"
 #include "dbusproxy/dldbushandler.h"
 
 #include <DApplication>
 
 #include <QDebug>
 #include <QFile>
-#include <QTextCodec>
-#include <QTextStream>
 #include <QTextDocument>
 #include <QTextDocumentWriter>
 #include <QElapsedTimer>
 #include <QStandardPaths>
-#include <QProcess>
+#include <QFileInfo>
+#include <QSet>
 #include <QLoggingCategory>
 
 #include <malloc.h>
@@ -31,6 +36,7 @@ Q_LOGGING_CATEGORY(logExport, "org.deepin.log.viewer.export.work")
 Q_LOGGING_CATEGORY(logExport, "org.deepin.log.viewer.export.work", QtInfoMsg)
 #endif
 
+
 /**
  * @brief LogExportThread::LogExportThread 导出日志线程类构造函数
  * @param parent 父对象
@@ -38,10 +44,10 @@ Q_LOGGING_CATEGORY(logExport, "org.deepin.log.viewer.export.work", QtInfoMsg)
 LogExportThread::LogExportThread(bool isDataComplete, QObject *parent)
     :  QObject(parent),
        QRunnable(),
-       m_allLoadComplete(isDataComplete)
+       m_allLoadComplete(isDataComplete),
+       m_progress([this](int nCur, int nTotal) { emit sigProgress(nCur, nTotal); })
 {
     setAutoDelete(true);
-    initMap();
 }
 /**
  * @brief LogExportThread::~LogExportThread 析构函数
@@ -53,12 +59,12 @@ LogExportThread::~LogExportThread()
 }
 
 /**
- * @brief LogExportThread::exportToTxtPublic 导出到日志txt格式配置函数对QStandardItemModel数据类型的重载
+ * @brief LogExportThread::exportToTxtPublic 导出到日志txt格式配置函数对model数据类型的重载
  * @param fileName 导出文件路径全称
- * @param pModel 要导出的数据源，为QStandardItemModel
+ * @param pModel 要导出的数据源，为主表的model
  * @param flag 导出的日志类型
  */
-void LogExportThread::exportToTxtPublic(const QString &fileName, QStandardItemModel *pModel, LOG_FLAG flag)
+void LogExportThread::exportToTxtPublic(const QString &fileName, QAbstractItemModel *pModel, LOG_FLAG flag)
 {
     m_fileName = fileName;
     m_pModel = pModel;
@@ -74,7 +80,7 @@ void LogExportThread::exportToTxtPublic(const QString &fileName, QStandardItemMo
  * @param labels 表头字符串
  * @param flag  导出的日志类型
  */
-void LogExportThread::exportToTxtPublic(const QString &fileName, const QList<LOG_MSG_JOURNAL> &jList,  const QStringList &labels, LOG_FLAG flag)
+void LogExportThread::exportToTxtPublic(const QString &fileName, const LogRecordView<LOG_MSG_JOURNAL> &jList,  const QStringList &labels, LOG_FLAG flag)
 {
     m_fileName = fileName;
     m_jList = jList;
@@ -92,7 +98,7 @@ void LogExportThread::exportToTxtPublic(const QString &fileName, const QList<LOG
  * @param labels 表头字符串
  * @param iAppName 导出的应用日志的应用名称
  */
-void LogExportThread::exportToTxtPublic(const QString &fileName, const QList<LOG_MSG_APPLICATOIN> &jList, const QStringList &labels, const QString &iAppName)
+void LogExportThread::exportToTxtPublic(const QString &fileName, const LogRecordView<LOG_MSG_APPLICATOIN> &jList, const QStringList &labels, const QString &iAppName)
 {
     m_fileName = fileName;
     m_appList = jList;
@@ -108,7 +114,7 @@ void LogExportThread::exportToTxtPublic(const QString &fileName, const QList<LOG
  * @param jList  要导出的数据源 LOG_MSG_DPKG
  * @param labels 表头字符串
  */
-void LogExportThread::exportToTxtPublic(const QString &fileName, const QList<LOG_MSG_DPKG> &jList, const QStringList &labels)
+void LogExportThread::exportToTxtPublic(const QString &fileName, const LogRecordView<LOG_MSG_DPKG> &jList, const QStringList &labels)
 {
     m_fileName = fileName;
     m_dpkgList = jList;
@@ -123,7 +129,7 @@ void LogExportThread::exportToTxtPublic(const QString &fileName, const QList<LOG
  * @param jList  要导出的数据源 LOG_MSG_BOOT
  * @param labels 表头字符串
  */
-void LogExportThread::exportToTxtPublic(const QString &fileName, const QList<LOG_MSG_BOOT> &jList, const QStringList &labels)
+void LogExportThread::exportToTxtPublic(const QString &fileName, const LogRecordView<LOG_MSG_BOOT> &jList, const QStringList &labels)
 {
     m_fileName = fileName;
     m_bootList = jList;
@@ -138,7 +144,7 @@ void LogExportThread::exportToTxtPublic(const QString &fileName, const QList<LOG
  * @param jList 要导出的数据源 LOG_MSG_XORG
  * @param labels 表头字符串
  */
-void LogExportThread::exportToTxtPublic(const QString &fileName, const QList<LOG_MSG_XORG> &jList, const QStringList &labels)
+void LogExportThread::exportToTxtPublic(const QString &fileName, const LogRecordView<LOG_MSG_XORG> &jList, const QStringList &labels)
 {
     m_fileName = fileName;
     m_xorgList = jList;
@@ -154,7 +160,7 @@ void LogExportThread::exportToTxtPublic(const QString &fileName, const QList<LOG
  * @param jList 要导出的数据源 LOG_MSG_NORMAL
  * @param labels 表头字符串
  */
-void LogExportThread::exportToTxtPublic(const QString &fileName, const QList<LOG_MSG_NORMAL> &jList, const QStringList &labels)
+void LogExportThread::exportToTxtPublic(const QString &fileName, const LogRecordView<LOG_MSG_NORMAL> &jList, const QStringList &labels)
 {
     m_fileName = fileName;
     m_normalList = jList;
@@ -169,7 +175,7 @@ void LogExportThread::exportToTxtPublic(const QString &fileName, const QList<LOG
  * @param jList 要导出的数据源 LOG_MSG_KWIN
  * @param labels 表头字符串
  */
-void LogExportThread::exportToTxtPublic(const QString &fileName, const QList<LOG_MSG_KWIN> &jList, const QStringList &labels)
+void LogExportThread::exportToTxtPublic(const QString &fileName, const LogRecordView<LOG_MSG_KWIN> &jList, const QStringList &labels)
 {
     m_fileName = fileName;
     m_kwinList = jList;
@@ -178,7 +184,7 @@ void LogExportThread::exportToTxtPublic(const QString &fileName, const QList<LOG
     m_canRunning = true;
 }
 
-void LogExportThread::exportToTxtPublic(const QString &fileName, const QList<LOG_MSG_DNF> &jList, const QStringList &labels)
+void LogExportThread::exportToTxtPublic(const QString &fileName, const LogRecordView<LOG_MSG_DNF> &jList, const QStringList &labels)
 {
     m_fileName = fileName;
     m_dnfList = jList;
@@ -187,7 +193,7 @@ void LogExportThread::exportToTxtPublic(const QString &fileName, const QList<LOG
     m_canRunning = true;
 }
 
-void LogExportThread::exportToTxtPublic(const QString &fileName, const QList<LOG_MSG_DMESG> &jList, const QStringList &labels)
+void LogExportThread::exportToTxtPublic(const QString &fileName, const LogRecordView<LOG_MSG_DMESG> &jList, const QStringList &labels)
 {
     m_fileName = fileName;
     m_dmesgList = jList;
@@ -196,7 +202,7 @@ void LogExportThread::exportToTxtPublic(const QString &fileName, const QList<LOG
     m_canRunning = true;
 }
 
-void LogExportThread::exportToTxtPublic(const QString &fileName, const QList<LOG_MSG_AUDIT> &jList, const QStringList &labels)
+void LogExportThread::exportToTxtPublic(const QString &fileName, const LogRecordView<LOG_MSG_AUDIT> &jList, const QStringList &labels)
 {
     m_fileName = fileName;
     m_alist = jList;
@@ -206,12 +212,12 @@ void LogExportThread::exportToTxtPublic(const QString &fileName, const QList<LOG
 }
 
 /**
- * @brief LogExportThread::exportToHtmlPublic 导出到日志html格式配置函数对QStandardItemModel数据类型的重载
+ * @brief LogExportThread::exportToHtmlPublic 导出到日志html格式配置函数对model数据类型的重载
  * @param fileName 导出文件路径全称
- * @param pModel 要导出的数据源，为QStandardItemModel
+ * @param pModel 要导出的数据源，为主表的model
  * @param flag 导出的日志类型
  */
-void LogExportThread::exportToHtmlPublic(const QString &fileName, QStandardItemModel *pModel, LOG_FLAG flag)
+void LogExportThread::exportToHtmlPublic(const QString &fileName, QAbstractItemModel *pModel, LOG_FLAG flag)
 {
     m_fileName = fileName;
     m_pModel = pModel;
@@ -228,7 +234,7 @@ void LogExportThread::exportToHtmlPublic(const QString &fileName, QStandardItemM
  * @param labels 表头字符串
  * @param flag  导出的日志类型
  */
-void LogExportThread::exportToHtmlPublic(const QString &fileName, const QList<LOG_MSG_JOURNAL> &jList, const QStringList &labels, LOG_FLAG flag)
+void LogExportThread::exportToHtmlPublic(const QString &fileName, const LogRecordView<LOG_MSG_JOURNAL> &jList, const QStringList &labels, LOG_FLAG flag)
 {
     m_fileName = fileName;
     m_jList = jList;
@@ -246,7 +252,7 @@ void LogExportThread::exportToHtmlPublic(const QString &fileName, const QList<LO
  * @param labels 表头字符串
  * @param iAppName 导出的应用日志的应用名称
  */
-void LogExportThread::exportToHtmlPublic(const QString &fileName, const QList<LOG_MSG_APPLICATOIN> &jList, const QStringList &labels, const QString &iAppName)
+void LogExportThread::exportToHtmlPublic(const QString &fileName, const LogRecordView<LOG_MSG_APPLICATOIN> &jList, const QStringList &labels, const QString &iAppName)
 {
     m_fileName = fileName;
     m_appList = jList;
@@ -262,7 +268,7 @@ void LogExportThread::exportToHtmlPublic(const QString &fileName, const QList<LO
  * @param jList  要导出的数据源 LOG_MSG_DPKG
  * @param labels 表头字符串
  */
-void LogExportThread::exportToHtmlPublic(const QString &fileName, const QList<LOG_MSG_DPKG> &jList, const QStringList &labels)
+void LogExportThread::exportToHtmlPublic(const QString &fileName, const LogRecordView<LOG_MSG_DPKG> &jList, const QStringList &labels)
 {
     m_fileName = fileName;
     m_dpkgList = jList;
@@ -277,7 +283,7 @@ void LogExportThread::exportToHtmlPublic(const QString &fileName, const QList<LO
  * @param jList  要导出的数据源 LOG_MSG_BOOT
  * @param labels 表头字符串
  */
-void LogExportThread::exportToHtmlPublic(const QString &fileName, const QList<LOG_MSG_BOOT> &jList, const QStringList &labels)
+void LogExportThread::exportToHtmlPublic(const QString &fileName, const LogRecordView<LOG_MSG_BOOT> &jList, const QStringList &labels)
 {
     m_fileName = fileName;
     m_bootList = jList;
@@ -292,7 +298,7 @@ void LogExportThread::exportToHtmlPublic(const QString &fileName, const QList<LO
  * @param jList 要导出的数据源 LOG_MSG_XORG
  * @param labels 表头字符串
  */
-void LogExportThread::exportToHtmlPublic(const QString &fileName, const QList<LOG_MSG_XORG> &jList, const QStringList &labels)
+void LogExportThread::exportToHtmlPublic(const QString &fileName, const LogRecordView<LOG_MSG_XORG> &jList, const QStringList &labels)
 {
     m_fileName = fileName;
     m_xorgList = jList;
@@ -307,7 +313,7 @@ void LogExportThread::exportToHtmlPublic(const QString &fileName, const QList<LO
  * @param jList 要导出的数据源 LOG_MSG_NORMAL
  * @param labels 表头字符串
  */
-void LogExportThread::exportToHtmlPublic(const QString &fileName, const QList<LOG_MSG_NORMAL> &jList, const QStringList &labels)
+void LogExportThread::exportToHtmlPublic(const QString &fileName, const LogRecordView<LOG_MSG_NORMAL> &jList, const QStringList &labels)
 {
     m_fileName = fileName;
     m_normalList = jList;
@@ -322,7 +328,7 @@ void LogExportThread::exportToHtmlPublic(const QString &fileName, const QList<LO
  * @param jList 要导出的数据源 LOG_MSG_KWIN
  * @param labels 表头字符串
  */
-void LogExportThread::exportToHtmlPublic(const QString &fileName, const QList<LOG_MSG_KWIN> &jList, const QStringList &labels)
+void LogExportThread::exportToHtmlPublic(const QString &fileName, const LogRecordView<LOG_MSG_KWIN> &jList, const QStringList &labels)
 {
     m_fileName = fileName;
     m_kwinList = jList;
@@ -330,7 +336,7 @@ void LogExportThread::exportToHtmlPublic(const QString &fileName, const QList<LO
     m_runMode = HtmlKWIN;
     m_canRunning = true;
 }
-void LogExportThread::exportToHtmlPublic(const QString &fileName, const QList<LOG_MSG_DNF> &jList, const QStringList &labels)
+void LogExportThread::exportToHtmlPublic(const QString &fileName, const LogRecordView<LOG_MSG_DNF> &jList, const QStringList &labels)
 {
     m_fileName = fileName;
     m_dnfList = jList;
@@ -339,7 +345,7 @@ void LogExportThread::exportToHtmlPublic(const QString &fileName, const QList<LO
     m_canRunning = true;
 }
 
-void LogExportThread::exportToHtmlPublic(const QString &fileName, const QList<LOG_MSG_DMESG> &jList, const QStringList &labels)
+void LogExportThread::exportToHtmlPublic(const QString &fileName, const LogRecordView<LOG_MSG_DMESG> &jList, const QStringList &labels)
 {
     m_fileName = fileName;
     m_dmesgList = jList;
@@ -348,7 +354,7 @@ void LogExportThread::exportToHtmlPublic(const QString &fileName, const QList<LO
     m_canRunning = true;
 }
 
-void LogExportThread::exportToHtmlPublic(const QString &fileName, const QList<LOG_MSG_AUDIT> &jList, const QStringList &labels)
+void LogExportThread::exportToHtmlPublic(const QString &fileName, const LogRecordView<LOG_MSG_AUDIT> &jList, const QStringList &labels)
 {
     m_fileName = fileName;
     m_alist = jList;
@@ -358,12 +364,12 @@ void LogExportThread::exportToHtmlPublic(const QString &fileName, const QList<LO
 }
 
 /**
- * @brief LogExportThread::exportToDocPublic导出到日志doc格式配置函数对QStandardItemModel数据类型的重载
+ * @brief LogExportThread::exportToDocPublic导出到日志doc格式配置函数对model数据类型的重载
  * @param fileName 导出文件路径全称
- * @param pModel 要导出的数据源，为QStandardItemModel
+ * @param pModel 要导出的数据源，为主表的model
  * @param flag 导出的日志类型
  */
-void LogExportThread::exportToDocPublic(const QString &fileName, QStandardItemModel *pModel, LOG_FLAG flag)
+void LogExportThread::exportToDocPublic(const QString &fileName, QAbstractItemModel *pModel, LOG_FLAG flag)
 {
     m_fileName = fileName;
     m_pModel = pModel;
@@ -380,7 +386,7 @@ void LogExportThread::exportToDocPublic(const QString &fileName, QStandardItemMo
  * @param labels 表头字符串
  * @param flag  导出的日志类型
  */
-void LogExportThread::exportToDocPublic(const QString &fileName, const QList<LOG_MSG_JOURNAL> &jList, const QStringList &labels, LOG_FLAG iFlag)
+void LogExportThread::exportToDocPublic(const QString &fileName, const LogRecordView<LOG_MSG_JOURNAL> &jList, const QStringList &labels, LOG_FLAG iFlag)
 {
     m_fileName = fileName;
     m_jList = jList;
@@ -398,7 +404,7 @@ void LogExportThread::exportToDocPublic(const QString &fileName, const QList<LOG
  * @param labels 表头字符串
  * @param iAppName 导出的应用日志的应用名称
  */
-void LogExportThread::exportToDocPublic(const QString &fileName, const QList<LOG_MSG_APPLICATOIN> &jList, const QStringList &labels, const QString &iAppName)
+void LogExportThread::exportToDocPublic(const QString &fileName, const LogRecordView<LOG_MSG_APPLICATOIN> &jList, const QStringList &labels, const QString &iAppName)
 {
     m_fileName = fileName;
     m_appList = jList;
@@ -414,7 +420,7 @@ void LogExportThread::exportToDocPublic(const QString &fileName, const QList<LOG
  * @param jList  要导出的数据源 LOG_MSG_DPKG
  * @param labels 表头字符串
  */
-void LogExportThread::exportToDocPublic(const QString &fileName, const QList<LOG_MSG_DPKG> &jList, const QStringList &labels)
+void LogExportThread::exportToDocPublic(const QString &fileName, const LogRecordView<LOG_MSG_DPKG> &jList, const QStringList &labels)
 {
     m_fileName = fileName;
     m_dpkgList = jList;
@@ -429,7 +435,7 @@ void LogExportThread::exportToDocPublic(const QString &fileName, const QList<LOG
  * @param jList  要导出的数据源 LOG_MSG_BOOT
  * @param labels 表头字符串
  */
-void LogExportThread::exportToDocPublic(const QString &fileName, const QList<LOG_MSG_BOOT> &jList, const QStringList &labels)
+void LogExportThread::exportToDocPublic(const QString &fileName, const LogRecordView<LOG_MSG_BOOT> &jList, const QStringList &labels)
 {
     m_fileName = fileName;
     m_bootList = jList;
@@ -444,7 +450,7 @@ void LogExportThread::exportToDocPublic(const QString &fileName, const QList<LOG
  * @param jList 要导出的数据源 LOG_MSG_XORG
  * @param labels 表头字符串
  */
-void LogExportThread::exportToDocPublic(const QString &fileName, const QList<LOG_MSG_XORG> &jList, const QStringList &labels)
+void LogExportThread::exportToDocPublic(const QString &fileName, const LogRecordView<LOG_MSG_XORG> &jList, const QStringList &labels)
 {
     m_fileName = fileName;
     m_xorgList = jList;
@@ -459,7 +465,7 @@ void LogExportThread::exportToDocPublic(const QString &fileName, const QList<LOG
  * @param jList 要导出的数据源 LOG_MSG_NORMAL
  * @param labels 表头字符串
  */
-void LogExportThread::exportToDocPublic(const QString &fileName, const QList<LOG_MSG_NORMAL> &jList, const QStringList &labels)
+void LogExportThread::exportToDocPublic(const QString &fileName, const LogRecordView<LOG_MSG_NORMAL> &jList, const QStringList &labels)
 {
     m_fileName = fileName;
     m_normalList = jList;
@@ -474,7 +480,7 @@ void LogExportThread::exportToDocPublic(const QString &fileName, const QList<LOG
  * @param jList 要导出的数据源 LOG_MSG_KWIN
  * @param labels 表头字符串
  */
-void LogExportThread::exportToDocPublic(const QString &fileName, const QList<LOG_MSG_KWIN> &jList, const QStringList &labels)
+void LogExportThread::exportToDocPublic(const QString &fileName, const LogRecordView<LOG_MSG_KWIN> &jList, const QStringList &labels)
 {
     m_fileName = fileName;
     m_kwinList = jList;
@@ -482,7 +488,7 @@ void LogExportThread::exportToDocPublic(const QString &fileName, const QList<LOG
     m_runMode = DocKWIN;
     m_canRunning = true;
 }
-void LogExportThread::exportToDocPublic(const QString &fileName, const QList<LOG_MSG_DNF> &jList, const QStringList &labels)
+void LogExportThread::exportToDocPublic(const QString &fileName, const LogRecordView<LOG_MSG_DNF> &jList, const QStringList &labels)
 {
     m_fileName = fileName;
     m_dnfList = jList;
@@ -491,7 +497,7 @@ void LogExportThread::exportToDocPublic(const QString &fileName, const QList<LOG
     m_canRunning = true;
 }
 
-void LogExportThread::exportToDocPublic(const QString &fileName, const QList<LOG_MSG_DMESG> &jList, const QStringList &labels)
+void LogExportThread::exportToDocPublic(const QString &fileName, const LogRecordView<LOG_MSG_DMESG> &jList, const QStringList &labels)
 {
     m_fileName = fileName;
     m_dmesgList = jList;
@@ -500,7 +506,7 @@ void LogExportThread::exportToDocPublic(const QString &fileName, const QList<LOG
     m_canRunning = true;
 }
 
-void LogExportThread::exportToDocPublic(const QString &fileName, const QList<LOG_MSG_AUDIT> &jList, const QStringList &labels)
+void LogExportThread::exportToDocPublic(const QString &fileName, const LogRecordView<LOG_MSG_AUDIT> &jList, const QStringList &labels)
 {
     m_fileName = fileName;
     m_alist = jList;
@@ -509,12 +515,12 @@ void LogExportThread::exportToDocPublic(const QString &fileName, const QList<LOG
     m_canRunning = true;
 }
 /**
- * @brief LogExportThread::exportToXlsPublic 导出到日志xlsx格式配置函数对QStandardItemModel数据类型的重载
+ * @brief LogExportThread::exportToXlsPublic 导出到日志xlsx格式配置函数对model数据类型的重载
  * @param fileName 导出文件路径全称
- * @param pModel 要导出的数据源，为QStandardItemModel
+ * @param pModel 要导出的数据源，为主表的model
  * @param flag 导出的日志类型
  */
-void LogExportThread::exportToXlsPublic(const QString &fileName, QStandardItemModel *pModel, LOG_FLAG flag)
+void LogExportThread::exportToXlsPublic(const QString &fileName, QAbstractItemModel *pModel, LOG_FLAG flag)
 {
     m_fileName = fileName;
     m_pModel = pModel;
@@ -530,7 +536,7 @@ void LogExportThread::exportToXlsPublic(const QString &fileName, QStandardItemMo
  * @param labels 表头字符串
  * @param flag  导出的日志类型
  */
-void LogExportThread::exportToXlsPublic(const QString &fileName, const QList<LOG_MSG_JOURNAL> &jList, const QStringList &labels, LOG_FLAG iFlag)
+void LogExportThread::exportToXlsPublic(const QString &fileName, const LogRecordView<LOG_MSG_JOURNAL> &jList, const QStringList &labels, LOG_FLAG iFlag)
 {
     m_fileName = fileName;
     m_jList = jList;
@@ -547,7 +553,7 @@ void LogExportThread::exportToXlsPublic(const QString &fileName, const QList<LOG
  * @param labels 表头字符串
  * @param iAppName 导出的应用日志的应用名称
  */
-void LogExportThread::exportToXlsPublic(const QString &fileName, const QList<LOG_MSG_APPLICATOIN> &jList, const QStringList &labels, const QString &iAppName)
+void LogExportThread::exportToXlsPublic(const QString &fileName, const LogRecordView<LOG_MSG_APPLICATOIN> &jList, const QStringList &labels, const QString &iAppName)
 {
     m_fileName = fileName;
     m_appList = jList;
@@ -563,7 +569,7 @@ void LogExportThread::exportToXlsPublic(const QString &fileName, const QList<LOG
  * @param jList  要导出的数据源 LOG_MSG_DPKG
  * @param labels 表头字符串
  */
-void LogExportThread::exportToXlsPublic(const QString &fileName, const QList<LOG_MSG_DPKG> &jList, const QStringList &labels)
+void LogExportThread::exportToXlsPublic(const QString &fileName, const LogRecordView<LOG_MSG_DPKG> &jList, const QStringList &labels)
 {
     m_fileName = fileName;
     m_dpkgList = jList;
@@ -578,7 +584,7 @@ void LogExportThread::exportToXlsPublic(const QString &fileName, const QList<LOG
  * @param jList  要导出的数据源 LOG_MSG_DPKG
  * @param labels 表头字符串
  */
-void LogExportThread::exportToXlsPublic(const QString &fileName, const QList<LOG_MSG_BOOT> &jList, const QStringList &labels)
+void LogExportThread::exportToXlsPublic(const QString &fileName, const LogRecordView<LOG_MSG_BOOT> &jList, const QStringList &labels)
 {
     m_fileName = fileName;
     m_bootList = jList;
@@ -593,7 +599,7 @@ void LogExportThread::exportToXlsPublic(const QString &fileName, const QList<LOG
  * @param jList 要导出的数据源 LOG_MSG_XORG
  * @param labels 表头字符串
  */
-void LogExportThread::exportToXlsPublic(const QString &fileName, const QList<LOG_MSG_XORG> &jList, const QStringList &labels)
+void LogExportThread::exportToXlsPublic(const QString &fileName, const LogRecordView<LOG_MSG_XORG> &jList, const QStringList &labels)
 {
     m_fileName = fileName;
     m_xorgList = jList;
@@ -608,7 +614,7 @@ void LogExportThread::exportToXlsPublic(const QString &fileName, const QList<LOG
  * @param jList 要导出的数据源 LOG_MSG_NORMAL
  * @param labels 表头字符串
  */
-void LogExportThread::exportToXlsPublic(const QString &fileName, const QList<LOG_MSG_NORMAL> &jList, const QStringList &labels)
+void LogExportThread::exportToXlsPublic(const QString &fileName, const LogRecordView<LOG_MSG_NORMAL> &jList, const QStringList &labels)
 {
     m_fileName = fileName;
     m_normalList = jList;
@@ -623,7 +629,7 @@ void LogExportThread::exportToXlsPublic(const QString &fileName, const QList<LOG
  * @param jList 要导出的数据源 LOG_MSG_KWIN
  * @param labels 表头字符串
  */
-void LogExportThread::exportToXlsPublic(const QString &fileName, const QList<LOG_MSG_KWIN> &jList, const QStringList &labels)
+void LogExportThread::exportToXlsPublic(const QString &fileName, const LogRecordView<LOG_MSG_KWIN> &jList, const QStringList &labels)
 {
     m_fileName = fileName;
     m_kwinList = jList;
@@ -631,7 +637,7 @@ void LogExportThread::exportToXlsPublic(const QString &fileName, const QList<LOG
     m_runMode = XlsKWIN;
     m_canRunning = true;
 }
-void LogExportThread::exportToXlsPublic(const QString &fileName, const QList<LOG_MSG_DNF> &jList, const QStringList &labels)
+void LogExportThread::exportToXlsPublic(const QString &fileName, const LogRecordView<LOG_MSG_DNF> &jList, const QStringList &labels)
 {
     m_fileName = fileName;
     m_dnfList = jList;
@@ -640,7 +646,7 @@ void LogExportThread::exportToXlsPublic(const QString &fileName, const QList<LOG
     m_canRunning = true;
 }
 
-void LogExportThread::exportToXlsPublic(const QString &fileName, const QList<LOG_MSG_DMESG> &jList, const QStringList &labels)
+void LogExportThread::exportToXlsPublic(const QString &fileName, const LogRecordView<LOG_MSG_DMESG> &jList, const QStringList &labels)
 {
     m_fileName = fileName;
     m_dmesgList = jList;
@@ -649,7 +655,7 @@ void LogExportThread::exportToXlsPublic(const QString &fileName, const QList<LOG
     m_canRunning = true;
 }
 
-void LogExportThread::exportToXlsPublic(const QString &fileName, const QList<LOG_MSG_AUDIT> &jList, const QStringList &labels)
+void LogExportThread::exportToXlsPublic(const QString &fileName, const LogRecordView<LOG_MSG_AUDIT> &jList, const QStringList &labels)
 {
     m_fileName = fileName;
     m_alist = jList;
@@ -685,13 +691,13 @@ void LogExportThread::stopImmediately()
 }
 
 /**
- * @brief LogExportThread::exportToTxt 导出数据到txt格式函数对QStandardItemModel数据类型的重载
+ * @brief LogExportThread::exportToTxt 导出数据到txt格式函数对model数据类型的重载
  * @param fileName 导出文件路径全称
- * @param pModel 要导出的数据源，为QStandardItemModel
+ * @param pModel 要导出的数据源，为主表的model
  * @param flag 导出的日志类型
  * @return 是否导出成功
  */
-bool LogExportThread::exportToTxt(const QString &fileName, QStandardItemModel *pModel, LOG_FLAG flag)
+bool LogExportThread::exportToTxt(const QString &fileName, QAbstractItemModel *pModel, LOG_FLAG flag)
 {
     QFile fi(fileName);
     //判断文件路径是否存在，不存在就返回错误
@@ -700,12 +706,19 @@ bool LogExportThread::exportToTxt(const QString &fileName, QStandardItemModel *p
         emit sigError(openErroStr);
         return false;
     }
+    //文件名以.gz结尾时边导出边压缩,压缩在单独的线程中进行
+    LogGzipWriter gzip(&fi);
+    if (LogGzipWriter::isGzipFileName(fileName) && !gzip.open(QIODevice::WriteOnly)) {
+        emit sigResult(false);
+        emit sigError(openErroStr);
+        return false;
+    }
     try {
         //判读啊model指针是为空，为空则不导出
         if (!pModel) {
             throw  QString("model is null");
         }
-        QTextStream out(&fi);
+        LogExportWriter out(gzip.isOpen() ? static_cast<QIODevice *>(&gzip) : &fi);
         //日志类型为应用日志时
         if (flag == APP) {
             for (int row = 0; row < pModel->rowCount(); ++row) {
@@ -714,15 +727,15 @@ bool LogExportThread::exportToTxt(const QString &fileName, QStandardItemModel *p
                     throw  QString(stopStr);
                 }
                 //获取表头项目和对应内容，拼成目标字符串写入文件
-                out << pModel->horizontalHeaderItem(0)->text() << ": "
-                    << pModel->item(row, 0)->data(Qt::UserRole + 6).toString() << " ";
+                out << pModel->headerData(0, Qt::Horizontal).toString() << ": "
+                    << pModel->index(row, 0).data(Qt::UserRole + 6).toString() << " ";
                 for (int col = 1; col < pModel->columnCount(); ++col) {
-                    out << pModel->horizontalHeaderItem(col)->text() << ": "
-                        << pModel->item(row, col)->text() << " ";
+                    out << pModel->headerData(col, Qt::Horizontal).toString() << ": "
+                        << pModel->index(row, col).data().toString() << " ";
                 }
                 out << "\n";
                 //导出进度信号
-                sigProgress(row + 1, pModel->rowCount());
+                reportProgress(row + 1, pModel->rowCount());
             }
         } else {
             //日志类型为其他所有日志时
@@ -733,17 +746,21 @@ bool LogExportThread::exportToTxt(const QString &fileName, QStandardItemModel *p
                 }
                 //获取表头项目和对应内容，拼成目标字符串写入文件
                 for (int col = 0; col < pModel->columnCount(); col++) {
-                    out << pModel->horizontalHeaderItem(col)->text() << ": "
-                        << pModel->item(row, col)->text() << " ";
+                    out << pModel->headerData(col, Qt::Horizontal).toString() << ": "
+                        << pModel->index(row, col).data().toString() << " ";
                 }
                 out << "\n";
                 //导出进度信号
-                sigProgress(row + 1, pModel->rowCount());
+                reportProgress(row + 1, pModel->rowCount());
             }
         }
+        if (!out.flush() || (gzip.isOpen() && !gzip.finish()))
+            throw QString("write export file failed");
     } catch (const QString &ErrorStr) {
         //捕获到异常，导出失败，发出失败信号
         qCWarning(logExport) << "Export Stop" << ErrorStr;
+        //先结束压缩线程再关闭文件
+        gzip.close();
         fi.close();
         emit sigResult(false);
         if (ErrorStr != stopStr) {
@@ -758,14 +775,101 @@ bool LogExportThread::exportToTxt(const QString &fileName, QStandardItemModel *p
 }
 
 /**
- * @brief LogExportThread::exportToTxt导出到日志txt格式函数，对LOG_MSG_JOURNAL数据类型的重载（指系统日志和内核日志）
+ * @brief LogExportThread::writeRecords 各导出格式共用的逐条导出循环
+ * 外部把m_canRunning置false时停止运行，抛出异常处理；每写完一条记录更新一次进度
+ * @param jList 要导出的数据源
+ * @param progressTotal 进度的总数
+ * @param writeRow 按导出列写入一条记录
+ */
+template <typename Traits, typename WriteRow>
+void LogExportThread::writeRecords(const LogRecordView<typename Traits::Record> &jList, int progressTotal, WriteRow writeRow)
+{
+    LogRecordLoader<typename Traits::Record> loader;
+    for (int row = 0; row < jList.count(); ++row) {
+        if (!m_canRunning) {
+            throw QString(stopStr);
+        }
+        writeRow(loader.load(jList.at(row)));
+        //导出进度信号
+        reportProgress(row + 1, progressTotal);
+    }
+}
+
+/**
+ * @brief LogExportThread::writeRecordBlocks 按块并行格式化记录,再按原顺序逐块写入,写出的内容和逐条写入一致
+ * 每LOG_EXPORT_FORMAT_BLOCK条记录为一块,在导出线程池中各自用自己的LogRecordLoader格式化到块缓冲中,
+ * 本线程按块的顺序取结果写入,同时最多有导出线程池线程数的块在格式化,内存占用和记录数无关
+ * @param empty 空的块缓冲
+ * @param formatRow 把一条记录追加到块缓冲,在线程池中并发调用,只能读取记录和m_formatter
+ * @param writeBlock 在本线程中写入一块,写入失败时抛出QString
+ */
+template <typename Traits, typename Block, typename FormatRow, typename WriteBlock>
+void LogExportThread::writeRecordBlocks(const LogRecordView<typename Traits::Record> &jList, int progressTotal, const Block &empty,
+                                        FormatRow formatRow, WriteBlock writeBlock)
+{
+    typedef typename Traits::Record Record;
+    const int count = jList.count();
+    const int blocks = (count + LOG_EXPORT_FORMAT_BLOCK - 1) / LOG_EXPORT_FORMAT_BLOCK;
+    const int window = qMax(2, LogWorkScheduler::instance()->maxThreads(LogWorkScheduler::Export));
+    QVector<QFuture<Block>> pending(blocks);
+    auto startBlock = [&](int block) {
+        if (block >= blocks)
+            return;
+        pending[block] = LogWorkScheduler::instance()->run(LogWorkScheduler::Export, [this, &jList, &empty, &formatRow, block, count]() {
+            Block rows = empty;
+            LogRecordLoader<Record> loader;
+            const int end = qMin(count, (block + 1) * LOG_EXPORT_FORMAT_BLOCK);
+            for (int row = block * LOG_EXPORT_FORMAT_BLOCK; row < end && m_canRunning; ++row)
+                formatRow(rows, loader.load(jList.at(row)));
+            finishBlock(rows);
+            return rows;
+        });
+    };
+    //格式化任务引用了本函数的参数,停止或写入失败时也要等它们结束再返回
+    auto waitPending = [&pending]() {
+        for (auto &future : pending)
+            future.waitForFinished();
+    };
+    for (int block = 0; block < window; ++block)
+        startBlock(block);
+    try {
+        for (int block = 0; block < blocks; ++block) {
+            //等待时优先在本线程中运行还没开始的任务,线程池占满时也不会互相等待
+            const Block rows = pending[block].result();
+            pending[block] = QFuture<Block>();
+            startBlock(block + window);
+            if (!m_canRunning)
+                throw QString(stopStr);
+            writeBlock(rows);
+            //导出进度信号
+            reportProgress(qMin(count, (block + 1) * LOG_EXPORT_FORMAT_BLOCK), progressTotal);
+        }
+    } catch (...) {
+        waitPending();
+        throw;
+    }
+}
+
+/**
+ * @brief LogExportThread::finishBlock 在格式化线程中把一块html转为utf8,写入线程只写字节
+ */
+void LogExportThread::finishBlock(HtmlRows &rows)
+{
+    rows.utf8 = rows.text.toUtf8();
+    rows.text.clear();
+}
+
+/**
+ * @brief LogExportThread::exportRecordsToTxt 按日志类型的导出列导出到txt格式，每个字段写为"表头:内容 "
+ * 文件名为.ndjson时每条记录写为一行json，后缀再加.gz时边导出边压缩
  * @param fileName 导出文件路径全称
- * @param jList 要导出的数据源 数据类型为LOG_MSG_JOURNAL
+ * @param jList 要导出的数据源
  * @param labels 表头字符串
- * @param flag  导出的日志类型
+ * @param appName 应用日志导出的应用名称，其他日志不使用
  * @return 是否导出成功
  */
-bool LogExportThread::exportToTxt(const QString &fileName, const QList<LOG_MSG_JOURNAL> &jList,  const QStringList &labels, LOG_FLAG flag)
+template <typename Traits>
+bool LogExportThread::exportRecordsToTxt(const QString &fileName, const LogRecordView<typename Traits::Record> &jList, const QStringList &labels, const QString &appName)
 {
     //判断文件路径是否存在，不存在就返回错误
     QFile fi(fileName);
@@ -774,65 +878,30 @@ bool LogExportThread::exportToTxt(const QString &fileName, const QList<LOG_MSG_J
         emit sigError(openErroStr);
         return false;
     }
+    //文件名以.gz结尾时边导出边压缩,压缩在单独的线程中进行
+    LogGzipWriter gzip(&fi);
+    if (LogGzipWriter::isGzipFileName(fileName) && !gzip.open(QIODevice::WriteOnly)) {
+        emit sigResult(false);
+        emit sigError(openErroStr);
+        return false;
+    }
     try {
-
-        QTextStream out(&fi);
-        //导出日志为系统日志时
-        if (flag == JOURNAL) {
-            for (int i = 0; i < jList.count(); i++) {
-                //导出逻辑启动停止控制，外部把m_canRunning置false时停止运行，抛出异常处理
-                if (!m_canRunning) {
-                    throw  QString(stopStr);
-                }
-                LOG_MSG_JOURNAL jMsg = jList.at(i);
-                //        out << QString(DApplication::translate("Table", "Date and Time:")) <<
-                //        jMsg.dateTime << " "; out << QString(DApplication::translate("Table", "User:")) <<
-                //        jMsg.hostName << " "; out << QString(DApplication::translate("Table", "Daemon:"))
-                //        << jMsg.daemonName << " "; out << QString(DApplication::translate("Table",
-                //        "PID:")) << jMsg.daemonId << " "; out << QString(DApplication::translate("Table",
-                //        "Level:")) << jMsg.level << " "; out << QString(DApplication::translate("Table",
-                //        "Info:")) << jMsg.msg << " "; //delete bug
-                //导出各字段的描述和对应内容拼成目标字符串
-                out << QString(DApplication::translate("Table", "Level:")) << jMsg.level << " ";
-                out << QString(DApplication::translate("Table", "Process:")) << jMsg.daemonName << " ";
-                out << QString(DApplication::translate("Table", "Date and Time:")) << jMsg.dateTime << " ";
-                if (jMsg.msg.isEmpty()) {
-                    out << QString(DApplication::translate("Table", "Info:"))
-                        << QString(DApplication::translate("Table", "Null")) << " ";  // modify for bug
-                } else {
-                    out << QString(DApplication::translate("Table", "Info:")) << jMsg.msg << " ";
-                }
-                out << QString(DApplication::translate("Table", "User:")) << jMsg.hostName << " ";
-                out << QString(DApplication::translate("Table", "PID:")) << jMsg.daemonId << " ";
-                out << "\n";
-                //导出进度信号
-                sigProgress(i + 1, jList.count());
-            }
-        } else if (flag == KERN) {
-            //导出日志为内核日志时
-            for (int i = 0; i < jList.count(); i++) {
-                //导出逻辑启动停止控制，外部把m_canRunning置false时停止运行，抛出异常处理
-                if (!m_canRunning) {
-                    throw  QString(stopStr);
-                }
-                int col = 0;
-                LOG_MSG_JOURNAL jMsg = jList.at(i);
-                //导出各字段的描述和对应内容拼成目标字符串
-                out << labels.value(col++, "") << ":" << jMsg.dateTime << " ";
-                out << labels.value(col++, "") << ":" << jMsg.hostName << " ";
-                out << labels.value(col++, "") << ":" << jMsg.daemonName << " ";
-                out << labels.value(col++, "") << ":" << jMsg.msg << " ";
-                out << "\n";
-                //导出进度信号
-                sigProgress(i + 1, jList.count());
-            }
-        }
-        //设置文件编码为utf8
-        out.setCodec(QTextCodec::codecForName("utf-8"));
-
+        LogExportWriter out(gzip.isOpen() ? static_cast<QIODevice *>(&gzip) : &fi);
+        //ndjson文件每行写一个json对象,供其他程序批量读取
+        const bool json = isJsonFileName(fileName);
+        writeRecords<Traits>(jList, jList.count(), [&](const typename Traits::Record &record) {
+            if (json)
+                m_formatter.writeJsonLine<Traits>(out, record, appName);
+            else
+                m_formatter.writeTextLine<Traits>(out, record, labels, appName);
+        });
+        if (!out.flush() || (gzip.isOpen() && !gzip.finish()))
+            throw QString("write export file failed");
     } catch (const QString &ErrorStr) {
         //捕获到异常，导出失败，发出失败信号
         qCWarning(logExport) << "Export Stop" << ErrorStr;
+        //先结束压缩线程再关闭文件
+        gzip.close();
         fi.close();
         emit sigResult(false);
         if (ErrorStr != stopStr) {
@@ -847,2315 +916,511 @@ bool LogExportThread::exportToTxt(const QString &fileName, const QList<LOG_MSG_J
 }
 
 /**
- * @brief LogExportThread::exportToTxt导出到日志txt格式函数，对LOG_MSG_APPLICATOIN数据类型的重载（指应用日志）
+ * @brief LogExportThread::exportToTxt 系统日志和内核日志导出到txt格式，按flag选择导出列
+ */
+bool LogExportThread::exportToTxt(const QString &fileName, const LogRecordView<LOG_MSG_JOURNAL> &jList, const QStringList &labels, LOG_FLAG flag)
+{
+    if (flag == KERN)
+        return exportRecordsToTxt<LogExportTraits<LOG_MSG_JOURNAL, KERN>>(fileName, jList, labels);
+    return exportRecordsToTxt<LogExportTraits<LOG_MSG_JOURNAL, JOURNAL>>(fileName, jList, labels);
+}
+
+/**
+ * @brief LogExportThread::exportToTxt 应用日志导出到txt格式
+ * @param iAppName 导出的应用日志的应用名称
+ */
+bool LogExportThread::exportToTxt(const QString &fileName, const LogRecordView<LOG_MSG_APPLICATOIN> &jList, const QStringList &labels, const QString &iAppName)
+{
+    return exportRecordsToTxt<LogExportTraits<LOG_MSG_APPLICATOIN>>(fileName, jList, labels, iAppName);
+}
+
+/**
+ * @brief LogExportThread::exportToTxt dpkg日志导出到txt格式
+ */
+bool LogExportThread::exportToTxt(const QString &fileName, const LogRecordView<LOG_MSG_DPKG> &jList, const QStringList &labels)
+{
+    return exportRecordsToTxt<LogExportTraits<LOG_MSG_DPKG>>(fileName, jList, labels);
+}
+
+/**
+ * @brief LogExportThread::exportToTxt 启动日志导出到txt格式
+ */
+bool LogExportThread::exportToTxt(const QString &fileName, const LogRecordView<LOG_MSG_BOOT> &jList, const QStringList &labels)
+{
+    return exportRecordsToTxt<LogExportTraits<LOG_MSG_BOOT>>(fileName, jList, labels);
+}
+
+/**
+ * @brief LogExportThread::exportToTxt xorg日志导出到txt格式
+ */
+bool LogExportThread::exportToTxt(const QString &fileName, const LogRecordView<LOG_MSG_XORG> &jList, const QStringList &labels)
+{
+    return exportRecordsToTxt<LogExportTraits<LOG_MSG_XORG>>(fileName, jList, labels);
+}
+
+/**
+ * @brief LogExportThread::exportToTxt 开关机日志导出到txt格式
+ */
+bool LogExportThread::exportToTxt(const QString &fileName, const LogRecordView<LOG_MSG_NORMAL> &jList, const QStringList &labels)
+{
+    return exportRecordsToTxt<LogExportTraits<LOG_MSG_NORMAL>>(fileName, jList, labels);
+}
+
+/**
+ * @brief LogExportThread::exportToTxt kwin日志导出到txt格式
+ */
+bool LogExportThread::exportToTxt(const QString &fileName, const LogRecordView<LOG_MSG_KWIN> &jList, const QStringList &labels)
+{
+    return exportRecordsToTxt<LogExportTraits<LOG_MSG_KWIN>>(fileName, jList, labels);
+}
+
+/**
+ * @brief LogExportThread::exportToTxt dnf日志导出到txt格式
+ */
+bool LogExportThread::exportToTxt(const QString &fileName, const LogRecordView<LOG_MSG_DNF> &jList, const QStringList &labels)
+{
+    return exportRecordsToTxt<LogExportTraits<LOG_MSG_DNF>>(fileName, jList, labels);
+}
+
+/**
+ * @brief LogExportThread::exportToTxt dmesg日志导出到txt格式
+ */
+bool LogExportThread::exportToTxt(const QString &fileName, const LogRecordView<LOG_MSG_DMESG> &jList, const QStringList &labels)
+{
+    return exportRecordsToTxt<LogExportTraits<LOG_MSG_DMESG>>(fileName, jList, labels);
+}
+
+/**
+ * @brief LogExportThread::exportToTxt 审计日志导出到txt格式
+ */
+bool LogExportThread::exportToTxt(const QString &fileName, const LogRecordView<LOG_MSG_AUDIT> &jList, const QStringList &labels)
+{
+    return exportRecordsToTxt<LogExportTraits<LOG_MSG_AUDIT>>(fileName, jList, labels);
+}
+
+/**
+ * @brief LogExportThread::exportRecordsToDoc 按日志类型的导出列导出到doc格式
+ * 模板按列数命名，只使用其中的样式
  * @param fileName 导出文件路径全称
- * @param jList 要导出的数据源 数据类型为LOG_MSG_APPLICATOIN
+ * @param jList 要导出的数据源
  * @param labels 表头字符串
- * @param iAppName 导出的应用日志的应用名称
+ * @param appName 应用日志导出的应用名称，其他日志不使用
  * @return 是否导出成功
  */
-bool LogExportThread::exportToTxt(const QString &fileName, const QList<LOG_MSG_APPLICATOIN> &jList, const QStringList &labels, const QString &iAppName)
+template <typename Traits>
+bool LogExportThread::exportRecordsToDoc(const QString &fileName, const LogRecordView<typename Traits::Record> &jList, const QStringList &labels, const QString &appName)
 {
-    //判断文件路径是否存在，不存在就返回错误
-    QFile fi(fileName);
-    if (!fi.open(QIODevice::WriteOnly)) {
-        emit sigResult(false);
-        emit sigError(openErroStr);
-        return false;
-    }
     try {
-        QTextStream out(&fi);
-        out.setCodec(QTextCodec::codecForName("utf-8"));
-        for (int i = 0; i < jList.count(); i++) {
-            //导出逻辑启动停止控制，外部把m_canRunning置false时停止运行，抛出异常处理
-            if (!m_canRunning) {
-                throw  QString(stopStr);
-            }
-            int col = 0;
-            //导出各字段的描述和对应内容拼成目标字符串
-            LOG_MSG_APPLICATOIN jMsg = jList.at(i);
-            out << labels.value(col++, "") << ":" << strTranslate(jMsg.level)  << " ";
-            out << labels.value(col++, "") << ":" << jMsg.dateTime << " ";
-            out << labels.value(col++, "") << ":" << iAppName << " ";
-            out << labels.value(col++, "") << ":" << jMsg.msg << " ";
-            out << "\n";
-            //导出进度信号
-            sigProgress(i + 1, jList.count());
+        const QString tempdir = QString("/usr/share/deepin-log-viewer/DocxTemplate/%1column.dfw").arg(Traits::columnCount);
+        if (!QFile(tempdir).exists()) {
+            qCWarning(logExport) << "export docx template is not exisits";
+            return  false;
         }
+
+        LogDocxWriter docx(fileName, tempdir, labels);
+        if (!docx.isOpen())
+            throw QString("create docx file failed");
+        //表格行的xml在导出线程池中生成,本线程只按顺序压缩写入
+        writeRecordBlocks<Traits>(jList, jList.count(), LogDocxWriter::Rows(docx.columnCount()),
+                                  [&](LogDocxWriter::Rows &rows, const typename Traits::Record &record) {
+                                      //把数据填入表格单元格中,等级直接写入预先转义的文字
+                                      for (const LogExportColumn<typename Traits::Record> &column : Traits::columns) {
+                                          if (const LogRecordFormatter::CodeCell *code = m_formatter.codeCell(column, record))
+                                              rows.appendEscaped(code->xml);
+                                          else
+                                              rows << m_formatter.cellText(column, record, appName);
+                                      }
+                                      rows.endRow();
+                                  },
+                                  [&](const LogDocxWriter::Rows &rows) { docx.writeRows(rows); });
+        if (!docx.close())
+            throw QString("write docx file failed");
     } catch (const QString &ErrorStr) {
         //捕获到异常，导出失败，发出失败信号
         qCWarning(logExport) << "Export Stop" << ErrorStr;
-        fi.close();
+        if (!m_canRunning) {
+            Utils::checkAndDeleteDir(m_fileName);
+        }
+
         emit sigResult(false);
         if (ErrorStr != stopStr) {
             emit sigError(QString("export error: %1").arg(ErrorStr));
         }
         return false;
     }
-    fi.close();
+    //如果取消导出，则删除文件
+    if (!m_canRunning) {
+        Utils::checkAndDeleteDir(m_fileName);
+    }
+    //100%进度
+    sigProgress(100, 100);
+    //延时200ms再发送导出成功信号，关闭导出进度框，让100%的进度有时间显示
+    Utils::sleep(200);
     //导出成功，如果此时被停止，则发出导出失败信号
     emit sigResult(m_canRunning);
     return m_canRunning;
 }
 
 /**
- * @brief LogExportThread::exportToTxt 导出到日志txt格式配置函数，对LOG_MSG_DPKG数据类型的重载（指dpkg日志）
+ * @brief LogExportThread::exportToDoc 系统日志和内核日志导出到doc格式，按iFlag选择导出列
+ */
+bool LogExportThread::exportToDoc(const QString &fileName, const LogRecordView<LOG_MSG_JOURNAL> &jList, const QStringList &labels, LOG_FLAG iFlag)
+{
+    if (iFlag == KERN)
+        return exportRecordsToDoc<LogExportTraits<LOG_MSG_JOURNAL, KERN>>(fileName, jList, labels);
+    return exportRecordsToDoc<LogExportTraits<LOG_MSG_JOURNAL, JOURNAL>>(fileName, jList, labels);
+}
+
+/**
+ * @brief LogExportThread::exportToDoc 应用日志导出到doc格式
+ * @param iAppName 导出的应用日志的应用名称
+ */
+bool LogExportThread::exportToDoc(const QString &fileName, const LogRecordView<LOG_MSG_APPLICATOIN> &jList, const QStringList &labels, QString &iAppName)
+{
+    return exportRecordsToDoc<LogExportTraits<LOG_MSG_APPLICATOIN>>(fileName, jList, labels, iAppName);
+}
+
+/**
+ * @brief LogExportThread::exportToDoc dpkg日志导出到doc格式
+ */
+bool LogExportThread::exportToDoc(const QString &fileName, const LogRecordView<LOG_MSG_DPKG> &jList, const QStringList &labels)
+{
+    return exportRecordsToDoc<LogExportTraits<LOG_MSG_DPKG>>(fileName, jList, labels);
+}
+
+/**
+ * @brief LogExportThread::exportToDoc 启动日志导出到doc格式
+ */
+bool LogExportThread::exportToDoc(const QString &fileName, const LogRecordView<LOG_MSG_BOOT> &jList, const QStringList &labels)
+{
+    return exportRecordsToDoc<LogExportTraits<LOG_MSG_BOOT>>(fileName, jList, labels);
+}
+
+/**
+ * @brief LogExportThread::exportToDoc xorg日志导出到doc格式
+ */
+bool LogExportThread::exportToDoc(const QString &fileName, const LogRecordView<LOG_MSG_XORG> &jList, const QStringList &labels)
+{
+    return exportRecordsToDoc<LogExportTraits<LOG_MSG_XORG>>(fileName, jList, labels);
+}
+
+/**
+ * @brief LogExportThread::exportToDoc 开关机日志导出到doc格式
+ */
+bool LogExportThread::exportToDoc(const QString &fileName, const LogRecordView<LOG_MSG_NORMAL> &jList, const QStringList &labels)
+{
+    return exportRecordsToDoc<LogExportTraits<LOG_MSG_NORMAL>>(fileName, jList, labels);
+}
+
+/**
+ * @brief LogExportThread::exportToDoc kwin日志导出到doc格式
+ */
+bool LogExportThread::exportToDoc(const QString &fileName, const LogRecordView<LOG_MSG_KWIN> &jList, const QStringList &labels)
+{
+    return exportRecordsToDoc<LogExportTraits<LOG_MSG_KWIN>>(fileName, jList, labels);
+}
+
+/**
+ * @brief LogExportThread::exportToDoc dnf日志导出到doc格式
+ */
+bool LogExportThread::exportToDoc(const QString &fileName, const LogRecordView<LOG_MSG_DNF> &jList, const QStringList &labels)
+{
+    return exportRecordsToDoc<LogExportTraits<LOG_MSG_DNF>>(fileName, jList, labels);
+}
+
+/**
+ * @brief LogExportThread::exportToDoc dmesg日志导出到doc格式
+ */
+bool LogExportThread::exportToDoc(const QString &fileName, const LogRecordView<LOG_MSG_DMESG> &jList, const QStringList &labels)
+{
+    return exportRecordsToDoc<LogExportTraits<LOG_MSG_DMESG>>(fileName, jList, labels);
+}
+
+/**
+ * @brief LogExportThread::exportToDoc 审计日志导出到doc格式
+ */
+bool LogExportThread::exportToDoc(const QString &fileName, const LogRecordView<LOG_MSG_AUDIT> &jList, const QStringList &labels)
+{
+    return exportRecordsToDoc<LogExportTraits<LOG_MSG_AUDIT>>(fileName, jList, labels);
+}
+
+/**
+ * @brief LogExportThread::exportToHtml导出到日志html格式函数对model数据类型的重载
  * @param fileName 导出文件路径全称
- * @param jList  要导出的数据源 LOG_MSG_DPKG
- * @param labels 表头字符串
+ * @param pModel 要导出的数据源，为主表的model
+ * @param flag 导出的日志类型
  * @return 是否导出成功
  */
-bool LogExportThread::exportToTxt(const QString &fileName, const QList<LOG_MSG_DPKG> &jList, const QStringList &labels)
+bool LogExportThread::exportToHtml(const QString &fileName, QAbstractItemModel *pModel, LOG_FLAG flag)
 {
+    QFile html(fileName);
     //判断文件路径是否存在，不存在就返回错误
-    QFile fi(fileName);
-    if (!fi.open(QIODevice::WriteOnly)) {
+    if (!html.open(QIODevice::WriteOnly)) {
         emit sigResult(false);
         emit sigError(openErroStr);
         return false;
     }
     try {
-        QTextStream out(&fi);
-        out.setCodec(QTextCodec::codecForName("utf-8"));
-        for (int i = 0; i < jList.count(); i++) {
-            //导出逻辑启动停止控制，外部把m_canRunning置false时停止运行，抛出异常处理
-            if (!m_canRunning) {
-                throw  QString(stopStr);
+        LogExportWriter out(&html);
+        //判读啊model指针是为空，为空则不导出
+        if (!pModel) {
+            throw  QString("model is null");
+        }
+        //写网页头
+        out << "<!DOCTYPE html>\n";
+        out << "<html>\n";
+        out << "<body>\n";
+        //写入表格标签
+        out << "<table border=\"1\">\n";
+        // 写入表头
+        out << "<tr>";
+        for (int i = 0; i < pModel->columnCount(); ++i) {
+            writeHtmlCell(out, pModel->headerData(i, Qt::Horizontal).toString());
+        }
+        out << "</tr>";
+        // 写入内容
+        //日志类型为应用日志时
+        if (flag == APP) {
+            for (int row = 0; row < pModel->rowCount(); ++row) {
+                //导出逻辑启动停止控制，外部把m_canRunning置false时停止运行，抛出异常处理
+                if (!m_canRunning) {
+                    throw  QString(stopStr);
+                }
+                //根据字段拼出每行的网页内容
+                out << "<tr>";
+                writeHtmlCell(out, pModel->index(row, 0).data(Qt::UserRole + 6).toString());
+                for (int col = 1; col < pModel->columnCount(); ++col) {
+                    writeHtmlCell(out, pModel->index(row, col).data().toString());
+                }
+                out << "</tr>";
+                //导出进度信号
+                reportProgress(row + 1, pModel->rowCount());
+            }
+        } else {
+            //日志类型为其他所有日志时
+            for (int row = 0; row < pModel->rowCount(); ++row) {
+                //导出逻辑启动停止控制，外部把m_canRunning置false时停止运行，抛出异常处理
+                if (!m_canRunning) {
+                    throw  QString(stopStr);
+                }
+                //根据字段拼出每行的网页内容
+                out << "<tr>";
+                for (int col = 0; col < pModel->columnCount(); ++col) {
+                    writeHtmlCell(out, pModel->index(row, col).data().toString());
+                }
+                out << "</tr>";
+                //导出进度信号
+                reportProgress(row + 1, pModel->rowCount());
             }
-            int col = 0;
-            //导出各字段的描述和对应内容拼成目标字符串
-            LOG_MSG_DPKG jMsg = jList.at(i);
-            out << labels.value(col++, "") << ":" << jMsg.dateTime << " ";
-            out << labels.value(col++, "") << ":" << jMsg.msg << " ";
-            out << labels.value(col++, "") << ":" << jMsg.action << " ";
-            out << "\n";
-            //导出进度信号
-            sigProgress(i + 1, jList.count());
         }
+        out << "</table>\n";
+        out << "</body>\n";
+        out << "</html>\n";
+        if (!out.flush())
+            throw QString("write export file failed");
     } catch (const QString &ErrorStr) {
         //捕获到异常，导出失败，发出失败信号
         qCWarning(logExport) << "Export Stop" << ErrorStr;
-        fi.close();
+        html.close();
         emit sigResult(false);
         if (ErrorStr != stopStr) {
             emit sigError(QString("export error: %1").arg(ErrorStr));
         }
         return false;
     }
-    fi.close();
+    html.close();
     //导出成功，如果此时被停止，则发出导出失败信号
     emit sigResult(m_canRunning);
     return m_canRunning;
 }
 
 /**
- * @brief LogExportThread::exportToTxt 导出到日志txt格式函数，对LOG_MSG_BOOT数据类型的重载（指启动日志）
+ * @brief LogExportThread::exportRecordsToHtml 按日志类型的导出列导出到html格式
  * @param fileName 导出文件路径全称
- * @param jList  要导出的数据源 LOG_MSG_BOOT
+ * @param jList 要导出的数据源
  * @param labels 表头字符串
+ * @param appName 应用日志导出的应用名称，其他日志不使用
  * @return 是否导出成功
  */
-bool LogExportThread::exportToTxt(const QString &fileName, const QList<LOG_MSG_BOOT> &jList, const QStringList &labels)
+template <typename Traits>
+bool LogExportThread::exportRecordsToHtml(const QString &fileName, const LogRecordView<typename Traits::Record> &jList, const QStringList &labels, const QString &appName)
 {
     //判断文件路径是否存在，不存在就返回错误
-    QFile fi(fileName);
-    if (!fi.open(QIODevice::WriteOnly)) {
+    QFile html(fileName);
+    if (!html.open(QIODevice::WriteOnly)) {
         emit sigResult(false);
         emit sigError(openErroStr);
         return false;
     }
     try {
-        QTextStream out(&fi);
-        out.setCodec(QTextCodec::codecForName("utf-8"));
-        for (int i = 0; i < jList.count(); i++) {
-            //导出逻辑启动停止控制，外部把m_canRunning置false时停止运行，抛出异常处理
-            if (!m_canRunning) {
-                throw  QString(stopStr);
-            }
-            //导出各字段的描述和对应内容拼成目标字符串
-            LOG_MSG_BOOT jMsg = jList.at(i);
-            int col = 0;
-            out << labels.value(col++, "") << ":" << jMsg.status << " ";
-            out << labels.value(col++, "") << ":" << jMsg.msg << " ";
-            out << "\n";
-            //导出进度信号
-            sigProgress(i + 1, jList.count());
+        LogExportWriter out(&html);
+        //写网页头
+        out << "<!DOCTYPE html>\n";
+        out << "<html>\n";
+        out << "<body>\n";
+        //写入表格标签
+        out << "<table border=\"1\">\n";
+        // 写入表头
+        out << "<tr>";
+        for (int i = 0; i < labels.count(); ++i) {
+            writeHtmlCell(out, labels.value(i));
         }
+        out << "</tr>";
+        // 写入内容
+        //每行的网页内容在导出线程池中拼接、转义并转为utf8,本线程只按顺序写入
+        writeRecordBlocks<Traits>(jList, jList.count(), HtmlRows(), [&](HtmlRows &rows, const typename Traits::Record &record) {
+            //根据字段拼出每行的网页内容
+            rows.text += QLatin1String("<tr>");
+            for (const LogExportColumn<typename Traits::Record> &column : Traits::columns) {
+                //此style为使元素内\n换行符起效
+                rows.text += (column.flags & ExportPreLine) ? QLatin1String("<td style='white-space: pre-line;'>") : QLatin1String("<td>");
+                if (const LogRecordFormatter::CodeCell *code = m_formatter.codeCell(column, record))
+                    rows.text += code->html;
+                else
+                    LogExportWriter::appendHtmlEscaped(rows.text, m_formatter.cellText(column, record, appName));
+                rows.text += QLatin1String("</td>");
+            }
+            rows.text += QLatin1String("</tr>");
+        }, [&](const HtmlRows &rows) { out.writeUtf8(rows.utf8); });
+
+        out << "</table>\n";
+        out << "</body>\n";
+        out << "</html>\n";
+        if (!out.flush())
+            throw QString("write export file failed");
     } catch (const QString &ErrorStr) {
         //捕获到异常，导出失败，发出失败信号
         qCWarning(logExport) << "Export Stop" << ErrorStr;
-        fi.close();
+        html.close();
         emit sigResult(false);
         if (ErrorStr != stopStr) {
             emit sigError(QString("export error: %1").arg(ErrorStr));
         }
         return false;
     }
-    fi.close();
+    html.close();
     //导出成功，如果此时被停止，则发出导出失败信号
     emit sigResult(m_canRunning);
     return m_canRunning;
 }
 
 /**
- * @brief LogExportThread::exportToTxt 导出到日志txt格式函数，对LOG_MSG_XORG数据类型的重载（指xorg日志）
- * @param fileName 导出文件路径全称
- * @param jList 要导出的数据源 LOG_MSG_XORG
- * @param labels 表头字符串
- * @return 是否导出成功
+ * @brief LogExportThread::exportToHtml 系统日志和内核日志导出到html格式，按flag选择导出列
  */
-bool LogExportThread::exportToTxt(const QString &fileName, const QList<LOG_MSG_XORG> &jList, const QStringList &labels)
+bool LogExportThread::exportToHtml(const QString &fileName, const LogRecordView<LOG_MSG_JOURNAL> &jList, const QStringList &labels, LOG_FLAG flag)
 {
-    //判断文件路径是否存在，不存在就返回错误
-    QFile fi(fileName);
-    if (!fi.open(QIODevice::WriteOnly)) {
-        emit sigResult(false);
-        emit sigError(openErroStr);
-        return false;
-    }
-    try {
-        QTextStream out(&fi);
-        out.setCodec(QTextCodec::codecForName("utf-8"));
-        for (int i = 0; i < jList.count(); i++) {
-            //导出逻辑启动停止控制，外部把m_canRunning置false时停止运行，抛出异常处理
-            if (!m_canRunning) {
-                throw  QString(stopStr);
-            }
-            //导出各字段的描述和对应内容拼成目标字符串
-            LOG_MSG_XORG jMsg = jList.at(i);
-            int col = 0;
-            out << labels.value(col++, "") << ":" << jMsg.offset << " ";
-            out << labels.value(col++, "") << ":" << jMsg.msg << " ";
-            out << "\n";
-            //导出进度信号
-            sigProgress(i + 1, jList.count());
-        }
-    } catch (const QString &ErrorStr) {
-        //捕获到异常，导出失败，发出失败信号
-        qCWarning(logExport) << "Export Stop" << ErrorStr;
-        fi.close();
-        emit sigResult(false);
-        if (ErrorStr != stopStr) {
-            emit sigError(QString("export error: %1").arg(ErrorStr));
-        }
-        return false;
-    }
-    fi.close();
-    //导出成功，如果此时被停止，则发出导出失败信号
-    emit sigResult(m_canRunning);
-    return m_canRunning;
-}
-
-/**
- * @brief LogExportThread::exportToTxt 导出到日志txt格式函数，对LOG_MSG_NORMAL数据类型的重载（指开关机日志）
- * @param fileName 导出文件路径全称
- * @param jList 要导出的数据源 LOG_MSG_NORMAL
- * @param labels 表头字符串
- * @return 是否导出成功
- */
-bool LogExportThread::exportToTxt(const QString &fileName, const QList<LOG_MSG_NORMAL> &jList, const QStringList &labels)
-{
-    //判断文件路径是否存在，不存在就返回错误
-    QFile fi(fileName);
-    if (!fi.open(QIODevice::WriteOnly)) {
-        emit sigResult(false);
-        emit sigError(openErroStr);
-        return false;
-    }
-    try {
-        QTextStream out(&fi);
-        out.setCodec(QTextCodec::codecForName("utf-8"));
-        for (int i = 0; i < jList.count(); i++) {
-            //导出逻辑启动停止控制，外部把m_canRunning置false时停止运行，抛出异常处理
-            if (!m_canRunning) {
-                throw  QString(stopStr);
-            }
-            //导出各字段的描述和对应内容拼成目标字符串
-            LOG_MSG_NORMAL jMsg = jList.at(i);
-            int col = 0;
-            out << labels.value(col++, "") << ":" << jMsg.eventType << " ";
-            out << labels.value(col++, "") << ":" << jMsg.userName << " ";
-            out << labels.value(col++, "") << ":" << jMsg.dateTime << " ";
-            out << labels.value(col++, "") << ":" << jMsg.msg << " ";
-            out << "\n";
-            //导出进度信号
-            sigProgress(i + 1, jList.count());
-        }
-    } catch (const QString &ErrorStr) {
-        //捕获到异常，导出失败，发出失败信号
-        qCWarning(logExport) << "Export Stop" << ErrorStr;
-        fi.close();
-        emit sigResult(false);
-        if (ErrorStr != stopStr) {
-            emit sigError(QString("export error: %1").arg(ErrorStr));
-        }
-        return false;
-    }
-    fi.close();
-    //导出成功，如果此时被停止，则发出导出失败信号
-    emit sigResult(m_canRunning);
-    return m_canRunning;
-}
-/**
- * @brief LogExportThread::exportToTxt导出到日志txt格式函数，对LOG_MSG_KWIN数据类型的重载（指klu上的kwin日志）
- * @param fileName 导出文件路径全称
- * @param jList 要导出的数据源 LOG_MSG_KWIN
- * @param labels 表头字符串
- * @return 是否导出成功
- */
-bool LogExportThread::exportToTxt(const QString &fileName, const QList<LOG_MSG_KWIN> &jList, const QStringList &labels)
-{
-    //判断文件路径是否存在，不存在就返回错误
-    QFile fi(fileName);
-    if (!fi.open(QIODevice::WriteOnly)) {
-        emit sigResult(false);
-        emit sigError(openErroStr);
-        return false;
-    }
-    try {
-        QTextStream out(&fi);
-        out.setCodec(QTextCodec::codecForName("utf-8"));
-        for (int i = 0; i < jList.count(); i++) {
-            //导出逻辑启动停止控制，外部把m_canRunning置false时停止运行，抛出异常处理
-            if (!m_canRunning) {
-                throw  QString(stopStr);
-            }
-            //导出各字段的描述和对应内容拼成目标字符串
-            LOG_MSG_KWIN jMsg = jList.at(i);
-            int col = 0;
-            out << labels.value(col++, "") << ":" << jMsg.msg << " ";
-            out << "\n";
-            //导出进度信号
-            sigProgress(i + 1, jList.count());
-        }
-    } catch (const QString &ErrorStr) {
-        //捕获到异常，导出失败，发出失败信号
-        qCWarning(logExport) << "Export Stop" << ErrorStr;
-        fi.close();
-        emit sigResult(false);
-        if (ErrorStr != stopStr) {
-            emit sigError(QString("export error: %1").arg(ErrorStr));
-        }
-        return false;
-    }
-    fi.close();
-    //导出成功，如果此时被停止，则发出导出失败信号
-    emit sigResult(m_canRunning);
-    return m_canRunning;
-}
-
-bool LogExportThread::exportToTxt(const QString &fileName, const QList<LOG_MSG_DNF> &jList, const QStringList &labels)
-{
-    //判断文件路径是否存在，不存在就返回错误
-    QFile fi(fileName);
-    if (!fi.open(QIODevice::WriteOnly)) {
-        emit sigResult(false);
-        emit sigError(openErroStr);
-        return false;
-    }
-    try {
-        QTextStream out(&fi);
-        out.setCodec(QTextCodec::codecForName("utf-8"));
-        for (int i = 0; i < jList.count(); i++) {
-            //导出逻辑启动停止控制，外部把m_canRunning置false时停止运行，抛出异常处理
-            if (!m_canRunning) {
-                throw QString(stopStr);
-            }
-            //导出各字段的描述和对应内容拼成目标字符串
-
-            int col = 0;
-            LOG_MSG_DNF jMsg = jList.at(i);
-            out << labels.value(col++, "") << ":" << jMsg.level << " ";
-            out << labels.value(col++, "") << ":" << jMsg.dateTime << " ";
-            out << labels.value(col++, "") << ":" << jMsg.msg << " ";
-            out << "\n";
-            //导出进度信号
-            sigProgress(i + 1, jList.count());
-        }
-    } catch (const QString &ErrorStr) {
-        //捕获到异常，导出失败，发出失败信号
-        qCWarning(logExport) << "Export Stop" << ErrorStr;
-        fi.close();
-        emit sigResult(false);
-        if (ErrorStr != stopStr) {
-            emit sigError(QString("export error: %1").arg(ErrorStr));
-        }
-        return false;
-    }
-    fi.close();
-    //导出成功，如果此时被停止，则发出导出失败信号
-    emit sigResult(m_canRunning);
-    return m_canRunning;
-}
-
-bool LogExportThread::exportToTxt(const QString &fileName, const QList<LOG_MSG_DMESG> &jList, const QStringList &labels)
-{
-    //判断文件路径是否存在，不存在就返回错误
-    QFile fi(fileName);
-    if (!fi.open(QIODevice::WriteOnly)) {
-        emit sigResult(false);
-        emit sigError(openErroStr);
-        return false;
-    }
-    try {
-        QTextStream out(&fi);
-        out.setCodec(QTextCodec::codecForName("utf-8"));
-        for (int i = 0; i < jList.count(); i++) {
-            //导出逻辑启动停止控制，外部把m_canRunning置false时停止运行，抛出异常处理
-            if (!m_canRunning) {
-                throw QString(stopStr);
-            }
-            //导出各字段的描述和对应内容拼成目标字符串
-
-            int col = 0;
-            LOG_MSG_DMESG jMsg = jList.at(i);
-            out << labels.value(col++, "") << ":" << jMsg.level << " ";
-            out << labels.value(col++, "") << ":" << jMsg.dateTime << " ";
-            out << labels.value(col++, "") << ":" << jMsg.msg << " ";
-            out << "\n";
-            //导出进度信号
-            sigProgress(i + 1, jList.count());
-        }
-    } catch (const QString &ErrorStr) {
-        //捕获到异常，导出失败，发出失败信号
-        qCWarning(logExport) << "Export Stop" << ErrorStr;
-        fi.close();
-        emit sigResult(false);
-        if (ErrorStr != stopStr) {
-            emit sigError(QString("export error: %1").arg(ErrorStr));
-        }
-        return false;
-    }
-    fi.close();
-    //导出成功，如果此时被停止，则发出导出失败信号
-    emit sigResult(m_canRunning);
-    return m_canRunning;
-}
-
-bool LogExportThread::exportToTxt(const QString &fileName, const QList<LOG_MSG_AUDIT> &jList, const QStringList &labels)
-{
-    //判断文件路径是否存在，不存在就返回错误
-    QFile fi(fileName);
-    if (!fi.open(QIODevice::WriteOnly)) {
-        emit sigResult(false);
-        emit sigError(openErroStr);
-        return false;
-    }
-    try {
-        QTextStream out(&fi);
-        out.setCodec(QTextCodec::codecForName("utf-8"));
-        for (int i = 0; i < jList.count(); i++) {
-            //导出逻辑启动停止控制，外部把m_canRunning置false时停止运行，抛出异常处理
-            if (!m_canRunning) {
-                throw  QString(stopStr);
-            }
-            //导出各字段的描述和对应内容拼成目标字符串
-            LOG_MSG_AUDIT jMsg = jList.at(i);
-            int col = 0;
-            out << labels.value(col++, "") << ":" << jMsg.eventType << " ";
-            out << labels.value(col++, "") << ":" << jMsg.dateTime << " ";
-            out << labels.value(col++, "") << ":" << jMsg.processName << " ";
-            out << labels.value(col++, "") << ":" << jMsg.status << " ";
-            out << labels.value(col++, "") << ":" << jMsg.msg << " ";
-            out << "\n";
-            //导出进度信号
-            sigProgress(i + 1, jList.count());
-        }
-    } catch (const QString &ErrorStr) {
-        //捕获到异常，导出失败，发出失败信号
-        qCWarning(logExport) << "Export Stop" << ErrorStr;
-        fi.close();
-        emit sigResult(false);
-        if (ErrorStr != stopStr) {
-            emit sigError(QString("export error: %1").arg(ErrorStr));
-        }
-        return false;
-    }
-    fi.close();
-    //导出成功，如果此时被停止，则发出导出失败信号
-    emit sigResult(m_canRunning);
-    return m_canRunning;
-}
-
-/**
- * @brief LogExportThread::exportToDoc导出到日志doc格式函数，对LOG_MSG_JOURNAL数据类型的重载（指系统日志和内核日志）
- * @param fileName 导出文件路径全称
- * @param jList 要导出的数据源 数据类型为LOG_MSG_JOURNAL
- * @param labels 表头字符串
- * @param flag  导出的日志类型
- * @return 是否导出成功
- */
-bool LogExportThread::exportToDoc(const QString &fileName, const QList<LOG_MSG_JOURNAL> &jList,
-                                  const QStringList &labels, LOG_FLAG iFlag)
-{
-    try {
-        QString tempdir ;
-        if (iFlag == JOURNAL) {
-            tempdir = "/usr/share/deepin-log-viewer/DocxTemplate/6column.dfw";
-        } else if (iFlag == KERN) {
-            tempdir = "/usr/share/deepin-log-viewer/DocxTemplate/4column.dfw";
-        } else {
-            qCWarning(logExport) << "exportToDoc type is Wrong!";
-            return false;
-        }
-        if (!QFile(tempdir).exists()) {
-            qCWarning(logExport) << "export docx template is not exisits";
-            return  false;
-        }
-
-        DocxFactory:: WordProcessingMerger &l_merger = DocxFactory:: WordProcessingMerger::getInstance();
-
-
-        l_merger.load(tempdir.toStdString());
-        //往表头中添加表头描述，表头为第一行，数据则在下面
-        for (int col = 0; col < labels.count(); ++col) {
-            l_merger.setClipboardValue("tableRow", QString("column%1").arg(col + 1).toStdString(), labels.at(col).toStdString());
-
-        }
-        l_merger.paste("tableRow");
-        //计算导出进度条最后一段的长度，因为最后写入文件那一段没有进度，所以预先留出一段进度
-        int end = static_cast<int>(jList.count() * 0.1 > 5 ? jList.count() * 0.1 : 5);
-        for (int row = 0; row < jList.count(); ++row) {
-            //导出逻辑启动停止控制，外部把m_canRunning置false时停止运行，抛出异常处理
-            if (!m_canRunning) {
-                throw  QString(stopStr);
-            }
-            LOG_MSG_JOURNAL message = jList.at(row);
-            //把数据填入表格单元格中
-            if (iFlag == JOURNAL) {
-                l_merger.setClipboardValue("tableRow", QString("column1").toStdString(), message.level.toStdString());
-                l_merger.setClipboardValue("tableRow", QString("column2").toStdString(), message.daemonName.toStdString());
-                l_merger.setClipboardValue("tableRow", QString("column3").toStdString(), message.dateTime.toStdString());
-                l_merger.setClipboardValue("tableRow", QString("column4").toStdString(), message.msg.toStdString());
-                l_merger.setClipboardValue("tableRow", QString("column5").toStdString(), message.hostName.toStdString());
-                l_merger.setClipboardValue("tableRow", QString("column6").toStdString(), message.daemonId.toStdString());
-            } else if (iFlag == KERN) {
-                l_merger.setClipboardValue("tableRow", QString("column1").toStdString(), message.dateTime.toStdString());
-                l_merger.setClipboardValue("tableRow", QString("column2").toStdString(), message.hostName.toStdString());
-                l_merger.setClipboardValue("tableRow", QString("column3").toStdString(), message.daemonName.toStdString());
-                l_merger.setClipboardValue("tableRow", QString("column4").toStdString(), message.msg.toStdString());
-            }
-            l_merger.paste("tableRow");
-            //导出进度信号
-            sigProgress(row + 1, jList.count() + end);
-        }
-        //保存，把拼好的xml写入文件中
-        QString fileNamex = fileName + "x";
-
-        QFile rsNameFile(fileName) ;
-        if (rsNameFile.exists()) {
-            rsNameFile.remove();
-        }
-        l_merger.save(fileNamex.toStdString());
-        QFile(fileNamex).rename(fileName);
-    } catch (const QString &ErrorStr) {
-        //捕获到异常，导出失败，发出失败信号
-        qCWarning(logExport) << "Export Stop" << ErrorStr;
-        if (!m_canRunning) {
-            Utils::checkAndDeleteDir(m_fileName);
-        }
-
-        emit sigResult(false);
-        if (ErrorStr != stopStr) {
-            emit sigError(QString("export error: %1").arg(ErrorStr));
-        }
-        return false;
-    }
-    //如果取消导出，则删除文件
-    if (!m_canRunning) {
-        Utils::checkAndDeleteDir(m_fileName);
-    }
-    //100%进度
-    sigProgress(100, 100);
-    //延时200ms再发送导出成功信号，关闭导出进度框，让100%的进度有时间显示
-    Utils::sleep(200);
-    //导出成功，如果此时被停止，则发出导出失败信号
-    emit sigResult(m_canRunning);
-    return m_canRunning;
-}
-
-/**
- * @brief LogExportThread::exportToDoc导出到日志doc格式配置函数，对LOG_MSG_APPLICATOIN数据类型的重载（指应用日志）
- * @param fileName 导出文件路径全称        if (!QFile(fileName).exists()) {
-            qCWarning(logExport) << "export file dir is not exisits";
-            return  false;
-        }
- * @param jList 要导出的数据源 数据类型为LOG_MSG_APPLICATOIN
- * @param labels 表头字符串
- * @param iAppName 导出的应用日志的应用名称
- * @return 是否导出成功
- */
-bool LogExportThread::exportToDoc(const QString &fileName, const QList<LOG_MSG_APPLICATOIN> &jList, const QStringList &labels, QString &iAppName)
-{
-    try {
-        QString tempdir = "/usr/share/deepin-log-viewer/DocxTemplate/4column.dfw";
-        if (!QFile(tempdir).exists()) {
-            qCWarning(logExport) << "export docx template is not exisits";
-            return  false;
-        }
-
-        DocxFactory:: WordProcessingMerger &l_merger = DocxFactory:: WordProcessingMerger::getInstance();
-        l_merger.load(tempdir.toStdString());
-        //往表头中添加表头描述，表头为第一行，数据则在下面
-        for (int col = 0; col < labels.count(); ++col) {
-            l_merger.setClipboardValue("tableRow", QString("column%1").arg(col + 1).toStdString(), labels.at(col).toStdString());
-
-        }
-        l_merger.paste("tableRow");
-        //计算导出进度条最后一段的长度，因为最后写入文件那一段没有进度，所以预先留出一段进度
-        int end = static_cast<int>(jList.count() * 0.1 > 5 ? jList.count() * 0.1 : 5);
-        for (int row = 0; row < jList.count(); ++row) {
-            //导出逻辑启动停止控制，外部把m_canRunning置false时停止运行，抛出异常处理
-            if (!m_canRunning) {
-                throw  QString(stopStr);
-            }
-            LOG_MSG_APPLICATOIN message = jList.at(row);
-            l_merger.setClipboardValue("tableRow", QString("column1").toStdString(), strTranslate(message.level).toStdString());
-            l_merger.setClipboardValue("tableRow", QString("column2").toStdString(), message.dateTime.toStdString());
-            l_merger.setClipboardValue("tableRow", QString("column3").toStdString(), iAppName.toStdString());
-            l_merger.setClipboardValue("tableRow", QString("column4").toStdString(), message.msg.toStdString());
-            l_merger.paste("tableRow");
-            //导出进度信号
-            sigProgress(row + 1, jList.count() + end);
-        }
-
-        //保存，把拼好的xml写入文件中
-        QString fileNamex = fileName + "x";
-
-        QFile rsNameFile(fileName) ;
-        if (rsNameFile.exists()) {
-            rsNameFile.remove();
-        }
-        l_merger.save(fileNamex.toStdString());
-        QFile(fileNamex).rename(fileName);
-
-    } catch (const QString &ErrorStr) {
-        //捕获到异常，导出失败，发出失败信号
-        qCWarning(logExport) << "Export Stop" << ErrorStr;
-        if (!m_canRunning) {
-            Utils::checkAndDeleteDir(m_fileName);
-        }
-
-        emit sigResult(false);
-        if (ErrorStr != stopStr) {
-            emit sigError(QString("export error: %1").arg(ErrorStr));
-        }
-        return false;
-    }
-    //如果取消导出，则删除文件
-    if (!m_canRunning) {
-        Utils::checkAndDeleteDir(m_fileName);
-    }
-    //100%进度
-    sigProgress(100, 100);
-    //延时200ms再发送导出成功信号，关闭导出进度框，让100%的进度有时间显示
-    Utils::sleep(200);
-    //导出成功，如果此时被停止，则发出导出失败信号
-    emit sigResult(m_canRunning);
-
-    return m_canRunning;
-}
-
-/**
- * @brief LogExportThread::exportToDoc导出到日志doc格式函数，对LOG_MSG_DPKG数据类型的重载（指dpkg日志）
- * @param fileName 导出文件路径全称
- * @param jList  要导出的数据源 LOG_MSG_DPKG
- * @param labels 表头字符串
- * @return 是否导出成功
- */
-bool LogExportThread::exportToDoc(const QString &fileName, const QList<LOG_MSG_DPKG> &jList, const QStringList &labels)
-{
-    try {
-        QString tempdir = "/usr/share/deepin-log-viewer/DocxTemplate/3column.dfw";
-        if (!QFile(tempdir).exists()) {
-            qCWarning(logExport) << "export docx template is not exisits";
-            return  false;
-        }
-
-        DocxFactory:: WordProcessingMerger &l_merger = DocxFactory:: WordProcessingMerger::getInstance();
-        l_merger.load(tempdir.toStdString());
-        //往表头中添加表头描述，表头为第一行，数据则在下面
-        for (int col = 0; col < labels.count(); ++col) {
-            l_merger.setClipboardValue("tableRow", QString("column%1").arg(col + 1).toStdString(), labels.at(col).toStdString());
-
-        }
-        l_merger.paste("tableRow");
-        //计算导出进度条最后一段的长度，因为最后写入文件那一段没有进度，所以预先留出一段进度
-        int end = static_cast<int>(jList.count() * 0.1 > 5 ? jList.count() * 0.1 : 5);
-        for (int row = 0; row < jList.count(); ++row) {
-            //导出逻辑启动停止控制，外部把m_canRunning置false时停止运行，抛出异常处理
-            if (!m_canRunning) {
-                throw  QString(stopStr);
-            }
-            LOG_MSG_DPKG message = jList.at(row);
-            l_merger.setClipboardValue("tableRow", QString("column1").toStdString(), message.dateTime.toStdString());
-            l_merger.setClipboardValue("tableRow", QString("column2").toStdString(), message.msg.toStdString());
-            l_merger.setClipboardValue("tableRow", QString("column3").toStdString(), message.action.toStdString());
-            l_merger.paste("tableRow");
-            //导出进度信号
-            sigProgress(row + 1, jList.count() + end);
-        }
-
-        //保存，把拼好的xml写入文件中
-        QString fileNamex = fileName + "x";
-
-        QFile rsNameFile(fileName) ;
-        if (rsNameFile.exists()) {
-            rsNameFile.remove();
-        }
-        l_merger.save(fileNamex.toStdString());
-        QFile(fileNamex).rename(fileName);
-
-    } catch (const QString &ErrorStr) {
-        //捕获到异常，导出失败，发出失败信号
-        qCWarning(logExport) << "Export Stop" << ErrorStr;
-        if (!m_canRunning) {
-            Utils::checkAndDeleteDir(m_fileName);
-        }
-
-        emit sigResult(false);
-        if (ErrorStr != stopStr) {
-            emit sigError(QString("export error: %1").arg(ErrorStr));
-        }
-        return false;
-    }
-    //如果取消导出，则删除文件
-    if (!m_canRunning) {
-        Utils::checkAndDeleteDir(m_fileName);
-    }
-    //100%进度
-    sigProgress(100, 100);
-    //延时200ms再发送导出成功信号，关闭导出进度框，让100%的进度有时间显示
-    Utils::sleep(200);
-    //导出成功，如果此时被停止，则发出导出失败信号
-    emit sigResult(m_canRunning);
-
-    return m_canRunning;
-}
-
-/**
- * @brief LogExportThread::exportToDoc导出到日志doc格式配置函数，对LOG_MSG_BOOT数据类型的重载（指启动日志）
- * @param fileName 导出文件路径全称
- * @param jList  要导出的数据源 LOG_MSG_BOOT
- * @param labels 表头字符串
- * @return 是否导出成功
- */
-bool LogExportThread::exportToDoc(const QString &fileName, const QList<LOG_MSG_BOOT> &jList, const QStringList &labels)
-{
-    try {
-        QString tempdir = "/usr/share/deepin-log-viewer/DocxTemplate/2column.dfw";
-        if (!QFile(tempdir).exists()) {
-            qCWarning(logExport) << "export docx template is not exisits";
-            return  false;
-        }
-
-        DocxFactory:: WordProcessingMerger &l_merger = DocxFactory:: WordProcessingMerger::getInstance();
-        l_merger.load(tempdir.toStdString());
-        //往表头中添加表头描述，表头为第一行，数据则在下面
-        for (int col = 0; col < labels.count(); ++col) {
-            l_merger.setClipboardValue("tableRow", QString("column%1").arg(col + 1).toStdString(), labels.at(col).toStdString());
-
-        }
-        l_merger.paste("tableRow");
-        //计算导出进度条最后一段的长度，因为最后写入文件那一段没有进度，所以预先留出一段进度
-        int end = static_cast<int>(jList.count() * 0.1 > 5 ? jList.count() * 0.1 : 5);
-        for (int row = 0; row < jList.count(); ++row) {
-            //导出逻辑启动停止控制，外部把m_canRunning置false时停止运行，抛出异常处理
-            if (!m_canRunning) {
-                throw  QString(stopStr);
-            }
-            LOG_MSG_BOOT message = jList.at(row);
-            l_merger.setClipboardValue("tableRow", QString("column1").toStdString(), message.status.toStdString());
-            l_merger.setClipboardValue("tableRow", QString("column2").toStdString(), message.msg.toStdString());
-            l_merger.paste("tableRow");
-            //导出进度信号
-            sigProgress(row + 1, jList.count() + end);
-        }
-        //保存，把拼好的xml写入文件中
-        QString fileNamex = fileName + "x";
-
-        QFile rsNameFile(fileName) ;
-        if (rsNameFile.exists()) {
-            rsNameFile.remove();
-        }
-        l_merger.save(fileNamex.toStdString());
-        QFile(fileNamex).rename(fileName);
-    } catch (const QString &ErrorStr) {
-        //捕获到异常，导出失败，发出失败信号
-        qCWarning(logExport) << "Export Stop" << ErrorStr;
-        if (!m_canRunning) {
-            Utils::checkAndDeleteDir(m_fileName);
-        }
-
-        emit sigResult(false);
-        if (ErrorStr != stopStr) {
-            emit sigError(QString("export error: %1").arg(ErrorStr));
-        }
-        return false;
-    }
-    //如果取消导出，则删除文件
-    if (!m_canRunning) {
-        Utils::checkAndDeleteDir(m_fileName);
-    }
-    //100%进度
-    sigProgress(100, 100);
-    //延时200ms再发送导出成功信号，关闭导出进度框，让100%的进度有时间显示
-    Utils::sleep(200);
-    //导出成功，如果此时被停止，则发出导出失败信号
-    emit sigResult(m_canRunning);
-    return m_canRunning;
-}
-
-/**
- * @brief LogExportThread::exportToDoc导出到日志doc格式函数，对LOG_MSG_XORG数据类型的重载（指xorg日志）
- * @param fileName 导出文件路径全称
- * @param jList 要导出的数据源 LOG_MSG_XORG
- * @param labels 表头字符串
- * @return 是否导出成功
- */
-bool LogExportThread::exportToDoc(const QString &fileName, const QList<LOG_MSG_XORG> &jList, const QStringList &labels)
-{
-    try {
-        QString tempdir = "/usr/share/deepin-log-viewer/DocxTemplate/2column.dfw";
-        if (!QFile(tempdir).exists()) {
-            qCWarning(logExport) << "export docx template is not exisits";
-            return  false;
-        }
-
-        DocxFactory:: WordProcessingMerger &l_merger = DocxFactory:: WordProcessingMerger::getInstance();
-        l_merger.load(tempdir.toStdString());
-        //往表头中添加表头描述，表头为第一行，数据则在下面
-        for (int col = 0; col < labels.count(); ++col) {
-            l_merger.setClipboardValue("tableRow", QString("column%1").arg(col + 1).toStdString(), labels.at(col).toStdString());
-
-        }
-        l_merger.paste("tableRow");
-        //计算导出进度条最后一段的长度，因为最后写入文件那一段没有进度，所以预先留出一段进度
-        int end = static_cast<int>(jList.count() * 0.1 > 5 ? jList.count() * 0.1 : 5);
-        for (int row = 0; row < jList.count(); ++row) {
-            //导出逻辑启动停止控制，外部把m_canRunning置false时停止运行，抛出异常处理
-            if (!m_canRunning) {
-                throw  QString(stopStr);
-            }
-            LOG_MSG_XORG message = jList.at(row);
-            l_merger.setClipboardValue("tableRow", QString("column1").toStdString(), message.offset.toStdString());
-            l_merger.setClipboardValue("tableRow", QString("column2").toStdString(), message.msg.toStdString());
-            l_merger.paste("tableRow");
-            //导出进度信号
-            sigProgress(row + 1, jList.count() + end);
-        }
-        //保存，把拼好的xml写入文件中
-        QString fileNamex = fileName + "x";
-
-        QFile rsNameFile(fileName) ;
-        if (rsNameFile.exists()) {
-            rsNameFile.remove();
-        }
-        l_merger.save(fileNamex.toStdString());
-        QFile(fileNamex).rename(fileName);
-
-    } catch (const QString &ErrorStr) {
-        //捕获到异常，导出失败，发出失败信号
-        qCWarning(logExport) << "Export Stop" << ErrorStr;
-        if (!m_canRunning) {
-            Utils::checkAndDeleteDir(m_fileName);
-        }
-
-        emit sigResult(false);
-        if (ErrorStr != stopStr) {
-            emit sigError(QString("export error: %1").arg(ErrorStr));
-        }
-        return false;
-    }
-    //如果取消导出，则删除文件
-    if (!m_canRunning) {
-        Utils::checkAndDeleteDir(m_fileName);
-    }
-    //100%进度
-    sigProgress(100, 100);
-    //延时200ms再发送导出成功信号，关闭导出进度框，让100%的进度有时间显示
-    Utils::sleep(200);
-    //导出成功，如果此时被停止，则发出导出失败信号
-    emit sigResult(m_canRunning);
-
-    return m_canRunning;
-}
-
-/**
- * @brief LogExportThread::exportToDoc 导出到日志doc格式函数，对LOG_MSG_NORMAL数据类型的重载（指开关机日志）
- * @param fileName 导出文件路径全称
- * @param jList 要导出的数据源 LOG_MSG_NORMAL
- * @param labels 表头字符串
- * @return 是否导出成功
- */
-bool LogExportThread::exportToDoc(const QString &fileName, const QList<LOG_MSG_NORMAL> &jList, const QStringList &labels)
-{
-
-    try {
-        QString tempdir = "/usr/share/deepin-log-viewer/DocxTemplate/4column.dfw";
-        if (!QFile(tempdir).exists()) {
-            qCWarning(logExport) << "export docx template is not exisits";
-            return  false;
-        }
-
-        DocxFactory:: WordProcessingMerger &l_merger = DocxFactory:: WordProcessingMerger::getInstance();
-        l_merger.load(tempdir.toStdString());
-        //往表头中添加表头描述，表头为第一行，数据则在下面
-        for (int col = 0; col < labels.count(); ++col) {
-            l_merger.setClipboardValue("tableRow", QString("column%1").arg(col + 1).toStdString(), labels.at(col).toStdString());
-
-        }
-        l_merger.paste("tableRow");
-        //计算导出进度条最后一段的长度，因为最后写入文件那一段没有进度，所以预先留出一段进度
-        int end = static_cast<int>(jList.count() * 0.1 > 5 ? jList.count() * 0.1 : 5);
-        for (int row = 0; row < jList.count(); ++row) {
-            //导出逻辑启动停止控制，外部把m_canRunning置false时停止运行，抛出异常处理
-            if (!m_canRunning) {
-                throw  QString(stopStr);
-            }
-            LOG_MSG_NORMAL message = jList.at(row);
-            l_merger.setClipboardValue("tableRow", QString("column1").toStdString(), message.eventType.toStdString());
-            l_merger.setClipboardValue("tableRow", QString("column2").toStdString(), message.userName.toStdString());
-            l_merger.setClipboardValue("tableRow", QString("column3").toStdString(), message.dateTime.toStdString());
-            l_merger.setClipboardValue("tableRow", QString("column4").toStdString(), message.msg.toStdString());
-            l_merger.paste("tableRow");
-            //导出进度信号
-            sigProgress(row + 1, jList.count() + end);
-        }
-        //保存，把拼好的xml写入文件中
-        QString fileNamex = fileName + "x";
-
-        QFile rsNameFile(fileName) ;
-        if (rsNameFile.exists()) {
-            rsNameFile.remove();
-        }
-        l_merger.save(fileNamex.toStdString());
-        QFile(fileNamex).rename(fileName);
-
-    } catch (const QString &ErrorStr) {
-        //捕获到异常，导出失败，发出失败信号
-        qCWarning(logExport) << "Export Stop" << ErrorStr;
-        if (!m_canRunning) {
-            Utils::checkAndDeleteDir(m_fileName);
-        }
-
-        emit sigResult(false);
-        if (ErrorStr != stopStr) {
-            emit sigError(QString("export error: %1").arg(ErrorStr));
-        }
-        return false;
-    }
-    //如果取消导出，则删除文件
-    if (!m_canRunning) {
-        Utils::checkAndDeleteDir(m_fileName);
-    }
-    //100%进度
-    sigProgress(100, 100);
-    //延时200ms再发送导出成功信号，关闭导出进度框，让100%的进度有时间显示
-    Utils::sleep(200);
-    //导出成功，如果此时被停止，则发出导出失败信号
-    emit sigResult(m_canRunning);
-
-    return m_canRunning;
-}
-
-/**
- * @brief LogExportThread::exportToDoc导出到日志doc格式函数，对LOG_MSG_KWIN数据类型的重载（指klu上的kwin日志）
- * @param fileName 导出文件路径全称
- * @param jList 要导出的数据源 LOG_MSG_KWIN
- * @param labels 表头字符串
- * @return 是否导出成功
- */
-bool LogExportThread::exportToDoc(const QString &fileName, const QList<LOG_MSG_KWIN> &jList, const QStringList &labels)
-{
-
-    try {
-        QString tempdir = "/usr/share/deepin-log-viewer/DocxTemplate/1column.dfw";
-        if (!QFile(tempdir).exists()) {
-            qCWarning(logExport) << "export docx template is not exisits";
-            return  false;
-        }
-
-        DocxFactory:: WordProcessingMerger &l_merger = DocxFactory:: WordProcessingMerger::getInstance();
-        l_merger.load(tempdir.toStdString());
-        //往表头中添加表头描述，表头为第一行，数据则在下面
-        for (int col = 0; col < labels.count(); ++col) {
-            l_merger.setClipboardValue("tableRow", QString("column%1").arg(col + 1).toStdString(), labels.at(col).toStdString());
-
-        }
-        l_merger.paste("tableRow");
-        //计算导出进度条最后一段的长度，因为最后写入文件那一段没有进度，所以预先留出一段进度
-        int end = static_cast<int>(jList.count() * 0.1 > 5 ? jList.count() * 0.1 : 5);
-        for (int row = 0; row < jList.count(); ++row) {
-            //导出逻辑启动停止控制，外部把m_canRunning置false时停止运行，抛出异常处理
-            if (!m_canRunning) {
-                throw  QString(stopStr);
-            }
-            LOG_MSG_KWIN message = jList.at(row);
-            l_merger.setClipboardValue("tableRow", QString("column1").toStdString(), message.msg.toStdString());
-            l_merger.paste("tableRow");
-            //导出进度信号
-            sigProgress(row + 1, jList.count() + end);
-        }
-        //保存，把拼好的xml写入文件中
-        QString fileNamex = fileName + "x";
-
-        QFile rsNameFile(fileName) ;
-        if (rsNameFile.exists()) {
-            rsNameFile.remove();
-        }
-        l_merger.save(fileNamex.toStdString());
-        QFile(fileNamex).rename(fileName);
-
-    } catch (const QString &ErrorStr) {
-        //捕获到异常，导出失败，发出失败信号
-        qCWarning(logExport) << "Export Stop" << ErrorStr;
-        if (!m_canRunning) {
-            Utils::checkAndDeleteDir(m_fileName);
-        }
-
-        emit sigResult(false);
-        if (ErrorStr != stopStr) {
-            emit sigError(QString("export error: %1").arg(ErrorStr));
-        }
-        return false;
-    }
-    //如果取消导出，则删除文件
-    if (!m_canRunning) {
-        Utils::checkAndDeleteDir(m_fileName);
-    }
-    //100%进度
-    sigProgress(100, 100);
-    //延时200ms再发送导出成功信号，关闭导出进度框，让100%的进度有时间显示
-    Utils::sleep(200);
-    //导出成功，如果此时被停止，则发出导出失败信号
-    emit sigResult(m_canRunning);
-
-    return m_canRunning;
-}
-
-bool LogExportThread::exportToDoc(const QString &fileName, const QList<LOG_MSG_DNF> &jList, const QStringList &labels)
-{
-    try {
-        QString tempdir = "/usr/share/deepin-log-viewer/DocxTemplate/1column.dfw";
-        if (!QFile(tempdir).exists()) {
-            qCWarning(logExport) << "export docx template is not exisits";
-            return false;
-        }
-
-        DocxFactory::WordProcessingMerger &l_merger = DocxFactory::WordProcessingMerger::getInstance();
-        l_merger.load(tempdir.toStdString());
-        //往表头中添加表头描述，表头为第一行，数据则在下面
-        for (int col = 0; col < labels.count(); ++col) {
-            l_merger.setClipboardValue("tableRow", QString("column%1").arg(col + 1).toStdString(), labels.at(col).toStdString());
-        }
-        l_merger.paste("tableRow");
-        //计算导出进度条最后一段的长度，因为最后写入文件那一段没有进度，所以预先留出一段进度
-        int end = static_cast<int>(jList.count() * 0.1 > 5 ? jList.count() * 0.1 : 5);
-        for (int row = 0; row < jList.count(); ++row) {
-            //导出逻辑启动停止控制，外部把m_canRunning置false时停止运行，抛出异常处理
-            if (!m_canRunning) {
-                throw QString(stopStr);
-            }
-            LOG_MSG_DNF message = jList.at(row);
-            l_merger.setClipboardValue("tableRow", QString("column1").toStdString(), message.msg.toStdString());
-            l_merger.paste("tableRow");
-            //导出进度信号
-            sigProgress(row + 1, jList.count() + end);
-        }
-        //保存，把拼好的xml写入文件中
-        QString fileNamex = fileName + "x";
-
-        QFile rsNameFile(fileName);
-        if (rsNameFile.exists()) {
-            rsNameFile.remove();
-        }
-        l_merger.save(fileNamex.toStdString());
-        QFile(fileNamex).rename(fileName);
-
-    } catch (const QString &ErrorStr) {
-        //捕获到异常，导出失败，发出失败信号
-        qCWarning(logExport) << "Export Stop" << ErrorStr;
-        if (!m_canRunning) {
-            Utils::checkAndDeleteDir(m_fileName);
-        }
-
-        emit sigResult(false);
-        if (ErrorStr != stopStr) {
-            emit sigError(QString("export error: %1").arg(ErrorStr));
-        }
-        return false;
-    }
-    //如果取消导出，则删除文件
-    if (!m_canRunning) {
-        Utils::checkAndDeleteDir(m_fileName);
-    }
-    //100%进度
-    sigProgress(100, 100);
-    //延时200ms再发送导出成功信号，关闭导出进度框，让100%的进度有时间显示
-    Utils::sleep(200);
-    //导出成功，如果此时被停止，则发出导出失败信号
-    emit sigResult(m_canRunning);
-
-    return m_canRunning;
-}
-
-bool LogExportThread::exportToDoc(const QString &fileName, const QList<LOG_MSG_DMESG> &jList, const QStringList &labels)
-{
-    try {
-        QString tempdir = "/usr/share/deepin-log-viewer/DocxTemplate/1column.dfw";
-        if (!QFile(tempdir).exists()) {
-            qCWarning(logExport) << "export docx template is not exisits";
-            return false;
-        }
-
-        DocxFactory::WordProcessingMerger &l_merger = DocxFactory::WordProcessingMerger::getInstance();
-        l_merger.load(tempdir.toStdString());
-        //往表头中添加表头描述，表头为第一行，数据则在下面
-        for (int col = 0; col < labels.count(); ++col) {
-            l_merger.setClipboardValue("tableRow", QString("column%1").arg(col + 1).toStdString(), labels.at(col).toStdString());
-        }
-        l_merger.paste("tableRow");
-        //计算导出进度条最后一段的长度，因为最后写入文件那一段没有进度，所以预先留出一段进度
-        int end = static_cast<int>(jList.count() * 0.1 > 5 ? jList.count() * 0.1 : 5);
-        for (int row = 0; row < jList.count(); ++row) {
-            //导出逻辑启动停止控制，外部把m_canRunning置false时停止运行，抛出异常处理
-            if (!m_canRunning) {
-                throw QString(stopStr);
-            }
-            LOG_MSG_DMESG message = jList.at(row);
-            l_merger.setClipboardValue("tableRow", QString("column1").toStdString(), message.msg.toStdString());
-            l_merger.paste("tableRow");
-            //导出进度信号
-            sigProgress(row + 1, jList.count() + end);
-        }
-        //保存，把拼好的xml写入文件中
-        QString fileNamex = fileName + "x";
-
-        QFile rsNameFile(fileName);
-        if (rsNameFile.exists()) {
-            rsNameFile.remove();
-        }
-        l_merger.save(fileNamex.toStdString());
-        QFile(fileNamex).rename(fileName);
-
-    } catch (const QString &ErrorStr) {
-        //捕获到异常，导出失败，发出失败信号
-        qCWarning(logExport) << "Export Stop" << ErrorStr;
-        if (!m_canRunning) {
-            Utils::checkAndDeleteDir(m_fileName);
-        }
-
-        emit sigResult(false);
-        if (ErrorStr != stopStr) {
-            emit sigError(QString("export error: %1").arg(ErrorStr));
-        }
-        return false;
-    }
-    //如果取消导出，则删除文件
-    if (!m_canRunning) {
-        Utils::checkAndDeleteDir(m_fileName);
-    }
-    //100%进度
-    sigProgress(100, 100);
-    //延时200ms再发送导出成功信号，关闭导出进度框，让100%的进度有时间显示
-    Utils::sleep(200);
-    //导出成功，如果此时被停止，则发出导出失败信号
-    emit sigResult(m_canRunning);
-
-    return m_canRunning;
-}
-
-bool LogExportThread::exportToDoc(const QString &fileName, const QList<LOG_MSG_AUDIT> &jList, const QStringList &labels)
-{
-    try {
-        QString tempdir = "/usr/share/deepin-log-viewer/DocxTemplate/5column.dfw";
-        if (!QFile(tempdir).exists()) {
-            qCWarning(logExport) << "export docx template is not exisits";
-            return  false;
-        }
-
-        DocxFactory:: WordProcessingMerger &l_merger = DocxFactory:: WordProcessingMerger::getInstance();
-        l_merger.load(tempdir.toStdString());
-        //往表头中添加表头描述，表头为第一行，数据则在下面
-        for (int col = 0; col < labels.count(); ++col) {
-            l_merger.setClipboardValue("tableRow", QString("column%1").arg(col + 1).toStdString(), labels.at(col).toStdString());
-
-        }
-        l_merger.paste("tableRow");
-        //计算导出进度条最后一段的长度，因为最后写入文件那一段没有进度，所以预先留出一段进度
-        int end = static_cast<int>(jList.count() * 0.1 > 5 ? jList.count() * 0.1 : 5);
-        for (int row = 0; row < jList.count(); ++row) {
-            //导出逻辑启动停止控制，外部把m_canRunning置false时停止运行，抛出异常处理
-            if (!m_canRunning) {
-                throw  QString(stopStr);
-            }
-            LOG_MSG_AUDIT message = jList.at(row);
-            l_merger.setClipboardValue("tableRow", QString("column1").toStdString(), message.eventType.toStdString());
-            l_merger.setClipboardValue("tableRow", QString("column2").toStdString(), message.dateTime.toStdString());
-            l_merger.setClipboardValue("tableRow", QString("column3").toStdString(), message.processName.toStdString());
-            l_merger.setClipboardValue("tableRow", QString("column4").toStdString(), message.status.toStdString());
-            l_merger.setClipboardValue("tableRow", QString("column5").toStdString(), message.msg.toStdString());
-            l_merger.paste("tableRow");
-            //导出进度信号
-            sigProgress(row + 1, jList.count() + end);
-        }
-        //保存，把拼好的xml写入文件中
-        QString fileNamex = fileName + "x";
-
-        QFile rsNameFile(fileName) ;
-        if (rsNameFile.exists()) {
-            rsNameFile.remove();
-        }
-        l_merger.save(fileNamex.toStdString());
-        QFile(fileNamex).rename(fileName);
-
-    } catch (const QString &ErrorStr) {
-        //捕获到异常，导出失败，发出失败信号
-        qCWarning(logExport) << "Export Stop" << ErrorStr;
-        if (!m_canRunning) {
-            Utils::checkAndDeleteDir(m_fileName);
-        }
-
-        emit sigResult(false);
-        if (ErrorStr != stopStr) {
-            emit sigError(QString("export error: %1").arg(ErrorStr));
-        }
-        return false;
-    }
-    //如果取消导出，则删除文件
-    if (!m_canRunning) {
-        Utils::checkAndDeleteDir(m_fileName);
-    }
-    //100%进度
-    sigProgress(100, 100);
-    //延时200ms再发送导出成功信号，关闭导出进度框，让100%的进度有时间显示
-    Utils::sleep(200);
-    //导出成功，如果此时被停止，则发出导出失败信号
-    emit sigResult(m_canRunning);
-
-    return m_canRunning;
-}
-
-/**
- * @brief LogExportThread::exportToHtml导出到日志html格式函数对QStandardItemModel数据类型的重载
- * @param fileName 导出文件路径全称
- * @param pModel 要导出的数据源，为QStandardItemModel
- * @param flag 导出的日志类型
- * @return 是否导出成功
- */
-bool LogExportThread::exportToHtml(const QString &fileName, QStandardItemModel *pModel, LOG_FLAG flag)
-{
-    QFile html(fileName);
-    //判断文件路径是否存在，不存在就返回错误
-    if (!html.open(QIODevice::WriteOnly)) {
-        emit sigResult(false);
-        emit sigError(openErroStr);
-        return false;
-    }
-    try {
-        //判读啊model指针是为空，为空则不导出
-        if (!pModel) {
-            throw  QString("model is null");
-        }
-        //写网页头
-        html.write("<!DOCTYPE html>\n");
-        html.write("<html>\n");
-        html.write("<body>\n");
-        //写入表格标签
-        html.write("<table border=\"1\">\n");
-        // 写入表头
-        html.write("<tr>");
-        for (int i = 0; i < pModel->columnCount(); ++i) {
-            QString labelInfo = QString("<td>%1</td>").arg(pModel->horizontalHeaderItem(i)->text());
-            html.write(labelInfo.toUtf8().data());
-        }
-        html.write("</tr>");
-        // 写入内容
-        //日志类型为应用日志时
-        if (flag == APP) {
-            for (int row = 0; row < pModel->rowCount(); ++row) {
-                //导出逻辑启动停止控制，外部把m_canRunning置false时停止运行，抛出异常处理
-                if (!m_canRunning) {
-                    throw  QString(stopStr);
-                }
-                //根据字段拼出每行的网页内容
-                html.write("<tr>");
-
-                QString info =
-                    QString("<td>%1</td>").arg(pModel->item(row, 0)->data(Qt::UserRole + 6).toString());
-                html.write(info.toUtf8().data());
-
-                for (int col = 1; col < pModel->columnCount(); ++col) {
-                    QString m_info = QString("<td>%1</td>").arg(pModel->item(row, col)->text());
-                    htmlEscapeCovert(m_info);
-                    html.write(m_info.toUtf8().data());
-                }
-                html.write("</tr>");
-                //导出进度信号
-                sigProgress(row + 1, pModel->rowCount());
-            }
-        } else {
-            //日志类型为其他所有日志时
-            for (int row = 0; row < pModel->rowCount(); ++row) {
-                //导出逻辑启动停止控制，外部把m_canRunning置false时停止运行，抛出异常处理
-                if (!m_canRunning) {
-                    throw  QString(stopStr);
-                }
-                //根据字段拼出每行的网页内容
-                html.write("<tr>");
-                for (int col = 0; col < pModel->columnCount(); ++col) {
-                    QString info = QString("<td>%1</td>").arg(pModel->item(row, col)->text());
-                    htmlEscapeCovert(info);
-                    html.write(info.toUtf8().data());
-                }
-                html.write("</tr>");
-                //导出进度信号
-                sigProgress(row + 1, pModel->rowCount());
-            }
-        }
-        html.write("</table>\n");
-        html.write("</body>\n");
-        html.write("</html>\n");
-    } catch (const QString &ErrorStr) {
-        //捕获到异常，导出失败，发出失败信号
-        qCWarning(logExport) << "Export Stop" << ErrorStr;
-        html.close();
-        emit sigResult(false);
-        if (ErrorStr != stopStr) {
-            emit sigError(QString("export error: %1").arg(ErrorStr));
-        }
-        return false;
-    }
-    html.close();
-    //导出成功，如果此时被停止，则发出导出失败信号
-    emit sigResult(m_canRunning);
-    return m_canRunning;
-}
-
-/**
- * @brief LogExportThread::exportToHtml 导出到日志html格式函数，对LOG_MSG_JOURNAL数据类型的重载（指系统日志和内核日志）
- * @param fileName 导出文件路径全称
- * @param jList 要导出的数据源 数据类型为LOG_MSG_JOURNAL
- * @param labels 表头字符串
- * @param flag  导出的日志类型
- * @return 是否导出成功
- */
-bool LogExportThread::exportToHtml(const QString &fileName, const QList<LOG_MSG_JOURNAL> &jList,  const QStringList &labels, LOG_FLAG flag)
-{
-    QFile html(fileName);
-    //判断文件路径是否存在，不存在就返回错误
-    if (!html.open(QIODevice::WriteOnly)) {
-        emit sigResult(false);
-        emit sigError(openErroStr);
-        return false;
-    }
-    try {
-        //写网页头
-        html.write("<!DOCTYPE html>\n");
-        html.write("<html>\n");
-        html.write("<body>\n");
-        //写入表格标签
-        html.write("<table border=\"1\">\n");
-        // 写入内容
-        //日志类型为系统日志时
-        if (flag == JOURNAL) {
-            // 写入表头
-            QString title = QString("<tr><td>") + QString(DApplication::translate("Table", "Level")) +
-                            QString("</td><td>") + QString(DApplication::translate("Table", "Process")) +
-                            QString("</td><td>") +
-                            QString(DApplication::translate("Table", "Date and Time")) +
-                            QString("</td><td>") + QString(DApplication::translate("Table", "Info")) +
-                            QString("</td><td>") + QString(DApplication::translate("Table", "User")) +
-                            QString("</td><td>") + QString(DApplication::translate("Table", "PID")) +
-                            QString("</td></tr>");
-            html.write(title.toUtf8().data());
-            // 写入内容
-            for (int i = 0; i < jList.count(); i++) {
-                //导出逻辑启动停止控制，外部把m_canRunning置false时停止运行，抛出异常处理
-                if (!m_canRunning) {
-                    throw  QString(stopStr);
-                }
-                LOG_MSG_JOURNAL jMsg = jList.at(i);
-                htmlEscapeCovert(jMsg.msg);
-                //根据字段拼出每行的网页内容
-                QString info =
-                    QString("<tr><td>%1</td><td>%2</td><td>%3</td><td>%4</td><td>%5</td><td>%6</td></tr>")
-                    .arg(jMsg.level)
-                    .arg(jMsg.daemonName)
-                    .arg(jMsg.dateTime)
-                    .arg(jMsg.msg)
-                    .arg(jMsg.hostName)
-                    .arg(jMsg.daemonId);
-                html.write(info.toUtf8().data());
-                //导出进度信号
-                sigProgress(i + 1, jList.count());
-
-            }
-        } else if (flag == KERN) {
-            //日志类型为内核日志时
-            // 写入表头
-            html.write("<tr>");
-            for (int i = 0; i < labels.count(); ++i) {
-                QString labelInfo = QString("<td>%1</td>").arg(labels.value(i));
-                html.write(labelInfo.toUtf8().data());
-            }
-            //根据字段拼出每行的网页内容
-            html.write("</tr>");
-            for (int row = 0; row < jList.count(); ++row) {
-                if (!m_canRunning) {
-                    throw  QString(stopStr);
-                }
-                LOG_MSG_JOURNAL jMsg = jList.at(row);
-                html.write("<tr>");
-                QString info = QString("<td>%1</td>").arg(jMsg.dateTime);
-                html.write(info.toUtf8().data());
-                info = QString("<td>%1</td>").arg(jMsg.hostName);
-                html.write(info.toUtf8().data());
-                info = QString("<td>%1</td>").arg(jMsg.daemonName);
-                html.write(info.toUtf8().data());
-                info = QString("<td>%1</td>").arg(jMsg.msg);
-                html.write(info.toUtf8().data());
-                html.write("</tr>");
-                sigProgress(row + 1, jList.count());
-            }
-
-        }
-
-        html.write("</table>\n");
-        html.write("</body>\n");
-        html.write("</html>\n");
-    } catch (const QString &ErrorStr) {
-        //捕获到异常，导出失败，发出失败信号
-        qCWarning(logExport) << "Export Stop" << ErrorStr;
-        html.close();
-        emit sigResult(false);
-        if (ErrorStr != stopStr) {
-            emit sigError(QString("export error: %1").arg(ErrorStr));
-        }
-        return false;
-    }
-    html.close();
-    //导出成功，如果此时被停止，则发出导出失败信号
-    emit sigResult(m_canRunning);
-    return m_canRunning;
-}
-
-/**
- * @brief LogExportThread::exportToHtml导出到日志html格式函数，对LOG_MSG_APPLICATOIN数据类型的重载（指应用日志）
- * @param fileName 导出文件路径全称
- * @param jList 要导出的数据源 数据类型为LOG_MSG_APPLICATOIN
- * @param labels 表头字符串
- * @param iAppName 导出的应用日志的应用名称
- * @return 是否导出成功
- */
-bool LogExportThread::exportToHtml(const QString &fileName, const QList<LOG_MSG_APPLICATOIN> &jList, const QStringList &labels, QString &iAppName)
-{
-    //判断文件路径是否存在，不存在就返回错误
-    QFile html(fileName);
-    if (!html.open(QIODevice::WriteOnly)) {
-        emit sigResult(false);
-        emit sigError(openErroStr);
-        return false;
-    }
-    try {
-        //写网页头
-        html.write("<!DOCTYPE html>\n");
-        html.write("<html>\n");
-        html.write("<body>\n");
-        //写入表格标签
-        html.write("<table border=\"1\">\n");
-        // 写入表头
-        html.write("<tr>");
-        for (int i = 0; i < labels.count(); ++i) {
-            QString labelInfo = QString("<td>%1</td>").arg(labels.value(i));
-            html.write(labelInfo.toUtf8().data());
-        }
-        html.write("</tr>");
-        // 写入内容
-        for (int row = 0; row < jList.count(); ++row) {
-            //导出逻辑启动停止控制，外部把m_canRunning置false时停止运行，抛出异常处理
-            if (!m_canRunning) {
-                throw  QString(stopStr);
-            }
-            //根据字段拼出每行的网页内容
-            LOG_MSG_APPLICATOIN jMsg = jList.at(row);
-            htmlEscapeCovert(jMsg.msg);
-            html.write("<tr>");
-            QString info = QString("<td>%1</td>").arg(strTranslate(jMsg.level));
-            html.write(info.toUtf8().data());
-            info = QString("<td>%1</td>").arg(jMsg.dateTime);
-            html.write(info.toUtf8().data());
-            info = QString("<td>%1</td>").arg(iAppName);
-            html.write(info.toUtf8().data());
-            info = QString("<td>%1</td>").arg(jMsg.msg);
-            html.write(info.toUtf8().data());
-            html.write("</tr>");
-            //导出进度信号
-            sigProgress(row + 1, jList.count());
-        }
-
-        html.write("</table>\n");
-        html.write("</body>\n");
-        html.write("</html>\n");
-    } catch (const QString &ErrorStr) {
-        //捕获到异常，导出失败，发出失败信号
-        qCWarning(logExport) << "Export Stop" << ErrorStr;
-        html.close();
-        emit sigResult(false);
-        if (ErrorStr != stopStr) {
-            emit sigError(QString("export error: %1").arg(ErrorStr));
-        }
-        return false;
-    }
-    html.close();
-    //导出成功，如果此时被停止，则发出导出失败信号
-    emit sigResult(m_canRunning);
-    return m_canRunning;
-}
-
-/**
- * @brief LogExportThread::exportToHtml 导出到日志html格式配置函数，对LOG_MSG_DPKG数据类型的重载（指dpkg日志）
- * @param fileName 导出文件路径全称
- * @param jList  要导出的数据源 LOG_MSG_DPKG
- * @param labels 表头字符串
- * @return 是否导出成功
- */
-bool LogExportThread::exportToHtml(const QString &fileName, const QList<LOG_MSG_DPKG> &jList, const QStringList &labels)
-{
-    //判断文件路径是否存在，不存在就返回错误
-    QFile html(fileName);
-    if (!html.open(QIODevice::WriteOnly)) {
-        emit sigResult(false);
-        emit sigError(openErroStr);
-        return false;
-    }
-    try {
-        //写网页头
-        html.write("<!DOCTYPE html>\n");
-        html.write("<html>\n");
-        html.write("<body>\n");
-        //写入表格标签
-        html.write("<table border=\"1\">\n");
-        // 写入表头
-        html.write("<tr>");
-        for (int i = 0; i < labels.count(); ++i) {
-            QString labelInfo = QString("<td>%1</td>").arg(labels.value(i));
-            html.write(labelInfo.toUtf8().data());
-        }
-        html.write("</tr>");
-        // 写入内容
-        for (int row = 0; row < jList.count(); ++row) {
-            //导出逻辑启动停止控制，外部把m_canRunning置false时停止运行，抛出异常处理
-            if (!m_canRunning) {
-                throw  QString(stopStr);
-            }
-            //根据字段拼出每行的网页内容
-            LOG_MSG_DPKG jMsg = jList.at(row);
-            htmlEscapeCovert(jMsg.msg);
-            html.write("<tr>");
-            QString info = QString("<td>%1</td>").arg(jMsg.dateTime);
-            html.write(info.toUtf8().data());
-            info = QString("<td>%1</td>").arg(jMsg.msg);
-            html.write(info.toUtf8().data());
-            info = QString("<td>%1</td>").arg(jMsg.action);
-            html.write(info.toUtf8().data());
-            html.write("</tr>");
-            //导出进度信号
-            sigProgress(row + 1, jList.count());
-        }
-
-        html.write("</table>\n");
-        html.write("</body>\n");
-        html.write("</html>\n");
-    } catch (const QString &ErrorStr) {
-        //捕获到异常，导出失败，发出失败信号
-        qCWarning(logExport) << "Export Stop" << ErrorStr;
-        html.close();
-        emit sigResult(false);
-        if (ErrorStr != stopStr) {
-            emit sigError(QString("export error: %1").arg(ErrorStr));
-        }
-        return false;
-    }
-    html.close();
-    //导出成功，如果此时被停止，则发出导出失败信号
-    emit sigResult(m_canRunning);
-    return m_canRunning;
-}
-
-/**
- * @brief LogExportThread::exportToHtml导出到日志html格式函数，对LOG_MSG_BOOT数据类型的重载（指启动日志）
- * @param fileName 导出文件路径全称
- * @param jList  要导出的数据源 LOG_MSG_BOOT
- * @param labels 表头字符串
- * @return 是否导出成功
- */
-bool LogExportThread::exportToHtml(const QString &fileName, const QList<LOG_MSG_BOOT> &jList, const QStringList &labels)
-{
-    //判断文件路径是否存在，不存在就返回错误
-    QFile html(fileName);
-    if (!html.open(QIODevice::WriteOnly)) {
-        emit sigResult(false);
-        emit sigError(openErroStr);
-        return false;
-    }
-    try {
-        //写网页头
-        html.write("<!DOCTYPE html>\n");
-        html.write("<html>\n");
-        html.write("<body>\n");
-        //写入表格标签
-        html.write("<table border=\"1\">\n");
-        // 写入表头
-        html.write("<tr>");
-        for (int i = 0; i < labels.count(); ++i) {
-            QString labelInfo = QString("<td>%1</td>").arg(labels.value(i));
-            html.write(labelInfo.toUtf8().data());
-        }
-        html.write("</tr>");
-        // 写入内容
-        for (int row = 0; row < jList.count(); ++row) {
-            //导出逻辑启动停止控制，外部把m_canRunning置false时停止运行，抛出异常处理
-            if (!m_canRunning) {
-                throw  QString(stopStr);
-            }
-            //根据字段拼出每行的网页内容
-            LOG_MSG_BOOT jMsg = jList.at(row);
-            htmlEscapeCovert(jMsg.msg);
-            html.write("<tr>");
-            QString info = QString("<td>%1</td>").arg(jMsg.status);
-            html.write(info.toUtf8().data());
-            info = QString("<td>%1</td>").arg(jMsg.msg);
-            html.write(info.toUtf8().data());
-            html.write("</tr>");
-            //导出进度信号
-            sigProgress(row + 1, jList.count());
-        }
-
-        html.write("</table>\n");
-        html.write("</body>\n");
-        html.write("</html>\n");
-    } catch (const QString &ErrorStr) {
-        //捕获到异常，导出失败，发出失败信号
-        qCWarning(logExport) << "Export Stop" << ErrorStr;
-        html.close();
-        emit sigResult(false);
-        if (ErrorStr != stopStr) {
-            emit sigError(QString("export error: %1").arg(ErrorStr));
-        }
-        return false;
-    }
-    html.close();
-    //导出成功，如果此时被停止，则发出导出失败信号
-    emit sigResult(m_canRunning);
-    return m_canRunning;
-}
-
-/**
- * @brief LogExportThread::exportToHtml 导出到日志html格式函数，对LOG_MSG_XORG数据类型的重载（指xorg日志）
- * @param fileName 导出文件路径全称
- * @param jList 要导出的数据源 LOG_MSG_XORG
- * @param labels 表头字符串
- * @return 是否导出成功
- */
-bool LogExportThread::exportToHtml(const QString &fileName, const QList<LOG_MSG_XORG> &jList, const QStringList &labels)
-{
-    //判断文件路径是否存在，不存在就返回错误
-    QFile html(fileName);
-    if (!html.open(QIODevice::WriteOnly)) {
-        emit sigResult(false);
-        emit sigError(openErroStr);
-        return false;
-    }
-    try {
-        //写网页头
-        html.write("<!DOCTYPE html>\n");
-        html.write("<html>\n");
-        html.write("<body>\n");
-        //写入表格标签
-        html.write("<table border=\"1\">\n");
-        // 写入表头
-        html.write("<tr>");
-        for (int i = 0; i < labels.count(); ++i) {
-            QString labelInfo = QString("<td>%1</td>").arg(labels.value(i));
-            html.write(labelInfo.toUtf8().data());
-        }
-        html.write("</tr>");
-        // 写入内容
-        for (int row = 0; row < jList.count(); ++row) {
-            //导出逻辑启动停止控制，外部把m_canRunning置false时停止运行，抛出异常处理
-            if (!m_canRunning) {
-                throw  QString(stopStr);
-            }
-            //根据字段拼出每行的网页内容
-            LOG_MSG_XORG jMsg = jList.at(row);
-            htmlEscapeCovert(jMsg.msg);
-            html.write("<tr>");
-            QString info = QString("<td>%1</td>").arg(jMsg.offset);
-            html.write(info.toUtf8().data());
-            info = QString("<td>%1</td>").arg(jMsg.msg);
-            html.write(info.toUtf8().data());
-            html.write("</tr>");
-            //导出进度信号
-            sigProgress(row + 1, jList.count());
-        }
-
-        html.write("</table>\n");
-        html.write("</body>\n");
-        html.write("</html>\n");
-    } catch (const QString &ErrorStr) {
-        //捕获到异常，导出失败，发出失败信号
-        qCWarning(logExport) << "Export Stop" << ErrorStr;
-        html.close();
-        emit sigResult(false);
-        if (ErrorStr != stopStr) {
-            emit sigError(QString("export error: %1").arg(ErrorStr));
-        }
-        return false;
-    }
-    html.close();
-    //导出成功，如果此时被停止，则发出导出失败信号
-    emit sigResult(m_canRunning);
-    return m_canRunning;
-}
-
-/**
- * @brief LogExportThread::exportToHtml 导出到日志html格式配置函数，对LOG_MSG_NORMAL数据类型的重载（指开关机日志）
- * @param fileName 导出文件路径全称
- * @param jList 要导出的数据源 LOG_MSG_NORMAL
- * @param labels 表头字符串
- * @return 是否导出成功
- */
-bool LogExportThread::exportToHtml(const QString &fileName, const QList<LOG_MSG_NORMAL> &jList, const QStringList &labels)
-{
-    //判断文件路径是否存在，不存在就返回错误
-    QFile html(fileName);
-    if (!html.open(QIODevice::WriteOnly)) {
-        emit sigResult(false);
-        emit sigError(openErroStr);
-        return false;
-    }
-    try {
-        //写网页头
-        html.write("<!DOCTYPE html>\n");
-        html.write("<html>\n");
-        html.write("<body>\n");
-        //写入表格标签
-        html.write("<table border=\"1\">\n");
-        // 写入表头
-        html.write("<tr>");
-        for (int i = 0; i < labels.count(); ++i) {
-            QString labelInfo = QString("<td>%1</td>").arg(labels.value(i));
-            html.write(labelInfo.toUtf8().data());
-        }
-        html.write("</tr>");
-        // 写入内容
-        for (int row = 0; row < jList.count(); ++row) {
-            //导出逻辑启动停止控制，外部把m_canRunning置false时停止运行，抛出异常处理
-            if (!m_canRunning) {
-                throw  QString(stopStr);
-            }
-            //根据字段拼出每行的网页内容
-            LOG_MSG_NORMAL jMsg = jList.at(row);
-            htmlEscapeCovert(jMsg.msg);
-            html.write("<tr>");
-            QString info = QString("<td>%1</td>").arg(jMsg.eventType);
-            html.write(info.toUtf8().data());
-            info = QString("<td>%1</td>").arg(jMsg.userName);
-            html.write(info.toUtf8().data());
-            info = QString("<td>%1</td>").arg(jMsg.dateTime);
-            html.write(info.toUtf8().data());
-            info = QString("<td>%1</td>").arg(jMsg.msg);
-            html.write(info.toUtf8().data());
-            html.write("</tr>");
-            //导出进度信号
-            sigProgress(row + 1, jList.count());
-        }
-
-        html.write("</table>\n");
-        html.write("</body>\n");
-        html.write("</html>\n");
-    } catch (const QString &ErrorStr) {
-        //捕获到异常，导出失败，发出失败信号
-        qCWarning(logExport) << "Export Stop" << ErrorStr;
-        html.close();
-        emit sigResult(false);
-        if (ErrorStr != stopStr) {
-            emit sigError(QString("export error: %1").arg(ErrorStr));
-        }
-        return false;
-    }
-    html.close();
-    //导出成功，如果此时被停止，则发出导出失败信号
-    emit sigResult(m_canRunning);
-    return m_canRunning;
-}
-
-/**
- * @brief LogExportThread::exportToHtml导出到日志html格式函数，对LOG_MSG_KWIN数据类型的重载（指klu上的kwin日志）
- * @param fileName 导出文件路径全称
- * @param jList 要导出的数据源 LOG_MSG_KWIN
- * @param labels 表头字符串
- * @return 是否导出成功
- */
-bool LogExportThread::exportToHtml(const QString &fileName, const QList<LOG_MSG_KWIN> &jList, const QStringList &labels)
-{
-    //判断文件路径是否存在，不存在就返回错误
-    QFile html(fileName);
-    if (!html.open(QIODevice::WriteOnly)) {
-        emit sigResult(false);
-        emit sigError(openErroStr);
-        return false;
-    }
-    try {
-        //写网页头
-        html.write("<!DOCTYPE html>\n");
-        html.write("<html>\n");
-        html.write("<body>\n");
-        //写入表格标签
-        html.write("<table border=\"1\">\n");
-        // 写入表头
-        html.write("<tr>");
-        for (int i = 0; i < labels.count(); ++i) {
-            QString labelInfo = QString("<td>%1</td>").arg(labels.value(i));
-            html.write(labelInfo.toUtf8().data());
-        }
-        html.write("</tr>");
-        // 写入内容
-        for (int row = 0; row < jList.count(); ++row) {
-            //导出逻辑启动停止控制，外部把m_canRunning置false时停止运行，抛出异常处理
-            if (!m_canRunning) {
-                throw  QString(stopStr);
-            }
-            //根据字段拼出每行的网页内容
-            LOG_MSG_KWIN jMsg = jList.at(row);
-            htmlEscapeCovert(jMsg.msg);
-            html.write("<tr>");
-            QString info = QString("<td>%1</td>").arg(jMsg.msg);
-            html.write(info.toUtf8().data());
-            html.write("</tr>");
-            //导出进度信号
-            sigProgress(row + 1, jList.count());
-        }
-
-        html.write("</table>\n");
-        html.write("</body>\n");
-        html.write("</html>\n");
-    } catch (const QString &ErrorStr) {
-        //捕获到异常，导出失败，发出失败信号
-        qCWarning(logExport) << "Export Stop" << ErrorStr;
-        html.close();
-        emit sigResult(false);
-        if (ErrorStr != stopStr) {
-            emit sigError(QString("export error: %1").arg(ErrorStr));
-        }
-        return false;
-    }
-    html.close();
-    //导出成功，如果此时被停止，则发出导出失败信号
-    emit sigResult(m_canRunning);
-    return m_canRunning;
-}
-
-bool LogExportThread::exportToHtml(const QString &fileName, const QList<LOG_MSG_DNF> &jList, const QStringList &labels)
-{
-    //判断文件路径是否存在，不存在就返回错误
-    QFile html(fileName);
-    if (!html.open(QIODevice::WriteOnly)) {
-        emit sigResult(false);
-        emit sigError(openErroStr);
-        return false;
-    }
-    try {
-        //写网页头
-        html.write("<!DOCTYPE html>\n");
-        html.write("<html>\n");
-        html.write("<body>\n");
-        //写入表格标签
-        html.write("<table border=\"1\">\n");
-        // 写入表头
-        html.write("<tr>");
-        for (int i = 0; i < labels.count(); ++i) {
-            QString labelInfo = QString("<td>%1</td>").arg(labels.value(i));
-            html.write(labelInfo.toUtf8().data());
-        }
-        html.write("</tr>");
-        // 写入内容
-        for (int row = 0; row < jList.count(); ++row) {
-            //导出逻辑启动停止控制，外部把m_canRunning置false时停止运行，抛出异常处理
-            if (!m_canRunning) {
-                throw QString(stopStr);
-            }
-            //根据字段拼出每行的网页内容
-            LOG_MSG_DNF jMsg = jList.at(row);
-            htmlEscapeCovert(jMsg.msg);
-            html.write("<tr>");
-            QString info = QString("<td>%1</td>").arg(jMsg.level);
-            html.write(info.toUtf8().data());
-            info = QString("<td>%1</td>").arg(jMsg.dateTime);
-            html.write(info.toUtf8().data());
-            //此style为使元素内\n换行符起效
-            info = QString("<td style='white-space: pre-line;'>%1</td>").arg(jMsg.msg);
-            html.write(info.toUtf8().data());
-            html.write("</tr>");
-            //导出进度信号
-            sigProgress(row + 1, jList.count());
-        }
-
-        html.write("</table>\n");
-        html.write("</body>\n");
-        html.write("</html>\n");
-    } catch (const QString &ErrorStr) {
-        //捕获到异常，导出失败，发出失败信号
-        qCWarning(logExport) << "Export Stop" << ErrorStr;
-        html.close();
-        emit sigResult(false);
-        if (ErrorStr != stopStr) {
-            emit sigError(QString("export error: %1").arg(ErrorStr));
-        }
-        return false;
-    }
-    html.close();
-    //导出成功，如果此时被停止，则发出导出失败信号
-    emit sigResult(m_canRunning);
-    return m_canRunning;
-}
-
-bool LogExportThread::exportToHtml(const QString &fileName, const QList<LOG_MSG_DMESG> &jList, const QStringList &labels)
-{
-    //判断文件路径是否存在，不存在就返回错误
-    QFile html(fileName);
-    if (!html.open(QIODevice::WriteOnly)) {
-        emit sigResult(false);
-        emit sigError(openErroStr);
-        return false;
-    }
-    try {
-        //写网页头
-        html.write("<!DOCTYPE html>\n");
-        html.write("<html>\n");
-        html.write("<body>\n");
-        //写入表格标签
-        html.write("<table border=\"1\">\n");
-        // 写入表头
-        html.write("<tr>");
-        for (int i = 0; i < labels.count(); ++i) {
-            QString labelInfo = QString("<td>%1</td>").arg(labels.value(i));
-            html.write(labelInfo.toUtf8().data());
-        }
-        html.write("</tr>");
-        // 写入内容
-        for (int row = 0; row < jList.count(); ++row) {
-            //导出逻辑启动停止控制，外部把m_canRunning置false时停止运行，抛出异常处理
-            if (!m_canRunning) {
-                throw QString(stopStr);
-            }
-            //根据字段拼出每行的网页内容
-            LOG_MSG_DMESG jMsg = jList.at(row);
-            htmlEscapeCovert(jMsg.msg);
-            html.write("<tr>");
-            QString info = QString("<td>%1</td>").arg(jMsg.level);
-            html.write(info.toUtf8().data());
-            info = QString("<td>%1</td>").arg(jMsg.dateTime);
-            html.write(info.toUtf8().data());
-            //此style为使元素内\n换行符起效
-            info = QString("<td style='white-space: pre-line;'>%1</td>").arg(jMsg.msg);
-            html.write(info.toUtf8().data());
-            html.write("</tr>");
-            //导出进度信号
-            sigProgress(row + 1, jList.count());
-        }
-
-        html.write("</table>\n");
-        html.write("</body>\n");
-        html.write("</html>\n");
-    } catch (const QString &ErrorStr) {
-        //捕获到异常，导出失败，发出失败信号
-        qCWarning(logExport) << "Export Stop" << ErrorStr;
-        html.close();
-        emit sigResult(false);
-        if (ErrorStr != stopStr) {
-            emit sigError(QString("export error: %1").arg(ErrorStr));
-        }
-        return false;
-    }
-    html.close();
-    //导出成功，如果此时被停止，则发出导出失败信号
-    emit sigResult(m_canRunning);
-    return m_canRunning;
-}
-
-bool LogExportThread::exportToHtml(const QString &fileName, const QList<LOG_MSG_AUDIT> &jList, const QStringList &labels)
-{
-    //判断文件路径是否存在，不存在就返回错误
-    QFile html(fileName);
-    if (!html.open(QIODevice::WriteOnly)) {
-        emit sigResult(false);
-        emit sigError(openErroStr);
-        return false;
-    }
-    try {
-        //写网页头
-        html.write("<!DOCTYPE html>\n");
-        html.write("<html>\n");
-        html.write("<body>\n");
-        //写入表格标签
-        html.write("<table border=\"1\">\n");
-        // 写入表头
-        html.write("<tr>");
-        for (int i = 0; i < labels.count(); ++i) {
-            QString labelInfo = QString("<td>%1</td>").arg(labels.value(i));
-            html.write(labelInfo.toUtf8().data());
-        }
-        html.write("</tr>");
-        // 写入内容
-        for (int row = 0; row < jList.count(); ++row) {
-            //导出逻辑启动停止控制，外部把m_canRunning置false时停止运行，抛出异常处理
-            if (!m_canRunning) {
-                throw  QString(stopStr);
-            }
-            //根据字段拼出每行的网页内容
-            LOG_MSG_AUDIT jMsg = jList.at(row);
-            htmlEscapeCovert(jMsg.msg);
-            html.write("<tr>");
-            QString info = QString("<td>%1</td>").arg(jMsg.eventType);
-            html.write(info.toUtf8().data());
-            info = QString("<td>%1</td>").arg(jMsg.dateTime);
-            html.write(info.toUtf8().data());
-            info = QString("<td>%1</td>").arg(jMsg.processName);
-            html.write(info.toUtf8().data());
-            info = QString("<td>%1</td>").arg(jMsg.status);
-            html.write(info.toUtf8().data());
-            info = QString("<td>%1</td>").arg(jMsg.msg);
-            html.write(info.toUtf8().data());
-            html.write("</tr>");
-            //导出进度信号
-            sigProgress(row + 1, jList.count());
-        }
-
-        html.write("</table>\n");
-        html.write("</body>\n");
-        html.write("</html>\n");
-    } catch (const QString &ErrorStr) {
-        //捕获到异常，导出失败，发出失败信号
-        qCWarning(logExport) << "Export Stop" << ErrorStr;
-        html.close();
-        emit sigResult(false);
-        if (ErrorStr != stopStr) {
-            emit sigError(QString("export error: %1").arg(ErrorStr));
-        }
-        return false;
-    }
-    html.close();
-    //导出成功，如果此时被停止，则发出导出失败信号
-    emit sigResult(m_canRunning);
-    return m_canRunning;
-}
-
-/**
- * @brief LogExportThread::exportToXls导出到日志xlsx格式函数，对LOG_MSG_JOURNAL数据类型的重载（指系统日志和内核日志）
- * @param fileName 导出文件路径全称
- * @param jList 要导出的数据源 数据类型为LOG_MSG_JOURNAL
- * @param labels 表头字符串
- * @param flag  导出的日志类型
- * @return 是否导出成功
- */
-bool LogExportThread::exportToXls(const QString &fileName, const QList<LOG_MSG_JOURNAL> &jList,
-                                  const QStringList &labels, LOG_FLAG iFlag)
-{
-    try {
-        auto currentXlsRow = 0;
-        lxw_workbook  *workbook  = workbook_new(fileName.toStdString().c_str());
-        lxw_worksheet *worksheet = workbook_add_worksheet(workbook, nullptr);
-        lxw_format *format = workbook_add_format(workbook);
-        format_set_bold(format);
-        for (int col = 0; col < labels.count(); ++col) {
-            worksheet_write_string(worksheet, static_cast<lxw_row_t>(currentXlsRow), static_cast<lxw_col_t>(col), labels.at(col).toStdString().c_str(), format);
-        }
-        ++currentXlsRow;
-        int end = static_cast<int>(jList.count() * 0.1 > 5 ? jList.count() * 0.1 : 5);
-
-        for (int row = 0; row < jList.count() ; ++row) {
-            if (!m_canRunning) {
-                throw  QString(stopStr);
-            }
-            LOG_MSG_JOURNAL message = jList.at(row);
-            int col = 0;
-
-            if (iFlag == JOURNAL) {
-                worksheet_write_string(worksheet, static_cast<lxw_row_t>(currentXlsRow), static_cast<lxw_col_t>(col++), message.level.toStdString().c_str(), nullptr);
-                worksheet_write_string(worksheet, static_cast<lxw_row_t>(currentXlsRow), static_cast<lxw_col_t>(col++), message.daemonName.toStdString().c_str(), nullptr);
-                worksheet_write_string(worksheet, static_cast<lxw_row_t>(currentXlsRow), static_cast<lxw_col_t>(col++), message.dateTime.toStdString().c_str(), nullptr);
-                worksheet_write_string(worksheet, static_cast<lxw_row_t>(currentXlsRow), static_cast<lxw_col_t>(col++), message.msg.toStdString().c_str(), nullptr);
-                worksheet_write_string(worksheet, static_cast<lxw_row_t>(currentXlsRow), static_cast<lxw_col_t>(col++), message.hostName.toStdString().c_str(), nullptr);
-                worksheet_write_string(worksheet, static_cast<lxw_row_t>(currentXlsRow), static_cast<lxw_col_t>(col++), message.daemonId.toStdString().c_str(), nullptr);
-            } else if (iFlag == KERN) {
-                worksheet_write_string(worksheet, static_cast<lxw_row_t>(currentXlsRow), static_cast<lxw_col_t>(col++), message.dateTime.toStdString().c_str(), nullptr);
-                worksheet_write_string(worksheet, static_cast<lxw_row_t>(currentXlsRow), static_cast<lxw_col_t>(col++), message.hostName.toStdString().c_str(), nullptr);
-                worksheet_write_string(worksheet, static_cast<lxw_row_t>(currentXlsRow), static_cast<lxw_col_t>(col++), message.daemonName.toStdString().c_str(), nullptr);
-                worksheet_write_string(worksheet, static_cast<lxw_row_t>(currentXlsRow), static_cast<lxw_col_t>(col++), message.msg.toStdString().c_str(), nullptr);
-            }
-
-            ++currentXlsRow;
-            sigProgress(row + 1, jList.count() + end);
-        }
-
-
-        workbook_close(workbook);
-        malloc_trim(0);
-        sigProgress(100, 100);
-    } catch (const QString &ErrorStr) {
-        qCWarning(logExport) << "Export Stop" << ErrorStr;
-        emit sigResult(false);
-        if (ErrorStr != stopStr) {
-            emit sigError(QString("export error: %1").arg(ErrorStr));
-        }
-        return false;
-    }
-    emit sigResult(m_canRunning);
-    return m_canRunning;
-
+    if (flag == KERN)
+        return exportRecordsToHtml<LogExportTraits<LOG_MSG_JOURNAL, KERN>>(fileName, jList, labels);
+    return exportRecordsToHtml<LogExportTraits<LOG_MSG_JOURNAL, JOURNAL>>(fileName, jList, labels);
 }
 
 /**
- * @brief LogExportThread::exportToXls导出到日志xlsx格式函数，对LOG_MSG_APPLICATOIN数据类型的重载（指应用日志）
- * @param fileName 导出文件路径全称
- * @param jList 要导出的数据源 数据类型为LOG_MSG_APPLICATOIN
- * @param labels 表头字符串
+ * @brief LogExportThread::exportToHtml 应用日志导出到html格式
  * @param iAppName 导出的应用日志的应用名称
- * @return 是否导出成功
  */
-bool LogExportThread::exportToXls(const QString &fileName, const QList<LOG_MSG_APPLICATOIN> &jList, const QStringList &labels, QString &iAppName)
+bool LogExportThread::exportToHtml(const QString &fileName, const LogRecordView<LOG_MSG_APPLICATOIN> &jList, const QStringList &labels, QString &iAppName)
 {
-    try {
-        auto currentXlsRow = 0;
-        lxw_workbook  *workbook  = workbook_new(fileName.toStdString().c_str());
-        lxw_worksheet *worksheet = workbook_add_worksheet(workbook, nullptr);
-        lxw_format *format = workbook_add_format(workbook);
-        format_set_bold(format);
-        for (int col = 0; col < labels.count(); ++col) {
-            worksheet_write_string(worksheet, static_cast<lxw_row_t>(currentXlsRow), static_cast<lxw_col_t>(col), labels.at(col).toStdString().c_str(), format);
-        }
-        ++currentXlsRow;
-        int end = static_cast<int>(jList.count() * 0.1 > 5 ? jList.count() * 0.1 : 5);
-
-        for (int row = 0; row < jList.count() ; ++row) {
-            if (!m_canRunning) {
-                throw  QString(stopStr);
-            }
-            LOG_MSG_APPLICATOIN message = jList.at(row);
-            int col = 0;
-            worksheet_write_string(worksheet, static_cast<lxw_row_t>(currentXlsRow), static_cast<lxw_col_t>(col++), strTranslate(message.level).toStdString().c_str(), nullptr);
-            worksheet_write_string(worksheet, static_cast<lxw_row_t>(currentXlsRow), static_cast<lxw_col_t>(col++), message.dateTime.toStdString().c_str(), nullptr);
-            worksheet_write_string(worksheet, static_cast<lxw_row_t>(currentXlsRow), static_cast<lxw_col_t>(col++), iAppName.toStdString().c_str(), nullptr);
-            worksheet_write_string(worksheet, static_cast<lxw_row_t>(currentXlsRow), static_cast<lxw_col_t>(col++), message.msg.toStdString().c_str(), nullptr);
-            ++currentXlsRow;
-            sigProgress(row + 1, jList.count() + end);
-        }
-
-
-        workbook_close(workbook);
-        malloc_trim(0);
-        sigProgress(100, 100);
-    } catch (const QString &ErrorStr) {
-        qCWarning(logExport) << "Export Stop" << ErrorStr;
-        emit sigResult(false);
-        if (ErrorStr != stopStr) {
-            emit sigError(QString("export error: %1").arg(ErrorStr));
-        }
-        return false;
-    }
-    emit sigResult(m_canRunning);
-    return m_canRunning;
-
+    return exportRecordsToHtml<LogExportTraits<LOG_MSG_APPLICATOIN>>(fileName, jList, labels, iAppName);
 }
 
 /**
- * @brief LogExportThread::exportToXls 导出到日志xlsx格式函数，对LOG_MSG_DPKG数据类型的重载（指dpkg日志）
- * @param fileName 导出文件路径全称
- * @param jList  要导出的数据源 LOG_MSG_DPKG
- * @param labels 表头字符串
- * @return 是否导出成功
+ * @brief LogExportThread::exportToHtml dpkg日志导出到html格式
  */
-bool LogExportThread::exportToXls(const QString &fileName, const QList<LOG_MSG_DPKG> &jList, const QStringList &labels)
+bool LogExportThread::exportToHtml(const QString &fileName, const LogRecordView<LOG_MSG_DPKG> &jList, const QStringList &labels)
 {
-    try {
-        auto currentXlsRow = 0;
-        lxw_workbook  *workbook  = workbook_new(fileName.toStdString().c_str());
-        lxw_worksheet *worksheet = workbook_add_worksheet(workbook, nullptr);
-        lxw_format *format = workbook_add_format(workbook);
-        format_set_bold(format);
-        for (int col = 0; col < labels.count(); ++col) {
-            worksheet_write_string(worksheet, static_cast<lxw_row_t>(currentXlsRow), static_cast<lxw_col_t>(col), labels.at(col).toStdString().c_str(), format);
-        }
-        ++currentXlsRow;
-        int end = static_cast<int>(jList.count() * 0.1 > 5 ? jList.count() * 0.1 : 5);
-
-        for (int row = 0; row < jList.count() ; ++row) {
-            if (!m_canRunning) {
-                throw  QString(stopStr);
-            }
-            LOG_MSG_DPKG message = jList.at(row);
-            int col = 0;
-            worksheet_write_string(worksheet, static_cast<lxw_row_t>(currentXlsRow), static_cast<lxw_col_t>(col++), message.dateTime.toStdString().c_str(), nullptr);
-            worksheet_write_string(worksheet, static_cast<lxw_row_t>(currentXlsRow), static_cast<lxw_col_t>(col++), message.msg.toStdString().c_str(), nullptr);
-            worksheet_write_string(worksheet, static_cast<lxw_row_t>(currentXlsRow), static_cast<lxw_col_t>(col++), message.action.toStdString().c_str(), nullptr);
-            ++currentXlsRow;
-            sigProgress(row + 1, jList.count() + end);
-        }
-
-
-        workbook_close(workbook);
-        malloc_trim(0);
-        sigProgress(100, 100);
-    } catch (const QString &ErrorStr) {
-        qCWarning(logExport) << "Export Stop" << ErrorStr;
-        emit sigResult(false);
-        if (ErrorStr != stopStr) {
-            emit sigError(QString("export error: %1").arg(ErrorStr));
-        }
-        return false;
-    }
-    emit sigResult(m_canRunning);
-    return m_canRunning;
+    return exportRecordsToHtml<LogExportTraits<LOG_MSG_DPKG>>(fileName, jList, labels);
 }
 
 /**
- * @brief LogExportThread::exportToXls导出到日志xlsx格式函数，对LOG_MSG_BOOT数据类型的重载（指启动日志）
- * @param fileName 导出文件路径全称
- * @param jList  要导出的数据源 LOG_MSG_DPKG
- * @param labels 表头字符串
- * @return 是否导出成功
+ * @brief LogExportThread::exportToHtml 启动日志导出到html格式
  */
-bool LogExportThread::exportToXls(const QString &fileName, const QList<LOG_MSG_BOOT> &jList, const QStringList &labels)
+bool LogExportThread::exportToHtml(const QString &fileName, const LogRecordView<LOG_MSG_BOOT> &jList, const QStringList &labels)
 {
-    try {
-        auto currentXlsRow = 0;
-        lxw_workbook  *workbook  = workbook_new(fileName.toStdString().c_str());
-        lxw_worksheet *worksheet = workbook_add_worksheet(workbook, nullptr);
-        lxw_format *format = workbook_add_format(workbook);
-        format_set_bold(format);
-        for (int col = 0; col < labels.count(); ++col) {
-            worksheet_write_string(worksheet, static_cast<lxw_row_t>(currentXlsRow), static_cast<lxw_col_t>(col), labels.at(col).toStdString().c_str(), format);
-        }
-        ++currentXlsRow;
-        int end = static_cast<int>(jList.count() * 0.1 > 5 ? jList.count() * 0.1 : 5);
-
-        for (int row = 0; row < jList.count() ; ++row) {
-            if (!m_canRunning) {
-                throw  QString(stopStr);
-            }
-            LOG_MSG_BOOT message = jList.at(row);
-            int col = 0;
-            worksheet_write_string(worksheet, static_cast<lxw_row_t>(currentXlsRow), static_cast<lxw_col_t>(col++), message.status.toStdString().c_str(), nullptr);
-            worksheet_write_string(worksheet, static_cast<lxw_row_t>(currentXlsRow), static_cast<lxw_col_t>(col++), message.msg.toStdString().c_str(), nullptr);
-            ++currentXlsRow;
-            sigProgress(row + 1, jList.count() + end);
-        }
+    return exportRecordsToHtml<LogExportTraits<LOG_MSG_BOOT>>(fileName, jList, labels);
+}
 
+/**
+ * @brief LogExportThread::exportToHtml xorg日志导出到html格式
+ */
+bool LogExportThread::exportToHtml(const QString &fileName, const LogRecordView<LOG_MSG_XORG> &jList, const QStringList &labels)
+{
+    return exportRecordsToHtml<LogExportTraits<LOG_MSG_XORG>>(fileName, jList, labels);
+}
 
-        workbook_close(workbook);
-        malloc_trim(0);
-        sigProgress(100, 100);
-    } catch (const QString &ErrorStr) {
-        qCWarning(logExport) << "Export Stop" << ErrorStr;
-        emit sigResult(false);
-        if (ErrorStr != stopStr) {
-            emit sigError(QString("export error: %1").arg(ErrorStr));
-        }
-        return false;
-    }
-    emit sigResult(m_canRunning);
-    return m_canRunning;
+/**
+ * @brief LogExportThread::exportToHtml 开关机日志导出到html格式
+ */
+bool LogExportThread::exportToHtml(const QString &fileName, const LogRecordView<LOG_MSG_NORMAL> &jList, const QStringList &labels)
+{
+    return exportRecordsToHtml<LogExportTraits<LOG_MSG_NORMAL>>(fileName, jList, labels);
 }
 
 /**
- * @brief LogExportThread::exportToXls导出到日志xlsx格式函数，对LOG_MSG_XORG数据类型的重载（指xorg日志）
- * @param fileName 导出文件路径全称
- * @param jList 要导出的数据源 LOG_MSG_XORG
- * @param labels 表头字符串
- * @return 是否导出成功
+ * @brief LogExportThread::exportToHtml kwin日志导出到html格式
  */
-bool LogExportThread::exportToXls(const QString &fileName, const QList<LOG_MSG_XORG> &jList, const QStringList &labels)
+bool LogExportThread::exportToHtml(const QString &fileName, const LogRecordView<LOG_MSG_KWIN> &jList, const QStringList &labels)
 {
-    try {
-        auto currentXlsRow = 0;
-        lxw_workbook  *workbook  = workbook_new(fileName.toStdString().c_str());
-        lxw_worksheet *worksheet = workbook_add_worksheet(workbook, nullptr);
-        lxw_format *format = workbook_add_format(workbook);
-        format_set_bold(format);
-        for (int col = 0; col < labels.count(); ++col) {
-            worksheet_write_string(worksheet, static_cast<lxw_row_t>(currentXlsRow), static_cast<lxw_col_t>(col), labels.at(col).toStdString().c_str(), format);
-        }
-        ++currentXlsRow;
-        int end = static_cast<int>(jList.count() * 0.1 > 5 ? jList.count() * 0.1 : 5);
+    return exportRecordsToHtml<LogExportTraits<LOG_MSG_KWIN>>(fileName, jList, labels);
+}
 
-        for (int row = 0; row < jList.count() ; ++row) {
-            if (!m_canRunning) {
-                throw  QString(stopStr);
-            }
-            LOG_MSG_XORG message = jList.at(row);
-            int col = 0;
-            worksheet_write_string(worksheet, static_cast<lxw_row_t>(currentXlsRow), static_cast<lxw_col_t>(col++), message.offset.toStdString().c_str(), nullptr);
-            worksheet_write_string(worksheet, static_cast<lxw_row_t>(currentXlsRow), static_cast<lxw_col_t>(col++), message.msg.toStdString().c_str(), nullptr);
-            ++currentXlsRow;
-            sigProgress(row + 1, jList.count() + end);
-        }
+/**
+ * @brief LogExportThread::exportToHtml dnf日志导出到html格式
+ */
+bool LogExportThread::exportToHtml(const QString &fileName, const LogRecordView<LOG_MSG_DNF> &jList, const QStringList &labels)
+{
+    return exportRecordsToHtml<LogExportTraits<LOG_MSG_DNF>>(fileName, jList, labels);
+}
 
+/**
+ * @brief LogExportThread::exportToHtml dmesg日志导出到html格式
+ */
+bool LogExportThread::exportToHtml(const QString &fileName, const LogRecordView<LOG_MSG_DMESG> &jList, const QStringList &labels)
+{
+    return exportRecordsToHtml<LogExportTraits<LOG_MSG_DMESG>>(fileName, jList, labels);
+}
 
-        workbook_close(workbook);
-        malloc_trim(0);
-        sigProgress(100, 100);
-    } catch (const QString &ErrorStr) {
-        qCWarning(logExport) << "Export Stop" << ErrorStr;
-        emit sigResult(false);
-        if (ErrorStr != stopStr) {
-            emit sigError(QString("export error: %1").arg(ErrorStr));
-        }
-        return false;
-    }
-    emit sigResult(m_canRunning);
-    return m_canRunning;
+/**
+ * @brief LogExportThread::exportToHtml 审计日志导出到html格式
+ */
+bool LogExportThread::exportToHtml(const QString &fileName, const LogRecordView<LOG_MSG_AUDIT> &jList, const QStringList &labels)
+{
+    return exportRecordsToHtml<LogExportTraits<LOG_MSG_AUDIT>>(fileName, jList, labels);
 }
 
 /**
- * @brief LogExportThread::exportToXls导出到日志xlsx格式函数，对LOG_MSG_NORMAL数据类型的重载（指开关机日志）
+ * @brief LogExportThread::exportRecordsToXls 按日志类型的导出列导出到xlsx格式
+ * 最后保存文件的耗时按记录数的10%计入进度
  * @param fileName 导出文件路径全称
- * @param jList 要导出的数据源 LOG_MSG_NORMAL
+ * @param jList 要导出的数据源
  * @param labels 表头字符串
+ * @param appName 应用日志导出的应用名称，其他日志不使用
  * @return 是否导出成功
  */
-bool LogExportThread::exportToXls(const QString &fileName, const QList<LOG_MSG_NORMAL> &jList, const QStringList &labels)
+template <typename Traits>
+bool LogExportThread::exportRecordsToXls(const QString &fileName, const LogRecordView<typename Traits::Record> &jList, const QStringList &labels, const QString &appName)
 {
     try {
-        auto currentXlsRow = 0;
-        lxw_workbook  *workbook  = workbook_new(fileName.toStdString().c_str());
-        lxw_worksheet *worksheet = workbook_add_worksheet(workbook, nullptr);
-        lxw_format *format = workbook_add_format(workbook);
-        format_set_bold(format);
-        for (int col = 0; col < labels.count(); ++col) {
-            worksheet_write_string(worksheet, static_cast<lxw_row_t>(currentXlsRow), static_cast<lxw_col_t>(col), labels.at(col).toStdString().c_str(), format);
-        }
-        ++currentXlsRow;
+        LogXlsxWriter xlsx(fileName, labels);
+        if (!xlsx.isOpen())
+            throw QString("create xlsx file failed");
         int end = static_cast<int>(jList.count() * 0.1 > 5 ? jList.count() * 0.1 : 5);
 
-        for (int row = 0; row < jList.count() ; ++row) {
-            if (!m_canRunning) {
-                throw  QString(stopStr);
-            }
-            LOG_MSG_NORMAL message = jList.at(row);
-            int col = 0;
-            worksheet_write_string(worksheet, static_cast<lxw_row_t>(currentXlsRow), static_cast<lxw_col_t>(col++), message.eventType.toStdString().c_str(), nullptr);
-            worksheet_write_string(worksheet, static_cast<lxw_row_t>(currentXlsRow), static_cast<lxw_col_t>(col++), message.userName.toStdString().c_str(), nullptr);
-            worksheet_write_string(worksheet, static_cast<lxw_row_t>(currentXlsRow), static_cast<lxw_col_t>(col++), message.dateTime.toStdString().c_str(), nullptr);
-            worksheet_write_string(worksheet, static_cast<lxw_row_t>(currentXlsRow), static_cast<lxw_col_t>(col++), message.msg.toStdString().c_str(), nullptr);
-            ++currentXlsRow;
-            sigProgress(row + 1, jList.count() + end);
-        }
-
-
-        workbook_close(workbook);
+        //单元格文字在导出线程池中编码为utf8,本线程只按顺序交给libxlsxwriter
+        writeRecordBlocks<Traits>(jList, jList.count() + end, LogXlsxWriter::Rows(),
+                                  [&](LogXlsxWriter::Rows &rows, const typename Traits::Record &record) {
+                                      //等级直接写入预先编码的utf8
+                                      for (const LogExportColumn<typename Traits::Record> &column : Traits::columns) {
+                                          if (const LogRecordFormatter::CodeCell *code = m_formatter.codeCell(column, record))
+                                              rows.appendUtf8(code->utf8);
+                                          else
+                                              rows << m_formatter.cellText(column, record, appName);
+                                      }
+                                      rows.endRow();
+                                  },
+                                  [&](const LogXlsxWriter::Rows &rows) { xlsx.writeRows(rows); });
+
+        if (!xlsx.close())
+            throw QString("write xlsx file failed");
         malloc_trim(0);
         sigProgress(100, 100);
     } catch (const QString &ErrorStr) {
@@ -3171,179 +1436,86 @@ bool LogExportThread::exportToXls(const QString &fileName, const QList<LOG_MSG_N
 }
 
 /**
- * @brief LogExportThread::exportToXls导出到日志xlsw格式函数，对LOG_MSG_KWIN数据类型的重载（指klu上的kwin日志）
- * @param fileName 导出文件路径全称
- * @param jList 要导出的数据源 LOG_MSG_KWIN
- * @param labels 表头字符串
- * @return 是否导出成功
+ * @brief LogExportThread::exportToXls 系统日志和内核日志导出到xlsx格式，按iFlag选择导出列
  */
-bool LogExportThread::exportToXls(const QString &fileName, const QList<LOG_MSG_KWIN> &jList, const QStringList &labels)
+bool LogExportThread::exportToXls(const QString &fileName, const LogRecordView<LOG_MSG_JOURNAL> &jList, const QStringList &labels, LOG_FLAG iFlag)
 {
-    try {
-        auto currentXlsRow = 0;
-        lxw_workbook  *workbook  = workbook_new(fileName.toStdString().c_str());
-        lxw_worksheet *worksheet = workbook_add_worksheet(workbook, nullptr);
-        lxw_format *format = workbook_add_format(workbook);
-        format_set_bold(format);
-        for (int col = 0; col < labels.count(); ++col) {
-            worksheet_write_string(worksheet, static_cast<lxw_row_t>(currentXlsRow), static_cast<lxw_col_t>(col), labels.at(col).toStdString().c_str(), format);
-        }
-        ++currentXlsRow;
-        int end = static_cast<int>(jList.count() * 0.1 > 5 ? jList.count() * 0.1 : 5);
-
-        for (int row = 0; row < jList.count() ; ++row) {
-            if (!m_canRunning) {
-                throw  QString(stopStr);
-            }
-            LOG_MSG_KWIN message = jList.at(row);
-            int col = 0;
-            worksheet_write_string(worksheet, static_cast<lxw_row_t>(currentXlsRow), static_cast<lxw_col_t>(col++), message.msg.toStdString().c_str(), nullptr);
-            ++currentXlsRow;
-            sigProgress(row + 1, jList.count() + end);
-        }
-
-
-        workbook_close(workbook);
-        malloc_trim(0);
-        sigProgress(100, 100);
-    } catch (const QString &ErrorStr) {
-        qCWarning(logExport) << "Export Stop" << ErrorStr;
-        emit sigResult(false);
-        if (ErrorStr != stopStr) {
-            emit sigError(QString("export error: %1").arg(ErrorStr));
-        }
-        return false;
-    }
-    emit sigResult(m_canRunning);
-    return m_canRunning;
+    if (iFlag == KERN)
+        return exportRecordsToXls<LogExportTraits<LOG_MSG_JOURNAL, KERN>>(fileName, jList, labels);
+    return exportRecordsToXls<LogExportTraits<LOG_MSG_JOURNAL, JOURNAL>>(fileName, jList, labels);
 }
 
-bool LogExportThread::exportToXls(const QString &fileName, const QList<LOG_MSG_DNF> &jList, const QStringList &labels)
+/**
+ * @brief LogExportThread::exportToXls 应用日志导出到xlsx格式
+ * @param iAppName 导出的应用日志的应用名称
+ */
+bool LogExportThread::exportToXls(const QString &fileName, const LogRecordView<LOG_MSG_APPLICATOIN> &jList, const QStringList &labels, QString &iAppName)
 {
-    try {
-        auto currentXlsRow = 0;
-        lxw_workbook *workbook = workbook_new(fileName.toStdString().c_str());
-        lxw_worksheet *worksheet = workbook_add_worksheet(workbook, nullptr);
-        lxw_format *format = workbook_add_format(workbook);
-        format_set_bold(format);
-        for (int col = 0; col < labels.count(); ++col) {
-            worksheet_write_string(worksheet, static_cast<lxw_row_t>(currentXlsRow), static_cast<lxw_col_t>(col), labels.at(col).toStdString().c_str(), format);
-        }
-        ++currentXlsRow;
-        int end = static_cast<int>(jList.count() * 0.1 > 5 ? jList.count() * 0.1 : 5);
+    return exportRecordsToXls<LogExportTraits<LOG_MSG_APPLICATOIN>>(fileName, jList, labels, iAppName);
+}
 
-        for (int row = 0; row < jList.count(); ++row) {
-            if (!m_canRunning) {
-                throw QString(stopStr);
-            }
-            LOG_MSG_DNF message = jList.at(row);
-            int col = 0;
-            worksheet_write_string(worksheet, static_cast<lxw_row_t>(currentXlsRow), static_cast<lxw_col_t>(col++), message.dateTime.toStdString().c_str(), nullptr);
-            worksheet_write_string(worksheet, static_cast<lxw_row_t>(currentXlsRow), static_cast<lxw_col_t>(col++), message.level.toStdString().c_str(), nullptr);
-            worksheet_write_string(worksheet, static_cast<lxw_row_t>(currentXlsRow), static_cast<lxw_col_t>(col++), message.msg.toStdString().c_str(), nullptr);
-            ++currentXlsRow;
-            sigProgress(row + 1, jList.count() + end);
-        }
+/**
+ * @brief LogExportThread::exportToXls dpkg日志导出到xlsx格式
+ */
+bool LogExportThread::exportToXls(const QString &fileName, const LogRecordView<LOG_MSG_DPKG> &jList, const QStringList &labels)
+{
+    return exportRecordsToXls<LogExportTraits<LOG_MSG_DPKG>>(fileName, jList, labels);
+}
 
-        workbook_close(workbook);
-        malloc_trim(0);
-        sigProgress(100, 100);
-    } catch (const QString &ErrorStr) {
-        qCWarning(logExport) << "Export Stop" << ErrorStr;
-        emit sigResult(false);
-        if (ErrorStr != stopStr) {
-            emit sigError(QString("export error: %1").arg(ErrorStr));
-        }
-        return false;
-    }
-    emit sigResult(m_canRunning);
-    return m_canRunning;
+/**
+ * @brief LogExportThread::exportToXls 启动日志导出到xlsx格式
+ */
+bool LogExportThread::exportToXls(const QString &fileName, const LogRecordView<LOG_MSG_BOOT> &jList, const QStringList &labels)
+{
+    return exportRecordsToXls<LogExportTraits<LOG_MSG_BOOT>>(fileName, jList, labels);
 }
 
-bool LogExportThread::exportToXls(const QString &fileName, const QList<LOG_MSG_DMESG> &jList, const QStringList &labels)
+/**
+ * @brief LogExportThread::exportToXls xorg日志导出到xlsx格式
+ */
+bool LogExportThread::exportToXls(const QString &fileName, const LogRecordView<LOG_MSG_XORG> &jList, const QStringList &labels)
 {
-    try {
-        auto currentXlsRow = 0;
-        lxw_workbook *workbook = workbook_new(fileName.toStdString().c_str());
-        lxw_worksheet *worksheet = workbook_add_worksheet(workbook, nullptr);
-        lxw_format *format = workbook_add_format(workbook);
-        format_set_bold(format);
-        for (int col = 0; col < labels.count(); ++col) {
-            worksheet_write_string(worksheet, static_cast<lxw_row_t>(currentXlsRow), static_cast<lxw_col_t>(col), labels.at(col).toStdString().c_str(), format);
-        }
-        ++currentXlsRow;
-        int end = static_cast<int>(jList.count() * 0.1 > 5 ? jList.count() * 0.1 : 5);
+    return exportRecordsToXls<LogExportTraits<LOG_MSG_XORG>>(fileName, jList, labels);
+}
 
-        for (int row = 0; row < jList.count(); ++row) {
-            if (!m_canRunning) {
-                throw QString(stopStr);
-            }
-            LOG_MSG_DMESG message = jList.at(row);
-            int col = 0;
-            worksheet_write_string(worksheet, static_cast<lxw_row_t>(currentXlsRow), static_cast<lxw_col_t>(col++), message.dateTime.toStdString().c_str(), nullptr);
-            worksheet_write_string(worksheet, static_cast<lxw_row_t>(currentXlsRow), static_cast<lxw_col_t>(col++), message.level.toStdString().c_str(), nullptr);
-            worksheet_write_string(worksheet, static_cast<lxw_row_t>(currentXlsRow), static_cast<lxw_col_t>(col++), message.msg.toStdString().c_str(), nullptr);
-            ++currentXlsRow;
-            sigProgress(row + 1, jList.count() + end);
-        }
+/**
+ * @brief LogExportThread::exportToXls 开关机日志导出到xlsx格式
+ */
+bool LogExportThread::exportToXls(const QString &fileName, const LogRecordView<LOG_MSG_NORMAL> &jList, const QStringList &labels)
+{
+    return exportRecordsToXls<LogExportTraits<LOG_MSG_NORMAL>>(fileName, jList, labels);
+}
 
-        workbook_close(workbook);
-        malloc_trim(0);
-        sigProgress(100, 100);
-    } catch (const QString &ErrorStr) {
-        qCWarning(logExport) << "Export Stop" << ErrorStr;
-        emit sigResult(false);
-        if (ErrorStr != stopStr) {
-            emit sigError(QString("export error: %1").arg(ErrorStr));
-        }
-        return false;
-    }
-    emit sigResult(m_canRunning);
-    return m_canRunning;
+/**
+ * @brief LogExportThread::exportToXls kwin日志导出到xlsx格式
+ */
+bool LogExportThread::exportToXls(const QString &fileName, const LogRecordView<LOG_MSG_KWIN> &jList, const QStringList &labels)
+{
+    return exportRecordsToXls<LogExportTraits<LOG_MSG_KWIN>>(fileName, jList, labels);
 }
 
-bool LogExportThread::exportToXls(const QString &fileName, const QList<LOG_MSG_AUDIT> &jList, const QStringList &labels)
+/**
+ * @brief LogExportThread::exportToXls dnf日志导出到xlsx格式
+ */
+bool LogExportThread::exportToXls(const QString &fileName, const LogRecordView<LOG_MSG_DNF> &jList, const QStringList &labels)
 {
-    try {
-        auto currentXlsRow = 0;
-        lxw_workbook  *workbook  = workbook_new(fileName.toStdString().c_str());
-        lxw_worksheet *worksheet = workbook_add_worksheet(workbook, nullptr);
-        lxw_format *format = workbook_add_format(workbook);
-        format_set_bold(format);
-        for (int col = 0; col < labels.count(); ++col) {
-            worksheet_write_string(worksheet, static_cast<lxw_row_t>(currentXlsRow), static_cast<lxw_col_t>(col), labels.at(col).toStdString().c_str(), format);
-        }
-        ++currentXlsRow;
-        int end = static_cast<int>(jList.count() * 0.1 > 5 ? jList.count() * 0.1 : 5);
+    return exportRecordsToXls<LogExportTraits<LOG_MSG_DNF>>(fileName, jList, labels);
+}
 
-        for (int row = 0; row < jList.count() ; ++row) {
-            if (!m_canRunning) {
-                throw  QString(stopStr);
-            }
-            LOG_MSG_AUDIT message = jList.at(row);
-            int col = 0;
-            worksheet_write_string(worksheet, static_cast<lxw_row_t>(currentXlsRow), static_cast<lxw_col_t>(col++), message.eventType.toStdString().c_str(), nullptr);
-            worksheet_write_string(worksheet, static_cast<lxw_row_t>(currentXlsRow), static_cast<lxw_col_t>(col++), message.dateTime.toStdString().c_str(), nullptr);
-            worksheet_write_string(worksheet, static_cast<lxw_row_t>(currentXlsRow), static_cast<lxw_col_t>(col++), message.processName.toStdString().c_str(), nullptr);
-            worksheet_write_string(worksheet, static_cast<lxw_row_t>(currentXlsRow), static_cast<lxw_col_t>(col++), message.status.toStdString().c_str(), nullptr);
-            worksheet_write_string(worksheet, static_cast<lxw_row_t>(currentXlsRow), static_cast<lxw_col_t>(col++), message.msg.toStdString().c_str(), nullptr);
-            ++currentXlsRow;
-            sigProgress(row + 1, jList.count() + end);
-        }
+/**
+ * @brief LogExportThread::exportToXls dmesg日志导出到xlsx格式
+ */
+bool LogExportThread::exportToXls(const QString &fileName, const LogRecordView<LOG_MSG_DMESG> &jList, const QStringList &labels)
+{
+    return exportRecordsToXls<LogExportTraits<LOG_MSG_DMESG>>(fileName, jList, labels);
+}
 
-        workbook_close(workbook);
-        malloc_trim(0);
-        sigProgress(100, 100);
-    } catch (const QString &ErrorStr) {
-        qCWarning(logExport) << "Export Stop" << ErrorStr;
-        emit sigResult(false);
-        if (ErrorStr != stopStr) {
-            emit sigError(QString("export error: %1").arg(ErrorStr));
-        }
-        return false;
-    }
-    emit sigResult(m_canRunning);
-    return m_canRunning;
+/**
+ * @brief LogExportThread::exportToXls 审计日志导出到xlsx格式
+ */
+bool LogExportThread::exportToXls(const QString &fileName, const LogRecordView<LOG_MSG_AUDIT> &jList, const QStringList &labels)
+{
+    return exportRecordsToXls<LogExportTraits<LOG_MSG_AUDIT>>(fileName, jList, labels);
 }
 
 bool LogExportThread::exportToZip(const QString &fileName, const QList<LOG_MSG_COREDUMP> &jList)
@@ -3355,55 +1527,61 @@ bool LogExportThread::exportToZip(const QString &fileName, const QList<LOG_MSG_C
     //创建临时目录
     Utils::mkMutiDir(tmpPath);
 
-    //复制文件
-    int nCoreDumpCount = 0;
+    //多条记录可能指向同一个文件,路径去重后一次查询元数据
+    QStringList paths;
+    QSet<QString> seen;
     for (auto &it : jList) {
-        DLDBusHandler::instance(this)->exportLog(tmpPath, it.storagePath, true);
-        if (it.coreFile == "present")
-            nCoreDumpCount++;
-        if (!m_canRunning) {
-            break;
-        }
-    }
-
-    if (!m_canRunning) {
-        return false;
-    }
-    //打包日志文件
-    QProcess procss;
-    procss.setWorkingDirectory(tmpPath);
-    QStringList arg = {"-c"};
-    // 使用7z进行压缩，方便获取进度
-    arg.append(QString("7z a -l -bsp1 tmp.zip ./*;mv tmp.zip '%1'").arg(fileName));
-
-    // refresh progress
-    bool ret = false;
-    // 有coredump文件，才读取压缩进度
-    if (nCoreDumpCount > 0) {
-        connect(&procss, &QProcess::readyReadStandardOutput, this, [&](){
-            if (!m_canRunning) {
-                procss.kill();
-                ret = false;
-                return;
-            }
-
-            QByteArray dd = procss.readAllStandardOutput();
-            QList<QString> lines = QString(dd).split('\n', QString::SkipEmptyParts);
-            for (const QString &line : qAsConst(lines)) {
-                int pos = line.indexOf(QLatin1Char('%'));
-                if (pos > 1) {
-                    int percentage = line.midRef(pos - 3, 3).toInt();
-                    sigProgress(percentage, 100);
-                }
-            }
-            ret = true;
+        if (!it.storagePath.isEmpty() && !seen.contains(it.storagePath)) {
+            seen.insert(it.storagePath);
+            paths.append(it.storagePath);
+        }
+    }
+    const QList<LogFileStat> stats = DLDBusHandler::instance(this)->statFiles(paths);
+    //同一程序反复崩溃常留下内容相同的core,每份内容只复制、压缩一次,其余的记在清单中
+    const QVector<int> payloads = LogExportDedup::payloads(stats, [this](const QList<LogFileStat> &candidates) {
+        return DLDBusHandler::instance(this)->hashExportFiles(candidates);
+    });
+
+    //当前用户能读取的文件直接打包,其余的由服务批量复制到临时目录
+    QList<QFileInfo> readableFiles;
+    QStringList files;
+    for (int i = 0; i < stats.size() && m_canRunning; ++i) {
+        if (payloads.at(i) != i)
+            continue;
+        QFileInfo info(stats.at(i).path);
+        if (stats.at(i).readable && info.isFile())
+            readableFiles.append(info);
+        else
+            files.append(stats.at(i).path);
+    }
+    if (!files.isEmpty() && m_canRunning) {
+        DLDBusHandler::instance(this)->exportLogFiles(tmpPath, files, [this](int, bool) {
+            return m_canRunning;
         });
-    } else {
-        ret = true;
+    }
+    if (LogExportDedup::hasDuplicates(payloads)) {
+        QFile manifest(tmpPath + LOG_EXPORT_MANIFEST_NAME);
+        if (manifest.open(QIODevice::WriteOnly | QIODevice::Truncate))
+            manifest.write(LogExportDedup::manifest(stats, payloads).toUtf8());
     }
 
-    procss.start("/bin/bash", arg);
-    procss.waitForFinished(-1);
+    if (!m_canRunning) {
+        dir.removeRecursively();
+        return false;
+    }
+    //打包日志文件,进度为已压缩的字节数
+    LogZipWriter zip(fileName);
+    for (const QFileInfo &info : readableFiles)
+        zip.addFile(info.filePath(), info.fileName());
+    zip.addDirectory(tmpPath, QString());
+    bool ret = zip.isOpen() && zip.write([this](qint64 done, qint64 total) {
+        if (total > 0)
+            reportProgress(static_cast<int>(done * 100 / total), 100);
+        return m_canRunning;
+    });
+    ret = zip.close() && ret;
+    if (!ret)
+        QFile::remove(fileName);
 
     emit sigResult(ret);
 
@@ -3412,39 +1590,31 @@ bool LogExportThread::exportToZip(const QString &fileName, const QList<LOG_MSG_C
 }
 
 /**
- * @brief LogExportThread::initMap 初始化等级和对应显示字符的map
+ * @brief LogExportThread::isJsonFileName 按文件名判断是否导出为ndjson
  */
-void LogExportThread::initMap()
+bool LogExportThread::isJsonFileName(const QString &fileName)
 {
-    m_levelStrMap.clear();
-    m_levelStrMap.insert("Emergency", DApplication::translate("Level", "Emergency"));
-    m_levelStrMap.insert("Alert", DApplication::translate("Level", "Alert"));
-    m_levelStrMap.insert("Critical", DApplication::translate("Level", "Critical"));
-    m_levelStrMap.insert("Error", DApplication::translate("Level", "Error"));
-    m_levelStrMap.insert("Warning", DApplication::translate("Level", "Warning"));
-    m_levelStrMap.insert("Notice", DApplication::translate("Level", "Notice"));
-    m_levelStrMap.insert("Info", DApplication::translate("Level", "Info"));
-    m_levelStrMap.insert("Debug", DApplication::translate("Level", "Debug"));
+    return fileName.endsWith(".ndjson", Qt::CaseInsensitive) || fileName.endsWith(".ndjson.gz", Qt::CaseInsensitive);
 }
 
 /**
- * @brief LogExportThread::strTranslate 通过等级字符获取显示字符
- * @param iLevelStr 等级字符
- * @return 显示字符
+ * @brief LogExportThread::reportProgress 导出进度,按固定频率合并后再发出sigProgress
+ * @param nCur 当前导出到的条数
+ * @param nTotal 总条数
  */
-QString LogExportThread::strTranslate(const QString &iLevelStr)
+void LogExportThread::reportProgress(int nCur, int nTotal)
 {
-    return m_levelStrMap.value(iLevelStr, iLevelStr);
+    m_progress.report(nCur, nTotal);
 }
 
-void LogExportThread::htmlEscapeCovert(QString &htmlMsg)
+/**
+ * @brief LogExportThread::writeHtmlCell 写入一个html单元格,文字在写入缓冲时一次扫描完成转义
+ */
+void LogExportThread::writeHtmlCell(LogExportWriter &out, const QString &text)
 {
-    //无法对所有转义字符进行转换，对常用转义字符转换
-    htmlMsg.replace("<", "&lt", Qt::CaseInsensitive);
-    htmlMsg.replace(">", "&gt", Qt::CaseInsensitive);
-    htmlMsg.replace("?", "&iexcl", Qt::CaseInsensitive);
-    htmlMsg.replace("￥", "&yen", Qt::CaseInsensitive);
-    htmlMsg.replace("|", "&brvbar", Qt::CaseInsensitive);
+    out << "<td>";
+    out.writeHtmlEscaped(text);
+    out << "</td>";
 }
 
 /**
@@ -3453,6 +1623,7 @@ void LogExportThread::htmlEscapeCovert(QString &htmlMsg)
 void LogExportThread::run()
 {
     qCDebug(logExport) << "threadrun";
+    m_progress.reset();
     sigProgress(0, 100);
     switch (m_runMode) {
     case TxtModel: {
@@ -4,11 +4,20 @@
 
 #ifndef LOGEXPORTTHREAD_H
 #define LOGEXPORTTHREAD_H
+#include "logexportcolumns.h"
+#include "logprogressreporter.h"
+#include "logrecordformatter.h"
+#include "logrecordview.h"
 #include "structdef.h"
 
 #include <QRunnable>
 #include <QObject>
-#include <QStandardItemModel>
+#include <QAbstractItemModel>
+
+//html、doc和xlsx导出时并行格式化的每块记录数
+#define LOG_EXPORT_FORMAT_BLOCK 4096
+
+class LogExportWriter;
 
 /**
  * @brief The LogExportThread class 导出日志线程类
@@ -71,53 +80,53 @@ public:
         NoneExportType = 9999 //任何行为
     };
 
-    void exportToTxtPublic(const QString &fileName, QStandardItemModel *pModel, LOG_FLAG flag);
-    void exportToTxtPublic(const QString &fileName, const QList<LOG_MSG_JOURNAL> &jList,  const QStringList &labels, LOG_FLAG flag);
-    void exportToTxtPublic(const QString &fileName, const QList<LOG_MSG_APPLICATOIN> &jList, const QStringList &labels, const QString &iAppName);
-    void exportToTxtPublic(const QString &fileName, const QList<LOG_MSG_DPKG> &jList, const QStringList &labels);
-    void exportToTxtPublic(const QString &fileName, const QList<LOG_MSG_BOOT> &jList, const QStringList &labels);
-    void exportToTxtPublic(const QString &fileName, const QList<LOG_MSG_XORG> &jList, const QStringList &labels);
-    void exportToTxtPublic(const QString &fileName, const QList<LOG_MSG_NORMAL> &jList, const QStringList &labels);
-    void exportToTxtPublic(const QString &fileName, const QList<LOG_MSG_KWIN> &jList, const QStringList &labels);
-    void exportToTxtPublic(const QString &fileName, const QList<LOG_MSG_DNF> &jList, const QStringList &labels);
-    void exportToTxtPublic(const QString &fileName, const QList<LOG_MSG_DMESG> &jList, const QStringList &labels);
-    void exportToTxtPublic(const QString &fileName, const QList<LOG_MSG_AUDIT> &jList, const QStringList &labels);
-
-    void exportToHtmlPublic(const QString &fileName, QStandardItemModel *pModel, LOG_FLAG flag);
-    void exportToHtmlPublic(const QString &fileName, const QList<LOG_MSG_JOURNAL> &jList,  const QStringList &labels, LOG_FLAG flag);
-    void exportToHtmlPublic(const QString &fileName, const QList<LOG_MSG_APPLICATOIN> &jList, const QStringList &labels, const QString &iAppName);
-    void exportToHtmlPublic(const QString &fileName, const QList<LOG_MSG_DPKG> &jList, const QStringList &labels);
-    void exportToHtmlPublic(const QString &fileName, const QList<LOG_MSG_BOOT> &jList, const QStringList &labels);
-    void exportToHtmlPublic(const QString &fileName, const QList<LOG_MSG_XORG> &jList, const QStringList &labels);
-    void exportToHtmlPublic(const QString &fileName, const QList<LOG_MSG_NORMAL> &jList, const QStringList &labels);
-    void exportToHtmlPublic(const QString &fileName, const QList<LOG_MSG_KWIN> &jList, const QStringList &labels);
-    void exportToHtmlPublic(const QString &fileName, const QList<LOG_MSG_DNF> &jList, const QStringList &labels);
-    void exportToHtmlPublic(const QString &fileName, const QList<LOG_MSG_DMESG> &jList, const QStringList &labels);
-    void exportToHtmlPublic(const QString &fileName, const QList<LOG_MSG_AUDIT> &jList, const QStringList &labels);
-
-    void exportToDocPublic(const QString &fileName, QStandardItemModel *pModel, LOG_FLAG flag);
-    void exportToDocPublic(const QString &fileName, const QList<LOG_MSG_JOURNAL> &jList, const QStringList &labels, LOG_FLAG iFlag);
-    void exportToDocPublic(const QString &fileName, const QList<LOG_MSG_APPLICATOIN> &jList, const QStringList &labels, const QString &iAppName);
-    void exportToDocPublic(const QString &fileName, const QList<LOG_MSG_DPKG> &jList, const QStringList &labels);
-    void exportToDocPublic(const QString &fileName, const QList<LOG_MSG_BOOT> &jList, const QStringList &labels);
-    void exportToDocPublic(const QString &fileName, const QList<LOG_MSG_XORG> &jList, const QStringList &labels);
-    void exportToDocPublic(const QString &fileName, const QList<LOG_MSG_NORMAL> &jList, const QStringList &labels);
-    void exportToDocPublic(const QString &fileName, const QList<LOG_MSG_KWIN> &jList, const QStringList &labels);
-    void exportToDocPublic(const QString &fileName, const QList<LOG_MSG_DNF> &jList, const QStringList &labels);
-    void exportToDocPublic(const QString &fileName, const QList<LOG_MSG_DMESG> &jList, const QStringList &labels);
-    void exportToDocPublic(const QString &fileName, const QList<LOG_MSG_AUDIT> &jList, const QStringList &labels);
-
-    void exportToXlsPublic(const QString &fileName, QStandardItemModel *pModel, LOG_FLAG flag);
-    void exportToXlsPublic(const QString &fileName, const QList<LOG_MSG_JOURNAL> &jList, const QStringList &labels, LOG_FLAG iFlag);
-    void exportToXlsPublic(const QString &fileName, const QList<LOG_MSG_APPLICATOIN> &jList, const QStringList &labels, const QString &iAppName);
-    void exportToXlsPublic(const QString &fileName, const QList<LOG_MSG_DPKG> &jList, const QStringList &labels);
-    void exportToXlsPublic(const QString &fileName, const QList<LOG_MSG_BOOT> &jList, const QStringList &labels);
-    void exportToXlsPublic(const QString &fileName, const QList<LOG_MSG_XORG> &jList, const QStringList &labels);
-    void exportToXlsPublic(const QString &fileName, const QList<LOG_MSG_NORMAL> &jList, const QStringList &labels);
-    void exportToXlsPublic(const QString &fileName, const QList<LOG_MSG_KWIN> &jList, const QStringList &labels);
-    void exportToXlsPublic(const QString &fileName, const QList<LOG_MSG_DNF> &jList, const QStringList &labels);
-    void exportToXlsPublic(const QString &fileName, const QList<LOG_MSG_DMESG> &jList, const QStringList &labels);
-    void exportToXlsPublic(const QString &fileName, const QList<LOG_MSG_AUDIT> &jList, const QStringList &labels);
+    void exportToTxtPublic(const QString &fileName, QAbstractItemModel *pModel, LOG_FLAG flag);
+    void exportToTxtPublic(const QString &fileName, const LogRecordView<LOG_MSG_JOURNAL> &jList,  const QStringList &labels, LOG_FLAG flag);
+    void exportToTxtPublic(const QString &fileName, const LogRecordView<LOG_MSG_APPLICATOIN> &jList, const QStringList &labels, const QString &iAppName);
+    void exportToTxtPublic(const QString &fileName, const LogRecordView<LOG_MSG_DPKG> &jList, const QStringList &labels);
+    void exportToTxtPublic(const QString &fileName, const LogRecordView<LOG_MSG_BOOT> &jList, const QStringList &labels);
+    void exportToTxtPublic(const QString &fileName, const LogRecordView<LOG_MSG_XORG> &jList, const QStringList &labels);
+    void exportToTxtPublic(const QString &fileName, const LogRecordView<LOG_MSG_NORMAL> &jList, const QStringList &labels);
+    void exportToTxtPublic(const QString &fileName, const LogRecordView<LOG_MSG_KWIN> &jList, const QStringList &labels);
+    void exportToTxtPublic(const QString &fileName, const LogRecordView<LOG_MSG_DNF> &jList, const QStringList &labels);
+    void exportToTxtPublic(const QString &fileName, const LogRecordView<LOG_MSG_DMESG> &jList, const QStringList &labels);
+    void exportToTxtPublic(const QString &fileName, const LogRecordView<LOG_MSG_AUDIT> &jList, const QStringList &labels);
+
+    void exportToHtmlPublic(const QString &fileName, QAbstractItemModel *pModel, LOG_FLAG flag);
+    void exportToHtmlPublic(const QString &fileName, const LogRecordView<LOG_MSG_JOURNAL> &jList,  const QStringList &labels, LOG_FLAG flag);
+    void exportToHtmlPublic(const QString &fileName, const LogRecordView<LOG_MSG_APPLICATOIN> &jList, const QStringList &labels, const QString &iAppName);
+    void exportToHtmlPublic(const QString &fileName, const LogRecordView<LOG_MSG_DPKG> &jList, const QStringList &labels);
+    void exportToHtmlPublic(const QString &fileName, const LogRecordView<LOG_MSG_BOOT> &jList, const QStringList &labels);
+    void exportToHtmlPublic(const QString &fileName, const LogRecordView<LOG_MSG_XORG> &jList, const QStringList &labels);
+    void exportToHtmlPublic(const QString &fileName, const LogRecordView<LOG_MSG_NORMAL> &jList, const QStringList &labels);
+    void exportToHtmlPublic(const QString &fileName, const LogRecordView<LOG_MSG_KWIN> &jList, const QStringList &labels);
+    void exportToHtmlPublic(const QString &fileName, const LogRecordView<LOG_MSG_DNF> &jList, const QStringList &labels);
+    void exportToHtmlPublic(const QString &fileName, const LogRecordView<LOG_MSG_DMESG> &jList, const QStringList &labels);
+    void exportToHtmlPublic(const QString &fileName, const LogRecordView<LOG_MSG_AUDIT> &jList, const QStringList &labels);
+
+    void exportToDocPublic(const QString &fileName, QAbstractItemModel *pModel, LOG_FLAG flag);
+    void exportToDocPublic(const QString &fileName, const LogRecordView<LOG_MSG_JOURNAL> &jList, const QStringList &labels, LOG_FLAG iFlag);
+    void exportToDocPublic(const QString &fileName, const LogRecordView<LOG_MSG_APPLICATOIN> &jList, const QStringList &labels, const QString &iAppName);
+    void exportToDocPublic(const QString &fileName, const LogRecordView<LOG_MSG_DPKG> &jList, const QStringList &labels);
+    void exportToDocPublic(const QString &fileName, const LogRecordView<LOG_MSG_BOOT> &jList, const QStringList &labels);
+    void exportToDocPublic(const QString &fileName, const LogRecordView<LOG_MSG_XORG> &jList, const QStringList &labels);
+    void exportToDocPublic(const QString &fileName, const LogRecordView<LOG_MSG_NORMAL> &jList, const QStringList &labels);
+    void exportToDocPublic(const QString &fileName, const LogRecordView<LOG_MSG_KWIN> &jList, const QStringList &labels);
+    void exportToDocPublic(const QString &fileName, const LogRecordView<LOG_MSG_DNF> &jList, const QStringList &labels);
+    void exportToDocPublic(const QString &fileName, const LogRecordView<LOG_MSG_DMESG> &jList, const QStringList &labels);
+    void exportToDocPublic(const QString &fileName, const LogRecordView<LOG_MSG_AUDIT> &jList, const QStringList &labels);
+
+    void exportToXlsPublic(const QString &fileName, QAbstractItemModel *pModel, LOG_FLAG flag);
+    void exportToXlsPublic(const QString &fileName, const LogRecordView<LOG_MSG_JOURNAL> &jList, const QStringList &labels, LOG_FLAG iFlag);
+    void exportToXlsPublic(const QString &fileName, const LogRecordView<LOG_MSG_APPLICATOIN> &jList, const QStringList &labels, const QString &iAppName);
+    void exportToXlsPublic(const QString &fileName, const LogRecordView<LOG_MSG_DPKG> &jList, const QStringList &labels);
+    void exportToXlsPublic(const QString &fileName, const LogRecordView<LOG_MSG_BOOT> &jList, const QStringList &labels);
+    void exportToXlsPublic(const QString &fileName, const LogRecordView<LOG_MSG_XORG> &jList, const QStringList &labels);
+    void exportToXlsPublic(const QString &fileName, const LogRecordView<LOG_MSG_NORMAL> &jList, const QStringList &labels);
+    void exportToXlsPublic(const QString &fileName, const LogRecordView<LOG_MSG_KWIN> &jList, const QStringList &labels);
+    void exportToXlsPublic(const QString &fileName, const LogRecordView<LOG_MSG_DNF> &jList, const QStringList &labels);
+    void exportToXlsPublic(const QString &fileName, const LogRecordView<LOG_MSG_DMESG> &jList, const QStringList &labels);
+    void exportToXlsPublic(const QString &fileName, const LogRecordView<LOG_MSG_AUDIT> &jList, const QStringList &labels);
 
     void exportToZipPublic(const QString &fileName, const QList<LOG_MSG_COREDUMP> &jList, const QStringList &labels);
 
@@ -149,89 +158,110 @@ signals:
      */
     void sigError(QString iError);
 private:
-    bool exportToTxt(const QString &fileName, QStandardItemModel *pModel, LOG_FLAG flag);
-    bool exportToTxt(const QString &fileName, const QList<LOG_MSG_JOURNAL> &jList,  const QStringList &labels, LOG_FLAG flag);
-    bool exportToTxt(const QString &fileName, const QList<LOG_MSG_APPLICATOIN> &jList, const QStringList &labels, const QString &iAppName);
-    bool exportToTxt(const QString &fileName, const QList<LOG_MSG_DPKG> &jList, const QStringList &labels);
-    bool exportToTxt(const QString &fileName, const QList<LOG_MSG_BOOT> &jList, const QStringList &labels);
-    bool exportToTxt(const QString &fileName, const QList<LOG_MSG_XORG> &jList, const QStringList &labels);
-    bool exportToTxt(const QString &fileName, const QList<LOG_MSG_NORMAL> &jList, const QStringList &labels);
-    bool exportToTxt(const QString &fileName, const QList<LOG_MSG_KWIN> &jList, const QStringList &labels);
-    bool exportToTxt(const QString &fileName, const QList<LOG_MSG_DNF> &jList, const QStringList &labels);
-    bool exportToTxt(const QString &fileName, const QList<LOG_MSG_DMESG> &jList, const QStringList &labels);
-    bool exportToTxt(const QString &fileName, const QList<LOG_MSG_AUDIT> &jList, const QStringList &labels);
-
-    bool exportToDoc(const QString &fileName, const QList<LOG_MSG_JOURNAL> &jList, const QStringList &labels, LOG_FLAG iFlag);
-    bool exportToDoc(const QString &fileName, const QList<LOG_MSG_APPLICATOIN> &jList, const QStringList &labels, QString &iAppName);
-    bool exportToDoc(const QString &fileName, const QList<LOG_MSG_DPKG> &jList, const QStringList &labels);
-    bool exportToDoc(const QString &fileName, const QList<LOG_MSG_BOOT> &jList, const QStringList &labels);
-    bool exportToDoc(const QString &fileName, const QList<LOG_MSG_XORG> &jList, const QStringList &labels);
-    bool exportToDoc(const QString &fileName, const QList<LOG_MSG_NORMAL> &jList, const QStringList &labels);
-    bool exportToDoc(const QString &fileName, const QList<LOG_MSG_KWIN> &jList, const QStringList &labels);
-    bool exportToDoc(const QString &fileName, const QList<LOG_MSG_DNF> &jList, const QStringList &labels);
-    bool exportToDoc(const QString &fileName, const QList<LOG_MSG_DMESG> &jList, const QStringList &labels);
-    bool exportToDoc(const QString &fileName, const QList<LOG_MSG_AUDIT> &jList, const QStringList &labels);
-
-    bool exportToHtml(const QString &fileName, QStandardItemModel *pModel, LOG_FLAG flag);
-    bool exportToHtml(const QString &fileName, const QList<LOG_MSG_JOURNAL> &jList,  const QStringList &labels, LOG_FLAG flag);
-    bool exportToHtml(const QString &fileName, const QList<LOG_MSG_APPLICATOIN> &jList, const QStringList &labels, QString &iAppName);
-    bool exportToHtml(const QString &fileName, const QList<LOG_MSG_DPKG> &jList, const QStringList &labels);
-    bool exportToHtml(const QString &fileName, const QList<LOG_MSG_BOOT> &jList, const QStringList &labels);
-    bool exportToHtml(const QString &fileName, const QList<LOG_MSG_XORG> &jList, const QStringList &labels);
-    bool exportToHtml(const QString &fileName, const QList<LOG_MSG_NORMAL> &jList, const QStringList &labels);
-    bool exportToHtml(const QString &fileName, const QList<LOG_MSG_KWIN> &jList, const QStringList &labels);
-    bool exportToHtml(const QString &fileName, const QList<LOG_MSG_DNF> &jList, const QStringList &labels);
-    bool exportToHtml(const QString &fileName, const QList<LOG_MSG_DMESG> &jList, const QStringList &labels);
-    bool exportToHtml(const QString &fileName, const QList<LOG_MSG_AUDIT> &jList, const QStringList &labels);
-
-    bool exportToXls(const QString &fileName, const QList<LOG_MSG_JOURNAL> &jList, const QStringList &labels, LOG_FLAG iFlag);
-    bool exportToXls(const QString &fileName, const QList<LOG_MSG_APPLICATOIN> &jList, const QStringList &labels, QString &iAppName);
-    bool exportToXls(const QString &fileName, const QList<LOG_MSG_DPKG> &jList, const QStringList &labels);
-    bool exportToXls(const QString &fileName, const QList<LOG_MSG_BOOT> &jList, const QStringList &labels);
-    bool exportToXls(const QString &fileName, const QList<LOG_MSG_XORG> &jList, const QStringList &labels);
-    bool exportToXls(const QString &fileName, const QList<LOG_MSG_NORMAL> &jList, const QStringList &labels);
-    bool exportToXls(const QString &fileName, const QList<LOG_MSG_KWIN> &jList, const QStringList &labels);
-    bool exportToXls(const QString &fileName, const QList<LOG_MSG_DNF> &jList, const QStringList &labels);
-    bool exportToXls(const QString &fileName, const QList<LOG_MSG_DMESG> &jList, const QStringList &labels);
-    bool exportToXls(const QString &fileName, const QList<LOG_MSG_AUDIT> &jList, const QStringList &labels);
+    bool exportToTxt(const QString &fileName, QAbstractItemModel *pModel, LOG_FLAG flag);
+    bool exportToTxt(const QString &fileName, const LogRecordView<LOG_MSG_JOURNAL> &jList,  const QStringList &labels, LOG_FLAG flag);
+    bool exportToTxt(const QString &fileName, const LogRecordView<LOG_MSG_APPLICATOIN> &jList, const QStringList &labels, const QString &iAppName);
+    bool exportToTxt(const QString &fileName, const LogRecordView<LOG_MSG_DPKG> &jList, const QStringList &labels);
+    bool exportToTxt(const QString &fileName, const LogRecordView<LOG_MSG_BOOT> &jList, const QStringList &labels);
+    bool exportToTxt(const QString &fileName, const LogRecordView<LOG_MSG_XORG> &jList, const QStringList &labels);
+    bool exportToTxt(const QString &fileName, const LogRecordView<LOG_MSG_NORMAL> &jList, const QStringList &labels);
+    bool exportToTxt(const QString &fileName, const LogRecordView<LOG_MSG_KWIN> &jList, const QStringList &labels);
+    bool exportToTxt(const QString &fileName, const LogRecordView<LOG_MSG_DNF> &jList, const QStringList &labels);
+    bool exportToTxt(const QString &fileName, const LogRecordView<LOG_MSG_DMESG> &jList, const QStringList &labels);
+    bool exportToTxt(const QString &fileName, const LogRecordView<LOG_MSG_AUDIT> &jList, const QStringList &labels);
 
-    bool exportToZip(const QString &fileName, const QList<LOG_MSG_COREDUMP> &jList);
+    bool exportToDoc(const QString &fileName, const LogRecordView<LOG_MSG_JOURNAL> &jList, const QStringList &labels, LOG_FLAG iFlag);
+    bool exportToDoc(const QString &fileName, const LogRecordView<LOG_MSG_APPLICATOIN> &jList, const QStringList &labels, QString &iAppName);
+    bool exportToDoc(const QString &fileName, const LogRecordView<LOG_MSG_DPKG> &jList, const QStringList &labels);
+    bool exportToDoc(const QString &fileName, const LogRecordView<LOG_MSG_BOOT> &jList, const QStringList &labels);
+    bool exportToDoc(const QString &fileName, const LogRecordView<LOG_MSG_XORG> &jList, const QStringList &labels);
+    bool exportToDoc(const QString &fileName, const LogRecordView<LOG_MSG_NORMAL> &jList, const QStringList &labels);
+    bool exportToDoc(const QString &fileName, const LogRecordView<LOG_MSG_KWIN> &jList, const QStringList &labels);
+    bool exportToDoc(const QString &fileName, const LogRecordView<LOG_MSG_DNF> &jList, const QStringList &labels);
+    bool exportToDoc(const QString &fileName, const LogRecordView<LOG_MSG_DMESG> &jList, const QStringList &labels);
+    bool exportToDoc(const QString &fileName, const LogRecordView<LOG_MSG_AUDIT> &jList, const QStringList &labels);
 
-    void initMap();
-    QString strTranslate(const QString &iLevelStr);
+    bool exportToHtml(const QString &fileName, QAbstractItemModel *pModel, LOG_FLAG flag);
+    bool exportToHtml(const QString &fileName, const LogRecordView<LOG_MSG_JOURNAL> &jList,  const QStringList &labels, LOG_FLAG flag);
+    bool exportToHtml(const QString &fileName, const LogRecordView<LOG_MSG_APPLICATOIN> &jList, const QStringList &labels, QString &iAppName);
+    bool exportToHtml(const QString &fileName, const LogRecordView<LOG_MSG_DPKG> &jList, const QStringList &labels);
+    bool exportToHtml(const QString &fileName, const LogRecordView<LOG_MSG_BOOT> &jList, const QStringList &labels);
+    bool exportToHtml(const QString &fileName, const LogRecordView<LOG_MSG_XORG> &jList, const QStringList &labels);
+    bool exportToHtml(const QString &fileName, const LogRecordView<LOG_MSG_NORMAL> &jList, const QStringList &labels);
+    bool exportToHtml(const QString &fileName, const LogRecordView<LOG_MSG_KWIN> &jList, const QStringList &labels);
+    bool exportToHtml(const QString &fileName, const LogRecordView<LOG_MSG_DNF> &jList, const QStringList &labels);
+    bool exportToHtml(const QString &fileName, const LogRecordView<LOG_MSG_DMESG> &jList, const QStringList &labels);
+    bool exportToHtml(const QString &fileName, const LogRecordView<LOG_MSG_AUDIT> &jList, const QStringList &labels);
 
+    bool exportToXls(const QString &fileName, const LogRecordView<LOG_MSG_JOURNAL> &jList, const QStringList &labels, LOG_FLAG iFlag);
+    bool exportToXls(const QString &fileName, const LogRecordView<LOG_MSG_APPLICATOIN> &jList, const QStringList &labels, QString &iAppName);
+    bool exportToXls(const QString &fileName, const LogRecordView<LOG_MSG_DPKG> &jList, const QStringList &labels);
+    bool exportToXls(const QString &fileName, const LogRecordView<LOG_MSG_BOOT> &jList, const QStringList &labels);
+    bool exportToXls(const QString &fileName, const LogRecordView<LOG_MSG_XORG> &jList, const QStringList &labels);
+    bool exportToXls(const QString &fileName, const LogRecordView<LOG_MSG_NORMAL> &jList, const QStringList &labels);
+    bool exportToXls(const QString &fileName, const LogRecordView<LOG_MSG_KWIN> &jList, const QStringList &labels);
+    bool exportToXls(const QString &fileName, const LogRecordView<LOG_MSG_DNF> &jList, const QStringList &labels);
+    bool exportToXls(const QString &fileName, const LogRecordView<LOG_MSG_DMESG> &jList, const QStringList &labels);
+    bool exportToXls(const QString &fileName, const LogRecordView<LOG_MSG_AUDIT> &jList, const QStringList &labels);
+
+    bool exportToZip(const QString &fileName, const QList<LOG_MSG_COREDUMP> &jList);
+
+    //按LogExportTraits中的导出列导出,各日志类型共用
+    template <typename Traits>
+    bool exportRecordsToTxt(const QString &fileName, const LogRecordView<typename Traits::Record> &jList, const QStringList &labels, const QString &appName = QString());
+    template <typename Traits>
+    bool exportRecordsToHtml(const QString &fileName, const LogRecordView<typename Traits::Record> &jList, const QStringList &labels, const QString &appName = QString());
+    template <typename Traits>
+    bool exportRecordsToDoc(const QString &fileName, const LogRecordView<typename Traits::Record> &jList, const QStringList &labels, const QString &appName = QString());
+    template <typename Traits>
+    bool exportRecordsToXls(const QString &fileName, const LogRecordView<typename Traits::Record> &jList, const QStringList &labels, const QString &appName = QString());
+    template <typename Traits, typename WriteRow>
+    void writeRecords(const LogRecordView<typename Traits::Record> &jList, int progressTotal, WriteRow writeRow);
+    template <typename Traits, typename Block, typename FormatRow, typename WriteBlock>
+    void writeRecordBlocks(const LogRecordView<typename Traits::Record> &jList, int progressTotal, const Block &empty,
+                           FormatRow formatRow, WriteBlock writeBlock);
     /**
-     * @brief htmlEscapeCovert html转义字符转换
-     * @param htmlMsg html信息
+     * @brief The HtmlRows struct 并行格式化的若干行html,在格式化线程中转为utf8
      */
-    void htmlEscapeCovert(QString &htmlMsg);
+    struct HtmlRows {
+        QString text;
+        QByteArray utf8;
+    };
+    template <typename Block>
+    static void finishBlock(Block &) {}
+    static void finishBlock(HtmlRows &rows);
+    static bool isJsonFileName(const QString &fileName);
+
+
+    static void writeHtmlCell(LogExportWriter &out, const QString &text);
+    void reportProgress(int nCur, int nTotal);
 
 private:
     //导出文件路径
     QString m_fileName = "";
     //model数据源
-    QStandardItemModel *m_pModel = nullptr;
+    QAbstractItemModel *m_pModel = nullptr;
     //导出日志类型
     LOG_FLAG m_flag = NONE;
     //如果导出项文本标题
     QStringList m_labels;
     //系统日志数据源
-    QList<LOG_MSG_JOURNAL> m_jList;
+    LogRecordView<LOG_MSG_JOURNAL> m_jList;
     //应用日志数据源
-    QList<LOG_MSG_APPLICATOIN> m_appList;
+    LogRecordView<LOG_MSG_APPLICATOIN> m_appList;
     //dpkg日志数据源
-    QList<LOG_MSG_DPKG> m_dpkgList;
+    LogRecordView<LOG_MSG_DPKG> m_dpkgList;
     //启动日志数据源
-    QList<LOG_MSG_BOOT> m_bootList;
+    LogRecordView<LOG_MSG_BOOT> m_bootList;
     //xorg日志数据源
-    QList<LOG_MSG_XORG> m_xorgList;
+    LogRecordView<LOG_MSG_XORG> m_xorgList;
     //开关机日志数据源
-    QList<LOG_MSG_NORMAL> m_normalList;
+    LogRecordView<LOG_MSG_NORMAL> m_normalList;
     //kwin日志数据源
-    QList<LOG_MSG_KWIN> m_kwinList;
-    QList<LOG_MSG_DNF> m_dnfList;
-    QList<LOG_MSG_DMESG> m_dmesgList;
-    QList<LOG_MSG_AUDIT> m_alist;
+    LogRecordView<LOG_MSG_KWIN> m_kwinList;
+    LogRecordView<LOG_MSG_DNF> m_dnfList;
+    LogRecordView<LOG_MSG_DMESG> m_dmesgList;
+    LogRecordView<LOG_MSG_AUDIT> m_alist;
     QList<LOG_MSG_COREDUMP> m_coredumplist;
     //当前线程执行的逻辑种类
     RUN_MODE m_runMode = NoneExportType;
@@ -241,9 +271,11 @@ private:
     QString stopStr = "stop export";
     //应用日志导出的应用名称
     QString m_appName = "";
-    //日志等级-显示文本键值对
-    QMap<QString, QString> m_levelStrMap;
+    //按导出列把记录格式化为文字
+    LogRecordFormatter m_formatter;
     bool m_allLoadComplete;
+    //导出进度的合并通知
+    LogProgressReporter m_progress;
 };
 
 #endif  // LOGEXPORTTHREAD_H
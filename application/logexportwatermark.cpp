@@ -0,0 +1,148 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logexportwatermark.h"
+#include "utils.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QLoggingCategory>
+#include <QSettings>
+
+#ifdef QT_DEBUG
+Q_LOGGING_CATEGORY(logWatermark, "org.deepin.log.viewer.export.watermark")
+#else
+Q_LOGGING_CATEGORY(logWatermark, "org.deepin.log.viewer.export.watermark", QtInfoMsg)
+#endif
+
+//水位文件名,和应用日志扫描缓存一样保存在配置目录
+#define EXPORT_WATERMARK_FILE "export-watermark.conf"
+//水位文件格式版本,格式变化时上次的水位无效
+#define EXPORT_WATERMARK_VERSION 1
+
+/**
+ * @brief LogExportWatermark::LogExportWatermark 读取上次导出的水位
+ * @param filePath 水位文件路径,为空时使用配置目录下的默认文件
+ */
+LogExportWatermark::LogExportWatermark(const QString &filePath)
+    : m_filePath(filePath.isEmpty() ? defaultPath() : filePath)
+    , m_startTime(QDateTime::currentMSecsSinceEpoch())
+{
+    if (!QFile::exists(m_filePath))
+        return;
+
+    QSettings settings(m_filePath, QSettings::IniFormat);
+    if (settings.value("version").toInt() != EXPORT_WATERMARK_VERSION)
+        return;
+
+    m_lastTime = settings.value("lastTime").toLongLong();
+    const QVariantMap files = settings.value("files").toMap();
+    for (auto it = files.constBegin(); it != files.constEnd(); ++it)
+        m_files.insert(it.key(), it.value().toLongLong());
+    const QVariantMap cursors = settings.value("cursors").toMap();
+    for (auto it = cursors.constBegin(); it != cursors.constEnd(); ++it)
+        m_cursors.insert(it.key(), it.value().toString());
+}
+
+/**
+ * @brief LogExportWatermark::isEmpty 是否还没有成功导出过
+ */
+bool LogExportWatermark::isEmpty() const
+{
+    return m_lastTime <= 0;
+}
+
+/**
+ * @brief LogExportWatermark::fileOffset 文件需要从哪个偏移开始导出,返回值不小于文件大小时没有新内容
+ * 记录过的文件被截断时从头导出;没有记录的文件在上次导出之后修改过才导出,
+ * 之前就存在的是上次已经导出过的内容压缩后的轮转文件;上次没有导出过同一目录的文件时从头导出
+ */
+qint64 LogExportWatermark::fileOffset(const LogFileStat &stat) const
+{
+    if (isEmpty() || !stat.exists)
+        return 0;
+
+    const QString key = fileKey(stat);
+    auto it = m_files.constFind(key);
+    if (it != m_files.constEnd())
+        return it.value() <= stat.size ? it.value() : 0;
+    if (stat.mtime > m_lastTime)
+        return 0;
+    //目录的key都以"目录:"开头,按顺序排列,第一个不小于前缀的key即可判断
+    const QString dirPrefix = key.left(key.lastIndexOf(':') + 1);
+    auto dirIt = m_files.lowerBound(dirPrefix);
+    return dirIt != m_files.constEnd() && dirIt.key().startsWith(dirPrefix) ? stat.size : 0;
+}
+
+/**
+ * @brief LogExportWatermark::setFileOffset 记录文件本次导出到的偏移
+ */
+void LogExportWatermark::setFileOffset(const LogFileStat &stat, qint64 offset)
+{
+    if (stat.exists && stat.inode != 0)
+        m_newFiles.insert(fileKey(stat), offset);
+}
+
+/**
+ * @brief LogExportWatermark::journalCursor 上次导出的最后一条journal记录的cursor,没有时为空
+ * @param source 导出命令,应用日志为命令加应用名称
+ */
+QString LogExportWatermark::journalCursor(const QString &source) const
+{
+    return m_cursors.value(source);
+}
+
+void LogExportWatermark::setJournalCursor(const QString &source, const QString &cursor)
+{
+    if (!cursor.isEmpty())
+        m_newCursors.insert(source, cursor);
+}
+
+/**
+ * @brief LogExportWatermark::save 保存本次导出的水位,本次导出没有涉及的journal来源保留上次的cursor
+ */
+bool LogExportWatermark::save()
+{
+    QFileInfo info(m_filePath);
+    if (!info.dir().exists())
+        info.dir().mkpath(info.absolutePath());
+
+    QVariantMap files;
+    for (auto it = m_newFiles.constBegin(); it != m_newFiles.constEnd(); ++it)
+        files.insert(it.key(), it.value());
+    QVariantMap cursors;
+    for (auto it = m_cursors.constBegin(); it != m_cursors.constEnd(); ++it)
+        cursors.insert(it.key(), it.value());
+    for (auto it = m_newCursors.constBegin(); it != m_newCursors.constEnd(); ++it)
+        cursors.insert(it.key(), it.value());
+
+    //按开始导出的时间记录,导出期间修改的文件下次还会导出
+    m_lastTime = m_startTime;
+    QSettings settings(m_filePath, QSettings::IniFormat);
+    settings.clear();
+    settings.setValue("version", EXPORT_WATERMARK_VERSION);
+    settings.setValue("lastTime", m_lastTime);
+    settings.setValue("files", files);
+    settings.setValue("cursors", cursors);
+    settings.sync();
+    if (settings.status() != QSettings::NoError) {
+        qCWarning(logWatermark) << "save export watermark failed:" << m_filePath;
+        return false;
+    }
+    return true;
+}
+
+QString LogExportWatermark::defaultPath()
+{
+    return QDir(Utils::getConfigPath()).filePath(EXPORT_WATERMARK_FILE);
+}
+
+/**
+ * @brief LogExportWatermark::fileKey 所在目录加inode,日志轮转只在同一目录中改名
+ */
+QString LogExportWatermark::fileKey(const LogFileStat &stat)
+{
+    return QString("%1:%2").arg(QFileInfo(stat.path).absolutePath()).arg(stat.inode);
+}
@@ -0,0 +1,49 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGEXPORTWATERMARK_H
+#define LOGEXPORTWATERMARK_H
+
+#include "logfilestat.h"
+
+#include <QMap>
+#include <QString>
+
+/**
+ * @brief The LogExportWatermark class 增量导出的水位,记录每个来源上次导出到的位置
+ * 文本文件按所在目录和inode记录导出到的偏移,轮转改名后的文件inode不变,只导出改名前没有导出的部分;
+ * journal来源记录最后一条的cursor;只有整次导出成功后才调用save写入配置目录
+ */
+class LogExportWatermark
+{
+public:
+    explicit LogExportWatermark(const QString &filePath = QString());
+
+    bool isEmpty() const;
+    qint64 fileOffset(const LogFileStat &stat) const;
+    void setFileOffset(const LogFileStat &stat, qint64 offset);
+    QString journalCursor(const QString &source) const;
+    void setJournalCursor(const QString &source, const QString &cursor);
+    bool save();
+
+    static QString defaultPath();
+
+private:
+    static QString fileKey(const LogFileStat &stat);
+
+    QString m_filePath;
+    //上次成功导出的时间,毫秒
+    qint64 m_lastTime = 0;
+    //本次导出开始的时间,毫秒
+    qint64 m_startTime;
+    //上次导出时记录的文件偏移
+    QMap<QString, qint64> m_files;
+    //上次导出时记录的journal cursor
+    QMap<QString, QString> m_cursors;
+    //本次导出记录的位置,save时替换上次的,已删除的文件不再保留
+    QMap<QString, qint64> m_newFiles;
+    QMap<QString, QString> m_newCursors;
+};
+
+#endif // LOGEXPORTWATERMARK_H
@@ -0,0 +1,196 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logexportwriter.h"
+
+#include <QLoggingCategory>
+
+#ifdef QT_DEBUG
+Q_LOGGING_CATEGORY(logExportWriter, "org.deepin.log.viewer.export.writer")
+#else
+Q_LOGGING_CATEGORY(logExportWriter, "org.deepin.log.viewer.export.writer", QtInfoMsg)
+#endif
+
+namespace {
+/**
+ * @brief The HtmlEscapeTable struct Latin-1范围内每个字符的html实体,不需要转义的为空
+ */
+struct HtmlEscapeTable {
+    HtmlEscapeTable()
+    {
+        entities[static_cast<uchar>('&')] = QLatin1String("&amp;");
+        entities[static_cast<uchar>('<')] = QLatin1String("&lt;");
+        entities[static_cast<uchar>('>')] = QLatin1String("&gt;");
+        entities[static_cast<uchar>('"')] = QLatin1String("&quot;");
+        entities[static_cast<uchar>('\'')] = QLatin1String("&#39;");
+    }
+    QLatin1String entities[256];
+};
+const HtmlEscapeTable kHtmlEscapes;
+
+/**
+ * @brief The JsonEscapeTable struct json字符串中需要转义的ascii字符,其余为空
+ */
+struct JsonEscapeTable {
+    JsonEscapeTable()
+    {
+        for (int code = 0; code < 0x20; ++code) {
+            qsnprintf(controls[code], sizeof(controls[code]), "\\u%04x", code);
+            entities[code] = QLatin1String(controls[code]);
+        }
+        entities[static_cast<uchar>('\b')] = QLatin1String("\\b");
+        entities[static_cast<uchar>('\f')] = QLatin1String("\\f");
+        entities[static_cast<uchar>('\n')] = QLatin1String("\\n");
+        entities[static_cast<uchar>('\r')] = QLatin1String("\\r");
+        entities[static_cast<uchar>('\t')] = QLatin1String("\\t");
+        entities[static_cast<uchar>('"')] = QLatin1String("\\\"");
+        entities[static_cast<uchar>('\\')] = QLatin1String("\\\\");
+    }
+    char controls[0x20][7];
+    QLatin1String entities[0x80];
+};
+const JsonEscapeTable kJsonEscapes;
+}
+
+LogExportWriter::LogExportWriter(QIODevice *device, int blockSize)
+    : m_device(device)
+    , m_blockSize(qMax(1, blockSize))
+{
+    m_buffer.reserve(m_blockSize);
+}
+
+/**
+ * @brief LogExportWriter::~LogExportWriter 写入剩余内容,析构时不能抛出,失败只记日志
+ */
+LogExportWriter::~LogExportWriter()
+{
+    if (!flush())
+        qCWarning(logExportWriter) << "write remaining export text failed";
+}
+
+LogExportWriter &LogExportWriter::operator<<(const QString &text)
+{
+    append(text);
+    return *this;
+}
+
+LogExportWriter &LogExportWriter::operator<<(const char *text)
+{
+    //标签等字面量基本都是ascii,直接按Latin-1追加,不生成临时QString
+    const char *end = text;
+    while (*end && static_cast<uchar>(*end) < 0x80)
+        ++end;
+    if (*end) {
+        append(QString::fromUtf8(text));
+    } else {
+        m_buffer.append(QLatin1String(text, static_cast<int>(end - text)));
+        flushIfFull();
+    }
+    return *this;
+}
+
+/**
+ * @brief LogExportWriter::writeHtmlEscaped 把text转义为html文字写入
+ */
+LogExportWriter &LogExportWriter::writeHtmlEscaped(const QString &text)
+{
+    appendHtmlEscaped(m_buffer, text);
+    flushIfFull();
+    return *this;
+}
+
+/**
+ * @brief LogExportWriter::writeUtf8 写入已在其他线程中转为utf8的内容,先写出缓冲中已有的文字,保持顺序
+ */
+LogExportWriter &LogExportWriter::writeUtf8(const QByteArray &bytes)
+{
+    if (!flush() || !m_device || m_device->write(bytes) != bytes.size())
+        throw QString("write export file failed");
+    m_written += bytes.size();
+    return *this;
+}
+
+/**
+ * @brief LogExportWriter::appendHtmlEscaped 把text中的html特殊字符转为实体追加到out
+ * 只扫描一遍,按256项的表查找每个字符,连续不需要转义的部分整段追加
+ */
+void LogExportWriter::appendHtmlEscaped(QString &out, const QString &text)
+{
+    const QChar *data = text.constData();
+    const int size = text.size();
+    int start = 0;
+    for (int i = 0; i < size; ++i) {
+        const ushort code = data[i].unicode();
+        if (code > 0xFF || kHtmlEscapes.entities[code].size() == 0)
+            continue;
+        out.append(data + start, i - start);
+        out.append(kHtmlEscapes.entities[code]);
+        start = i + 1;
+    }
+    out.append(data + start, size - start);
+}
+
+/**
+ * @brief LogExportWriter::writeJsonEscaped 把text转义为json字符串的内容写入,不包括两侧的引号
+ */
+LogExportWriter &LogExportWriter::writeJsonEscaped(const QString &text)
+{
+    appendJsonEscaped(m_buffer, text);
+    flushIfFull();
+    return *this;
+}
+
+/**
+ * @brief LogExportWriter::appendJsonEscaped 把text中的引号、反斜杠和控制字符转义后追加到out,扫描方式同appendHtmlEscaped
+ */
+void LogExportWriter::appendJsonEscaped(QString &out, const QString &text)
+{
+    const QChar *data = text.constData();
+    const int size = text.size();
+    int start = 0;
+    for (int i = 0; i < size; ++i) {
+        const ushort code = data[i].unicode();
+        if (code >= 0x80 || kJsonEscapes.entities[code].size() == 0)
+            continue;
+        out.append(data + start, i - start);
+        out.append(kJsonEscapes.entities[code]);
+        start = i + 1;
+    }
+    out.append(data + start, size - start);
+}
+
+void LogExportWriter::append(const QString &text)
+{
+    m_buffer += text;
+    flushIfFull();
+}
+
+void LogExportWriter::flushIfFull()
+{
+    //只在完整的字符串之后写入,不会把代理对拆到两次转码中
+    if (m_buffer.size() >= m_blockSize && !flush())
+        throw QString("write export file failed");
+}
+
+/**
+ * @brief LogExportWriter::flush 把缓冲中的内容转为utf8写入设备,保留缓冲的容量
+ * @return 是否全部写入
+ */
+bool LogExportWriter::flush()
+{
+    if (m_buffer.isEmpty())
+        return true;
+    const QByteArray bytes = m_buffer.toUtf8();
+    //resize(0)不释放已分配的空间,下一块继续使用
+    m_buffer.resize(0);
+    if (!m_device || m_device->write(bytes) != bytes.size())
+        return false;
+    m_written += bytes.size();
+    return true;
+}
+
+qint64 LogExportWriter::written() const
+{
+    return m_written;
+}
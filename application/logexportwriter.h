@@ -0,0 +1,49 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGEXPORTWRITER_H
+#define LOGEXPORTWRITER_H
+
+#include <QIODevice>
+#include <QLatin1String>
+#include <QString>
+
+//攒够这么多字符再转码写入一次
+#define EXPORT_WRITE_BLOCK_SIZE (512 * 1024)
+
+/**
+ * @brief The LogExportWriter class 导出文本时的写入缓冲,替代逐字段写入的QTextStream
+ * 文字先追加到预先分配好的缓冲中,攒满一块后整体转为utf8写入,缓冲重复使用,
+ * 导出多少条记录占用的内存都只有一块缓冲;写入失败时抛出QString,和导出函数的异常处理一致
+ * html导出的单元格文字用writeHtmlEscaped边转义边写入,不再先逐个字符replace,ndjson的字符串用writeJsonEscaped
+ */
+class LogExportWriter
+{
+public:
+    explicit LogExportWriter(QIODevice *device, int blockSize = EXPORT_WRITE_BLOCK_SIZE);
+    ~LogExportWriter();
+
+    LogExportWriter &operator<<(const QString &text);
+    LogExportWriter &operator<<(const char *text);
+    LogExportWriter &writeHtmlEscaped(const QString &text);
+    LogExportWriter &writeJsonEscaped(const QString &text);
+    LogExportWriter &writeUtf8(const QByteArray &bytes);
+    bool flush();
+    qint64 written() const;
+
+    static void appendHtmlEscaped(QString &out, const QString &text);
+    static void appendJsonEscaped(QString &out, const QString &text);
+
+private:
+    void append(const QString &text);
+    void flushIfFull();
+
+    QIODevice *m_device = nullptr;
+    int m_blockSize;
+    QString m_buffer;
+    //已写入设备的字节数
+    qint64 m_written = 0;
+};
+
+#endif // LOGEXPORTWRITER_H
@@ -0,0 +1,299 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logfilefollower.h"
+#include "dbusproxy/dldbushandler.h"
+#include "logbytesanitizer.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QLoggingCategory>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef QT_DEBUG
+Q_LOGGING_CATEGORY(logFileFollower, "org.deepin.log.viewer.file.follower")
+#else
+Q_LOGGING_CATEGORY(logFileFollower, "org.deepin.log.viewer.file.follower", QtInfoMsg)
+#endif
+
+//一次读取的inotify事件缓冲,足够容纳多条带文件名的事件
+#define FILE_FOLLOW_EVENT_BUFFER 4096
+
+LogFileFollower::LogFileFollower(const QString &filePath)
+    : m_filePath(filePath)
+    , m_fileName(QFile::encodeName(QFileInfo(filePath).fileName()))
+{
+}
+
+LogFileFollower::~LogFileFollower()
+{
+    close();
+}
+
+/**
+ * @brief LogFileFollower::open 打开文件并开始监视所在目录
+ * @param position 起始位置
+ * @return 是否打开成功,文件不存在或服务也无法打开时失败
+ */
+bool LogFileFollower::open(StartPosition position)
+{
+    close();
+    m_errorString.clear();
+    if (!openFile()) {
+        m_errorString = QString("open %1 failed").arg(m_filePath);
+        return false;
+    }
+    struct stat st;
+    m_offset = (position == FromEnd && fstat(m_fd, &st) == 0) ? st.st_size : 0;
+
+    //监视目录而不是文件,轮转后新建的同名文件也能收到事件
+    m_notifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    const QByteArray dir = QFile::encodeName(QFileInfo(m_filePath).absolutePath());
+    if (m_notifyFd < 0 || inotify_add_watch(m_notifyFd, dir.constData(), IN_MODIFY | IN_CREATE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE | IN_CLOSE_WRITE) < 0) {
+        //inotify不可用(如监视数量达到上限)时按超时间隔检查
+        qCWarning(logFileFollower) << "watch" << dir << "failed, fall back to polling:" << strerror(errno);
+        if (m_notifyFd >= 0) {
+            ::close(m_notifyFd);
+            m_notifyFd = -1;
+        }
+    }
+    m_opened = true;
+    return true;
+}
+
+void LogFileFollower::close()
+{
+    closeFile();
+    if (m_notifyFd >= 0) {
+        ::close(m_notifyFd);
+        m_notifyFd = -1;
+    }
+    m_partial.clear();
+    m_offset = 0;
+    m_opened = false;
+}
+
+bool LogFileFollower::isOpen() const
+{
+    return m_opened;
+}
+
+/**
+ * @brief LogFileFollower::readLines 读取上次之后新追加的完整行
+ * @param lines 输出参数,按从旧到新排列
+ * @return 是否读到了新行,false时通过errorString是否为空区分没有新内容和出错
+ */
+bool LogFileFollower::readLines(QStringList &lines)
+{
+    lines.clear();
+    m_errorString.clear();
+    if (!m_opened)
+        return false;
+
+    //轮转后新文件尚未创建时,稍后再打开
+    if (m_fd < 0) {
+        if (!openFile())
+            return false;
+        m_offset = 0;
+    }
+    if (!readAvailable(lines))
+        return false;
+
+    if (isRotated()) {
+        //旧文件已读完,最后不完整的一行不会再被写完
+        if (!m_partial.isEmpty()) {
+            appendLine(lines, m_partial.constData(), m_partial.size());
+            m_partial.clear();
+        }
+        qCDebug(logFileFollower) << m_filePath << "rotated";
+        closeFile();
+        m_offset = 0;
+        if (openFile() && !readAvailable(lines))
+            return false;
+    }
+    return !lines.isEmpty();
+}
+
+/**
+ * @brief LogFileFollower::waitForChange 等待所在目录中该文件的变化
+ * @param msecs 超时时间,毫秒
+ * @return 是否收到该文件的事件,超时或没有inotify时为false,调用者仍应再读取一次
+ */
+bool LogFileFollower::waitForChange(int msecs)
+{
+    if (m_notifyFd < 0) {
+        poll(nullptr, 0, msecs);
+        return false;
+    }
+    struct pollfd pfd;
+    pfd.fd = m_notifyFd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    if (poll(&pfd, 1, msecs) <= 0 || !(pfd.revents & POLLIN))
+        return false;
+
+    //取空所有事件,只关心文件名匹配的
+    bool changed = false;
+    alignas(struct inotify_event) char buffer[FILE_FOLLOW_EVENT_BUFFER];
+    ssize_t length;
+    while ((length = read(m_notifyFd, buffer, sizeof(buffer))) > 0) {
+        for (char *p = buffer; p < buffer + length;) {
+            const struct inotify_event *event = reinterpret_cast<const struct inotify_event *>(p);
+            if (event->len > 0 && m_fileName == event->name)
+                changed = true;
+            p += sizeof(struct inotify_event) + event->len;
+        }
+    }
+    return changed;
+}
+
+/**
+ * @brief LogFileFollower::follow 跟踪新追加的行,直到被停止
+ * @param canRun 是否继续
+ * @param callback 每批新行的回调,按从旧到新排列
+ * @return 被停止时返回-ECANCELED,出错时返回负的错误码
+ */
+int LogFileFollower::follow(const std::atomic_bool &canRun, const std::function<void(const QStringList &)> &callback)
+{
+    if (!m_opened)
+        return -EBADF;
+
+    QStringList lines;
+    while (canRun) {
+        if (readLines(lines))
+            callback(lines);
+        else if (!m_errorString.isEmpty())
+            return -EIO;
+        waitForChange(FILE_FOLLOW_TIMEOUT);
+    }
+    return -ECANCELED;
+}
+
+/**
+ * @brief LogFileFollower::offset 当前文件中已读取到的位置
+ */
+qint64 LogFileFollower::offset() const
+{
+    return m_offset;
+}
+
+QString LogFileFollower::errorString() const
+{
+    return m_errorString;
+}
+
+/**
+ * @brief LogFileFollower::openFile 打开当前路径的文件,记录inode,没有读权限时由服务打开
+ */
+bool LogFileFollower::openFile()
+{
+    const QByteArray path = QFile::encodeName(m_filePath);
+    int fd = ::open(path.constData(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0 && errno == EACCES) {
+        QDBusUnixFileDescriptor descriptor = DLDBusHandler::instance(nullptr)->openLogFile(m_filePath);
+        //描述符对象析构时会关闭,复制一份自己管理
+        if (descriptor.isValid())
+            fd = fcntl(descriptor.fileDescriptor(), F_DUPFD_CLOEXEC, 0);
+    }
+    if (fd < 0)
+        return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        ::close(fd);
+        return false;
+    }
+    m_fd = fd;
+    m_device = st.st_dev;
+    m_inode = st.st_ino;
+    m_partial.clear();
+    return true;
+}
+
+void LogFileFollower::closeFile()
+{
+    if (m_fd >= 0) {
+        ::close(m_fd);
+        m_fd = -1;
+    }
+}
+
+/**
+ * @brief LogFileFollower::readAvailable 从已读位置读到文件末尾,文件比已读位置短时视为被截断,从开头重新读取
+ */
+bool LogFileFollower::readAvailable(QStringList &lines)
+{
+    struct stat st;
+    if (fstat(m_fd, &st) != 0) {
+        m_errorString = QString::fromLocal8Bit(strerror(errno));
+        return false;
+    }
+    if (st.st_size < m_offset) {
+        qCDebug(logFileFollower) << m_filePath << "truncated";
+        m_offset = 0;
+        m_partial.clear();
+    }
+
+    QByteArray buffer(FILE_FOLLOW_READ_CHUNK, Qt::Uninitialized);
+    forever {
+        const ssize_t length = pread(m_fd, buffer.data(), static_cast<size_t>(buffer.size()), m_offset);
+        if (length < 0) {
+            if (errno == EINTR)
+                continue;
+            m_errorString = QString::fromLocal8Bit(strerror(errno));
+            return false;
+        }
+        if (length == 0)
+            break;
+        m_offset += length;
+
+        const char *begin = buffer.constData();
+        const char *end = begin + length;
+        const char *newline;
+        while ((newline = static_cast<const char *>(memchr(begin, '\n', static_cast<size_t>(end - begin))))) {
+            if (m_partial.isEmpty()) {
+                appendLine(lines, begin, static_cast<int>(newline - begin));
+            } else {
+                m_partial.append(begin, static_cast<int>(newline - begin));
+                appendLine(lines, m_partial.constData(), m_partial.size());
+                m_partial.clear();
+            }
+            begin = newline + 1;
+        }
+        m_partial.append(begin, static_cast<int>(end - begin));
+        if (m_partial.size() > FILE_FOLLOW_LINE_MAX) {
+            appendLine(lines, m_partial.constData(), m_partial.size());
+            m_partial.clear();
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief LogFileFollower::isRotated 路径是否已不再指向当前打开的文件(被移走、删除或替换)
+ */
+bool LogFileFollower::isRotated() const
+{
+    struct stat st;
+    if (stat(QFile::encodeName(m_filePath).constData(), &st) != 0)
+        return true;
+    return st.st_dev != m_device || st.st_ino != m_inode;
+}
+
+void LogFileFollower::appendLine(QStringList &lines, const char *data, int length)
+{
+    QByteArray line(data, length);
+    //和服务端一致,0x00替换为空格,避免转换QString时被截断
+    LogByteSanitizer::sanitize(line, LogByteSanitizer::ReplaceNul);
+    if (line.endsWith('\r'))
+        line.chop(1);
+    lines.append(QString::fromUtf8(line));
+}
@@ -0,0 +1,77 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGFILEFOLLOWER_H
+#define LOGFILEFOLLOWER_H
+
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+
+#include <atomic>
+#include <functional>
+
+#include <sys/types.h>
+
+//每次读取新追加内容的块大小
+#define FILE_FOLLOW_READ_CHUNK (64 * 1024)
+//没有换行的内容超过该长度时按一行交出,避免异常文件占用过多内存
+#define FILE_FOLLOW_LINE_MAX (1024 * 1024)
+//跟踪模式下等待文件变化的超时,超时后检查是否被停止,没有inotify时也按此间隔检查
+#define FILE_FOLLOW_TIMEOUT 500
+
+/**
+ * @brief The LogFileFollower class 跟踪文本日志文件新追加的行,类似tail -F
+ * 用inotify监视文件所在目录(文件本身可能没有读权限),按inode和偏移记录读到的位置;
+ * 文件被轮转(路径指向新的inode)时读完旧文件后从新文件开头继续,被截断时从开头重新读取;
+ * 没有读权限时通过服务以root权限打开文件,只取描述符在本进程读取
+ */
+class LogFileFollower
+{
+public:
+    enum StartPosition {
+        //从文件开头读取
+        FromStart,
+        //只读取打开之后新追加的内容
+        FromEnd
+    };
+
+    explicit LogFileFollower(const QString &filePath);
+    ~LogFileFollower();
+
+    bool open(StartPosition position = FromEnd);
+    void close();
+    bool isOpen() const;
+    bool readLines(QStringList &lines);
+    bool waitForChange(int msecs);
+    int follow(const std::atomic_bool &canRun, const std::function<void(const QStringList &)> &callback);
+    qint64 offset() const;
+    QString errorString() const;
+
+private:
+    Q_DISABLE_COPY(LogFileFollower)
+
+    bool openFile();
+    void closeFile();
+    bool readAvailable(QStringList &lines);
+    bool isRotated() const;
+    void appendLine(QStringList &lines, const char *data, int length);
+
+    QString m_filePath;
+    //目录监视事件中的文件名
+    QByteArray m_fileName;
+    bool m_opened = false;
+    int m_fd = -1;
+    int m_notifyFd = -1;
+    //当前打开的文件,用于判断是否被轮转
+    dev_t m_device = 0;
+    ino_t m_inode = 0;
+    //已读取到的位置
+    qint64 m_offset = 0;
+    //末尾还没有换行的内容,等写完整后再交出
+    QByteArray m_partial;
+    QString m_errorString;
+};
+
+#endif // LOGFILEFOLLOWER_H
@@ -6,12 +6,18 @@
 #define _GNU_SOURCE
 #endif
 #include "logfileparser.h"
+#include "logingestsource.h"
+#include "logsnapshot.h"
+#include "journalreader.h"
 #include "journalwork.h"
+#include "journalfollowwork.h"
+#include "logfollowwork.h"
 #include "sharedmemorymanager.h"
 #include "utils.h"// add by Airy
 #include "wtmpparse.h"
 #include "logapplicationhelper.h"
 
+#include <DApplication>
 #include <DMessageManager>
 
 #include <QDateTime>
@@ -24,6 +30,7 @@
 #include <QMessageBox>
 #include <QProcess>
 #include <QtConcurrent>
+#include <QTimer>
 #include <QLoggingCategory>
 
 #include <time.h>
@@ -57,9 +64,6 @@ LogFileParser::LogFileParser(QWidget *parent)
     m_dateDict.insert("Nov", "11月");
     m_dateDict.insert("Dec", "12月");
 
-    // TODO::
-    m_levelDict.insert("Warning", WARN);
-    m_levelDict.insert("Debug", DEB);
     qRegisterMetaType<QList<LOG_MSG_KWIN> > ("QList<LOG_MSG_KWIN>");
     qRegisterMetaType<QList<LOG_MSG_XORG> > ("QList<LOG_MSG_XORG>");
     qRegisterMetaType<QList<LOG_MSG_DPKG> > ("QList<LOG_MSG_DPKG>");
@@ -72,6 +76,7 @@ LogFileParser::LogFileParser(QWidget *parent)
     qRegisterMetaType<QList<LOG_MSG_COREDUMP>>("QList<LOG_MSG_COREDUMP>");
     qRegisterMetaType<LOG_FLAG> ("LOG_FLAG");
 
+    initCategoryCache();
 }
 
 LogFileParser::~LogFileParser()
@@ -81,11 +86,40 @@ LogFileParser::~LogFileParser()
     SharedMemoryManager::instance()->releaseMemory();
 }
 
-int LogFileParser::parseByJournal(const QStringList &arg)
+int LogFileParser::parseByJournal(const QStringList &arg, const QString &stopCursor)
 {
     stopAllLoad();
     m_isJournalLoading = true;
 
+    //增量读取只取游标之后的新日志,不经过缓存
+    const QString cacheKey = "journal:" + arg.join(',');
+    //快照中的日志不会再增加
+    if (m_snapshot && !stopCursor.isEmpty())
+        return finishSnapshotMiss(++journalWork::thread_index, [this](int index) { emit journalFinished(index); });
+    if (stopCursor.isEmpty()) {
+        int cachedIndex = ++journalWork::thread_index;
+        if (replayCache<LOG_MSG_JOURNAL>(cacheKey, LogCacheValidity(), cachedIndex, &LogFileParser::journalData,
+                                         [this, cachedIndex](const QString & cursor) {
+                                             if (!cursor.isEmpty())
+                                                 emit journalCursor(cachedIndex, cursor);
+                                             emit journalFinished(cachedIndex);
+                                         }))
+            return cachedIndex;
+        //缩小等级或时间范围时从已缓存的更大范围的结果中筛出
+        const std::function<bool(const LOG_MSG_JOURNAL &)> accept = journalSubset(arg);
+        if (accept) {
+            if (replaySubset<LOG_MSG_JOURNAL>("journal", journalRange(arg), LogCacheValidity(), cachedIndex, &LogFileParser::journalData, accept,
+                                              [this, cachedIndex](const QString & cursor) {
+                                                  if (!cursor.isEmpty())
+                                                      emit journalCursor(cachedIndex, cursor);
+                                                  emit journalFinished(cachedIndex);
+                                              }))
+                return cachedIndex;
+        }
+        if (m_snapshot)
+            return finishSnapshotMiss(cachedIndex, [this](int index) { emit journalFinished(index); });
+    }
+
 #if 0
     m_currentJournalWork = journalWork::instance();
 
@@ -116,25 +150,132 @@ int LogFileParser::parseByJournal(const QStringList &arg)
     journalWork *work = new journalWork(this);
 
     work->setArg(arg);
+    work->setStopCursor(stopCursor);
     auto a = connect(work, &journalWork::journalFinished, this, &LogFileParser::journalFinished,
                      Qt::QueuedConnection);
     auto b = connect(work, &journalWork::journalData, this, &LogFileParser::journalData,
                      Qt::QueuedConnection);
+    connect(work, &journalWork::journalCursor, this, &LogFileParser::journalCursor,
+            Qt::QueuedConnection);
 
     connect(this, &LogFileParser::stopJournal, work, &journalWork::stopWork);
 
     int index = work->getIndex();
-    QThreadPool::globalInstance()->start(work);
+    if (stopCursor.isEmpty())
+        beginCache(cacheKey, index, LogCacheValidity(), "journal", journalRange(arg));
+    LogWorkScheduler::instance()->start(work, LogWorkScheduler::Interactive);
     return index;
 #endif
 }
 
-int LogFileParser::parseByJournalBoot(const QStringList &arg)
+/**
+ * @brief LogFileParser::parseByJournalFollow 启动系统日志实时跟踪线程,不停止其他正在进行的获取
+ * @param arg 筛选参数,和parseByJournal一致
+ * @param startCursor 已读取到的最新一条日志的游标
+ * @return 线程标号
+ */
+int LogFileParser::parseByJournalFollow(const QStringList &arg, const QString &startCursor)
+{
+    //快照中的日志不会再变化,不跟踪本机日志
+    if (m_snapshot)
+        return -1;
+    emit stopJournalFollow();
+    JournalFollowWork *work = new JournalFollowWork(this);
+
+    work->setArg(arg);
+    work->setStartCursor(startCursor);
+    connect(work, &JournalFollowWork::journalFollowData, this, &LogFileParser::journalFollowData,
+            Qt::QueuedConnection);
+    connect(work, &JournalFollowWork::journalFollowFinished, this, &LogFileParser::journalFollowFinished,
+            Qt::QueuedConnection);
+    connect(this, &LogFileParser::stopJournalFollow, work, &JournalFollowWork::stopWork);
+
+    int index = work->getIndex();
+    LogWorkScheduler::instance()->start(work, LogWorkScheduler::Follow);
+    return index;
+}
+
+/**
+ * @brief LogFileParser::parseByKernFollow 启动kern.log实时跟踪线程,只发出之后新追加的日志
+ * @return 线程标号
+ */
+int LogFileParser::parseByKernFollow()
+{
+    //快照中的日志不会再变化,不跟踪本机日志
+    if (m_snapshot)
+        return -1;
+    emit stopLogFollow();
+    LogFollowWork *work = new LogFollowWork(LogFollowWork::KernFile, this);
+
+    work->setFilePath(KERN_TREE_DATA);
+    connect(work, &LogFollowWork::kernFollowData, this, &LogFileParser::kernFollowData,
+            Qt::QueuedConnection);
+    connect(work, &LogFollowWork::followFinished, this, &LogFileParser::logFollowFinished,
+            Qt::QueuedConnection);
+    connect(this, &LogFileParser::stopLogFollow, work, &LogFollowWork::stopWork);
+
+    int index = work->getIndex();
+    LogWorkScheduler::instance()->start(work, LogWorkScheduler::Follow);
+    return index;
+}
+
+/**
+ * @brief LogFileParser::parseByDmesgFollow 启动内核环形缓冲区实时跟踪线程,只发出之后新产生的日志
+ * @param level 等级筛选,-1为全部
+ * @return 线程标号
+ */
+int LogFileParser::parseByDmesgFollow(int level)
+{
+    //快照中的日志不会再变化,不跟踪本机日志
+    if (m_snapshot)
+        return -1;
+    emit stopLogFollow();
+    LogFollowWork *work = new LogFollowWork(LogFollowWork::Kmsg, this);
+
+    work->setLevelFilter(level);
+    connect(work, &LogFollowWork::dmesgFollowData, this, &LogFileParser::dmesgFollowData,
+            Qt::QueuedConnection);
+    connect(work, &LogFollowWork::followFinished, this, &LogFileParser::logFollowFinished,
+            Qt::QueuedConnection);
+    connect(this, &LogFileParser::stopLogFollow, work, &LogFollowWork::stopWork);
+
+    int index = work->getIndex();
+    LogWorkScheduler::instance()->start(work, LogWorkScheduler::Follow);
+    return index;
+}
+
+/**
+ * @brief LogFileParser::parseByTextFollow 启动文本日志实时跟踪线程,只按行发出之后新追加的内容
+ * @param filePath 日志文件路径,轮转和截断后继续跟踪同名的新文件
+ * @return 线程标号
+ */
+int LogFileParser::parseByTextFollow(const QString &filePath)
+{
+    //快照中的日志不会再变化,不跟踪本机日志
+    if (m_snapshot)
+        return -1;
+    emit stopLogFollow();
+    LogFollowWork *work = new LogFollowWork(LogFollowWork::TextFile, this);
+
+    work->setFilePath(filePath);
+    connect(work, &LogFollowWork::lineFollowData, this, &LogFileParser::lineFollowData,
+            Qt::QueuedConnection);
+    connect(work, &LogFollowWork::followFinished, this, &LogFileParser::logFollowFinished,
+            Qt::QueuedConnection);
+    connect(this, &LogFileParser::stopLogFollow, work, &LogFollowWork::stopWork);
+
+    int index = work->getIndex();
+    LogWorkScheduler::instance()->start(work, LogWorkScheduler::Follow);
+    return index;
+}
+
+int LogFileParser::parseByJournalBoot(const QStringList &arg, const QString &bootId)
 {
     stopAllLoad();
     JournalBootWork *work = new JournalBootWork(this);
 
     work->setArg(arg);
+    work->setBootId(bootId);
     auto a = connect(work, &JournalBootWork::journalBootFinished, this, &LogFileParser::journalBootFinished,
                      Qt::QueuedConnection);
     auto b = connect(work, &JournalBootWork::journaBootlData, this, &LogFileParser::journaBootlData,
@@ -143,50 +284,18 @@ int LogFileParser::parseByJournalBoot(const QStringList &arg)
     connect(this, &LogFileParser::stopJournalBoot, work, &JournalBootWork::stopWork);
 
     int index = work->getIndex();
-    QThreadPool::globalInstance()->start(work);
+    LogWorkScheduler::instance()->start(work, LogWorkScheduler::Interactive);
     return index;
 }
 
 int LogFileParser::parseByDpkg(const DKPG_FILTERS &iDpkgFilter)
 {
-
-    stopAllLoad();
-    LogAuthThread   *authThread = new LogAuthThread(this);
-    authThread->setType(DPKG);
-    QStringList filePath = DLDBusHandler::instance(this)->getFileInfo("dpkg");
-    //    const QString&str="/var/log/kern";
-    authThread->setFilePath(filePath);
-    authThread->setFileterParam(iDpkgFilter);
-    connect(authThread, &LogAuthThread::proccessError, this,
-            &LogFileParser::slog_proccessError, Qt::UniqueConnection);
-    connect(authThread, &LogAuthThread::dpkgFinished, this,
-            &LogFileParser::dpkgFinished, Qt::UniqueConnection);
-    connect(authThread, &LogAuthThread::dpkgData, this,
-            &LogFileParser::dpkgData, Qt::UniqueConnection);
-    connect(this, &LogFileParser::stopDpkg, authThread, &LogAuthThread::stopProccess);
-    int index = authThread->getIndex();
-    QThreadPool::globalInstance()->start(authThread);
-    return index;
+    return startSource(iDpkgFilter);
 }
 
 int LogFileParser::parseByXlog(const XORG_FILTERS &iXorgFilter)    // modifed by Airy
 {
-    stopAllLoad();
-    LogAuthThread   *authThread = new LogAuthThread(this);
-    authThread->setType(XORG);
-    QStringList filePath = DLDBusHandler::instance(this)->getFileInfo("Xorg");
-    authThread->setFilePath(filePath);
-    authThread->setFileterParam(iXorgFilter);
-    connect(authThread, &LogAuthThread::proccessError, this,
-            &LogFileParser::slog_proccessError, Qt::UniqueConnection);
-    connect(authThread, &LogAuthThread::xorgFinished, this,
-            &LogFileParser::xlogFinished, Qt::UniqueConnection);
-    connect(authThread, &LogAuthThread::xorgData, this,
-            &LogFileParser::xlogData, Qt::UniqueConnection);
-    connect(this, &LogFileParser::stopXlog, authThread, &LogAuthThread::stopProccess);
-    int index = authThread->getIndex();
-    QThreadPool::globalInstance()->tryStart(authThread);
-    return index;
+    return startSource(iXorgFilter);
 }
 
 int LogFileParser::parseByNormal(const NORMAL_FILTERS &iNormalFiler)
@@ -203,7 +312,8 @@ int LogFileParser::parseByNormal(const NORMAL_FILTERS &iNormalFiler)
             &LogFileParser::normalData, Qt::UniqueConnection);
     connect(this, &LogFileParser::stopNormal, authThread, &LogAuthThread::stopProccess);
     int index = authThread->getIndex();
-    QThreadPool::globalInstance()->tryStart(authThread);
+    attachCredits(authThread);
+    LogWorkScheduler::instance()->start(authThread, LogWorkScheduler::Interactive);
     return index;
 }
 
@@ -220,7 +330,8 @@ int LogFileParser::parseByKwin(const KWIN_FILTERS &iKwinfilter)
     connect(this, &LogFileParser::stopKwin, authThread, &LogAuthThread::stopProccess);
 
     int index = authThread->getIndex();
-    QThreadPool::globalInstance()->start(authThread);
+    attachCredits(authThread);
+    LogWorkScheduler::instance()->start(authThread, LogWorkScheduler::Interactive);
     return index;
 }
 #if 0
@@ -256,10 +367,18 @@ int LogFileParser::parseByBoot()
 {
     stopAllLoad();
     m_isBootLoading = true;
+    QStringList filePath = sourceFiles("boot");
+    const QString cacheKey = "boot";
+    const LogCacheValidity validity = fileValidity(filePath);
+    int cachedIndex = ++LogAuthThread::thread_count;
+    if (replayCache<LOG_MSG_BOOT>(cacheKey, validity, cachedIndex, &LogFileParser::bootData,
+                                  [this, cachedIndex](const QString &) { emit bootFinished(cachedIndex); }))
+        return cachedIndex;
+    if (m_snapshot)
+        return finishSnapshotMiss(cachedIndex, [this](int index) { emit bootFinished(index); });
     LogAuthThread   *authThread = new LogAuthThread(this);
     authThread->setType(BOOT);
 
-    QStringList filePath = DLDBusHandler::instance(this)->getFileInfo("boot");
     authThread->setFilePath(filePath);
     connect(authThread, &LogAuthThread::bootFinished, this,
             &LogFileParser::bootFinished);
@@ -268,7 +387,9 @@ int LogFileParser::parseByBoot()
     connect(this, &LogFileParser::stopBoot, authThread,
             &LogAuthThread::stopProccess);
     int index = authThread->getIndex();
-    QThreadPool::globalInstance()->start(authThread);
+    attachCredits(authThread);
+    beginCache(cacheKey, index, validity);
+    LogWorkScheduler::instance()->start(authThread, LogWorkScheduler::Interactive);
     return index;
 }
 
@@ -276,9 +397,46 @@ int LogFileParser::parseByKern(const KERN_FILTERS &iKernFilter)
 {
     stopAllLoad();
     m_isKernLoading = true;
+    QStringList filePath = sourceFiles("kern");
+    //journal来源直接读取,不经过按文件校验的缓存;快照中的内核日志都来自缓存
+    if (!m_snapshot && kernFromJournal(filePath)) {
+        LogAuthThread *authThread = new LogAuthThread(this);
+        authThread->setType(KERN);
+        authThread->setFileterParam(iKernFilter);
+        authThread->setKernFromJournal(true);
+        connect(authThread, &LogAuthThread::kernFinished, this,
+                &LogFileParser::kernFinished);
+        connect(authThread, &LogAuthThread::kernData, this,
+                &LogFileParser::kernData);
+        connect(this, &LogFileParser::stopKern, authThread,
+                &LogAuthThread::stopProccess);
+        int index = authThread->getIndex();
+        attachCredits(authThread);
+        LogWorkScheduler::instance()->start(authThread, LogWorkScheduler::Interactive);
+        return index;
+    }
+    const QString cacheKey = cacheKey(iKernFilter);
+    const LogCacheValidity validity = fileValidity(filePath);
+    int cachedIndex = ++LogAuthThread::thread_count;
+    if (replayCache<LOG_MSG_JOURNAL>(cacheKey, validity, cachedIndex, &LogFileParser::kernData,
+                                     [this, cachedIndex](const QString &) { emit kernFinished(cachedIndex); }))
+        return cachedIndex;
+    LogCacheRange range;
+    range.begin = iKernFilter.timeFilterBegin;
+    range.end = iKernFilter.timeFilterEnd;
+    //时间戳为微秒,筛选条件为毫秒
+    const bool timed = range.begin > 0 && range.end > 0;
+    auto accept = [timed, range](const LOG_MSG_JOURNAL & record) {
+        const qint64 msecs = record.timestamp / 1000;
+        return !timed || (msecs >= range.begin && msecs <= range.end);
+    };
+    if (replaySubset<LOG_MSG_JOURNAL>("kern", range, validity, cachedIndex, &LogFileParser::kernData, accept,
+                                      [this, cachedIndex](const QString &) { emit kernFinished(cachedIndex); }))
+        return cachedIndex;
+    if (m_snapshot)
+        return finishSnapshotMiss(cachedIndex, [this](int index) { emit kernFinished(index); });
     LogAuthThread   *authThread = new LogAuthThread(this);
     authThread->setType(KERN);
-    QStringList filePath = DLDBusHandler::instance(this)->getFileInfo("kern", false);
     authThread->setFileterParam(iKernFilter);
     authThread->setFilePath(filePath);
     connect(authThread, &LogAuthThread::kernFinished, this,
@@ -288,7 +446,9 @@ int LogFileParser::parseByKern(const KERN_FILTERS &iKernFilter)
     connect(this, &LogFileParser::stopKern, authThread,
             &LogAuthThread::stopProccess);
     int index = authThread->getIndex();
-    QThreadPool::globalInstance()->start(authThread);
+    attachCredits(authThread);
+    beginCache(cacheKey, index, validity, "kern", range);
+    LogWorkScheduler::instance()->start(authThread, LogWorkScheduler::Interactive);
     return index;
 }
 
@@ -343,21 +503,8 @@ int LogFileParser::parseByApp(const APP_FILTERS &iAPPFilter)
         stopAllLoad();
         emit stopJournalApp();
 
-        // 级别筛选
-        QStringList arg;
-        if (iAPPFilter.lvlFilter != LVALL) {
-            QString prio = QString("PRIORITY=%1").arg(iAPPFilter.lvlFilter);
-            arg.append(prio);
-        } else {
-            arg.append("all");
-        }
-
-        // 时间筛选
-        if (iAPPFilter.timeFilterBegin != -1) {
-            arg << QString::number(iAPPFilter.timeFilterBegin * 1000) << QString::number(iAPPFilter.timeFilterEnd * 1000);
-        }
-
-        // 应用筛选
+        // 级别、时间筛选和应用筛选
+        QStringList arg = appJournalArgs(iAPPFilter);
         arg << appName;
 
         JournalAppWork* work = new JournalAppWork(this);
@@ -370,45 +517,70 @@ int LogFileParser::parseByApp(const APP_FILTERS &iAPPFilter)
         connect(this, &LogFileParser::stopJournalApp, work, &JournalAppWork::stopWork);
 
         int index = work->getIndex();
-        QThreadPool::globalInstance()->start(work);
+        LogWorkScheduler::instance()->start(work, LogWorkScheduler::Interactive);
         return index;
     }
 
     return -1;
 }
 
-void LogFileParser::parseByDnf(DNF_FILTERS iDnfFilter)
+/**
+ * @brief LogFileParser::parseByApps 一次读取journal得到多个journal方式应用的日志
+ * 各应用的SYSLOG_IDENTIFIER作为或条件加入筛选,数据按应用通过appsData发出,全部读完后发出appFinished;
+ * file方式的应用各自是独立的文件,不在此处处理
+ * @param appNames 应用名(SYSLOG_IDENTIFIER)列表
+ * @param iAPPFilter 等级和时间筛选,path不使用
+ * @return 线程标号,没有应用时返回-1
+ */
+int LogFileParser::parseByApps(const QStringList &appNames, const APP_FILTERS &iAPPFilter)
 {
+    if (appNames.isEmpty())
+        return -1;
+
     stopAllLoad();
-    LogAuthThread *authThread = new LogAuthThread(this);
-    authThread->setType(Dnf);
-    QStringList filePath = DLDBusHandler::instance(this)->getFileInfo("dnf");
-    authThread->setFilePath(filePath);
-    authThread->setFileterParam(iDnfFilter);
-    connect(authThread, &LogAuthThread::proccessError, this,
-            &LogFileParser::slog_proccessError, Qt::UniqueConnection);
-    connect(authThread, &LogAuthThread::dnfFinished, this,
-            &LogFileParser::dnfFinished, Qt::UniqueConnection);
-    connect(this, &LogFileParser::stopDnf, authThread,
-            &LogAuthThread::stopProccess);
-    QThreadPool::globalInstance()->start(authThread);
+    emit stopJournalApp();
+
+    JournalAppWork *work = new JournalAppWork(this);
+    work->setArg(appJournalArgs(iAPPFilter));
+    work->setApps(appNames);
+
+    connect(work, &JournalAppWork::journalAppFinished, this, &LogFileParser::appFinished, Qt::QueuedConnection);
+    connect(work, &JournalAppWork::journalAppsData, this, &LogFileParser::appsData, Qt::QueuedConnection);
+    connect(this, &LogFileParser::stopJournalApp, work, &JournalAppWork::stopWork);
+
+    int index = work->getIndex();
+    LogWorkScheduler::instance()->start(work, LogWorkScheduler::Interactive);
+    return index;
 }
 
-void LogFileParser::parseByDmesg(DMESG_FILTERS iDmesgFilter)
+/**
+ * @brief LogFileParser::appJournalArgs journal方式应用日志的等级和时间筛选参数,见JournalReadOptions::fromArgs
+ */
+QStringList LogFileParser::appJournalArgs(const APP_FILTERS &filter)
 {
-    stopAllLoad();
-    LogAuthThread *authThread = new LogAuthThread(this);
-    authThread->setType(Dmesg);
-    QStringList filePath = DLDBusHandler::instance(this)->getFileInfo("dmesg");
-    authThread->setFilePath(filePath);
-    authThread->setFileterParam(iDmesgFilter);
-    connect(authThread, &LogAuthThread::proccessError, this,
-            &LogFileParser::slog_proccessError, Qt::UniqueConnection);
-    connect(authThread, &LogAuthThread::dmesgFinished, this,
-            &LogFileParser::dmesgFinished, Qt::UniqueConnection);
-    connect(this, &LogFileParser::stopDmesg, authThread,
-            &LogAuthThread::stopProccess);
-    QThreadPool::globalInstance()->start(authThread);
+    // 级别筛选
+    QStringList arg;
+    if (filter.lvlFilter != LVALL) {
+        arg.append(QString("PRIORITY=%1").arg(filter.lvlFilter));
+    } else {
+        arg.append("all");
+    }
+
+    // 时间筛选
+    if (filter.timeFilterBegin != -1) {
+        arg << QString::number(filter.timeFilterBegin * 1000) << QString::number(filter.timeFilterEnd * 1000);
+    }
+    return arg;
+}
+
+int LogFileParser::parseByDnf(DNF_FILTERS iDnfFilter)
+{
+    return startSource(iDnfFilter);
+}
+
+int LogFileParser::parseByDmesg(DMESG_FILTERS iDmesgFilter)
+{
+    return startSource(iDmesgFilter);
 }
 
 int LogFileParser::parseByOOC(const QString &path)
@@ -431,26 +603,38 @@ int LogFileParser::parseByOOC(const QString &path)
     return index;
 }
 
-int LogFileParser::parseByAudit(const AUDIT_FILTERS &iAuditFilter)
+/**
+ * @brief LogFileParser::parseByArchive 读取归档中一个类别的各文件,结果和其他日志一样通过OOCData、OOCFinished发出
+ * @param archive 已打开的归档
+ * @param category 类别,见LogArchive::categories
+ * @return 线程标号
+ */
+int LogFileParser::parseByArchive(const LogArchivePtr &archive, const QString &category)
 {
     stopAllLoad();
-    m_isAuditLoading = true;
-    LogAuthThread   *authThread = new LogAuthThread(this);
-    authThread->setType(Audit);
-    QStringList filePath = DLDBusHandler::instance(this)->getFileInfo("audit", false);
-    authThread->setFileterParam(iAuditFilter);
-    authThread->setFilePath(filePath);
-    connect(authThread, &LogAuthThread::auditFinished, this,
-            &LogFileParser::auditFinished);
-    connect(authThread, &LogAuthThread::auditData, this,
-            &LogFileParser::auditData);
-    connect(this, &LogFileParser::stopKern, authThread,
-            &LogAuthThread::stopProccess);
-    int index = authThread->getIndex();
-    QThreadPool::globalInstance()->start(authThread);
+    m_isOOCLoading = true;
+
+    m_OOCThread = new LogOOCFileParseThread(this);
+    m_OOCThread->setArchive(archive, category);
+    connect(m_OOCThread, &LogOOCFileParseThread::sigFinished, this,
+            &LogFileParser::OOCFinished);
+    connect(m_OOCThread, &LogOOCFileParseThread::sigData, this,
+            &LogFileParser::OOCData);
+    connect(this, &LogFileParser::stopOOC, m_OOCThread,
+            &LogOOCFileParseThread::stopProccess);
+    connect(m_OOCThread, &LogOOCFileParseThread::finished, m_OOCThread,
+            &QObject::deleteLater);
+    int index = m_OOCThread->getIndex();
+    m_OOCThread->start();
     return index;
 }
 
+int LogFileParser::parseByAudit(const AUDIT_FILTERS &iAuditFilter)
+{
+    m_isAuditLoading = true;
+    return startSource(iAuditFilter);
+}
+
 int LogFileParser::parseByCoredump(const COREDUMP_FILTERS &iCoredumpFilter)
 {
     stopAllLoad();
@@ -463,9 +647,12 @@ int LogFileParser::parseByCoredump(const COREDUMP_FILTERS &iCoredumpFilter)
             &LogFileParser::coredumpFinished);
     connect(authThread, &LogAuthThread::coredumpData, this,
             &LogFileParser::coredumpData);
+    connect(authThread, &LogAuthThread::coredumpCursor, this,
+            &LogFileParser::coredumpCursor);
     connect(this, &LogFileParser::stopCoredump, authThread, &LogAuthThread::stopProccess);
     int index = authThread->getIndex();
-    QThreadPool::globalInstance()->start(authThread);
+    attachCredits(authThread);
+    LogWorkScheduler::instance()->start(authThread, LogWorkScheduler::Interactive);
     return index;
 }
 
@@ -495,15 +682,587 @@ void LogFileParser::stopAllLoad()
     emit stopApp();
     emit stopJournalApp();
     emit stopJournal();
+    emit stopJournalFollow();
+    emit stopLogFollow();
     emit stopJournalBoot();
     emit stopNormal();
     emit stopDnf();
     emit stopDmesg();
     emit stopOOC();
     emit stopCoredump();
+    //界面加载开始时立即停止后台预取
+    cancelPrefetch();
+    //中途停止的加载结果不完整,不能存入缓存
+    m_categoryCache.abort();
+    m_cachedIndex = -1;
+    //唤醒等待界面额度的旧加载线程,使其尽快看到停止标记
+    if (m_credits) {
+        m_credits->abort();
+        m_credits.reset();
+        m_creditIndex = -1;
+    }
     return;
 }
 
+/**
+ * @brief LogFileParser::setDeliveryCredits 开启后获取线程每发出一批数据占用一个额度,
+ * 界面在数据槽函数中调用releaseDelivery归还,界面插入慢时获取线程随之等待
+ */
+void LogFileParser::setDeliveryCredits(bool enabled)
+{
+    m_deliveryCredits = enabled;
+}
+
+/**
+ * @brief LogFileParser::releaseDelivery 界面处理完index加载的一批数据,归还额度;取自缓存或已停止的加载忽略
+ */
+void LogFileParser::releaseDelivery(int index)
+{
+    if (m_credits && index == m_creditIndex)
+        m_credits->release();
+}
+
+/**
+ * @brief LogFileParser::attachCredits 为界面发起的加载线程分配发送额度
+ */
+void LogFileParser::attachCredits(LogAuthThread *authThread)
+{
+    if (!m_deliveryCredits)
+        return;
+    if (m_credits)
+        m_credits->abort();
+    m_credits = std::make_shared<LogDeliveryCredits>();
+    m_creditIndex = authThread->getIndex();
+    authThread->setDeliveryCredits(m_credits);
+}
+
+/**
+ * @brief LogFileParser::clearCategoryCache 清空日志类别缓存,例如日志被清除之后
+ */
+void LogFileParser::clearCategoryCache()
+{
+    m_categoryCache.clear();
+}
+
+/**
+ * @brief LogFileParser::setMemoryPressure 内存紧张时停止预取、释放已缓存的类别,解除前不再缓存新的加载结果
+ */
+void LogFileParser::setMemoryPressure(bool pressure)
+{
+    m_memoryPressure = pressure;
+    //快照中的类别释放后无法重新读取
+    if (!pressure || m_snapshot)
+        return;
+    cancelPrefetch();
+    m_categoryCache.clear();
+}
+
+/**
+ * @brief LogFileParser::invalidateFiles 只丢弃来自这些文件的类别缓存,其他类别的缓存保留
+ * @param paths 被清空或改写的日志文件
+ */
+void LogFileParser::invalidateFiles(const QStringList &paths)
+{
+    m_categoryCache.removeFiles(paths);
+}
+
+/**
+ * @brief LogFileParser::startSource 按LogIngestSource加载一种由LogAuthThread解析的日志,各parseBy*共用的流程
+ * 来源文件没有变化且缓存过相同的筛选条件时直接回放缓存,打开快照时只取自快照;
+ * 否则启动解析线程,接入界面额度和停止信号,结果在正常结束时存入类别缓存
+ * @param filter 筛选条件
+ * @return 本次加载的标号
+ */
+template <typename Filter>
+int LogFileParser::startSource(const Filter &filter)
+{
+    using Source = LogIngestSource<Filter>;
+    stopAllLoad();
+    const QString category = QString::fromLatin1(Source::category);
+    const QStringList filePath = category.isEmpty() ? QStringList() : sourceFiles(category);
+    const QString key = Source::cacheKey(filter);
+    LogCacheValidity validity;
+    //不缓存的类型不实例化缓存的读取函数
+    if constexpr (Source::cached) {
+        validity = fileValidity(filePath);
+        const int cachedIndex = ++LogAuthThread::thread_count;
+        if (replayCache<typename Source::Record>(key, validity, cachedIndex, Source::data,
+                                                 [this, cachedIndex](const QString &) { Source::emitFinished(this, cachedIndex); }))
+            return cachedIndex;
+        if (m_snapshot)
+            return finishSnapshotMiss(cachedIndex, [this](int index) { Source::emitFinished(this, index); });
+    }
+
+    LogAuthThread *authThread = new LogAuthThread(this);
+    authThread->setType(Source::flag);
+    if (!category.isEmpty())
+        authThread->setFilePath(filePath);
+    authThread->setFileterParam(filter);
+    connect(authThread, &LogAuthThread::proccessError, this,
+            &LogFileParser::slog_proccessError, Qt::UniqueConnection);
+    connect(authThread, Source::threadFinished, this, Source::finished, Qt::UniqueConnection);
+    connect(authThread, Source::threadData, this, Source::data, Qt::UniqueConnection);
+    connect(this, Source::stop, authThread, &LogAuthThread::stopProccess);
+    const int index = authThread->getIndex();
+    attachCredits(authThread);
+    if (Source::cached)
+        beginCache(key, index, validity);
+    LogWorkScheduler::instance()->start(authThread, LogWorkScheduler::Interactive);
+    return index;
+}
+
+/**
+ * @brief LogFileParser::connectCache 收集LogIngestSource转发的数据,正常结束时存入类别缓存
+ */
+template <typename Filter>
+void LogFileParser::connectCache()
+{
+    using Source = LogIngestSource<Filter>;
+    connect(this, Source::data, this, [this](int index, QList<typename Source::Record> list) {
+        m_categoryCache.collect(index, list);
+    });
+    connect(this, Source::finished, this, [this](int index) {
+        m_categoryCache.finish(index);
+    });
+}
+
+/**
+ * @brief LogFileParser::initCategoryCache 收集各类别加载线程转发的数据,正常结束时存入缓存
+ */
+void LogFileParser::initCategoryCache()
+{
+    connectCache<DKPG_FILTERS>();
+    connectCache<XORG_FILTERS>();
+    connectCache<DNF_FILTERS>();
+    connect(this, &LogFileParser::bootData, this, [this](int index, QList<LOG_MSG_BOOT> list) {
+        m_categoryCache.collect(index, list);
+    });
+    connect(this, &LogFileParser::kernData, this, [this](int index, QList<LOG_MSG_JOURNAL> list) {
+        m_categoryCache.collect(index, list);
+    });
+    connect(this, &LogFileParser::auditData, this, [this](int index, QList<LOG_MSG_AUDIT> list) {
+        m_categoryCache.collect(index, list);
+    });
+    connect(this, &LogFileParser::journalData, this, [this](int index, QList<LOG_MSG_JOURNAL> list) {
+        m_categoryCache.collect(index, list);
+    });
+    connect(this, &LogFileParser::journalCursor, this, [this](int index, const QString & cursor) {
+        m_categoryCache.setCursor(index, cursor);
+    });
+    auto finish = [this](int index) {
+        m_categoryCache.finish(index);
+    };
+    connect(this, &LogFileParser::bootFinished, this, finish);
+    connect(this, &LogFileParser::kernFinished, this, finish);
+    connect(this, &LogFileParser::journalFinished, this, finish);
+    //需要提示的结束表示审计服务未开启或没有权限,结果不可信
+    connect(this, &LogFileParser::auditFinished, this, [this](int index, bool bShowTip) {
+        if (bShowTip)
+            m_categoryCache.abort();
+        else
+            m_categoryCache.finish(index);
+    });
+}
+
+/**
+ * @brief LogFileParser::saveSnapshot 把已缓存的各类别写入快照文件,之后可以用openSnapshot在本机或其他机器上打开
+ * @return 是否写入成功,没有已缓存的类别时返回false
+ */
+bool LogFileParser::saveSnapshot(const QString &path)
+{
+    const QList<LogCategoryCache::SnapshotEntry> entries = m_categoryCache.snapshotEntries();
+    return !entries.isEmpty() && LogSnapshot::save(path, entries);
+}
+
+/**
+ * @brief LogFileParser::openSnapshot 打开快照文件,之后各类别的加载只取自快照,不再读取本机日志和经过DBus,
+ * 快照中没有的类别和筛选条件返回空结果,直到closeSnapshot
+ * @return 是否打开成功,文件无效时保持原来的状态
+ */
+bool LogFileParser::openSnapshot(const QString &path)
+{
+    QList<LogCategoryCache::SnapshotEntry> entries;
+    if (!LogSnapshot::load(path, &entries))
+        return false;
+    stopAllLoad();
+    //导入前按配置设置上限,快照中超出上限的类别被淘汰
+    m_categoryCache.setBudget(static_cast<qint64>(Utils::categoryCacheSize) * 1024 * 1024);
+    m_categoryCache.importSnapshot(entries);
+    m_snapshot = true;
+    return true;
+}
+
+/**
+ * @brief LogFileParser::closeSnapshot 关闭快照,丢弃快照中的类别,之后重新读取本机日志
+ */
+void LogFileParser::closeSnapshot()
+{
+    if (!m_snapshot)
+        return;
+    stopAllLoad();
+    m_categoryCache.clear();
+    m_snapshot = false;
+}
+
+/**
+ * @brief LogFileParser::sourceFiles 类别的来源文件,打开快照时为空,缓存只按空的文件列表校验
+ * @param category 日志类别,见DLDBusHandler::getFileInfo
+ */
+QStringList LogFileParser::sourceFiles(const QString &category)
+{
+    if (m_snapshot)
+        return QStringList();
+    return DLDBusHandler::instance(this)->getFileInfo(category, false);
+}
+
+/**
+ * @brief LogFileParser::finishSnapshotMiss 快照中没有的类别或筛选条件,在下一次事件循环中只发出结束信号
+ * @param index 本次加载的标号
+ * @param finished 发出结束信号
+ * @return index
+ */
+int LogFileParser::finishSnapshotMiss(int index, const std::function<void(int)> &finished)
+{
+    m_cachedIndex = index;
+    QTimer::singleShot(0, this, [this, index, finished]() {
+        if (index == m_cachedIndex)
+            finished(index);
+    });
+    return index;
+}
+
+/**
+ * @brief LogFileParser::fileValidity 来源文件当前的元数据,作为缓存的有效性依据
+ */
+LogCacheValidity LogFileParser::fileValidity(const QStringList &paths)
+{
+    LogCacheValidity validity;
+    if (!paths.isEmpty())
+        validity.files = DLDBusHandler::instance(this)->statFiles(paths);
+    return validity;
+}
+
+/**
+ * @brief LogFileParser::prefetch 在后台以最低优先级加载一个类别不筛选的结果,只存入缓存,不发出数据信号
+ * 之后切换到该类别时直接取缓存或从中筛选;需要鉴权的类别不预取,避免弹出鉴权框
+ * @param flag 日志类别,支持系统、内核、启动、Xorg和dpkg日志
+ * @return 是否开始预取,已在预取、已有缓存或类别不支持时返回false
+ */
+bool LogFileParser::prefetch(LOG_FLAG flag)
+{
+    if (isPrefetching() || m_memoryPressure || m_snapshot || Utils::categoryCacheSize <= 0)
+        return false;
+    m_categoryCache.setBudget(static_cast<qint64>(Utils::categoryCacheSize) * 1024 * 1024);
+
+    const int id = ++m_prefetchCount;
+    switch (flag) {
+    case JOURNAL: {
+        const QStringList arg {"all"};
+        const QString key = "journal:" + arg.join(',');
+        if (m_categoryCache.contains(key, LogCacheValidity()))
+            return false;
+        journalWork *work = new journalWork(this);
+        work->setArg(arg);
+        work->setLowPriority(true);
+        connectPrefetch(work, id, &journalWork::journalData, &journalWork::journalFinished);
+        connect(work, &journalWork::journalCursor, this, [this, id](int, const QString & cursor) {
+            m_categoryCache.setCursor(-id, cursor);
+        });
+        connect(this, &LogFileParser::stopPrefetch, work, &journalWork::stopWork);
+        m_categoryCache.begin(key, -id, LogCacheValidity(), "journal", journalRange(arg));
+        m_prefetchIndex = id;
+        LogWorkScheduler::instance()->start(work, LogWorkScheduler::Prefetch);
+        return true;
+    }
+    case XORG:
+        return prefetchSource<XORG_FILTERS>(id);
+    case DPKG:
+        return prefetchSource<DKPG_FILTERS>(id);
+    case KERN:
+    case BOOT:
+        break;
+    default:
+        return false;
+    }
+
+    QString key;
+    QString category;
+    LogCacheRange range;
+    QStringList filePath;
+    if (flag == KERN) {
+        filePath = DLDBusHandler::instance(this)->getFileInfo("kern", false);
+        if (kernFromJournal(filePath))
+            return false;
+        key = cacheKey(KERN_FILTERS());
+        category = "kern";
+    } else {
+        filePath = DLDBusHandler::instance(this)->getFileInfo("boot", false);
+        key = "boot";
+    }
+    const LogCacheValidity validity = fileValidity(filePath);
+    if (filePath.isEmpty() || m_categoryCache.contains(key, validity))
+        return false;
+
+    LogAuthThread *authThread = new LogAuthThread(this);
+    authThread->setType(flag);
+    authThread->setFilePath(filePath);
+    authThread->setLowPriority(true);
+    if (flag == KERN)
+        connectPrefetch(authThread, id, &LogAuthThread::kernData, &LogAuthThread::kernFinished);
+    else
+        connectPrefetch(authThread, id, &LogAuthThread::bootData, &LogAuthThread::bootFinished);
+    connect(this, &LogFileParser::stopPrefetch, authThread, &LogAuthThread::stopProccess);
+    m_categoryCache.begin(key, -id, validity, category, range);
+    m_prefetchIndex = id;
+    LogWorkScheduler::instance()->start(authThread, LogWorkScheduler::Prefetch);
+    return true;
+}
+
+/**
+ * @brief LogFileParser::cancelPrefetch 停止正在进行的后台预取并丢弃已收集的部分,同时通知预取调度暂停
+ */
+void LogFileParser::cancelPrefetch()
+{
+    emit stopPrefetch();
+    if (!isPrefetching())
+        return;
+    m_categoryCache.abort(-m_prefetchIndex);
+    m_prefetchIndex = 0;
+}
+
+/**
+ * @brief LogFileParser::connectPrefetch 把预取线程的数据和结束信号接到缓存,被取消的预取之后发出的信号通过id忽略
+ */
+template <typename Worker, typename T>
+void LogFileParser::connectPrefetch(Worker *worker, int id, void (Worker::*data)(int, QList<T>), void (Worker::*finished)(int))
+{
+    connect(worker, data, this, [this, id](int, QList<T> list) {
+        m_categoryCache.collect(-id, list);
+    });
+    connect(worker, finished, this, [this, id](int) {
+        finishPrefetch(id);
+    });
+}
+
+/**
+ * @brief LogFileParser::prefetchSource 按LogIngestSource预取一个类别不筛选的结果,见prefetch
+ * @param id 本次预取的标号
+ */
+template <typename Filter>
+bool LogFileParser::prefetchSource(int id)
+{
+    using Source = LogIngestSource<Filter>;
+    const QStringList filePath = DLDBusHandler::instance(this)->getFileInfo(Source::category, false);
+    const QString key = Source::cacheKey(Filter());
+    const LogCacheValidity validity = fileValidity(filePath);
+    if (filePath.isEmpty() || m_categoryCache.contains(key, validity))
+        return false;
+
+    LogAuthThread *authThread = new LogAuthThread(this);
+    authThread->setType(Source::flag);
+    authThread->setFilePath(filePath);
+    authThread->setLowPriority(true);
+    connectPrefetch(authThread, id, Source::threadData, Source::threadFinished);
+    connect(this, &LogFileParser::stopPrefetch, authThread, &LogAuthThread::stopProccess);
+    m_categoryCache.begin(key, -id, validity);
+    m_prefetchIndex = id;
+    LogWorkScheduler::instance()->start(authThread, LogWorkScheduler::Prefetch);
+    return true;
+}
+
+void LogFileParser::finishPrefetch(int id)
+{
+    if (id != m_prefetchIndex)
+        return;
+    m_categoryCache.finish(-id);
+    m_prefetchIndex = 0;
+    emit prefetchFinished();
+}
+
+/**
+ * @brief LogFileParser::cacheKey 各类别筛选条件对应的缓存键
+ */
+/**
+ * @brief LogFileParser::kernFromJournal 内核日志是否从journal读取,见Utils::kernLogSource
+ * @param files kern.log及其轮转文件,为空说明rsyslog没有写入内核日志
+ */
+bool LogFileParser::kernFromJournal(const QStringList &files)
+{
+    if (Utils::kernLogSource == "journal")
+        return true;
+    if (Utils::kernLogSource == "file")
+        return false;
+    return files.isEmpty();
+}
+
+QString LogFileParser::cacheKey(const KERN_FILTERS &filter)
+{
+    return QString("kern:%1:%2").arg(filter.timeFilterBegin).arg(filter.timeFilterEnd);
+}
+
+/**
+ * @brief LogFileParser::journalRange 系统日志筛选参数对应的缓存范围,时间为微秒
+ */
+LogCacheRange LogFileParser::journalRange(const QStringList &arg)
+{
+    LogCacheRange range;
+    if (!arg.isEmpty() && arg.at(0) != "all")
+        range.match = arg.at(0);
+    if (arg.size() >= 3) {
+        range.begin = arg.at(1).toLongLong();
+        range.end = arg.at(2).toLongLong();
+    }
+    //搜索下推的字段匹配也是筛选条件,不同的匹配之间不能互相复用
+    QStringList matches;
+    for (int i = 1; i < arg.size(); ++i) {
+        if (JournalReadOptions::isMatchArg(arg.at(i)))
+            matches.append(arg.at(i));
+    }
+    if (!matches.isEmpty())
+        range.match = (range.match.isEmpty() ? QString("all") : range.match) + " " + matches.join(' ');
+    return range;
+}
+
+/**
+ * @brief LogFileParser::journalSubset 按等级和时间从已缓存的更大范围的系统日志中筛出新范围的条件
+ * @return 有下推的字段匹配或等级无法识别时不能筛出,返回空
+ */
+std::function<bool(const LOG_MSG_JOURNAL &)> LogFileParser::journalSubset(const QStringList &arg)
+{
+    const LogCacheRange range = journalRange(arg);
+    if (!JournalReadOptions::fromArgs(arg).matches.isEmpty())
+        return std::function<bool(const LOG_MSG_JOURNAL &)>();
+    bool levelOk = false;
+    const int level = range.match.isEmpty() ? -1 : range.match.section('=', 1).toInt(&levelOk);
+    if (!range.match.isEmpty() && !(levelOk && level >= EMER && level <= DEB))
+        return std::function<bool(const LOG_MSG_JOURNAL &)>();
+    const bool timed = range.begin > 0 && range.end > 0;
+    return [level, timed, range](const LOG_MSG_JOURNAL & record) {
+        return (level < 0 || record.level == level)
+               && (!timed || (record.timestamp >= range.begin && record.timestamp <= range.end));
+    };
+}
+
+/**
+ * @brief LogFileParser::cachedJournal 取缓存中能满足筛选参数的系统日志,不发出任何信号,供其他进程的导出请求使用
+ * @param arg 筛选参数,和parseByJournal一致
+ * @param records 按从新到旧排列的记录
+ * @param cursor 缓存时最新条目的游标,之后的新日志需要另外读取
+ * @return 是否命中;打开快照时快照中的日志不代表本机,总是返回false
+ */
+bool LogFileParser::cachedJournal(const QStringList &arg, QList<LOG_MSG_JOURNAL> *records, QString *cursor)
+{
+    if (m_snapshot)
+        return false;
+    QVector<QList<LOG_MSG_JOURNAL>> batches;
+    std::function<bool(const LOG_MSG_JOURNAL &)> accept;
+    if (!m_categoryCache.find("journal:" + arg.join(','), LogCacheValidity(), &batches, cursor)) {
+        accept = journalSubset(arg);
+        if (!accept || !m_categoryCache.findCovering("journal", journalRange(arg), LogCacheValidity(), &batches, cursor))
+            return false;
+    }
+    records->clear();
+    for (const QList<LOG_MSG_JOURNAL> &batch : batches) {
+        if (!accept) {
+            records->append(batch);
+            continue;
+        }
+        for (const LOG_MSG_JOURNAL &record : batch) {
+            if (accept(record))
+                records->append(record);
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief LogFileParser::beginCache 按配置的内存上限开始收集本次加载的结果
+ */
+void LogFileParser::beginCache(const QString &key, int index, const LogCacheValidity &validity,
+                               const QString &category, const LogCacheRange &range)
+{
+    m_categoryCache.setBudget(m_memoryPressure ? 0 : static_cast<qint64>(Utils::categoryCacheSize) * 1024 * 1024);
+    m_categoryCache.begin(key, index, validity, category, range);
+}
+
+/**
+ * @brief LogFileParser::replayCache 命中缓存时在下一次事件循环中按原来的批次发出数据和结束信号,不启动加载线程
+ * @param key 类别和筛选条件
+ * @param validity 来源文件当前的元数据
+ * @param index 本次加载的标号
+ * @param data 数据信号
+ * @param finished 发出结束信号,参数为缓存时最新条目的游标
+ * @return 是否命中
+ */
+template <typename T>
+bool LogFileParser::replayCache(const QString &key, const LogCacheValidity &validity, int index,
+                                void (LogFileParser::*data)(int, QList<T>), const std::function<void(const QString &)> &finished)
+{
+    QVector<QList<T>> batches;
+    QString cursor;
+    if (!m_categoryCache.find(key, validity, &batches, &cursor))
+        return false;
+    scheduleReplay<T>(index, batches, cursor, data, std::function<bool(const T &)>(), finished);
+    return true;
+}
+
+/**
+ * @brief LogFileParser::replaySubset 新的筛选范围包含在已缓存的结果中时,按accept在内存中筛出后发出,不重新读取
+ * @param category 类别
+ * @param range 新的筛选范围
+ * @param accept 记录是否在新的筛选范围内
+ * @return 是否命中
+ */
+template <typename T>
+bool LogFileParser::replaySubset(const QString &category, const LogCacheRange &range, const LogCacheValidity &validity, int index,
+                                 void (LogFileParser::*data)(int, QList<T>), const std::function<bool(const T &)> &accept,
+                                 const std::function<void(const QString &)> &finished)
+{
+    QVector<QList<T>> batches;
+    QString cursor;
+    if (!m_categoryCache.findCovering(category, range, validity, &batches, &cursor))
+        return false;
+    scheduleReplay<T>(index, batches, cursor, data, accept, finished);
+    return true;
+}
+
+/**
+ * @brief LogFileParser::scheduleReplay 在下一次事件循环中发出缓存的数据,有accept时筛选后按每批SINGLE_READ_CNT条重新分批
+ */
+template <typename T>
+void LogFileParser::scheduleReplay(int index, const QVector<QList<T>> &batches, const QString &cursor,
+                                   void (LogFileParser::*data)(int, QList<T>), const std::function<bool(const T &)> &accept,
+                                   const std::function<void(const QString &)> &finished)
+{
+    m_cachedIndex = index;
+    QTimer::singleShot(0, this, [this, index, data, accept, finished, batches, cursor]() {
+        //已被之后的加载取代
+        if (index != m_cachedIndex)
+            return;
+        if (!accept) {
+            for (const QList<T> &batch : batches)
+                emit(this->*data)(index, batch);
+            finished(cursor);
+            return;
+        }
+        QList<T> list;
+        for (const QList<T> &batch : batches) {
+            for (const T &record : batch) {
+                if (!accept(record))
+                    continue;
+                list.append(record);
+                if (list.size() >= SINGLE_READ_CNT) {
+                    emit(this->*data)(index, list);
+                    list.clear();
+                }
+            }
+        }
+        if (!list.isEmpty())
+            emit(this->*data)(index, list);
+        finished(cursor);
+    });
+}
+
 void LogFileParser::quitLogAuththread(QThread *iThread)
 {
     if (iThread && iThread->isRunning()) {
@@ -13,11 +13,15 @@
 #include "dbusproxy/dldbushandler.h"
 #include "dbusproxy/dldbusinterface.h"
 #include "logoocfileparsethread.h"
+#include "logcategorycache.h"
+#include "logworkscheduler.h"
 
 #include <QMap>
 #include <QThread>
 #include <QDebug>
 
+#include <functional>
+
 class LogFileParser : public QObject
 {
     Q_OBJECT
@@ -26,8 +30,12 @@ public:
     ~LogFileParser();
 
 
-    int parseByJournal(const QStringList &arg = QStringList());
-    int parseByJournalBoot(const QStringList &arg = QStringList());
+    int parseByJournal(const QStringList &arg = QStringList(), const QString &stopCursor = QString());
+    int parseByJournalFollow(const QStringList &arg, const QString &startCursor);
+    int parseByKernFollow();
+    int parseByDmesgFollow(int level);
+    int parseByTextFollow(const QString &filePath);
+    int parseByJournalBoot(const QStringList &arg = QStringList(), const QString &bootId = QString());
 
     int parseByDpkg(const DKPG_FILTERS &iDpkgFilter);
 #if 0
@@ -37,13 +45,16 @@ public:
     int parseByXlog(const XORG_FILTERS &iXorgFilter);
     int parseByBoot();
     int parseByKern(const KERN_FILTERS &iKernFilter);
+    static bool kernFromJournal(const QStringList &files);
     int parseByApp(const APP_FILTERS &iAPPFilter);
-    void parseByDnf(DNF_FILTERS iDnfFilter);
-    void parseByDmesg(DMESG_FILTERS iDmesgFilter);
+    int parseByApps(const QStringList &appNames, const APP_FILTERS &iAPPFilter);
+    int parseByDnf(DNF_FILTERS iDnfFilter);
+    int parseByDmesg(DMESG_FILTERS iDmesgFilter);
     int parseByNormal(const NORMAL_FILTERS &iNormalFiler);   // add by Airy
 
     int parseByKwin(const KWIN_FILTERS &iKwinfilter);
     int parseByOOC(const QString &path);
+    int parseByArchive(const LogArchivePtr &archive, const QString &category);
 
     int parseByAudit(const AUDIT_FILTERS &iAuditFilter);
 
@@ -51,6 +62,25 @@ public:
 
     void createFile(const QString &output, int count);
     void stopAllLoad();
+    /**
+     * @brief isCachedLoad index对应的加载是否直接取自缓存,系统日志取自缓存时需要再增量读取之后的新日志
+     */
+    bool isCachedLoad(int index) const { return index >= 0 && index == m_cachedIndex; }
+    void clearCategoryCache();
+    void setMemoryPressure(bool pressure);
+    bool memoryPressure() const { return m_memoryPressure; }
+    void invalidateFiles(const QStringList &paths);
+    bool prefetch(LOG_FLAG flag);
+    void cancelPrefetch();
+    bool isPrefetching() const { return m_prefetchIndex > 0; }
+    const LogCategoryCache &categoryCache() const { return m_categoryCache; }
+    bool saveSnapshot(const QString &path);
+    bool openSnapshot(const QString &path);
+    void closeSnapshot();
+    bool isSnapshot() const { return m_snapshot; }
+    bool cachedJournal(const QStringList &arg, QList<LOG_MSG_JOURNAL> *records, QString *cursor);
+    void setDeliveryCredits(bool enabled);
+    void releaseDelivery(int index);
 
 signals:
     void dpkgFinished(int index);
@@ -61,11 +91,20 @@ signals:
     void bootData(int index, QList<LOG_MSG_BOOT>);
     void kernFinished(int index);
     void kernData(int index, QList<LOG_MSG_JOURNAL>);
-    void dnfFinished(QList<LOG_MSG_DNF>);
-    void dmesgFinished(QList<LOG_MSG_DMESG>);
+    void dnfFinished(int index);
+    void dnfData(int index, QList<LOG_MSG_DNF>);
+    void dmesgFinished(int index);
+    void dmesgData(int index, QList<LOG_MSG_DMESG>);
     void journalFinished(int index);
     void journalBootFinished(int index);
     void journalData(int index, QList<LOG_MSG_JOURNAL>);
+    void journalCursor(int index, const QString &cursor);
+    void journalFollowData(int index, QList<LOG_MSG_JOURNAL> list, const QString &cursor);
+    void journalFollowFinished(int index);
+    void kernFollowData(int index, QList<LOG_MSG_JOURNAL> list);
+    void dmesgFollowData(int index, QList<LOG_MSG_DMESG> list);
+    void lineFollowData(int index, QStringList lines);
+    void logFollowFinished(int index);
     void journaBootlData(int index, QList<LOG_MSG_JOURNAL>);
 
     //void normalFinished();  // add by Airy
@@ -79,14 +118,19 @@ signals:
      */
     void appFinished(int index);
     void appData(int index, QList<LOG_MSG_APPLICATOIN> iDataList);
+    /**
+     * @brief appsData 多应用一次读取时按应用分发的数据,app为应用名(SYSLOG_IDENTIFIER)
+     */
+    void appsData(int index, const QString &app, QList<LOG_MSG_APPLICATOIN> iDataList);
     void OOCFinished(int index, int error = 0);
-    void OOCData(int index, const QString &data);
+    void OOCData(int index, LogTextSourcePtr source);
 
     void auditFinished(int index, bool bShowTip = false);
     void auditData(int index, QList<LOG_MSG_AUDIT>);
 
     void coredumpFinished(int index);
     void coredumpData(int index, QList<LOG_MSG_COREDUMP> iDataList);
+    void coredumpCursor(int index, const QString &cursor);
 
     void stopKern();
     void stopBoot();
@@ -96,12 +140,19 @@ signals:
     void stopKwin();
     void stopApp();
     void stopJournal();
+    void stopJournalFollow();
+    void stopLogFollow();
     void stopJournalBoot();
     void stopJournalApp();
     void stopDnf();
     void stopDmesg();
     void stopOOC();
     void stopCoredump();
+    void stopPrefetch();
+    /**
+     * @brief prefetchFinished 一次后台预取结束,被取消时不发出
+     */
+    void prefetchFinished();
     /**
      * @brief proccessError 获取日志文件失败错误信息传递信号，传递到主界面显示 DMessage tooltip
      * @param iError 错误字符
@@ -110,6 +161,37 @@ signals:
 
 private:
     void quitLogAuththread(QThread *iThread);
+    void attachCredits(LogAuthThread *authThread);
+    void initCategoryCache();
+    LogCacheValidity fileValidity(const QStringList &paths);
+    QStringList sourceFiles(const QString &category);
+    int finishSnapshotMiss(int index, const std::function<void(int)> &finished);
+    void beginCache(const QString &key, int index, const LogCacheValidity &validity,
+                    const QString &category = QString(), const LogCacheRange &range = LogCacheRange());
+    template <typename T>
+    bool replayCache(const QString &key, const LogCacheValidity &validity, int index,
+                     void (LogFileParser::*data)(int, QList<T>), const std::function<void(const QString &)> &finished);
+    template <typename T>
+    bool replaySubset(const QString &category, const LogCacheRange &range, const LogCacheValidity &validity, int index,
+                      void (LogFileParser::*data)(int, QList<T>), const std::function<bool(const T &)> &accept,
+                      const std::function<void(const QString &)> &finished);
+    template <typename T>
+    void scheduleReplay(int index, const QVector<QList<T>> &batches, const QString &cursor,
+                        void (LogFileParser::*data)(int, QList<T>), const std::function<bool(const T &)> &accept,
+                        const std::function<void(const QString &)> &finished);
+    static LogCacheRange journalRange(const QStringList &arg);
+    static std::function<bool(const LOG_MSG_JOURNAL &)> journalSubset(const QStringList &arg);
+    static QStringList appJournalArgs(const APP_FILTERS &filter);
+    static QString cacheKey(const KERN_FILTERS &filter);
+    template <typename Filter>
+    int startSource(const Filter &filter);
+    template <typename Filter>
+    void connectCache();
+    template <typename Filter>
+    bool prefetchSource(int id);
+    template <typename Worker, typename T>
+    void connectPrefetch(Worker *worker, int id, void (Worker::*data)(int, QList<T>), void (Worker::*finished)(int));
+    void finishPrefetch(int id);
 signals:
 
 public slots:
@@ -118,7 +200,6 @@ private:
     QString m_rootPasswd;
 
     QMap<QString, QString> m_dateDict;
-    QMap<QString, int> m_levelDict;  // example:warning=>4
 
     LogOOCFileParseThread *m_OOCThread {nullptr};
     LogApplicationParseThread *m_appThread {nullptr};
@@ -140,6 +221,34 @@ private:
     bool m_isOOCLoading = false;
     bool m_isAuditLoading = false;
     bool m_isCoredumpLoading = false;
+    /**
+     * @brief m_categoryCache 最近查看过的日志类别的结果,切换回来且来源没有变化时不再重新解析
+     */
+    LogCategoryCache m_categoryCache;
+    /**
+     * @brief m_memoryPressure 内存紧张,不缓存类别结果、不预取
+     */
+    bool m_memoryPressure = false;
+    /**
+     * @brief m_snapshot 已打开快照,各类别只取自快照,不读取本机日志
+     */
+    bool m_snapshot = false;
+    /**
+     * @brief m_cachedIndex 最近一次取自缓存的加载标号
+     */
+    int m_cachedIndex = -1;
+    /**
+     * @brief m_prefetchIndex 正在进行的后台预取的标号,0表示没有;收集缓存时使用其相反数,和界面加载的标号区分
+     */
+    int m_prefetchIndex = 0;
+    /**
+     * @brief m_deliveryCredits 是否按界面处理进度限制获取线程的发送,由界面开启,命令行等使用者不受限制
+     */
+    bool m_deliveryCredits = false;
+    //正在进行的界面加载的标号和发送额度,同一时刻只有一个界面加载
+    int m_creditIndex = -1;
+    LogDeliveryCreditsPtr m_credits;
+    int m_prefetchCount = 0;
 };
 
 #endif  // LOGFILEPARSER_H
@@ -0,0 +1,65 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logfilestat.h"
+
+#include <QCryptographicHash>
+#include <QFile>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @brief LogFileStat::fromPath 读取文件的元数据,符号链接取其指向的文件
+ * @param path 文件或目录路径
+ * @return 元数据,文件不存在时exists为false;readable为当前进程的读权限
+ */
+LogFileStat LogFileStat::fromPath(const QString &path)
+{
+    LogFileStat result;
+    result.path = path;
+    const QByteArray encoded = QFile::encodeName(path);
+    struct stat st;
+    if (::stat(encoded.constData(), &st) != 0)
+        return result;
+
+    result.exists = true;
+    result.size = static_cast<qint64>(st.st_size);
+    result.mtime = static_cast<qint64>(st.st_mtim.tv_sec) * 1000 + st.st_mtim.tv_nsec / 1000000;
+    result.inode = static_cast<quint64>(st.st_ino);
+    result.readable = access(encoded.constData(), R_OK) == 0;
+    return result;
+}
+
+/**
+ * @brief LogFileStat::contentHash 文件内容的SHA-1摘要,分块读取,不把整个文件读入内存
+ * 导出时用来找出内容相同的文件(如同一程序反复崩溃留下的core),服务和应用共用
+ * @return 十六进制摘要,文件无法读取时为空
+ */
+QString LogFileStat::contentHash(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return QString();
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    if (!hash.addData(&file))
+        return QString();
+    return QString::fromLatin1(hash.result().toHex());
+}
+
+QDBusArgument &operator<<(QDBusArgument &argument, const LogFileStat &stat)
+{
+    argument.beginStructure();
+    argument << stat.path << stat.exists << stat.size << stat.mtime << stat.inode;
+    argument.endStructure();
+    return argument;
+}
+
+const QDBusArgument &operator>>(const QDBusArgument &argument, LogFileStat &stat)
+{
+    argument.beginStructure();
+    argument >> stat.path >> stat.exists >> stat.size >> stat.mtime >> stat.inode;
+    argument.endStructure();
+    return argument;
+}
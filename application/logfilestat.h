@@ -0,0 +1,37 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGFILESTAT_H
+#define LOGFILESTAT_H
+
+#include <QDBusArgument>
+#include <QList>
+#include <QMetaType>
+#include <QString>
+
+/**
+ * @brief The LogFileStat struct 一个日志文件的元数据,服务一次返回一组文件的结果,DBus签名为(sbxxt)
+ * 代替逐个文件调用isFileExist/getFileSize,切换日志类别时只需要一次总线往返
+ */
+struct LogFileStat {
+    QString path;
+    bool exists = false;
+    qint64 size = 0;
+    //修改时间,毫秒
+    qint64 mtime = 0;
+    quint64 inode = 0;
+    //当前进程能否直接读取,不经过总线传输,由DLDBusHandler在本进程判断
+    bool readable = false;
+
+    static LogFileStat fromPath(const QString &path);
+    static QString contentHash(const QString &path);
+};
+
+Q_DECLARE_METATYPE(LogFileStat)
+Q_DECLARE_METATYPE(QList<LogFileStat>)
+
+QDBusArgument &operator<<(QDBusArgument &argument, const LogFileStat &stat);
+const QDBusArgument &operator>>(const QDBusArgument &argument, LogFileStat &stat);
+
+#endif // LOGFILESTAT_H
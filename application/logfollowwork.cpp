@@ -0,0 +1,214 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logfollowwork.h"
+#include "logfilefollower.h"
+#include "logkmsgreader.h"
+#include "loglocaltime.h"
+#include "logrecordparser.h"
+
+#include <DApplication>
+
+#include <QLoggingCategory>
+
+#include <errno.h>
+
+#ifdef QT_DEBUG
+Q_LOGGING_CATEGORY(logFollowWork, "org.deepin.log.viewer.parse.kernel.follow")
+#else
+Q_LOGGING_CATEGORY(logFollowWork, "org.deepin.log.viewer.parse.kernel.follow", QtInfoMsg)
+#endif
+
+DWIDGET_USE_NAMESPACE
+
+int LogFollowWork::thread_index = 0;
+
+/**
+ * @brief LogFollowWork::LogFollowWork 线程构造函数
+ * @param source 跟踪的数据源
+ * @param parent 父对象
+ */
+LogFollowWork::LogFollowWork(Source source, QObject *parent)
+    : QObject(parent)
+    , QRunnable()
+    , m_source(source)
+{
+    qRegisterMetaType<QList<LOG_MSG_JOURNAL> >("QList<LOG_MSG_JOURNAL>");
+    qRegisterMetaType<QList<LOG_MSG_DMESG> >("QList<LOG_MSG_DMESG>");
+    //使用线程池启动该线程，跑完自己删自己
+    setAutoDelete(true);
+    //静态计数变量加一并赋值给本对象的成员变量，以供外部判断是否为最新线程发出的数据信号
+    thread_index++;
+    m_threadIndex = thread_index;
+}
+
+LogFollowWork::~LogFollowWork()
+{
+}
+
+/**
+ * @brief LogFollowWork::setFilePath 设置跟踪的文本文件
+ * @param filePath 文件路径
+ */
+void LogFollowWork::setFilePath(const QString &filePath)
+{
+    m_filePath = filePath;
+}
+
+/**
+ * @brief LogFollowWork::setLevelFilter 设置dmesg等级筛选
+ * @param level 等级0-7,-1为全部
+ */
+void LogFollowWork::setLevelFilter(int level)
+{
+    m_levelFilter = level;
+}
+
+/**
+ * @brief LogFollowWork::run 线程执行函数
+ */
+void LogFollowWork::run()
+{
+    qCDebug(logFollowWork) << "threadrun";
+    doWork();
+}
+
+/**
+ * @brief LogFollowWork::doWork 阻塞跟踪新日志,直到被停止
+ */
+void LogFollowWork::doWork()
+{
+    switch (m_source) {
+    case KernFile:
+        followKernFile();
+        break;
+    case Kmsg:
+        followKmsg();
+        break;
+    case TextFile:
+        followTextFile();
+        break;
+    }
+}
+
+/**
+ * @brief LogFollowWork::followKernFile 跟踪kern.log新追加的行,按kern格式解析
+ */
+void LogFollowWork::followKernFile()
+{
+    LogFileFollower follower(m_filePath);
+    if (!follower.open(LogFileFollower::FromEnd)) {
+        qCWarning(logFollowWork) << "follow" << m_filePath << "failed:" << follower.errorString();
+        emit followFinished(m_threadIndex);
+        return;
+    }
+    int r = follower.follow(m_canRun, [this](const QStringList &lines) {
+        QList<LOG_MSG_JOURNAL> list;
+        qint64 lineTime = 0;
+        QStringList columns;
+        for (const QString &line : lines) {
+            if (!LogRecordParser::parseKern(line, lineTime, columns))
+                continue;
+            LOG_MSG_JOURNAL msg;
+            msg.dateTime = columns.at(0);
+            //和系统日志一致为微秒
+            msg.timestamp = lineTime * 1000;
+            msg.hostName = columns.at(1);
+            msg.daemonName = columns.at(2);
+            msg.daemonId = columns.at(3);
+            msg.msg = columns.at(4);
+            list.append(msg);
+        }
+        if (!list.isEmpty())
+            emit kernFollowData(m_threadIndex, list);
+    });
+    //被停止时不再发出任何信号
+    if (r == -ECANCELED)
+        return;
+    qCWarning(logFollowWork) << "follow" << m_filePath << "failed:" << follower.errorString();
+    emit followFinished(m_threadIndex);
+}
+
+/**
+ * @brief LogFollowWork::followTextFile 跟踪文本文件新追加的行,不解析,按行交出
+ */
+void LogFollowWork::followTextFile()
+{
+    LogFileFollower follower(m_filePath);
+    if (!follower.open(LogFileFollower::FromEnd)) {
+        qCWarning(logFollowWork) << "follow" << m_filePath << "failed:" << follower.errorString();
+        emit followFinished(m_threadIndex);
+        return;
+    }
+    int r = follower.follow(m_canRun, [this](const QStringList &lines) {
+        emit lineFollowData(m_threadIndex, lines);
+    });
+    if (r == -ECANCELED)
+        return;
+    qCWarning(logFollowWork) << "follow" << m_filePath << "failed:" << follower.errorString();
+    emit followFinished(m_threadIndex);
+}
+
+/**
+ * @brief LogFollowWork::followKmsg 跟踪/dev/kmsg新产生的记录,每次取空已有记录后一起发出
+ */
+void LogFollowWork::followKmsg()
+{
+    LogKmsgReader reader;
+    if (!reader.open(LogKmsgReader::FromEnd)) {
+        qCWarning(logFollowWork) << "follow kmsg failed:" << reader.errorString();
+        emit followFinished(m_threadIndex);
+        return;
+    }
+
+    const qint64 bootTime = LogKmsgReader::bootMSecs();
+    LogKmsgRecord record;
+    while (m_canRun) {
+        QList<LOG_MSG_DMESG> list;
+        while (m_canRun && reader.readRecord(record)) {
+            if (m_levelFilter != LVALL && record.level != m_levelFilter)
+                continue;
+            LOG_MSG_DMESG msg;
+            msg.dateTime = LogLocalTime::format(bootTime + static_cast<qint64>(record.timestamp / 1000), true);
+            msg.msg = record.message.simplified();
+            msg.level = record.level;
+            list.append(msg);
+        }
+        if (!reader.errorString().isEmpty()) {
+            qCWarning(logFollowWork) << "read kmsg failed:" << reader.errorString();
+            emit followFinished(m_threadIndex);
+            return;
+        }
+        if (!list.isEmpty())
+            emit dmesgFollowData(m_threadIndex, list);
+        reader.waitForRecord(KMSG_FOLLOW_TIMEOUT);
+    }
+}
+
+/**
+ * @brief LogFollowWork::stopWork 停止该线程,最迟在一次等待超时后退出
+ */
+void LogFollowWork::stopWork()
+{
+    qCDebug(logFollowWork) << "stopWork";
+    m_canRun = false;
+}
+
+/**
+ * @brief LogFollowWork::getIndex 获取当前对象的计数
+ * @return 当前对象的计数标号
+ */
+int LogFollowWork::getIndex()
+{
+    return m_threadIndex;
+}
+
+/**
+ * @brief LogFollowWork::getPublicIndex 获取现在此类产生对象的个数
+ * @return 此类产生对象的个数，静态成员变量
+ */
+int LogFollowWork::getPublicIndex()
+{
+    return thread_index;
+}
@@ -0,0 +1,100 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGFOLLOWWORK_H
+#define LOGFOLLOWWORK_H
+
+#include "structdef.h"
+
+#include <QMap>
+#include <QObject>
+#include <QRunnable>
+
+#include <atomic>
+
+/**
+ * @brief The LogFollowWork class 日志实时跟踪线程,文本日志按文件追加跟踪(含轮转和截断),dmesg直接跟踪/dev/kmsg,只发出新日志
+ */
+class LogFollowWork : public QObject, public QRunnable
+{
+    Q_OBJECT
+
+public:
+    enum Source {
+        //文本文件,按kern.log格式解析
+        KernFile,
+        //内核环形缓冲区
+        Kmsg,
+        //任意文本文件,只按行交出,由使用者按各自的格式解析
+        TextFile
+    };
+
+    explicit LogFollowWork(Source source, QObject *parent = nullptr);
+    ~LogFollowWork();
+
+    void setFilePath(const QString &filePath);
+    void setLevelFilter(int level);
+    void run() override;
+
+signals:
+    /**
+     * @brief kernFollowData kern.log新追加的日志
+     * @param index 当前线程的数字标号
+     * @param list 按从旧到新排列的新日志
+     */
+    void kernFollowData(int index, QList<LOG_MSG_JOURNAL> list);
+    /**
+     * @brief dmesgFollowData 内核环形缓冲区新产生的日志
+     * @param index 当前线程的数字标号
+     * @param list 按从旧到新排列的新日志
+     */
+    void dmesgFollowData(int index, QList<LOG_MSG_DMESG> list);
+    /**
+     * @brief lineFollowData 文本文件新追加的完整行
+     * @param index 当前线程的数字标号
+     * @param lines 按从旧到新排列的新行
+     */
+    void lineFollowData(int index, QStringList lines);
+    /**
+     * @brief followFinished 跟踪出错结束,被停止时不发出
+     */
+    void followFinished(int index);
+
+public slots:
+    void doWork();
+    void stopWork();
+    int getIndex();
+    static int getPublicIndex();
+
+public:
+    /**
+     * @brief thread_index 静态成员变量，用来每次构造时标记新的当前线程对象 m_threadIndex
+     */
+    static int thread_index;
+
+private:
+    void followKernFile();
+    void followKmsg();
+    void followTextFile();
+
+    Source m_source;
+    /**
+     * @brief m_filePath 跟踪的文本文件路径
+     */
+    QString m_filePath;
+    /**
+     * @brief m_levelFilter dmesg等级筛选,-1为全部
+     */
+    int m_levelFilter {-1};
+    /**
+     * @brief m_canRun 是否允许标记量，用于停止该线程,构造时即置true,避免线程启动前的停止被覆盖
+     */
+    std::atomic_bool m_canRun {true};
+    /**
+     * @brief m_threadIndex 当前线程标号
+     */
+    int m_threadIndex;
+};
+
+#endif  // LOGFOLLOWWORK_H
@@ -0,0 +1,237 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logglobalsearch.h"
+#include "dbusproxy/dldbushandler.h"
+#include "journalreader.h"
+#include "loglevel.h"
+#include "loglinefilter.h"
+#include "loglinestream.h"
+#include "loglocaltime.h"
+#include "logrecordreader.h"
+#include "logtimeline.h"
+
+#include <DApplication>
+
+#include <QLoggingCategory>
+
+#ifdef QT_DEBUG
+Q_LOGGING_CATEGORY(logGlobalSearch, "org.deepin.log.viewer.search.global")
+#else
+Q_LOGGING_CATEGORY(logGlobalSearch, "org.deepin.log.viewer.search.global", QtInfoMsg)
+#endif
+
+DWIDGET_USE_NAMESPACE
+
+/**
+ * @brief LogGlobalSearchSource::available 本机当前可搜索的来源,文本日志只包括存在的文件
+ * 在GUI线程调用,文件列表通过服务获取
+ */
+QList<LogGlobalSearchSource> LogGlobalSearchSource::available()
+{
+    QList<LogGlobalSearchSource> sources;
+    LogGlobalSearchSource journal;
+    journal.name = DApplication::translate("Tree", "System Log");
+    journal.kind = Journal;
+    sources.append(journal);
+
+    const struct {
+        const char *category;
+        const char *name;
+        Kind kind;
+        int format;
+    } files[] = {
+        {"kern", QT_TRANSLATE_NOOP("Tree", "Kernel Log"), RecordFile, LogRecordBatch::KernFormat},
+        {"dpkg", QT_TRANSLATE_NOOP("Tree", "dpkg Log"), RecordFile, LogRecordBatch::DpkgFormat},
+        {"boot", QT_TRANSLATE_NOOP("Tree", "Boot Log"), TextFile, LogRecordBatch::InvalidFormat},
+        {"dnf", QT_TRANSLATE_NOOP("Tree", "dnf Log"), TextFile, LogRecordBatch::InvalidFormat},
+        {"Xorg", QT_TRANSLATE_NOOP("Tree", "Xorg Log"), TextFile, LogRecordBatch::InvalidFormat},
+    };
+    DLDBusHandler *handler = DLDBusHandler::instance(qApp);
+    for (const auto &file : files) {
+        LogGlobalSearchSource source;
+        source.files = handler->getFileInfo(file.category, false);
+        //kern.log不存在时内核日志只在journal中,已包括在系统日志里
+        if (source.files.isEmpty())
+            continue;
+        source.name = DApplication::translate("Tree", file.name);
+        source.kind = file.kind;
+        source.format = file.format;
+        sources.append(source);
+    }
+    return sources;
+}
+
+/**
+ * @brief LogGlobalSearchWork::LogGlobalSearchWork 构造函数
+ * @param search 本次搜索的标号
+ * @param source 来源序号
+ * @param info 来源
+ * @param keyword 关键字,不区分大小写
+ * @param canRun 本次搜索的取消标记,各来源共享
+ */
+LogGlobalSearchWork::LogGlobalSearchWork(int search, int source, const LogGlobalSearchSource &info, const QString &keyword,
+                                         const std::shared_ptr<std::atomic_bool> &canRun, QObject *parent)
+    : QObject(parent)
+    , QRunnable()
+    , m_search(search)
+    , m_source(source)
+    , m_info(info)
+    , m_keyword(keyword)
+    , m_text(keyword)
+    , m_canRun(canRun)
+{
+    qRegisterMetaType<QList<LogGlobalSearchHit>>("QList<LogGlobalSearchHit>");
+    //使用线程池启动该线程，跑完自己删自己
+    setAutoDelete(true);
+}
+
+void LogGlobalSearchWork::run()
+{
+    m_timer.start();
+    bool finished = true;
+    if (m_info.kind == LogGlobalSearchSource::Journal) {
+        finished = searchJournal();
+    } else {
+        //文件按从新到旧排列,和类别加载的顺序一致
+        for (const QString &filePath : m_info.files) {
+            finished = m_info.kind == LogGlobalSearchSource::RecordFile ? searchRecordFile(filePath) : searchTextFile(filePath);
+            if (!finished)
+                break;
+        }
+    }
+    if (!*m_canRun)
+        return;
+    flush();
+    const bool truncated = m_total >= m_limit;
+    qCDebug(logGlobalSearch) << "source" << m_info.name << "hits" << m_total << "truncated" << truncated << "finished" << finished;
+    emit sourceFinished(m_search, m_source, m_total, truncated);
+}
+
+/**
+ * @brief LogGlobalSearchWork::searchJournal 从新到旧读取系统日志,逐条按关键字匹配
+ */
+bool LogGlobalSearchWork::searchJournal()
+{
+    JournalReader<SystemJournalPolicy> reader(SystemJournalPolicy(), m_sourceCanRun);
+    JournalMessageResolver resolver;
+    QList<LOG_MSG_JOURNAL> batch;
+    const int r = reader.read(JournalReadOptions(), batch, [this, &resolver](QList<LOG_MSG_JOURNAL> &list) {
+        for (const LOG_MSG_JOURNAL &msg : list) {
+            if (!LogRecordFilter::matchJournal(m_text, msg, resolver))
+                continue;
+            LogGlobalSearchHit hit;
+            hit.time = msg.timestamp / 1000;
+            hit.level = msg.level;
+            hit.dateTime = msg.dateTime;
+            hit.message = msg.daemonName.isEmpty() ? msg.msg : msg.daemonName + ": " + msg.msg;
+            if (!addHit(hit))
+                break;
+        }
+    });
+    if (r < 0 && r != -ECANCELED)
+        qCWarning(logGlobalSearch) << "read journal failed:" << reader.errorString();
+    return r >= 0 || m_total >= m_limit;
+}
+
+/**
+ * @brief LogGlobalSearchWork::searchRecordFile 读取定长列的日志,关键字交给读取器跳过解析缓存中不可能匹配的记录块
+ */
+bool LogGlobalSearchWork::searchRecordFile(const QString &filePath)
+{
+    LogRecordReader reader(filePath, m_info.format);
+    LogLineFilter filter;
+    filter.keyword = m_keyword;
+    reader.setFilter(filter);
+    return reader.read(m_sourceCanRun, [this](qint64 time, const QStringList &columns) {
+        //缓存和服务只做了预筛,仍需逐列确认
+        bool matched = false;
+        for (const QString &column : columns) {
+            if (m_text.matches(column)) {
+                matched = true;
+                break;
+            }
+        }
+        if (!matched)
+            return canRun();
+        LogGlobalSearchHit hit;
+        hit.time = time;
+        hit.dateTime = columns.value(0);
+        if (m_info.format == LogRecordBatch::KernFormat) {
+            //列:时间文本,主机名,进程名,进程id,信息
+            const QString daemon = columns.value(3).isEmpty() ? columns.value(2) : QString("%1[%2]").arg(columns.value(2), columns.value(3));
+            hit.message = daemon.isEmpty() ? columns.value(4) : daemon + ": " + columns.value(4);
+        } else {
+            //列:时间文本,动作,信息
+            hit.message = columns.value(1) + " " + columns.value(2);
+        }
+        return addHit(hit);
+    }) || m_total >= m_limit;
+}
+
+/**
+ * @brief LogGlobalSearchWork::searchTextFile 从新到旧逐块读取文本日志的行,通过服务读取时由服务按关键字预筛
+ */
+bool LogGlobalSearchWork::searchTextFile(const QString &filePath)
+{
+    LogLineStream stream(filePath);
+    LogLineFilter filter;
+    filter.keyword = m_keyword;
+    stream.setFilter(filter);
+    QStringList lines;
+    while (stream.readChunk(lines)) {
+        for (const QString &line : lines) {
+            if (!canRun())
+                return m_total >= m_limit;
+            if (line.isEmpty() || !m_text.matches(line))
+                continue;
+            LogGlobalSearchHit hit;
+            hit.time = LogLineFilter::prefixTime(line);
+            hit.message = line;
+            if (hit.time >= 0)
+                hit.dateTime = LogLocalTime::format(hit.time);
+            if (!addHit(hit))
+                return m_total >= m_limit;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief LogGlobalSearchWork::addHit 记下一条命中,攒够一批或超过间隔时发出
+ * @return false表示已达到上限或已被取消,应停止读取
+ */
+bool LogGlobalSearchWork::addHit(const LogGlobalSearchHit &hit)
+{
+    if (!canRun())
+        return false;
+    m_batch.append(hit);
+    ++m_total;
+    if (m_batch.size() >= LOG_GLOBAL_SEARCH_BATCH_COUNT || m_timer.elapsed() >= LOG_GLOBAL_SEARCH_BATCH_INTERVAL)
+        flush();
+    if (m_total >= m_limit) {
+        m_sourceCanRun = false;
+        return false;
+    }
+    return true;
+}
+
+void LogGlobalSearchWork::flush()
+{
+    if (m_batch.isEmpty() || !*m_canRun)
+        return;
+    emit hitsReady(m_search, m_source, m_batch);
+    m_batch.clear();
+    m_timer.restart();
+}
+
+/**
+ * @brief LogGlobalSearchWork::canRun 本次搜索没有被取消且本来源没有达到上限,被取消时同时停止读取器
+ */
+bool LogGlobalSearchWork::canRun() const
+{
+    if (!*m_canRun)
+        const_cast<std::atomic_bool &>(m_sourceCanRun) = false;
+    return m_sourceCanRun;
+}
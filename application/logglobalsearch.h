@@ -0,0 +1,113 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGGLOBALSEARCH_H
+#define LOGGLOBALSEARCH_H
+
+#include "logrecordbatch.h"
+#include "logrecordfilter.h"
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QMetaType>
+#include <QObject>
+#include <QRunnable>
+#include <QString>
+#include <QStringList>
+
+#include <atomic>
+#include <memory>
+
+//每个来源最多返回的命中数,达到后停止读取该来源,其余来源继续
+#define LOG_GLOBAL_SEARCH_SOURCE_LIMIT 2000
+//攒够这么多条命中或距上次发出超过这么长时间(毫秒)就发出一批
+#define LOG_GLOBAL_SEARCH_BATCH_COUNT 200
+#define LOG_GLOBAL_SEARCH_BATCH_INTERVAL 200
+
+/**
+ * @brief The LogGlobalSearchHit struct 全局搜索的一条命中,各来源统一为时间、等级和一行信息
+ */
+struct LogGlobalSearchHit {
+    //毫秒时间戳,取不到时为-1
+    qint64 time = -1;
+    //等级,为PRIORITY的值,没有等级的来源为-1
+    int level = -1;
+    QString dateTime;
+    QString message;
+};
+Q_DECLARE_METATYPE(LogGlobalSearchHit)
+
+/**
+ * @brief The LogGlobalSearchSource struct 全局搜索的一个来源
+ */
+struct LogGlobalSearchSource {
+    enum Kind {
+        //系统日志,按从新到旧读取journal
+        Journal,
+        //kern.log、dpkg.log等定长列的日志,有解析缓存时按布隆过滤器跳过不可能匹配的块
+        RecordFile,
+        //其他文本日志,逐块从新到旧读取行
+        TextFile
+    };
+    QString name;
+    Kind kind = TextFile;
+    //RecordFile的记录格式,见LogRecordBatch::Format
+    int format = LogRecordBatch::InvalidFormat;
+    QStringList files;
+
+    static QList<LogGlobalSearchSource> available();
+};
+
+/**
+ * @brief The LogGlobalSearchWork class 在线程池中搜索一个来源,分批发出命中
+ * 同一次搜索的各来源使用同一个取消标记,每个来源各自有命中数上限,达到后提前结束,不影响其他来源
+ */
+class LogGlobalSearchWork : public QObject, public QRunnable
+{
+    Q_OBJECT
+
+public:
+    LogGlobalSearchWork(int search, int source, const LogGlobalSearchSource &info, const QString &keyword,
+                        const std::shared_ptr<std::atomic_bool> &canRun, QObject *parent = nullptr);
+
+    void setLimit(int limit) { m_limit = limit; }
+    void run() override;
+
+signals:
+    /**
+     * @brief hitsReady 一批命中,按读取顺序(每个文件内从新到旧)
+     * @param search 搜索标号,旧搜索的结果由接收方丢弃
+     * @param source 来源序号
+     */
+    void hitsReady(int search, int source, QList<LogGlobalSearchHit> hits);
+    /**
+     * @brief sourceFinished 来源搜索结束,被取消时不发出
+     * @param total 命中数
+     * @param truncated 是否因达到上限而提前结束
+     */
+    void sourceFinished(int search, int source, int total, bool truncated);
+
+private:
+    bool searchJournal();
+    bool searchRecordFile(const QString &filePath);
+    bool searchTextFile(const QString &filePath);
+    bool addHit(const LogGlobalSearchHit &hit);
+    void flush();
+    bool canRun() const;
+
+    int m_search;
+    int m_source;
+    LogGlobalSearchSource m_info;
+    QString m_keyword;
+    LogRecordFilter::TextMatcher m_text;
+    std::shared_ptr<std::atomic_bool> m_canRun;
+    //本来源达到上限后置false,只停止本来源的读取
+    std::atomic_bool m_sourceCanRun {true};
+    int m_limit = LOG_GLOBAL_SEARCH_SOURCE_LIMIT;
+    int m_total = 0;
+    QList<LogGlobalSearchHit> m_batch;
+    QElapsedTimer m_timer;
+};
+
+#endif // LOGGLOBALSEARCH_H
@@ -0,0 +1,195 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logglobalsearchdlg.h"
+#include "loglevel.h"
+#include "logtablemodel.h"
+#include "logworkscheduler.h"
+
+#include <DApplication>
+
+#include <QHeaderView>
+#include <QTimer>
+#include <QVBoxLayout>
+
+//面板的默认大小
+#define LOG_GLOBAL_SEARCH_DLG_WIDTH 860
+#define LOG_GLOBAL_SEARCH_DLG_HEIGHT 560
+//命中到达后合并刷新时间线的延迟,毫秒
+#define LOG_GLOBAL_SEARCH_REFRESH_DELAY 150
+
+namespace {
+QVariant hitLevel(const LogGlobalSearchHit &hit, int role)
+{
+    if (role == LogTableModel::SortKeyRole)
+        return hit.level;
+    return role == Qt::DisplayRole && hit.level >= 0 ? QVariant(LogLevel::text(hit.level)) : QVariant();
+}
+
+QVariant hitDateTime(const LogGlobalSearchHit &hit, int role)
+{
+    return role == Qt::DisplayRole ? QVariant(hit.dateTime) : QVariant();
+}
+
+QVariant hitMessage(const LogGlobalSearchHit &hit, int role)
+{
+    return role == Qt::DisplayRole || role == Qt::ToolTipRole ? QVariant(hit.message) : QVariant();
+}
+}
+
+/**
+ * @brief LogGlobalSearchDlg::LogGlobalSearchDlg 构造函数,来源列表在打开面板时获取一次
+ * @param parent 父对象指针
+ */
+LogGlobalSearchDlg::LogGlobalSearchDlg(DWidget *parent)
+    : DDialog(parent)
+    , m_refreshTimer(new QTimer(this))
+    , m_sources(LogGlobalSearchSource::available())
+    , m_canRun(std::make_shared<std::atomic_bool>(false))
+{
+    setIcon(QIcon::fromTheme("deepin-log-viewer"));
+    setTitle(DApplication::translate("Dialog", "Search all logs"));
+
+    DWidget *pWidget = new DWidget(this);
+    QVBoxLayout *pVLayout = new QVBoxLayout();
+    pVLayout->setContentsMargins(0, 0, 0, 0);
+    m_pEdit = new DSearchEdit(pWidget);
+    m_pEdit->setAccessibleName("global_search_edit");
+    m_pEdit->setPlaceHolder(DApplication::translate("Dialog", "Search all logs"));
+    m_pStatus = new DLabel(pWidget);
+    m_pStatus->setAccessibleName("global_search_status");
+    m_pView = new QTreeView(pWidget);
+    m_pView->setAccessibleName("global_search_view");
+    m_pView->setRootIsDecorated(false);
+    m_pView->setUniformRowHeights(true);
+    m_pView->setSortingEnabled(false);
+    m_pModel = new LogTableModel(this);
+    m_pModel->setColumns<LogTimelineEntry>("global", m_timeline.columns());
+    m_pModel->setHorizontalHeaderLabels(QStringList() << DApplication::translate("Table", "Log Type")
+                                                      << DApplication::translate("Table", "Level")
+                                                      << DApplication::translate("Table", "Date and Time")
+                                                      << DApplication::translate("Table", "Info"));
+    m_pView->setModel(m_pModel);
+    m_pView->header()->setSectionResizeMode(LogTimeline::MessageColumn, QHeaderView::Stretch);
+    pVLayout->addWidget(m_pEdit);
+    pVLayout->addWidget(m_pStatus);
+    pVLayout->addWidget(m_pView, 1);
+    pWidget->setLayout(pVLayout);
+    addContent(pWidget);
+    resize(LOG_GLOBAL_SEARCH_DLG_WIDTH, LOG_GLOBAL_SEARCH_DLG_HEIGHT);
+
+    //每个来源一个存储,时间线的来源编号和来源序号一致
+    for (const LogGlobalSearchSource &source : m_sources) {
+        m_stores.emplace_back(new LogRecordStore<LogGlobalSearchHit>);
+        LogTimeline::Fields<LogGlobalSearchHit> fields {hitLevel, hitDateTime, hitMessage};
+        m_timeline.addSource<LogGlobalSearchHit>(source.name, LogRecordView<LogGlobalSearchHit>::all(m_stores.back().get()),
+                                                 [](const LogGlobalSearchHit &hit) { return hit.time; }, fields);
+    }
+
+    m_refreshTimer->setSingleShot(true);
+    m_refreshTimer->setInterval(LOG_GLOBAL_SEARCH_REFRESH_DELAY);
+    connect(m_refreshTimer, &QTimer::timeout, this, &LogGlobalSearchDlg::refreshView);
+    connect(m_pEdit, &DSearchEdit::returnPressed, this, [this]() {
+        search(m_pEdit->text());
+    });
+}
+
+LogGlobalSearchDlg::~LogGlobalSearchDlg()
+{
+    //任务不持有面板,取消后迟到的信号随面板断开
+    cancel();
+}
+
+/**
+ * @brief LogGlobalSearchDlg::search 取消上一次搜索,在所有来源中重新搜索关键字
+ * @param keyword 关键字,为空时只清空结果
+ */
+void LogGlobalSearchDlg::search(const QString &keyword)
+{
+    cancel();
+    if (m_pEdit->text() != keyword)
+        m_pEdit->setText(keyword);
+    m_pModel->removeRows(0, m_pModel->rowCount());
+    for (size_t i = 0; i < m_stores.size(); ++i) {
+        m_stores.at(i)->clear();
+        m_timeline.setSourceView(static_cast<int>(i), LogRecordView<LogGlobalSearchHit>::all(m_stores.at(i).get()));
+    }
+    m_timeline.rebuild();
+    m_truncated.clear();
+    ++m_search;
+    if (keyword.trimmed().isEmpty()) {
+        m_running = 0;
+        updateStatus();
+        return;
+    }
+
+    m_canRun = std::make_shared<std::atomic_bool>(true);
+    m_running = m_sources.size();
+    for (int i = 0; i < m_sources.size(); ++i) {
+        LogGlobalSearchWork *work = new LogGlobalSearchWork(m_search, i, m_sources.at(i), keyword.trimmed(), m_canRun);
+        connect(work, &LogGlobalSearchWork::hitsReady, this, &LogGlobalSearchDlg::onHitsReady, Qt::QueuedConnection);
+        connect(work, &LogGlobalSearchWork::sourceFinished, this, &LogGlobalSearchDlg::onSourceFinished, Qt::QueuedConnection);
+        LogWorkScheduler::instance()->start(work, LogWorkScheduler::Search);
+    }
+    updateStatus();
+}
+
+void LogGlobalSearchDlg::onHitsReady(int search, int source, QList<LogGlobalSearchHit> hits)
+{
+    if (search != m_search || source < 0 || source >= static_cast<int>(m_stores.size()))
+        return;
+    //每个文件内从新到旧,文件之间也从新到旧,直接追加;不同来源的先后由时间线归并
+    m_stores.at(static_cast<size_t>(source))->append(hits);
+    if (!m_refreshTimer->isActive())
+        m_refreshTimer->start();
+}
+
+void LogGlobalSearchDlg::onSourceFinished(int search, int source, int total, bool truncated)
+{
+    Q_UNUSED(total)
+    if (search != m_search)
+        return;
+    --m_running;
+    if (truncated)
+        m_truncated.append(m_sources.value(source).name);
+    if (m_running <= 0)
+        refreshView();
+    else
+        updateStatus();
+}
+
+void LogGlobalSearchDlg::cancel()
+{
+    *m_canRun = false;
+    m_refreshTimer->stop();
+}
+
+/**
+ * @brief LogGlobalSearchDlg::refreshView 按各来源当前的命中重新归并时间线
+ * 表格中的视图在重建后失效,先清空再装入新结果;命中数有上限,重建的开销很小
+ */
+void LogGlobalSearchDlg::refreshView()
+{
+    m_pModel->removeRows(0, m_pModel->rowCount());
+    for (size_t i = 0; i < m_stores.size(); ++i)
+        m_timeline.setSourceView(static_cast<int>(i), LogRecordView<LogGlobalSearchHit>::all(m_stores.at(i).get()));
+    m_timeline.rebuild();
+    m_pModel->appendRecords(m_timeline.view());
+    updateStatus();
+}
+
+void LogGlobalSearchDlg::updateStatus()
+{
+    QString status;
+    if (m_running > 0) {
+        status = DApplication::translate("Dialog", "Searching %1 sources, %2 results").arg(m_running).arg(m_timeline.size());
+    } else {
+        status = DApplication::translate("Dialog", "%1 results").arg(m_timeline.size());
+        if (!m_truncated.isEmpty())
+            status += " " + DApplication::translate("Dialog", "(only the newest %1 shown for: %2)")
+                                .arg(LOG_GLOBAL_SEARCH_SOURCE_LIMIT)
+                                .arg(m_truncated.join(", "));
+    }
+    m_pStatus->setText(status);
+}
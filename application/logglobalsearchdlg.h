@@ -0,0 +1,68 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGGLOBALSEARCHDLG_H
+#define LOGGLOBALSEARCHDLG_H
+
+#include "logglobalsearch.h"
+#include "logrecordstore.h"
+#include "logtimeline.h"
+
+#include <DDialog>
+#include <DLabel>
+#include <DSearchEdit>
+#include <DWidget>
+
+#include <QTreeView>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+DWIDGET_USE_NAMESPACE
+
+class LogTableModel;
+class QTimer;
+
+/**
+ * @brief The LogGlobalSearchDlg class 全局搜索面板,同一个关键字同时搜索系统日志、内核日志、dpkg等所有来源,
+ * 每个来源一个线程池任务,命中按时间合并成一个时间线显示;每个来源最多保留LOG_GLOBAL_SEARCH_SOURCE_LIMIT条
+ */
+class LogGlobalSearchDlg : public DDialog
+{
+    Q_OBJECT
+public:
+    explicit LogGlobalSearchDlg(DWidget *parent = nullptr);
+    ~LogGlobalSearchDlg() override;
+
+    void search(const QString &keyword);
+
+private slots:
+    void onHitsReady(int search, int source, QList<LogGlobalSearchHit> hits);
+    void onSourceFinished(int search, int source, int total, bool truncated);
+
+private:
+    void cancel();
+    void refreshView();
+    void updateStatus();
+
+    DSearchEdit *m_pEdit;
+    DLabel *m_pStatus;
+    QTreeView *m_pView;
+    LogTableModel *m_pModel;
+    //合并刷新,命中陆续到达时不每批重建一次时间线
+    QTimer *m_refreshTimer;
+
+    QList<LogGlobalSearchSource> m_sources;
+    //各来源的命中,时间线只保存下标,存储需要比时间线活得久
+    std::vector<std::unique_ptr<LogRecordStore<LogGlobalSearchHit>>> m_stores;
+    LogTimeline m_timeline;
+    std::shared_ptr<std::atomic_bool> m_canRun;
+    //搜索标号,旧搜索迟到的结果按标号丢弃
+    int m_search = 0;
+    int m_running = 0;
+    QStringList m_truncated;
+};
+
+#endif // LOGGLOBALSEARCHDLG_H
@@ -0,0 +1,146 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "loggzipinflater.h"
+
+#include <QFile>
+#include <QFileInfo>
+
+#include <string.h>
+
+/**
+ * @brief LogGzipInflater::LogGzipInflater 构造函数
+ * @param device 已打开的压缩数据设备,由调用者管理生命周期
+ */
+LogGzipInflater::LogGzipInflater(QIODevice *device)
+    : m_device(device)
+{
+    memset(&m_stream, 0, sizeof(m_stream));
+    //15 + 32: 自动识别gzip/zlib头
+    if (inflateInit2(&m_stream, 15 + 32) == Z_OK) {
+        m_initialized = true;
+    } else {
+        m_errorString = "inflateInit2 failed";
+        m_finished = true;
+    }
+}
+
+LogGzipInflater::~LogGzipInflater()
+{
+    if (m_initialized)
+        inflateEnd(&m_stream);
+}
+
+/**
+ * @brief LogGzipInflater::readChunk 解压下一块数据
+ * @param out 输出参数,最多LOG_GZIP_OUTPUT_CHUNK字节的解压数据
+ * @return 是否解压出了数据,false表示结束或出错,出错时errorString不为空
+ */
+bool LogGzipInflater::readChunk(QByteArray &out)
+{
+    out.clear();
+    if (m_finished)
+        return false;
+
+    out.resize(LOG_GZIP_OUTPUT_CHUNK);
+    m_stream.next_out = reinterpret_cast<Bytef *>(out.data());
+    m_stream.avail_out = static_cast<uInt>(out.size());
+    while (m_stream.avail_out > 0) {
+        if (m_stream.avail_in == 0) {
+            m_input = m_device->read(LOG_GZIP_INPUT_CHUNK);
+            if (m_input.isEmpty()) {
+                //输入结束时还没有遇到流结尾,说明文件不完整,保留已解压的内容
+                if (!m_device->atEnd() || m_stream.total_in > 0)
+                    m_errorString = m_device->errorString().isEmpty() ? QString("unexpected end of gzip data") : m_device->errorString();
+                m_finished = true;
+                break;
+            }
+            m_stream.next_in = reinterpret_cast<Bytef *>(m_input.data());
+            m_stream.avail_in = static_cast<uInt>(m_input.size());
+        }
+
+        int r = inflate(&m_stream, Z_NO_FLUSH);
+        if (r == Z_STREAM_END) {
+            //多个gzip成员拼接时继续解压下一个成员
+            if (m_stream.avail_in == 0 && m_device->atEnd()) {
+                m_finished = true;
+                break;
+            }
+            inflateReset(&m_stream);
+            m_stream.total_in = 0;
+        } else if (r != Z_OK && r != Z_BUF_ERROR) {
+            m_errorString = m_stream.msg ? QString::fromLatin1(m_stream.msg) : QString("inflate error %1").arg(r);
+            m_finished = true;
+            break;
+        }
+    }
+    out.resize(out.size() - static_cast<int>(m_stream.avail_out));
+    return !out.isEmpty();
+}
+
+/**
+ * @brief LogGzipInflater::isGzipFile 是否为轮转压缩的日志文件
+ * @param filePath 文件路径
+ * @return 后缀为gz时返回true
+ */
+bool LogGzipInflater::isGzipFile(const QString &filePath)
+{
+    return QString::compare(QFileInfo(filePath).suffix(), "gz", Qt::CaseInsensitive) == 0;
+}
+
+/**
+ * @brief LogGzipInflater::sizeLimitError 解压后超过大小上限时的错误信息
+ */
+QString LogGzipInflater::sizeLimitError()
+{
+    return QStringLiteral("inflated size exceeds limit");
+}
+
+/**
+ * @brief LogGzipInflater::inflateFile 解压整个文件到内存
+ * @param filePath 文件路径
+ * @param out 输出参数,解压后的数据
+ * @param error 可选的错误信息输出
+ * @param maxSize 解压后的大小上限
+ * @return 是否成功,数据损坏时out中保留已解压的部分,超过上限时out为空
+ */
+bool LogGzipInflater::inflateFile(const QString &filePath, QByteArray &out, QString *error, qint64 maxSize)
+{
+    out.clear();
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (error)
+            *error = file.errorString();
+        return false;
+    }
+    return inflateDevice(&file, out, error, maxSize);
+}
+
+/**
+ * @brief LogGzipInflater::inflateDevice 解压已打开设备中的全部数据到内存,如服务传来的文件描述符
+ * @param device 已打开的设备
+ * @param out 输出参数,解压后的数据
+ * @param error 可选的错误信息输出
+ * @param maxSize 解压后的大小上限,超过时停止解压并返回sizeLimitError
+ * @return 是否成功,数据损坏时out中保留已解压的部分,超过上限时out为空
+ */
+bool LogGzipInflater::inflateDevice(QIODevice *device, QByteArray &out, QString *error, qint64 maxSize)
+{
+    out.clear();
+    LogGzipInflater inflater(device);
+    QByteArray chunk;
+    while (inflater.readChunk(chunk)) {
+        if (out.size() + static_cast<qint64>(chunk.size()) > maxSize) {
+            out.clear();
+            out.squeeze();
+            if (error)
+                *error = sizeLimitError();
+            return false;
+        }
+        out.append(chunk);
+    }
+    if (error)
+        *error = inflater.errorString();
+    return inflater.errorString().isEmpty();
+}
@@ -0,0 +1,53 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGGZIPINFLATER_H
+#define LOGGZIPINFLATER_H
+
+#include <QByteArray>
+#include <QString>
+
+#include <zlib.h>
+
+class QIODevice;
+
+//每次从设备读取的压缩数据大小
+#define LOG_GZIP_INPUT_CHUNK (256 * 1024)
+//每次解压输出的最大数据大小
+#define LOG_GZIP_OUTPUT_CHUNK (1024 * 1024)
+//整个解压到内存时解压后的大小上限,防止压缩炸弹耗尽内存,也不超过QByteArray的容量
+#define LOG_GZIP_MAX_INFLATED (1024 * 1024 * 1024LL)
+
+/**
+ * @brief The LogGzipInflater class 轮转日志(.gz)的进程内流式解压,代替gunzip子进程和临时文件
+ * 支持多个gzip成员拼接的文件,应用和提权服务共用
+ */
+class LogGzipInflater
+{
+public:
+    explicit LogGzipInflater(QIODevice *device);
+    ~LogGzipInflater();
+
+    bool readChunk(QByteArray &out);
+    QString errorString() const { return m_errorString; }
+
+    static bool isGzipFile(const QString &filePath);
+    static bool inflateFile(const QString &filePath, QByteArray &out, QString *error = nullptr,
+                            qint64 maxSize = LOG_GZIP_MAX_INFLATED);
+    static bool inflateDevice(QIODevice *device, QByteArray &out, QString *error = nullptr,
+                              qint64 maxSize = LOG_GZIP_MAX_INFLATED);
+    static QString sizeLimitError();
+
+private:
+    Q_DISABLE_COPY(LogGzipInflater)
+
+    QIODevice *m_device;
+    z_stream m_stream;
+    QByteArray m_input;
+    bool m_initialized = false;
+    bool m_finished = false;
+    QString m_errorString;
+};
+
+#endif // LOGGZIPINFLATER_H
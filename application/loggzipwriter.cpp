@@ -0,0 +1,199 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "loggzipwriter.h"
+
+#include <QLoggingCategory>
+#include <QtConcurrent>
+
+#include <string.h>
+
+#ifdef QT_DEBUG
+Q_LOGGING_CATEGORY(logGzipWriter, "org.deepin.log.viewer.export.gzip")
+#else
+Q_LOGGING_CATEGORY(logGzipWriter, "org.deepin.log.viewer.export.gzip", QtInfoMsg)
+#endif
+
+//导出时压缩级别偏向速度,文本日志的压缩率和默认级别相差不多
+#define GZIP_WRITE_LEVEL 3
+//最多排队等待压缩的数据块数,压缩跟不上时写入方在此等待,内存占用有上限
+#define GZIP_WRITE_QUEUE_BLOCKS 4
+//每次压缩输出的缓冲大小
+#define GZIP_WRITE_OUTPUT_SIZE (256 * 1024)
+
+/**
+ * @brief LogGzipWriter::LogGzipWriter 构造函数
+ * @param target 已打开的目标设备,由调用者管理生命周期,压缩期间只由压缩线程写入
+ */
+LogGzipWriter::LogGzipWriter(QIODevice *target)
+    : m_target(target)
+{
+    memset(&m_stream, 0, sizeof(m_stream));
+    m_pool.setMaxThreadCount(1);
+}
+
+/**
+ * @brief LogGzipWriter::~LogGzipWriter 没有调用finish时丢弃未压缩的数据,结束压缩线程
+ */
+LogGzipWriter::~LogGzipWriter()
+{
+    if (isOpen()) {
+        stopWorker(false);
+        QIODevice::close();
+    }
+    if (m_initialized)
+        deflateEnd(&m_stream);
+}
+
+/**
+ * @brief LogGzipWriter::open 初始化gzip压缩流并启动压缩线程,只支持写入
+ */
+bool LogGzipWriter::open(OpenMode mode)
+{
+    if (isOpen() || (mode & ReadOnly) || !(mode & WriteOnly) || !m_target || !m_target->isWritable())
+        return false;
+    //MAX_WBITS + 16: 输出带gzip头和尾
+    if (deflateInit2(&m_stream, GZIP_WRITE_LEVEL, Z_DEFLATED, MAX_WBITS + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        qCWarning(logGzipWriter) << "deflateInit2 failed";
+        return false;
+    }
+    m_initialized = true;
+    m_output.resize(GZIP_WRITE_OUTPUT_SIZE);
+    m_queue.clear();
+    m_finishing = false;
+    m_canceled = false;
+    m_failed = false;
+    m_worker = QtConcurrent::run(&m_pool, [this]() {
+        compressLoop();
+    });
+    return QIODevice::open(mode);
+}
+
+/**
+ * @brief LogGzipWriter::close 写完剩余数据后关闭,需要知道是否成功时调用finish
+ */
+void LogGzipWriter::close()
+{
+    if (isOpen())
+        finish();
+}
+
+bool LogGzipWriter::isSequential() const
+{
+    return true;
+}
+
+/**
+ * @brief LogGzipWriter::finish 等待队列中的数据压缩完,写入gzip尾后关闭
+ * @return 所有数据是否都已压缩写入目标设备
+ */
+bool LogGzipWriter::finish()
+{
+    if (!isOpen())
+        return false;
+    stopWorker(true);
+    const bool ok = !m_failed;
+    deflateEnd(&m_stream);
+    m_initialized = false;
+    QIODevice::close();
+    if (!ok)
+        qCWarning(logGzipWriter) << "write gzip data failed:" << m_target->errorString();
+    return ok;
+}
+
+/**
+ * @brief LogGzipWriter::isGzipFileName 按文件名判断是否导出为gzip压缩文本
+ */
+bool LogGzipWriter::isGzipFileName(const QString &fileName)
+{
+    return fileName.endsWith(".gz", Qt::CaseInsensitive);
+}
+
+qint64 LogGzipWriter::readData(char *data, qint64 maxSize)
+{
+    Q_UNUSED(data)
+    Q_UNUSED(maxSize)
+    return -1;
+}
+
+/**
+ * @brief LogGzipWriter::writeData 数据复制到队列后返回,队列满时等待压缩线程取走
+ */
+qint64 LogGzipWriter::writeData(const char *data, qint64 len)
+{
+    QMutexLocker locker(&m_mutex);
+    while (m_queue.size() >= GZIP_WRITE_QUEUE_BLOCKS && !m_failed)
+        m_queueChanged.wait(&m_mutex);
+    if (m_failed)
+        return -1;
+    m_queue.enqueue(QByteArray(data, static_cast<int>(len)));
+    m_queueChanged.wakeAll();
+    return len;
+}
+
+/**
+ * @brief LogGzipWriter::compressLoop 压缩线程,按写入顺序逐块压缩,收到结束通知且队列取空后写入gzip尾
+ */
+void LogGzipWriter::compressLoop()
+{
+    forever {
+        QByteArray block;
+        bool last = false;
+        {
+            QMutexLocker locker(&m_mutex);
+            while (m_queue.isEmpty() && !m_finishing && !m_canceled)
+                m_queueChanged.wait(&m_mutex);
+            if (m_canceled)
+                return;
+            if (m_queue.isEmpty()) {
+                last = true;
+            } else {
+                block = m_queue.dequeue();
+                m_queueChanged.wakeAll();
+            }
+        }
+        if (!deflateBlock(block, last ? Z_FINISH : Z_NO_FLUSH)) {
+            QMutexLocker locker(&m_mutex);
+            m_failed = true;
+            m_queue.clear();
+            m_queueChanged.wakeAll();
+            return;
+        }
+        if (last)
+            return;
+    }
+}
+
+bool LogGzipWriter::deflateBlock(const QByteArray &block, int flush)
+{
+    m_stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(block.constData()));
+    m_stream.avail_in = static_cast<uInt>(block.size());
+    do {
+        m_stream.next_out = reinterpret_cast<Bytef *>(m_output.data());
+        m_stream.avail_out = static_cast<uInt>(m_output.size());
+        if (deflate(&m_stream, flush) == Z_STREAM_ERROR)
+            return false;
+        const qint64 have = m_output.size() - static_cast<qint64>(m_stream.avail_out);
+        if (have > 0 && m_target->write(m_output.constData(), have) != have)
+            return false;
+    } while (m_stream.avail_out == 0);
+    return true;
+}
+
+/**
+ * @brief LogGzipWriter::stopWorker 通知压缩线程结束并等待
+ * @param finishStream 为true时先压缩完队列中的数据并写入gzip尾,否则直接丢弃
+ */
+void LogGzipWriter::stopWorker(bool finishStream)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        if (finishStream)
+            m_finishing = true;
+        else
+            m_canceled = true;
+        m_queueChanged.wakeAll();
+    }
+    m_worker.waitForFinished();
+}
@@ -0,0 +1,63 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGGZIPWRITER_H
+#define LOGGZIPWRITER_H
+
+#include <QByteArray>
+#include <QFuture>
+#include <QIODevice>
+#include <QMutex>
+#include <QQueue>
+#include <QThreadPool>
+#include <QWaitCondition>
+
+#include <zlib.h>
+
+/**
+ * @brief The LogGzipWriter class 导出文本时边写边压缩为gzip(.txt.gz)
+ * 作为写入设备交给LogExportWriter,写入的数据块进入有界队列后立即返回,
+ * 由单独的线程压缩并写入目标设备,文本拼接和压缩并行进行;压缩或写入失败后的写入返回-1
+ */
+class LogGzipWriter : public QIODevice
+{
+public:
+    explicit LogGzipWriter(QIODevice *target);
+    ~LogGzipWriter() override;
+
+    bool open(OpenMode mode) override;
+    void close() override;
+    bool isSequential() const override;
+
+    bool finish();
+
+    static bool isGzipFileName(const QString &fileName);
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override;
+    qint64 writeData(const char *data, qint64 len) override;
+
+private:
+    void compressLoop();
+    bool deflateBlock(const QByteArray &block, int flush);
+    void stopWorker(bool finishStream);
+
+    QIODevice *m_target;
+    z_stream m_stream;
+    bool m_initialized = false;
+    //压缩输出缓冲,只在压缩线程中使用
+    QByteArray m_output;
+
+    QThreadPool m_pool;
+    QFuture<void> m_worker;
+    QMutex m_mutex;
+    QWaitCondition m_queueChanged;
+    //等待压缩的数据块
+    QQueue<QByteArray> m_queue;
+    bool m_finishing = false;
+    bool m_canceled = false;
+    bool m_failed = false;
+};
+
+#endif // LOGGZIPWRITER_H
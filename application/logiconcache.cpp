@@ -0,0 +1,68 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logiconcache.h"
+
+#include <DApplicationHelper>
+
+#include <QGuiApplication>
+
+DWIDGET_USE_NAMESPACE
+
+uint qHash(const LogIconCache::PixmapKey &key, uint seed)
+{
+    return qHash(key.icon, seed) ^ qHash((key.width << 16) ^ key.height, seed) ^ qHash((key.ratio << 4) ^ key.theme, seed);
+}
+
+LogIconCache::LogIconCache(QObject *parent)
+    : QObject(parent)
+{
+    connect(DApplicationHelper::instance(), &DApplicationHelper::themeTypeChanged, this, &LogIconCache::clear);
+}
+
+LogIconCache *LogIconCache::instance()
+{
+    static LogIconCache *cache = new LogIconCache(qApp);
+    return cache;
+}
+
+/**
+ * @brief LogIconCache::icon 取路径为prefix + name的图标,名称为空时返回空图标
+ */
+QIcon LogIconCache::icon(const QString &prefix, const QString &name)
+{
+    if (name.isEmpty())
+        return QIcon();
+    QHash<QString, QIcon> &icons = m_icons[prefix];
+    auto it = icons.constFind(name);
+    if (it == icons.constEnd())
+        it = icons.insert(name, QIcon(prefix + name));
+    return it.value();
+}
+
+/**
+ * @brief LogIconCache::pixmap 图标在指定尺寸和设备像素比下的位图
+ */
+QPixmap LogIconCache::pixmap(const QIcon &icon, const QSize &size, qreal devicePixelRatio)
+{
+    const PixmapKey key {icon.cacheKey(), size.width(), size.height(), qRound(devicePixelRatio * 1000),
+                         static_cast<int>(DApplicationHelper::instance()->themeType())};
+    auto it = m_pixmaps.constFind(key);
+    if (it != m_pixmaps.constEnd())
+        return it.value();
+
+    QPixmap pixmap = icon.pixmap(size * devicePixelRatio);
+    pixmap.setDevicePixelRatio(devicePixelRatio);
+    m_pixmaps.insert(key, pixmap);
+    return pixmap;
+}
+
+/**
+ * @brief LogIconCache::clear 主题变化后丢弃所有图标和位图
+ */
+void LogIconCache::clear()
+{
+    m_icons.clear();
+    m_pixmaps.clear();
+}
@@ -0,0 +1,56 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGICONCACHE_H
+#define LOGICONCACHE_H
+
+#include <QHash>
+#include <QIcon>
+#include <QObject>
+#include <QPixmap>
+#include <QSize>
+#include <QString>
+
+/**
+ * @brief The LogIconCache class 进程内共用的等级、状态图标缓存,只在GUI线程使用
+ * 各表格的等级列只有十来种图标,同一路径的QIcon在所有表格、所有行之间共用一份;
+ * 绘制用的位图按(图标, 尺寸, 设备像素比, 主题)缓存,SVG只在第一次绘制时渲染,主题变化后清空重新生成
+ */
+class LogIconCache : public QObject
+{
+    Q_OBJECT
+public:
+    static LogIconCache *instance();
+
+    QIcon icon(const QString &prefix, const QString &name);
+    QPixmap pixmap(const QIcon &icon, const QSize &size, qreal devicePixelRatio);
+    int iconCount() const { return m_icons.size(); }
+    int pixmapCount() const { return m_pixmaps.size(); }
+
+public slots:
+    void clear();
+
+private:
+    explicit LogIconCache(QObject *parent = nullptr);
+
+    struct PixmapKey {
+        qint64 icon;
+        int width;
+        int height;
+        //设备像素比放大1000倍取整
+        int ratio;
+        int theme;
+        bool operator==(const PixmapKey &other) const
+        {
+            return icon == other.icon && width == other.width && height == other.height && ratio == other.ratio && theme == other.theme;
+        }
+    };
+    friend uint qHash(const PixmapKey &key, uint seed);
+
+    //键为prefix + name,只在未命中时拼接
+    QHash<QString, QHash<QString, QIcon>> m_icons;
+    QHash<PixmapKey, QPixmap> m_pixmaps;
+};
+
+#endif // LOGICONCACHE_H
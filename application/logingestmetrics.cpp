@@ -0,0 +1,213 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logingestmetrics.h"
+#include "logtracer.h"
+
+#include <QDateTime>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLoggingCategory>
+
+#ifdef QT_DEBUG
+Q_LOGGING_CATEGORY(logIngestMetrics, "org.deepin.log.viewer.ingest.metrics")
+#else
+Q_LOGGING_CATEGORY(logIngestMetrics, "org.deepin.log.viewer.ingest.metrics", QtInfoMsg)
+#endif
+
+namespace {
+//当前线程所属加载的计数,没有在加载中时为空
+thread_local LogIngestCountersPtr t_counters;
+//总线调用嵌套的层数,只统计最外层,避免重复计算
+thread_local int t_dbusDepth = 0;
+}
+
+/**
+ * @brief LogIngestReport::toLogLine 一行key=value格式的指标,便于在日志中按字段检索
+ */
+QString LogIngestReport::toLogLine() const
+{
+    return QString("ingest type=%1 bytes=%2 lines=%3 kept=%4 dbusMs=%5 dbusCalls=%6 parseMs=%7 insertMs=%8 firstRowMs=%9 totalMs=%10")
+        .arg(type)
+        .arg(bytesRead)
+        .arg(linesParsed)
+        .arg(linesKept)
+        .arg(dbusMs)
+        .arg(dbusCalls)
+        .arg(parseMs)
+        .arg(insertMs)
+        .arg(firstRowMs)
+        .arg(totalMs);
+}
+
+QByteArray LogIngestReport::toJson() const
+{
+    QJsonObject obj;
+    obj.insert("time", QDateTime::currentDateTime().toString(Qt::ISODateWithMs));
+    obj.insert("type", type);
+    obj.insert("bytes", static_cast<double>(bytesRead));
+    obj.insert("lines", static_cast<double>(linesParsed));
+    obj.insert("kept", static_cast<double>(linesKept));
+    obj.insert("dbusMs", static_cast<double>(dbusMs));
+    obj.insert("dbusCalls", static_cast<double>(dbusCalls));
+    obj.insert("parseMs", static_cast<double>(parseMs));
+    obj.insert("insertMs", static_cast<double>(insertMs));
+    obj.insert("firstRowMs", firstRowMs >= 0 ? QJsonValue(static_cast<double>(firstRowMs)) : QJsonValue());
+    obj.insert("totalMs", static_cast<double>(totalMs));
+    return QJsonDocument(obj).toJson(QJsonDocument::Compact);
+}
+
+LogIngestCountersPtr LogIngestMetrics::current()
+{
+    return t_counters;
+}
+
+void LogIngestMetrics::setCurrent(const LogIngestCountersPtr &counters)
+{
+    t_counters = counters;
+}
+
+/**
+ * @brief LogIngestMetrics::addRead 累加读取的字节数和行数,服务端解析好的记录没有原始字节数时bytes为0
+ */
+void LogIngestMetrics::addRead(qint64 bytes, qint64 lines)
+{
+    LogIngestCounters *counters = t_counters.get();
+    if (!counters)
+        return;
+    counters->bytesRead.fetch_add(bytes, std::memory_order_relaxed);
+    counters->linesParsed.fetch_add(lines, std::memory_order_relaxed);
+}
+
+void LogIngestMetrics::addDBus(qint64 us)
+{
+    LogIngestCounters *counters = t_counters.get();
+    if (!counters)
+        return;
+    counters->dbusUs.fetch_add(us, std::memory_order_relaxed);
+    counters->dbusCalls.fetch_add(1, std::memory_order_relaxed);
+}
+
+QString LogIngestMetrics::metricsPath()
+{
+    return QString::fromLocal8Bit(qgetenv(LOG_INGEST_METRICS_ENV));
+}
+
+/**
+ * @brief LogIngestMetrics::appendMetricsFile 指标文件中追加一行json,多次运行的结果保留在同一个文件中
+ * @param path 文件路径,为空时使用环境变量指定的路径,都没有时不写入
+ */
+bool LogIngestMetrics::appendMetricsFile(const LogIngestReport &report, const QString &path)
+{
+    const QString outPath = path.isEmpty() ? metricsPath() : path;
+    if (outPath.isEmpty())
+        return false;
+    QFile file(outPath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        qCWarning(logIngestMetrics) << "open metrics file failed:" << outPath;
+        return false;
+    }
+    return file.write(report.toJson() + '\n') > 0;
+}
+
+LogIngestScope::LogIngestScope(const LogIngestCountersPtr &counters, bool timed)
+    : m_previous(t_counters)
+    , m_counters(counters)
+    , m_begin(timed && counters ? LogTracer::now() : -1)
+{
+    t_counters = counters;
+}
+
+LogIngestScope::~LogIngestScope()
+{
+    if (m_begin >= 0)
+        m_counters->parseUs.fetch_add(LogTracer::now() - m_begin, std::memory_order_relaxed);
+    t_counters = m_previous;
+}
+
+LogIngestDBusScope::LogIngestDBusScope()
+    : m_begin(t_counters && t_dbusDepth == 0 ? LogTracer::now() : -1)
+{
+    ++t_dbusDepth;
+}
+
+LogIngestDBusScope::~LogIngestDBusScope()
+{
+    --t_dbusDepth;
+    if (m_begin >= 0)
+        LogIngestMetrics::addDBus(LogTracer::now() - m_begin);
+}
+
+/**
+ * @brief LogIngestSession::begin 开始一次加载,之后在界面线程创建的解析线程都计入这次加载
+ * @param type 日志类型名称,如kern、journal
+ */
+void LogIngestSession::begin(const QString &type)
+{
+    m_type = type;
+    m_counters = std::make_shared<LogIngestCounters>();
+    m_begin = LogTracer::now();
+    m_insertUs = 0;
+    m_firstRowUs = -1;
+    LogIngestMetrics::setCurrent(m_counters);
+}
+
+/**
+ * @brief LogIngestSession::addInsert 累计插入model的耗时,第一次插入非空数据时记下第一行显示的时间
+ */
+void LogIngestSession::addInsert(qint64 us, int rows)
+{
+    if (!isActive())
+        return;
+    m_insertUs += us;
+    if (m_firstRowUs < 0 && rows > 0)
+        m_firstRowUs = LogTracer::now() - m_begin;
+}
+
+/**
+ * @brief LogIngestSession::finish 结束加载并汇总指标,界面线程不再计入这次加载
+ * @param kept 加载得到的记录数
+ */
+LogIngestReport LogIngestSession::finish(qint64 kept)
+{
+    LogIngestReport report;
+    if (!isActive())
+        return report;
+    report.type = m_type;
+    report.bytesRead = m_counters->bytesRead.load(std::memory_order_relaxed);
+    report.linesParsed = m_counters->linesParsed.load(std::memory_order_relaxed);
+    report.linesKept = kept;
+    report.dbusMs = m_counters->dbusUs.load(std::memory_order_relaxed) / 1000;
+    report.dbusCalls = m_counters->dbusCalls.load(std::memory_order_relaxed);
+    report.parseMs = m_counters->parseUs.load(std::memory_order_relaxed) / 1000;
+    report.insertMs = m_insertUs / 1000;
+    report.firstRowMs = m_firstRowUs >= 0 ? m_firstRowUs / 1000 : -1;
+    report.totalMs = (LogTracer::now() - m_begin) / 1000;
+    abort();
+    return report;
+}
+
+/**
+ * @brief LogIngestSession::abort 放弃当前加载,不输出指标
+ */
+void LogIngestSession::abort()
+{
+    if (LogIngestMetrics::current() == m_counters)
+        LogIngestMetrics::setCurrent(LogIngestCountersPtr());
+    m_counters.reset();
+}
+
+LogIngestSession::InsertScope::InsertScope(LogIngestSession &session, int rows)
+    : m_session(session)
+    , m_rows(rows)
+    , m_begin(session.isActive() ? LogTracer::now() : -1)
+{
+}
+
+LogIngestSession::InsertScope::~InsertScope()
+{
+    if (m_begin >= 0)
+        m_session.addInsert(LogTracer::now() - m_begin, m_rows);
+}
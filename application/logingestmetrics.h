@@ -0,0 +1,137 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGINGESTMETRICS_H
+#define LOGINGESTMETRICS_H
+
+#include <QByteArray>
+#include <QString>
+
+#include <atomic>
+#include <memory>
+
+//环境变量,值为指标文件的路径,设置后每次加载结束追加一行json
+#define LOG_INGEST_METRICS_ENV "DEEPIN_LOG_VIEWER_METRICS"
+
+/**
+ * @brief The LogIngestCounters struct 一次加载在各个线程中累计的计数,时间单位为微秒
+ */
+struct LogIngestCounters {
+    std::atomic<qint64> bytesRead {0};
+    std::atomic<qint64> linesParsed {0};
+    std::atomic<qint64> dbusUs {0};
+    std::atomic<qint64> dbusCalls {0};
+    std::atomic<qint64> parseUs {0};
+};
+typedef std::shared_ptr<LogIngestCounters> LogIngestCountersPtr;
+
+/**
+ * @brief The LogIngestReport struct 一次加载的各阶段指标,时间单位为毫秒,-1表示没有该阶段
+ */
+struct LogIngestReport {
+    QString type;
+    qint64 bytesRead = 0;
+    qint64 linesParsed = 0;
+    //解析线程交出的记录数,即经过时间、等级等筛选后保留的行
+    qint64 linesKept = 0;
+    qint64 dbusMs = 0;
+    qint64 dbusCalls = 0;
+    //解析线程的运行时间,包括其中的总线调用
+    qint64 parseMs = 0;
+    qint64 insertMs = 0;
+    qint64 firstRowMs = -1;
+    qint64 totalMs = 0;
+
+    QString toLogLine() const;
+    QByteArray toJson() const;
+};
+
+/**
+ * @brief The LogIngestMetrics class 加载指标的线程内上下文
+ * 界面发起加载时设置当前线程的计数,解析线程在构造时取得、运行时安装到自己的线程,
+ * 读取、解析和总线调用的位置只累加到当前线程的计数,没有计数时什么都不做
+ */
+class LogIngestMetrics
+{
+public:
+    static LogIngestCountersPtr current();
+    static void setCurrent(const LogIngestCountersPtr &counters);
+    static void addRead(qint64 bytes, qint64 lines);
+    static void addDBus(qint64 us);
+
+    static QString metricsPath();
+    static bool appendMetricsFile(const LogIngestReport &report, const QString &path = QString());
+};
+
+/**
+ * @brief The LogIngestScope class 在当前线程安装计数,析构时恢复;timed为true时把作用域的耗时计为解析时间
+ */
+class LogIngestScope
+{
+public:
+    explicit LogIngestScope(const LogIngestCountersPtr &counters, bool timed = false);
+    ~LogIngestScope();
+    LogIngestScope(const LogIngestScope &) = delete;
+    LogIngestScope &operator=(const LogIngestScope &) = delete;
+
+private:
+    LogIngestCountersPtr m_previous;
+    LogIngestCountersPtr m_counters;
+    qint64 m_begin;
+};
+
+/**
+ * @brief The LogIngestDBusScope class 作用域内的总线调用耗时计入当前线程的计数
+ */
+class LogIngestDBusScope
+{
+public:
+    LogIngestDBusScope();
+    ~LogIngestDBusScope();
+    LogIngestDBusScope(const LogIngestDBusScope &) = delete;
+    LogIngestDBusScope &operator=(const LogIngestDBusScope &) = delete;
+
+private:
+    qint64 m_begin;
+};
+
+/**
+ * @brief The LogIngestSession class 界面线程中的一次加载,从发起到结束统计插入model的耗时和第一行显示的时间
+ */
+class LogIngestSession
+{
+public:
+    void begin(const QString &type);
+    bool isActive() const { return m_counters != nullptr; }
+    QString type() const { return m_type; }
+    void addInsert(qint64 us, int rows);
+    LogIngestReport finish(qint64 kept);
+    void abort();
+
+    /**
+     * @brief The InsertScope class 统计一次插入model的耗时,rows为插入的行数
+     */
+    class InsertScope
+    {
+    public:
+        InsertScope(LogIngestSession &session, int rows);
+        ~InsertScope();
+        InsertScope(const InsertScope &) = delete;
+        InsertScope &operator=(const InsertScope &) = delete;
+
+    private:
+        LogIngestSession &m_session;
+        int m_rows;
+        qint64 m_begin;
+    };
+
+private:
+    QString m_type;
+    LogIngestCountersPtr m_counters;
+    qint64 m_begin = 0;
+    qint64 m_insertUs = 0;
+    qint64 m_firstRowUs = -1;
+};
+
+#endif // LOGINGESTMETRICS_H
@@ -0,0 +1,114 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGINGESTSOURCE_H
+#define LOGINGESTSOURCE_H
+
+#include "logfileparser.h"
+
+/**
+ * @brief The LogIngestSource struct 由LogAuthThread解析的日志类型的接入描述,按筛选条件的类型特化
+ * LogFileParser::startSource按它完成一次加载:取来源文件、回放类别缓存、快照中没有时直接结束、
+ * 启动解析线程、接入界面额度和停止信号、开始收集缓存;预取和缓存收集也按它连接信号。
+ * 新的日志类型只需补一个特化,就能用上这些功能,不必再写一份parseBy*的流程。
+ * 各成员:
+ * Record 记录类型;flag 解析线程的类型;category 来源文件的类别,为空表示不按文件读取;
+ * cached 结果是否存入类别缓存(需要LogCategoryCache支持Record);
+ * threadData/threadFinished 解析线程的信号;data/finished/stop LogFileParser转发的信号和停止信号;
+ * emitFinished 只带标号发出结束信号,用于回放缓存;cacheKey 筛选条件对应的缓存键
+ */
+template <typename Filter>
+struct LogIngestSource;
+
+template <>
+struct LogIngestSource<DKPG_FILTERS> {
+    using Record = LOG_MSG_DPKG;
+    static constexpr LOG_FLAG flag = DPKG;
+    static constexpr const char *category = "dpkg";
+    static constexpr bool cached = true;
+    static constexpr auto threadData = &LogAuthThread::dpkgData;
+    static constexpr auto threadFinished = &LogAuthThread::dpkgFinished;
+    static constexpr auto data = &LogFileParser::dpkgData;
+    static constexpr auto finished = &LogFileParser::dpkgFinished;
+    static constexpr auto stop = &LogFileParser::stopDpkg;
+    static void emitFinished(LogFileParser *parser, int index) { emit parser->dpkgFinished(index); }
+    static QString cacheKey(const DKPG_FILTERS &filter)
+    {
+        return QString("dpkg:%1:%2").arg(filter.timeFilterBegin).arg(filter.timeFilterEnd);
+    }
+};
+
+template <>
+struct LogIngestSource<XORG_FILTERS> {
+    using Record = LOG_MSG_XORG;
+    static constexpr LOG_FLAG flag = XORG;
+    static constexpr const char *category = "Xorg";
+    static constexpr bool cached = true;
+    static constexpr auto threadData = &LogAuthThread::xorgData;
+    static constexpr auto threadFinished = &LogAuthThread::xorgFinished;
+    static constexpr auto data = &LogFileParser::xlogData;
+    static constexpr auto finished = &LogFileParser::xlogFinished;
+    static constexpr auto stop = &LogFileParser::stopXlog;
+    static void emitFinished(LogFileParser *parser, int index) { emit parser->xlogFinished(index); }
+    static QString cacheKey(const XORG_FILTERS &filter)
+    {
+        return QString("xorg:%1:%2").arg(filter.timeFilterBegin).arg(filter.timeFilterEnd);
+    }
+};
+
+template <>
+struct LogIngestSource<AUDIT_FILTERS> {
+    using Record = LOG_MSG_AUDIT;
+    static constexpr LOG_FLAG flag = Audit;
+    static constexpr const char *category = "audit";
+    static constexpr bool cached = true;
+    static constexpr auto threadData = &LogAuthThread::auditData;
+    static constexpr auto threadFinished = &LogAuthThread::auditFinished;
+    static constexpr auto data = &LogFileParser::auditData;
+    static constexpr auto finished = &LogFileParser::auditFinished;
+    //审计日志一直随内核日志的停止信号停止
+    static constexpr auto stop = &LogFileParser::stopKern;
+    static void emitFinished(LogFileParser *parser, int index) { emit parser->auditFinished(index); }
+    static QString cacheKey(const AUDIT_FILTERS &filter)
+    {
+        return QString("audit:%1:%2:%3:%4").arg(filter.timeFilterBegin).arg(filter.timeFilterEnd)
+               .arg(filter.auditTypeFilter).arg(filter.searchstr);
+    }
+};
+
+template <>
+struct LogIngestSource<DNF_FILTERS> {
+    using Record = LOG_MSG_DNF;
+    static constexpr LOG_FLAG flag = Dnf;
+    static constexpr const char *category = "dnf";
+    static constexpr bool cached = true;
+    static constexpr auto threadData = &LogAuthThread::dnfData;
+    static constexpr auto threadFinished = &LogAuthThread::dnfFinished;
+    static constexpr auto data = &LogFileParser::dnfData;
+    static constexpr auto finished = &LogFileParser::dnfFinished;
+    static constexpr auto stop = &LogFileParser::stopDnf;
+    static void emitFinished(LogFileParser *parser, int index) { emit parser->dnfFinished(index); }
+    static QString cacheKey(const DNF_FILTERS &filter)
+    {
+        return QString("dnf:%1:%2").arg(filter.timeFilter).arg(filter.levelfilter);
+    }
+};
+
+template <>
+struct LogIngestSource<DMESG_FILTERS> {
+    using Record = LOG_MSG_DMESG;
+    static constexpr LOG_FLAG flag = Dmesg;
+    //读取内核环形缓冲区,没有来源文件,内容随时变化,不缓存
+    static constexpr const char *category = "";
+    static constexpr bool cached = false;
+    static constexpr auto threadData = &LogAuthThread::dmesgData;
+    static constexpr auto threadFinished = &LogAuthThread::dmesgFinished;
+    static constexpr auto data = &LogFileParser::dmesgData;
+    static constexpr auto finished = &LogFileParser::dmesgFinished;
+    static constexpr auto stop = &LogFileParser::stopDmesg;
+    static void emitFinished(LogFileParser *parser, int index) { emit parser->dmesgFinished(index); }
+    static QString cacheKey(const DMESG_FILTERS &) { return QString(); }
+};
+
+#endif // LOGINGESTSOURCE_H
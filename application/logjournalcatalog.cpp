@@ -0,0 +1,151 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logjournalcatalog.h"
+#include "journalreader.h"
+#include "logworkscheduler.h"
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QLoggingCategory>
+
+#ifdef QT_DEBUG
+Q_LOGGING_CATEGORY(logJournalCatalog, "org.deepin.log.viewer.journal.catalog")
+#else
+Q_LOGGING_CATEGORY(logJournalCatalog, "org.deepin.log.viewer.journal.catalog", QtInfoMsg)
+#endif
+
+LogJournalCatalog::LogJournalCatalog(QObject *parent)
+    : QObject(parent)
+{
+    connect(&m_watcher, &QFutureWatcher<LogJournalCatalogData>::finished, this, &LogJournalCatalog::onQueryFinished);
+    connect(&m_bootWatcher, &QFutureWatcher<QList<JournalBootInfo>>::finished, this, &LogJournalCatalog::onBootsFinished);
+}
+
+LogJournalCatalog *LogJournalCatalog::instance()
+{
+    static LogJournalCatalog *catalog = new LogJournalCatalog(qApp);
+    return catalog;
+}
+
+const char *LogJournalCatalog::fieldName(Field field)
+{
+    switch (field) {
+    case Unit:
+        return "_SYSTEMD_UNIT";
+    case Identifier:
+        return "SYSLOG_IDENTIFIER";
+    case Command:
+        return "_COMM";
+    default:
+        return "";
+    }
+}
+
+/**
+ * @brief LogJournalCatalog::query 同步枚举所有字段的值,不访问成员,在线程池中执行
+ */
+LogJournalCatalogData LogJournalCatalog::query()
+{
+    LogJournalCatalogData data;
+    data.units = JournalReaderBase::uniqueValues(fieldName(Unit), LOG_JOURNAL_CATALOG_LIMIT);
+    data.identifiers = JournalReaderBase::uniqueValues(fieldName(Identifier), LOG_JOURNAL_CATALOG_LIMIT);
+    data.commands = JournalReaderBase::uniqueValues(fieldName(Command), LOG_JOURNAL_CATALOG_LIMIT);
+    data.time = QDateTime::currentMSecsSinceEpoch();
+    return data;
+}
+
+/**
+ * @brief LogJournalCatalog::match 字段取值对应的journalctl写法的匹配参数
+ * @return "FIELD=value",值为空时为空
+ */
+QString LogJournalCatalog::match(Field field, const QString &value)
+{
+    if (value.isEmpty() || field < 0 || field >= FieldCount)
+        return QString();
+    return QString("%1=%2").arg(QLatin1String(fieldName(field)), value);
+}
+
+/**
+ * @brief LogJournalCatalog::applyMatch 把一个字段匹配和搜索条件下推的匹配参数求与
+ * 匹配参数为析取范式,"+"分隔各项,字段匹配需要加入每一项,否则会放宽其他项
+ * @param matchArgs LogQuery::journalMatches的结果,可以为空
+ * @param match 字段匹配,为空时原样返回
+ */
+QStringList LogJournalCatalog::applyMatch(const QStringList &matchArgs, const QString &match)
+{
+    if (match.isEmpty())
+        return matchArgs;
+    if (matchArgs.isEmpty())
+        return QStringList() << match;
+    QStringList args;
+    for (const QString &arg : matchArgs) {
+        if (arg == "+")
+            args << match;
+        args << arg;
+    }
+    args << match;
+    return args;
+}
+
+QStringList LogJournalCatalog::values(Field field) const
+{
+    switch (field) {
+    case Unit:
+        return m_data.units;
+    case Identifier:
+        return m_data.identifiers;
+    case Command:
+        return m_data.commands;
+    default:
+        return QStringList();
+    }
+}
+
+/**
+ * @brief LogJournalCatalog::refresh 目录还没有枚举过或已过期时在后台重新枚举,完成后发出catalogChanged
+ * @param force 不论是否过期都重新枚举,如刷新按钮
+ */
+void LogJournalCatalog::refresh(bool force)
+{
+    if (m_watcher.isRunning())
+        return;
+    if (!force && isLoaded() && QDateTime::currentMSecsSinceEpoch() - m_data.time < LOG_JOURNAL_CATALOG_TTL)
+        return;
+    m_watcher.setFuture(LogWorkScheduler::instance()->run(LogWorkScheduler::Prefetch, &LogJournalCatalog::query));
+}
+
+void LogJournalCatalog::onQueryFinished()
+{
+    if (m_watcher.isCanceled())
+        return;
+    m_data = m_watcher.result();
+    qCDebug(logJournalCatalog) << "journal catalog:" << m_data.units.size() << "units," << m_data.identifiers.size()
+                               << "identifiers," << m_data.commands.size() << "commands";
+    emit catalogChanged();
+}
+
+/**
+ * @brief LogJournalCatalog::refreshBoots 启动列表还没有枚举过或已过期时在后台重新枚举,完成后发出bootsChanged
+ * 每次启动要定位首尾两条日志,启动次数多时耗时较长,不能在界面线程中进行
+ * @param force 不论是否过期都重新枚举
+ */
+void LogJournalCatalog::refreshBoots(bool force)
+{
+    if (m_bootWatcher.isRunning())
+        return;
+    if (!force && isBootsLoaded() && QDateTime::currentMSecsSinceEpoch() - m_bootsTime < LOG_JOURNAL_CATALOG_TTL)
+        return;
+    m_bootWatcher.setFuture(LogWorkScheduler::instance()->run(LogWorkScheduler::Prefetch, &JournalReaderBase::bootCatalog));
+}
+
+void LogJournalCatalog::onBootsFinished()
+{
+    if (m_bootWatcher.isCanceled())
+        return;
+    m_boots = m_bootWatcher.result();
+    m_bootsTime = QDateTime::currentMSecsSinceEpoch();
+    qCDebug(logJournalCatalog) << "journal boot catalog:" << m_boots.size() << "boots";
+    emit bootsChanged();
+}
@@ -0,0 +1,84 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGJOURNALCATALOG_H
+#define LOGJOURNALCATALOG_H
+
+#include "journalreader.h"
+
+#include <QFutureWatcher>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+
+//每个字段最多列出的值数,超过时只列出按字母排序的前这么多个
+#define LOG_JOURNAL_CATALOG_LIMIT 1000
+//目录的有效时间,毫秒,超过后先显示旧的目录,同时在后台重新枚举
+#define LOG_JOURNAL_CATALOG_TTL (5 * 60 * 1000)
+
+/**
+ * @brief The LogJournalCatalogData struct 一次枚举得到的各字段的值
+ */
+struct LogJournalCatalogData {
+    QStringList units;
+    QStringList identifiers;
+    QStringList commands;
+    //枚举完成的时间,毫秒时间戳,0表示还没有枚举过
+    qint64 time = 0;
+};
+
+/**
+ * @brief The LogJournalCatalog class 系统日志中服务单元、标识符和进程名的取值目录,用于筛选下拉框
+ * 通过sd_journal_query_unique只读取字段的数据对象,不遍历日志;结果缓存在内存中,过期后在后台刷新,
+ * 刷新完成时发出catalogChanged。选中的值转换为"FIELD=value"的journal匹配,读取时只取该来源的日志。
+ * 启动列表(klu启动日志的下拉框)同样在后台枚举并缓存,完成时发出bootsChanged,界面线程不再扫描journal
+ */
+class LogJournalCatalog : public QObject
+{
+    Q_OBJECT
+public:
+    enum Field {
+        //_SYSTEMD_UNIT
+        Unit,
+        //SYSLOG_IDENTIFIER
+        Identifier,
+        //_COMM
+        Command,
+        FieldCount
+    };
+
+    static LogJournalCatalog *instance();
+
+    static const char *fieldName(Field field);
+    static LogJournalCatalogData query();
+    static QString match(Field field, const QString &value);
+    static QStringList applyMatch(const QStringList &matchArgs, const QString &match);
+
+    QStringList values(Field field) const;
+    bool isLoaded() const { return m_data.time > 0; }
+    void refresh(bool force = false);
+    bool isRunning() const { return m_watcher.isRunning(); }
+
+    QList<JournalBootInfo> boots() const { return m_boots; }
+    bool isBootsLoaded() const { return m_bootsTime > 0; }
+    void refreshBoots(bool force = false);
+
+signals:
+    void catalogChanged();
+    void bootsChanged();
+
+private:
+    explicit LogJournalCatalog(QObject *parent = nullptr);
+    void onQueryFinished();
+    void onBootsFinished();
+
+    QFutureWatcher<LogJournalCatalogData> m_watcher;
+    LogJournalCatalogData m_data;
+    QFutureWatcher<QList<JournalBootInfo>> m_bootWatcher;
+    QList<JournalBootInfo> m_boots;
+    //启动列表枚举完成的时间,毫秒时间戳,0表示还没有枚举过
+    qint64 m_bootsTime = 0;
+};
+
+#endif // LOGJOURNALCATALOG_H
@@ -0,0 +1,283 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logkmsgreader.h"
+
+#include <QLoggingCategory>
+
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifdef QT_DEBUG
+Q_LOGGING_CATEGORY(logKmsgReader, "org.deepin.log.viewer.kmsg.reader")
+#else
+Q_LOGGING_CATEGORY(logKmsgReader, "org.deepin.log.viewer.kmsg.reader", QtInfoMsg)
+#endif
+
+LogKmsgReader::LogKmsgReader()
+{
+}
+
+LogKmsgReader::~LogKmsgReader()
+{
+    close();
+}
+
+/**
+ * @brief LogKmsgReader::open 打开内核环形缓冲区,非阻塞读取
+ * @param position 起始位置
+ * @param device 设备路径
+ * @return 是否打开成功,没有权限(kernel.dmesg_restrict)时失败
+ */
+bool LogKmsgReader::open(StartPosition position, const QString &device)
+{
+    close();
+    m_fd = ::open(device.toLocal8Bit().constData(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    if (m_fd < 0) {
+        m_errorString = QString::fromLocal8Bit(strerror(errno));
+        qCDebug(logKmsgReader) << "open" << device << "failed:" << m_errorString;
+        return false;
+    }
+    //SEEK_DATA定位到上次清空之后的第一条记录,SEEK_END定位到下一条新记录
+    if (lseek(m_fd, 0, position == FromOldest ? SEEK_DATA : SEEK_END) < 0)
+        qCDebug(logKmsgReader) << "seek" << device << "failed:" << strerror(errno);
+    m_lastSequence = 0;
+    return true;
+}
+
+void LogKmsgReader::close()
+{
+    if (m_fd >= 0) {
+        ::close(m_fd);
+        m_fd = -1;
+    }
+}
+
+bool LogKmsgReader::isOpen() const
+{
+    return m_fd >= 0;
+}
+
+/**
+ * @brief LogKmsgReader::readRecord 读取下一条记录
+ * @param record 输出参数,读到的记录
+ * @return 是否读到了记录,false表示当前没有更多记录或出错
+ */
+bool LogKmsgReader::readRecord(LogKmsgRecord &record)
+{
+    m_errorString.clear();
+    if (m_fd < 0)
+        return false;
+
+    char buffer[KMSG_RECORD_MAX];
+    while (true) {
+        ssize_t size = ::read(m_fd, buffer, sizeof(buffer) - 1);
+        if (size < 0) {
+            //读取过程中最早的记录被覆盖,跳到下一条继续读
+            if (errno == EPIPE)
+                continue;
+            if (errno == EINTR)
+                continue;
+            if (errno != EAGAIN)
+                m_errorString = QString::fromLocal8Bit(strerror(errno));
+            return false;
+        }
+        if (size == 0)
+            return false;
+        if (!parseRecord(buffer, static_cast<int>(size), record))
+            continue;
+        m_lastSequence = record.sequence;
+        return true;
+    }
+}
+
+/**
+ * @brief LogKmsgReader::waitForRecord 等待新记录
+ * @param msecs 超时时间,毫秒
+ * @return 是否有新记录可读
+ */
+bool LogKmsgReader::waitForRecord(int msecs)
+{
+    if (m_fd < 0)
+        return false;
+    struct pollfd pfd;
+    pfd.fd = m_fd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    int r = poll(&pfd, 1, msecs);
+    return r > 0 && (pfd.revents & POLLIN);
+}
+
+/**
+ * @brief LogKmsgReader::follow 跟踪新产生的内核记录,直到被停止
+ * @param afterSequence 已读取到的最后一条记录的序号,只交出其后的记录
+ * @param canRun 是否继续
+ * @param callback 每条新记录的回调
+ * @return 被停止时返回-ECANCELED,出错时返回负的错误码
+ */
+int LogKmsgReader::follow(quint64 afterSequence, const std::atomic_bool &canRun, const std::function<void(const LogKmsgRecord &)> &callback)
+{
+    if (m_fd < 0)
+        return -EBADF;
+
+    LogKmsgRecord record;
+    while (canRun) {
+        if (readRecord(record)) {
+            if (record.sequence > afterSequence)
+                callback(record);
+            continue;
+        }
+        if (!m_errorString.isEmpty())
+            return -EIO;
+        waitForRecord(KMSG_FOLLOW_TIMEOUT);
+    }
+    return -ECANCELED;
+}
+
+/**
+ * @brief LogKmsgReader::lastSequence 最后读到的记录的序号
+ * @return 序号
+ */
+quint64 LogKmsgReader::lastSequence() const
+{
+    return m_lastSequence;
+}
+
+QString LogKmsgReader::errorString() const
+{
+    return m_errorString;
+}
+
+/**
+ * @brief LogKmsgReader::bootMSecs 开机时刻的毫秒时间戳,每次加载计算一次,记录的时间加上它即为当地时间
+ * kmsg的时间和CLOCK_MONOTONIC一致,不包括休眠的时间,加载和实时跟踪都按同一个时刻换算
+ */
+qint64 LogKmsgReader::bootMSecs()
+{
+    struct timespec realtime;
+    struct timespec monotonic;
+    clock_gettime(CLOCK_REALTIME, &realtime);
+    clock_gettime(CLOCK_MONOTONIC, &monotonic);
+    return (static_cast<qint64>(realtime.tv_sec) - monotonic.tv_sec) * 1000 + (realtime.tv_nsec - monotonic.tv_nsec) / 1000000;
+}
+
+/**
+ * @brief LogKmsgReader::textTimestamp dmesg -r输出的一行"<6>[   12.345678] ..."中开机以来的时间
+ * 直接按字符转换整数和小数部分,不经过正则和浮点数
+ * @return 微秒,不是以等级和时间开头的行(续行)返回-1
+ */
+qint64 LogKmsgReader::textTimestamp(const QByteArray &line)
+{
+    const char *p = line.constData();
+    const char *end = p + line.size();
+    if (p == end || *p != '<')
+        return -1;
+    p = static_cast<const char *>(memchr(p, '[', static_cast<size_t>(end - p)));
+    if (!p)
+        return -1;
+    ++p;
+    while (p < end && *p == ' ')
+        ++p;
+    const bool negative = p < end && *p == '-';
+    if (p < end && (*p == '+' || *p == '-'))
+        ++p;
+    if (p == end || !isdigit(static_cast<unsigned char>(*p)))
+        return -1;
+    qint64 secs = 0;
+    for (; p < end && isdigit(static_cast<unsigned char>(*p)); ++p)
+        secs = secs * 10 + (*p - '0');
+    qint64 usecs = 0;
+    if (p < end && *p == '.') {
+        ++p;
+        int digits = 0;
+        for (; p < end && isdigit(static_cast<unsigned char>(*p)); ++p) {
+            if (digits < 6) {
+                usecs = usecs * 10 + (*p - '0');
+                ++digits;
+            }
+        }
+        for (; digits < 6; ++digits)
+            usecs *= 10;
+    }
+    if (p == end || *p != ']')
+        return -1;
+    //开机前的负时间和0一样排在最前面
+    return negative ? 0 : secs * 1000000 + usecs;
+}
+
+/**
+ * @brief LogKmsgReader::parseRecord 解析一条"prio,seq,ts,flags[,...];message\n[ KEY=VALUE\n...]"格式的记录
+ * @param data 记录数据
+ * @param length 数据长度
+ * @param record 输出参数,解析结果
+ * @return 格式是否正确
+ */
+bool LogKmsgReader::parseRecord(const char *data, int length, LogKmsgRecord &record)
+{
+    const char *end = data + length;
+    const char *header = static_cast<const char *>(memchr(data, ';', static_cast<size_t>(length)));
+    if (header == nullptr)
+        return false;
+
+    //头部的前三个字段依次为prio,seq,ts,均为十进制数字
+    quint64 fields[3] = {0, 0, 0};
+    int field = 0;
+    bool hasDigit = false;
+    for (const char *p = data; p < header && field < 3; ++p) {
+        if (*p >= '0' && *p <= '9') {
+            fields[field] = fields[field] * 10 + static_cast<quint64>(*p - '0');
+            hasDigit = true;
+        } else if (*p == ',') {
+            if (!hasDigit)
+                return false;
+            ++field;
+            hasDigit = false;
+        } else {
+            return false;
+        }
+    }
+    if (field < 2 || (field == 2 && !hasDigit))
+        return false;
+
+    record.level = static_cast<int>(fields[0] & 7);
+    record.facility = static_cast<int>(fields[0] >> 3);
+    record.sequence = fields[1];
+    record.timestamp = fields[2];
+
+    //内容到第一个换行为止,后面以空格开头的行是设备信息等附加字段
+    const char *message = header + 1;
+    const char *newline = static_cast<const char *>(memchr(message, '\n', static_cast<size_t>(end - message)));
+    record.message = decodeMessage(message, static_cast<int>((newline ? newline : end) - message));
+    return true;
+}
+
+/**
+ * @brief LogKmsgReader::decodeMessage 解码内核对不可打印字符的\xNN转义
+ * @param data 内容
+ * @param length 长度
+ * @return 解码后的内容
+ */
+QString LogKmsgReader::decodeMessage(const char *data, int length)
+{
+    if (memchr(data, '\\', static_cast<size_t>(length)) == nullptr)
+        return QString::fromUtf8(data, length);
+
+    QByteArray decoded;
+    decoded.reserve(length);
+    for (int i = 0; i < length; ++i) {
+        if (data[i] == '\\' && i + 3 < length && data[i + 1] == 'x' && isxdigit(static_cast<unsigned char>(data[i + 2]))
+                && isxdigit(static_cast<unsigned char>(data[i + 3]))) {
+            decoded.append(static_cast<char>(QByteArray(data + i + 2, 2).toInt(nullptr, 16)));
+            i += 3;
+        } else {
+            decoded.append(data[i]);
+        }
+    }
+    return QString::fromUtf8(decoded);
+}
@@ -0,0 +1,111 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGKMSGREADER_H
+#define LOGKMSGREADER_H
+
+#include <QByteArray>
+#include <QString>
+
+#include <atomic>
+#include <functional>
+
+#define KMSG_DEVICE "/dev/kmsg"
+//内核单条记录不超过8K,和dmesg的缓冲区一致
+#define KMSG_RECORD_MAX 8192
+//跟踪模式下等待新记录的超时,超时后检查是否被停止
+#define KMSG_FOLLOW_TIMEOUT 500
+
+/**
+ * @brief The LogKmsgRecord struct /dev/kmsg中的一条记录
+ */
+struct LogKmsgRecord {
+    //等级 0-7
+    int level = 0;
+    //设施
+    int facility = 0;
+    //序号,内核中单调递增
+    quint64 sequence = 0;
+    //开机以来的时间,微秒
+    quint64 timestamp = 0;
+    //内容,已解码\xNN转义
+    QString message;
+};
+
+/**
+ * @brief The LogKmsgReader class 直接读取/dev/kmsg中的内核环形缓冲区
+ * 每次read得到一条"prio,seq,ts,flags;message"格式的结构化记录,不需要启动dmesg进程也不需要正则
+ */
+class LogKmsgReader
+{
+public:
+    enum StartPosition {
+        //从缓冲区中最早的记录开始(上次清空之后),和dmesg一致
+        FromOldest,
+        //只读取打开之后新产生的记录
+        FromEnd
+    };
+
+    LogKmsgReader();
+    ~LogKmsgReader();
+
+    bool open(StartPosition position = FromOldest, const QString &device = KMSG_DEVICE);
+    void close();
+    bool isOpen() const;
+    bool readRecord(LogKmsgRecord &record);
+    bool waitForRecord(int msecs);
+    int follow(quint64 afterSequence, const std::atomic_bool &canRun, const std::function<void(const LogKmsgRecord &)> &callback);
+    quint64 lastSequence() const;
+    QString errorString() const;
+
+    static bool parseRecord(const char *data, int length, LogKmsgRecord &record);
+    static qint64 bootMSecs();
+    static qint64 textTimestamp(const QByteArray &line);
+    template <typename TimestampOf>
+    static int lowerBound(int count, qint64 since, TimestampOf timestampOf);
+
+private:
+    Q_DISABLE_COPY(LogKmsgReader)
+
+    static QString decodeMessage(const char *data, int length);
+
+    int m_fd = -1;
+    quint64 m_lastSequence = 0;
+    QString m_errorString;
+};
+
+/**
+ * @brief LogKmsgReader::lowerBound 在按时间递增的记录中二分查找第一条不早于since的记录
+ * 环形缓冲区中的时间随序号单调递增,按时间段筛选时只需找到起点,不必逐条转换时间
+ * @param count 记录数
+ * @param since 开机以来的时间,微秒
+ * @param timestampOf 第i条记录开机以来的时间(微秒),没有时间的记录(dmesg输出的续行)返回-1
+ * @return 起点下标,都早于since时为count
+ */
+template <typename TimestampOf>
+int LogKmsgReader::lowerBound(int count, qint64 since, TimestampOf timestampOf)
+{
+    int lo = 0;
+    int hi = count;
+    while (lo < hi) {
+        const int mid = lo + (hi - lo) / 2;
+        //从mid向后找到第一条有时间的记录,续行跟随前面的记录
+        int stamped = mid;
+        qint64 time = -1;
+        for (; stamped < hi; ++stamped) {
+            time = timestampOf(stamped);
+            if (time >= 0)
+                break;
+        }
+        if (stamped >= hi)
+            hi = mid;
+        else if (time < since)
+            lo = stamped + 1;
+        else
+            hi = stamped;
+    }
+    return lo;
+}
+
+#endif // LOGKMSGREADER_H
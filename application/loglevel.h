@@ -0,0 +1,137 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGLEVEL_H
+#define LOGLEVEL_H
+
+#include "structdef.h"
+
+#include <QCoreApplication>
+#include <QString>
+#include <QStringList>
+#include <QStringRef>
+
+/**
+ * @brief The LogLevel class 日志等级的数字编码和显示文本
+ * 记录中只保存等级数字:系统、内核、启动、dmesg和应用日志为PRIORITY,dnf日志为DNFPRIORITY,没有等级时为-1(dnf为DNFINVALID)。
+ * 读取、筛选和排序都只比较数字,显示文字只在模型、导出和搜索时按下标查表,翻译在第一次使用时做一次
+ */
+class LogLevel
+{
+public:
+    //syslog等级数
+    static constexpr int SyslogCount = DEB + 1;
+    //dnf等级数,从TRACE开始
+    static constexpr int DnfCount = SUPERCRITICAL - TRACE + 1;
+
+    //syslog等级的英文名,下标为PRIORITY,翻译上下文为"Level"
+    static constexpr const char *syslogNames[SyslogCount] = {
+        QT_TRANSLATE_NOOP("Level", "Emergency"), QT_TRANSLATE_NOOP("Level", "Alert"), QT_TRANSLATE_NOOP("Level", "Critical"),
+        QT_TRANSLATE_NOOP("Level", "Error"), QT_TRANSLATE_NOOP("Level", "Warning"), QT_TRANSLATE_NOOP("Level", "Notice"),
+        QT_TRANSLATE_NOOP("Level", "Info"), QT_TRANSLATE_NOOP("Level", "Debug")
+    };
+    //dnf等级的英文名,下标为DNFPRIORITY - TRACE
+    static constexpr const char *dnfNames[DnfCount] = {
+        QT_TRANSLATE_NOOP("Level", "Trace"), QT_TRANSLATE_NOOP("Level", "Debug"), QT_TRANSLATE_NOOP("Level", "Debug"),
+        QT_TRANSLATE_NOOP("Level", "Debug"), QT_TRANSLATE_NOOP("Level", "Info"), QT_TRANSLATE_NOOP("Level", "Warning"),
+        QT_TRANSLATE_NOOP("Level", "Error"), QT_TRANSLATE_NOOP("Level", "Critical"), QT_TRANSLATE_NOOP("Level", "Super critical")
+    };
+    //dnf等级对应的syslog等级,用于ndjson中的priority,没有对应时为-1
+    static constexpr int dnfSyslog[DnfCount] = {-1, DEB, DEB, DEB, INF, WARN, ERR, CRI, -1};
+
+    /**
+     * @brief text syslog等级翻译后的显示文字,不在范围内时为空
+     */
+    static QString text(int level)
+    {
+        static const QStringList texts = translate(syslogNames, SyslogCount);
+        return level >= 0 && level < SyslogCount ? texts.at(level) : QString();
+    }
+
+    /**
+     * @brief dnfText dnf等级翻译后的显示文字,不在范围内时为空
+     */
+    static QString dnfText(int level)
+    {
+        static const QStringList texts = translate(dnfNames, DnfCount);
+        return level >= TRACE && level <= SUPERCRITICAL ? texts.at(level - TRACE) : QString();
+    }
+
+    /**
+     * @brief fromName 应用日志行中的英文等级名(如"Warning")转换为syslog等级,不认识时返回-1
+     */
+    static int fromName(const QStringRef &name)
+    {
+        for (int i = 0; i < SyslogCount; ++i) {
+            if (name == QLatin1String(syslogNames[i]))
+                return i;
+        }
+        return -1;
+    }
+
+    /**
+     * @brief fromText 英文或翻译后的syslog等级文字转换为等级数字,不认识时返回-1
+     */
+    static int fromText(const QString &text)
+    {
+        const int level = fromName(QStringRef(&text));
+        if (level >= 0)
+            return level;
+        for (int i = 0; i < SyslogCount; ++i) {
+            if (text == LogLevel::text(i))
+                return i;
+        }
+        return -1;
+    }
+
+    /**
+     * @brief fromDnfName dnf日志中的等级名(如"WARNING")转换为DNFPRIORITY,不认识时返回DNFINVALID
+     * 先按长度和首字母确定唯一的候选,每行最多比较一次字符串
+     */
+    static int fromDnfName(const QStringRef &name)
+    {
+        //dnf日志中的写法和对应的等级,SUBDEBUG和DDEBUG按DEBUG处理
+        static const struct {
+            const char *name;
+            DNFPRIORITY level;
+        } dnfLogNames[] = {{"TRACE", TRACE}, {"SUBDEBUG", DEBUG}, {"DDEBUG", DEBUG}, {"DEBUG", DEBUG}, {"INFO", INFO},
+                           {"WARNING", WARNING}, {"ERROR", ERROR}, {"CRITICAL", CRITICAL}, {"SUPERCRITICAL", SUPERCRITICAL}};
+        const QChar first = name.isEmpty() ? QChar() : name.at(0);
+        int index = -1;
+        switch (name.size()) {
+        case 4:
+            index = 4;
+            break;
+        case 5:
+            index = first == 'T' ? 0 : (first == 'D' ? 3 : 6);
+            break;
+        case 6:
+            index = 2;
+            break;
+        case 7:
+            index = 5;
+            break;
+        case 8:
+            index = first == 'S' ? 1 : 7;
+            break;
+        case 13:
+            index = 8;
+            break;
+        default:
+            return DNFINVALID;
+        }
+        return name == QLatin1String(dnfLogNames[index].name) ? dnfLogNames[index].level : DNFINVALID;
+    }
+
+private:
+    static QStringList translate(const char *const names[], int count)
+    {
+        QStringList texts;
+        for (int i = 0; i < count; ++i)
+            texts.append(QCoreApplication::translate("Level", names[i]));
+        return texts;
+    }
+};
+
+#endif // LOGLEVEL_H
@@ -0,0 +1,210 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "loglinefilter.h"
+
+#include <QDate>
+#include <QDateTime>
+
+#include <ctype.h>
+#include <string.h>
+
+namespace {
+//从p开始读取count位十进制数字,不足时返回-1
+int readNumber(const char *p, int count)
+{
+    int value = 0;
+    for (int i = 0; i < count; ++i) {
+        if (!isdigit(static_cast<unsigned char>(p[i])))
+            return -1;
+        value = value * 10 + (p[i] - '0');
+    }
+    return value;
+}
+
+//"hh:mm:ss"
+bool readTime(const char *p, int length, QTime &time)
+{
+    if (length < 8 || p[2] != ':' || p[5] != ':')
+        return false;
+    time = QTime(readNumber(p, 2), readNumber(p + 3, 2), readNumber(p + 6, 2));
+    return time.isValid();
+}
+}
+
+/**
+ * @brief LogLineFilter::isEmpty 是否没有任何筛选条件
+ */
+bool LogLineFilter::isEmpty() const
+{
+    return !(timeBegin > 0 && timeEnd > 0) && levels.isEmpty() && keyword.isEmpty();
+}
+
+/**
+ * @brief LogLineFilter::matches 行是否满足筛选条件
+ * @param line 一行日志
+ * @return 是否匹配,取不到时间的行不按时间筛选
+ */
+bool LogLineFilter::matches(const QByteArray &line) const
+{
+    if (timeBegin > 0 && timeEnd > 0) {
+        qint64 time = lineTime(line);
+        if (time >= 0 && (time < timeBegin || time > timeEnd))
+            return false;
+    }
+    if (!levels.isEmpty()) {
+        bool found = false;
+        for (const QString &level : levels) {
+            if (containsWord(line, level.toUtf8())) {
+                found = true;
+                break;
+            }
+        }
+        if (!found)
+            return false;
+    }
+    if (!keyword.isEmpty()) {
+        //大多数行是ASCII,直接在字节上匹配,不再把每一行转换为QString
+        if (m_keywordMatcher.keyword() != keyword)
+            m_keywordMatcher = LogUtf8Matcher(keyword);
+        if (!m_keywordMatcher.matches(line))
+            return false;
+    }
+    return true;
+}
+
+/**
+ * @brief LogLineFilter::matchesTime 只按行首的时间判断,本地解析时在拆分字段之前跳过时间范围外的行
+ * @param line 一行日志
+ * @return 是否在时间范围内,没有时间条件或取不到时间时返回true
+ */
+bool LogLineFilter::matchesTime(const QString &line) const
+{
+    if (!(timeBegin > 0 && timeEnd > 0))
+        return true;
+    const qint64 time = prefixTime(line);
+    return time < 0 || (time >= timeBegin && time <= timeEnd);
+}
+
+/**
+ * @brief LogLineFilter::prefixTime 只转换行首LINE_TIME_PREFIX_SIZE个字符取时间,规则同lineTime
+ */
+qint64 LogLineFilter::prefixTime(const QString &line)
+{
+    return lineTime(line.leftRef(LINE_TIME_PREFIX_SIZE).toLatin1());
+}
+
+QVariantMap LogLineFilter::toVariantMap() const
+{
+    QVariantMap map;
+    if (timeBegin > 0 && timeEnd > 0) {
+        map.insert("timeBegin", timeBegin);
+        map.insert("timeEnd", timeEnd);
+    }
+    if (!levels.isEmpty())
+        map.insert("levels", levels);
+    if (!keyword.isEmpty())
+        map.insert("keyword", keyword);
+    return map;
+}
+
+/**
+ * @brief LogLineFilter::timeRange 只按时间范围筛选
+ * @param begin 开始时间,毫秒
+ * @param end 结束时间,毫秒
+ */
+LogLineFilter LogLineFilter::timeRange(qint64 begin, qint64 end)
+{
+    LogLineFilter filter;
+    filter.timeBegin = begin;
+    filter.timeEnd = end;
+    return filter;
+}
+
+/**
+ * @brief LogLineFilter::fromVariantMap 从DBus传来的筛选条件构造,不认识的键忽略
+ * @param map 筛选条件,键为timeBegin/timeEnd/levels/keyword
+ */
+LogLineFilter LogLineFilter::fromVariantMap(const QVariantMap &map)
+{
+    LogLineFilter filter;
+    filter.timeBegin = map.value("timeBegin", -1).toLongLong();
+    filter.timeEnd = map.value("timeEnd", -1).toLongLong();
+    filter.levels = map.value("levels").toStringList();
+    filter.keyword = map.value("keyword").toString();
+    return filter;
+}
+
+/**
+ * @brief LogLineFilter::lineTime 取行首的时间,和应用解析各类日志的规则一致
+ * 支持audit的"msg=audit(秒.毫秒:序号)"、"yyyy-MM-dd hh:mm:ss"(dpkg、带年份的kern)和
+ * 没有年份的syslog格式"MMM d hh:mm:ss"(按当前年份)
+ * @param line 一行日志
+ * @return 当地时间的毫秒数,取不到时返回-1
+ */
+qint64 LogLineFilter::lineTime(const QByteArray &line)
+{
+    const char *data = line.constData();
+    const int length = line.size();
+
+    int audit = line.indexOf("msg=audit(");
+    if (audit >= 0) {
+        qint64 secs = 0;
+        bool hasDigit = false;
+        for (int i = audit + 10; i < length && isdigit(static_cast<unsigned char>(data[i])); ++i) {
+            secs = secs * 10 + (data[i] - '0');
+            hasDigit = true;
+        }
+        return hasDigit ? secs * 1000 : -1;
+    }
+
+    QTime time;
+    if (length >= 19 && data[4] == '-' && data[7] == '-' && (data[10] == ' ' || data[10] == 'T')) {
+        QDate date(readNumber(data, 4), readNumber(data + 5, 2), readNumber(data + 8, 2));
+        if (!date.isValid() || !readTime(data + 11, length - 11, time))
+            return -1;
+        return QDateTime(date, time).toMSecsSinceEpoch();
+    }
+
+    //"Sep 29 15:53:34"或"Sep  9 15:53:34"
+    static const char months[] = "JanFebMarAprMayJunJulAugSepOctNovDec";
+    if (length < 15 || data[3] != ' ')
+        return -1;
+    const char *month = static_cast<const char *>(memmem(months, 36, data, 3));
+    if (month == nullptr || (month - months) % 3 != 0)
+        return -1;
+    int pos = 4;
+    while (pos < length && data[pos] == ' ')
+        ++pos;
+    int day = 0;
+    while (pos < length && isdigit(static_cast<unsigned char>(data[pos])))
+        day = day * 10 + (data[pos++] - '0');
+    if (pos >= length || data[pos] != ' ' || !readTime(data + pos + 1, length - pos - 1, time))
+        return -1;
+    QDate date(QDate::currentDate().year(), static_cast<int>(month - months) / 3 + 1, day);
+    if (!date.isValid())
+        return -1;
+    return QDateTime(date, time).toMSecsSinceEpoch();
+}
+
+/**
+ * @brief LogLineFilter::containsWord 行中是否有以非字母数字字符为界的word,不区分大小写
+ */
+bool LogLineFilter::containsWord(const QByteArray &line, const QByteArray &word)
+{
+    if (word.isEmpty())
+        return true;
+    const QByteArray lower = line.toLower();
+    const QByteArray needle = word.toLower();
+    int from = 0;
+    while ((from = lower.indexOf(needle, from)) >= 0) {
+        int end = from + needle.size();
+        bool leftOk = from == 0 || !isalnum(static_cast<unsigned char>(lower.at(from - 1)));
+        bool rightOk = end >= lower.size() || !isalnum(static_cast<unsigned char>(lower.at(end)));
+        if (leftOk && rightOk)
+            return true;
+        from = end;
+    }
+    return false;
+}
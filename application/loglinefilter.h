@@ -0,0 +1,49 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGLINEFILTER_H
+#define LOGLINEFILTER_H
+
+#include "logutf8view.h"
+
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+#include <QVariantMap>
+
+//按时间预筛时只转换行首这么多字符
+#define LINE_TIME_PREFIX_SIZE 64
+
+/**
+ * @brief The LogLineFilter struct 文本日志的行筛选条件,应用和提权服务共用
+ * 服务端在倒序通道中按该条件丢弃不匹配的行,只有匹配的行经过DBus;
+ * 取不到时间的行(如多行记录的续行)总是保留,由调用者按记录再次筛选
+ */
+struct LogLineFilter {
+    //时间范围,毫秒,两者都大于0时生效
+    qint64 timeBegin = -1;
+    qint64 timeEnd = -1;
+    //等级,行中出现任意一个(整词,不区分大小写)即匹配,为空表示不筛选
+    QStringList levels;
+    //关键字,不区分大小写,为空表示不筛选
+    QString keyword;
+
+    bool isEmpty() const;
+    bool matches(const QByteArray &line) const;
+    bool matchesTime(const QString &line) const;
+    QVariantMap toVariantMap() const;
+
+    static LogLineFilter timeRange(qint64 begin, qint64 end);
+    static LogLineFilter fromVariantMap(const QVariantMap &map);
+    static qint64 lineTime(const QByteArray &line);
+    static qint64 prefixTime(const QString &line);
+
+private:
+    //keyword的匹配器,第一次按关键字筛选时建立,keyword改变后重新建立;因此同一筛选条件不能在多个线程中同时调用matches
+    mutable LogUtf8Matcher m_keywordMatcher;
+
+    static bool containsWord(const QByteArray &line, const QByteArray &word);
+};
+
+#endif // LOGLINEFILTER_H
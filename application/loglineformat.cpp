@@ -0,0 +1,493 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "loglineformat.h"
+#include "loglocaltime.h"
+#include "structdef.h"
+
+#include <QDate>
+#include <QTime>
+#include <QVarLengthArray>
+
+#include <algorithm>
+
+namespace {
+bool isDigit(const QChar &c)
+{
+    return c.unicode() >= '0' && c.unicode() <= '9';
+}
+
+bool isSpace(const QChar &c)
+{
+    const ushort u = c.unicode();
+    return u == ' ' || (u >= '\t' && u <= '\r');
+}
+
+bool isAsciiLetter(const QChar &c)
+{
+    const ushort u = c.unicode();
+    return (u >= 'A' && u <= 'Z') || (u >= 'a' && u <= 'z');
+}
+
+/**
+ * @brief readDigits 从pos开始读取minDigits到maxDigits位数字
+ * @return 读到的位数,少于minDigits时为0
+ */
+int readDigits(const QString &line, int pos, int minDigits, int maxDigits, qint64 &value)
+{
+    value = 0;
+    int count = 0;
+    while (count < maxDigits && pos + count < line.size() && isDigit(line.at(pos + count))) {
+        value = value * 10 + (line.at(pos + count).unicode() - '0');
+        ++count;
+    }
+    return count >= minDigits ? count : 0;
+}
+
+int monthOf(const QStringRef &name)
+{
+    static const char *const months[] = {"jan", "feb", "mar", "apr", "may", "jun", "jul", "aug", "sep", "oct", "nov", "dec"};
+    for (int i = 0; i < 12; ++i) {
+        if (name.compare(QLatin1String(months[i]), Qt::CaseInsensitive) == 0)
+            return i + 1;
+    }
+    return 0;
+}
+}
+
+/**
+ * @brief LogLineFormat::compile 编译格式说明
+ * @param spec 格式说明,见类说明
+ * @param error 不为空时写入编译失败的原因
+ * @return 编译结果,格式说明无效时为空
+ */
+LogLineFormatPtr LogLineFormat::compile(const QString &spec, QString *error)
+{
+    std::shared_ptr<LogLineFormat> format(new LogLineFormat);
+    format->m_spec = spec;
+    format->m_defaultYear = QDate::currentDate().year();
+    if (!format->compileSteps(error))
+        return LogLineFormatPtr();
+    return format;
+}
+
+bool LogLineFormat::compileSteps(QString *error)
+{
+    auto fail = [error](const QString &reason) {
+        if (error)
+            *error = reason;
+        return false;
+    };
+    auto addStep = [this](Step::Kind kind, const QString &text = QString()) {
+        Step step;
+        step.kind = kind;
+        step.text = text;
+        m_steps.append(step);
+    };
+
+    QString literal;
+    auto flushLiteral = [&literal, &addStep]() {
+        if (!literal.isEmpty())
+            addStep(Step::Literal, literal);
+        literal.clear();
+    };
+    bool hasMessage = false;
+    for (int i = 0; i < m_spec.size(); ++i) {
+        const QChar c = m_spec.at(i);
+        if (isSpace(c)) {
+            flushLiteral();
+            if (m_steps.isEmpty() || m_steps.last().kind != Step::Space)
+                addStep(Step::Space);
+            continue;
+        }
+        if (c != '%' || i + 1 >= m_spec.size()) {
+            literal.append(c);
+            continue;
+        }
+        if (m_spec.at(i + 1) == '%') {
+            literal.append(c);
+            ++i;
+            continue;
+        }
+        if (m_spec.at(i + 1) != '{') {
+            literal.append(c);
+            continue;
+        }
+        const int close = m_spec.indexOf('}', i + 2);
+        if (close < 0)
+            return fail(QString("unterminated placeholder at %1").arg(i));
+        const QString name = m_spec.mid(i + 2, close - i - 2).trimmed();
+        i = close;
+        flushLiteral();
+        if (hasMessage)
+            return fail("%{message} must be the last placeholder");
+        if (!m_steps.isEmpty() && m_steps.last().kind >= Step::Level)
+            return fail(QString("placeholder %{%1} needs a separator before it").arg(name));
+
+        if (name.startsWith("time:")) {
+            if (m_hasTime)
+                return fail("duplicate %{time}");
+            m_hasTime = true;
+            if (!compileTime(name.mid(5), error))
+                return false;
+            addStep(Step::Time);
+        } else if (name == "level") {
+            if (m_hasLevel)
+                return fail("duplicate %{level}");
+            m_hasLevel = true;
+            addStep(Step::Level);
+        } else if (name == "message") {
+            hasMessage = true;
+            addStep(Step::Message);
+        } else if (name.isEmpty() || name == "time") {
+            return fail(name.isEmpty() ? QString("empty placeholder") : QString("%{time} needs a format, such as %{time:yyyy-MM-dd hh:mm:ss}"));
+        } else {
+            addStep(Step::Field);
+            m_steps.last().column = FirstFieldColumn + m_fieldNames.size();
+            m_fieldNames.append(name);
+        }
+    }
+    flushLiteral();
+    if (!m_hasTime && !m_hasLevel && !hasMessage && m_fieldNames.isEmpty())
+        return fail("format has no placeholder");
+    return true;
+}
+
+/**
+ * @brief LogLineFormat::compileTime 编译时间格式,连续的同一字母为一个元素,不认识的字母按字面文字比较
+ */
+bool LogLineFormat::compileTime(const QString &format, QString *error)
+{
+    auto fail = [error, &format](const QString &reason) {
+        if (error)
+            *error = QString("invalid time format \"%1\": %2").arg(format, reason);
+        return false;
+    };
+    auto add = [this](TimeElement::Kind kind, int minDigits = 0, int maxDigits = 0, QChar text = QChar()) {
+        TimeElement element;
+        element.kind = kind;
+        element.minDigits = minDigits;
+        element.maxDigits = maxDigits;
+        element.text = text;
+        m_timeElements.append(element);
+    };
+
+    if (format.trimmed() == "epoch") {
+        add(TimeElement::Epoch, 1, 12);
+        return true;
+    }
+    if (format.isEmpty())
+        return fail("empty");
+    for (int i = 0; i < format.size();) {
+        const QChar c = format.at(i);
+        int run = 1;
+        while (i + run < format.size() && format.at(i + run) == c)
+            ++run;
+        bool ok = true;
+        switch (c.unicode()) {
+        case 'y':
+            ok = run == 4 || run == 2;
+            add(run == 4 ? TimeElement::Year4 : TimeElement::Year2, run, run);
+            break;
+        case 'M':
+            m_timeHasDate = true;
+            ok = run <= 3;
+            if (run == 3)
+                add(TimeElement::MonthName);
+            else
+                add(TimeElement::Month, run, 2);
+            break;
+        case 'd':
+            //ddd为英文星期缩写,只跳过不校验
+            m_timeHasDate = m_timeHasDate || run < 3;
+            ok = run <= 3;
+            if (run == 3)
+                add(TimeElement::DayName);
+            else
+                add(TimeElement::Day, run, 2);
+            break;
+        case 'h':
+        case 'H':
+            ok = run <= 2;
+            add(TimeElement::Hour, run, 2);
+            break;
+        case 'm':
+            ok = run <= 2;
+            add(TimeElement::Minute, run, 2);
+            break;
+        case 's':
+            ok = run <= 2;
+            add(TimeElement::Second, run, 2);
+            break;
+        case 'z':
+            ok = run == 3 || run == 1;
+            if (run == 3)
+                add(TimeElement::Millisecond, 3, 3);
+            else
+                add(TimeElement::Fraction, 1, 9);
+            break;
+        default:
+            for (int k = 0; k < run; ++k) {
+                if (isSpace(c)) {
+                    if (k == 0)
+                        add(TimeElement::Space);
+                } else {
+                    add(TimeElement::Literal, 0, 0, c);
+                }
+            }
+            break;
+        }
+        if (!ok)
+            return fail(QString("unsupported \"%1\"").arg(QString(run, c)));
+        i += run;
+    }
+    return true;
+}
+
+/**
+ * @brief LogLineFormat::parse 按格式解析一行
+ * @param time 输出参数,时间(毫秒),格式中没有时间时为-1
+ * @param columns 输出参数,各列文字,见Column;没有出现的部分为空
+ * @return 是否为该格式的记录行,不是时(如多行记录的续行)columns不变
+ */
+bool LogLineFormat::parse(const QString &line, qint64 &time, QStringList &columns) const
+{
+    time = -1;
+    return scan(line, &time, &columns);
+}
+
+/**
+ * @brief LogLineFormat::timeOf 只取出行的时间,扫描到时间为止,用于时间索引和按时间段跳过
+ * @return 时间(毫秒),不是记录行或格式中没有时间时为-1
+ */
+qint64 LogLineFormat::timeOf(const QString &line) const
+{
+    if (!m_hasTime)
+        return -1;
+    qint64 time = -1;
+    return scan(line, &time, nullptr) ? time : -1;
+}
+
+/**
+ * @brief LogLineFormat::scan 依次匹配各段,只记下各列的位置,整行匹配后才复制文字
+ * @param columns 为空时只取时间,匹配到时间后立即返回
+ */
+bool LogLineFormat::scan(const QString &line, qint64 *time, QStringList *columns) const
+{
+    const int size = line.size();
+    const int count = columnCount();
+    //各列的起止位置
+    QVarLengthArray<int, 32> spans(count * 2);
+    std::fill(spans.begin(), spans.end(), 0);
+    int pos = 0;
+    for (int i = 0; i < m_steps.size(); ++i) {
+        const Step &step = m_steps.at(i);
+        switch (step.kind) {
+        case Step::Literal:
+            if (line.midRef(pos, step.text.size()) != step.text)
+                return false;
+            pos += step.text.size();
+            break;
+        case Step::Space:
+            if (pos >= size || !isSpace(line.at(pos)))
+                return false;
+            while (pos < size && isSpace(line.at(pos)))
+                ++pos;
+            break;
+        case Step::Time: {
+            const int begin = pos;
+            qint64 msecs = -1;
+            if (!scanTime(line, pos, msecs))
+                return false;
+            *time = msecs;
+            if (!columns)
+                return true;
+            spans[TimeColumn * 2] = begin;
+            spans[TimeColumn * 2 + 1] = pos;
+            break;
+        }
+        case Step::Level:
+        case Step::Field: {
+            const int end = fieldEnd(line, pos, i);
+            if (end < 0)
+                return false;
+            const int column = step.kind == Step::Level ? int(LevelColumn) : step.column;
+            spans[column * 2] = pos;
+            spans[column * 2 + 1] = end;
+            pos = end;
+            break;
+        }
+        case Step::Message:
+            spans[messageColumn() * 2] = pos;
+            spans[messageColumn() * 2 + 1] = size;
+            pos = size;
+            break;
+        }
+    }
+    if (!columns)
+        return true;
+    //没有%{message}时剩余部分作为信息
+    if (pos < size && spans[messageColumn() * 2 + 1] == 0) {
+        spans[messageColumn() * 2] = pos;
+        spans[messageColumn() * 2 + 1] = size;
+    }
+    columns->clear();
+    for (int c = 0; c < count; ++c)
+        columns->append(line.mid(spans[c * 2], spans[c * 2 + 1] - spans[c * 2]));
+    return true;
+}
+
+/**
+ * @brief LogLineFormat::scanTime 按时间格式逐个元素取数字,换算为当地时间
+ * @param pos 输入输出参数,时间的开始,成功时移到时间之后
+ */
+bool LogLineFormat::scanTime(const QString &line, int &pos, qint64 &time) const
+{
+    const int size = line.size();
+    qint64 year = m_defaultYear, month = 1, day = 1, hour = 0, minute = 0, second = 0, msecs = 0;
+    for (const TimeElement &element : m_timeElements) {
+        qint64 value = 0;
+        int digits = 0;
+        switch (element.kind) {
+        case TimeElement::Literal:
+            if (pos >= size || line.at(pos) != element.text)
+                return false;
+            ++pos;
+            continue;
+        case TimeElement::DayName:
+            for (int k = 0; k < 3; ++k) {
+                if (pos >= size || !isAsciiLetter(line.at(pos)))
+                    return false;
+                ++pos;
+            }
+            continue;
+        case TimeElement::Space:
+            if (pos >= size || !isSpace(line.at(pos)))
+                return false;
+            while (pos < size && isSpace(line.at(pos)))
+                ++pos;
+            continue;
+        case TimeElement::MonthName:
+            month = pos + 3 <= size ? monthOf(line.midRef(pos, 3)) : 0;
+            if (month == 0)
+                return false;
+            pos += 3;
+            continue;
+        case TimeElement::Epoch: {
+            digits = readDigits(line, pos, element.minDigits, element.maxDigits, value);
+            if (digits == 0)
+                return false;
+            pos += digits;
+            time = value * 1000;
+            if (pos + 1 < size && line.at(pos) == '.' && isDigit(line.at(pos + 1))) {
+                qint64 fraction = 0;
+                ++pos;
+                digits = readDigits(line, pos, 1, 9, fraction);
+                pos += digits;
+                for (; digits > 3; --digits)
+                    fraction /= 10;
+                for (; digits < 3; ++digits)
+                    fraction *= 10;
+                time += fraction;
+            }
+            return true;
+        }
+        default:
+            digits = readDigits(line, pos, element.minDigits, element.maxDigits, value);
+            if (digits == 0)
+                return false;
+            pos += digits;
+            break;
+        }
+        switch (element.kind) {
+        case TimeElement::Year4:
+            year = value;
+            break;
+        case TimeElement::Year2:
+            year = 2000 + value;
+            break;
+        case TimeElement::Month:
+            month = value;
+            break;
+        case TimeElement::Day:
+            day = value;
+            break;
+        case TimeElement::Hour:
+            hour = value;
+            break;
+        case TimeElement::Minute:
+            minute = value;
+            break;
+        case TimeElement::Second:
+            second = value;
+            break;
+        case TimeElement::Millisecond:
+            msecs = value;
+            break;
+        case TimeElement::Fraction:
+            //小数部分换算为毫秒,超过三位的截断
+            for (; digits > 3; --digits)
+                value /= 10;
+            for (; digits < 3; ++digits)
+                value *= 10;
+            msecs = value;
+            break;
+        default:
+            break;
+        }
+    }
+    //只有时分秒时按当天处理
+    const QDate date = m_timeHasDate ? QDate(static_cast<int>(year), static_cast<int>(month), static_cast<int>(day)) : QDate::currentDate();
+    if (!date.isValid() || !QTime::isValid(static_cast<int>(hour), static_cast<int>(minute), static_cast<int>(second), static_cast<int>(msecs)))
+        return false;
+    time = LogLocalTime::toMSecs(date, static_cast<int>(hour), static_cast<int>(minute), static_cast<int>(second), static_cast<int>(msecs));
+    return true;
+}
+
+/**
+ * @brief LogLineFormat::fieldEnd 字段或等级的结尾:下一段字面文字第一次出现的位置,下一段是空白时为第一个空白,没有下一段时为行尾
+ * @return 结尾位置,找不到下一段时为-1
+ */
+int LogLineFormat::fieldEnd(const QString &line, int pos, int step) const
+{
+    if (step + 1 >= m_steps.size())
+        return line.size();
+    const Step &next = m_steps.at(step + 1);
+    if (next.kind == Step::Space) {
+        int end = pos;
+        while (end < line.size() && !isSpace(line.at(end)))
+            ++end;
+        return end < line.size() ? end : -1;
+    }
+    return line.indexOf(next.text, pos);
+}
+
+/**
+ * @brief LogLineFormat::levelOf 常见的等级写法换算为syslog等级,不区分大小写,也接受0-7的数字;不认识时返回-1
+ * 首字母和长度相同的写法才逐字比较
+ */
+int LogLineFormat::levelOf(const QStringRef &token)
+{
+    if (token.isEmpty())
+        return -1;
+    if (token.size() == 1 && token.at(0).unicode() >= '0' && token.at(0).unicode() <= '7')
+        return token.at(0).unicode() - '0';
+
+    //首字母不同的不比较,每个写法都是小写
+    static const struct {
+        const char *text;
+        int level;
+    } names[] = {{"e", ERR}, {"err", ERR}, {"error", ERR}, {"emerg", EMER}, {"emergency", EMER},
+                 {"w", WARN}, {"warn", WARN}, {"warning", WARN}, {"i", INF}, {"info", INF}, {"information", INF},
+                 {"d", DEB}, {"debug", DEB}, {"t", DEB}, {"trace", DEB}, {"v", DEB}, {"verbose", DEB},
+                 {"c", CRI}, {"crit", CRI}, {"critical", CRI}, {"n", NOTICE}, {"notice", NOTICE},
+                 {"a", ALERT}, {"alert", ALERT}, {"f", EMER}, {"fatal", EMER}, {"panic", EMER}};
+    const ushort first = token.at(0).toLower().unicode();
+    for (const auto &name : names) {
+        if (ushort(name.text[0]) == first && token.size() == int(qstrlen(name.text))
+                && token.compare(QLatin1String(name.text), Qt::CaseInsensitive) == 0)
+            return name.level;
+    }
+    return -1;
+}
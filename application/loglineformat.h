@@ -0,0 +1,128 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGLINEFORMAT_H
+#define LOGLINEFORMAT_H
+
+#include <QString>
+#include <QStringList>
+#include <QStringRef>
+#include <QVector>
+
+#include <memory>
+
+//按自定义格式取时间的时间索引名称前缀,之后是格式说明,同一文件换了格式时重新建立索引
+#define LOG_TIME_INDEX_CUSTOM "custom:"
+
+class LogLineFormat;
+typedef std::shared_ptr<const LogLineFormat> LogLineFormatPtr;
+
+/**
+ * @brief The LogLineFormat class 用户为自定义日志声明的行格式,编译一次后按位置逐段扫描,不使用正则,不回溯
+ * 格式说明由字面文字和占位符组成,如"%{time:yyyy-MM-dd hh:mm:ss.zzz} [%{level}] %{module}: %{message}":
+ * %{time:格式} 时间,格式中yyyy/yy/MM/M/MMM/dd/d/hh/h/mm/ss/zzz按位置取数字(MMM为英文月份缩写),
+ *              z为任意位小数,epoch为秒数(可带小数),其余字符为字面文字;没有年份时取当前年份
+ * %{level}     等级,按常见写法(如ERROR、warn、I、3)换算为syslog等级
+ * %{message}   行的剩余部分,只能是最后一个占位符
+ * %{名称}      其他字段,各成一列
+ * 字段和等级到下一段字面文字第一次出现的位置为止(下一段是空格时到第一个空白为止),相邻的两个字段之间必须有分隔;
+ * 格式说明中的空格匹配一个或多个空白,%%为字面的%。
+ * 编译后只读,可以在多个解析线程中共用
+ */
+class LogLineFormat
+{
+public:
+    /**
+     * @brief The Column enum 解析出的各列:时间文字、等级文字、各字段依次在等级之后,最后一列为信息
+     */
+    enum Column {
+        TimeColumn = 0,
+        LevelColumn,
+        FirstFieldColumn
+    };
+
+    static LogLineFormatPtr compile(const QString &spec, QString *error = nullptr);
+
+    const QString &spec() const { return m_spec; }
+    const QStringList &fieldNames() const { return m_fieldNames; }
+    int columnCount() const { return m_fieldNames.size() + FirstFieldColumn + 1; }
+    int messageColumn() const { return columnCount() - 1; }
+    bool hasTime() const { return m_hasTime; }
+    bool hasLevel() const { return m_hasLevel; }
+    QString indexKind() const { return LOG_TIME_INDEX_CUSTOM + m_spec; }
+
+    bool parse(const QString &line, qint64 &time, QStringList &columns) const;
+    qint64 timeOf(const QString &line) const;
+
+    static int levelOf(const QStringRef &token);
+
+private:
+    /**
+     * @brief The Step struct 行格式中的一段
+     */
+    struct Step {
+        enum Kind {
+            //字面文字,逐字比较
+            Literal,
+            //一个或多个空白
+            Space,
+            Time,
+            Level,
+            Field,
+            Message
+        };
+        Kind kind = Literal;
+        QString text;
+        //Field写入的列
+        int column = 0;
+    };
+
+    /**
+     * @brief The TimeElement struct 时间格式中的一个元素
+     */
+    struct TimeElement {
+        enum Kind {
+            Literal,
+            Space,
+            Year4,
+            Year2,
+            Month,
+            MonthName,
+            Day,
+            //英文星期缩写,只跳过不校验
+            DayName,
+            Hour,
+            Minute,
+            Second,
+            Millisecond,
+            Fraction,
+            Epoch
+        };
+        Kind kind = Literal;
+        //数字的最少和最多位数
+        int minDigits = 0;
+        int maxDigits = 0;
+        QChar text;
+    };
+
+    LogLineFormat() = default;
+    bool compileSteps(QString *error);
+    bool compileTime(const QString &format, QString *error);
+    bool scan(const QString &line, qint64 *time, QStringList *columns) const;
+    bool scanTime(const QString &line, int &pos, qint64 &time) const;
+    int fieldEnd(const QString &line, int pos, int step) const;
+
+    QString m_spec;
+    QVector<Step> m_steps;
+    QVector<TimeElement> m_timeElements;
+    QStringList m_fieldNames;
+    bool m_hasTime = false;
+    bool m_hasLevel = false;
+    //时间格式中没有年份时使用的年份
+    int m_defaultYear = 0;
+    //时间格式中是否有月或日,没有时取当天
+    bool m_timeHasDate = false;
+};
+
+#endif // LOGLINEFORMAT_H
@@ -0,0 +1,80 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "loglineindexer.h"
+
+/**
+ * @brief LogLineIndexer::index 从前到后记下[begin, end)中每个非空行的范围,最后没有换行符的一行也包括在内
+ * @param spans 输出参数,先清空,保留已有的容量供下次复用
+ * @return 行数
+ */
+int LogLineIndexer::index(const char *data, qint64 begin, qint64 end, QVector<LogLineSpan> &spans)
+{
+    spans.resize(0);
+    qint64 start = begin;
+    forEachNewline(data, begin, end, [&spans, &start](qint64 newline) {
+        if (newline > start)
+            spans.append({start, static_cast<int>(newline - start)});
+        start = newline + 1;
+        return true;
+    });
+    if (end > start)
+        spans.append({start, static_cast<int>(end - start)});
+    return spans.size();
+}
+
+/**
+ * @brief LogLineIndexer::count 统计换行符的个数,每16字节的比较结果直接累加,不逐个取出位置
+ */
+qint64 LogLineIndexer::count(const char *data, qint64 size)
+{
+    qint64 total = 0;
+    qint64 pos = 0;
+#if defined(LOG_LINE_INDEXER_SSE2)
+    const __m128i newline = _mm_set1_epi8('\n');
+    for (; pos + LOG_LINE_INDEXER_BLOCK <= size; pos += LOG_LINE_INDEXER_BLOCK) {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + pos));
+        total += __builtin_popcount(static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, newline))));
+    }
+#elif defined(LOG_LINE_INDEXER_NEON)
+    const uint8x16_t newline = vdupq_n_u8('\n');
+    for (; pos + LOG_LINE_INDEXER_BLOCK <= size; pos += LOG_LINE_INDEXER_BLOCK) {
+        //相等的字节为0xFF,右移7位后为1,横向相加得到这一段的个数
+        const uint8x16_t equal = vceqq_u8(vld1q_u8(reinterpret_cast<const uint8_t *>(data + pos)), newline);
+#if defined(__aarch64__)
+        total += vaddlvq_u8(vshrq_n_u8(equal, 7));
+#else
+        //armv7没有横向相加指令,逐级两两相加到两个64位数
+        const uint64x2_t sum = vpaddlq_u32(vpaddlq_u16(vpaddlq_u8(vshrq_n_u8(equal, 7))));
+        total += static_cast<qint64>(vgetq_lane_u64(sum, 0) + vgetq_lane_u64(sum, 1));
+#endif
+    }
+#endif
+    for (; pos < size; ++pos) {
+        if (data[pos] == '\n')
+            ++total;
+    }
+    return total;
+}
+
+/**
+ * @brief LogLineIndexer::findNewline [begin, end)中第一个换行符,没有时为nullptr
+ * 单次查找直接用memchr,glibc已按平台向量化
+ */
+const char *LogLineIndexer::findNewline(const char *begin, const char *end)
+{
+    if (begin >= end)
+        return nullptr;
+    return static_cast<const char *>(memchr(begin, '\n', static_cast<size_t>(end - begin)));
+}
+
+/**
+ * @brief LogLineIndexer::findLastNewline [begin, end)中最后一个换行符,没有时为nullptr
+ */
+const char *LogLineIndexer::findLastNewline(const char *begin, const char *end)
+{
+    if (begin >= end)
+        return nullptr;
+    return static_cast<const char *>(memrchr(begin, '\n', static_cast<size_t>(end - begin)));
+}
@@ -0,0 +1,95 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGLINEINDEXER_H
+#define LOGLINEINDEXER_H
+
+#include <QVector>
+#include <QtGlobal>
+
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define LOG_LINE_INDEXER_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define LOG_LINE_INDEXER_NEON
+#endif
+
+//一次比较的字节数
+#define LOG_LINE_INDEXER_BLOCK 16
+
+/**
+ * @brief The LogLineSpan struct 一行在文件中的字节范围,不含换行符
+ */
+struct LogLineSpan {
+    qint64 offset;
+    int length;
+};
+Q_DECLARE_TYPEINFO(LogLineSpan, Q_PRIMITIVE_TYPE);
+
+/**
+ * @brief The LogLineIndexer class UTF-8缓冲中换行符的查找,各文本解析、分块和索引共用
+ * 每次比较16字节(SSE2/NEON),得到这一段中所有换行符的位掩码后逐位取出,短行密集时不必每行调用一次memchr;
+ * 不足16字节的尾部和其他平台使用memchr。只记录位置,不为每行分配内存
+ */
+class LogLineIndexer
+{
+public:
+    template <typename Visitor>
+    static bool forEachNewline(const char *data, qint64 begin, qint64 end, Visitor visit);
+    static int index(const char *data, qint64 begin, qint64 end, QVector<LogLineSpan> &spans);
+    static qint64 count(const char *data, qint64 size);
+    static const char *findNewline(const char *begin, const char *end);
+    static const char *findLastNewline(const char *begin, const char *end);
+};
+
+/**
+ * @brief LogLineIndexer::forEachNewline 按从前到后的顺序对[begin, end)中每个换行符的位置调用visit
+ * @param visit 参数为换行符的下标,返回false时停止
+ * @return 是否扫描到了end,visit返回false时为false
+ */
+template <typename Visitor>
+bool LogLineIndexer::forEachNewline(const char *data, qint64 begin, qint64 end, Visitor visit)
+{
+    qint64 pos = begin;
+#if defined(LOG_LINE_INDEXER_SSE2)
+    const __m128i newline = _mm_set1_epi8('\n');
+    for (; pos + LOG_LINE_INDEXER_BLOCK <= end; pos += LOG_LINE_INDEXER_BLOCK) {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + pos));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, newline)));
+        while (mask) {
+            if (!visit(pos + __builtin_ctz(mask)))
+                return false;
+            mask &= mask - 1;
+        }
+    }
+#elif defined(LOG_LINE_INDEXER_NEON)
+    const uint8x16_t newline = vdupq_n_u8('\n');
+    for (; pos + LOG_LINE_INDEXER_BLOCK <= end; pos += LOG_LINE_INDEXER_BLOCK) {
+        const uint8x16_t equal = vceqq_u8(vld1q_u8(reinterpret_cast<const uint8_t *>(data + pos)), newline);
+        //每个字节收窄为4位,16字节得到一个64位掩码
+        uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(equal), 4)), 0);
+        while (mask) {
+            const int bit = __builtin_ctzll(mask);
+            if (!visit(pos + (bit >> 2)))
+                return false;
+            mask &= ~(Q_UINT64_C(0xF) << bit);
+        }
+    }
+#endif
+    while (pos < end) {
+        const void *found = memchr(data + pos, '\n', static_cast<size_t>(end - pos));
+        if (!found)
+            break;
+        const qint64 at = static_cast<const char *>(found) - data;
+        if (!visit(at))
+            return false;
+        pos = at + 1;
+    }
+    return true;
+}
+
+#endif // LOGLINEINDEXER_H
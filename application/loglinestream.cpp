@@ -0,0 +1,682 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "loglinestream.h"
+#include "dbusproxy/dldbushandler.h"
+#include "loggzipinflater.h"
+#include "logbytesanitizer.h"
+#include "logingestmetrics.h"
+#include "loglineindexer.h"
+#include "logtimeindex.h"
+
+#include <QFileInfo>
+#include <QLoggingCategory>
+
+#include <algorithm>
+#include <errno.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef QT_DEBUG
+Q_LOGGING_CATEGORY(logLineStream, "org.deepin.log.viewer.line.stream")
+#else
+Q_LOGGING_CATEGORY(logLineStream, "org.deepin.log.viewer.line.stream", QtInfoMsg)
+#endif
+
+
+/**
+ * @brief LogLineStream::LogLineStream 构造函数,第一次读取时才打开文件或通道
+ * @param filePath 日志文件路径
+ * @param parent DLDBusHandler单例的父对象
+ */
+LogLineStream::LogLineStream(const QString &filePath, QObject *parent)
+    : m_filePath(filePath)
+    , m_parent(parent)
+{
+}
+
+LogLineStream::~LogLineStream()
+{
+    closeLocal();
+    closeStream();
+}
+
+/**
+ * @brief LogLineStream::closeStream 通知服务释放倒序通道,读完、被取消或中途停止都经过这里
+ * 读完时服务端已经释放通道,再关闭一次没有影响
+ */
+void LogLineStream::closeStream()
+{
+    if (m_token.isEmpty())
+        return;
+    DLDBusHandler::instance(m_parent)->closeLogStream(m_token);
+    m_token.clear();
+}
+
+/**
+ * @brief LogLineStream::openDirect 尝试在进程内读取:当前用户可读时直接映射,否则映射服务传来的描述符
+ * @return 是否在进程内读取,false时readChunk会改用服务的流式通道
+ */
+bool LogLineStream::openDirect()
+{
+    if (!m_directTried) {
+        m_directTried = true;
+        m_local = openLocal() || openDescriptor();
+    }
+    return m_local;
+}
+
+/**
+ * @brief LogLineStream::readChunk 读取下一块的行
+ * @param lines 输出参数,按从新到旧排列的非空行,已去除\u0000和\x01
+ * @return 是否读到了数据,false表示读取结束
+ */
+bool LogLineStream::readChunk(QStringList &lines)
+{
+    lines.clear();
+    m_spans.clear();
+    if (m_finished)
+        return false;
+
+    QString data;
+    if (!m_opened) {
+        m_opened = true;
+        if (openDirect())
+            return readLocalChunk(lines);
+
+        //服务不支持传递描述符时才通过服务读取内容
+        //有筛选条件时由服务端丢弃不匹配的行,旧版服务不支持时再打开不带筛选的通道
+        if (!m_filter.isEmpty())
+            m_token = DLDBusHandler::instance(m_parent)->openFilteredLogStream(m_filePath, m_filter.toVariantMap());
+        if (m_token.isEmpty())
+            m_token = DLDBusHandler::instance(m_parent)->openReverseLogStream(m_filePath);
+        if (m_token.isEmpty()) {
+            qCDebug(logLineStream) << "reverse stream unavailable, read whole file:" << m_filePath;
+            m_finished = true;
+            data = DLDBusHandler::instance(m_parent)->readLog(m_filePath);
+            data.replace('\u0000', "").replace("\x01", "");
+            lines = data.split('\n', QString::SkipEmptyParts);
+            LogIngestMetrics::addRead(data.size(), lines.size());
+            //整个文件读取的结果是从旧到新,转换为和倒序通道一致的顺序
+            std::reverse(lines.begin(), lines.end());
+            return !lines.isEmpty();
+        }
+    }
+
+    if (m_local)
+        return readLocalChunk(lines);
+
+    data = DLDBusHandler::instance(m_parent)->readLogInStream(m_token);
+    if (data.isEmpty()) {
+        //读到末尾和等待时被取消都返回空,两种情况都关闭通道,取消时服务端的通道不会留到空闲超时
+        m_finished = true;
+        closeStream();
+        return false;
+    }
+    data.replace('\u0000', "").replace("\x01", "");
+    lines = data.split('\n', QString::SkipEmptyParts);
+    LogIngestMetrics::addRead(data.size(), lines.size());
+    return true;
+}
+
+/**
+ * @brief LogLineStream::openLocal 当前用户可读时在进程内映射文件,压缩日志在进程内解压
+ * @return 是否使用本地读取,失败时由调用者改用服务读取
+ */
+bool LogLineStream::openLocal()
+{
+    QFileInfo info(m_filePath);
+    if (!info.isFile() || access(QFile::encodeName(m_filePath).constData(), R_OK) != 0)
+        return false;
+
+    m_file.setFileName(m_filePath);
+    if (!m_file.open(QIODevice::ReadOnly))
+        return false;
+    return mapOpenedFile();
+}
+
+/**
+ * @brief LogLineStream::openDescriptor 没有读权限时由服务以root权限打开文件,在进程内映射传回的描述符
+ * @return 是否使用描述符读取,服务不支持或路径无效时由调用者改用服务的流式通道
+ */
+bool LogLineStream::openDescriptor()
+{
+    m_descriptor = DLDBusHandler::instance(m_parent)->openLogFile(m_filePath);
+    if (!m_descriptor.isValid())
+        return false;
+
+    if (!m_file.open(m_descriptor.fileDescriptor(), QIODevice::ReadOnly)) {
+        qCWarning(logLineStream) << "open descriptor failed:" << m_filePath << m_file.errorString();
+        m_descriptor = QDBusUnixFileDescriptor();
+        return false;
+    }
+    qCDebug(logLineStream) << "read file by descriptor:" << m_filePath;
+    return mapOpenedFile();
+}
+
+/**
+ * @brief LogLineStream::mapOpenedFile 映射已打开的m_file,压缩日志解压到内存后关闭文件
+ * @return 是否成功,失败时已关闭文件
+ */
+bool LogLineStream::mapOpenedFile()
+{
+    if (LogGzipInflater::isGzipFile(m_filePath)) {
+        QString error;
+        //压缩数据无法倒序解压,整个解压到内存后再从末尾读取,不产生临时文件
+        bool ok = LogGzipInflater::inflateDevice(&m_file, m_inflated, &error);
+        closeFile();
+        if (!ok) {
+            qCWarning(logLineStream) << "inflate failed:" << m_filePath << error;
+            //超过大小上限时服务也不会解压,不再改用服务读取,作为空文件结束
+            if (m_inflated.isEmpty() && error != LogGzipInflater::sizeLimitError())
+                return false;
+        }
+        m_local = true;
+        m_data = m_inflated.constData();
+        m_size = m_inflated.size();
+        m_pos = m_size;
+        return true;
+    }
+
+    const qint64 size = m_file.size();
+    if (size > 0) {
+        m_map = m_file.map(0, size);
+        if (!m_map) {
+            qCDebug(logLineStream) << "map failed, fall back to service:" << m_filePath << m_file.errorString();
+            closeFile();
+            return false;
+        }
+    }
+    m_local = true;
+    m_data = reinterpret_cast<const char *>(m_map);
+    m_size = size;
+    m_pos = size;
+    qCDebug(logLineStream) << "read local file:" << m_filePath << size;
+    return true;
+}
+
+/**
+ * @brief LogLineStream::readLocalChunk 从末尾向前解码最多LOG_LINE_STREAM_CHUNK字节的完整行,映射的文件见readFileChunk
+ * @param lines 输出参数,按从新到旧排列的非空行
+ * @return 是否读到了数据
+ */
+bool LogLineStream::readLocalChunk(QStringList &lines)
+{
+    if (m_map)
+        return readFileChunk(lines);
+
+    const char *base = m_data;
+    const qint64 chunkEnd = m_pos;
+    while (m_pos > m_begin && lines.isEmpty()) {
+        //块的开始退到LOG_LINE_STREAM_CHUNK字节之前的行首,超长的行整行留在这一块中
+        qint64 chunkBegin = qMax(m_begin, m_pos - LOG_LINE_STREAM_CHUNK);
+        if (chunkBegin > m_begin) {
+            const char *newline = LogLineIndexer::findLastNewline(base + m_begin, base + chunkBegin);
+            chunkBegin = newline ? newline - base + 1 : m_begin;
+        }
+        LogLineIndexer::index(base, chunkBegin, m_pos, m_chunkSpans);
+        lines.reserve(m_chunkSpans.size());
+        for (int i = m_chunkSpans.size() - 1; i >= 0; --i)
+            lines.append(decodeLine(base + m_chunkSpans.at(i).offset, m_chunkSpans.at(i).length));
+        //跳过块前面一行行尾的换行符
+        m_pos = chunkBegin > m_begin ? chunkBegin - 1 : m_begin;
+    }
+
+    if (lines.isEmpty()) {
+        m_finished = true;
+        closeLocal();
+        return false;
+    }
+    LogIngestMetrics::addRead(chunkEnd - qMax(m_pos, m_begin), lines.size());
+    return true;
+}
+
+/**
+ * @brief LogLineStream::readFileChunk 映射的文件按块用pread从末尾向前读取完整的行,不访问映射
+ * 读取期间文件可能还在追加或被截断(如copytruncate轮转),检查文件大小之后再访问映射仍可能越界触发SIGBUS,
+ * pread读到截断的位置只会返回较少的字节,这时停止读取
+ * @param lines 输出参数,按从新到旧排列的非空行
+ * @return 是否读到了数据
+ */
+bool LogLineStream::readFileChunk(QStringList &lines)
+{
+    const qint64 chunkEnd = m_pos;
+    while (m_pos > m_begin && lines.isEmpty()) {
+        //块的开始之前还有内容时,块中第一个换行符之前的不完整行留到下一块,超长的行扩大读取范围直到读到整行
+        qint64 window = LOG_LINE_STREAM_CHUNK;
+        qint64 chunkBegin = m_begin;
+        int start = 0;
+        for (;;) {
+            chunkBegin = qMax(m_begin, m_pos - window);
+            if (!readRange(chunkBegin, m_pos, m_chunkData)) {
+                qCWarning(logLineStream) << "file shrank while reading, stop:" << m_filePath;
+                m_pos = m_begin;
+                break;
+            }
+            if (chunkBegin == m_begin)
+                break;
+            const int newline = m_chunkData.indexOf('\n');
+            if (newline >= 0) {
+                start = newline + 1;
+                break;
+            }
+            window *= 2;
+        }
+        if (m_pos == m_begin)
+            break;
+
+        const char *base = m_chunkData.constData();
+        LogLineIndexer::index(base, start, m_chunkData.size(), m_chunkSpans);
+        lines.reserve(m_chunkSpans.size());
+        for (int i = m_chunkSpans.size() - 1; i >= 0; --i) {
+            const LogLineSpan &span = m_chunkSpans.at(i);
+            lines.append(decodeLine(base + span.offset, span.length));
+            if (m_recordSpans)
+                m_spans.append({chunkBegin + span.offset, span.length});
+        }
+        //留下的不完整行结束在块中第一个换行符处
+        m_pos = start > 0 ? chunkBegin + start - 1 : m_begin;
+    }
+    m_chunkData.clear();
+
+    if (lines.isEmpty()) {
+        m_finished = true;
+        closeLocal();
+        return false;
+    }
+    LogIngestMetrics::addRead(chunkEnd - qMax(m_pos, m_begin), lines.size());
+    return true;
+}
+
+/**
+ * @brief LogLineStream::readRange 取出[begin, end)的内容,可以在多个线程中同时调用
+ * 映射的文件用pread读取,不访问映射,读取期间文件被截断不会触发SIGBUS;解压的内容直接引用,不复制
+ * @param data 输出参数,解压的内容只在流关闭前有效
+ * @return 是否读满,文件被截断到end之前时返回false
+ */
+bool LogLineStream::readRange(qint64 begin, qint64 end, QByteArray &data) const
+{
+    if (begin < 0 || end < begin || end > m_size)
+        return false;
+    if (!m_map) {
+        data = QByteArray::fromRawData(m_data + begin, static_cast<int>(end - begin));
+        return true;
+    }
+    data.resize(static_cast<int>(end - begin));
+    qint64 done = 0;
+    while (done < data.size()) {
+        const ssize_t n = pread(m_file.handle(), data.data() + done, static_cast<size_t>(data.size() - done), begin + done);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return false;
+        done += n;
+    }
+    return true;
+}
+
+/**
+ * @brief LogLineStream::lastNewline [begin, end)中最后一个换行符的位置,用readRange从末尾向前按块查找,不访问映射
+ * @return 没有换行符或读取失败时为-1
+ */
+qint64 LogLineStream::lastNewline(qint64 begin, qint64 end) const
+{
+    QByteArray block;
+    while (end > begin) {
+        const qint64 blockBegin = qMax(begin, end - LOG_LINE_SPLIT_WINDOW);
+        if (!readRange(blockBegin, end, block))
+            return -1;
+        const int newline = block.lastIndexOf('\n');
+        if (newline >= 0)
+            return blockBegin + newline;
+        end = blockBegin;
+    }
+    return -1;
+}
+
+/**
+ * @brief LogLineStream::fileIdentity 打开的文件的设备号和inode,按描述符取,和按路径取到的可能不是同一个文件
+ * @return 是否获取成功,解压到内存的压缩日志和通过服务读取时返回false
+ */
+bool LogLineStream::fileIdentity(quint64 &device, quint64 &inode) const
+{
+    struct stat st;
+    if (!m_file.isOpen() || fstat(m_file.handle(), &st) != 0)
+        return false;
+    device = static_cast<quint64>(st.st_dev);
+    inode = static_cast<quint64>(st.st_ino);
+    return true;
+}
+
+/**
+ * @brief LogLineStream::splitRange 同静态的splitRange,把尚未读取的[rangeBegin, rangeEnd)切分为约chunkBytes的块
+ * 映射的文件只在每个切分点附近用pread读取一段,不访问映射;切分点附近的行不完整时扩大读取范围。
+ * 读取失败(文件被截断)时不切分,调用者按readChunk读取时会发现截断并停止
+ */
+QVector<qint64> LogLineStream::splitRange(qint64 chunkBytes, const GroupKeyFunc &groupKey) const
+{
+    if (!m_map)
+        return splitRange(m_data, m_begin, m_pos, chunkBytes, groupKey);
+
+    const QVector<qint64> whole {m_pos, m_begin};
+    QVector<qint64> bounds;
+    bounds.append(m_pos);
+    qint64 pos = m_pos;
+    QByteArray window;
+    while (chunkBytes > 0 && pos - m_begin > chunkBytes) {
+        const qint64 target = pos - chunkBytes;
+        qint64 cut = -1;
+        for (qint64 span = LOG_LINE_SPLIT_WINDOW;; span *= 2) {
+            const qint64 windowBegin = qMax(m_begin, target - span);
+            const qint64 windowEnd = qMin(pos, target + span);
+            if (!readRange(windowBegin, windowEnd, window))
+                return whole;
+            //在窗口上求第一个切分点,和在整个范围上求得的一致
+            const QVector<qint64> local = splitRange(window.constData(), 0, window.size(), windowEnd - target, groupKey);
+            const char *data = window.constData();
+            if (local.size() > 2) {
+                const qint64 localCut = local.at(1);
+                //分组比较用到了切分点前后各一整行,窗口边上的行不完整时结果不可信
+                const bool complete = !groupKey
+                                      || ((windowBegin == m_begin || LogLineIndexer::findLastNewline(data, data + localCut - 1))
+                                          && (windowEnd == pos || LogLineIndexer::findNewline(data + localCut, data + window.size())));
+                if (complete) {
+                    cut = windowBegin + localCut;
+                    break;
+                }
+            } else if (windowBegin == m_begin) {
+                break;
+            }
+            if (windowBegin == m_begin && windowEnd == pos)
+                break;
+        }
+        if (cut <= m_begin)
+            break;
+        bounds.append(cut);
+        pos = cut;
+    }
+    bounds.append(m_begin);
+    return bounds;
+}
+
+/**
+ * @brief LogLineStream::seekTimeRange 按时间顺序写入的日志只读取[begin, end]时间段所在的部分
+ * 按字节偏移二分查找,每次只通过readRange读取并解码采样点之后的几行取时间,找到时间段两端所在的行后readChunk只读取这一段;
+ * 得到的范围只会比时间段大,调用者仍需逐行筛选。首尾的时间倒序或取不到时间时不做定位,读取整个文件
+ * @param begin 时间段开始,毫秒
+ * @param end 时间段结束,毫秒
+ * @param lineTime 取出一行的时间
+ * @param indexKind 不为空时使用缓存目录中按该规则建立的时间索引(见LogTimeIndex),只对映射的大文件生效
+ * @return 是否缩小了读取范围,需要在readChunk之前、openDirect成功之后调用
+ */
+bool LogLineStream::seekTimeRange(qint64 begin, qint64 end, const LineTimeFunc &lineTime, const QString &indexKind)
+{
+    if (!m_local || m_opened || m_size <= LOG_LINE_SEEK_MIN_SPAN || begin > end || fileShrank())
+        return false;
+
+    //压缩日志每次都要整个解压,只给映射的文件建立索引
+    if (!indexKind.isEmpty() && m_map) {
+        LogTimeIndex index(m_filePath, indexKind);
+        if (index.update([this](qint64 rangeBegin, qint64 rangeEnd, QByteArray &data) { return readRange(rangeBegin, rangeEnd, data); },
+                         m_size, lineTime)) {
+            qint64 rangeBegin = 0;
+            qint64 rangeEnd = m_size;
+            if (!index.range(begin, end, rangeBegin, rangeEnd) || (rangeBegin == 0 && rangeEnd == m_size))
+                return false;
+            qCDebug(logLineStream) << "seek time range by index:" << m_filePath << rangeBegin << rangeEnd << m_size;
+            m_begin = rangeBegin;
+            m_pos = rangeEnd;
+            return true;
+        }
+    }
+
+    qint64 firstStart = 0;
+    qint64 firstTime = -1;
+    qint64 lastStart = 0;
+    qint64 lastTime = -1;
+    //首行没有时间时从第一条带时间的行开始,末尾的采样点取最后一块中带时间的行
+    if (!sampleTime(-1, m_size, lineTime, firstStart, firstTime)
+            || !sampleTime(m_size - LOG_LINE_SEEK_MIN_SPAN, m_size, lineTime, lastStart, lastTime)
+            || firstTime > lastTime)
+        return false;
+
+    //lo之前带时间的行都早于begin,时间段内的第一行在[lo, hi)开始
+    qint64 lo = 0;
+    qint64 hi = m_size;
+    while (hi - lo > LOG_LINE_SEEK_MIN_SPAN) {
+        const qint64 mid = lo + (hi - lo) / 2;
+        qint64 start = 0;
+        qint64 time = -1;
+        if (!sampleTime(mid, hi, lineTime, start, time))
+            break;
+        if (time < begin)
+            lo = start;
+        else
+            hi = mid;
+    }
+    const qint64 rangeBegin = lo;
+
+    //hi及之后的行都晚于end,lo之前的行都不晚于end
+    lo = rangeBegin;
+    hi = m_size;
+    while (hi - lo > LOG_LINE_SEEK_MIN_SPAN) {
+        const qint64 mid = lo + (hi - lo) / 2;
+        qint64 start = 0;
+        qint64 time = -1;
+        if (!sampleTime(mid, hi, lineTime, start, time))
+            break;
+        if (time > end)
+            hi = start;
+        else
+            lo = start;
+    }
+
+    if (rangeBegin == 0 && hi == m_size)
+        return false;
+    qCDebug(logLineStream) << "seek time range:" << m_filePath << rangeBegin << hi << m_size;
+    m_begin = rangeBegin;
+    m_pos = hi;
+    return true;
+}
+
+/**
+ * @brief LogLineStream::sampleTime 从offset之后的第一个行首开始,向后找第一条带时间的行
+ * @param offset 采样位置,-1表示从文件开头
+ * @param limit 只找在limit之前开始的行
+ * @param lineTime 取出一行的时间
+ * @param lineStart 输出参数,找到的行的起始偏移
+ * @param time 输出参数,找到的行的时间
+ * @return LOG_LINE_SEEK_SAMPLE_LINES行内是否找到了带时间的行
+ */
+bool LogLineStream::sampleTime(qint64 offset, qint64 limit, const LineTimeFunc &lineTime, qint64 &lineStart, qint64 &time) const
+{
+    return sampleLine([this](qint64 begin, qint64 end, QByteArray &data) { return readRange(begin, end, data); },
+                      m_size, offset, limit, LOG_LINE_SEEK_SAMPLE_LINES, lineTime, lineStart, time) > 0;
+}
+
+/**
+ * @brief LogLineStream::sampleLine 同sampleTime,内容通过read读取,二分采样和时间索引共用
+ * 从采样位置开始读取一段,行没有读全时向后追加,不访问映射
+ * @param read 读取[begin, end)的内容,文件被截断时返回false
+ * @param size 内容长度
+ * @param maxLines 最多检查的行数
+ * @return 1找到,0没有找到,-1读取失败
+ */
+int LogLineStream::sampleLine(const RangeReader &read, qint64 size, qint64 offset, qint64 limit, int maxLines,
+                              const LineTimeFunc &lineTime, qint64 &lineStart, qint64 &time)
+{
+    const qint64 windowBegin = qMax<qint64>(offset, 0);
+    QByteArray window;
+    QByteArray block;
+    //[from, to)中第一个换行符的位置,1找到,0没有,-1读取失败
+    auto findNewline = [&](qint64 from, qint64 to, qint64 &at) {
+        for (;;) {
+            const int found = window.indexOf('\n', static_cast<int>(from - windowBegin));
+            if (found >= 0) {
+                at = windowBegin + found;
+                return at < to ? 1 : 0;
+            }
+            const qint64 windowEnd = windowBegin + window.size();
+            if (windowEnd >= to)
+                return 0;
+            if (!read(windowEnd, qMin(to, windowEnd + LOG_LINE_SPLIT_WINDOW), block))
+                return -1;
+            window.append(block);
+        }
+    };
+
+    qint64 start = 0;
+    if (offset >= 0) {
+        qint64 newline = 0;
+        const int found = findNewline(offset, limit, newline);
+        if (found <= 0)
+            return found;
+        start = newline + 1;
+    }
+
+    for (int i = 0; i < maxLines && start < limit; ++i) {
+        qint64 newline = 0;
+        const int found = findNewline(start, size, newline);
+        if (found < 0)
+            return -1;
+        const qint64 lineEnd = found > 0 ? newline : size;
+        time = lineTime(decodeLine(window.constData() + (start - windowBegin), static_cast<int>(lineEnd - start)));
+        if (time >= 0) {
+            lineStart = start;
+            return 1;
+        }
+        start = lineEnd + 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief LogLineStream::fileShrank 映射的文件是否已被截断,截断后访问映射越界部分会触发SIGBUS
+ */
+bool LogLineStream::fileShrank() const
+{
+    if (!m_map)
+        return false;
+    struct stat st;
+    return fstat(m_file.handle(), &st) != 0 || st.st_size < m_size;
+}
+
+/**
+ * @brief LogLineStream::setRangeBegin 只读取begin之后的行,如开头部分已有缓存的解析结果时
+ * @param begin 读取范围的开始位置,需要在行首
+ * @return 是否生效,需要在readChunk之前、openDirect成功之后调用
+ */
+bool LogLineStream::setRangeBegin(qint64 begin)
+{
+    if (!m_local || m_opened || begin < 0 || begin > m_pos)
+        return false;
+    m_begin = begin;
+    return true;
+}
+
+/**
+ * @brief LogLineStream::setRangeEnd 只读取end之前的行,如末尾还没有写完整的一行留到下次读取
+ * @param end 读取范围的结束位置(不含),需要在行首
+ * @return 是否生效,需要在readChunk之前、openDirect成功之后调用
+ */
+bool LogLineStream::setRangeEnd(qint64 end)
+{
+    if (!m_local || m_opened || end < m_begin || end > m_pos)
+        return false;
+    m_pos = end;
+    return true;
+}
+
+/**
+ * @brief LogLineStream::splitRange 把[begin, end)在换行处切分为约chunkBytes的块,供多个线程分别解码
+ * @param groupKey 切分点前后两行属于同一分组时切分点前移,整组留在较新的一块中
+ * @return 从end到begin递减的切分点,第i块为[bounds[i + 1], bounds[i]),按从新到旧排列
+ */
+QVector<qint64> LogLineStream::splitRange(const char *data, qint64 begin, qint64 end, qint64 chunkBytes,
+                                          const GroupKeyFunc &groupKey)
+{
+    QVector<qint64> bounds;
+    bounds.append(end);
+    qint64 pos = end;
+    while (chunkBytes > 0 && pos - begin > chunkBytes) {
+        const qint64 target = pos - chunkBytes;
+        const char *newline = LogLineIndexer::findLastNewline(data + begin, data + target);
+        if (!newline)
+            break;
+        qint64 cut = newline - data + 1;
+        for (int shift = 0; groupKey && shift < LOG_LINE_SPLIT_MAX_SHIFT && cut > begin; ++shift) {
+            const char *nextEnd = LogLineIndexer::findNewline(data + cut, data + pos);
+            const int nextLength = static_cast<int>((nextEnd ? nextEnd - data : pos) - cut);
+            const char *prevNewline = LogLineIndexer::findLastNewline(data + begin, data + cut - 1);
+            const qint64 prevStart = prevNewline ? prevNewline - data + 1 : begin;
+            const QByteArray key = groupKey(data + prevStart, static_cast<int>(cut - 1 - prevStart));
+            if (key.isEmpty() || key != groupKey(data + cut, nextLength))
+                break;
+            cut = prevStart;
+        }
+        if (cut <= begin)
+            break;
+        bounds.append(cut);
+        pos = cut;
+    }
+    bounds.append(begin);
+    return bounds;
+}
+
+/**
+ * @brief LogLineStream::decodeRange 解码[begin, end)中的完整行,和readChunk一样按从新到旧排列并跳过空行
+ * @return 行数
+ */
+int LogLineStream::decodeRange(const char *data, qint64 begin, qint64 end, QStringList &lines)
+{
+    lines.clear();
+    QVector<LogLineSpan> spans;
+    LogLineIndexer::index(data, begin, end, spans);
+    lines.reserve(spans.size());
+    for (int i = spans.size() - 1; i >= 0; --i)
+        lines.append(decodeLine(data + spans.at(i).offset, spans.at(i).length));
+    LogIngestMetrics::addRead(end - begin, lines.size());
+    return lines.size();
+}
+
+/**
+ * @brief LogLineStream::closeLocal 释放映射、解压数据和文件
+ */
+void LogLineStream::closeLocal()
+{
+    m_data = nullptr;
+    m_size = 0;
+    m_inflated.clear();
+    if (m_map) {
+        m_file.unmap(m_map);
+        m_map = nullptr;
+    }
+    closeFile();
+}
+
+/**
+ * @brief LogLineStream::closeFile 关闭文件和服务传来的描述符
+ */
+void LogLineStream::closeFile()
+{
+    if (m_file.isOpen())
+        m_file.close();
+    m_descriptor = QDBusUnixFileDescriptor();
+}
+
+/**
+ * @brief LogLineStream::decodeLine 在映射上直接解码一行,和服务读取的结果一致:\0替换为空格,去掉\x01
+ * @param data 行数据
+ * @param length 行长度,不含换行符
+ * @return 解码后的字符串
+ */
+QString LogLineStream::decodeLine(const char *data, int length)
+{
+    if (LogByteSanitizer::isClean(data, length, LogByteSanitizer::ReplaceNulRemoveSoh))
+        return QString::fromUtf8(data, length);
+
+    QByteArray buffer(data, length);
+    LogByteSanitizer::sanitize(buffer, LogByteSanitizer::ReplaceNulRemoveSoh);
+    return QString::fromUtf8(buffer);
+}
@@ -0,0 +1,163 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGLINESTREAM_H
+#define LOGLINESTREAM_H
+
+#include "loglinefilter.h"
+#include "loglineindexer.h"
+
+#include <QDBusUnixFileDescriptor>
+#include <QFile>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include <functional>
+
+class QObject;
+
+//本地映射读取时每块最多解析的字节数
+#define LOG_LINE_STREAM_CHUNK (1024 * 1024)
+//按时间二分查找时范围小于这么多字节就停止查找,剩下的部分逐行筛选
+#define LOG_LINE_SEEK_MIN_SPAN (64 * 1024)
+//二分查找的每个采样点最多向后找这么多行带时间的行
+#define LOG_LINE_SEEK_SAMPLE_LINES 64
+//分块时切分点最多为保持分组完整而前移的行数
+#define LOG_LINE_SPLIT_MAX_SHIFT 256
+//映射的文件分块时每个切分点前后先读取的字节数
+#define LOG_LINE_SPLIT_WINDOW (64 * 1024)
+
+/**
+ * @brief The LogLineStream class 按块从新到旧读取日志文件的行
+ * 当前用户可读的普通文件直接在进程内mmap,从映射上逐行解码,不经过服务和DBus,
+ * 可读的轮转压缩日志(.gz)在进程内解压到内存后同样从末尾逐行解码;
+ * 没有读权限时由服务打开文件并传回描述符,同样在进程内映射或解压;
+ * 服务不支持传递描述符时通过服务的倒序流式通道读取,每次只持有一块的内容,解析线程可以边读边发出数据;
+ * 服务也不支持倒序通道时退回到整个文件读取,此时作为一块返回
+ */
+class LogLineStream
+{
+public:
+    explicit LogLineStream(const QString &filePath, QObject *parent = nullptr);
+    ~LogLineStream();
+
+    bool openDirect();
+    bool readChunk(QStringList &lines);
+    /**
+     * @brief LineTimeFunc 取出一行的时间(毫秒),没有时间的行(如多行日志的后续行)返回-1
+     */
+    using LineTimeFunc = std::function<qint64(const QString &line)>;
+    /**
+     * @brief RangeReader 读取[begin, end)的内容,读不满(文件被截断)时返回false
+     */
+    using RangeReader = std::function<bool(qint64 begin, qint64 end, QByteArray &data)>;
+    bool seekTimeRange(qint64 begin, qint64 end, const LineTimeFunc &lineTime, const QString &indexKind = QString());
+    bool setRangeBegin(qint64 begin);
+    bool setRangeEnd(qint64 end);
+    void setFilter(const LogLineFilter &filter) { m_filter = filter; }
+    bool isLocal() const { return m_local; }
+    /**
+     * @brief setRecordSpans 映射读取普通文件时记下每行的字节范围(lineSpans),用于之后按位置重新读取某一行
+     */
+    void setRecordSpans(bool record) { m_recordSpans = record; }
+    /**
+     * @brief lineSpans 上一次readChunk读到的各行的字节范围,和行一一对应;压缩日志或通过服务读取时为空
+     */
+    const QVector<LogLineSpan> &lineSpans() const { return m_spans; }
+    /**
+     * @brief mappedData 进程内读取时的全部内容,openDirect成功后有效,readChunk会逐步释放,两者不要混用
+     */
+    const char *mappedData() const { return m_data; }
+    qint64 mappedSize() const { return m_size; }
+    /**
+     * @brief rangeBegin/rangeEnd 进程内读取时尚未读取的范围,按时间段定位后只包括时间段所在的部分
+     */
+    qint64 rangeBegin() const { return m_begin; }
+    qint64 rangeEnd() const { return m_pos; }
+    bool fileShrank() const;
+    static QString decodeLine(const char *data, int length);
+    /**
+     * @brief GroupKeyFunc 取出一行所属的分组(如审计事件编号),同一分组的相邻行不会被切分到两块,空表示不分组
+     */
+    using GroupKeyFunc = std::function<QByteArray(const char *line, int length)>;
+    static QVector<qint64> splitRange(const char *data, qint64 begin, qint64 end, qint64 chunkBytes,
+                                      const GroupKeyFunc &groupKey = GroupKeyFunc());
+    QVector<qint64> splitRange(qint64 chunkBytes, const GroupKeyFunc &groupKey = GroupKeyFunc()) const;
+    bool readRange(qint64 begin, qint64 end, QByteArray &data) const;
+    qint64 lastNewline(qint64 begin, qint64 end) const;
+    bool fileIdentity(quint64 &device, quint64 &inode) const;
+    static int decodeRange(const char *data, qint64 begin, qint64 end, QStringList &lines);
+    static int sampleLine(const RangeReader &read, qint64 size, qint64 offset, qint64 limit, int maxLines,
+                          const LineTimeFunc &lineTime, qint64 &lineStart, qint64 &time);
+
+private:
+    Q_DISABLE_COPY(LogLineStream)
+
+    bool openLocal();
+    bool openDescriptor();
+    bool mapOpenedFile();
+    bool readLocalChunk(QStringList &lines);
+    bool readFileChunk(QStringList &lines);
+    bool sampleTime(qint64 offset, qint64 limit, const LineTimeFunc &lineTime, qint64 &lineStart, qint64 &time) const;
+    void closeLocal();
+    void closeStream();
+    void closeFile();
+
+    QString m_filePath;
+    QObject *m_parent;
+    /**
+     * @brief m_filter 通过服务的倒序通道读取时交给服务端的筛选条件,本地读取时不生效,调用者仍需自行筛选
+     */
+    LogLineFilter m_filter;
+    /**
+     * @brief m_token 倒序流式通道token,为空表示使用整个文件读取
+     */
+    QString m_token;
+    bool m_opened = false;
+    bool m_directTried = false;
+    bool m_finished = false;
+    /**
+     * @brief m_local 是否为进程内映射读取
+     */
+    bool m_local = false;
+    QFile m_file;
+    /**
+     * @brief m_descriptor 服务打开的文件描述符,m_file映射期间需要保持有效
+     */
+    QDBusUnixFileDescriptor m_descriptor;
+    uchar *m_map = nullptr;
+    /**
+     * @brief m_inflated 压缩日志解压后的内容
+     */
+    QByteArray m_inflated;
+    /**
+     * @brief m_data 本地读取的数据,指向映射或解压后的内容
+     */
+    const char *m_data = nullptr;
+    /**
+     * @brief m_size 本地读取的数据总长度
+     */
+    qint64 m_size = 0;
+    /**
+     * @brief m_pos 映射中尚未读取部分的结束位置,从文件末尾向前移动
+     */
+    qint64 m_pos = 0;
+    /**
+     * @brief m_begin 映射中读取范围的开始位置,按时间段定位后不再读取它之前的行
+     */
+    qint64 m_begin = 0;
+    bool m_recordSpans = false;
+    QVector<LogLineSpan> m_spans;
+    /**
+     * @brief m_chunkSpans 映射读取时一块中各行的范围,按从旧到新排列,每块复用
+     */
+    QVector<LogLineSpan> m_chunkSpans;
+    /**
+     * @brief m_chunkData 映射的文件按块读取时用pread读出的一块内容,每块复用
+     */
+    QByteArray m_chunkData;
+};
+
+#endif // LOGLINESTREAM_H
@@ -9,6 +9,8 @@
 #include "logapplicationhelper.h"
 #include "dbusproxy/dldbushandler.h"
 #include "utils.h"
+#include "logtruncator.h"
+#include "logcategoryprobe.h"
 
 #include <DDesktopServices>
 #include <DDialog>
@@ -32,6 +34,8 @@
 #include <QMenu>
 #include <QShortcut>
 #include <QAbstractButton>
+#include <QLocale>
+#include <QLoggingCategory>
 #define ITEM_HEIGHT 40
 #define ITEM_WIDTH 108
 #define ICON_SIZE 16
@@ -40,6 +44,12 @@
 
 Q_DECLARE_METATYPE(QMargins)
 
+#ifdef QT_DEBUG
+Q_LOGGING_CATEGORY(logListView, "org.deepin.log.viewer.listview")
+#else
+Q_LOGGING_CATEGORY(logListView, "org.deepin.log.viewer.listview", QtInfoMsg)
+#endif
+
 DWIDGET_USE_NAMESPACE
 
 const QVariant VListViewItemMargin = QVariant::fromValue(QMargins(15, 0, 5, 0));
@@ -84,7 +94,10 @@ bool LogListDelegate::helpEvent(QHelpEvent *event, QAbstractItemView *view, cons
 {
     QToolTip::hideText();
     if (event->type() == QEvent::ToolTip) {
-        const QString tooltip = index.data(Qt::DisplayRole).toString();
+        //提示中可能带有日志的大致大小,没有单独设置时和显示文本相同
+        QString tooltip = index.data(Qt::ToolTipRole).toString();
+        if (tooltip.isEmpty())
+            tooltip = index.data(Qt::DisplayRole).toString();
         //如果tooltip不为空且合法则显示，否则直接关闭所有tooltip
         if (tooltip.isEmpty() || tooltip == "_split_") {
             hideTooltipImmediately();
@@ -136,10 +149,12 @@ LogListView::LogListView(QWidget *parent)
     });
 
     connect(LogApplicationHelper::instance(), &LogApplicationHelper::sigValueChanged, this, &LogListView::slot_valueChanged_dConfig_or_gSetting);
+    connect(LogApplicationHelper::instance(), &LogApplicationHelper::appLogsChanged, this, &LogListView::slot_appLogsChanged);
 }
 
 /**
  * @brief LogListView::initUI 设置基本属性，且本listview为固定的种类，所以在此初始化函数中根据日志文件是否存在动态显示日志种类
+ * 依赖文件或机器类型的类别由LogCategoryProbe判断:缓存有效时直接显示,否则先显示其余类别,各类别的探测结果到达时再按顺序插入
  */
 void LogListView::initUI()
 {
@@ -148,175 +163,152 @@ void LogListView::initUI()
     this->setItemDelegate(new LogListDelegate(this));
     this->setItemSpacing(0);
     this->setViewportMargins(10, 10, 10, 0);
+    setIconSize(QSize(ICON_SIZE, ICON_SIZE));
     Dtk::Core::DSysInfo::UosEdition edition = Dtk::Core::DSysInfo::uosEditionType();
     //等于服务器行业版或欧拉版(centos)
-    bool isCentos = Dtk::Core::DSysInfo::UosEuler == edition || Dtk::Core::DSysInfo::UosEnterpriseC == edition || Dtk::Core::DSysInfo::UosMilitaryS == edition;
+    m_isCentos = Dtk::Core::DSysInfo::UosEuler == edition || Dtk::Core::DSysInfo::UosEnterpriseC == edition || Dtk::Core::DSysInfo::UosMilitaryS == edition;
     m_pModel = new QStandardItemModel(this);
-    QStandardItem *item = nullptr;
-    if (isFileExist("/var/log/journal") || isCentos) {
-        item = new QStandardItem(QIcon::fromTheme("dp_system"), DApplication::translate("Tree", "System Log"));
-        setIconSize(QSize(ICON_SIZE, ICON_SIZE));
-        item->setToolTip(DApplication::translate("Tree", "System Log")); // add by Airy for bug 16245
-        item->setData(JOUR_TREE_DATA, ITEM_DATE_ROLE);
-        item->setSizeHint(QSize(ITEM_WIDTH, ITEM_HEIGHT));
-        item->setData(VListViewItemMargin, Dtk::MarginsRole);
-        m_pModel->appendRow(item);
-        m_logTypes.push_back(JOUR_TREE_DATA);
+    this->setModel(m_pModel);
+    if (m_isCentos) {
+        addCategoryItem(JOUR_TREE_DATA);
+        addCategoryItem(DMESG_TREE_DATA);
+        addCategoryItem(DNF_TREE_DATA);
     }
 
-    if (isCentos) {
-        item = new QStandardItem(QIcon::fromTheme("dp_core"), DApplication::translate("Tree", "Kernel Log"));
-        setIconSize(QSize(ICON_SIZE, ICON_SIZE));
-        item->setToolTip(DApplication::translate("Tree", "Kernel Log")); // add by Airy for bug 16245
-        item->setData(DMESG_TREE_DATA, ITEM_DATE_ROLE);
-        item->setSizeHint(QSize(ITEM_WIDTH, ITEM_HEIGHT));
-        item->setData(VListViewItemMargin, Dtk::MarginsRole);
-        m_pModel->appendRow(item);
-        m_logTypes.push_back(DMESG_TREE_DATA);
-    } else {
-        if (isFileExist("/var/log/kern.log")) {
-            item = new QStandardItem(QIcon::fromTheme("dp_core"), DApplication::translate("Tree", "Kernel Log"));
-            setIconSize(QSize(ICON_SIZE, ICON_SIZE));
-            item->setToolTip(DApplication::translate("Tree", "Kernel Log")); // add by Airy for bug 16245
-            item->setData(KERN_TREE_DATA, ITEM_DATE_ROLE);
-            item->setSizeHint(QSize(ITEM_WIDTH, ITEM_HEIGHT));
-            item->setData(VListViewItemMargin, Dtk::MarginsRole);
-            m_pModel->appendRow(item);
-            m_logTypes.push_back(KERN_TREE_DATA);
-        }
-    }
-    if (DBusManager::isSpecialComType()) {
-        item = new QStandardItem(QIcon::fromTheme("dp_start"), DApplication::translate("Tree", "Boot Log"));
-        setIconSize(QSize(ICON_SIZE, ICON_SIZE));
-        item->setToolTip(DApplication::translate("Tree", "Boot Log")); // add by Airy for bug 16245
-        item->setData(BOOT_KLU_TREE_DATA, ITEM_DATE_ROLE);
-        item->setSizeHint(QSize(ITEM_WIDTH, ITEM_HEIGHT));
-        item->setData(VListViewItemMargin, Dtk::MarginsRole);
-        m_pModel->appendRow(item);
-        m_logTypes.push_back(BOOT_KLU_TREE_DATA);
-    } else {
-        item = new QStandardItem(QIcon::fromTheme("dp_start"), DApplication::translate("Tree", "Boot Log"));
-        setIconSize(QSize(ICON_SIZE, ICON_SIZE));
-        item->setToolTip(DApplication::translate("Tree", "Boot Log")); // add by Airy for bug 16245
-        item->setData(BOOT_TREE_DATA, ITEM_DATE_ROLE);
-        item->setSizeHint(QSize(ITEM_WIDTH, ITEM_HEIGHT));
-        item->setData(VListViewItemMargin, Dtk::MarginsRole);
-        m_pModel->appendRow(item);
-        m_logTypes.push_back(BOOT_TREE_DATA);
-    }
-    if (isCentos) {
-        item = new QStandardItem(QIcon::fromTheme("dp_d"), DApplication::translate("Tree", "dnf Log"));
-        setIconSize(QSize(ICON_SIZE, ICON_SIZE));
-        item->setToolTip(DApplication::translate("Tree", "dnf Log"));
-        item->setData(DNF_TREE_DATA, ITEM_DATE_ROLE);
-        item->setSizeHint(QSize(ITEM_WIDTH, ITEM_HEIGHT));
-        item->setData(VListViewItemMargin, Dtk::MarginsRole);
-        m_pModel->appendRow(item);
-        m_logTypes.push_back(DNF_TREE_DATA);
-    } else {
-        if (isFileExist("/var/log/dpkg.log")) {
-            item = new QStandardItem(QIcon::fromTheme("dp_d"), DApplication::translate("Tree", "dpkg Log"));
-            setIconSize(QSize(ICON_SIZE, ICON_SIZE));
-            item->setToolTip(DApplication::translate("Tree", "dpkg Log")); // add by Airy for bug 16245
-            item->setData(DPKG_TREE_DATA, ITEM_DATE_ROLE);
-            item->setSizeHint(QSize(ITEM_WIDTH, ITEM_HEIGHT));
-            item->setData(VListViewItemMargin, Dtk::MarginsRole);
-            m_pModel->appendRow(item);
-            m_logTypes.push_back(DPKG_TREE_DATA);
-        }
-    }
-    //w515是新版本内核的panguv返回值  panguV是老版本
-    if (DBusManager::isSpecialComType()) {
-        item = new QStandardItem(QIcon::fromTheme("dp_kwin"), DApplication::translate("Tree", "Kwin Log"));
-        setIconSize(QSize(ICON_SIZE, ICON_SIZE));
-        item->setToolTip(DApplication::translate("Tree", "Kwin Log"));
-        item->setData(KWIN_TREE_DATA, ITEM_DATE_ROLE);
-        item->setSizeHint(QSize(ITEM_WIDTH, ITEM_HEIGHT));
-        item->setData(VListViewItemMargin, Dtk::MarginsRole);
-        m_pModel->appendRow(item);
-        m_logTypes.push_back(KWIN_TREE_DATA);
-    } else {
-        item = new QStandardItem(QIcon::fromTheme("dp_x"), DApplication::translate("Tree", "Xorg Log"));
-        setIconSize(QSize(ICON_SIZE, ICON_SIZE));
-        item->setToolTip(DApplication::translate("Tree", "Xorg Log")); // add by Airy for bug 16245
-        item->setData(XORG_TREE_DATA, ITEM_DATE_ROLE);
-        item->setSizeHint(QSize(ITEM_WIDTH, ITEM_HEIGHT));
-        item->setData(VListViewItemMargin, Dtk::MarginsRole);
-        m_pModel->appendRow(item);
-        m_logTypes.push_back(XORG_TREE_DATA);
-    }
+    //应用日志在后台扫描,没有缓存时扫描结束后再插入
     auto *appHelper = LogApplicationHelper::instance();
     QMap<QString, QString> appMap = appHelper->getMap();
     if (!appMap.isEmpty()) {
-        item = new QStandardItem(QIcon::fromTheme("dp_application"), DApplication::translate("Tree", "Application Log"));
-        setIconSize(QSize(ICON_SIZE, ICON_SIZE));
-        item->setToolTip(
-            DApplication::translate("Tree", "Application Log")); // add by Airy for bug 16245
-        item->setData(APP_TREE_DATA, ITEM_DATE_ROLE);
-        item->setSizeHint(QSize(ITEM_WIDTH, ITEM_HEIGHT));
-        item->setData(VListViewItemMargin, Dtk::MarginsRole);
-        m_pModel->appendRow(item);
-        this->setModel(m_pModel);
-        m_logTypes.push_back(APP_TREE_DATA);  
+        initAppLogItem();
     }
 
     // coredump log
-    item = new QStandardItem(QIcon::fromTheme("dp_customlog"), DApplication::translate("Tree", "Coredump Log"));
-    setIconSize(QSize(ICON_SIZE, ICON_SIZE));
-    item->setToolTip(DApplication::translate("Tree", "Coredump Log"));
-    item->setData(COREDUMP_TREE_DATA, ITEM_DATE_ROLE);
-    item->setSizeHint(QSize(ITEM_WIDTH, ITEM_HEIGHT));
-    item->setData(VListViewItemMargin, Dtk::MarginsRole);
-    m_pModel->appendRow(item);
-    m_logTypes.push_back(COREDUMP_TREE_DATA);
-
-
-    // add by Airy
-    if (isFileExist("/var/log/wtmp")) {
-        item = new QStandardItem(QIcon::fromTheme("dp_onoff"), DApplication::translate("Tree", "Boot-Shutdown Event"));
-        setIconSize(QSize(ICON_SIZE, ICON_SIZE));
-        item->setData(LAST_TREE_DATA, ITEM_DATE_ROLE);
-        item->setToolTip(
-            DApplication::translate("Tree", "Boot-Shutdown Event")); // add by Airy for bug 16245
-        item->setSizeHint(QSize(ITEM_WIDTH, ITEM_HEIGHT));
-        item->setData(VListViewItemMargin, Dtk::MarginsRole);
-        m_pModel->appendRow(item);
-        this->setModel(m_pModel);
-        m_logTypes.push_back(LAST_TREE_DATA);
-    }
+    addCategoryItem(COREDUMP_TREE_DATA);
 
     //other
-    item = new QStandardItem(QIcon::fromTheme("dp_customlog", QIcon(":/customlog.svg")), DApplication::translate("Tree", "Other Log"));
-    setIconSize(QSize(ICON_SIZE, ICON_SIZE));
-    item->setToolTip(DApplication::translate("Tree", "Other Log"));
-    item->setData(OTHER_TREE_DATA, ITEM_DATE_ROLE);
-    item->setSizeHint(QSize(ITEM_WIDTH, ITEM_HEIGHT));
-    item->setData(VListViewItemMargin, Dtk::MarginsRole);
-    m_pModel->appendRow(item);
-    m_logTypes.push_back(OTHER_TREE_DATA);
+    addCategoryItem(OTHER_TREE_DATA);
 
     //custom
     if (LogApplicationHelper::instance()->getCustomLogList().size()) {
-        m_logTypes.push_back(CUSTOM_TREE_DATA);
         initCustomLogItem();
     }
 
-    // 审计日志文件存在，才加载和显示审计日志模块（审计日志文件需要root权限访问，因此在service服务中判断审计日志文件是否存在）
-    if (DLDBusHandler::instance(this)->isFileExist(AUDIT_TREE_DATA)) {
-        item = new QStandardItem(QIcon::fromTheme("dp_customlog"), DApplication::translate("Tree", "Audit Log"));
-        setIconSize(QSize(ICON_SIZE, ICON_SIZE));
-        item->setToolTip(DApplication::translate("Tree", "Audit Log"));
-        item->setData(AUDIT_TREE_DATA, ITEM_DATE_ROLE);
-        item->setSizeHint(QSize(ITEM_WIDTH, ITEM_HEIGHT));
-        item->setData(VListViewItemMargin, Dtk::MarginsRole);
-        m_pModel->appendRow(item);
-        m_logTypes.push_back(AUDIT_TREE_DATA);
+    LogCategoryProbe *probe = LogCategoryProbe::instance();
+    connect(probe, &LogCategoryProbe::categoryProbed, this, &LogListView::slot_categoryProbed);
+    LogCategoryProbeResult cached;
+    if (probe->cachedResult(&cached)) {
+        for (const LogCategoryState &state : cached.states)
+            slot_categoryProbed(state);
+    } else {
+        probe->start();
     }
 
     // set first item is select when app start
     if (m_pModel->rowCount() > 0) {
         this->setCurrentIndex(m_pModel->index(0, 0));
-    }  
+    }
+}
+
+/**
+ * @brief LogListView::categoryOrder 各类别在列表中的顺序,后插入的类别按此顺序放到对应位置
+ */
+QStringList LogListView::categoryOrder()
+{
+    return QStringList() << JOUR_TREE_DATA << DMESG_TREE_DATA << KERN_TREE_DATA << BOOT_KLU_TREE_DATA << BOOT_TREE_DATA
+                         << DNF_TREE_DATA << DPKG_TREE_DATA << KWIN_TREE_DATA << XORG_TREE_DATA << APP_TREE_DATA
+                         << COREDUMP_TREE_DATA << LAST_TREE_DATA << OTHER_TREE_DATA << CUSTOM_TREE_DATA << AUDIT_TREE_DATA;
+}
+
+/**
+ * @brief LogListView::addCategoryItem 创建一个类别的列表项并插入到对应位置
+ * @param type 类别,即列表项的ITEM_DATE_ROLE数据
+ * @param size 来源文件的大致大小,大于等于0时显示在提示中
+ */
+void LogListView::addCategoryItem(const QString &type, qint64 size)
+{
+    QString iconName;
+    QString fallbackIcon;
+    QString text;
+    if (type == JOUR_TREE_DATA) {
+        iconName = "dp_system";
+        text = DApplication::translate("Tree", "System Log");
+    } else if (type == KERN_TREE_DATA || type == DMESG_TREE_DATA) {
+        iconName = "dp_core";
+        text = DApplication::translate("Tree", "Kernel Log");
+    } else if (type == BOOT_TREE_DATA || type == BOOT_KLU_TREE_DATA) {
+        iconName = "dp_start";
+        text = DApplication::translate("Tree", "Boot Log");
+    } else if (type == DPKG_TREE_DATA) {
+        iconName = "dp_d";
+        text = DApplication::translate("Tree", "dpkg Log");
+    } else if (type == DNF_TREE_DATA) {
+        iconName = "dp_d";
+        text = DApplication::translate("Tree", "dnf Log");
+    } else if (type == KWIN_TREE_DATA) {
+        iconName = "dp_kwin";
+        text = DApplication::translate("Tree", "Kwin Log");
+    } else if (type == XORG_TREE_DATA) {
+        iconName = "dp_x";
+        text = DApplication::translate("Tree", "Xorg Log");
+    } else if (type == COREDUMP_TREE_DATA) {
+        iconName = "dp_customlog";
+        text = DApplication::translate("Tree", "Coredump Log");
+    } else if (type == LAST_TREE_DATA) {
+        // add by Airy
+        iconName = "dp_onoff";
+        text = DApplication::translate("Tree", "Boot-Shutdown Event");
+    } else if (type == OTHER_TREE_DATA) {
+        iconName = "dp_customlog";
+        fallbackIcon = ":/customlog.svg";
+        text = DApplication::translate("Tree", "Other Log");
+    } else if (type == AUDIT_TREE_DATA) {
+        iconName = "dp_customlog";
+        text = DApplication::translate("Tree", "Audit Log");
+    } else {
+        return;
+    }
+
+    QStandardItem *item = new QStandardItem(QIcon::fromTheme(iconName, QIcon(fallbackIcon)), text);
+    item->setToolTip(size >= 0 ? DApplication::translate("Tree", "%1 (about %2)").arg(text).arg(QLocale().formattedDataSize(size))
+                               : text); // add by Airy for bug 16245
+    item->setData(type, ITEM_DATE_ROLE);
+    item->setSizeHint(QSize(ITEM_WIDTH, ITEM_HEIGHT));
+    item->setData(VListViewItemMargin, Dtk::MarginsRole);
+    insertCategoryItem(item);
+}
+
+/**
+ * @brief LogListView::insertCategoryItem 按categoryOrder的顺序插入列表项,同时更新日志类型列表
+ * 用户还没有选择过类别时,插入到第一行的类别成为默认选中的类别
+ */
+void LogListView::insertCategoryItem(QStandardItem *item)
+{
+    const QStringList order = categoryOrder();
+    const QString type = item->data(ITEM_DATE_ROLE).toString();
+    const int rank = order.indexOf(type);
+    int row = m_pModel->rowCount();
+    for (int i = 0; i < m_pModel->rowCount(); ++i) {
+        if (order.indexOf(m_pModel->index(i, 0).data(ITEM_DATE_ROLE).toString()) > rank) {
+            row = i;
+            break;
+        }
+    }
+    const bool selectInserted = row == 0 && !m_userSelected && currentIndex().row() == 0;
+    m_pModel->insertRow(row, item);
+
+    if (!m_logTypes.contains(type)) {
+        int typeIndex = m_logTypes.size();
+        for (int i = 0; i < m_logTypes.size(); ++i) {
+            if (order.indexOf(m_logTypes.at(i)) > rank) {
+                typeIndex = i;
+                break;
+            }
+        }
+        m_logTypes.insert(typeIndex, type);
+    }
+
+    if (selectInserted)
+        setCurrentIndex(m_pModel->index(0, 0));
 }
 
 void LogListView::initCustomLogItem()
@@ -325,12 +317,28 @@ void LogListView::initCustomLogItem()
         m_customLogItem = new QStandardItem(QIcon::fromTheme("dp_customlog", QIcon(":/customlog.svg")), DApplication::translate("Tree", "Custom Log"));
     }
 
-    setIconSize(QSize(ICON_SIZE, ICON_SIZE));
     m_customLogItem->setToolTip(DApplication::translate("Tree", "Custom Log"));
     m_customLogItem->setData(CUSTOM_TREE_DATA, ITEM_DATE_ROLE);
     m_customLogItem->setSizeHint(QSize(ITEM_WIDTH, ITEM_HEIGHT));
     m_customLogItem->setData(VListViewItemMargin, Dtk::MarginsRole);
-    m_pModel->appendRow(m_customLogItem);
+    insertCategoryItem(m_customLogItem);
+}
+
+/**
+ * @brief LogListView::initAppLogItem 在崩溃日志之前插入应用日志项
+ */
+void LogListView::initAppLogItem()
+{
+    if (!m_appLogItem) {
+        m_appLogItem = new QStandardItem(QIcon::fromTheme("dp_application"), DApplication::translate("Tree", "Application Log"));
+    }
+
+    m_appLogItem->setToolTip(
+        DApplication::translate("Tree", "Application Log")); // add by Airy for bug 16245
+    m_appLogItem->setData(APP_TREE_DATA, ITEM_DATE_ROLE);
+    m_appLogItem->setSizeHint(QSize(ITEM_WIDTH, ITEM_HEIGHT));
+    m_appLogItem->setData(VListViewItemMargin, Dtk::MarginsRole);
+    insertCategoryItem(m_appLogItem);
 }
 
 void LogListView::setDefaultSelect()
@@ -340,14 +348,20 @@ void LogListView::setDefaultSelect()
 }
 
 /**
- * @brief LogListView::isFileExist 判断文件路径是否存在
- * @param iFile 要判断的文件路径字符串
- * @return
+ * @brief LogListView::selectCategory 选中type对应的类别,已选中时不重复发出itemChanged
+ * @param type 类别数据,如OTHER_TREE_DATA
+ * @return 列表中是否有该类别
  */
-bool LogListView::isFileExist(const QString &iFile)
+bool LogListView::selectCategory(const QString &type)
 {
-    QFile file(iFile);
-    return file.exists();
+    for (int i = 0; i < m_pModel->rowCount(); ++i) {
+        const QModelIndex index = m_pModel->index(i, 0);
+        if (index.data(ITEM_DATE_ROLE).toString() == type) {
+            setCurrentIndex(index);
+            return true;
+        }
+    }
+    return false;
 }
 
 /**
@@ -385,27 +399,51 @@ void LogListView::currentChanged(const QModelIndex &current, const QModelIndex &
 
 /**
  * @author Airy
- * @brief LogListView::truncateFile 清空日志文件内容
+ * @brief LogListView::truncateFile 清空日志文件内容,连同轮转的旧日志一次提权清空
+ * 清空后发出sigLogCleared,只让涉及这些文件的缓存失效
  * @param path_
  */
 void LogListView::truncateFile(QString path_)
 {
-    QProcess prc;
+    QStringList targets;
+    bool privileged = true;
     if (path_ == KERN_TREE_DATA || path_ == BOOT_TREE_DATA || path_ == DPKG_TREE_DATA || path_ == KWIN_TREE_DATA) {
-        prc.start("pkexec", QStringList() << "logViewerTruncate" << path_.append("*"));
+        targets << path_.append("*");
     } else if (path_ == XORG_TREE_DATA) {
-        path_ = "/var/log/Xorg*.log*";
-        prc.start("pkexec", QStringList() << "logViewerTruncate" << path_);
+        targets << "/var/log/Xorg*.log*";
     } else if (path_ == DNF_TREE_DATA) {
-        path_ = "/var/log/dnf*.log*";
-        prc.start("pkexec", QStringList() << "logViewerTruncate" << path_);
+        targets << "/var/log/dnf*.log*";
+    } else if (path_ == DMESG_TREE_DATA) {
+        targets << LOG_TRUNCATE_DMESG;
+    } else {
+        //应用日志属于当前用户,不需要提权
+        targets << path_.append("*");
+        privileged = false;
+    }
+
+    QList<LogTruncateResult> results;
+    if (privileged) {
+        QProcess prc;
+        prc.start("pkexec", QStringList() << "logViewerTruncate" << targets);
+        prc.waitForFinished(-1);
+        results = LogTruncator::fromText(prc.readAllStandardOutput());
     } else {
-        QStringList arg;
-        arg << "-c" << QString("truncate -s 0 %1").arg(path_.append("*"));
-        prc.start("/bin/bash", arg);
+        results = LogTruncator::truncate(targets);
     }
 
-    prc.waitForFinished();
+    QStringList files;
+    qint64 freed = 0;
+    for (const LogTruncateResult &result : results) {
+        if (!result.ok) {
+            qCWarning(logListView) << "truncate failed:" << result.path << result.error;
+            continue;
+        }
+        files << result.path;
+        freed += result.freed;
+    }
+    qCInfo(logListView) << "cleared" << files.size() << "files," << freed << "bytes freed";
+    if (!files.isEmpty())
+        emit sigLogCleared(files, freed);
 }
 
 /**
@@ -518,6 +556,7 @@ void LogListView::mouseMoveEvent(QMouseEvent *event)
 
 void LogListView::keyPressEvent(QKeyEvent *event)
 {
+    m_userSelected = true;
     if (event->key() == Qt::Key_Up) {
         if (currentIndex().row() == 0) {
             QModelIndex modelIndex = model()->index(model()->rowCount() - 1, 0);
@@ -539,6 +578,7 @@ void LogListView::keyPressEvent(QKeyEvent *event)
 
 void LogListView::mousePressEvent(QMouseEvent *event)
 {
+    m_userSelected = true;
     if (event->button() == Qt::RightButton) {
         emit clicked(indexAt(event->pos()));
     }
@@ -571,6 +611,49 @@ void LogListView::slot_valueChanged_dConfig_or_gSetting(const QString &key)
             }
             m_pModel->removeRow(m_customLogItem->row());
             m_customLogItem = nullptr;
+            m_logTypes.removeAll(CUSTOM_TREE_DATA);
+        }
+    }
+}
+
+/**
+ * @brief LogListView::slot_appLogsChanged 后台扫描结束,应用日志从无到有时插入,全部消失时移除
+ */
+void LogListView::slot_appLogsChanged()
+{
+    bool hasApp = !LogApplicationHelper::instance()->getMap().isEmpty();
+    bool shown = m_appLogItem && m_pModel->indexFromItem(m_appLogItem).isValid();
+    if (hasApp && !shown) {
+        initAppLogItem();
+    } else if (!hasApp && shown) {
+        // set first item is select
+        if (currentIndex() == m_appLogItem->index()) {
+            this->setCurrentIndex(m_pModel->index(0, 0));
         }
+        m_pModel->removeRow(m_appLogItem->row());
+        m_appLogItem = nullptr;
+        m_logTypes.removeAll(APP_TREE_DATA);
     }
 }
+
+/**
+ * @brief LogListView::slot_categoryProbed 一个类别的探测结果到达,可用时插入对应的列表项
+ * 机器类型的结果决定显示哪一种启动日志,以及显示Kwin日志还是Xorg日志
+ */
+void LogListView::slot_categoryProbed(const LogCategoryState &state)
+{
+    if (state.type == BOOT_KLU_TREE_DATA) {
+        //w515是新版本内核的panguv返回值  panguV是老版本
+        if (!m_logTypes.contains(BOOT_KLU_TREE_DATA) && !m_logTypes.contains(BOOT_TREE_DATA)) {
+            addCategoryItem(state.available ? BOOT_KLU_TREE_DATA : BOOT_TREE_DATA);
+            addCategoryItem(state.available ? KWIN_TREE_DATA : XORG_TREE_DATA);
+        }
+        return;
+    }
+    //服务器版的系统、内核和dnf日志不依赖文件探测
+    if (m_isCentos && (state.type == JOUR_TREE_DATA || state.type == KERN_TREE_DATA || state.type == DPKG_TREE_DATA))
+        return;
+    if (!state.available || m_logTypes.contains(state.type))
+        return;
+    addCategoryItem(state.type, state.size);
+}
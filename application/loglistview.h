@@ -6,6 +6,7 @@
 #define LOGLISTVIEW_H
 
 #include "structdef.h"
+#include "logcategoryprobe.h"
 
 #include <DApplicationHelper>
 #include <DStyledItemDelegate>
@@ -34,18 +35,24 @@ public:
     explicit LogListView(QWidget *parent = nullptr);
     void initUI();
     void setDefaultSelect();
+    bool selectCategory(const QString &type);
     void truncateFile(QString path_); //add by Airy for truncate file
     QStringList getLogTypes() { return m_logTypes; }
 
 private:
-    bool isFileExist(const QString &iFile);
+    static QStringList categoryOrder();
+    void addCategoryItem(const QString &type, qint64 size = -1);
+    void insertCategoryItem(QStandardItem *item);
     void initCustomLogItem();
+    void initAppLogItem();
 public slots:
     void slot_getAppPath(int id, const QString &path); // add by Airy
     Qt::FocusReason focusReson();
     void showRightMenu(const QPoint &pos, bool isUsePoint);
     void requestshowRightMenu(const QPoint &pos);
     void slot_valueChanged_dConfig_or_gSetting(const QString &key);
+    void slot_appLogsChanged();
+    void slot_categoryProbed(const LogCategoryState &state);
 
 protected:
     void paintEvent(QPaintEvent *event) override;
@@ -58,6 +65,10 @@ protected:
 signals:
     void itemChanged(const QModelIndex &index);
     void sigRefresh(const QModelIndex &index); // add refresh
+    /**
+     * @brief sigLogCleared 清除日志后发出,files为实际清空的文件,freed为释放的字节数
+     */
+    void sigLogCleared(const QStringList &files, qint64 freed);
 
 private:
     QStandardItemModel *m_pModel {nullptr};
@@ -73,6 +84,11 @@ private:
     Qt::FocusReason m_reson = Qt::MouseFocusReason;
     QStringList m_logTypes;
     QStandardItem *m_customLogItem = nullptr;
+    QStandardItem *m_appLogItem = nullptr;
+    //等于服务器行业版或欧拉版(centos)
+    bool m_isCentos = false;
+    //用户是否点击或用按键选择过类别,没有时后到的探测结果插入第一行后选中该行
+    bool m_userSelected = false;
 };
 
 #endif // LOGLISTVIEW_H
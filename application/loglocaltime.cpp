@@ -0,0 +1,183 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "loglocaltime.h"
+
+#include <QDateTime>
+#include <QTimeZone>
+
+#include <limits>
+
+namespace {
+const qint64 dayMSecs = 86400000LL;
+//1970-01-01的儒略日
+const qint64 epochJulianDay = 2440588;
+//当地时间离切换点不到一天时交给QDateTime,任何时区一次切换的偏移变化都小于一天
+const qint64 transitionMargin = dayMSecs;
+//没有切换点时区间的两端,留出余量免得加减时溢出
+const qint64 unbounded = std::numeric_limits<qint64>::max() / 4;
+
+/**
+ * @brief The OffsetRange struct 时区偏移不变的区间[begin, end),单位为UTC毫秒
+ */
+struct OffsetRange {
+    qint64 begin = 0;
+    qint64 end = 0;
+    qint64 offset = 0;
+};
+
+//每个线程一份,解析线程之间不加锁
+OffsetRange &cachedRange()
+{
+    static thread_local OffsetRange range;
+    return range;
+}
+
+/**
+ * @brief rangeOf msecs所在的偏移不变区间,不在缓存的区间内时按系统时区的切换点重新计算
+ */
+const OffsetRange &rangeOf(qint64 msecs)
+{
+    OffsetRange &range = cachedRange();
+    if (msecs >= range.begin && msecs < range.end)
+        return range;
+
+    const QDateTime dt = QDateTime::fromMSecsSinceEpoch(msecs);
+    range.offset = dt.offsetFromUtc() * 1000LL;
+    range.begin = -unbounded;
+    range.end = unbounded;
+    const QTimeZone zone = QTimeZone::systemTimeZone();
+    if (zone.hasTransitions()) {
+        const QTimeZone::OffsetData previous = zone.previousTransition(dt.addMSecs(1));
+        if (previous.atUtc.isValid())
+            range.begin = previous.atUtc.toMSecsSinceEpoch();
+        const QTimeZone::OffsetData next = zone.nextTransition(dt);
+        if (next.atUtc.isValid())
+            range.end = next.atUtc.toMSecsSinceEpoch();
+    }
+    //切换数据和QDateTime不一致时只缓存这一毫秒,不会用错偏移
+    if (range.begin > msecs || range.end <= msecs) {
+        range.begin = msecs;
+        range.end = msecs + 1;
+    }
+    return range;
+}
+
+qint64 floorDiv(qint64 value, qint64 divisor)
+{
+    return value >= 0 ? value / divisor : -((-value - 1) / divisor) - 1;
+}
+
+void putDigits(char *out, int value, int count)
+{
+    for (int i = count - 1; i >= 0; --i) {
+        out[i] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    }
+}
+
+//从pos开始读取count位十进制数字,不是数字时返回-1
+int readNumber(const QString &text, int pos, int count)
+{
+    int value = 0;
+    for (int i = pos; i < pos + count; ++i) {
+        const ushort c = text.at(i).unicode();
+        if (c < '0' || c > '9')
+            return -1;
+        value = value * 10 + (c - '0');
+    }
+    return value;
+}
+}
+
+/**
+ * @brief LogLocalTime::offsetMSecs 时间戳处的时区偏移,当地时间为msecs加上偏移
+ * @param begin 不为空时写入偏移不变区间的开始(UTC毫秒)
+ * @param end 不为空时写入偏移不变区间的结束(不含)
+ * @return 偏移的毫秒数
+ */
+qint64 LogLocalTime::offsetMSecs(qint64 msecs, qint64 *begin, qint64 *end)
+{
+    const OffsetRange &range = rangeOf(msecs);
+    if (begin)
+        *begin = range.begin;
+    if (end)
+        *end = range.end;
+    return range.offset;
+}
+
+/**
+ * @brief LogLocalTime::toMSecs 当地时间换算为毫秒时间戳,结果和QDateTime(date, time).toMSecsSinceEpoch()一致
+ * @param date 有效的日期
+ */
+qint64 LogLocalTime::toMSecs(const QDate &date, int hour, int minute, int second, int msecs)
+{
+    const qint64 local = (date.toJulianDay() - epochJulianDay) * dayMSecs + ((hour * 60 + minute) * 60 + second) * 1000LL + msecs;
+    //先按上次的偏移猜测时间戳所在的区间,换算后仍远离区间两端时才可以直接使用
+    const OffsetRange &range = rangeOf(local - cachedRange().offset);
+    const qint64 utc = local - range.offset;
+    if (utc - range.begin >= transitionMargin && range.end - utc > transitionMargin)
+        return utc;
+    return QDateTime(date, QTime(hour, minute, second, msecs)).toMSecsSinceEpoch();
+}
+
+/**
+ * @brief LogLocalTime::parse "yyyy-MM-dd hh:mm:ss"或带".zzz"毫秒的当地时间文本换算为毫秒时间戳,之后的文字忽略
+ * 只按固定位置取数字,不经过QDateTime::fromString的格式解析
+ * @return 毫秒时间戳,格式不符或日期时间无效时为-1
+ */
+qint64 LogLocalTime::parse(const QString &text)
+{
+    if (text.size() < 19 || text.at(4) != QLatin1Char('-') || text.at(7) != QLatin1Char('-') || text.at(10) != QLatin1Char(' ')
+            || text.at(13) != QLatin1Char(':') || text.at(16) != QLatin1Char(':'))
+        return -1;
+    int msecs = 0;
+    if (text.size() >= 23 && text.at(19) == QLatin1Char('.'))
+        msecs = readNumber(text, 20, 3);
+    const int year = readNumber(text, 0, 4);
+    const int month = readNumber(text, 5, 2);
+    const int day = readNumber(text, 8, 2);
+    const int hour = readNumber(text, 11, 2);
+    const int minute = readNumber(text, 14, 2);
+    const int second = readNumber(text, 17, 2);
+    if (!QDate::isValid(year, month, day) || !QTime::isValid(hour, minute, second, msecs))
+        return -1;
+    return toMSecs(QDate(year, month, day), hour, minute, second, msecs);
+}
+
+/**
+ * @brief LogLocalTime::format 毫秒时间戳格式化为当地时间"yyyy-MM-dd hh:mm:ss",结果和QDateTime::toString一致
+ * @param withMSecs 是否带".zzz"毫秒
+ */
+QString LogLocalTime::format(qint64 msecs, bool withMSecs)
+{
+    const qint64 local = msecs + rangeOf(msecs).offset;
+    const qint64 day = floorDiv(local, dayMSecs);
+    int year = 0;
+    int month = 0;
+    int dayOfMonth = 0;
+    QDate::fromJulianDay(day + epochJulianDay).getDate(&year, &month, &dayOfMonth);
+    //四位年份以外的少见时间按原来的方式格式化
+    if (year < 0 || year > 9999)
+        return QDateTime::fromMSecsSinceEpoch(msecs).toString(withMSecs ? "yyyy-MM-dd hh:mm:ss.zzz" : "yyyy-MM-dd hh:mm:ss");
+
+    const int inDay = static_cast<int>(local - day * dayMSecs);
+    char text[23] = {0, 0, 0, 0, '-', 0, 0, '-', 0, 0, ' ', 0, 0, ':', 0, 0, ':', 0, 0, '.', 0, 0, 0};
+    putDigits(text, year, 4);
+    putDigits(text + 5, month, 2);
+    putDigits(text + 8, dayOfMonth, 2);
+    putDigits(text + 11, inDay / 3600000, 2);
+    putDigits(text + 14, inDay / 60000 % 60, 2);
+    putDigits(text + 17, inDay / 1000 % 60, 2);
+    putDigits(text + 20, inDay % 1000, 3);
+    return QString::fromLatin1(text, withMSecs ? 23 : 19);
+}
+
+/**
+ * @brief LogLocalTime::dateOf 时间戳所在的当地日期
+ */
+QDate LogLocalTime::dateOf(qint64 msecs)
+{
+    return QDate::fromJulianDay(floorDiv(msecs + rangeOf(msecs).offset, dayMSecs) + epochJulianDay);
+}
@@ -0,0 +1,27 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGLOCALTIME_H
+#define LOGLOCALTIME_H
+
+#include <QDate>
+#include <QString>
+
+/**
+ * @brief The LogLocalTime class 毫秒时间戳和当地时间的换算与格式化,各解析线程、表格和导出共用
+ * 每个线程缓存时区偏移不变的区间(两次夏令时切换之间),区间内只做整数运算,不经过QDateTime的时区解析;
+ * 当地时间换算为时间戳时如果靠近切换点(前后一天内),交给QDateTime处理,不存在和重复的时刻和QDateTime结果一致
+ */
+class LogLocalTime
+{
+public:
+    static qint64 offsetMSecs(qint64 msecs, qint64 *begin = nullptr, qint64 *end = nullptr);
+    static qint64 toMSecs(const QDate &date, int hour, int minute, int second, int msecs = 0);
+    static qint64 parse(const QString &text);
+    static QString format(qint64 msecs, bool withMSecs = false);
+    static QString formatSecs(qint64 secs) { return format(secs * 1000); }
+    static QDate dateOf(qint64 msecs);
+};
+
+#endif // LOGLOCALTIME_H
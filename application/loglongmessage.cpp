@@ -0,0 +1,108 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "loglongmessage.h"
+#include "loglinestream.h"
+#include "dbusproxy/dldbushandler.h"
+
+#include <QLoggingCategory>
+
+#ifdef QT_DEBUG
+Q_LOGGING_CATEGORY(logLongMessage, "org.deepin.log.viewer.long.message")
+#else
+Q_LOGGING_CATEGORY(logLongMessage, "org.deepin.log.viewer.long.message", QtInfoMsg)
+#endif
+
+LogLongMessage::LogLongMessage()
+{
+}
+
+/**
+ * @brief LogLongMessage::shorten 信息超过LOG_LONG_MESSAGE_PREFIX个字符时只保留前缀
+ * @param record msg为完整信息的记录
+ * @param ref 完整信息的位置,为空时完整信息保存在detailInfo中
+ * @return 是否被截断
+ */
+bool LogLongMessage::shorten(LOG_MSG_APPLICATOIN &record, const LOG_MESSAGE_REF &ref)
+{
+    if (record.msg.size() <= LOG_LONG_MESSAGE_PREFIX)
+        return false;
+    if (ref.isNull())
+        record.detailInfo = record.msg;
+    else
+        record.fullRef = ref;
+    record.msg.truncate(LOG_LONG_MESSAGE_PREFIX);
+    return true;
+}
+
+/**
+ * @brief LogLongMessage::fullText 取记录的完整信息,读取失败或文件已改变时返回前缀
+ */
+QString LogLongMessage::fullText(const LOG_MSG_APPLICATOIN &record)
+{
+    if (!record.detailInfo.isEmpty())
+        return record.detailInfo;
+    if (!record.fullRef.cursor.isEmpty()) {
+        const QString full = m_journal.message(record.fullRef.cursor);
+        return full.isEmpty() ? record.msg : full;
+    }
+    if (record.fullRef.offset < 0)
+        return record.msg;
+
+    const QString full = readFile(record.fullRef);
+    //文件被轮转或改写后同一位置不再是这一行
+    if (!full.startsWith(record.msg)) {
+        qCWarning(logLongMessage) << "message changed in file:" << record.fullRef.path << record.fullRef.offset;
+        return record.msg;
+    }
+    return full;
+}
+
+/**
+ * @brief LogLongMessage::resolve 把msg补全为完整信息并清除引用,用于导出
+ */
+void LogLongMessage::resolve(LOG_MSG_APPLICATOIN &record)
+{
+    if (record.detailInfo.isEmpty() && record.fullRef.isNull())
+        return;
+    record.msg = fullText(record);
+    record.detailInfo.clear();
+    record.fullRef = LOG_MESSAGE_REF();
+}
+
+/**
+ * @brief LogLongMessage::readFile 读取引用的字节范围,按和读取时相同的规则解码后去掉行首的部分
+ */
+QString LogLongMessage::readFile(const LOG_MESSAGE_REF &ref)
+{
+    if (!openFile(ref.path) || !m_file.seek(ref.offset))
+        return QString();
+    const QByteArray data = m_file.read(ref.length);
+    if (data.size() != ref.length)
+        return QString();
+    return LogLineStream::decodeLine(data.constData(), data.size()).mid(ref.skip);
+}
+
+/**
+ * @brief LogLongMessage::openFile 打开引用所在的文件,当前用户不可读时由服务打开
+ */
+bool LogLongMessage::openFile(const QString &path)
+{
+    if (path == m_path)
+        return m_file.isOpen();
+
+    m_file.close();
+    m_descriptor = QDBusUnixFileDescriptor();
+    m_path = path;
+    m_file.setFileName(path);
+    if (m_file.open(QIODevice::ReadOnly))
+        return true;
+
+    m_descriptor = DLDBusHandler::instance()->openLogFile(path);
+    if (m_descriptor.isValid() && m_file.open(m_descriptor.fileDescriptor(), QIODevice::ReadOnly))
+        return true;
+    qCWarning(logLongMessage) << "open file failed:" << path;
+    m_descriptor = QDBusUnixFileDescriptor();
+    return false;
+}
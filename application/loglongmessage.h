@@ -0,0 +1,46 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGLONGMESSAGE_H
+#define LOGLONGMESSAGE_H
+
+#include "journalreader.h"
+#include "structdef.h"
+
+#include <QDBusUnixFileDescriptor>
+#include <QFile>
+#include <QString>
+
+//列表中的信息最多保存的字符数,更长的信息只保存这一前缀,完整内容按LOG_MESSAGE_REF读取
+#define LOG_LONG_MESSAGE_PREFIX 500
+
+/**
+ * @brief The LogLongMessage class 过长信息的统一处理:记录中只保存显示用的前缀和完整内容的位置,
+ * 打开详情或导出时再从文件的字节范围或journal条目读取完整内容,不再在每条记录中同时保存截断和完整的两份
+ * 同一对象内复用打开的文件和journal句柄,不能跨线程使用
+ */
+class LogLongMessage
+{
+public:
+    LogLongMessage();
+
+    static bool shorten(LOG_MSG_APPLICATOIN &record, const LOG_MESSAGE_REF &ref);
+    QString fullText(const LOG_MSG_APPLICATOIN &record);
+    void resolve(LOG_MSG_APPLICATOIN &record);
+
+private:
+    Q_DISABLE_COPY(LogLongMessage)
+
+    QString readFile(const LOG_MESSAGE_REF &ref);
+    bool openFile(const QString &path);
+
+    JournalMessageResolver m_journal;
+    QFile m_file;
+    //没有读权限时由服务打开的文件描述符,读取期间需要保持有效
+    QDBusUnixFileDescriptor m_descriptor;
+    //m_file对应的路径,打开失败时也记下,不再重试
+    QString m_path;
+};
+
+#endif // LOGLONGMESSAGE_H
@@ -0,0 +1,74 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logmatchnavigator.h"
+
+#include <algorithm>
+#include <iterator>
+
+/**
+ * @brief LogMatchNavigator::add 追加一批升序的匹配行
+ * 通常整批都在已有的行之后,直接追加;复用上一次结果等情况下有交叉时合并并去重
+ */
+void LogMatchNavigator::add(const QVector<int> &rows)
+{
+    if (rows.isEmpty())
+        return;
+    if (m_rows.isEmpty() || rows.first() > m_rows.last()) {
+        m_rows += rows;
+        if (std::is_sorted(rows.constBegin(), rows.constEnd()))
+            return;
+        std::sort(m_rows.begin(), m_rows.end());
+    } else {
+        QVector<int> sorted = rows;
+        std::sort(sorted.begin(), sorted.end());
+        QVector<int> merged;
+        merged.reserve(m_rows.size() + sorted.size());
+        std::merge(m_rows.constBegin(), m_rows.constEnd(), sorted.constBegin(), sorted.constEnd(), std::back_inserter(merged));
+        m_rows.swap(merged);
+    }
+    m_rows.erase(std::unique(m_rows.begin(), m_rows.end()), m_rows.end());
+}
+
+/**
+ * @brief LogMatchNavigator::next 当前行之后的第一个匹配行
+ * @param row 当前行,为-1时返回第一个匹配
+ * @param wrap 之后没有匹配时是否回到第一个
+ * @return 匹配行,没有时为-1
+ */
+int LogMatchNavigator::next(int row, bool wrap) const
+{
+    if (m_rows.isEmpty())
+        return -1;
+    const auto it = std::upper_bound(m_rows.constBegin(), m_rows.constEnd(), row);
+    if (it != m_rows.constEnd())
+        return *it;
+    return wrap ? m_rows.first() : -1;
+}
+
+/**
+ * @brief LogMatchNavigator::previous 当前行之前的最后一个匹配行
+ * @param row 当前行,为-1时返回最后一个匹配
+ * @param wrap 之前没有匹配时是否回到最后一个
+ * @return 匹配行,没有时为-1
+ */
+int LogMatchNavigator::previous(int row, bool wrap) const
+{
+    if (m_rows.isEmpty())
+        return -1;
+    if (row < 0)
+        return m_rows.last();
+    const auto it = std::lower_bound(m_rows.constBegin(), m_rows.constEnd(), row);
+    if (it != m_rows.constBegin())
+        return *(it - 1);
+    return wrap ? m_rows.last() : -1;
+}
+
+/**
+ * @brief LogMatchNavigator::countBefore 行号小于row的匹配个数,row本身是匹配时即为它的序号
+ */
+int LogMatchNavigator::countBefore(int row) const
+{
+    return static_cast<int>(std::lower_bound(m_rows.constBegin(), m_rows.constEnd(), row) - m_rows.constBegin());
+}
@@ -0,0 +1,31 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGMATCHNAVIGATOR_H
+#define LOGMATCHNAVIGATOR_H
+
+#include <QVector>
+
+/**
+ * @brief The LogMatchNavigator class 只高亮不筛选的搜索中匹配记录的有序行号,用于跳到上一个/下一个匹配
+ * 搜索线程按升序分批返回匹配的行,追加后仍保持有序;从当前行查找相邻的匹配用二分查找
+ */
+class LogMatchNavigator
+{
+public:
+    void clear() { m_rows.clear(); }
+    void add(const QVector<int> &rows);
+    int size() const { return m_rows.size(); }
+    bool isEmpty() const { return m_rows.isEmpty(); }
+    const QVector<int> &rows() const { return m_rows; }
+
+    int next(int row, bool wrap = true) const;
+    int previous(int row, bool wrap = true) const;
+    int countBefore(int row) const;
+
+private:
+    QVector<int> m_rows;
+};
+
+#endif // LOGMATCHNAVIGATOR_H
@@ -0,0 +1,57 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logmemorydlg.h"
+
+#include <QFontDatabase>
+#include <QVBoxLayout>
+
+//面板的默认大小
+#define LOG_MEMORY_DLG_WIDTH 560
+#define LOG_MEMORY_DLG_HEIGHT 480
+
+/**
+ * @brief LogMemoryDlg::LogMemoryDlg 构造函数
+ * @param usage 取得当前各类别内存占用的函数,刷新时调用
+ * @param parent 父对象指针
+ */
+LogMemoryDlg::LogMemoryDlg(const UsageFunc &usage, DWidget *parent)
+    : DDialog(parent)
+    , m_usage(usage)
+{
+    setIcon(QIcon::fromTheme("deepin-log-viewer"));
+    setTitle("Memory usage");
+
+    DWidget *pWidget = new DWidget(this);
+    QVBoxLayout *pVLayout = new QVBoxLayout();
+    pVLayout->setContentsMargins(0, 0, 0, 0);
+    m_pText = new DTextBrowser(pWidget);
+    //等宽字体,各列数字对齐
+    m_pText->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    m_pText->setLineWrapMode(QTextEdit::NoWrap);
+    pVLayout->addWidget(m_pText);
+    pWidget->setLayout(pVLayout);
+    addContent(pWidget);
+    resize(LOG_MEMORY_DLG_WIDTH, LOG_MEMORY_DLG_HEIGHT);
+
+    //刷新按钮不关闭面板
+    addButton("Refresh", false, DDialog::ButtonNormal);
+    setOnButtonClickedClose(false);
+    connect(this, &DDialog::buttonClicked, this, [this](int) {
+        refresh();
+    });
+    refresh();
+}
+
+/**
+ * @brief LogMemoryDlg::refresh 重新统计并显示,同时输出到org.deepin.log.viewer.memory日志
+ */
+void LogMemoryDlg::refresh()
+{
+    if (!m_usage)
+        return;
+    const QList<LogMemoryUsage> usages = m_usage();
+    LogMemoryAccounting::dump(usages);
+    m_pText->setPlainText(LogMemoryAccounting::format(usages));
+}
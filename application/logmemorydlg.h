@@ -0,0 +1,37 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGMEMORYDLG_H
+#define LOGMEMORYDLG_H
+
+#include "logmemoryusage.h"
+
+#include <DDialog>
+#include <DTextBrowser>
+#include <DWidget>
+
+#include <functional>
+
+DWIDGET_USE_NAMESPACE
+
+/**
+ * @brief The LogMemoryDlg class 内存占用调试面板,快捷键Ctrl+Alt+M打开,
+ * 按类别列出记录、字段、筛选视图和表格model的占用,用户反馈内存问题时可直接复制其中的文字
+ */
+class LogMemoryDlg : public DDialog
+{
+    Q_OBJECT
+public:
+    using UsageFunc = std::function<QList<LogMemoryUsage>()>;
+
+    explicit LogMemoryDlg(const UsageFunc &usage, DWidget *parent = nullptr);
+
+    void refresh();
+
+private:
+    UsageFunc m_usage;
+    DTextBrowser *m_pText;
+};
+
+#endif // LOGMEMORYDLG_H
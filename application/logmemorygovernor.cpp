@@ -0,0 +1,264 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logmemorygovernor.h"
+
+#include <QFile>
+#include <QLoggingCategory>
+
+#include <unistd.h>
+
+#ifdef QT_DEBUG
+Q_LOGGING_CATEGORY(logMemoryGovernor, "org.deepin.log.viewer.memory.governor")
+#else
+Q_LOGGING_CATEGORY(logMemoryGovernor, "org.deepin.log.viewer.memory.governor", QtInfoMsg)
+#endif
+
+//已用内存占上限的比例达到这些值时分别进入Pressure、Severe、Critical
+#define LOG_MEMORY_USED_PRESSURE 0.80
+#define LOG_MEMORY_USED_SEVERE 0.90
+#define LOG_MEMORY_USED_CRITICAL 0.95
+//本进程常驻内存占上限的比例达到这些值时分别进入Pressure、Severe、Critical
+#define LOG_MEMORY_RSS_PRESSURE 0.30
+#define LOG_MEMORY_RSS_SEVERE 0.45
+#define LOG_MEMORY_RSS_CRITICAL 0.60
+//PSI some avg10达到这些百分比时分别进入Pressure、Severe
+#define LOG_MEMORY_PSI_SOME_PRESSURE 10.0
+#define LOG_MEMORY_PSI_SOME_SEVERE 25.0
+//PSI full avg10达到该百分比(所有任务都在等待内存)时进入Critical
+#define LOG_MEMORY_PSI_FULL_CRITICAL 10.0
+
+std::atomic<int> LogMemoryGovernor::s_level {LogMemoryGovernor::Normal};
+
+namespace {
+
+QByteArray readProcFile(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return QByteArray();
+    return file.readAll();
+}
+
+/**
+ * @brief readBytes 读取cgroup中只有一个数值的文件,"max"或读取失败时返回-1
+ */
+qint64 readBytes(const QString &path)
+{
+    const QByteArray text = readProcFile(path).trimmed();
+    bool ok = false;
+    const qint64 value = text.toLongLong(&ok);
+    return ok ? value : -1;
+}
+
+} // namespace
+
+LogMemoryGovernor::LogMemoryGovernor(QObject *parent)
+    : QObject(parent)
+{
+    m_timer.setInterval(LOG_MEMORY_GOVERNOR_INTERVAL);
+    connect(&m_timer, &QTimer::timeout, this, &LogMemoryGovernor::check);
+}
+
+LogMemoryGovernor *LogMemoryGovernor::instance()
+{
+    static LogMemoryGovernor governor;
+    return &governor;
+}
+
+/**
+ * @brief LogMemoryGovernor::currentLevel 当前的降级等级,可在任意线程调用
+ */
+LogMemoryGovernor::Level LogMemoryGovernor::currentLevel()
+{
+    return static_cast<Level>(s_level.load(std::memory_order_relaxed));
+}
+
+QString LogMemoryGovernor::levelName(Level level)
+{
+    switch (level) {
+    case Pressure:
+        return "pressure";
+    case Severe:
+        return "severe";
+    case Critical:
+        return "critical";
+    default:
+        return "normal";
+    }
+}
+
+/**
+ * @brief LogMemoryGovernor::start 开始定时采样,只需在GUI线程调用一次,重复调用无影响
+ */
+void LogMemoryGovernor::start()
+{
+    if (m_timer.isActive())
+        return;
+    check();
+    m_timer.start();
+}
+
+/**
+ * @brief LogMemoryGovernor::parsePressure 解析PSI文件(/proc/pressure/memory或cgroup的memory.pressure)
+ * 格式为"some avg10=1.23 avg60=... total=..."和"full avg10=..."两行
+ */
+bool LogMemoryGovernor::parsePressure(const QByteArray &text, double *someAvg10, double *fullAvg10)
+{
+    bool found = false;
+    for (const QByteArray &line : text.split('\n')) {
+        const QList<QByteArray> fields = line.simplified().split(' ');
+        if (fields.size() < 2 || !fields.at(1).startsWith("avg10="))
+            continue;
+        bool ok = false;
+        const double value = fields.at(1).mid(6).toDouble(&ok);
+        if (!ok)
+            continue;
+        if (fields.at(0) == "some" && someAvg10) {
+            *someAvg10 = value;
+            found = true;
+        } else if (fields.at(0) == "full" && fullAvg10) {
+            *fullAvg10 = value;
+            found = true;
+        }
+    }
+    return found;
+}
+
+/**
+ * @brief LogMemoryGovernor::parseMemInfo 取/proc/meminfo中的一项,单位为字节,没有该项时返回-1
+ * @param key 项名,如"MemAvailable"
+ */
+qint64 LogMemoryGovernor::parseMemInfo(const QByteArray &text, const QByteArray &key)
+{
+    for (const QByteArray &line : text.split('\n')) {
+        if (!line.startsWith(key + ':'))
+            continue;
+        const QList<QByteArray> fields = line.mid(key.size() + 1).simplified().split(' ');
+        bool ok = false;
+        const qint64 value = fields.value(0).toLongLong(&ok);
+        if (!ok)
+            return -1;
+        return fields.value(1) == "kB" ? value * 1024 : value;
+    }
+    return -1;
+}
+
+/**
+ * @brief LogMemoryGovernor::cgroupPath 由/proc/self/cgroup的内容得到cgroup v2的目录,不是v2时返回空
+ */
+QString LogMemoryGovernor::cgroupPath(const QByteArray &procCgroup)
+{
+    for (const QByteArray &line : procCgroup.split('\n')) {
+        if (line.startsWith("0::"))
+            return QString("/sys/fs/cgroup") + QString::fromUtf8(line.mid(3).trimmed());
+    }
+    return QString();
+}
+
+/**
+ * @brief LogMemoryGovernor::sample 采样本进程、所在cgroup和整机的内存状态
+ */
+LogMemoryGovernor::Sample LogMemoryGovernor::sample()
+{
+    Sample result;
+    //statm的第二项为常驻内存的页数
+    const QList<QByteArray> statm = readProcFile("/proc/self/statm").split(' ');
+    bool ok = false;
+    const qint64 pages = statm.value(1).toLongLong(&ok);
+    if (ok)
+        result.rss = pages * sysconf(_SC_PAGESIZE);
+
+    const QByteArray meminfo = readProcFile("/proc/meminfo");
+    const qint64 total = parseMemInfo(meminfo, "MemTotal");
+    const qint64 available = parseMemInfo(meminfo, "MemAvailable");
+    if (total > 0 && available >= 0) {
+        result.used = total - available;
+        result.limit = total;
+    }
+
+    //在限制了内存的cgroup(如瘦客户机的用户切片)中时,按比例更高的一方计算
+    const QString cgroup = cgroupPath(readProcFile("/proc/self/cgroup"));
+    QByteArray pressure;
+    if (!cgroup.isEmpty()) {
+        const qint64 max = readBytes(cgroup + "/memory.max");
+        const qint64 current = readBytes(cgroup + "/memory.current");
+        if (max > 0 && current >= 0 && (result.limit <= 0 || static_cast<double>(current) / max > static_cast<double>(result.used) / result.limit)) {
+            result.used = current;
+            result.limit = max;
+        }
+        pressure = readProcFile(cgroup + "/memory.pressure");
+    }
+    if (pressure.isEmpty())
+        pressure = readProcFile("/proc/pressure/memory");
+    parsePressure(pressure, &result.someAvg10, &result.fullAvg10);
+    return result;
+}
+
+/**
+ * @brief LogMemoryGovernor::classify 按一次采样得到降级等级,各项中最严重的为准,读取失败的项不参与
+ */
+LogMemoryGovernor::Level LogMemoryGovernor::classify(const Sample &sample)
+{
+    Level level = Normal;
+    auto raise = [&level](Level other) {
+        level = qMax(level, other);
+    };
+    if (sample.limit > 0 && sample.used >= 0) {
+        const double used = static_cast<double>(sample.used) / sample.limit;
+        if (used >= LOG_MEMORY_USED_CRITICAL)
+            raise(Critical);
+        else if (used >= LOG_MEMORY_USED_SEVERE)
+            raise(Severe);
+        else if (used >= LOG_MEMORY_USED_PRESSURE)
+            raise(Pressure);
+    }
+    if (sample.limit > 0 && sample.rss >= 0) {
+        const double rss = static_cast<double>(sample.rss) / sample.limit;
+        if (rss >= LOG_MEMORY_RSS_CRITICAL)
+            raise(Critical);
+        else if (rss >= LOG_MEMORY_RSS_SEVERE)
+            raise(Severe);
+        else if (rss >= LOG_MEMORY_RSS_PRESSURE)
+            raise(Pressure);
+    }
+    if (sample.fullAvg10 >= LOG_MEMORY_PSI_FULL_CRITICAL)
+        raise(Critical);
+    if (sample.someAvg10 >= LOG_MEMORY_PSI_SOME_SEVERE)
+        raise(Severe);
+    else if (sample.someAvg10 >= LOG_MEMORY_PSI_SOME_PRESSURE)
+        raise(Pressure);
+    return level;
+}
+
+/**
+ * @brief LogMemoryGovernor::check 采样一次,压力升高时立即升级,降低时连续几次都低才降一级
+ */
+void LogMemoryGovernor::check()
+{
+    const Sample current = sample();
+    const Level measured = classify(current);
+    const Level old = currentLevel();
+    Level next = old;
+    if (measured > old) {
+        next = measured;
+        m_relaxSamples = 0;
+    } else if (measured < old) {
+        if (++m_relaxSamples >= LOG_MEMORY_GOVERNOR_RELAX_SAMPLES) {
+            next = static_cast<Level>(old - 1);
+            m_relaxSamples = 0;
+        }
+    } else {
+        m_relaxSamples = 0;
+    }
+    if (next == old)
+        return;
+
+    s_level.store(next, std::memory_order_relaxed);
+    qCInfo(logMemoryGovernor).noquote() << QString("memory level %1 -> %2 rss=%3MB used=%4/%5MB psi some=%6 full=%7")
+                                               .arg(levelName(old)).arg(levelName(next))
+                                               .arg(current.rss / 1024 / 1024).arg(current.used / 1024 / 1024).arg(current.limit / 1024 / 1024)
+                                               .arg(current.someAvg10).arg(current.fullAvg10);
+    emit levelChanged(next);
+}
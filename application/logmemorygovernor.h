@@ -0,0 +1,80 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGMEMORYGOVERNOR_H
+#define LOGMEMORYGOVERNOR_H
+
+#include <QObject>
+#include <QTimer>
+
+#include <atomic>
+
+//内存采样间隔,毫秒
+#define LOG_MEMORY_GOVERNOR_INTERVAL 2000
+//连续这么多次采样都低于当前等级的阈值才降低等级,避免在阈值附近来回切换
+#define LOG_MEMORY_GOVERNOR_RELAX_SAMPLES 5
+//内存紧张时系统日志一次最多加载的条数,更早的日志由"加载更早的日志"分段读取
+#define LOG_MEMORY_WINDOW_RECORDS 200000
+
+/**
+ * @brief The LogMemoryGovernor class 监视本进程的常驻内存、所在cgroup(或整机)的内存用量和PSI内存压力,
+ * 按压力逐级降级,不让一次加载把整个桌面推入交换区或触发OOM:
+ * Pressure停止类别缓存和后台预取并释放已缓存的类别,Severe读取系统日志时只保留更短的信息前缀,
+ * Critical时系统日志只加载最新的LOG_MEMORY_WINDOW_RECORDS条,更早的部分按需分段加载。
+ * 在GUI线程中定时采样,等级变化时发出levelChanged;获取线程通过currentLevel读取
+ */
+class LogMemoryGovernor : public QObject
+{
+    Q_OBJECT
+public:
+    enum Level {
+        Normal,   //不降级
+        Pressure, //不缓存、不预取
+        Severe,   //缩短延迟加载的信息前缀
+        Critical  //限制一次加载的条数
+    };
+
+    /**
+     * @brief The Sample struct 一次内存采样,读取失败的项为-1
+     */
+    struct Sample {
+        //本进程常驻内存,字节
+        qint64 rss = -1;
+        //所在cgroup或整机已用的内存和上限,取比例较高的一方,字节
+        qint64 used = -1;
+        qint64 limit = -1;
+        //PSI最近10秒部分任务、全部任务因等待内存而停顿的时间比例,百分比
+        double someAvg10 = -1;
+        double fullAvg10 = -1;
+    };
+
+    static LogMemoryGovernor *instance();
+    static Level currentLevel();
+    static QString levelName(Level level);
+
+    void start();
+    Level level() const { return currentLevel(); }
+
+    static Sample sample();
+    static Level classify(const Sample &sample);
+    static bool parsePressure(const QByteArray &text, double *someAvg10, double *fullAvg10);
+    static qint64 parseMemInfo(const QByteArray &text, const QByteArray &key);
+    static QString cgroupPath(const QByteArray &procCgroup);
+
+signals:
+    void levelChanged(int level);
+
+private slots:
+    void check();
+
+private:
+    explicit LogMemoryGovernor(QObject *parent = nullptr);
+
+    QTimer m_timer;
+    //连续低于当前等级阈值的采样次数
+    int m_relaxSamples = 0;
+    static std::atomic<int> s_level;
+};
+
+#endif // LOGMEMORYGOVERNOR_H
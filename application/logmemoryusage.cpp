@@ -0,0 +1,112 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logmemoryusage.h"
+
+#include <QLoggingCategory>
+
+#include <algorithm>
+
+#ifdef QT_DEBUG
+Q_LOGGING_CATEGORY(logMemoryUsage, "org.deepin.log.viewer.memory")
+#else
+Q_LOGGING_CATEGORY(logMemoryUsage, "org.deepin.log.viewer.memory", QtInfoMsg)
+#endif
+
+//c++11下constexpr静态数组需要类外定义
+constexpr LogMemoryColumn<LOG_MSG_JOURNAL> LogMemoryTraits<LOG_MSG_JOURNAL>::columns[];
+constexpr LogMemoryColumn<LOG_MSG_APPLICATOIN> LogMemoryTraits<LOG_MSG_APPLICATOIN>::columns[];
+constexpr LogMemoryColumn<LOG_MSG_DPKG> LogMemoryTraits<LOG_MSG_DPKG>::columns[];
+constexpr LogMemoryColumn<LOG_MSG_BOOT> LogMemoryTraits<LOG_MSG_BOOT>::columns[];
+constexpr LogMemoryColumn<LOG_MSG_XORG> LogMemoryTraits<LOG_MSG_XORG>::columns[];
+constexpr LogMemoryColumn<LOG_MSG_NORMAL> LogMemoryTraits<LOG_MSG_NORMAL>::columns[];
+constexpr LogMemoryColumn<LOG_MSG_KWIN> LogMemoryTraits<LOG_MSG_KWIN>::columns[];
+constexpr LogMemoryColumn<LOG_FILE_OTHERORCUSTOM> LogMemoryTraits<LOG_FILE_OTHERORCUSTOM>::columns[];
+constexpr LogMemoryColumn<LOG_MSG_DNF> LogMemoryTraits<LOG_MSG_DNF>::columns[];
+constexpr LogMemoryColumn<LOG_MSG_DMESG> LogMemoryTraits<LOG_MSG_DMESG>::columns[];
+constexpr LogMemoryColumn<LOG_MSG_AUDIT> LogMemoryTraits<LOG_MSG_AUDIT>::columns[];
+constexpr LogMemoryColumn<LOG_MSG_COREDUMP> LogMemoryTraits<LOG_MSG_COREDUMP>::columns[];
+
+qint64 LogMemoryUsage::columnTotal() const
+{
+    qint64 sum = 0;
+    for (qint64 bytes : columnBytes)
+        sum += bytes;
+    return sum;
+}
+
+qint64 LogMemoryUsage::total() const
+{
+    return recordBytes + columnTotal() + viewBytes + modelBytes;
+}
+
+/**
+ * @brief LogMemoryAccounting::textBytes 字符串内容占用的字节,空字符串和已统计过的共享数据返回0
+ * 隐式共享的字符串按数据指针去重,字符串池中的值只算一次
+ */
+qint64 LogMemoryAccounting::textBytes(const QString &text, QSet<const void *> &seen)
+{
+    if (text.isNull() || text.capacity() == 0)
+        return 0;
+    const void *data = text.constData();
+    if (seen.contains(data))
+        return 0;
+    seen.insert(data);
+    return LOG_MEMORY_ARRAY_HEADER + LOG_MEMORY_MALLOC_OVERHEAD + static_cast<qint64>(text.capacity() + 1) * static_cast<qint64>(sizeof(QChar));
+}
+
+qint64 LogMemoryAccounting::bytesBytes(const QByteArray &data, QSet<const void *> &seen)
+{
+    if (data.isNull() || data.capacity() == 0)
+        return 0;
+    const void *ptr = data.constData();
+    if (seen.contains(ptr))
+        return 0;
+    seen.insert(ptr);
+    return LOG_MEMORY_ARRAY_HEADER + LOG_MEMORY_MALLOC_OVERHEAD + data.capacity() + 1;
+}
+
+qint64 LogMemoryAccounting::vectorBytes(const void *data, int capacity, int elementSize, QSet<const void *> &seen)
+{
+    if (!data || capacity <= 0 || seen.contains(data))
+        return 0;
+    seen.insert(data);
+    return LOG_MEMORY_ARRAY_HEADER + LOG_MEMORY_MALLOC_OVERHEAD + static_cast<qint64>(capacity) * elementSize;
+}
+
+/**
+ * @brief LogMemoryAccounting::format 按类别和字段输出统计表,占用大的类别排在前面
+ */
+QString LogMemoryAccounting::format(const QList<LogMemoryUsage> &usages)
+{
+    QList<LogMemoryUsage> sorted = usages;
+    std::stable_sort(sorted.begin(), sorted.end(), [](const LogMemoryUsage &a, const LogMemoryUsage &b) {
+        return a.total() > b.total();
+    });
+    qint64 sum = 0;
+    QString text;
+    for (const LogMemoryUsage &usage : sorted) {
+        sum += usage.total();
+        text += QString("%1: %2 bytes, %3 records in %4 batches%5\n")
+                    .arg(usage.category)
+                    .arg(usage.total())
+                    .arg(usage.records)
+                    .arg(usage.batches)
+                    .arg(usage.sampled ? QString(" (sampled)") : QString());
+        text += QString("    records %1, views %2, model %3\n").arg(usage.recordBytes).arg(usage.viewBytes).arg(usage.modelBytes);
+        for (int i = 0; i < usage.columnNames.size() && i < usage.columnBytes.size(); ++i) {
+            if (usage.columnBytes.at(i) > 0)
+                text += QString("    %1 %2\n").arg(usage.columnNames.at(i)).arg(usage.columnBytes.at(i));
+        }
+    }
+    text += QString("total: %1 bytes\n").arg(sum);
+    return text;
+}
+
+void LogMemoryAccounting::dump(const QList<LogMemoryUsage> &usages)
+{
+    const QStringList lines = format(usages).split('\n', QString::SkipEmptyParts);
+    for (const QString &line : lines)
+        qCInfo(logMemoryUsage) << qPrintable(line);
+}
@@ -0,0 +1,291 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGMEMORYUSAGE_H
+#define LOGMEMORYUSAGE_H
+
+#include "logrecordstore.h"
+#include "logrecordview.h"
+#include "structdef.h"
+
+#include <QList>
+#include <QSet>
+#include <QString>
+#include <QVector>
+
+//记录数超过这么多时均匀抽样估计,几百万条记录时统计本身不卡住界面
+#define LOG_MEMORY_SAMPLE_RECORDS 20000
+//QString、QByteArray数据头的大小,和QArrayData一致
+#define LOG_MEMORY_ARRAY_HEADER 24
+//堆上每次分配的额外开销,近似为malloc的块头和对齐
+#define LOG_MEMORY_MALLOC_OVERHEAD 16
+
+/**
+ * @brief The LogMemoryColumn struct 记录中的一个字符串字段,按字段统计占用
+ */
+template <typename T>
+struct LogMemoryColumn {
+    QString T::*field;
+    const char *name;
+};
+
+/**
+ * @brief The LogMemoryTraits struct 每种记录参与统计的字段,和LogExportTraits不同,
+ * 这里列出所有占用堆内存的字段,包括不导出的字段;QByteArray字段单独统计
+ */
+template <typename T>
+struct LogMemoryTraits;
+
+template <>
+struct LogMemoryTraits<LOG_MSG_JOURNAL> {
+    static constexpr LogMemoryColumn<LOG_MSG_JOURNAL> columns[] = {
+        {&LOG_MSG_JOURNAL::dateTime, "dateTime"},
+        {&LOG_MSG_JOURNAL::hostName, "hostName"},
+        {&LOG_MSG_JOURNAL::daemonName, "daemonName"},
+        {&LOG_MSG_JOURNAL::daemonId, "daemonId"},
+        {&LOG_MSG_JOURNAL::msg, "msg"},
+    };
+    static const char *extraName() { return "cursor"; }
+    static const QByteArray *extra(const LOG_MSG_JOURNAL &record) { return &record.cursor; }
+};
+
+template <>
+struct LogMemoryTraits<LOG_MSG_APPLICATOIN> {
+    static constexpr LogMemoryColumn<LOG_MSG_APPLICATOIN> columns[] = {
+        {&LOG_MSG_APPLICATOIN::dateTime, "dateTime"},
+        {&LOG_MSG_APPLICATOIN::src, "src"},
+        {&LOG_MSG_APPLICATOIN::msg, "msg"},
+        {&LOG_MSG_APPLICATOIN::detailInfo, "detailInfo"},
+    };
+    static const char *extraName() { return "fullRef.cursor"; }
+    static const QByteArray *extra(const LOG_MSG_APPLICATOIN &record) { return &record.fullRef.cursor; }
+};
+
+template <>
+struct LogMemoryTraits<LOG_MSG_DPKG> {
+    static constexpr LogMemoryColumn<LOG_MSG_DPKG> columns[] = {
+        {&LOG_MSG_DPKG::dateTime, "dateTime"},
+        {&LOG_MSG_DPKG::action, "action"},
+        {&LOG_MSG_DPKG::msg, "msg"},
+    };
+    static const char *extraName() { return nullptr; }
+    static const QByteArray *extra(const LOG_MSG_DPKG &) { return nullptr; }
+};
+
+template <>
+struct LogMemoryTraits<LOG_MSG_BOOT> {
+    static constexpr LogMemoryColumn<LOG_MSG_BOOT> columns[] = {
+        {&LOG_MSG_BOOT::status, "status"},
+        {&LOG_MSG_BOOT::msg, "msg"},
+    };
+    static const char *extraName() { return nullptr; }
+    static const QByteArray *extra(const LOG_MSG_BOOT &) { return nullptr; }
+};
+
+template <>
+struct LogMemoryTraits<LOG_MSG_XORG> {
+    static constexpr LogMemoryColumn<LOG_MSG_XORG> columns[] = {
+        {&LOG_MSG_XORG::offset, "offset"},
+        {&LOG_MSG_XORG::msg, "msg"},
+    };
+    static const char *extraName() { return nullptr; }
+    static const QByteArray *extra(const LOG_MSG_XORG &) { return nullptr; }
+};
+
+template <>
+struct LogMemoryTraits<LOG_MSG_NORMAL> {
+    static constexpr LogMemoryColumn<LOG_MSG_NORMAL> columns[] = {
+        {&LOG_MSG_NORMAL::eventType, "eventType"},
+        {&LOG_MSG_NORMAL::userName, "userName"},
+        {&LOG_MSG_NORMAL::dateTime, "dateTime"},
+        {&LOG_MSG_NORMAL::msg, "msg"},
+    };
+    static const char *extraName() { return nullptr; }
+    static const QByteArray *extra(const LOG_MSG_NORMAL &) { return nullptr; }
+};
+
+template <>
+struct LogMemoryTraits<LOG_MSG_KWIN> {
+    static constexpr LogMemoryColumn<LOG_MSG_KWIN> columns[] = {
+        {&LOG_MSG_KWIN::msg, "msg"},
+    };
+    static const char *extraName() { return nullptr; }
+    static const QByteArray *extra(const LOG_MSG_KWIN &) { return nullptr; }
+};
+
+template <>
+struct LogMemoryTraits<LOG_FILE_OTHERORCUSTOM> {
+    static constexpr LogMemoryColumn<LOG_FILE_OTHERORCUSTOM> columns[] = {
+        {&LOG_FILE_OTHERORCUSTOM::name, "name"},
+        {&LOG_FILE_OTHERORCUSTOM::path, "path"},
+        {&LOG_FILE_OTHERORCUSTOM::dateTimeModify, "dateTimeModify"},
+    };
+    static const char *extraName() { return nullptr; }
+    static const QByteArray *extra(const LOG_FILE_OTHERORCUSTOM &) { return nullptr; }
+};
+
+template <>
+struct LogMemoryTraits<LOG_MSG_DNF> {
+    static constexpr LogMemoryColumn<LOG_MSG_DNF> columns[] = {
+        {&LOG_MSG_DNF::dateTime, "dateTime"},
+        {&LOG_MSG_DNF::msg, "msg"},
+    };
+    static const char *extraName() { return nullptr; }
+    static const QByteArray *extra(const LOG_MSG_DNF &) { return nullptr; }
+};
+
+template <>
+struct LogMemoryTraits<LOG_MSG_DMESG> {
+    static constexpr LogMemoryColumn<LOG_MSG_DMESG> columns[] = {
+        {&LOG_MSG_DMESG::dateTime, "dateTime"},
+        {&LOG_MSG_DMESG::msg, "msg"},
+    };
+    static const char *extraName() { return nullptr; }
+    static const QByteArray *extra(const LOG_MSG_DMESG &) { return nullptr; }
+};
+
+template <>
+struct LogMemoryTraits<LOG_MSG_AUDIT> {
+    static constexpr LogMemoryColumn<LOG_MSG_AUDIT> columns[] = {
+        {&LOG_MSG_AUDIT::auditType, "auditType"},
+        {&LOG_MSG_AUDIT::eventType, "eventType"},
+        {&LOG_MSG_AUDIT::dateTime, "dateTime"},
+        {&LOG_MSG_AUDIT::processName, "processName"},
+        {&LOG_MSG_AUDIT::processId, "processId"},
+        {&LOG_MSG_AUDIT::status, "status"},
+        {&LOG_MSG_AUDIT::origin, "origin"},
+    };
+    static const char *extraName() { return nullptr; }
+    static const QByteArray *extra(const LOG_MSG_AUDIT &) { return nullptr; }
+};
+
+template <>
+struct LogMemoryTraits<LOG_MSG_COREDUMP> {
+    static constexpr LogMemoryColumn<LOG_MSG_COREDUMP> columns[] = {
+        {&LOG_MSG_COREDUMP::sig, "sig"},
+        {&LOG_MSG_COREDUMP::dateTime, "dateTime"},
+        {&LOG_MSG_COREDUMP::coreFile, "coreFile"},
+        {&LOG_MSG_COREDUMP::uid, "uid"},
+        {&LOG_MSG_COREDUMP::exe, "exe"},
+        {&LOG_MSG_COREDUMP::pid, "pid"},
+        {&LOG_MSG_COREDUMP::storagePath, "storagePath"},
+        {&LOG_MSG_COREDUMP::stackInfo, "stackInfo"},
+        {&LOG_MSG_COREDUMP::maps, "maps"},
+    };
+    static const char *extraName() { return "cursor"; }
+    static const QByteArray *extra(const LOG_MSG_COREDUMP &record) { return &record.cursor; }
+};
+
+/**
+ * @brief The LogMemoryUsage struct 一个类别的内存占用估计,单位字节
+ */
+struct LogMemoryUsage {
+    QString category;
+    int records = 0;
+    int batches = 0;
+    //记录结构体本身、QList的节点和批次数组
+    qint64 recordBytes = 0;
+    //各字段字符串的内容,和columnNames一一对应;多条记录共享的字符串只算一次
+    QStringList columnNames;
+    QVector<qint64> columnBytes;
+    //筛选视图的下标数组,和表格共享的数组只算一次
+    qint64 viewBytes = 0;
+    //表格model的下标数组、修改过的单元格和图标缓存,只有当前显示的类别有
+    qint64 modelBytes = 0;
+    //是否为抽样估计
+    bool sampled = false;
+
+    qint64 columnTotal() const;
+    qint64 total() const;
+};
+
+/**
+ * @brief The LogMemoryAccounting class 统计记录存储、筛选视图和表格model的内存占用
+ * 只按数据结构估计堆上的占用,不包括分配器的碎片;用于调试面板和日志输出,找出占用内存的类别
+ */
+class LogMemoryAccounting
+{
+public:
+    template <typename T>
+    static LogMemoryUsage measure(const QString &category, const LogRecordStore<T> &store);
+    template <typename T>
+    static LogMemoryUsage measure(const QString &category, const QList<T> &list);
+    template <typename T>
+    static void addView(LogMemoryUsage &usage, const LogRecordView<T> &view, QSet<const void *> &seen);
+
+    static qint64 textBytes(const QString &text, QSet<const void *> &seen);
+    static qint64 bytesBytes(const QByteArray &data, QSet<const void *> &seen);
+    static qint64 vectorBytes(const void *data, int capacity, int elementSize, QSet<const void *> &seen);
+    static QString format(const QList<LogMemoryUsage> &usages);
+    static void dump(const QList<LogMemoryUsage> &usages);
+};
+
+/**
+ * @brief LogMemoryAccounting::measure 统计一个类别的存储,记录多时均匀抽样后按比例放大;
+ * 抽样中一半以上的字符串是共享的字段(如经过字符串池的主机名、等级)不放大,共享的值基本都已在样本中
+ */
+template <typename T>
+LogMemoryUsage LogMemoryAccounting::measure(const QString &category, const LogRecordStore<T> &store)
+{
+    LogMemoryUsage usage;
+    usage.category = category;
+    usage.records = store.size();
+    usage.batches = store.batchCount();
+    //QList<T>中较大的T按指针存放,每条记录一次堆分配;批次数组按QList对象和起始下标计算
+    usage.recordBytes = static_cast<qint64>(store.size()) * (static_cast<qint64>(sizeof(T)) + static_cast<qint64>(sizeof(void *)) + LOG_MEMORY_MALLOC_OVERHEAD)
+                        + static_cast<qint64>(store.batchCount()) * (static_cast<qint64>(sizeof(QList<T>)) + static_cast<qint64>(sizeof(int)) + LOG_MEMORY_ARRAY_HEADER);
+
+    const int columnCount = static_cast<int>(sizeof(LogMemoryTraits<T>::columns) / sizeof(LogMemoryTraits<T>::columns[0]));
+    for (int i = 0; i < columnCount; ++i)
+        usage.columnNames.append(QString::fromLatin1(LogMemoryTraits<T>::columns[i].name));
+    if (LogMemoryTraits<T>::extraName())
+        usage.columnNames.append(QString::fromLatin1(LogMemoryTraits<T>::extraName()));
+    usage.columnBytes.fill(0, usage.columnNames.size());
+    if (store.isEmpty())
+        return usage;
+
+    const int step = qMax(1, store.size() / LOG_MEMORY_SAMPLE_RECORDS);
+    usage.sampled = step > 1;
+    QSet<const void *> seen;
+    QVector<int> unique(usage.columnNames.size(), 0);
+    int sampledCount = 0;
+    for (int row = 0; row < store.size(); row += step) {
+        const T &record = store.at(row);
+        for (int i = 0; i < columnCount; ++i) {
+            const qint64 bytes = textBytes(record.*(LogMemoryTraits<T>::columns[i].field), seen);
+            usage.columnBytes[i] += bytes;
+            unique[i] += bytes > 0 ? 1 : 0;
+        }
+        if (const QByteArray *extra = LogMemoryTraits<T>::extra(record)) {
+            const qint64 bytes = bytesBytes(*extra, seen);
+            usage.columnBytes[columnCount] += bytes;
+            unique[columnCount] += bytes > 0 ? 1 : 0;
+        }
+        ++sampledCount;
+    }
+    if (usage.sampled) {
+        for (int i = 0; i < usage.columnBytes.size(); ++i) {
+            if (unique.at(i) * 2 >= sampledCount)
+                usage.columnBytes[i] = usage.columnBytes.at(i) * store.size() / sampledCount;
+        }
+    }
+    return usage;
+}
+
+template <typename T>
+LogMemoryUsage LogMemoryAccounting::measure(const QString &category, const QList<T> &list)
+{
+    return measure(category, LogRecordStore<T>(list));
+}
+
+/**
+ * @brief LogMemoryAccounting::addView 计入筛选视图的下标数组,seen中已有的数组(和表格或其他视图共享)不重复计算
+ */
+template <typename T>
+void LogMemoryAccounting::addView(LogMemoryUsage &usage, const LogRecordView<T> &view, QSet<const void *> &seen)
+{
+    usage.viewBytes += vectorBytes(view.rows().constData(), view.rows().capacity(), static_cast<int>(sizeof(quint32)), seen);
+}
+
+#endif // LOGMEMORYUSAGE_H
@@ -0,0 +1,165 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logminimap.h"
+
+#include <QtMath>
+
+namespace {
+void mergeTime(LogMinimap::Bucket &bucket, qint64 minTime, qint64 maxTime)
+{
+    if (minTime < 0)
+        return;
+    bucket.minTime = bucket.minTime < 0 ? minTime : qMin(bucket.minTime, minTime);
+    bucket.maxTime = qMax(bucket.maxTime, maxTime);
+}
+
+/**
+ * @brief daysFromCivil 公历日期到1970-01-01的天数
+ */
+qint64 daysFromCivil(qint64 y, qint64 m, qint64 d)
+{
+    y -= m <= 2;
+    const qint64 era = (y >= 0 ? y : y - 399) / 400;
+    const qint64 yoe = y - era * 400;
+    const qint64 doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    const qint64 doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+}
+
+void LogMinimap::clear()
+{
+    m_buckets.clear();
+    m_rowsPerBucket = 1;
+    m_rowCount = 0;
+}
+
+void LogMinimap::clearHits()
+{
+    for (Bucket &bucket : m_buckets)
+        bucket.hits = 0;
+}
+
+/**
+ * @brief LogMinimap::appendTimes 追加一批行的时间
+ * @param times 按行号顺序的时间,毫秒,取不到时间的行为-1
+ */
+void LogMinimap::appendTimes(const QVector<qint64> &times)
+{
+    for (qint64 time : times) {
+        const int index = m_rowCount / m_rowsPerBucket;
+        if (index >= m_buckets.size())
+            m_buckets.append(Bucket());
+        Bucket &bucket = m_buckets[index];
+        ++bucket.rows;
+        mergeTime(bucket, time, time);
+        ++m_rowCount;
+        if (m_buckets.size() == LOG_MINIMAP_BUCKETS && bucket.rows == m_rowsPerBucket)
+            mergeBuckets();
+    }
+}
+
+/**
+ * @brief LogMinimap::addHits 记下一批命中的行,超出已有行数的行忽略
+ */
+void LogMinimap::addHits(const QVector<int> &rows)
+{
+    for (int row : rows) {
+        if (row >= 0 && row < m_rowCount)
+            ++m_buckets[row / m_rowsPerBucket].hits;
+    }
+}
+
+/**
+ * @brief LogMinimap::density 把全部行均分为bins段,每段的相对密度
+ * 密度为行数除以时间跨度,取对数后按最密集的一段归一化到0到1;没有时间的段为0
+ */
+QVector<float> LogMinimap::density(int bins) const
+{
+    QVector<float> result(qMax(0, bins), 0.0f);
+    if (bins <= 0 || m_rowCount == 0)
+        return result;
+    QVector<Bucket> merged(bins);
+    for (int i = 0; i < m_buckets.size(); ++i) {
+        const Bucket &bucket = m_buckets.at(i);
+        Bucket &bin = merged[static_cast<int>(qint64(i) * m_rowsPerBucket * bins / m_rowCount)];
+        bin.rows += bucket.rows;
+        mergeTime(bin, bucket.minTime, bucket.maxTime);
+    }
+    float peak = 0.0f;
+    for (int i = 0; i < bins; ++i) {
+        const Bucket &bin = merged.at(i);
+        if (bin.rows == 0 || bin.minTime < 0)
+            continue;
+        //时间跨度至少按1毫秒计
+        const double perSecond = bin.rows * 1000.0 / qMax<qint64>(1, bin.maxTime - bin.minTime);
+        result[i] = static_cast<float>(qLn(1.0 + perSecond));
+        peak = qMax(peak, result.at(i));
+    }
+    if (peak > 0.0f) {
+        for (float &value : result)
+            value /= peak;
+    }
+    return result;
+}
+
+/**
+ * @brief LogMinimap::hits 把全部行均分为bins段,每段的命中数
+ */
+QVector<int> LogMinimap::hits(int bins) const
+{
+    QVector<int> result(qMax(0, bins), 0);
+    if (bins <= 0 || m_rowCount == 0)
+        return result;
+    for (int i = 0; i < m_buckets.size(); ++i)
+        result[static_cast<int>(qint64(i) * m_rowsPerBucket * bins / m_rowCount)] += m_buckets.at(i).hits;
+    return result;
+}
+
+/**
+ * @brief LogMinimap::keyTime 排序键(LogTableModel::dateTimeKey,时间文字中的数字依次拼接)换算为毫秒
+ * 至少14位时前14位按yyyyMMddHHmmss、其余按秒的小数处理;更短的(如开机后的秒数)原样返回,只用于比较跨度
+ */
+qint64 LogMinimap::keyTime(qint64 key)
+{
+    if (key < 0)
+        return -1;
+    int digits = 1;
+    for (qint64 rest = key; rest >= 10; rest /= 10)
+        ++digits;
+    if (digits < 14)
+        return key;
+    qint64 fracScale = 1;
+    for (int i = 14; i < digits; ++i)
+        fracScale *= 10;
+    const qint64 head = key / fracScale;
+    const qint64 frac = key % fracScale;
+    const qint64 sec = head % 100;
+    const qint64 min = head / 100 % 100;
+    const qint64 hour = head / 10000 % 100;
+    const qint64 day = head / 1000000 % 100;
+    const qint64 month = head / 100000000 % 100;
+    const qint64 year = head / 10000000000LL;
+    if (month < 1 || month > 12 || day < 1 || day > 31)
+        return key;
+    const qint64 seconds = daysFromCivil(year, month, day) * 86400 + hour * 3600 + min * 60 + sec;
+    return seconds * 1000 + frac * 1000 / fracScale;
+}
+
+/**
+ * @brief LogMinimap::mergeBuckets 相邻两桶合并,桶数减半
+ */
+void LogMinimap::mergeBuckets()
+{
+    QVector<Bucket> merged((m_buckets.size() + 1) / 2);
+    for (int i = 0; i < m_buckets.size(); ++i) {
+        Bucket &bucket = merged[i / 2];
+        bucket.rows += m_buckets.at(i).rows;
+        bucket.hits += m_buckets.at(i).hits;
+        mergeTime(bucket, m_buckets.at(i).minTime, m_buckets.at(i).maxTime);
+    }
+    m_buckets.swap(merged);
+    m_rowsPerBucket *= 2;
+}
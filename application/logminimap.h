@@ -0,0 +1,50 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGMINIMAP_H
+#define LOGMINIMAP_H
+
+#include <QVector>
+
+//最多保存的行分桶数,超过时相邻两桶合并,每桶的行数加倍
+#define LOG_MINIMAP_BUCKETS 2048
+
+/**
+ * @brief The LogMinimap class 滚动条上的缩略图数据:按表格行号分桶统计记录的时间跨度和搜索命中数
+ * 日志按时间排列,一段行对应的时间跨度越短,这段时间内的日志越密集;
+ * 每桶的行数为2的幂,行只在末尾追加时逐批累加,不需要重新扫描已有的行
+ */
+class LogMinimap
+{
+public:
+    struct Bucket {
+        int rows = 0;
+        int hits = 0;
+        //桶内记录的最早、最晚时间,毫秒,没有带时间的记录时为-1
+        qint64 minTime = -1;
+        qint64 maxTime = -1;
+    };
+
+    void clear();
+    void clearHits();
+    void appendTimes(const QVector<qint64> &times);
+    void addHits(const QVector<int> &rows);
+    int rowCount() const { return m_rowCount; }
+    int rowsPerBucket() const { return m_rowsPerBucket; }
+    const QVector<Bucket> &buckets() const { return m_buckets; }
+
+    QVector<float> density(int bins) const;
+    QVector<int> hits(int bins) const;
+
+    static qint64 keyTime(qint64 key);
+
+private:
+    void mergeBuckets();
+
+    QVector<Bucket> m_buckets;
+    int m_rowsPerBucket = 1;
+    int m_rowCount = 0;
+};
+
+#endif // LOGMINIMAP_H
@@ -3,9 +3,12 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "logoocfileparsethread.h"
+#include "logcanceltoken.h"
 #include "utils.h"
 #include "dbusproxy/dldbushandler.h"
 #include "sharedmemorymanager.h"
+#include "logsharedring.h"
+#include "logauthcache.h"
 
 #include <DMessageBox>
 
@@ -33,6 +36,7 @@ LogOOCFileParseThread::LogOOCFileParseThread(QObject *parent)
     //静态计数变量加一并赋值给本对象的成员变量，以供外部判断是否为最新线程发出的数据信号
     thread_count++;
     m_threadCount = thread_count;
+    qRegisterMetaType<LogTextSourcePtr>("LogTextSourcePtr");
 }
 
 /**
@@ -48,6 +52,15 @@ void LogOOCFileParseThread::setParam(const QString &path)
     m_path = path;
 }
 
+/**
+ * @brief LogOOCFileParseThread::setArchive 改为读取归档中一个类别的各文件,不需要鉴权
+ */
+void LogOOCFileParseThread::setArchive(const LogArchivePtr &archive, const QString &category)
+{
+    m_archive = archive;
+    m_category = category;
+}
+
 int LogOOCFileParseThread::getIndex()
 {
     return m_threadCount;
@@ -58,9 +71,24 @@ int LogOOCFileParseThread::getIndex()
  */
 void LogOOCFileParseThread::doWork()
 {
+    LogIngestScope ingest(m_ingest, true);
+    LogCancelScope cancel(m_canRun);
     //此线程刚开始把可以继续变量置true，不然下面没法跑
     m_canRun = true;
 
+    //归档中的各文件并行解压和建立索引,之后按包中顺序发出
+    if (m_archive) {
+        const QList<LogTextSourcePtr> sources = m_archive->index(m_category, m_canRun);
+        for (const LogTextSourcePtr &source : sources) {
+            if (!m_canRun)
+                break;
+            m_sources.append(source);
+            emit sigData(m_threadCount, source);
+        }
+        emit sigFinished(m_threadCount);
+        return;
+    }
+
     if (m_path.isEmpty()) {
         emit sigFinished(m_threadCount);
         return;
@@ -84,20 +112,31 @@ void LogOOCFileParseThread::doWork()
             return;
         }
 
-        m_fileData += DLDBusHandler::instance(this)->readLog(filePath.at(i));
-        emit sigData(m_threadCount, m_fileData);
+        //优先映射文件,只有服务不支持传递描述符时才把整个文件读到内存
+        std::shared_ptr<LogTextSource> source = std::make_shared<LogTextSource>(filePath.at(i));
+        if (!source->open(this))
+            source->setData(DLDBusHandler::instance(this)->readLog(filePath.at(i)).toUtf8());
+        if (!source->buildIndex(m_canRun)) {
+            emit sigFinished(m_threadCount);
+            return;
+        }
+        m_sources.append(source);
+        emit sigData(m_threadCount, source);
     }
 
     emit sigFinished(m_threadCount);
 }
 
-//鉴权
+//鉴权,按m_path所在目录在本次运行中只提权一次,服务列出的各个文件(包括解压到临时目录的)不再分别启动logViewerAuth
 bool LogOOCFileParseThread::checkAuthentication(const QString &path)
 {
     //判断当前用户对文件是否可读
     QFlags <QFileDevice::Permission> power = QFile::permissions(path);
-    if (!power.testFlag(QFile::ReadUser)) {
-        //若当前用户不具备读取权限，则显示提权对话框
+    if (power.testFlag(QFile::ReadUser))
+        return true;
+
+    //若当前用户不具备读取权限，则显示提权对话框
+    return LogAuthCache::instance()->authorize(m_path, [this, &path]() {
         //共享内存对应变量置true，允许进程内部逻辑运行
         ShareMemoryInfo shareInfo;
         shareInfo.isStart = true;
@@ -105,15 +144,11 @@ bool LogOOCFileParseThread::checkAuthentication(const QString &path)
         //启动日志需要提权获取，运行的时候把对应共享内存的名称传进去，方便获取进程拿标记量判断是否继续运行
         initProccess();
         m_process->start("pkexec", QStringList() << "logViewerAuth"
-                         << path << SharedMemoryManager::instance()->getRunnableKey());
-        m_process->waitForFinished(-1);
+                         << path << SharedMemoryManager::instance()->getRunnableKey() << LOG_AUTH_NO_DATA);
+        LogCancelToken::current().waitForProcess(m_process.data());
         //有错则传出空数据
-        if (m_process->exitCode() != 0) {
-            return false;
-        }
-    }
-
-    return true;
+        return m_process->exitCode() == 0;
+    });
 }
 
 //void LogOOCFileParseThread::doWork()
@@ -5,12 +5,16 @@
 #ifndef LOGOOCFILEPARSETHREAD_H
 #define LOGOOCFILEPARSETHREAD_H
 #include "structdef.h"
+#include "logtextsource.h"
+#include "logarchive.h"
+#include "logingestmetrics.h"
 
 #include <QMap>
 #include <QObject>
 #include <QThread>
 #include <QProcess>
 
+#include <atomic>
 #include <mutex>
 
 /**
@@ -23,19 +27,23 @@ public:
     explicit LogOOCFileParseThread(QObject *parent = nullptr);
     ~LogOOCFileParseThread() override;
     void setParam(const QString &path);
+    void setArchive(const LogArchivePtr &archive, const QString &category);
     static int thread_count;
     void initProccess();
 
     const QScopedPointer<QProcess> &getProcess() const {return m_process;}
     const QString &getPath() const {return m_path;}
-    const QString &getFileData() const {return m_fileData;}
+    const QList<LogTextSourcePtr> &getSources() const {return m_sources;}
 
 signals:
     /**
      * @brief sigFinished 获取数据结束信号
      */
     void sigFinished(int index, int error = 0);
-    void sigData(int index, const QString &data);
+    /**
+     * @brief sigData 一个文件的内容读取并建立行索引后发出,按文件顺序
+     */
+    void sigData(int index, LogTextSourcePtr source);
 public slots:
     void doWork();
     void stopProccess();
@@ -51,15 +59,22 @@ private:
      * @brief m_path 文件路径
      */
     QString m_path;
+    /**
+     * @brief m_archive 不为空时读取归档中m_category类别的各文件,不读取本机文件
+     */
+    LogArchivePtr m_archive;
+    QString m_category;
 
     /**
-     * @brief m_fileData 获取的数据结果
+     * @brief m_sources 已读取的各文件内容,映射读取时不复制文件内容
      */
-    QString m_fileData;
+    QList<LogTextSourcePtr> m_sources;
     /**
      * @brief m_canRun 是否可以继续运行的标记量，用于停止运行线程
      */
-    bool m_canRun = false;
+    std::atomic_bool m_canRun {false};
+    //构造时(界面发起加载时)所属加载的指标计数,运行时安装到解析线程
+    LogIngestCountersPtr m_ingest {LogIngestMetrics::current()};
     /**
      * @brief m_threadIndex 当前线程标号
      */
@@ -0,0 +1,179 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGORDEREDPARSER_H
+#define LOGORDEREDPARSER_H
+
+#include "logcanceltoken.h"
+#include "logingestmetrics.h"
+
+#include <QList>
+#include <QMutex>
+#include <QQueue>
+#include <QSharedPointer>
+#include <QThread>
+#include <QVector>
+#include <QWaitCondition>
+
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <vector>
+
+//并行解析的最大线程数
+#define LOG_PARSE_MAX_THREADS 8
+//每个解析任务最多缓存的批数,解析快于交付时阻塞,避免占用过多内存
+#define LOG_PARSE_QUEUE 8
+
+/**
+ * @brief The LogOrderedParser class 多个日志文件(如一组轮转文件)的并行解析
+ * 每个任务有一个顺序号,在线程池中并行解析,任务的结果进入各自的有界队列;
+ * 交付端按顺序号依次取出,所以交付顺序和串行解析完全一致(轮转文件从新到旧)
+ */
+template <typename Record>
+class LogOrderedParser
+{
+public:
+    /**
+     * @brief Sink 解析任务交出一批数据,返回false表示已被停止,任务应立即结束
+     */
+    typedef std::function<bool(QList<Record> &)> Sink;
+    typedef std::function<void(int index, const Sink &sink)> Task;
+    typedef std::function<void(QList<Record> &)> Deliver;
+
+    explicit LogOrderedParser(const std::atomic_bool &canRun)
+        : m_canRun(canRun)
+    {
+    }
+
+    static int idealThreadCount(int taskCount)
+    {
+        return qBound(1, qMin(QThread::idealThreadCount(), LOG_PARSE_MAX_THREADS), qMax(taskCount, 1));
+    }
+
+    /**
+     * @brief run 执行所有任务,在调用者线程按顺序号交付结果
+     * @param taskCount 任务数
+     * @param threads 线程数,不超过1时在调用者线程串行解析
+     * @param task 解析任务
+     * @param deliver 交付函数,只在调用者线程调用
+     * @return 是否全部完成,被停止时返回false
+     */
+    bool run(int taskCount, int threads, const Task &task, const Deliver &deliver)
+    {
+        if (threads <= 1 || taskCount <= 1) {
+            Sink sink = [this, &deliver](QList<Record> &records) {
+                if (!m_canRun)
+                    return false;
+                deliver(records);
+                records.clear();
+                return true;
+            };
+            for (int i = 0; i < taskCount && m_canRun; ++i)
+                task(i, sink);
+            return m_canRun;
+        }
+
+        std::atomic_bool abort(false);
+        std::atomic_int next(0);
+        QVector<QSharedPointer<Queue>> queues;
+        for (int i = 0; i < taskCount; ++i)
+            queues.append(QSharedPointer<Queue>(new Queue(m_canRun, abort)));
+
+        //任务按顺序号领取,正在交付的任务一定已被领取,不会因为后面的队列满而死锁
+        std::vector<std::thread> workers;
+        //解析线程中的读取计入调用者所属的加载,调用者停止时解析线程中等待的总线调用也随之返回
+        const LogIngestCountersPtr ingest = LogIngestMetrics::current();
+        const LogCancelToken cancel = LogCancelToken::current();
+        for (int t = 0; t < qMin(threads, taskCount); ++t) {
+            workers.emplace_back([&]() {
+                LogIngestScope ingestScope(ingest);
+                LogCancelScope cancelScope(cancel);
+                int index;
+                while ((index = next++) < taskCount) {
+                    Queue *queue = queues.at(index).data();
+                    if (!queue->stopped()) {
+                        task(index, [queue](QList<Record> &records) {
+                            return queue->push(records);
+                        });
+                    }
+                    queue->finish();
+                }
+            });
+        }
+
+        QList<Record> records;
+        for (int i = 0; i < taskCount && m_canRun; ++i) {
+            while (queues.at(i)->pop(records))
+                deliver(records);
+        }
+
+        abort = true;
+        for (std::thread &worker : workers)
+            worker.join();
+        return m_canRun;
+    }
+
+private:
+    /**
+     * @brief The Queue class 单个任务到交付端的有界队列
+     */
+    class Queue
+    {
+    public:
+        Queue(const std::atomic_bool &canRun, const std::atomic_bool &abort)
+            : m_canRun(canRun)
+            , m_abort(abort)
+        {
+        }
+
+        bool stopped() const { return !m_canRun || m_abort; }
+
+        bool push(QList<Record> &records)
+        {
+            QMutexLocker locker(&m_mutex);
+            //定时醒来检查是否被停止
+            while (m_queue.size() >= LOG_PARSE_QUEUE && !stopped())
+                m_notFull.wait(&m_mutex, 100);
+            if (stopped())
+                return false;
+            m_queue.enqueue(records);
+            records.clear();
+            m_notEmpty.wakeOne();
+            return true;
+        }
+
+        bool pop(QList<Record> &records)
+        {
+            QMutexLocker locker(&m_mutex);
+            while (m_queue.isEmpty() && !m_finished && !stopped())
+                m_notEmpty.wait(&m_mutex, 100);
+            if (m_queue.isEmpty() || stopped())
+                return false;
+            records = m_queue.dequeue();
+            m_notFull.wakeOne();
+            return true;
+        }
+
+        void finish()
+        {
+            QMutexLocker locker(&m_mutex);
+            m_finished = true;
+            m_notEmpty.wakeOne();
+        }
+
+    private:
+        const std::atomic_bool &m_canRun;
+        const std::atomic_bool &m_abort;
+        QMutex m_mutex;
+        QWaitCondition m_notEmpty;
+        QWaitCondition m_notFull;
+        QQueue<QList<Record>> m_queue;
+        bool m_finished = false;
+    };
+
+    const std::atomic_bool &m_canRun;
+};
+
+#endif // LOGORDEREDPARSER_H
@@ -0,0 +1,213 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logpagedtextview.h"
+
+#include <QApplication>
+#include <QClipboard>
+#include <QKeyEvent>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QScrollBar>
+#include <QStringList>
+
+#include <algorithm>
+
+/**
+ * @brief LogPagedTextView::LogPagedTextView 构造函数
+ * @param parent 父对象
+ */
+LogPagedTextView::LogPagedTextView(QWidget *parent)
+    : QAbstractScrollArea(parent)
+{
+    setFocusPolicy(Qt::ClickFocus);
+    setVerticalScrollBarPolicy(Qt::ScrollBarAsNeeded);
+    setHorizontalScrollBarPolicy(Qt::ScrollBarAsNeeded);
+    verticalScrollBar()->setSingleStep(1);
+    updateScrollBars();
+}
+
+/**
+ * @brief LogPagedTextView::appendSource 在末尾追加一个文件的内容
+ * @param source 已建立行索引的内容
+ */
+void LogPagedTextView::appendSource(const LogTextSourcePtr &source)
+{
+    if (!source || source->lineCount() == 0)
+        return;
+    m_sources.append(source);
+    m_starts.append(m_lineCount);
+    m_lineCount += source->lineCount();
+    updateScrollBars();
+    viewport()->update();
+}
+
+void LogPagedTextView::clear()
+{
+    m_sources.clear();
+    m_starts.clear();
+    m_lineCount = 0;
+    m_maxWidth = 0;
+    m_anchor = -1;
+    m_cursor = -1;
+    verticalScrollBar()->setValue(0);
+    horizontalScrollBar()->setValue(0);
+    updateScrollBars();
+    viewport()->update();
+}
+
+/**
+ * @brief LogPagedTextView::lineText 全局第line行的文字,文件被截断后返回空
+ */
+QString LogPagedTextView::lineText(int line) const
+{
+    if (line < 0 || line >= m_lineCount)
+        return QString();
+    const int source = sourceOf(line);
+    const LogTextSourcePtr &text = m_sources.at(source);
+    if (!text->isValid())
+        return QString();
+    return text->line(line - m_starts.at(source));
+}
+
+/**
+ * @brief LogPagedTextView::selectedText 选中的行,以换行符连接
+ */
+QString LogPagedTextView::selectedText() const
+{
+    if (m_anchor < 0)
+        return QString();
+    const int first = qMin(m_anchor, m_cursor);
+    const int last = qMax(m_anchor, m_cursor);
+    QStringList lines;
+    lines.reserve(last - first + 1);
+    for (int line = first; line <= last; ++line)
+        lines.append(lineText(line));
+    return lines.join('\n');
+}
+
+/**
+ * @brief LogPagedTextView::paintEvent 只解码和绘制可见的行
+ */
+void LogPagedTextView::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event)
+    QPainter painter(viewport());
+    const int height = lineHeight();
+    const int ascent = fontMetrics().ascent();
+    const int offsetX = horizontalScrollBar()->value();
+    const int first = verticalScrollBar()->value();
+    const int last = qMin(m_lineCount, first + viewport()->height() / height + 1);
+    const int selFirst = m_anchor < 0 ? -1 : qMin(m_anchor, m_cursor);
+    const int selLast = m_anchor < 0 ? -1 : qMax(m_anchor, m_cursor);
+
+    int maxWidth = m_maxWidth;
+    for (int line = first; line < last; ++line) {
+        const int y = (line - first) * height;
+        QString text = lineText(line);
+        if (text.size() > LOG_PAGED_LINE_MAX_PAINT)
+            text.truncate(LOG_PAGED_LINE_MAX_PAINT);
+        const bool selected = line >= selFirst && line <= selLast;
+        if (selected) {
+            painter.fillRect(QRect(0, y, viewport()->width(), height), palette().color(QPalette::Highlight));
+            painter.setPen(palette().color(QPalette::HighlightedText));
+        } else {
+            painter.setPen(palette().color(QPalette::Text));
+        }
+        painter.drawText(QPoint(-offsetX, y + ascent), text);
+        maxWidth = qMax(maxWidth, fontMetrics().width(text));
+    }
+
+    if (maxWidth != m_maxWidth) {
+        m_maxWidth = maxWidth;
+        updateScrollBars();
+    }
+}
+
+void LogPagedTextView::resizeEvent(QResizeEvent *event)
+{
+    QAbstractScrollArea::resizeEvent(event);
+    updateScrollBars();
+}
+
+void LogPagedTextView::mousePressEvent(QMouseEvent *event)
+{
+    const int line = lineAt(event->pos().y());
+    if (event->button() != Qt::LeftButton || line < 0) {
+        QAbstractScrollArea::mousePressEvent(event);
+        return;
+    }
+    if (!(event->modifiers() & Qt::ShiftModifier) || m_anchor < 0)
+        m_anchor = line;
+    m_cursor = line;
+    viewport()->update();
+}
+
+void LogPagedTextView::mouseMoveEvent(QMouseEvent *event)
+{
+    if (!(event->buttons() & Qt::LeftButton) || m_anchor < 0 || m_lineCount == 0)
+        return;
+    //拖出可见区域时跟随滚动
+    if (event->pos().y() < 0)
+        verticalScrollBar()->setValue(verticalScrollBar()->value() - 1);
+    else if (event->pos().y() > viewport()->height())
+        verticalScrollBar()->setValue(verticalScrollBar()->value() + 1);
+    const int line = lineAt(qBound(0, event->pos().y(), viewport()->height() - 1));
+    m_cursor = line < 0 ? m_lineCount - 1 : line;
+    viewport()->update();
+}
+
+void LogPagedTextView::keyPressEvent(QKeyEvent *event)
+{
+    if (event->matches(QKeySequence::Copy)) {
+        const QString text = selectedText();
+        if (!text.isEmpty())
+            QApplication::clipboard()->setText(text);
+        return;
+    }
+    if (event->matches(QKeySequence::SelectAll)) {
+        if (m_lineCount > 0) {
+            m_anchor = 0;
+            m_cursor = m_lineCount - 1;
+            viewport()->update();
+        }
+        return;
+    }
+    QAbstractScrollArea::keyPressEvent(event);
+}
+
+/**
+ * @brief LogPagedTextView::updateScrollBars 垂直滚动条按行,水平滚动条按像素
+ */
+void LogPagedTextView::updateScrollBars()
+{
+    const int visible = qMax(1, viewport()->height() / lineHeight());
+    verticalScrollBar()->setPageStep(visible);
+    verticalScrollBar()->setRange(0, qMax(0, m_lineCount - visible));
+    horizontalScrollBar()->setPageStep(viewport()->width());
+    horizontalScrollBar()->setSingleStep(fontMetrics().averageCharWidth());
+    horizontalScrollBar()->setRange(0, qMax(0, m_maxWidth - viewport()->width()));
+}
+
+int LogPagedTextView::lineHeight() const
+{
+    return qMax(1, fontMetrics().height());
+}
+
+/**
+ * @brief LogPagedTextView::lineAt 视口中y处的全局行号,没有行时为-1
+ */
+int LogPagedTextView::lineAt(int y) const
+{
+    const int line = verticalScrollBar()->value() + y / lineHeight();
+    return line >= 0 && line < m_lineCount ? line : -1;
+}
+
+/**
+ * @brief LogPagedTextView::sourceOf 全局行号所在的文件下标
+ */
+int LogPagedTextView::sourceOf(int line) const
+{
+    return static_cast<int>(std::upper_bound(m_starts.constBegin(), m_starts.constEnd(), line) - m_starts.constBegin()) - 1;
+}
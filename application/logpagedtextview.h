@@ -0,0 +1,61 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGPAGEDTEXTVIEW_H
+#define LOGPAGEDTEXTVIEW_H
+
+#include "logtextsource.h"
+
+#include <QAbstractScrollArea>
+#include <QVector>
+
+//单行最多绘制的字符数,超长的行只绘制开头部分,复制时仍是完整内容
+#define LOG_PAGED_LINE_MAX_PAINT 4096
+
+/**
+ * @brief The LogPagedTextView class 大文件的分页文本显示控件,用于其他日志和自定义日志
+ * 内容为若干LogTextSource,只解码和绘制可见的行,滚动条按行计数;
+ * 支持按行选择(鼠标拖动、Shift+点击、Ctrl+A)和Ctrl+C复制
+ */
+class LogPagedTextView : public QAbstractScrollArea
+{
+    Q_OBJECT
+public:
+    explicit LogPagedTextView(QWidget *parent = nullptr);
+
+    void appendSource(const LogTextSourcePtr &source);
+    void clear();
+    int lineCount() const { return m_lineCount; }
+    QString lineText(int line) const;
+    QString selectedText() const;
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+    void keyPressEvent(QKeyEvent *event) override;
+
+private:
+    void updateScrollBars();
+    int lineHeight() const;
+    int lineAt(int y) const;
+    int sourceOf(int line) const;
+
+    QVector<LogTextSourcePtr> m_sources;
+    /**
+     * @brief m_starts 每个文件第一行的全局行号
+     */
+    QVector<int> m_starts;
+    int m_lineCount = 0;
+    /**
+     * @brief m_maxWidth 已绘制过的最宽行的宽度,用于水平滚动范围
+     */
+    int m_maxWidth = 0;
+    //选中的行范围,m_anchor为-1表示没有选中
+    int m_anchor = -1;
+    int m_cursor = -1;
+};
+
+#endif // LOGPAGEDTEXTVIEW_H
@@ -0,0 +1,110 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logparsecontext.h"
+
+#include <QMutexLocker>
+
+/**
+ * @brief LogParseContext::reset 归还前清空上次的行,字符串池保留;池已收满时清空,免得新的值再也收不进去
+ */
+void LogParseContext::reset()
+{
+    lines.clear();
+    if (strings.size() >= LOG_STRING_POOL_MAX_SIZE)
+        strings.clear();
+}
+
+LogParseContextPool::Lease::Lease(LogParseContextPool *pool, const QByteArray &kind, std::unique_ptr<LogParseContext> context)
+    : m_pool(pool)
+    , m_kind(kind)
+    , m_context(std::move(context))
+{
+}
+
+LogParseContextPool::Lease::Lease(Lease &&other) noexcept
+    : m_pool(other.m_pool)
+    , m_kind(std::move(other.m_kind))
+    , m_context(std::move(other.m_context))
+{
+    other.m_pool = nullptr;
+}
+
+LogParseContextPool::Lease &LogParseContextPool::Lease::operator=(Lease &&other) noexcept
+{
+    if (this != &other) {
+        release();
+        m_pool = other.m_pool;
+        m_kind = std::move(other.m_kind);
+        m_context = std::move(other.m_context);
+        other.m_pool = nullptr;
+    }
+    return *this;
+}
+
+LogParseContextPool::Lease::~Lease()
+{
+    release();
+}
+
+void LogParseContextPool::Lease::release()
+{
+    if (m_pool && m_context)
+        m_pool->giveBack(m_kind, std::move(m_context));
+    m_pool = nullptr;
+}
+
+LogParseContextPool &LogParseContextPool::instance()
+{
+    static LogParseContextPool pool;
+    return pool;
+}
+
+/**
+ * @brief LogParseContextPool::acquire 取出一个空闲的上下文,没有时新建
+ * @param kind 日志种类,同一种类的上下文才能互相复用
+ */
+LogParseContextPool::Lease LogParseContextPool::acquire(const QByteArray &kind)
+{
+    std::unique_ptr<LogParseContext> context;
+    {
+        QMutexLocker locker(&m_mutex);
+        auto it = m_idle.find(kind);
+        if (it != m_idle.end() && !it->second.empty()) {
+            context = std::move(it->second.back());
+            it->second.pop_back();
+        }
+    }
+    if (!context)
+        context.reset(new LogParseContext);
+    return Lease(this, kind, std::move(context));
+}
+
+/**
+ * @brief LogParseContextPool::idleCount 某种日志的空闲上下文个数
+ */
+int LogParseContextPool::idleCount(const QByteArray &kind) const
+{
+    QMutexLocker locker(&m_mutex);
+    auto it = m_idle.find(kind);
+    return it == m_idle.end() ? 0 : static_cast<int>(it->second.size());
+}
+
+/**
+ * @brief LogParseContextPool::clear 释放全部空闲的上下文,已取出的归还时重新入池
+ */
+void LogParseContextPool::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_idle.clear();
+}
+
+void LogParseContextPool::giveBack(const QByteArray &kind, std::unique_ptr<LogParseContext> context)
+{
+    context->reset();
+    QMutexLocker locker(&m_mutex);
+    std::vector<std::unique_ptr<LogParseContext>> &idle = m_idle[kind];
+    if (idle.size() < LOG_PARSE_CONTEXT_IDLE_MAX)
+        idle.push_back(std::move(context));
+}
@@ -0,0 +1,78 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGPARSECONTEXT_H
+#define LOGPARSECONTEXT_H
+
+#include "logstringpool.h"
+
+#include <QByteArray>
+#include <QMutex>
+#include <QStringList>
+
+#include <map>
+#include <memory>
+#include <vector>
+
+//每种日志最多保留的空闲解析上下文个数,和并行解析的线程数相当
+#define LOG_PARSE_CONTEXT_IDLE_MAX 8
+
+/**
+ * @brief The LogParseContext struct 一次解析用到的可复用状态
+ * 字符串池保留上次加载收录的主机名、进程名等,再次加载同类日志时直接命中;行缓冲在各块之间复用
+ */
+struct LogParseContext {
+    LogStringPool strings;
+    QStringList lines;
+
+    void reset();
+};
+
+/**
+ * @brief The LogParseContextPool class 按日志种类保存空闲的解析上下文,快速切换类别和刷新时不再重新建表
+ * 同一个上下文同时只在一个线程中使用;取出和归还加锁,解析过程中不加锁
+ */
+class LogParseContextPool
+{
+public:
+    /**
+     * @brief The Lease class 取出的上下文,析构时归还到池中
+     */
+    class Lease
+    {
+    public:
+        Lease() = default;
+        Lease(Lease &&other) noexcept;
+        Lease &operator=(Lease &&other) noexcept;
+        Lease(const Lease &) = delete;
+        Lease &operator=(const Lease &) = delete;
+        ~Lease();
+
+        LogParseContext *operator->() const { return m_context.get(); }
+        LogParseContext &operator*() const { return *m_context; }
+
+    private:
+        friend class LogParseContextPool;
+        Lease(LogParseContextPool *pool, const QByteArray &kind, std::unique_ptr<LogParseContext> context);
+        void release();
+
+        LogParseContextPool *m_pool = nullptr;
+        QByteArray m_kind;
+        std::unique_ptr<LogParseContext> m_context;
+    };
+
+    static LogParseContextPool &instance();
+
+    Lease acquire(const QByteArray &kind);
+    int idleCount(const QByteArray &kind) const;
+    void clear();
+
+private:
+    void giveBack(const QByteArray &kind, std::unique_ptr<LogParseContext> context);
+
+    mutable QMutex m_mutex;
+    std::map<QByteArray, std::vector<std::unique_ptr<LogParseContext>>> m_idle;
+};
+
+#endif // LOGPARSECONTEXT_H
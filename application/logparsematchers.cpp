@@ -0,0 +1,404 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logparsematchers.h"
+#include "structdef.h"
+#include "loglocaltime.h"
+
+#include <QTime>
+
+namespace {
+bool isDigit(const QChar &c)
+{
+    return c.unicode() >= '0' && c.unicode() <= '9';
+}
+
+//从pos开始读取count位十进制数字,调用前已确认都是数字
+int readNumber(const QString &line, int pos, int count)
+{
+    int value = 0;
+    for (int i = pos; i < pos + count; ++i)
+        value = value * 10 + (line.at(i).unicode() - '0');
+    return value;
+}
+
+//"yyyy-MM-dd",月和日的十位分别只能是0-2和0-3,和正则\d{4}-[0-2]\d-[0-3]\d一致
+bool matchDate(const QString &line, int pos)
+{
+    if (line.size() < pos + 10)
+        return false;
+    for (int i : {0, 1, 2, 3, 5, 6, 8, 9}) {
+        if (!isDigit(line.at(pos + i)))
+            return false;
+    }
+    return line.at(pos + 4) == '-' && line.at(pos + 7) == '-' && line.at(pos + 5).unicode() <= '2'
+           && line.at(pos + 8).unicode() <= '3';
+}
+
+//"hh:mm:ss",和正则[0-2]\d:[0-5]\d:[0-5]\d一致
+bool matchTime(const QString &line, int pos)
+{
+    if (line.size() < pos + 8)
+        return false;
+    for (int i : {0, 1, 3, 4, 6, 7}) {
+        if (!isDigit(line.at(pos + i)))
+            return false;
+    }
+    return line.at(pos + 2) == ':' && line.at(pos + 5) == ':' && line.at(pos).unicode() <= '2'
+           && line.at(pos + 3).unicode() <= '5' && line.at(pos + 6).unicode() <= '5';
+}
+
+//日期之后跳过非数字(正则中的\D*),返回时间的开始位置
+int skipNonDigits(const QString &line, int pos)
+{
+    while (pos < line.size() && !isDigit(line.at(pos)))
+        ++pos;
+    return pos;
+}
+
+//按当地时间换算,日期或时间无效时返回-1
+qint64 localTime(const QString &line, int datePos, int timePos, int msecs)
+{
+    const QDate date(readNumber(line, datePos, 4), readNumber(line, datePos + 5, 2), readNumber(line, datePos + 8, 2));
+    const int hour = readNumber(line, timePos, 2);
+    const int minute = readNumber(line, timePos + 3, 2);
+    const int second = readNumber(line, timePos + 6, 2);
+    if (!date.isValid() || !QTime::isValid(hour, minute, second, msecs))
+        return -1;
+    return LogParseMatchers::localMSecs(date, hour, minute, second, msecs);
+}
+
+bool isAsciiLetter(const QChar &c)
+{
+    const ushort u = c.unicode();
+    return (u >= 'A' && u <= 'Z') || (u >= 'a' && u <= 'z');
+}
+
+//未开启UseUnicodePropertiesOption时正则的\s和\w都只匹配ASCII字符
+bool isSpace(const QChar &c)
+{
+    const ushort u = c.unicode();
+    return u == ' ' || (u >= '\t' && u <= '\r');
+}
+
+bool isWordChar(const QChar &c)
+{
+    return isAsciiLetter(c) || isDigit(c) || c.unicode() == '_';
+}
+}
+
+LogParseMatchers::LogParseMatchers()
+    : dnfLine("^(\\d{4}-[0-2]\\d-[0-3]\\d)\\D*([0-2]\\d:[0-5]\\d:[0-5]\\d)\\S*\\s*(\\w*)\\s*(.*)$")
+    , dmesgLine("^\\<([0-7])\\>\\[\\s*[+-]?(0|([1-9]\\d*))(\\.\\d+)?\\](.*)")
+{
+    //解析线程会对每一行调用,提前优化避免首次匹配时再做
+    dnfLine.optimize();
+    dmesgLine.optimize();
+}
+
+/**
+ * @brief LogParseMatchers::instance 获取共用的匹配器,线程安全的懒加载
+ * @return 匹配器对象
+ */
+const LogParseMatchers &LogParseMatchers::instance()
+{
+    static const LogParseMatchers matchers;
+    return matchers;
+}
+
+/**
+ * @brief LogParseMatchers::scanDnfPrefix 按位置识别dnf日志行,结果和dnfLine的分组一致
+ * 正则各部分都是贪婪且不回溯的,第一个数字之后依次是时间、非空白、空白、等级、空白和信息
+ * @param line 一行日志
+ * @param prefix 输出参数,时间、等级和信息的位置
+ * @return 是记录行且时间有效时返回true;返回false时调用者按多行信息处理
+ */
+bool LogParseMatchers::scanDnfPrefix(const QString &line, LogLinePrefix &prefix)
+{
+    if (!matchDate(line, 0))
+        return false;
+    const int timePos = skipNonDigits(line, 10);
+    if (!matchTime(line, timePos))
+        return false;
+    prefix.time = localTime(line, 0, timePos, 0);
+    if (prefix.time < 0)
+        return false;
+
+    const int size = line.size();
+    int pos = timePos + 8;
+    while (pos < size && !isSpace(line.at(pos)))
+        ++pos;
+    while (pos < size && isSpace(line.at(pos)))
+        ++pos;
+    prefix.levelBegin = pos;
+    while (pos < size && isWordChar(line.at(pos)))
+        ++pos;
+    prefix.levelEnd = pos;
+    while (pos < size && isSpace(line.at(pos)))
+        ++pos;
+    prefix.restBegin = pos;
+    return true;
+}
+
+/**
+ * @brief LogParseMatchers::scanAppPrefix 按位置识别应用日志行首的时间和等级,和应用日志正则的前三个分组一致
+ * 时间为"hh:mm:ss"加任意一个字符和若干数字,只有".毫秒(三位)"时换算出时间,否则time为-1,由调用者按正则结果判断
+ * @param line 一行日志
+ * @param prefix 输出参数,时间和等级的位置
+ * @return 是否为应用日志的记录行
+ */
+bool LogParseMatchers::scanAppPrefix(const QString &line, LogLinePrefix &prefix)
+{
+    if (!matchDate(line, 0))
+        return false;
+    const int timePos = skipNonDigits(line, 10);
+    //时间之后至少还有一个字符
+    if (!matchTime(line, timePos) || line.size() <= timePos + 8)
+        return false;
+
+    const int size = line.size();
+    int pos = timePos + 9;
+    while (pos < size && isDigit(line.at(pos)))
+        ++pos;
+    const int digits = pos - timePos - 9;
+    prefix.timeBegin = timePos;
+    prefix.timeEnd = pos;
+    prefix.time = (line.at(timePos + 8) == '.' && digits == 3) ? localTime(line, 0, timePos, readNumber(line, timePos + 9, 3)) : -1;
+
+    while (pos < size && !isAsciiLetter(line.at(pos)))
+        ++pos;
+    prefix.levelBegin = pos;
+    while (pos < size && isAsciiLetter(line.at(pos)))
+        ++pos;
+    prefix.levelEnd = pos;
+    prefix.restBegin = pos;
+    return true;
+}
+
+/**
+ * @brief LogParseMatchers::scanAppLine 按位置识别整行应用日志,结果和应用日志正则的四个分组一致,
+ * 解析时不再逐行做正则匹配和QDateTime::fromString
+ * 等级之后依次是[^\[]*、[^\]]*、\]*和\s*,都是贪婪的且后面的(.*)总能匹配,所以不会回溯:
+ * 跳到第一个'['后面的第一个']',再跳过连续的']'和空白即为信息;没有'['或']'时信息为空
+ * @param line 一行日志
+ * @param prefix 输出参数,时间、等级的位置,restBegin为信息的开始
+ * @return 是记录行且时间能按"yyyy-MM-dd hh:mm:ss.zzz"换算时返回true;返回false时调用者按正则处理
+ */
+bool LogParseMatchers::scanAppLine(const QString &line, LogLinePrefix &prefix)
+{
+    if (!scanAppPrefix(line, prefix) || prefix.time < 0)
+        return false;
+
+    const int size = line.size();
+    int pos = prefix.levelEnd;
+    while (pos < size && line.at(pos) != '[')
+        ++pos;
+    while (pos < size && line.at(pos) != ']')
+        ++pos;
+    while (pos < size && line.at(pos) == ']')
+        ++pos;
+    while (pos < size && isSpace(line.at(pos)))
+        ++pos;
+    prefix.restBegin = pos;
+    return true;
+}
+
+/**
+ * @brief LogParseMatchers::scanBootStatus 按位置识别systemd写入boot.log的状态前缀,如"[  OK  ] Started ..."、"[FAILED] Failed to ..."
+ * 行首(可有空白)为'[',其后10个字符内有']',括号内去掉空白后为OK或FAILED(不区分大小写)
+ * @param line 已去掉颜色序列的一行
+ * @param msgBegin 输出参数,信息的开始;没有状态时为第一个非空白字符
+ * @return BOOT_STATUS的值
+ */
+int LogParseMatchers::scanBootStatus(const QString &line, int &msgBegin)
+{
+    const int size = line.size();
+    int pos = 0;
+    while (pos < size && isSpace(line.at(pos)))
+        ++pos;
+    msgBegin = pos;
+    if (pos >= size || line.at(pos) != '[')
+        return BootStatusNone;
+
+    const int end = line.indexOf(']', pos + 1);
+    if (end < 0 || end - pos > 10)
+        return BootStatusNone;
+    const QStringRef inner = line.midRef(pos + 1, end - pos - 1).trimmed();
+    int status = BootStatusNone;
+    if (inner.compare(QLatin1String("OK"), Qt::CaseInsensitive) == 0)
+        status = BootStatusOk;
+    else if (inner.compare(QLatin1String("FAILED"), Qt::CaseInsensitive) == 0)
+        status = BootStatusFailed;
+    else
+        return BootStatusNone;
+
+    pos = end + 1;
+    while (pos < size && isSpace(line.at(pos)))
+        ++pos;
+    msgBegin = pos;
+    return status;
+}
+
+/**
+ * @brief LogParseMatchers::bootStatusText 启动日志状态的显示文字,所有记录共用同一份字符串
+ */
+QString LogParseMatchers::bootStatusText(int status)
+{
+    static const QString ok = QStringLiteral("OK");
+    static const QString failed = QStringLiteral("Failed");
+    switch (status) {
+    case BootStatusOk:
+        return ok;
+    case BootStatusFailed:
+        return failed;
+    default:
+        return QString();
+    }
+}
+
+/**
+ * @brief LogParseMatchers::bootStatusFilter 状态筛选文字("OK"、"Failed",不区分大小写)转换为BOOT_STATUS
+ * @return 为空时返回-1表示不筛选;不认识的文字返回BootStatusNone,只匹配没有状态的行
+ */
+int LogParseMatchers::bootStatusFilter(const QString &statusFilter)
+{
+    if (statusFilter.isEmpty())
+        return -1;
+    if (statusFilter.compare(QLatin1String("OK"), Qt::CaseInsensitive) == 0)
+        return BootStatusOk;
+    if (statusFilter.compare(QLatin1String("Failed"), Qt::CaseInsensitive) == 0)
+        return BootStatusFailed;
+    return BootStatusNone;
+}
+
+/**
+ * @brief LogParseMatchers::localMSecs 当地时间换算为毫秒数,结果和QDateTime(date, time).toMSecsSinceEpoch()一致,见LogLocalTime::toMSecs
+ * @param date 有效的日期
+ * @return 毫秒数
+ */
+qint64 LogParseMatchers::localMSecs(const QDate &date, int hour, int minute, int second, int msecs)
+{
+    return LogLocalTime::toMSecs(date, hour, minute, second, msecs);
+}
+
+/**
+ * @brief LogParseMatchers::parseIsoDateTime 按位置解析"yyyy-MM-dd"和"hh:mm:ss"
+ * @param date 日期文本
+ * @param time 时间文本
+ * @return 当地时间毫秒数,不是这一格式或日期时间无效时为-1,由调用者按原来的方式解析
+ */
+qint64 LogParseMatchers::parseIsoDateTime(const QString &date, const QString &time)
+{
+    if (date.size() != 10 || time.size() != 8 || !matchDate(date, 0) || !matchTime(time, 0))
+        return -1;
+    const QDate day(readNumber(date, 0, 4), readNumber(date, 5, 2), readNumber(date, 8, 2));
+    const int hour = readNumber(time, 0, 2);
+    const int minute = readNumber(time, 3, 2);
+    const int second = readNumber(time, 6, 2);
+    if (!day.isValid() || !QTime::isValid(hour, minute, second, 0))
+        return -1;
+    return localMSecs(day, hour, minute, second);
+}
+
+/**
+ * @brief LogParseMatchers::parseSyslogDateTime 按位置解析syslog格式的"MMM"、"d"和"hh:mm:ss",月份为英文缩写
+ * @param year 年份,syslog格式的时间中没有年份
+ * @return 当地时间毫秒数,不是这一格式或日期时间无效时为-1
+ */
+qint64 LogParseMatchers::parseSyslogDateTime(const QString &month, const QString &day, const QString &time, int year)
+{
+    static const char *const months[] = {"jan", "feb", "mar", "apr", "may", "jun", "jul", "aug", "sep", "oct", "nov", "dec"};
+    if (month.size() != 3 || day.isEmpty() || day.size() > 2 || time.size() != 8 || !matchTime(time, 0))
+        return -1;
+    int monthNumber = 0;
+    for (int i = 0; i < 12 && monthNumber == 0; ++i) {
+        if (month.compare(QLatin1String(months[i]), Qt::CaseInsensitive) == 0)
+            monthNumber = i + 1;
+    }
+    for (const QChar &c : day) {
+        if (!isDigit(c))
+            return -1;
+    }
+    const QDate date(year, monthNumber, readNumber(day, 0, day.size()));
+    const int hour = readNumber(time, 0, 2);
+    const int minute = readNumber(time, 3, 2);
+    const int second = readNumber(time, 6, 2);
+    if (monthNumber == 0 || !date.isValid() || !QTime::isValid(hour, minute, second, 0))
+        return -1;
+    return localMSecs(date, hour, minute, second);
+}
+
+/**
+ * @brief LogParseMatchers::stripColorSequences 去掉行中的终端颜色控制序列,
+ * 等价于依次替换正则"\\x1B\\[\\d+(;\\d+){0,2}m"和"\\#033\\[\\d+(;\\d+){0,2}m",但只扫描一遍
+ * @param line 要清洗的行,不含ESC和"#033["的行不做任何修改
+ */
+void LogParseMatchers::stripColorSequences(QString &line)
+{
+    //QString::indexOf按字符查找是向量化的,绝大多数行在这里就返回
+    int first = line.indexOf(QChar(0x1B));
+    int hashFirst = line.indexOf(QLatin1String("#033["));
+    if (first < 0 && hashFirst < 0)
+        return;
+    if (first < 0 || (hashFirst >= 0 && hashFirst < first))
+        first = hashFirst;
+
+    const QChar *data = line.constData();
+    const int length = line.size();
+    QString result;
+    result.reserve(length);
+    result.append(data, first);
+    int i = first;
+    while (i < length) {
+        const QChar c = data[i];
+        if (c.unicode() == 0x1B || c.unicode() == '#') {
+            int seqLength = colorSequenceLength(data + i, length - i);
+            if (seqLength > 0) {
+                i += seqLength;
+                continue;
+            }
+        }
+        result.append(c);
+        ++i;
+    }
+    line = result;
+}
+
+/**
+ * @brief LogParseMatchers::colorSequenceLength 判断data开头是否为颜色控制序列 ESC[或#033[ 数字(;数字){0,2}m
+ * @param data 数据
+ * @param length 数据长度
+ * @return 序列长度,不是颜色序列返回0
+ */
+int LogParseMatchers::colorSequenceLength(const QChar *data, int length)
+{
+    int i = 0;
+    if (length >= 2 && data[0].unicode() == 0x1B && data[1].unicode() == '[') {
+        i = 2;
+    } else if (length >= 5 && data[0].unicode() == '#' && data[1].unicode() == '0' && data[2].unicode() == '3'
+               && data[3].unicode() == '3' && data[4].unicode() == '[') {
+        i = 5;
+    } else {
+        return 0;
+    }
+
+    //最多三组数字,组之间以';'分隔
+    for (int group = 0; group < 3; ++group) {
+        int digits = 0;
+        while (i < length && data[i].unicode() >= '0' && data[i].unicode() <= '9') {
+            ++i;
+            ++digits;
+        }
+        if (digits == 0)
+            return 0;
+        if (i >= length)
+            return 0;
+        if (data[i].unicode() == 'm')
+            return i + 1;
+        if (data[i].unicode() != ';' || group == 2)
+            return 0;
+        ++i;
+    }
+    return 0;
+}
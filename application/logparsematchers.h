@@ -0,0 +1,66 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGPARSEMATCHERS_H
+#define LOGPARSEMATCHERS_H
+
+#include <QDate>
+#include <QRegularExpression>
+#include <QString>
+#include <QStringList>
+
+/**
+ * @brief The LogLinePrefix struct 行首已识别出的时间和等级,只记位置,不复制文字
+ */
+struct LogLinePrefix {
+    //当地时间毫秒数,不能按固定格式换算时为-1
+    qint64 time = -1;
+    //等级在行中的范围
+    int levelBegin = 0;
+    int levelEnd = 0;
+    //等级之后跳过空白的位置,即信息的开始
+    int restBegin = 0;
+    //时间文字在行中的范围,只有scanAppPrefix填写
+    int timeBegin = 0;
+    int timeEnd = 0;
+
+    QStringRef level(const QString &line) const
+    {
+        return line.midRef(levelBegin, levelEnd - levelBegin);
+    }
+};
+
+/**
+ * @brief The LogParseMatchers class 文件类日志解析共用的预编译正则和颜色序列清洗
+ * 正则只在第一次使用时编译一次,QRegularExpression的const匹配可在多个解析线程中共用;
+ * 带筛选条件加载时先用scan*Prefix按位置识别行首的时间和等级,不满足条件的行不再做正则匹配和取字段;
+ * 固定格式的时间按位置取数字后由LogLocalTime换算,不经过QDateTime::fromString的格式解析
+ */
+class LogParseMatchers
+{
+public:
+    static const LogParseMatchers &instance();
+
+    static void stripColorSequences(QString &line);
+    static bool scanDnfPrefix(const QString &line, LogLinePrefix &prefix);
+    static bool scanAppPrefix(const QString &line, LogLinePrefix &prefix);
+    static bool scanAppLine(const QString &line, LogLinePrefix &prefix);
+    static int scanBootStatus(const QString &line, int &msgBegin);
+    static QString bootStatusText(int status);
+    static int bootStatusFilter(const QString &statusFilter);
+    static qint64 localMSecs(const QDate &date, int hour, int minute, int second, int msecs = 0);
+    static qint64 parseIsoDateTime(const QString &date, const QString &time);
+    static qint64 parseSyslogDateTime(const QString &month, const QString &day, const QString &time, int year);
+
+    //dnf日志:日期+时间+等级+主要内容
+    QRegularExpression dnfLine;
+    //dmesg日志:<等级>[偏移时间]内容
+    QRegularExpression dmesgLine;
+
+private:
+    LogParseMatchers();
+    static int colorSequenceLength(const QChar *data, int length);
+};
+
+#endif // LOGPARSEMATCHERS_H
@@ -0,0 +1,141 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logperformanceprofile.h"
+#include "logworkscheduler.h"
+
+#include <QLoggingCategory>
+
+#ifdef QT_DEBUG
+Q_LOGGING_CATEGORY(logPerfProfile, "org.deepin.log.viewer.performance.profile")
+#else
+Q_LOGGING_CATEGORY(logPerfProfile, "org.deepin.log.viewer.performance.profile", QtInfoMsg)
+#endif
+
+//覆盖项的取值上限,防止写错的配置占满内存或线程
+#define LOG_PERFORMANCE_MAX_BATCH 100000
+#define LOG_PERFORMANCE_MAX_THREADS 256
+#define LOG_PERFORMANCE_MAX_MB (64 * 1024)
+
+namespace {
+
+/**
+ * @brief overrideInt 读取一个覆盖项,不是整数或超出范围时保持原值
+ */
+void overrideInt(const QVariantMap &overrides, const char *key, int minimum, int maximum, int &value)
+{
+    if (!overrides.contains(key))
+        return;
+    bool ok = false;
+    const int v = overrides.value(key).toInt(&ok);
+    if (!ok || v < minimum || v > maximum) {
+        qCWarning(logPerfProfile) << "ignore invalid performance override" << key << overrides.value(key);
+        return;
+    }
+    value = v;
+}
+
+} // namespace
+
+QStringList LogPerformanceProfile::presetNames()
+{
+    return QStringList() << "low-memory" << "balanced" << "throughput";
+}
+
+/**
+ * @brief LogPerformanceProfile::preset 预设档位
+ * @param name 档位名称
+ * @param ok 名称是否认识,不认识时返回balanced
+ */
+LogPerformanceProfile LogPerformanceProfile::preset(const QString &name, bool *ok)
+{
+    LogPerformanceProfile profile;
+    profile.name = LOG_PERFORMANCE_DEFAULT_PROFILE;
+    const bool known = presetNames().contains(name);
+    if (ok)
+        *ok = known;
+    if (!known)
+        return profile;
+
+    profile.name = name;
+    if (name == "low-memory") {
+        //批次小、缓存小,串行读取,峰值内存尽量低
+        profile.readBatchSize = 200;
+        profile.maxBatchSize = 1000;
+        profile.journalReadThreads = 1;
+        profile.searchThreads = 1;
+        profile.prefetchThreads = 1;
+        profile.exportThreads = 1;
+        profile.categoryCacheMB = 32;
+        profile.searchIndexMB = 32;
+    } else if (name == "throughput") {
+        //批次大、并发高,减少信号和线程切换的开销
+        profile.readBatchSize = 2000;
+        profile.maxBatchSize = 16000;
+        profile.searchThreads = 4;
+        profile.prefetchThreads = 2;
+        profile.exportThreads = 4;
+        profile.categoryCacheMB = 1024;
+        profile.searchIndexMB = 1024;
+    }
+    return profile;
+}
+
+/**
+ * @brief LogPerformanceProfile::fromConfig 按配置的档位和覆盖项得到参数
+ * @param name 档位名称,不认识时使用balanced
+ * @param overrides 覆盖项,键为字段名(readBatchSize、journalReadThreads等)
+ */
+LogPerformanceProfile LogPerformanceProfile::fromConfig(const QString &name, const QVariantMap &overrides)
+{
+    bool ok = false;
+    LogPerformanceProfile profile = preset(name, &ok);
+    if (!ok && !name.isEmpty())
+        qCWarning(logPerfProfile) << "unknown performance profile" << name << "use" << profile.name;
+
+    overrideInt(overrides, "readBatchSize", 1, LOG_PERFORMANCE_MAX_BATCH, profile.readBatchSize);
+    overrideInt(overrides, "maxBatchSize", 1, LOG_PERFORMANCE_MAX_BATCH, profile.maxBatchSize);
+    overrideInt(overrides, "journalReadThreads", 0, LOG_PERFORMANCE_MAX_THREADS, profile.journalReadThreads);
+    overrideInt(overrides, "searchThreads", 1, LOG_PERFORMANCE_MAX_THREADS, profile.searchThreads);
+    overrideInt(overrides, "prefetchThreads", 1, LOG_PERFORMANCE_MAX_THREADS, profile.prefetchThreads);
+    overrideInt(overrides, "exportThreads", 1, LOG_PERFORMANCE_MAX_THREADS, profile.exportThreads);
+    overrideInt(overrides, "categoryCacheMB", 0, LOG_PERFORMANCE_MAX_MB, profile.categoryCacheMB);
+    overrideInt(overrides, "searchIndexMB", 1, LOG_PERFORMANCE_MAX_MB, profile.searchIndexMB);
+    return profile;
+}
+
+LogPerformanceProfile &LogPerformanceProfile::storage()
+{
+    static LogPerformanceProfile profile = preset(LOG_PERFORMANCE_DEFAULT_PROFILE);
+    return profile;
+}
+
+const LogPerformanceProfile &LogPerformanceProfile::current()
+{
+    return storage();
+}
+
+/**
+ * @brief LogPerformanceProfile::setCurrent 设置当前参数,需在获取线程开始之前调用
+ */
+void LogPerformanceProfile::setCurrent(const LogPerformanceProfile &profile)
+{
+    storage() = profile;
+    qCInfo(logPerfProfile).noquote() << QString("performance profile=%1 batch=%2/%9 journalThreads=%3 search=%4 prefetch=%5 export=%6 cacheMB=%7 indexMB=%8")
+                                            .arg(profile.name).arg(profile.readBatchSize).arg(profile.journalReadThreads)
+                                            .arg(profile.searchThreads).arg(profile.prefetchThreads).arg(profile.exportThreads)
+                                            .arg(profile.categoryCacheMB).arg(profile.searchIndexMB).arg(profile.maxBatchSize);
+}
+
+/**
+ * @brief LogPerformanceProfile::applyToScheduler 按当前参数设置后台任务的并发数
+ */
+void LogPerformanceProfile::applyToScheduler()
+{
+    const LogPerformanceProfile &profile = current();
+    LogWorkScheduler *scheduler = LogWorkScheduler::instance();
+    scheduler->setMaxThreads(LogWorkScheduler::Search, profile.searchThreads);
+    scheduler->setMaxThreads(LogWorkScheduler::Prefetch, profile.prefetchThreads);
+    scheduler->setMaxThreads(LogWorkScheduler::Export, profile.exportThreads);
+}
@@ -0,0 +1,50 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGPERFORMANCEPROFILE_H
+#define LOGPERFORMANCEPROFILE_H
+
+#include <QString>
+#include <QStringList>
+#include <QVariantMap>
+
+//默认的性能档位
+#define LOG_PERFORMANCE_DEFAULT_PROFILE "balanced"
+
+/**
+ * @brief The LogPerformanceProfile struct 读取批大小、后台线程数和缓存上限等和机器配置相关的参数
+ * 预设low-memory(4GB内存的瘦客户机)、balanced(默认,和之前写死的值一致)、throughput(多核大内存的日志服务器)三档,
+ * 由dconfig的performanceProfile选择,performanceOverrides中的同名项覆盖单个参数。
+ * 在启动读取配置时设置一次,之后只读,各线程按值读取;修改配置后重新启动生效
+ */
+struct LogPerformanceProfile {
+    QString name;
+    //按固定条数分批的地方(跟踪新日志、重放缓存等)每批的条数
+    int readBatchSize = 500;
+    //获取线程按读取速度调整批次大小时每批的条数上限
+    int maxBatchSize = 4000;
+    //系统日志读取的并行线程数,0表示CPU核数
+    int journalReadThreads = 0;
+    //搜索、预取和导出后台任务的并发数
+    int searchThreads = 2;
+    int prefetchThreads = 1;
+    int exportThreads = 2;
+    //最近查看过的日志类别的缓存上限,MB,0表示不缓存
+    int categoryCacheMB = 256;
+    //搜索索引的内存上限,MB,每个类别单独计算
+    int searchIndexMB = 256;
+
+    static QStringList presetNames();
+    static LogPerformanceProfile preset(const QString &name, bool *ok = nullptr);
+    static LogPerformanceProfile fromConfig(const QString &name, const QVariantMap &overrides);
+
+    static const LogPerformanceProfile &current();
+    static void setCurrent(const LogPerformanceProfile &profile);
+    static void applyToScheduler();
+
+private:
+    static LogPerformanceProfile &storage();
+};
+
+#endif // LOGPERFORMANCEPROFILE_H
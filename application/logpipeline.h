@@ -0,0 +1,226 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGPIPELINE_H
+#define LOGPIPELINE_H
+
+#include "logcanceltoken.h"
+#include "logingestmetrics.h"
+
+#include <QList>
+#include <QMap>
+#include <QMutex>
+#include <QPair>
+#include <QQueue>
+#include <QThread>
+#include <QWaitCondition>
+
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <vector>
+
+//流水线解析的最大线程数,不包括读取线程
+#define LOG_PIPELINE_MAX_THREADS 4
+//已读取、还没有交付的块数上限,读取快于交付时读取线程阻塞
+#define LOG_PIPELINE_QUEUE 8
+//阻塞等待时定时醒来检查是否被停止,毫秒
+#define LOG_PIPELINE_WAIT_MSEC 50
+
+/**
+ * @brief The LogPipeline class 读取、解析、交付三段流水线
+ * 读取线程顺序读出块(如一批行),多个解析线程并行把块解析为记录,调用者线程按读取顺序交付;
+ * 在途的块数有上限,交付慢(如界面插入慢)时读取和解析随之阻塞,内存中最多缓存LOG_PIPELINE_QUEUE块
+ */
+template <typename Chunk, typename Record>
+class LogPipeline
+{
+public:
+    /**
+     * @brief Read 读取下一块,读到结尾或出错时返回false,只在读取线程中调用
+     */
+    typedef std::function<bool(Chunk &)> Read;
+    /**
+     * @brief Parse 把一块解析为记录,返回false时停止流水线,在多个解析线程中并发调用
+     */
+    typedef std::function<bool(const Chunk &, QList<Record> &)> Parse;
+    /**
+     * @brief Deliver 按读取顺序交付一块的记录,返回false时停止流水线,只在调用者线程中调用
+     */
+    typedef std::function<bool(QList<Record> &)> Deliver;
+
+    LogPipeline(const std::atomic_bool &canRun, int parseThreads, int capacity = LOG_PIPELINE_QUEUE)
+        : m_canRun(canRun)
+        , m_parseThreads(qBound(1, parseThreads, LOG_PIPELINE_MAX_THREADS))
+        , m_capacity(qMax(1, capacity))
+    {
+    }
+
+    static int idealThreadCount()
+    {
+        //留一个核给读取线程
+        return qBound(1, QThread::idealThreadCount() - 1, LOG_PIPELINE_MAX_THREADS);
+    }
+
+    /**
+     * @brief run 运行流水线直到读完、被停止或某一段返回false
+     * @return 是否全部读取并交付
+     */
+    bool run(const Read &read, const Parse &parse, const Deliver &deliver)
+    {
+        if (m_parseThreads <= 1)
+            return runSerial(read, parse, deliver);
+
+        m_stopped = false;
+        m_readFinished = false;
+        m_readCount = 0;
+        m_delivered = 0;
+        m_failed = false;
+        m_input.clear();
+        m_output.clear();
+
+        //读取和解析线程中的计数计入调用者所属的加载,读取线程中等待的总线调用随调用者取消
+        const LogIngestCountersPtr ingest = LogIngestMetrics::current();
+        const LogCancelToken cancel = LogCancelToken::current();
+        std::thread reader([this, &read, ingest, cancel]() {
+            LogIngestScope ingestScope(ingest);
+            LogCancelScope cancelScope(cancel);
+            readLoop(read);
+        });
+        std::vector<std::thread> parsers;
+        for (int i = 0; i < m_parseThreads; ++i) {
+            parsers.emplace_back([this, &parse, ingest, cancel]() {
+                LogIngestScope ingestScope(ingest);
+                LogCancelScope cancelScope(cancel);
+                parseLoop(parse);
+            });
+        }
+
+        bool completed = deliverLoop(deliver);
+        stop();
+        reader.join();
+        for (std::thread &parser : parsers)
+            parser.join();
+        return completed && !m_failed && m_canRun;
+    }
+
+private:
+    bool stopped() const { return m_stopped || !m_canRun; }
+
+    void stop()
+    {
+        QMutexLocker locker(&m_mutex);
+        m_stopped = true;
+        m_notFull.wakeAll();
+        m_hasInput.wakeAll();
+        m_hasOutput.wakeAll();
+    }
+
+    bool runSerial(const Read &read, const Parse &parse, const Deliver &deliver)
+    {
+        Chunk chunk;
+        QList<Record> records;
+        while (m_canRun && read(chunk)) {
+            records.clear();
+            if (!parse(chunk, records) || !m_canRun)
+                return false;
+            if (!records.isEmpty() && !deliver(records))
+                return false;
+        }
+        return m_canRun;
+    }
+
+    void readLoop(const Read &read)
+    {
+        for (;;) {
+            {
+                //在途的块数达到上限时等待交付
+                QMutexLocker locker(&m_mutex);
+                while (m_readCount - m_delivered >= m_capacity && !stopped())
+                    m_notFull.wait(&m_mutex, LOG_PIPELINE_WAIT_MSEC);
+                if (stopped())
+                    break;
+            }
+            Chunk chunk;
+            if (!read(chunk))
+                break;
+            QMutexLocker locker(&m_mutex);
+            m_input.enqueue(qMakePair(m_readCount++, chunk));
+            m_hasInput.wakeOne();
+        }
+        QMutexLocker locker(&m_mutex);
+        m_readFinished = true;
+        m_hasInput.wakeAll();
+        m_hasOutput.wakeAll();
+    }
+
+    void parseLoop(const Parse &parse)
+    {
+        for (;;) {
+            QPair<int, Chunk> item;
+            {
+                QMutexLocker locker(&m_mutex);
+                while (m_input.isEmpty() && !m_readFinished && !stopped())
+                    m_hasInput.wait(&m_mutex, LOG_PIPELINE_WAIT_MSEC);
+                if (m_input.isEmpty() || stopped())
+                    return;
+                item = m_input.dequeue();
+            }
+            QList<Record> records;
+            const bool ok = parse(item.second, records);
+            QMutexLocker locker(&m_mutex);
+            if (!ok) {
+                m_failed = true;
+                m_stopped = true;
+                m_hasOutput.wakeAll();
+                return;
+            }
+            m_output.insert(item.first, records);
+            m_hasOutput.wakeAll();
+        }
+    }
+
+    bool deliverLoop(const Deliver &deliver)
+    {
+        for (;;) {
+            QList<Record> records;
+            {
+                QMutexLocker locker(&m_mutex);
+                //等待下一个顺序号的块解析完成
+                while (!m_output.contains(m_delivered) && !stopped()
+                       && !(m_readFinished && m_delivered >= m_readCount))
+                    m_hasOutput.wait(&m_mutex, LOG_PIPELINE_WAIT_MSEC);
+                if (stopped())
+                    return false;
+                if (!m_output.contains(m_delivered))
+                    return true;
+                records = m_output.take(m_delivered);
+            }
+            //交付时不持有锁,解析和读取继续进行
+            if (!records.isEmpty() && !deliver(records))
+                return false;
+            QMutexLocker locker(&m_mutex);
+            ++m_delivered;
+            m_notFull.wakeOne();
+        }
+    }
+
+    const std::atomic_bool &m_canRun;
+    int m_parseThreads;
+    int m_capacity;
+
+    QMutex m_mutex;
+    QWaitCondition m_notFull;
+    QWaitCondition m_hasInput;
+    QWaitCondition m_hasOutput;
+    QQueue<QPair<int, Chunk>> m_input;
+    QMap<int, QList<Record>> m_output;
+    int m_readCount = 0;
+    int m_delivered = 0;
+    bool m_readFinished = false;
+    bool m_stopped = false;
+    bool m_failed = false;
+};
+
+#endif // LOGPIPELINE_H
@@ -0,0 +1,162 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logprefetcher.h"
+#include "logfileparser.h"
+#include "logsettings.h"
+
+#include <QLoggingCategory>
+#include <QThread>
+
+#include <stdlib.h>
+
+#ifdef QT_DEBUG
+Q_LOGGING_CATEGORY(logPrefetcher, "org.deepin.log.viewer.prefetcher")
+#else
+Q_LOGGING_CATEGORY(logPrefetcher, "org.deepin.log.viewer.prefetcher", QtInfoMsg)
+#endif
+
+namespace {
+//支持预取的类别和记录点击次数时使用的名称
+const QList<QPair<LOG_FLAG, QString>> PREFETCH_CATEGORIES {
+    {JOURNAL, "journal"},
+    {KERN, "kern"},
+    {BOOT, "boot"},
+    {XORG, "xorg"},
+    {DPKG, "dpkg"}
+};
+}
+
+/**
+ * @brief LogPrefetcher::LogPrefetcher 构造函数
+ * @param parser 界面使用的日志获取对象,预取结果存入它的类别缓存
+ * @param parent 父对象
+ */
+LogPrefetcher::LogPrefetcher(LogFileParser *parser, QObject *parent)
+    : QObject(parent)
+    , m_parser(parser)
+{
+    m_idleTimer.setSingleShot(true);
+    m_idleTimer.setInterval(LOG_PREFETCH_IDLE_MSEC);
+    connect(&m_idleTimer, &QTimer::timeout, this, &LogPrefetcher::onIdle);
+    connect(m_parser, &LogFileParser::prefetchFinished, this, &LogPrefetcher::runNext);
+    connect(m_parser, &LogFileParser::stopPrefetch, this, &LogPrefetcher::stop);
+
+    //任意类别的界面加载结束后重新开始空闲计时
+    connect(m_parser, &LogFileParser::dpkgFinished, this, &LogPrefetcher::schedule);
+    connect(m_parser, &LogFileParser::xlogFinished, this, &LogPrefetcher::schedule);
+    connect(m_parser, &LogFileParser::bootFinished, this, &LogPrefetcher::schedule);
+    connect(m_parser, &LogFileParser::kernFinished, this, &LogPrefetcher::schedule);
+    connect(m_parser, &LogFileParser::journalFinished, this, &LogPrefetcher::schedule);
+    connect(m_parser, &LogFileParser::journalBootFinished, this, &LogPrefetcher::schedule);
+    connect(m_parser, &LogFileParser::normalFinished, this, &LogPrefetcher::schedule);
+    connect(m_parser, &LogFileParser::kwinFinished, this, &LogPrefetcher::schedule);
+    connect(m_parser, &LogFileParser::appFinished, this, &LogPrefetcher::schedule);
+    connect(m_parser, &LogFileParser::coredumpFinished, this, &LogPrefetcher::schedule);
+    connect(m_parser, &LogFileParser::dnfFinished, this, &LogPrefetcher::schedule);
+    connect(m_parser, &LogFileParser::dmesgFinished, this, &LogPrefetcher::schedule);
+    connect(m_parser, &LogFileParser::OOCFinished, this, &LogPrefetcher::schedule);
+    connect(m_parser, &LogFileParser::auditFinished, this, &LogPrefetcher::schedule);
+}
+
+/**
+ * @brief LogPrefetcher::recordVisit 记录一次类别点击,不支持预取的类别不记录
+ */
+void LogPrefetcher::recordVisit(LOG_FLAG flag)
+{
+    const QString name = categoryName(flag);
+    if (!name.isEmpty())
+        LogSettings::instance()->addCategoryVisit(name);
+}
+
+/**
+ * @brief LogPrefetcher::setPaused 导出开始时暂停并停止正在进行的预取,结束后恢复调度
+ */
+void LogPrefetcher::setPaused(bool paused)
+{
+    m_paused = paused;
+    if (m_paused)
+        m_parser->cancelPrefetch();
+    else
+        schedule();
+}
+
+QString LogPrefetcher::categoryName(LOG_FLAG flag)
+{
+    for (const auto &category : PREFETCH_CATEGORIES) {
+        if (category.first == flag)
+            return category.second;
+    }
+    return QString();
+}
+
+LOG_FLAG LogPrefetcher::categoryFlag(const QString &name)
+{
+    for (const auto &category : PREFETCH_CATEGORIES) {
+        if (category.second == name)
+            return category.first;
+    }
+    return NONE;
+}
+
+/**
+ * @brief LogPrefetcher::isCpuIdle 按1分钟平均负载判断CPU是否空闲,读取失败时认为不空闲
+ */
+bool LogPrefetcher::isCpuIdle()
+{
+    double load = 0;
+    if (getloadavg(&load, 1) != 1)
+        return false;
+    return load < QThread::idealThreadCount() * LOG_PREFETCH_MAX_LOAD;
+}
+
+/**
+ * @brief LogPrefetcher::schedule 重新开始空闲计时,到时后开始新一轮预取
+ */
+void LogPrefetcher::schedule()
+{
+    if (m_paused)
+        return;
+    m_idleTimer.start();
+}
+
+void LogPrefetcher::onIdle()
+{
+    if (m_paused || m_parser->isPrefetching())
+        return;
+    m_queue.clear();
+    for (const QString &name : LogSettings::instance()->frequentCategories(LOG_PREFETCH_CATEGORIES)) {
+        const LOG_FLAG flag = categoryFlag(name);
+        if (flag != NONE)
+            m_queue.append(flag);
+    }
+    runNext();
+}
+
+/**
+ * @brief LogPrefetcher::runNext 预取队列中的下一个类别,已有缓存的类别跳过,CPU繁忙时等待下一次空闲
+ */
+void LogPrefetcher::runNext()
+{
+    while (!m_paused && !m_queue.isEmpty()) {
+        if (!isCpuIdle()) {
+            m_idleTimer.start();
+            return;
+        }
+        const LOG_FLAG flag = m_queue.takeFirst();
+        if (m_parser->prefetch(flag)) {
+            qCDebug(logPrefetcher) << "prefetch category:" << categoryName(flag);
+            return;
+        }
+    }
+}
+
+/**
+ * @brief LogPrefetcher::stop 界面加载开始,放弃本轮预取,加载结束后重新调度
+ */
+void LogPrefetcher::stop()
+{
+    m_idleTimer.stop();
+    m_queue.clear();
+}
@@ -0,0 +1,63 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGPREFETCHER_H
+#define LOGPREFETCHER_H
+
+#include "structdef.h"
+
+#include <QList>
+#include <QObject>
+#include <QTimer>
+
+//加载结束后空闲多久开始预取,毫秒
+#define LOG_PREFETCH_IDLE_MSEC 3000
+//最多预取的常用类别个数
+#define LOG_PREFETCH_CATEGORIES 3
+//每个CPU的1分钟平均负载低于该值时认为空闲
+#define LOG_PREFETCH_MAX_LOAD 0.5
+
+class LogFileParser;
+
+/**
+ * @brief The LogPrefetcher class 后台预取常用日志类别,预热LogFileParser的类别缓存
+ * 点击次数记录在LogSettings中;界面加载结束且CPU空闲一段时间后,依次预取点击最多的几个类别,
+ * 界面加载开始(LogFileParser::stopPrefetch)或导出时立即停止
+ */
+class LogPrefetcher : public QObject
+{
+    Q_OBJECT
+public:
+    explicit LogPrefetcher(LogFileParser *parser, QObject *parent = nullptr);
+
+    void recordVisit(LOG_FLAG flag);
+    void setPaused(bool paused);
+    bool isPaused() const { return m_paused; }
+
+    static QString categoryName(LOG_FLAG flag);
+    static LOG_FLAG categoryFlag(const QString &name);
+    static bool isCpuIdle();
+
+public slots:
+    void schedule();
+
+private slots:
+    void onIdle();
+    void runNext();
+    void stop();
+
+private:
+    LogFileParser *m_parser;
+    QTimer m_idleTimer;
+    /**
+     * @brief m_queue 本轮还未预取的类别
+     */
+    QList<LOG_FLAG> m_queue;
+    /**
+     * @brief m_paused 导出期间暂停,加载结束时也不再调度
+     */
+    bool m_paused = false;
+};
+
+#endif // LOGPREFETCHER_H
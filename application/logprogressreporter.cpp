@@ -0,0 +1,42 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logprogressreporter.h"
+
+LogProgressReporter::LogProgressReporter(const Notify &notify, int intervalMs)
+    : m_notify(notify)
+    , m_intervalMs(qMax(0, intervalMs))
+{
+}
+
+/**
+ * @brief LogProgressReporter::report 更新进度,第一次、完成时和每个间隔最多通知一次,被合并掉的中间值不再补发
+ * @param current 当前进度
+ * @param total 总数
+ */
+void LogProgressReporter::report(int current, int total)
+{
+    if (current == m_lastCurrent && total == m_lastTotal)
+        return;
+    const bool finished = current >= total;
+    if (m_reported && !finished && m_timer.isValid() && m_timer.elapsed() < m_intervalMs)
+        return;
+    m_reported = true;
+    m_lastCurrent = current;
+    m_lastTotal = total;
+    m_timer.start();
+    if (m_notify)
+        m_notify(current, total);
+}
+
+/**
+ * @brief LogProgressReporter::reset 开始新一轮进度,下一次report立即通知
+ */
+void LogProgressReporter::reset()
+{
+    m_reported = false;
+    m_lastCurrent = -1;
+    m_lastTotal = -1;
+    m_timer.invalidate();
+}
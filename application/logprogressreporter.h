@@ -0,0 +1,39 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGPROGRESSREPORTER_H
+#define LOGPROGRESSREPORTER_H
+
+#include <QElapsedTimer>
+
+#include <functional>
+
+//两次进度通知的最小间隔,约30Hz
+#define PROGRESS_REPORT_INTERVAL_MS 33
+
+/**
+ * @brief The LogProgressReporter class 合并高频的进度更新,按固定频率通知界面
+ * 导出循环每处理一条记录都会调用report,只有距上次通知超过间隔且进度有变化时才真正通知,
+ * 完成时总是通知;跨线程的进度信号因此不再随记录数增长,界面事件循环也不会被淹没
+ */
+class LogProgressReporter
+{
+public:
+    using Notify = std::function<void(int current, int total)>;
+
+    explicit LogProgressReporter(const Notify &notify, int intervalMs = PROGRESS_REPORT_INTERVAL_MS);
+
+    void report(int current, int total);
+    void reset();
+
+private:
+    Notify m_notify;
+    int m_intervalMs;
+    QElapsedTimer m_timer;
+    bool m_reported = false;
+    int m_lastCurrent = -1;
+    int m_lastTotal = -1;
+};
+
+#endif // LOGPROGRESSREPORTER_H
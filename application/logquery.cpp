@@ -0,0 +1,512 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logquery.h"
+#include "loglevel.h"
+#include "loglocaltime.h"
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QFileInfo>
+#include <QHash>
+
+namespace {
+
+struct FieldName {
+    const char *name;
+    LogQuery::Field field;
+};
+
+//字段名和别名
+const FieldName fieldNames[] = {
+    {"unit", LogQuery::FieldUnit},
+    {"ident", LogQuery::FieldIdent},
+    {"proc", LogQuery::FieldIdent},
+    {"app", LogQuery::FieldIdent},
+    {"daemon", LogQuery::FieldIdent},
+    {"host", LogQuery::FieldHost},
+    {"pid", LogQuery::FieldPid},
+    {"level", LogQuery::FieldLevel},
+    {"priority", LogQuery::FieldLevel},
+    {"prio", LogQuery::FieldLevel},
+    {"user", LogQuery::FieldUser},
+    {"hour", LogQuery::FieldHour}
+};
+
+//hour条件值的格式,本地时间
+const char *const hourFormat = "yyyy-MM-ddTHH";
+//一小时的毫秒数
+const qint64 hourMsecs = 3600 * 1000;
+
+//等级名称,下标即等级数字
+const char *const levelNames[] = {"emerg", "alert", "crit", "err", "warning", "notice", "info", "debug"};
+//等级的显示文本,和各解析线程中的翻译一致
+const char *const levelTexts[] = {"Emergency", "Alert", "Critical", "Error", "Warning", "Notice", "Info", "Debug"};
+
+/**
+ * @brief levelBits 满足比较条件的等级位掩码
+ */
+int levelBits(LogQuery::Op op, int level)
+{
+    int mask = 0;
+    for (int i = 0; i < 8; ++i) {
+        bool ok = false;
+        switch (op) {
+        case LogQuery::OpEqual:
+            ok = i == level;
+            break;
+        case LogQuery::OpNotEqual:
+            ok = i != level;
+            break;
+        case LogQuery::OpLess:
+            ok = i < level;
+            break;
+        case LogQuery::OpLessEqual:
+            ok = i <= level;
+            break;
+        case LogQuery::OpGreater:
+            ok = i > level;
+            break;
+        case LogQuery::OpGreaterEqual:
+            ok = i >= level;
+            break;
+        }
+        if (ok)
+            mask |= 1 << i;
+    }
+    return mask;
+}
+
+} // namespace
+
+/**
+ * @brief LogQuery::LogQuery 解析搜索框的输入
+ * @param text 搜索框的输入
+ */
+LogQuery::LogQuery(const QString &text)
+{
+    QStringList words;
+    QStringList phrases;
+    int pos = 0;
+    while (pos < text.length()) {
+        if (text.at(pos).isSpace()) {
+            ++pos;
+            continue;
+        }
+        if (text.at(pos) == QLatin1Char('"')) {
+            const QString phrase = readValue(text, pos);
+            if (!phrase.isEmpty())
+                phrases.append(phrase);
+            continue;
+        }
+        if (parseTerm(text, pos))
+            continue;
+        const int start = pos;
+        while (pos < text.length() && !text.at(pos).isSpace())
+            ++pos;
+        words.append(text.mid(start, pos - start));
+    }
+
+    if (m_terms.isEmpty()) {
+        m_texts.append(text);
+        return;
+    }
+    if (!words.isEmpty())
+        m_texts.append(words.join(' '));
+    m_texts.append(phrases);
+
+    //等于条件之间为或,比较和不等于条件之间为与
+    int equalMask = 0;
+    int compareMask = LOG_QUERY_ALL_LEVELS;
+    for (const Term &term : m_terms) {
+        if (term.field != FieldLevel)
+            continue;
+        m_hasLevel = true;
+        const int bits = levelBits(term.op, parseLevel(term.value));
+        if (term.op == OpEqual)
+            equalMask |= bits;
+        else
+            compareMask &= bits;
+    }
+    if (m_hasLevel)
+        m_levelMask = (equalMask ? equalMask : LOG_QUERY_ALL_LEVELS) & compareMask;
+}
+
+/**
+ * @brief LogQuery::parseTerm 在pos处解析一个字段条件,不是合法的字段条件时不移动pos,按普通词处理
+ */
+bool LogQuery::parseTerm(const QString &text, int &pos)
+{
+    int end = pos;
+    while (end < text.length() && text.at(end).isLetter())
+        ++end;
+    const QString name = text.mid(pos, end - pos).toLower();
+    Field field = FieldUnit;
+    bool known = false;
+    for (const FieldName &item : fieldNames) {
+        if (name == QLatin1String(item.name)) {
+            field = item.field;
+            known = true;
+            break;
+        }
+    }
+    if (!known)
+        return false;
+
+    const QStringRef rest = text.midRef(end, 2);
+    Op op = OpEqual;
+    if (rest.startsWith("<=")) {
+        op = OpLessEqual;
+    } else if (rest.startsWith(">=")) {
+        op = OpGreaterEqual;
+    } else if (rest.startsWith("!=")) {
+        op = OpNotEqual;
+    } else if (rest.startsWith('<')) {
+        op = OpLess;
+    } else if (rest.startsWith('>')) {
+        op = OpGreater;
+    } else if (!rest.startsWith(':') && !rest.startsWith('=')) {
+        return false;
+    }
+    //只有等级可以比较大小
+    if (field != FieldLevel && op != OpEqual && op != OpNotEqual)
+        return false;
+    int valuePos = end + (op == OpEqual || op == OpLess || op == OpGreater ? 1 : 2);
+    const QString value = readValue(text, valuePos);
+    if (value.isEmpty() || (field == FieldLevel && parseLevel(value) < 0))
+        return false;
+    const qint64 hourBegin = field == FieldHour ? parseHour(value) : -1;
+    if (field == FieldHour && hourBegin < 0)
+        return false;
+
+    m_terms.append({field, op, value, hourBegin});
+    pos = valuePos;
+    return true;
+}
+
+/**
+ * @brief LogQuery::readValue 读取一个值,引号中的值可以包含空白,\"表示引号
+ */
+QString LogQuery::readValue(const QString &text, int &pos)
+{
+    QString value;
+    if (pos < text.length() && text.at(pos) == QLatin1Char('"')) {
+        ++pos;
+        while (pos < text.length() && text.at(pos) != QLatin1Char('"')) {
+            if (text.at(pos) == QLatin1Char('\\') && pos + 1 < text.length())
+                ++pos;
+            value.append(text.at(pos));
+            ++pos;
+        }
+        //跳过结束的引号
+        if (pos < text.length())
+            ++pos;
+        return value;
+    }
+    const int start = pos;
+    while (pos < text.length() && !text.at(pos).isSpace())
+        ++pos;
+    return text.mid(start, pos - start);
+}
+
+/**
+ * @brief LogQuery::parseLevel 等级名称(不区分大小写,可以是常见别名或显示文本)或数字转换为0-7
+ * @return 等级,不认识时为-1
+ */
+int LogQuery::parseLevel(const QString &value)
+{
+    bool ok = false;
+    const int number = value.toInt(&ok);
+    if (ok)
+        return number >= 0 && number < 8 ? number : -1;
+    static const QHash<QString, int> aliases {
+        {"emergency", 0}, {"panic", 0}, {"critical", 2}, {"error", 3}, {"warn", 4}
+    };
+    const QString name = value.toLower();
+    for (int i = 0; i < 8; ++i) {
+        if (name == QLatin1String(levelNames[i]) || name == QString(levelTexts[i]).toLower())
+            return i;
+    }
+    const int alias = aliases.value(name, -1);
+    return alias >= 0 ? alias : levelPriority(value);
+}
+
+/**
+ * @brief LogQuery::parseHour hour条件的值(本地时间yyyy-MM-ddTHH)转换为该小时的起始时间
+ * @return 毫秒时间戳,格式不对时为-1
+ */
+qint64 LogQuery::parseHour(const QString &value)
+{
+    const QDateTime time = QDateTime::fromString(value, QLatin1String(hourFormat));
+    return time.isValid() ? time.toMSecsSinceEpoch() : -1;
+}
+
+/**
+ * @brief LogQuery::hourText 小时的起始时间转换为hour条件的值,和parseHour互逆
+ */
+QString LogQuery::hourText(qint64 hourBegin)
+{
+    //统计每小时的条数时每一项都会调用,按LogLocalTime格式化后换上分隔符
+    QString text = LogLocalTime::format(hourBegin).left(13);
+    text[10] = QLatin1Char('T');
+    return text;
+}
+
+/**
+ * @brief LogQuery::levelPriority 记录中等级的显示文本转换为等级数字
+ * @return 等级,不是等级文本时为-1
+ */
+int LogQuery::levelPriority(const QString &levelText)
+{
+    static const QHash<QString, int> priorities = []() -> QHash<QString, int> {
+        QHash<QString, int> hash;
+        for (int i = 0; i < 8; ++i) {
+            hash.insert(QCoreApplication::translate("Level", levelTexts[i]), i);
+            hash.insert(QString(levelTexts[i]), i);
+        }
+        return hash;
+    }();
+    return priorities.value(levelText, -1);
+}
+
+/**
+ * @brief LogQuery::journalMatches 字段条件转换为journalctl写法的匹配参数,追加在系统日志的筛选参数之后
+ * 同一字段的多个值在sd_journal中为或;unit同时匹配系统和用户单元,需要展开为"+"分隔的两项
+ * @return 匹配参数,没有可以下推的条件时为空
+ */
+QStringList LogQuery::journalMatches() const
+{
+    //每个字段的候选写法,各写法之间为或,一种写法内是同一journal字段的多个值
+    QList<QList<QStringList>> groups;
+    auto values = [this](Field field) -> QStringList {
+        QStringList list;
+        for (const Term &term : m_terms) {
+            if (term.field == field && term.op == OpEqual)
+                list.append(term.value);
+        }
+        return list;
+    };
+    auto matches = [](const char *name, const QStringList &list) -> QStringList {
+        QStringList result;
+        for (const QString &value : list)
+            result.append(QString("%1=%2").arg(QLatin1String(name), value));
+        return result;
+    };
+
+    QStringList units;
+    for (const QString &unit : values(FieldUnit))
+        units.append(unit.contains('.') ? unit : unit + ".service");
+    if (!units.isEmpty())
+        groups.append(QList<QStringList>() << matches("_SYSTEMD_UNIT", units) << matches("_SYSTEMD_USER_UNIT", units));
+    const QStringList idents = values(FieldIdent);
+    if (!idents.isEmpty())
+        groups.append(QList<QStringList>() << matches("SYSLOG_IDENTIFIER", idents));
+    const QStringList hosts = values(FieldHost);
+    if (!hosts.isEmpty())
+        groups.append(QList<QStringList>() << matches("_HOSTNAME", hosts));
+    const QStringList pids = values(FieldPid);
+    if (!pids.isEmpty())
+        groups.append(QList<QStringList>() << matches("_PID", pids));
+    if (m_hasLevel && m_levelMask != 0 && m_levelMask != LOG_QUERY_ALL_LEVELS) {
+        QStringList priorities;
+        for (int i = 0; i < 8; ++i) {
+            if (m_levelMask & (1 << i))
+                priorities.append(QString("PRIORITY=%1").arg(i));
+        }
+        groups.append(QList<QStringList>() << priorities);
+    }
+    if (groups.isEmpty())
+        return QStringList();
+
+    //展开为析取范式:从每个字段中各取一种写法组成一项
+    QList<QStringList> terms {QStringList()};
+    for (const QList<QStringList> &group : groups) {
+        QList<QStringList> next;
+        for (const QStringList &term : terms) {
+            for (const QStringList &choice : group)
+                next.append(term + choice);
+        }
+        terms = next;
+        if (terms.size() > LOG_QUERY_MAX_JOURNAL_TERMS)
+            return QStringList();
+    }
+    QStringList args;
+    for (const QStringList &term : terms) {
+        if (!args.isEmpty())
+            args.append("+");
+        args.append(term);
+    }
+    return args;
+}
+
+/**
+ * @brief LogQuery::matchesColumns 字段条件在内存中的判断
+ * @param columns 记录中可以判断的列
+ * @param pushedDown 已按journalMatches读取,能下推的条件跳过
+ */
+bool LogQuery::matchesColumns(const LogQueryColumns &columns, bool pushedDown) const
+{
+    static const Field fields[] = {FieldUnit, FieldIdent, FieldHost, FieldPid, FieldLevel, FieldUser, FieldHour};
+    for (Field field : fields) {
+        if (!matchField(field, columns, pushedDown))
+            return false;
+    }
+    return true;
+}
+
+bool LogQuery::matchField(Field field, const LogQueryColumns &columns, bool pushedDown) const
+{
+    if (field == FieldLevel) {
+        if (!m_hasLevel || (pushedDown && m_levelMask != 0))
+            return true;
+        return columns.level >= 0 && columns.level < LogLevel::SyslogCount && (m_levelMask & (1 << columns.level));
+    }
+    //小时条件:等于条件之间为或,不等于条件之间为与
+    if (field == FieldHour) {
+        bool hasEqual = false;
+        bool equal = false;
+        for (const Term &term : m_terms) {
+            if (term.field != FieldHour)
+                continue;
+            const bool same = columns.msecs >= term.hourBegin && columns.msecs < term.hourBegin + hourMsecs;
+            if (term.op == OpNotEqual) {
+                if (same)
+                    return false;
+            } else {
+                hasEqual = true;
+                equal = equal || same;
+            }
+        }
+        return !hasEqual || equal;
+    }
+
+    const QString *column = nullptr;
+    switch (field) {
+    case FieldUnit:
+    case FieldIdent:
+        column = columns.ident;
+        break;
+    case FieldHost:
+        column = columns.host;
+        break;
+    case FieldPid:
+        column = columns.pid;
+        break;
+    case FieldUser:
+        column = columns.user;
+        break;
+    default:
+        break;
+    }
+    bool hasEqual = false;
+    bool equal = false;
+    for (const Term &term : m_terms) {
+        if (term.field != field || (pushedDown && isPushedDown(term)))
+            continue;
+        if (!column)
+            return false;
+        const bool same = (field == FieldUnit || field == FieldIdent) ? sameIdent(term.value, *column)
+                                                                      : column->compare(term.value, Qt::CaseInsensitive) == 0;
+        if (term.op == OpNotEqual) {
+            if (same)
+                return false;
+        } else {
+            hasEqual = true;
+            equal = equal || same;
+        }
+    }
+    return !hasEqual || equal;
+}
+
+bool LogQuery::isPushedDown(const Term &term) const
+{
+    return term.op == OpEqual && term.field != FieldUser && term.field != FieldLevel && term.field != FieldHour;
+}
+
+/**
+ * @brief LogQuery::sameIdent 进程名列和条件值是否相同,忽略大小写、单元的.service后缀和可执行文件的目录
+ */
+bool LogQuery::sameIdent(const QString &value, const QString &column)
+{
+    QString name = value;
+    if (name.endsWith(".service"))
+        name.chop(8);
+    if (column.compare(name, Qt::CaseInsensitive) == 0 || column.compare(value, Qt::CaseInsensitive) == 0)
+        return true;
+    return column.contains('/') && QFileInfo(column).fileName().compare(name, Qt::CaseInsensitive) == 0;
+}
+
+/**
+ * @brief LogQuery::textMatchers 各关键字的匹配器,所有关键字都要匹配;没有关键字时为一个空关键字
+ */
+QVector<LogRecordFilter::TextMatcher> LogQuery::textMatchers(LogRecordFilter::TextMatcher::Mode mode) const
+{
+    QVector<LogRecordFilter::TextMatcher> matchers;
+    for (const QString &text : m_texts)
+        matchers.append(LogRecordFilter::TextMatcher(text, mode));
+    if (matchers.isEmpty())
+        matchers.append(LogRecordFilter::TextMatcher());
+    return matchers;
+}
+
+LogQueryColumns logQueryColumns(const LOG_MSG_JOURNAL &msg)
+{
+    LogQueryColumns columns;
+    columns.ident = &msg.daemonName;
+    columns.host = &msg.hostName;
+    columns.pid = &msg.daemonId;
+    columns.level = msg.level;
+    columns.msecs = msg.timestamp > 0 ? msg.timestamp / 1000 : -1;
+    return columns;
+}
+
+LogQueryColumns logQueryColumns(const LOG_MSG_APPLICATOIN &msg)
+{
+    LogQueryColumns columns;
+    columns.ident = &msg.src;
+    columns.level = msg.level;
+    columns.msecs = msg.timestamp > 0 ? msg.timestamp / 1000 : -1;
+    return columns;
+}
+
+LogQueryColumns logQueryColumns(const LOG_MSG_DNF &msg)
+{
+    LogQueryColumns columns;
+    //dnf等级按相近的syslog等级判断
+    if (msg.level >= TRACE && msg.level <= SUPERCRITICAL)
+        columns.level = LogLevel::dnfSyslog[msg.level - TRACE];
+    return columns;
+}
+
+LogQueryColumns logQueryColumns(const LOG_MSG_DMESG &msg)
+{
+    LogQueryColumns columns;
+    columns.level = msg.level;
+    return columns;
+}
+
+LogQueryColumns logQueryColumns(const LOG_MSG_NORMAL &msg)
+{
+    LogQueryColumns columns;
+    columns.user = &msg.userName;
+    return columns;
+}
+
+LogQueryColumns logQueryColumns(const LOG_MSG_AUDIT &msg)
+{
+    LogQueryColumns columns;
+    columns.ident = &msg.processName;
+    columns.pid = &msg.processId;
+    return columns;
+}
+
+LogQueryColumns logQueryColumns(const LOG_MSG_COREDUMP &msg)
+{
+    LogQueryColumns columns;
+    columns.ident = &msg.exe;
+    columns.pid = &msg.pid;
+    columns.level = msg.level;
+    columns.msecs = msg.timestamp > 0 ? msg.timestamp / 1000 : -1;
+    return columns;
+}
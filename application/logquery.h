@@ -0,0 +1,147 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGQUERY_H
+#define LOGQUERY_H
+
+#include "logrecordfilter.h"
+#include "structdef.h"
+
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include <functional>
+
+//所有等级(0-7)的位掩码
+#define LOG_QUERY_ALL_LEVELS 0xff
+//字段条件展开为journal析取项时最多的项数,超过时不下推,在内存中判断
+#define LOG_QUERY_MAX_JOURNAL_TERMS 16
+
+/**
+ * @brief The LogQueryColumns struct 一条记录中可以按字段条件判断的列,没有的列为空指针(等级为-1),
+ * 对没有该列的记录,该字段的条件总是不匹配
+ */
+struct LogQueryColumns {
+    //进程名、应用名或可执行文件,unit:和ident:都按这一列判断
+    const QString *ident = nullptr;
+    const QString *host = nullptr;
+    const QString *pid = nullptr;
+    //syslog数字等级,没有等级的记录为-1
+    int level = -1;
+    const QString *user = nullptr;
+    //记录时间(毫秒时间戳),没有时间的记录为-1
+    qint64 msecs = -1;
+};
+
+/**
+ * @brief The LogQuery class 搜索框的查询语法,如 unit:sshd level<=err host:foo "failed password"
+ * 字段条件:unit、ident(proc、app、daemon)、host、pid、user用":"或"="表示等于、"!="表示不等于,level(priority、prio)还可以用<、<=、>、>=比较,
+ * hour按本地时间的整点小时(如hour:2023-05-01T13)判断记录时间,不下推到journal;
+ * 等级可以写名称(emerg、alert、crit、err、warning、notice、info、debug)或数字,数字越小越严重;
+ * 同一字段的多个等于条件为或,不同字段为与。其余的词连成一个关键字,引号中的短语各自是一个关键字,所有关键字都要匹配。
+ * 没有字段条件时整个输入仍按原来的方式作为一个关键字,不改变普通搜索的行为。
+ * 系统日志的字段条件转换为journalctl写法的匹配参数(journalMatches),读取时由sd_journal筛选;
+ * 文件来源的日志先按LogQueryColumns中的列判断字段条件,通过后才做全文匹配
+ */
+class LogQuery
+{
+public:
+    enum Field {
+        FieldUnit,
+        FieldIdent,
+        FieldHost,
+        FieldPid,
+        FieldLevel,
+        FieldUser,
+        FieldHour
+    };
+    enum Op {
+        OpEqual,
+        OpNotEqual,
+        OpLess,
+        OpLessEqual,
+        OpGreater,
+        OpGreaterEqual
+    };
+    struct Term {
+        Field field;
+        Op op;
+        QString value;
+        //hour条件对应小时的起始时间(毫秒时间戳),其他字段为-1
+        qint64 hourBegin = -1;
+    };
+
+    explicit LogQuery(const QString &text = QString());
+
+    bool isStructured() const { return !m_terms.isEmpty(); }
+    QList<Term> terms() const { return m_terms; }
+    QStringList texts() const { return m_texts; }
+    int levelMask() const { return m_levelMask; }
+
+    QStringList journalMatches() const;
+    bool matchesColumns(const LogQueryColumns &columns, bool pushedDown = false) const;
+    QVector<LogRecordFilter::TextMatcher> textMatchers(LogRecordFilter::TextMatcher::Mode mode) const;
+    template <typename T>
+    std::function<bool(const T &)> predicate(const std::function<bool(const LogRecordFilter::TextMatcher &, const T &)> &textMatch,
+                                             LogRecordFilter::TextMatcher::Mode mode, bool pushedDown = false) const;
+
+    static int parseLevel(const QString &value);
+    static int levelPriority(const QString &levelText);
+    static qint64 parseHour(const QString &value);
+    static QString hourText(qint64 hourBegin);
+
+private:
+    bool parseTerm(const QString &text, int &pos);
+    static QString readValue(const QString &text, int &pos);
+    bool isPushedDown(const Term &term) const;
+    bool matchField(Field field, const LogQueryColumns &columns, bool pushedDown) const;
+    static bool sameIdent(const QString &value, const QString &column);
+
+    QList<Term> m_terms;
+    QStringList m_texts;
+    //等级条件允许的等级,第n位对应等级n
+    int m_levelMask = LOG_QUERY_ALL_LEVELS;
+    bool m_hasLevel = false;
+};
+
+template <typename T>
+LogQueryColumns logQueryColumns(const T &)
+{
+    return LogQueryColumns();
+}
+LogQueryColumns logQueryColumns(const LOG_MSG_JOURNAL &msg);
+LogQueryColumns logQueryColumns(const LOG_MSG_APPLICATOIN &msg);
+LogQueryColumns logQueryColumns(const LOG_MSG_DNF &msg);
+LogQueryColumns logQueryColumns(const LOG_MSG_DMESG &msg);
+LogQueryColumns logQueryColumns(const LOG_MSG_NORMAL &msg);
+LogQueryColumns logQueryColumns(const LOG_MSG_AUDIT &msg);
+LogQueryColumns logQueryColumns(const LOG_MSG_COREDUMP &msg);
+
+/**
+ * @brief LogQuery::predicate 组合字段条件和关键字的判断函数,先判断字段条件,通过后才做全文匹配
+ * @param textMatch 单个关键字对一条记录的匹配规则,如LogRecordFilter::matchKern;
+ * 没有关键字时仍以空关键字调用一次,等级、状态等其他筛选条件照常生效
+ * @param mode 关键字按普通文本还是正则表达式匹配
+ * @param pushedDown 记录是按journalMatches读取的,已下推的字段条件不再判断
+ */
+template <typename T>
+std::function<bool(const T &)> LogQuery::predicate(const std::function<bool(const LogRecordFilter::TextMatcher &, const T &)> &textMatch,
+                                                   LogRecordFilter::TextMatcher::Mode mode, bool pushedDown) const
+{
+    const LogQuery query = *this;
+    const QVector<LogRecordFilter::TextMatcher> matchers = textMatchers(mode);
+    return [query, matchers, textMatch, pushedDown](const T &msg) {
+        if (query.isStructured() && !query.matchesColumns(logQueryColumns(msg), pushedDown))
+            return false;
+        for (const LogRecordFilter::TextMatcher &matcher : matchers) {
+            if (!textMatch(matcher, msg))
+                return false;
+        }
+        return true;
+    };
+}
+
+#endif // LOGQUERY_H
@@ -0,0 +1,99 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logrecordbatch.h"
+
+/**
+ * @brief LogRecordBatch::columnCountOf 格式对应的列数
+ * @param format 记录格式
+ * @return 列数,不认识的格式为0
+ */
+int LogRecordBatch::columnCountOf(int format)
+{
+    switch (format) {
+    case KernFormat:
+        return 5;
+    case DpkgFormat:
+        return 3;
+    default:
+        return 0;
+    }
+}
+
+/**
+ * @brief LogRecordBatch::reset 清空记录并设置格式
+ * @param recordFormat 记录格式
+ */
+void LogRecordBatch::reset(int recordFormat)
+{
+    version = LOG_RECORD_BATCH_VERSION;
+    format = recordFormat;
+    columnCount = columnCountOf(recordFormat);
+    timestamps.clear();
+    levels.clear();
+    offsets.clear();
+    blob.clear();
+}
+
+/**
+ * @brief LogRecordBatch::append 追加一条记录
+ * @param time 时间(毫秒)
+ * @param level 等级
+ * @param columns 各列文本,个数必须和columnCount一致,多余的忽略、不足的补空
+ */
+void LogRecordBatch::append(qint64 time, qint32 level, const QStringList &columns)
+{
+    if (offsets.isEmpty())
+        offsets.append(0);
+    timestamps.append(time);
+    levels.append(level);
+    for (int c = 0; c < columnCount; ++c) {
+        if (c < columns.size())
+            blob.append(columns.at(c).toUtf8());
+        offsets.append(blob.size());
+    }
+}
+
+/**
+ * @brief LogRecordBatch::isValid 版本和各数组长度是否一致,不一致的批次不能按列读取
+ */
+bool LogRecordBatch::isValid() const
+{
+    if (version != LOG_RECORD_BATCH_VERSION || columnCount != columnCountOf(format) || levels.size() != timestamps.size())
+        return false;
+    if (timestamps.isEmpty())
+        return offsets.size() <= 1;
+    if (offsets.size() != timestamps.size() * columnCount + 1)
+        return false;
+    for (int i = 1; i < offsets.size(); ++i) {
+        if (offsets.at(i) < offsets.at(i - 1))
+            return false;
+    }
+    return offsets.first() == 0 && offsets.last() == blob.size();
+}
+
+QString LogRecordBatch::column(int record, int column) const
+{
+    const int index = record * columnCount + column;
+    if (record < 0 || column < 0 || column >= columnCount || index + 1 >= offsets.size())
+        return QString();
+    return QString::fromUtf8(blob.constData() + offsets.at(index), offsets.at(index + 1) - offsets.at(index));
+}
+
+QDBusArgument &operator<<(QDBusArgument &argument, const LogRecordBatch &batch)
+{
+    argument.beginStructure();
+    argument << batch.version << batch.format << batch.columnCount
+             << batch.timestamps << batch.levels << batch.offsets << batch.blob;
+    argument.endStructure();
+    return argument;
+}
+
+const QDBusArgument &operator>>(const QDBusArgument &argument, LogRecordBatch &batch)
+{
+    argument.beginStructure();
+    argument >> batch.version >> batch.format >> batch.columnCount >> batch.timestamps >> batch.levels >> batch.offsets >> batch.blob;
+    argument.endStructure();
+    return argument;
+}
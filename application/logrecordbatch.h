@@ -0,0 +1,57 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGRECORDBATCH_H
+#define LOGRECORDBATCH_H
+
+#include <QByteArray>
+#include <QDBusArgument>
+#include <QMetaType>
+#include <QStringList>
+#include <QVector>
+
+//批量记录格式的版本,字段布局变化时递增,版本不一致的批次不解析
+#define LOG_RECORD_BATCH_VERSION 1
+
+/**
+ * @brief The LogRecordBatch struct 服务端解析好的一批定长列记录,DBus签名为(uiiaxaiaiay)
+ * 所有列的文本UTF-8编码后依次存放在一个blob中,offsets记录每一列的起始位置,
+ * 客户端按列取出即可填入记录结构,不需要再对原始行分词
+ */
+struct LogRecordBatch {
+    /**
+     * @brief The Format enum 记录格式,决定列数和每一列的含义,见LogRecordParser
+     */
+    enum Format {
+        InvalidFormat = 0,
+        KernFormat = 1, //列:时间文本,主机名,进程名,进程id,信息
+        DpkgFormat = 2  //列:时间文本,动作,信息
+    };
+
+    quint32 version = LOG_RECORD_BATCH_VERSION;
+    qint32 format = InvalidFormat;
+    qint32 columnCount = 0;
+    //每条记录的时间(毫秒),取不到为-1
+    QVector<qint64> timestamps;
+    //每条记录的等级,没有等级的格式为-1
+    QVector<qint32> levels;
+    //第i条记录第c列在blob中的范围为[offsets[i*columnCount+c], offsets[i*columnCount+c+1])
+    QVector<qint32> offsets;
+    QByteArray blob;
+
+    static int columnCountOf(int format);
+
+    void reset(int recordFormat);
+    void append(qint64 time, qint32 level, const QStringList &columns);
+    bool isValid() const;
+    int size() const { return timestamps.size(); }
+    QString column(int record, int column) const;
+};
+
+Q_DECLARE_METATYPE(LogRecordBatch)
+
+QDBusArgument &operator<<(QDBusArgument &argument, const LogRecordBatch &batch);
+const QDBusArgument &operator>>(const QDBusArgument &argument, LogRecordBatch &batch);
+
+#endif // LOGRECORDBATCH_H
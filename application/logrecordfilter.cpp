@@ -0,0 +1,196 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logrecordfilter.h"
+#include "journalreader.h"
+#include "loglevel.h"
+
+//每段至少这么多条记录,更少时分段和线程调度的开销超过收益
+#define FILTER_MIN_CHUNK_SIZE 4096
+
+LogRecordFilter::TextMatcher::TextMatcher(const QString &pattern, Mode mode)
+    : m_matcher(mode == Keyword ? pattern : QString())
+    , m_regex(mode == Regex && !pattern.isEmpty() ? std::make_shared<const LogRegex>(pattern) : nullptr)
+{
+}
+
+bool LogRecordFilter::TextMatcher::isEmpty() const
+{
+    return !m_regex && m_matcher.pattern().isEmpty();
+}
+
+/**
+ * @brief LogRecordFilter::TextMatcher::isValid 正则模式下表达式是否有语法错误,无效的表达式不匹配任何文本
+ */
+bool LogRecordFilter::TextMatcher::isValid() const
+{
+    return !m_regex || m_regex->isValid();
+}
+
+QString LogRecordFilter::TextMatcher::errorString() const
+{
+    return m_regex ? m_regex->errorString() : QString();
+}
+
+/**
+ * @brief LogRecordFilter::TextMatcher::matches 文本中是否包含关键字,和QString::contains(Qt::CaseInsensitive)一致
+ */
+bool LogRecordFilter::TextMatcher::matches(const QString &text) const
+{
+    if (m_regex)
+        return m_regex->matches(text);
+    return isEmpty() || m_matcher.indexIn(text) >= 0;
+}
+
+/**
+ * @brief LogRecordFilter::TextMatcher::indexIn 从from开始第一次出现关键字的位置,没有时为-1
+ * @param length 输出参数,命中的长度,正则模式下每处命中的长度不同,可能为0
+ */
+int LogRecordFilter::TextMatcher::indexIn(const QString &text, int from, int *length) const
+{
+    if (m_regex)
+        return m_regex->indexIn(text, from, length);
+    if (length)
+        *length = m_matcher.length();
+    return m_matcher.indexIn(text, from);
+}
+
+/**
+ * @brief LogRecordFilter::TextMatcher::length 关键字的长度,正则模式下为-1,命中长度由indexIn给出
+ */
+int LogRecordFilter::TextMatcher::length() const
+{
+    return m_regex ? -1 : m_matcher.pattern().length();
+}
+
+/**
+ * @brief LogRecordFilter::TextMatcher::literals 每处命中都包含的字面量,用于索引预筛选;为空时不能预筛选
+ */
+QStringList LogRecordFilter::TextMatcher::literals() const
+{
+    if (m_regex)
+        return m_regex->literals();
+    return isEmpty() ? QStringList() : QStringList(m_matcher.pattern());
+}
+
+/**
+ * @brief LogRecordFilter::chunkCount 按记录数和CPU核数决定分段数
+ * @param size 记录数
+ * @return 分段数,为1时在调用线程中直接筛选
+ */
+int LogRecordFilter::chunkCount(int size)
+{
+    return qBound(1, size / FILTER_MIN_CHUNK_SIZE, qMax(1, QThread::idealThreadCount()));
+}
+
+/**
+ * @brief LogRecordFilter::matchBoot 启动日志
+ * @param statusFilter BOOT_STATUS的值,-1为不筛选,见LogParseMatchers::bootStatusFilter
+ */
+bool LogRecordFilter::matchBoot(int statusFilter, const TextMatcher &text, const LOG_MSG_BOOT &msg)
+{
+    if (statusFilter >= 0 && msg.statusCode != statusFilter)
+        return false;
+    return text.matches(msg.status) || text.matches(msg.msg);
+}
+
+/**
+ * @brief LogRecordFilter::matchNormal 开关机日志
+ * @param eventTypeFilter 0全部 1登陆 2开机 3关机,其他值都不匹配
+ */
+bool LogRecordFilter::matchNormal(int eventTypeFilter, const TextMatcher &text, const LOG_MSG_NORMAL &msg)
+{
+    if (!text.matches(msg.eventType) && !text.matches(msg.userName) && !text.matches(msg.dateTime) && !text.matches(msg.msg))
+        return false;
+    switch (eventTypeFilter) {
+    case 0:
+        return true;
+    case 1:
+        return msg.eventType.compare("Boot", Qt::CaseInsensitive) != 0 && msg.eventType.compare("shutdown", Qt::CaseInsensitive) != 0
+               && msg.eventType.compare("runlevel", Qt::CaseInsensitive) != 0;
+    case 2:
+        return msg.eventType.compare("Boot", Qt::CaseInsensitive) == 0;
+    case 3:
+        return msg.eventType.compare("shutdown", Qt::CaseInsensitive) == 0;
+    default:
+        return false;
+    }
+}
+
+bool LogRecordFilter::matchDpkg(const TextMatcher &text, const LOG_MSG_DPKG &msg)
+{
+    return text.matches(msg.dateTime) || text.matches(msg.msg);
+}
+
+bool LogRecordFilter::matchKern(const TextMatcher &text, const LOG_MSG_JOURNAL &msg)
+{
+    return text.matches(msg.dateTime) || text.matches(msg.hostName) || text.matches(msg.daemonName) || text.matches(msg.msg);
+}
+
+bool LogRecordFilter::matchXorg(const TextMatcher &text, const LOG_MSG_XORG &msg)
+{
+    return text.matches(msg.offset) || text.matches(msg.msg);
+}
+
+bool LogRecordFilter::matchKwin(const TextMatcher &text, const LOG_MSG_KWIN &msg)
+{
+    return text.matches(msg.msg);
+}
+
+bool LogRecordFilter::matchApp(const TextMatcher &text, const LOG_MSG_APPLICATOIN &msg)
+{
+    return text.matches(msg.dateTime) || text.matches(LogLevel::text(msg.level)) || text.matches(msg.src) || text.matches(msg.msg);
+}
+
+/**
+ * @brief LogRecordFilter::matchJournal 系统日志,被截断的信息在前缀中没有匹配时才读取完整内容
+ * @param resolver 读取完整信息,只能在一个线程中使用
+ */
+bool LogRecordFilter::matchJournal(const TextMatcher &text, const LOG_MSG_JOURNAL &msg, JournalMessageResolver &resolver)
+{
+    if (text.matches(msg.dateTime) || text.matches(msg.hostName) || text.matches(msg.daemonName) || text.matches(msg.daemonId)
+            || text.matches(LogLevel::text(msg.level)) || text.matches(msg.msg))
+        return true;
+    return !msg.cursor.isEmpty() && text.matches(resolver.message(msg.cursor));
+}
+
+bool LogRecordFilter::matchJournalBoot(const TextMatcher &text, const LOG_MSG_JOURNAL &msg)
+{
+    return text.matches(msg.dateTime) || text.matches(msg.hostName) || text.matches(msg.daemonName) || text.matches(msg.daemonId)
+           || text.matches(LogLevel::text(msg.level)) || text.matches(msg.msg);
+}
+
+bool LogRecordFilter::matchDnf(const TextMatcher &text, const LOG_MSG_DNF &msg)
+{
+    return text.matches(msg.dateTime) || text.matches(msg.msg) || text.matches(LogLevel::dnfText(msg.level));
+}
+
+bool LogRecordFilter::matchDmesg(const TextMatcher &text, const LOG_MSG_DMESG &msg)
+{
+    return text.matches(msg.dateTime) || text.matches(msg.msg);
+}
+
+bool LogRecordFilter::matchOOC(const TextMatcher &text, const LOG_FILE_OTHERORCUSTOM &msg)
+{
+    return text.matches(msg.name) || text.matches(msg.path);
+}
+
+/**
+ * @brief LogRecordFilter::matchAudit 审计日志,关键字的匹配范围和LOG_MSG_AUDIT::contains一致
+ * @param auditTypeFilter 0全部,其他为审计类型加1
+ */
+bool LogRecordFilter::matchAudit(int auditTypeFilter, const TextMatcher &text, const LOG_MSG_AUDIT &msg)
+{
+    if (!text.matches(msg.auditType) && !text.matches(msg.eventType) && !text.matches(msg.dateTime)
+            && !text.matches(msg.processName) && !text.matches(msg.status) && !text.matches(msg.message()))
+        return false;
+    const int nAuditType = auditTypeFilter - 1;
+    return nAuditType == -1 || msg.filterAuditType(nAuditType);
+}
+
+bool LogRecordFilter::matchCoredump(const TextMatcher &text, const LOG_MSG_COREDUMP &msg)
+{
+    return text.matches(msg.sig) || text.matches(msg.dateTime) || text.matches(msg.coreFile) || text.matches(msg.uid)
+           || text.matches(msg.exe);
+}
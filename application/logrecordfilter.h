@@ -0,0 +1,189 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGRECORDFILTER_H
+#define LOGRECORDFILTER_H
+
+#include "logcasematcher.h"
+#include "logregex.h"
+#include "logrecordview.h"
+#include "structdef.h"
+
+#include <QList>
+#include <QString>
+#include <QStringMatcher>
+#include <QThread>
+#include <QVector>
+#include <QtConcurrent>
+
+#include <memory>
+
+class JournalMessageResolver;
+
+/**
+ * @brief The LogRecordFilter class 各类日志记录的筛选规则和多线程筛选,界面、命令行和插件共用
+ * 记录较多时把列表分段交给全局线程池并行判断,各段结果按原顺序拼接;判断时直接引用列表中的记录,不复制,
+ * 对LogRecordView筛选时结果是同一存储上的下标视图
+ */
+class LogRecordFilter
+{
+public:
+    /**
+     * @brief The TextMatcher class 预先编译好的关键字,不区分大小写,关键字为空时总是匹配
+     * 关键字的大小写形式只在构造时处理一次,每行每列的查找由LogCaseMatcher向量化;只读使用,可以在多个线程间共享
+     * 正则模式下关键字编译为LogRegex,各拷贝共享同一份编译结果
+     */
+    class TextMatcher
+    {
+    public:
+        enum Mode {
+            Keyword,
+            Regex
+        };
+
+        explicit TextMatcher(const QString &pattern = QString(), Mode mode = Keyword);
+
+        bool isEmpty() const;
+        bool isValid() const;
+        QString errorString() const;
+        bool matches(const QString &text) const;
+        int indexIn(const QString &text, int from = 0, int *length = nullptr) const;
+        int length() const;
+        QStringList literals() const;
+
+    private:
+        LogCaseMatcher m_matcher;
+        std::shared_ptr<const LogRegex> m_regex;
+    };
+
+    template <typename T, typename Predicate>
+    static QList<T> filter(const QList<T> &list, const Predicate &predicate);
+    template <typename T, typename MakePredicate>
+    static QList<T> filterWith(const QList<T> &list, const MakePredicate &makePredicate);
+    template <typename T, typename Predicate>
+    static LogRecordView<T> filter(const LogRecordView<T> &view, const Predicate &predicate);
+    template <typename T, typename MakePredicate>
+    static LogRecordView<T> filterWith(const LogRecordView<T> &view, const MakePredicate &makePredicate);
+
+    static bool matchBoot(int statusFilter, const TextMatcher &text, const LOG_MSG_BOOT &msg);
+    static bool matchNormal(int eventTypeFilter, const TextMatcher &text, const LOG_MSG_NORMAL &msg);
+    static bool matchDpkg(const TextMatcher &text, const LOG_MSG_DPKG &msg);
+    static bool matchKern(const TextMatcher &text, const LOG_MSG_JOURNAL &msg);
+    static bool matchXorg(const TextMatcher &text, const LOG_MSG_XORG &msg);
+    static bool matchKwin(const TextMatcher &text, const LOG_MSG_KWIN &msg);
+    static bool matchApp(const TextMatcher &text, const LOG_MSG_APPLICATOIN &msg);
+    static bool matchJournal(const TextMatcher &text, const LOG_MSG_JOURNAL &msg, JournalMessageResolver &resolver);
+    static bool matchJournalBoot(const TextMatcher &text, const LOG_MSG_JOURNAL &msg);
+    static bool matchDnf(const TextMatcher &text, const LOG_MSG_DNF &msg);
+    static bool matchDmesg(const TextMatcher &text, const LOG_MSG_DMESG &msg);
+    static bool matchOOC(const TextMatcher &text, const LOG_FILE_OTHERORCUSTOM &msg);
+    static bool matchAudit(int auditTypeFilter, const TextMatcher &text, const LOG_MSG_AUDIT &msg);
+    static bool matchCoredump(const TextMatcher &text, const LOG_MSG_COREDUMP &msg);
+
+    static int chunkCount(int size);
+
+private:
+    template <typename Result, typename FilterRange>
+    static Result filterChunks(int size, const FilterRange &filterRange);
+};
+
+/**
+ * @brief LogRecordFilter::filter 筛选出predicate返回true的记录,保持原有顺序
+ * @param list 记录
+ * @param predicate 判断函数,各段使用各自的拷贝,必须只依赖按值捕获的数据
+ * @return 匹配的记录
+ */
+template <typename T, typename Predicate>
+QList<T> LogRecordFilter::filter(const QList<T> &list, const Predicate &predicate)
+{
+    return filterWith(list, [&predicate]() {
+        return predicate;
+    });
+}
+
+/**
+ * @brief LogRecordFilter::filterWith 同filter,每段先调用makePredicate生成自己的判断函数,
+ * 用于判断时需要各自状态的场景,如读取完整信息的journal句柄
+ * @param list 记录
+ * @param makePredicate 生成判断函数,在工作线程中调用
+ * @return 匹配的记录
+ */
+template <typename T, typename MakePredicate>
+QList<T> LogRecordFilter::filterWith(const QList<T> &list, const MakePredicate &makePredicate)
+{
+    return filterChunks<QList<T>>(list.size(), [&list, &makePredicate](int begin, int end) {
+        auto predicate = makePredicate();
+        QList<T> rsList;
+        for (int i = begin; i < end; ++i) {
+            const T &msg = list.at(i);
+            if (predicate(msg))
+                rsList.append(msg);
+        }
+        return rsList;
+    });
+}
+
+/**
+ * @brief LogRecordFilter::filter 同filter,只记录匹配记录的下标,不复制记录
+ * @param view 记录视图
+ * @param predicate 判断函数
+ * @return 和view同一存储的视图
+ */
+template <typename T, typename Predicate>
+LogRecordView<T> LogRecordFilter::filter(const LogRecordView<T> &view, const Predicate &predicate)
+{
+    return filterWith(view, [&predicate]() {
+        return predicate;
+    });
+}
+
+template <typename T, typename MakePredicate>
+LogRecordView<T> LogRecordFilter::filterWith(const LogRecordView<T> &view, const MakePredicate &makePredicate)
+{
+    return view.withRows(filterChunks<QVector<quint32>>(view.size(), [&view, &makePredicate](int begin, int end) {
+        auto predicate = makePredicate();
+        QVector<quint32> rows;
+        for (int i = begin; i < end; ++i) {
+            if (predicate(view.at(i)))
+                rows.append(view.row(i));
+        }
+        return rows;
+    }));
+}
+
+/**
+ * @brief LogRecordFilter::filterChunks 把[0, size)分段并行调用filterRange,各段结果按顺序拼接
+ * @param size 记录数
+ * @param filterRange 筛选[begin, end)范围的记录,返回QList或QVector
+ */
+template <typename Result, typename FilterRange>
+Result LogRecordFilter::filterChunks(int size, const FilterRange &filterRange)
+{
+    const int count = chunkCount(size);
+    if (count <= 1)
+        return filterRange(0, size);
+
+    const int chunkSize = (size + count - 1) / count;
+    QVector<Result> results(count);
+    Result *out = results.data();
+    QVector<int> chunks(count);
+    for (int i = 0; i < count; ++i)
+        chunks[i] = i;
+    //调用线程也参与执行,在线程池的工作线程中调用也不会互相等待
+    QtConcurrent::blockingMap(chunks, [size, &filterRange, out, chunkSize](const int &chunk) {
+        const int begin = chunk * chunkSize;
+        out[chunk] = filterRange(begin, qMin(size, begin + chunkSize));
+    });
+
+    int total = 0;
+    for (const Result &result : results)
+        total += result.size();
+    Result rsList;
+    rsList.reserve(total);
+    for (const Result &result : results)
+        rsList += result;
+    return rsList;
+}
+
+#endif // LOGRECORDFILTER_H
@@ -0,0 +1,53 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logrecordformatter.h"
+#include "logdocxwriter.h"
+#include "loglocaltime.h"
+#include "logxlsxwriter.h"
+
+#include <DApplication>
+
+#include <QDateTime>
+
+DWIDGET_USE_NAMESPACE
+
+/**
+ * @brief LogRecordFormatter::LogRecordFormatter 初始化空值的显示文字,翻译并编码各等级的显示文字
+ */
+LogRecordFormatter::LogRecordFormatter()
+    : m_nullStr(DApplication::translate("Table", "Null"))
+{
+    m_levelCells.reserve(LogLevel::SyslogCount);
+    for (int level = 0; level < LogLevel::SyslogCount; ++level)
+        m_levelCells.append(makeCodeCell(LogLevel::text(level)));
+    m_dnfCells.reserve(LogLevel::DnfCount);
+    for (int level = TRACE; level <= SUPERCRITICAL; ++level)
+        m_dnfCells.append(makeCodeCell(LogLevel::dnfText(level)));
+}
+
+/**
+ * @brief LogRecordFormatter::makeCodeCell 生成一个显示文字在各导出格式中的形式,和逐行转义、转码的结果一致
+ */
+LogRecordFormatter::CodeCell LogRecordFormatter::makeCodeCell(const QString &text)
+{
+    CodeCell cell;
+    cell.text = text;
+    LogExportWriter::appendHtmlEscaped(cell.html, text);
+    LogXlsxWriter::appendUtf8(cell.utf8, text);
+    LogDocxWriter::appendEscaped(cell.xml, text);
+    return cell;
+}
+
+/**
+ * @brief LogRecordFormatter::parseTimestamp 没有保存时间戳的记录按显示的时间换算为微秒时间戳,无法识别时返回0
+ */
+qint64 LogRecordFormatter::parseTimestamp(const QString &dateTime)
+{
+    const qint64 msecs = LogLocalTime::parse(dateTime);
+    if (msecs >= 0)
+        return msecs * 1000;
+    const QDateTime time = QDateTime::fromString(dateTime, Qt::ISODate);
+    return time.isValid() ? time.toMSecsSinceEpoch() * 1000 : 0;
+}
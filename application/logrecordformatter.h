@@ -0,0 +1,218 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGRECORDFORMATTER_H
+#define LOGRECORDFORMATTER_H
+
+#include "journalreader.h"
+#include "loglongmessage.h"
+#include "logexportcolumns.h"
+#include "logexportwriter.h"
+#include "loglevel.h"
+
+#include <QByteArray>
+#include <QStringList>
+#include <QVector>
+
+/**
+ * @brief The LogRecordLoader struct 输出时逐条取出记录,大部分日志类型直接引用数据源中的记录
+ */
+template <typename T>
+struct LogRecordLoader {
+    const T &load(const T &record) { return record; }
+};
+
+/**
+ * @brief The LogRecordLoader struct 延迟加载的系统日志信息在输出时按游标读取完整内容
+ */
+template <>
+struct LogRecordLoader<LOG_MSG_JOURNAL> {
+    const LOG_MSG_JOURNAL &load(const LOG_MSG_JOURNAL &record)
+    {
+        m_record = record;
+        m_resolver.resolve(m_record);
+        return m_record;
+    }
+
+    JournalMessageResolver m_resolver;
+    LOG_MSG_JOURNAL m_record;
+};
+
+/**
+ * @brief The LogRecordLoader struct 应用日志过长的信息在输出时读取完整内容
+ */
+template <>
+struct LogRecordLoader<LOG_MSG_APPLICATOIN> {
+    const LOG_MSG_APPLICATOIN &load(const LOG_MSG_APPLICATOIN &record)
+    {
+        m_record = record;
+        m_message.resolve(m_record);
+        return m_record;
+    }
+
+    LogLongMessage m_message;
+    LOG_MSG_APPLICATOIN m_record;
+};
+
+/**
+ * @brief The LogRecordFormatter class 按LogExportTraits的导出列把记录格式化为文字,
+ * 导出线程和命令行查询共用,txt每个字段写为"表头:内容 ",ndjson每条记录写为一行json对象。
+ * 等级这类按数字编码保存的列在构造时为每个取值翻译一次,并生成utf8、html转义和docx转义后的形式,
+ * 导出时按编码取出直接写入,不再逐行翻译、转义和转码
+ */
+class LogRecordFormatter
+{
+public:
+    LogRecordFormatter();
+
+    /**
+     * @brief The CodeCell struct 数字编码列一个取值的各种导出形式
+     */
+    struct CodeCell {
+        //翻译后的显示文字
+        QString text;
+        //html转义后的文字
+        QString html;
+        //utf8编码,用于xlsx
+        QByteArray utf8;
+        //xml转义后的utf8编码,用于docx
+        QByteArray xml;
+    };
+
+    template <typename T>
+    QString cellText(const LogExportColumn<T> &column, const T &record, const QString &appName) const;
+    template <typename T>
+    const CodeCell *codeCell(const LogExportColumn<T> &column, const T &record) const;
+    template <typename Traits>
+    void writeTextLine(LogExportWriter &out, const typename Traits::Record &record, const QStringList &labels, const QString &appName) const;
+    template <typename Traits>
+    void writeJsonLine(LogExportWriter &out, const typename Traits::Record &record, const QString &appName) const;
+
+private:
+    template <typename T>
+    static qint64 recordTimestamp(const T &) { return 0; }
+    static qint64 recordTimestamp(const LOG_MSG_JOURNAL &record) { return record.timestamp; }
+    static qint64 recordTimestamp(const LOG_MSG_APPLICATOIN &record) { return record.timestamp; }
+    static qint64 parseTimestamp(const QString &dateTime);
+    template <typename T>
+    static int columnPriority(const LogExportColumn<T> &column, const T &record);
+    static CodeCell makeCodeCell(const QString &text);
+
+    //txt中空值的显示文字
+    QString m_nullStr;
+    //syslog等级各取值的导出形式,下标为PRIORITY
+    QVector<CodeCell> m_levelCells;
+    //dnf等级各取值的导出形式,下标为DNFPRIORITY - TRACE
+    QVector<CodeCell> m_dnfCells;
+    //等级不在范围内时的空文字
+    CodeCell m_emptyCell;
+};
+
+/**
+ * @brief LogRecordFormatter::cellText 取记录在导出列上的显示文字
+ * @param appName 应用日志导出的应用名称
+ */
+template <typename T>
+QString LogRecordFormatter::cellText(const LogExportColumn<T> &column, const T &record, const QString &appName) const
+{
+    switch (column.kind) {
+    case ExportLevel:
+    case ExportDnfLevel:
+        return codeCell(column, record)->text;
+    case ExportAppName:
+        return appName;
+    case ExportText:
+        return (record.*column.text)();
+    default:
+        return record.*column.field;
+    }
+}
+
+/**
+ * @brief LogRecordFormatter::codeCell 等级列取值预先生成的导出形式,其他列返回nullptr
+ */
+template <typename T>
+const LogRecordFormatter::CodeCell *LogRecordFormatter::codeCell(const LogExportColumn<T> &column, const T &record) const
+{
+    if (!column.level)
+        return nullptr;
+    const int level = record.*column.level;
+    if (column.kind == ExportDnfLevel)
+        return level >= TRACE && level <= SUPERCRITICAL ? &m_dnfCells.at(level - TRACE) : &m_emptyCell;
+    if (column.kind == ExportLevel)
+        return level >= 0 && level < LogLevel::SyslogCount ? &m_levelCells.at(level) : &m_emptyCell;
+    return nullptr;
+}
+
+/**
+ * @brief LogRecordFormatter::writeTextLine 把一条记录写为一行txt,导出各字段的描述和对应内容拼成目标字符串
+ * @param labels 表头字符串
+ */
+template <typename Traits>
+void LogRecordFormatter::writeTextLine(LogExportWriter &out, const typename Traits::Record &record, const QStringList &labels, const QString &appName) const
+{
+    int col = 0;
+    for (const LogExportColumn<typename Traits::Record> &column : Traits::columns) {
+        const QString text = cellText(column, record, appName);
+        out << labels.value(col++, "") << ":";
+        out << ((column.flags & ExportNullIfEmpty) && text.isEmpty() ? m_nullStr : text) << " ";
+    }
+    out << "\n";
+}
+
+/**
+ * @brief LogRecordFormatter::writeJsonLine 把一条记录写为一行json对象
+ * 字段名取导出列的key,除文字外另外写入微秒时间戳timestamp、数字等级priority,pid等能转为整数的列按数字写入
+ */
+template <typename Traits>
+void LogRecordFormatter::writeJsonLine(LogExportWriter &out, const typename Traits::Record &record, const QString &appName) const
+{
+    bool first = true;
+    out << "{";
+    for (const LogExportColumn<typename Traits::Record> &column : Traits::columns) {
+        const QString text = cellText(column, record, appName);
+        out << (first ? "\"" : ",\"") << column.key << "\":";
+        first = false;
+        bool isNumber = false;
+        if (column.flags & ExportNumber) {
+            const qlonglong number = text.toLongLong(&isNumber);
+            if (isNumber)
+                out << QString::number(number);
+        }
+        if (!isNumber) {
+            out << "\"";
+            out.writeJsonEscaped(text);
+            out << "\"";
+        }
+        if (column.flags & ExportPriority) {
+            const int priority = columnPriority(column, record);
+            if (priority >= 0)
+                out << ",\"priority\":" << QString::number(priority);
+        }
+        if (column.flags & ExportTime) {
+            qint64 timestamp = recordTimestamp(record);
+            if (timestamp <= 0)
+                timestamp = parseTimestamp(text);
+            if (timestamp > 0)
+                out << ",\"timestamp\":" << QString::number(timestamp);
+        }
+    }
+    out << "}\n";
+}
+
+/**
+ * @brief LogRecordFormatter::columnPriority 等级列对应的syslog数字等级,dnf等级换算为相近的syslog等级,没有对应时返回-1
+ */
+template <typename T>
+int LogRecordFormatter::columnPriority(const LogExportColumn<T> &column, const T &record)
+{
+    if (!column.level)
+        return -1;
+    const int level = record.*column.level;
+    if (column.kind == ExportDnfLevel)
+        return level >= TRACE && level <= SUPERCRITICAL ? LogLevel::dnfSyslog[level - TRACE] : -1;
+    return level >= 0 && level < LogLevel::SyslogCount ? level : -1;
+}
+
+#endif // LOGRECORDFORMATTER_H
@@ -0,0 +1,152 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logrecordparser.h"
+#include "logparsematchers.h"
+
+#include <QDate>
+#include <QDateTime>
+#include <QLocale>
+
+/**
+ * @brief LogRecordParser::parseLine 按格式解析一行
+ * @param format 记录格式,见LogRecordBatch::Format
+ * @param line 一行日志
+ * @param time 输出参数,时间(毫秒)
+ * @param columns 输出参数,各列文本
+ * @return 是否为该格式的记录
+ */
+bool LogRecordParser::parseLine(int format, QString line, qint64 &time, QStringList &columns)
+{
+    switch (format) {
+    case LogRecordBatch::KernFormat:
+        return parseKern(line, time, columns);
+    case LogRecordBatch::DpkgFormat:
+        return parseDpkg(line, time, columns);
+    default:
+        return false;
+    }
+}
+
+/**
+ * @brief LogRecordParser::parseKern 解析内核日志,列为时间文本,主机名,进程名,进程id,信息
+ */
+bool LogRecordParser::parseKern(QString line, qint64 &time, QStringList &columns)
+{
+    columns.clear();
+    //删除颜色格式字符
+    LogParseMatchers::stripColorSequences(line);
+    QStringList list = line.split(" ", QString::SkipEmptyParts);
+    if (list.size() < 5)
+        return false;
+
+    //获取内核年份接口已添加，等待系统接口添加年份改变相关日志
+    const bool hasYear = list[0].contains("-");
+    QString dateTime;
+    if (hasYear) {
+        dateTime = list[0] + " " + list[1];
+        time = formatDateTime(list[0], list[1]);
+    } else {
+        dateTime = list[0] + " " + list[1] + " " + list[2];
+        time = formatDateTime(list[0], list[1], list[2]);
+    }
+
+    //内核日志存在年份时主机名在第3列,否则在第4列,之后是"进程名[进程id]:"
+    const int hostIndex = hasYear ? 2 : 3;
+    const QString &daemon = list[hostIndex + 1];
+    QString daemonName;
+    QString daemonId;
+    QStringList tmpList = daemon.split("[");
+    if (tmpList.size() != 2) {
+        daemonName = daemon.split(":")[0];
+    } else {
+        daemonName = tmpList[0];
+        daemonId = tmpList[1];
+        daemonId.chop(2);
+    }
+
+    QString msgInfo;
+    for (int k = hostIndex + 2; k < list.size(); k++) {
+        msgInfo.append(list[k] + " ");
+    }
+    columns << dateTime << list[hostIndex] << daemonName << daemonId << msgInfo;
+    return true;
+}
+
+/**
+ * @brief LogRecordParser::parseDpkg 解析dpkg日志,列为时间文本,动作,信息
+ */
+bool LogRecordParser::parseDpkg(QString line, qint64 &time, QStringList &columns)
+{
+    columns.clear();
+    LogParseMatchers::stripColorSequences(line);
+    QStringList list = line.split(" ", QString::SkipEmptyParts);
+    if (list.size() < 3)
+        return false;
+
+    QString info;
+    for (auto k = 3; k < list.size(); k++) {
+        info = info + list[k] + " ";
+    }
+    const QString dateTime = list[0] + " " + list[1];
+    time = LogParseMatchers::parseIsoDateTime(list[0], list[1]);
+    if (time < 0)
+        time = QDateTime::fromString(dateTime, "yyyy-MM-dd hh:mm:ss").toMSecsSinceEpoch();
+    columns << dateTime << list[2] << info;
+    return true;
+}
+
+/**
+ * @brief LogRecordParser::formatDateTime 内核日志没有年份 格式为Sep 29 15:53:34 所以需要特殊转换
+ * @param m 月份字符串
+ * @param d 日期字符串
+ * @param t 时间字符串
+ * @return 时间毫秒数
+ */
+qint64 LogRecordParser::formatDateTime(const QString &m, const QString &d, const QString &t)
+{
+    const int year = currentYear();
+    const qint64 msecs = LogParseMatchers::parseSyslogDateTime(m, d, t, year);
+    if (msecs >= 0)
+        return msecs;
+
+    QLocale local(QLocale::English, QLocale::UnitedStates);
+    QString tStr = QString("%1 %2 %3 %4").arg(m).arg(d).arg(year).arg(t);
+    QDateTime dt = local.toDateTime(tStr, "MMM d yyyy hh:mm:ss");
+    return dt.toMSecsSinceEpoch();
+}
+
+/**
+ * @brief LogRecordParser::formatDateTime 内核日志有年份 格式为2020-01-05 所以需要特殊转换
+ * @param y 年月日
+ * @param t 时间字符串
+ * @return 时间毫秒数
+ */
+qint64 LogRecordParser::formatDateTime(const QString &y, const QString &t)
+{
+    //when /var/kern.log have the year
+    const qint64 msecs = LogParseMatchers::parseIsoDateTime(y, t);
+    if (msecs >= 0)
+        return msecs;
+
+    QLocale local(QLocale::English, QLocale::UnitedStates);
+    QString tStr = QString("%1 %2").arg(y).arg(t);
+    QDateTime dt = local.toDateTime(tStr, "yyyy-MM-dd hh:mm:ss");
+    return dt.toMSecsSinceEpoch();
+}
+
+/**
+ * @brief LogRecordParser::currentYear 当前年份,每个线程缓存到下一年开始,不需要每行都换算当前日期
+ */
+int LogRecordParser::currentYear()
+{
+    static thread_local int year = 0;
+    static thread_local qint64 nextYear = 0;
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    if (now >= nextYear) {
+        year = QDate::currentDate().year();
+        nextYear = QDateTime(QDate(year + 1, 1, 1), QTime(0, 0)).toMSecsSinceEpoch();
+    }
+    return year;
+}
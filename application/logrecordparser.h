@@ -0,0 +1,30 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGRECORDPARSER_H
+#define LOGRECORDPARSER_H
+
+#include "logrecordbatch.h"
+
+#include <QString>
+#include <QStringList>
+
+/**
+ * @brief The LogRecordParser class kern/dpkg文本行到定长列的解析,应用和提权服务共用
+ * 应用本地读取时直接解析行,通过服务读取时由服务解析后按LogRecordBatch传回,两边结果一致
+ */
+class LogRecordParser
+{
+public:
+    static bool parseLine(int format, QString line, qint64 &time, QStringList &columns);
+    static bool parseKern(QString line, qint64 &time, QStringList &columns);
+    static bool parseDpkg(QString line, qint64 &time, QStringList &columns);
+
+private:
+    static qint64 formatDateTime(const QString &m, const QString &d, const QString &t);
+    static qint64 formatDateTime(const QString &y, const QString &t);
+    static int currentYear();
+};
+
+#endif // LOGRECORDPARSER_H
@@ -0,0 +1,304 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logrecordreader.h"
+#include "logrecordparser.h"
+#include "loglinestream.h"
+#include "logtimeindex.h"
+#include "logsegmentcache.h"
+#include "logingestmetrics.h"
+#include "logpipeline.h"
+#include "logchunkparser.h"
+#include "dbusproxy/dldbushandler.h"
+
+#include <QLoggingCategory>
+
+#ifdef QT_DEBUG
+Q_LOGGING_CATEGORY(logRecordReader, "org.deepin.log.viewer.record.reader")
+#else
+Q_LOGGING_CATEGORY(logRecordReader, "org.deepin.log.viewer.record.reader", QtInfoMsg)
+#endif
+
+/**
+ * @brief LogRecordReader::LogRecordReader 构造函数
+ * @param filePath 日志文件路径
+ * @param format 记录格式,见LogRecordBatch::Format
+ * @param parent DLDBusHandler单例的父对象
+ */
+LogRecordReader::LogRecordReader(const QString &filePath, int format, QObject *parent)
+    : m_filePath(filePath)
+    , m_format(format)
+    , m_parent(parent)
+{
+}
+
+/**
+ * @brief LogRecordReader::LogRecordReader 按用户声明的行格式读取
+ * @param lineFormat 编译好的行格式,不能为空
+ */
+LogRecordReader::LogRecordReader(const QString &filePath, const LogLineFormatPtr &lineFormat, QObject *parent)
+    : m_filePath(filePath)
+    , m_format(LogRecordBatch::InvalidFormat)
+    , m_parent(parent)
+    , m_lineFormat(lineFormat)
+{
+}
+
+/**
+ * @brief LogRecordReader::read 读取所有记录
+ * @param canRun 是否继续
+ * @param handler 每条记录的回调,记录按从新到旧的顺序交出;筛选条件只用于减少传输,回调仍需自行筛选
+ * @return 是否读取完成,被停止时返回false
+ */
+bool LogRecordReader::read(const std::atomic_bool &canRun, const Handler &handler)
+{
+    m_batched = false;
+    if (m_lineFormat)
+        return readCustom(canRun, handler);
+    //轮转后不再变化的压缩日志有缓存时直接交出,不再解压和解析
+    LogSegmentCache cache(m_filePath, m_format);
+    if (cache.open() && cache.isImmutable())
+        return cache.replay(canRun, m_filter, handler);
+
+    LogLineStream stream(m_filePath, m_parent);
+    //本地直接读取时服务端的筛选不生效,先按行首时间跳过范围外的行,免得拆分字段
+    const bool direct = stream.openDirect();
+    if (!direct) {
+        const QString token = DLDBusHandler::instance(m_parent)->openRecordStream(m_filePath, m_format, remoteFilter().toVariantMap());
+        if (!token.isEmpty()) {
+            int r = readBatches(token, canRun, handler);
+            //中途停止时通知服务释放通道
+            if (r <= 0)
+                DLDBusHandler::instance(m_parent)->closeLogStream(token);
+            //已交出过记录时不能再从头读取文本
+            if (r >= 0)
+                return r > 0;
+            qCWarning(logRecordReader) << "record batch is not supported, read as text:" << m_filePath;
+        }
+        stream.setFilter(remoteFilter());
+    }
+
+    if (direct)
+        return readCached(stream, cache, canRun, handler);
+    return readLines(stream, direct, canRun, handler);
+}
+
+/**
+ * @brief LogRecordReader::readCached 进程内读取时使用解析结果的缓存
+ * 缓存有效时只解析缓存之后新写入的尾部,再交出缓存中的记录;没有时间段筛选的完整读取顺便写入或更新缓存
+ */
+bool LogRecordReader::readCached(LogLineStream &stream, LogSegmentCache &cache, const std::atomic_bool &canRun, const Handler &handler)
+{
+    const qint64 size = stream.mappedSize();
+    const bool timed = m_filter.timeBegin > 0 && m_filter.timeEnd > 0;
+    //需要在读取前校验缓存并取文件开头,开头和最后一个字节通过readRange读取,文件被截断时不使用缓存
+    QByteArray head;
+    QByteArray last;
+    const bool readable = size > 0 && stream.readRange(0, qMin<qint64>(size, LOG_SEGMENT_HEAD_SIZE), head)
+                          && stream.readRange(size - 1, size, last);
+    const bool cached = readable && cache.isValid() && cache.matches(head, size);
+    const bool write = readable && !timed && cache.shouldWrite(size) && cache.beginWrite(head, size, last.at(0) == '\n');
+    if (cached) {
+        stream.setRangeBegin(cache.coveredBytes());
+    } else if (timed) {
+        //按时间顺序写入的大文件查时间索引,只读取时间段所在的部分
+        stream.seekTimeRange(m_filter.timeBegin, m_filter.timeEnd, &LogLineFilter::prefixTime, LOG_TIME_INDEX_LINE);
+    }
+
+    Handler tail = handler;
+    if (write) {
+        tail = [&cache, &handler](qint64 time, const QStringList &columns) {
+            cache.append(time, columns);
+            return handler(time, columns);
+        };
+    }
+    if (!readLines(stream, true, canRun, tail) || (cached && !cache.replay(canRun, m_filter, handler))) {
+        cache.abortWrite();
+        return false;
+    }
+    if (write)
+        cache.finishWrite();
+    return true;
+}
+
+/**
+ * @brief LogRecordReader::readCustom 按自定义行格式读取
+ * 服务不认识自定义格式,不使用记录通道和解析结果缓存,通过服务读取时也不交给服务按时间筛选;
+ * 映射读取时按该格式取时间建立时间索引,只读取时间段所在的部分,其余的行在解析线程中先取时间再决定是否拆分字段
+ */
+bool LogRecordReader::readCustom(const std::atomic_bool &canRun, const Handler &handler)
+{
+    LogLineStream stream(m_filePath, m_parent);
+    const bool direct = stream.openDirect();
+    if (direct && m_lineFormat->hasTime() && m_filter.timeBegin > 0 && m_filter.timeEnd > 0) {
+        const LogLineFormatPtr format = m_lineFormat;
+        stream.seekTimeRange(m_filter.timeBegin, m_filter.timeEnd, [format](const QString &line) {
+            return format->timeOf(line);
+        }, format->indexKind());
+    }
+    return readLines(stream, direct, canRun, handler);
+}
+
+/**
+ * @brief LogRecordReader::parseLines 解析一批行,可以在多个解析线程中同时调用
+ */
+void LogRecordReader::parseLines(const QStringList &lines, bool direct, QList<Parsed> &records) const
+{
+    Parsed parsed;
+    if (!m_lineFormat) {
+        for (const QString &line : lines) {
+            if (direct && !m_filter.matchesTime(line))
+                continue;
+            if (LogRecordParser::parseLine(m_format, line, parsed.time, parsed.columns))
+                records.append(parsed);
+        }
+        return;
+    }
+
+    const bool timed = m_lineFormat->hasTime() && m_filter.timeBegin > 0 && m_filter.timeEnd > 0;
+    for (const QString &line : lines) {
+        //时间段之外的记录只取时间,不拆分字段
+        if (timed) {
+            const qint64 time = m_lineFormat->timeOf(line);
+            if (time >= 0 && (time < m_filter.timeBegin || time > m_filter.timeEnd)) {
+                parsed.kind = Parsed::Skipped;
+                parsed.columns.clear();
+                records.append(parsed);
+                continue;
+            }
+        }
+        if (m_lineFormat->parse(line, parsed.time, parsed.columns)) {
+            parsed.kind = Parsed::Record;
+            records.append(parsed);
+        } else if (!line.trimmed().isEmpty()) {
+            parsed.kind = Parsed::Continuation;
+            parsed.columns = QStringList {line};
+            records.append(parsed);
+        }
+    }
+}
+
+/**
+ * @brief LogRecordReader::remoteFilter 交给服务的筛选条件
+ * 关键字按整行匹配,和调用者按字段(如转换格式后的时间)匹配的结果不一致,只用于本地跳过缓存中的记录块,不交给服务
+ */
+LogLineFilter LogRecordReader::remoteFilter() const
+{
+    LogLineFilter filter = m_filter;
+    filter.keyword.clear();
+    return filter;
+}
+
+/**
+ * @brief LogRecordReader::parseThreadsFor 同时解析fileCount个文件时每个文件的解析线程数
+ */
+int LogRecordReader::parseThreadsFor(int fileCount)
+{
+    return qMax(1, LogPipeline<QStringList, int>::idealThreadCount() / qMax(1, fileCount));
+}
+
+/**
+ * @brief LogRecordReader::readLines 在本进程解析文本行
+ * 多个解析线程时读取、拆分字段和回调分为三段流水线:读取线程读出一批行,解析线程并行拆分,
+ * 调用线程按顺序回调;回调慢时读取和解析随之等待,不会把整个文件读入内存
+ */
+bool LogRecordReader::readLines(LogLineStream &stream, bool direct, const std::atomic_bool &canRun, const Handler &handler)
+{
+    auto parse = [this, direct](const QStringList &lines, QList<Parsed> &records) {
+        parseLines(lines, direct, records);
+        return true;
+    };
+    //从新到旧读取时续行在所属记录之前,先攒下,遇到记录时接在信息列之后
+    QStringList pending;
+    auto deliver = [this, &canRun, &handler, &pending](QList<Parsed> &records) {
+        for (Parsed &parsed : records) {
+            if (!canRun)
+                return false;
+            if (parsed.kind == Parsed::Continuation) {
+                pending.prepend(parsed.columns.first());
+                continue;
+            }
+            if (parsed.kind == Parsed::Skipped) {
+                pending.clear();
+                continue;
+            }
+            if (!pending.isEmpty()) {
+                QString &message = parsed.columns[m_lineFormat->messageColumn()];
+                message += '\n' + pending.join('\n');
+                pending.clear();
+            }
+            if (!handler(parsed.time, parsed.columns))
+                return false;
+        }
+        return true;
+    };
+
+    if (m_parseThreads <= 1) {
+        QStringList lines;
+        QList<Parsed> records;
+        while (stream.readChunk(lines)) {
+            records.clear();
+            parse(lines, records);
+            if (!deliver(records))
+                return false;
+        }
+        return canRun;
+    }
+
+    //单个大文件在进程内读取时按换行切分为多块,各线程分别解码和解析,不受读取线程逐行解码的限制
+    if (direct) {
+        const QVector<qint64> bounds = stream.splitRange(LOG_CHUNK_BYTES);
+        if (bounds.size() > 2) {
+            LogChunkParser<Parsed> parser(canRun);
+            return parser.run(bounds.size() - 1, m_parseThreads, [&stream, &bounds, &parse](int index, QList<Parsed> &records) {
+                //每块用pread读出后再解码,文件在读取期间被截断时停止
+                QByteArray data;
+                if (!stream.readRange(bounds.at(index + 1), bounds.at(index), data))
+                    return false;
+                QStringList lines;
+                LogLineStream::decodeRange(data.constData(), 0, data.size(), lines);
+                return parse(lines, records);
+            }, deliver);
+        }
+    }
+
+    LogPipeline<QStringList, Parsed> pipeline(canRun, m_parseThreads);
+    return pipeline.run([&stream](QStringList &lines) {
+        return stream.readChunk(lines);
+    }, parse, deliver);
+}
+
+/**
+ * @brief LogRecordReader::readBatches 从服务的记录通道读取所有批次
+ * @return 1读取完成,0被停止或批次格式错误,-1第一批就不可用,由调用者改用文本通道
+ */
+int LogRecordReader::readBatches(const QString &token, const std::atomic_bool &canRun, const Handler &handler)
+{
+    bool first = true;
+    QStringList columns;
+    while (canRun) {
+        const LogRecordBatch batch = DLDBusHandler::instance(m_parent)->readRecordBatch(token);
+        if (!batch.isValid() || (batch.size() > 0 && batch.format != m_format)) {
+            qCWarning(logRecordReader) << "invalid record batch, version:" << batch.version << "format:" << batch.format;
+            return first ? -1 : 0;
+        }
+        if (batch.size() == 0)
+            return 1;
+
+        first = false;
+        m_batched = true;
+        //服务端解析好的记录没有原始字节数,只计行数
+        LogIngestMetrics::addRead(0, batch.size());
+        for (int i = 0; i < batch.size(); ++i) {
+            if (!canRun)
+                return 0;
+            columns.clear();
+            for (int c = 0; c < batch.columnCount; ++c)
+                columns.append(batch.column(i, c));
+            if (!handler(batch.timestamps.at(i), columns))
+                return 0;
+        }
+    }
+    return 0;
+}
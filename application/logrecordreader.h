@@ -0,0 +1,85 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGRECORDREADER_H
+#define LOGRECORDREADER_H
+
+#include "loglinefilter.h"
+#include "loglineformat.h"
+#include "logrecordbatch.h"
+
+#include <QString>
+#include <QStringList>
+
+#include <atomic>
+#include <functional>
+
+class QObject;
+class LogLineStream;
+class LogSegmentCache;
+
+/**
+ * @brief The LogRecordReader class 按从新到旧的顺序读取kern/dpkg日志的定长列记录
+ * 进程内可读(直接可读或服务传回描述符)时本地解析行;否则由服务解析后按LogRecordBatch批量传回,
+ * 不再传输原始文本后在本进程重复分词;旧版服务不支持记录通道时退回到文本通道本地解析。
+ * 筛选条件中的关键字只用于跳过解析结果缓存中不可能匹配的记录块,交出的记录仍需调用者按字段筛选。
+ * 按用户声明的行格式(LogLineFormat)读取自定义日志时只在本进程解析,列见LogLineFormat::Column,
+ * 不是记录行的续行接在所属记录的信息列之后
+ */
+class LogRecordReader
+{
+public:
+    /**
+     * @brief Handler 每条记录的回调,参数为时间(毫秒)和各列文本,返回false时停止读取
+     */
+    typedef std::function<bool(qint64, const QStringList &)> Handler;
+
+    LogRecordReader(const QString &filePath, int format, QObject *parent = nullptr);
+    LogRecordReader(const QString &filePath, const LogLineFormatPtr &lineFormat, QObject *parent = nullptr);
+
+    void setFilter(const LogLineFilter &filter) { m_filter = filter; }
+    void setParseThreads(int threads) { m_parseThreads = threads; }
+    static int parseThreadsFor(int fileCount);
+    bool read(const std::atomic_bool &canRun, const Handler &handler);
+    bool isBatched() const { return m_batched; }
+
+private:
+    Q_DISABLE_COPY(LogRecordReader)
+
+    /**
+     * @brief The Parsed struct 解析线程交给调用线程的一行的结果
+     */
+    struct Parsed {
+        enum Kind {
+            Record,
+            //自定义格式中不是记录行的续行,columns只有这一行
+            Continuation,
+            //自定义格式中时间段之外的记录,只用于丢弃之前攒下的续行
+            Skipped
+        };
+        Kind kind = Record;
+        qint64 time = -1;
+        QStringList columns;
+    };
+
+    LogLineFilter remoteFilter() const;
+    bool readCustom(const std::atomic_bool &canRun, const Handler &handler);
+    void parseLines(const QStringList &lines, bool direct, QList<Parsed> &records) const;
+    int readBatches(const QString &token, const std::atomic_bool &canRun, const Handler &handler);
+    bool readCached(LogLineStream &stream, LogSegmentCache &cache, const std::atomic_bool &canRun, const Handler &handler);
+    bool readLines(LogLineStream &stream, bool direct, const std::atomic_bool &canRun, const Handler &handler);
+
+    QString m_filePath;
+    int m_format;
+    QObject *m_parent;
+    //不为空时按该行格式解析,m_format不使用
+    LogLineFormatPtr m_lineFormat;
+    LogLineFilter m_filter;
+    //是否通过服务的记录通道读取
+    bool m_batched = false;
+    //本地解析文本行的线程数,1时在调用线程中逐行解析
+    int m_parseThreads = 1;
+};
+
+#endif // LOGRECORDREADER_H
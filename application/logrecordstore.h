@@ -0,0 +1,235 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGRECORDSTORE_H
+#define LOGRECORDSTORE_H
+
+#include <QList>
+#include <QVector>
+
+#include <algorithm>
+
+/**
+ * @brief The LogRecordStore class 按批次保存的日志记录存储,只在头尾增加记录
+ * 获取线程发来的每一批QList直接作为一个批次收下,只增加引用计数,不逐条复制记录,
+ * 加载时GUI线程的开销只和批次数有关;按下标访问时二分查找所在批次。
+ * 记录按从新到旧排列;按文件自然顺序(从旧到新)读取的批次标记为倒序批次,访问时反向取下标,不需要翻转整个列表。
+ * ingest按时间把批次归并进已有数据,来源之间时间有重叠(并行解析、轮转文件)时也保持整体有序
+ */
+template <typename T>
+class LogRecordStore
+{
+public:
+    /**
+     * @brief The Order enum 一批记录的排列顺序
+     */
+    enum Order {
+        NewestFirst, //从新到旧,和存储的顺序相同
+        OldestFirst  //从旧到新,按文件自然顺序读取的结果
+    };
+    /**
+     * @brief The IngestResult enum ingest把一批记录放到了哪里
+     */
+    enum IngestResult {
+        Ignored,   //空批次
+        Appended,  //比已有记录都旧,追加到末尾,已有下标不变
+        Prepended, //比已有记录都新,插入到头部,已有下标后移批次大小
+        Merged     //和已有记录时间重叠,从mergedFrom开始的记录重新排列
+    };
+
+    LogRecordStore() {}
+    /**
+     * @brief LogRecordStore 以list为唯一批次的存储
+     */
+    LogRecordStore(const QList<T> &list)
+    {
+        append(list);
+    }
+
+    int size() const
+    {
+        return m_size;
+    }
+    int count() const
+    {
+        return m_size;
+    }
+    bool isEmpty() const
+    {
+        return m_size == 0;
+    }
+    int batchCount() const
+    {
+        return m_batches.size();
+    }
+    const T &at(int row) const
+    {
+        //第一个起始下标大于row的批次的前一个即为所在批次
+        const int batch = static_cast<int>(std::upper_bound(m_starts.constBegin(), m_starts.constEnd(), row) - m_starts.constBegin()) - 1;
+        const QList<T> &records = m_batches.at(batch);
+        const int offset = row - m_starts.at(batch);
+        return m_reversed.at(batch) ? records.at(records.size() - 1 - offset) : records.at(offset);
+    }
+
+    /**
+     * @brief append 把一批记录整体追加到末尾,和发送方共享数据
+     * @param order batch的排列顺序,OldestFirst时按倒序访问
+     */
+    void append(const QList<T> &batch, Order order = NewestFirst)
+    {
+        if (batch.isEmpty())
+            return;
+        m_starts.append(m_size);
+        m_batches.append(batch);
+        m_reversed.append(order == OldestFirst);
+        m_size += batch.size();
+    }
+    /**
+     * @brief append 追加单条记录,写入最后一个批次,逐条解析的少量数据使用
+     */
+    void append(const T &record)
+    {
+        if (m_batches.isEmpty()) {
+            m_starts.append(0);
+            m_batches.append(QList<T>());
+            m_reversed.append(false);
+        }
+        if (m_reversed.last())
+            m_batches.last().prepend(record);
+        else
+            m_batches.last().append(record);
+        ++m_size;
+    }
+    /**
+     * @brief prepend 把一批记录整体插入到头部,已有记录的下标后移batch.size()
+     */
+    void prepend(const QList<T> &batch, Order order = NewestFirst)
+    {
+        if (batch.isEmpty())
+            return;
+        for (int &start : m_starts)
+            start += batch.size();
+        m_starts.prepend(0);
+        m_batches.prepend(batch);
+        m_reversed.prepend(order == OldestFirst);
+        m_size += batch.size();
+    }
+
+    /**
+     * @brief ingest 按时间把一批记录放入存储,保持整体从新到旧
+     * 批次整体比已有记录旧或新时直接追加或插入头部,不复制记录;与已有记录时间重叠时只把重叠的尾部和批次归并为一个新批次,
+     * 开销和重叠部分的条数成正比。
+     * 和最新记录时间相同的批次按更新的记录插入头部,归并时时间相同的记录已有的排在前面
+     * @param batch 一批记录,批次内按order有序
+     * @param order batch的排列顺序,来源按自然顺序给出即可
+     * @param timeOf 取记录时间的函数,返回可比较的值
+     * @param mergedFrom 返回Merged时为第一条位置变化的记录下标,之后的下标不再指向原来的记录
+     */
+    template <typename TimeOf>
+    IngestResult ingest(const QList<T> &batch, Order order, TimeOf timeOf, int *mergedFrom = nullptr)
+    {
+        if (batch.isEmpty())
+            return Ignored;
+        const bool reversed = order == OldestFirst;
+        const auto newest = timeOf(reversed ? batch.last() : batch.first());
+        const auto oldest = timeOf(reversed ? batch.first() : batch.last());
+        if (m_size == 0 || !(timeOf(at(m_size - 1)) < newest)) {
+            append(batch, order);
+            return Appended;
+        }
+        if (!(oldest < timeOf(at(0)))) {
+            prepend(batch, order);
+            return Prepended;
+        }
+
+        //第一条比批次最新记录还旧的位置,从这里开始和批次归并
+        int low = 0;
+        int high = m_size;
+        while (low < high) {
+            const int mid = low + (high - low) / 2;
+            if (timeOf(at(mid)) < newest)
+                high = mid;
+            else
+                low = mid + 1;
+        }
+        const int from = low;
+        QList<T> merged;
+        merged.reserve(m_size - from + batch.size());
+        int row = from;
+        int index = 0;
+        while (row < m_size || index < batch.size()) {
+            const T *incoming = index < batch.size() ? &batch.at(reversed ? batch.size() - 1 - index : index) : nullptr;
+            if (row < m_size && (!incoming || !(timeOf(at(row)) < timeOf(*incoming)))) {
+                merged.append(at(row++));
+            } else {
+                merged.append(*incoming);
+                ++index;
+            }
+        }
+        truncate(from);
+        append(merged);
+        if (mergedFrom)
+            *mergedFrom = from;
+        return Merged;
+    }
+
+    void clear()
+    {
+        m_batches.clear();
+        m_starts.clear();
+        m_reversed.clear();
+        m_size = 0;
+    }
+
+    /**
+     * @brief toList 合并为一个QList,用于导出等需要独立QList的场景
+     */
+    QList<T> toList() const
+    {
+        if (m_batches.size() == 1 && !m_reversed.first())
+            return m_batches.first();
+        QList<T> list;
+        list.reserve(m_size);
+        for (int i = 0; i < m_batches.size(); ++i) {
+            const QList<T> &batch = m_batches.at(i);
+            if (m_reversed.at(i)) {
+                for (int j = batch.size() - 1; j >= 0; --j)
+                    list.append(batch.at(j));
+            } else {
+                list.append(batch);
+            }
+        }
+        return list;
+    }
+
+private:
+    /**
+     * @brief truncate 只保留前rows条记录,被截断的批次复制保留的部分
+     */
+    void truncate(int rows)
+    {
+        while (!m_batches.isEmpty() && m_starts.last() >= rows) {
+            m_batches.removeLast();
+            m_starts.removeLast();
+            m_reversed.removeLast();
+        }
+        m_size = rows;
+        if (m_batches.isEmpty())
+            return;
+        const int keep = rows - m_starts.last();
+        QList<T> &batch = m_batches.last();
+        if (keep == batch.size())
+            return;
+        batch = m_reversed.last() ? batch.mid(batch.size() - keep) : batch.mid(0, keep);
+    }
+
+    QVector<QList<T>> m_batches;
+    //每个批次第一条记录的下标
+    QVector<int> m_starts;
+    //按倒序访问的批次(从旧到新收下的批次)
+    QVector<bool> m_reversed;
+    int m_size = 0;
+};
+
+#endif // LOGRECORDSTORE_H
@@ -0,0 +1,200 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGRECORDVIEW_H
+#define LOGRECORDVIEW_H
+
+#include "logrecordstore.h"
+
+#include <QList>
+#include <QVector>
+
+#include <memory>
+
+/**
+ * @brief The LogRecordView class 日志记录的筛选视图,只保存记录在存储列表中的下标
+ * 同一类日志只在LogRecordStore中保存一份完整记录,筛选、搜索和表格显示的结果都是下标数组,叠加多少层筛选都不再复制记录;
+ * 视图不持有存储时存储需要比视图活得久,头部插入后要用offsetRows修正下标
+ */
+template <typename T>
+class LogRecordView
+{
+public:
+    LogRecordView() {}
+    explicit LogRecordView(const LogRecordStore<T> *store)
+        : m_store(store)
+    {
+    }
+    /**
+     * @brief LogRecordView 持有list的隐式共享拷贝,视图包含其中所有记录
+     */
+    LogRecordView(const QList<T> &list)
+        : m_owned(std::make_shared<const LogRecordStore<T>>(list))
+        , m_store(m_owned.get())
+    {
+        appendRange(0, list.size());
+    }
+
+    static LogRecordView<T> range(const LogRecordStore<T> *store, int begin, int end)
+    {
+        LogRecordView<T> view(store);
+        view.appendRange(begin, end);
+        return view;
+    }
+    static LogRecordView<T> all(const LogRecordStore<T> *store)
+    {
+        return range(store, 0, store->size());
+    }
+
+    const LogRecordStore<T> *store() const
+    {
+        return m_store;
+    }
+    const QVector<quint32> &rows() const
+    {
+        return m_rows;
+    }
+    int size() const
+    {
+        return m_rows.size();
+    }
+    int count() const
+    {
+        return m_rows.size();
+    }
+    bool isEmpty() const
+    {
+        return m_rows.isEmpty();
+    }
+    /**
+     * @brief isValid 第i条记录是否还在存储中,存储被清空后表格可能还没来得及重置
+     */
+    bool isValid(int i) const
+    {
+        return m_store && i >= 0 && i < m_rows.size() && m_rows.at(i) < static_cast<quint32>(m_store->size());
+    }
+    const T &at(int i) const
+    {
+        return m_store->at(static_cast<int>(m_rows.at(i)));
+    }
+    //第i条记录在存储中的下标
+    quint32 row(int i) const
+    {
+        return m_rows.at(i);
+    }
+
+    /**
+     * @brief withRows 同一存储上的另一个视图
+     * @param rows 记录在存储中的下标
+     */
+    LogRecordView<T> withRows(const QVector<quint32> &rows) const
+    {
+        LogRecordView<T> view = *this;
+        view.m_rows = rows;
+        return view;
+    }
+    LogRecordView<T> mid(int pos, int length = -1) const
+    {
+        return withRows(m_rows.mid(pos, length));
+    }
+
+    void clear()
+    {
+        m_rows.clear();
+    }
+    /**
+     * @brief appendRange 追加存储中[begin, end)范围的记录
+     */
+    void appendRange(int begin, int end)
+    {
+        if (begin >= end)
+            return;
+        m_rows.reserve(m_rows.size() + end - begin);
+        for (int i = begin; i < end; ++i)
+            m_rows.append(static_cast<quint32>(i));
+    }
+    void append(const LogRecordView<T> &other)
+    {
+        insert(m_rows.size(), other, 0, other.size());
+    }
+    /**
+     * @brief insert 在pos处插入other中[start, end)范围的记录
+     * 两者的存储不同时,当前为空则直接改用other的存储,否则把两边的记录合并成自己持有的存储
+     */
+    void insert(int pos, const LogRecordView<T> &other, int start, int end)
+    {
+        if (start >= end)
+            return;
+        pos = qBound(0, pos, m_rows.size());
+        if (m_store != other.m_store) {
+            if (!isEmpty()) {
+                QList<T> records = toList();
+                for (int i = start; i < end; ++i)
+                    records.insert(pos + i - start, other.at(i));
+                *this = LogRecordView<T>(records);
+                return;
+            }
+            m_owned = other.m_owned;
+            m_store = other.m_store;
+        }
+        if (isEmpty() && start == 0 && end == other.size()) {
+            m_rows = other.m_rows;
+        } else if (pos == m_rows.size()) {
+            m_rows += other.m_rows.mid(start, end - start);
+        } else {
+            QVector<quint32> rows;
+            rows.reserve(m_rows.size() + end - start);
+            rows += m_rows.mid(0, pos);
+            rows += other.m_rows.mid(start, end - start);
+            rows += m_rows.mid(pos);
+            m_rows.swap(rows);
+        }
+    }
+    void remove(int pos, int count)
+    {
+        m_rows.remove(pos, count);
+    }
+    /**
+     * @brief offsetRows 存储头部插入了delta条记录后,所有下标后移
+     */
+    void offsetRows(int delta)
+    {
+        for (quint32 &row : m_rows)
+            row += static_cast<quint32>(delta);
+    }
+
+    /**
+     * @brief snapshot 持有存储浅拷贝的同一视图,原存储之后被清空或追加都不影响它,可交给其他线程使用
+     * 只复制存储的批次列表并增加各批次的引用计数,不复制记录
+     */
+    LogRecordView<T> snapshot() const
+    {
+        LogRecordView<T> view = *this;
+        if (m_store && !m_owned) {
+            view.m_owned = std::make_shared<const LogRecordStore<T>>(*m_store);
+            view.m_store = view.m_owned.get();
+        }
+        return view;
+    }
+
+    /**
+     * @brief toList 复制出视图中的记录,用于导出等需要独立QList的场景
+     */
+    QList<T> toList() const
+    {
+        QList<T> list;
+        list.reserve(m_rows.size());
+        for (quint32 row : m_rows)
+            list.append(m_store->at(static_cast<int>(row)));
+        return list;
+    }
+
+private:
+    //从QList构造时持有的存储
+    std::shared_ptr<const LogRecordStore<T>> m_owned;
+    const LogRecordStore<T> *m_store = nullptr;
+    QVector<quint32> m_rows;
+};
+
+#endif // LOGRECORDVIEW_H
@@ -0,0 +1,798 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logregex.h"
+
+#include <QCoreApplication>
+
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief The VmThread struct Pike VM中的一个状态:程序位置和匹配开始的位置
+ */
+struct VmThread {
+    int pc;
+    int start;
+};
+
+/**
+ * @brief The VmScratch struct 每个线程一份的匹配工作区,多个记录、多个表达式复用同一块内存
+ * mark中等于当前代数的指令已经在本轮的状态列表中,代数每轮递增,不需要每轮清空
+ */
+struct VmScratch {
+    std::vector<VmThread> current;
+    std::vector<VmThread> next;
+    std::vector<quint32> mark;
+    std::vector<int> stack;
+    quint32 generation = 0;
+
+    void prepare(int size)
+    {
+        if (static_cast<int>(mark.size()) < size)
+            mark.resize(static_cast<size_t>(size), 0);
+    }
+
+    quint32 nextGeneration()
+    {
+        if (++generation == 0) {
+            std::fill(mark.begin(), mark.end(), 0);
+            generation = 1;
+        }
+        return generation;
+    }
+};
+
+thread_local VmScratch vmScratch;
+
+} // namespace
+
+/**
+ * @brief LogRegex::LogRegex 编译表达式,语法错误时isValid为false,不匹配任何文本
+ * @param pattern 表达式
+ * @param cs 是否区分大小写,界面搜索不区分
+ */
+LogRegex::LogRegex(const QString &pattern, Qt::CaseSensitivity cs)
+    : m_pattern(pattern)
+    , m_cs(cs)
+{
+    const int root = parseAlternate();
+    if (m_error.isEmpty() && !atEnd())
+        fail(QCoreApplication::translate("LogRegex", "Unmatched ) at position %1").arg(m_pos + 1));
+    if (m_error.isEmpty() && (!compileNode(root) || emitInst(OpMatch) >= LOG_REGEX_MAX_PROGRAM))
+        fail(QCoreApplication::translate("LogRegex", "Regular expression is too large"));
+    if (!m_error.isEmpty()) {
+        m_nodes.clear();
+        m_classes.clear();
+        m_program.clear();
+        return;
+    }
+
+    const LiteralInfo info = literalInfo(root);
+    QStringList all = info.required;
+    all << info.prefix << info.suffix;
+    //越长的字面量越少出现,先检查
+    std::stable_sort(all.begin(), all.end(), [](const QString &a, const QString &b) {
+        return a.length() > b.length();
+    });
+    for (const QString &literal : all) {
+        if (literal.isEmpty() || m_literals.size() >= LOG_REGEX_MAX_LITERALS)
+            continue;
+        bool covered = false;
+        for (const QString &kept : m_literals)
+            covered = covered || kept.contains(literal, Qt::CaseInsensitive);
+        if (!covered) {
+            m_literals.append(literal);
+            m_required.append(LogCaseMatcher(literal));
+        }
+    }
+    m_prefix = LogCaseMatcher(info.prefix);
+    m_anchored = anchoredAtBegin(root);
+    m_nodes.clear();
+}
+
+/**
+ * @brief LogRegex::indexIn 从from开始最左边的匹配,多个分支都能匹配时按书写顺序和贪婪规则取一个,和Perl一致
+ * @param length 输出参数,匹配的长度,可以为0
+ * @return 匹配开始的位置,没有匹配时为-1
+ */
+int LogRegex::indexIn(const QString &text, int from, int *length) const
+{
+    return search(text, from, length, false);
+}
+
+/**
+ * @brief LogRegex::matches 文本中是否有匹配,找到任意一个匹配就返回,不确定匹配的范围
+ */
+bool LogRegex::matches(const QString &text) const
+{
+    return search(text, 0, nullptr, true) >= 0;
+}
+
+int LogRegex::search(const QString &text, int from, int *length, bool anyMatch) const
+{
+    const int size = text.length();
+    if (!isValid() || from > size)
+        return -1;
+    from = qMax(0, from);
+    for (const LogCaseMatcher &literal : m_required) {
+        if (literal.indexIn(text, from) < 0)
+            return -1;
+    }
+
+    VmScratch &vm = vmScratch;
+    vm.prepare(m_program.size());
+    const ushort *data = text.utf16();
+    int matchStart = -1;
+    int matchEnd = -1;
+
+    //沿跳转和断言展开到消耗字符的指令,先加入的状态优先级高
+    auto addThread = [this, &vm, &text, size](std::vector<VmThread> &list, quint32 generation, int pc, int pos, int start) {
+        vm.stack.clear();
+        vm.stack.push_back(pc);
+        while (!vm.stack.empty()) {
+            const int p = vm.stack.back();
+            vm.stack.pop_back();
+            if (vm.mark[static_cast<size_t>(p)] == generation)
+                continue;
+            vm.mark[static_cast<size_t>(p)] = generation;
+            const Inst &inst = m_program.at(p);
+            switch (inst.op) {
+            case OpJmp:
+                vm.stack.push_back(inst.x);
+                break;
+            case OpSplit:
+                vm.stack.push_back(inst.y);
+                vm.stack.push_back(inst.x);
+                break;
+            case OpBegin:
+                if (pos == 0)
+                    vm.stack.push_back(p + 1);
+                break;
+            case OpEnd:
+                if (pos == size)
+                    vm.stack.push_back(p + 1);
+                break;
+            case OpWordBoundary:
+            case OpNotWordBoundary:
+                if ((isWordChar(text, pos - 1) != isWordChar(text, pos)) == (inst.op == OpWordBoundary))
+                    vm.stack.push_back(p + 1);
+                break;
+            default:
+                list.push_back({p, start});
+                break;
+            }
+        }
+    };
+
+    vm.current.clear();
+    quint32 generation = vm.nextGeneration();
+    for (int pos = from; pos <= size; ++pos) {
+        if (matchStart < 0) {
+            if (vm.current.empty()) {
+                if (m_anchored && pos > 0)
+                    break;
+                //没有进行中的状态时,直接跳到下一个可能开始匹配的位置
+                if (!m_prefix.isEmpty()) {
+                    pos = m_prefix.indexIn(text, pos);
+                    if (pos < 0)
+                        break;
+                }
+            }
+            //新的开始位置优先级最低,已有匹配后不再尝试更靠右的开始位置
+            if (!m_anchored || pos == 0)
+                addThread(vm.current, generation, 0, pos, pos);
+        }
+        vm.next.clear();
+        const quint32 nextGeneration = vm.nextGeneration();
+        for (const VmThread &thread : vm.current) {
+            const Inst &inst = m_program.at(thread.pc);
+            if (inst.op == OpMatch) {
+                matchStart = thread.start;
+                matchEnd = pos;
+                //优先级更低的状态不再需要
+                break;
+            }
+            if (pos < size && matchChar(inst, data[pos]))
+                addThread(vm.next, nextGeneration, thread.pc + 1, pos + 1, thread.start);
+        }
+        if (matchStart >= 0 && (anyMatch || vm.next.empty()))
+            break;
+        vm.current.swap(vm.next);
+        generation = nextGeneration;
+    }
+    if (matchStart >= 0 && length)
+        *length = matchEnd - matchStart;
+    return matchStart;
+}
+
+int LogRegex::parseAlternate()
+{
+    const int first = parseConcat();
+    if (first < 0 || atEnd() || m_pattern.at(m_pos) != QLatin1Char('|'))
+        return first;
+    const int alternate = addNode(NodeAlternate);
+    m_nodes[alternate].children.append(first);
+    while (!atEnd() && m_pattern.at(m_pos) == QLatin1Char('|')) {
+        ++m_pos;
+        const int next = parseConcat();
+        if (next < 0)
+            return -1;
+        m_nodes[alternate].children.append(next);
+    }
+    return alternate;
+}
+
+int LogRegex::parseConcat()
+{
+    const int concat = addNode(NodeConcat);
+    while (!atEnd()) {
+        const QChar c = m_pattern.at(m_pos);
+        if (c == QLatin1Char('|') || c == QLatin1Char(')'))
+            break;
+        const int next = parseRepeat();
+        if (next < 0)
+            return -1;
+        m_nodes[concat].children.append(next);
+    }
+    if (m_nodes.at(concat).children.size() == 1)
+        return m_nodes.at(concat).children.first();
+    if (m_nodes.at(concat).children.isEmpty())
+        m_nodes[concat].type = NodeEmpty;
+    return concat;
+}
+
+int LogRegex::parseRepeat()
+{
+    int atom = parseAtom();
+    while (atom >= 0 && !atEnd()) {
+        const QChar c = m_pattern.at(m_pos);
+        int min = 0;
+        int max = -1;
+        if (c == QLatin1Char('*')) {
+            ++m_pos;
+        } else if (c == QLatin1Char('+')) {
+            min = 1;
+            ++m_pos;
+        } else if (c == QLatin1Char('?')) {
+            max = 1;
+            ++m_pos;
+        } else if (c == QLatin1Char('{')) {
+            //不是合法的{m,n}时按字面字符处理
+            const int save = m_pos;
+            ++m_pos;
+            if (!parseCount(min)) {
+                m_pos = save;
+                break;
+            }
+            max = min;
+            if (!atEnd() && m_pattern.at(m_pos) == QLatin1Char(',')) {
+                ++m_pos;
+                max = -1;
+                if (!atEnd() && m_pattern.at(m_pos) != QLatin1Char('}') && !parseCount(max)) {
+                    m_pos = save;
+                    break;
+                }
+            }
+            if (atEnd() || m_pattern.at(m_pos) != QLatin1Char('}')) {
+                m_pos = save;
+                break;
+            }
+            ++m_pos;
+            if (min > LOG_REGEX_MAX_REPEAT || max > LOG_REGEX_MAX_REPEAT) {
+                fail(QCoreApplication::translate("LogRegex", "Repeat count exceeds %1").arg(LOG_REGEX_MAX_REPEAT));
+                return -1;
+            }
+            if (max >= 0 && max < min) {
+                fail(QCoreApplication::translate("LogRegex", "Invalid repeat range at position %1").arg(save + 1));
+                return -1;
+            }
+        } else {
+            break;
+        }
+        bool greedy = true;
+        if (!atEnd() && m_pattern.at(m_pos) == QLatin1Char('?')) {
+            greedy = false;
+            ++m_pos;
+        }
+        const int repeat = addNode(NodeRepeat);
+        Node &node = m_nodes[repeat];
+        node.children.append(atom);
+        node.min = min;
+        node.max = max;
+        node.greedy = greedy;
+        atom = repeat;
+    }
+    return atom;
+}
+
+int LogRegex::parseAtom()
+{
+    const ushort c = m_pattern.at(m_pos).unicode();
+    switch (c) {
+    case '(': {
+        ++m_pos;
+        if (m_pattern.midRef(m_pos, 2) == QLatin1String("?:")) {
+            m_pos += 2;
+        } else if (!atEnd() && m_pattern.at(m_pos) == QLatin1Char('?')) {
+            fail(QCoreApplication::translate("LogRegex", "Unsupported group at position %1").arg(m_pos));
+            return -1;
+        }
+        const int inner = parseAlternate();
+        if (inner < 0)
+            return -1;
+        if (atEnd() || m_pattern.at(m_pos) != QLatin1Char(')')) {
+            fail(QCoreApplication::translate("LogRegex", "Missing )"));
+            return -1;
+        }
+        ++m_pos;
+        return inner;
+    }
+    case '*':
+    case '+':
+    case '?':
+        fail(QCoreApplication::translate("LogRegex", "Nothing to repeat at position %1").arg(m_pos + 1));
+        return -1;
+    case '[':
+        return parseClass();
+    case '.':
+        ++m_pos;
+        return addNode(NodeAny);
+    case '^':
+        ++m_pos;
+        return addNode(NodeBegin);
+    case '$':
+        ++m_pos;
+        return addNode(NodeEnd);
+    case '\\': {
+        ++m_pos;
+        if (atEnd()) {
+            fail(QCoreApplication::translate("LogRegex", "Trailing backslash"));
+            return -1;
+        }
+        const QChar e = m_pattern.at(m_pos);
+        if (e == QLatin1Char('b') || e == QLatin1Char('B')) {
+            ++m_pos;
+            return addNode(e == QLatin1Char('b') ? NodeWordBoundary : NodeNotWordBoundary);
+        }
+        CharClass cls;
+        int ch = -1;
+        if (!parseEscape(cls, ch))
+            return -1;
+        if (ch >= 0)
+            return addNode(NodeChar, static_cast<ushort>(ch));
+        finishClass(cls);
+        m_classes.append(cls);
+        return addNode(NodeClass, 0, m_classes.size() - 1);
+    }
+    default:
+        ++m_pos;
+        return addNode(NodeChar, c);
+    }
+}
+
+int LogRegex::parseClass()
+{
+    const int start = m_pos;
+    ++m_pos;
+    CharClass cls;
+    if (!atEnd() && m_pattern.at(m_pos) == QLatin1Char('^')) {
+        cls.negated = true;
+        ++m_pos;
+    }
+    bool first = true;
+    while (true) {
+        if (atEnd()) {
+            fail(QCoreApplication::translate("LogRegex", "Missing ] for [ at position %1").arg(start + 1));
+            return -1;
+        }
+        const ushort c = m_pattern.at(m_pos).unicode();
+        //紧跟[或[^的]是字面字符
+        if (c == ']' && !first) {
+            ++m_pos;
+            break;
+        }
+        first = false;
+        int low = c;
+        ++m_pos;
+        if (c == '\\') {
+            if (atEnd())
+                continue;
+            low = -1;
+            if (!parseEscape(cls, low))
+                return -1;
+            if (low < 0)
+                continue;
+        }
+        int high = low;
+        if (m_pos + 1 < m_pattern.length() && m_pattern.at(m_pos) == QLatin1Char('-') && m_pattern.at(m_pos + 1) != QLatin1Char(']')) {
+            ++m_pos;
+            high = m_pattern.at(m_pos).unicode();
+            ++m_pos;
+            if (high == '\\') {
+                CharClass unused;
+                high = -1;
+                if (atEnd()) {
+                    fail(QCoreApplication::translate("LogRegex", "Trailing backslash"));
+                    return -1;
+                }
+                if (!parseEscape(unused, high))
+                    return -1;
+            }
+            if (high < low) {
+                fail(QCoreApplication::translate("LogRegex", "Invalid range in [ at position %1").arg(start + 1));
+                return -1;
+            }
+        }
+        cls.ranges.append(qMakePair(static_cast<ushort>(low), static_cast<ushort>(high)));
+    }
+    finishClass(cls);
+    m_classes.append(cls);
+    return addNode(NodeClass, 0, m_classes.size() - 1);
+}
+
+/**
+ * @brief LogRegex::parseEscape 解析反斜杠之后的部分,m_pos指向反斜杠后的字符
+ * @param cls \d这类转义加入的字符集
+ * @param ch 输出参数,单个字符的转义为字符,字符集转义为-1
+ */
+bool LogRegex::parseEscape(CharClass &cls, int &ch)
+{
+    const ushort e = m_pattern.at(m_pos).unicode();
+    ++m_pos;
+    ch = -1;
+    switch (e) {
+    case 'd':
+        cls.builtins |= Digit;
+        return true;
+    case 'D':
+        cls.builtins |= NotDigit;
+        return true;
+    case 'w':
+        cls.builtins |= Word;
+        return true;
+    case 'W':
+        cls.builtins |= NotWord;
+        return true;
+    case 's':
+        cls.builtins |= Space;
+        return true;
+    case 'S':
+        cls.builtins |= NotSpace;
+        return true;
+    case 'n':
+        ch = '\n';
+        return true;
+    case 't':
+        ch = '\t';
+        return true;
+    case 'r':
+        ch = '\r';
+        return true;
+    case 'f':
+        ch = '\f';
+        return true;
+    case 'v':
+        ch = '\v';
+        return true;
+    case 'x': {
+        bool ok = false;
+        const int value = m_pattern.midRef(m_pos, 2).toInt(&ok, 16);
+        if (!ok || m_pattern.midRef(m_pos, 2).length() != 2) {
+            fail(QCoreApplication::translate("LogRegex", "Invalid \\x escape at position %1").arg(m_pos));
+            return false;
+        }
+        m_pos += 2;
+        ch = value;
+        return true;
+    }
+    default:
+        //未知的字母数字转义保留给以后的语法,标点等其他字符转义为自身
+        if (e < 128 && QChar(e).isLetterOrNumber()) {
+            fail(QCoreApplication::translate("LogRegex", "Unsupported escape \\%1").arg(QChar(e)));
+            return false;
+        }
+        ch = e;
+        return true;
+    }
+}
+
+bool LogRegex::parseCount(int &value)
+{
+    value = 0;
+    const int start = m_pos;
+    while (!atEnd() && m_pattern.at(m_pos).unicode() >= '0' && m_pattern.at(m_pos).unicode() <= '9') {
+        value = qMin(value * 10 + (m_pattern.at(m_pos).unicode() - '0'), LOG_REGEX_MAX_REPEAT + 1);
+        ++m_pos;
+    }
+    return m_pos > start;
+}
+
+int LogRegex::addNode(NodeType type, ushort ch, int cls)
+{
+    m_nodes.append({type, ch, cls, QVector<int>(), 1, 1, true});
+    return m_nodes.size() - 1;
+}
+
+void LogRegex::fail(const QString &error)
+{
+    if (m_error.isEmpty())
+        m_error = error;
+}
+
+/**
+ * @brief LogRegex::compileNode 把语法树节点编译为程序,{m,n}的子表达式按次数展开
+ * @return 程序是否没有超出LOG_REGEX_MAX_PROGRAM
+ */
+bool LogRegex::compileNode(int node)
+{
+    if (m_program.size() >= LOG_REGEX_MAX_PROGRAM)
+        return false;
+    const Node &n = m_nodes.at(node);
+    switch (n.type) {
+    case NodeEmpty:
+        return true;
+    case NodeChar:
+        emitInst(OpChar, m_cs == Qt::CaseInsensitive ? QChar::toCaseFolded(n.ch) : n.ch);
+        return true;
+    case NodeClass:
+        emitInst(OpClass, 0, n.cls);
+        return true;
+    case NodeAny:
+        emitInst(OpAny);
+        return true;
+    case NodeBegin:
+        emitInst(OpBegin);
+        return true;
+    case NodeEnd:
+        emitInst(OpEnd);
+        return true;
+    case NodeWordBoundary:
+        emitInst(OpWordBoundary);
+        return true;
+    case NodeNotWordBoundary:
+        emitInst(OpNotWordBoundary);
+        return true;
+    case NodeConcat:
+        for (int child : n.children) {
+            if (!compileNode(child))
+                return false;
+        }
+        return true;
+    case NodeAlternate: {
+        //除最后一个分支外,每个分支前用split分出下一个分支,结束后跳到整个选择之后
+        QVector<int> jumps;
+        for (int i = 0; i < n.children.size(); ++i) {
+            const bool last = i + 1 == n.children.size();
+            const int split = last ? -1 : emitInst(OpSplit);
+            if (!compileNode(n.children.at(i)))
+                return false;
+            if (last)
+                break;
+            jumps.append(emitInst(OpJmp));
+            m_program[split].x = split + 1;
+            m_program[split].y = m_program.size();
+        }
+        for (int jump : jumps)
+            m_program[jump].x = m_program.size();
+        return true;
+    }
+    case NodeRepeat: {
+        const int child = n.children.first();
+        const int min = n.min;
+        const int max = n.max;
+        const bool greedy = n.greedy;
+        for (int i = 0; i < min; ++i) {
+            if (!compileNode(child))
+                return false;
+        }
+        if (max < 0) {
+            const int split = emitInst(OpSplit);
+            if (!compileNode(child))
+                return false;
+            emitInst(OpJmp, 0, split);
+            m_program[split].x = greedy ? split + 1 : m_program.size();
+            m_program[split].y = greedy ? m_program.size() : split + 1;
+            return true;
+        }
+        QVector<int> splits;
+        for (int i = min; i < max; ++i) {
+            splits.append(emitInst(OpSplit));
+            if (!compileNode(child))
+                return false;
+        }
+        for (int split : splits) {
+            m_program[split].x = greedy ? split + 1 : m_program.size();
+            m_program[split].y = greedy ? m_program.size() : split + 1;
+        }
+        return true;
+    }
+    }
+    return true;
+}
+
+int LogRegex::emitInst(Op op, ushort ch, int x, int y)
+{
+    m_program.append({op, ch, x, y});
+    return m_program.size() - 1;
+}
+
+/**
+ * @brief LogRegex::literalInfo 计算节点的字面量信息,只需要保证提取出的字面量在每个匹配中都出现
+ */
+LogRegex::LiteralInfo LogRegex::literalInfo(int node) const
+{
+    const Node &n = m_nodes.at(node);
+    LiteralInfo info;
+    switch (n.type) {
+    case NodeEmpty:
+    case NodeBegin:
+    case NodeEnd:
+    case NodeWordBoundary:
+    case NodeNotWordBoundary:
+        info.exact = true;
+        return info;
+    case NodeChar:
+        info.exact = true;
+        info.str = QString(QChar(n.ch));
+        info.prefix = info.str;
+        info.suffix = info.str;
+        return info;
+    case NodeClass:
+    case NodeAny:
+        return info;
+    case NodeConcat: {
+        info.exact = true;
+        for (int child : n.children)
+            info = join(info, literalInfo(child));
+        return info;
+    }
+    case NodeAlternate: {
+        //各分支都是同一个字面量时仍然确定,否则只保留共同的前缀和后缀
+        for (int i = 0; i < n.children.size(); ++i) {
+            const LiteralInfo child = literalInfo(n.children.at(i));
+            if (i == 0) {
+                info = child;
+                info.required.clear();
+                continue;
+            }
+            info.exact = info.exact && child.exact && info.str == child.str;
+            int common = 0;
+            while (common < info.prefix.length() && common < child.prefix.length() && info.prefix.at(common) == child.prefix.at(common))
+                ++common;
+            info.prefix.truncate(common);
+            common = 0;
+            while (common < info.suffix.length() && common < child.suffix.length()
+                   && info.suffix.at(info.suffix.length() - 1 - common) == child.suffix.at(child.suffix.length() - 1 - common))
+                ++common;
+            info.suffix = info.suffix.right(common);
+        }
+        if (!info.exact)
+            info.str.clear();
+        return info;
+    }
+    case NodeRepeat: {
+        if (n.min == 0)
+            return info;
+        const LiteralInfo child = literalInfo(n.children.first());
+        if (child.exact && n.min == n.max && child.str.length() * n.min <= 256) {
+            info.exact = true;
+            info.str = child.str.repeated(n.min);
+            info.prefix = info.str;
+            info.suffix = info.str;
+            return info;
+        }
+        info.prefix = child.prefix;
+        info.suffix = child.suffix;
+        info.required = child.required;
+        return info;
+    }
+    }
+    return info;
+}
+
+/**
+ * @brief LogRegex::join 连接两个子表达式:前一个的后缀和后一个的前缀在每个匹配中都连在一起出现
+ */
+LogRegex::LiteralInfo LogRegex::join(const LiteralInfo &a, const LiteralInfo &b)
+{
+    LiteralInfo info;
+    info.required = a.required + b.required;
+    if (a.exact && b.exact) {
+        info.exact = true;
+        info.str = a.str + b.str;
+        info.prefix = info.str;
+        info.suffix = info.str;
+        return info;
+    }
+    info.prefix = a.exact ? a.str + b.prefix : a.prefix;
+    info.suffix = b.exact ? a.suffix + b.str : b.suffix;
+    info.required.append(a.suffix + b.prefix);
+    return info;
+}
+
+bool LogRegex::anchoredAtBegin(int node) const
+{
+    const Node &n = m_nodes.at(node);
+    switch (n.type) {
+    case NodeBegin:
+        return true;
+    case NodeConcat:
+        return !n.children.isEmpty() && anchoredAtBegin(n.children.first());
+    case NodeAlternate:
+        for (int child : n.children) {
+            if (!anchoredAtBegin(child))
+                return false;
+        }
+        return true;
+    default:
+        return false;
+    }
+}
+
+/**
+ * @brief LogRegex::finishClass 预先算好字符集在ASCII范围内的位图
+ */
+void LogRegex::finishClass(CharClass &cls) const
+{
+    for (ushort ch = 0; ch < 128; ++ch) {
+        if (inClass(cls, ch))
+            cls.ascii[ch >> 6] |= Q_UINT64_C(1) << (ch & 63);
+    }
+}
+
+bool LogRegex::classContains(const CharClass &cls, ushort ch) const
+{
+    for (const auto &range : cls.ranges) {
+        if (ch >= range.first && ch <= range.second)
+            return true;
+    }
+    if (!cls.builtins)
+        return false;
+    const QChar c(ch);
+    const bool digit = ch >= '0' && ch <= '9';
+    const bool word = c.isLetterOrNumber() || ch == '_';
+    const bool space = c.isSpace();
+    return ((cls.builtins & Digit) && digit) || ((cls.builtins & NotDigit) && !digit)
+           || ((cls.builtins & Word) && word) || ((cls.builtins & NotWord) && !word)
+           || ((cls.builtins & Space) && space) || ((cls.builtins & NotSpace) && !space);
+}
+
+bool LogRegex::inClass(const CharClass &cls, ushort ch) const
+{
+    bool contains = classContains(cls, ch);
+    if (!contains && m_cs == Qt::CaseInsensitive) {
+        const QChar c(ch);
+        contains = classContains(cls, c.toLower().unicode()) || classContains(cls, c.toUpper().unicode())
+                   || classContains(cls, QChar::toCaseFolded(ch));
+    }
+    return cls.negated ? !contains : contains;
+}
+
+bool LogRegex::matchChar(const Inst &inst, ushort ch) const
+{
+    switch (inst.op) {
+    case OpChar:
+        return inst.ch == (m_cs == Qt::CaseInsensitive ? QChar::toCaseFolded(ch) : ch);
+    case OpClass: {
+        if (ch < 128)
+            return m_classes.at(inst.x).ascii[ch >> 6] & (Q_UINT64_C(1) << (ch & 63));
+        return inClass(m_classes.at(inst.x), ch);
+    }
+    case OpAny:
+        return ch != '\n';
+    default:
+        return false;
+    }
+}
+
+bool LogRegex::isWordChar(const QString &text, int pos)
+{
+    if (pos < 0 || pos >= text.length())
+        return false;
+    const QChar c = text.at(pos);
+    return c.isLetterOrNumber() || c == QLatin1Char('_');
+}
@@ -0,0 +1,160 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGREGEX_H
+#define LOGREGEX_H
+
+#include "logcasematcher.h"
+
+#include <QPair>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+//编译后程序的最大指令数,{m,n}展开过大的表达式直接报错
+#define LOG_REGEX_MAX_PROGRAM 20000
+//{m,n}中允许的最大重复次数
+#define LOG_REGEX_MAX_REPEAT 1000
+//参与预筛选的必需字面量最多个数,越长的越先检查
+#define LOG_REGEX_MAX_LITERALS 4
+
+/**
+ * @brief The LogRegex class 日志搜索用的正则表达式,编译一次后在多个线程中只读使用
+ * 表达式先编译为Thompson NFA程序,匹配用Pike VM同时推进所有状态,时间和文本长度成线性,
+ * 不会像回溯引擎那样被(a+)+这类表达式拖住搜索线程;不支持反向引用和环视。
+ * 编译时从表达式中提取每个匹配都必须包含的字面量:匹配前先用LogCaseMatcher确认它们都在文本中,
+ * 也交给三元组索引缩小候选记录;所有匹配共同的前缀用来跳过不可能开始匹配的位置
+ * 支持的语法:字面字符、.、[...]和[^...]、\d \w \s \D \W \S \b \B、^、$、(...)、(?:...)、|、* + ? {m} {m,} {m,n}及其非贪婪形式
+ */
+class LogRegex
+{
+public:
+    explicit LogRegex(const QString &pattern, Qt::CaseSensitivity cs = Qt::CaseInsensitive);
+
+    bool isValid() const { return m_error.isEmpty(); }
+    QString errorString() const { return m_error; }
+    QString pattern() const { return m_pattern; }
+    QStringList literals() const { return m_literals; }
+    QString prefix() const { return m_prefix.pattern(); }
+    int programSize() const { return m_program.size(); }
+
+    int indexIn(const QString &text, int from = 0, int *length = nullptr) const;
+    bool matches(const QString &text) const;
+
+private:
+    enum NodeType {
+        NodeEmpty,
+        NodeChar,
+        NodeClass,
+        NodeAny,
+        NodeBegin,
+        NodeEnd,
+        NodeWordBoundary,
+        NodeNotWordBoundary,
+        NodeConcat,
+        NodeAlternate,
+        NodeRepeat
+    };
+    struct Node {
+        NodeType type;
+        ushort ch;
+        int cls;
+        QVector<int> children;
+        int min;
+        int max;
+        bool greedy;
+    };
+    /**
+     * @brief The CharClass struct 字符集,ASCII部分预先算好位图,其余字符按区间判断
+     */
+    struct CharClass {
+        QVector<QPair<ushort, ushort>> ranges;
+        //\d \w \s及其取反形式,BuiltinClass的组合
+        int builtins = 0;
+        bool negated = false;
+        quint64 ascii[2] = {0, 0};
+    };
+    /**
+     * @brief The LiteralInfo struct 一个子表达式的字面量信息,用于提取预筛选字面量
+     */
+    struct LiteralInfo {
+        //子表达式只能匹配str
+        bool exact = false;
+        QString str;
+        //每个匹配都以prefix开头、以suffix结尾
+        QString prefix;
+        QString suffix;
+        //每个匹配都包含的字面量
+        QStringList required;
+    };
+    enum BuiltinClass {
+        Digit = 0x01,
+        NotDigit = 0x02,
+        Word = 0x04,
+        NotWord = 0x08,
+        Space = 0x10,
+        NotSpace = 0x20
+    };
+    enum Op {
+        OpChar,
+        OpClass,
+        OpAny,
+        OpSplit,
+        OpJmp,
+        OpBegin,
+        OpEnd,
+        OpWordBoundary,
+        OpNotWordBoundary,
+        OpMatch
+    };
+    struct Inst {
+        Op op;
+        ushort ch;
+        //OpClass时为字符集下标,OpSplit/OpJmp时为跳转目标,OpSplit优先走x
+        int x;
+        int y;
+    };
+
+    //语法分析
+    int parseAlternate();
+    int parseConcat();
+    int parseRepeat();
+    int parseAtom();
+    int parseClass();
+    bool parseEscape(CharClass &cls, int &ch);
+    bool parseCount(int &value);
+    int addNode(NodeType type, ushort ch = 0, int cls = -1);
+    void fail(const QString &error);
+    bool atEnd() const { return m_pos >= m_pattern.length(); }
+
+    //编译和字面量提取
+    bool compileNode(int node);
+    int emitInst(Op op, ushort ch = 0, int x = -1, int y = -1);
+    LiteralInfo literalInfo(int node) const;
+    static LiteralInfo join(const LiteralInfo &a, const LiteralInfo &b);
+    bool anchoredAtBegin(int node) const;
+    void finishClass(CharClass &cls) const;
+    bool classContains(const CharClass &cls, ushort ch) const;
+    bool inClass(const CharClass &cls, ushort ch) const;
+    bool matchChar(const Inst &inst, ushort ch) const;
+    static bool isWordChar(const QString &text, int pos);
+    int search(const QString &text, int from, int *length, bool anyMatch) const;
+
+    QString m_pattern;
+    Qt::CaseSensitivity m_cs;
+    QString m_error;
+    int m_pos = 0;
+    QVector<Node> m_nodes;
+    QVector<CharClass> m_classes;
+    QVector<Inst> m_program;
+    QStringList m_literals;
+    //每个匹配都必须包含的字面量,匹配前先确认
+    QVector<LogCaseMatcher> m_required;
+    //所有匹配共同的前缀,为空时逐个位置尝试
+    LogCaseMatcher m_prefix;
+    //只能在文本开头匹配
+    bool m_anchored = false;
+};
+
+#endif // LOGREGEX_H
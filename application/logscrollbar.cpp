@@ -3,7 +3,13 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "logscrollbar.h"
+#include "logtablemodel.h"
 
+#include <QAbstractItemModel>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QStyle>
+#include <QStyleOptionSlider>
 
 LogScrollBar::LogScrollBar(QWidget *parent)
     : QScrollBar(parent)
@@ -17,8 +23,183 @@ LogScrollBar::LogScrollBar(Qt::Orientation o, QWidget *parent)
 
 }
 
+/**
+ * @brief LogScrollBar::setMinimapModel 在滚动条上显示model各行记录的时间密度和搜索命中的缩略图
+ * 行在末尾追加时只取新增行的时间,其他变化在下次绘制时重新取
+ * @param timeColumn 返回当前带时间的列,列定义在LogTableModel::SortKeyRole下返回时间的排序键
+ */
+void LogScrollBar::setMinimapModel(QAbstractItemModel *model, const std::function<int()> &timeColumn)
+{
+    if (m_model)
+        disconnect(m_model, nullptr, this, nullptr);
+    m_model = model;
+    m_timeColumn = timeColumn;
+    m_hitRows.clear();
+    invalidateMinimap(true);
+    if (!model)
+        return;
+    connect(model, &QAbstractItemModel::rowsInserted, this, [this](const QModelIndex &parent, int first) {
+        //追加到末尾时等到绘制时再补齐,中间插入要重新取
+        if (!parent.isValid() && first < m_minimap.rowCount())
+            invalidateMinimap(true);
+        else
+            invalidateMinimap(false);
+    });
+    connect(model, &QAbstractItemModel::rowsRemoved, this, [this]() { invalidateMinimap(true); });
+    connect(model, &QAbstractItemModel::modelReset, this, [this]() { invalidateMinimap(true); });
+    connect(model, &QAbstractItemModel::layoutChanged, this, [this]() { invalidateMinimap(true); });
+}
+
+/**
+ * @brief LogScrollBar::setMinimapHits 替换命中的行
+ * @param rows 表格中的行号
+ */
+void LogScrollBar::setMinimapHits(const QVector<int> &rows)
+{
+    m_hitRows = rows;
+    m_minimap.clearHits();
+    m_minimap.addHits(rows);
+    invalidateMinimap(false);
+}
+
+/**
+ * @brief LogScrollBar::addMinimapHits 追加一批命中的行
+ */
+void LogScrollBar::addMinimapHits(const QVector<int> &rows)
+{
+    m_hitRows += rows;
+    m_minimap.addHits(rows);
+    invalidateMinimap(false);
+}
+
+/**
+ * @brief LogScrollBar::mousePressEvent 有缩略图时点击槽内直接跳到对应位置,便于定位密集处和命中处
+ */
 void LogScrollBar::mousePressEvent(QMouseEvent *event)
 {
     m_isOnPress = true;
+    if (m_minimap.rowCount() > 0 && event->button() == Qt::LeftButton) {
+        QStyleOptionSlider opt;
+        initStyleOption(&opt);
+        const QStyle::SubControl control = style()->hitTestComplexControl(QStyle::CC_ScrollBar, &opt, event->pos(), this);
+        if (control == QStyle::SC_ScrollBarAddPage || control == QStyle::SC_ScrollBarSubPage) {
+            const QRect groove = style()->subControlRect(QStyle::CC_ScrollBar, &opt, QStyle::SC_ScrollBarGroove, this);
+            const bool vertical = orientation() == Qt::Vertical;
+            const int pos = vertical ? event->pos().y() - groove.top() : event->pos().x() - groove.left();
+            const int span = vertical ? groove.height() : groove.width();
+            setValue(QStyle::sliderValueFromPosition(minimum(), maximum(), pos, span, opt.upsideDown));
+            event->accept();
+            return;
+        }
+    }
     QScrollBar::mousePressEvent(event);
 }
+
+void LogScrollBar::paintEvent(QPaintEvent *event)
+{
+    QScrollBar::paintEvent(event);
+    if (!m_model)
+        return;
+    if (m_minimapDirty)
+        renderMinimap();
+    if (m_minimapCache.isNull())
+        return;
+    QPainter painter(this);
+    painter.drawPixmap(minimapRect().topLeft(), m_minimapCache);
+}
+
+void LogScrollBar::resizeEvent(QResizeEvent *event)
+{
+    QScrollBar::resizeEvent(event);
+    invalidateMinimap(false);
+}
+
+void LogScrollBar::invalidateMinimap(bool rebuild)
+{
+    m_minimapRebuild = m_minimapRebuild || rebuild;
+    m_minimapDirty = true;
+    update();
+}
+
+/**
+ * @brief LogScrollBar::syncMinimap 从model取还没有统计的行的时间
+ */
+void LogScrollBar::syncMinimap()
+{
+    if (m_minimapRebuild) {
+        m_minimap.clear();
+        m_minimapRebuild = false;
+    }
+    //没有时间列的类别只显示命中的位置
+    const int column = m_timeColumn ? m_timeColumn() : -1;
+    const int before = m_minimap.rowCount();
+    const int count = m_model->rowCount();
+    for (int row = before; row < count;) {
+        const int end = qMin(count, row + LOG_MINIMAP_READ_BATCH);
+        QVector<qint64> times;
+        times.reserve(end - row);
+        for (; row < end; ++row) {
+            const QVariant key = column < 0 ? QVariant() : m_model->data(m_model->index(row, column), LogTableModel::SortKeyRole);
+            times.append(key.type() == QVariant::LongLong ? LogMinimap::keyTime(key.toLongLong()) : -1);
+        }
+        m_minimap.appendTimes(times);
+    }
+    //新增的行中可能有之前已记下的命中
+    if (before == 0) {
+        m_minimap.addHits(m_hitRows);
+    } else if (m_minimap.rowCount() > before) {
+        QVector<int> added;
+        for (int row : m_hitRows) {
+            if (row >= before)
+                added.append(row);
+        }
+        m_minimap.addHits(added);
+    }
+}
+
+/**
+ * @brief LogScrollBar::renderMinimap 数据变化后重新生成缩略图,之后的绘制直接使用缓存
+ * 密度越高颜色越深,命中的位置画一条高亮色的横线
+ */
+void LogScrollBar::renderMinimap()
+{
+    m_minimapDirty = false;
+    syncMinimap();
+    const QRect rect = minimapRect();
+    if (m_minimap.rowCount() == 0 || rect.isEmpty()) {
+        m_minimapCache = QPixmap();
+        return;
+    }
+    const bool vertical = orientation() == Qt::Vertical;
+    const int length = vertical ? rect.height() : rect.width();
+    const QVector<float> density = m_minimap.density(length);
+    const QVector<int> hits = m_minimap.hits(length);
+
+    m_minimapCache = QPixmap(rect.size());
+    m_minimapCache.fill(Qt::transparent);
+    QPainter painter(&m_minimapCache);
+    QColor densityColor = palette().color(QPalette::Text);
+    const QColor hitColor = palette().color(QPalette::Highlight);
+    for (int i = 0; i < length; ++i) {
+        const QRect cell = vertical ? QRect(0, i, rect.width(), 1) : QRect(i, 0, 1, rect.height());
+        if (density.at(i) > 0.0f) {
+            densityColor.setAlphaF(0.6 * density.at(i));
+            painter.fillRect(cell, densityColor);
+        }
+        if (hits.at(i) > 0)
+            painter.fillRect(cell, hitColor);
+    }
+}
+
+/**
+ * @brief LogScrollBar::minimapRect 缩略图所在的区域,槽内靠右(水平滚动条靠下)的一条
+ */
+QRect LogScrollBar::minimapRect() const
+{
+    QStyleOptionSlider opt;
+    initStyleOption(&opt);
+    const QRect groove = style()->subControlRect(QStyle::CC_ScrollBar, &opt, QStyle::SC_ScrollBarGroove, this);
+    if (orientation() == Qt::Vertical)
+        return QRect(groove.right() - LOG_MINIMAP_WIDTH + 1, groove.top(), LOG_MINIMAP_WIDTH, groove.height());
+    return QRect(groove.left(), groove.bottom() - LOG_MINIMAP_WIDTH + 1, groove.width(), LOG_MINIMAP_WIDTH);
+}
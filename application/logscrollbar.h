@@ -5,18 +5,56 @@
 #ifndef LOGSCROLLBAR_H
 #define LOGSCROLLBAR_H
 
+#include "logminimap.h"
+
+#include <QPixmap>
+#include <QPointer>
 #include <QScrollBar>
+
+#include <functional>
+
+class QAbstractItemModel;
+
+//缩略图的宽度,画在滚动条的槽内靠右一侧
+#define LOG_MINIMAP_WIDTH 4
+//每次从model取时间的最多行数,追加的行较多时分批取,避免长时间不响应
+#define LOG_MINIMAP_READ_BATCH 65536
+
 class LogScrollBar : public QScrollBar
 {
 public:
 public:
     explicit LogScrollBar(QWidget *parent = nullptr);
     explicit LogScrollBar(Qt::Orientation o, QWidget *parent = nullptr);
+
+    void setMinimapModel(QAbstractItemModel *model, const std::function<int()> &timeColumn);
+    void setMinimapHits(const QVector<int> &rows);
+    void addMinimapHits(const QVector<int> &rows);
+    const LogMinimap &minimap() const { return m_minimap; }
+
 protected:
     void mousePressEvent(QMouseEvent *event) Q_DECL_OVERRIDE;
+    void paintEvent(QPaintEvent *event) Q_DECL_OVERRIDE;
+    void resizeEvent(QResizeEvent *event) Q_DECL_OVERRIDE;
+
 private:
-    bool m_isOnPress = false;
+    void invalidateMinimap(bool rebuild);
+    void syncMinimap();
+    void renderMinimap();
+    QRect minimapRect() const;
 
+    bool m_isOnPress = false;
+    QPointer<QAbstractItemModel> m_model;
+    //当前表格中带时间的列,没有时为-1
+    std::function<int()> m_timeColumn;
+    LogMinimap m_minimap;
+    //命中的行,重建时重新计入
+    QVector<int> m_hitRows;
+    //行被插入到中间、删除或重排后需要从头重新取时间
+    bool m_minimapRebuild = false;
+    //数据变化后缓存的图像在下次绘制时重新生成
+    bool m_minimapDirty = true;
+    QPixmap m_minimapCache;
 };
 
 #endif // LOGSCROLLBAR_H
@@ -0,0 +1,104 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logsearchhits.h"
+
+#include <algorithm>
+#include <climits>
+
+bool LogSearchHits::isEmpty() const
+{
+    return m_rows.isEmpty();
+}
+
+int LogSearchHits::rowCount() const
+{
+    return m_rows.size();
+}
+
+int LogSearchHits::spanCount() const
+{
+    return m_spans.size();
+}
+
+/**
+ * @brief LogSearchHits::markText 记下关键字在text中的所有位置,命中互不重叠
+ * @param row 记录下标,需要不小于已记录的下标
+ * @param column 显示text的列
+ * @param text 单元格的显示文字
+ * @param matcher 关键字
+ */
+void LogSearchHits::markText(int row, int column, const QString &text, const LogRecordFilter::TextMatcher &matcher)
+{
+    if (matcher.isEmpty())
+        return;
+    int count = 0;
+    int length = 0;
+    //正则的空匹配不高亮,从下一个字符继续查找
+    for (int pos = matcher.indexIn(text, 0, &length); pos >= 0 && count < SEARCH_HITS_PER_CELL;
+            pos = matcher.indexIn(text, pos + qMax(1, length), &length)) {
+        if (length <= 0 || length > SHRT_MAX)
+            continue;
+        addSpan(row, column, pos, length);
+        ++count;
+    }
+}
+
+void LogSearchHits::addSpan(int row, int column, int offset, int length)
+{
+    if (m_rows.isEmpty() || m_rows.last() != row) {
+        m_rows.append(row);
+        m_ends.append(m_spans.size());
+    }
+    m_spans.append({offset, static_cast<qint16>(column), static_cast<qint16>(length)});
+    m_ends.last() = m_spans.size();
+}
+
+/**
+ * @brief LogSearchHits::append 追加后一批的结果,other中的下标需要都比已记录的大
+ */
+void LogSearchHits::append(const LogSearchHits &other)
+{
+    if (other.isEmpty())
+        return;
+    if (isEmpty()) {
+        *this = other;
+        return;
+    }
+    const int base = m_spans.size();
+    m_rows += other.m_rows;
+    m_ends.reserve(m_ends.size() + other.m_ends.size());
+    for (int end : other.m_ends)
+        m_ends.append(base + end);
+    m_spans += other.m_spans;
+}
+
+void LogSearchHits::clear()
+{
+    m_rows.clear();
+    m_ends.clear();
+    m_spans.clear();
+}
+
+/**
+ * @brief LogSearchHits::find 某个单元格中的命中
+ * @param row 记录下标
+ * @param column 列
+ * @return 依次为每处命中的位置和长度,没有命中时为空
+ */
+QVector<int> LogSearchHits::find(int row, int column) const
+{
+    QVector<int> result;
+    auto it = std::lower_bound(m_rows.constBegin(), m_rows.constEnd(), row);
+    if (it == m_rows.constEnd() || *it != row)
+        return result;
+    const int i = static_cast<int>(it - m_rows.constBegin());
+    const int begin = i == 0 ? 0 : m_ends.at(i - 1);
+    for (int s = begin; s < m_ends.at(i); ++s) {
+        const LogSearchSpan &span = m_spans.at(s);
+        if (span.column == column)
+            result << span.offset << span.length;
+    }
+    return result;
+}
@@ -0,0 +1,94 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGSEARCHHITS_H
+#define LOGSEARCHHITS_H
+
+#include "logrecordfilter.h"
+
+#include <QMetaType>
+#include <QVector>
+
+//每个单元格最多记录的命中数,超出的部分不高亮
+#define SEARCH_HITS_PER_CELL 64
+//高亮关键字背景的不透明度
+#define SEARCH_HIT_ALPHA 90
+
+/**
+ * @brief The LogSearchSpan struct 一处关键字命中,offset为在单元格显示文字中的下标
+ */
+struct LogSearchSpan {
+    qint32 offset;
+    qint16 column;
+    qint16 length;
+};
+
+/**
+ * @brief The LogSearchField struct 参与高亮的一列,取记录中的字段,或者由记录的成员函数截取出显示文字
+ */
+template <typename T>
+struct LogSearchField {
+    LogSearchField() = default;
+    LogSearchField(int column, QString T::*field)
+        : column(column), field(field) {}
+    LogSearchField(int column, QString (T::*text)() const)
+        : column(column), text(text) {}
+
+    QString textOf(const T &record) const { return field ? record.*field : (record.*text)(); }
+
+    int column = 0;
+    QString T::*field = nullptr;
+    QString (T::*text)() const = nullptr;
+};
+
+/**
+ * @brief The LogSearchHits class 搜索时记下的关键字位置,供绘制时高亮
+ * 按记录在存储中的下标从小到大保存,每条记录的命中连续存放在一个数组中,只用两个下标数组定位,
+ * 没有命中的记录不占空间;绘制时按下标二分查找,不再重新匹配文字
+ */
+class LogSearchHits
+{
+public:
+    /**
+     * @brief Fields 参与高亮的列和对应的记录字段,字段内容必须和该列的显示文字一致
+     */
+    template <typename T>
+    using Fields = QVector<LogSearchField<T>>;
+
+    bool isEmpty() const;
+    int rowCount() const;
+    int spanCount() const;
+
+    void markText(int row, int column, const QString &text, const LogRecordFilter::TextMatcher &matcher);
+    template <typename T>
+    void markRecord(int row, const T &record, const Fields<T> &fields, const LogRecordFilter::TextMatcher &matcher);
+    void append(const LogSearchHits &other);
+    void clear();
+
+    QVector<int> find(int row, int column) const;
+
+private:
+    void addSpan(int row, int column, int offset, int length);
+
+    //有命中的记录下标,从小到大
+    QVector<int> m_rows;
+    //m_rows中每条记录最后一个命中之后的位置,前一条的结束即这一条的开始
+    QVector<int> m_ends;
+    QVector<LogSearchSpan> m_spans;
+};
+
+Q_DECLARE_METATYPE(LogSearchHits)
+
+/**
+ * @brief LogSearchHits::markRecord 在记录的各个显示字段中查找关键字并记下位置
+ * @param row 记录下标,需要比已记录的下标大
+ */
+template <typename T>
+void LogSearchHits::markRecord(int row, const T &record, const Fields<T> &fields, const LogRecordFilter::TextMatcher &matcher)
+{
+    for (const auto &field : fields)
+        markText(row, field.column, field.textOf(record), matcher);
+}
+
+#endif // LOGSEARCHHITS_H
@@ -0,0 +1,105 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logsearchwork.h"
+
+#include <QElapsedTimer>
+#include <QLoggingCategory>
+
+#ifdef QT_DEBUG
+Q_LOGGING_CATEGORY(logSearchWork, "org.deepin.log.viewer.search.work")
+#else
+Q_LOGGING_CATEGORY(logSearchWork, "org.deepin.log.viewer.search.work", QtInfoMsg)
+#endif
+
+//攒够这么多条匹配或距上次发出超过这么长时间(毫秒)就发出一批,保证第一批结果尽快显示
+#define SEARCH_BATCH_COUNT 1000
+#define SEARCH_BATCH_INTERVAL 100
+
+int LogSearchWork::thread_index = 0;
+
+/**
+ * @brief LogSearchWork::LogSearchWork 构造函数
+ * @param count 被搜索的记录数
+ * @param match 匹配函数
+ * @param canRun 本次搜索的取消标记
+ * @param parent 父对象
+ */
+LogSearchWork::LogSearchWork(int count, const Matcher &match, const std::shared_ptr<std::atomic_bool> &canRun,
+                             QObject *parent)
+    : QObject(parent)
+    , QRunnable()
+    , m_count(count)
+    , m_match(match)
+    , m_canRun(canRun)
+{
+    qRegisterMetaType<QVector<int>>("QVector<int>");
+    qRegisterMetaType<LogSearchHits>("LogSearchHits");
+    //使用线程池启动该线程，跑完自己删自己
+    setAutoDelete(true);
+    thread_index++;
+    m_threadIndex = thread_index;
+}
+
+LogSearchWork::~LogSearchWork()
+{
+}
+
+/**
+ * @brief LogSearchWork::setCandidates 只扫描给定的下标,不设置时扫描全部记录
+ * @param rows 从小到大的下标
+ */
+void LogSearchWork::setCandidates(const QVector<int> &rows)
+{
+    m_candidates = rows;
+    m_hasCandidates = true;
+}
+
+/**
+ * @brief LogSearchWork::setMarker 匹配后顺便记下关键字位置,只对匹配的记录调用,绘制时不必重新匹配
+ */
+void LogSearchWork::setMarker(const Marker &mark)
+{
+    m_mark = mark;
+}
+
+/**
+ * @brief LogSearchWork::run 从前往后扫描,按批发出匹配的下标
+ */
+void LogSearchWork::run()
+{
+    const int count = m_hasCandidates ? m_candidates.size() : m_count;
+    QVector<int> rows;
+    LogSearchHits hits;
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < count; ++i) {
+        if (!*m_canRun) {
+            qCDebug(logSearchWork) << "search" << m_threadIndex << "canceled at" << i;
+            return;
+        }
+        const int row = m_hasCandidates ? m_candidates.at(i) : i;
+        if (m_match(row)) {
+            rows.append(row);
+            if (m_mark)
+                m_mark(row, hits);
+        }
+        if (!rows.isEmpty() && (rows.size() >= SEARCH_BATCH_COUNT || timer.elapsed() >= SEARCH_BATCH_INTERVAL)) {
+            emit searchData(m_threadIndex, rows, i + 1, hits);
+            rows.clear();
+            hits.clear();
+            timer.restart();
+        }
+    }
+    if (!*m_canRun)
+        return;
+    if (!rows.isEmpty())
+        emit searchData(m_threadIndex, rows, count, hits);
+    emit searchFinished(m_threadIndex);
+}
+
+int LogSearchWork::getIndex()
+{
+    return m_threadIndex;
+}
@@ -0,0 +1,84 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGSEARCHWORK_H
+#define LOGSEARCHWORK_H
+
+#include "logsearchhits.h"
+
+#include <QObject>
+#include <QRunnable>
+#include <QVector>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+
+/**
+ * @brief The LogSearchWork class 在线程池中按关键字扫描已加载的日志,分批发出匹配记录的下标
+ * 每次搜索使用独立的取消标记,新的搜索把上一次的标记置false,正在扫描的线程随即退出
+ */
+class LogSearchWork : public QObject, public QRunnable
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Matcher 判断第row条记录是否匹配,在工作线程中调用,只能访问按值捕获的数据
+     */
+    using Matcher = std::function<bool(int row)>;
+    /**
+     * @brief Marker 在匹配的第row条记录中记下关键字位置,同样在工作线程中调用
+     */
+    using Marker = std::function<void(int row, LogSearchHits &hits)>;
+
+    LogSearchWork(int count, const Matcher &match, const std::shared_ptr<std::atomic_bool> &canRun,
+                  QObject *parent = nullptr);
+    ~LogSearchWork();
+
+    void setCandidates(const QVector<int> &rows);
+    void setMarker(const Marker &mark);
+    void run() override;
+    int getIndex();
+
+signals:
+    /**
+     * @brief searchData 一批匹配的记录
+     * @param index 当前线程的数字标号
+     * @param rows 匹配记录在被搜索列表中的下标,从小到大
+     * @param scanned 到这一批为止已扫描的记录(或候选下标)个数
+     * @param hits 这一批记录中关键字的位置,没有设置Marker时为空
+     */
+    void searchData(int index, QVector<int> rows, int scanned, LogSearchHits hits);
+    /**
+     * @brief searchFinished 扫描完成,被取消时不发出
+     */
+    void searchFinished(int index);
+
+public:
+    /**
+     * @brief thread_index 静态成员变量，用来每次构造时标记新的当前线程对象 m_threadIndex
+     */
+    static int thread_index;
+
+private:
+    int m_count;
+    Matcher m_match;
+    Marker m_mark;
+    /**
+     * @brief m_candidates 只扫描这些下标,用于在上一次的搜索结果中继续搜索
+     */
+    QVector<int> m_candidates;
+    bool m_hasCandidates {false};
+    /**
+     * @brief m_canRun 本次搜索的取消标记,和发起方共享
+     */
+    std::shared_ptr<std::atomic_bool> m_canRun;
+    /**
+     * @brief m_threadIndex 当前线程标号
+     */
+    int m_threadIndex;
+};
+
+#endif // LOGSEARCHWORK_H
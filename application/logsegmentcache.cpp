@@ -0,0 +1,432 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logsegmentcache.h"
+#include "logrecordbatch.h"
+#include "loggzipinflater.h"
+#include "logingestmetrics.h"
+#include "utils.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QLoggingCategory>
+
+#include <string.h>
+#include <sys/stat.h>
+#include <utime.h>
+
+#ifdef QT_DEBUG
+Q_LOGGING_CATEGORY(logSegment, "org.deepin.log.viewer.segment")
+#else
+Q_LOGGING_CATEGORY(logSegment, "org.deepin.log.viewer.segment", QtInfoMsg)
+#endif
+
+//段文件的标识"LVSG"
+#define LOG_SEGMENT_MAGIC 0x4753564c
+//块表中每一项的字节数
+#define BLOCK_ENTRY_SIZE static_cast<qint64>(sizeof(Block) + LOG_BLOOM_BYTES)
+
+namespace {
+QByteArray headHash(const char *data, qint64 size)
+{
+    return QCryptographicHash::hash(QByteArray::fromRawData(data, static_cast<int>(qMin<qint64>(size, LOG_SEGMENT_HEAD_SIZE))),
+                                    QCryptographicHash::Sha1);
+}
+}
+
+/**
+ * @brief LogSegmentCache::LogSegmentCache 构造函数
+ * @param filePath 日志文件路径
+ * @param format 记录格式,见LogRecordBatch::Format
+ */
+LogSegmentCache::LogSegmentCache(const QString &filePath, int format)
+    : m_filePath(filePath)
+    , m_format(format)
+{
+}
+
+LogSegmentCache::~LogSegmentCache()
+{
+    abortWrite();
+    close();
+}
+
+/**
+ * @brief LogSegmentCache::open 映射日志文件对应的段文件并检查描述信息
+ * 压缩日志大小和修改时间都没有变化时段有效;普通文件还需调用matches检查内容开头
+ * @return 是否有可用的段
+ */
+bool LogSegmentCache::open()
+{
+    close();
+    if (!statSource())
+        return false;
+    m_immutable = LogGzipInflater::isGzipFile(m_filePath);
+
+    m_file.setFileName(segmentPath());
+    if (!m_file.open(QIODevice::ReadOnly))
+        return false;
+    const qint64 size = m_file.size();
+    if (size < static_cast<qint64>(sizeof(Footer)) || !(m_map = m_file.map(0, size))) {
+        close();
+        return false;
+    }
+    memcpy(&m_footer, m_map + size - sizeof(Footer), sizeof(Footer));
+    const bool sameSource = m_footer.device == m_device && m_footer.inode == m_inode
+                            && (m_immutable ? m_footer.sourceSize == m_sourceSize && m_footer.sourceMtime == m_sourceMtime
+                                : m_footer.sourceSize <= m_sourceSize);
+    if (m_footer.magic != LOG_SEGMENT_MAGIC || m_footer.version != LOG_SEGMENT_VERSION || m_footer.format != m_format
+            || m_footer.bodySize < 0 || m_footer.blockCount < 0 || m_footer.blockCount > size / BLOCK_ENTRY_SIZE
+            || m_footer.bodySize + m_footer.blockCount * BLOCK_ENTRY_SIZE + static_cast<qint64>(sizeof(Footer)) != size || !sameSource) {
+        qCDebug(logSegment) << "segment is stale:" << m_filePath;
+        discard();
+        return false;
+    }
+    //记录使用时间,长期不用的段由prune删除
+    utime(QFile::encodeName(segmentPath()).constData(), nullptr);
+    m_valid = true;
+    return true;
+}
+
+/**
+ * @brief LogSegmentCache::matches 普通文件的段是否对应当前内容:内容没有变短且开头没有被改写
+ * @param data 日志内容
+ * @param size 内容长度
+ */
+bool LogSegmentCache::matches(const char *data, qint64 size)
+{
+    if (!data)
+        return false;
+    return matches(QByteArray::fromRawData(data, static_cast<int>(qMin<qint64>(size, LOG_SEGMENT_HEAD_SIZE))), size);
+}
+
+/**
+ * @brief LogSegmentCache::matches 同上,只需要内容开头的部分,映射的文件通过LogLineStream::readRange读取
+ * @param head 内容开头的min(size, LOG_SEGMENT_HEAD_SIZE)字节
+ * @param size 内容长度
+ */
+bool LogSegmentCache::matches(const QByteArray &head, qint64 size)
+{
+    if (!m_valid)
+        return false;
+    if (size < m_footer.coveredBytes || m_footer.headSize != qMin<qint64>(size, LOG_SEGMENT_HEAD_SIZE) || head.size() != m_footer.headSize
+            || headHash(head.constData(), head.size()) != QByteArray::fromRawData(m_footer.headHash, sizeof(m_footer.headHash))) {
+        qCDebug(logSegment) << "segment does not match content:" << m_filePath;
+        discard();
+        return false;
+    }
+    return true;
+}
+
+qint64 LogSegmentCache::coveredBytes() const
+{
+    return m_valid ? m_footer.coveredBytes : 0;
+}
+
+qint64 LogSegmentCache::recordCount() const
+{
+    return m_valid ? m_footer.recordCount : 0;
+}
+
+qint64 LogSegmentCache::blockCount() const
+{
+    return m_valid ? m_footer.blockCount : 0;
+}
+
+/**
+ * @brief LogSegmentCache::replay 按保存的顺序(从新到旧)交出段中的记录,时间范围外的记录不解码各列,
+ * 有关键字时跳过布隆过滤器排除的整块记录;交出的记录只是可能匹配,调用者仍需自行筛选
+ * @return 是否全部交出,被停止或段已损坏时返回false
+ */
+bool LogSegmentCache::replay(const std::atomic_bool &canRun, const LogLineFilter &filter, const Handler &handler)
+{
+    m_skippedBlocks = 0;
+    if (!m_valid)
+        return false;
+    const bool timed = filter.timeBegin > 0 && filter.timeEnd > 0;
+    const QVector<quint32> trigrams = LogTrigramBloom::trigrams(filter.keyword);
+    const uchar *table = m_map + m_footer.bodySize;
+    bool corrupted = false;
+    for (qint64 i = 0; i < m_footer.blockCount && !corrupted; ++i) {
+        const uchar *entry = table + i * BLOCK_ENTRY_SIZE;
+        Block block;
+        memcpy(&block, entry, sizeof(Block));
+        qint64 end = m_footer.bodySize;
+        if (i + 1 < m_footer.blockCount)
+            memcpy(&end, entry + BLOCK_ENTRY_SIZE, sizeof(end));
+        if (block.offset < 0 || block.offset > end || end > m_footer.bodySize) {
+            corrupted = true;
+            break;
+        }
+        if (!trigrams.isEmpty() && !LogTrigramBloom::mayContain(entry + sizeof(Block), trigrams)) {
+            ++m_skippedBlocks;
+            continue;
+        }
+        if (!replayBlock(block, end, canRun, timed, filter, handler, corrupted))
+            return false;
+    }
+    if (corrupted) {
+        qCWarning(logSegment) << "segment is corrupted:" << segmentPath();
+        discard();
+        return false;
+    }
+    LogIngestMetrics::addRead(m_footer.bodySize, m_footer.recordCount);
+    return canRun;
+}
+
+/**
+ * @brief LogSegmentCache::replayBlock 交出[block.offset, end)中的记录
+ * @param corrupted 输出参数,记录越界或列数不对时为true
+ * @return 是否继续
+ */
+bool LogSegmentCache::replayBlock(const Block &block, qint64 end, const std::atomic_bool &canRun, bool timed,
+                                  const LogLineFilter &filter, const Handler &handler, bool &corrupted)
+{
+    const int columnCount = LogRecordBatch::columnCountOf(m_format);
+    const uchar *p = m_map + block.offset;
+    const uchar *limit = m_map + end;
+    QStringList columns;
+    for (qint64 i = 0; i < block.rows; ++i) {
+        if (!canRun)
+            return false;
+        qint64 time = 0;
+        if (limit - p < static_cast<qint64>(sizeof(time))) {
+            corrupted = true;
+            return false;
+        }
+        memcpy(&time, p, sizeof(time));
+        p += sizeof(time);
+        const bool skip = timed && time >= 0 && (time < filter.timeBegin || time > filter.timeEnd);
+        columns.clear();
+        for (int c = 0; c < columnCount; ++c) {
+            quint32 length = 0;
+            if (limit - p < static_cast<qint64>(sizeof(length))) {
+                corrupted = true;
+                return false;
+            }
+            memcpy(&length, p, sizeof(length));
+            p += sizeof(length);
+            if (limit - p < static_cast<qint64>(length)) {
+                corrupted = true;
+                return false;
+            }
+            if (!skip)
+                columns.append(QString::fromUtf8(reinterpret_cast<const char *>(p), static_cast<int>(length)));
+            p += length;
+        }
+        if (!skip && !handler(time, columns))
+            return false;
+    }
+    return true;
+}
+
+/**
+ * @brief LogSegmentCache::shouldWrite 本次完整读取后是否写入新段:没有段时文件足够大,已有段时尾部新增得足够多
+ * @param contentSize 当前内容长度
+ */
+bool LogSegmentCache::shouldWrite(qint64 contentSize) const
+{
+    if (contentSize < LOG_SEGMENT_MIN_SIZE)
+        return false;
+    if (!m_valid)
+        return true;
+    const qint64 tail = contentSize - m_footer.coveredBytes;
+    return tail >= qMax<qint64>(LOG_SEGMENT_MIN_TAIL, m_footer.coveredBytes / 8);
+}
+
+/**
+ * @brief LogSegmentCache::beginWrite 开始写入覆盖[0, size)的新段,之后按交出顺序append尾部的记录,
+ * finishWrite时接上旧段的记录
+ * @param data 日志内容
+ * @param size 内容长度,最后一行没有写完(不以换行结尾)时不写入
+ */
+bool LogSegmentCache::beginWrite(const char *data, qint64 size)
+{
+    if (!data || size <= 0) {
+        abortWrite();
+        return false;
+    }
+    return beginWrite(QByteArray::fromRawData(data, static_cast<int>(qMin<qint64>(size, LOG_SEGMENT_HEAD_SIZE))), size,
+                      data[size - 1] == '\n');
+}
+
+/**
+ * @brief LogSegmentCache::beginWrite 同上,只需要内容开头的部分和最后一个字节是否为换行
+ * @param head 内容开头的min(size, LOG_SEGMENT_HEAD_SIZE)字节
+ * @param complete 内容是否以换行结尾
+ */
+bool LogSegmentCache::beginWrite(const QByteArray &head, qint64 size, bool complete)
+{
+    abortWrite();
+    if (size <= 0 || !complete || head.size() != qMin<qint64>(size, LOG_SEGMENT_HEAD_SIZE))
+        return false;
+    if (!m_device && !statSource())
+        return false;
+    if (!QDir().mkpath(segmentDir()))
+        return false;
+    m_writer.reset(new QSaveFile(segmentPath()));
+    if (!m_writer->open(QIODevice::WriteOnly)) {
+        m_writer.reset();
+        return false;
+    }
+    //段中是日志原文,只有当前用户可读
+    m_writer->setPermissions(QFileDevice::ReadOwner | QFileDevice::WriteOwner);
+    m_writeCovered = size;
+    m_writeRecords = 0;
+    m_writeBlocks = 0;
+    m_block = Block();
+    m_bloom.clear();
+    m_blocks.clear();
+    m_writeHead = headHash(head.constData(), head.size());
+    return true;
+}
+
+void LogSegmentCache::append(qint64 time, const QStringList &columns)
+{
+    if (!m_writer)
+        return;
+    if (m_block.rows == 0)
+        m_block.offset = m_writer->pos();
+    m_record.clear();
+    m_record.append(reinterpret_cast<const char *>(&time), sizeof(time));
+    for (const QString &column : columns) {
+        const QByteArray text = column.toUtf8();
+        const quint32 length = static_cast<quint32>(text.size());
+        m_record.append(reinterpret_cast<const char *>(&length), sizeof(length));
+        m_record.append(text);
+        m_bloom.add(column);
+    }
+    m_writer->write(m_record);
+    ++m_writeRecords;
+    if (++m_block.rows == LOG_SEGMENT_BLOCK_ROWS)
+        flushBlock();
+}
+
+/**
+ * @brief LogSegmentCache::flushBlock 把正在写入的块加入块表
+ */
+void LogSegmentCache::flushBlock()
+{
+    if (m_block.rows == 0)
+        return;
+    m_blocks.append(reinterpret_cast<const char *>(&m_block), sizeof(Block));
+    m_blocks.append(m_bloom.bits());
+    ++m_writeBlocks;
+    m_block = Block();
+    m_bloom.clear();
+}
+
+/**
+ * @brief LogSegmentCache::finishWrite 接上旧段的记录,写入描述信息后替换段文件
+ */
+bool LogSegmentCache::finishWrite()
+{
+    if (!m_writer)
+        return false;
+    flushBlock();
+    qint64 bodySize = m_writer->pos();
+    if (m_valid) {
+        //旧段的记录整体接在后面,块表中的位置随之后移
+        m_writer->write(reinterpret_cast<const char *>(m_map), m_footer.bodySize);
+        const qint64 shift = bodySize;
+        bodySize += m_footer.bodySize;
+        m_writeRecords += m_footer.recordCount;
+        QByteArray blocks(reinterpret_cast<const char *>(m_map + m_footer.bodySize),
+                          static_cast<int>(m_footer.blockCount * BLOCK_ENTRY_SIZE));
+        for (qint64 i = 0; i < m_footer.blockCount; ++i) {
+            char *entry = blocks.data() + i * BLOCK_ENTRY_SIZE;
+            qint64 offset = 0;
+            memcpy(&offset, entry, sizeof(offset));
+            offset += shift;
+            memcpy(entry, &offset, sizeof(offset));
+        }
+        m_blocks.append(blocks);
+        m_writeBlocks += m_footer.blockCount;
+    }
+    m_writer->write(m_blocks);
+    Footer footer;
+    footer.magic = LOG_SEGMENT_MAGIC;
+    footer.version = LOG_SEGMENT_VERSION;
+    footer.format = m_format;
+    footer.headSize = static_cast<quint32>(qMin<qint64>(m_writeCovered, LOG_SEGMENT_HEAD_SIZE));
+    footer.device = m_device;
+    footer.inode = m_inode;
+    footer.sourceSize = m_sourceSize;
+    footer.sourceMtime = m_sourceMtime;
+    footer.coveredBytes = m_writeCovered;
+    footer.recordCount = m_writeRecords;
+    footer.bodySize = bodySize;
+    footer.blockCount = m_writeBlocks;
+    memcpy(footer.headHash, m_writeHead.constData(), qMin<int>(m_writeHead.size(), sizeof(footer.headHash)));
+    m_writer->write(reinterpret_cast<const char *>(&footer), sizeof(footer));
+    const bool ok = m_writer->commit();
+    m_writer.reset();
+    qCDebug(logSegment) << "segment written:" << m_filePath << "records" << m_writeRecords << "ok" << ok;
+    prune();
+    return ok;
+}
+
+void LogSegmentCache::abortWrite()
+{
+    if (m_writer) {
+        m_writer->cancelWriting();
+        m_writer.reset();
+    }
+}
+
+/**
+ * @brief LogSegmentCache::segmentPath 段文件路径,按格式、设备号和inode命名,轮转改名后仍能找到
+ */
+QString LogSegmentCache::segmentPath() const
+{
+    const QByteArray key = QByteArray::number(m_format) + ':' + QByteArray::number(m_device) + ':' + QByteArray::number(m_inode);
+    return segmentDir() + "/" + QString::fromLatin1(QCryptographicHash::hash(key, QCryptographicHash::Sha1).toHex()) + ".seg";
+}
+
+QString LogSegmentCache::segmentDir()
+{
+    return Utils::getAppDataPath() + "/segments";
+}
+
+/**
+ * @brief LogSegmentCache::prune 删除超过LOG_SEGMENT_MAX_AGE_DAYS天没有使用的段,如已被删除的轮转日志对应的段
+ */
+void LogSegmentCache::prune()
+{
+    const QDateTime expired = QDateTime::currentDateTime().addDays(-LOG_SEGMENT_MAX_AGE_DAYS);
+    const QFileInfoList segments = QDir(segmentDir()).entryInfoList(QStringList() << "*.seg", QDir::Files);
+    for (const QFileInfo &info : segments) {
+        if (info.lastModified() < expired)
+            QFile::remove(info.filePath());
+    }
+}
+
+bool LogSegmentCache::statSource()
+{
+    struct stat st;
+    if (stat(QFile::encodeName(m_filePath).constData(), &st) != 0)
+        return false;
+    m_device = static_cast<quint64>(st.st_dev);
+    m_inode = static_cast<quint64>(st.st_ino);
+    m_sourceSize = st.st_size;
+    m_sourceMtime = static_cast<qint64>(st.st_mtime);
+    return true;
+}
+
+void LogSegmentCache::close()
+{
+    m_valid = false;
+    if (m_map) {
+        m_file.unmap(const_cast<uchar *>(m_map));
+        m_map = nullptr;
+    }
+    m_file.close();
+}
+
+void LogSegmentCache::discard()
+{
+    close();
+    QFile::remove(segmentPath());
+}
@@ -0,0 +1,138 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGSEGMENTCACHE_H
+#define LOGSEGMENTCACHE_H
+
+#include "loglinefilter.h"
+#include "logtrigrambloom.h"
+
+#include <QByteArray>
+#include <QFile>
+#include <QSaveFile>
+#include <QScopedPointer>
+#include <QString>
+#include <QStringList>
+
+#include <atomic>
+#include <functional>
+
+//段文件格式的版本,布局变化时递增,版本不一致的段重新生成
+#define LOG_SEGMENT_VERSION 2
+//小于这么大的日志不缓存,解析本身就很快
+#define LOG_SEGMENT_MIN_SIZE (256 * 1024)
+//已有缓存时尾部新增的内容超过这么多字节(且超过已缓存部分的1/8)才重写段文件
+#define LOG_SEGMENT_MIN_TAIL (1024 * 1024)
+//校验文件开头没有被改写时比较的字节数
+#define LOG_SEGMENT_HEAD_SIZE 4096
+//超过这么多天没有使用的段文件在写入新段时删除
+#define LOG_SEGMENT_MAX_AGE_DAYS 30
+//每个记录块的行数,按关键字查询时整块跳过布隆过滤器排除的记录块
+#define LOG_SEGMENT_BLOCK_ROWS 4096
+
+/**
+ * @brief The LogSegmentCache class 解析结果的磁盘缓存,按日志文件的设备号和inode保存在应用数据目录下
+ * 段文件依次存放每条记录的时间和各列文本(从新到旧,和LogRecordReader交出的顺序一致),末尾是描述信息;
+ * 启动时映射段文件直接交出记录,不再解压和分词。轮转的压缩日志不会变化,大小和修改时间不变时整个取自缓存;
+ * 正在写入的日志开头没有被改写时,只解析缓存之后新写入的尾部。
+ * 记录每LOG_SEGMENT_BLOCK_ROWS行为一块,块表中保存每块的位置和三元组布隆过滤器,筛选条件有关键字时跳过不可能匹配的块
+ */
+class LogSegmentCache
+{
+public:
+    typedef std::function<bool(qint64, const QStringList &)> Handler;
+
+    LogSegmentCache(const QString &filePath, int format);
+    ~LogSegmentCache();
+
+    bool open();
+    bool isImmutable() const { return m_immutable; }
+    bool isValid() const { return m_valid; }
+    bool matches(const char *data, qint64 size);
+    bool matches(const QByteArray &head, qint64 size);
+    qint64 coveredBytes() const;
+    qint64 recordCount() const;
+    qint64 blockCount() const;
+    qint64 skippedBlocks() const { return m_skippedBlocks; }
+    bool replay(const std::atomic_bool &canRun, const LogLineFilter &filter, const Handler &handler);
+
+    bool shouldWrite(qint64 contentSize) const;
+    bool beginWrite(const char *data, qint64 size);
+    bool beginWrite(const QByteArray &head, qint64 size, bool complete);
+    void append(qint64 time, const QStringList &columns);
+    bool finishWrite();
+    void abortWrite();
+
+    QString segmentPath() const;
+    static QString segmentDir();
+    static void prune();
+
+private:
+    Q_DISABLE_COPY(LogSegmentCache)
+
+    /**
+     * @brief The Block struct 块表中的一项,其后紧跟LOG_BLOOM_BYTES字节的布隆过滤器
+     */
+    struct Block {
+        //块在段文件中的开始位置
+        qint64 offset = 0;
+        qint64 rows = 0;
+    };
+
+    /**
+     * @brief The Footer struct 段文件末尾的描述信息,按本机字节序原样写入,段文件不在机器之间共享
+     */
+    struct Footer {
+        quint32 magic = 0;
+        quint32 version = 0;
+        qint32 format = 0;
+        quint32 headSize = 0;
+        quint64 device = 0;
+        quint64 inode = 0;
+        qint64 sourceSize = 0;
+        qint64 sourceMtime = 0;
+        //已缓存的内容长度,压缩日志为解压后的长度
+        qint64 coveredBytes = 0;
+        qint64 recordCount = 0;
+        qint64 bodySize = 0;
+        //块表在记录之后、描述信息之前
+        qint64 blockCount = 0;
+        //内容开头LOG_SEGMENT_HEAD_SIZE字节的SHA1
+        char headHash[20] = {};
+    };
+
+    bool statSource();
+    bool replayBlock(const Block &block, qint64 end, const std::atomic_bool &canRun, bool timed,
+                     const LogLineFilter &filter, const Handler &handler, bool &corrupted);
+    void flushBlock();
+    void close();
+    void discard();
+
+    QString m_filePath;
+    int m_format;
+    //源文件的设备号、inode、大小和修改时间
+    quint64 m_device = 0;
+    quint64 m_inode = 0;
+    qint64 m_sourceSize = 0;
+    qint64 m_sourceMtime = 0;
+    bool m_immutable = false;
+    bool m_valid = false;
+    QFile m_file;
+    const uchar *m_map = nullptr;
+    Footer m_footer;
+    //正在写入的新段
+    QScopedPointer<QSaveFile> m_writer;
+    qint64 m_writeCovered = 0;
+    qint64 m_writeRecords = 0;
+    QByteArray m_writeHead;
+    QByteArray m_record;
+    //正在写入的块和已写完的块表
+    Block m_block;
+    LogTrigramBloom m_bloom;
+    QByteArray m_blocks;
+    qint64 m_writeBlocks = 0;
+    qint64 m_skippedBlocks = 0;
+};
+
+#endif // LOGSEGMENTCACHE_H
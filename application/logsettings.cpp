@@ -10,8 +10,12 @@
 #include <QDir>
 #include <QDebug>
 #include <QDateTime>
+
+#include <algorithm>
+
 #define MAINWINDOW_HEIGHT_NAME "logMainWindowHeightName"
 #define MAINWINDOW_WIDTH_NAME "logMainWindowWidthName"
+#define CATEGORY_VISITS_GROUP "categoryVisits"
 
 std::atomic<LogSettings *> LogSettings::m_instance;
 std::mutex LogSettings::m_mutex;
@@ -80,6 +84,39 @@ void LogSettings::saveConfigWinSize(int w, int h)
     m_winInfoConfig->sync();
 }
 
+/**
+ * @brief LogSettings::addCategoryVisit 记录一次日志类别的点击,用于后台预取常用类别
+ * @param category 类别名称,不能包含'/'
+ */
+void LogSettings::addCategoryVisit(const QString &category)
+{
+    m_winInfoConfig->beginGroup(CATEGORY_VISITS_GROUP);
+    m_winInfoConfig->setValue(category, m_winInfoConfig->value(category, 0).toInt() + 1);
+    m_winInfoConfig->endGroup();
+}
+
+/**
+ * @brief LogSettings::frequentCategories 点击次数最多的日志类别
+ * @param count 最多返回的个数
+ * @return 按点击次数从多到少排列的类别名称
+ */
+QStringList LogSettings::frequentCategories(int count)
+{
+    QList<QPair<int, QString>> visits;
+    m_winInfoConfig->beginGroup(CATEGORY_VISITS_GROUP);
+    for (const QString &category : m_winInfoConfig->childKeys())
+        visits.append(qMakePair(m_winInfoConfig->value(category).toInt(), category));
+    m_winInfoConfig->endGroup();
+    std::stable_sort(visits.begin(), visits.end(), [](const QPair<int, QString> &a, const QPair<int, QString> &b) {
+        return a.first > b.first;
+    });
+
+    QStringList categories;
+    for (int i = 0; i < visits.size() && i < count; ++i)
+        categories.append(visits.at(i).second);
+    return categories;
+}
+
 QMap<QString, QStringList> LogSettings::loadAuditMap()
 {
     QMap<QString, QStringList> auditType2EventType;
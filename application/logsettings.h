@@ -58,6 +58,8 @@ public:
     void saveConfigWinSize(int w, int h);
     void saveLogDir(const QString &iKey, const QString &iDir);
     QString getLogDir(const QString &iKey);
+    void addCategoryVisit(const QString &category);
+    QStringList frequentCategories(int count);
 
     // 审计类型与事件类型映射表
     static QMap<QString, QStringList> loadAuditMap();
@@ -0,0 +1,339 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logsharedring.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QLoggingCategory>
+#include <QSharedMemory>
+
+#include <atomic>
+#include <new>
+
+#include <string.h>
+#include <unistd.h>
+
+#ifdef QT_DEBUG
+Q_LOGGING_CATEGORY(logSharedRing, "org.deepin.log.viewer.shared.ring")
+#else
+Q_LOGGING_CATEGORY(logSharedRing, "org.deepin.log.viewer.shared.ring", QtInfoMsg)
+#endif
+
+/**
+ * @brief The LogSharedRing::Header struct 共享内存开头的控制信息,其后是capacity字节的数据区
+ */
+struct LogSharedRing::Header {
+    quint32 magic = LOG_SHARED_RING_MAGIC;
+    std::atomic<int> state {Running};
+    qint64 capacity = 0;
+    //累计写入的字节数,只有写入方修改
+    std::atomic<qint64> written {0};
+    //累计读取的字节数,只有读取方修改
+    std::atomic<qint64> consumed {0};
+};
+
+LogSharedRing::LogSharedRing(const QString &key)
+    : m_memory(new QSharedMemory(key))
+    , m_capacity(0)
+    , m_written(0)
+    , m_reserved(0)
+{
+}
+
+LogSharedRing::~LogSharedRing()
+{
+    detach();
+    delete m_memory;
+}
+
+/**
+ * @brief LogSharedRing::create 界面进程创建共享内存,提权进程启动前调用
+ * @param capacity 数据区大小
+ * @return 创建成功返回true
+ */
+bool LogSharedRing::create(qint64 capacity)
+{
+    if (capacity <= 0)
+        return false;
+    if (!m_memory->create(static_cast<int>(sizeof(Header) + capacity))) {
+        qCWarning(logSharedRing) << "create failed:" << m_memory->key() << m_memory->errorString();
+        return false;
+    }
+    Header *head = new (m_memory->data()) Header;
+    head->capacity = capacity;
+    m_capacity = capacity;
+    m_written = 0;
+    return true;
+}
+
+/**
+ * @brief LogSharedRing::attach 提权进程连接界面进程创建的共享内存
+ * @return 连接成功且校验通过返回true
+ */
+bool LogSharedRing::attach()
+{
+    if (!m_memory->attach()) {
+        qCWarning(logSharedRing) << "attach failed:" << m_memory->key() << m_memory->errorString();
+        return false;
+    }
+    const Header *head = header();
+    const qint64 capacity = head ? head->capacity : 0;
+    const qint64 written = head ? head->written.load(std::memory_order_acquire) : 0;
+    const qint64 consumed = head ? head->consumed.load(std::memory_order_acquire) : 0;
+    if (!head || head->magic != LOG_SHARED_RING_MAGIC || capacity <= 0
+            || static_cast<qint64>(sizeof(Header)) + capacity > m_memory->size()
+            || written < 0 || consumed < 0 || written - consumed < 0 || written - consumed > capacity) {
+        qCWarning(logSharedRing) << "invalid ring:" << m_memory->key();
+        m_memory->detach();
+        return false;
+    }
+    //之后只用这里保存的值,共享内存中的容量和写入位置被改写也不会影响写入的位置
+    m_capacity = capacity;
+    m_written = written;
+    m_reserved = 0;
+    return true;
+}
+
+void LogSharedRing::detach()
+{
+    if (m_memory->isAttached())
+        m_memory->detach();
+}
+
+bool LogSharedRing::isAttached() const
+{
+    return m_memory->isAttached();
+}
+
+QString LogSharedRing::key() const
+{
+    return m_memory->key();
+}
+
+qint64 LogSharedRing::capacity() const
+{
+    return header() ? m_capacity : 0;
+}
+
+LogSharedRing::State LogSharedRing::state() const
+{
+    const Header *head = header();
+    return head ? static_cast<State>(head->state.load(std::memory_order_acquire)) : Failed;
+}
+
+/**
+ * @brief LogSharedRing::writeBuffer 写入方取得一段连续的空闲区域,可以直接read进去,写完后commit
+ * 缓冲区满时等待读取方取走数据
+ * @param available 返回空闲区域的大小
+ * @param canRun 等待时检查,返回false时放弃
+ * @return 空闲区域的开头,读取方已停止、长时间没有读取或canRun返回false时为nullptr
+ */
+char *LogSharedRing::writeBuffer(qint64 &available, const CanRun &canRun)
+{
+    Header *head = header();
+    if (!head)
+        return nullptr;
+    QElapsedTimer stall;
+    stall.start();
+    qint64 lastConsumed = -1;
+    for (;;) {
+        if (head->state.load(std::memory_order_acquire) != Running)
+            return nullptr;
+        const qint64 consumed = head->consumed.load(std::memory_order_acquire);
+        if (!validConsumed(consumed)) {
+            qCWarning(logSharedRing) << "broken ring, consumed:" << consumed << "written:" << m_written << m_memory->key();
+            head->state.store(Failed, std::memory_order_release);
+            return nullptr;
+        }
+        const qint64 free = m_capacity - (m_written - consumed);
+        if (free > 0) {
+            const qint64 offset = m_written % m_capacity;
+            available = qMin(free, m_capacity - offset);
+            m_reserved = available;
+            return data() + offset;
+        }
+        if (consumed != lastConsumed) {
+            lastConsumed = consumed;
+            stall.restart();
+        } else if (stall.elapsed() > LOG_SHARED_RING_STALL_MSEC) {
+            qCWarning(logSharedRing) << "reader stalled, give up:" << m_memory->key();
+            return nullptr;
+        }
+        if (canRun && !canRun())
+            return nullptr;
+        usleep(LOG_SHARED_RING_WAIT_USEC);
+    }
+}
+
+/**
+ * @brief LogSharedRing::commit 提交writeBuffer取得的区域中写入的字节数
+ */
+void LogSharedRing::commit(qint64 size)
+{
+    Header *head = header();
+    if (!head || size <= 0)
+        return;
+    m_written += qMin(size, m_reserved);
+    m_reserved = 0;
+    head->written.store(m_written, std::memory_order_release);
+}
+
+/**
+ * @brief LogSharedRing::write 复制一段数据到缓冲区,用于子进程输出等不能直接读到共享内存中的数据
+ * @return 全部写入返回true
+ */
+bool LogSharedRing::write(const char *data, qint64 size, const CanRun &canRun)
+{
+    while (size > 0) {
+        qint64 available = 0;
+        char *buffer = writeBuffer(available, canRun);
+        if (!buffer)
+            return false;
+        const qint64 count = qMin(available, size);
+        memcpy(buffer, data, static_cast<size_t>(count));
+        commit(count);
+        data += count;
+        size -= count;
+    }
+    return true;
+}
+
+/**
+ * @brief LogSharedRing::finish 写入方结束,读取方读完剩余的数据后返回
+ * @param ok 数据是否完整
+ */
+void LogSharedRing::finish(bool ok)
+{
+    Header *head = header();
+    if (!head)
+        return;
+    int expected = Running;
+    head->state.compare_exchange_strong(expected, ok ? Finished : Failed, std::memory_order_release);
+}
+
+/**
+ * @brief LogSharedRing::read 读取方依次取出缓冲区中的连续数据,直接在共享内存上交给回调
+ * @param handler 数据回调,返回false时停止并通知写入方
+ * @param canRun 没有数据时检查,通常判断提权进程是否还在运行,返回false且写入方没有结束时停止
+ * @return 写入方正常结束且数据全部读完返回true
+ */
+bool LogSharedRing::read(const ChunkHandler &handler, const CanRun &canRun)
+{
+    Header *head = header();
+    if (!head)
+        return false;
+    for (;;) {
+        const qint64 consumed = head->consumed.load(std::memory_order_relaxed);
+        const qint64 written = head->written.load(std::memory_order_acquire);
+        if (written > consumed) {
+            const qint64 offset = consumed % m_capacity;
+            const qint64 size = qMin(written - consumed, m_capacity - offset);
+            const bool goOn = handler(data() + offset, size);
+            head->consumed.store(consumed + size, std::memory_order_release);
+            if (!goOn) {
+                cancel();
+                return false;
+            }
+            continue;
+        }
+        //写入方先提交数据再结束,结束后再检查一次是否还有没读的数据
+        const int state = head->state.load(std::memory_order_acquire);
+        if (state != Running) {
+            if (head->written.load(std::memory_order_acquire) > consumed)
+                continue;
+            return state == Finished;
+        }
+        if (canRun && !canRun()) {
+            if (head->state.load(std::memory_order_acquire) != Running)
+                continue;
+            cancel();
+            return false;
+        }
+        usleep(LOG_SHARED_RING_WAIT_USEC);
+    }
+}
+
+/**
+ * @brief LogSharedRing::readLines 按行读取,完整落在一段连续数据中的行不复制,
+ * 只有跨越缓冲区末尾或跨两次写入的行拼接一次;交给回调的行只在回调内有效
+ * @return 同read,最后一行没有换行符也会交出
+ */
+bool LogSharedRing::readLines(const LineHandler &handler, const CanRun &canRun)
+{
+    QByteArray carry;
+    bool stopped = false;
+    const bool completed = read([&](const char *chunk, qint64 size) {
+        const char *end = chunk + size;
+        const char *begin = chunk;
+        while (begin < end) {
+            const char *newline = static_cast<const char *>(memchr(begin, '\n', static_cast<size_t>(end - begin)));
+            if (!newline) {
+                carry.append(begin, static_cast<int>(end - begin));
+                break;
+            }
+            bool goOn = true;
+            if (carry.isEmpty()) {
+                goOn = handler(QByteArray::fromRawData(begin, static_cast<int>(newline - begin)));
+            } else {
+                carry.append(begin, static_cast<int>(newline - begin));
+                goOn = handler(carry);
+                carry.clear();
+            }
+            if (!goOn) {
+                stopped = true;
+                return false;
+            }
+            begin = newline + 1;
+        }
+        return true;
+    }, canRun);
+    if (stopped)
+        return false;
+    if (!carry.isEmpty() && !handler(carry))
+        return false;
+    return completed;
+}
+
+/**
+ * @brief LogSharedRing::cancel 读取方停止,写入方下次等待空间时返回
+ */
+void LogSharedRing::cancel()
+{
+    Header *head = header();
+    if (!head)
+        return;
+    int expected = Running;
+    head->state.compare_exchange_strong(expected, Cancelled, std::memory_order_release);
+}
+
+/**
+ * @brief LogSharedRing::uniqueKey 生成本进程内唯一的共享内存名称,每次提权读取使用一个新的通道
+ */
+QString LogSharedRing::uniqueKey()
+{
+    static std::atomic<int> counter {0};
+    return QString("LOGAUTHDATA_%1_%2").arg(QCoreApplication::applicationPid()).arg(++counter);
+}
+
+/**
+ * @brief LogSharedRing::validConsumed 写入方校验从共享内存读到的读取位置,未读的数据不能为负,也不能超过容量
+ */
+bool LogSharedRing::validConsumed(qint64 consumed) const
+{
+    const qint64 unread = m_written - consumed;
+    return consumed >= 0 && unread >= 0 && unread <= m_capacity;
+}
+
+LogSharedRing::Header *LogSharedRing::header() const
+{
+    if (!m_memory->isAttached())
+        return nullptr;
+    return static_cast<Header *>(m_memory->data());
+}
+
+char *LogSharedRing::data() const
+{
+    return static_cast<char *>(m_memory->data()) + sizeof(Header);
+}
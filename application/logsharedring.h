@@ -0,0 +1,96 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGSHAREDRING_H
+#define LOGSHAREDRING_H
+
+#include <QByteArray>
+#include <QString>
+
+#include <functional>
+
+class QSharedMemory;
+
+//共享内存数据通道的标识,attach时校验,防止连到同名的其他共享内存
+#define LOG_SHARED_RING_MAGIC 0x4c475247
+//数据区默认大小,提权进程写满后等待界面进程读取
+#define LOG_SHARED_RING_DEFAULT_SIZE (4 * 1024 * 1024)
+//没有数据或空间时的轮询间隔,微秒
+#define LOG_SHARED_RING_WAIT_USEC 1000
+//logViewerAuth的数据通道参数为此值时只做提权鉴权,不读取数据,界面进程随后通过日志服务读取文件
+#define LOG_AUTH_NO_DATA "-"
+//读取方这么久没有取走数据时写入方放弃,避免界面进程退出后提权进程一直等待,毫秒
+#define LOG_SHARED_RING_STALL_MSEC 30000
+
+/**
+ * @brief The LogSharedRing class 界面进程和提权进程(logViewerAuth)之间的共享内存环形缓冲区,单写单读
+ * 界面进程create后把key作为参数传给提权进程,提权进程attach后直接把文件read到共享内存中,
+ * 界面进程在共享内存上按块或按行解析,数据不再经过bash、管道和QProcess的缓冲多次复制。
+ * 写入和读取的位置是累计字节数,只增不减,二者之差为缓冲区中未读的数据。
+ * 共享内存对界面进程可写,提权进程attach后只用自己保存的容量和写入位置,
+ * 每次读到的读取位置都要校验,不合法时按通道损坏结束,不会写到共享内存之外
+ */
+class LogSharedRing
+{
+public:
+    enum State {
+        Running = 0,
+        Finished,
+        Failed,
+        //读取方停止读取,写入方应尽快退出
+        Cancelled
+    };
+
+    /**
+     * @brief CanRun 等待空间或数据时检查,返回false时停止等待
+     */
+    typedef std::function<bool()> CanRun;
+    /**
+     * @brief ChunkHandler 共享内存中一段连续的数据,只在回调内有效,返回false时停止读取
+     */
+    typedef std::function<bool(const char *, qint64)> ChunkHandler;
+    /**
+     * @brief LineHandler 一行数据(不含换行符),返回false时停止读取
+     */
+    typedef std::function<bool(const QByteArray &)> LineHandler;
+
+    explicit LogSharedRing(const QString &key);
+    ~LogSharedRing();
+
+    bool create(qint64 capacity = LOG_SHARED_RING_DEFAULT_SIZE);
+    bool attach();
+    void detach();
+    bool isAttached() const;
+    QString key() const;
+    qint64 capacity() const;
+    State state() const;
+
+    char *writeBuffer(qint64 &available, const CanRun &canRun);
+    void commit(qint64 size);
+    bool write(const char *data, qint64 size, const CanRun &canRun);
+    void finish(bool ok);
+
+    bool read(const ChunkHandler &handler, const CanRun &canRun);
+    bool readLines(const LineHandler &handler, const CanRun &canRun);
+    void cancel();
+
+    static QString uniqueKey();
+
+private:
+    struct Header;
+
+    Header *header() const;
+    char *data() const;
+    bool validConsumed(qint64 consumed) const;
+
+    QSharedMemory *m_memory;
+    //create或attach时确定的数据区大小,之后不再读取共享内存中的值
+    qint64 m_capacity;
+    //写入方累计写入的字节数,只发布到共享内存,不从共享内存读回
+    qint64 m_written;
+    //最近一次writeBuffer交出的空闲区域大小,commit不能超过它
+    qint64 m_reserved;
+};
+
+#endif // LOGSHAREDRING_H
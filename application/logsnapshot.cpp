@@ -0,0 +1,142 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logsnapshot.h"
+
+#include <QDataStream>
+#include <QFile>
+#include <QLoggingCategory>
+#include <QSaveFile>
+
+#ifdef QT_DEBUG
+Q_LOGGING_CATEGORY(logSnapshot, "org.deepin.log.viewer.snapshot")
+#else
+Q_LOGGING_CATEGORY(logSnapshot, "org.deepin.log.viewer.snapshot", QtInfoMsg)
+#endif
+
+namespace {
+//标识的字节数,含结尾的0
+const int MAGIC_SIZE = sizeof(LOG_SNAPSHOT_MAGIC);
+//标识之后的版本和类别表长度
+const int HEADER_SIZE = MAGIC_SIZE + sizeof(quint32) + sizeof(quint64);
+
+void prepare(QDataStream &stream)
+{
+    //固定序列化版本,不同Qt版本的机器之间可以互相打开
+    stream.setVersion(QDataStream::Qt_5_6);
+}
+}
+
+/**
+ * @brief LogSnapshot::save 写入快照文件,写完整后才替换已有的文件
+ * @param path 文件路径
+ * @param entries 类别缓存导出的各类别,见LogCategoryCache::snapshotEntries
+ * @return 是否写入成功
+ */
+bool LogSnapshot::save(const QString &path, const QList<LogCategoryCache::SnapshotEntry> &entries)
+{
+    QByteArray table;
+    QDataStream tableOut(&table, QIODevice::WriteOnly);
+    prepare(tableOut);
+    tableOut << static_cast<qint32>(entries.size());
+    quint64 offset = 0;
+    for (const LogCategoryCache::SnapshotEntry &entry : entries) {
+        tableOut << entry.key << entry.category << entry.range.begin << entry.range.end << entry.range.match << entry.cursor
+                 << entry.type << static_cast<qint32>(entry.count) << entry.rawCost << static_cast<qint32>(entry.chunks.size());
+        for (const QByteArray &chunk : entry.chunks) {
+            tableOut << offset << static_cast<quint64>(chunk.size());
+            offset += static_cast<quint64>(chunk.size());
+        }
+    }
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCWarning(logSnapshot) << "open snapshot for writing failed:" << path << file.errorString();
+        return false;
+    }
+    file.write(LOG_SNAPSHOT_MAGIC, MAGIC_SIZE);
+    QDataStream out(&file);
+    prepare(out);
+    out << static_cast<quint32>(LOG_SNAPSHOT_VERSION) << static_cast<quint64>(table.size());
+    file.write(table);
+    for (const LogCategoryCache::SnapshotEntry &entry : entries) {
+        for (const QByteArray &chunk : entry.chunks)
+            file.write(chunk);
+    }
+    if (!file.commit()) {
+        qCWarning(logSnapshot) << "write snapshot failed:" << path << file.errorString();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief LogSnapshot::load 映射快照文件并读出各类别,各批数据从映射中复制,不经过额外的读缓冲
+ * @param path 文件路径
+ * @param entries 输出参数,各类别
+ * @return 是否是可以打开的快照,标识、版本不符或内容不完整时返回false
+ */
+bool LogSnapshot::load(const QString &path, QList<LogCategoryCache::SnapshotEntry> *entries)
+{
+    entries->clear();
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qCWarning(logSnapshot) << "open snapshot failed:" << path << file.errorString();
+        return false;
+    }
+    const qint64 size = file.size();
+    if (size < HEADER_SIZE)
+        return false;
+    const uchar *data = file.map(0, size);
+    if (!data) {
+        qCWarning(logSnapshot) << "map snapshot failed:" << path << file.errorString();
+        return false;
+    }
+
+    const char *begin = reinterpret_cast<const char *>(data);
+    bool ok = false;
+    if (qstrncmp(begin, LOG_SNAPSHOT_MAGIC, MAGIC_SIZE) == 0) {
+        const QByteArray header = QByteArray::fromRawData(begin + MAGIC_SIZE, HEADER_SIZE - MAGIC_SIZE);
+        QDataStream headerIn(header);
+        prepare(headerIn);
+        quint32 version = 0;
+        quint64 tableSize = 0;
+        headerIn >> version >> tableSize;
+        if (version == LOG_SNAPSHOT_VERSION && tableSize <= static_cast<quint64>(size - HEADER_SIZE)) {
+            const QByteArray table = QByteArray::fromRawData(begin + HEADER_SIZE, static_cast<int>(tableSize));
+            const char *chunks = begin + HEADER_SIZE + tableSize;
+            const quint64 chunksSize = static_cast<quint64>(size - HEADER_SIZE) - tableSize;
+            QDataStream in(table);
+            prepare(in);
+            qint32 count = 0;
+            in >> count;
+            ok = in.status() == QDataStream::Ok && count >= 0;
+            for (qint32 i = 0; ok && i < count; ++i) {
+                LogCategoryCache::SnapshotEntry entry;
+                qint32 records = 0;
+                qint32 chunkCount = 0;
+                in >> entry.key >> entry.category >> entry.range.begin >> entry.range.end >> entry.range.match >> entry.cursor
+                   >> entry.type >> records >> entry.rawCost >> chunkCount;
+                entry.count = records;
+                ok = in.status() == QDataStream::Ok && chunkCount >= 0;
+                for (qint32 j = 0; ok && j < chunkCount; ++j) {
+                    quint64 offset = 0;
+                    quint64 length = 0;
+                    in >> offset >> length;
+                    ok = in.status() == QDataStream::Ok && offset <= chunksSize && length <= chunksSize - offset;
+                    if (ok)
+                        entry.chunks.append(QByteArray(chunks + offset, static_cast<int>(length)));
+                }
+                if (ok)
+                    entries->append(entry);
+            }
+        }
+    }
+    file.unmap(const_cast<uchar *>(data));
+    if (!ok) {
+        qCWarning(logSnapshot) << "not a valid snapshot:" << path;
+        entries->clear();
+    }
+    return ok;
+}
@@ -0,0 +1,32 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGSNAPSHOT_H
+#define LOGSNAPSHOT_H
+
+#include "logcategorycache.h"
+
+#include <QList>
+#include <QString>
+
+//快照文件开头的标识
+#define LOG_SNAPSHOT_MAGIC "DLVSNAP"
+//快照文件的后缀
+#define LOG_SNAPSHOT_SUFFIX ".logsnap"
+//快照文件格式的版本,格式不兼容时递增
+#define LOG_SNAPSHOT_VERSION 1
+
+/**
+ * @brief The LogSnapshot class 把已加载的各类别写入快照文件,之后在本机或其他机器上打开,不再读取日志或经过DBus鉴权
+ * 文件由标识、版本、类别表和数据区组成:类别表记录每个类别的缓存键、筛选范围、记录类型和各批数据在数据区中的位置,
+ * 数据区为类别缓存压缩后的各批记录。打开时映射整个文件,按类别表取出各批数据,解压推迟到第一次查看该类别时
+ */
+class LogSnapshot
+{
+public:
+    static bool save(const QString &path, const QList<LogCategoryCache::SnapshotEntry> &entries);
+    static bool load(const QString &path, QList<LogCategoryCache::SnapshotEntry> *entries);
+};
+
+#endif // LOGSNAPSHOT_H
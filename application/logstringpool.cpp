@@ -0,0 +1,69 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logstringpool.h"
+
+LogStringPool::LogStringPool(int maxSize)
+    : m_maxSize(maxSize)
+{
+}
+
+/**
+ * @brief LogStringPool::intern 获取与value相等的池中字符串
+ * @param value 字段值
+ * @return 池中已有相同的值时返回池中的共享拷贝,否则收录value并原样返回
+ */
+QString LogStringPool::intern(const QString &value)
+{
+    if (value.isEmpty())
+        return value;
+    auto it = m_values.constFind(value);
+    if (it != m_values.constEnd())
+        return *it;
+    if (size() < m_maxSize)
+        m_values.insert(value);
+    return value;
+}
+
+/**
+ * @brief LogStringPool::intern 按原始字节查找,命中时不解码也不分配内存
+ * @param data 原始数据,不要求以'\0'结尾,调用返回后不再引用
+ * @param length 数据长度
+ * @param decode 未命中时的解码函数,为空时按UTF-8解码
+ * @return 解码后的值
+ */
+QString LogStringPool::intern(const char *data, size_t length, Decoder decode)
+{
+    if (!data || length == 0)
+        return QString();
+    const QByteArray key = QByteArray::fromRawData(data, static_cast<int>(length));
+    auto it = m_raw.constFind(key);
+    if (it != m_raw.constEnd())
+        return it.value();
+
+    QString value = intern((decode ? decode : fromUtf8)(data, length));
+    //fromRawData不持有数据,收录时必须深拷贝
+    if (size() < m_maxSize)
+        m_raw.insert(QByteArray(data, static_cast<int>(length)), value);
+    return value;
+}
+
+/**
+ * @brief LogStringPool::size 已收录的条目数,原始字节和字符串两种键分别计数
+ */
+int LogStringPool::size() const
+{
+    return m_values.size() + m_raw.size();
+}
+
+void LogStringPool::clear()
+{
+    m_values.clear();
+    m_raw.clear();
+}
+
+QString LogStringPool::fromUtf8(const char *data, size_t length)
+{
+    return QString::fromUtf8(data, static_cast<int>(length));
+}
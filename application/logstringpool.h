@@ -0,0 +1,44 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGSTRINGPOOL_H
+#define LOGSTRINGPOOL_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QSet>
+#include <QString>
+
+#include <stddef.h>
+
+//单个字符串池最多保存的不同值个数,超过后不再收录,避免高基数字段把池撑大
+#define LOG_STRING_POOL_MAX_SIZE 4096
+
+/**
+ * @brief The LogStringPool class 低基数字段(主机名、进程名、等级、事件类型等)的字符串池
+ * 相同的值返回同一个隐式共享的QString,一次加载中成千上万条记录只保留一份字符数据;
+ * 不是线程安全的,每个读取线程各用一个
+ */
+class LogStringPool
+{
+public:
+    typedef QString (*Decoder)(const char *data, size_t length);
+
+    explicit LogStringPool(int maxSize = LOG_STRING_POOL_MAX_SIZE);
+
+    QString intern(const QString &value);
+    QString intern(const char *data, size_t length, Decoder decode);
+    int size() const;
+    void clear();
+
+private:
+    static QString fromUtf8(const char *data, size_t length);
+
+    int m_maxSize;
+    QSet<QString> m_values;
+    //原始字节 -> 解码后的值,命中时不再解码
+    QHash<QByteArray, QString> m_raw;
+};
+
+#endif // LOGSTRINGPOOL_H
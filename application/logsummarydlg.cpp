@@ -0,0 +1,96 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logsummarydlg.h"
+
+#include <DApplication>
+
+#include <QHeaderView>
+#include <QLocale>
+#include <QSet>
+#include <QVBoxLayout>
+
+//面板的默认大小
+#define LOG_SUMMARY_DLG_WIDTH 480
+#define LOG_SUMMARY_DLG_HEIGHT 520
+//最多列出的进程数
+#define LOG_SUMMARY_MAX_DAEMONS 20
+//最多列出的最近小时数
+#define LOG_SUMMARY_MAX_HOURS 48
+//项中保存查询条件的角色
+#define LOG_SUMMARY_TERM_ROLE (Qt::UserRole + 1)
+
+/**
+ * @brief LogSummaryDlg::LogSummaryDlg 构造函数
+ * @param aggregates 统计数据,由调用者持有,需要比面板活得久
+ * @param parent 父对象指针
+ */
+LogSummaryDlg::LogSummaryDlg(const LogAggregates *aggregates, DWidget *parent)
+    : DDialog(parent)
+    , m_aggregates(aggregates)
+{
+    setIcon(QIcon::fromTheme("deepin-log-viewer"));
+    setTitle(DApplication::translate("Dialog", "Summary"));
+
+    DWidget *pWidget = new DWidget(this);
+    QVBoxLayout *pVLayout = new QVBoxLayout();
+    pVLayout->setContentsMargins(0, 0, 0, 0);
+    m_pTree = new QTreeWidget(pWidget);
+    m_pTree->setAccessibleName("summary_tree");
+    m_pTree->setColumnCount(2);
+    m_pTree->setHeaderLabels(QStringList() << DApplication::translate("Table", "Item")
+                                           << DApplication::translate("Table", "Count"));
+    m_pTree->header()->setSectionResizeMode(0, QHeaderView::Stretch);
+    m_pTree->header()->setSectionResizeMode(1, QHeaderView::ResizeToContents);
+    m_pTree->header()->setStretchLastSection(false);
+    pVLayout->addWidget(m_pTree);
+    pWidget->setLayout(pVLayout);
+    addContent(pWidget);
+    resize(LOG_SUMMARY_DLG_WIDTH, LOG_SUMMARY_DLG_HEIGHT);
+
+    connect(m_pTree, &QTreeWidget::itemClicked, this, [this](QTreeWidgetItem *item) {
+        const QString term = item ? item->data(0, LOG_SUMMARY_TERM_ROLE).toString() : QString();
+        if (!term.isEmpty())
+            emit termActivated(term);
+    });
+    refresh();
+}
+
+/**
+ * @brief LogSummaryDlg::refresh 按当前统计重建列表,保留各分组的展开状态
+ */
+void LogSummaryDlg::refresh()
+{
+    QSet<QString> collapsed;
+    for (int i = 0; i < m_pTree->topLevelItemCount(); ++i) {
+        const QTreeWidgetItem *section = m_pTree->topLevelItem(i);
+        if (!section->isExpanded())
+            collapsed.insert(section->text(0));
+    }
+    m_pTree->clear();
+    if (!m_aggregates)
+        return;
+
+    addSection(DApplication::translate("Table", "Process"), m_aggregates->daemons(LOG_SUMMARY_MAX_DAEMONS));
+    addSection(DApplication::translate("Table", "Level"), m_aggregates->levels());
+    addSection(DApplication::translate("Table", "Hour"), m_aggregates->hours(LOG_SUMMARY_MAX_HOURS));
+    for (int i = 0; i < m_pTree->topLevelItemCount(); ++i) {
+        QTreeWidgetItem *section = m_pTree->topLevelItem(i);
+        section->setExpanded(!collapsed.contains(section->text(0)));
+    }
+}
+
+void LogSummaryDlg::addSection(const QString &title, const QList<LogAggregateEntry> &entries)
+{
+    if (entries.isEmpty())
+        return;
+    QTreeWidgetItem *section = new QTreeWidgetItem(m_pTree, QStringList() << title);
+    const QLocale locale;
+    for (const LogAggregateEntry &entry : entries) {
+        QTreeWidgetItem *item = new QTreeWidgetItem(section, QStringList() << entry.text << locale.toString(entry.count));
+        item->setData(0, LOG_SUMMARY_TERM_ROLE, entry.term);
+        item->setToolTip(0, entry.term);
+        item->setTextAlignment(1, Qt::AlignRight | Qt::AlignVCenter);
+    }
+}
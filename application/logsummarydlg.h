@@ -0,0 +1,43 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGSUMMARYDLG_H
+#define LOGSUMMARYDLG_H
+
+#include "logaggregates.h"
+
+#include <DDialog>
+#include <DWidget>
+
+#include <QTreeWidget>
+
+DWIDGET_USE_NAMESPACE
+
+/**
+ * @brief The LogSummaryDlg class 当前类别已加载日志的统计面板,按进程、等级和小时列出条数,
+ * 加载过程中每批数据到达后刷新;单击某一项时发出termActivated,把对应条件加入搜索框
+ */
+class LogSummaryDlg : public DDialog
+{
+    Q_OBJECT
+public:
+    explicit LogSummaryDlg(const LogAggregates *aggregates, DWidget *parent = nullptr);
+
+    void refresh();
+
+signals:
+    /**
+     * @brief termActivated 选中了某一项
+     * @param term 该项的查询条件,如ident:sshd
+     */
+    void termActivated(const QString &term);
+
+private:
+    void addSection(const QString &title, const QList<LogAggregateEntry> &entries);
+
+    const LogAggregates *m_aggregates;
+    QTreeWidget *m_pTree;
+};
+
+#endif // LOGSUMMARYDLG_H
@@ -0,0 +1,348 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logtablemodel.h"
+#include "logrecordfilter.h"
+#include "logmemoryusage.h"
+
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <numeric>
+
+namespace {
+quint64 overrideKey(int row, int column, int role)
+{
+    return (static_cast<quint64>(static_cast<quint32>(row)) << 32) | (static_cast<quint64>(column & 0xff) << 24)
+           | static_cast<quint64>(role & 0xffffff);
+}
+
+int overrideRow(quint64 key)
+{
+    return static_cast<int>(key >> 32);
+}
+
+/**
+ * @brief sortedOrder 按排序键稳定排序后的行排列,键相同的行保持原有顺序
+ * 分段后各段并行排序,再逐轮两两归并,同一轮的各次归并互不重叠,也并行执行
+ */
+template <typename Key>
+QVector<int> sortedOrder(const QVector<Key> &keys, Qt::SortOrder order)
+{
+    const int size = keys.size();
+    QVector<int> rows(size);
+    std::iota(rows.begin(), rows.end(), 0);
+    const Key *k = keys.constData();
+    auto less = [k, order](int a, int b) {
+        return order == Qt::AscendingOrder ? k[a] < k[b] : k[b] < k[a];
+    };
+
+    const int count = LogRecordFilter::chunkCount(size);
+    if (count <= 1) {
+        std::stable_sort(rows.begin(), rows.end(), less);
+        return rows;
+    }
+    const int chunkSize = (size + count - 1) / count;
+    int *data = rows.data();
+    QVector<int> begins;
+    for (int begin = 0; begin < size; begin += chunkSize)
+        begins.append(begin);
+    QtConcurrent::blockingMap(begins, [data, size, chunkSize, &less](const int &begin) {
+        std::stable_sort(data + begin, data + qMin(size, begin + chunkSize), less);
+    });
+    for (int width = chunkSize; width < size; width *= 2) {
+        begins.clear();
+        for (int begin = 0; begin + width < size; begin += 2 * width)
+            begins.append(begin);
+        QtConcurrent::blockingMap(begins, [data, size, width, &less](const int &begin) {
+            std::inplace_merge(data + begin, data + begin + width, data + qMin(size, begin + 2 * width), less);
+        });
+    }
+    return rows;
+}
+}
+
+LogTableModel::LogTableModel(QObject *parent)
+    : QAbstractTableModel(parent)
+{
+}
+
+LogTableModel::~LogTableModel()
+{
+}
+
+int LogTableModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid() || !m_rows)
+        return 0;
+    return m_rows->count();
+}
+
+int LogTableModel::columnCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+    return m_headers.size();
+}
+
+/**
+ * @brief LogTableModel::data 按角色取单元格数据
+ * 表格标记和辅助文本所有列通用,其余角色交给列定义
+ */
+QVariant LogTableModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || !m_rows || index.row() >= m_rows->count() || index.column() >= m_headers.size())
+        return QVariant();
+
+    if (!m_overrides.isEmpty()) {
+        auto it = m_overrides.constFind(overrideKey(index.row(), index.column(), role));
+        if (it != m_overrides.constEnd())
+            return it.value();
+    }
+
+    switch (role) {
+    case Qt::UserRole + 1:
+        return m_tableData;
+    case Qt::AccessibleTextRole:
+        //只在辅助技术查询时生成,不再逐次解析格式串
+        return QStringLiteral("treeview_context_") + QString::number(index.row()) + QLatin1Char('_') + QString::number(index.column());
+    case SearchHitsRole: {
+        if (!m_searchHits || m_searchHits->isEmpty())
+            return QVariant();
+        const QVector<int> hits = m_searchHits->find(m_rows->storeRow(index.row()), index.column());
+        return hits.isEmpty() ? QVariant() : QVariant::fromValue(hits);
+    }
+    default:
+        return m_rows->data(index.row(), index.column(), role);
+    }
+}
+
+/**
+ * @brief LogTableModel::setData 覆盖单元格的数据,如延迟加载的完整信息,传入空QVariant时恢复为列定义的数据
+ */
+bool LogTableModel::setData(const QModelIndex &index, const QVariant &value, int role)
+{
+    if (!index.isValid() || index.row() >= rowCount() || index.column() >= columnCount())
+        return false;
+    if (role == Qt::EditRole)
+        role = Qt::DisplayRole;
+
+    const quint64 key = overrideKey(index.row(), index.column(), role);
+    if (value.isValid())
+        m_overrides.insert(key, value);
+    else
+        m_overrides.remove(key);
+    emit dataChanged(index, index, QVector<int>() << role);
+    return true;
+}
+
+QVariant LogTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation == Qt::Horizontal && role == Qt::DisplayRole && section >= 0 && section < m_headers.size())
+        return m_headers.at(section);
+    return QAbstractTableModel::headerData(section, orientation, role);
+}
+
+Qt::ItemFlags LogTableModel::flags(const QModelIndex &index) const
+{
+    if (!index.isValid())
+        return Qt::NoItemFlags;
+    return Qt::ItemIsEnabled | Qt::ItemIsSelectable;
+}
+
+bool LogTableModel::removeRows(int row, int count, const QModelIndex &parent)
+{
+    if (parent.isValid() || !m_rows || row < 0 || count <= 0 || row + count > m_rows->count())
+        return false;
+
+    beginRemoveRows(QModelIndex(), row, row + count - 1);
+    m_rows->remove(row, count);
+    QHash<quint64, QVariant> overrides;
+    for (auto it = m_overrides.constBegin(); it != m_overrides.constEnd(); ++it) {
+        const int overrideAt = overrideRow(it.key());
+        if (overrideAt < row)
+            overrides.insert(it.key(), it.value());
+        else if (overrideAt >= row + count)
+            overrides.insert(it.key() - (static_cast<quint64>(count) << 32), it.value());
+    }
+    m_overrides.swap(overrides);
+    endRemoveRows();
+    return true;
+}
+
+/**
+ * @brief LogTableModel::sort 按列排序,列定义提供SortKeyRole时按数值,否则按显示文字
+ * 先并行算出每行的排序键,排序只比较键;记录不移动,只重排行号,选中等持久索引随行移动
+ * @param column 列号,小于0时不排序
+ * @param order 排序方式
+ */
+void LogTableModel::sort(int column, Qt::SortOrder order)
+{
+    const int count = rowCount();
+    if (column < 0 || column >= columnCount() || count < 2)
+        return;
+
+    QVector<int> rows;
+    if (m_rows->data(0, column, SortKeyRole).isValid())
+        rows = sortedOrder(sortKeys<qint64>(column, SortKeyRole), order);
+    else
+        rows = sortedOrder(sortKeys<QString>(column, Qt::DisplayRole), order);
+    //原来的第i行排序后的行号
+    QVector<int> target(count);
+    for (int i = 0; i < count; ++i)
+        target[rows.at(i)] = i;
+
+    emit layoutAboutToBeChanged(QList<QPersistentModelIndex>(), QAbstractItemModel::VerticalSortHint);
+    const QModelIndexList from = persistentIndexList();
+    QModelIndexList to;
+    to.reserve(from.size());
+    for (const QModelIndex &index : from)
+        to.append(index.isValid() ? createIndex(target.at(index.row()), index.column()) : QModelIndex());
+    m_rows->permute(rows);
+    if (!m_overrides.isEmpty()) {
+        QHash<quint64, QVariant> overrides;
+        for (auto it = m_overrides.constBegin(); it != m_overrides.constEnd(); ++it) {
+            const quint64 row = static_cast<quint64>(static_cast<quint32>(target.at(overrideRow(it.key()))));
+            overrides.insert((it.key() & 0xffffffffULL) | (row << 32), it.value());
+        }
+        m_overrides.swap(overrides);
+    }
+    changePersistentIndexList(from, to);
+    emit layoutChanged(QList<QPersistentModelIndex>(), QAbstractItemModel::VerticalSortHint);
+}
+
+/**
+ * @brief LogTableModel::dateTimeKey 时间文本的数值排序键
+ * 依次取出文本中的数字拼成整数,"yyyy-MM-dd hh:mm:ss"得到yyyyMMddhhmmss,同一格式的文本数值大小和时间先后一致
+ * @param text 时间文本
+ * @return 排序键,没有数字时为-1
+ */
+qint64 LogTableModel::dateTimeKey(const QString &text)
+{
+    qint64 key = 0;
+    int digits = 0;
+    for (const QChar &c : text) {
+        if (c < QLatin1Char('0') || c > QLatin1Char('9'))
+            continue;
+        //超过18位会溢出,之后的数字不再参与比较
+        if (++digits > 18)
+            break;
+        key = key * 10 + (c.unicode() - '0');
+    }
+    return digits == 0 ? -1 : key;
+}
+
+/**
+ * @brief LogTableModel::clear 清空表头、列定义和所有记录
+ */
+void LogTableModel::clear()
+{
+    beginResetModel();
+    m_headers.clear();
+    m_tableData.clear();
+    m_rows.reset();
+    m_overrides.clear();
+    m_searchHits.reset();
+    endResetModel();
+}
+
+/**
+ * @brief LogTableModel::setHorizontalHeaderLabels 设置表头,列数和表头个数一致
+ * @param labels 表头
+ */
+void LogTableModel::setHorizontalHeaderLabels(const QStringList &labels)
+{
+    //按列增删而不重置model,保留表头上已设置的列宽和隐藏状态
+    if (labels.size() > m_headers.size()) {
+        beginInsertColumns(QModelIndex(), m_headers.size(), labels.size() - 1);
+        m_headers = labels;
+        endInsertColumns();
+    } else if (labels.size() < m_headers.size()) {
+        beginRemoveColumns(QModelIndex(), labels.size(), m_headers.size() - 1);
+        m_headers = labels;
+        endRemoveColumns();
+    } else {
+        m_headers = labels;
+    }
+    if (!labels.isEmpty())
+        emit headerDataChanged(Qt::Horizontal, 0, labels.size() - 1);
+}
+
+QString LogTableModel::tableData() const
+{
+    return m_tableData;
+}
+
+/**
+ * @brief LogTableModel::setSearchHits 设置搜索时记下的关键字位置,可见单元格绘制时通过SearchHitsRole取用
+ * @param hits 按存储下标记录的位置,为空时不高亮
+ */
+void LogTableModel::setSearchHits(const std::shared_ptr<const LogSearchHits> &hits)
+{
+    if (m_searchHits == hits)
+        return;
+    m_searchHits = hits;
+    const int count = rowCount();
+    if (count > 0 && columnCount() > 0)
+        emit dataChanged(index(0, 0), index(count - 1, columnCount() - 1), QVector<int>() << SearchHitsRole);
+}
+
+/**
+ * @brief LogTableModel::memoryBytes model自身的内存占用:行下标数组、setData写入的数据和表头
+ * 记录由调用方的存储持有,不计入;seen中已有的下标数组(和调用方视图共享)不重复计算
+ */
+qint64 LogTableModel::memoryBytes(QSet<const void *> &seen) const
+{
+    qint64 bytes = static_cast<qint64>(sizeof(LogTableModel));
+    if (m_rows) {
+        const QVector<quint32> &rows = m_rows->rows();
+        bytes += LogMemoryAccounting::vectorBytes(rows.constData(), rows.capacity(), static_cast<int>(sizeof(quint32)), seen);
+    }
+    //QHash每个节点一次堆分配,节点包含哈希值、键和值
+    bytes += static_cast<qint64>(m_overrides.size()) * (static_cast<qint64>(sizeof(void *) + sizeof(uint) + sizeof(quint64) + sizeof(QVariant)) + LOG_MEMORY_MALLOC_OVERHEAD);
+    for (const QString &header : m_headers)
+        bytes += LogMemoryAccounting::textBytes(header, seen);
+    return bytes;
+}
+
+/**
+ * @brief LogTableModel::sortKeys 分段并行取出每一行在role下的数据作为排序键
+ */
+template <typename Key>
+QVector<Key> LogTableModel::sortKeys(int column, int role) const
+{
+    const int size = rowCount();
+    QVector<Key> keys(size);
+    Key *out = keys.data();
+    const Rows *rows = m_rows.get();
+    const int count = LogRecordFilter::chunkCount(size);
+    const int chunkSize = (size + count - 1) / count;
+    QVector<int> begins;
+    for (int begin = 0; begin < size; begin += chunkSize)
+        begins.append(begin);
+    QtConcurrent::blockingMap(begins, [rows, out, size, chunkSize, column, role](const int &begin) {
+        const int end = qMin(size, begin + chunkSize);
+        for (int row = begin; row < end; ++row)
+            out[row] = rows->data(row, column, role).value<Key>();
+    });
+    return keys;
+}
+
+/**
+ * @brief LogTableModel::shiftOverrides 在row处插入delta行后,把其后的覆盖数据下移
+ */
+void LogTableModel::shiftOverrides(int row, int delta)
+{
+    if (m_overrides.isEmpty())
+        return;
+
+    QHash<quint64, QVariant> overrides;
+    for (auto it = m_overrides.constBegin(); it != m_overrides.constEnd(); ++it) {
+        if (overrideRow(it.key()) < row)
+            overrides.insert(it.key(), it.value());
+        else
+            overrides.insert(it.key() + (static_cast<quint64>(delta) << 32), it.value());
+    }
+    m_overrides.swap(overrides);
+}
@@ -0,0 +1,254 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGTABLEMODEL_H
+#define LOGTABLEMODEL_H
+
+#include "logrecordview.h"
+#include "logsearchhits.h"
+
+#include <QAbstractTableModel>
+#include <QHash>
+#include <QIcon>
+#include <QSet>
+#include <QStringList>
+#include <QVector>
+
+#include <functional>
+#include <memory>
+
+/**
+ * @brief The LogTableModel class 主表的列式model
+ * 通过LogRecordView引用各类日志的记录,只保存下标,data()按列定义从记录中取值,图标和辅助文本在请求对应角色时才生成,
+ * 不再为每个单元格创建QStandardItem;行数即全部记录数,视图只为可见的行取数据;
+ * 排序时每行只取一次排序键,并行排序得到行的排列,只调整下标,不移动记录
+ */
+class LogTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+public:
+    /**
+     * @brief Column 列定义,返回记录在某个角色下的数据,不支持的角色返回空QVariant
+     */
+    template <typename T>
+    using Column = std::function<QVariant(const T &record, int role)>;
+    /**
+     * @brief SortKeyRole 排序键,列定义在该角色下返回qint64时按数值排序,否则按显示文字排序
+     */
+    static const int SortKeyRole = Qt::UserRole + 20;
+    /**
+     * @brief SearchHitsRole 单元格显示文字中搜索关键字的位置和长度(QVector<int>,两两一组),没有命中时为空QVariant
+     */
+    static const int SearchHitsRole = Qt::UserRole + 21;
+
+    explicit LogTableModel(QObject *parent = nullptr);
+    ~LogTableModel() override;
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole) override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    Qt::ItemFlags flags(const QModelIndex &index) const override;
+    bool removeRows(int row, int count, const QModelIndex &parent = QModelIndex()) override;
+    void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
+
+    void clear();
+    void setHorizontalHeaderLabels(const QStringList &labels);
+    QString tableData() const;
+    void setSearchHits(const std::shared_ptr<const LogSearchHits> &hits);
+    qint64 memoryBytes(QSet<const void *> &seen) const;
+
+    template <typename T>
+    void setColumns(const QString &tableData, const QVector<Column<T>> &columns);
+    template <typename T>
+    void insertRecords(int row, const LogRecordView<T> &records, int start = 0, int end = -1);
+    template <typename T>
+    void insertRecords(int row, const QList<T> &records, int start = 0, int end = -1);
+    template <typename T>
+    void appendRecords(const LogRecordView<T> &records);
+    template <typename T>
+    void appendRecords(const QList<T> &records);
+    template <typename T>
+    void offsetRecords(int delta);
+
+    template <typename T>
+    static Column<T> sortKeyColumn(const Column<T> &column, const std::function<qint64(const T &)> &key);
+    static qint64 dateTimeKey(const QString &text);
+
+private:
+    /**
+     * @brief The Rows class 类型擦除后的记录存储
+     */
+    class Rows
+    {
+    public:
+        virtual ~Rows() {}
+        virtual int count() const = 0;
+        virtual QVariant data(int row, int column, int role) const = 0;
+        //第row行记录在存储中的下标
+        virtual int storeRow(int row) const = 0;
+        virtual void remove(int row, int count) = 0;
+        //按order重排,新的第i行为原来的第order[i]行
+        virtual void permute(const QVector<int> &order) = 0;
+        //下标数组,统计内存占用时和调用方视图共享的数组只算一次
+        virtual const QVector<quint32> &rows() const = 0;
+    };
+
+    template <typename T>
+    class RecordRows : public Rows
+    {
+    public:
+        int count() const override
+        {
+            return records.size();
+        }
+        QVariant data(int row, int column, int role) const override
+        {
+            if (column >= columns.size() || !columns.at(column) || !records.isValid(row))
+                return QVariant();
+            return columns.at(column)(records.at(row), role);
+        }
+        int storeRow(int row) const override
+        {
+            return static_cast<int>(records.row(row));
+        }
+        void remove(int row, int count) override
+        {
+            records.remove(row, count);
+        }
+        void permute(const QVector<int> &order) override
+        {
+            QVector<quint32> rows;
+            rows.reserve(order.size());
+            for (int i : order)
+                rows.append(records.row(i));
+            records = records.withRows(rows);
+        }
+        const QVector<quint32> &rows() const override
+        {
+            return records.rows();
+        }
+
+        //引用调用方的记录存储,整表加载时和调用方的视图共享下标数组
+        LogRecordView<T> records;
+        QVector<Column<T>> columns;
+    };
+
+    void shiftOverrides(int row, int delta);
+    template <typename Key>
+    QVector<Key> sortKeys(int column, int role) const;
+
+    QStringList m_headers;
+    QString m_tableData;
+    std::unique_ptr<Rows> m_rows;
+    //setData写入的数据,优先于列定义,键为(行,列,角色)
+    QHash<quint64, QVariant> m_overrides;
+    //当前搜索记下的关键字位置,按存储下标查找,排序不影响
+    std::shared_ptr<const LogSearchHits> m_searchHits;
+};
+
+/**
+ * @brief LogTableModel::setColumns 设置记录类型和列定义
+ * 类型和表格标记都和当前相同时只替换列定义,保留已有记录,以便追加后续批次的数据;否则清空已有记录
+ * @param tableData 表格标记,作为每个单元格Qt::UserRole + 1的数据,详情页据此区分日志类型
+ * @param columns 列定义
+ */
+template <typename T>
+void LogTableModel::setColumns(const QString &tableData, const QVector<Column<T>> &columns)
+{
+    RecordRows<T> *rows = dynamic_cast<RecordRows<T> *>(m_rows.get());
+    if (rows && tableData == m_tableData) {
+        rows->columns = columns;
+        return;
+    }
+
+    //不重置model,保留表头上已设置的列宽和隐藏状态
+    const int count = rowCount();
+    if (count > 0)
+        beginRemoveRows(QModelIndex(), 0, count - 1);
+    rows = new RecordRows<T>;
+    rows->columns = columns;
+    m_rows.reset(rows);
+    m_tableData = tableData;
+    m_overrides.clear();
+    if (count > 0)
+        endRemoveRows();
+}
+
+/**
+ * @brief LogTableModel::insertRecords 插入records中[start, end)范围的记录,需要先用setColumns设置同类型的列定义
+ * @param row 插入的行号,超出范围时追加到末尾
+ * @param records 记录视图,不持有存储时存储需要比model中的数据活得久
+ * @param start 开始下标
+ * @param end 结束下标,-1表示到末尾
+ */
+template <typename T>
+void LogTableModel::insertRecords(int row, const LogRecordView<T> &records, int start, int end)
+{
+    RecordRows<T> *rows = dynamic_cast<RecordRows<T> *>(m_rows.get());
+    if (!rows)
+        return;
+    if (end < 0 || end > records.size())
+        end = records.size();
+    start = qMax(0, start);
+    if (start >= end)
+        return;
+    if (row < 0 || row > rows->records.size())
+        row = rows->records.size();
+
+    const int count = end - start;
+    beginInsertRows(QModelIndex(), row, row + count - 1);
+    rows->records.insert(row, records, start, end);
+    shiftOverrides(row, count);
+    endInsertRows();
+}
+
+template <typename T>
+void LogTableModel::insertRecords(int row, const QList<T> &records, int start, int end)
+{
+    insertRecords(row, LogRecordView<T>(records), start, end);
+}
+
+template <typename T>
+void LogTableModel::appendRecords(const LogRecordView<T> &records)
+{
+    insertRecords(-1, records);
+}
+
+template <typename T>
+void LogTableModel::appendRecords(const QList<T> &records)
+{
+    insertRecords(-1, LogRecordView<T>(records));
+}
+
+/**
+ * @brief LogTableModel::offsetRecords 记录存储头部插入了delta条记录后修正已有行的下标,行数和显示内容不变
+ */
+template <typename T>
+void LogTableModel::offsetRecords(int delta)
+{
+    RecordRows<T> *rows = dynamic_cast<RecordRows<T> *>(m_rows.get());
+    if (rows)
+        rows->records.offsetRows(delta);
+    //关键字位置按搜索时的下标记录,存储变化后不再对应
+    m_searchHits.reset();
+}
+
+/**
+ * @brief LogTableModel::sortKeyColumn 给列定义加上数值排序键
+ * @param column 原列定义
+ * @param key 排序键,会在多个线程中同时调用,必须只读记录
+ */
+template <typename T>
+LogTableModel::Column<T> LogTableModel::sortKeyColumn(const Column<T> &column, const std::function<qint64(const T &)> &key)
+{
+    return [column, key](const T &record, int role) -> QVariant {
+        if (role == SortKeyRole)
+            return key(record);
+        return column(record, role);
+    };
+}
+
+#endif // LOGTABLEMODEL_H
@@ -0,0 +1,233 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logtemplateminer.h"
+
+/**
+ * @brief LogTemplateMiner::isParameter 含数字的词(计数、编号、地址、时间等)和参数写法本身都作为参数
+ */
+bool LogTemplateMiner::isParameter(const QString &token)
+{
+    if (token == QLatin1String(LOG_TEMPLATE_WILDCARD))
+        return true;
+    for (const QChar &ch : token) {
+        if (ch.unicode() >= '0' && ch.unicode() <= '9')
+            return true;
+    }
+    return false;
+}
+
+/**
+ * @brief LogTemplateMiner::similarity 相同位置上相同的词数,两边都是参数的位置也算相同
+ */
+int LogTemplateMiner::similarity(const QStringList &tokens, const QStringList &templateTokens) const
+{
+    int same = 0;
+    for (int i = 0; i < tokens.size(); ++i) {
+        if (tokens.at(i) == templateTokens.at(i))
+            ++same;
+    }
+    return same;
+}
+
+/**
+ * @brief LogTemplateMiner::add 归纳一条信息
+ * @param message 信息
+ * @param params 输出参数,按顺序为模板各参数位置上的原文
+ * @return 信息所属的模板编号,用render和params可以还原出原文
+ */
+int LogTemplateMiner::add(const QString &message, QStringList *params)
+{
+    const QStringList tokens = message.split(QLatin1Char(' '));
+    QStringList masked = tokens;
+    for (QString &token : masked) {
+        if (isParameter(token))
+            token = QLatin1String(LOG_TEMPLATE_WILDCARD);
+    }
+
+    QVector<int> &leaf = m_leaves[QString::number(masked.size()) + QLatin1Char('\n') + masked.first()];
+    int best = -1;
+    int bestSame = -1;
+    for (int cluster : leaf) {
+        const int same = similarity(masked, m_templates.at(m_clusters.at(cluster).templateId).tokens);
+        if (same > bestSame) {
+            best = cluster;
+            bestSame = same;
+        }
+    }
+
+    int templateId = -1;
+    if (best >= 0 && bestSame * 100 >= LOG_TEMPLATE_SIMILARITY * masked.size()) {
+        Cluster &cluster = m_clusters[best];
+        QStringList merged = m_templates.at(cluster.templateId).tokens;
+        bool changed = false;
+        for (int i = 0; i < merged.size(); ++i) {
+            if (merged.at(i) != masked.at(i) && merged.at(i) != QLatin1String(LOG_TEMPLATE_WILDCARD)) {
+                merged[i] = QLatin1String(LOG_TEMPLATE_WILDCARD);
+                changed = true;
+            }
+        }
+        //旧模板保留,已归入的信息仍按旧模板还原
+        if (changed) {
+            Template next;
+            next.tokens = merged;
+            next.cluster = best;
+            m_templates.append(next);
+            cluster.templateId = m_templates.size() - 1;
+        }
+        ++cluster.count;
+        templateId = cluster.templateId;
+    } else {
+        Template created;
+        created.tokens = masked;
+        created.cluster = m_clusters.size();
+        m_templates.append(created);
+        Cluster cluster;
+        cluster.templateId = m_templates.size() - 1;
+        cluster.count = 1;
+        cluster.first = m_added;
+        m_clusters.append(cluster);
+        leaf.append(created.cluster);
+        templateId = cluster.templateId;
+    }
+    ++m_added;
+
+    if (params) {
+        params->clear();
+        const QStringList &templateTokens = m_templates.at(templateId).tokens;
+        for (int i = 0; i < templateTokens.size(); ++i) {
+            if (templateTokens.at(i) == QLatin1String(LOG_TEMPLATE_WILDCARD))
+                params->append(tokens.at(i));
+        }
+    }
+    return templateId;
+}
+
+/**
+ * @brief LogTemplateMiner::groupOf 模板所属的分组,编号无效时为-1
+ */
+int LogTemplateMiner::groupOf(int templateId) const
+{
+    if (templateId < 0 || templateId >= m_templates.size())
+        return -1;
+    return m_templates.at(templateId).cluster;
+}
+
+QString LogTemplateMiner::templateText(int templateId) const
+{
+    if (templateId < 0 || templateId >= m_templates.size())
+        return QString();
+    return m_templates.at(templateId).tokens.join(QLatin1Char(' '));
+}
+
+/**
+ * @brief LogTemplateMiner::render 把参数依次填回模板的参数位置,还原出原文
+ */
+QString LogTemplateMiner::render(int templateId, const QStringList &params) const
+{
+    if (templateId < 0 || templateId >= m_templates.size())
+        return QString();
+    QStringList tokens = m_templates.at(templateId).tokens;
+    int param = 0;
+    for (QString &token : tokens) {
+        if (token == QLatin1String(LOG_TEMPLATE_WILDCARD) && param < params.size())
+            token = params.at(param++);
+    }
+    return tokens.join(QLatin1Char(' '));
+}
+
+/**
+ * @brief LogTemplateMiner::groups 各组的当前模板和条数,按第一条出现的顺序
+ */
+QVector<LogTemplateGroup> LogTemplateMiner::groups() const
+{
+    QVector<LogTemplateGroup> result;
+    result.reserve(m_clusters.size());
+    for (const Cluster &cluster : m_clusters) {
+        LogTemplateGroup group;
+        group.pattern = templateText(cluster.templateId);
+        group.count = cluster.count;
+        group.first = cluster.first;
+        result.append(group);
+    }
+    return result;
+}
+
+/**
+ * @brief LogTemplateMiner::memoryBytes 模板表的大致内存占用
+ */
+qint64 LogTemplateMiner::memoryBytes() const
+{
+    qint64 bytes = static_cast<qint64>(m_templates.size()) * static_cast<qint64>(sizeof(Template))
+                   + static_cast<qint64>(m_clusters.size()) * static_cast<qint64>(sizeof(Cluster));
+    for (const Template &t : m_templates) {
+        for (const QString &token : t.tokens)
+            bytes += static_cast<qint64>(sizeof(QString)) + token.size() * static_cast<qint64>(sizeof(QChar));
+    }
+    return bytes;
+}
+
+void LogTemplateMiner::clear()
+{
+    m_templates.clear();
+    m_clusters.clear();
+    m_leaves.clear();
+    m_added = 0;
+}
+
+/**
+ * @brief LogTemplatedMessages::append 归纳并保存一条信息
+ * @return 信息的下标
+ */
+int LogTemplatedMessages::append(const QString &message)
+{
+    QStringList params;
+    Entry entry;
+    entry.templateId = static_cast<quint32>(m_miner.add(message, &params));
+    entry.firstParam = static_cast<quint32>(m_params.size());
+    entry.paramCount = static_cast<quint32>(params.size());
+    for (const QString &param : params)
+        m_params.append(m_arena.add(param));
+    m_entries.append(entry);
+    return m_entries.size() - 1;
+}
+
+QString LogTemplatedMessages::text(int i) const
+{
+    const Entry &entry = m_entries.at(i);
+    QStringList params;
+    params.reserve(static_cast<int>(entry.paramCount));
+    for (quint32 p = 0; p < entry.paramCount; ++p)
+        params.append(m_arena.text(m_params.at(static_cast<int>(entry.firstParam + p))));
+    return m_miner.render(static_cast<int>(entry.templateId), params);
+}
+
+int LogTemplatedMessages::templateId(int i) const
+{
+    return static_cast<int>(m_entries.at(i).templateId);
+}
+
+int LogTemplatedMessages::group(int i) const
+{
+    return m_miner.groupOf(templateId(i));
+}
+
+/**
+ * @brief LogTemplatedMessages::memoryBytes 模板、参数位置和字符区一共的大致内存占用
+ */
+qint64 LogTemplatedMessages::memoryBytes() const
+{
+    return m_miner.memoryBytes()
+           + static_cast<qint64>(m_entries.size()) * static_cast<qint64>(sizeof(Entry))
+           + static_cast<qint64>(m_params.size()) * static_cast<qint64>(sizeof(LogArenaString))
+           + m_arena.size();
+}
+
+void LogTemplatedMessages::clear()
+{
+    m_miner.clear();
+    m_entries.clear();
+    m_params.clear();
+    m_arena.clear();
+}
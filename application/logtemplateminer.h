@@ -0,0 +1,102 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGTEMPLATEMINER_H
+#define LOGTEMPLATEMINER_H
+
+#include "logcompactrecords.h"
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+//模板中参数位置的写法,和Drain/LogPai一致
+#define LOG_TEMPLATE_WILDCARD "<*>"
+//相同词数至少占总词数的这个百分比时归入已有模板
+#define LOG_TEMPLATE_SIMILARITY 50
+
+/**
+ * @brief The LogTemplateGroup struct 一组相似信息:当前模板、条数和第一条在输入中的位置
+ */
+struct LogTemplateGroup {
+    QString pattern;
+    int count = 0;
+    int first = -1;
+};
+
+/**
+ * @brief The LogTemplateMiner class 按Drain算法把信息归纳为带参数位置的模板
+ * 信息按空格分词,含数字的词直接作为参数;按词数和第一个词分组后,和组内各模板比较相同位置上的词,
+ * 相同比例不低于LOG_TEMPLATE_SIMILARITY时归入该模板,不同的位置改为参数,否则新建模板。
+ * 模板合并时生成新的模板编号,旧编号的模板不变,已记下的参数始终能按原模板还原出原文;
+ * 同一组的各个模板编号都对应同一个分组。不是线程安全的
+ */
+class LogTemplateMiner
+{
+public:
+    int add(const QString &message, QStringList *params = nullptr);
+    int templateCount() const { return m_templates.size(); }
+    int groupCount() const { return m_clusters.size(); }
+    int groupOf(int templateId) const;
+    QString templateText(int templateId) const;
+    QString render(int templateId, const QStringList &params) const;
+    QVector<LogTemplateGroup> groups() const;
+    qint64 memoryBytes() const;
+    void clear();
+
+    static bool isParameter(const QString &token);
+
+private:
+    struct Template {
+        QStringList tokens;
+        int cluster = 0;
+    };
+    struct Cluster {
+        int templateId = 0;
+        int count = 0;
+        int first = -1;
+    };
+
+    int similarity(const QStringList &tokens, const QStringList &templateTokens) const;
+
+    QVector<Template> m_templates;
+    QVector<Cluster> m_clusters;
+    //词数和第一个词到该组各个分组的下标
+    QHash<QString, QVector<int>> m_leaves;
+    int m_added = 0;
+};
+
+/**
+ * @brief The LogTemplatedMessages class 按模板紧凑存储的信息,每个模板只保存一份,
+ * 每条信息只记模板编号和各参数在字符区中的位置;重复度高的日志占用远小于逐条保存QString
+ */
+class LogTemplatedMessages
+{
+public:
+    int size() const { return m_entries.size(); }
+    bool isEmpty() const { return m_entries.isEmpty(); }
+    int append(const QString &message);
+    QString text(int i) const;
+    int templateId(int i) const;
+    int group(int i) const;
+    const LogTemplateMiner &miner() const { return m_miner; }
+    qint64 memoryBytes() const;
+    void clear();
+
+private:
+    struct Entry {
+        quint32 templateId = 0;
+        //第一个参数在m_params中的下标
+        quint32 firstParam = 0;
+        quint32 paramCount = 0;
+    };
+
+    LogTemplateMiner m_miner;
+    QVector<Entry> m_entries;
+    QVector<LogArenaString> m_params;
+    LogStringArena m_arena;
+};
+
+#endif // LOGTEMPLATEMINER_H
@@ -0,0 +1,53 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logtemplatework.h"
+
+#include <QLoggingCategory>
+
+#ifdef QT_DEBUG
+Q_LOGGING_CATEGORY(logTemplateWork, "org.deepin.log.viewer.template.work")
+#else
+Q_LOGGING_CATEGORY(logTemplateWork, "org.deepin.log.viewer.template.work", QtInfoMsg)
+#endif
+
+int LogTemplateWork::thread_index = 0;
+
+/**
+ * @brief LogTemplateWork::LogTemplateWork 构造函数
+ * @param count 记录数
+ * @param message 取记录信息的函数
+ * @param canRun 本次归纳的取消标记
+ * @param parent 父对象
+ */
+LogTemplateWork::LogTemplateWork(int count, const Message &message, const std::shared_ptr<std::atomic_bool> &canRun,
+                                 QObject *parent)
+    : QObject(parent)
+    , QRunnable()
+    , m_count(count)
+    , m_message(message)
+    , m_canRun(canRun)
+{
+    qRegisterMetaType<QVector<LogTemplateGroup>>("QVector<LogTemplateGroup>");
+    //使用线程池启动该线程，跑完自己删自己
+    setAutoDelete(true);
+    thread_index++;
+    m_threadIndex = thread_index;
+}
+
+void LogTemplateWork::run()
+{
+    LogTemplateMiner miner;
+    for (int i = 0; i < m_count; ++i) {
+        if (!*m_canRun) {
+            qCDebug(logTemplateWork) << "template work" << m_threadIndex << "canceled at" << i;
+            return;
+        }
+        miner.add(m_message(i));
+    }
+    if (!*m_canRun)
+        return;
+    qCDebug(logTemplateWork) << "template work" << m_threadIndex << m_count << "messages," << miner.groupCount() << "groups";
+    emit groupsReady(m_threadIndex, miner.groups());
+}
@@ -0,0 +1,58 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGTEMPLATEWORK_H
+#define LOGTEMPLATEWORK_H
+
+#include "logtemplateminer.h"
+
+#include <QMetaType>
+#include <QObject>
+#include <QRunnable>
+#include <QVector>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+
+Q_DECLARE_METATYPE(QVector<LogTemplateGroup>)
+
+/**
+ * @brief The LogTemplateWork class 在线程池中把已加载的信息按模板归纳为相似信息组,用于折叠显示
+ * 和LogSearchWork一样使用共享的取消标记,重新加载或展开时置false,扫描的线程随即退出
+ */
+class LogTemplateWork : public QObject, public QRunnable
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Message 取第row条记录的信息,在工作线程中调用,只能访问按值捕获的数据
+     */
+    using Message = std::function<QString(int row)>;
+
+    LogTemplateWork(int count, const Message &message, const std::shared_ptr<std::atomic_bool> &canRun,
+                    QObject *parent = nullptr);
+
+    void run() override;
+    int getIndex() const { return m_threadIndex; }
+
+signals:
+    /**
+     * @brief groupsReady 归纳完成,被取消时不发出
+     * @param index 当前线程的数字标号
+     * @param groups 各组的模板、条数和第一条记录的下标,按第一条出现的顺序
+     */
+    void groupsReady(int index, QVector<LogTemplateGroup> groups);
+
+private:
+    static int thread_index;
+
+    int m_count;
+    Message m_message;
+    std::shared_ptr<std::atomic_bool> m_canRun;
+    int m_threadIndex;
+};
+
+#endif // LOGTEMPLATEWORK_H
@@ -0,0 +1,115 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logtextsource.h"
+#include "loglineindexer.h"
+#include "loglinestream.h"
+
+/**
+ * @brief LogTextSource::LogTextSource 构造函数,open或setData之后才有内容
+ * @param filePath 日志文件路径
+ */
+LogTextSource::LogTextSource(const QString &filePath)
+    : m_filePath(filePath)
+{
+}
+
+LogTextSource::~LogTextSource()
+{
+}
+
+/**
+ * @brief LogTextSource::open 在进程内映射文件,没有读权限时映射服务传回的描述符
+ * @param parent DLDBusHandler单例的父对象
+ * @return 是否成功,失败时调用者需要通过服务读取内容后调用setData
+ */
+bool LogTextSource::open(QObject *parent)
+{
+    std::unique_ptr<LogLineStream> stream(new LogLineStream(m_filePath, parent));
+    if (!stream->openDirect())
+        return false;
+    m_stream = std::move(stream);
+    m_buffer.clear();
+    //映射的内容只通过readRange读取
+    m_data = nullptr;
+    m_size = m_stream->mappedSize();
+    m_lineStarts.clear();
+    return true;
+}
+
+/**
+ * @brief LogTextSource::setData 使用已读取的内容
+ * @param data UTF-8内容
+ */
+void LogTextSource::setData(const QByteArray &data)
+{
+    m_stream.reset();
+    m_buffer = data;
+    m_data = m_buffer.constData();
+    m_size = m_buffer.size();
+    m_lineStarts.clear();
+}
+
+/**
+ * @brief LogTextSource::buildIndex 扫描换行符建立行索引,末尾的换行符不产生空行
+ * 映射的文件按块用pread读出后扫描,读取期间文件被截断时停止,不访问映射
+ * @param canRun 为false时中止,用于切换文件时停止解析线程
+ * @return 是否扫描完成
+ */
+bool LogTextSource::buildIndex(const std::atomic_bool &canRun)
+{
+    m_lineStarts.clear();
+    if (m_size <= 0)
+        return true;
+    if (!canRun)
+        return false;
+    m_lineStarts.append(0);
+    auto append = [this, &canRun](qint64 lineStart) {
+        if (m_lineStarts.size() % LOG_TEXT_INDEX_CHECK_LINES == 0 && !canRun)
+            return false;
+        m_lineStarts.append(lineStart);
+        return true;
+    };
+    //最后一个字节不参与查找,末尾的换行符之后没有行
+    if (!m_stream)
+        return LogLineIndexer::forEachNewline(m_data, 0, m_size - 1, [&append](qint64 newline) { return append(newline + 1); });
+
+    QByteArray block;
+    for (qint64 pos = 0; pos < m_size - 1; pos += block.size()) {
+        if (!m_stream->readRange(pos, qMin(m_size - 1, pos + LOG_TEXT_INDEX_BLOCK), block))
+            return false;
+        if (!LogLineIndexer::forEachNewline(block.constData(), 0, block.size(), [&append, pos](qint64 newline) { return append(pos + newline + 1); }))
+            return false;
+    }
+    return true;
+}
+
+/**
+ * @brief LogTextSource::line 解码第i行,\0替换为空格,去掉\x01和行尾的\r
+ * 映射的文件用pread读出这一行再解码,文件被截断后读不到时返回空
+ * @param i 行号,需要在[0, lineCount())范围内
+ */
+QString LogTextSource::line(int i) const
+{
+    const qint64 start = m_lineStarts.at(i);
+    const qint64 end = i + 1 < m_lineStarts.size() ? m_lineStarts.at(i + 1) - 1 : m_size;
+    QByteArray buffer;
+    if (m_stream && !m_stream->readRange(start, end, buffer))
+        return QString();
+    const char *data = m_stream ? buffer.constData() : m_data + start;
+    int length = static_cast<int>(end - start);
+    if (length > 0 && data[length - 1] == '\n')
+        --length;
+    if (length > 0 && data[length - 1] == '\r')
+        --length;
+    return LogLineStream::decodeLine(data, length);
+}
+
+/**
+ * @brief LogTextSource::isValid 映射的文件被截断后内容不再完整,读不到的行返回空
+ */
+bool LogTextSource::isValid() const
+{
+    return !m_stream || !m_stream->fileShrank();
+}
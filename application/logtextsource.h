@@ -0,0 +1,66 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGTEXTSOURCE_H
+#define LOGTEXTSOURCE_H
+
+#include <QByteArray>
+#include <QMetaType>
+#include <QString>
+#include <QVector>
+
+#include <atomic>
+#include <memory>
+
+class LogLineStream;
+class QObject;
+
+//建立行索引时每扫描这么多行检查一次是否需要停止
+#define LOG_TEXT_INDEX_CHECK_LINES 65536
+//映射的文件建立行索引时每次读取的字节数
+#define LOG_TEXT_INDEX_BLOCK (1024 * 1024)
+
+/**
+ * @brief The LogTextSource class 按行访问的日志文件内容,供分页显示
+ * 当前用户可读或服务能传回描述符时直接打开文件(压缩日志解压到内存),否则保存服务读回的内容;
+ * 打开的文件用pread读取,不访问映射,文件被截断时不会触发SIGBUS;
+ * 建立行索引后只读,可以在线程间共享,取某一行时才读取和解码
+ */
+class LogTextSource
+{
+public:
+    explicit LogTextSource(const QString &filePath);
+    ~LogTextSource();
+
+    bool open(QObject *parent = nullptr);
+    void setData(const QByteArray &data);
+    bool buildIndex(const std::atomic_bool &canRun);
+
+    const QString &filePath() const { return m_filePath; }
+    int lineCount() const { return m_lineStarts.size(); }
+    qint64 size() const { return m_size; }
+    QString line(int i) const;
+    bool isValid() const;
+
+private:
+    Q_DISABLE_COPY(LogTextSource)
+
+    QString m_filePath;
+    /**
+     * @brief m_stream 直接读取文件时持有打开的文件,为空表示内容在m_buffer中
+     */
+    std::unique_ptr<LogLineStream> m_stream;
+    QByteArray m_buffer;
+    const char *m_data = nullptr;
+    qint64 m_size = 0;
+    /**
+     * @brief m_lineStarts 每一行的起始偏移,行的结束位置为下一行起始偏移前的换行符
+     */
+    QVector<qint64> m_lineStarts;
+};
+
+using LogTextSourcePtr = std::shared_ptr<const LogTextSource>;
+Q_DECLARE_METATYPE(LogTextSourcePtr)
+
+#endif // LOGTEXTSOURCE_H
@@ -0,0 +1,232 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logtimeindex.h"
+#include "loglinestream.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDate>
+#include <QDir>
+#include <QFile>
+#include <QLoggingCategory>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+#include <algorithm>
+#include <sys/stat.h>
+
+#ifdef QT_DEBUG
+Q_LOGGING_CATEGORY(logTimeIndex, "org.deepin.log.viewer.time.index")
+#else
+Q_LOGGING_CATEGORY(logTimeIndex, "org.deepin.log.viewer.time.index", QtInfoMsg)
+#endif
+
+//索引文件的标识和格式版本
+#define LOG_TIME_INDEX_MAGIC 0x4c544958
+#define LOG_TIME_INDEX_VERSION 1
+
+/**
+ * @brief LogTimeIndex::LogTimeIndex 构造函数
+ * @param filePath 日志文件路径
+ * @param kind 取时间的规则名称,如line、app
+ */
+LogTimeIndex::LogTimeIndex(const QString &filePath, const QString &kind)
+    : m_filePath(filePath)
+    , m_kind(kind)
+{
+}
+
+/**
+ * @brief LogTimeIndex::update 读取保存的索引,文件追加了内容时从上次的结尾继续建立,无效时重新建立,完成后保存
+ * @param data 内存中的文件内容
+ * @param size 内容长度
+ * @param lineTime 取出一行的时间
+ * @return 索引是否可用,小文件或取不到文件信息时返回false
+ */
+bool LogTimeIndex::update(const char *data, qint64 size, const LineTimeFunc &lineTime)
+{
+    m_reused = false;
+    if (!data)
+        return false;
+    return update([data](qint64 begin, qint64 end, QByteArray &out) {
+        out = QByteArray::fromRawData(data + begin, static_cast<int>(end - begin));
+        return true;
+    }, size, lineTime);
+}
+
+/**
+ * @brief LogTimeIndex::update 同上,内容通过read按块读取,用于映射的文件,避免文件被截断时访问映射
+ * @param read 读取[begin, end)的内容,通常为LogLineStream::readRange
+ * @return 索引是否可用,小文件、取不到文件信息或读取失败时返回false
+ */
+bool LogTimeIndex::update(const ReadFunc &read, qint64 size, const LineTimeFunc &lineTime)
+{
+    m_reused = false;
+    FileKey key;
+    if (size < LOG_TIME_INDEX_MIN_SIZE || !statFile(key))
+        return false;
+    //映射之后文件可能又追加了内容,以映射的长度为准
+    key.size = size;
+    QByteArray head;
+    if (!read(0, qMin<qint64>(size, LOG_TIME_INDEX_HEAD_SIZE), head))
+        return false;
+    //read可能返回不拷贝的数据,保存前先拷贝
+    head.detach();
+
+    m_reused = load(key, head);
+    if (m_reused && m_indexedSize == size)
+        return true;
+
+    qint64 from = 0;
+    if (m_reused) {
+        //最后一个间隔可能不完整,从它开始重新采样
+        from = m_indexedSize / LOG_TIME_INDEX_SPAN * LOG_TIME_INDEX_SPAN;
+        while (!m_entries.isEmpty() && m_entries.last().offset >= from)
+            m_entries.removeLast();
+    } else {
+        m_entries.clear();
+    }
+    if (!extend(read, size, from, lineTime)) {
+        //文件被截断,采样不完整,不保存
+        m_entries.clear();
+        m_reused = false;
+        return false;
+    }
+    m_indexedSize = size;
+    m_sorted = true;
+    for (int i = 1; i < m_entries.size() && m_sorted; ++i)
+        m_sorted = m_entries.at(i).time >= m_entries.at(i - 1).time;
+
+    if (!save(key, head))
+        qCDebug(logTimeIndex) << "save time index failed:" << indexPath();
+    qCDebug(logTimeIndex) << "time index updated:" << m_filePath << "from" << from << "entries" << m_entries.size();
+    return true;
+}
+
+/**
+ * @brief LogTimeIndex::range 时间段[begin, end]所在的字节范围
+ * 结果只会比时间段大,两端都落在带时间的行首,不会拆开多行记录;调用者仍需逐行筛选
+ * @return 时间不是顺序的或没有索引时返回false
+ */
+bool LogTimeIndex::range(qint64 begin, qint64 end, qint64 &rangeBegin, qint64 &rangeEnd) const
+{
+    if (!m_sorted || m_entries.isEmpty() || begin > end)
+        return false;
+    //最后一条早于begin的采样之前的行都早于begin
+    auto first = std::lower_bound(m_entries.constBegin(), m_entries.constEnd(), begin, [](const Entry &entry, qint64 time) {
+        return entry.time < time;
+    });
+    rangeBegin = first == m_entries.constBegin() ? 0 : (first - 1)->offset;
+    //第一条晚于end的采样及之后的行都晚于end
+    auto last = std::upper_bound(m_entries.constBegin(), m_entries.constEnd(), end, [](qint64 time, const Entry &entry) {
+        return time < entry.time;
+    });
+    rangeEnd = last == m_entries.constEnd() ? m_indexedSize : last->offset;
+    if (rangeEnd < rangeBegin)
+        rangeEnd = rangeBegin;
+    return true;
+}
+
+/**
+ * @brief LogTimeIndex::indexPath 索引文件路径,按取时间的规则和日志路径命名
+ */
+QString LogTimeIndex::indexPath() const
+{
+    const QByteArray name = QCryptographicHash::hash((m_kind + '\n' + m_filePath).toUtf8(), QCryptographicHash::Sha1).toHex();
+    return indexDir() + "/" + QString::fromLatin1(name) + ".idx";
+}
+
+/**
+ * @brief LogTimeIndex::indexDir 索引文件所在目录
+ */
+QString LogTimeIndex::indexDir()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/time-index";
+}
+
+bool LogTimeIndex::statFile(FileKey &key) const
+{
+    struct stat st;
+    if (stat(QFile::encodeName(m_filePath).constData(), &st) != 0)
+        return false;
+    key.device = static_cast<quint64>(st.st_dev);
+    key.inode = static_cast<quint64>(st.st_ino);
+    key.size = st.st_size;
+    key.mtime = static_cast<qint64>(st.st_mtime);
+    return true;
+}
+
+/**
+ * @brief LogTimeIndex::load 读取保存的索引
+ * 同一个文件(设备号、inode)、没有变小、开头没有被改写且建立索引的年份相同(syslog格式没有年份)时有效;
+ * 大小没有变化而修改时间变了说明内容被原地改写,需要重新建立
+ */
+bool LogTimeIndex::load(const FileKey &key, const QByteArray &head)
+{
+    QFile file(indexPath());
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+    QDataStream in(&file);
+    quint32 magic = 0;
+    qint32 version = 0;
+    FileKey saved;
+    qint32 year = 0;
+    QByteArray savedHead;
+    bool sorted = true;
+    qint32 count = 0;
+    in >> magic >> version >> saved.device >> saved.inode >> saved.size >> saved.mtime >> year >> savedHead >> sorted >> count;
+    if (in.status() != QDataStream::Ok || magic != LOG_TIME_INDEX_MAGIC || version != LOG_TIME_INDEX_VERSION)
+        return false;
+    if (saved.device != key.device || saved.inode != key.inode || saved.size > key.size
+            || (saved.size == key.size && saved.mtime != key.mtime)
+            || year != QDate::currentDate().year() || !head.startsWith(savedHead) || count < 0)
+        return false;
+
+    QVector<Entry> entries(count);
+    for (Entry &entry : entries)
+        in >> entry.offset >> entry.time;
+    if (in.status() != QDataStream::Ok)
+        return false;
+    m_entries = entries;
+    m_indexedSize = saved.size;
+    m_sorted = sorted;
+    return true;
+}
+
+bool LogTimeIndex::save(const FileKey &key, const QByteArray &head) const
+{
+    if (!QDir().mkpath(indexDir()))
+        return false;
+    QSaveFile file(indexPath());
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+    QDataStream out(&file);
+    out << quint32(LOG_TIME_INDEX_MAGIC) << qint32(LOG_TIME_INDEX_VERSION) << key.device << key.inode << key.size
+        << key.mtime << qint32(QDate::currentDate().year()) << head << m_sorted << qint32(m_entries.size());
+    for (const Entry &entry : m_entries)
+        out << entry.offset << entry.time;
+    return out.status() == QDataStream::Ok && file.commit();
+}
+
+/**
+ * @brief LogTimeIndex::extend 从from开始每LOG_TIME_INDEX_SPAN字节采样一次,记录该间隔中第一条带时间的行
+ * 每个采样点只读取和解码几行,不需要读取整个文件
+ * @return 读取失败(文件被截断)时返回false
+ */
+bool LogTimeIndex::extend(const ReadFunc &read, qint64 size, qint64 from, const LineTimeFunc &lineTime)
+{
+    for (qint64 base = from; base < size; base += LOG_TIME_INDEX_SPAN) {
+        const qint64 limit = qMin(base + LOG_TIME_INDEX_SPAN, size);
+        Entry entry;
+        //从base之后的第一个行首开始,base正好是行首时也包括在内
+        const int found = LogLineStream::sampleLine(read, size, base - 1, limit, LOG_TIME_INDEX_SAMPLE_LINES, lineTime,
+                                                    entry.offset, entry.time);
+        if (found < 0)
+            return false;
+        if (found > 0)
+            m_entries.append(entry);
+    }
+    return true;
+}
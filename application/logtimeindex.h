@@ -0,0 +1,87 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGTIMEINDEX_H
+#define LOGTIMEINDEX_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+#include <functional>
+
+//索引的间隔,每这么多字节记录一条
+#define LOG_TIME_INDEX_SPAN (64 * 1024)
+//小于这么大的文件不建立索引,直接二分查找
+#define LOG_TIME_INDEX_MIN_SIZE (1024 * 1024)
+//每个采样点最多向后找这么多行带时间的行
+#define LOG_TIME_INDEX_SAMPLE_LINES 64
+//按LogLineFilter::prefixTime取时间的索引名称,kern、dpkg、audit共用
+#define LOG_TIME_INDEX_LINE "line"
+//按应用日志行首格式取时间的索引名称
+#define LOG_TIME_INDEX_APP "app"
+//校验文件开头没有被改写时比较的字节数
+#define LOG_TIME_INDEX_HEAD_SIZE 4096
+
+/**
+ * @brief The LogTimeIndex class 文本日志的时间稀疏索引,保存在缓存目录下,和日志文件一一对应
+ * 每LOG_TIME_INDEX_SPAN字节记录一条"偏移 -> 该处第一条带时间的行的时间";
+ * 按inode、大小、修改时间和文件开头的校验判断是否有效,文件只追加时从上次的结尾继续建立,
+ * 之后按时间段筛选时直接查索引得到读取范围,不再每次在文件上二分采样
+ */
+class LogTimeIndex
+{
+public:
+    struct Entry {
+        //行首偏移
+        qint64 offset = 0;
+        //时间,毫秒
+        qint64 time = 0;
+    };
+    /**
+     * @brief LineTimeFunc 取出一行的时间(毫秒),没有时间的行返回-1
+     */
+    typedef std::function<qint64(const QString &line)> LineTimeFunc;
+    /**
+     * @brief ReadFunc 读取日志[begin, end)的内容,读不满(文件被截断)时返回false
+     */
+    typedef std::function<bool(qint64 begin, qint64 end, QByteArray &data)> ReadFunc;
+
+    LogTimeIndex(const QString &filePath, const QString &kind);
+
+    bool update(const char *data, qint64 size, const LineTimeFunc &lineTime);
+    bool update(const ReadFunc &read, qint64 size, const LineTimeFunc &lineTime);
+    bool range(qint64 begin, qint64 end, qint64 &rangeBegin, qint64 &rangeEnd) const;
+    const QVector<Entry> &entries() const { return m_entries; }
+    bool isSorted() const { return m_sorted; }
+    //本次update是否从已保存的索引继续,用于测试和日志
+    bool isReused() const { return m_reused; }
+    QString indexPath() const;
+
+    static QString indexDir();
+
+private:
+    struct FileKey {
+        quint64 device = 0;
+        quint64 inode = 0;
+        qint64 size = 0;
+        qint64 mtime = 0;
+    };
+
+    bool statFile(FileKey &key) const;
+    bool load(const FileKey &key, const QByteArray &head);
+    bool save(const FileKey &key, const QByteArray &head) const;
+    bool extend(const ReadFunc &read, qint64 size, qint64 from, const LineTimeFunc &lineTime);
+
+    QString m_filePath;
+    //索引的取时间规则,同一文件按不同规则取时间时各自建立索引
+    QString m_kind;
+    QVector<Entry> m_entries;
+    //已建立索引的长度
+    qint64 m_indexedSize = 0;
+    bool m_sorted = true;
+    bool m_reused = false;
+};
+
+#endif // LOGTIMEINDEX_H
@@ -0,0 +1,159 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logtimeline.h"
+#include "logtracer.h"
+#include "loglocaltime.h"
+
+
+#include <algorithm>
+#include <numeric>
+#include <queue>
+
+void LogTimeline::setSourceEnabled(int source, bool enabled)
+{
+    if (source >= 0 && source < sourceCount())
+        m_sources.at(static_cast<size_t>(source))->enabled = enabled;
+}
+
+bool LogTimeline::isSourceEnabled(int source) const
+{
+    return source >= 0 && source < sourceCount() && m_sources.at(static_cast<size_t>(source))->enabled;
+}
+
+int LogTimeline::sourceCount() const
+{
+    return static_cast<int>(m_sources.size());
+}
+
+QString LogTimeline::sourceName(int source) const
+{
+    if (source < 0 || source >= sourceCount())
+        return QString();
+    return m_sources.at(static_cast<size_t>(source))->name;
+}
+
+void LogTimeline::clear()
+{
+    m_entries.clear();
+    m_sources.clear();
+}
+
+/**
+ * @brief LogTimeline::rebuild 按各来源当前的筛选结果重新归并,时间相同时编号小的来源在前
+ * 各来源已按时间从新到旧排好,堆中只放每个来源的下一条,总开销为O(n log k)
+ */
+void LogTimeline::rebuild()
+{
+    PERF_TRACE_SCOPE("timeline", "rebuild");
+    m_entries.clear();
+
+    //堆顶为时间最新的来源
+    using Head = std::pair<qint64, int>;
+    auto later = [](const Head &a, const Head &b) {
+        return a.first != b.first ? a.first < b.first : a.second > b.second;
+    };
+    std::priority_queue<Head, std::vector<Head>, decltype(later)> heads(later);
+    QVector<int> cursors(sourceCount(), 0);
+    int total = 0;
+    for (int i = 0; i < sourceCount(); ++i) {
+        const Source *source = m_sources.at(static_cast<size_t>(i)).get();
+        if (!source->enabled || source->rows.isEmpty())
+            continue;
+        heads.push({source->keys.first(), i});
+        total += source->rows.size();
+    }
+
+    QList<LogTimelineEntry> entries;
+    entries.reserve(total);
+    while (!heads.empty()) {
+        const int i = heads.top().second;
+        heads.pop();
+        const Source *source = m_sources.at(static_cast<size_t>(i)).get();
+        int &cursor = cursors[i];
+        entries.append({source->keys.at(cursor), i, source->rows.at(cursor)});
+        if (++cursor < source->rows.size())
+            heads.push({source->keys.at(cursor), i});
+    }
+    m_entries.append(entries);
+}
+
+int LogTimeline::size() const
+{
+    return m_entries.size();
+}
+
+const LogTimelineEntry &LogTimeline::at(int i) const
+{
+    return m_entries.at(i);
+}
+
+/**
+ * @brief LogTimeline::view 归并结果的视图,可直接交给LogTableModel,时间线重建或清空后失效
+ */
+LogRecordView<LogTimelineEntry> LogTimeline::view() const
+{
+    return LogRecordView<LogTimelineEntry>::all(&m_entries);
+}
+
+/**
+ * @brief LogTimeline::data 时间线一行在某列某个角色下的数据,来源列显示来源名称,其他列由来源自己的列定义提供
+ */
+QVariant LogTimeline::data(const LogTimelineEntry &entry, int column, int role) const
+{
+    if (entry.source < 0 || entry.source >= sourceCount())
+        return QVariant();
+    const Source *source = m_sources.at(static_cast<size_t>(entry.source)).get();
+    if (column == SourceColumn)
+        return role == Qt::DisplayRole ? QVariant(source->name) : QVariant();
+    if (column == DateTimeColumn && role == LogTableModel::SortKeyRole)
+        return entry.time;
+    return source->data(entry.row, column, role);
+}
+
+/**
+ * @brief LogTimeline::columns 时间线的列定义,来源、等级、时间、信息四列,时间列按毫秒时间戳排序
+ */
+QVector<LogTableModel::Column<LogTimelineEntry>> LogTimeline::columns() const
+{
+    QVector<LogTableModel::Column<LogTimelineEntry>> result;
+    for (int column = 0; column < ColumnCount; ++column) {
+        result.append([this, column](const LogTimelineEntry &entry, int role) {
+            return data(entry, column, role);
+        });
+    }
+    return result;
+}
+
+/**
+ * @brief LogTimeline::dateTimeMSecs "yyyy-MM-dd hh:mm:ss"或带".zzz"毫秒的本地时间文本转为毫秒时间戳,见LogLocalTime::parse
+ * @return 毫秒时间戳,格式不符时为-1
+ */
+qint64 LogTimeline::dateTimeMSecs(const QString &text)
+{
+    return LogLocalTime::parse(text);
+}
+
+/**
+ * @brief LogTimeline::sortNewestFirst 把来源内的下标按时间从新到旧排列,已有序时不再排序
+ * 系统日志、内核日志等读取时本来就是从新到旧,只有时间回拨或从旧到新读取的来源才需要排序
+ */
+void LogTimeline::sortNewestFirst(QVector<quint32> &rows, QVector<qint64> &keys)
+{
+    if (std::is_sorted(keys.constBegin(), keys.constEnd(), std::greater<qint64>()))
+        return;
+    QVector<int> order(keys.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&keys](int a, int b) {
+        return keys.at(a) > keys.at(b);
+    });
+    QVector<quint32> sortedRows(rows.size());
+    QVector<qint64> sortedKeys(keys.size());
+    for (int i = 0; i < order.size(); ++i) {
+        sortedRows[i] = rows.at(order.at(i));
+        sortedKeys[i] = keys.at(order.at(i));
+    }
+    rows.swap(sortedRows);
+    keys.swap(sortedKeys);
+}
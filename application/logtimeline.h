@@ -0,0 +1,201 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGTIMELINE_H
+#define LOGTIMELINE_H
+
+#include "logrecordfilter.h"
+#include "logrecordview.h"
+#include "logtablemodel.h"
+
+#include <QString>
+#include <QVector>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief The LogTimelineEntry struct 时间线中的一行,只记下来源和记录在来源存储中的下标
+ */
+struct LogTimelineEntry {
+    //毫秒时间戳,没有时间的记录为-1
+    qint64 time;
+    qint32 source;
+    quint32 row;
+};
+Q_DECLARE_TYPEINFO(LogTimelineEntry, Q_PRIMITIVE_TYPE);
+
+/**
+ * @brief The LogTimeline class 把多类日志按时间合并成一个视图,便于对照内核、系统服务和软件包的先后关系
+ * 每个来源是一个已加载类别的记录视图,各自带有筛选条件,合并时先在各来源内按时间从新到旧排好下标,
+ * 再用堆多路归并,结果每行只有16字节,不复制任何记录;来源的存储需要比时间线活得久
+ */
+class LogTimeline
+{
+public:
+    enum Column {
+        SourceColumn = 0,
+        LevelColumn,
+        DateTimeColumn,
+        MessageColumn,
+        ColumnCount
+    };
+
+    /**
+     * @brief Fields 来源记录在等级、时间、信息三列的显示,等级为空时该来源不显示等级
+     */
+    template <typename T>
+    struct Fields {
+        LogTableModel::Column<T> level;
+        LogTableModel::Column<T> dateTime;
+        LogTableModel::Column<T> message;
+    };
+
+    template <typename T>
+    int addSource(const QString &name, const LogRecordView<T> &view, const std::function<qint64(const T &)> &timeKey, const Fields<T> &fields);
+    template <typename T>
+    void setSourceView(int source, const LogRecordView<T> &view);
+    template <typename T>
+    void setSourceFilter(int source, const std::function<bool(const T &)> &predicate);
+    void setSourceEnabled(int source, bool enabled);
+    bool isSourceEnabled(int source) const;
+    int sourceCount() const;
+    QString sourceName(int source) const;
+    void clear();
+
+    void rebuild();
+    int size() const;
+    const LogTimelineEntry &at(int i) const;
+    LogRecordView<LogTimelineEntry> view() const;
+    QVariant data(const LogTimelineEntry &entry, int column, int role) const;
+    QVector<LogTableModel::Column<LogTimelineEntry>> columns() const;
+
+    static qint64 dateTimeMSecs(const QString &text);
+
+private:
+    /**
+     * @brief The Source class 类型擦除后的来源,rows和keys为筛选后按时间从新到旧排列的下标和时间
+     */
+    class Source
+    {
+    public:
+        virtual ~Source() {}
+        virtual void refresh() = 0;
+        virtual QVariant data(quint32 row, int column, int role) const = 0;
+
+        QString name;
+        bool enabled = true;
+        QVector<quint32> rows;
+        QVector<qint64> keys;
+    };
+
+    template <typename T>
+    class RecordSource : public Source
+    {
+    public:
+        void refresh() override;
+        QVariant data(quint32 row, int column, int role) const override;
+
+        LogRecordView<T> view;
+        std::function<qint64(const T &)> timeKey;
+        std::function<bool(const T &)> predicate;
+        Fields<T> fields;
+    };
+
+    template <typename T>
+    RecordSource<T> *recordSource(int source) const;
+    static void sortNewestFirst(QVector<quint32> &rows, QVector<qint64> &keys);
+
+    std::vector<std::unique_ptr<Source>> m_sources;
+    LogRecordStore<LogTimelineEntry> m_entries;
+};
+
+/**
+ * @brief LogTimeline::addSource 增加一个来源
+ * @param name 来源名称,显示在来源列
+ * @param view 来源的记录,一般为该类别的完整存储
+ * @param timeKey 记录的毫秒时间戳,会在调用线程中对每条记录调用一次
+ * @param fields 来源在各列的显示
+ * @return 来源编号,按增加的顺序从0开始
+ */
+template <typename T>
+int LogTimeline::addSource(const QString &name, const LogRecordView<T> &view, const std::function<qint64(const T &)> &timeKey, const Fields<T> &fields)
+{
+    auto *source = new RecordSource<T>;
+    source->name = name;
+    source->view = view;
+    source->timeKey = timeKey;
+    source->fields = fields;
+    source->refresh();
+    m_sources.emplace_back(source);
+    return static_cast<int>(m_sources.size()) - 1;
+}
+
+/**
+ * @brief LogTimeline::setSourceView 来源的记录有变化,如追加了新加载的批次,需要再调用rebuild
+ */
+template <typename T>
+void LogTimeline::setSourceView(int source, const LogRecordView<T> &view)
+{
+    RecordSource<T> *recordSource = this->recordSource<T>(source);
+    if (!recordSource)
+        return;
+    recordSource->view = view;
+    recordSource->refresh();
+}
+
+/**
+ * @brief LogTimeline::setSourceFilter 只对一个来源生效的筛选条件,为空时显示全部,需要再调用rebuild
+ * @param predicate 判断函数,会在多个线程中同时调用,必须只读记录
+ */
+template <typename T>
+void LogTimeline::setSourceFilter(int source, const std::function<bool(const T &)> &predicate)
+{
+    RecordSource<T> *recordSource = this->recordSource<T>(source);
+    if (!recordSource)
+        return;
+    recordSource->predicate = predicate;
+    recordSource->refresh();
+}
+
+template <typename T>
+LogTimeline::RecordSource<T> *LogTimeline::recordSource(int source) const
+{
+    if (source < 0 || source >= sourceCount())
+        return nullptr;
+    return dynamic_cast<RecordSource<T> *>(m_sources.at(static_cast<size_t>(source)).get());
+}
+
+template <typename T>
+void LogTimeline::RecordSource<T>::refresh()
+{
+    const LogRecordView<T> filtered = predicate ? LogRecordFilter::filter(view, predicate) : view;
+    rows = filtered.rows();
+    keys.resize(rows.size());
+    for (int i = 0; i < rows.size(); ++i)
+        keys[i] = timeKey(filtered.at(i));
+    sortNewestFirst(rows, keys);
+}
+
+template <typename T>
+QVariant LogTimeline::RecordSource<T>::data(quint32 row, int column, int role) const
+{
+    const LogRecordStore<T> *store = view.store();
+    if (!store || row >= static_cast<quint32>(store->size()))
+        return QVariant();
+    const T &record = store->at(static_cast<int>(row));
+    switch (column) {
+    case LevelColumn:
+        return fields.level ? fields.level(record, role) : QVariant();
+    case DateTimeColumn:
+        return fields.dateTime ? fields.dateTime(record, role) : QVariant();
+    case MessageColumn:
+        return fields.message ? fields.message(record, role) : QVariant();
+    default:
+        return QVariant();
+    }
+}
+
+#endif // LOGTIMELINE_H
@@ -0,0 +1,286 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logtracer.h"
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLoggingCategory>
+#include <QSaveFile>
+#include <QSocketNotifier>
+#include <QThread>
+
+#include <signal.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifdef QT_DEBUG
+Q_LOGGING_CATEGORY(logTracer, "org.deepin.log.viewer.tracer")
+#else
+Q_LOGGING_CATEGORY(logTracer, "org.deepin.log.viewer.tracer", QtInfoMsg)
+#endif
+
+std::atomic<bool> LogTracer::s_enabled(!qgetenv(LOG_TRACE_ENV).isEmpty());
+
+namespace {
+//当前线程的缓冲,第一次记录时注册到LogTracer
+thread_local LogTraceBuffer *t_buffer = nullptr;
+
+//SIGUSR1处理函数只写socket,由界面线程的QSocketNotifier导出
+int s_dumpSocket[2] = {-1, -1};
+
+void dumpSignalHandler(int)
+{
+    char c = 1;
+    ssize_t ret = ::write(s_dumpSocket[0], &c, sizeof(c));
+    Q_UNUSED(ret)
+}
+
+void copyText(char *dest, int size, const QByteArray &text)
+{
+    const int len = qMin(text.size(), size - 1);
+    memcpy(dest, text.constData(), static_cast<size_t>(len));
+    dest[len] = '\0';
+}
+}
+
+LogTraceBuffer::LogTraceBuffer(qint64 tid, const QString &threadName)
+    : m_tid(tid)
+    , m_threadName(threadName)
+{
+    for (auto &chunk : m_chunks)
+        chunk.store(nullptr, std::memory_order_relaxed);
+}
+
+LogTraceBuffer::~LogTraceBuffer()
+{
+    for (auto &chunk : m_chunks)
+        delete[] chunk.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief LogTraceBuffer::append 追加一个事件,只能由所属线程调用,写满后丢弃并计数
+ */
+void LogTraceBuffer::append(const LogTraceEvent &event)
+{
+    const int index = m_size.load(std::memory_order_relaxed);
+    const int chunkIndex = index / LOG_TRACE_CHUNK_SIZE;
+    if (chunkIndex >= LOG_TRACE_MAX_CHUNKS) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    LogTraceEvent *chunk = m_chunks[chunkIndex].load(std::memory_order_relaxed);
+    if (!chunk) {
+        chunk = new LogTraceEvent[LOG_TRACE_CHUNK_SIZE];
+        m_chunks[chunkIndex].store(chunk, std::memory_order_release);
+    }
+    chunk[index % LOG_TRACE_CHUNK_SIZE] = event;
+    m_size.store(index + 1, std::memory_order_release);
+}
+
+int LogTraceBuffer::size() const
+{
+    return m_size.load(std::memory_order_acquire);
+}
+
+/**
+ * @brief LogTraceBuffer::at 读取已发布的事件,index必须小于之前size()的返回值
+ */
+const LogTraceEvent &LogTraceBuffer::at(int index) const
+{
+    const LogTraceEvent *chunk = m_chunks[index / LOG_TRACE_CHUNK_SIZE].load(std::memory_order_acquire);
+    return chunk[index % LOG_TRACE_CHUNK_SIZE];
+}
+
+int LogTraceBuffer::dropped() const
+{
+    return m_dropped.load(std::memory_order_relaxed);
+}
+
+LogTracer::LogTracer()
+    : m_outputPath(QString::fromLocal8Bit(qgetenv(LOG_TRACE_ENV)))
+    , m_pid(static_cast<int>(::getpid()))
+{
+}
+
+LogTracer *LogTracer::instance()
+{
+    static LogTracer tracer;
+    return &tracer;
+}
+
+void LogTracer::setEnabled(bool enabled)
+{
+    s_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+/**
+ * @brief LogTracer::now CLOCK_MONOTONIC的微秒数,与DebugTimeManager的打点使用同一时钟
+ */
+qint64 LogTracer::now()
+{
+    timespec time;
+    if (clock_gettime(CLOCK_MONOTONIC, &time))
+        return 0;
+    return static_cast<qint64>(time.tv_sec) * 1000000 + time.tv_nsec / 1000;
+}
+
+QString LogTracer::outputPath() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_outputPath;
+}
+
+void LogTracer::setOutputPath(const QString &path)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_outputPath = path;
+}
+
+void LogTracer::record(const char *category, const char *name, qint64 begin, qint64 end, const QString &args)
+{
+    if (isEnabled())
+        append(category, QByteArray::fromRawData(name, static_cast<int>(qstrlen(name))), begin, end, args);
+}
+
+void LogTracer::record(const char *category, const QString &name, qint64 begin, qint64 end, const QString &args)
+{
+    if (isEnabled())
+        append(category, name.toUtf8(), begin, end, args);
+}
+
+void LogTracer::append(const char *category, const QByteArray &name, qint64 begin, qint64 end, const QString &args)
+{
+    LogTraceEvent event;
+    event.category = category;
+    copyText(event.name, LOG_TRACE_NAME_SIZE, name);
+    copyText(event.args, LOG_TRACE_ARGS_SIZE, args.toUtf8());
+    event.begin = begin;
+    event.duration = qMax<qint64>(0, end - begin);
+    currentBuffer()->append(event);
+}
+
+/**
+ * @brief LogTracer::currentBuffer 当前线程的缓冲,只在线程第一次记录时加锁注册
+ * 线程结束后缓冲仍保留,线程池中已退出线程的事件也能导出
+ */
+LogTraceBuffer *LogTracer::currentBuffer()
+{
+    if (t_buffer)
+        return t_buffer;
+
+    const qint64 tid = static_cast<qint64>(::syscall(SYS_gettid));
+    QString threadName = QThread::currentThread()->objectName();
+    if (threadName.isEmpty()) {
+        if (QCoreApplication::instance() && QThread::currentThread() == QCoreApplication::instance()->thread())
+            threadName = "main";
+        else
+            threadName = QString("thread-%1").arg(tid);
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_buffers.emplace_back(new LogTraceBuffer(tid, threadName));
+    t_buffer = m_buffers.back().get();
+    return t_buffer;
+}
+
+/**
+ * @brief LogTracer::toJson 所有线程已记录的事件,Chrome trace event格式
+ */
+QByteArray LogTracer::toJson() const
+{
+    QJsonArray events;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const auto &buffer : m_buffers) {
+        QJsonObject threadName;
+        threadName.insert("name", "thread_name");
+        threadName.insert("ph", "M");
+        threadName.insert("pid", m_pid);
+        threadName.insert("tid", buffer->tid());
+        threadName.insert("args", QJsonObject {{"name", buffer->threadName()}});
+        events.append(threadName);
+
+        const int count = buffer->size();
+        for (int i = 0; i < count; ++i) {
+            const LogTraceEvent &event = buffer->at(i);
+            QJsonObject object;
+            object.insert("name", QString::fromUtf8(event.name));
+            object.insert("cat", QString::fromLatin1(event.category));
+            object.insert("ph", "X");
+            object.insert("ts", event.begin);
+            object.insert("dur", event.duration);
+            object.insert("pid", m_pid);
+            object.insert("tid", buffer->tid());
+            if (event.args[0] != '\0')
+                object.insert("args", QJsonObject {{"detail", QString::fromUtf8(event.args)}});
+            events.append(object);
+        }
+        if (buffer->dropped() > 0)
+            qCWarning(logTracer) << "trace buffer full, thread:" << buffer->threadName() << "dropped:" << buffer->dropped();
+    }
+
+    QJsonObject root;
+    root.insert("traceEvents", events);
+    root.insert("displayTimeUnit", "ms");
+    return QJsonDocument(root).toJson(QJsonDocument::Compact);
+}
+
+/**
+ * @brief LogTracer::dump 写入trace文件,可用chrome://tracing或ui.perfetto.dev打开
+ * @param path 输出路径,为空时使用环境变量指定的路径
+ */
+bool LogTracer::dump(const QString &path) const
+{
+    const QString outPath = path.isEmpty() ? outputPath() : path;
+    if (outPath.isEmpty())
+        return false;
+
+    QSaveFile file(outPath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCWarning(logTracer) << "open trace file failed:" << outPath;
+        return false;
+    }
+    file.write(toJson());
+    if (!file.commit()) {
+        qCWarning(logTracer) << "write trace file failed:" << outPath;
+        return false;
+    }
+    qCInfo(logTracer) << "trace written to" << outPath;
+    return true;
+}
+
+/**
+ * @brief LogTracer::installDumpSignal 开启追踪时,收到SIGUSR1即导出,便于在现场机器上按需抓取
+ * @param context 接收通知的对象,一般为QApplication
+ */
+void LogTracer::installDumpSignal(QObject *context)
+{
+    if (!isEnabled() || s_dumpSocket[0] >= 0)
+        return;
+    if (::socketpair(AF_UNIX, SOCK_STREAM, 0, s_dumpSocket)) {
+        qCWarning(logTracer) << "create trace signal socket failed";
+        return;
+    }
+
+    auto *notifier = new QSocketNotifier(s_dumpSocket[1], QSocketNotifier::Read, context);
+    QObject::connect(notifier, &QSocketNotifier::activated, context, [this]() {
+        char c = 0;
+        ssize_t ret = ::read(s_dumpSocket[1], &c, sizeof(c));
+        Q_UNUSED(ret)
+        dump();
+    });
+
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = dumpSignalHandler;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    sigaction(SIGUSR1, &action, nullptr);
+}
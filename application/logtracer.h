@@ -0,0 +1,154 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGTRACER_H
+#define LOGTRACER_H
+
+#include <QByteArray>
+#include <QString>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class QObject;
+
+//环境变量,值为trace文件的输出路径,设置后开启追踪
+#define LOG_TRACE_ENV "DEEPIN_LOG_VIEWER_TRACE"
+//每个线程的事件按块分配,每块的事件数
+#define LOG_TRACE_CHUNK_SIZE 1024
+//每个线程最多的块数,写满后丢弃新事件
+#define LOG_TRACE_MAX_CHUNKS 64
+//事件名称和参数的最大字节数,超出部分截断
+#define LOG_TRACE_NAME_SIZE 48
+#define LOG_TRACE_ARGS_SIZE 96
+
+#define LOG_TRACE_CONCAT_IMPL(a, b) a##b
+#define LOG_TRACE_CONCAT(a, b) LOG_TRACE_CONCAT_IMPL(a, b)
+/**
+ * @brief PERF_TRACE_SCOPE 记录当前作用域的耗时,category和name必须是字符串常量
+ */
+#define PERF_TRACE_SCOPE(category, name) \
+    LogTraceSpan LOG_TRACE_CONCAT(logTraceSpan, __LINE__)(category, name)
+/**
+ * @brief PERF_TRACE_SCOPE_ARGS 同PERF_TRACE_SCOPE,并附带参数说明,未开启追踪时不计算args
+ */
+#define PERF_TRACE_SCOPE_ARGS(category, name, args) \
+    LogTraceSpan LOG_TRACE_CONCAT(logTraceSpan, __LINE__)(category, name); \
+    if (LOG_TRACE_CONCAT(logTraceSpan, __LINE__).isActive()) \
+        LOG_TRACE_CONCAT(logTraceSpan, __LINE__).setArgs(args)
+
+/**
+ * @brief The LogTraceEvent struct 一段已结束的耗时,时间为CLOCK_MONOTONIC的微秒数
+ */
+struct LogTraceEvent {
+    const char *category;
+    char name[LOG_TRACE_NAME_SIZE];
+    char args[LOG_TRACE_ARGS_SIZE];
+    qint64 begin;
+    qint64 duration;
+};
+
+/**
+ * @brief The LogTraceBuffer class 单个线程的事件缓冲
+ * 只有所属线程追加,导出时其他线程只读已发布的部分,两者之间不加锁
+ */
+class LogTraceBuffer
+{
+public:
+    LogTraceBuffer(qint64 tid, const QString &threadName);
+    ~LogTraceBuffer();
+    LogTraceBuffer(const LogTraceBuffer &) = delete;
+    LogTraceBuffer &operator=(const LogTraceBuffer &) = delete;
+
+    void append(const LogTraceEvent &event);
+    int size() const;
+    const LogTraceEvent &at(int index) const;
+    int dropped() const;
+
+    qint64 tid() const { return m_tid; }
+    QString threadName() const { return m_threadName; }
+
+private:
+    qint64 m_tid;
+    QString m_threadName;
+    std::atomic<LogTraceEvent *> m_chunks[LOG_TRACE_MAX_CHUNKS];
+    /**
+     * @brief m_size 已发布的事件数,先写事件再以release发布
+     */
+    std::atomic<int> m_size {0};
+    std::atomic<int> m_dropped {0};
+};
+
+/**
+ * @brief The LogTracer class 低开销的分线程耗时追踪,导出为Chrome/Perfetto可读取的trace json
+ * 设置环境变量DEEPIN_LOG_VIEWER_TRACE=<文件路径>开启,退出时或收到SIGUSR1时写入该文件;
+ * 未开启时每个打点只有一次原子读取
+ */
+class LogTracer
+{
+public:
+    static LogTracer *instance();
+
+    static bool isEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+    static void setEnabled(bool enabled);
+    static qint64 now();
+
+    QString outputPath() const;
+    void setOutputPath(const QString &path);
+
+    void record(const char *category, const char *name, qint64 begin, qint64 end, const QString &args = QString());
+    void record(const char *category, const QString &name, qint64 begin, qint64 end, const QString &args = QString());
+
+    QByteArray toJson() const;
+    bool dump(const QString &path = QString()) const;
+    void installDumpSignal(QObject *context);
+
+private:
+    LogTracer();
+    LogTraceBuffer *currentBuffer();
+    void append(const char *category, const QByteArray &name, qint64 begin, qint64 end, const QString &args);
+
+    static std::atomic<bool> s_enabled;
+    /**
+     * @brief m_mutex 保护线程缓冲列表和输出路径,追加事件时不使用
+     */
+    mutable std::mutex m_mutex;
+    std::vector<std::unique_ptr<LogTraceBuffer>> m_buffers;
+    QString m_outputPath;
+    int m_pid;
+};
+
+/**
+ * @brief The LogTraceSpan class 构造时记录开始时间,析构时记录一段耗时到当前线程的缓冲
+ */
+class LogTraceSpan
+{
+public:
+    LogTraceSpan(const char *category, const char *name)
+        : m_category(category)
+        , m_name(name)
+        , m_begin(LogTracer::isEnabled() ? LogTracer::now() : -1)
+    {
+    }
+    ~LogTraceSpan()
+    {
+        if (m_begin >= 0)
+            LogTracer::instance()->record(m_category, m_name, m_begin, LogTracer::now(), m_args);
+    }
+    LogTraceSpan(const LogTraceSpan &) = delete;
+    LogTraceSpan &operator=(const LogTraceSpan &) = delete;
+
+    bool isActive() const { return m_begin >= 0; }
+    void setArgs(const QString &args) { m_args = args; }
+
+private:
+    const char *m_category;
+    const char *m_name;
+    qint64 m_begin;
+    QString m_args;
+};
+
+#endif // LOGTRACER_H
@@ -3,6 +3,7 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "logtreeview.h"
+#include "logscrollbar.h"
 #include "structdef.h"
 #include "logviewheaderview.h"
 #include "logviewitemdelegate.h"
@@ -71,8 +72,11 @@ void LogTreeView::initUI()
     this->setEditTriggers(QAbstractItemView::NoEditTriggers);
     this->setRootIsDecorated(false);
 
-    //这个设置默认是值是ScrollPerPixel，和我们想要的Mode不一样，我们要通过纵向滚动实现分页的
+    m_scrollBar = new LogScrollBar(Qt::Vertical, this);
+    setVerticalScrollBar(m_scrollBar);
     this->setVerticalScrollMode(QAbstractItemView::ScrollMode::ScrollPerPixel);
+    //所有行等高,model中是全部记录,视图按行高直接计算滚动范围和可见行,不必逐行测量
+    this->setUniformRowHeights(true);
 
     setSelectionMode(QAbstractItemView::SingleSelection);
     setSelectionBehavior(QAbstractItemView::SelectRows);
@@ -266,3 +270,29 @@ void LogTreeView::focusInEvent(QFocusEvent *event)
     m_reson = event->reason();
     DTreeView::focusInEvent(event);
 }
+
+/**
+ * @brief LogTreeView::rowsInserted 刷新得到的新记录插入到头部时,已向下滚动的视图保持当前看到的行不动,
+ * 选中行由选择模型随插入自动后移;视图在顶部时照常显示新记录
+ */
+void LogTreeView::rowsInserted(const QModelIndex &parent, int start, int end)
+{
+    if (!parent.isValid() && start == 0 && verticalScrollBar()->value() > 0 && model() && model()->rowCount() > end + 1)
+        m_pendingTopRows += end - start + 1;
+    DTreeView::rowsInserted(parent, start, end);
+}
+
+/**
+ * @brief LogTreeView::updateGeometries 插入行后的延迟布局完成时滚动条范围才更新,此时再补上头部插入的行高
+ */
+void LogTreeView::updateGeometries()
+{
+    DTreeView::updateGeometries();
+    if (m_pendingTopRows > 0) {
+        const int rows = m_pendingTopRows;
+        m_pendingTopRows = 0;
+        const int height = singleRowHeight();
+        if (height > 0)
+            verticalScrollBar()->setValue(verticalScrollBar()->value() + rows * height);
+    }
+}
@@ -11,12 +11,14 @@
 class QKeyEvent;
 class LogViewHeaderView;
 class LogViewItemDelegate;
+class LogScrollBar;
 class QTime;
 class LogTreeView : public Dtk::Widget::DTreeView
 {
 public:
     explicit LogTreeView(QWidget *parent = nullptr);
     int singleRowHeight();
+    LogScrollBar *logScrollBar() const { return m_scrollBar; }
 protected:
     void initUI();
     void paintEvent(QPaintEvent *event) override;
@@ -27,10 +29,14 @@ protected:
     void mouseMoveEvent(QMouseEvent *event) override;
     void mouseReleaseEvent(QMouseEvent *event) Q_DECL_OVERRIDE;
     void focusInEvent(QFocusEvent *event)override;
+    void rowsInserted(const QModelIndex &parent, int start, int end) override;
+    void updateGeometries() override;
 
 private:
     LogViewItemDelegate *m_itemDelegate;
     LogViewHeaderView *m_headerDelegate;
+    //带时间密度和搜索命中缩略图的纵向滚动条
+    LogScrollBar *m_scrollBar {nullptr};
     // 记录触摸按下事件，在mouse move事件中使用，用于判断手指移动的距离，当大于
     // QPlatformTheme::TouchDoubleTapDistance 的值时认为触发触屏滚动
     QPoint lastTouchBeginPos;
@@ -40,6 +46,8 @@ private:
     QPointF m_lastTouchBeginPos;
     QTime m_lastTouchTime;
     Qt::FocusReason m_reson = Qt::MouseFocusReason;
+    //刷新时插入到头部、还未完成布局的行数,布局后按行高下移滚动条
+    int m_pendingTopRows = 0;
 };
 
 #endif  // LOGTREEVIEW_H
@@ -0,0 +1,78 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logtrigrambloom.h"
+
+//布隆过滤器的位数掩码
+#define LOG_BLOOM_MASK (LOG_BLOOM_BYTES * 8 - 1)
+
+namespace {
+inline quint32 trigramAt(const char *p)
+{
+    return static_cast<uchar>(p[0]) | static_cast<uchar>(p[1]) << 8 | static_cast<uchar>(p[2]) << 16;
+}
+}
+
+LogTrigramBloom::LogTrigramBloom()
+    : m_bits(LOG_BLOOM_BYTES, '\0')
+{
+}
+
+/**
+ * @brief LogTrigramBloom::add 记录一列文本的所有三元组,三元组不跨列
+ */
+void LogTrigramBloom::add(const QString &text)
+{
+    const QByteArray folded = text.toCaseFolded().toUtf8();
+    uchar *bits = reinterpret_cast<uchar *>(m_bits.data());
+    quint32 first = 0;
+    quint32 second = 0;
+    for (int i = 0; i + 3 <= folded.size(); ++i) {
+        positions(trigramAt(folded.constData() + i), first, second);
+        bits[first >> 3] |= static_cast<uchar>(1u << (first & 7));
+        bits[second >> 3] |= static_cast<uchar>(1u << (second & 7));
+    }
+}
+
+void LogTrigramBloom::clear()
+{
+    m_bits.fill('\0');
+}
+
+/**
+ * @brief LogTrigramBloom::trigrams 关键字的三元组,已去重;不足3字节时为空
+ */
+QVector<quint32> LogTrigramBloom::trigrams(const QString &keyword)
+{
+    const QByteArray folded = keyword.toCaseFolded().toUtf8();
+    QVector<quint32> result;
+    for (int i = 0; i + 3 <= folded.size(); ++i) {
+        const quint32 trigram = trigramAt(folded.constData() + i);
+        if (!result.contains(trigram))
+            result.append(trigram);
+    }
+    return result;
+}
+
+/**
+ * @brief LogTrigramBloom::mayContain 位图中是否可能包含所有三元组
+ * @param bits LOG_BLOOM_BYTES字节的位图
+ */
+bool LogTrigramBloom::mayContain(const uchar *bits, const QVector<quint32> &trigrams)
+{
+    quint32 first = 0;
+    quint32 second = 0;
+    for (quint32 trigram : trigrams) {
+        positions(trigram, first, second);
+        if (!(bits[first >> 3] & (1u << (first & 7))) || !(bits[second >> 3] & (1u << (second & 7))))
+            return false;
+    }
+    return true;
+}
+
+void LogTrigramBloom::positions(quint32 trigram, quint32 &first, quint32 &second)
+{
+    first = (trigram * 0x9e3779b1u) >> 7 & LOG_BLOOM_MASK;
+    second = (trigram * 0x85ebca77u) >> 11 & LOG_BLOOM_MASK;
+}
@@ -0,0 +1,37 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGTRIGRAMBLOOM_H
+#define LOGTRIGRAMBLOOM_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+//每个记录块的布隆过滤器字节数,4096行日志的不同三元组通常在5万以内,误判率约10%,多个三元组同时误判的概率很低
+#define LOG_BLOOM_BYTES (32 * 1024)
+
+/**
+ * @brief The LogTrigramBloom class 一组文本中出现过的三元组(大小写折叠后UTF-8的连续3字节)的布隆过滤器
+ * 关键字的所有三元组都可能出现时才需要逐条比较;关键字不足3字节时总是可能匹配
+ */
+class LogTrigramBloom
+{
+public:
+    LogTrigramBloom();
+
+    void add(const QString &text);
+    void clear();
+    const QByteArray &bits() const { return m_bits; }
+
+    static QVector<quint32> trigrams(const QString &keyword);
+    static bool mayContain(const uchar *bits, const QVector<quint32> &trigrams);
+
+private:
+    static void positions(quint32 trigram, quint32 &first, quint32 &second);
+
+    QByteArray m_bits;
+};
+
+#endif // LOGTRIGRAMBLOOM_H
@@ -0,0 +1,224 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logtrigramindex.h"
+#include "logtrigrambloom.h"
+
+#include <QElapsedTimer>
+#include <QLoggingCategory>
+
+#include <algorithm>
+#include <iterator>
+
+#ifdef QT_DEBUG
+Q_LOGGING_CATEGORY(logTrigramIndex, "org.deepin.log.viewer.search.index")
+#else
+Q_LOGGING_CATEGORY(logTrigramIndex, "org.deepin.log.viewer.search.index", QtInfoMsg)
+#endif
+
+//估计内存时每个三元组的哈希节点和倒排表数据头的大小
+#define LOG_TRIGRAM_INDEX_NODE_BYTES 64
+
+int LogTrigramIndexWork::thread_index = 0;
+
+LogTrigramIndex::LogTrigramIndex(qint64 budget)
+    : m_budget(budget)
+{
+}
+
+/**
+ * @brief LogTrigramIndex::build 为[0, count)的记录建立索引
+ * @param count 记录数
+ * @param text 取出记录的各列文本
+ * @param canRun 是否继续
+ * @param progress 进度回调,每LOG_TRIGRAM_INDEX_PROGRESS_ROWS条调用一次
+ * @return 是否建立完成,被停止或超过内存上限时返回false,索引为空
+ */
+bool LogTrigramIndex::build(int count, const TextFunc &text, const std::atomic_bool &canRun, const ProgressFunc &progress)
+{
+    clear();
+    const int denseLimit = qMax(LOG_TRIGRAM_INDEX_DENSE_MIN, count / LOG_TRIGRAM_INDEX_DENSE_DIV);
+    QStringList fields;
+    QVector<quint32> trigrams;
+    for (int row = 0; row < count; ++row) {
+        if (!canRun) {
+            clear();
+            return false;
+        }
+        fields.clear();
+        if (!text(row, fields))
+            m_partial.append(row);
+
+        //三元组不跨列,同一记录中重复的三元组只记一次
+        trigrams.clear();
+        for (const QString &field : fields) {
+            const QByteArray folded = field.toCaseFolded().toUtf8();
+            const uchar *p = reinterpret_cast<const uchar *>(folded.constData());
+            for (int i = 0; i + 3 <= folded.size(); ++i)
+                trigrams.append(p[i] | p[i + 1] << 8 | p[i + 2] << 16);
+        }
+        std::sort(trigrams.begin(), trigrams.end());
+        trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+
+        for (quint32 trigram : trigrams) {
+            if (m_dense.contains(trigram))
+                continue;
+            auto it = m_postings.find(trigram);
+            if (it == m_postings.end()) {
+                it = m_postings.insert(trigram, QVector<qint32>());
+                m_bytes += LOG_TRIGRAM_INDEX_NODE_BYTES;
+            }
+            it->append(row);
+            m_bytes += sizeof(qint32);
+            if (it->size() > denseLimit) {
+                m_bytes -= it->size() * static_cast<qint64>(sizeof(qint32)) + LOG_TRIGRAM_INDEX_NODE_BYTES;
+                m_postings.erase(it);
+                m_dense.insert(trigram);
+                m_bytes += sizeof(quint32) * 2;
+            }
+        }
+        if (m_bytes > m_budget) {
+            qCInfo(logTrigramIndex) << "search index over budget at row" << row << "of" << count;
+            clear();
+            m_overBudget = true;
+            return false;
+        }
+        if (progress && (row + 1) % LOG_TRIGRAM_INDEX_PROGRESS_ROWS == 0)
+            progress(row + 1);
+    }
+    for (auto it = m_postings.begin(); it != m_postings.end(); ++it)
+        it->squeeze();
+    m_rows = count;
+    return true;
+}
+
+/**
+ * @brief LogTrigramIndex::candidates 可能包含关键字的记录
+ * @param keyword 关键字
+ * @param rows 输出参数,从小到大的候选下标
+ * @return 索引能否缩小范围,关键字不足3字节、三元组都是高频三元组或索引为空时返回false,需要扫描全部记录
+ */
+bool LogTrigramIndex::candidates(const QString &keyword, QVector<int> &rows) const
+{
+    rows.clear();
+    if (m_rows == 0)
+        return false;
+    const QVector<quint32> trigrams = LogTrigramBloom::trigrams(keyword);
+    QVector<const QVector<qint32> *> lists;
+    for (quint32 trigram : trigrams) {
+        if (m_dense.contains(trigram))
+            continue;
+        auto it = m_postings.constFind(trigram);
+        //没有记录包含这个三元组
+        if (it == m_postings.constEnd()) {
+            lists.clear();
+            lists.append(nullptr);
+            break;
+        }
+        lists.append(&it.value());
+    }
+    if (lists.isEmpty())
+        return false;
+
+    QVector<qint32> result;
+    if (lists.first()) {
+        //从最短的倒排表开始求交集,中间结果始终不超过最短的表
+        std::sort(lists.begin(), lists.end(), [](const QVector<qint32> *a, const QVector<qint32> *b) {
+            return a->size() < b->size();
+        });
+        result = *lists.first();
+        QVector<qint32> next;
+        for (int i = 1; i < lists.size() && !result.isEmpty(); ++i) {
+            next.clear();
+            std::set_intersection(result.constBegin(), result.constEnd(), lists.at(i)->constBegin(), lists.at(i)->constEnd(),
+                                  std::back_inserter(next));
+            result.swap(next);
+        }
+    }
+    if (!m_partial.isEmpty()) {
+        QVector<qint32> merged;
+        merged.reserve(result.size() + m_partial.size());
+        std::set_union(result.constBegin(), result.constEnd(), m_partial.constBegin(), m_partial.constEnd(), std::back_inserter(merged));
+        result.swap(merged);
+    }
+    rows.reserve(result.size());
+    for (qint32 row : result)
+        rows.append(row);
+    return true;
+}
+
+/**
+ * @brief LogTrigramIndex::candidates 可能同时包含所有字面量的记录,用于正则搜索:求各字面量候选的交集
+ * @param literals 每个匹配都包含的字面量
+ * @param rows 输出参数,从小到大的候选下标
+ * @return 是否至少有一个字面量能缩小范围
+ */
+bool LogTrigramIndex::candidates(const QStringList &literals, QVector<int> &rows) const
+{
+    rows.clear();
+    bool narrowed = false;
+    QVector<int> next;
+    QVector<int> merged;
+    for (const QString &literal : literals) {
+        if (!candidates(literal, next))
+            continue;
+        if (!narrowed) {
+            rows.swap(next);
+            narrowed = true;
+        } else {
+            merged.clear();
+            std::set_intersection(rows.constBegin(), rows.constEnd(), next.constBegin(), next.constEnd(), std::back_inserter(merged));
+            rows.swap(merged);
+        }
+        if (rows.isEmpty())
+            break;
+    }
+    return narrowed;
+}
+
+void LogTrigramIndex::clear()
+{
+    m_postings.clear();
+    m_dense.clear();
+    m_partial.clear();
+    m_rows = 0;
+    m_bytes = 0;
+    m_overBudget = false;
+}
+
+/**
+ * @brief LogTrigramIndexWork::LogTrigramIndexWork 构造函数
+ * @param index 要建立的索引,由发起方持有
+ * @param count 记录数
+ * @param text 取出记录的各列文本,在工作线程中调用,只能访问按值捕获的数据
+ * @param canRun 取消标记
+ */
+LogTrigramIndexWork::LogTrigramIndexWork(const std::shared_ptr<LogTrigramIndex> &index, int count, const LogTrigramIndex::TextFunc &text,
+                                         const std::shared_ptr<std::atomic_bool> &canRun, QObject *parent)
+    : QObject(parent)
+    , QRunnable()
+    , m_index(index)
+    , m_count(count)
+    , m_text(text)
+    , m_canRun(canRun)
+{
+    //使用线程池启动该线程，跑完自己删自己
+    setAutoDelete(true);
+    thread_index++;
+    m_threadIndex = thread_index;
+}
+
+void LogTrigramIndexWork::run()
+{
+    QElapsedTimer timer;
+    timer.start();
+    const bool ok = m_index->build(m_count, m_text, *m_canRun, [this](int rows) {
+        emit buildProgress(m_threadIndex, rows, m_count);
+    });
+    if (!*m_canRun)
+        return;
+    qCInfo(logTrigramIndex) << "search index built:" << m_count << "rows," << m_index->memoryBytes() / 1024 << "KB,"
+                            << timer.elapsed() << "ms, ok" << ok;
+    emit buildFinished(m_threadIndex, ok);
+}
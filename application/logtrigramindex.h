@@ -0,0 +1,112 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGTRIGRAMINDEX_H
+#define LOGTRIGRAMINDEX_H
+
+#include <QHash>
+#include <QObject>
+#include <QRunnable>
+#include <QSet>
+#include <QStringList>
+#include <QVector>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+
+//索引占用内存的上限(估计值),超过时放弃建立索引,搜索按原方式逐条扫描
+#define LOG_TRIGRAM_INDEX_BUDGET (256 * 1024 * 1024)
+//已加载的记录超过这么多条才在后台建立索引,记录少时逐条扫描已经很快
+#define LOG_TRIGRAM_INDEX_MIN_ROWS 200000
+//出现在超过1/LOG_TRIGRAM_INDEX_DENSE_DIV的记录中的三元组不保存倒排表,几乎不能缩小范围却占用大部分内存
+#define LOG_TRIGRAM_INDEX_DENSE_DIV 8
+//出现次数不超过这么多的三元组总是保存倒排表
+#define LOG_TRIGRAM_INDEX_DENSE_MIN 4096
+//每建立这么多条记录的索引报告一次进度
+#define LOG_TRIGRAM_INDEX_PROGRESS_ROWS 65536
+
+/**
+ * @brief The LogTrigramIndex class 已加载记录的三元组倒排索引,用于界面关键字搜索
+ * 每个三元组(大小写折叠后UTF-8的连续3字节)对应包含它的记录下标;搜索时求关键字各三元组倒排表的交集得到候选记录,
+ * 再由LogSearchWork逐条确认,所以候选只需要包含所有匹配的记录。建立完成后只读,可以在多个线程间共享
+ */
+class LogTrigramIndex
+{
+public:
+    /**
+     * @brief TextFunc 取出第row条记录参与搜索的各列文本,返回false表示记录还有不在内存中的文本(如被截断的系统日志),
+     * 这样的记录总是作为候选
+     */
+    using TextFunc = std::function<bool(int row, QStringList &fields)>;
+    /**
+     * @brief ProgressFunc 已建立索引的记录数
+     */
+    using ProgressFunc = std::function<void(int rows)>;
+
+    explicit LogTrigramIndex(qint64 budget = LOG_TRIGRAM_INDEX_BUDGET);
+
+    bool build(int count, const TextFunc &text, const std::atomic_bool &canRun, const ProgressFunc &progress = ProgressFunc());
+    int rowCount() const { return m_rows; }
+    qint64 memoryBytes() const { return m_bytes; }
+    qint64 budget() const { return m_budget; }
+    bool isOverBudget() const { return m_overBudget; }
+    bool candidates(const QString &keyword, QVector<int> &rows) const;
+    bool candidates(const QStringList &literals, QVector<int> &rows) const;
+
+private:
+    void clear();
+
+    //三元组到包含它的记录下标,从小到大
+    QHash<quint32, QVector<qint32>> m_postings;
+    //不保存倒排表的高频三元组
+    QSet<quint32> m_dense;
+    //总是作为候选的记录
+    QVector<qint32> m_partial;
+    int m_rows = 0;
+    qint64 m_bytes = 0;
+    qint64 m_budget;
+    bool m_overBudget = false;
+};
+
+/**
+ * @brief The LogTrigramIndexWork class 在线程池中为一个类别的已加载记录建立LogTrigramIndex
+ * 索引由发起方持有,buildFinished之后才能读取;取消标记置false时线程随即退出,不发出buildFinished
+ */
+class LogTrigramIndexWork : public QObject, public QRunnable
+{
+    Q_OBJECT
+
+public:
+    LogTrigramIndexWork(const std::shared_ptr<LogTrigramIndex> &index, int count, const LogTrigramIndex::TextFunc &text,
+                        const std::shared_ptr<std::atomic_bool> &canRun, QObject *parent = nullptr);
+
+    void run() override;
+    int getIndex() const { return m_threadIndex; }
+
+signals:
+    /**
+     * @brief buildProgress 建立进度
+     * @param index 当前线程的数字标号
+     * @param rows 已建立索引的记录数
+     * @param total 记录总数
+     */
+    void buildProgress(int index, int rows, int total);
+    /**
+     * @brief buildFinished 建立结束
+     * @param ok 是否建立成功,超过内存上限时为false
+     */
+    void buildFinished(int index, bool ok);
+
+private:
+    static int thread_index;
+
+    std::shared_ptr<LogTrigramIndex> m_index;
+    int m_count;
+    LogTrigramIndex::TextFunc m_text;
+    std::shared_ptr<std::atomic_bool> m_canRun;
+    int m_threadIndex;
+};
+
+#endif // LOGTRIGRAMINDEX_H
@@ -0,0 +1,147 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logtruncator.h"
+
+#include <QFile>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <glob.h>
+#include <string.h>
+#include <sys/klog.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+//klogctl清空缓冲区的操作,同dmesg -C
+#define LOG_SYSLOG_ACTION_CLEAR 5
+//klogctl查询未读字节数的操作
+#define LOG_SYSLOG_ACTION_SIZE_UNREAD 9
+
+/**
+ * @brief LogTruncator::expand 展开通配符,没有通配符时原样返回存在的路径
+ * @param pattern 路径或通配符,如/var/log/kern.log*
+ * @return 匹配到的路径,没有匹配时为空
+ */
+QStringList LogTruncator::expand(const QString &pattern)
+{
+    QStringList paths;
+    glob_t matches;
+    if (glob(QFile::encodeName(pattern).constData(), 0, nullptr, &matches) == 0) {
+        for (size_t i = 0; i < matches.gl_pathc; ++i)
+            paths << QFile::decodeName(matches.gl_pathv[i]);
+    }
+    globfree(&matches);
+    return paths;
+}
+
+/**
+ * @brief LogTruncator::truncateFile 把一个文件截断为0字节
+ * 不跟随符号链接,只处理普通文件,避免提权后被链接引到其他文件
+ * @param path 文件路径
+ * @return 结果,freed为截断前的大小
+ */
+LogTruncateResult LogTruncator::truncateFile(const QString &path)
+{
+    LogTruncateResult result;
+    result.path = path;
+    const int fd = ::open(QFile::encodeName(path).constData(), O_WRONLY | O_NOFOLLOW | O_NONBLOCK | O_NOCTTY | O_CLOEXEC);
+    if (fd < 0) {
+        result.error = QString::fromLocal8Bit(strerror(errno));
+        return result;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        result.error = QString::fromLocal8Bit(strerror(errno));
+    } else if (!S_ISREG(st.st_mode)) {
+        result.error = "not a regular file";
+    } else if (ftruncate(fd, 0) != 0) {
+        result.error = QString::fromLocal8Bit(strerror(errno));
+    } else {
+        result.freed = static_cast<qint64>(st.st_size);
+        result.ok = true;
+    }
+    ::close(fd);
+    return result;
+}
+
+/**
+ * @brief LogTruncator::clearKernelBuffer 清空内核环形缓冲区
+ * @return 结果,freed为清空前未读的字节数
+ */
+LogTruncateResult LogTruncator::clearKernelBuffer()
+{
+    LogTruncateResult result;
+    result.path = LOG_TRUNCATE_DMESG;
+    const int unread = klogctl(LOG_SYSLOG_ACTION_SIZE_UNREAD, nullptr, 0);
+    if (klogctl(LOG_SYSLOG_ACTION_CLEAR, nullptr, 0) < 0) {
+        result.error = QString::fromLocal8Bit(strerror(errno));
+        return result;
+    }
+    result.freed = qMax(unread, 0);
+    result.ok = true;
+    return result;
+}
+
+/**
+ * @brief LogTruncator::truncate 依次清空各目标,通配符展开后去重
+ * @param targets 文件路径、通配符或dmesg
+ * @return 每个实际处理的文件一项,没有匹配到文件的通配符不产生结果
+ */
+QList<LogTruncateResult> LogTruncator::truncate(const QStringList &targets)
+{
+    QList<LogTruncateResult> results;
+    QStringList done;
+    for (const QString &target : targets) {
+        if (target == LOG_TRUNCATE_DMESG) {
+            results << clearKernelBuffer();
+            continue;
+        }
+        for (const QString &path : expand(target)) {
+            if (done.contains(path))
+                continue;
+            done << path;
+            results << truncateFile(path);
+        }
+    }
+    return results;
+}
+
+/**
+ * @brief LogTruncator::toText 按行输出结果,失败的项释放字节数为-1并附带错误
+ */
+QByteArray LogTruncator::toText(const QList<LogTruncateResult> &results)
+{
+    QByteArray text;
+    for (const LogTruncateResult &result : results) {
+        text += QByteArray::number(result.ok ? result.freed : -1) + '\t' + result.path.toUtf8();
+        if (!result.ok)
+            text += '\t' + result.error.toUtf8();
+        text += '\n';
+    }
+    return text;
+}
+
+/**
+ * @brief LogTruncator::fromText 解析logViewerTruncate的输出,格式不对的行跳过
+ */
+QList<LogTruncateResult> LogTruncator::fromText(const QByteArray &text)
+{
+    QList<LogTruncateResult> results;
+    for (const QByteArray &line : text.split('\n')) {
+        const QList<QByteArray> fields = line.split('\t');
+        bool ok = false;
+        const qint64 freed = fields.value(0).toLongLong(&ok);
+        if (!ok || fields.size() < 2)
+            continue;
+        LogTruncateResult result;
+        result.path = QString::fromUtf8(fields.at(1));
+        result.ok = freed >= 0;
+        result.freed = qMax<qint64>(freed, 0);
+        result.error = QString::fromUtf8(fields.value(2));
+        results << result;
+    }
+    return results;
+}
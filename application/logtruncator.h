@@ -0,0 +1,45 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGTRUNCATOR_H
+#define LOGTRUNCATOR_H
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+//清空内核环形缓冲区的目标名称,和DMESG_TREE_DATA一致
+#define LOG_TRUNCATE_DMESG "dmesg"
+
+/**
+ * @brief The LogTruncateResult struct 清空一个目标的结果
+ */
+struct LogTruncateResult {
+    QString path;
+    //清空前的文件大小,内核缓冲区为清空前未读的字节数
+    qint64 freed = 0;
+    bool ok = false;
+    QString error;
+};
+
+/**
+ * @brief The LogTruncator class 清空日志文件,logViewerTruncate和应用共用
+ * 目标可以是文件路径或通配符(展开为整组轮转日志),也可以是dmesg;
+ * 在进程内open+ftruncate,不再为每个文件启动bash执行truncate,多个目标一次提权完成。
+ * logViewerTruncate每个目标输出一行"释放字节数\t路径[\t错误]",应用按fromText解析
+ */
+class LogTruncator
+{
+public:
+    static QStringList expand(const QString &pattern);
+    static LogTruncateResult truncateFile(const QString &path);
+    static LogTruncateResult clearKernelBuffer();
+    static QList<LogTruncateResult> truncate(const QStringList &targets);
+
+    static QByteArray toText(const QList<LogTruncateResult> &results);
+    static QList<LogTruncateResult> fromText(const QByteArray &text);
+};
+
+#endif // LOGTRUNCATOR_H
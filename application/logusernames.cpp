@@ -0,0 +1,127 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logusernames.h"
+
+#include <QElapsedTimer>
+#include <QMutexLocker>
+
+#include <errno.h>
+#include <grp.h>
+#include <pwd.h>
+#include <unistd.h>
+
+#include <vector>
+
+//getpwuid_r/getgrgid_r缓冲区的初始大小和上限,系统没有给出建议值时使用初始值
+#define LOG_USER_NAME_BUFFER 16384
+#define LOG_USER_NAME_BUFFER_MAX (1024 * 1024)
+
+QMutex LogUserNames::s_mutex;
+QHash<uint, LogUserNames::Entry> LogUserNames::s_users;
+QHash<uint, LogUserNames::Entry> LogUserNames::s_groups;
+
+namespace {
+
+size_t initialBufferSize(int name)
+{
+    const long size = sysconf(name);
+    return size > 0 ? static_cast<size_t>(size) : LOG_USER_NAME_BUFFER;
+}
+
+} // namespace
+
+/**
+ * @brief LogUserNames::userName uid对应的用户名
+ * @return 用户名,查询不到时为空
+ */
+QString LogUserNames::userName(uint uid)
+{
+    return cached(s_users, uid, &LogUserNames::lookupUser);
+}
+
+/**
+ * @brief LogUserNames::groupName gid对应的组名
+ * @return 组名,查询不到时为空
+ */
+QString LogUserNames::groupName(uint gid)
+{
+    return cached(s_groups, gid, &LogUserNames::lookupGroup);
+}
+
+/**
+ * @brief LogUserNames::clear 清空缓存,之后的查询重新经过NSS
+ */
+void LogUserNames::clear()
+{
+    QMutexLocker locker(&s_mutex);
+    s_users.clear();
+    s_groups.clear();
+}
+
+/**
+ * @brief LogUserNames::cached 取缓存中未过期的结果,没有时查询并写入缓存
+ * 查询在锁外进行,慢的NSS查询不阻塞其他线程读取已缓存的id;同一个id并发查询时以后写入的为准
+ */
+QString LogUserNames::cached(QHash<uint, Entry> &cache, uint id, Lookup lookup)
+{
+    const qint64 current = now();
+    {
+        QMutexLocker locker(&s_mutex);
+        auto it = cache.constFind(id);
+        if (it != cache.constEnd() && it->expires > current)
+            return it->name;
+    }
+
+    Entry entry;
+    entry.name = lookup(id);
+    entry.expires = now() + (entry.name.isEmpty() ? LOG_USER_NAME_NEGATIVE_TTL : LOG_USER_NAME_TTL);
+    QMutexLocker locker(&s_mutex);
+    cache.insert(id, entry);
+    return entry.name;
+}
+
+QString LogUserNames::lookupUser(uint uid)
+{
+    size_t size = initialBufferSize(_SC_GETPW_R_SIZE_MAX);
+    while (size <= LOG_USER_NAME_BUFFER_MAX) {
+        std::vector<char> buffer(size);
+        struct passwd pwd;
+        struct passwd *result = nullptr;
+        const int r = getpwuid_r(static_cast<uid_t>(uid), &pwd, buffer.data(), buffer.size(), &result);
+        if (r == ERANGE) {
+            size *= 2;
+            continue;
+        }
+        return r == 0 && result ? QString::fromLocal8Bit(result->pw_name) : QString();
+    }
+    return QString();
+}
+
+QString LogUserNames::lookupGroup(uint gid)
+{
+    size_t size = initialBufferSize(_SC_GETGR_R_SIZE_MAX);
+    while (size <= LOG_USER_NAME_BUFFER_MAX) {
+        std::vector<char> buffer(size);
+        struct group grp;
+        struct group *result = nullptr;
+        const int r = getgrgid_r(static_cast<gid_t>(gid), &grp, buffer.data(), buffer.size(), &result);
+        if (r == ERANGE) {
+            size *= 2;
+            continue;
+        }
+        return r == 0 && result ? QString::fromLocal8Bit(result->gr_name) : QString();
+    }
+    return QString();
+}
+
+/**
+ * @brief LogUserNames::now 单调时钟的毫秒数,不受修改系统时间影响
+ */
+qint64 LogUserNames::now()
+{
+    QElapsedTimer timer;
+    timer.start();
+    return timer.msecsSinceReference();
+}
@@ -0,0 +1,49 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGUSERNAMES_H
+#define LOGUSERNAMES_H
+
+#include <QHash>
+#include <QMutex>
+#include <QString>
+
+//查询到的用户名、组名的有效期,毫秒
+#define LOG_USER_NAME_TTL (10 * 60 * 1000)
+//查询不到的uid、gid的有效期,毫秒,期间不再查询
+#define LOG_USER_NAME_NEGATIVE_TTL (60 * 1000)
+
+/**
+ * @brief The LogUserNames class 进程内共享的uid/gid到用户名、组名的缓存,可在任意线程调用
+ * getpwuid_r/getgrgid_r会经过NSS,在使用LDAP、SSSD的机器上每次都是一次网络查询;
+ * 崩溃日志、审计日志的每条记录和详情面板都通过这里查询,同一个id在有效期内只查询一次,
+ * 查询不到的id也会缓存一段较短的时间
+ */
+class LogUserNames
+{
+public:
+    static QString userName(uint uid);
+    static QString groupName(uint gid);
+    static void clear();
+
+private:
+    struct Entry {
+        //为空表示查询不到
+        QString name;
+        //过期时间,单调时钟的毫秒数
+        qint64 expires = 0;
+    };
+    typedef QString (*Lookup)(uint id);
+
+    static QString cached(QHash<uint, Entry> &cache, uint id, Lookup lookup);
+    static QString lookupUser(uint uid);
+    static QString lookupGroup(uint gid);
+    static qint64 now();
+
+    static QMutex s_mutex;
+    static QHash<uint, Entry> s_users;
+    static QHash<uint, Entry> s_groups;
+};
+
+#endif // LOGUSERNAMES_H
@@ -0,0 +1,58 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logutf8view.h"
+
+namespace {
+inline char asciiLower(char c)
+{
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c + ('a' - 'A')) : c;
+}
+}
+
+/**
+ * @brief LogUtf8View::isAscii 是否全部为ASCII字符,UTF-8中多字节字符的每个字节都不小于0x80
+ */
+bool LogUtf8View::isAscii() const
+{
+    for (int i = 0; i < size; ++i) {
+        if (static_cast<uchar>(data[i]) >= 0x80)
+            return false;
+    }
+    return true;
+}
+
+LogUtf8Matcher::LogUtf8Matcher(const QString &keyword)
+    : m_keyword(keyword)
+{
+    const QByteArray bytes = keyword.toUtf8();
+    if (LogUtf8View(bytes).isAscii())
+        m_lowerAscii = bytes.toLower();
+}
+
+/**
+ * @brief LogUtf8Matcher::matches 文本中是否包含关键字
+ * 非ASCII字符的大小写折叠可能得到ASCII字符(如开尔文符号),文本中含有非ASCII字符时不走字节比较
+ */
+bool LogUtf8Matcher::matches(const LogUtf8View &text) const
+{
+    if (m_keyword.isEmpty())
+        return true;
+    if (m_lowerAscii.isEmpty() || !text.isAscii())
+        return text.toString().contains(m_keyword, Qt::CaseInsensitive);
+
+    const int needleSize = m_lowerAscii.size();
+    const char *needle = m_lowerAscii.constData();
+    const char first = needle[0];
+    for (int i = 0; i + needleSize <= text.size; ++i) {
+        if (asciiLower(text.data[i]) != first)
+            continue;
+        int j = 1;
+        while (j < needleSize && asciiLower(text.data[i + j]) == needle[j])
+            ++j;
+        if (j == needleSize)
+            return true;
+    }
+    return false;
+}
@@ -0,0 +1,55 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGUTF8VIEW_H
+#define LOGUTF8VIEW_H
+
+#include <QByteArray>
+#include <QString>
+
+/**
+ * @brief The LogUtf8View struct 不持有数据的一段UTF-8文本,指向映射、读取块或字符区中的原始字节
+ * Qt5没有QUtf8StringView,按行筛选等只需要判断的场景直接在字节上进行,需要显示时才用toString转换
+ */
+struct LogUtf8View {
+    const char *data = nullptr;
+    int size = 0;
+
+    LogUtf8View() {}
+    LogUtf8View(const char *d, int s)
+        : data(d)
+        , size(s)
+    {
+    }
+    LogUtf8View(const QByteArray &bytes)
+        : data(bytes.constData())
+        , size(bytes.size())
+    {
+    }
+
+    bool isEmpty() const { return size == 0; }
+    bool isAscii() const;
+    QString toString() const { return QString::fromUtf8(data, size); }
+};
+
+/**
+ * @brief The LogUtf8Matcher class 不区分大小写的关键字匹配,和QString::contains(keyword, Qt::CaseInsensitive)结果一致
+ * 关键字和文本都是ASCII时(日志中的绝大多数情况)按字节比较,不转换为QString;否则转换后按QString比较
+ */
+class LogUtf8Matcher
+{
+public:
+    LogUtf8Matcher() {}
+    explicit LogUtf8Matcher(const QString &keyword);
+
+    const QString &keyword() const { return m_keyword; }
+    bool matches(const LogUtf8View &text) const;
+
+private:
+    QString m_keyword;
+    //ASCII关键字的小写字节,非ASCII关键字为空
+    QByteArray m_lowerAscii;
+};
+
+#endif // LOGUTF8VIEW_H
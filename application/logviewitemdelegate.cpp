@@ -3,6 +3,8 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "logviewitemdelegate.h"
+#include "logtablemodel.h"
+#include "logiconcache.h"
 
 #include <DApplication>
 #include <DApplicationHelper>
@@ -23,7 +25,46 @@ DWIDGET_USE_NAMESPACE
 
 LogViewItemDelegate::LogViewItemDelegate(QObject *parent)
     : QStyledItemDelegate(parent)
+    , m_elidedTexts(ELIDED_TEXT_CACHE_SIZE)
 {
+    connect(DApplicationHelper::instance(), &DApplicationHelper::themeTypeChanged, this, &LogViewItemDelegate::invalidateStyle);
+    connect(qApp, &QGuiApplication::paletteChanged, this, &LogViewItemDelegate::invalidateStyle);
+}
+
+/**
+ * @brief LogViewItemDelegate::invalidateStyle 主题或调色板变化后丢弃缓存的样式数据
+ */
+void LogViewItemDelegate::invalidateStyle()
+{
+    m_styleValid = false;
+}
+
+/**
+ * @brief LogViewItemDelegate::elidedText 获取省略后的文字,结果按LRU缓存
+ * @param text 原文字
+ * @param font 字体
+ * @param width 可用宽度
+ * @param mode 省略模式
+ */
+QString LogViewItemDelegate::elidedText(const QString &text, const QFont &font, int width, Qt::TextElideMode mode) const
+{
+    const ElidedTextKey key {text, font, width, static_cast<int>(mode)};
+    if (QString *cached = m_elidedTexts.object(key))
+        return *cached;
+    QString elided = QFontMetrics(font).elidedText(text, mode, width);
+    m_elidedTexts.insert(key, new QString(elided));
+    return elided;
+}
+
+/**
+ * @brief LogViewItemDelegate::updateStyle 重新获取边距和应用调色板
+ */
+void LogViewItemDelegate::updateStyle(const QStyleOptionViewItem &option) const
+{
+    DStyle *style = dynamic_cast<DStyle *>(DApplication::style());
+    m_margin = style ? style->pixelMetric(DStyle::PM_ContentsMargins, &option) : 0;
+    m_palette = DApplicationHelper::instance()->applicationPalette();
+    m_styleValid = true;
 }
 /**
  * @brief LogViewItemDelegate::paint 绘制内容数据和文字虚函数
@@ -57,22 +98,19 @@ void LogViewItemDelegate::paint(QPainter *painter, const QStyleOptionViewItem &o
             cg = DPalette::Active;
         }
     }
-    DStyle *style = dynamic_cast<DStyle *>(DApplication::style());
-    int margin = style->pixelMetric(DStyle::PM_ContentsMargins, &option);
+    if (!m_styleValid)
+        updateStyle(option);
+    const int margin = m_margin;
     //设置高亮文字色
-    DApplicationHelper *dAppHelper = DApplicationHelper::instance();
-    DPalette palette = dAppHelper->applicationPalette();
     QPen forground;
-    forground.setColor(palette.color(cg, DPalette::Text));
+    forground.setColor(m_palette.color(cg, DPalette::Text));
     if (opt.state & DStyle::State_Enabled) {
         if (opt.state & DStyle::State_Selected) {
-            forground.setColor(palette.color(cg, DPalette::HighlightedText));
+            forground.setColor(m_palette.color(cg, DPalette::HighlightedText));
         }
     }
     painter->setPen(forground);
     QRect rect = opt.rect;
-    QFontMetrics fm(opt.font);
-    QPainterPath path, clipPath;
     QRect textRect = rect;
     switch (opt.viewItemPosition) {
     case QStyleOptionViewItem::Beginning: {
@@ -106,17 +144,56 @@ void LogViewItemDelegate::paint(QPainter *painter, const QStyleOptionViewItem &o
         iconRect.setY((rect.height() - ICON_HEIGHT) / 2 + rect.y());
         iconRect.setWidth(ICON_WIDTH);
         iconRect.setHeight(ICON_HEIGHT);
-        QIcon ic = index.data(Qt::DecorationRole).value<QIcon>();
-        ic.paint(painter, iconRect, Qt::AlignLeft | Qt::AlignVCenter);
+        //等级图标的位图在进程内共用,不在每次绘制时渲染SVG
+        const QIcon ic = index.data(Qt::DecorationRole).value<QIcon>();
+        if (!ic.isNull()) {
+            const QPixmap pixmap = LogIconCache::instance()->pixmap(ic, iconRect.size(), painter->device()->devicePixelRatioF());
+            //和QIcon::paint一致,比区域小的位图靠左垂直居中
+            const int height = qRound(pixmap.height() / pixmap.devicePixelRatio());
+            painter->drawPixmap(iconRect.x(), iconRect.y() + (iconRect.height() - height) / 2, pixmap);
+        }
     }
     //绘制文字
     textRect = rect;
     textRect.setX(iconRect.right() + margin - 2);
-    QString text = fm.elidedText(opt.text, opt.textElideMode, textRect.width());
+    QString text = elidedText(opt.text, opt.font, textRect.width(), opt.textElideMode);
+    const QVariant hits = index.data(LogTableModel::SearchHitsRole);
+    if (hits.isValid())
+        paintSearchHits(painter, opt, textRect, text, hits.value<QVector<int>>(), cg);
     painter->drawText(textRect, Qt::TextSingleLine | static_cast<int>(opt.displayAlignment), text);
     painter->restore();
 }
 
+/**
+ * @brief LogViewItemDelegate::paintSearchHits 在文字下方绘制搜索关键字的背景
+ * 位置由搜索线程记下,这里只换算可见部分的像素范围,被省略掉的命中不绘制
+ * @param textRect 文字区域
+ * @param text 省略后实际绘制的文字
+ * @param hits 完整显示文字中的位置和长度,两两一组
+ */
+void LogViewItemDelegate::paintSearchHits(QPainter *painter, const QStyleOptionViewItem &opt, const QRect &textRect,
+                                          const QString &text, const QVector<int> &hits, DPalette::ColorGroup cg) const
+{
+    //只有左对齐、右侧省略的文字能直接按前缀换算位置
+    if (!(opt.displayAlignment & Qt::AlignLeft) || opt.textElideMode != Qt::ElideRight)
+        return;
+    //省略后末尾是省略号,之前的前缀和原文一致
+    const int visible = text == opt.text ? text.size() : qMax(0, text.size() - 1);
+    const QFontMetrics fm(opt.font);
+    QColor color = m_palette.color(cg, (opt.state & DStyle::State_Selected) ? DPalette::HighlightedText : DPalette::Highlight);
+    color.setAlpha(SEARCH_HIT_ALPHA);
+    const int top = textRect.y() + (textRect.height() - fm.height()) / 2;
+    for (int i = 0; i + 1 < hits.size(); i += 2) {
+        const int begin = hits.at(i);
+        const int end = qMin(visible, begin + hits.at(i + 1));
+        if (begin >= end)
+            continue;
+        const int x = textRect.x() + fm.width(text.left(begin));
+        const int width = fm.width(text.mid(begin, end - begin));
+        painter->fillRect(QRect(x, top, width, fm.height()), color);
+    }
+}
+
 QSize LogViewItemDelegate::sizeHint(const QStyleOptionViewItem &option,
                                     const QModelIndex &index) const
 {
@@ -5,13 +5,43 @@
 #ifndef SYSTEM_SERVICE_ITEM_DELEGATE_H
 #define SYSTEM_SERVICE_ITEM_DELEGATE_H
 
+#include <DPalette>
+
+#include <QCache>
+#include <QFont>
 #include <QStyledItemDelegate>
+#include <QVector>
+
+//省略文字缓存的条目数,约为4K屏上数页单元格
+#define ELIDED_TEXT_CACHE_SIZE 4096
 
 class QModelIndex;
 class QPainter;
 class QStyleOptionViewItem;
+/**
+ * @brief The ElidedTextKey struct 省略文字缓存的键,同一文字在同一字体和宽度下省略结果不变
+ */
+struct ElidedTextKey {
+    QString text;
+    QFont font;
+    int width;
+    int mode;
+
+    bool operator==(const ElidedTextKey &other) const
+    {
+        return width == other.width && mode == other.mode && text == other.text && font == other.font;
+    }
+};
+
+inline uint qHash(const ElidedTextKey &key, uint seed = 0)
+{
+    return qHash(key.text, seed) ^ qHash(key.font, seed) ^ (static_cast<uint>(key.width) << 4) ^ static_cast<uint>(key.mode);
+}
+
 /**
  * @brief 主数据表的委托
+ * 调色板和边距在主题或调色板变化时才重新获取,省略后的文字按LRU缓存,滚动时只需绘制;
+ * 搜索关键字的高亮位置从model的SearchHitsRole读取,只有可见的单元格才会取用
  */
 class LogViewItemDelegate : public QStyledItemDelegate
 {
@@ -23,9 +53,22 @@ public:
     void paint(QPainter *painter, const QStyleOptionViewItem &option,
                const QModelIndex &index) const override;
     QSize sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const override;
+    QString elidedText(const QString &text, const QFont &font, int width, Qt::TextElideMode mode) const;
+    void invalidateStyle();
 
 protected:
     void initStyleOption(QStyleOptionViewItem *option, const QModelIndex &index) const override;
+
+private:
+    void updateStyle(const QStyleOptionViewItem &option) const;
+    void paintSearchHits(QPainter *painter, const QStyleOptionViewItem &opt, const QRect &textRect,
+                         const QString &text, const QVector<int> &hits, Dtk::Gui::DPalette::ColorGroup cg) const;
+
+    //缓存的样式数据,m_styleValid为false时在下次绘制前重新获取
+    mutable bool m_styleValid = false;
+    mutable int m_margin = 0;
+    mutable Dtk::Gui::DPalette m_palette;
+    mutable QCache<ElidedTextKey, QString> m_elidedTexts;
 };
 
 #endif  // SYSTEM_SERVICE_ITEM_DELEGATE_H
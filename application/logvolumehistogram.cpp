@@ -0,0 +1,368 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logvolumehistogram.h"
+#include "loglinefilter.h"
+#include "loglineindexer.h"
+#include "loglinestream.h"
+#include "loggzipinflater.h"
+#include "structdef.h"
+#include "dbusproxy/dldbushandler.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QLoggingCategory>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+#include <limits>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <systemd/sd-journal.h>
+
+#ifdef QT_DEBUG
+Q_LOGGING_CATEGORY(logVolume, "org.deepin.log.viewer.volume")
+#else
+Q_LOGGING_CATEGORY(logVolume, "org.deepin.log.viewer.volume", QtInfoMsg)
+#endif
+
+//校验文件开头时比较的字节数
+#define LOG_VOLUME_HEAD_SIZE 4096
+//每统计这么多条journal检查一次是否被停止
+#define LOG_VOLUME_CHECK_ENTRIES 4096
+//统计文本日志时每次读取的字节数,一行超过时加倍
+#define LOG_VOLUME_READ_BLOCK (1024 * 1024)
+
+/**
+ * @brief LogVolumeHistogram::add 记录一个条目
+ * @param msecs 条目时间,毫秒,小于0时不记录
+ * @param level 等级,超出范围时记为LOG_VOLUME_DEFAULT_LEVEL
+ */
+void LogVolumeHistogram::add(qint64 msecs, int level)
+{
+    if (msecs < 0)
+        return;
+    if (level < 0 || level >= LOG_VOLUME_LEVELS)
+        level = LOG_VOLUME_DEFAULT_LEVEL;
+    QVector<quint32> &bucket = m_buckets[msecs / LOG_VOLUME_BUCKET_MSEC];
+    if (bucket.isEmpty())
+        bucket.resize(LOG_VOLUME_LEVELS);
+    ++bucket[level];
+}
+
+void LogVolumeHistogram::merge(const LogVolumeHistogram &other)
+{
+    for (auto it = other.m_buckets.constBegin(); it != other.m_buckets.constEnd(); ++it) {
+        QVector<quint32> &bucket = m_buckets[it.key()];
+        if (bucket.isEmpty())
+            bucket.resize(LOG_VOLUME_LEVELS);
+        for (int level = 0; level < LOG_VOLUME_LEVELS && level < it.value().size(); ++level)
+            bucket[level] += it.value().at(level);
+    }
+}
+
+/**
+ * @brief LogVolumeHistogram::dropBefore 删除整个早于msecs的桶,如journal被清理掉的部分
+ */
+void LogVolumeHistogram::dropBefore(qint64 msecs)
+{
+    const qint64 first = msecs / LOG_VOLUME_BUCKET_MSEC;
+    while (!m_buckets.isEmpty() && m_buckets.firstKey() < first)
+        m_buckets.erase(m_buckets.begin());
+}
+
+/**
+ * @brief LogVolumeHistogram::count [begin, end]时间段内的条目数,按小时统计,时间段两端所在的整个小时都计入
+ * @param begin 开始时间,毫秒,小于0表示不限
+ * @param end 结束时间,毫秒,小于0表示不限
+ * @param level 等级,-1表示全部等级
+ */
+qint64 LogVolumeHistogram::count(qint64 begin, qint64 end, int level) const
+{
+    auto it = begin < 0 ? m_buckets.constBegin() : m_buckets.lowerBound(begin / LOG_VOLUME_BUCKET_MSEC);
+    const qint64 last = end < 0 ? std::numeric_limits<qint64>::max() : end / LOG_VOLUME_BUCKET_MSEC;
+    qint64 total = 0;
+    for (; it != m_buckets.constEnd() && it.key() <= last; ++it) {
+        if (level >= 0) {
+            total += level < it.value().size() ? it.value().at(level) : 0;
+            continue;
+        }
+        for (quint32 n : it.value())
+            total += n;
+    }
+    return total;
+}
+
+/**
+ * @brief LogVolumeHistogram::periodBegin 时间筛选按钮对应时间段的开始时间,和LogBackend::getTimeRange一致
+ * @param periodId 见BUTTONID
+ * @return 毫秒,全部时为-1
+ */
+qint64 LogVolumeHistogram::periodBegin(int periodId)
+{
+    QDateTime start = QDateTime::currentDateTime();
+    start.setTime(QTime());
+    switch (periodId) {
+    case ONE_DAY:
+        return start.toMSecsSinceEpoch();
+    case THREE_DAYS:
+        return start.addDays(-2).toMSecsSinceEpoch();
+    case ONE_WEEK:
+        return start.addDays(-6).toMSecsSinceEpoch();
+    case ONE_MONTH:
+        return start.addMonths(-1).toMSecsSinceEpoch();
+    case THREE_MONTHS:
+        return start.addMonths(-3).toMSecsSinceEpoch();
+    default:
+        return -1;
+    }
+}
+
+QDataStream &operator<<(QDataStream &out, const LogVolumeHistogram &histogram)
+{
+    return out << histogram.m_buckets;
+}
+
+QDataStream &operator>>(QDataStream &in, LogVolumeHistogram &histogram)
+{
+    return in >> histogram.m_buckets;
+}
+
+QDataStream &operator<<(QDataStream &out, const LogVolumeCounter::FileState &state)
+{
+    return out << state.offset << state.size << state.mtime << state.head << state.histogram;
+}
+
+QDataStream &operator>>(QDataStream &in, LogVolumeCounter::FileState &state)
+{
+    return in >> state.offset >> state.size >> state.mtime >> state.head >> state.histogram;
+}
+
+/**
+ * @brief LogVolumeCounter::update 读取上次的状态,统计之后新增的条目并保存
+ * @param source journal、kern或dpkg
+ * @param canRun 是否继续,被停止时保存已统计的部分
+ * @param histogram 输出参数,来源当前的直方图
+ * @return 是否支持该来源
+ */
+bool LogVolumeCounter::update(const QString &source, const std::atomic_bool &canRun, LogVolumeHistogram &histogram)
+{
+    histogram.clear();
+    const bool journal = source == "journal";
+    if (!journal && source != "kern" && source != "dpkg")
+        return false;
+
+    QByteArray cursor;
+    QMap<QByteArray, FileState> states;
+    QFile file(statePath(source));
+    if (file.open(QIODevice::ReadOnly)) {
+        QDataStream in(&file);
+        quint32 version = 0;
+        in >> version;
+        if (version == LOG_VOLUME_VERSION) {
+            in >> cursor >> histogram >> states;
+            if (in.status() != QDataStream::Ok) {
+                cursor.clear();
+                histogram.clear();
+                states.clear();
+            }
+        }
+        file.close();
+    }
+
+    if (journal) {
+        updateJournal(cursor, histogram, canRun);
+    } else {
+        const QStringList paths = DLDBusHandler::instance(nullptr)->getFileInfo(source, false);
+        updateFiles(paths, states, canRun);
+        histogram.clear();
+        for (const FileState &state : states)
+            histogram.merge(state.histogram);
+    }
+
+    QDir().mkpath(QFileInfo(statePath(source)).absolutePath());
+    QSaveFile out(statePath(source));
+    if (out.open(QIODevice::WriteOnly)) {
+        QDataStream stream(&out);
+        //文本日志的总数由各文件合并得到,不单独保存
+        stream << static_cast<quint32>(LOG_VOLUME_VERSION) << cursor << (journal ? histogram : LogVolumeHistogram()) << states;
+        out.commit();
+    }
+    return true;
+}
+
+/**
+ * @brief LogVolumeCounter::updateJournal 从cursor之后统计本机journal,只读取时间和等级
+ * journal开头被清理后删除更早的桶;游标失效(如journal被整个删除)时从头重新统计
+ * @param cursor 输入输出参数,最后统计到的条目游标
+ */
+bool LogVolumeCounter::updateJournal(QByteArray &cursor, LogVolumeHistogram &histogram, const std::atomic_bool &canRun)
+{
+    sd_journal *j = nullptr;
+    if (sd_journal_open(&j, SD_JOURNAL_LOCAL_ONLY) < 0)
+        return false;
+
+    uint64_t usec = 0;
+    if (sd_journal_seek_head(j) >= 0 && sd_journal_next(j) > 0 && sd_journal_get_realtime_usec(j, &usec) >= 0)
+        histogram.dropBefore(static_cast<qint64>(usec / 1000));
+
+    int r = 0;
+    if (!cursor.isEmpty() && sd_journal_seek_cursor(j, cursor.constData()) >= 0 && sd_journal_next(j) > 0
+            && sd_journal_test_cursor(j, cursor.constData()) > 0) {
+        r = sd_journal_next(j);
+    } else {
+        histogram.clear();
+        r = sd_journal_seek_head(j) >= 0 ? sd_journal_next(j) : -1;
+    }
+
+    qint64 counted = 0;
+    const void *data = nullptr;
+    size_t length = 0;
+    for (; r > 0; r = sd_journal_next(j)) {
+        if (sd_journal_get_realtime_usec(j, &usec) < 0)
+            continue;
+        int level = LOG_VOLUME_DEFAULT_LEVEL;
+        //字段为"PRIORITY=n"
+        if (sd_journal_get_data(j, "PRIORITY", &data, &length) >= 0 && length > 9)
+            level = static_cast<const char *>(data)[9] - '0';
+        histogram.add(static_cast<qint64>(usec / 1000), level);
+        if (++counted % LOG_VOLUME_CHECK_ENTRIES == 0 && !canRun)
+            break;
+    }
+
+    char *current = nullptr;
+    if (counted > 0 && sd_journal_get_cursor(j, &current) >= 0) {
+        cursor = current;
+        free(current);
+    }
+    sd_journal_close(j);
+    qCDebug(logVolume) << "journal entries counted:" << counted;
+    return true;
+}
+
+/**
+ * @brief LogVolumeCounter::countLines 统计[begin, end)中每一行行首的时间,取不到时间的行不计入
+ * @return 最后一个完整行之后的位置,没有写完的最后一行留到下次统计
+ */
+qint64 LogVolumeCounter::countLines(const char *data, qint64 begin, qint64 end, LogVolumeHistogram &histogram)
+{
+    qint64 pos = begin;
+    LogLineIndexer::forEachNewline(data, begin, end, [data, &pos, &histogram](qint64 lineEnd) {
+        const qint64 length = qMin<qint64>(lineEnd - pos, LINE_TIME_PREFIX_SIZE);
+        histogram.add(LogLineFilter::lineTime(QByteArray::fromRawData(data + pos, static_cast<int>(length))));
+        pos = lineEnd + 1;
+        return true;
+    });
+    return pos;
+}
+
+/**
+ * @brief LogVolumeCounter::countLines 同上,按LOG_VOLUME_READ_BLOCK字节的块通过readRange读取,不访问映射
+ * @return 最后一个完整行之后的位置,读取失败(文件被截断)时为已经统计到的位置
+ */
+qint64 LogVolumeCounter::countLines(const LogLineStream &stream, qint64 begin, qint64 end, LogVolumeHistogram &histogram)
+{
+    qint64 pos = begin;
+    qint64 blockSize = LOG_VOLUME_READ_BLOCK;
+    QByteArray block;
+    while (pos < end) {
+        const qint64 blockEnd = qMin(end, pos + blockSize);
+        if (!stream.readRange(pos, blockEnd, block))
+            break;
+        const qint64 next = pos + countLines(block.constData(), 0, block.size(), histogram);
+        if (next == pos) {
+            //没有写完的最后一行留到下次统计,超过块大小的行扩大读取范围
+            if (blockEnd == end)
+                break;
+            blockSize *= 2;
+            continue;
+        }
+        pos = next;
+        blockSize = LOG_VOLUME_READ_BLOCK;
+    }
+    return pos;
+}
+
+/**
+ * @brief LogVolumeCounter::updateFiles 统计各日志文件新增的部分,按设备号和inode识别文件,轮转改名后继续使用
+ * @param paths 来源当前的所有文件
+ * @param states 输入输出参数,各文件的状态,不在paths中的文件被删除
+ */
+bool LogVolumeCounter::updateFiles(const QStringList &paths, QMap<QByteArray, FileState> &states, const std::atomic_bool &canRun)
+{
+    QMap<QByteArray, FileState> current;
+    for (const QString &path : paths) {
+        struct stat st;
+        if (!canRun || stat(QFile::encodeName(path).constData(), &st) != 0)
+            continue;
+        const QByteArray key = QByteArray::number(static_cast<quint64>(st.st_dev)) + ':' + QByteArray::number(static_cast<quint64>(st.st_ino));
+        FileState state = states.value(key);
+        const bool gzip = LogGzipInflater::isGzipFile(path);
+        if (gzip && states.contains(key) && state.size == st.st_size && state.mtime == static_cast<qint64>(st.st_mtime)) {
+            current.insert(key, state);
+            continue;
+        }
+
+        LogLineStream stream(path);
+        if (!stream.openDirect()) {
+            //没有读权限时保留上次的结果
+            if (states.contains(key))
+                current.insert(key, state);
+            continue;
+        }
+        const qint64 size = stream.mappedSize();
+        QByteArray headData;
+        if (!stream.readRange(0, qMin<qint64>(size, LOG_VOLUME_HEAD_SIZE), headData)) {
+            //刚打开就被截断,保留上次的结果
+            if (states.contains(key))
+                current.insert(key, state);
+            continue;
+        }
+        const QByteArray head = QCryptographicHash::hash(headData, QCryptographicHash::Sha1);
+        qint64 begin = 0;
+        if (!gzip && states.contains(key) && state.head == head && size >= state.offset) {
+            begin = state.offset;
+        } else {
+            state.histogram.clear();
+        }
+        state.offset = countLines(stream, begin, size, state.histogram);
+        state.size = st.st_size;
+        state.mtime = static_cast<qint64>(st.st_mtime);
+        state.head = head;
+        current.insert(key, state);
+    }
+    states = current;
+    return true;
+}
+
+QString LogVolumeCounter::statePath(const QString &source)
+{
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/volume/" + source + ".dat";
+}
+
+/**
+ * @brief LogVolumeWork::LogVolumeWork 构造函数
+ * @param source journal、kern或dpkg
+ * @param canRun 取消标记,被停止时不发出volumeReady
+ */
+LogVolumeWork::LogVolumeWork(const QString &source, const std::shared_ptr<std::atomic_bool> &canRun, QObject *parent)
+    : QObject(parent)
+    , QRunnable()
+    , m_source(source)
+    , m_canRun(canRun)
+{
+    qRegisterMetaType<LogVolumeHistogram>("LogVolumeHistogram");
+    //使用线程池启动该线程，跑完自己删自己
+    setAutoDelete(true);
+}
+
+void LogVolumeWork::run()
+{
+    LogVolumeHistogram histogram;
+    if (LogVolumeCounter::update(m_source, *m_canRun, histogram) && *m_canRun)
+        emit volumeReady(m_source, histogram);
+}
@@ -0,0 +1,115 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGVOLUMEHISTOGRAM_H
+#define LOGVOLUMEHISTOGRAM_H
+
+#include <QByteArray>
+#include <QDataStream>
+#include <QMap>
+#include <QMetaType>
+#include <QObject>
+#include <QRunnable>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include <atomic>
+#include <memory>
+
+class LogLineStream;
+
+//直方图每个桶的时间跨度,毫秒
+#define LOG_VOLUME_BUCKET_MSEC (3600 * 1000LL)
+//journal的等级数,见PRIORITY;文本日志没有等级,记为LOG_VOLUME_DEFAULT_LEVEL
+#define LOG_VOLUME_LEVELS 8
+//没有等级的条目记在信息等级中,和journald的默认等级一致
+#define LOG_VOLUME_DEFAULT_LEVEL 6
+//时间段内超过这么多条时提示加载较慢
+#define LOG_VOLUME_HEAVY_ROWS 1000000
+//状态文件格式的版本,不一致时重新统计
+#define LOG_VOLUME_VERSION 1
+
+/**
+ * @brief The LogVolumeHistogram class 一个日志来源按小时、按等级的条目数,用于在加载前显示各时间段的数据量
+ */
+class LogVolumeHistogram
+{
+public:
+    void add(qint64 msecs, int level = LOG_VOLUME_DEFAULT_LEVEL);
+    void merge(const LogVolumeHistogram &other);
+    void dropBefore(qint64 msecs);
+    void clear() { m_buckets.clear(); }
+    bool isEmpty() const { return m_buckets.isEmpty(); }
+    qint64 count(qint64 begin, qint64 end, int level = -1) const;
+
+    static qint64 periodBegin(int periodId);
+
+    friend QDataStream &operator<<(QDataStream &out, const LogVolumeHistogram &histogram);
+    friend QDataStream &operator>>(QDataStream &in, LogVolumeHistogram &histogram);
+
+private:
+    //小时序号(毫秒时间/LOG_VOLUME_BUCKET_MSEC)到各等级的条目数
+    QMap<qint64, QVector<quint32>> m_buckets;
+};
+Q_DECLARE_METATYPE(LogVolumeHistogram)
+
+/**
+ * @brief The LogVolumeCounter class 增量更新各来源的直方图,状态保存在缓存目录中
+ * journal从上次的游标继续统计,文本日志从上次统计到的位置继续统计新写入的尾部;
+ * 压缩的轮转日志大小和修改时间不变时不再解压,轮转后不存在的文件不再计入
+ */
+class LogVolumeCounter
+{
+public:
+    static bool update(const QString &source, const std::atomic_bool &canRun, LogVolumeHistogram &histogram);
+    static bool updateJournal(QByteArray &cursor, LogVolumeHistogram &histogram, const std::atomic_bool &canRun);
+    static qint64 countLines(const char *data, qint64 begin, qint64 end, LogVolumeHistogram &histogram);
+    static qint64 countLines(const LogLineStream &stream, qint64 begin, qint64 end, LogVolumeHistogram &histogram);
+    static QString statePath(const QString &source);
+
+private:
+    /**
+     * @brief The FileState struct 一个日志文件已统计的部分
+     */
+    struct FileState {
+        qint64 offset = 0;
+        qint64 size = 0;
+        qint64 mtime = 0;
+        //文件开头的SHA1,开头被改写(如copytruncate后重新写入)时重新统计
+        QByteArray head;
+        LogVolumeHistogram histogram;
+    };
+
+    static bool updateFiles(const QStringList &paths, QMap<QByteArray, FileState> &states, const std::atomic_bool &canRun);
+    friend QDataStream &operator<<(QDataStream &out, const FileState &state);
+    friend QDataStream &operator>>(QDataStream &in, FileState &state);
+};
+
+/**
+ * @brief The LogVolumeWork class 在线程池中更新一个来源的直方图
+ */
+class LogVolumeWork : public QObject, public QRunnable
+{
+    Q_OBJECT
+
+public:
+    LogVolumeWork(const QString &source, const std::shared_ptr<std::atomic_bool> &canRun, QObject *parent = nullptr);
+
+    void run() override;
+
+signals:
+    /**
+     * @brief volumeReady 更新完成
+     * @param source 来源,如journal、kern、dpkg
+     * @param histogram 来源的直方图
+     */
+    void volumeReady(const QString &source, const LogVolumeHistogram &histogram);
+
+private:
+    QString m_source;
+    std::shared_ptr<std::atomic_bool> m_canRun;
+};
+
+#endif // LOGVOLUMEHISTOGRAM_H
@@ -0,0 +1,154 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logworkscheduler.h"
+
+#include <QLoggingCategory>
+#include <QRunnable>
+
+#ifdef QT_DEBUG
+Q_LOGGING_CATEGORY(logWorkScheduler, "org.deepin.log.viewer.work.scheduler")
+#else
+Q_LOGGING_CATEGORY(logWorkScheduler, "org.deepin.log.viewer.work.scheduler", QtInfoMsg)
+#endif
+
+namespace {
+/**
+ * @brief The PriorityRunnable class 在类别对应的线程优先级下运行任务,结束后恢复,线程池的线程是复用的
+ * 任务本身设置了autoDelete时随包装一起释放,包括被clear丢弃、没有运行的任务
+ */
+class PriorityRunnable : public QRunnable
+{
+public:
+    PriorityRunnable(QRunnable *runnable, QThread::Priority priority)
+        : m_runnable(runnable)
+        , m_priority(priority)
+    {
+    }
+
+    ~PriorityRunnable() override
+    {
+        if (m_runnable->autoDelete())
+            delete m_runnable;
+    }
+
+    void run() override
+    {
+        QThread *thread = QThread::currentThread();
+        if (m_priority != QThread::NormalPriority)
+            thread->setPriority(m_priority);
+        m_runnable->run();
+        if (thread->priority() != QThread::NormalPriority)
+            thread->setPriority(QThread::NormalPriority);
+    }
+
+private:
+    QRunnable *m_runnable;
+    QThread::Priority m_priority;
+};
+}
+
+LogWorkScheduler *LogWorkScheduler::instance()
+{
+    static LogWorkScheduler scheduler;
+    return &scheduler;
+}
+
+LogWorkScheduler::LogWorkScheduler()
+{
+    m_pools[Interactive].setMaxThreadCount(qMax(2, QThread::idealThreadCount()));
+    m_pools[Search].setMaxThreadCount(LOG_WORK_SEARCH_THREADS);
+    m_pools[Prefetch].setMaxThreadCount(LOG_WORK_PREFETCH_THREADS);
+    m_pools[Export].setMaxThreadCount(LOG_WORK_EXPORT_THREADS);
+    m_pools[Follow].setMaxThreadCount(LOG_WORK_FOLLOW_THREADS);
+}
+
+/**
+ * @brief LogWorkScheduler::start 在类别的线程池中运行任务,线程数达到上限时排队,不会失败
+ * @param runnable 任务,autoDelete时运行结束后释放
+ * @param workClass 任务类别
+ */
+void LogWorkScheduler::start(QRunnable *runnable, WorkClass workClass)
+{
+    if (!runnable || workClass < 0 || workClass >= WorkClassCount)
+        return;
+    QThreadPool &pool = m_pools[workClass];
+    if (pool.activeThreadCount() >= pool.maxThreadCount())
+        qCDebug(logWorkScheduler) << "queued" << className(workClass) << "work, active:" << pool.activeThreadCount();
+    const QThread::Priority priority = threadPriority(workClass);
+    if (priority == QThread::NormalPriority) {
+        pool.start(runnable);
+        return;
+    }
+    pool.start(new PriorityRunnable(runnable, priority));
+}
+
+/**
+ * @brief LogWorkScheduler::clear 丢弃类别中还在排队的任务,已经在运行的不受影响
+ */
+void LogWorkScheduler::clear(WorkClass workClass)
+{
+    if (workClass >= 0 && workClass < WorkClassCount)
+        m_pools[workClass].clear();
+}
+
+bool LogWorkScheduler::waitForDone(WorkClass workClass, int msecs)
+{
+    if (workClass < 0 || workClass >= WorkClassCount)
+        return true;
+    return m_pools[workClass].waitForDone(msecs);
+}
+
+void LogWorkScheduler::setMaxThreads(WorkClass workClass, int count)
+{
+    if (workClass >= 0 && workClass < WorkClassCount)
+        m_pools[workClass].setMaxThreadCount(qMax(1, count));
+}
+
+int LogWorkScheduler::maxThreads(WorkClass workClass) const
+{
+    if (workClass < 0 || workClass >= WorkClassCount)
+        return 0;
+    return m_pools[workClass].maxThreadCount();
+}
+
+int LogWorkScheduler::activeThreads(WorkClass workClass) const
+{
+    if (workClass < 0 || workClass >= WorkClassCount)
+        return 0;
+    return m_pools[workClass].activeThreadCount();
+}
+
+/**
+ * @brief LogWorkScheduler::threadPriority 各类别的线程优先级,预取使用空闲优先级,导出低于界面加载
+ */
+QThread::Priority LogWorkScheduler::threadPriority(WorkClass workClass)
+{
+    switch (workClass) {
+    case Prefetch:
+        return QThread::IdlePriority;
+    case Export:
+        return QThread::LowPriority;
+    default:
+        return QThread::NormalPriority;
+    }
+}
+
+QString LogWorkScheduler::className(WorkClass workClass)
+{
+    switch (workClass) {
+    case Interactive:
+        return "interactive";
+    case Search:
+        return "search";
+    case Prefetch:
+        return "prefetch";
+    case Export:
+        return "export";
+    case Follow:
+        return "follow";
+    default:
+        return "unknown";
+    }
+}
@@ -0,0 +1,96 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGWORKSCHEDULER_H
+#define LOGWORKSCHEDULER_H
+
+#include <QFuture>
+#include <QThread>
+#include <QThreadPool>
+#include <QtConcurrent/QtConcurrentRun>
+
+class QRunnable;
+
+//搜索、预取和导出各自的默认并发数,界面加载的并发数为CPU核数(至少2)
+#define LOG_WORK_SEARCH_THREADS 2
+#define LOG_WORK_PREFETCH_THREADS 1
+#define LOG_WORK_EXPORT_THREADS 2
+//实时跟踪线程常驻运行,单独限制,不占用界面加载的线程
+#define LOG_WORK_FOLLOW_THREADS 4
+
+/**
+ * @brief The LogWorkScheduler class 后台任务的调度,按优先级类别分别使用有并发上限的线程池
+ * 之前所有加载、搜索和导出共用QThreadPool::globalInstance(),长时间的导出会占满线程,界面点击的加载只能排队;
+ * 分开后导出和预取最多占用各自的线程数,并以较低的线程优先级运行,界面加载始终有空闲线程
+ */
+class LogWorkScheduler
+{
+public:
+    enum WorkClass {
+        //界面发起的类别加载
+        Interactive,
+        //表格内的关键字搜索
+        Search,
+        //空闲时的后台预取
+        Prefetch,
+        //导出文件
+        Export,
+        //kern.log、dmesg和journal的实时跟踪
+        Follow,
+        WorkClassCount
+    };
+
+    static LogWorkScheduler *instance();
+
+    void start(QRunnable *runnable, WorkClass workClass);
+    /**
+     * @brief run 在类别的线程池中运行函数并返回结果,用于一个加载内部拆分出的并行任务
+     * 等待结果时如果任务还在排队,QFuture会直接在等待的线程中运行它,线程池占满时也不会死锁
+     */
+    template <typename Function>
+    auto run(WorkClass workClass, Function function) -> QFuture<decltype(function())>
+    {
+        if (workClass < 0 || workClass >= WorkClassCount)
+            workClass = Interactive;
+        const QThread::Priority priority = threadPriority(workClass);
+        return QtConcurrent::run(&m_pools[workClass], [function, priority]() {
+            PriorityGuard guard(priority);
+            return function();
+        });
+    }
+    void clear(WorkClass workClass);
+    bool waitForDone(WorkClass workClass, int msecs = -1);
+
+    void setMaxThreads(WorkClass workClass, int count);
+    int maxThreads(WorkClass workClass) const;
+    int activeThreads(WorkClass workClass) const;
+
+    static QThread::Priority threadPriority(WorkClass workClass);
+    static QString className(WorkClass workClass);
+
+private:
+    /**
+     * @brief The PriorityGuard struct 作用域内使用类别的线程优先级,结束后恢复,线程池的线程是复用的
+     */
+    struct PriorityGuard {
+        explicit PriorityGuard(QThread::Priority priority)
+        {
+            if (priority != QThread::NormalPriority)
+                QThread::currentThread()->setPriority(priority);
+        }
+        ~PriorityGuard()
+        {
+            if (QThread::currentThread()->priority() != QThread::NormalPriority)
+                QThread::currentThread()->setPriority(QThread::NormalPriority);
+        }
+    };
+
+    LogWorkScheduler();
+    LogWorkScheduler(const LogWorkScheduler &) = delete;
+    LogWorkScheduler &operator=(const LogWorkScheduler &) = delete;
+
+    QThreadPool m_pools[WorkClassCount];
+};
+
+#endif // LOGWORKSCHEDULER_H
@@ -0,0 +1,223 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logxlsxwriter.h"
+#include "xlsxwriter.h"
+
+#include <QDir>
+#include <QLoggingCategory>
+
+#ifdef QT_DEBUG
+Q_LOGGING_CATEGORY(logXlsxWriter, "org.deepin.log.viewer.export.xlsx")
+#else
+Q_LOGGING_CATEGORY(logXlsxWriter, "org.deepin.log.viewer.export.xlsx", QtInfoMsg)
+#endif
+
+//一行的utf8缓冲初始大小
+#define XLSX_ROW_BUFFER_SIZE 4096
+//Excel单元格最多的字符数,超出时libxlsxwriter拒绝写入
+#define XLSX_CELL_MAX_LENGTH 32767
+
+/**
+ * @brief LogXlsxWriter::LogXlsxWriter 创建工作簿并写入第一个工作表的表头
+ * @param fileName 导出文件路径
+ * @param labels 表头,每个工作表的第一行
+ * @param rowsPerSheet 每个工作表最多的行数(含表头),0为Excel的上限1048576
+ */
+LogXlsxWriter::LogXlsxWriter(const QString &fileName, const QStringList &labels, int rowsPerSheet)
+    : m_labels(labels)
+    , m_rowsPerSheet(rowsPerSheet > 1 && rowsPerSheet < LXW_ROW_MAX ? rowsPerSheet : LXW_ROW_MAX)
+{
+    m_cells.reserve(XLSX_ROW_BUFFER_SIZE);
+    m_offsets.reserve(labels.size());
+
+    QByteArray tmpDir = QDir::tempPath().toLocal8Bit();
+    lxw_workbook_options options;
+    options.constant_memory = LXW_TRUE;
+    options.tmpdir = tmpDir.data();
+    options.use_zip64 = LXW_TRUE;
+    m_workbook = workbook_new_opt(fileName.toUtf8().constData(), &options);
+    if (!m_workbook) {
+        qCWarning(logXlsxWriter) << "create workbook failed:" << fileName;
+        return;
+    }
+    m_headerFormat = workbook_add_format(m_workbook);
+    format_set_bold(m_headerFormat);
+    addSheet();
+}
+
+/**
+ * @brief LogXlsxWriter::~LogXlsxWriter 没有调用close时(如导出被停止)也关闭工作簿,释放libxlsxwriter的资源
+ */
+LogXlsxWriter::~LogXlsxWriter()
+{
+    close();
+}
+
+bool LogXlsxWriter::isOpen() const
+{
+    return m_workbook != nullptr;
+}
+
+int LogXlsxWriter::sheetCount() const
+{
+    return m_sheetCount;
+}
+
+/**
+ * @brief LogXlsxWriter::operator<< 给当前行追加一个单元格,超过单元格长度上限的部分截掉
+ */
+LogXlsxWriter &LogXlsxWriter::operator<<(const QString &cell)
+{
+    appendCell(m_cells, m_offsets, cell);
+    return *this;
+}
+
+LogXlsxWriter::Rows &LogXlsxWriter::Rows::operator<<(const QString &cell)
+{
+    appendCell(cells, offsets, cell);
+    return *this;
+}
+
+/**
+ * @brief LogXlsxWriter::Rows::appendUtf8 追加一个已编码为utf8的单元格,如预先生成的等级文字,不做长度截断
+ */
+LogXlsxWriter::Rows &LogXlsxWriter::Rows::appendUtf8(const QByteArray &cell)
+{
+    offsets.append(cells.size());
+    cells.append(cell);
+    cells.append('\0');
+    return *this;
+}
+
+void LogXlsxWriter::Rows::endRow()
+{
+    rowEnds.append(offsets.size());
+}
+
+/**
+ * @brief LogXlsxWriter::writeRows 按顺序写入预先编码的各行,需要时换到新工作表,写入失败时抛出QString
+ */
+void LogXlsxWriter::writeRows(const Rows &rows)
+{
+    if (!m_workbook)
+        throw QString("xlsx workbook is not open");
+    int first = 0;
+    for (int end : rows.rowEnds) {
+        if (m_row >= m_rowsPerSheet)
+            addSheet();
+        writeCells(rows.cells, rows.offsets.constData() + first, end - first, nullptr);
+        first = end;
+    }
+}
+
+/**
+ * @brief LogXlsxWriter::endRow 写入当前行,写入失败时抛出QString,和导出函数的异常处理一致
+ */
+void LogXlsxWriter::endRow()
+{
+    if (!m_workbook)
+        throw QString("xlsx workbook is not open");
+    if (m_row >= m_rowsPerSheet)
+        addSheet();
+    writeRow(nullptr);
+}
+
+bool LogXlsxWriter::close()
+{
+    if (!m_workbook)
+        return false;
+    const lxw_error error = workbook_close(m_workbook);
+    m_workbook = nullptr;
+    m_worksheet = nullptr;
+    if (error != LXW_NO_ERROR)
+        qCWarning(logXlsxWriter) << "close workbook failed:" << lxw_strerror(error);
+    return error == LXW_NO_ERROR;
+}
+
+void LogXlsxWriter::addSheet()
+{
+    m_worksheet = workbook_add_worksheet(m_workbook, nullptr);
+    ++m_sheetCount;
+    m_row = 0;
+    if (m_labels.isEmpty())
+        return;
+    //表头和数据行共用同一个缓冲,先把已追加的数据单元格挪开
+    QByteArray cells;
+    QVector<int> offsets;
+    cells.swap(m_cells);
+    offsets.swap(m_offsets);
+    for (const QString &label : m_labels)
+        *this << label;
+    writeRow(m_headerFormat);
+    cells.swap(m_cells);
+    offsets.swap(m_offsets);
+}
+
+void LogXlsxWriter::writeRow(lxw_format *format)
+{
+    try {
+        writeCells(m_cells, m_offsets.constData(), m_offsets.size(), format);
+    } catch (const QString &) {
+        m_cells.resize(0);
+        m_offsets.resize(0);
+        throw;
+    }
+    //resize(0)保留已分配的空间,下一行继续使用
+    m_cells.resize(0);
+    m_offsets.resize(0);
+}
+
+void LogXlsxWriter::writeCells(const QByteArray &cells, const int *offsets, int count, lxw_format *format)
+{
+    for (int col = 0; col < count; ++col) {
+        const lxw_error error = worksheet_write_string(m_worksheet, static_cast<lxw_row_t>(m_row), static_cast<lxw_col_t>(col),
+                                                       cells.constData() + offsets[col], format);
+        if (error != LXW_NO_ERROR)
+            throw QString("write xlsx cell failed: %1").arg(lxw_strerror(error));
+    }
+    ++m_row;
+}
+
+/**
+ * @brief LogXlsxWriter::appendCell 单元格编码为utf8追加到cells,超过单元格长度上限的部分截掉
+ */
+void LogXlsxWriter::appendCell(QByteArray &cells, QVector<int> &offsets, const QString &cell)
+{
+    offsets.append(cells.size());
+    appendUtf8(cells, cell.size() > XLSX_CELL_MAX_LENGTH ? cell.left(XLSX_CELL_MAX_LENGTH) : cell);
+    cells.append('\0');
+}
+
+/**
+ * @brief LogXlsxWriter::appendUtf8 把text编码为utf8追加到out,不生成临时对象;落单的代理项按U+FFFD处理
+ */
+void LogXlsxWriter::appendUtf8(QByteArray &out, const QString &text)
+{
+    const ushort *data = text.utf16();
+    const int size = text.size();
+    for (int i = 0; i < size; ++i) {
+        uint code = data[i];
+        if (QChar::isHighSurrogate(code) && i + 1 < size && QChar::isLowSurrogate(data[i + 1])) {
+            code = QChar::surrogateToUcs4(static_cast<ushort>(code), data[++i]);
+        } else if (QChar::isSurrogate(code)) {
+            code = QChar::ReplacementCharacter;
+        }
+        if (code < 0x80) {
+            out.append(static_cast<char>(code));
+        } else if (code < 0x800) {
+            out.append(static_cast<char>(0xC0 | (code >> 6)));
+            out.append(static_cast<char>(0x80 | (code & 0x3F)));
+        } else if (code < 0x10000) {
+            out.append(static_cast<char>(0xE0 | (code >> 12)));
+            out.append(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+            out.append(static_cast<char>(0x80 | (code & 0x3F)));
+        } else {
+            out.append(static_cast<char>(0xF0 | (code >> 18)));
+            out.append(static_cast<char>(0x80 | ((code >> 12) & 0x3F)));
+            out.append(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+            out.append(static_cast<char>(0x80 | (code & 0x3F)));
+        }
+    }
+}
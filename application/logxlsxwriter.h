@@ -0,0 +1,73 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGXLSXWRITER_H
+#define LOGXLSXWRITER_H
+
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+struct lxw_workbook;
+struct lxw_worksheet;
+struct lxw_format;
+
+/**
+ * @brief The LogXlsxWriter class 逐行写入的xlsx导出,使用libxlsxwriter的constant_memory模式
+ * 每写完一行libxlsxwriter就把它落到临时文件,内存占用和行数无关;一行的各单元格先一次性转为utf8放进复用的缓冲,
+ * 不再为每个单元格生成临时std::string;工作表写满Excel的行数上限后自动换到新工作表并重写表头
+ */
+class LogXlsxWriter
+{
+public:
+    explicit LogXlsxWriter(const QString &fileName, const QStringList &labels, int rowsPerSheet = 0);
+    ~LogXlsxWriter();
+
+    bool isOpen() const;
+    int sheetCount() const;
+
+    /**
+     * @brief The Rows struct 在其他线程中预先编码的若干行,由writeRows按顺序写入,和逐个单元格写入的结果一致
+     */
+    struct Rows {
+        //各单元格的utf8文字,以'\0'分隔
+        QByteArray cells;
+        //各单元格在cells中的起始位置
+        QVector<int> offsets;
+        //每行结束时offsets的长度
+        QVector<int> rowEnds;
+
+        Rows &operator<<(const QString &cell);
+        Rows &appendUtf8(const QByteArray &cell);
+        void endRow();
+    };
+
+    LogXlsxWriter &operator<<(const QString &cell);
+    void endRow();
+    void writeRows(const Rows &rows);
+    bool close();
+
+    static void appendUtf8(QByteArray &out, const QString &text);
+
+private:
+    static void appendCell(QByteArray &cells, QVector<int> &offsets, const QString &cell);
+    void addSheet();
+    void writeRow(lxw_format *format);
+    void writeCells(const QByteArray &cells, const int *offsets, int count, lxw_format *format);
+
+    lxw_workbook *m_workbook = nullptr;
+    lxw_worksheet *m_worksheet = nullptr;
+    lxw_format *m_headerFormat = nullptr;
+    QStringList m_labels;
+    int m_rowsPerSheet;
+    int m_sheetCount = 0;
+    //当前工作表中下一行的行号
+    int m_row = 0;
+    //当前行各单元格的utf8文字,以'\0'分隔
+    QByteArray m_cells;
+    QVector<int> m_offsets;
+};
+
+#endif // LOGXLSXWRITER_H
@@ -0,0 +1,264 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logzipwriter.h"
+
+#include "minizip/zip.h"
+
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QFuture>
+#include <QLoggingCategory>
+#include <QtConcurrent>
+
+#include <algorithm>
+
+#ifdef QT_DEBUG
+Q_LOGGING_CATEGORY(logZipWriter, "org.deepin.log.viewer.export.zip")
+#else
+Q_LOGGING_CATEGORY(logZipWriter, "org.deepin.log.viewer.export.zip", QtInfoMsg)
+#endif
+
+//不超过这个大小的文件交给线程池整体压缩,更大的文件在写入线程中流式压缩
+#define ZIP_PARALLEL_MAX_SIZE (32 * 1024 * 1024)
+//读取源文件的块大小
+#define ZIP_READ_BLOCK_SIZE (1024 * 1024)
+//超过这个大小的文件按zip64写入
+#define ZIP_ZIP64_MIN_SIZE 0xFFFFFFFFLL
+
+LogZipWriter::LogZipWriter(const QString &fileName)
+{
+    m_pool.setMaxThreadCount(qMax(1, QThread::idealThreadCount()));
+    m_zip = zipOpen64(fileName.toLocal8Bit().constData(), APPEND_STATUS_CREATE);
+    if (!m_zip)
+        qCWarning(logZipWriter) << "create zip file failed:" << fileName;
+}
+
+/**
+ * @brief LogZipWriter::~LogZipWriter 没有调用close时也关闭zip,释放minizip的资源
+ */
+LogZipWriter::~LogZipWriter()
+{
+    m_canceled = true;
+    m_pool.waitForDone();
+    close();
+}
+
+bool LogZipWriter::isOpen() const
+{
+    return m_zip != nullptr;
+}
+
+/**
+ * @brief LogZipWriter::addFile 加入一个待打包的文件,调用write时才读取
+ * @param sourcePath 源文件路径
+ * @param entryName 包中的路径,以'/'分隔
+ */
+void LogZipWriter::addFile(const QString &sourcePath, const QString &entryName)
+{
+    const QFileInfo info(sourcePath);
+    m_entries.append({sourcePath, entryName.toUtf8(), info.size(), info.lastModified()});
+    m_totalBytes += info.size();
+}
+
+/**
+ * @brief LogZipWriter::addDirectory 加入目录下的所有文件,包括隐藏文件和子目录中的文件
+ * @param entryPrefix 这些文件在包中所在的目录,为空时放在包的根目录
+ */
+void LogZipWriter::addDirectory(const QString &dirPath, const QString &entryPrefix)
+{
+    const QDir dir(dirPath);
+    QStringList paths;
+    QDirIterator it(dirPath, QDir::Files | QDir::Hidden | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+    while (it.hasNext())
+        paths.append(it.next());
+    //目录遍历顺序不固定,排序后包中的顺序稳定
+    std::sort(paths.begin(), paths.end());
+    const QString prefix = entryPrefix.isEmpty() || entryPrefix.endsWith(QLatin1Char('/')) ? entryPrefix : entryPrefix + QLatin1Char('/');
+    for (const QString &path : paths)
+        addFile(path, prefix + dir.relativeFilePath(path));
+}
+
+int LogZipWriter::entryCount() const
+{
+    return m_entries.size();
+}
+
+qint64 LogZipWriter::totalBytes() const
+{
+    return m_totalBytes;
+}
+
+/**
+ * @brief LogZipWriter::write 压缩并写入所有已加入的文件
+ * 线程池最多比写入位置提前两倍线程数个文件,已经压缩好但还没轮到写入的数据不会无限堆积;
+ * 打不开的源文件跳过并记日志,和zip命令行的行为一致
+ * @param progress 每写完一个文件或一块数据调用一次
+ * @return 是否全部写入,被progress停止时为false
+ */
+bool LogZipWriter::write(const Progress &progress)
+{
+    if (!m_zip)
+        return false;
+    m_canceled = false;
+    const int count = m_entries.size();
+    const int window = m_pool.maxThreadCount() * 2;
+    QVector<QFuture<Deflated>> pending(count);
+    int launched = 0;
+    qint64 done = 0;
+    bool ok = true;
+    for (int i = 0; i < count && ok; ++i) {
+        for (; launched < count && launched < i + window; ++launched) {
+            const Entry &entry = m_entries.at(launched);
+            if (entry.size > ZIP_PARALLEL_MAX_SIZE)
+                continue;
+            const QString path = entry.sourcePath;
+            pending[launched] = QtConcurrent::run(&m_pool, [this, path]() {
+                return deflateFile(path, m_canceled);
+            });
+        }
+
+        const Entry &entry = m_entries.at(i);
+        if (entry.size > ZIP_PARALLEL_MAX_SIZE) {
+            ok = writeStreamed(entry, done, progress);
+        } else {
+            const Deflated deflated = pending[i].result();
+            pending[i] = QFuture<Deflated>();
+            if (deflated.ok)
+                ok = writeDeflated(entry, deflated);
+            else
+                qCWarning(logZipWriter) << "skip unreadable file:" << entry.sourcePath;
+            done += entry.size;
+        }
+        if (ok && progress && !progress(qMin(done, m_totalBytes), m_totalBytes))
+            ok = false;
+    }
+    if (!ok) {
+        m_canceled = true;
+        m_pool.waitForDone();
+    }
+    m_entries.clear();
+    m_totalBytes = 0;
+    return ok;
+}
+
+bool LogZipWriter::close()
+{
+    if (!m_zip)
+        return false;
+    const int error = zipClose(m_zip, nullptr);
+    m_zip = nullptr;
+    if (error != ZIP_OK)
+        qCWarning(logZipWriter) << "close zip file failed:" << error;
+    return error == ZIP_OK;
+}
+
+/**
+ * @brief LogZipWriter::deflateFile 把整个文件压缩为不带头的deflate数据,在线程池中调用
+ */
+LogZipWriter::Deflated LogZipWriter::deflateFile(const QString &path, const std::atomic_bool &canceled)
+{
+    Deflated result;
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return result;
+    z_stream stream = {};
+    if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+        return result;
+
+    QByteArray input(ZIP_READ_BLOCK_SIZE, Qt::Uninitialized);
+    result.data.resize(static_cast<int>(deflateBound(&stream, static_cast<uLong>(file.size()))) + 64);
+    stream.next_out = reinterpret_cast<Bytef *>(result.data.data());
+    stream.avail_out = static_cast<uInt>(result.data.size());
+    uLong crc = crc32(0, Z_NULL, 0);
+    int flush = Z_NO_FLUSH;
+    int error = Z_OK;
+    while (flush != Z_FINISH && error >= Z_OK) {
+        if (canceled) {
+            deflateEnd(&stream);
+            return Deflated();
+        }
+        const qint64 read = file.read(input.data(), input.size());
+        if (read < 0) {
+            deflateEnd(&stream);
+            return Deflated();
+        }
+        crc = crc32(crc, reinterpret_cast<const Bytef *>(input.constData()), static_cast<uInt>(read));
+        flush = read < input.size() ? Z_FINISH : Z_NO_FLUSH;
+        stream.next_in = reinterpret_cast<Bytef *>(input.data());
+        stream.avail_in = static_cast<uInt>(read);
+        do {
+            //读取期间文件变大时预估的空间可能不够
+            if (stream.avail_out == 0) {
+                const uLong used = stream.total_out;
+                result.data.resize(result.data.size() * 2);
+                stream.next_out = reinterpret_cast<Bytef *>(result.data.data()) + used;
+                stream.avail_out = static_cast<uInt>(static_cast<uLong>(result.data.size()) - used);
+            }
+            error = deflate(&stream, flush);
+        } while (error >= Z_OK && (stream.avail_in > 0 || (flush == Z_FINISH && error != Z_STREAM_END)));
+    }
+    result.data.resize(static_cast<int>(stream.total_out));
+    result.size = static_cast<qint64>(stream.total_in);
+    result.crc = static_cast<quint32>(crc);
+    result.ok = deflateEnd(&stream) == Z_OK && error == Z_STREAM_END;
+    return result;
+}
+
+bool LogZipWriter::writeDeflated(const Entry &entry, const Deflated &deflated)
+{
+    if (!openEntry(entry, 1, 0))
+        return false;
+    const bool ok = zipWriteInFileInZip(m_zip, deflated.data.constData(), static_cast<unsigned>(deflated.data.size())) == ZIP_OK;
+    return zipCloseFileInZipRaw64(m_zip, static_cast<ZPOS64_T>(deflated.size), deflated.crc) == ZIP_OK && ok;
+}
+
+/**
+ * @brief LogZipWriter::writeStreamed 大文件边读边由minizip压缩写入,每块数据更新一次进度
+ */
+bool LogZipWriter::writeStreamed(const Entry &entry, qint64 &done, const Progress &progress)
+{
+    QFile file(entry.sourcePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qCWarning(logZipWriter) << "skip unreadable file:" << entry.sourcePath;
+        done += entry.size;
+        return true;
+    }
+    if (!openEntry(entry, 0, entry.size >= ZIP_ZIP64_MIN_SIZE ? 1 : 0))
+        return false;
+    QByteArray block(ZIP_READ_BLOCK_SIZE, Qt::Uninitialized);
+    bool ok = true;
+    qint64 read = 0;
+    while (ok && (read = file.read(block.data(), block.size())) > 0) {
+        ok = zipWriteInFileInZip(m_zip, block.constData(), static_cast<unsigned>(read)) == ZIP_OK;
+        done += read;
+        if (ok && progress && !progress(qMin(done, m_totalBytes), m_totalBytes))
+            ok = false;
+    }
+    if (read < 0)
+        qCWarning(logZipWriter) << "read file failed, entry truncated:" << entry.sourcePath;
+    return zipCloseFileInZip(m_zip) == ZIP_OK && ok;
+}
+
+bool LogZipWriter::openEntry(const Entry &entry, int raw, int zip64)
+{
+    zip_fileinfo info = {};
+    //源文件已不存在时修改时间无效,用当前时间
+    const QDateTime modified = entry.modified.isValid() ? entry.modified : QDateTime::currentDateTime();
+    const QDate date = modified.date();
+    const QTime time = modified.time();
+    info.tmz_date.tm_sec = static_cast<uInt>(time.second());
+    info.tmz_date.tm_min = static_cast<uInt>(time.minute());
+    info.tmz_date.tm_hour = static_cast<uInt>(time.hour());
+    info.tmz_date.tm_mday = static_cast<uInt>(date.day());
+    info.tmz_date.tm_mon = static_cast<uInt>(date.month() - 1);
+    info.tmz_date.tm_year = static_cast<uInt>(date.year());
+    const int error = zipOpenNewFileInZip2_64(m_zip, entry.name.constData(), &info, nullptr, 0, nullptr, 0, nullptr,
+                                              Z_DEFLATED, Z_DEFAULT_COMPRESSION, raw, zip64);
+    if (error != ZIP_OK)
+        qCWarning(logZipWriter) << "open zip entry failed:" << entry.name << error;
+    return error == ZIP_OK;
+}
@@ -0,0 +1,73 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGZIPWRITER_H
+#define LOGZIPWRITER_H
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QString>
+#include <QThreadPool>
+#include <QVector>
+
+#include <atomic>
+#include <functional>
+
+/**
+ * @brief The LogZipWriter class 进程内的zip打包,替代调用7z、zip命令行
+ * 源文件直接读入压缩,不经过临时目录;较小的文件由线程池并行压缩成原始deflate数据,再按加入顺序写入包中,
+ * 较大的文件在写入线程中边读边压缩,同时线程池继续压缩后面的小文件,内存占用只和线程数有关;
+ * 进度为已压缩的源文件字节数
+ */
+class LogZipWriter
+{
+public:
+    /**
+     * @brief Progress 打包进度回调,返回false时停止打包
+     */
+    using Progress = std::function<bool(qint64 done, qint64 total)>;
+
+    explicit LogZipWriter(const QString &fileName);
+    ~LogZipWriter();
+
+    bool isOpen() const;
+    void addFile(const QString &sourcePath, const QString &entryName);
+    void addDirectory(const QString &dirPath, const QString &entryPrefix);
+    int entryCount() const;
+    qint64 totalBytes() const;
+
+    bool write(const Progress &progress = Progress());
+    bool close();
+
+private:
+    struct Entry {
+        QString sourcePath;
+        QByteArray name;
+        qint64 size;
+        QDateTime modified;
+    };
+    /**
+     * @brief The Deflated struct 线程池中压缩好的一个文件
+     */
+    struct Deflated {
+        QByteArray data;
+        quint32 crc = 0;
+        qint64 size = 0;
+        bool ok = false;
+    };
+
+    static Deflated deflateFile(const QString &path, const std::atomic_bool &canceled);
+    bool writeDeflated(const Entry &entry, const Deflated &deflated);
+    bool writeStreamed(const Entry &entry, qint64 &done, const Progress &progress);
+    bool openEntry(const Entry &entry, int raw, int zip64);
+
+    //minizip的zipFile句柄
+    void *m_zip = nullptr;
+    QVector<Entry> m_entries;
+    qint64 m_totalBytes = 0;
+    QThreadPool m_pool;
+    std::atomic_bool m_canceled {false};
+};
+
+#endif // LOGZIPWRITER_H
@@ -7,11 +7,15 @@
 #include "logapplication.h"
 #include "environments.h"
 #include "dbusmanager.h"
+#include "dbusproxy/dldbushandler.h"
 #include "utils.h"
 #include "eventlogutils.h"
 #include "DebugTimeManager.h"
+#include "logtracer.h"
 #include "logbackend.h"
+#include "logbenchmark.h"
 #include "cliapplicationhelper.h"
+#include "journalreader.h"
 #include "accessible.h"
 
 #include <DApplication>
@@ -21,10 +25,13 @@
 #include <DLog>
 
 #include <QDateTime>
+#include <QFile>
 #include <QSurfaceFormat>
 #include <QDebug>
 #include <QLoggingCategory>
 
+#include <unistd.h>
+
 DWIDGET_USE_NAMESPACE
 DCORE_USE_NAMESPACE
 
@@ -69,6 +76,13 @@ int main(int argc, char *argv[])
         QCommandLineOption statusOption(QStringList() << "s" << "status", DApplication::translate("main", "Export boot(no-klu) logs within a specified status"), DApplication::translate("main", "BOOT STATUS"));
         QCommandLineOption eventOption(QStringList() << "E" << "event", DApplication::translate("main", "Export boot-shutdown-event or audit logs within a specified event type"), DApplication::translate("main", "EVENT TYPE"));
         QCommandLineOption keywordOption(QStringList() << "k" << "search", DApplication::translate("main", "Export logs based on keywords search results"), DApplication::translate("main", "KEY WORD"));
+        QCommandLineOption gzipOption(QStringList() << "z" << "gzip", DApplication::translate("main", "Compress the exported text logs with gzip (.txt.gz)"));
+        QCommandLineOption ndjsonOption(QStringList() << "j" << "ndjson", DApplication::translate("main", "Export the text logs as one JSON object per line (.ndjson)"));
+        QCommandLineOption incrementalOption(QStringList() << "i" << "incremental", DApplication::translate("main", "Export only the logs added since the last successful export of all logs"));
+        QCommandLineOption queryOption(QStringList() << "q" << "query" << "stdout", DApplication::translate("main", "Query logs by conditions and write the results to standard output while parsing"));
+        QCommandLineOption followOption(QStringList() << "f" << "follow", DApplication::translate("main", "Keep running and write new system or kernel logs to standard output as they arrive"));
+        QCommandLineOption benchOption(QStringList() << "bench", DApplication::translate("main", "Benchmark log parsing and exporting on a file or directory, and print the results as JSON"), DApplication::translate("main", "PATH"));
+        QCommandLineOption journalDirOption(QStringList() << "journal-dir", DApplication::translate("main", "Read the system journals from the specified directory (journals collected from other machines, or a system root) instead of the local journal, can be repeated"), DApplication::translate("main", "DIR"));
         QCommandLineOption reportCoredumpOption(QStringList() << "reportcoredump", DApplication::translate("main", "Report coredump informations."));
 
         QCommandLineParser cmdParser;
@@ -83,6 +97,13 @@ int main(int argc, char *argv[])
         cmdParser.addOption(statusOption);
         cmdParser.addOption(eventOption);
         cmdParser.addOption(keywordOption);
+        cmdParser.addOption(gzipOption);
+        cmdParser.addOption(ndjsonOption);
+        cmdParser.addOption(incrementalOption);
+        cmdParser.addOption(queryOption);
+        cmdParser.addOption(followOption);
+        cmdParser.addOption(benchOption);
+        cmdParser.addOption(journalDirOption);
         cmdParser.addOption(reportCoredumpOption);
 
         if (!cmdParser.parse(qApp->arguments())) {
@@ -102,6 +123,9 @@ int main(int argc, char *argv[])
         QString keyword = "";
         if (cmdParser.isSet(typeOption))
             type = cmdParser.value(typeOption);
+        //命令行指定的journal目录优先于配置
+        if (cmdParser.isSet(journalDirOption))
+            JournalReaderBase::setSourceDirectories(cmdParser.values(journalDirOption));
         if (cmdParser.isSet(appOption))
             appName = cmdParser.value(appOption);
         if (cmdParser.isSet(periodOption))
@@ -154,6 +178,68 @@ int main(int argc, char *argv[])
             if (!LogBackend::instance(&a)->reportCoredumpInfo())
                 return -1;
 
+            return a.exec();
+        } else if (cmdParser.isSet(benchOption)) {
+            if (cmdParser.isSet(exportOption) || cmdParser.isSet(queryOption) || cmdParser.isSet(followOption)) {
+                qCWarning(logAppMain) << "Option --bench can not be used with -e, --query or --follow.";
+                return -1;
+            }
+
+            Utils::runInCmd = true;
+            // -t指定文件的日志种类,目录按文件名识别;-t system读取本机journal
+            LogBenchmark bench;
+            if (!bench.addPath(cmdParser.value(benchOption), type))
+                return -1;
+            const bool bRet = bench.run();
+            QFile out;
+            if (out.open(STDOUT_FILENO, QIODevice::WriteOnly))
+                out.write(LogBenchmark::toJson(bench.results()));
+            return bRet ? 0 : -1;
+        } else if (cmdParser.isSet(followOption)) {
+            if (cmdParser.isSet(exportOption) || cmdParser.isSet(queryOption)) {
+                qCWarning(logAppMain) << "Option --follow writes to standard output, it can not be used with -e or --query.";
+                return -1;
+            }
+            if (type.isEmpty() || !appName.isEmpty() || !period.isEmpty()) {
+                qCWarning(logAppMain) << "Option --follow needs a log type (-t system, kernel, dpkg or kwin), and can not be used with -d or -p.";
+                return -1;
+            }
+
+            Utils::runInCmd = true;
+            // 只输出启动之后新产生的日志,格式同--query,直到进程被结束
+            LogBackend::instance(&a)->setJsonExport(cmdParser.isSet(ndjsonOption));
+            if (!LogBackend::instance(&a)->followTypeLogs(type, level, keyword))
+                return -1;
+
+            return a.exec();
+        } else if (cmdParser.isSet(queryOption)) {
+            if (cmdParser.isSet(exportOption)) {
+                qCWarning(logAppMain) << "Option --query writes to standard output, it can not be used with -e.";
+                return -1;
+            }
+            if (type.isEmpty() && appName.isEmpty()) {
+                qCWarning(logAppMain) << "Option --query needs a log type (-t) or an application (-d).";
+                return -1;
+            }
+            if (!type.isEmpty() && type != TYPE_APP && !appName.isEmpty()) {
+                qCWarning(logAppMain) << QString("Option -d -t both exist, -t can only be set to 'app' type.");
+                return -1;
+            }
+
+            Utils::runInCmd = true;
+            // 结果按导出的txt格式逐批写到标准输出,指定-j时每条记录为一行json
+            LogBackend::instance(&a)->setJsonExport(cmdParser.isSet(ndjsonOption));
+            bool bRet = false;
+            if (!appName.isEmpty()) {
+                bRet = LogBackend::instance(&a)->queryAppLogsByCondition(appName, period, level, keyword);
+            } else {
+                // 级别、状态、事件类型按日志种类只有一个有效,由解析时校验
+                const QString condition = !level.isEmpty() ? level : (!status.isEmpty() ? status : event);
+                bRet = LogBackend::instance(&a)->queryTypeLogsByCondition(type, period, condition, keyword);
+            }
+            if (!bRet)
+                return -1;
+
             return a.exec();
         } else if (cmdParser.isSet(exportOption)) {
 
@@ -171,6 +257,10 @@ int main(int argc, char *argv[])
                 return -1;
             }
 
+            // 按条件导出的文本日志边导出边压缩
+            LogBackend::instance(&a)->setCompressExport(cmdParser.isSet(gzipOption));
+            LogBackend::instance(&a)->setJsonExport(cmdParser.isSet(ndjsonOption));
+
             if (!type.isEmpty() && type != "app" && !appName.isEmpty()) {
                 qCWarning(logAppMain) << QString("Option -d -t both exist, -t can only be set to 'app' type.");
                 return -1;
@@ -268,7 +358,8 @@ int main(int argc, char *argv[])
                     qCWarning(logAppMain) << "Export all logs by conditons currently is not supported.";
                     return -1;
                 }
-                // 未指定类型，默认导出所有日志
+                // 未指定类型，默认导出所有日志，指定-i时只导出上次导出之后新增的
+                LogBackend::instance(&a)->setIncrementalExport(cmdParser.isSet(incrementalOption));
                 int nRet = LogBackend::instance(&a)->exportAllLogs(outDir);
                 if (nRet != 0)
                     return nRet;
@@ -282,6 +373,8 @@ int main(int argc, char *argv[])
     } else {
 
         PERF_PRINT_BEGIN("POINT-01", "");
+        //启动到第一屏显示出结果、可以操作的时间
+        PERF_PRINT_BEGIN("POINT-06", "");
 
         //klu下不使用opengl 使用OpenGLES,因为opengl基于x11 现在全面换wayland了
         QCoreApplication::setAttribute(Qt::AA_UseOpenGLES);
@@ -295,6 +388,8 @@ int main(int argc, char *argv[])
         format.setRenderableType(QSurfaceFormat::OpenGLES);
         format.setDefaultFormat(format);
         LogApplication a(argc, argv);
+        //开启追踪时收到SIGUSR1导出trace
+        LogTracer::instance()->installDumpSignal(&a);
 
         qputenv("DTK_USE_SEMAPHORE_SINGLEINSTANCE", "1");
 
@@ -321,14 +416,16 @@ int main(int argc, char *argv[])
         DLogManager::registerConsoleAppender();
         DLogManager::registerFileAppender();
 #endif
-        LogApplicationHelper::instance();
-
         if (!DGuiApplicationHelper::instance()->setSingleInstance(a.applicationName(),
                                                                   DGuiApplicationHelper::UserScope)) {
             qCCritical(logAppMain) << "DGuiApplicationHelper::instance()->setSingleInstance";
             a.activeWindow();
             return 0;
         }
+        //已有实例时直接退出,不读取应用日志配置
+        LogApplicationHelper::instance();
+        //后台服务的激活和界面的创建同时进行,不等待
+        DLDBusHandler::warmUp(&a);
 
         // 显示GUI
         LogCollectorMain w;
@@ -337,8 +434,7 @@ int main(int argc, char *argv[])
         // 自动化标记由此开始
         QAccessible::installFactory(accessibleFactory);
 
-        // 先初始化埋点接口，延迟2秒后调用埋点接口，以便能正常写入埋点数据
-        Eventlogutils::GetInstance();
+        // 埋点接口在第一屏显示之后由主窗口初始化(最迟1.5秒)，延迟2秒后调用埋点接口，以便能正常写入埋点数据
         QTimer::singleShot(2000, &a, [=]{
             //埋点记录启动数据
             QJsonObject objStartEvent{
@@ -353,6 +449,8 @@ int main(int argc, char *argv[])
         Dtk::Widget::moveToCenter(&w);
         bool result = a.exec();
         PERF_PRINT_END("POINT-02", "");
+        if (LogTracer::isEnabled())
+            LogTracer::instance()->dump();
 
         return  result;
 
@@ -9,6 +9,8 @@
 #include <QMap>
 #include <QJsonObject>
 #include "utils.h"
+
+#include <memory>
 #define DPKG_TABLE_DATA "dpkgItemData"
 #define XORG_TABLE_DATA "XorgItemData"
 #define BOOT_TABLE_DATA "bootItemData"
@@ -99,43 +101,87 @@ struct LOG_MSG_JOURNAL {
     QString hostName;
     QString daemonName;
     QString daemonId;
-    QString level;
+    //等级,为PRIORITY的值,没有等级(如kern.log)时为-1;显示文字见LogLevel
+    int level = -1;
     QString msg;
+    //日志时间(微秒时间戳),dateTime为其显示文本
+    qint64 timestamp = 0;
+    //MESSAGE过长时msg只保存前一部分,此处保存条目游标,需要完整内容时通过游标重新读取;为空表示msg已完整
+    QByteArray cursor;
 };
 
 struct LOG_MSG_DPKG {
     QString dateTime;
     QString action;
     QString msg;
+    //日志时间(毫秒时间戳),用于按事务归组,dateTime为其显示文本
+    qint64 timestamp = 0;
 };
 
 struct LOG_MSG_DNF {
     QString dateTime;
-    QString level;
+    //等级,为DNFPRIORITY的值,无法识别时为DNFINVALID
+    int level = DNFINVALID;
     QString msg;
 };
 
 struct LOG_MSG_DMESG {
-    QString level;
+    //等级,为PRIORITY的值
+    int level = -1;
     QString dateTime;
     QString msg;
 };
+/**
+ * @brief The BOOT_STATUS enum 启动日志行首"[  OK  ]"、"[FAILED]"中的状态
+ */
+enum BOOT_STATUS { BootStatusNone = 0, //没有状态,为上一条记录的后续或其他行
+                   BootStatusOk,
+                   BootStatusFailed
+                 };
+
 struct LOG_MSG_BOOT {
+    //状态的显示文字,"OK"、"Failed"或空
     QString status;
     QString msg;
+    //状态,为BOOT_STATUS的值,解析时确定,筛选时只比较它
+    int statusCode = BootStatusNone;
+};
+
+/**
+ * @brief The LOG_MESSAGE_REF struct 被截断的信息的完整内容所在位置,见LogLongMessage
+ * 文件来源为所在行的字节范围和行中信息开始的字符位置,journal来源为条目游标
+ */
+struct LOG_MESSAGE_REF {
+    QString path;
+    qint64 offset = -1;
+    int length = 0;
+    //行首到信息开始的字符数
+    int skip = 0;
+    QByteArray cursor;
+
+    bool isNull() const { return offset < 0 && cursor.isEmpty(); }
 };
 
 struct LOG_MSG_APPLICATOIN {
     QString dateTime;
-    QString level;
+    //等级,为PRIORITY的值,行中的等级无法识别时为-1
+    int level = -1;
     QString src;
+    //信息,过长时只保存前LOG_LONG_MESSAGE_PREFIX个字符
     QString msg;
+    //完整信息,只在msg被截断又没有可用的fullRef(如压缩日志、通过服务读取)时保存
     QString detailInfo;
+    //日志时间(微秒时间戳),只有journal来源的应用日志会设置
+    qint64 timestamp = 0;
+    //msg被截断时完整信息的位置,打开详情或导出时按它读取
+    LOG_MESSAGE_REF fullRef;
 };
 
 struct LOG_MSG_XORG {
     QString offset;
     QString msg;
+    //offset的数值(微秒),解析时计算一次,用于排序和按时间筛选;不是数字时为-1
+    qint64 offsetUsec = -1;
 };
 
 // add by Airy
@@ -144,6 +190,8 @@ struct LOG_MSG_NORMAL {
     QString userName;
     QString dateTime;
     QString msg;
+    //事件时间(秒,wtmp中的ut_time),dateTime为其显示文本,排序和比较都用它
+    qint64 time = 0;
 };
 struct LOG_MSG_KWIN {
     QString msg;
@@ -168,22 +216,49 @@ struct LOG_MSG_AUDIT {
     QString processName;
     QString processId;
     QString status;
-    QString msg;
+    //原文,同一事件的多行记录以换行连接;信息列不单独保存,由message()从原文截取
     QString origin;
+    //审计类型对应的位,解析时按auditType设置一次,按类型筛选时只需一次按位与;为0时按auditType文本比较
+    quint32 auditTypeBit = 0;
 
-    bool contains(const QString& searchstr) {
+    bool contains(const QString& searchstr) const {
         if (auditType.contains(searchstr, Qt::CaseInsensitive)
                 || eventType.contains(searchstr, Qt::CaseInsensitive)
                 || dateTime.contains(searchstr, Qt::CaseInsensitive)
                 || processName.contains(searchstr, Qt::CaseInsensitive)
                 || status.contains(searchstr, Qt::CaseInsensitive)
-                || msg.contains(searchstr, Qt::CaseInsensitive))
+                || message().contains(searchstr, Qt::CaseInsensitive))
             return true;
 
         return false;
     }
 
-    QString auditType2Str(int nAuditType) {
+    /**
+     * @brief message 信息列,原文每行"msg=audit(...): "之后的部分,多行时以换行连接
+     * 只有一行时直接截取一次,不拼接
+     */
+    QString message() const {
+        QString text;
+        int lineBegin = 0;
+        while (lineBegin <= origin.size()) {
+            int lineEnd = origin.indexOf(QLatin1Char('\n'), lineBegin);
+            if (lineEnd < 0)
+                lineEnd = origin.size();
+            const QStringRef line = origin.midRef(lineBegin, lineEnd - lineBegin);
+            const int idBegin = line.indexOf(QLatin1String("msg=audit("));
+            const int idEnd = idBegin < 0 ? -1 : line.indexOf(QLatin1Char(')'), idBegin);
+            const QStringRef detail = idEnd < 0 ? QStringRef() : line.mid(idEnd + 3);
+            if (lineBegin == 0 && lineEnd == origin.size())
+                return detail.toString();
+            if (lineBegin > 0)
+                text.append(QLatin1Char('\n'));
+            text.append(detail);
+            lineBegin = lineEnd + 1;
+        }
+        return text;
+    }
+
+    QString auditType2Str(int nAuditType) const {
         QString str = "";
         switch (nAuditType) {
         case IDENTAUTH:
@@ -212,7 +287,29 @@ struct LOG_MSG_AUDIT {
         return str;
     }
 
-    bool filterAuditType(int nAuditType) {
+    static int auditStr2Type(const QString &str) {
+        //审计类型名称按枚举顺序排列,每条事件解析时查一次
+        static const char *const names[] = {Audit_IdentAuth, Audit_DAC, Audit_MAC, Audit_Remote, Audit_DocAudit, Audit_Other};
+        for (int i = IDENTAUTH; i <= OTHER; ++i) {
+            if (str == QLatin1String(names[i]))
+                return i;
+        }
+        return AUDITLVALL;
+    }
+
+    static quint32 auditTypeMask(int nAuditType) {
+        return (nAuditType >= IDENTAUTH && nAuditType <= OTHER) ? (1u << nAuditType) : 0u;
+    }
+
+    void setAuditType(const QString &str) {
+        auditType = str;
+        auditTypeBit = auditTypeMask(auditStr2Type(str));
+    }
+
+    bool filterAuditType(int nAuditType) const {
+        if (auditTypeBit != 0)
+            return (auditTypeBit & auditTypeMask(nAuditType)) != 0;
+
         QString str = auditType2Str(nAuditType);
         if (str.compare(auditType) == 0)
             return true;
@@ -231,6 +328,12 @@ struct LOG_MSG_COREDUMP {
     QString storagePath;
     QString stackInfo;
     QString maps;
+    //崩溃时间(微秒时间戳),dateTime为其显示文本
+    qint64 timestamp = 0;
+    //等级,为PRIORITY的值,崩溃记录没有等级,为-1
+    int level = -1;
+    //journal条目游标,堆栈和maps信息在需要时通过游标读取;为空表示已读取
+    QByteArray cursor;
 
     QJsonObject toJson() {
         QJsonObject obj;
@@ -252,9 +355,24 @@ struct TIME_RANGE {
     qint64 end = -1;
 };
 
+/**
+ * @brief The LogTailPosition struct 持续增长的日志文件已读取到的位置,获取线程读取结束时更新,刷新时只读取之后追加的内容
+ */
+struct LogTailPosition {
+    quint64 device = 0;
+    quint64 inode = 0;
+    //已读取内容的结束位置,在行首;0表示还没有读取过
+    qint64 offset = 0;
+    //offset之前的最后一段内容,用于发现先截断再写入超过原长度的情况
+    QByteArray tailBytes;
+    //上一次读取是否因为文件被轮转、截断或改写而从头读取
+    bool rescanned = false;
+};
 //kwin筛选条件，kwin日志只有信息，没有任何可筛选的，但是先放在这，以后统一化
 struct KWIN_FILTERS {
     QString msg;
+    //不为空时从记录的位置增量读取,并在读取结束时更新位置
+    std::shared_ptr<LogTailPosition> tail;
 };
 struct XORG_FILTERS {
     qint64 timeFilterBegin = -1 ;
@@ -263,6 +381,7 @@ struct XORG_FILTERS {
 struct DKPG_FILTERS {
     qint64 timeFilterBegin = -1 ;
     qint64 timeFilterEnd = -1;
+    QString keyword = ""; //查询关键字,只用于跳过缓存中不可能匹配的记录块,调用者仍需按字段筛选
 };
 struct APP_FILTERS {
     qint64 timeFilterBegin = -1 ;
@@ -297,11 +416,15 @@ struct NORMAL_FILTERS {
 struct KERN_FILTERS {
     qint64 timeFilterBegin = -1 ;
     qint64 timeFilterEnd = -1;
+    QString keyword = ""; //查询关键字,只用于跳过缓存中不可能匹配的记录块,调用者仍需按字段筛选
+    int priority = -1; //只读取该等级及更严重(数字更小)的日志,-1为不筛选;kern.log中没有等级,只在从journal读取时生效
 };
 
 struct COREDUMP_FILTERS {
     qint64 timeFilterBegin = -1 ;
     qint64 timeFilterEnd = -1;
+    //增量上报截止游标,倒序读取到该条目时停止,为空则只按时间范围筛选
+    QString stopCursor;
 };
 
 /**
@@ -368,7 +491,8 @@ enum LOG_FLAG {
 // Airy
 namespace Log_Item_SPACE {
 enum LogItemDataRole {
-    levelRole = Qt::UserRole + 6
+    levelRole = Qt::UserRole + 6,
+    journalCursorRole = Qt::UserRole + 7 //系统日志信息列和崩溃日志堆栈延迟加载的条目游标
 };
 }
 namespace JOURNAL_SPACE {
@@ -4,6 +4,9 @@
 
 #include "utils.h"
 #include "logsettings.h"
+#include "logcategorycache.h"
+#include "logbytesanitizer.h"
+#include "logusernames.h"
 
 #include <math.h>
 #include <pwd.h>
@@ -24,6 +27,7 @@
 #include <QFontDatabase>
 #include <QProcessEnvironment>
 #include <QTime>
+#include <QRegularExpression>
 #include <QLoggingCategory>
 #include <QDBusInterface>
 
@@ -39,7 +43,10 @@ Q_LOGGING_CATEGORY(logUtils, "org.deepin.log.viewer.utils", QtInfoMsg)
 QHash<QString, QPixmap> Utils::m_imgCacheHash;
 QHash<QString, QString> Utils::m_fontNameCache;
 QMap<QString, QStringList> Utils::m_mapAuditType2EventType;
+QHash<QString, QString> Utils::m_hashEventType2AuditType;
 int Utils::specialComType = -1;
+int Utils::categoryCacheSize = LOG_CATEGORY_CACHE_DEFAULT_MB;
+QString Utils::kernLogSource = "auto";
 QString Utils::homePath = QDir::homePath();
 bool Utils::runInCmd = false;
 Utils::Utils(QObject *parent)
@@ -165,7 +172,8 @@ QByteArray Utils::replaceEmptyByteArray(const QByteArray &iReplaceStr)
 {
     QByteArray byteOutput = iReplaceStr;
     //\u0000是空字符，\x01是标题开始，出现于系统日志部分进程进程名称最后一个字符，不替换英文情况下显示错误
-    return byteOutput.replace('\u0000', "").replace("\x01", "");
+    LogByteSanitizer::sanitize(byteOutput, LogByteSanitizer::RemoveNulAndSoh);
+    return byteOutput;
 }
 /**
  * @brief Utils::isErroCommand 判断qproccess获取日志的返回值是否为报错
@@ -234,7 +242,8 @@ bool Utils::deleteDir(const QString &iFilePath)
 
 void Utils::replaceColorfulFont(QString *iStr)
 {
-    iStr->replace(QRegExp("[[0-9]{1,2}m"), "");
+    static const QRegularExpression colorExp("[[0-9]{1,2}m");
+    iStr->replace(colorExp, "");
 }
 
 bool Utils::isWayland()
@@ -304,16 +313,30 @@ QString Utils::osVersion()
     return osVerStr;
 }
 
+/**
+ * @brief Utils::auditType 按事件类型查审计类型,每条审计事件解析时调用,查反查表而不是遍历各类型的事件列表
+ * @param eventType 事件类型或自定义的key
+ * @return 审计类型,没有配置时为空
+ */
 QString Utils::auditType(const QString &eventType)
 {
-    QMapIterator<QString, QStringList> it(m_mapAuditType2EventType);
-    while (it.hasNext()) {
-        it.next();
-        if (it.value().indexOf(eventType) != -1)
-            return it.key();
-    }
+    return m_hashEventType2AuditType.value(eventType);
+}
 
-    return "";
+/**
+ * @brief Utils::setAuditMap 设置审计类型配置并建立反查表,同一事件类型配置在多个审计类型下时取排序靠前的
+ * @param auditMap 审计类型->事件类型列表
+ */
+void Utils::setAuditMap(const QMap<QString, QStringList> &auditMap)
+{
+    m_mapAuditType2EventType = auditMap;
+    m_hashEventType2AuditType.clear();
+    for (auto it = auditMap.constBegin(); it != auditMap.constEnd(); ++it) {
+        for (const QString &eventType : it.value()) {
+            if (!m_hashEventType2AuditType.contains(eventType))
+                m_hashEventType2AuditType.insert(eventType, it.key());
+        }
+    }
 }
 
 double Utils::convertToMB(quint64 cap, const int size/* = 1024*/)
@@ -331,11 +354,12 @@ double Utils::convertToMB(quint64 cap, const int size/* = 1024*/)
     return 0.0;
 }
 
+/**
+ * @brief Utils::getUserNamebyUID 根据uid获取用户名,经过进程内的缓存,查询不到时为空
+ */
 QString Utils::getUserNamebyUID(uint uid)
 {
-    struct passwd * pwd;
-    pwd = getpwuid(uid);
-    return pwd->pw_name;
+    return LogUserNames::userName(uid);
 }
 
 QString Utils::getCurrentUserName()
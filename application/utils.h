@@ -4,7 +4,9 @@
 
 #ifndef UTILS_H
 #define UTILS_H
-#define SINGLE_READ_CNT 500
+#include "logperformanceprofile.h"
+//每读取多少条数据发送一次,随性能档位变化
+#define SINGLE_READ_CNT (LogPerformanceProfile::current().readBatchSize)
 #include <QObject>
 #include <QHash>
 /**
@@ -29,6 +31,8 @@ public:
     static QHash<QString, QPixmap> m_imgCacheHash;
     static QHash<QString, QString> m_fontNameCache;
     static QMap<QString, QStringList> m_mapAuditType2EventType;
+    //m_mapAuditType2EventType的反查表,事件类型->审计类型,由setAuditMap一起设置
+    static QHash<QString, QString> m_hashEventType2AuditType;
 
     static QString getQssContent(const QString &filePath);
     static QString getConfigPath();
@@ -52,6 +56,7 @@ public:
     //系统版本号
     static QString osVersion();
     static QString auditType(const QString& eventType);
+    static void setAuditMap(const QMap<QString, QStringList> &auditMap);
     static double convertToMB(quint64 cap, const int size = 1024);
     static QString getUserNamebyUID(uint uid);  //根据uid获取用户名
     static QString getCurrentUserName();
@@ -65,6 +70,15 @@ public:
      * 取值有3种（-1,0,>0），默认为-1（未知），0（不是特殊机型）,>0（特殊机型）
      */
     static int specialComType;
+    /**
+     * @brief categoryCacheSize 最近查看过的日志类别的缓存上限,MB,0表示不缓存
+     */
+    static int categoryCacheSize;
+    /**
+     * @brief kernLogSource 内核日志来源,"file"读取kern.log,"journal"读取journal中_TRANSPORT=kernel的条目,
+     * 其他值(默认"auto")在没有kern.log(rsyslog未写入)时读取journal
+     */
+    static QString kernLogSource;
     static QString homePath;
     static bool runInCmd;
 };
@@ -0,0 +1,228 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "wtmpsessionreader.h"
+#include "logstringpool.h"
+#include "journalreader.h"
+
+#include <QHash>
+#include <QLoggingCategory>
+#include <QVector>
+
+#include <string.h>
+
+#ifdef QT_DEBUG
+Q_LOGGING_CATEGORY(logWtmpSession, "org.deepin.log.viewer.wtmp.session")
+#else
+Q_LOGGING_CATEGORY(logWtmpSession, "org.deepin.log.viewer.wtmp.session", QtInfoMsg)
+#endif
+
+namespace {
+//ut_line/ut_name等字段不一定以'\0'结尾
+template <size_t N>
+QByteArray utmpField(const char (&field)[N])
+{
+    return QByteArray(field, static_cast<int>(strnlen(field, N)));
+}
+
+bool isShutdownRecord(const struct utmp &record, const QByteArray &name)
+{
+    return (record.ut_type == RUN_LVL || utmpField(record.ut_line) == "~") && name == "shutdown";
+}
+
+bool isBootRecord(const struct utmp &record, const QByteArray &name)
+{
+    return record.ut_type == BOOT_TIME || (utmpField(record.ut_line) == "~" && name == "reboot");
+}
+}
+
+WtmpSessionReader::WtmpSessionReader()
+{
+}
+
+WtmpSessionReader::~WtmpSessionReader()
+{
+    close();
+}
+
+/**
+ * @brief WtmpSessionReader::open 只读映射wtmp文件
+ * @param path 文件路径
+ * @return 是否打开成功
+ */
+bool WtmpSessionReader::open(const QString &path)
+{
+    close();
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        qCWarning(logWtmpSession) << "open" << path << "failed:" << m_file.errorString();
+        return false;
+    }
+    m_size = m_file.size();
+    //空文件没有可映射的内容
+    if (m_size > 0) {
+        m_data = m_file.map(0, m_size);
+        if (m_data == nullptr) {
+            qCWarning(logWtmpSession) << "map" << path << "failed:" << m_file.errorString();
+            m_file.close();
+            return false;
+        }
+    }
+    return true;
+}
+
+void WtmpSessionReader::close()
+{
+    if (m_data != nullptr) {
+        m_file.unmap(const_cast<uchar *>(m_data));
+        m_data = nullptr;
+    }
+    m_size = 0;
+    if (m_file.isOpen())
+        m_file.close();
+}
+
+/**
+ * @brief WtmpSessionReader::sessions 获取所有登录和开关机事件
+ * @param canRun 是否继续
+ * @return 按从新到旧排列的事件
+ */
+QList<WtmpSession> WtmpSessionReader::sessions(const std::atomic_bool &canRun) const
+{
+    if (m_data == nullptr)
+        return QList<WtmpSession>();
+    //文件末尾不完整的记录忽略
+    int count = static_cast<int>(m_size / static_cast<qint64>(sizeof(struct utmp)));
+    return build(reinterpret_cast<const struct utmp *>(m_data), count, canRun);
+}
+
+/**
+ * @brief WtmpSessionReader::build 从wtmp记录生成事件
+ * 第一遍从旧到新确定要显示的事件,开关机事件的用户为之前最近一次登录的用户;
+ * 第二遍从新到旧配对结束时间,所以结果直接是从新到旧的顺序
+ * @param records wtmp记录
+ * @param count 记录数
+ * @param canRun 是否继续
+ * @return 按从新到旧排列的事件
+ */
+QList<WtmpSession> WtmpSessionReader::build(const struct utmp *records, int count, const std::atomic_bool &canRun)
+{
+    QVector<int> indexes;
+    QVector<WtmpSession> events;
+    //用户名和事件类型只有少数几种,每种值只保留一份
+    LogStringPool strings;
+    QString lastUser = strings.intern(QStringLiteral("root"));
+    for (int i = 0; i < count && canRun; ++i) {
+        const struct utmp &record = records[i];
+        if (record.ut_type != RUN_LVL && record.ut_type != BOOT_TIME && record.ut_type != USER_PROCESS)
+            continue;
+        const QByteArray name = utmpField(record.ut_name);
+        // clear the runlevel
+        if (name == "runlevel" || (record.ut_type == RUN_LVL && name != "shutdown") || record.ut_time <= 0)
+            continue;
+
+        WtmpSession session;
+        session.time = record.ut_time;
+        if (record.ut_type == USER_PROCESS) {
+            session.eventType = strings.intern(QStringLiteral("Login"));
+            session.userName = strings.intern(QString::fromLocal8Bit(name));
+            lastUser = session.userName;
+        } else {
+            session.eventType = strings.intern(name == "reboot" ? QStringLiteral("Boot") : QString::fromLocal8Bit(name));
+            session.userName = lastUser;
+        }
+        indexes.append(i);
+        events.append(session);
+    }
+
+    enum BoundaryState {
+        //之后没有开关机记录,系统仍在运行
+        Running,
+        //之后最近的是关机记录
+        Down,
+        //之后最近的是开机记录,中间没有关机,视为异常断电
+        Crash
+    };
+    BoundaryState state = Running;
+    //之后最近一次开关机的时间
+    qint64 boundary = 0;
+    //终端 -> 之后该终端上最近一次注销或登录的时间
+    QHash<QByteArray, qint64> logouts;
+    int next = events.size() - 1;
+    QList<WtmpSession> result;
+    result.reserve(events.size());
+    //事件按时间顺序处理,同一天的日期部分只格式化一次
+    JournalTimeFormatter start(QStringLiteral("ddd MMM d "), false);
+    JournalTimeFormatter clock(QString(), false);
+    for (int i = count - 1; i >= 0 && canRun; --i) {
+        const struct utmp &record = records[i];
+        const QByteArray name = utmpField(record.ut_name);
+        const QByteArray line = utmpField(record.ut_line);
+        const bool shutdown = isShutdownRecord(record, name);
+        const bool boot = !shutdown && isBootRecord(record, name);
+
+        if (next >= 0 && indexes.at(next) == i) {
+            WtmpSession session = events.at(next--);
+            if (session.eventType == "Login") {
+                auto it = logouts.constFind(line);
+                if (it != logouts.constEnd())
+                    session.msg = formatPeriod(start, clock, session.time, it.value());
+                else if (state == Running)
+                    session.msg = formatStart(start, session.time) + " still logged in";
+                else
+                    session.msg = formatPeriod(start, clock, session.time, boundary, state == Down ? "down" : "crash");
+            } else if (boot) {
+                if (state == Running)
+                    session.msg = formatStart(start, session.time) + " still running";
+                else
+                    session.msg = formatPeriod(start, clock, session.time, boundary, state == Crash ? "crash" : QString());
+            } else {
+                session.msg = formatStart(start, session.time) + "  -  ";
+            }
+            result.append(session);
+        }
+
+        if (shutdown || boot) {
+            //开关机之前的登录都在此时结束
+            state = shutdown ? Down : Crash;
+            boundary = record.ut_time;
+            logouts.clear();
+        } else if ((record.ut_type == DEAD_PROCESS || record.ut_type == USER_PROCESS) && !line.isEmpty()) {
+            logouts.insert(line, record.ut_time);
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief WtmpSessionReader::formatStart 和last一致的开始时间格式
+ * @param start 按"ddd MMM d "缓存日期的格式化器
+ * @param time 时间,秒
+ * @return 如"Mon Jul 3 10:00"
+ */
+QString WtmpSessionReader::formatStart(JournalTimeFormatter &start, qint64 time)
+{
+    return start.formatSecs(time);
+}
+
+/**
+ * @brief WtmpSessionReader::formatPeriod 和last一致的时间段格式
+ * @param start 开始时间的格式化器
+ * @param clock 只输出时分的格式化器
+ * @param begin 开始时间,秒
+ * @param end 结束时间,秒
+ * @param endText 结束时间的描述(down/crash),为空时显示结束时间
+ * @return 如"Mon Jul 3 10:00 - 12:00 (02:00)"、"Mon Jul 3 10:00 - crash (1+02:00)"
+ */
+QString WtmpSessionReader::formatPeriod(JournalTimeFormatter &start, JournalTimeFormatter &clock, qint64 begin, qint64 end,
+                                        const QString &endText)
+{
+    qint64 duration = qMax<qint64>(0, end - begin) / 60;
+    qint64 days = duration / (24 * 60);
+    QString period = QString("%1:%2").arg((duration / 60) % 24, 2, 10, QChar('0')).arg(duration % 60, 2, 10, QChar('0'));
+    if (days > 0)
+        period.prepend(QString("%1+").arg(days));
+    QString endStr = endText.isEmpty() ? clock.formatSecs(end) : endText;
+    return QString("%1 - %2 (%3)").arg(formatStart(start, begin), endStr, period);
+}
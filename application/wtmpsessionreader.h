@@ -0,0 +1,59 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef WTMPSESSIONREADER_H
+#define WTMPSESSIONREADER_H
+
+#include <QFile>
+#include <QList>
+#include <QString>
+
+#include <atomic>
+#include <utmp.h>
+
+class JournalTimeFormatter;
+
+/**
+ * @brief The WtmpSession struct 一次登录或开关机事件,以及和last命令一致的时间段描述
+ */
+struct WtmpSession {
+    //Login/Boot/shutdown
+    QString eventType;
+    QString userName;
+    //开始时间,秒
+    qint64 time = 0;
+    //时间段,如"Mon Jul 3 10:00 - 12:00 (02:00)"、"still logged in"
+    QString msg;
+};
+
+/**
+ * @brief The WtmpSessionReader class 映射wtmp文件并自行配对登录/注销、开机/关机记录
+ * 从新到旧扫描一遍:注销和同一终端的下一次登录作为登录的结束,关机和下一次开机作为开机的结束,
+ * 不需要启动last进程,也不需要按位置把last的输出和记录对应起来
+ */
+class WtmpSessionReader
+{
+public:
+    WtmpSessionReader();
+    ~WtmpSessionReader();
+
+    bool open(const QString &path = WTMP_FILE);
+    void close();
+    QList<WtmpSession> sessions(const std::atomic_bool &canRun) const;
+
+    static QList<WtmpSession> build(const struct utmp *records, int count, const std::atomic_bool &canRun);
+
+private:
+    Q_DISABLE_COPY(WtmpSessionReader)
+
+    static QString formatStart(JournalTimeFormatter &start, qint64 time);
+    static QString formatPeriod(JournalTimeFormatter &start, JournalTimeFormatter &clock, qint64 begin, qint64 end,
+                                const QString &endText = QString());
+
+    QFile m_file;
+    const uchar *m_data = nullptr;
+    qint64 m_size = 0;
+};
+
+#endif // WTMPSESSIONREADER_H
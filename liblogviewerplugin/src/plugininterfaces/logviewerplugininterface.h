@@ -7,8 +7,13 @@
 
 #include "../application/structdef.h"
 
+#include <QFuture>
+#include <QSharedPointer>
 #include <QtPlugin>
 
+#include <atomic>
+#include <functional>
+
 class LogViewerPluginInterface
 {  
 public:
@@ -46,7 +51,79 @@ public:
     //virtual void nothing();
 };
 
+/**
+ * @brief The LogViewerAppQuery struct v2接口的应用日志筛选条件
+ */
+struct LogViewerAppQuery {
+    //应用日志文件路径,可以通过LogApplicationHelper::getPathByAppId由应用id获取
+    QString path;
+    //时间筛选,对应BUTTONID枚举
+    BUTTONID period = ALL;
+    //等级筛选,对应PRIORITY枚举,-1表示全部等级
+    PRIORITY level = LVALL;
+    //搜索关键字,为空不筛选
+    QString searchStr;
+};
+
+/**
+ * @brief The LogViewerCancelToken class 取消标记,宿主在任意线程调用cancel后插件尽快停止读取,之后不再交出数据
+ */
+class LogViewerCancelToken
+{
+public:
+    void cancel() { m_canceled = true; }
+    bool isCanceled() const { return m_canceled; }
+
+private:
+    std::atomic_bool m_canceled {false};
+};
+
+typedef QSharedPointer<LogViewerCancelToken> LogViewerCancelTokenPtr;
+
+/**
+ * @brief The LogViewerPluginInterfaceV2 class 流式读取接口,数据分批交给宿主的回调,插件不保存读取结果
+ * 宿主通过qobject_cast<LogViewerPluginInterfaceV2 *>判断插件是否支持
+ */
+class LogViewerPluginInterfaceV2
+{
+public:
+    /**
+     * @brief AppBatchSink 一批筛选后的应用日志,返回false表示宿主不再需要后续数据,等同于取消
+     */
+    typedef std::function<bool(const QList<LOG_MSG_APPLICATOIN> &batch)> AppBatchSink;
+    /**
+     * @brief FinishedHandler 读取结束,complete为false表示被取消,只调用一次
+     */
+    typedef std::function<void(bool complete)> FinishedHandler;
+
+    virtual ~LogViewerPluginInterfaceV2() {}
+
+    /**
+     * @brief streamAppLog 分批读取应用日志,回调都在插件对象所在线程中调用,可以同时进行多次读取
+     * @param query 筛选条件
+     * @param token 取消标记,可以为空
+     * @param sink 数据回调
+     * @param finished 结束回调,可以为空
+     * @return 筛选条件无效时返回false,不会调用任何回调
+     */
+    virtual bool streamAppLog(const LogViewerAppQuery &query, const LogViewerCancelTokenPtr &token,
+                              const AppBatchSink &sink, const FinishedHandler &finished = FinishedHandler()) = 0;
+
+    /**
+     * @brief exportAppLog 异步导出应用日志,读取和写入都在插件的线程中进行,调用后立即返回
+     * 进度范围为0-100,前一半为读取,后一半为写入,可以用QFutureWatcher监听;
+     * 对返回的future调用cancel()取消导出,取消后不保留不完整的文件
+     * @param query 筛选条件
+     * @param fileName 导出文件路径,按后缀txt/html/doc/xls选择格式
+     * @return 结果为是否导出成功;筛选条件或格式无效时返回已结束且结果为false的future
+     */
+    virtual QFuture<bool> exportAppLog(const LogViewerAppQuery &query, const QString &fileName) = 0;
+};
+
 #define LogViewerPluginInterface_iid "com.deepin.logviewer.LogViewerPluginInterface/1.0"
 Q_DECLARE_INTERFACE(LogViewerPluginInterface, LogViewerPluginInterface_iid)
 
+#define LogViewerPluginInterfaceV2_iid "com.deepin.logviewer.LogViewerPluginInterface/2.0"
+Q_DECLARE_INTERFACE(LogViewerPluginInterfaceV2, LogViewerPluginInterfaceV2_iid)
+
 #endif // LOGVIEWERPLUGININTERFACE_H
@@ -5,11 +5,22 @@
 #include "logviewerplugin.h"
 #include "../application/logexportthread.h"
 #include "../application/logapplicationhelper.h"
+#include "../application/logrecordfilter.h"
+#include "../application/logworkscheduler.h"
 
 #include <DApplication>
 
+#include <QFile>
+#include <QFutureInterface>
+#include <QFutureWatcher>
+#include <QTimer>
 #include <qdatetime.h>
 
+//v2流式读取检查取消标记的间隔,毫秒
+#define PLUGIN_CANCEL_POLL_INTERVAL 100
+//v2异步导出的进度范围
+#define PLUGIN_EXPORT_PROGRESS_MAX 100
+
 LogViewerPlugin::LogViewerPlugin()
 {
     initConnections();
@@ -35,26 +46,7 @@ void LogViewerPlugin::clearAllDatalist()
 {
     //m_detailWgt->cleanText();
     //m_pModel->clear();
-    jList.clear();
-    jListOrigin.clear();
-    dList.clear();
-    dListOrigin.clear();
-    xList.clear();
-    xListOrigin.clear();
-    bList.clear();
-    currentBootList.clear();
-    kList.clear();
-    kListOrigin.clear();
     appList.clear();
-    appListOrigin.clear();
-    norList.clear();
-    nortempList.clear();
-    m_currentKwinList.clear();
-    m_kwinList.clear();
-    jBootList.clear();
-    jBootListOrigin.clear();
-    dnfList.clear();
-    dnfListOrigin.clear();
     //malloc_trim(0);
 }
 
@@ -78,66 +70,54 @@ void LogViewerPlugin::generateAppFile(const QString &path, BUTTONID id, PRIORITY
 {
     Q_UNUSED(iSearchStr)
     appList.clear();
-    appListOrigin.clear();
     clearAllFilter();
     clearAllDatalist();
     //setLoadState(DATA_LOADING);
     m_firstLoadPageData = true;
     m_isDataLoadComplete = false;
+    //createAppTableForm();
+    if (id < ALL || id > THREE_MONTHS)
+        return;
+    m_appCurrentIndex = m_logFileParse.parseByApp(appFilter(path, id, lId));
+}
+
+/**
+ * @brief LogViewerPlugin::appFilter 时间筛选id转换为应用日志的筛选条件
+ * @param path 应用日志文件路径
+ * @param id 时间筛选id,对应BUTTONID枚举
+ * @param lId 等级筛选id,对应PRIORITY枚举
+ */
+APP_FILTERS LogViewerPlugin::appFilter(const QString &path, BUTTONID id, PRIORITY lId)
+{
     QDateTime dt = QDateTime::currentDateTime();
     dt.setTime(QTime()); // get zero time
-    //createAppTableForm();
+    QDateTime dtEnd = dt;
+    dtEnd.setTime(QTime(23, 59, 59, 999));
     APP_FILTERS appFilter;
     appFilter.path = path;
     appFilter.lvlFilter = lId;
     switch (id) {
-    case ALL:
-        m_appCurrentIndex = m_logFileParse.parseByApp(appFilter);
+    case ONE_DAY:
+        appFilter.timeFilterBegin = dt.toMSecsSinceEpoch();
         break;
-    case ONE_DAY: {
-        QDateTime dtStart = dt;
-        QDateTime dtEnd = dt;
-        dtEnd.setTime(QTime(23, 59, 59, 999));
-        appFilter.timeFilterBegin = dtStart.toMSecsSinceEpoch();
-        appFilter.timeFilterEnd = dtEnd.toMSecsSinceEpoch();
-        m_appCurrentIndex = m_logFileParse.parseByApp(appFilter);
-    } break;
-    case THREE_DAYS: {
-        QDateTime dtStart = dt;
-        QDateTime dtEnd = dt;
-        dtEnd.setTime(QTime(23, 59, 59, 999));
-        appFilter.timeFilterBegin = dtStart.addDays(-2).toMSecsSinceEpoch();
-        appFilter.timeFilterEnd = dtEnd.toMSecsSinceEpoch();
-        m_appCurrentIndex = m_logFileParse.parseByApp(appFilter);
-
-    } break;
-    case ONE_WEEK: {
-        QDateTime dtStart = dt;
-        QDateTime dtEnd = dt;
-        dtEnd.setTime(QTime(23, 59, 59, 999));
-        appFilter.timeFilterBegin = dtStart.addDays(-6).toMSecsSinceEpoch();
-        appFilter.timeFilterEnd = dtEnd.toMSecsSinceEpoch();
-        m_appCurrentIndex = m_logFileParse.parseByApp(appFilter);
-    } break;
-    case ONE_MONTH: {
-        QDateTime dtStart = dt;
-        QDateTime dtEnd = dt;
-        dtEnd.setTime(QTime(23, 59, 59, 999));
-        appFilter.timeFilterBegin = dtStart.addMonths(-1).toMSecsSinceEpoch();
-        appFilter.timeFilterEnd = dtEnd.toMSecsSinceEpoch();
-        m_appCurrentIndex = m_logFileParse.parseByApp(appFilter);
-    } break;
-    case THREE_MONTHS: {
-        QDateTime dtStart = dt;
-        QDateTime dtEnd = dt;
-        dtEnd.setTime(QTime(23, 59, 59, 999));
-        appFilter.timeFilterBegin = dtStart.addMonths(-3).toMSecsSinceEpoch();
-        appFilter.timeFilterEnd = dtEnd.toMSecsSinceEpoch();
-        m_appCurrentIndex = m_logFileParse.parseByApp(appFilter);
-    } break;
-    default:
+    case THREE_DAYS:
+        appFilter.timeFilterBegin = dt.addDays(-2).toMSecsSinceEpoch();
+        break;
+    case ONE_WEEK:
+        appFilter.timeFilterBegin = dt.addDays(-6).toMSecsSinceEpoch();
         break;
+    case ONE_MONTH:
+        appFilter.timeFilterBegin = dt.addMonths(-1).toMSecsSinceEpoch();
+        break;
+    case THREE_MONTHS:
+        appFilter.timeFilterBegin = dt.addMonths(-3).toMSecsSinceEpoch();
+        break;
+    default:
+        //全部时间不筛选
+        return appFilter;
     }
+    appFilter.timeFilterEnd = dtEnd.toMSecsSinceEpoch();
+    return appFilter;
 }
 
 // exportAppLogFile 导出应用日志
@@ -162,6 +142,84 @@ bool LogViewerPlugin::exportAppLogFile(const QString &path, BUTTONID period, PRI
     return true;
 }
 
+/**
+ * @brief LogViewerPlugin::streamAppLog 分批读取应用日志,数据经过关键字筛选后交给sink,插件不保存
+ * 每次读取使用单独的LogFileParser,和generateAppFile以及其他读取互不影响;
+ * 宿主取消或sink返回false后停止解析线程,之后只调用一次finished(false)
+ */
+bool LogViewerPlugin::streamAppLog(const LogViewerAppQuery &query, const LogViewerCancelTokenPtr &token,
+                                   const AppBatchSink &sink, const FinishedHandler &finished)
+{
+    if (query.path.isEmpty() || !sink || query.period < ALL || query.period > THREE_MONTHS)
+        return false;
+
+    struct StreamState {
+        LogFileParser *parser = nullptr;
+        QTimer *cancelTimer = nullptr;
+        QList<QMetaObject::Connection> connections;
+        int index = -1;
+        bool done = false;
+    };
+    QSharedPointer<StreamState> state(new StreamState);
+    //解析线程是解析对象的子对象,运行中不能释放解析对象,读取结束后留作下次使用
+    state->parser = m_idleStreamParsers.isEmpty() ? new LogFileParser(this) : m_idleStreamParsers.takeLast();
+    state->cancelTimer = new QTimer(this);
+
+    //取消时先停止解析线程,结束后不再处理该解析对象之后发出的数据
+    auto finish = [this, state, finished](bool complete) {
+        if (state->done)
+            return;
+        state->done = true;
+        if (!complete)
+            state->parser->stopAllLoad();
+        for (const QMetaObject::Connection &connection : state->connections)
+            disconnect(connection);
+        state->cancelTimer->stop();
+        state->cancelTimer->deleteLater();
+        m_idleStreamParsers.append(state->parser);
+        if (finished)
+            finished(complete);
+    };
+    auto canceled = [token]() { return token && token->isCanceled(); };
+
+    const QString searchStr = query.searchStr;
+    state->connections << connect(state->parser, &LogFileParser::appData, this, [=](int index, QList<LOG_MSG_APPLICATOIN> list) {
+        if (state->done || index != state->index)
+            return;
+        if (canceled()) {
+            finish(false);
+            return;
+        }
+        list = filterApp(searchStr, list);
+        if (!list.isEmpty() && !sink(list))
+            finish(false);
+    });
+    state->connections << connect(state->parser, &LogFileParser::appFinished, this, [=](int index) {
+        if (index == state->index)
+            finish(!canceled());
+    });
+    //解析线程长时间没有交出数据时也能及时响应取消
+    if (token) {
+        connect(state->cancelTimer, &QTimer::timeout, this, [=]() {
+            if (canceled())
+                finish(false);
+        });
+        state->cancelTimer->start(PLUGIN_CANCEL_POLL_INTERVAL);
+    }
+
+    state->index = state->parser->parseByApp(appFilter(query.path, query.period, query.level));
+    if (state->index < 0) {
+        //未能启动解析时不调用任何回调
+        state->done = true;
+        for (const QMetaObject::Connection &connection : state->connections)
+            disconnect(connection);
+        state->cancelTimer->deleteLater();
+        m_idleStreamParsers.append(state->parser);
+        return false;
+    }
+    return true;
+}
+
 void LogViewerPlugin::slot_appFinished(int index)
 {
     if (m_flag != APP || index != m_appCurrentIndex)
@@ -179,7 +237,6 @@ void LogViewerPlugin::slot_appData(int index, QList<LOG_MSG_APPLICATOIN> list)
 {
     if (m_flag != APP || index != m_appCurrentIndex)
         return;
-    appListOrigin.append(list);
     QList<LOG_MSG_APPLICATOIN> listFiltered = filterApp(m_currentSearchStr, list);
     appList.append(listFiltered);
     //因为此槽会在同一次加载数据完成前触发数次,所以第一次收到数据需要更新界面状态,后面的话往model里塞数据就行
@@ -193,16 +250,10 @@ void LogViewerPlugin::slot_appData(int index, QList<LOG_MSG_APPLICATOIN> list)
 
 QList<LOG_MSG_APPLICATOIN> LogViewerPlugin::filterApp(const QString &iSearchStr, const QList<LOG_MSG_APPLICATOIN> &iList)
 {
-    QList<LOG_MSG_APPLICATOIN> rsList;
-    if (iSearchStr.isEmpty()) {
+    if (iSearchStr.isEmpty())
         return iList;
-    }
-    for (int i = 0; i < iList.size(); i++) {
-        LOG_MSG_APPLICATOIN msg = iList.at(i);
-        if (msg.dateTime.contains(iSearchStr, Qt::CaseInsensitive) || msg.level.contains(iSearchStr, Qt::CaseInsensitive) || msg.src.contains(iSearchStr, Qt::CaseInsensitive) || msg.msg.contains(iSearchStr, Qt::CaseInsensitive))
-            rsList.append(msg);
-    }
-    return rsList;
+    const LogRecordFilter::TextMatcher text(iSearchStr);
+    return LogRecordFilter::filter(iList, [text](const LOG_MSG_APPLICATOIN &msg) { return LogRecordFilter::matchApp(text, msg); });
 }
 
 /**
@@ -270,6 +321,16 @@ void LogViewerPlugin::exportLogFile(QString path)
 //    }
 
     //m_exportDlg->show();
+    startAppExport(exportThread, fileName, appList, getAppName(m_curAppLog));
+}
+
+/**
+ * @brief LogViewerPlugin::startAppExport 按文件后缀设置导出格式并在线程池中启动导出
+ * @return 后缀不支持时返回false,不启动导出
+ */
+bool LogViewerPlugin::startAppExport(LogExportThread *exportThread, const QString &fileName,
+                                     const QList<LOG_MSG_APPLICATOIN> &list, const QString &appName)
+{
     QStringList labels;
 //    for (int col = 0; col < m_pModel->columnCount(); ++col) {
 //        labels.append(m_pModel->horizontalHeaderItem(col)->text());
@@ -281,217 +342,88 @@ void LogViewerPlugin::exportLogFile(QString path)
            << DApplication::translate("Table", "Source")
            << DApplication::translate("Table", "Info");
 
-    //根据导出格式判断执行逻辑
-    if (selectFilter.contains("(*.txt)")) {
-        switch (m_flag) {
-        //根据导出日志类型执行正确的导出逻辑
-        case JOURNAL:
-            //PERF_PRINT_BEGIN("POINT-04", QString("format=txt count=%1").arg(jList.count()));
-            exportThread->exportToTxtPublic(fileName, jList, labels, m_flag);
-            break;
-        case BOOT_KLU:
-            //PERF_PRINT_BEGIN("POINT-04", QString("format=txt count=%1").arg(jBootList.count()));
-            exportThread->exportToTxtPublic(fileName, jBootList, labels, JOURNAL);
-            break;
-        case APP: {
-            //PERF_PRINT_BEGIN("POINT-04", QString("format=txt count=%1").arg(appList.count()));
-            QString appName = getAppName(m_curAppLog);
-            exportThread->exportToTxtPublic(fileName, appList, labels, appName);
-            break;
-        }
-        case DPKG:
-            //PERF_PRINT_BEGIN("POINT-04", QString("format=txt count=%1").arg(dList.count()));
-            exportThread->exportToTxtPublic(fileName, dList, labels);
-            break;
-        case BOOT:
-            //PERF_PRINT_BEGIN("POINT-04", QString("format=txt count=%1").arg(currentBootList.count()));
-            exportThread->exportToTxtPublic(fileName, currentBootList, labels);
-            break;
-        case XORG:
-            //PERF_PRINT_BEGIN("POINT-04", QString("format=txt count=%1").arg(xList.count()));
-            exportThread->exportToTxtPublic(fileName, xList, labels);
-            break;
-        case Normal:
-            //PERF_PRINT_BEGIN("POINT-04", QString("format=txt count=%1").arg(nortempList.count()));
-            exportThread->exportToTxtPublic(fileName, nortempList, labels);
-            break;
-        case KERN:
-            //PERF_PRINT_BEGIN("POINT-04", QString("format=txt count=%1").arg(kList.count()));
-            exportThread->exportToTxtPublic(fileName, kList, labels, m_flag);
-            break;
-        case Kwin:
-            //PERF_PRINT_BEGIN("POINT-04", QString("format=txt count=%1").arg(m_currentKwinList.count()));
-            exportThread->exportToTxtPublic(fileName, m_currentKwinList, labels);
-            break;
-        case Dmesg:
-            //PERF_PRINT_BEGIN("POINT-04", QString("format=txt count=%1").arg(dmesgList.count()));
-            exportThread->exportToTxtPublic(fileName, dmesgList, labels);
-            break;
-        case Dnf:
-            //PERF_PRINT_BEGIN("POINT-04", QString("format=txt count=%1").arg(dnfList.count()));
-            exportThread->exportToTxtPublic(fileName, dnfList, labels);
-            break;
-        default:
-            break;
-        }
-        QThreadPool::globalInstance()->start(exportThread);
-    } else if (selectFilter.contains("(*.html)")) {
-        switch (m_flag) {
-        case JOURNAL:
-            //PERF_PRINT_BEGIN("POINT-04", QString("format=html count=%1").arg(jList.count()));
-            exportThread->exportToHtmlPublic(fileName, jList, labels, m_flag);
-            break;
-        case BOOT_KLU:
-            //PERF_PRINT_BEGIN("POINT-04", QString("format=html count=%1").arg(jBootList.count()));
-            exportThread->exportToHtmlPublic(fileName, jBootList, labels, JOURNAL);
-            break;
-        case APP: {
-            //PERF_PRINT_BEGIN("POINT-04", QString("format=html count=%1").arg(appList.count()));
-            QString appName = getAppName(m_curAppLog);
-            exportThread->exportToHtmlPublic(fileName, appList, labels, appName);
-            break;
-        }
-        case DPKG:
-            //PERF_PRINT_BEGIN("POINT-04", QString("format=html count=%1").arg(dList.count()));
-            exportThread->exportToHtmlPublic(fileName, dList, labels);
-            break;
-        case BOOT:
-            //PERF_PRINT_BEGIN("POINT-04", QString("format=html count=%1").arg(currentBootList.count()));
-            exportThread->exportToHtmlPublic(fileName, currentBootList, labels);
-            break;
-        case XORG:
-            //PERF_PRINT_BEGIN("POINT-04", QString("format=html count=%1").arg(xList.count()));
-            exportThread->exportToHtmlPublic(fileName, xList, labels);
-            break;
-        case Normal:
-            //PERF_PRINT_BEGIN("POINT-04", QString("format=html count=%1").arg(nortempList.count()));
-            exportThread->exportToHtmlPublic(fileName, nortempList, labels);
-            break;
-        case KERN:
-            //PERF_PRINT_BEGIN("POINT-04", QString("format=html count=%1").arg(kList.count()));
-            exportThread->exportToHtmlPublic(fileName, kList, labels, m_flag);
-            break;
-        case Kwin:
-            //PERF_PRINT_BEGIN("POINT-04", QString("format=html count=%1").arg(m_currentKwinList.count()));
-            exportThread->exportToHtmlPublic(fileName, m_currentKwinList, labels);
-            break;
-        case Dmesg:
-            //PERF_PRINT_BEGIN("POINT-04", QString("format=txt count=%1").arg(dmesgList.count()));
-            exportThread->exportToHtmlPublic(fileName, dmesgList, labels);
-            break;
-        case Dnf:
-            //PERF_PRINT_BEGIN("POINT-04", QString("format=txt count=%1").arg(dnfList.count()));
-            exportThread->exportToHtmlPublic(fileName, dnfList, labels);
-            break;
-        default:
-            break;
-        }
-        QThreadPool::globalInstance()->start(exportThread);
-    } else if (selectFilter.contains("(*.doc)")) {
-        switch (m_flag) {
-        case JOURNAL:
-            //PERF_PRINT_BEGIN("POINT-04", QString("format=doc count=%1").arg(jList.count()));
-            exportThread->exportToDocPublic(fileName, jList, labels, m_flag);
-            break;
-        case BOOT_KLU:
-            //PERF_PRINT_BEGIN("POINT-04", QString("format=doc count=%1").arg(jBootList.count()));
-            exportThread->exportToDocPublic(fileName, jBootList, labels, JOURNAL);
-            break;
-        case APP: {
-            //PERF_PRINT_BEGIN("POINT-04", QString("format=doc count=%1").arg(appList.count()));
-            QString appName = getAppName(m_curAppLog);
-            exportThread->exportToDocPublic(fileName, appList, labels, appName);
-            break;
-        }
-        case DPKG:
-            //PERF_PRINT_BEGIN("POINT-04", QString("format=doc count=%1").arg(dList.count()));
-            exportThread->exportToDocPublic(fileName, dList, labels);
-            break;
-        case BOOT:
-            //PERF_PRINT_BEGIN("POINT-04", QString("format=doc count=%1").arg(currentBootList.count()));
-            exportThread->exportToDocPublic(fileName, currentBootList, labels);
-            break;
-        case XORG:
-            //PERF_PRINT_BEGIN("POINT-04", QString("format=doc count=%1").arg(xList.count()));
-            exportThread->exportToDocPublic(fileName, xList, labels);
-            break;
-        case Normal:
-            //PERF_PRINT_BEGIN("POINT-04", QString("format=doc count=%1").arg(nortempList.count()));
-            exportThread->exportToDocPublic(fileName, nortempList, labels);
-            break;
-        case KERN:
-            //PERF_PRINT_BEGIN("POINT-04", QString("format=doc count=%1").arg(kList.count()));
-            exportThread->exportToDocPublic(fileName, kList, labels, m_flag);
-            break;
-        case Kwin:
-            //PERF_PRINT_BEGIN("POINT-04", QString("format=doc count=%1").arg(m_currentKwinList.count()));
-            exportThread->exportToDocPublic(fileName, m_currentKwinList, labels);
-            break;
-        case Dmesg:
-            //PERF_PRINT_BEGIN("POINT-04", QString("format=txt count=%1").arg(dmesgList.count()));
-            exportThread->exportToDocPublic(fileName, dmesgList, labels);
-            break;
-        case Dnf:
-            //PERF_PRINT_BEGIN("POINT-04", QString("format=txt count=%1").arg(dnfList.count()));
-            exportThread->exportToDocPublic(fileName, dnfList, labels);
-            break;
-        default:
-            break;
-        }
-        QThreadPool::globalInstance()->start(exportThread);
-    } else if (selectFilter.contains("(*.xls)")) {
-        switch (m_flag) {
-        case JOURNAL:
-            //PERF_PRINT_BEGIN("POINT-04", QString("format=xls count=%1").arg(jList.count()));
-            exportThread->exportToXlsPublic(fileName, jList, labels, m_flag);
-            break;
-        case BOOT_KLU:
-            //PERF_PRINT_BEGIN("POINT-04", QString("format=xls count=%1").arg(jBootList.count()));
-            exportThread->exportToXlsPublic(fileName, jBootList, labels, JOURNAL);
-            break;
-        case APP: {
-            //PERF_PRINT_BEGIN("POINT-04", QString("format=xls count=%1").arg(appList.count()));
-            QString appName = getAppName(m_curAppLog);
-            exportThread->exportToXlsPublic(fileName, appList, labels, appName);
-            break;
+    //插件只加载应用日志,根据导出格式判断执行逻辑
+    const QString suffix = QFileInfo(fileName).suffix();
+    if (suffix == "txt") {
+        exportThread->exportToTxtPublic(fileName, list, labels, appName);
+    } else if (suffix == "html") {
+        exportThread->exportToHtmlPublic(fileName, list, labels, appName);
+    } else if (suffix == "doc") {
+        exportThread->exportToDocPublic(fileName, list, labels, appName);
+    } else if (suffix == "xls") {
+        exportThread->exportToXlsPublic(fileName, list, labels, appName);
+    } else {
+        return false;
+    }
+    LogWorkScheduler::instance()->start(exportThread, LogWorkScheduler::Export);
+    return true;
+}
+
+/**
+ * @brief LogViewerPlugin::exportAppLog 异步导出应用日志,调用后立即返回
+ * 读取阶段通过streamAppLog分批收集,写入阶段在线程池中进行,进度、结果和取消都通过返回的future传递
+ */
+QFuture<bool> LogViewerPlugin::exportAppLog(const LogViewerAppQuery &query, const QString &fileName)
+{
+    QSharedPointer<QFutureInterface<bool>> job(new QFutureInterface<bool>);
+    job->reportStarted();
+    job->setProgressRange(0, PLUGIN_EXPORT_PROGRESS_MAX);
+    const QString suffix = QFileInfo(fileName).suffix();
+    const QStringList formats {"txt", "html", "doc", "xls"};
+    if (!formats.contains(suffix) || !QFileInfo(QFileInfo(fileName).path()).isWritable()) {
+        job->reportResult(false);
+        job->reportFinished();
+        return job->future();
+    }
+
+    //宿主对future调用cancel()时停止读取或写入
+    LogViewerCancelTokenPtr token(new LogViewerCancelToken);
+    QFutureWatcher<bool> *watcher = new QFutureWatcher<bool>(this);
+    connect(watcher, &QFutureWatcher<bool>::canceled, this, [token]() { token->cancel(); });
+    watcher->setFuture(job->future());
+
+    const QString appName = getAppName(query.path);
+    QSharedPointer<QList<LOG_MSG_APPLICATOIN>> records(new QList<LOG_MSG_APPLICATOIN>);
+    auto sink = [job, records](const QList<LOG_MSG_APPLICATOIN> &batch) {
+        records->append(batch);
+        //读取阶段不知道总数,按批次推进,不超过一半
+        job->setProgressValue(qMin(job->progressValue() + 1, PLUGIN_EXPORT_PROGRESS_MAX / 2 - 1));
+        return !job->isCanceled();
+    };
+    auto finish = [job, watcher, fileName](bool ok) {
+        if (job->isCanceled()) {
+            QFile::remove(fileName);
+            ok = false;
+        } else {
+            job->setProgressValue(PLUGIN_EXPORT_PROGRESS_MAX);
         }
-        case DPKG:
-            //PERF_PRINT_BEGIN("POINT-04", QString("format=xls count=%1").arg(dList.count()));
-            exportThread->exportToXlsPublic(fileName, dList, labels);
-            break;
-        case BOOT:
-            //PERF_PRINT_BEGIN("POINT-04", QString("format=xls count=%1").arg(currentBootList.count()));
-            exportThread->exportToXlsPublic(fileName, currentBootList, labels);
-            break;
-        case XORG:
-            //PERF_PRINT_BEGIN("POINT-04", QString("format=xls count=%1").arg(xList.count()));
-            exportThread->exportToXlsPublic(fileName, xList, labels);
-            break;
-        case Normal:
-            //PERF_PRINT_BEGIN("POINT-04", QString("format=xls count=%1").arg(nortempList.count()));
-            exportThread->exportToXlsPublic(fileName, nortempList, labels);
-            break;
-        case KERN:
-            //PERF_PRINT_BEGIN("POINT-04", QString("format=xls count=%1").arg(kList.count()));
-            exportThread->exportToXlsPublic(fileName, kList, labels, m_flag);
-            break;
-        case Kwin:
-            //PERF_PRINT_BEGIN("POINT-04", QString("format=xls count=%1").arg(m_currentKwinList.count()));
-            exportThread->exportToXlsPublic(fileName, m_currentKwinList, labels);
-            break;
-        case Dmesg:
-            //PERF_PRINT_BEGIN("POINT-04", QString("format=txt count=%1").arg(dmesgList.count()));
-            exportThread->exportToXlsPublic(fileName, dmesgList, labels);
-            break;
-        case Dnf:
-            //PERF_PRINT_BEGIN("POINT-04", QString("format=txt count=%1").arg(dnfList.count()));
-            exportThread->exportToXlsPublic(fileName, dnfList, labels);
-            break;
-        default:
-            break;
+        job->reportResult(ok);
+        job->reportFinished();
+        watcher->deleteLater();
+    };
+    auto finished = [=](bool complete) {
+        if (!complete) {
+            finish(false);
+            return;
         }
-        QThreadPool::globalInstance()->start(exportThread);
+        job->setProgressValue(PLUGIN_EXPORT_PROGRESS_MAX / 2);
+        LogExportThread *thread = new LogExportThread(true);
+        connect(thread, &LogExportThread::sigProgress, watcher, [job](int nCur, int nTotal) {
+            if (nTotal > 0)
+                job->setProgressValue(PLUGIN_EXPORT_PROGRESS_MAX / 2 + nCur * (PLUGIN_EXPORT_PROGRESS_MAX / 2) / nTotal);
+        });
+        connect(thread, &LogExportThread::sigResult, watcher, finish);
+        //写入阶段取消时停止导出线程
+        connect(watcher, &QFutureWatcher<bool>::canceled, thread, &LogExportThread::stopImmediately);
+        startAppExport(thread, fileName, *records, appName);
+        records->clear();
+    };
+    if (!streamAppLog(query, token, sink, finished)) {
+        watcher->deleteLater();
+        job->reportResult(false);
+        job->reportFinished();
     }
+    return job->future();
 }
 
 void LogViewerPlugin::slot_exportResult(bool isSuccess)
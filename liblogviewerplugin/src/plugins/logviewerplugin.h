@@ -12,13 +12,15 @@
 
 #include <QObject>
 
-class LogViewerPlugin : public QObject, public LogViewerPluginInterface
+class LogExportThread;
+
+class LogViewerPlugin : public QObject, public LogViewerPluginInterface, public LogViewerPluginInterfaceV2
 {
     Q_OBJECT
 
     //Q_PLUGIN_METADATA(IID "com.deepin.logviewer.LogViewerPlugin" FILE "LogViewerPlugin.json")
     Q_PLUGIN_METADATA(IID "com.deepin.logviewer.LogViewerPlugin")
-    Q_INTERFACES(LogViewerPluginInterface)
+    Q_INTERFACES(LogViewerPluginInterface LogViewerPluginInterfaceV2)
     /**
      * @brief The LOAD_STATE enum 主表部分的显示状态
      */
@@ -47,6 +49,13 @@ public:
     // param: appid 自研应用id，用于导出指定应用的日志，若为空，什么都不做，返回false（例：导出相册的日志信息，传入deepin-album即可）
     // return：true 导出成功， false 导出失败
     bool exportAppLogFile(const QString &path, BUTTONID period, PRIORITY level, const QString &appid) override;
+
+    // streamAppLog 分批读取应用日志,每次读取使用单独的解析对象,筛选后的数据直接交给sink,不保存
+    bool streamAppLog(const LogViewerAppQuery &query, const LogViewerCancelTokenPtr &token,
+                      const AppBatchSink &sink, const FinishedHandler &finished = FinishedHandler()) override;
+
+    // exportAppLog 异步导出应用日志,先通过streamAppLog读取再在线程池中写入,返回的future带进度、可取消
+    QFuture<bool> exportAppLog(const LogViewerAppQuery &query, const QString &fileName) override;
 signals:
     //应用日志数据读取结束信号
     void sigAppFinished(int index) override;
@@ -67,6 +76,8 @@ protected:
     void clearAllFilter();
     void clearAllDatalist();
     void initConnections();
+    //时间筛选id转换为应用日志的筛选条件
+    static APP_FILTERS appFilter(const QString &path, BUTTONID id, PRIORITY lId);
     //筛选应用日志
     QList<LOG_MSG_APPLICATOIN> filterApp(const QString &iSearchStr, const QList<LOG_MSG_APPLICATOIN> &iList);
     /**
@@ -78,6 +89,9 @@ protected:
     //导出日志
     //path:导出路径
     void exportLogFile(QString path);
+    //按文件后缀设置导出格式并在线程池中启动导出,后缀不支持时返回false,不启动
+    static bool startAppExport(LogExportThread *exportThread, const QString &fileName,
+                               const QList<LOG_MSG_APPLICATOIN> &list, const QString &appName);
 
 private:
     /**
@@ -128,73 +142,15 @@ private:
      * @brief m_logFileParse 获取日志工具类对象
      */
     LogFileParser m_logFileParse;
-
     /**
-     * @brief jBootList 经过筛选完成的启动日志列表
+     * @brief m_idleStreamParsers v2流式读取已结束的解析对象,下次读取时复用
      */
-    /**
-     * @brief jBootListOrigin 未经过筛选的启动日志数据 journalctl --boot cmd.
-     */
-    QList<LOG_MSG_JOURNAL> jBootList, jBootListOrigin;
+    QList<LogFileParser *> m_idleStreamParsers;
 
     /**
-     * @brief jList 经过筛选完成的系统日志数据
-     */
-    /**
-     * @brief jListOrigin 未经过筛选的系统日志数据 journalctl cmd.
-     */
-    QList<LOG_MSG_JOURNAL> jList, jListOrigin;
-    /**
-     * @brief dList 经过筛选完成的dpkg日志数据
-     */
-    /**
-     * @brief dListOrigin 未经过筛选的dpkg日志数据  dpkg.log
-     */
-    QList<LOG_MSG_DPKG> dList, dListOrigin;
-    /**
-     * @brief xList 经过筛选完成的xorg日志数据
-     */
-    /**
-     * @brief xListOrigin 未经过筛选的xorg日志数据   Xorg.0.log
-     */
-    QList<LOG_MSG_XORG> xList, xListOrigin;
-    /**
-     * @brief currentBootList 经过筛选完成的启动日志数据
-     */
-    /**
-     * @brief bList 未经过筛选的启动日志数据   boot.log
-     */
-    QList<LOG_MSG_BOOT> bList, currentBootList;
-    /**
-     * @brief kList 经过筛选完成的内核日志数据
-     */
-    /**
-     * @brief kListOrigin 未经过筛选的内核日志数据   kern.log
-     */
-    QList<LOG_MSG_JOURNAL> kList, kListOrigin;
-    /**
-     * @brief appList 经过筛选完成的内核日志数据
-     */
-    /**
-     * @brief appListOrigin 未经过筛选的内核日志数据   ~/.cache/deepin/xxx.log(.xxx)
-     */
-    QList<LOG_MSG_APPLICATOIN> appList, appListOrigin;
-    /**
-     * @brief norList add 未经过筛选完成的开关机日志数据 by Airy
-     */
-    QList<LOG_MSG_NORMAL> norList;
-    /**
-     * @brief nortempList 经过筛选的开关机日志数据 add by Airy
-     */
-    QList<LOG_MSG_NORMAL> nortempList;
-    /**
-     * @brief m_currentKwinList add 经过筛选完成的kwin日志数据 by Airy /$HOME/.kwin.log
-     */
-    QList<LOG_MSG_KWIN> m_currentKwinList;
-    /**
-     * @brief m_kwinList 未经过筛选的开关机日志数据
+     * @brief appList 经过筛选完成的应用日志数据,插件只导出筛选结果,不另存原始数据   ~/.cache/deepin/xxx.log(.xxx)
      */
-    QList<LOG_MSG_KWIN> m_kwinList;
+    QList<LOG_MSG_APPLICATOIN> appList;
     /**
      * @brief m_iconPrefix 图标资源文件路径前缀
      */
@@ -230,8 +186,6 @@ private:
      * @brief m_journalFilter 当前系统日志筛选条件
      */
     JOURNAL_FILTERS m_journalFilter;
-    QList<LOG_MSG_DNF> dnfList, dnfListOrigin; //dnf.log
-    QList<LOG_MSG_DMESG> dmesgList, dmesgListOrigin; //dmesg cmd
     QMap<QString, QString> m_dnfIconNameMap;
     DNFPRIORITY m_curDnfLevel {INFO};
     //当前系统日志获取进程标记量
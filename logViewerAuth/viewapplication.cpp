@@ -3,6 +3,8 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "viewapplication.h"
+#include "logsharedring.h"
+#include "logbytesanitizer.h"
 
 #include <QDebug>
 #include <QFile>
@@ -18,6 +20,8 @@
 
 #include <iostream>
 #include<signal.h>
+#include <errno.h>
+#include <unistd.h>
 
 #ifdef QT_DEBUG
 Q_LOGGING_CATEGORY(logViewApp, "org.deepin.log.viewer.application.view")
@@ -34,6 +38,8 @@ ViewApplication::ViewApplication(int &argc, char **argv): QCoreApplication(argc,
         qCCritical(logViewApp) << "cmd param count less than 2";
         return ;
     }
+    //第三个参数为界面进程创建的共享内存数据通道,"-"表示只需要提权鉴权,不需要数据
+    const QString dataKey = fileList.count() > 2 ? fileList[2] : QString();
     bool useFinishedSignal = false;
     bool onlyExec = false;
     QStringList arg;
@@ -56,7 +62,11 @@ ViewApplication::ViewApplication(int &argc, char **argv): QCoreApplication(argc,
             << QString("readelf -n %1").arg(fileList[1]);
         useFinishedSignal = true;
     } else {
-        arg << "-c" << QString("cat %1").arg(fileList[0]);
+        m_commondM->setKey(fileList[1]);
+        m_commondM->attach(QSharedMemory::ReadOnly);
+        if (dataKey != LOG_AUTH_NO_DATA)
+            readFile(fileList[0], dataKey);
+        return;
     }
     m_proc = new QProcess(this);
 
@@ -79,8 +89,21 @@ ViewApplication::ViewApplication(int &argc, char **argv): QCoreApplication(argc,
             }
 
             QByteArray byte =   m_proc->readAll();
-            QStringList strList = QString(byte.replace('\u0000', "").replace("\x01", "")).split('\n', QString::SkipEmptyParts);
-            std::cout << byte.replace('\u0000', "").data();
+            LogByteSanitizer::sanitize(byte, LogByteSanitizer::RemoveNulAndSoh);
+            std::cout << byte.data();
+        });
+    } else if (!onlyExec && !dataKey.isEmpty() && fileList[0] == "dmesg") {
+        //dmesg的输出写入共享内存通道
+        m_ring.reset(new LogSharedRing(dataKey));
+        if (!m_ring->attach()) {
+            m_ring.reset();
+            return;
+        }
+        connect(m_proc, &QProcess::readyReadStandardOutput, this, [ = ] {
+            const QByteArray byte = m_proc->readAll();
+            if (!m_ring->write(byte.constData(), byte.size(), [this]() { return getControlInfo().isStart; })) {
+                m_proc->kill();
+            }
         });
     } else if (!onlyExec) {
         connect(m_proc, &QProcess::readyReadStandardOutput, this, [ = ] {
@@ -91,15 +114,67 @@ ViewApplication::ViewApplication(int &argc, char **argv): QCoreApplication(argc,
                 exit(0);
             }
             QByteArray byte =   m_proc->readAll();
-            std::cout << byte.replace('\u0000', "").data();
+            LogByteSanitizer::sanitize(byte, LogByteSanitizer::RemoveNulAndSoh);
+            std::cout << byte.data();
         });
     }
 
     m_proc->start("/bin/bash", arg);
     m_proc->waitForFinished(-1);
+    if (m_ring) {
+        m_ring->finish(m_proc->exitStatus() == QProcess::NormalExit);
+        m_ring.reset();
+    }
     m_proc->close();
 }
 
+/**
+ * @brief ViewApplication::readFile 直接读取文件,不再通过bash执行cat
+ * 有数据通道时把文件read到共享内存中,界面进程在共享内存上解析;否则按原来的方式输出到标准输出
+ * @param path 文件路径
+ * @param dataKey 共享内存数据通道的名称,为空时输出到标准输出
+ */
+void ViewApplication::readFile(const QString &path, const QString &dataKey)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qCWarning(logViewApp) << "open failed:" << path << file.errorString();
+        return;
+    }
+    if (dataKey.isEmpty()) {
+        QByteArray byte;
+        while (getControlInfo().isStart && !(byte = file.read(LOG_AUTH_READ_CHUNK)).isEmpty()) {
+            LogByteSanitizer::sanitize(byte, LogByteSanitizer::RemoveNulAndSoh);
+            std::cout << byte.constData();
+        }
+        return;
+    }
+
+    LogSharedRing ring(dataKey);
+    if (!ring.attach())
+        return;
+    const LogSharedRing::CanRun canRun = [this]() { return getControlInfo().isStart; };
+    const int fd = file.handle();
+    bool ok = true;
+    for (;;) {
+        qint64 available = 0;
+        char *buffer = ring.writeBuffer(available, canRun);
+        if (!buffer) {
+            ok = false;
+            break;
+        }
+        const ssize_t count = ::read(fd, buffer, static_cast<size_t>(qMin<qint64>(available, LOG_AUTH_READ_CHUNK)));
+        if (count < 0 && errno == EINTR)
+            continue;
+        if (count <= 0) {
+            ok = count == 0;
+            break;
+        }
+        ring.commit(count);
+    }
+    ring.finish(ok);
+}
+
 ViewApplication::~ViewApplication()
 {
     releaseMemery();
@@ -4,7 +4,14 @@
 
 #ifndef VIEWAPPLICATION_H
 #define VIEWAPPLICATION_H
+#include "logsharedring.h"
+
 #include <QCoreApplication>
+#include <QScopedPointer>
+
+//直接读取文件时每次读取的字节数
+#define LOG_AUTH_READ_CHUNK (1024 * 1024)
+
 class QProcess;
 class QSharedMemory;
 class ViewApplication : public QCoreApplication
@@ -17,10 +24,15 @@ public:
     ~ViewApplication();
     QProcess *m_proc;
     QSharedMemory *m_commondM;
+    //dmesg输出的共享内存数据通道,界面进程没有传入时为空
+    QScopedPointer<LogSharedRing> m_ring;
 public slots:
     void releaseMemery();
     ShareMemoryInfo getControlInfo();
 
+private:
+    void readFile(const QString &path, const QString &dataKey);
+
 };
 
 #endif // VIEWAPPLICATION_H
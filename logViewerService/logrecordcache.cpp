@@ -0,0 +1,319 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logrecordcache.h"
+#include "logbytesanitizer.h"
+#include "loglineindexer.h"
+#include "logrecordparser.h"
+
+#include <QDateTime>
+#include <QFile>
+#include <QFileSystemWatcher>
+#include <QLoggingCategory>
+#include <QRunnable>
+#include <QThreadPool>
+#include <QTimer>
+
+#include <sys/stat.h>
+
+#ifdef QT_DEBUG
+Q_LOGGING_CATEGORY(logRecordCache, "org.deepin.log.viewer.service.record.cache")
+#else
+Q_LOGGING_CATEGORY(logRecordCache, "org.deepin.log.viewer.service.record.cache", QtInfoMsg)
+#endif
+
+namespace {
+/**
+ * @brief The FileIdentity struct 文件的设备号、inode和大小,取不到时valid为false
+ */
+struct FileIdentity {
+    bool valid = false;
+    quint64 device = 0;
+    quint64 inode = 0;
+    qint64 size = 0;
+};
+
+FileIdentity identityOf(const QString &filePath)
+{
+    FileIdentity identity;
+    struct stat info;
+    if (::stat(filePath.toLocal8Bit().constData(), &info) != 0 || !S_ISREG(info.st_mode))
+        return identity;
+    identity.valid = true;
+    identity.device = static_cast<quint64>(info.st_dev);
+    identity.inode = static_cast<quint64>(info.st_ino);
+    identity.size = static_cast<qint64>(info.st_size);
+    return identity;
+}
+
+/**
+ * @brief sameFile 缓存是否仍对应该文件:同一个inode且没有被截断
+ */
+bool sameFile(const LogRecordCacheEntry &entry, const FileIdentity &identity)
+{
+    return identity.valid && identity.device == entry.device && identity.inode == entry.inode
+           && identity.size >= entry.parsedSize;
+}
+
+class BuildTask : public QRunnable
+{
+public:
+    explicit BuildTask(const std::function<void()> &task)
+        : m_task(task)
+    {
+    }
+
+    void run() override
+    {
+        m_task();
+    }
+
+private:
+    std::function<void()> m_task;
+};
+}
+
+qint64 LogRecordCacheEntry::memory() const
+{
+    return records.blob.size() + records.timestamps.size() * qint64(sizeof(qint64))
+           + (records.levels.size() + records.offsets.size()) * qint64(sizeof(qint32));
+}
+
+LogRecordCache::LogRecordCache(QThreadPool *pool, QObject *parent)
+    : QObject(parent)
+    , m_pool(pool)
+    , m_watcher(new QFileSystemWatcher(this))
+    , m_refreshTimer(new QTimer(this))
+{
+    m_refreshTimer->setSingleShot(true);
+    m_refreshTimer->setInterval(RECORD_CACHE_REFRESH_DELAY);
+    connect(m_refreshTimer, &QTimer::timeout, this, &LogRecordCache::refreshPending);
+    connect(m_watcher, &QFileSystemWatcher::fileChanged, this, [this](const QString &path) {
+        m_pending.insert(path);
+        if (!m_refreshTimer->isActive())
+            m_refreshTimer->start();
+    });
+}
+
+/**
+ * @brief LogRecordCache::acquire 取得文件当前的解析结果,追加的内容先增量解析
+ * 还没有缓存时在工作线程中开始建立,本次返回空,调用者按原来的方式逐块读取
+ * @param filePath 已校验过的普通文件路径
+ * @param format 记录格式,见LogRecordBatch::Format
+ * @return 不随之后的更新变化的结果,为空时没有可用的缓存
+ */
+LogRecordCacheSnapshot LogRecordCache::acquire(const QString &filePath, int format)
+{
+    const QString key = keyOf(filePath, format);
+    auto it = m_slots.find(key);
+    if (it == m_slots.end()) {
+        build(filePath, format);
+        return LogRecordCacheSnapshot();
+    }
+    if (!refresh(it.value())) {
+        remove(key);
+        build(filePath, format);
+        return LogRecordCacheSnapshot();
+    }
+    it->lastUsed = QDateTime::currentMSecsSinceEpoch();
+    return it->entry;
+}
+
+/**
+ * @brief LogRecordCache::canServe 缓存中只保存解析后的列,按等级和关键字筛选需要原始行,仍逐块读取
+ */
+bool LogRecordCache::canServe(const LogLineFilter &filter)
+{
+    return filter.levels.isEmpty() && filter.keyword.isEmpty();
+}
+
+/**
+ * @brief LogRecordCache::readBatch 从缓存中按从新到旧取出下一批满足时间范围的记录
+ * @param next 输入输出参数,下一条要检查的记录序号,小于0表示已取完
+ * @return 一批记录,为空时表示读取结束
+ */
+LogRecordBatch LogRecordCache::readBatch(const LogRecordCacheEntry &entry, int &next, const LogLineFilter &filter)
+{
+    const LogRecordBatch &records = entry.records;
+    LogRecordBatch batch;
+    batch.reset(entry.format);
+    const bool timed = filter.timeBegin > 0 && filter.timeEnd > 0;
+    const int columnCount = records.columnCount;
+    batch.offsets.append(0);
+    for (; next >= 0 && batch.size() < RECORD_CACHE_BATCH_SIZE; --next) {
+        const qint64 time = records.timestamps.at(next);
+        //和逐行读取一致,取不到时间的记录总是返回
+        if (timed && time >= 0 && (time < filter.timeBegin || time > filter.timeEnd))
+            continue;
+        batch.timestamps.append(time);
+        batch.levels.append(records.levels.at(next));
+        //各列在blob中连续存放,整条记录一次复制
+        const int first = next * columnCount;
+        const qint32 begin = records.offsets.at(first);
+        const qint32 base = batch.blob.size() - begin;
+        batch.blob.append(records.blob.constData() + begin, records.offsets.at(first + columnCount) - begin);
+        for (int c = 1; c <= columnCount; ++c)
+            batch.offsets.append(records.offsets.at(first + c) + base);
+    }
+    if (batch.size() == 0)
+        batch.offsets.clear();
+    return batch;
+}
+
+/**
+ * @brief LogRecordCache::parseTail 从已解析的位置顺序解析到end,最后不完整的行留到下次
+ * @return false表示读取失败或超过单个文件的缓存上限,缓存不能再使用
+ */
+bool LogRecordCache::parseTail(LogRecordCacheEntry &entry, qint64 end)
+{
+    if (end <= entry.parsedSize)
+        return true;
+    QFile file(entry.filePath);
+    if (!file.open(QIODevice::ReadOnly) || !file.seek(entry.parsedSize)) {
+        qCWarning(logRecordCache) << "open log failed:" << entry.filePath << file.errorString();
+        return false;
+    }
+    if (entry.records.columnCount == 0)
+        entry.records.reset(entry.format);
+
+    QByteArray carry;
+    qint64 pos = entry.parsedSize;
+    qint64 time = 0;
+    QStringList columns;
+    QVector<LogLineSpan> spans;
+    while (pos < end) {
+        const QByteArray block = file.read(qMin<qint64>(RECORD_CACHE_READ_CHUNK, end - pos));
+        if (block.isEmpty())
+            break;
+        pos += block.size();
+        carry.append(block);
+        const int lineEnd = carry.lastIndexOf('\n');
+        if (lineEnd < 0)
+            continue;
+        QByteArray data = carry.left(lineEnd);
+        carry.remove(0, lineEnd + 1);
+        //和逐块读取一致,0x00替换为空格
+        LogByteSanitizer::sanitize(data, LogByteSanitizer::ReplaceNul);
+        LogLineIndexer::index(data.constData(), 0, data.size(), spans);
+        for (const LogLineSpan &span : spans) {
+            if (LogRecordParser::parseLine(entry.format, QString::fromUtf8(data.constData() + span.offset, span.length), time, columns))
+                entry.records.append(time, -1, columns);
+        }
+        entry.parsedSize = pos - carry.size();
+        if (entry.memory() > RECORD_CACHE_ENTRY_LIMIT) {
+            qCInfo(logRecordCache) << "log too large to cache:" << entry.filePath;
+            return false;
+        }
+    }
+    return true;
+}
+
+QString LogRecordCache::keyOf(const QString &filePath, int format)
+{
+    return QString::number(format) + ":" + filePath;
+}
+
+/**
+ * @brief LogRecordCache::build 在工作线程中建立文件的缓存,完成后回到主线程安装
+ */
+void LogRecordCache::build(const QString &filePath, int format)
+{
+    const QString key = keyOf(filePath, format);
+    const FileIdentity identity = identityOf(filePath);
+    //解析结果和原文大小相近,明显超过上限的文件不尝试
+    if (!identity.valid || identity.size > RECORD_CACHE_ENTRY_LIMIT || m_building.contains(key))
+        return;
+    m_building.insert(key);
+
+    //服务析构时先等待工作线程结束,之后才销毁本对象
+    m_pool->start(new BuildTask([this, filePath, format, identity]() {
+        std::shared_ptr<LogRecordCacheEntry> entry = std::make_shared<LogRecordCacheEntry>();
+        entry->filePath = filePath;
+        entry->format = format;
+        entry->device = identity.device;
+        entry->inode = identity.inode;
+        if (!parseTail(*entry, identity.size))
+            entry.reset();
+        QMetaObject::invokeMethod(this, [this, filePath, format, entry]() {
+            m_building.remove(keyOf(filePath, format));
+            if (entry)
+                install(entry);
+        }, Qt::QueuedConnection);
+    }));
+}
+
+void LogRecordCache::install(const std::shared_ptr<LogRecordCacheEntry> &entry)
+{
+    //建立期间文件被轮转时结果作废
+    if (!sameFile(*entry, identityOf(entry->filePath)))
+        return;
+    Slot slot;
+    slot.entry = entry;
+    slot.lastUsed = QDateTime::currentMSecsSinceEpoch();
+    m_slots.insert(keyOf(entry->filePath, entry->format), slot);
+    if (!m_watcher->files().contains(entry->filePath))
+        m_watcher->addPath(entry->filePath);
+    qCInfo(logRecordCache) << "cached" << entry->records.size() << "records of" << entry->filePath;
+    evict();
+}
+
+/**
+ * @brief LogRecordCache::refresh 增量解析文件追加的内容;正在使用旧结果的通道不受影响
+ * @return false表示文件已被轮转、截断或删除,缓存不能再使用
+ */
+bool LogRecordCache::refresh(Slot &slot)
+{
+    const FileIdentity identity = identityOf(slot.entry->filePath);
+    if (!sameFile(*slot.entry, identity))
+        return false;
+    if (identity.size == slot.entry->parsedSize)
+        return true;
+    std::shared_ptr<LogRecordCacheEntry> entry = std::make_shared<LogRecordCacheEntry>(*slot.entry);
+    if (!parseTail(*entry, identity.size))
+        return false;
+    slot.entry = entry;
+    return true;
+}
+
+void LogRecordCache::refreshPending()
+{
+    const QSet<QString> pending = m_pending;
+    m_pending.clear();
+    for (const QString &key : m_slots.keys()) {
+        auto it = m_slots.find(key);
+        if (pending.contains(it->entry->filePath) && !refresh(it.value()))
+            remove(key);
+    }
+    evict();
+}
+
+void LogRecordCache::remove(const QString &key)
+{
+    const QString filePath = m_slots.take(key).entry->filePath;
+    for (const Slot &slot : m_slots) {
+        if (slot.entry->filePath == filePath)
+            return;
+    }
+    m_watcher->removePath(filePath);
+}
+
+void LogRecordCache::evict()
+{
+    while (!m_slots.isEmpty()) {
+        qint64 total = 0;
+        QString oldest;
+        qint64 oldestTime = 0;
+        for (auto it = m_slots.constBegin(); it != m_slots.constEnd(); ++it) {
+            total += it->entry->memory();
+            if (oldest.isEmpty() || it->lastUsed < oldestTime) {
+                oldest = it.key();
+                oldestTime = it->lastUsed;
+            }
+        }
+        if (total <= RECORD_CACHE_TOTAL_LIMIT)
+            return;
+        qCInfo(logRecordCache) << "evict cache of" << m_slots.value(oldest).entry->filePath;
+        remove(oldest);
+    }
+}
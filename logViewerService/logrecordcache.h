@@ -0,0 +1,92 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGRECORDCACHE_H
+#define LOGRECORDCACHE_H
+
+#include "loglinefilter.h"
+#include "logrecordbatch.h"
+
+#include <QMap>
+#include <QObject>
+#include <QSet>
+
+#include <memory>
+
+class QFileSystemWatcher;
+class QThreadPool;
+class QTimer;
+
+//单个文件的解析缓存占用内存的上限,超过时不缓存该文件
+#define RECORD_CACHE_ENTRY_LIMIT (256 * 1024 * 1024LL)
+//所有解析缓存占用内存的上限,超过时淘汰最久没有使用的文件
+#define RECORD_CACHE_TOTAL_LIMIT (512 * 1024 * 1024LL)
+//从缓存中每次返回的最多记录数
+#define RECORD_CACHE_BATCH_SIZE 20000
+//解析文件时每次读取的数据量
+#define RECORD_CACHE_READ_CHUNK (4 * 1024 * 1024)
+//文件变化后合并通知再解析新增内容的延迟,毫秒,持续写入的日志不会每行解析一次
+#define RECORD_CACHE_REFRESH_DELAY 1000
+
+/**
+ * @brief The LogRecordCacheEntry struct 一个文件按某种记录格式解析的结果,记录按文件中的顺序排列
+ */
+struct LogRecordCacheEntry {
+    QString filePath;
+    int format = LogRecordBatch::InvalidFormat;
+    //文件的设备号和inode,轮转改名或重建后不再对应
+    quint64 device = 0;
+    quint64 inode = 0;
+    //已解析到的位置,总在行尾,之后不完整的行等写完再解析
+    qint64 parsedSize = 0;
+    LogRecordBatch records;
+
+    qint64 memory() const;
+};
+typedef std::shared_ptr<const LogRecordCacheEntry> LogRecordCacheSnapshot;
+
+/**
+ * @brief The LogRecordCache class 服务端常驻的需要root权限的日志的解析缓存
+ * 第一次打开某个文件的记录通道时在工作线程中顺序解析整个文件,之后打开同一文件的通道(重新打开界面、
+ * 同时运行的界面和命令行)直接从缓存按时间范围取出记录,不再读取和分词;
+ * 文件变化时由inotify通知,追加的内容增量解析,轮转或截断时丢弃缓存,下次打开时重建
+ * 只在服务的主线程中访问,工作线程只解析私有的结果
+ */
+class LogRecordCache : public QObject
+{
+    Q_OBJECT
+public:
+    explicit LogRecordCache(QThreadPool *pool, QObject *parent = nullptr);
+
+    LogRecordCacheSnapshot acquire(const QString &filePath, int format);
+    bool isEmpty() const { return m_slots.isEmpty() && m_building.isEmpty(); }
+    static bool canServe(const LogLineFilter &filter);
+    static LogRecordBatch readBatch(const LogRecordCacheEntry &entry, int &next, const LogLineFilter &filter);
+    static bool parseTail(LogRecordCacheEntry &entry, qint64 end);
+
+private:
+    struct Slot {
+        std::shared_ptr<LogRecordCacheEntry> entry;
+        qint64 lastUsed = 0;
+    };
+
+    static QString keyOf(const QString &filePath, int format);
+    void build(const QString &filePath, int format);
+    void install(const std::shared_ptr<LogRecordCacheEntry> &entry);
+    bool refresh(Slot &slot);
+    void refreshPending();
+    void remove(const QString &key);
+    void evict();
+
+    QThreadPool *m_pool;
+    QMap<QString, Slot> m_slots;
+    //正在工作线程中建立的缓存
+    QSet<QString> m_building;
+    QFileSystemWatcher *m_watcher = nullptr;
+    //收到变化通知、等待增量解析的文件
+    QSet<QString> m_pending;
+    QTimer *m_refreshTimer = nullptr;
+};
+
+#endif // LOGRECORDCACHE_H
@@ -3,17 +3,37 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "logviewerservice.h"
+#include "loggzipinflater.h"
+#include "logbytesanitizer.h"
+#include "loglineindexer.h"
+#include "logrecordparser.h"
+#include "logviewerwatcher.h"
 
 #include <QCoreApplication>
 #include <QDebug>
 #include <QStringList>
-#include <QCryptographicHash>
-#include <QTextStream>
+#include <QUuid>
+#include <QFile>
+#include <QFileInfo>
 #include <QDBusConnection>
 #include <QDBusMessage>
 #include <QDBusConnectionInterface>
+#include <QDBusMetaType>
 #include <QStandardPaths>
 #include <QLoggingCategory>
+#include <QMutexLocker>
+#include <QProcess>
+#include <QRunnable>
+#include <QTimer>
+#include <QDateTime>
+#include <QRegularExpression>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/sendfile.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #ifdef QT_DEBUG
 Q_LOGGING_CATEGORY(logService, "org.deepin.log.viewer.service")
@@ -21,9 +41,77 @@ Q_LOGGING_CATEGORY(logService, "org.deepin.log.viewer.service")
 Q_LOGGING_CATEGORY(logService, "org.deepin.log.viewer.service", QtInfoMsg)
 #endif
 
+//倒序流式读取时每次从文件读取的块大小
+#define REVERSE_STREAM_BLOCK_SIZE (4 * 1024 * 1024)
+//顺序流式读取时每次返回的最大数据量
+#define FORWARD_STREAM_BLOCK_SIZE (4 * 1024 * 1024)
+//压缩传输的压缩等级,日志文本在最低等级下已有数倍的压缩比,服务端的耗时远小于总线传输
+#define TRANSFER_COMPRESS_LEVEL 1
+//每个调用者的通道占用的内存上限
+#define STREAM_CALLER_MEMORY_LIMIT (256 * 1024 * 1024LL)
+//所有通道占用的内存上限
+#define STREAM_TOTAL_MEMORY_LIMIT (512 * 1024 * 1024LL)
+//每个调用者同时打开的通道数上限
+#define STREAM_CALLER_MAX_COUNT 32
+//通道超过这个时间没有读取时关闭,毫秒
+#define STREAM_IDLE_TIMEOUT (5 * 60 * 1000)
+//检查空闲通道的间隔,毫秒
+#define STREAM_REAP_INTERVAL (60 * 1000)
+//导出时每次在内核中复制的最大数据量
+#define EXPORT_COPY_CHUNK (16 * 1024 * 1024)
+//不支持内核复制时每次读写的数据量
+#define EXPORT_READ_CHUNK (256 * 1024)
+//增量导出journal时保留输出末尾的字节数,末尾的cursor行在其中
+#define JOURNAL_CURSOR_TAIL 1024
+//同时处理的耗时请求(读取、查找解压、导出)数
+#define SERVICE_WORKER_COUNT 4
+//轮转日志解压缓存的总大小上限,超过时淘汰最久没有用到的解压结果
+#define UNZIP_CACHE_MAX_SIZE (512 * 1024 * 1024LL)
+
+namespace {
+/**
+ * @brief The DelayedReplyTask class 在工作线程中执行请求,完成后发送延迟的D-Bus回复
+ */
+class DelayedReplyTask : public QRunnable
+{
+public:
+    DelayedReplyTask(const QDBusConnection &connection, const QDBusMessage &message, const std::function<QVariant()> &task)
+        : m_connection(connection)
+        , m_message(message)
+        , m_task(task)
+    {
+    }
+
+    void run() override
+    {
+        //QDBusConnection::send是线程安全的,可以直接从工作线程回复
+        m_connection.send(m_message.createReply(m_task()));
+    }
+
+private:
+    QDBusConnection m_connection;
+    QDBusMessage m_message;
+    std::function<QVariant()> m_task;
+};
+}
+
 LogViewerService::LogViewerService(QObject *parent)
     : QObject(parent)
 {
+    qDBusRegisterMetaType<LogRecordBatch>();
+    qDBusRegisterMetaType<LogFileStat>();
+    qDBusRegisterMetaType<QList<LogFileStat>>();
+    if (tmpDir.isValid()) {
+        tmpDirPath = tmpDir.path();
+    }
+    m_workerPool.setMaxThreadCount(SERVICE_WORKER_COUNT);
+    m_recordCache = new LogRecordCache(&m_workerPool, this);
+    m_streamReaper = new QTimer(this);
+    m_streamReaper->setInterval(STREAM_REAP_INTERVAL);
+    connect(m_streamReaper, &QTimer::timeout, this, [this]() {
+        reapIdleStreams();
+    });
+    m_streamReaper->start();
     m_commands.insert("dmesg", "dmesg -r");
     m_commands.insert("last", "last -x");
     m_commands.insert("journalctl_system", "journalctl -r");
@@ -31,15 +119,51 @@ LogViewerService::LogViewerService(QObject *parent)
     m_commands.insert("journalctl_app", "journalctl");
 }
 
+/**
+ * @brief LogViewerService::setClientWatcher 设置客户端监控,有解析缓存时最后一个客户端退出后延迟退出
+ */
+void LogViewerService::setClientWatcher(LogViewerWatcher *watcher)
+{
+    m_clientWatcher = watcher;
+    if (m_clientWatcher) {
+        m_clientWatcher->setKeepAlive([this]() {
+            return !m_recordCache->isEmpty();
+        });
+    }
+}
+
 LogViewerService::~LogViewerService()
 {
-    if(!m_logMap.isEmpty()) {
-        for(auto eachPair : m_logMap) {
-            delete eachPair.second;
-        }
+    //工作线程会访问解压缓存,先等待所有请求结束
+    m_workerPool.waitForDone();
+    for (auto &stream : m_logMap) {
+        releaseLogStream(stream);
+    }
+    for (auto &stream : m_reverseLogMap) {
+        delete stream.file;
     }
 }
 
+/*!
+ * \~chinese \brief LogViewerService::dispatch 把耗时的请求放到工作线程池中执行
+ * \~chinese 通过D-Bus调用时使用延迟回复,主线程立即返回处理下一个请求;直接调用时同步执行
+ * \~chinese 调用者校验过调用者和参数之后再调用,task中不能再访问message()等当前请求的上下文
+ * \~chinese \param task 执行请求并返回结果
+ * \~chinese \return 直接调用时返回结果,通过D-Bus调用时返回值被忽略
+ */
+template <typename T>
+T LogViewerService::dispatch(const std::function<T()> &task)
+{
+    if (!calledFromDBus()) {
+        return task();
+    }
+    setDelayedReply(true);
+    m_workerPool.start(new DelayedReplyTask(connection(), message(), [task]() {
+        return QVariant::fromValue(task());
+    }));
+    return T();
+}
+
 /*!
  * \~chinese \brief LogViewerService::readLog 读取日志文件
  * \~chinese \param filePath 文件路径
@@ -51,84 +175,129 @@ QString LogViewerService::readLog(const QString &filePath)
         return " ";
     }
 
-    //增加服务黑名单，只允许通过提权接口读取/var/log下，家目录下和临时目录下的文件
-    //部分设备是直接从root账户进入，因此还需要监控/root目录
-    if ((!filePath.startsWith("/var/log/") &&
-         !filePath.startsWith("/tmp") &&
-         !filePath.startsWith("/home") &&
-         !filePath.startsWith("/root") &&
-         !filePath.startsWith("coredumpctl info") &&
-         !filePath.startsWith("coredumpctl dump") &&
-         !filePath.startsWith("readelf") &&
-         filePath != "coredump") ||
-         filePath.contains(".."))  {
+    if (!isValidReadPath(filePath)) {
         return " ";
     }
 
+    return dispatch<QString>([this, filePath]() {
+        return QString::fromUtf8(readLogContent(filePath));
+    });
+}
+
+/*!
+ * \~chinese \brief LogViewerService::readLogCompressed 同readLog,返回压缩后的UTF-8数据
+ * \~chinese 不允许传递文件描述符时日志内容经过总线,压缩后传输的数据量只有QString的几分之一
+ * \~chinese \param filePath 文件路径
+ * \~chinese \return qCompress格式的UTF-8数据
+ */
+QByteArray LogViewerService::readLogCompressed(const QString &filePath)
+{
+    if (!isValidInvoker() || !isValidReadPath(filePath)) {
+        return compressTransfer(" ");
+    }
+
+    return dispatch<QByteArray>([this, filePath]() {
+        return compressTransfer(readLogContent(filePath));
+    });
+}
+
+/*!
+ * \~chinese \brief LogViewerService::compressTransfer 压缩要传输的数据,空数据不压缩,仍表示读取结束
+ */
+QByteArray LogViewerService::compressTransfer(const QByteArray &data)
+{
+    if (data.isEmpty()) {
+        return QByteArray();
+    }
+    return qCompress(data, TRANSFER_COMPRESS_LEVEL);
+}
+
+/*!
+ * \~chinese \brief LogViewerService::readLogContent 在工作线程中执行readLog的读取
+ * \~chinese 每次使用独立的QProcess,多个请求可以同时执行
+ * \~chinese \param filePath 已校验过的文件路径或命令
+ * \~chinese \return 读取的日志,UTF-8编码,0x00已替换为空格
+ */
+QByteArray LogViewerService::readLogContent(const QString &filePath)
+{
+    QProcess process;
     if (filePath == "coredump") {
         // 通过后端服务，读取系统下所有账户的崩溃日志信息
-        m_process.start("/bin/bash", QStringList() << "-c" << "coredumpctl list --no-pager");
-        m_process.waitForFinished(-1);
+        process.start("/bin/bash", QStringList() << "-c" << "coredumpctl list --no-pager");
+        process.waitForFinished(-1);
+        m_exitCode = process.exitCode();
 
-        return m_process.readAllStandardOutput();
+        return process.readAllStandardOutput();
     } else if (filePath.startsWith("coredumpctl info")) {
         // 通过后端服务，按进程号获取崩溃信息
-        m_process.start("/bin/bash", QStringList() << "-c" << filePath);
-        m_process.waitForFinished(-1);
+        process.start("/bin/bash", QStringList() << "-c" << filePath);
+        process.waitForFinished(-1);
+        m_exitCode = process.exitCode();
 
-        return m_process.readAllStandardOutput();
+        return process.readAllStandardOutput();
     } else if (filePath.startsWith("coredumpctl dump")) {
         // 截取对应pid的dump文件到指定目录
-        m_process.start("/bin/bash", QStringList() << "-c" << filePath);
-        m_process.waitForFinished(-1);
+        process.start("/bin/bash", QStringList() << "-c" << filePath);
+        process.waitForFinished(-1);
+        m_exitCode = process.exitCode();
 
-        return m_process.readAllStandardOutput();
+        return process.readAllStandardOutput();
     } else if (filePath.startsWith("readelf")) {
         // 获取dump文件偏移地址信息
-        m_process.start("/bin/bash", QStringList() << "-c" << filePath);
-        m_process.waitForFinished(-1);
+        process.start("/bin/bash", QStringList() << "-c" << filePath);
+        process.waitForFinished(-1);
+        m_exitCode = process.exitCode();
 
-        return m_process.readAllStandardOutput();
+        return process.readAllStandardOutput();
     } else {
-        m_process.start("cat", QStringList() << filePath);
-        m_process.waitForFinished(-1);
-        QByteArray byte = m_process.readAllStandardOutput();
+        process.start("cat", QStringList() << filePath);
+        process.waitForFinished(-1);
+        m_exitCode = process.exitCode();
+        QByteArray byte = process.readAllStandardOutput();
 
         //QByteArray -> QString 如果遇到0x00，会导致转换终止
-        //replace("\x00", "")和replace("\u0000", "")无效
         //使用remove操作，性能损耗过大，因此遇到0x00 替换为 0x20(空格符)
-        qCInfo(logService) << "replace 0x00 to 0x20 begin";
-        int replaceTimes = 0;
-        for (int i = 0; i != byte.size(); ++i) {
-            if (byte.at(i) == 0x00) {
-                byte[i] = 0x20;
-                replaceTimes++;
-            }
-        }
-        qCInfo(logService) << "replace 0x00 to 0x20   end. replaceTimes:" << replaceTimes;
-        return QString::fromUtf8(byte);
+        if (LogByteSanitizer::sanitize(byte, LogByteSanitizer::ReplaceNul))
+            qCInfo(logService) << "replaced 0x00 with 0x20:" << filePath;
+        return byte;
     }
 }
 
 /*!
  * \~chinese \brief LogViewerService::openLogStream 打开一个日志文件的流式读取通道
+ * \~chinese 普通文件只打开不读取,之后每次readLogInStream从记录的位置读取下一块,轮转压缩的日志(.gz)边读边解压,
+ * \~chinese 服务端不会持有整个文件的内容
  * \~chinese \param filePath 文件路径
  * \~chinese \return 通道token，返回空时表示文件路径无效
  */
 QString LogViewerService::openLogStream(const QString &filePath)
 {
-    QString result = readLog(filePath);
-    if(result == " ") {
+    if (!isValidInvoker() || !isValidReadPath(filePath)) {
         return "";
     }
 
-    QString token = QCryptographicHash::hash(filePath.toUtf8(), QCryptographicHash::Md5).toHex();
-
-    auto stream = new QTextStream;
-
-    m_logMap[token] = std::make_pair(result, stream);
-    stream->setString(&(m_logMap[token].first), QIODevice::ReadOnly);
+    LogStream stream;
+    if (QFileInfo(filePath).isFile()) {
+        stream.file = new QFile(filePath);
+        if (!stream.file->open(QIODevice::ReadOnly)) {
+            qCWarning(logService) << "open log stream failed:" << filePath << stream.file->errorString();
+            delete stream.file;
+            return "";
+        }
+        if (LogGzipInflater::isGzipFile(filePath)) {
+            stream.inflater = new LogGzipInflater(stream.file);
+        }
+    } else {
+        //允许执行的命令没有对应的文件,输出整体作为通道的内容;已校验过,不经过readLog的延迟回复
+        stream.buffer = readLogContent(filePath);
+    }
 
+    //每次打开都是新的通道,同一文件的多个读取者各自保留读取位置
+    const QString token = newStreamToken();
+    stream.owner = streamCaller();
+    stream.lastUsed = QDateTime::currentMSecsSinceEpoch();
+    m_logMap.insert(token, stream);
+    enforceStreamLimits(stream.owner, token);
     return token;
 }
 
@@ -139,43 +308,528 @@ QString LogViewerService::openLogStream(const QString &filePath)
  */
 QString LogViewerService::readLogInStream(const QString &token)
 {
-    if(!m_logMap.contains(token)) {
+    return QString::fromUtf8(readLogChunk(token));
+}
+
+/*!
+ * \~chinese \brief LogViewerService::readLogInStreamCompressed 同readLogInStream,返回压缩后的UTF-8数据
+ * \~chinese \param token 通道token
+ * \~chinese \return qCompress格式的UTF-8数据，返回为空的时候表示读取结束或token无效
+ */
+QByteArray LogViewerService::readLogInStreamCompressed(const QString &token)
+{
+    return compressTransfer(readLogChunk(token));
+}
+
+/*!
+ * \~chinese \brief LogViewerService::readLogChunk 从顺序或倒序通道读取下一块,readLogInStream和压缩传输共用
+ * \~chinese \param token 通道token
+ * \~chinese \return UTF-8编码的完整行，返回为空的时候表示读取结束或token无效
+ */
+QByteArray LogViewerService::readLogChunk(const QString &token)
+{
+    auto reverseIt = m_reverseLogMap.constFind(token);
+    if (reverseIt != m_reverseLogMap.constEnd()) {
+        if (reverseIt->owner != streamCaller()) {
+            return "";
+        }
+        return readReverseLogChunk(token);
+    }
+
+    auto it = m_logMap.find(token);
+    if (it == m_logMap.end() || it->owner != streamCaller()) {
         return "";
     }
 
-    auto stream = m_logMap[token].second;
+    LogStream &stream = it.value();
+    stream.lastUsed = QDateTime::currentMSecsSinceEpoch();
+    QByteArray data;
+    bool finished = false;
+    while (data.isEmpty() && !finished) {
+        QByteArray block;
+        if (stream.inflater) {
+            finished = !stream.inflater->readChunk(block);
+            if (finished && !stream.inflater->errorString().isEmpty()) {
+                qCWarning(logService) << "inflate log stream failed:" << stream.inflater->errorString();
+            }
+        } else if (stream.file) {
+            block = stream.file->read(FORWARD_STREAM_BLOCK_SIZE);
+            finished = block.isEmpty();
+        } else {
+            block = stream.buffer.mid(static_cast<int>(stream.offset), FORWARD_STREAM_BLOCK_SIZE);
+            finished = block.isEmpty();
+        }
+        stream.offset += block.size();
 
-    QString result;
-    constexpr int maxReadSize = 10 * 1024 * 1024;
-    while (1) {
-        auto data = stream->readLine();
-        if(data.isEmpty()) {
+        stream.carry.append(block);
+        if (finished) {
+            //已读到末尾,剩下的数据就是最后一行
+            data.swap(stream.carry);
             break;
         }
+        //块末尾的行可能还不完整,留到下一块拼接
+        int lineEnd = stream.carry.lastIndexOf('\n');
+        if (lineEnd < 0) {
+            continue;
+        }
+        data = stream.carry.left(lineEnd + 1);
+        stream.carry.remove(0, lineEnd + 1);
+    }
 
-        result += data + '\n';
+    if (data.isEmpty()) {
+        releaseLogStream(stream);
+        m_logMap.erase(it);
+        return QByteArray();
+    }
 
-        if(result.size() > maxReadSize) {
-            break;
+    //和readLog一致,0x00替换为空格,避免转换QString时被截断
+    LogByteSanitizer::sanitize(data, LogByteSanitizer::ReplaceNul);
+    if (!data.endsWith('\n')) {
+        data.append('\n');
+    }
+    return data;
+}
+
+/*!
+ * \~chinese \brief LogViewerService::releaseLogStream 释放顺序通道的文件和解压器
+ * \~chinese \param stream 顺序通道
+ */
+void LogViewerService::releaseLogStream(LogStream &stream)
+{
+    delete stream.inflater;
+    stream.inflater = nullptr;
+    delete stream.file;
+    stream.file = nullptr;
+}
+
+/*!
+ * \~chinese \brief LogViewerService::closeLogStream 调用者不再读取时主动关闭通道,不必等到读完或空闲超时
+ * \~chinese \param token 通道token,顺序、倒序和记录通道都可以关闭
+ * \~chinese \return 是否关闭了通道,token无效或不属于调用者时返回false
+ */
+bool LogViewerService::closeLogStream(const QString &token)
+{
+    const QString caller = streamCaller();
+    auto it = m_logMap.constFind(token);
+    if (it != m_logMap.constEnd() && it->owner != caller) {
+        return false;
+    }
+    auto reverseIt = m_reverseLogMap.constFind(token);
+    if (reverseIt != m_reverseLogMap.constEnd() && reverseIt->owner != caller) {
+        return false;
+    }
+    return removeStream(token);
+}
+
+/*!
+ * \~chinese \brief LogViewerService::newStreamToken 生成新通道的token,每次打开都不同,不由文件路径推出
+ * \~chinese 通道只能由打开它的调用者读取和关闭,其他调用者猜到token也无法使用
+ */
+QString LogViewerService::newStreamToken()
+{
+    QString token;
+    do {
+        token = QString::fromLatin1(QUuid::createUuid().toRfc4122().toHex());
+    } while (m_logMap.contains(token) || m_reverseLogMap.contains(token));
+    return token;
+}
+
+/*!
+ * \~chinese \brief LogViewerService::streamCaller 当前请求的调用者,通过总线调用时为发送者的唯一总线名
+ */
+QString LogViewerService::streamCaller()
+{
+    return calledFromDBus() ? message().service() : QString();
+}
+
+/*!
+ * \~chinese \brief LogViewerService::trackCaller 让客户端监控记录当前请求的调用者
+ */
+void LogViewerService::trackCaller()
+{
+    if (m_clientWatcher) {
+        m_clientWatcher->addClient(streamCaller());
+    }
+}
+
+/*!
+ * \~chinese \brief LogViewerService::removeStream 关闭并删除通道
+ * \~chinese \param token 通道token
+ * \~chinese \return 通道是否存在
+ */
+bool LogViewerService::removeStream(const QString &token)
+{
+    auto it = m_logMap.find(token);
+    if (it != m_logMap.end()) {
+        releaseLogStream(it.value());
+        m_logMap.erase(it);
+        return true;
+    }
+    auto reverseIt = m_reverseLogMap.find(token);
+    if (reverseIt != m_reverseLogMap.end()) {
+        delete reverseIt->file;
+        m_reverseLogMap.erase(reverseIt);
+        return true;
+    }
+    return false;
+}
+
+/*!
+ * \~chinese \brief LogViewerService::enforceStreamLimits 新通道打开后检查内存和数量上限,超过时关闭最久没有读取的通道
+ * \~chinese 调用者超过自己的上限时只关闭它自己的通道,超过总上限时关闭任意调用者的通道;
+ * \~chinese 刚打开的通道不会被关闭,单个通道本身超过上限时也保留
+ * \~chinese \param owner 新通道的调用者
+ * \~chinese \param keepToken 新通道的token
+ */
+void LogViewerService::enforceStreamLimits(const QString &owner, const QString &keepToken)
+{
+    while (true) {
+        qint64 totalMemory = 0;
+        qint64 ownerMemory = 0;
+        int ownerCount = 0;
+        //顺序通道的文件只在读取时占用内存,按缓存的数据和解压器的缓冲区计算
+        auto account = [&](const QString &streamOwner, qint64 memory) {
+            totalMemory += memory;
+            if (streamOwner == owner) {
+                ownerMemory += memory;
+                ++ownerCount;
+            }
+        };
+        for (const LogStream &stream : m_logMap) {
+            account(stream.owner, stream.buffer.size() + stream.carry.size()
+                    + (stream.inflater ? LOG_GZIP_INPUT_CHUNK + LOG_GZIP_OUTPUT_CHUNK : 0));
+        }
+        for (const ReverseLogStream &stream : m_reverseLogMap) {
+            account(stream.owner, stream.buffer.size() + stream.carry.size());
         }
+
+        const bool overOwner = ownerMemory > STREAM_CALLER_MEMORY_LIMIT || ownerCount > STREAM_CALLER_MAX_COUNT;
+        if (!overOwner && totalMemory <= STREAM_TOTAL_MEMORY_LIMIT) {
+            return;
+        }
+
+        QString oldestToken;
+        qint64 oldestTime = 0;
+        auto consider = [&](const QString &token, const QString &streamOwner, qint64 lastUsed) {
+            if (token == keepToken || (overOwner && streamOwner != owner)) {
+                return;
+            }
+            if (oldestToken.isEmpty() || lastUsed < oldestTime) {
+                oldestToken = token;
+                oldestTime = lastUsed;
+            }
+        };
+        for (auto it = m_logMap.constBegin(); it != m_logMap.constEnd(); ++it) {
+            consider(it.key(), it->owner, it->lastUsed);
+        }
+        for (auto it = m_reverseLogMap.constBegin(); it != m_reverseLogMap.constEnd(); ++it) {
+            consider(it.key(), it->owner, it->lastUsed);
+        }
+        if (oldestToken.isEmpty()) {
+            return;
+        }
+        qCInfo(logService) << "stream limit exceeded, close least recently used stream, owner:" << owner
+                           << "owner memory:" << ownerMemory << "count:" << ownerCount << "total memory:" << totalMemory;
+        removeStream(oldestToken);
     }
+}
 
-    if(result.isEmpty()) {
-        delete m_logMap[token].second;
-        m_logMap.remove(token);
+/*!
+ * \~chinese \brief LogViewerService::reapIdleStreams 关闭超过STREAM_IDLE_TIMEOUT没有读取的通道
+ */
+void LogViewerService::reapIdleStreams()
+{
+    const qint64 deadline = QDateTime::currentMSecsSinceEpoch() - STREAM_IDLE_TIMEOUT;
+    QStringList idleTokens;
+    for (auto it = m_logMap.constBegin(); it != m_logMap.constEnd(); ++it) {
+        if (it->lastUsed < deadline) {
+            idleTokens.append(it.key());
+        }
+    }
+    for (auto it = m_reverseLogMap.constBegin(); it != m_reverseLogMap.constEnd(); ++it) {
+        if (it->lastUsed < deadline) {
+            idleTokens.append(it.key());
+        }
     }
+    for (const QString &token : idleTokens) {
+        qCDebug(logService) << "close idle stream:" << token;
+        removeStream(token);
+    }
+}
 
-    return result;
+/*!
+ * \~chinese \brief LogViewerService::openReverseLogStream 打开一个从文件末尾向前读取的流式通道
+ * \~chinese 服务端只保留当前块,调用者按从新到旧的顺序逐块拿到完整的行,适合日志这类新内容追加在末尾的文件
+ * \~chinese 轮转压缩的日志(.gz)在服务进程内解压到内存,不再调用gunzip和写临时文件
+ * \~chinese \param filePath 文件路径,只支持普通文件
+ * \~chinese \return 通道token，返回空时表示文件路径无效或无法打开
+ */
+QString LogViewerService::openReverseLogStream(const QString &filePath)
+{
+    return openFilteredLogStream(filePath, QVariantMap());
+}
+
+/*!
+ * \~chinese \brief LogViewerService::openFilteredLogStream 打开一个带筛选条件的倒序通道
+ * \~chinese 时间、等级和关键字在服务端逐行判断,只有匹配的行经过总线,取不到时间的行总是返回
+ * \~chinese \param filePath 文件路径,只支持普通文件
+ * \~chinese \param filter 筛选条件,见LogLineFilter::fromVariantMap
+ * \~chinese \return 通道token，通过readLogInStream读取，返回空时表示文件路径无效或无法打开
+ */
+QString LogViewerService::openFilteredLogStream(const QString &filePath, const QVariantMap &filter)
+{
+    if (!isValidInvoker() || !isValidReadPath(filePath) || !QFileInfo(filePath).isFile()) {
+        return "";
+    }
+
+    ReverseLogStream stream;
+    stream.filter = LogLineFilter::fromVariantMap(filter);
+    if (LogGzipInflater::isGzipFile(filePath)) {
+        QString error;
+        //解压后的内容超过一个调用者的通道内存上限时不打开,不等到enforceStreamLimits才发现
+        if (!LogGzipInflater::inflateFile(filePath, stream.buffer, &error, STREAM_CALLER_MEMORY_LIMIT)) {
+            qCWarning(logService) << "inflate log failed:" << filePath << error;
+            if (stream.buffer.isEmpty()) {
+                return "";
+            }
+        }
+        stream.pos = stream.buffer.size();
+    } else {
+        stream.file = new QFile(filePath);
+        if (!stream.file->open(QIODevice::ReadOnly)) {
+            qCWarning(logService) << "open reverse log stream failed:" << filePath << stream.file->errorString();
+            delete stream.file;
+            return "";
+        }
+        stream.pos = stream.file->size();
+    }
+
+    //同一文件、同一筛选条件的多个通道互不影响
+    const QString token = newStreamToken();
+    stream.owner = streamCaller();
+    stream.lastUsed = QDateTime::currentMSecsSinceEpoch();
+    m_reverseLogMap.insert(token, stream);
+    enforceStreamLimits(stream.owner, token);
+    return token;
+}
+
+/*!
+ * \~chinese \brief LogViewerService::openLogFile 以root权限打开日志文件,把文件描述符传给调用者
+ * \~chinese 调用者直接读取或映射该描述符,日志内容不再经过总线转成QString传输
+ * \~chinese \param filePath 文件路径,只支持普通文件
+ * \~chinese \return 只读的文件描述符，路径无效或无法打开时为无效描述符
+ */
+QDBusUnixFileDescriptor LogViewerService::openLogFile(const QString &filePath)
+{
+    if (!isValidInvoker() || !isValidReadPath(filePath) || !filePath.startsWith("/")) {
+        return QDBusUnixFileDescriptor();
+    }
+
+    //符号链接可能指向允许范围之外的文件,按真实路径再检查一次
+    const QString realPath = QFileInfo(filePath).canonicalFilePath();
+    if (realPath.isEmpty() || !isValidReadPath(realPath) || !QFileInfo(realPath).isFile()) {
+        return QDBusUnixFileDescriptor();
+    }
+
+    int fd = ::open(QFile::encodeName(realPath).constData(), O_RDONLY | O_CLOEXEC | O_NOCTTY | O_NOFOLLOW);
+    if (fd < 0) {
+        qCWarning(logService) << "open log file failed:" << realPath << strerror(errno);
+        return QDBusUnixFileDescriptor();
+    }
+
+    //QDBusUnixFileDescriptor保存的是复制出的描述符,原描述符需要关闭
+    QDBusUnixFileDescriptor descriptor(fd);
+    ::close(fd);
+    return descriptor;
+}
+
+/*!
+ * \~chinese \brief LogViewerService::readReverseLogChunk 从倒序通道读取下一块日志
+ * \~chinese \param token 通道token
+ * \~chinese \return 按从新到旧排列、以换行分隔的完整行，返回为空的时候表示读取结束
+ */
+QByteArray LogViewerService::readReverseLogChunk(const QString &token)
+{
+    ReverseLogStream &stream = m_reverseLogMap[token];
+    stream.lastUsed = QDateTime::currentMSecsSinceEpoch();
+    //整块拼接为UTF-8后由调用者只转换一次,不再逐行转换和追加QString
+    QByteArray bytes;
+    QList<QByteArray> lines;
+    while (bytes.isEmpty() && readReverseLines(stream, lines)) {
+        for (const QByteArray &line : lines) {
+            bytes += line;
+            bytes += '\n';
+        }
+    }
+    if (bytes.isEmpty()) {
+        delete stream.file;
+        m_reverseLogMap.remove(token);
+    }
+    return bytes;
+}
+
+/*!
+ * \~chinese \brief LogViewerService::readReverseLines 从倒序通道向前读取一块,取出其中完整的行
+ * \~chinese \param stream 倒序通道
+ * \~chinese \param lines 输出参数,按从新到旧排列的非空且满足筛选条件的行,0x00已替换为空格
+ * \~chinese \return 是否还有数据,false表示已读到文件开头或读取失败
+ */
+bool LogViewerService::readReverseLines(ReverseLogStream &stream, QList<QByteArray> &lines)
+{
+    lines.clear();
+    if (stream.pos == 0 && stream.carry.isEmpty())
+        return false;
+
+    QByteArray data;
+    if (stream.pos == 0) {
+        //已到文件开头,剩下的数据就是第一行
+        data.swap(stream.carry);
+    } else {
+        qint64 size = qMin<qint64>(REVERSE_STREAM_BLOCK_SIZE, stream.pos);
+        stream.pos -= size;
+        QByteArray block;
+        if (!stream.file)
+            block = stream.buffer.mid(static_cast<int>(stream.pos), static_cast<int>(size));
+        else if (stream.file->seek(stream.pos))
+            block = stream.file->read(size);
+        if (block.size() != size) {
+            //读取失败时丢弃剩余内容,结束通道
+            qCWarning(logService) << "read reverse log stream failed:" << (stream.file ? stream.file->errorString() : QString());
+            stream.pos = 0;
+            stream.carry.clear();
+            return false;
+        }
+        stream.carry.prepend(block);
+        if (stream.pos == 0)
+            return true;
+        //块开头的行可能还不完整,留到下一块拼接
+        int lineEnd = stream.carry.indexOf('\n');
+        if (lineEnd < 0)
+            return true;
+        data = stream.carry.mid(lineEnd + 1);
+        stream.carry.truncate(lineEnd);
+    }
+
+    //和readLog一致,0x00替换为空格,避免转换QString时被截断
+    LogByteSanitizer::sanitize(data, LogByteSanitizer::ReplaceNul);
+    //只记下各行的位置,筛选时不复制,匹配的行才复制到结果中
+    QVector<LogLineSpan> spans;
+    LogLineIndexer::index(data.constData(), 0, data.size(), spans);
+    for (int i = spans.size() - 1; i >= 0; --i) {
+        const QByteArray line = QByteArray::fromRawData(data.constData() + spans.at(i).offset, spans.at(i).length);
+        if (stream.filter.matches(line))
+            lines.append(QByteArray(line.constData(), line.size()));
+    }
+    return true;
+}
+
+/*!
+ * \~chinese \brief LogViewerService::openRecordStream 打开一个在服务端解析好的记录通道
+ * \~chinese 倒序读取文件,每行按格式解析成定长列,通过readRecordBatch按批取回,客户端不再重复分词;
+ * \~chinese 只按时间范围筛选时使用解析缓存,第一次打开时在后台建立,之后的通道直接从缓存取出记录
+ * \~chinese \param filePath 文件路径,只支持普通文件
+ * \~chinese \param format 记录格式,见LogRecordBatch::Format
+ * \~chinese \param filter 筛选条件,见LogLineFilter::fromVariantMap
+ * \~chinese \return 通道token，返回空时表示格式不支持、文件路径无效或无法打开
+ */
+QString LogViewerService::openRecordStream(const QString &filePath, int format, const QVariantMap &filter)
+{
+    if (LogRecordBatch::columnCountOf(format) == 0) {
+        return "";
+    }
+    QString token = openFilteredLogStream(filePath, filter);
+    if (token.isEmpty()) {
+        return "";
+    }
+    ReverseLogStream stream = m_reverseLogMap.take(token);
+    stream.format = format;
+    if (stream.file && LogRecordCache::canServe(stream.filter)) {
+        stream.cached = m_recordCache->acquire(filePath, format);
+        if (stream.cached) {
+            stream.cachedNext = stream.cached->records.size() - 1;
+            delete stream.file;
+            stream.file = nullptr;
+            stream.pos = 0;
+        }
+    }
+    token = newStreamToken();
+    m_reverseLogMap.insert(token, stream);
+    return token;
+}
+
+/*!
+ * \~chinese \brief LogViewerService::readRecordBatch 从记录通道读取下一批记录
+ * \~chinese \param token 通道token
+ * \~chinese \return 按从新到旧排列的记录，为空时表示读取结束或token无效
+ */
+LogRecordBatch LogViewerService::readRecordBatch(const QString &token)
+{
+    LogRecordBatch batch;
+    auto it = m_reverseLogMap.find(token);
+    if (it == m_reverseLogMap.end() || it->format == LogRecordBatch::InvalidFormat || it->owner != streamCaller()) {
+        return batch;
+    }
+
+    ReverseLogStream &stream = it.value();
+    stream.lastUsed = QDateTime::currentMSecsSinceEpoch();
+    if (stream.cached) {
+        batch = LogRecordCache::readBatch(*stream.cached, stream.cachedNext, stream.filter);
+        if (batch.size() == 0) {
+            m_reverseLogMap.erase(it);
+        }
+        return batch;
+    }
+    batch.reset(stream.format);
+    QList<QByteArray> lines;
+    QStringList columns;
+    qint64 time = 0;
+    while (batch.size() == 0 && readReverseLines(stream, lines)) {
+        for (const QByteArray &line : lines) {
+            if (LogRecordParser::parseLine(stream.format, QString::fromUtf8(line), time, columns)) {
+                batch.append(time, -1, columns);
+            }
+        }
+    }
+
+    if (batch.size() == 0) {
+        delete stream.file;
+        m_reverseLogMap.erase(it);
+    }
+    return batch;
+}
+
+/*!
+ * \~chinese \brief LogViewerService::isValidReadPath 增加服务黑名单，只允许通过提权接口读取/var/log下，家目录下和临时目录下的文件
+ * \~chinese 部分设备是直接从root账户进入，因此还需要监控/root目录
+ * \~chinese \param filePath 文件路径或允许执行的命令
+ * \~chinese \return 是否允许读取
+ */
+bool LogViewerService::isValidReadPath(const QString &filePath)
+{
+    if ((!filePath.startsWith("/var/log/") &&
+         !filePath.startsWith("/tmp") &&
+         !filePath.startsWith("/home") &&
+         !filePath.startsWith("/root") &&
+         !filePath.startsWith("coredumpctl info") &&
+         !filePath.startsWith("coredumpctl dump") &&
+         !filePath.startsWith("readelf") &&
+         filePath != "coredump") ||
+         filePath.contains(".."))  {
+        return false;
+    }
+    return true;
 }
 
 bool LogViewerService::isFileExist(const QString &filePath)
 {
+    trackCaller();
     QFile file(filePath);
     return file.exists();
 }
 
 quint64 LogViewerService::getFileSize(const QString &filePath)
 {
+    trackCaller();
     QFileInfo fi(filePath);
     if (fi.exists())
         return static_cast<quint64>(fi.size());
@@ -183,13 +837,37 @@ quint64 LogViewerService::getFileSize(const QString &filePath)
     return 0;
 }
 
+/*!
+ * \~chinese \brief LogViewerService::statFiles 一次返回一组文件的元数据,代替逐个调用isFileExist/getFileSize
+ * \~chinese \param paths 文件或目录的绝对路径
+ * \~chinese \return 和paths顺序一致的元数据,不在允许读取范围内的路径按不存在返回
+ */
+QList<LogFileStat> LogViewerService::statFiles(const QStringList &paths)
+{
+    QList<LogFileStat> stats;
+    if (!isValidInvoker()) {
+        return stats;
+    }
+
+    for (const QString &path : paths) {
+        if (!path.startsWith("/") || !isValidReadPath(path)) {
+            LogFileStat stat;
+            stat.path = path;
+            stats.append(stat);
+            continue;
+        }
+        stats.append(LogFileStat::fromPath(path));
+    }
+    return stats;
+}
+
 /*!
  * \~chinese \brief LogViewerService::exitCode 返回进程状态
  * \~chinese \return 进程返回值
  */
 int LogViewerService::exitCode()
 {
-    return m_process.exitCode();
+    return m_exitCode;
 }
 
 /*!
@@ -208,10 +886,17 @@ void LogViewerService::quit()
  */
 QStringList LogViewerService::getFileInfo(const QString &file, bool unzip)
 {
-    int fileNum = 0;
-    if (tmpDir.isValid()) {
-        tmpDirPath = tmpDir.path();
-    }
+    trackCaller();
+    return dispatch<QStringList>([this, file, unzip]() {
+        return collectFileInfo(file, unzip);
+    });
+}
+
+/*!
+ * \~chinese \brief LogViewerService::collectFileInfo 在工作线程中执行getFileInfo的查找和解压
+ */
+QStringList LogViewerService::collectFileInfo(const QString &file, bool unzip)
+{
     QStringList fileNamePath;
     QString nameFilter;
     QDir dir;
@@ -238,7 +923,8 @@ QStringList LogViewerService::getFileInfo(const QString &file, bool unzip)
         process.start("/bin/bash", args);
         process.waitForFinished(-1);
         QByteArray outByte = process.readAllStandardOutput();
-        QStringList strList = QString(outByte.replace('\u0000', "").replace("\x01", "")).split('\n', QString::SkipEmptyParts);
+        LogByteSanitizer::sanitize(outByte, LogByteSanitizer::RemoveNulAndSoh);
+        QStringList strList = QString(outByte).split('\n', QString::SkipEmptyParts);
 
         QRegExp re("(Storage: )\\S+");
         for (int i = strList.size() - 1; i >= 0; --i) {
@@ -282,24 +968,20 @@ QStringList LogViewerService::getFileInfo(const QString &file, bool unzip)
     dir.setNameFilters(QStringList() << nameFilter + ".*"); //设置过滤
     dir.setSorting(QDir::Time);
     QFileInfoList fileList = dir.entryInfoList();
+    //本次返回的解压结果属于同一批次,返回前不会被淘汰
+    const quint64 generation = beginUnzipGeneration();
     for (int i = 0; i < fileList.count(); i++) {
         if (QString::compare(fileList[i].suffix(), "gz", Qt::CaseInsensitive) == 0 && unzip) {
-            QProcess m_process;
-
-            QString command = "gunzip";
-            QStringList args;
-            args.append("-c");
-            args.append(fileList[i].absoluteFilePath());
-            m_process.setStandardOutputFile(tmpDirPath + "/" + QString::number(fileNum) + ".txt");
-            m_process.start(command, args);
-            m_process.waitForFinished(-1);
-            fileNamePath.append(tmpDirPath + "/" + QString::number(fileNum) + ".txt");
-            fileNum++;
+            QString unzipPath = unzipToCache(fileList[i], generation);
+            if (!unzipPath.isEmpty()) {
+                fileNamePath.append(unzipPath);
+            }
         }
         else {
             fileNamePath.append(fileList[i].absoluteFilePath());
         }
     }
+    endUnzipGeneration(generation);
     return fileNamePath;
 }
 
@@ -310,10 +992,17 @@ QStringList LogViewerService::getFileInfo(const QString &file, bool unzip)
  */
 QStringList LogViewerService::getOtherFileInfo(const QString &file, bool unzip)
 {
-    int fileNum = 0;
-    if (tmpDir.isValid()) {
-        tmpDirPath = tmpDir.path();
-    }
+    trackCaller();
+    return dispatch<QStringList>([this, file, unzip]() {
+        return collectOtherFileInfo(file, unzip);
+    });
+}
+
+/*!
+ * \~chinese \brief LogViewerService::collectOtherFileInfo 在工作线程中执行getOtherFileInfo的查找和解压
+ */
+QStringList LogViewerService::collectOtherFileInfo(const QString &file, bool unzip)
+{
     QStringList fileNamePath;
     QString nameFilter;
     QDir dir;
@@ -339,33 +1028,173 @@ QStringList LogViewerService::getOtherFileInfo(const QString &file, bool unzip)
     dir.setSorting(QDir::Time);
     fileList = dir.entryInfoList();
 
+    //本次返回的解压结果属于同一批次,返回前不会被淘汰
+    const quint64 generation = beginUnzipGeneration();
     for (int i = 0; i < fileList.count(); i++) {
         if (QString::compare(fileList[i].suffix(), "gz", Qt::CaseInsensitive) == 0 && unzip) {
-            QProcess m_process;
-
-            QString command = "gunzip";
-            QStringList args;
-            args.append("-c");
-            args.append(fileList[i].absoluteFilePath());
-            m_process.setStandardOutputFile(tmpDirPath + "/" + QString::number(fileNum) + ".txt");
-            m_process.start(command, args);
-            m_process.waitForFinished(-1);
-            fileNamePath.append(tmpDirPath + "/" + QString::number(fileNum) + ".txt");
-            fileNum++;
+            QString unzipPath = unzipToCache(fileList[i], generation);
+            if (!unzipPath.isEmpty()) {
+                fileNamePath.append(unzipPath);
+            }
         }
         else {
             fileNamePath.append(fileList[i].absoluteFilePath());
         }
     }
+    endUnzipGeneration(generation);
     return fileNamePath;
 }
 
+/*!
+ * \~chinese \brief LogViewerService::unzipToCache 获取轮转日志的解压结果
+ * \~chinese 按源文件的设备号和inode查找缓存,修改时间和大小都没变时直接返回上次的解压结果,
+ * \~chinese 轮转日志压缩后不再改变,服务运行期间每个压缩文件最多只解压一次
+ * \~chinese 多个工作线程共用缓存,解压时持有m_unzipMutex,同一个文件不会被同时解压两次
+ * \~chinese \param info 压缩文件信息
+ * \~chinese \param generation 本次请求的批次
+ * \~chinese \return 解压结果的路径,解压失败时返回空
+ */
+QString LogViewerService::unzipToCache(const QFileInfo &info, quint64 generation)
+{
+    const QString sourcePath = info.absoluteFilePath();
+    struct stat st;
+    if (stat(sourcePath.toLocal8Bit().constData(), &st) != 0) {
+        qCWarning(logService) << "stat" << sourcePath << "failed:" << strerror(errno);
+        return "";
+    }
+    const QString key = QString("%1:%2").arg(st.st_dev).arg(st.st_ino);
+    const qint64 mtime = static_cast<qint64>(st.st_mtim.tv_sec) * 1000000000LL + st.st_mtim.tv_nsec;
+    const qint64 size = static_cast<qint64>(st.st_size);
+
+    QMutexLocker locker(&m_unzipMutex);
+    auto it = m_unzipCache.find(key);
+    if (it != m_unzipCache.end()) {
+        if (it->mtime == mtime && it->size == size && QFile::exists(it->filePath)) {
+            it->sourcePath = sourcePath;
+            it->generation = generation;
+            return it->filePath;
+        }
+        //源文件已改变,丢弃旧的解压结果
+        QFile::remove(it->filePath);
+        m_unzipCacheSize -= it->unzippedSize;
+        m_unzipCache.erase(it);
+    }
+
+    //每次解压使用新的文件名,不会覆盖客户端可能还在读取的旧结果
+    const QString outPath = tmpDirPath + "/" + QString::number(m_unzipFileNum++) + ".txt";
+    qint64 unzippedSize = 0;
+    if (!unzipFile(sourcePath, outPath, unzippedSize)) {
+        QFile::remove(outPath);
+        return "";
+    }
+
+    UnzipCacheEntry entry;
+    entry.sourcePath = sourcePath;
+    entry.filePath = outPath;
+    entry.mtime = mtime;
+    entry.size = size;
+    entry.unzippedSize = unzippedSize;
+    entry.generation = generation;
+    m_unzipCache.insert(key, entry);
+    m_unzipCacheSize += unzippedSize;
+    return outPath;
+}
+
+/*!
+ * \~chinese \brief LogViewerService::unzipFile 进程内流式解压到文件,不再启动gunzip子进程
+ * \~chinese \param sourcePath 压缩文件路径
+ * \~chinese \param outPath 解压结果路径
+ * \~chinese \param unzippedSize 输出参数,解压后的大小
+ * \~chinese \return 是否解压成功
+ */
+bool LogViewerService::unzipFile(const QString &sourcePath, const QString &outPath, qint64 &unzippedSize)
+{
+    QFile source(sourcePath);
+    if (!source.open(QIODevice::ReadOnly)) {
+        qCWarning(logService) << "open" << sourcePath << "failed:" << source.errorString();
+        return false;
+    }
+    QFile out(outPath);
+    if (!out.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qCWarning(logService) << "open" << outPath << "failed:" << out.errorString();
+        return false;
+    }
+
+    LogGzipInflater inflater(&source);
+    QByteArray chunk;
+    unzippedSize = 0;
+    while (inflater.readChunk(chunk)) {
+        if (out.write(chunk) != chunk.size()) {
+            qCWarning(logService) << "write" << outPath << "failed:" << out.errorString();
+            return false;
+        }
+        unzippedSize += chunk.size();
+    }
+    //和gunzip一致,不完整的压缩文件保留已解压的内容
+    if (!inflater.errorString().isEmpty()) {
+        qCWarning(logService) << "unzip" << sourcePath << "failed:" << inflater.errorString();
+    }
+    return true;
+}
+
+/*!
+ * \~chinese \brief LogViewerService::beginUnzipGeneration 开始一次需要解压的请求
+ * \~chinese \return 本次请求的批次,结束时传给endUnzipGeneration
+ */
+quint64 LogViewerService::beginUnzipGeneration()
+{
+    QMutexLocker locker(&m_unzipMutex);
+    const quint64 generation = ++m_unzipGeneration;
+    m_activeUnzipGenerations.insert(generation);
+    return generation;
+}
+
+/*!
+ * \~chinese \brief LogViewerService::endUnzipGeneration 结束一次请求,缓存超过上限时从最久没有用到的开始删除
+ * \~chinese 还在进行中的请求用到的结果即使超过上限也保留
+ * \~chinese \param generation 本次请求的批次
+ */
+void LogViewerService::endUnzipGeneration(quint64 generation)
+{
+    QMutexLocker locker(&m_unzipMutex);
+    while (m_unzipCacheSize > UNZIP_CACHE_MAX_SIZE) {
+        auto oldest = m_unzipCache.end();
+        for (auto it = m_unzipCache.begin(); it != m_unzipCache.end(); ++it) {
+            if (!m_activeUnzipGenerations.contains(it->generation) && (oldest == m_unzipCache.end() || it->generation < oldest->generation)) {
+                oldest = it;
+            }
+        }
+        if (oldest == m_unzipCache.end()) {
+            break;
+        }
+        QFile::remove(oldest->filePath);
+        m_unzipCacheSize -= oldest->unzippedSize;
+        m_unzipCache.erase(oldest);
+    }
+    m_activeUnzipGenerations.remove(generation);
+}
+
 bool LogViewerService::exportLog(const QString &outDir, const QString &in, bool isFile)
 {
     if(!isValidInvoker()) { //非法调用
         return false;
     }
 
+    //大文件的复制或命令导出在工作线程中执行,不阻塞同时进行的日志读取
+    return dispatch<bool>([this, outDir, in, isFile]() {
+        return runExportLog(outDir, in, isFile);
+    });
+}
+
+/*!
+ * \~chinese \brief LogViewerService::runExportLog 在工作线程中执行exportLog的复制或导出命令
+ * \~chinese \param outDir 导出目录
+ * \~chinese \param in 文件路径或命令名
+ * \~chinese \param isFile in是否为文件路径
+ * \~chinese \return 是否导出成功
+ */
+bool LogViewerService::runExportLog(const QString &outDir, const QString &in, bool isFile)
+{
     QFileInfo outDirInfo;
     if(!outDir.endsWith("/")) {
         outDirInfo.setFile(outDir + "/");
@@ -380,19 +1209,11 @@ bool LogViewerService::exportLog(const QString &outDir, const QString &in, bool
     QString outFullPath = "";
     QStringList arg = {"-c", ""};
     if (isFile) {
-        //增加服务黑名单，只允许通过提权接口读取/var/log、/var/lib/systemd/coredump下，家目录下和临时目录下的文件
-        if ((!in.startsWith("/var/log/") && !in.startsWith("/tmp") && !in.startsWith("/home") && !in.startsWith("/var/lib/systemd/coredump"))
-                || in.contains("..")) {
-            return false;
-        }
-        QFileInfo filein(in);
-        if (!filein.isFile()) {
-            qCWarning(logService) << "in not file:" << in;
+        if (!isValidExportFile(in)) {
             return false;
         }
-        outFullPath = outDirInfo.absoluteFilePath() + filein.fileName();
-        //复制文件
-        arg[1].append(QString("cp %1 \"%2\";").arg(in, outDirInfo.absoluteFilePath()));
+        //普通文件在进程内复制,不再启动cp和chmod
+        return copyExportFile(in, outDirInfo.absoluteFilePath() + QFileInfo(in).fileName());
     } else {
         auto it = m_commands.find(in);
         if (it == m_commands.end()) {
@@ -424,6 +1245,387 @@ bool LogViewerService::exportLog(const QString &outDir, const QString &in, bool
     return true;
 }
 
+/*!
+ * \~chinese \brief LogViewerService::exportJournalSince 增量导出journal,只导出上次导出的最后一条之后的记录
+ * \~chinese \param outDir 导出目录
+ * \~chinese \param in journal的导出命令名,同exportLog
+ * \~chinese \param cursor 上次导出的最后一条记录的cursor,为空时全部导出
+ * \~chinese \return 本次导出的最后一条记录的cursor,没有新记录时返回传入的cursor,失败时返回空
+ */
+QString LogViewerService::exportJournalSince(const QString &outDir, const QString &in, const QString &cursor)
+{
+    if (!isValidInvoker()) {
+        return QString();
+    }
+
+    return dispatch<QString>([this, outDir, in, cursor]() {
+        return runExportJournalSince(outDir, in, cursor);
+    });
+}
+
+/*!
+ * \~chinese \brief LogViewerService::runExportJournalSince 在工作线程中执行exportJournalSince
+ * \~chinese 不经过shell直接启动journalctl,按时间正序输出并用--show-cursor取得最后一条的cursor,
+ * \~chinese 末尾的cursor行不写入导出文件
+ */
+QString LogViewerService::runExportJournalSince(const QString &outDir, const QString &in, const QString &cursor)
+{
+    QFileInfo outDirInfo(outDir.endsWith("/") ? outDir : outDir + "/");
+    if (!outDirInfo.isDir() || !in.startsWith("journalctl_") || !m_commands.contains(in)) {
+        return QString();
+    }
+    //cursor由journal生成,只含字母数字和=;,其他字符一律拒绝
+    static const QRegularExpression cursorPattern("^[0-9A-Za-z=;_-]*$");
+    if (!cursorPattern.match(cursor).hasMatch()) {
+        qCWarning(logService) << "invalid journal cursor:" << cursor;
+        return QString();
+    }
+
+    QStringList args = m_commands.value(in).split(" ", QString::SkipEmptyParts);
+    const QString program = args.takeFirst();
+    args.removeAll("-r");
+    args << "--show-cursor";
+    if (!cursor.isEmpty()) {
+        args << QString("--after-cursor=%1").arg(cursor);
+    }
+    QString outFullPath = outDirInfo.absoluteFilePath() + in + ".log";
+    if (in == "journalctl_app") {
+        const QStringList dirs = outDirInfo.absoluteFilePath().split("/");
+        const QString appName = dirs.at(dirs.size() - 2);
+        outFullPath = outDirInfo.absoluteFilePath() + appName + ".log";
+        args << QString("SYSLOG_IDENTIFIER=%1").arg(appName);
+    }
+
+    int out = ::open(QFile::encodeName(outFullPath).constData(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC | O_NOFOLLOW, 0777);
+    if (out < 0) {
+        qCWarning(logService) << "open export target failed:" << outFullPath << strerror(errno);
+        return QString();
+    }
+    QProcess process;
+    process.start(program, args);
+    qint64 written = 0;
+    QByteArray tail;
+    const bool success = writeProcessOutput(process, out, outFullPath, &written, &tail);
+
+    QString lastCursor = cursor;
+    const QByteArray marker("-- cursor: ");
+    const int pos = tail.lastIndexOf(marker);
+    if (success && pos >= 0 && (pos == 0 || tail.at(pos - 1) == '\n')) {
+        lastCursor = QString::fromUtf8(tail.mid(pos + marker.size()).trimmed());
+        //cursor行不是日志内容
+        if (ftruncate(out, written - (tail.size() - pos)) != 0) {
+            qCWarning(logService) << "truncate journal export failed:" << outFullPath << strerror(errno);
+        }
+    }
+    if (fchmod(out, 0777) != 0) {
+        qCWarning(logService) << "chmod export file failed:" << outFullPath << strerror(errno);
+    }
+    ::close(out);
+    return success ? lastCursor : QString();
+}
+
+/*!
+ * \~chinese \brief LogViewerService::writeProcessOutput 把已启动进程的输出写入导出文件,结束后等待进程退出
+ * \~chinese \param out 导出文件的描述符
+ * \~chinese \param outPath 导出文件路径,用于输出错误信息
+ * \~chinese \param written 输出写入的字节数
+ * \~chinese \param tail 输出末尾最多JOURNAL_CURSOR_TAIL个字节,不需要时为空
+ * \~chinese \return 进程启动成功且全部写入时为true
+ */
+bool LogViewerService::writeProcessOutput(QProcess &process, int out, const QString &outPath, qint64 *written, QByteArray *tail)
+{
+    bool success = process.waitForStarted();
+    while (success && (process.bytesAvailable() > 0 || process.waitForReadyRead(-1))) {
+        const QByteArray data = process.readAll();
+        for (qint64 pos = 0; pos < data.size();) {
+            ssize_t r = ::write(out, data.constData() + pos, static_cast<size_t>(data.size() - pos));
+            if (r < 0 && errno != EINTR) {
+                qCWarning(logService) << "write journal export failed:" << outPath << strerror(errno);
+                success = false;
+                break;
+            }
+            pos += qMax<ssize_t>(r, 0);
+        }
+        *written += data.size();
+        if (tail) {
+            *tail = data.size() >= JOURNAL_CURSOR_TAIL ? data.right(JOURNAL_CURSOR_TAIL) : (*tail + data).right(JOURNAL_CURSOR_TAIL);
+        }
+    }
+    if (process.state() != QProcess::NotRunning) {
+        process.kill();
+    }
+    process.waitForFinished(-1);
+    return success;
+}
+
+/*!
+ * \~chinese \brief LogViewerService::exportJournal 按时间范围、等级和输出格式导出journal
+ * \~chinese \param outDir 导出目录
+ * \~chinese \param in journal的导出命令名,同exportLog
+ * \~chinese \param options 导出参数,都可以省略:since、until为开始、结束时间(微秒时间戳,包含边界),
+ * \~chinese priority为等级(0-7,和等级筛选一样只导出该等级),output为journalctl的输出格式
+ * \~chinese \return 是否导出成功,参数非法时为false
+ */
+bool LogViewerService::exportJournal(const QString &outDir, const QString &in, const QVariantMap &options)
+{
+    if (!isValidInvoker()) {
+        return false;
+    }
+
+    return dispatch<bool>([this, outDir, in, options]() {
+        return runExportJournal(outDir, in, options);
+    });
+}
+
+/*!
+ * \~chinese \brief LogViewerService::journalExportArgs 导出参数转换为journalctl的参数
+ * \~chinese 时间范围由journalctl按时间定位到开始位置,读到结束时间即停止,不读取范围外的条目
+ * \~chinese \param args 追加转换后的参数
+ * \~chinese \return 参数都合法时为true
+ */
+bool LogViewerService::journalExportArgs(const QVariantMap &options, QStringList &args)
+{
+    static const QStringList outputs {"short", "short-full", "short-iso", "short-iso-precise", "short-precise",
+                                      "short-monotonic", "short-unix", "verbose", "export", "json", "cat"};
+    auto usecArg = [](const char *name, const QVariant &value, QStringList &list) {
+        bool ok = false;
+        const qint64 usec = value.toLongLong(&ok);
+        if (!ok || usec < 0) {
+            return false;
+        }
+        list << QString("--%1=@%2.%3").arg(QLatin1String(name)).arg(usec / 1000000).arg(usec % 1000000, 6, 10, QLatin1Char('0'));
+        return true;
+    };
+
+    if (options.contains("since") && !usecArg("since", options.value("since"), args)) {
+        return false;
+    }
+    if (options.contains("until") && !usecArg("until", options.value("until"), args)) {
+        return false;
+    }
+    if (options.contains("priority")) {
+        bool ok = false;
+        const int priority = options.value("priority").toInt(&ok);
+        if (!ok || priority < 0 || priority > 7) {
+            return false;
+        }
+        args << QString("--priority=%1..%1").arg(priority);
+    }
+    if (options.contains("output")) {
+        const QString output = options.value("output").toString();
+        if (!outputs.contains(output)) {
+            return false;
+        }
+        args << QString("--output=%1").arg(output);
+    }
+    return true;
+}
+
+/*!
+ * \~chinese \brief LogViewerService::runExportJournal 在工作线程中执行exportJournal,不经过shell直接启动journalctl
+ */
+bool LogViewerService::runExportJournal(const QString &outDir, const QString &in, const QVariantMap &options)
+{
+    QFileInfo outDirInfo(outDir.endsWith("/") ? outDir : outDir + "/");
+    if (!outDirInfo.isDir() || !in.startsWith("journalctl_") || !m_commands.contains(in)) {
+        return false;
+    }
+
+    QStringList args = m_commands.value(in).split(" ", QString::SkipEmptyParts);
+    const QString program = args.takeFirst();
+    if (!journalExportArgs(options, args)) {
+        qCWarning(logService) << "invalid journal export options:" << options;
+        return false;
+    }
+    QString outFullPath = outDirInfo.absoluteFilePath() + in + ".log";
+    if (in == "journalctl_app") {
+        const QStringList dirs = outDirInfo.absoluteFilePath().split("/");
+        const QString appName = dirs.at(dirs.size() - 2);
+        outFullPath = outDirInfo.absoluteFilePath() + appName + ".log";
+        args << QString("SYSLOG_IDENTIFIER=%1").arg(appName);
+    }
+
+    int out = ::open(QFile::encodeName(outFullPath).constData(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC | O_NOFOLLOW, 0777);
+    if (out < 0) {
+        qCWarning(logService) << "open export target failed:" << outFullPath << strerror(errno);
+        return false;
+    }
+    QProcess process;
+    process.start(program, args);
+    qint64 written = 0;
+    const bool success = writeProcessOutput(process, out, outFullPath, &written, nullptr);
+    if (fchmod(out, 0777) != 0) {
+        qCWarning(logService) << "chmod export file failed:" << outFullPath << strerror(errno);
+    }
+    ::close(out);
+    return success;
+}
+
+/*!
+ * \~chinese \brief LogViewerService::exportLogFiles 批量导出文件,在进程内复制,不再为每个文件启动一次shell
+ * \~chinese 每复制完一个文件发出exportProgress信号
+ * \~chinese \param outDir 导出目录
+ * \~chinese \param files 要导出的文件路径
+ * \~chinese \param jobId 调用者指定的任务标识,用于区分信号属于哪一次调用
+ * \~chinese \return 每个文件是否导出成功,顺序和files一致;调用者非法或导出目录无效时为空
+ */
+QList<bool> LogViewerService::exportLogFiles(const QString &outDir, const QStringList &files, const QString &jobId)
+{
+    if (!isValidInvoker()) {
+        return QList<bool>();
+    }
+
+    return dispatch<QList<bool>>([this, outDir, files, jobId]() {
+        return runExportLogFiles(outDir, files, jobId);
+    });
+}
+
+/*!
+ * \~chinese \brief LogViewerService::runExportLogFiles 在工作线程中执行exportLogFiles的复制
+ */
+QList<bool> LogViewerService::runExportLogFiles(const QString &outDir, const QStringList &files, const QString &jobId)
+{
+    QList<bool> results;
+    QFileInfo outDirInfo(outDir.endsWith("/") ? outDir : outDir + "/");
+    if (!outDirInfo.isDir()) {
+        qCWarning(logService) << "export dir is invalid:" << outDir;
+        return results;
+    }
+
+    for (int i = 0; i < files.size(); ++i) {
+        const QString &in = files.at(i);
+        bool success = isValidExportFile(in) && copyExportFile(in, outDirInfo.absoluteFilePath() + QFileInfo(in).fileName());
+        results.append(success);
+        //信号和回复都从本线程发出,调用者先收到所有进度再收到回复
+        emit exportProgress(jobId, i, success);
+    }
+    return results;
+}
+
+/*!
+ * \~chinese \brief LogViewerService::hashExportFiles 计算一组待导出文件的内容摘要,调用者据此只导出内容不同的文件
+ * \~chinese 在工作线程中分块读取,和exportLogFiles的路径限制一致
+ * \~chinese \param files 要导出的文件路径
+ * \~chinese \return 和files顺序一致的十六进制SHA-1摘要,不允许导出或读取失败的文件为空;调用者非法时为空列表
+ */
+QStringList LogViewerService::hashExportFiles(const QStringList &files)
+{
+    if (!isValidInvoker()) {
+        return QStringList();
+    }
+
+    return dispatch<QStringList>([files]() {
+        QStringList hashes;
+        for (const QString &in : files) {
+            hashes.append(isValidExportFile(in) ? LogFileStat::contentHash(in) : QString());
+        }
+        return hashes;
+    });
+}
+
+/*!
+ * \~chinese \brief LogViewerService::isValidExportFile 增加服务黑名单，只允许通过提权接口导出/var/log、/var/lib/systemd/coredump下，家目录下和临时目录下的文件
+ * \~chinese \param in 文件路径
+ * \~chinese \return 是否允许导出
+ */
+bool LogViewerService::isValidExportFile(const QString &in)
+{
+    if ((!in.startsWith("/var/log/") && !in.startsWith("/tmp") && !in.startsWith("/home") && !in.startsWith("/var/lib/systemd/coredump"))
+            || in.contains("..")) {
+        return false;
+    }
+    if (!QFileInfo(in).isFile()) {
+        qCWarning(logService) << "in not file:" << in;
+        return false;
+    }
+    return true;
+}
+
+/*!
+ * \~chinese \brief LogViewerService::copyExportFile 在内核中复制文件,优先copy_file_range,不支持时依次退回sendfile和read/write
+ * \~chinese 和之前cp之后chmod 777的结果一致,导出的文件当前用户可以读取和打包
+ * \~chinese \param sourcePath 源文件路径
+ * \~chinese \param targetPath 目标文件路径,已存在时覆盖,是符号链接时失败
+ * \~chinese \return 是否复制成功,失败时删除不完整的目标文件
+ */
+bool LogViewerService::copyExportFile(const QString &sourcePath, const QString &targetPath)
+{
+    int in = ::open(QFile::encodeName(sourcePath).constData(), O_RDONLY | O_CLOEXEC | O_NOCTTY);
+    if (in < 0) {
+        qCWarning(logService) << "open export source failed:" << sourcePath << strerror(errno);
+        return false;
+    }
+    struct stat st;
+    if (fstat(in, &st) != 0 || !S_ISREG(st.st_mode)) {
+        qCWarning(logService) << "export source is not a regular file:" << sourcePath;
+        ::close(in);
+        return false;
+    }
+    int out = ::open(QFile::encodeName(targetPath).constData(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC | O_NOFOLLOW, 0777);
+    if (out < 0) {
+        qCWarning(logService) << "open export target failed:" << targetPath << strerror(errno);
+        ::close(in);
+        return false;
+    }
+
+    bool useCopyRange = true;
+    bool useSendfile = true;
+    bool success = true;
+    QByteArray buffer;
+    while (true) {
+        ssize_t size = -1;
+        if (useCopyRange) {
+            size = copy_file_range(in, nullptr, out, nullptr, EXPORT_COPY_CHUNK, 0);
+            //旧内核不支持或跨文件系统时退回sendfile,文件偏移不变可以直接继续
+            if (size < 0 && (errno == ENOSYS || errno == EXDEV || errno == EINVAL || errno == EOPNOTSUPP || errno == EPERM)) {
+                useCopyRange = false;
+                continue;
+            }
+        } else if (useSendfile) {
+            size = sendfile(out, in, nullptr, EXPORT_COPY_CHUNK);
+            if (size < 0 && (errno == ENOSYS || errno == EINVAL)) {
+                useSendfile = false;
+                continue;
+            }
+        } else {
+            if (buffer.isEmpty()) {
+                buffer.resize(EXPORT_READ_CHUNK);
+            }
+            size = ::read(in, buffer.data(), static_cast<size_t>(buffer.size()));
+            for (ssize_t written = 0; size > 0 && written < size;) {
+                ssize_t r = ::write(out, buffer.constData() + written, static_cast<size_t>(size - written));
+                if (r < 0 && errno != EINTR) {
+                    size = -1;
+                    break;
+                }
+                written += qMax<ssize_t>(r, 0);
+            }
+        }
+        if (size < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            qCWarning(logService) << "copy export file failed:" << sourcePath << strerror(errno);
+            success = false;
+            break;
+        }
+        if (size == 0) {
+            break;
+        }
+    }
+
+    //O_CREAT的权限受umask影响,和之前一样显式设置为777
+    if (success && fchmod(out, 0777) != 0) {
+        qCWarning(logService) << "chmod export file failed:" << targetPath << strerror(errno);
+    }
+    ::close(out);
+    ::close(in);
+    if (!success) {
+        ::unlink(QFile::encodeName(targetPath).constData());
+    }
+    return success;
+}
+
 bool LogViewerService::isValidInvoker()
 {
     bool valid = false;
@@ -457,5 +1659,6 @@ bool LogViewerService::isValidInvoker()
                        .arg((invokerPath)));
         return false;
     }
+    trackCaller();
     return true;
 }
@@ -5,13 +5,29 @@
 #ifndef LOGVIEWERSERVICE_H
 #define LOGVIEWERSERVICE_H
 
+#include "loglinefilter.h"
+#include "logfilestat.h"
+#include "logrecordbatch.h"
+#include "logrecordcache.h"
+
 #include <QObject>
 #include <QDBusContext>
+#include <QDBusUnixFileDescriptor>
 #include <QScopedPointer>
-#include <QProcess>
+#include <QMutex>
+#include <QSet>
 #include <QTemporaryDir>
+#include <QThreadPool>
+
+#include <atomic>
+#include <functional>
 
-class QTextStream;
+class QFile;
+class QFileInfo;
+class QProcess;
+class QTimer;
+class LogGzipInflater;
+class LogViewerWatcher;
 
 class LogViewerService : public QObject
     , protected QDBusContext
@@ -22,7 +38,10 @@ public:
     explicit LogViewerService(QObject *parent = nullptr);
     ~LogViewerService();
 
+    void setClientWatcher(LogViewerWatcher *watcher);
+
 Q_SIGNALS:
+    Q_SCRIPTABLE void exportProgress(const QString &jobId, int index, bool success);
 
 public Q_SLOTS:
     Q_SCRIPTABLE QString readLog(const QString &filePath);
@@ -31,17 +50,119 @@ public Q_SLOTS:
     Q_SCRIPTABLE QStringList getFileInfo(const QString &file, bool unzip = true);
     Q_SCRIPTABLE QStringList getOtherFileInfo(const QString &file, bool unzip = true);
     Q_SCRIPTABLE bool exportLog(const QString &outDir, const QString &in, bool isFile);
+    Q_SCRIPTABLE QList<bool> exportLogFiles(const QString &outDir, const QStringList &files, const QString &jobId);
+    Q_SCRIPTABLE QStringList hashExportFiles(const QStringList &files);
+    Q_SCRIPTABLE QString exportJournalSince(const QString &outDir, const QString &in, const QString &cursor);
+    Q_SCRIPTABLE bool exportJournal(const QString &outDir, const QString &in, const QVariantMap &options);
     Q_SCRIPTABLE QString openLogStream(const QString &filePath);
     Q_SCRIPTABLE QString readLogInStream(const QString &token);
+    Q_SCRIPTABLE QByteArray readLogCompressed(const QString &filePath);
+    Q_SCRIPTABLE QByteArray readLogInStreamCompressed(const QString &token);
+    Q_SCRIPTABLE QString openReverseLogStream(const QString &filePath);
+    Q_SCRIPTABLE QString openFilteredLogStream(const QString &filePath, const QVariantMap &filter);
+    Q_SCRIPTABLE QDBusUnixFileDescriptor openLogFile(const QString &filePath);
+    Q_SCRIPTABLE QString openRecordStream(const QString &filePath, int format, const QVariantMap &filter);
+    Q_SCRIPTABLE LogRecordBatch readRecordBatch(const QString &token);
+    Q_SCRIPTABLE bool closeLogStream(const QString &token);
     Q_SCRIPTABLE bool isFileExist(const QString &filePath);
     Q_SCRIPTABLE quint64 getFileSize(const QString &filePath);
+    Q_SCRIPTABLE QList<LogFileStat> statFiles(const QStringList &paths);
 
 private:
     QTemporaryDir tmpDir;
-    QProcess m_process;
     QString tmpDirPath;
+    //记录调用者,最后一个客户端退出时退出服务
+    LogViewerWatcher *m_clientWatcher = nullptr;
+    //最近一次readLog执行命令的返回值
+    std::atomic_int m_exitCode {0};
+    //耗时请求的工作线程池,请求之间不再互相排队
+    QThreadPool m_workerPool;
     QMap<QString, QString> m_commands;
-    QMap<QString, std::pair<QString, QTextStream*>> m_logMap;
+    /**
+     * @brief The LogStream struct 从文件开头向后按块读取的流式通道,服务端只保留当前块
+     */
+    struct LogStream {
+        QFile *file = nullptr;
+        LogGzipInflater *inflater = nullptr; //压缩日志边读边解压,为空时直接读取file
+        QByteArray buffer;  //命令的输出,file为空时从这里读取
+        qint64 offset = 0;  //下一块的起始位置
+        QByteArray carry;   //已读取但还没有拼成完整行的数据
+        QString owner;      //打开通道的调用者的总线名
+        qint64 lastUsed = 0; //最近一次读取的时间,毫秒
+    };
+    QMap<QString, LogStream> m_logMap;
+    /**
+     * @brief The ReverseLogStream struct 从文件末尾向前按块读取的流式通道
+     */
+    struct ReverseLogStream {
+        QFile *file = nullptr;
+        QByteArray buffer;  //压缩日志解压后的内容,file为空时从这里读取
+        qint64 pos = 0;     //下一块的结束位置,到0表示已读到文件开头
+        QByteArray carry;   //已读取但还没有拼成完整行的数据
+        LogLineFilter filter; //只返回匹配的行
+        int format = LogRecordBatch::InvalidFormat; //记录通道的格式,文本通道为InvalidFormat
+        LogRecordCacheSnapshot cached; //记录通道命中解析缓存时从这里取出记录,不再读取文件
+        int cachedNext = -1; //cached中下一条要返回的记录,从最后一条向前
+        QString owner;      //打开通道的调用者的总线名
+        qint64 lastUsed = 0; //最近一次读取的时间,毫秒
+    };
+    QMap<QString, ReverseLogStream> m_reverseLogMap;
+    //需要root权限的日志的解析缓存,多个客户端和重复打开共用
+    LogRecordCache *m_recordCache = nullptr;
+    //定时关闭长时间没有读取的通道,调用者中途放弃读取时通道不会一直占用内存
+    QTimer *m_streamReaper = nullptr;
+    /**
+     * @brief The UnzipCacheEntry struct 已解压的轮转日志,源文件不变时重复使用
+     */
+    struct UnzipCacheEntry {
+        QString sourcePath; //最近一次解压时的源文件路径,轮转改名后会更新
+        QString filePath;   //解压结果在tmpDir下的路径
+        qint64 mtime = 0;   //源文件修改时间,纳秒
+        qint64 size = 0;    //源文件大小
+        qint64 unzippedSize = 0;
+        quint64 generation = 0; //最近一次被getFileInfo返回的批次,当前批次的结果不能被淘汰
+    };
+    //key为源文件的设备号和inode,轮转改名(如kern.log.2.gz -> kern.log.3.gz)后仍能命中
+    QMap<QString, UnzipCacheEntry> m_unzipCache;
+    qint64 m_unzipCacheSize = 0;
+    quint64 m_unzipGeneration = 0;
+    //还在进行中的请求的批次,它们用到的解压结果不能被淘汰
+    QSet<quint64> m_activeUnzipGenerations;
+    int m_unzipFileNum = 0;
+    //保护解压缓存,查找和解压在工作线程中进行
+    QMutex m_unzipMutex;
+    /**
+     * @brief isValidReadPath 检验要读取的文件路径是否在允许读取的范围内
+     */
+    bool isValidReadPath(const QString &filePath);
+    QByteArray readLogChunk(const QString &token);
+    QByteArray readReverseLogChunk(const QString &token);
+    static QByteArray compressTransfer(const QByteArray &data);
+    bool readReverseLines(ReverseLogStream &stream, QList<QByteArray> &lines);
+    void releaseLogStream(LogStream &stream);
+    QString newStreamToken();
+    QString streamCaller();
+    void trackCaller();
+    bool removeStream(const QString &token);
+    void enforceStreamLimits(const QString &owner, const QString &keepToken);
+    void reapIdleStreams();
+    template <typename T>
+    T dispatch(const std::function<T()> &task);
+    QByteArray readLogContent(const QString &filePath);
+    QStringList collectFileInfo(const QString &file, bool unzip);
+    QStringList collectOtherFileInfo(const QString &file, bool unzip);
+    bool runExportLog(const QString &outDir, const QString &in, bool isFile);
+    QList<bool> runExportLogFiles(const QString &outDir, const QStringList &files, const QString &jobId);
+    QString runExportJournalSince(const QString &outDir, const QString &in, const QString &cursor);
+    bool runExportJournal(const QString &outDir, const QString &in, const QVariantMap &options);
+    static bool journalExportArgs(const QVariantMap &options, QStringList &args);
+    static bool writeProcessOutput(QProcess &process, int out, const QString &outPath, qint64 *written, QByteArray *tail);
+    static bool isValidExportFile(const QString &in);
+    static bool copyExportFile(const QString &sourcePath, const QString &targetPath);
+    QString unzipToCache(const QFileInfo &info, quint64 generation);
+    bool unzipFile(const QString &sourcePath, const QString &outPath, qint64 &unzippedSize);
+    quint64 beginUnzipGeneration();
+    void endUnzipGeneration(quint64 generation);
     /**
      * @brief isValidInvoker 检验调研者是否是日志
      * @return
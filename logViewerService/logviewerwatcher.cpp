@@ -4,39 +4,75 @@
 
 #include "logviewerwatcher.h"
 
-#include <QProcess>
 #include <QCoreApplication>
-#include <QDebug>
+#include <QDBusConnection>
+#include <QDBusConnectionInterface>
+#include <QDBusServiceWatcher>
+#include <QLoggingCategory>
+#include <QTimer>
 
-LogViewerWatcher::LogViewerWatcher():m_Timer(new QTimer (this))
+Q_DECLARE_LOGGING_CATEGORY(logService)
+
+//启动后等待第一个客户端调用的时间,毫秒
+#define CLIENT_WAIT_TIMEOUT (10 * 1000)
+//服务有缓存时最后一个客户端退出后保留的时间,毫秒,期间重新打开界面或运行命令行直接使用缓存
+#define CLIENT_LINGER_TIMEOUT (5 * 60 * 1000)
+
+LogViewerWatcher::LogViewerWatcher(QObject *parent)
+    : QObject(parent)
+    , m_clientWatcher(new QDBusServiceWatcher(this))
+    , m_idleTimer(new QTimer(this))
 {
+    m_clientWatcher->setConnection(QDBusConnection::systemBus());
+    m_clientWatcher->setWatchMode(QDBusServiceWatcher::WatchForUnregistration);
+    connect(m_clientWatcher, &QDBusServiceWatcher::serviceUnregistered, this, &LogViewerWatcher::onClientUnregistered);
 
-    connect(m_Timer,&QTimer::timeout,this,&LogViewerWatcher::onTimeOut);
-    m_Timer->start(1000);
+    m_idleTimer->setSingleShot(true);
+    connect(m_idleTimer, &QTimer::timeout, this, &LogViewerWatcher::onIdleTimeout);
+    m_idleTimer->start(CLIENT_WAIT_TIMEOUT);
 }
 
 /**
- * @brief 定时监控客户端
+ * @brief LogViewerWatcher::addClient 记录调用服务的客户端,之后它退出时收到通知
+ * @param busName 客户端的唯一总线名
  */
-void LogViewerWatcher::onTimeOut()
+void LogViewerWatcher::addClient(const QString &busName)
 {
-    QString cmd, outPut;
-    //判断deepin-log-viewer客户端是否存在，如果不存在退出服务。
-    cmd = QString("ps aux | grep -w deepin-log-viewer$");
-    outPut= executCmd(cmd);
-    int ret = outPut.length();
-    if (!ret)
-        QCoreApplication::exit(0);
+    if (busName.isEmpty() || m_clientWatcher->watchedServices().contains(busName))
+        return;
+
+    m_idleTimer->stop();
+    m_clientWatcher->addWatchedService(busName);
+    //开始监控之前客户端可能已经退出,错过了NameOwnerChanged
+    if (!QDBusConnection::systemBus().interface()->isServiceRegistered(busName).value()) {
+        onClientUnregistered(busName);
+        return;
+    }
+    qCDebug(logService) << "watch client:" << busName;
+}
+
+/**
+ * @brief LogViewerWatcher::onClientUnregistered 客户端退出,没有其他客户端时退出服务,有缓存时延迟退出
+ * @param busName 客户端的唯一总线名
+ */
+void LogViewerWatcher::onClientUnregistered(const QString &busName)
+{
+    m_clientWatcher->removeWatchedService(busName);
+    qCDebug(logService) << "client exited:" << busName;
+    if (!m_clientWatcher->watchedServices().isEmpty())
+        return;
+    if (m_keepAlive && m_keepAlive()) {
+        m_idleTimer->start(CLIENT_LINGER_TIMEOUT);
+        return;
+    }
+    QCoreApplication::exit(0);
 }
 
 /**
- * @brief 执行外部命令
- * @param strCmd:外部命令字符串
+ * @brief LogViewerWatcher::onIdleTimeout 启动后或最后一个客户端退出后一直没有客户端调用
  */
-QString LogViewerWatcher::executCmd(const QString &strCmd)
+void LogViewerWatcher::onIdleTimeout()
 {
-     QProcess proc;
-     proc.start("bash", QStringList() << "-c" << strCmd);
-     proc.waitForFinished(-1);
-     return  proc.readAllStandardOutput();
+    if (m_clientWatcher->watchedServices().isEmpty())
+        QCoreApplication::exit(0);
 }
@@ -6,24 +6,37 @@
 #define LOGVIEWERWATCHER_H
 
 #include <QObject>
-#include <QTimer>
+
+#include <functional>
+
+class QDBusServiceWatcher;
+class QTimer;
 
 /**
  * @class LogViewerWatcher
  * @brief 监控客户端类
+ * 记录调用过服务的客户端总线名,通过NameOwnerChanged得知客户端退出,最后一个客户端退出时立即退出服务;
+ * 空闲时不轮询,也不启动任何进程;服务还有缓存时,最后一个客户端退出后保留一段时间,等待重新打开
  */
 class LogViewerWatcher :public QObject
 {
     Q_OBJECT
 public:
-    explicit LogViewerWatcher();
+    explicit LogViewerWatcher(QObject *parent = nullptr);
+
+    void addClient(const QString &busName);
+    void setKeepAlive(const std::function<bool()> &keepAlive) { m_keepAlive = keepAlive; }
+
+private Q_SLOTS:
+    void onClientUnregistered(const QString &busName);
+    void onIdleTimeout();
 
-public Q_SLOTS:
-    void onTimeOut();
-private:
-    QString executCmd(const QString &strCmd);
 private:
-    QTimer *m_Timer=nullptr;
+    QDBusServiceWatcher *m_clientWatcher = nullptr;
+    //启动后一直没有客户端调用时退出
+    QTimer *m_idleTimer = nullptr;
+    //服务是否有值得保留的状态,如解析缓存
+    std::function<bool()> m_keepAlive;
 };
 
 #endif // LOGVIEWERWATCHER_H
@@ -64,6 +64,7 @@ int main(int argc, char *argv[])
     }
     LogViewerWatcher watcher;
     LogViewerService service;
+    service.setClientWatcher(&watcher);
     if (!systemBus.registerObject(LogViewrPath,
                                   &service,
                                   QDBusConnection::ExportAllSlots | QDBusConnection::ExportAllSignals)) {
@@ -2,45 +2,33 @@
 //
 // SPDX-License-Identifier: GPL-3.0-or-later
 
+#include "logtruncator.h"
+
 #include <QCommandLineParser>
 #include <QCoreApplication>
-#include <QDebug>
-#include <QFile>
-#include <QProcess>
-#include <QString>
 #include <QStringList>
-#include <QThread>
-#include <QDir>
+
 #include <iostream>
 
+/**
+ * 用法: logViewerTruncate <文件|通配符|dmesg>...
+ * 一次提权清空多个目标,每个文件输出一行"释放字节数\t路径",失败的文件释放字节数为-1,有失败时返回1
+ */
 int main(int argc, char *argv[])
 {
     QCoreApplication app(argc, argv);
     QCommandLineParser parser;
     parser.process(app);
-    const QStringList fileList = parser.positionalArguments();
-    if (fileList.count() < 1) {
+    const QStringList targets = parser.positionalArguments();
+    if (targets.isEmpty()) {
         return 0;
     }
-    QStringList arg;
-    if (fileList[0] == "dmesg") {
-        arg << "-c"
-            << "dmesg -C";
-    } else {
-        arg << "-c" << QString("truncate -s 0 %1").arg(fileList[0]);
-    }
 
-    QProcess proc;
-    proc.start("/bin/bash", arg);
-    proc.waitForFinished(-1);
-    //直接
-    QByteArray byte =   proc.readAllStandardOutput();
-    //    QTextStream stream(&byte);
-    //    QByteArray encode;
-    //    stream.setCodec(encode);
-    //    QString str = stream.readAll();
-    //必须要replace \u0000,不然QByteArray会忽略这以后的内容
-    std::cout << byte.replace('\u0000', "").data();
-    proc.close();
+    const QList<LogTruncateResult> results = LogTruncator::truncate(targets);
+    std::cout << LogTruncator::toText(results).constData();
+    for (const LogTruncateResult &result : results) {
+        if (!result.ok)
+            return 1;
+    }
     return 0;
 }
@@ -0,0 +1,191 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "bench_common.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+/**
+ * @brief MicroBench::sizes 本次运行的数据规模,环境变量中无效的数值忽略
+ */
+QList<int> MicroBench::sizes()
+{
+    QByteArray value = qgetenv("LOG_VIEWER_BENCH_SIZES");
+    if (value.isEmpty())
+        value = BENCH_DEFAULT_SIZES;
+    QList<int> result;
+    for (const QByteArray &item : value.split(',')) {
+        bool ok = false;
+        const int size = item.trimmed().toInt(&ok);
+        if (ok && size > 0)
+            result.append(size);
+    }
+    return result;
+}
+
+/**
+ * @brief MicroBench::measure 运行一次fn并计时,结果记入results
+ * @param stage 阶段,如parse、filter、model、export、read
+ * @param name 用例名称,结果中的名称会加上"@规模"
+ * @param size 数据规模,作为记录数和行数
+ * @param fn 被测代码,数据准备不要放在这里
+ * @return 本次的结果
+ */
+LogBenchResult MicroBench::measure(const QString &stage, const QString &name, int size, const std::function<void()> &fn)
+{
+    LogBenchResult result;
+    result.stage = stage;
+    result.name = QString("%1@%2").arg(name).arg(size);
+    result.records = size;
+    result.lines = size;
+
+    LogBenchmark::resetPeakRss();
+    QElapsedTimer timer;
+    timer.start();
+    fn();
+    result.elapsedMs = timer.elapsed();
+    result.peakRssKb = LogBenchmark::peakRssKb();
+    result.ok = true;
+    append(result);
+    return result;
+}
+
+void MicroBench::append(const LogBenchResult &result)
+{
+    qInfo().noquote() << QString("[  BENCH   ] %1 %2 %3 ms").arg(result.stage, -8).arg(result.name, -32).arg(result.elapsedMs);
+    storage().append(result);
+}
+
+const QList<LogBenchResult> &MicroBench::results()
+{
+    return storage();
+}
+
+/**
+ * @brief MicroBench::writeResults 设置了LOG_VIEWER_BENCH_OUTPUT时把全部结果写为json
+ * @return 没有设置或写入成功时返回true
+ */
+bool MicroBench::writeResults()
+{
+    const QString path = QString::fromLocal8Bit(qgetenv(BENCH_OUTPUT_ENV));
+    if (path.isEmpty())
+        return true;
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+    return file.write(LogBenchmark::toJson(results())) > 0;
+}
+
+/**
+ * @brief MicroBench::checkBaseline 设置了LOG_VIEWER_BENCH_BASELINE时和基线比较
+ * 基线文件不存在或要求更新时把本次结果写为基线;基线随机器而不同,应在同一台机器上记录和比较
+ * @return 0没有回退,1有用例超出容差或基线无法读写
+ */
+int MicroBench::checkBaseline()
+{
+    const QString path = QString::fromLocal8Bit(qgetenv(BENCH_BASELINE_ENV));
+    if (path.isEmpty())
+        return 0;
+
+    QFile file(path);
+    if (qgetenv(BENCH_UPDATE_BASELINE_ENV) == "1" || !file.exists()) {
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(LogBenchmark::toJson(results())) <= 0) {
+            qWarning().noquote() << "[  BENCH   ] write baseline failed:" << path;
+            return 1;
+        }
+        qInfo().noquote() << "[  BENCH   ] baseline recorded:" << path;
+        return 0;
+    }
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning().noquote() << "[  BENCH   ] read baseline failed:" << path;
+        return 1;
+    }
+
+    bool ok = false;
+    double tolerance = QString::fromLocal8Bit(qgetenv(BENCH_TOLERANCE_ENV)).toDouble(&ok);
+    if (!ok || tolerance < 0)
+        tolerance = BENCH_DEFAULT_TOLERANCE;
+    const QStringList regressions = compareBaseline(file.readAll(), results(), tolerance);
+    for (const QString &line : regressions)
+        qWarning().noquote() << "[REGRESSED ]" << line;
+    return regressions.isEmpty() ? 0 : 1;
+}
+
+/**
+ * @brief MicroBench::compareBaseline 按阶段和名称对应基线中的用例,比较每条记录的平均耗时,
+ * 这样本机系统日志的条数变化时也能比较;基线中没有的用例和失败的用例不比较
+ * @param baseline LogBenchmark::toJson格式的基线,单个结果可以带tolerancePct覆盖默认容差
+ * @param tolerancePct 默认容差,百分比
+ * @return 超出容差的用例说明,为空表示没有回退
+ */
+QStringList MicroBench::compareBaseline(const QByteArray &baseline, const QList<LogBenchResult> &results, double tolerancePct)
+{
+    struct Base {
+        double msPerRecord;
+        qint64 elapsedMs;
+        double tolerance;
+    };
+    QHash<QString, Base> bases;
+    const QJsonArray array = QJsonDocument::fromJson(baseline).object().value("results").toArray();
+    for (const QJsonValue &value : array) {
+        const QJsonObject obj = value.toObject();
+        if (!obj.value("ok").toBool())
+            continue;
+        const qint64 elapsed = static_cast<qint64>(obj.value("elapsedMs").toDouble());
+        const double records = qMax(1.0, obj.value("records").toDouble());
+        const QJsonValue tolerance = obj.value("tolerancePct");
+        bases.insert(obj.value("stage").toString() + '/' + obj.value("name").toString(),
+                     {elapsed / records, elapsed, tolerance.isDouble() ? tolerance.toDouble() : tolerancePct});
+    }
+
+    QStringList regressions;
+    for (const LogBenchResult &result : results) {
+        auto it = bases.constFind(result.stage + '/' + result.name);
+        if (it == bases.constEnd() || !result.ok)
+            continue;
+        if (it->elapsedMs < BENCH_MIN_COMPARE_MS && result.elapsedMs < BENCH_MIN_COMPARE_MS)
+            continue;
+        const double msPerRecord = static_cast<double>(result.elapsedMs) / qMax<qint64>(1, result.records);
+        const double limit = it->msPerRecord * (1.0 + it->tolerance / 100.0);
+        if (msPerRecord > limit) {
+            regressions.append(QString("%1 %2: %3 ms/record, baseline %4 ms/record, tolerance %5%")
+                                   .arg(result.stage, result.name)
+                                   .arg(msPerRecord, 0, 'g', 4)
+                                   .arg(it->msPerRecord, 0, 'g', 4)
+                                   .arg(it->tolerance));
+        }
+    }
+    return regressions;
+}
+
+/**
+ * @brief MicroBench::generateFile 生成按行编号的测试日志文件
+ * @param line 生成第i行的内容,不含换行符
+ * @return 文件路径
+ */
+QString MicroBench::generateFile(const QString &dir, const QString &fileName, int lines, const std::function<QString(int)> &line)
+{
+    const QString path = QDir(dir).filePath(fileName);
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return QString();
+    for (int i = 0; i < lines; ++i) {
+        file.write(line(i).toUtf8());
+        file.write("\n");
+    }
+    return path;
+}
+
+QList<LogBenchResult> &MicroBench::storage()
+{
+    static QList<LogBenchResult> results;
+    return results;
+}
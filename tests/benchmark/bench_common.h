@@ -0,0 +1,50 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef BENCH_COMMON_H
+#define BENCH_COMMON_H
+
+#include "logbenchmark.h"
+
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+#include <functional>
+
+//默认的数据规模(记录数),可以用环境变量LOG_VIEWER_BENCH_SIZES覆盖,如"1000,100000"
+#define BENCH_DEFAULT_SIZES "1000,10000,100000"
+//结果json的输出路径,不设置时只打印
+#define BENCH_OUTPUT_ENV "LOG_VIEWER_BENCH_OUTPUT"
+//基线json的路径,设置后运行结束时和基线比较,超出容差的用例使进程失败
+#define BENCH_BASELINE_ENV "LOG_VIEWER_BENCH_BASELINE"
+//允许比基线慢的百分比,基线中单个用例的tolerancePct优先
+#define BENCH_TOLERANCE_ENV "LOG_VIEWER_BENCH_TOLERANCE"
+#define BENCH_DEFAULT_TOLERANCE 25.0
+//值为1时用本次结果覆盖基线,不做比较
+#define BENCH_UPDATE_BASELINE_ENV "LOG_VIEWER_BENCH_UPDATE_BASELINE"
+//基线和本次都快于这么多毫秒的用例不比较,计时误差比差异还大
+#define BENCH_MIN_COMPARE_MS 20
+
+/**
+ * @brief The MicroBench class 微基准测试的计时和结果收集
+ * 每个用例在几种数据规模上各运行一次,结果和命令行--bench一样用LogBenchmark::toJson输出,可以直接比较不同提交的数据
+ */
+class MicroBench
+{
+public:
+    static QList<int> sizes();
+    static LogBenchResult measure(const QString &stage, const QString &name, int size, const std::function<void()> &fn);
+    static void append(const LogBenchResult &result);
+    static const QList<LogBenchResult> &results();
+    static bool writeResults();
+    static int checkBaseline();
+    static QStringList compareBaseline(const QByteArray &baseline, const QList<LogBenchResult> &results, double tolerancePct);
+    static QString generateFile(const QString &dir, const QString &fileName, int lines, const std::function<QString(int)> &line);
+
+private:
+    static QList<LogBenchResult> &storage();
+};
+
+#endif // BENCH_COMMON_H
@@ -0,0 +1,289 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "bench_common.h"
+#include "displaycontent.h"
+#include "logtablemodel.h"
+
+#include <gtest/gtest.h>
+
+#include <QDateTime>
+
+namespace {
+//每10条记录中有一条包含搜索关键字
+const QString kSearch = "bench-error";
+
+QString benchMsg(int i)
+{
+    return QString("bench message %1 %2").arg(i).arg(i % 10 ? "ok" : kSearch);
+}
+
+QString benchTime(int i)
+{
+    return QDateTime::fromMSecsSinceEpoch(1688349600000LL + i * 1000LL).toString("yyyy-MM-dd hh:mm:ss");
+}
+
+/**
+ * @brief benchView 在各个规模上依次测试筛选、parseListToModel和insert*Table
+ * @param make 生成第i条记录
+ * @param filter 调用被测的filter*函数
+ * @param insert 调用被测的insert*Table函数
+ */
+template <typename T>
+void benchView(const QString &name, const std::function<T(int)> &make,
+               const std::function<LogRecordView<T>(DisplayContent *, const LogRecordView<T> &)> &filter,
+               const std::function<void(DisplayContent *, const LogRecordView<T> &)> &insert)
+{
+    for (int size : MicroBench::sizes()) {
+        QList<T> list;
+        list.reserve(size);
+        for (int i = 0; i < size; ++i)
+            list.append(make(i));
+        const LogRecordView<T> view(list);
+
+        DisplayContent *content = new DisplayContent(nullptr);
+        LogRecordView<T> filtered;
+        MicroBench::measure("filter", name, size, [&]() { filtered = filter(content, view); });
+        EXPECT_LE(filtered.size(), size);
+
+        LogTableModel model;
+        MicroBench::measure("model", name, size, [&]() { content->parseListToModel(view, &model); });
+        MicroBench::measure("table", name, size, [&]() { insert(content, view); });
+        delete content;
+    }
+}
+}
+
+TEST(DisplayContent_kern_BENCH, DisplayContent_kern_BENCH_001)
+{
+    benchView<LOG_MSG_JOURNAL>("kern", [](int i) {
+        LOG_MSG_JOURNAL msg;
+        msg.dateTime = benchTime(i);
+        msg.hostName = "bench-host";
+        msg.daemonName = "kernel";
+        msg.daemonId = QString::number(i);
+        msg.level = INF;
+        msg.msg = benchMsg(i);
+        return msg;
+    }, [](DisplayContent *content, const LogRecordView<LOG_MSG_JOURNAL> &view) {
+        return content->filterKern(kSearch, view);
+    }, [](DisplayContent *content, const LogRecordView<LOG_MSG_JOURNAL> &view) {
+        content->insertKernTable(view, 0, view.size());
+    });
+}
+
+TEST(DisplayContent_journal_BENCH, DisplayContent_journal_BENCH_001)
+{
+    benchView<LOG_MSG_JOURNAL>("journal", [](int i) {
+        LOG_MSG_JOURNAL msg;
+        msg.dateTime = benchTime(i);
+        msg.hostName = "bench-host";
+        msg.daemonName = "bench-daemon";
+        msg.daemonId = QString::number(i);
+        msg.level = i % 3 ? INF : WARN;
+        msg.msg = benchMsg(i);
+        return msg;
+    }, [](DisplayContent *content, const LogRecordView<LOG_MSG_JOURNAL> &view) {
+        return content->filterJournal(kSearch, view);
+    }, [](DisplayContent *content, const LogRecordView<LOG_MSG_JOURNAL> &view) {
+        content->insertJournalTable(view, 0, view.size());
+    });
+}
+
+TEST(DisplayContent_journalBoot_BENCH, DisplayContent_journalBoot_BENCH_001)
+{
+    benchView<LOG_MSG_JOURNAL>("journalBoot", [](int i) {
+        LOG_MSG_JOURNAL msg;
+        msg.dateTime = benchTime(i);
+        msg.hostName = "bench-host";
+        msg.daemonName = "bench-daemon";
+        msg.daemonId = QString::number(i);
+        msg.level = INF;
+        msg.msg = benchMsg(i);
+        return msg;
+    }, [](DisplayContent *content, const LogRecordView<LOG_MSG_JOURNAL> &view) {
+        return content->filterJournalBoot(kSearch, view);
+    }, [](DisplayContent *content, const LogRecordView<LOG_MSG_JOURNAL> &view) {
+        content->insertJournalBootTable(view, 0, view.size());
+    });
+}
+
+TEST(DisplayContent_dpkg_BENCH, DisplayContent_dpkg_BENCH_001)
+{
+    benchView<LOG_MSG_DPKG>("dpkg", [](int i) {
+        LOG_MSG_DPKG msg;
+        msg.dateTime = benchTime(i);
+        msg.action = "status";
+        msg.msg = benchMsg(i);
+        return msg;
+    }, [](DisplayContent *content, const LogRecordView<LOG_MSG_DPKG> &view) {
+        return content->filterDpkg(kSearch, view);
+    }, [](DisplayContent *content, const LogRecordView<LOG_MSG_DPKG> &view) {
+        content->insertDpkgTable(view, 0, view.size());
+    });
+}
+
+TEST(DisplayContent_boot_BENCH, DisplayContent_boot_BENCH_001)
+{
+    benchView<LOG_MSG_BOOT>("boot", [](int i) {
+        LOG_MSG_BOOT msg;
+        msg.status = i % 10 ? "OK" : "Failed";
+        msg.msg = benchMsg(i);
+        return msg;
+    }, [](DisplayContent *content, const LogRecordView<LOG_MSG_BOOT> &view) {
+        BOOT_FILTERS filter;
+        filter.searchstr = kSearch;
+        return content->filterBoot(filter, view);
+    }, [](DisplayContent *content, const LogRecordView<LOG_MSG_BOOT> &view) {
+        content->insertBootTable(view, 0, view.size());
+    });
+}
+
+TEST(DisplayContent_xorg_BENCH, DisplayContent_xorg_BENCH_001)
+{
+    benchView<LOG_MSG_XORG>("xorg", [](int i) {
+        LOG_MSG_XORG msg;
+        msg.offset = QString::number(i / 1000.0, 'f', 3);
+        msg.msg = benchMsg(i);
+        return msg;
+    }, [](DisplayContent *content, const LogRecordView<LOG_MSG_XORG> &view) {
+        return content->filterXorg(kSearch, view);
+    }, [](DisplayContent *content, const LogRecordView<LOG_MSG_XORG> &view) {
+        content->insertXorgTable(view, 0, view.size());
+    });
+}
+
+TEST(DisplayContent_kwin_BENCH, DisplayContent_kwin_BENCH_001)
+{
+    benchView<LOG_MSG_KWIN>("kwin", [](int i) {
+        LOG_MSG_KWIN msg;
+        msg.msg = benchMsg(i);
+        return msg;
+    }, [](DisplayContent *content, const LogRecordView<LOG_MSG_KWIN> &view) {
+        return content->filterKwin(kSearch, view);
+    }, [](DisplayContent *content, const LogRecordView<LOG_MSG_KWIN> &view) {
+        content->insertKwinTable(view, 0, view.size());
+    });
+}
+
+TEST(DisplayContent_normal_BENCH, DisplayContent_normal_BENCH_001)
+{
+    benchView<LOG_MSG_NORMAL>("normal", [](int i) {
+        LOG_MSG_NORMAL msg;
+        msg.eventType = i % 2 ? "Login" : "Boot";
+        msg.userName = "bench";
+        msg.dateTime = benchTime(i);
+        msg.msg = benchMsg(i);
+        return msg;
+    }, [](DisplayContent *content, const LogRecordView<LOG_MSG_NORMAL> &view) {
+        NORMAL_FILTERS filter;
+        filter.searchstr = kSearch;
+        return content->filterNomal(filter, view);
+    }, [](DisplayContent *content, const LogRecordView<LOG_MSG_NORMAL> &view) {
+        content->insertNormalTable(view, 0, view.size());
+    });
+}
+
+TEST(DisplayContent_app_BENCH, DisplayContent_app_BENCH_001)
+{
+    benchView<LOG_MSG_APPLICATOIN>("app", [](int i) {
+        LOG_MSG_APPLICATOIN msg;
+        msg.dateTime = benchTime(i);
+        msg.level = INF;
+        msg.src = "bench";
+        msg.msg = benchMsg(i);
+        msg.detailInfo = msg.msg;
+        return msg;
+    }, [](DisplayContent *content, const LogRecordView<LOG_MSG_APPLICATOIN> &view) {
+        return content->filterApp(kSearch, view);
+    }, [](DisplayContent *content, const LogRecordView<LOG_MSG_APPLICATOIN> &view) {
+        content->insertApplicationTable(view, 0, view.size());
+    });
+}
+
+TEST(DisplayContent_ooc_BENCH, DisplayContent_ooc_BENCH_001)
+{
+    benchView<LOG_FILE_OTHERORCUSTOM>("ooc", [](int i) {
+        LOG_FILE_OTHERORCUSTOM msg;
+        msg.name = QString("bench-%1.log").arg(i % 10 ? "ok" : kSearch);
+        msg.path = QString("/var/log/bench/%1.log").arg(i);
+        msg.dateTimeModify = benchTime(i);
+        return msg;
+    }, [](DisplayContent *content, const LogRecordView<LOG_FILE_OTHERORCUSTOM> &view) {
+        return content->filterOOC(kSearch, view);
+    }, [](DisplayContent *content, const LogRecordView<LOG_FILE_OTHERORCUSTOM> &view) {
+        content->insertOOCTable(view, 0, view.size());
+    });
+}
+
+TEST(DisplayContent_audit_BENCH, DisplayContent_audit_BENCH_001)
+{
+    benchView<LOG_MSG_AUDIT>("audit", [](int i) {
+        LOG_MSG_AUDIT msg;
+        msg.auditType = Audit_Other;
+        msg.eventType = "SYSCALL";
+        msg.dateTime = benchTime(i);
+        msg.processName = "bench";
+        msg.processId = QString::number(i);
+        msg.status = "yes";
+        msg.msg = benchMsg(i);
+        msg.origin = msg.msg;
+        return msg;
+    }, [](DisplayContent *content, const LogRecordView<LOG_MSG_AUDIT> &view) {
+        AUDIT_FILTERS filter;
+        filter.searchstr = kSearch;
+        return content->filterAudit(filter, view);
+    }, [](DisplayContent *content, const LogRecordView<LOG_MSG_AUDIT> &view) {
+        content->insertAuditTable(view, 0, view.size());
+    });
+}
+
+TEST(DisplayContent_coredump_BENCH, DisplayContent_coredump_BENCH_001)
+{
+    benchView<LOG_MSG_COREDUMP>("coredump", [](int i) {
+        LOG_MSG_COREDUMP msg;
+        msg.sig = "11";
+        msg.dateTime = benchTime(i);
+        msg.coreFile = "present";
+        msg.uid = "1000";
+        msg.exe = QString("/usr/bin/bench-%1").arg(i % 10 ? "ok" : kSearch);
+        msg.pid = QString::number(i);
+        return msg;
+    }, [](DisplayContent *content, const LogRecordView<LOG_MSG_COREDUMP> &view) {
+        return content->filterCoredump(kSearch, view);
+    }, [](DisplayContent *content, const LogRecordView<LOG_MSG_COREDUMP> &view) {
+        content->insertCoredumpTable(view, 0, view.size());
+    });
+}
+
+TEST(DisplayContent_dnf_BENCH, DisplayContent_dnf_BENCH_001)
+{
+    //dnf和dmesg按等级和时间在解析线程中筛选,没有filter*函数
+    benchView<LOG_MSG_DNF>("dnf", [](int i) {
+        LOG_MSG_DNF msg;
+        msg.dateTime = benchTime(i);
+        msg.level = INFO;
+        msg.msg = benchMsg(i);
+        return msg;
+    }, [](DisplayContent *, const LogRecordView<LOG_MSG_DNF> &view) {
+        return view;
+    }, [](DisplayContent *content, const LogRecordView<LOG_MSG_DNF> &view) {
+        content->insertDnfTable(view, 0, view.size());
+    });
+}
+
+TEST(DisplayContent_dmesg_BENCH, DisplayContent_dmesg_BENCH_001)
+{
+    benchView<LOG_MSG_DMESG>("dmesg", [](int i) {
+        LOG_MSG_DMESG msg;
+        msg.level = INF;
+        msg.dateTime = benchTime(i);
+        msg.msg = benchMsg(i);
+        return msg;
+    }, [](DisplayContent *, const LogRecordView<LOG_MSG_DMESG> &view) {
+        return view;
+    }, [](DisplayContent *content, const LogRecordView<LOG_MSG_DMESG> &view) {
+        content->insertDmesgTable(view, 0, view.size());
+    });
+}
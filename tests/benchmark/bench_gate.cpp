@@ -0,0 +1,152 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "bench_common.h"
+#include "corpus/logcorpusgenerator.h"
+#include "dbusproxy/dldbushandler.h"
+#include "displaycontent.h"
+#include "journalreader.h"
+#include "logbenchmark.h"
+
+#include <stub.h>
+
+#include <gtest/gtest.h>
+
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QProcess>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+#include <QThread>
+
+/**
+ * 性能回退门禁,ctest -L perf运行,只运行PerfGate开头的用例:
+ * 合成语料上的journal读取、kern/audit解析及txt/xls导出、百万行搜索;
+ * 规模固定,结果和LOG_VIEWER_BENCH_BASELINE指定的基线比较
+ */
+
+//门禁的数据规模,可以用环境变量覆盖
+#define PERF_GATE_PARSE_ROWS_ENV "LOG_VIEWER_PERF_PARSE_ROWS"
+#define PERF_GATE_PARSE_ROWS 200000
+#define PERF_GATE_SEARCH_ROWS_ENV "LOG_VIEWER_PERF_SEARCH_ROWS"
+#define PERF_GATE_SEARCH_ROWS 1000000
+#define PERF_GATE_JOURNAL_ROWS_ENV "LOG_VIEWER_PERF_JOURNAL_ROWS"
+#define PERF_GATE_JOURNAL_ROWS 100000
+
+namespace {
+int gateRows(const char *env, int fallback)
+{
+    bool ok = false;
+    const int rows = qgetenv(env).toInt(&ok);
+    return ok && rows > 0 ? rows : fallback;
+}
+
+QStringList stub_gateGetFileInfo(const QString &flag, bool unzip)
+{
+    Q_UNUSED(unzip)
+    return QStringList() << flag;
+}
+
+//systemd-journal-remote把导出格式转换为journal文件,不在PATH中
+QString journalRemotePath()
+{
+    for (const QString &path : {QStringLiteral("/lib/systemd/systemd-journal-remote"), QStringLiteral("/usr/lib/systemd/systemd-journal-remote")}) {
+        if (QFileInfo(path).isExecutable())
+            return path;
+    }
+    return QStandardPaths::findExecutable("systemd-journal-remote");
+}
+}
+
+TEST(PerfGate_journal_BENCH, PerfGate_journal_BENCH_001)
+{
+    const QString remote = journalRemotePath();
+    if (remote.isEmpty()) {
+        qWarning() << "systemd-journal-remote not found, journal ingest is not gated";
+        return;
+    }
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    LogCorpusOptions options;
+    options.records = gateRows(PERF_GATE_JOURNAL_ROWS_ENV, PERF_GATE_JOURNAL_ROWS);
+    LogCorpusGenerator generator(options);
+    const QStringList exports = generator.generate(LogCorpusGenerator::Journal, dir.path());
+    ASSERT_FALSE(exports.isEmpty());
+    const QString journal = QDir(dir.path()).filePath("corpus.journal");
+    ASSERT_EQ(QProcess::execute(remote, QStringList() << "-o" << journal << exports.first()), 0);
+
+    JournalReadOptions readOptions;
+    readOptions.files << journal;
+    readOptions.threads = QThread::idealThreadCount();
+    std::atomic_bool canRun(true);
+    SystemJournalPolicy policy;
+    policy.lazyMessage = true;
+
+    int count = 0;
+    MicroBench::measure("parse", "journal", static_cast<int>(options.records), [&]() {
+        JournalReader<SystemJournalPolicy> reader(policy, canRun);
+        QList<LOG_MSG_JOURNAL> batch;
+        count = reader.read(readOptions, batch, [](QList<LOG_MSG_JOURNAL> &) {});
+    });
+    EXPECT_EQ(count, options.records);
+}
+
+/**
+ * kern和audit的解析,解析结果导出为txt和xls
+ */
+TEST(PerfGate_parseExport_BENCH, PerfGate_parseExport_BENCH_001)
+{
+    Stub stub;
+    stub.set(ADDR(DLDBusHandler, getFileInfo), stub_gateGetFileInfo);
+
+    const int rows = gateRows(PERF_GATE_PARSE_ROWS_ENV, PERF_GATE_PARSE_ROWS);
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    LogCorpusOptions options;
+    options.records = rows;
+    for (LogCorpusGenerator::Kind kind : {LogCorpusGenerator::Kern, LogCorpusGenerator::Audit}) {
+        LogCorpusGenerator generator(options);
+        ASSERT_FALSE(generator.generate(kind, dir.path()).isEmpty());
+    }
+
+    LogBenchmark bench;
+    bench.setExportFormats({LogBenchmark::BenchTxt, LogBenchmark::BenchXls});
+    ASSERT_TRUE(bench.addPath(dir.path()));
+    EXPECT_TRUE(bench.run());
+    for (LogBenchResult result : bench.results()) {
+        EXPECT_TRUE(result.ok) << result.name.toStdString();
+        result.name = QString("%1@%2").arg(result.name).arg(rows);
+        MicroBench::append(result);
+    }
+}
+
+/**
+ * 百万行上的关键字搜索,和界面搜索使用同一个筛选函数
+ */
+TEST(PerfGate_search_BENCH, PerfGate_search_BENCH_001)
+{
+    const int rows = gateRows(PERF_GATE_SEARCH_ROWS_ENV, PERF_GATE_SEARCH_ROWS);
+    QList<LOG_MSG_JOURNAL> list;
+    list.reserve(rows);
+    for (int i = 0; i < rows; ++i) {
+        LOG_MSG_JOURNAL msg;
+        msg.dateTime = QDateTime::fromMSecsSinceEpoch(1688349600000LL + i * 1000LL).toString("yyyy-MM-dd hh:mm:ss");
+        msg.hostName = "bench-host";
+        msg.daemonName = "kernel";
+        msg.daemonId = QString::number(i % 1000);
+        msg.level = INF;
+        msg.msg = QString("bench message %1 %2").arg(i).arg(i % 100 ? "ok" : "gate-needle");
+        list.append(msg);
+    }
+    const LogRecordView<LOG_MSG_JOURNAL> view(list);
+
+    DisplayContent *content = new DisplayContent(nullptr);
+    LogRecordView<LOG_MSG_JOURNAL> found;
+    MicroBench::measure("search", "kern", rows, [&]() { found = content->filterKern("gate-needle", view); });
+    EXPECT_EQ(found.size(), (rows + 99) / 100);
+    MicroBench::measure("search", "journal", rows, [&]() { found = content->filterJournal("gate-needle", view); });
+    EXPECT_EQ(found.size(), (rows + 99) / 100);
+    delete content;
+}
@@ -0,0 +1,26 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "bench_common.h"
+#include "utils.h"
+
+#include <gtest/gtest.h>
+
+#include <QApplication>
+
+int main(int argc, char *argv[])
+{
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+    QApplication a(argc, argv);
+    //和命令行--bench一致,解析线程直接读取文件,不经过pkexec
+    Utils::runInCmd = true;
+
+    testing::InitGoogleTest(&argc, argv);
+    int ret = RUN_ALL_TESTS();
+    if (!MicroBench::writeResults())
+        ret = 1;
+    if (MicroBench::checkBaseline() != 0)
+        ret = 1;
+    return ret;
+}
@@ -0,0 +1,69 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "bench_common.h"
+#include "corpus/logcorpusgenerator.h"
+#include "dbusproxy/dldbushandler.h"
+#include "logbenchmark.h"
+
+#include <stub.h>
+
+#include <gtest/gtest.h>
+
+#include <QTemporaryDir>
+
+namespace {
+//应用日志的文件列表由服务按路径查找,基准测试直接使用生成的文件
+QStringList stub_benchGetFileInfo(const QString &flag, bool unzip)
+{
+    Q_UNUSED(unzip)
+    return QStringList() << flag;
+}
+
+/**
+ * @brief generateInputs 生成各个解析器的输入文件,文件名和LogBenchmark::typeForFile的识别规则一致
+ * 有生成器的种类按真实格式生成,boot和dnf日志格式简单,直接按行生成
+ */
+void generateInputs(const QString &dir, int size)
+{
+    LogCorpusOptions options;
+    options.records = size;
+    for (LogCorpusGenerator::Kind kind : {LogCorpusGenerator::Kern, LogCorpusGenerator::Dpkg, LogCorpusGenerator::Audit,
+                                          LogCorpusGenerator::Xorg, LogCorpusGenerator::App}) {
+        LogCorpusGenerator generator(options);
+        generator.generate(kind, dir);
+    }
+    MicroBench::generateFile(dir, "boot.log", size, [](int i) {
+        return QString("[  %1  ] Started Bench Service %2.").arg(i % 10 ? "OK" : "FAILED").arg(i);
+    });
+    MicroBench::generateFile(dir, "dnf.log", size, [](int i) {
+        return QString("2023-07-03T10:%1:%2+0800 %3 bench dnf message %4")
+            .arg(i / 60 % 60, 2, 10, QChar('0')).arg(i % 60, 2, 10, QChar('0')).arg(i % 5 ? "INFO" : "DEBUG").arg(i);
+    });
+}
+}
+
+/**
+ * 每种解析器在各个规模上解析一次,解析结果再按txt、ndjson、html、doc、xls导出,
+ * 复用命令行--bench的流程,只是输入换成生成的数据
+ */
+TEST(LogBenchmark_parseAndExport_BENCH, LogBenchmark_parseAndExport_BENCH_001)
+{
+    Stub stub;
+    stub.set(ADDR(DLDBusHandler, getFileInfo), stub_benchGetFileInfo);
+
+    for (int size : MicroBench::sizes()) {
+        QTemporaryDir dir;
+        ASSERT_TRUE(dir.isValid());
+        generateInputs(dir.path(), size);
+
+        LogBenchmark bench;
+        ASSERT_TRUE(bench.addPath(dir.path()));
+        EXPECT_TRUE(bench.run());
+        for (LogBenchResult result : bench.results()) {
+            result.name = QString("%1@%2").arg(result.name).arg(size);
+            MicroBench::append(result);
+        }
+    }
+}
@@ -0,0 +1,133 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "bench_common.h"
+#include "dbusproxy/dldbushandler.h"
+#include "loglinestream.h"
+
+#include <stub.h>
+
+#include <gtest/gtest.h>
+
+#include <QTemporaryDir>
+
+namespace {
+//服务端倒序通道每块的行数,和服务的分块大小相近
+const int kStreamChunkLines = 8192;
+QStringList s_streamChunks;
+int s_streamIndex = 0;
+QString s_wholeFile;
+
+QString benchLine(int i)
+{
+    return QString("2023-07-03 10:00:00.000 [Info   ] [bench.cpp main %1] bench read line %1").arg(i);
+}
+
+QDBusUnixFileDescriptor stub_benchOpenLogFileFail(const QString &filePath)
+{
+    Q_UNUSED(filePath)
+    return QDBusUnixFileDescriptor();
+}
+
+QString stub_benchOpenReverseLogStream(const QString &filePath)
+{
+    Q_UNUSED(filePath)
+    s_streamIndex = 0;
+    return "bench-token";
+}
+
+QString stub_benchOpenReverseLogStreamFail(const QString &filePath)
+{
+    Q_UNUSED(filePath)
+    return QString();
+}
+
+QString stub_benchReadLogInStream(const QString &token)
+{
+    Q_UNUSED(token)
+    return s_streamIndex < s_streamChunks.size() ? s_streamChunks.at(s_streamIndex++) : QString();
+}
+
+QString stub_benchReadLog(const QString &filePath)
+{
+    Q_UNUSED(filePath)
+    return s_wholeFile;
+}
+
+/**
+ * @brief prepareServiceData 准备服务端返回的数据:倒序通道的各块(从新到旧)和整个文件读取的内容
+ */
+void prepareServiceData(int size)
+{
+    s_streamChunks.clear();
+    QStringList lines;
+    for (int i = 0; i < size; ++i)
+        lines.append(benchLine(i));
+    s_wholeFile = lines.join('\n');
+    for (int end = size; end > 0; end -= kStreamChunkLines) {
+        QStringList chunk;
+        for (int i = end - 1; i >= qMax(0, end - kStreamChunkLines); --i)
+            chunk.append(lines.at(i));
+        s_streamChunks.append(chunk.join('\n'));
+    }
+}
+
+qint64 readAll(LogLineStream &stream)
+{
+    qint64 count = 0;
+    QStringList lines;
+    while (stream.readChunk(lines))
+        count += lines.size();
+    return count;
+}
+}
+
+/**
+ * 进程内映射读取,当前用户可读的文件不经过服务
+ */
+TEST(LogLineStream_readLocal_BENCH, LogLineStream_readLocal_BENCH_001)
+{
+    for (int size : MicroBench::sizes()) {
+        QTemporaryDir dir;
+        ASSERT_TRUE(dir.isValid());
+        const QString path = MicroBench::generateFile(dir.path(), "bench-read.log", size, benchLine);
+        qint64 count = 0;
+        MicroBench::measure("read", "local", size, [&]() {
+            LogLineStream stream(path);
+            count = readAll(stream);
+        });
+        EXPECT_EQ(count, size);
+    }
+}
+
+/**
+ * 通过服务的倒序通道和整个文件读取,服务端返回的内容已准备好,只测客户端解码和分行的开销;
+ * 服务进程的代码不编译到测试中
+ */
+TEST(LogLineStream_readService_BENCH, LogLineStream_readService_BENCH_001)
+{
+    Stub stub;
+    stub.set(ADDR(DLDBusHandler, openLogFile), stub_benchOpenLogFileFail);
+    stub.set(ADDR(DLDBusHandler, readLogInStream), stub_benchReadLogInStream);
+    stub.set(ADDR(DLDBusHandler, readLog), stub_benchReadLog);
+
+    for (int size : MicroBench::sizes()) {
+        prepareServiceData(size);
+        qint64 count = 0;
+
+        stub.set(ADDR(DLDBusHandler, openReverseLogStream), stub_benchOpenReverseLogStream);
+        MicroBench::measure("read", "serviceStream", size, [&]() {
+            LogLineStream stream("/var/log/not-exist-bench.log");
+            count = readAll(stream);
+        });
+        EXPECT_EQ(count, size);
+
+        stub.set(ADDR(DLDBusHandler, openReverseLogStream), stub_benchOpenReverseLogStreamFail);
+        MicroBench::measure("read", "serviceWholeFile", size, [&]() {
+            LogLineStream stream("/var/log/not-exist-bench.log");
+            count = readAll(stream);
+        });
+        EXPECT_EQ(count, size);
+    }
+}
@@ -0,0 +1,267 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "bench_common.h"
+#include "displaycontent.h"
+#include "logtablemodel.h"
+#include "logtreeview.h"
+#include "logviewitemdelegate.h"
+
+#include <gtest/gtest.h>
+
+#include <QApplication>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QHeaderView>
+#include <QScrollBar>
+
+#include <algorithm>
+
+namespace {
+//每种操作的帧数:滚轮滚动、整页跳转和调整列宽
+const int kScrollFrames = 300;
+const int kJumpFrames = 60;
+const int kResizeFrames = 40;
+//滚轮一格滚动的行数,和Qt默认的wheelScrollLines一致
+const int kWheelRows = 3;
+//视图大小,和默认窗口中表格区域的大小接近
+const QSize kViewSize(1000, 620);
+
+/**
+ * @brief The RenderCost struct 一段操作中各绘制环节的累计耗时(纳秒)和调用次数,只在界面线程中更新
+ * drawRow包含其中各单元格的paint,paint包含其中的data调用
+ */
+struct RenderCost {
+    qint64 drawRowNs = 0;
+    qint64 drawRows = 0;
+    qint64 paintNs = 0;
+    qint64 paints = 0;
+    qint64 dataNs = 0;
+    qint64 datas = 0;
+};
+RenderCost s_cost;
+
+class TimedModel : public LogTableModel
+{
+public:
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override
+    {
+        QElapsedTimer timer;
+        timer.start();
+        QVariant value = LogTableModel::data(index, role);
+        s_cost.dataNs += timer.nsecsElapsed();
+        ++s_cost.datas;
+        return value;
+    }
+};
+
+class TimedDelegate : public LogViewItemDelegate
+{
+public:
+    explicit TimedDelegate(QObject *parent)
+        : LogViewItemDelegate(parent)
+    {
+    }
+
+    void paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const override
+    {
+        QElapsedTimer timer;
+        timer.start();
+        LogViewItemDelegate::paint(painter, option, index);
+        s_cost.paintNs += timer.nsecsElapsed();
+        ++s_cost.paints;
+    }
+};
+
+class TimedTreeView : public LogTreeView
+{
+public:
+    TimedTreeView()
+    {
+        //替换LogTreeView自带的委托,绘制逻辑不变
+        setItemDelegate(new TimedDelegate(this));
+    }
+
+protected:
+    void drawRow(QPainter *painter, const QStyleOptionViewItem &options, const QModelIndex &index) const override
+    {
+        QElapsedTimer timer;
+        timer.start();
+        LogTreeView::drawRow(painter, options, index);
+        s_cost.drawRowNs += timer.nsecsElapsed();
+        ++s_cost.drawRows;
+    }
+};
+
+QString benchMsg(int i)
+{
+    return QString("bench message %1 with some longer text that has to be elided in narrow columns %2").arg(i).arg(i % 10 ? "ok" : "error");
+}
+
+QString benchTime(int i)
+{
+    return QDateTime::fromMSecsSinceEpoch(1688349600000LL + i * 1000LL).toString("yyyy-MM-dd hh:mm:ss");
+}
+
+qint64 percentile(QVector<qint64> frames, double pct)
+{
+    if (frames.isEmpty())
+        return 0;
+    std::sort(frames.begin(), frames.end());
+    const int index = qBound(0, static_cast<int>(frames.size() * pct / 100.0), frames.size() - 1);
+    return frames.at(index);
+}
+
+void appendResult(const QString &name, int size, qint64 count, qint64 ns)
+{
+    LogBenchResult result;
+    result.stage = "render";
+    result.name = QString("%1@%2").arg(name).arg(size);
+    result.records = size;
+    result.lines = count;
+    result.elapsedMs = ns / 1000000;
+    result.ok = true;
+    MicroBench::append(result);
+}
+
+/**
+ * @brief runFrames 执行count次操作,每次操作后同步重绘整个视口,记录每帧的耗时和各绘制环节的累计耗时
+ * 结果中name.frame为全部帧的总耗时,p50、p95、max为单帧耗时,paint、drawRow、data为各环节的累计耗时
+ */
+void runFrames(TimedTreeView &view, const QString &name, int size, int count, const std::function<void(int)> &step)
+{
+    QVector<qint64> frames;
+    frames.reserve(count);
+    s_cost = RenderCost();
+    qint64 total = 0;
+    for (int i = 0; i < count; ++i) {
+        QElapsedTimer timer;
+        timer.start();
+        step(i);
+        //滚动和调整列宽引起的布局在下一次事件循环中进行,也算在这一帧里
+        QCoreApplication::processEvents();
+        view.viewport()->repaint();
+        frames.append(timer.nsecsElapsed());
+        total += frames.last();
+    }
+    appendResult(name + ".frame", size, count, total);
+    appendResult(name + ".p50", size, count, percentile(frames, 50));
+    appendResult(name + ".p95", size, count, percentile(frames, 95));
+    appendResult(name + ".max", size, count, percentile(frames, 100));
+    appendResult(name + ".drawRow", size, s_cost.drawRows, s_cost.drawRowNs);
+    appendResult(name + ".paint", size, s_cost.paints, s_cost.paintNs);
+    appendResult(name + ".data", size, s_cost.datas, s_cost.dataNs);
+    qInfo().noquote() << QString("[  BENCH   ] render   %1@%2 frames=%3 p50=%4us p95=%5us max=%6us drawRow=%7 paint=%8 data=%9")
+                         .arg(name).arg(size).arg(count)
+                         .arg(percentile(frames, 50) / 1000).arg(percentile(frames, 95) / 1000).arg(percentile(frames, 100) / 1000)
+                         .arg(s_cost.drawRows).arg(s_cost.paints).arg(s_cost.datas);
+}
+
+/**
+ * @brief benchRender 在各个规模上把记录填入model,在离屏的表格中依次测试滚轮滚动、整页跳转和调整列宽
+ * @param make 生成第i条记录
+ */
+template <typename T>
+void benchRender(const QString &name, const std::function<T(int)> &make)
+{
+    for (int size : MicroBench::sizes()) {
+        QList<T> list;
+        list.reserve(size);
+        for (int i = 0; i < size; ++i)
+            list.append(make(i));
+
+        DisplayContent content(nullptr);
+        TimedModel model;
+        content.parseListToModel(LogRecordView<T>(list), &model);
+        ASSERT_EQ(model.rowCount(), size);
+
+        TimedTreeView view;
+        view.setModel(&model);
+        view.resize(kViewSize);
+        view.show();
+        QCoreApplication::processEvents();
+        view.viewport()->repaint();
+
+        QScrollBar *bar = view.verticalScrollBar();
+        const int rowHeight = qMax(1, view.singleRowHeight());
+        runFrames(view, name + ".scroll", size, kScrollFrames, [bar, rowHeight](int) {
+            bar->setValue(bar->value() + kWheelRows * rowHeight);
+        });
+        //跳转位置按固定的伪随机序列分布在整个范围内,每次运行相同
+        quint32 seed = 20230701;
+        runFrames(view, name + ".jump", size, kJumpFrames, [bar, &seed](int) {
+            seed = seed * 1103515245u + 12345u;
+            bar->setValue(bar->maximum() > 0 ? static_cast<int>(seed % static_cast<quint32>(bar->maximum() + 1)) : 0);
+        });
+        QHeaderView *header = view.header();
+        const int columns = qMax(1, header->count() - 1);
+        runFrames(view, name + ".resize", size, kResizeFrames, [header, columns](int i) {
+            const int column = i % columns;
+            header->resizeSection(column, header->sectionSize(column) + ((i / columns) % 2 ? -40 : 40));
+        });
+        view.setModel(nullptr);
+    }
+}
+}
+
+TEST(LogTreeView_journal_BENCH, LogTreeView_journal_BENCH_001)
+{
+    benchRender<LOG_MSG_JOURNAL>("journal", [](int i) {
+        LOG_MSG_JOURNAL msg;
+        msg.dateTime = benchTime(i);
+        msg.hostName = "bench-host";
+        msg.daemonName = "bench-daemon";
+        msg.daemonId = QString::number(i);
+        msg.level = i % 3 ? INF : WARN;
+        msg.msg = benchMsg(i);
+        return msg;
+    });
+}
+
+TEST(LogTreeView_dpkg_BENCH, LogTreeView_dpkg_BENCH_001)
+{
+    benchRender<LOG_MSG_DPKG>("dpkg", [](int i) {
+        LOG_MSG_DPKG msg;
+        msg.dateTime = benchTime(i);
+        msg.action = "status";
+        msg.msg = benchMsg(i);
+        return msg;
+    });
+}
+
+TEST(LogTreeView_app_BENCH, LogTreeView_app_BENCH_001)
+{
+    benchRender<LOG_MSG_APPLICATOIN>("app", [](int i) {
+        LOG_MSG_APPLICATOIN msg;
+        msg.dateTime = benchTime(i);
+        msg.level = INF;
+        msg.src = "bench";
+        msg.msg = benchMsg(i);
+        msg.detailInfo = msg.msg;
+        return msg;
+    });
+}
+
+TEST(LogTreeView_normal_BENCH, LogTreeView_normal_BENCH_001)
+{
+    benchRender<LOG_MSG_NORMAL>("normal", [](int i) {
+        LOG_MSG_NORMAL msg;
+        msg.eventType = i % 2 ? "Login" : "Boot";
+        msg.userName = "bench";
+        msg.dateTime = benchTime(i);
+        msg.msg = benchMsg(i);
+        return msg;
+    });
+}
+
+TEST(LogTreeView_dmesg_BENCH, LogTreeView_dmesg_BENCH_001)
+{
+    benchRender<LOG_MSG_DMESG>("dmesg", [](int i) {
+        LOG_MSG_DMESG msg;
+        msg.level = INF;
+        msg.dateTime = benchTime(i);
+        msg.msg = benchMsg(i);
+        return msg;
+    });
+}
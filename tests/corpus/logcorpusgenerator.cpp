@@ -0,0 +1,407 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logcorpusgenerator.h"
+#include "loggzipwriter.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+
+#include <stdio.h>
+#include <string.h>
+#include <utmp.h>
+
+namespace {
+const char *const kWords[] = {
+    "usb", "device", "connected", "disconnected", "failed", "timeout", "session", "started", "stopped", "service",
+    "network", "interface", "link", "up", "down", "memory", "allocation", "thread", "request", "response",
+    "config", "loaded", "reload", "cache", "miss", "hit", "display", "output", "mode", "set",
+    "audio", "sink", "source", "volume", "bluetooth", "adapter", "power", "suspend", "resume", "battery",
+    "0x7f3a", "pid=1234", "uid=1000", "/usr/lib/x86_64-linux-gnu", "/home/bench/.config", "ok", "error", "warning",
+    "日志", "设备", "连接", "失败", "服务", "启动"
+};
+const char *const kMonths[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+const char *const kPackages[] = {"libc6", "libqt5core5a", "dde-dock", "deepin-log-viewer", "systemd", "openssl", "xserver-xorg-core", "linux-image"};
+const char *const kDpkgActions[] = {"install", "upgrade", "configure", "status installed", "status unpacked", "status half-configured", "trigproc", "remove"};
+const char *const kXorgTags[] = {"(II)", "(II)", "(II)", "(--)", "(==)", "(**)", "(WW)", "(EE)"};
+const char *const kAppLevels[] = {"Debug", "Info", "Info", "Info", "Warning", "Error"};
+const char *const kAppFiles[] = {"mainwindow.cpp", "dbusadaptor.cpp", "settings.cpp", "worker.cpp"};
+const char *const kAppFunctions[] = {"MainWindow::initUI", "DBusAdaptor::handleCall", "Settings::load", "Worker::run"};
+const char *const kCommands[] = {"ls", "cat", "bash", "systemctl", "apt", "dde-file-manager"};
+const char *const kIdentifiers[] = {"systemd", "NetworkManager", "dde-session-daemon", "kernel", "lightdm", "pulseaudio"};
+
+#define COUNT_OF(items) static_cast<int>(sizeof(items) / sizeof(items[0]))
+
+QByteArray localTime(qint64 time, const char *format)
+{
+    return QDateTime::fromMSecsSinceEpoch(time).toString(QString::fromLatin1(format)).toLatin1();
+}
+}
+
+LogCorpusGenerator::LogCorpusGenerator(const LogCorpusOptions &options)
+    : m_options(options)
+    , m_random(options.seed)
+{
+    if (m_options.maxLineLength < m_options.minLineLength)
+        m_options.maxLineLength = m_options.minLineLength;
+}
+
+/**
+ * @brief LogCorpusGenerator::generate 生成一种日志及其轮转文件,轮转文件的时间更早
+ * @param kind 日志种类
+ * @param dir 输出目录
+ * @return 生成的文件,从新到旧;失败时为空
+ */
+QStringList LogCorpusGenerator::generate(Kind kind, const QString &dir)
+{
+    const int files = qMax(0, m_options.rotations) + 1;
+    QStringList result;
+    qint64 time = m_options.startTime;
+    //从最旧的轮转文件开始写,时间持续向后
+    for (int index = files - 1; index >= 0; --index) {
+        QString name = fileName(kind);
+        if (index > 0)
+            name += QString(".%1").arg(index);
+        const bool gzip = index >= 2 && kind != Wtmp;
+        if (gzip)
+            name += ".gz";
+        //余数留给最新的文件
+        const qint64 bytes = m_options.bytes / files + (index == 0 ? m_options.bytes % files : 0);
+        const qint64 records = m_options.records / files + (index == 0 ? m_options.records % files : 0);
+        const QString path = QDir(dir).filePath(name);
+        if (!writeFile(kind, path, gzip, bytes, records, time))
+            return QStringList();
+        result.prepend(path);
+    }
+    return result;
+}
+
+/**
+ * @brief LogCorpusGenerator::fileName 各种日志的文件名,和LogBenchmark::typeForFile的识别规则一致
+ */
+QString LogCorpusGenerator::fileName(Kind kind)
+{
+    switch (kind) {
+    case Kern:
+        return "kern.log";
+    case Dpkg:
+        return "dpkg.log";
+    case Audit:
+        return "audit.log";
+    case Xorg:
+        return "Xorg.0.log";
+    case App:
+        return "deepin-corpus.log";
+    case Wtmp:
+        return "wtmp";
+    case Journal:
+        return "system.journal.export";
+    }
+    return QString();
+}
+
+QStringList LogCorpusGenerator::kindNames()
+{
+    return QStringList() << "kern" << "dpkg" << "audit" << "xorg" << "app" << "wtmp" << "journal";
+}
+
+bool LogCorpusGenerator::kindFromName(const QString &name, Kind &kind)
+{
+    const int index = kindNames().indexOf(name.toLower());
+    if (index < 0)
+        return false;
+    kind = static_cast<Kind>(index);
+    return true;
+}
+
+/**
+ * @brief LogCorpusGenerator::parseSize 解析"512K"、"100M"、"10G"形式的大小,没有单位时为字节
+ * @return 字节数,无效时返回-1
+ */
+qint64 LogCorpusGenerator::parseSize(const QString &text)
+{
+    QString value = text.trimmed().toUpper();
+    qint64 unit = 1;
+    if (value.endsWith('K'))
+        unit = 1024;
+    else if (value.endsWith('M'))
+        unit = 1024 * 1024;
+    else if (value.endsWith('G'))
+        unit = 1024LL * 1024 * 1024;
+    if (unit > 1)
+        value.chop(1);
+    bool ok = false;
+    const double number = value.toDouble(&ok);
+    if (!ok || number < 0)
+        return -1;
+    return static_cast<qint64>(number * unit);
+}
+
+bool LogCorpusGenerator::writeFile(Kind kind, const QString &path, bool gzip, qint64 bytes, qint64 records, qint64 &time)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+    if (!gzip)
+        return writeRecords(kind, &file, bytes, records, time);
+
+    LogGzipWriter writer(&file);
+    if (!writer.open(QIODevice::WriteOnly))
+        return false;
+    const bool ok = writeRecords(kind, &writer, bytes, records, time);
+    return writer.finish() && ok;
+}
+
+/**
+ * @brief LogCorpusGenerator::writeRecords 写入记录直到达到目标大小或记录数
+ * @param time 输入输出参数,下一条记录的时间
+ */
+bool LogCorpusGenerator::writeRecords(Kind kind, QIODevice *device, qint64 bytes, qint64 records, qint64 &time)
+{
+    QByteArray block;
+    block.reserve(CORPUS_WRITE_BLOCK + 4096);
+    qint64 written = 0;
+    qint64 count = 0;
+    while (records > 0 ? count < records : written < bytes) {
+        written += appendRecord(kind, block, time);
+        ++count;
+        time += m_random.bounded(2 * m_options.stepMs + 1);
+        if (block.size() >= CORPUS_WRITE_BLOCK) {
+            if (device->write(block) != block.size())
+                return false;
+            block.clear();
+        }
+    }
+    return block.isEmpty() || device->write(block) == block.size();
+}
+
+int LogCorpusGenerator::appendRecord(Kind kind, QByteArray &out, qint64 time)
+{
+    const int before = out.size();
+    switch (kind) {
+    case Kern:
+        appendKern(out, time);
+        break;
+    case Dpkg:
+        appendDpkg(out, time);
+        break;
+    case Audit:
+        appendAudit(out, time);
+        break;
+    case Xorg:
+        appendXorg(out, time);
+        break;
+    case App:
+        appendApp(out, time);
+        break;
+    case Wtmp:
+        appendWtmp(out, time);
+        break;
+    case Journal:
+        appendJournal(out, time);
+        break;
+    }
+    return out.size() - before;
+}
+
+//Jul  3 10:00:00 bench-host kernel: [ 1234.567890] 信息
+void LogCorpusGenerator::appendKern(QByteArray &out, qint64 time)
+{
+    const QDateTime dateTime = QDateTime::fromMSecsSinceEpoch(time);
+    const qint64 uptime = time - m_options.startTime;
+    char prefix[128];
+    const int length = snprintf(prefix, sizeof(prefix), "%s %2d %s bench-host kernel: [%5lld.%06u] ",
+                                kMonths[dateTime.date().month() - 1], dateTime.date().day(),
+                                localTime(time, "hh:mm:ss").constData(), uptime / 1000,
+                                static_cast<unsigned>(uptime % 1000 * 1000 + m_random.bounded(1000)));
+    out.append(prefix, length).append(message()).append('\n');
+}
+
+//2023-07-03 10:00:00 status installed libc6:amd64 2.31-13
+void LogCorpusGenerator::appendDpkg(QByteArray &out, qint64 time)
+{
+    const char *action = pick(kDpkgActions, COUNT_OF(kDpkgActions));
+    const char *package = pick(kPackages, COUNT_OF(kPackages));
+    char line[256];
+    const int length = snprintf(line, sizeof(line), "%s %s %s:amd64 %u.%u-%u\n", localTime(time, "yyyy-MM-dd hh:mm:ss").constData(),
+                                action, package, m_random.bounded(10u), m_random.bounded(100u), m_random.bounded(20u));
+    out.append(line, length);
+}
+
+/**
+ * @brief LogCorpusGenerator::appendAudit 一个审计事件,执行命令的事件由SYSCALL、EXECVE、CWD、PATH和PROCTITLE
+ * 几条记录组成,共用同一个audit(时间:序号);其余为单条的登录记录
+ */
+void LogCorpusGenerator::appendAudit(QByteArray &out, qint64 time)
+{
+    ++m_serial;
+    char id[64];
+    snprintf(id, sizeof(id), "audit(%lld.%03lld:%llu): ", time / 1000, time % 1000, static_cast<unsigned long long>(m_serial));
+    const unsigned pid = 1000 + m_random.bounded(30000u);
+
+    if (m_serial % 5 == 0) {
+        out.append("type=USER_LOGIN msg=").append(id);
+        out.append(QByteArray("pid=") + QByteArray::number(pid)
+                   + " uid=0 auid=1000 ses=2 msg='op=login id=1000 exe=\"/usr/sbin/sshd\" hostname=? addr=192.168.1."
+                   + QByteArray::number(m_random.bounded(1, 255)) + " terminal=ssh res=" + (chance(0.2) ? "failed'" : "success'"));
+        out.append('\n');
+        return;
+    }
+
+    const char *command = pick(kCommands, COUNT_OF(kCommands));
+    out.append("type=SYSCALL msg=").append(id)
+        .append(QByteArray("arch=c000003e syscall=59 success=yes exit=0 items=2 ppid=1 pid=") + QByteArray::number(pid)
+                + " auid=1000 uid=1000 gid=1000 euid=1000 tty=pts0 ses=2 comm=\"" + command + "\" exe=\"/usr/bin/" + command
+                + "\" key=\"corpus\"\n");
+    out.append("type=EXECVE msg=").append(id).append(QByteArray("argc=2 a0=\"") + command + "\" a1=\"-l\"\n");
+    out.append("type=CWD msg=").append(id).append("cwd=\"/home/bench\"\n");
+    out.append("type=PATH msg=").append(id)
+        .append(QByteArray("item=0 name=\"/usr/bin/") + command + "\" inode=" + QByteArray::number(m_random.bounded(100000u))
+                + " dev=08:01 mode=0100755 ouid=0 ogid=0 rdev=00:00 nametype=NORMAL\n");
+    //进程标题是十六进制编码的命令行,长度按信息长度分布
+    out.append("type=PROCTITLE msg=").append(id).append("proctitle=").append(message(false).toHex().toUpper()).append('\n');
+}
+
+//[  1234.567] (II) 信息
+void LogCorpusGenerator::appendXorg(QByteArray &out, qint64 time)
+{
+    char prefix[64];
+    const double offset = (time - m_options.startTime) / 1000.0;
+    const int length = snprintf(prefix, sizeof(prefix), "[%10.3f] %s ", offset, pick(kXorgTags, COUNT_OF(kXorgTags)));
+    out.append(prefix, length).append(message()).append('\n');
+}
+
+//DTK日志格式:2023-07-03, 10:00:00.123 [Info   ] [mainwindow.cpp       MainWindow::initUI                  42] 信息
+void LogCorpusGenerator::appendApp(QByteArray &out, qint64 time)
+{
+    char prefix[160];
+    const int length = snprintf(prefix, sizeof(prefix), "%s [%-7s] [%-20s %-35s %u] ", localTime(time, "yyyy-MM-dd, hh:mm:ss.zzz").constData(),
+                                pick(kAppLevels, COUNT_OF(kAppLevels)), pick(kAppFiles, COUNT_OF(kAppFiles)),
+                                pick(kAppFunctions, COUNT_OF(kAppFunctions)), m_random.bounded(1u, 2000u));
+    out.append(prefix, length).append(message()).append('\n');
+}
+
+/**
+ * @brief LogCorpusGenerator::appendWtmp 一条utmp记录:未登录时登录(偶尔先开机),已登录时注销,偶尔关机
+ */
+void LogCorpusGenerator::appendWtmp(QByteArray &out, qint64 time)
+{
+    struct utmp entry;
+    memset(&entry, 0, sizeof(entry));
+    entry.ut_tv.tv_sec = static_cast<int32_t>(time / 1000);
+    entry.ut_tv.tv_usec = static_cast<int32_t>(time % 1000 * 1000);
+
+    if (m_wtmpLine.isEmpty()) {
+        if (chance(0.1)) {
+            //开机记录,user为reboot,host为内核版本
+            entry.ut_type = BOOT_TIME;
+            strncpy(entry.ut_line, "~", sizeof(entry.ut_line));
+            strncpy(entry.ut_user, "reboot", sizeof(entry.ut_user));
+            strncpy(entry.ut_host, "5.15.77-amd64-desktop", sizeof(entry.ut_host));
+            out.append(reinterpret_cast<const char *>(&entry), sizeof(entry));
+            return;
+        }
+        m_wtmpPid = 1000 + static_cast<int>(m_random.bounded(30000u));
+        m_wtmpLine = chance(0.5) ? QByteArray("tty1") : QByteArray("pts/") + QByteArray::number(m_random.bounded(10u));
+        entry.ut_type = USER_PROCESS;
+        entry.ut_pid = m_wtmpPid;
+        strncpy(entry.ut_line, m_wtmpLine.constData(), sizeof(entry.ut_line));
+        strncpy(entry.ut_id, m_wtmpLine.right(4).constData(), sizeof(entry.ut_id));
+        strncpy(entry.ut_user, "bench", sizeof(entry.ut_user));
+        strncpy(entry.ut_host, m_wtmpLine.startsWith("tty") ? ":0" : "192.168.1.10", sizeof(entry.ut_host));
+    } else if (chance(0.05)) {
+        //关机记录
+        entry.ut_type = RUN_LVL;
+        strncpy(entry.ut_line, "~", sizeof(entry.ut_line));
+        strncpy(entry.ut_user, "shutdown", sizeof(entry.ut_user));
+        strncpy(entry.ut_host, "5.15.77-amd64-desktop", sizeof(entry.ut_host));
+        m_wtmpLine.clear();
+    } else {
+        entry.ut_type = DEAD_PROCESS;
+        entry.ut_pid = m_wtmpPid;
+        strncpy(entry.ut_line, m_wtmpLine.constData(), sizeof(entry.ut_line));
+        strncpy(entry.ut_id, m_wtmpLine.right(4).constData(), sizeof(entry.ut_id));
+        m_wtmpLine.clear();
+    }
+    out.append(reinterpret_cast<const char *>(&entry), sizeof(entry));
+}
+
+/**
+ * @brief LogCorpusGenerator::appendJournal journal导出格式的一个条目,字段为"名称=值"行,条目之间空一行;
+ * 含\0或换行的值按二进制格式写:名称、换行、64位小端长度、数据、换行
+ */
+void LogCorpusGenerator::appendJournal(QByteArray &out, qint64 time)
+{
+    static const QByteArray bootId = "5b6e1f2d8c9a4e7fb0c3d2a1e4f5a6b7";
+    static const QByteArray seqnumId = "0f1e2d3c4b5a69788796a5b4c3d2e1f0";
+    ++m_serial;
+    const qint64 realtime = time * 1000;
+    const qint64 monotonic = (time - m_options.startTime) * 1000 + 1000000;
+    char cursor[256];
+    snprintf(cursor, sizeof(cursor), "__CURSOR=s=%s;i=%llx;b=%s;m=%llx;t=%llx;x=%llx\n", seqnumId.constData(),
+             static_cast<unsigned long long>(m_serial), bootId.constData(), static_cast<unsigned long long>(monotonic),
+             static_cast<unsigned long long>(realtime), static_cast<unsigned long long>(m_serial * 2654435761u));
+    out.append(cursor);
+    out.append("__REALTIME_TIMESTAMP=").append(QByteArray::number(realtime)).append('\n');
+    out.append("__MONOTONIC_TIMESTAMP=").append(QByteArray::number(monotonic)).append('\n');
+    out.append("_BOOT_ID=").append(bootId).append('\n');
+    out.append("PRIORITY=").append(QByteArray::number(m_random.bounded(8u))).append('\n');
+    out.append("_HOSTNAME=bench-host\n");
+    out.append("SYSLOG_IDENTIFIER=").append(pick(kIdentifiers, COUNT_OF(kIdentifiers))).append('\n');
+    out.append("_PID=").append(QByteArray::number(1000 + m_random.bounded(30000u))).append('\n');
+    out.append("_TRANSPORT=journal\n");
+
+    const QByteArray text = message();
+    if (text.contains('\0') || text.contains('\n')) {
+        const quint64 length = static_cast<quint64>(text.size());
+        char size[8];
+        for (int i = 0; i < 8; ++i)
+            size[i] = static_cast<char>((length >> (8 * i)) & 0xff);
+        out.append("MESSAGE\n").append(size, 8).append(text).append('\n');
+    } else {
+        out.append("MESSAGE=").append(text).append('\n');
+    }
+    out.append('\n');
+}
+
+/**
+ * @brief LogCorpusGenerator::message 信息部分,长度在minLineLength和maxLineLength之间,按比例带颜色序列和\0
+ */
+QByteArray LogCorpusGenerator::message(bool allowNul)
+{
+    const int target = m_options.minLineLength + static_cast<int>(m_random.bounded(m_options.maxLineLength - m_options.minLineLength + 1));
+    QByteArray text;
+    text.reserve(target + 32);
+    while (text.size() < target) {
+        if (!text.isEmpty())
+            text.append(' ');
+        text.append(pick(kWords, COUNT_OF(kWords)));
+    }
+    text.truncate(target);
+    //截断可能把多字节字符截成一半,去掉不完整的最后一个字符
+    int last = text.size() - 1;
+    while (last > 0 && (static_cast<uchar>(text.at(last)) & 0xc0) == 0x80)
+        --last;
+    const uchar lead = last >= 0 ? static_cast<uchar>(text.at(last)) : 0;
+    const int charLength = lead >= 0xf0 ? 4 : (lead >= 0xe0 ? 3 : (lead >= 0xc0 ? 2 : 1));
+    if (last >= 0 && last + charLength > text.size())
+        text.truncate(last);
+
+    if (chance(m_options.ansiRatio))
+        text = "\x1b[1;31m" + text + "\x1b[0m";
+    if (allowNul && !text.isEmpty() && chance(m_options.nulRatio))
+        text.insert(static_cast<int>(m_random.bounded(static_cast<quint32>(text.size()))), '\0');
+    return text;
+}
+
+const char *LogCorpusGenerator::pick(const char *const *items, int count)
+{
+    return items[m_random.bounded(count)];
+}
+
+bool LogCorpusGenerator::chance(double ratio)
+{
+    return ratio > 0 && m_random.generateDouble() < ratio;
+}
@@ -0,0 +1,93 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef LOGCORPUSGENERATOR_H
+#define LOGCORPUSGENERATOR_H
+
+#include <QByteArray>
+#include <QRandomGenerator>
+#include <QString>
+#include <QStringList>
+
+class QIODevice;
+
+//生成时每积累这么多字节写一次文件
+#define CORPUS_WRITE_BLOCK (1024 * 1024)
+
+/**
+ * @brief The LogCorpusOptions struct 生成语料的规模和分布
+ */
+struct LogCorpusOptions {
+    //每种日志所有轮转文件的未压缩总大小
+    qint64 bytes = 1024 * 1024;
+    //非0时按记录数生成,代替bytes
+    qint64 records = 0;
+    //信息部分的长度在两者之间均匀分布
+    int minLineLength = 40;
+    int maxLineLength = 200;
+    //带终端颜色控制序列的行比例
+    double ansiRatio = 0;
+    //带\0的行比例
+    double nulRatio = 0;
+    //轮转文件数,.1为文本,.2起为.gz压缩(wtmp轮转不压缩)
+    int rotations = 0;
+    quint32 seed = 1;
+    //第一条记录的时间(毫秒),相邻记录的间隔在0到2*stepMs之间
+    qint64 startTime = 1688342400000LL;
+    int stepMs = 1000;
+};
+
+/**
+ * @brief The LogCorpusGenerator class 生成用于规模测试的合成日志
+ * 格式和真实日志一致:kern.log、dpkg.log、audit.log(一个事件多条记录)、Xorg.0.log、DTK应用日志、
+ * wtmp二进制记录和journal导出格式(可用systemd-journal-remote转为journal文件);
+ * 同一个种子生成的内容相同,不同提交之间的测试结果可以比较
+ */
+class LogCorpusGenerator
+{
+public:
+    enum Kind {
+        Kern,
+        Dpkg,
+        Audit,
+        Xorg,
+        App,
+        Wtmp,
+        Journal
+    };
+
+    explicit LogCorpusGenerator(const LogCorpusOptions &options);
+
+    QStringList generate(Kind kind, const QString &dir);
+
+    static QString fileName(Kind kind);
+    static bool kindFromName(const QString &name, Kind &kind);
+    static QStringList kindNames();
+    static qint64 parseSize(const QString &text);
+
+private:
+    bool writeFile(Kind kind, const QString &path, bool gzip, qint64 bytes, qint64 records, qint64 &time);
+    bool writeRecords(Kind kind, QIODevice *device, qint64 bytes, qint64 records, qint64 &time);
+    int appendRecord(Kind kind, QByteArray &out, qint64 time);
+    void appendKern(QByteArray &out, qint64 time);
+    void appendDpkg(QByteArray &out, qint64 time);
+    void appendAudit(QByteArray &out, qint64 time);
+    void appendXorg(QByteArray &out, qint64 time);
+    void appendApp(QByteArray &out, qint64 time);
+    void appendWtmp(QByteArray &out, qint64 time);
+    void appendJournal(QByteArray &out, qint64 time);
+    QByteArray message(bool allowNul = true);
+    const char *pick(const char *const *items, int count);
+    bool chance(double ratio);
+
+    LogCorpusOptions m_options;
+    QRandomGenerator m_random;
+    //audit事件序号、wtmp会话和journal条目序号,跨轮转文件递增
+    quint64 m_serial = 0;
+    //wtmp当前登录会话的终端和进程号,为空表示没有登录
+    QByteArray m_wtmpLine;
+    int m_wtmpPid = 0;
+};
+
+#endif // LOGCORPUSGENERATOR_H
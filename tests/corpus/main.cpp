@@ -0,0 +1,76 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logcorpusgenerator.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+
+#include <iostream>
+
+/**
+ * 生成规模测试用的合成日志,例如:
+ * deepin-log-viewer-corpus -o /tmp/corpus -t kern,audit,app -s 1G --rotate 3 --ansi 0.05 --nul 0.001
+ */
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Generate synthetic logs for scaling tests.");
+    parser.addHelpOption();
+    QCommandLineOption outputOption(QStringList() << "o" << "output", "Output directory.", "dir", ".");
+    QCommandLineOption typeOption(QStringList() << "t" << "type",
+                                  "Comma separated types: " + LogCorpusGenerator::kindNames().join(',') + ".", "types",
+                                  LogCorpusGenerator::kindNames().join(','));
+    QCommandLineOption sizeOption(QStringList() << "s" << "size", "Uncompressed size of each type, e.g. 1M, 10G.", "size", "1M");
+    QCommandLineOption recordsOption("records", "Number of records of each type, overrides --size.", "count", "0");
+    QCommandLineOption minLineOption("min-line", "Minimum message length.", "length", "40");
+    QCommandLineOption maxLineOption("max-line", "Maximum message length.", "length", "200");
+    QCommandLineOption ansiOption("ansi", "Ratio of lines with ANSI color sequences.", "ratio", "0");
+    QCommandLineOption nulOption("nul", "Ratio of lines with NUL bytes.", "ratio", "0");
+    QCommandLineOption rotateOption("rotate", "Number of rotated files, the second and older ones are gzipped.", "count", "0");
+    QCommandLineOption seedOption("seed", "Random seed.", "seed", "1");
+    parser.addOptions({outputOption, typeOption, sizeOption, recordsOption, minLineOption, maxLineOption, ansiOption, nulOption,
+                       rotateOption, seedOption});
+    parser.process(app);
+
+    LogCorpusOptions options;
+    options.bytes = LogCorpusGenerator::parseSize(parser.value(sizeOption));
+    options.records = parser.value(recordsOption).toLongLong();
+    options.minLineLength = parser.value(minLineOption).toInt();
+    options.maxLineLength = parser.value(maxLineOption).toInt();
+    options.ansiRatio = parser.value(ansiOption).toDouble();
+    options.nulRatio = parser.value(nulOption).toDouble();
+    options.rotations = parser.value(rotateOption).toInt();
+    options.seed = parser.value(seedOption).toUInt();
+    if (options.bytes < 0 || options.records < 0 || options.minLineLength < 0 || options.rotations < 0) {
+        std::cerr << "invalid size, records, line length or rotate option" << std::endl;
+        return 1;
+    }
+
+    const QString dir = parser.value(outputOption);
+    if (!QDir().mkpath(dir)) {
+        std::cerr << "can not create " << dir.toStdString() << std::endl;
+        return 1;
+    }
+
+    for (const QString &name : parser.value(typeOption).split(',', QString::SkipEmptyParts)) {
+        LogCorpusGenerator::Kind kind;
+        if (!LogCorpusGenerator::kindFromName(name, kind)) {
+            std::cerr << "unknown type " << name.toStdString() << std::endl;
+            return 1;
+        }
+        //每种日志单独的生成器,增减种类不影响其他种类的内容
+        LogCorpusGenerator generator(options);
+        const QStringList files = generator.generate(kind, dir);
+        if (files.isEmpty()) {
+            std::cerr << "generate " << name.toStdString() << " failed" << std::endl;
+            return 1;
+        }
+        for (const QString &file : files)
+            std::cout << file.toStdString() << std::endl;
+    }
+    return 0;
+}
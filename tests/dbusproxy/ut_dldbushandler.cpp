@@ -44,3 +44,11 @@ TEST(UT_DLDBusHandler_exportLog, UT_DLDBusHandler_exportLog_001)
 }
 
 
+TEST(UT_DLDBusHandler_decodeTransfer, UT_DLDBusHandler_decodeTransfer_001)
+{
+    const QString text = QString("kern: 中文日志 line\n").repeated(100);
+    EXPECT_EQ(DLDBusHandler::decodeTransfer(qCompress(text.toUtf8(), 1)), text);
+    //空数据表示读取结束,损坏的数据按空处理
+    EXPECT_TRUE(DLDBusHandler::decodeTransfer(QByteArray()).isEmpty());
+    EXPECT_TRUE(DLDBusHandler::decodeTransfer(QByteArray("broken")).isEmpty());
+}
@@ -109,25 +109,22 @@ QString stub_getSaveHtmlFileName(QWidget *parent = nullptr,
     return "/home/Desktop/test.html";
 }
 
-int stub_singleRowHeight()
-{
-    return 1;
-}
-
 void stub_start(QRunnable *runnable, int priority = 0)
 {
     Q_UNUSED(runnable);
     Q_UNUSED(priority);
 }
 
-void parseDnfNull(DNF_FILTERS iDnfFilter)
+int parseDnfNull(DNF_FILTERS iDnfFilter)
 {
     Q_UNUSED(iDnfFilter);
+    return 0;
 }
 
-void parseDmesgNull(DMESG_FILTERS iDmesgFilter)
+int parseDmesgNull(DMESG_FILTERS iDmesgFilter)
 {
     Q_UNUSED(iDmesgFilter);
+    return 0;
 }
 
 void generateAppFileNull(QString path, int id, int lId, const QString &iSearchStr)
@@ -296,152 +293,22 @@ TEST_F(DisplayContentlx_UT, exportClicked_UT003)
     EXPECT_NE(m_content->m_exportDlg, nullptr)<<"check the status after slot_exportClicked()";
 }
 
-TEST_F(DisplayContentlx_UT, ScrollValueChanged_UT)
-{
-    Stub stub;
-    m_content->m_flag = LOG_FLAG::JOURNAL;
-    stub.set(ADDR(LogTreeView, singleRowHeight), stub_singleRowHeight);
-    m_content->slot_vScrollValueChanged(275);
-    EXPECT_NE(m_content->m_treeView,nullptr)<<"check the status after slot_vScrollValueChanged()";
-    EXPECT_EQ(m_content->m_treeViewLastScrollValue, 275)<<"check the status after slot_vScrollValueChanged()";
-    EXPECT_EQ(m_content->m_limitTag, 1)<<"check the status after slot_vScrollValueChanged()";
-    EXPECT_EQ(m_content->m_flag, LOG_FLAG::JOURNAL)<<"check the status after slot_vScrollValueChanged()";
-}
-
-TEST_F(DisplayContentlx_UT, ScrollValueChanged_UT002)
-{
-    Stub stub;
-    m_content->m_flag = LOG_FLAG::BOOT;
-    stub.set(ADDR(LogTreeView, singleRowHeight), stub_singleRowHeight);
-    m_content->slot_vScrollValueChanged(275);
-    EXPECT_NE(m_content->m_treeView,nullptr)<<"check the status after slot_vScrollValueChanged()";
-    EXPECT_EQ(m_content->m_treeViewLastScrollValue, 275)<<"check the status after slot_vScrollValueChanged()";
-    EXPECT_EQ(m_content->m_limitTag, 1)<<"check the status after slot_vScrollValueChanged()";
-    EXPECT_EQ(m_content->m_flag, LOG_FLAG::BOOT)<<"check the status after slot_vScrollValueChanged()";
-}
-
-TEST_F(DisplayContentlx_UT, ScrollValueChanged_UT003)
-{
-    Stub stub;
-    m_content->m_flag = LOG_FLAG::BOOT_KLU;
-    stub.set(ADDR(LogTreeView, singleRowHeight), stub_singleRowHeight);
-    m_content->slot_vScrollValueChanged(275);
-    EXPECT_NE(m_content->m_treeView,nullptr)<<"check the status after slot_vScrollValueChanged()";
-    EXPECT_EQ(m_content->m_treeViewLastScrollValue, 275)<<"check the status after slot_vScrollValueChanged()";
-    EXPECT_EQ(m_content->m_limitTag, 1)<<"check the status after slot_vScrollValueChanged()";
-    EXPECT_EQ(m_content->m_flag, LOG_FLAG::BOOT_KLU)<<"check the status after slot_vScrollValueChanged()";
-}
-
-TEST_F(DisplayContentlx_UT, ScrollValueChanged_UT005)
-{
-    Stub stub;
-    m_content->m_flag = LOG_FLAG::APP;
-    stub.set(ADDR(LogTreeView, singleRowHeight), stub_singleRowHeight);
-    m_content->slot_vScrollValueChanged(275);
-    EXPECT_NE(m_content->m_treeView,nullptr)<<"check the status after slot_vScrollValueChanged()";
-    EXPECT_EQ(m_content->m_treeViewLastScrollValue, 275)<<"check the status after slot_vScrollValueChanged()";
-    EXPECT_EQ(m_content->m_limitTag, 1)<<"check the status after slot_vScrollValueChanged()";
-    EXPECT_EQ(m_content->m_flag, LOG_FLAG::APP)<<"check the status after slot_vScrollValueChanged()";
-}
-
-TEST_F(DisplayContentlx_UT, ScrollValueChanged_UT006)
-{
-    Stub stub;
-    m_content->m_flag = LOG_FLAG::XORG;
-    stub.set(ADDR(LogTreeView, singleRowHeight), stub_singleRowHeight);
-    m_content->slot_vScrollValueChanged(275);
-    EXPECT_NE(m_content->m_treeView,nullptr)<<"check the status after slot_vScrollValueChanged()";
-    EXPECT_EQ(m_content->m_treeViewLastScrollValue, 275)<<"check the status after slot_vScrollValueChanged()";
-    EXPECT_EQ(m_content->m_limitTag, 1)<<"check the status after slot_vScrollValueChanged()";
-    EXPECT_EQ(m_content->m_flag, LOG_FLAG::XORG)<<"check the status after slot_vScrollValueChanged()";
-}
-
-TEST_F(DisplayContentlx_UT, ScrollValueChanged_UT007)
-{
-    Stub stub;
-    m_content->m_flag = LOG_FLAG::KERN;
-    stub.set(ADDR(LogTreeView, singleRowHeight), stub_singleRowHeight);
-    m_content->slot_vScrollValueChanged(275);
-    EXPECT_NE(m_content->m_treeView,nullptr)<<"check the status after slot_vScrollValueChanged()";
-    EXPECT_EQ(m_content->m_treeViewLastScrollValue, 275)<<"check the status after slot_vScrollValueChanged()";
-    EXPECT_EQ(m_content->m_limitTag, 1)<<"check the status after slot_vScrollValueChanged()";
-    EXPECT_EQ(m_content->m_flag, LOG_FLAG::KERN)<<"check the status after slot_vScrollValueChanged()";
-}
-
-TEST_F(DisplayContentlx_UT, DmesgScrollValueChanged_UT)
-{
-    Stub stub;
-    m_content->m_flag = LOG_FLAG::Dmesg;
-    stub.set(ADDR(LogTreeView, singleRowHeight), stub_singleRowHeight);
-    m_content->slot_vScrollValueChanged(275);
-    EXPECT_NE(m_content->m_treeView,nullptr)<<"check the status after slot_vScrollValueChanged()";
-    EXPECT_EQ(m_content->m_treeViewLastScrollValue, 275)<<"check the status after slot_vScrollValueChanged()";
-    EXPECT_EQ(m_content->m_limitTag, 1)<<"check the status after slot_vScrollValueChanged()";
-    EXPECT_EQ(m_content->m_flag, LOG_FLAG::Dmesg)<<"check the status after slot_vScrollValueChanged()";
-}
-
-TEST_F(DisplayContentlx_UT, DnfScrollValueChanged_UT)
-{
-    Stub stub;
-    m_content->m_flag = LOG_FLAG::Dnf;
-    stub.set(ADDR(LogTreeView, singleRowHeight), stub_singleRowHeight);
-    m_content->slot_vScrollValueChanged(275);
-    EXPECT_NE(m_content->m_treeView,nullptr)<<"check the status after slot_vScrollValueChanged()";
-    EXPECT_EQ(m_content->m_treeViewLastScrollValue, 275)<<"check the status after slot_vScrollValueChanged()";
-    EXPECT_EQ(m_content->m_limitTag, 1)<<"check the status after slot_vScrollValueChanged()";
-    EXPECT_EQ(m_content->m_flag, LOG_FLAG::Dnf)<<"check the status after slot_vScrollValueChanged()";
-}
-
-TEST_F(DisplayContentlx_UT, NormalScrollValueChanged_UT)
-{
-    Stub stub;
-    m_content->m_flag = LOG_FLAG::Normal;
-    stub.set(ADDR(LogTreeView, singleRowHeight), stub_singleRowHeight);
-    m_content->slot_vScrollValueChanged(275);
-    EXPECT_NE(m_content->m_treeView,nullptr)<<"check the status after slot_vScrollValueChanged()";
-    EXPECT_EQ(m_content->m_treeViewLastScrollValue, 275)<<"check the status after slot_vScrollValueChanged()";
-    EXPECT_EQ(m_content->m_limitTag, 1)<<"check the status after slot_vScrollValueChanged()";
-    EXPECT_EQ(m_content->m_flag, LOG_FLAG::Normal)<<"check the status after slot_vScrollValueChanged()";
-}
-
-TEST_F(DisplayContentlx_UT, KwinScrollValueChanged_UT)
-{
-    Stub stub;
-    m_content->m_flag = LOG_FLAG::Kwin;
-    stub.set(ADDR(LogTreeView, singleRowHeight), stub_singleRowHeight);
-    m_content->slot_vScrollValueChanged(275);
-    EXPECT_NE(m_content->m_treeView,nullptr)<<"check the status after slot_vScrollValueChanged()";
-    EXPECT_EQ(m_content->m_treeViewLastScrollValue, 275)<<"check the status after slot_vScrollValueChanged()";
-    EXPECT_EQ(m_content->m_limitTag, 1)<<"check the status after slot_vScrollValueChanged()";
-    EXPECT_EQ(m_content->m_flag, LOG_FLAG::Kwin)<<"check the status after slot_vScrollValueChanged()";
-}
-
-TEST_F(DisplayContentlx_UT, ScrollValueChanged_UT008)
-{
-    Stub stub;
-    m_content->m_flag = LOG_FLAG::DPKG;
-    stub.set(ADDR(LogTreeView, singleRowHeight), stub_singleRowHeight);
-    m_content->slot_vScrollValueChanged(275);
-    EXPECT_NE(m_content->m_treeView,nullptr)<<"check the status after slot_vScrollValueChanged()";
-    EXPECT_EQ(m_content->m_treeViewLastScrollValue, 275)<<"check the status after slot_vScrollValueChanged()";
-    EXPECT_EQ(m_content->m_limitTag, 1)<<"check the status after slot_vScrollValueChanged()";
-    EXPECT_EQ(m_content->m_flag, LOG_FLAG::DPKG)<<"check the status after slot_vScrollValueChanged()";
-}
-
 TEST_F(DisplayContentlx_UT, FileParse_UT)
 {
     DisplayContent *p = new DisplayContent(nullptr);
     QList<LOG_MSG_DNF> list;
-    QStandardItemModel m_model;
+    LogTableModel m_model;
     p->parseListToModel(list, &m_model);
     QList<LOG_MSG_DMESG> m_list;
     p->parseListToModel(m_list, &m_model);
     QList<LOG_MSG_BOOT> m_list1;
     p->parseListToModel(m_list, &m_model);
     EXPECT_NE(p, nullptr);
-    EXPECT_NE(p->m_transDict.count(),0)<<"check the status after parseListToModel()";
     EXPECT_NE(p->m_iconPrefix.count(),0)<<"check the status after parseListToModel()";
-    EXPECT_NE(p->m_dnfIconNameMap.count(),0)<<"check the status after parseListToModel()";
+    //dnf的获取信号第一次显示dnf日志时才连接
+    EXPECT_EQ(p->m_setupTypes.contains(Dnf),false);
+    p->ensureTypeSetup(Dnf);
+    EXPECT_EQ(p->m_setupTypes.contains(Dnf),true)<<"check the status after ensureTypeSetup()";
     p->deleteLater();
 }
 
@@ -476,10 +343,10 @@ TEST_F(DisplayContentlx_UT, generateJournalFile_UT)
 TEST_F(DisplayContentlx_UT, createDnfTable_UT)
 {
     QList<LOG_MSG_DNF> dnfList;
-    LOG_MSG_DNF dnfLog = {"2021-05-21", "DEBUG", "DNF version: 4.2.23"};
+    LOG_MSG_DNF dnfLog = {"2021-05-21", DEBUG, "DNF version: 4.2.23"};
     dnfList.push_back(dnfLog);
     m_content->createDnfTable(dnfList);
-    EXPECT_EQ(m_content->m_limitTag, 0)<<"check the status after createDnfTable()";
+    EXPECT_EQ(m_content->m_pModel->rowCount(), 1)<<"check the status after createDnfTable()";
     EXPECT_NE(m_content->m_pModel, nullptr)<<"check the status after createDnfTable()";
 }
 
@@ -500,10 +367,10 @@ TEST_F(DisplayContentlx_UT, generateDmesgFile_UT)
 TEST_F(DisplayContentlx_UT, createDmesgTable_UT)
 {
     QList<LOG_MSG_DMESG> dmesgList;
-    LOG_MSG_DMESG dmesgLog = {"ERR", "2021-05-21", "DNF version: 4.2.23"};
+    LOG_MSG_DMESG dmesgLog = {ERR, "2021-05-21", "DNF version: 4.2.23"};
     dmesgList.push_back(dmesgLog);
     m_content->createDmesgTable(dmesgList);
-    EXPECT_EQ(m_content->m_limitTag, 0)<<"check the status after createDmesgTable()";
+    EXPECT_EQ(m_content->m_pModel->rowCount(), 1)<<"check the status after createDmesgTable()";
     EXPECT_NE(m_content->m_pModel, nullptr)<<"check the status after createDmesgTable()";
 }
 
@@ -517,7 +384,7 @@ TEST_F(DisplayContentlx_UT, createDnfForm_UT)
 TEST_F(DisplayContentlx_UT, insertDmesgTable_UT)
 {
     QList<LOG_MSG_DMESG> dmesgList;
-    LOG_MSG_DMESG dmesgLog = {"ERR", "2021-05-21", "DNF version: 4.2.23"};
+    LOG_MSG_DMESG dmesgLog = {ERR, "2021-05-21", "DNF version: 4.2.23"};
     dmesgList.push_back(dmesgLog);
     m_content->insertDmesgTable(dmesgList, -1, -1);
     EXPECT_NE(m_content, nullptr);
@@ -526,7 +393,7 @@ TEST_F(DisplayContentlx_UT, insertDmesgTable_UT)
 TEST_F(DisplayContentlx_UT, insertDnfTable_UT)
 {
     QList<LOG_MSG_DNF> dnfList;
-    LOG_MSG_DNF dnfLog = {"2021-05-21", "DEBUG", "DNF version: 4.2.23"};
+    LOG_MSG_DNF dnfLog = {"2021-05-21", DEBUG, "DNF version: 4.2.23"};
     dnfList.push_back(dnfLog);
     m_content->insertDnfTable(dnfList, -1, -1);
     EXPECT_NE(m_content, nullptr);
@@ -574,7 +441,7 @@ TEST_F(DisplayContentlx_UT, slot_XorgFinished_UT)
 TEST_F(DisplayContentlx_UT, slot_kernData_UT)
 {
     QList<LOG_MSG_JOURNAL> kernList;
-    LOG_MSG_JOURNAL kernLog = {"2021-05-21", "UOS", "dde-daemon", "1122", "DEBUG", "DNF version: 4.2.23"};
+    LOG_MSG_JOURNAL kernLog = {"2021-05-21", "UOS", "dde-daemon", "1122", DEB, "DNF version: 4.2.23"};
     kernList.push_back(kernLog);
     m_content->m_flag = LOG_FLAG::KERN;
     m_content->m_firstLoadPageData = true;
@@ -619,25 +486,35 @@ TEST_F(DisplayContentlx_UT, slot_journalFinished_UT)
 TEST_F(DisplayContentlx_UT, slot_dnfFinished_UT)
 {
     QList<LOG_MSG_DNF> dnfList;
-    LOG_MSG_DNF dnfLog = {"ok", "DEBUG", "DNF version: 4.2.23"};
+    LOG_MSG_DNF dnfLog = {"ok", DEBUG, "DNF version: 4.2.23"};
     dnfList.push_back(dnfLog);
     m_content->m_flag = LOG_FLAG::Dnf;
     m_content->m_firstLoadPageData = true;
-    m_content->slot_dnfFinished(dnfList);
+    m_content->m_dnfCurrentIndex = 1;
+    m_content->slot_dnfData(1, dnfList);
+    //其他线程发来的数据丢弃
+    m_content->slot_dnfData(2, dnfList);
+    m_content->slot_dnfData(1, dnfList);
+    m_content->slot_dnfFinished(1);
     EXPECT_EQ(m_content->m_flag, LOG_FLAG::Dnf)<<"check the status after slot_dnfFinished()";
-    EXPECT_EQ(m_content->dnfList.size(), 1)<<"check the status after slot_dnfFinished()";
+    EXPECT_EQ(m_content->dnfList.size(), 2)<<"check the status after slot_dnfFinished()";
+    EXPECT_EQ(m_content->m_isDataLoadComplete, true)<<"check the status after slot_dnfFinished()";
 }
 
 TEST_F(DisplayContentlx_UT, slot_dmesgFinished_UT)
 {
     QList<LOG_MSG_DMESG> dmesgList;
-    LOG_MSG_DMESG dmesgLog = {"DEBUG", "ok", "DNF version: 4.2.23"};
+    LOG_MSG_DMESG dmesgLog = {DEB, "ok", "DNF version: 4.2.23"};
     dmesgList.push_back(dmesgLog);
     m_content->m_flag = LOG_FLAG::Dmesg;
     m_content->m_firstLoadPageData = true;
-    m_content->slot_dmesgFinished(dmesgList);
+    m_content->m_dmesgCurrentIndex = 1;
+    m_content->slot_dmesgData(1, dmesgList);
+    m_content->slot_dmesgData(2, dmesgList);
+    m_content->slot_dmesgFinished(1);
     EXPECT_EQ(m_content->m_flag, LOG_FLAG::Dmesg)<<"check the status after slot_dmesgFinished()";
     EXPECT_EQ(m_content->dmesgList.size(), 1)<<"check the status after slot_dmesgFinished()";
+    EXPECT_EQ(m_content->m_isDataLoadComplete, true)<<"check the status after slot_dmesgFinished()";
 }
 
 TEST_F(DisplayContentlx_UT, slot_normalFinished_UT)
@@ -728,7 +605,7 @@ TEST_F(DisplayContentlx_UT, slot_journalBootFinished_UT){
 
 
 TEST_F(DisplayContentlx_UT, slot_applicationData_UT){
-    LOG_MSG_APPLICATOIN app={"20210202","waring","test","test","test"};
+    LOG_MSG_APPLICATOIN app={"20210202",WARN,"test","test","test"};
     QList<LOG_MSG_APPLICATOIN>listApp;
     listApp.append(app);
     m_content->m_flag=LOG_FLAG::APP;
@@ -783,14 +660,14 @@ TEST_F(DisplayContentlx_UT, slot_refreshClicked_UT){
 TEST_F(DisplayContentlx_UT, filterJournal_UT){
 
     NORMAL_FILTERS fiter;
-    LOG_MSG_JOURNAL journal={"20210202","waring","test","test","test","test"};
+    LOG_MSG_JOURNAL journal={"20210202","waring","test","test",DEB,"test"};
     QList<LOG_MSG_JOURNAL>listjournal;
     listjournal.append(journal);
-    QList<LOG_MSG_JOURNAL> list= m_content->filterJournal("",listjournal);
+    QList<LOG_MSG_JOURNAL> list= m_content->filterJournal("",listjournal).toList();
     EXPECT_EQ(list.at(0).daemonId,"test")<<"check the status after filterJournal()";
     EXPECT_EQ(list.at(0).daemonName,"test")<<"check the status after filterJournal()";
     EXPECT_EQ(list.at(0).dateTime,"20210202")<<"check the status after filterJournal()";
-    EXPECT_EQ(list.at(0).level,"test")<<"check the status after filterJournal()";
+    EXPECT_EQ(list.at(0).level,DEB)<<"check the status after filterJournal()";
     EXPECT_EQ(list.at(0).msg,"test")<<"check the status after filterJournal()";
     m_content->filterJournal("test",listjournal);
 }
@@ -841,31 +718,15 @@ TEST(DisplayContent_MainLogTableView_UT, DisplayContent_MainLogTableView_UT_001)
     delete p;
 }
 
-TEST(DisplayContent_initMap_UT, DisplayContent_initMap_UT_001)
-{
-    DisplayContent *p = new DisplayContent(nullptr);
-    EXPECT_NE(p, nullptr);
-    p->initMap();
-    QMap<QString, QString> map1;
-    map1.insert("Warning", Dtk::Widget::DApplication::translate("Level", "Warning")); //add by Airy for bug 19167 and 19161
-    map1.insert("Debug", Dtk::Widget::DApplication::translate("Level", "Debug")); //add by Airy for bug 19167 and 19161
-    map1.insert("Info", Dtk::Widget::DApplication::translate("Level", "Info"));
-    map1.insert("Error", Dtk::Widget::DApplication::translate("Level", "Error"));
-    QMap<QString, QString> map2;
-    map2.insert(Dtk::Widget::DApplication::translate("Level", "Emergency"), "warning2.svg");
-    map2.insert(Dtk::Widget::DApplication::translate("Level", "Alert"), "warning3.svg");
-    map2.insert(Dtk::Widget::DApplication::translate("Level", "Critical"), "warning2.svg");
-    map2.insert(Dtk::Widget::DApplication::translate("Level", "Error"), "wrong.svg");
-    map2.insert(Dtk::Widget::DApplication::translate("Level", "Warning"), "warning.svg");
-    map2.insert(Dtk::Widget::DApplication::translate("Level", "Notice"), "warning.svg");
-    map2.insert(Dtk::Widget::DApplication::translate("Level", "Info"), "");
-    map2.insert(Dtk::Widget::DApplication::translate("Level", "Debug"), "");
-    map2.insert("Warning", "warning.svg");
-    map2.insert("Debug", "");
-    map2.insert("Error", "wrong.svg");
-    EXPECT_EQ(p->m_transDict, map1);
-    EXPECT_EQ(p->m_icon_name_map, map2);
-    delete p;
+TEST(DisplayContent_levelOrder_UT, DisplayContent_levelOrder_UT_001)
+{
+    //越严重越靠前,没有等级的排在最后
+    EXPECT_LT(DisplayContent::levelOrder(EMER), DisplayContent::levelOrder(DEB));
+    EXPECT_LT(DisplayContent::levelOrder(DEB), DisplayContent::levelOrder(-1));
+    EXPECT_LT(DisplayContent::dnfLevelOrder(SUPERCRITICAL), DisplayContent::dnfLevelOrder(TRACE));
+    EXPECT_LT(DisplayContent::dnfLevelOrder(TRACE), DisplayContent::dnfLevelOrder(DNFINVALID));
+    EXPECT_EQ(DisplayContent::dnfLevelIcon(ERROR), QString("wrong.svg"));
+    EXPECT_EQ(DisplayContent::dnfLevelIcon(DNFINVALID), QString());
 }
 TEST(DisplayContent_initTableView_UT, DisplayContent_initTableView_UT_001)
 {
@@ -887,6 +748,21 @@ TEST(DisplayContent_initConnections_UT, DisplayContent_initConnections_UT_001)
     delete p;
 }
 
+TEST(DisplayContent_ensureTypeSetup_UT, DisplayContent_ensureTypeSetup_UT_001)
+{
+    DisplayContent *p = new DisplayContent(nullptr);
+    //启动时不连接任何类别的获取信号
+    EXPECT_EQ(p->m_setupTypes.isEmpty(), true);
+    p->ensureTypeSetup(JOURNAL);
+    p->ensureTypeSetup(JOURNAL);
+    EXPECT_EQ(p->m_setupTypes.size(), 1);
+    //其他日志和自定义日志共用一组信号
+    p->ensureTypeSetup(OtherLog);
+    p->ensureTypeSetup(CustomLog);
+    EXPECT_EQ(p->m_setupTypes.size(), 2);
+    delete p;
+}
+
 class DisplayContent_generateJournalFile_UT_Param
 {
 public:
@@ -932,7 +808,7 @@ TEST(DisplayContent_createJournalTableStart_UT, DisplayContent_createJournalTabl
     for (int i = 0; i < 100; ++i) {
         LOG_MSG_JOURNAL item;
         item.msg = "";
-        item.level = "";
+        item.level = -1;
         item.daemonId = "";
         item.dateTime = "";
         item.hostName = "";
@@ -960,7 +836,7 @@ TEST(DisplayContent_createJournalTableForm_UT, DisplayContent_createJournalTable
       << Dtk::Widget::DApplication::translate("Table", "PID");
     bool rs = true;
     for (int i = 0; i < a.size(); ++i) {
-        if (p->m_pModel->horizontalHeaderItem(i)->text() != a.value(i)) {
+        if (p->m_pModel->headerData(i, Qt::Horizontal).toString() != a.value(i)) {
             rs = false;
         }
     }
@@ -1069,7 +945,7 @@ TEST(DisplayContent_createKernTableForm_UT, DisplayContent_createKernTableForm_U
       << Dtk::Widget::DApplication::translate("Table", "Info");
     bool rs = true;
     for (int i = 0; i < a.size(); ++i) {
-        if (p->m_pModel->horizontalHeaderItem(i)->text() != a.value(i)) {
+        if (p->m_pModel->headerData(i, Qt::Horizontal).toString() != a.value(i)) {
             rs = false;
         }
     }
@@ -1088,7 +964,7 @@ TEST(DisplayContent_createOOCTableForm_UT, DisplayContent_createOOCTableForm_UT_
       << DApplication::translate("Table", "Time Modified");
     bool rs = true;
     for (int i = 0; i < a.size(); ++i) {
-        if (p->m_pModel->horizontalHeaderItem(i)->text() != a.value(i)) {
+        if (p->m_pModel->headerData(i, Qt::Horizontal).toString() != a.value(i)) {
             rs = false;
         }
     }
@@ -1107,7 +983,7 @@ TEST(DisplayContent_createKernTable_UT, DisplayContent_createKernTable_UT_001)
     LOG_MSG_JOURNAL item;
     for (int i = 0; i < 100; ++i) {
         item.msg = QString("msg%1").arg(i);
-        item.level = "Debug";
+        item.level = DEB;
         item.daemonId = "1";
         item.dateTime = QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss");
         item.hostName = "test_host";
@@ -1144,7 +1020,7 @@ TEST(DisplayContent_insertKernTable_UT, DisplayContent_insertKernTable_UT_001)
     LOG_MSG_JOURNAL item;
     for (int i = 0; i < 100; ++i) {
         item.msg = QString("msg%1").arg(i);
-        item.level = "Debug";
+        item.level = DEB;
         item.daemonId = "1";
         item.dateTime = QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss");
         item.hostName = "test_host";
@@ -1201,7 +1077,7 @@ TEST(DisplayContent_createAppTableForm_UT, DisplayContent_createAppTableForm_UT_
       << Dtk::Widget::DApplication::translate("Table", "Info");
     bool rs = true;
     for (int i = 0; i < a.size(); ++i) {
-        if (p->m_pModel->horizontalHeaderItem(i)->text() != a.value(i)) {
+        if (p->m_pModel->headerData(i, Qt::Horizontal).toString() != a.value(i)) {
             rs = false;
         }
     }
@@ -1220,7 +1096,7 @@ TEST(DisplayContent_createAppTable_UT, DisplayContent_createAppTable_UT_001)
     LOG_MSG_APPLICATOIN item;
     for (int i = 0; i < 100; ++i) {
         item.msg = QString("msg%1").arg(i);
-        item.level = "Debug";
+        item.level = DEB;
         item.dateTime = QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss");
         item.src = "test_src";
         list.append(item);
@@ -1402,7 +1278,7 @@ TEST(DisplayContent_insertJournalTable_UT, DisplayContent_insertJournalTable_UT_
     LOG_MSG_JOURNAL item;
     for (int i = 0; i < 100; ++i) {
         item.msg = QString("msg%1").arg(i);
-        item.level = "Debug";
+        item.level = DEB;
         item.daemonId = "1";
         item.dateTime = QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss");
         item.hostName = "test_host";
@@ -1496,7 +1372,7 @@ TEST(DisplayContent_createJournalBootTableStart_UT, DisplayContent_createJournal
     for (int i = 0; i < 100; ++i) {
         LOG_MSG_JOURNAL item;
         item.msg = "";
-        item.level = "";
+        item.level = -1;
         item.daemonId = "";
         item.dateTime = "";
         item.hostName = "";
@@ -1524,7 +1400,7 @@ TEST(DisplayContent_createJournalBootTableForm_UT, DisplayContent_createJournalB
       << Dtk::Widget::DApplication::translate("Table", "PID");
     bool rs = true;
     for (int i = 0; i < a.size(); ++i) {
-        if (p->m_pModel->horizontalHeaderItem(i)->text() != a.value(i)) {
+        if (p->m_pModel->headerData(i, Qt::Horizontal).toString() != a.value(i)) {
             rs = false;
         }
     }
@@ -1543,7 +1419,7 @@ TEST(DisplayContent_insertJournalBootTable_UT, DisplayContent_insertJournalBootT
     LOG_MSG_JOURNAL item;
     for (int i = 0; i < 100; ++i) {
         item.msg = QString("msg%1").arg(i);
-        item.level = "Debug";
+        item.level = DEB;
         item.daemonId = "1";
         item.dateTime = QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss");
         item.hostName = "test_host";
@@ -1584,9 +1460,10 @@ TEST(DisplayContent_slot_requestShowRightMenu_UT, DisplayContent_slot_requestSho
     EXPECT_NE(p, nullptr);
     QPoint point(20, 10);
     p->m_flag = OtherLog;
-    QStandardItem * standItem = new QStandardItem ();
-    standItem->setData("path", Qt::UserRole + 2);
-    p->m_pModel->appendRow(QList<QStandardItem*>()<<new QStandardItem ()<<new QStandardItem ());
+    LOG_FILE_OTHERORCUSTOM ooc;
+    ooc.path = "path";
+    p->m_pModel->setHorizontalHeaderLabels(QStringList() << "Name" << "Date Modified");
+    p->parseListToModel(QList<LOG_FILE_OTHERORCUSTOM>() << ooc, p->m_pModel);
     p->m_treeView->selectionModel()->select(p->m_pModel->index(0, 0), QItemSelectionModel::Rows | QItemSelectionModel::Select);
     p->m_treeView->setCurrentIndex(p->m_pModel->index(0, 0));
     p->slot_requestShowRightMenu(point);
@@ -1909,7 +1786,7 @@ TEST(DisplayContent_slot_kernFinished_UT, DisplayContent_slot_kernFinished_UT_00
     LOG_MSG_JOURNAL item;
     for (int i = 0; i < 100; ++i) {
         item.msg = QString("msg%1").arg(i);
-        item.level = "Debug";
+        item.level = DEB;
         item.daemonId = "1";
         item.dateTime = QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss");
         item.hostName = "test_host";
@@ -1957,9 +1834,10 @@ TEST(DisplayContent_slot_OOCFinished_UT, DisplayContent_slot_OOCFinished_UT_001)
 {
     DisplayContent *p = new DisplayContent(nullptr);
     EXPECT_NE(p, nullptr);
-    QStandardItem * standItem = new QStandardItem ();
-    standItem->setData("path", Qt::UserRole + 2);
-    p->m_pModel->appendRow(QList<QStandardItem*>()<<new QStandardItem ()<<new QStandardItem ());
+    LOG_FILE_OTHERORCUSTOM ooc;
+    ooc.path = "path";
+    p->m_pModel->setHorizontalHeaderLabels(QStringList() << "Name" << "Date Modified");
+    p->parseListToModel(QList<LOG_FILE_OTHERORCUSTOM>() << ooc, p->m_pModel);
     p->m_treeView->selectionModel()->select(p->m_pModel->index(0, 0), QItemSelectionModel::Rows | QItemSelectionModel::Select);
     p->m_treeView->setCurrentIndex(p->m_pModel->index(0, 0));
     p->m_OOCCurrentIndex = 1;
@@ -1976,16 +1854,21 @@ TEST(DisplayContent_slot_OOCData_UT, DisplayContent_slot_OOCData_UT_001)
 {
     DisplayContent *p = new DisplayContent(nullptr);
     EXPECT_NE(p, nullptr);
-    QStandardItem * standItem = new QStandardItem ();
-    standItem->setData("path", Qt::UserRole + 2);
-    p->m_pModel->appendRow(QList<QStandardItem*>()<<new QStandardItem ()<<new QStandardItem ());
+    LOG_FILE_OTHERORCUSTOM ooc;
+    ooc.path = "path";
+    p->m_pModel->setHorizontalHeaderLabels(QStringList() << "Name" << "Date Modified");
+    p->parseListToModel(QList<LOG_FILE_OTHERORCUSTOM>() << ooc, p->m_pModel);
     p->m_treeView->selectionModel()->select(p->m_pModel->index(0, 0), QItemSelectionModel::Rows | QItemSelectionModel::Select);
     p->m_treeView->setCurrentIndex(p->m_pModel->index(0, 0));
     p->m_OOCCurrentIndex = 1;
+    std::shared_ptr<LogTextSource> source = std::make_shared<LogTextSource>("path");
+    source->setData("data\n");
+    std::atomic_bool canRun(true);
+    source->buildIndex(canRun);
     p->m_flag = OtherLog;
-    p->slot_OOCData(1, "data");
+    p->slot_OOCData(1, source);
     p->m_flag = CustomLog;
-    p->slot_OOCData(1, "data");
+    p->slot_OOCData(1, source);
     p->deleteLater();
 }
 
@@ -2024,7 +1907,7 @@ TEST_P(DisplayContent_slot_journalData_UT, DisplayContent_slot_journalData_UT_00
         LOG_MSG_JOURNAL item;
         for (int i = 0; i < 100; ++i) {
             item.msg = QString("msg%1").arg(i);
-            item.level = "Debug";
+            item.level = DEB;
             item.daemonId = "1";
             item.dateTime = QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss");
             item.hostName = "test_host";
@@ -2076,7 +1959,7 @@ TEST_P(DisplayContent_slot_journalBootData_UT, DisplayContent_slot_journalBootDa
         LOG_MSG_JOURNAL item;
         for (int i = 0; i < 100; ++i) {
             item.msg = QString("msg%1").arg(i);
-            item.level = "Debug";
+            item.level = DEB;
             item.daemonId = "1";
             item.dateTime = QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss");
             item.hostName = "test_host";
@@ -2104,7 +1987,7 @@ TEST(DisplayContent_slot_applicationFinished_UT, DisplayContent_slot_application
     LOG_MSG_APPLICATOIN item;
     for (int i = 0; i < 100; ++i) {
         item.msg = QString("msg%1").arg(i);
-        item.level = "Debug";
+        item.level = DEB;
         item.dateTime = QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss");
         item.src = "test_src";
         list.append(item);
@@ -2157,75 +2040,6 @@ TEST(DisplayContent_resizeEvent_UT, DisplayContent_resizeEvent_UT_001)
 ////    p->paintEvent(new QPaintEvent(p->rect()));
 ////    p->deleteLater();
 ////}
-class DisplayContent_slot_vScrollValueChanged_UT_Param
-{
-public:
-    DisplayContent_slot_vScrollValueChanged_UT_Param(LOG_FLAG iFlag, bool iIsTreeView, bool iIsTreeViewHeight, bool iIsLastHeight, bool iIsLoadData, bool iIsOutLoad)
-    {
-        m_flag = iFlag;
-        isTreeView = iIsTreeView;
-        isTreeViewHeight = iIsTreeViewHeight;
-        isLastHeight = iIsLastHeight;
-        isLoadData = iIsLoadData;
-        isOutLoad = iIsOutLoad;
-    }
-    LOG_FLAG m_flag;
-    bool isTreeView;
-    bool isTreeViewHeight;
-    bool isLastHeight;
-    bool isLoadData;
-    bool isOutLoad;
-};
-
-class DisplayContent_slot_vScrollValueChanged_UT : public ::testing::TestWithParam<DisplayContent_slot_vScrollValueChanged_UT_Param>
-{
-};
-int DisplayContent_slot_vScrollValueChanged_treeView_singleRowHeight = -1;
-int DisplayContent_slot_vScrollValueChanged_treeView_singleRowHeight_Func(void *obj)
-{
-    return DisplayContent_slot_vScrollValueChanged_treeView_singleRowHeight;
-}
-
-INSTANTIATE_TEST_CASE_P(DisplayContent, DisplayContent_slot_vScrollValueChanged_UT, ::testing::Values(DisplayContent_slot_vScrollValueChanged_UT_Param(JOURNAL, false, true, true, true, true), DisplayContent_slot_vScrollValueChanged_UT_Param(JOURNAL, true, false, true, true, true), DisplayContent_slot_vScrollValueChanged_UT_Param(JOURNAL, true, true, false, true, true), DisplayContent_slot_vScrollValueChanged_UT_Param(JOURNAL, true, true, true, false, true), DisplayContent_slot_vScrollValueChanged_UT_Param(JOURNAL, true, true, true, true, true), DisplayContent_slot_vScrollValueChanged_UT_Param(JOURNAL, true, true, true, true, false), DisplayContent_slot_vScrollValueChanged_UT_Param(BOOT_KLU, false, true, true, true, true), DisplayContent_slot_vScrollValueChanged_UT_Param(BOOT_KLU, true, false, true, true, true), DisplayContent_slot_vScrollValueChanged_UT_Param(BOOT_KLU, true, true, false, true, true), DisplayContent_slot_vScrollValueChanged_UT_Param(BOOT_KLU, true, true, true, false, true), DisplayContent_slot_vScrollValueChanged_UT_Param(BOOT_KLU, true, true, true, true, true), DisplayContent_slot_vScrollValueChanged_UT_Param(BOOT_KLU, true, true, true, true, false), DisplayContent_slot_vScrollValueChanged_UT_Param(APP, false, true, true, true, true), DisplayContent_slot_vScrollValueChanged_UT_Param(APP, true, false, true, true, true), DisplayContent_slot_vScrollValueChanged_UT_Param(APP, true, true, false, true, true), DisplayContent_slot_vScrollValueChanged_UT_Param(APP, true, true, true, false, true), DisplayContent_slot_vScrollValueChanged_UT_Param(APP, true, true, true, true, true), DisplayContent_slot_vScrollValueChanged_UT_Param(APP, true, true, true, true, false), DisplayContent_slot_vScrollValueChanged_UT_Param(KERN, false, true, true, true, true), DisplayContent_slot_vScrollValueChanged_UT_Param(KERN, true, false, true, true, true), DisplayContent_slot_vScrollValueChanged_UT_Param(KERN, true, true, false, true, true), DisplayContent_slot_vScrollValueChanged_UT_Param(KERN, true, true, true, false, true), DisplayContent_slot_vScrollValueChanged_UT_Param(KERN, true, true, true, true, true), DisplayContent_slot_vScrollValueChanged_UT_Param(KERN, true, true, true, true, false)));
-
-TEST_P(DisplayContent_slot_vScrollValueChanged_UT, DisplayContent_slot_vScrollValueChanged_UT_001)
-{
-    Stub stub;
-    stub.set(ADDR(JournalBootWork, getReplaceColorStr), stub_getReplaceColorStr_bootwork);
-    stub.set(ADDR(journalWork, getReplaceColorStr), stub_getReplaceColorStr_bootwork);
-    DisplayContent_slot_vScrollValueChanged_UT_Param param = GetParam();
-    DisplayContent *p = new DisplayContent(nullptr);
-    EXPECT_NE(p, nullptr);
-    int valuePixel = 0;
-
-    p->m_flag = param.m_flag;
-    if (!param.isTreeView) {
-        p->m_treeView->deleteLater();
-        p->m_treeView = nullptr;
-    }
-    DisplayContent_slot_vScrollValueChanged_treeView_singleRowHeight = param.isTreeViewHeight ? 20 : -1;
-    if (param.isLoadData) {
-        valuePixel = 190 * DisplayContent_slot_vScrollValueChanged_treeView_singleRowHeight;
-    } else {
-        valuePixel = 5 * DisplayContent_slot_vScrollValueChanged_treeView_singleRowHeight;
-    }
-    if (param.isOutLoad) {
-        p->m_limitTag = -1;
-    } else {
-        p->m_limitTag = (valuePixel / DisplayContent_slot_vScrollValueChanged_treeView_singleRowHeight + 25) / 200;
-    }
-    stub.set(ADDR(LogTreeView, singleRowHeight), DisplayContent_slot_vScrollValueChanged_treeView_singleRowHeight_Func);
-    stub.set((void (QThreadPool::*)(QRunnable *, int))ADDR(QThreadPool, start), QThreadPool_start);
-    stub.set(ADDR(QThread, start), QThread_start);
-    if (!param.isLastHeight) {
-        p->m_treeViewLastScrollValue = valuePixel;
-    } else {
-        p->m_treeViewLastScrollValue = -1;
-    }
-    p->slot_vScrollValueChanged(valuePixel);
-    p->deleteLater();
-}
-
 class DisplayContent_slot_searchResult_UT_Param
 {
 public:
@@ -2267,7 +2081,7 @@ TEST_P(DisplayContent_slot_searchResult_UT, DisplayContent_slot_searchResult_UT_
         LOG_MSG_JOURNAL item;
         for (int i = 0; i < 100; ++i) {
             item.msg = QString("msg%1").arg(i);
-            item.level = "Debug";
+            item.level = DEB;
             item.daemonId = "1";
             item.dateTime = QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss");
             item.hostName = "test_host";
@@ -2282,7 +2096,7 @@ TEST_P(DisplayContent_slot_searchResult_UT, DisplayContent_slot_searchResult_UT_
         LOG_MSG_JOURNAL item;
         for (int i = 0; i < 100; ++i) {
             item.msg = QString("msg%1").arg(i);
-            item.level = "Debug";
+            item.level = DEB;
             item.daemonId = "1";
             item.dateTime = QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss");
             item.hostName = "test_host";
@@ -2297,7 +2111,7 @@ TEST_P(DisplayContent_slot_searchResult_UT, DisplayContent_slot_searchResult_UT_
         LOG_MSG_JOURNAL item;
         for (int i = 0; i < 100; ++i) {
             item.msg = QString("msg%1").arg(i);
-            item.level = "Debug";
+            item.level = DEB;
             item.daemonId = "1";
             item.dateTime = QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss");
             item.hostName = "test_host";
@@ -2338,7 +2152,7 @@ TEST_P(DisplayContent_slot_searchResult_UT, DisplayContent_slot_searchResult_UT_
         LOG_MSG_APPLICATOIN item;
         for (int i = 0; i < 100; ++i) {
             item.msg = QString("msg%1").arg(i);
-            item.level = "Debug";
+            item.level = DEB;
             item.dateTime = QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss");
             item.src = "test_src";
             list.append(item);
@@ -2496,7 +2310,7 @@ TEST_P(DisplayContent_parseListToModel_APP_UT, DisplayContent_parseListToModel_A
         LOG_MSG_APPLICATOIN item;
         for (int i = 0; i < 100; ++i) {
             item.msg = QString("msg%1").arg(i);
-            item.level = "Debug";
+            item.level = DEB;
             item.dateTime = QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss");
             item.src = "test_src";
             list.append(item);
@@ -2730,6 +2544,23 @@ TEST_P(DisplayContent_setLoadState_UT, DisplayContent_setLoadState_UT)
     p->deleteLater();
 }
 
+TEST(DisplayContent_firstScreenReady_UT, DisplayContent_firstScreenReady_UT_001)
+{
+    DisplayContent *p = new DisplayContent(nullptr);
+    int ready = 0;
+    QObject::connect(p, &DisplayContent::firstScreenReady, [&ready]() {
+        ++ready;
+    });
+    //正在加载时还没有可操作的结果
+    p->setLoadState(DisplayContent::DATA_LOADING);
+    EXPECT_EQ(ready, 0);
+    p->setLoadState(DisplayContent::DATA_NO_SEARCH_RESULT);
+    EXPECT_EQ(ready, 1);
+    p->setLoadState(DisplayContent::DATA_COMPLETE);
+    EXPECT_EQ(ready, 1);
+    delete p;
+}
+
 class DisplayContent_onExportResult_UT_Param
 {
 public:
@@ -2861,9 +2692,10 @@ TEST_P(DisplayContent_filterBoot_UT, DisplayContent_filterBoot_UT)
     for (int i = 0; i < 100; ++i) {
         item.msg = QString("msg%1").arg(i);
         item.status = "OK";
+        item.statusCode = BootStatusOk;
         list.append(item);
     }
-    QList<LOG_MSG_BOOT> rslist = p->filterBoot(filter, list);
+    QList<LOG_MSG_BOOT> rslist = p->filterBoot(filter, list).toList();
 
     EXPECT_EQ(rslist.size(), 100);
     p->deleteLater();
@@ -2905,7 +2737,7 @@ TEST_P(DisplayContent_filterNomal_UT, DisplayContent_filterNomal_UT)
         list.append(item);
     }
 
-    QList<LOG_MSG_NORMAL> rslist = p->filterNomal(filter, list);
+    QList<LOG_MSG_NORMAL> rslist = p->filterNomal(filter, list).toList();
     int resultCount = (param.m_isEventTypeFilterEmpty && (!param.m_isMsgFilerEmpty)) ? 0 : 100;
 
     EXPECT_EQ(rslist.size(), resultCount);
@@ -2948,7 +2780,7 @@ TEST_P(DisplayContent_parseListToModel_JOURNAL_UT, DisplayContent_parseListToMod
         LOG_MSG_JOURNAL item;
         for (int i = 0; i < 100; ++i) {
             item.msg = QString("msg%1").arg(i);
-            item.level = "Debug";
+            item.level = DEB;
             item.daemonId = "1";
             item.dateTime = QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss");
             item.hostName = "test_host";
@@ -2961,31 +2793,28 @@ TEST_P(DisplayContent_parseListToModel_JOURNAL_UT, DisplayContent_parseListToMod
     p->deleteLater();
 }
 
-class DisplayContent_getIconByname_UT_Param
+class DisplayContent_levelIcon_UT_Param
 {
 public:
-    DisplayContent_getIconByname_UT_Param(const QString &iKey, const QString &iValue)
+    DisplayContent_levelIcon_UT_Param(int iKey, const QString &iValue)
         : key(iKey)
         , value(iValue)
     {
     }
-    QString key;
+    int key;
     QString value;
 };
 
-class DisplayContent_getIconByname_UT : public ::testing::TestWithParam<DisplayContent_getIconByname_UT_Param>
+class DisplayContent_levelIcon_UT : public ::testing::TestWithParam<DisplayContent_levelIcon_UT_Param>
 {
 };
 
-INSTANTIATE_TEST_CASE_P(DisplayContent, DisplayContent_getIconByname_UT, ::testing::Values(DisplayContent_getIconByname_UT_Param(DApplication::translate("Level", "Emergency"), "warning2.svg"), DisplayContent_getIconByname_UT_Param(DApplication::translate("Level", "Alert"), "warning3.svg"), DisplayContent_getIconByname_UT_Param(DApplication::translate("Level", "Critical"), "warning2.svg"), DisplayContent_getIconByname_UT_Param(DApplication::translate("Level", "Error"), "wrong.svg"), DisplayContent_getIconByname_UT_Param(DApplication::translate("Level", "Warning"), "warning.svg"), DisplayContent_getIconByname_UT_Param(DApplication::translate("Level", "Notice"), "warning.svg"), DisplayContent_getIconByname_UT_Param(DApplication::translate("Level", "Info"), ""), DisplayContent_getIconByname_UT_Param(DApplication::translate("Level", "Debug"), ""), DisplayContent_getIconByname_UT_Param("Warning", "warning.svg"), DisplayContent_getIconByname_UT_Param("Debug", ""), DisplayContent_getIconByname_UT_Param("Error", "wrong.svg")));
+INSTANTIATE_TEST_CASE_P(DisplayContent, DisplayContent_levelIcon_UT, ::testing::Values(DisplayContent_levelIcon_UT_Param(EMER, "warning2.svg"), DisplayContent_levelIcon_UT_Param(ALERT, "warning3.svg"), DisplayContent_levelIcon_UT_Param(CRI, "warning2.svg"), DisplayContent_levelIcon_UT_Param(ERR, "wrong.svg"), DisplayContent_levelIcon_UT_Param(WARN, "warning.svg"), DisplayContent_levelIcon_UT_Param(NOTICE, "warning.svg"), DisplayContent_levelIcon_UT_Param(INF, ""), DisplayContent_levelIcon_UT_Param(DEB, ""), DisplayContent_levelIcon_UT_Param(-1, "")));
 
-TEST_P(DisplayContent_getIconByname_UT, DisplayContent_getIconByname_UT)
+TEST_P(DisplayContent_levelIcon_UT, DisplayContent_levelIcon_UT)
 {
-    DisplayContent *p = new DisplayContent(nullptr);
-    EXPECT_NE(p, nullptr);
-    DisplayContent_getIconByname_UT_Param param = GetParam();
-    EXPECT_EQ(p->getIconByname(param.key), param.value);
-    p->deleteLater();
+    DisplayContent_levelIcon_UT_Param param = GetParam();
+    EXPECT_EQ(DisplayContent::levelIcon(param.key), param.value);
 }
 
 TEST(DisplayContent_createApplicationTable_UT, DisplayContent_createApplicationTable_UT_001)
@@ -2996,13 +2825,14 @@ TEST(DisplayContent_createApplicationTable_UT, DisplayContent_createApplicationT
     LOG_MSG_APPLICATOIN item;
     for (int i = 0; i < 100; ++i) {
         item.msg = QString("msg%1").arg(i);
-        item.level = "Debug";
+        item.level = DEB;
         item.dateTime = QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss");
         item.src = "test_src";
         list.append(item);
     }
     p->createAppTable(list);
-    EXPECT_EQ(p->m_limitTag, 0);
+    //不再分页,全部记录一次进入model
+    EXPECT_EQ(p->m_pModel->rowCount(), 100);
     EXPECT_NE(p->m_pModel,nullptr);
     p->deleteLater();
 }
@@ -3032,7 +2862,7 @@ TEST_P(DisplayContent_insertApplicationTable_UT, DisplayContent_insertApplicatio
     LOG_MSG_APPLICATOIN item;
     for (int i = 0; i < 100; ++i) {
         item.msg = QString("msg%1").arg(i);
-        item.level = "Debug";
+        item.level = DEB;
         item.dateTime = QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss");
         item.src = "test_src";
         list.append(item);
@@ -3149,3 +2979,51 @@ void displaycontent_test::TearDown()
 {
 
 }
+
+static void stub_runNow(QRunnable *runnable, int priority = 0)
+{
+    Q_UNUSED(priority);
+    runnable->run();
+    if (runnable->autoDelete())
+        delete runnable;
+}
+
+TEST(DisplayContent_slot_searchResult_UT, DisplayContent_slot_searchResult_refine_UT_001)
+{
+    Stub stub;
+    stub.set((void (QThreadPool::*)(QRunnable *, int))ADDR(QThreadPool, start), stub_runNow);
+    DisplayContent *p = new DisplayContent(nullptr);
+    p->m_flag = Kwin;
+    QStringList msgs = QStringList() << "netw down" << "network up" << "disk" << "Network ok";
+    for (const QString &msg : msgs) {
+        LOG_MSG_KWIN item;
+        item.msg = msg;
+        p->m_kwinList.append(item);
+    }
+
+    p->slot_searchResult("netw");
+    EXPECT_EQ(p->m_currentKwinList.size(), 3);
+    EXPECT_EQ(p->m_searchState.matches, QVector<int>() << 0 << 1 << 3);
+    EXPECT_EQ(p->m_searchState.hasCandidates, false);
+
+    //追加字符只在上一次的结果中继续搜索
+    p->slot_searchResult("network");
+    EXPECT_EQ(p->m_searchState.hasCandidates, true);
+    EXPECT_EQ(p->m_searchState.candidates, QVector<int>() << 0 << 1 << 3);
+    EXPECT_EQ(p->m_currentKwinList.size(), 2);
+    EXPECT_EQ(p->m_pModel->rowCount(), 2);
+
+    //删除字符回到全部记录
+    p->slot_searchResult("net");
+    EXPECT_EQ(p->m_searchState.hasCandidates, false);
+    EXPECT_EQ(p->m_currentKwinList.size(), 3);
+
+    //列表变化后不复用
+    LOG_MSG_KWIN item;
+    item.msg = "netlink";
+    p->m_kwinList.append(item);
+    p->slot_searchResult("netl");
+    EXPECT_EQ(p->m_searchState.hasCandidates, false);
+    EXPECT_EQ(p->m_currentKwinList.size(), 1);
+    p->deleteLater();
+}
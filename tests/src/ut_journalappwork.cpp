@@ -0,0 +1,59 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <stub.h>
+#include "journalappwork.h"
+#include "journalreader.h"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+QByteArrayList s_matches;
+
+int stub_sd_journal_add_match(sd_journal *j, const void *data, size_t size)
+{
+    Q_UNUSED(j)
+    s_matches.append(QByteArray(static_cast<const char *>(data), static_cast<int>(size)));
+    return 0;
+}
+
+LOG_MSG_APPLICATOIN record(const QString &src, const QString &msg)
+{
+    LOG_MSG_APPLICATOIN r;
+    r.src = src;
+    r.msg = msg;
+    return r;
+}
+
+} // namespace
+
+TEST(AppJournalPolicy_addMatches_UT, AppJournalPolicy_addMatches_UT_001)
+{
+    Stub stub;
+    stub.set(sd_journal_add_match, stub_sd_journal_add_match);
+    s_matches.clear();
+
+    AppJournalPolicy policy;
+    EXPECT_EQ(policy.addMatches(nullptr), 0);
+    EXPECT_EQ(s_matches.isEmpty(), true);
+
+    //同一字段的多个匹配由sd-journal作为或条件处理,不插入析取
+    policy.identifiers << "deepin-editor" << "dde-calendar";
+    EXPECT_EQ(policy.addMatches(nullptr), 0);
+    EXPECT_EQ(s_matches, QByteArrayList() << "SYSLOG_IDENTIFIER=deepin-editor" << "SYSLOG_IDENTIFIER=dde-calendar");
+}
+
+TEST(JournalAppWork_demultiplex_UT, JournalAppWork_demultiplex_UT_001)
+{
+    const QList<LOG_MSG_APPLICATOIN> list = QList<LOG_MSG_APPLICATOIN>()
+                                            << record("a", "1") << record("b", "2") << record("a", "3");
+    const QMap<QString, QList<LOG_MSG_APPLICATOIN>> apps = JournalAppWork::demultiplex(list);
+    ASSERT_EQ(apps.size(), 2);
+    ASSERT_EQ(apps.value("a").size(), 2);
+    EXPECT_EQ(apps.value("a").at(0).msg, QString("1"));
+    EXPECT_EQ(apps.value("a").at(1).msg, QString("3"));
+    EXPECT_EQ(apps.value("b").at(0).msg, QString("2"));
+    EXPECT_EQ(JournalAppWork::demultiplex(QList<LOG_MSG_APPLICATOIN>()).isEmpty(), true);
+}
@@ -51,7 +51,6 @@ TEST(JournalBootWork_Destructor_UT, JournalBootWork_Destructor_UT_001)
     EXPECT_NE(p, nullptr);
     p->~JournalBootWork();
     EXPECT_EQ(p->logList.isEmpty(), true);
-    EXPECT_EQ(p->m_map.isEmpty(), true);
     p->deleteLater();
 }
 
@@ -123,50 +122,11 @@ TEST(JournalBootWork_getDateTimeFromStamp_UT, JournalBootWork_getDateTimeFromSta
     p->deleteLater();
 }
 
-TEST(JournalBootWork_initMap_UT, JournalBootWork_initMap_UT)
-{
-    JournalBootWork *p = new JournalBootWork(nullptr);
-    EXPECT_NE(p, nullptr);
-    p->initMap();
-    QMap<int, QString> map;
-    map.insert(0, Dtk::Widget::DApplication::translate("Level", "Emergency"));
-    map.insert(1, Dtk::Widget::DApplication::translate("Level", "Alert"));
-    map.insert(2, Dtk::Widget::DApplication::translate("Level", "Critical"));
-    map.insert(3, Dtk::Widget::DApplication::translate("Level", "Error"));
-    map.insert(4, Dtk::Widget::DApplication::translate("Level", "Warning"));
-    map.insert(5, Dtk::Widget::DApplication::translate("Level", "Notice"));
-    map.insert(6, Dtk::Widget::DApplication::translate("Level", "Info"));
-    map.insert(7, Dtk::Widget::DApplication::translate("Level", "Debug"));
-    EXPECT_EQ(map, p->m_map);
-    p->deleteLater();
-}
-
-TEST(JournalBootWork_i2str_UT, JournalBootWork_i2str_UT)
-{
-    JournalBootWork *p = new JournalBootWork(nullptr);
-    EXPECT_NE(p, nullptr);
-    QMap<int, QString> map;
-    map.insert(0, Dtk::Widget::DApplication::translate("Level", "Emergency"));
-    map.insert(1, Dtk::Widget::DApplication::translate("Level", "Alert"));
-    map.insert(2, Dtk::Widget::DApplication::translate("Level", "Critical"));
-    map.insert(3, Dtk::Widget::DApplication::translate("Level", "Error"));
-    map.insert(4, Dtk::Widget::DApplication::translate("Level", "Warning"));
-    map.insert(5, Dtk::Widget::DApplication::translate("Level", "Notice"));
-    map.insert(6, Dtk::Widget::DApplication::translate("Level", "Info"));
-    map.insert(7, Dtk::Widget::DApplication::translate("Level", "Debug"));
-    foreach (int key, map.keys()) {
-        EXPECT_EQ(p->i2str(key), map.value(key));
-    }
-
-    p->deleteLater();
-}
-
 int stub_sd_journal_open(sd_journal **ret, int flags)
 {
     return -1;
 }
 
-
 class JournalBootWork_UT : public testing::Test
 {
 public:
@@ -191,7 +151,6 @@ public:
     JournalBootWork *m_bootWork;
 };
 
-
 TEST_F(JournalBootWork_UT, testBootWork_UT001)
 {
     Stub stub;
@@ -0,0 +1,142 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <stub.h>
+#include "journalfielddecoder.h"
+
+#include <gtest/gtest.h>
+
+#include <string.h>
+
+TEST(JournalFieldDecoder_decode_UT, JournalFieldDecoder_decode_UT_001)
+{
+    const char *data = "MESSAGE=a=b=c";
+    EXPECT_EQ(JournalFieldDecoder::decode(data, strlen(data)), QString("a=b=c"));
+}
+
+TEST(JournalFieldDecoder_decode_UT, JournalFieldDecoder_decode_UT_002)
+{
+    const char *data = "MESSAGE";
+    EXPECT_EQ(JournalFieldDecoder::decode(data, strlen(data)).isEmpty(), true);
+    EXPECT_EQ(JournalFieldDecoder::decode(nullptr, 0).isEmpty(), true);
+}
+
+TEST(JournalFieldDecoder_decode_UT, JournalFieldDecoder_decode_UT_003)
+{
+    //不以'\0'结尾的数据只取length范围内的内容
+    const char data[] = {'_', 'P', 'I', 'D', '=', '1', '2', '3', '4'};
+    EXPECT_EQ(JournalFieldDecoder::decode(data, 7), QString("12"));
+}
+
+TEST(JournalFieldDecoder_sanitize_UT, JournalFieldDecoder_sanitize_UT_001)
+{
+    const char *data = "\033[40;37mtest\033[0m";
+    EXPECT_EQ(JournalFieldDecoder::sanitize(data, strlen(data)), QString("test"));
+}
+
+TEST(JournalFieldDecoder_sanitize_UT, JournalFieldDecoder_sanitize_UT_002)
+{
+    const char data[] = {'a', '\0', 'b', '\x01', 'c', '\x02', 'd'};
+    EXPECT_EQ(JournalFieldDecoder::sanitize(data, sizeof(data)), QString("abcd"));
+}
+
+TEST(JournalFieldDecoder_sanitize_UT, JournalFieldDecoder_sanitize_UT_003)
+{
+    //不完整或超过三组参数的序列不是颜色序列,保留原样
+    const char *data = "\033[1;2;3;4mx";
+    EXPECT_EQ(JournalFieldDecoder::sanitize(data, strlen(data)), QString(data));
+    const char *data2 = "\033[m";
+    EXPECT_EQ(JournalFieldDecoder::sanitize(data2, strlen(data2)), QString(data2));
+}
+
+static const char s_prefixData[] = "MESSAGE=ab\xe4\xb8\xad" "cd";
+
+int stub_sd_journal_get_data_prefix(sd_journal *j, const char *field, const void **data, size_t *l)
+{
+    Q_UNUSED(j)
+    Q_UNUSED(field)
+    *data = s_prefixData;
+    *l = strlen(s_prefixData);
+    return 0;
+}
+
+TEST(JournalFieldDecoder_fieldPrefix_UT, JournalFieldDecoder_fieldPrefix_UT_001)
+{
+    Stub stub;
+    stub.set(sd_journal_get_data, stub_sd_journal_get_data_prefix);
+    QString value;
+    bool truncated = false;
+    //截断位置落在"中"的UTF-8编码中间,回退到字符边界
+    EXPECT_EQ(JournalFieldDecoder::fieldPrefix(nullptr, "MESSAGE", 4, value, truncated), true);
+    EXPECT_EQ(truncated, true);
+    EXPECT_EQ(value, QString("ab"));
+
+    EXPECT_EQ(JournalFieldDecoder::fieldPrefix(nullptr, "MESSAGE", 64, value, truncated), true);
+    EXPECT_EQ(truncated, false);
+    EXPECT_EQ(value, QString::fromUtf8("ab\xe4\xb8\xad" "cd"));
+}
+
+TEST(JournalFieldDecoder_prefix_UT, JournalFieldDecoder_prefix_UT_001)
+{
+    //按清洗后的长度截断,颜色序列不占长度,也不会被截成半个序列
+    const char *data = "ab\033[31mcd";
+    bool truncated = false;
+    EXPECT_EQ(JournalFieldDecoder::prefix(data, strlen(data), 4, truncated), QString("abcd"));
+    EXPECT_EQ(truncated, false);
+    EXPECT_EQ(JournalFieldDecoder::prefix(data, strlen(data), 3, truncated), QString("abc"));
+    EXPECT_EQ(truncated, true);
+
+    //截断位置之后只剩颜色序列时不算截断
+    const char *data2 = "abcd\033[0m";
+    EXPECT_EQ(JournalFieldDecoder::prefix(data2, strlen(data2), 4, truncated), QString("abcd"));
+    EXPECT_EQ(truncated, false);
+}
+
+static const char *const s_entryData[] = {"_PID=42", "MESSAGE_ID=abc", "MESSAGE=hello\x1b[31mworld", "PRIORITY=3", "_HOSTNAME=host"};
+static int s_entryIndex = 0;
+
+void stub_sd_journal_restart_data(sd_journal *j)
+{
+    Q_UNUSED(j)
+    s_entryIndex = 0;
+}
+
+int stub_sd_journal_enumerate_data(sd_journal *j, const void **data, size_t *l)
+{
+    Q_UNUSED(j)
+    if (s_entryIndex >= static_cast<int>(sizeof(s_entryData) / sizeof(s_entryData[0])))
+        return 0;
+    *data = s_entryData[s_entryIndex];
+    *l = strlen(s_entryData[s_entryIndex]);
+    ++s_entryIndex;
+    return 1;
+}
+
+TEST(JournalEntryFields_read_UT, JournalEntryFields_read_UT_001)
+{
+    Stub stub;
+    stub.set(sd_journal_restart_data, stub_sd_journal_restart_data);
+    stub.set(sd_journal_enumerate_data, stub_sd_journal_enumerate_data);
+    JournalEntryFields fields(QList<QByteArray>() << "_HOSTNAME" << "MESSAGE" << "_COMM");
+    const int hostname = JournalEntryFields::PolicyField;
+    fields.read(nullptr);
+
+    qint64 prio = 0;
+    EXPECT_EQ(fields.fieldNumber(JournalEntryFields::Priority, prio), true);
+    EXPECT_EQ(prio, 3);
+    EXPECT_EQ(fields.contains(JournalEntryFields::SourceRealtime), false);
+
+    QString value;
+    LogStringPool pool;
+    EXPECT_EQ(fields.field(hostname, value, pool), true);
+    EXPECT_EQ(value, QString("host"));
+    //字段名只按完整名称匹配,MESSAGE_ID不会当作MESSAGE
+    EXPECT_EQ(fields.field(hostname + 1, value), true);
+    EXPECT_EQ(value, QString("helloworld"));
+    bool truncated = false;
+    EXPECT_EQ(fields.fieldPrefix(hostname + 1, 3, value, truncated), true);
+    EXPECT_EQ(truncated, true);
+    EXPECT_EQ(value, QString("hel"));
+    EXPECT_EQ(fields.field(hostname + 2, value), false);
+}
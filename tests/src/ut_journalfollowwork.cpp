@@ -0,0 +1,35 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "journalfollowwork.h"
+
+#include <gtest/gtest.h>
+
+TEST(JournalFollowWork_Constructor_UT, JournalFollowWork_Constructor_UT_001)
+{
+    JournalFollowWork *p = new JournalFollowWork(nullptr);
+    EXPECT_NE(p, nullptr);
+    EXPECT_EQ(p->m_canRun, true);
+    EXPECT_EQ(p->getIndex(), JournalFollowWork::getPublicIndex());
+    p->deleteLater();
+}
+
+TEST(JournalFollowWork_setStartCursor_UT, JournalFollowWork_setStartCursor_UT_001)
+{
+    JournalFollowWork *p = new JournalFollowWork(nullptr);
+    p->setArg(QStringList() << "all");
+    p->setStartCursor("s=abc;i=1");
+    EXPECT_EQ(p->m_arg, QStringList() << "all");
+    EXPECT_EQ(p->m_startCursor, QByteArray("s=abc;i=1"));
+    p->deleteLater();
+}
+
+TEST(JournalFollowWork_stopWork_UT, JournalFollowWork_stopWork_UT_001)
+{
+    //线程启动前停止,启动后也不能再跑
+    JournalFollowWork *p = new JournalFollowWork(nullptr);
+    p->stopWork();
+    EXPECT_EQ(p->m_canRun, false);
+    p->deleteLater();
+}
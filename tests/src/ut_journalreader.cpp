@@ -0,0 +1,243 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <stub.h>
+#include "journalreader.h"
+
+#include <gtest/gtest.h>
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QLocale>
+#include <QTemporaryDir>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+TEST(JournalReadOptions_fromArgs_UT, JournalReadOptions_fromArgs_UT_001)
+{
+    JournalReadOptions options = JournalReadOptions::fromArgs(QStringList() << "all");
+    EXPECT_EQ(options.priorityMatch.isEmpty(), true);
+    EXPECT_EQ(options.hasTimeRange, false);
+}
+
+TEST(JournalReadOptions_fromArgs_UT, JournalReadOptions_fromArgs_UT_002)
+{
+    JournalReadOptions options = JournalReadOptions::fromArgs(QStringList() << "PRIORITY=3" << "1000000" << "2000000");
+    EXPECT_EQ(options.priorityMatch, QByteArray("PRIORITY=3"));
+    EXPECT_EQ(options.hasTimeRange, true);
+    EXPECT_EQ(options.beginTime, 1000000u);
+    EXPECT_EQ(options.endTime, 2000000u);
+}
+
+TEST(JournalReadOptions_fromArgs_UT, JournalReadOptions_fromArgs_UT_003)
+{
+    //应用日志只有等级和应用名时没有时间范围
+    JournalReadOptions options = JournalReadOptions::fromArgs(QStringList() << "all" << "deepin-log-viewer");
+    EXPECT_EQ(options.hasTimeRange, false);
+    options = JournalReadOptions::fromArgs(QStringList() << "all" << "abc" << "def");
+    EXPECT_EQ(options.hasTimeRange, false);
+}
+
+TEST(JournalReadOptions_fromArgs_UT, JournalReadOptions_fromArgs_UT_004)
+{
+    JournalReadOptions options = JournalReadOptions::fromArgs(QStringList() << "all" << "_SYSTEMD_UNIT=sshd.service" << "PRIORITY=3"
+                                                                            << "+" << "_SYSTEMD_USER_UNIT=sshd.service" << "PRIORITY=3");
+    ASSERT_EQ(options.matches.size(), 2);
+    EXPECT_EQ(options.matches.at(0), QByteArrayList() << "_SYSTEMD_UNIT=sshd.service" << "PRIORITY=3");
+    EXPECT_EQ(options.matches.at(1), QByteArrayList() << "_SYSTEMD_USER_UNIT=sshd.service" << "PRIORITY=3");
+    //应用名等其他参数不是字段匹配
+    options = JournalReadOptions::fromArgs(QStringList() << "all" << "deepin-log-viewer" << "a=b");
+    EXPECT_EQ(options.matches.isEmpty(), true);
+}
+
+TEST(JournalReadOptions_fromArgs_UT, JournalReadOptions_fromArgs_UT_005)
+{
+    JournalReadOptions options = JournalReadOptions::fromArgs(QStringList() << "PRIORITY=3" << "_PID=1" << "PRIORITY=2" << "PRIORITY=3"
+                                                                            << "+" << "_PID=2" << "PRIORITY=4");
+    EXPECT_EQ(options.priorityMatch.isEmpty(), true);
+    ASSERT_EQ(options.matches.size(), 1);
+    EXPECT_EQ(options.matches.at(0), QByteArrayList() << "_PID=1" << "PRIORITY=3");
+
+    options = JournalReadOptions::fromArgs(QStringList() << "PRIORITY=3" << "PRIORITY=4");
+    ASSERT_EQ(options.matches.size(), 1);
+    EXPECT_EQ(options.matches.at(0), QByteArrayList() << "PRIORITY=none");
+}
+
+TEST(JournalReaderBase_formatTime_UT, JournalReaderBase_formatTime_UT_001)
+{
+    quint64 usec = 1600000000ULL * 1000000ULL + 123456ULL;
+    EXPECT_EQ(JournalReaderBase::formatTime(usec), QDateTime::fromTime_t(1600000000).toString("yyyy-MM-dd hh:mm:ss"));
+}
+
+TEST(JournalReaderBase_partitionFiles_UT, JournalReaderBase_partitionFiles_UT_001)
+{
+    QStringList files {"/tmp/a.journal", "/tmp/b.journal", "/tmp/c.journal"};
+    QList<QStringList> groups = JournalReaderBase::partitionFiles(files, 2);
+    EXPECT_EQ(groups.size(), 2);
+    EXPECT_EQ(groups.at(0).size() + groups.at(1).size(), 3);
+    EXPECT_EQ(groups.at(0).isEmpty() || groups.at(1).isEmpty(), false);
+}
+
+TEST(JournalReaderBase_partitionFiles_UT, JournalReaderBase_partitionFiles_UT_002)
+{
+    //组数不超过文件数
+    QList<QStringList> groups = JournalReaderBase::partitionFiles(QStringList() << "/tmp/a.journal", 4);
+    EXPECT_EQ(groups.size(), 1);
+    EXPECT_EQ(JournalReaderBase::partitionFiles(QStringList(), 4).isEmpty(), true);
+}
+
+TEST(JournalReaderBase_directoryFiles_UT, JournalReaderBase_directoryFiles_UT_001)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    const QString machineA = "0123456789abcdef0123456789abcdef";
+    const QString machineB = "fedcba9876543210fedcba9876543210";
+    const QStringList paths {"node1/var/log/journal/" + machineA + "/system.journal",
+                             "node1/var/log/journal/" + machineA + "/user-1000.journal",
+                             "node1/run/log/journal/" + machineA + "/system.journal",
+                             "node2/" + machineB + "/system@0001.journal~",
+                             "node2/remote/remote-host3.journal",
+                             "node2/remote/remote-host3@0001-0002.journal",
+                             "node2/remote/readme.txt"};
+    for (const QString &path : paths) {
+        QDir().mkpath(QFileInfo(dir.filePath(path)).absolutePath());
+        QFile file(dir.filePath(path));
+        ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    }
+
+    //系统根目录读取持久化和易失日志,同一机器的文件合并;远程保存的文件按主机归组
+    const QMap<QString, QStringList> machines = JournalReaderBase::directoryFiles(QStringList() << dir.filePath("node1") << dir.filePath("node2"));
+    EXPECT_EQ(machines.keys(), QStringList() << machineA << machineB << "host3");
+    EXPECT_EQ(machines.value(machineA).size(), 3);
+    EXPECT_EQ(machines.value(machineB).size(), 1);
+    EXPECT_EQ(machines.value("host3").size(), 2);
+
+    //同一台机器的文件在同一组
+    const QList<QStringList> groups = JournalReaderBase::partitionMachines(machines, 2);
+    EXPECT_EQ(groups.size(), 2);
+    for (const QStringList &group : groups) {
+        const bool hasA = group.contains(machines.value(machineA).first());
+        for (const QString &file : machines.value(machineA))
+            EXPECT_EQ(group.contains(file), hasA);
+    }
+    EXPECT_EQ(groups.at(0).size() + groups.at(1).size(), 6);
+    EXPECT_EQ(JournalReaderBase::partitionMachines(machines, 8).size(), 3);
+}
+
+TEST(JournalReaderBase_openJournal_UT, JournalReaderBase_openJournal_UT_001)
+{
+    //来源目录中没有journal文件时不退回读取本机日志
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    JournalReaderBase::setSourceDirectories(QStringList() << dir.path());
+    sd_journal *j = nullptr;
+    EXPECT_EQ(JournalReaderBase::openJournal(&j), -ENOENT);
+    EXPECT_EQ(j, nullptr);
+    JournalReaderBase::setSourceDirectories(QStringList());
+    EXPECT_TRUE(JournalReaderBase::sourceDirectories().isEmpty());
+}
+
+TEST(JournalMessageResolver_resolve_UT, JournalMessageResolver_resolve_UT_001)
+{
+    //信息完整的记录不需要读取journal
+    JournalMessageResolver resolver;
+    LOG_MSG_JOURNAL record;
+    record.msg = "test message";
+    resolver.resolve(record);
+    EXPECT_EQ(record.msg, QString("test message"));
+    EXPECT_EQ(resolver.m_journal, nullptr);
+    EXPECT_EQ(resolver.messageContains(record, "MESSAGE"), true);
+    EXPECT_EQ(resolver.messageContains(record, "other"), false);
+    EXPECT_EQ(resolver.message(QByteArray()).isEmpty(), true);
+}
+
+TEST(JournalExeNameCache_daemonName_UT, JournalExeNameCache_daemonName_UT_001)
+{
+    JournalExeNameCache cache;
+    EXPECT_EQ(cache.daemonName("/not/exist/exe"), QString("unknown"));
+    EXPECT_EQ(cache.m_names.size(), 1);
+    //再次获取走缓存
+    EXPECT_EQ(cache.daemonName("/not/exist/exe"), QString("unknown"));
+    EXPECT_EQ(cache.m_names.size(), 1);
+}
+
+TEST(JournalTimeFormatter_format_UT, JournalTimeFormatter_format_UT_001)
+{
+    //缓存的结果和逐条格式化一致,包括跨天和同一秒
+    JournalTimeFormatter formatter;
+    const quint64 base = 1600000000ULL * 1000000ULL;
+    const quint64 steps[] = {0, 500, 1000000, 59000000, 3600000000ULL, 86399000000ULL, 86400000000ULL, 200000000000ULL};
+    for (quint64 step : steps) {
+        quint64 usec = base + step;
+        EXPECT_EQ(formatter.format(usec), JournalReaderBase::formatTime(usec));
+    }
+    EXPECT_EQ(formatter.format(base), JournalReaderBase::formatTime(base));
+}
+
+TEST(JournalTimeFormatter_format_UT, JournalTimeFormatter_format_UT_002)
+{
+    //last格式的日期前缀和只有时分的格式
+    JournalTimeFormatter start(QStringLiteral("ddd MMM d "), false);
+    JournalTimeFormatter clock(QString(), false);
+    const qint64 base = 1600000000;
+    const qint64 steps[] = {0, 59, 3600, 86400, 86400 * 40};
+    for (qint64 step : steps) {
+        const QDateTime dt = QDateTime::fromSecsSinceEpoch(base + step);
+        EXPECT_EQ(start.formatSecs(base + step), QLocale(QLocale::English).toString(dt, "ddd MMM d hh:mm"));
+        EXPECT_EQ(clock.formatSecs(base + step), dt.toString("hh:mm"));
+    }
+}
+
+TEST(JournalTimeFormatter_forThread_UT, JournalTimeFormatter_forThread_UT_001)
+{
+    //每个线程一份实例,同时格式化不同的日期互不影响
+    JournalTimeFormatter *mine = &JournalTimeFormatter::forThread();
+    EXPECT_EQ(&JournalTimeFormatter::forThread(), mine);
+    const quint64 base = 1600000000ULL * 1000000ULL;
+    std::vector<std::thread> threads;
+    std::atomic_int mismatched(0);
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([t, base, mine, &mismatched]() {
+            if (&JournalTimeFormatter::forThread() == mine)
+                ++mismatched;
+            for (int i = 0; i < 2000; ++i) {
+                const quint64 usec = base + static_cast<quint64>(t * 2000 + i) * 43200000000ULL;
+                if (JournalTimeFormatter::forThread().format(usec) != JournalReaderBase::formatTime(usec))
+                    ++mismatched;
+            }
+        });
+    }
+    for (std::thread &thread : threads)
+        thread.join();
+    EXPECT_EQ(mismatched.load(), 0);
+}
+
+int stub_sd_journal_open_fail(sd_journal **ret, int flags)
+{
+    Q_UNUSED(ret)
+    Q_UNUSED(flags)
+    return -EPERM;
+}
+
+TEST(JournalReaderBase_bootCatalog_UT, JournalReaderBase_bootCatalog_UT_001)
+{
+    //无法打开journal时启动列表为空
+    Stub stub;
+    stub.set(sd_journal_open, stub_sd_journal_open_fail);
+    EXPECT_EQ(JournalReaderBase::bootCatalog().isEmpty(), true);
+}
+
+TEST(JournalReaderBase_uniqueValues_UT, JournalReaderBase_uniqueValues_UT_001)
+{
+    //无法打开journal时没有任何取值
+    Stub stub;
+    stub.set(sd_journal_open, stub_sd_journal_open_fail);
+    bool truncated = true;
+    EXPECT_EQ(JournalReaderBase::uniqueValues("_SYSTEMD_UNIT", 10, &truncated).isEmpty(), true);
+    EXPECT_FALSE(truncated);
+}
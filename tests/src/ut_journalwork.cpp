@@ -49,7 +49,6 @@ TEST(journalWork_Destructor_UT, journalWork_Destructor_UT_001)
     EXPECT_NE(p, nullptr);
     p->~journalWork();
     EXPECT_EQ(p->logList.isEmpty(), true);
-    EXPECT_EQ(p->m_map.isEmpty(), true);
     p->deleteLater();
 }
 
@@ -90,6 +89,17 @@ TEST(journalWork_setArg_UT, journalWork_setArg_UT_002)
     p->deleteLater();
 }
 
+TEST(journalWork_setStopCursor_UT, journalWork_setStopCursor_UT_001)
+{
+    journalWork *p = new journalWork(nullptr);
+    EXPECT_NE(p, nullptr);
+    p->setStopCursor("s=test;i=1");
+    EXPECT_EQ(p->m_stopCursor, QByteArray("s=test;i=1"));
+    p->setStopCursor(QString());
+    EXPECT_EQ(p->m_stopCursor.isEmpty(), true);
+    p->deleteLater();
+}
+
 TEST(journalWork_doWork_UT, journalWork_doWork_UT)
 {
     journalWork *p = new journalWork(nullptr);
@@ -118,40 +128,3 @@ TEST(journalWork_getDateTimeFromStamp_UT, journalWork_getDateTimeFromStamp_UT)
     p->deleteLater();
 }
 
-TEST(journalWork_initMap_UT, journalWork_initMap_UT)
-{
-    journalWork *p = new journalWork(nullptr);
-    EXPECT_NE(p, nullptr);
-    p->initMap();
-    QMap<int, QString> map;
-    map.insert(0, Dtk::Widget::DApplication::translate("Level", "Emergency"));
-    map.insert(1, Dtk::Widget::DApplication::translate("Level", "Alert"));
-    map.insert(2, Dtk::Widget::DApplication::translate("Level", "Critical"));
-    map.insert(3, Dtk::Widget::DApplication::translate("Level", "Error"));
-    map.insert(4, Dtk::Widget::DApplication::translate("Level", "Warning"));
-    map.insert(5, Dtk::Widget::DApplication::translate("Level", "Notice"));
-    map.insert(6, Dtk::Widget::DApplication::translate("Level", "Info"));
-    map.insert(7, Dtk::Widget::DApplication::translate("Level", "Debug"));
-    EXPECT_EQ(map, p->m_map);
-    p->deleteLater();
-}
-
-TEST(journalWork_i2str_UT, journalWork_i2str_UT)
-{
-    journalWork *p = new journalWork(nullptr);
-    EXPECT_NE(p, nullptr);
-    QMap<int, QString> map;
-    map.insert(0, Dtk::Widget::DApplication::translate("Level", "Emergency"));
-    map.insert(1, Dtk::Widget::DApplication::translate("Level", "Alert"));
-    map.insert(2, Dtk::Widget::DApplication::translate("Level", "Critical"));
-    map.insert(3, Dtk::Widget::DApplication::translate("Level", "Error"));
-    map.insert(4, Dtk::Widget::DApplication::translate("Level", "Warning"));
-    map.insert(5, Dtk::Widget::DApplication::translate("Level", "Notice"));
-    map.insert(6, Dtk::Widget::DApplication::translate("Level", "Info"));
-    map.insert(7, Dtk::Widget::DApplication::translate("Level", "Debug"));
-    foreach (int key, map.keys()) {
-        EXPECT_EQ(p->i2str(key), map.value(key));
-    }
-
-    p->deleteLater();
-}
@@ -0,0 +1,84 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logaggregates.h"
+#include "logquery.h"
+#include "loglevel.h"
+
+#include <QDateTime>
+
+#include <gtest/gtest.h>
+
+namespace {
+
+LOG_MSG_JOURNAL journalRecord(const QString &daemon, int level, const QDateTime &time)
+{
+    LOG_MSG_JOURNAL msg;
+    msg.daemonName = daemon;
+    msg.level = level;
+    msg.timestamp = time.isValid() ? time.toMSecsSinceEpoch() * 1000 : 0;
+    return msg;
+}
+
+} // namespace
+
+TEST(LogAggregates_add_UT, LogAggregates_add_UT_001)
+{
+    const QDateTime base = QDateTime::fromString("2023-05-01T13:10:00", Qt::ISODate);
+    QList<LOG_MSG_JOURNAL> list;
+    list << journalRecord("sshd", ERR, base)
+         << journalRecord("cron", INF, base.addSecs(60))
+         << journalRecord("sshd", INF, base.addSecs(3600))
+         << journalRecord("", -1, QDateTime());
+
+    LogAggregates aggregates;
+    aggregates.add(list, 0, 2);
+    aggregates.add(list, 2);
+    EXPECT_EQ(aggregates.total(), 4);
+
+    const QList<LogAggregateEntry> daemons = aggregates.daemons();
+    ASSERT_EQ(daemons.size(), 2);
+    EXPECT_EQ(daemons.at(0).text, QString("sshd"));
+    EXPECT_EQ(daemons.at(0).count, 2);
+    EXPECT_EQ(daemons.at(0).term, QString("ident:sshd"));
+    EXPECT_EQ(aggregates.daemons(1).size(), 1);
+
+    //等级从严重到轻微
+    const QList<LogAggregateEntry> levels = aggregates.levels();
+    ASSERT_EQ(levels.size(), 2);
+    EXPECT_EQ(levels.at(0).text, LogLevel::text(ERR));
+    EXPECT_EQ(levels.at(0).term, QString("level:3"));
+    EXPECT_EQ(levels.at(1).count, 2);
+
+    //小时从新到旧,没有时间的记录不计入
+    const QList<LogAggregateEntry> hours = aggregates.hours();
+    ASSERT_EQ(hours.size(), 2);
+    EXPECT_EQ(hours.at(0).term, QString("hour:2023-05-01T14"));
+    EXPECT_EQ(hours.at(1).count, 2);
+    EXPECT_EQ(aggregates.hours(1).size(), 1);
+
+    aggregates.clear();
+    EXPECT_EQ(aggregates.isEmpty(), true);
+    EXPECT_EQ(aggregates.daemons().isEmpty(), true);
+}
+
+TEST(LogAggregates_hourBegin_UT, LogAggregates_hourBegin_UT_001)
+{
+    LogAggregates aggregates;
+    const QDateTime time = QDateTime::fromString("2023-05-01T13:59:59", Qt::ISODate);
+    const qint64 begin = aggregates.hourBegin(time.toMSecsSinceEpoch());
+    EXPECT_EQ(begin, QDateTime::fromString("2023-05-01T13:00:00", Qt::ISODate).toMSecsSinceEpoch());
+    //统计项的条件能被查询解析回同一小时
+    EXPECT_EQ(LogQuery::parseHour(LogQuery::hourText(begin)), begin);
+}
+
+TEST(LogAggregates_quoteValue_UT, LogAggregates_quoteValue_UT_001)
+{
+    EXPECT_EQ(LogAggregates::quoteValue("sshd"), QString("sshd"));
+    EXPECT_EQ(LogAggregates::quoteValue("my \"app\""), QString("\"my \\\"app\\\"\""));
+    //加引号的条件值解析后和原值相同
+    LogQuery query(QString("ident:%1").arg(LogAggregates::quoteValue("a b\\c")));
+    ASSERT_EQ(query.terms().size(), 1);
+    EXPECT_EQ(query.terms().at(0).value, QString("a b\\c"));
+}
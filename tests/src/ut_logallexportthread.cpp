@@ -22,6 +22,18 @@ bool LogAllExportThread_stub_bool(const QString &outDir, const QString &in, bool
     return false;
 }
 
+static int s_exportedFileCount = 0;
+
+int LogAllExportThread_stub_exportLogFiles(const QString &outDir, const QStringList &files, const DLDBusHandler::ExportProgress &progress)
+{
+    Q_UNUSED(outDir);
+    for (int i = 0; i < files.size(); ++i) {
+        ++s_exportedFileCount;
+        if (progress && !progress(i, true))
+            break;
+    }
+    return files.size();
+}
 
 TEST(LogAllExportThread_LogAllExportThread_UT, LogAllExportThread_LogAllExportThread_UT_001)
 {
@@ -43,10 +55,14 @@ TEST(LogAllExportThread_run_UT, LogAllExportThread_run_UT_001)
     Stub stub;
     stub.set(ADDR(DLDBusHandler, getFileInfo), LogAllExportThread_stub_toString);
     stub.set(ADDR(DLDBusHandler, exportLog), LogAllExportThread_stub_bool);
+    stub.set(ADDR(DLDBusHandler, exportLogFiles), LogAllExportThread_stub_exportLogFiles);
+    s_exportedFileCount = 0;
     p->m_types << JOUR_TREE_DATA << BOOT_KLU_TREE_DATA << DMESG_TREE_DATA << LAST_TREE_DATA <<
                DPKG_TREE_DATA << KERN_TREE_DATA << XORG_TREE_DATA << DNF_TREE_DATA << BOOT_TREE_DATA <<
                KWIN_TREE_DATA << APP_TREE_DATA;
     p->run();
+    //文件通过批量接口导出
+    EXPECT_GT(s_exportedFileCount, 0);
     delete p;
 }
 
@@ -57,6 +73,7 @@ TEST(LogAllExportThread_run_UT, LogAllExportThread_run_UT_002)
     Stub stub;
     stub.set(ADDR(DLDBusHandler, getFileInfo), LogAllExportThread_stub_toString);
     stub.set(ADDR(DLDBusHandler, exportLog), LogAllExportThread_stub_bool);
+    stub.set(ADDR(DLDBusHandler, exportLogFiles), LogAllExportThread_stub_exportLogFiles);
     LogAllExportThread *p = new LogAllExportThread(thread, "path");
     ASSERT_TRUE(p);
     p->run();
@@ -72,3 +89,33 @@ TEST(LogAllExportThread_slot_cancelExport_UT, LogAllExportThread_slot_cancelExpo
     p->slot_cancelExport();
     delete p;
 }
+
+static QVariantMap s_journalOptions;
+
+bool LogAllExportThread_stub_exportJournal(const QString &outDir, const QString &in, const QVariantMap &options)
+{
+    Q_UNUSED(outDir);
+    Q_UNUSED(in);
+    s_journalOptions = options;
+    return true;
+}
+
+TEST(LogAllExportThread_exportCommand_UT, LogAllExportThread_exportCommand_UT_001)
+{
+    Stub stub;
+    stub.set(ADDR(DLDBusHandler, exportLog), LogAllExportThread_stub_bool);
+    stub.set(ADDR(DLDBusHandler, exportJournal), LogAllExportThread_stub_exportJournal);
+    LogAllExportThread p(QStringList(), "path");
+    QVariantMap options;
+    options.insert("priority", 3);
+    options.insert("since", 1000000LL);
+    p.setJournalOptions("journalctl_system", options);
+    LogAllExportThread::ExportContext context;
+    s_journalOptions.clear();
+    //设置了参数的命令按参数导出
+    p.exportCommand("/tmp/", "journalctl_system", "journalctl_system", context);
+    EXPECT_EQ(s_journalOptions, options);
+    s_journalOptions.clear();
+    p.exportCommand("/tmp/", "journalctl_boot", "journalctl_boot", context);
+    EXPECT_EQ(s_journalOptions.isEmpty(), true);
+}
@@ -0,0 +1,56 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logalloccounter.h"
+#include "logingestmetrics.h"
+
+#include <QStringList>
+
+#include <gtest/gtest.h>
+
+TEST(LogAllocScope_destruct_UT, LogAllocScope_destruct_UT_001)
+{
+    //单元测试进程没有替换分配函数,直接模拟分配函数的计数
+    LogAllocCounter::setHooked();
+    LogAllocCounter::takeScopes();
+    LogIngestCountersPtr counters = std::make_shared<LogIngestCounters>();
+    {
+        LogIngestScope ingest(counters);
+        LogAllocScope scope("ut.parse");
+        LogIngestMetrics::addRead(0, 4);
+        for (int i = 0; i < 8; ++i)
+            LogAllocCounter::onAlloc(16);
+    }
+    {
+        LogAllocScope scope("ut.model", 2);
+        LogAllocCounter::onAlloc(100);
+    }
+
+    const QList<LogAllocScopeStats> scopes = LogAllocCounter::takeScopes();
+    ASSERT_EQ(scopes.size(), 2);
+    //按分配次数排列
+    EXPECT_EQ(scopes.at(0).name, QString("ut.parse"));
+    EXPECT_EQ(scopes.at(0).allocs, 8u);
+    EXPECT_EQ(scopes.at(0).units, 4u);
+    EXPECT_DOUBLE_EQ(scopes.at(0).allocsPerUnit(), 2.0);
+    EXPECT_DOUBLE_EQ(scopes.at(1).bytesPerUnit(), 50.0);
+    EXPECT_TRUE(LogAllocCounter::takeScopes().isEmpty());
+}
+
+TEST(LogAllocCounter_format_UT, LogAllocCounter_format_UT_001)
+{
+    LogAllocScopeStats scope;
+    scope.name = "journalWork";
+    scope.calls = 1;
+    scope.allocs = 30;
+    scope.bytes = 900;
+    scope.units = 10;
+    LogAllocScopeStats empty;
+    empty.name = "idle";
+
+    const QStringList lines = LogAllocCounter::format(QList<LogAllocScopeStats>() << scope << empty).split('\n');
+    ASSERT_EQ(lines.size(), 2);
+    EXPECT_EQ(lines.at(0), QString("alloc scope=journalWork calls=1 allocs=30 bytes=900 lines=10 allocsPerLine=3.00 bytesPerLine=90.0"));
+    EXPECT_TRUE(lines.at(1).endsWith("allocsPerLine=- bytesPerLine=-"));
+}
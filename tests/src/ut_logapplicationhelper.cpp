@@ -6,6 +6,8 @@
 #include <stub.h>
 #include "logapplicationhelper.h"
 #include <QDebug>
+#include <QDir>
+#include <QLocale>
 
 QByteArray stub_readLine(qint64 maxlen = 0)
 {
@@ -17,7 +19,7 @@ QByteArray stub_readLine001(qint64 maxlen = 0)
     return "NotShowIn testX-Deepin-Vendor=deepin";
 }
 
-void stub_parseField(QString path, QString name, bool isDeepin, bool isGeneric,
+void stub_parseField(AppLogScanResult &result, QString path, QString name, bool isDeepin, bool isGeneric,
                      bool isName)
 {
 }
@@ -65,7 +67,8 @@ TEST(LogApplicationHelper_createDesktopFiles_UT, LogApplicationHelper_createDesk
 {
     LogApplicationHelper *p = new LogApplicationHelper(nullptr);
     EXPECT_NE(p, nullptr);
-    p->createDesktopFiles();
+    AppLogScanResult result;
+    p->createDesktopFiles(result);
     p->deleteLater();
 }
 
@@ -76,7 +79,8 @@ TEST(LogApplicationHelper_createDesktopFiles_UT, LogApplicationHelper_createDesk
     Stub stub;
     stub.set((QByteArray(QIODevice::*)(qint64))ADDR(QIODevice, readLine), stub_readLine);
     stub.set(ADDR(LogApplicationHelper, parseField), stub_parseField);
-    p->createDesktopFiles();
+    AppLogScanResult result;
+    p->createDesktopFiles(result);
     p->deleteLater();
 }
 
@@ -87,7 +91,8 @@ TEST(LogApplicationHelper_createDesktopFiles_UT, LogApplicationHelper_createDesk
     Stub stub;
     stub.set((QByteArray(QIODevice::*)(qint64))ADDR(QIODevice, readLine), stub_readLine001);
     stub.set(ADDR(LogApplicationHelper, parseField), stub_parseField);
-    p->createDesktopFiles();
+    AppLogScanResult result;
+    p->createDesktopFiles(result);
     p->deleteLater();
 }
 
@@ -95,7 +100,8 @@ TEST(LogApplicationHelper_createLogFiles_UT, LogApplicationHelper_createLogFiles
 {
     LogApplicationHelper *p = new LogApplicationHelper(nullptr);
     EXPECT_NE(p, nullptr);
-    p->createLogFiles();
+    AppLogScanResult result;
+    p->createLogFiles(result);
     p->deleteLater();
 }
 
@@ -127,7 +133,8 @@ TEST_P(LogApplicationHelper_parseField_UT, LogApplicationHelper_parseField_UT)
     EXPECT_NE(p, nullptr);
     LogApplicationHelper_parseField_UT_Param param = GetParam();
     QString path = param.isPathEmpty ? "" : "../sources/dde-calendar.log";
-    p->parseField(path, "dde-calendar.log", param.isDeepin, param.isGeneric, param.isName);
+    AppLogScanResult result;
+    p->parseField(result, path, "dde-calendar.log", param.isDeepin, param.isGeneric, param.isName);
 
     p->deleteLater();
 }
@@ -156,6 +163,60 @@ TEST(LogApplicationHelper_getMap_UT, LogApplicationHelper_getMape_UT)
     p->deleteLater();
 }
 
+TEST(LogApplicationHelper_getMap_UT, LogApplicationHelper_getMape_UT_002)
+{
+    LogApplicationHelper *p = new LogApplicationHelper(nullptr);
+    EXPECT_NE(p, nullptr);
+    //等待扫描时与同步扫描的结果一致
+    QMap<QString, QString> waited = p->getMap(true);
+    p->initAppLog();
+    EXPECT_EQ(p->getMap(true), waited);
+    p->deleteLater();
+}
+
+TEST(LogApplicationHelper_isStampValid_UT, LogApplicationHelper_isStampValid_UT_001)
+{
+    //没有记录任何目录时认为无效
+    EXPECT_EQ(LogApplicationHelper::isStampValid(QMap<QString, qint64>()), false);
+
+    QMap<QString, qint64> stamps;
+    stamps.insert("/nonexistent/deepin-log-viewer", -1);
+    EXPECT_EQ(LogApplicationHelper::isStampValid(stamps), true);
+    //目录出现或修改时间变化后失效
+    stamps.insert("/nonexistent/deepin-log-viewer", 1000);
+    EXPECT_EQ(LogApplicationHelper::isStampValid(stamps), false);
+    stamps.clear();
+    stamps.insert(QDir::tempPath(), LogApplicationHelper::dirStamp(QDir::tempPath()));
+    EXPECT_EQ(LogApplicationHelper::isStampValid(stamps), true);
+}
+
+TEST(LogApplicationHelper_applyAppLog_UT, LogApplicationHelper_applyAppLog_UT_001)
+{
+    LogApplicationHelper *p = new LogApplicationHelper(nullptr);
+    EXPECT_NE(p, nullptr);
+    p->getMap(true);
+    int changedCount = 0;
+    QObject::connect(p, &LogApplicationHelper::appLogsChanged, [&changedCount]() {
+        ++changedCount;
+    });
+
+    AppLogScanResult result;
+    result.language = QLocale::system().name();
+    result.stamps.insert("/nonexistent/deepin-log-viewer", -1);
+    result.enLogMap.insert("deepin-test", "/tmp/deepin-test");
+    result.enTransMap.insert("deepin-test", "Test");
+    result.transLogMap.insert("Test", "/tmp/deepin-test/deepin-test.log");
+    p->applyAppLog(result);
+    EXPECT_EQ(changedCount, 1);
+    EXPECT_EQ(p->getMap(), result.transLogMap);
+    EXPECT_EQ(p->transName("deepin-test"), QString("Test"));
+    EXPECT_EQ(p->isValidAppName("deepin-test"), true);
+    //结果相同时不重复通知
+    p->applyAppLog(result);
+    EXPECT_EQ(changedCount, 1);
+    p->deleteLater();
+}
+
 TEST(LogApplicationHelper_transName_UT, LogApplicationHelper_transName_UT)
 {
     LogApplicationHelper *p = new LogApplicationHelper(nullptr);
@@ -43,6 +43,22 @@ QStringList stub_getAppFileInfo(const QString &flag)
     return QStringList() << "test";
 }
 
+QStringList stub_getRotatedAppFileInfo(void *obj, const QString &flag, bool unzip)
+{
+    Q_UNUSED(obj);
+    Q_UNUSED(flag);
+    Q_UNUSED(unzip);
+    return QStringList() << "app.log" << "app.log.1" << "app.log.2" << "app.log.3" << "app.log.4" << "app.log.5";
+}
+
+QString stub_readRotatedAppLog(void *obj, const QString &filePath)
+{
+    Q_UNUSED(obj);
+    //越旧的文件日期越早
+    const int age = filePath == "app.log" ? 0 : filePath.section('.', -1).toInt();
+    return QString("2021-04-%1 13:29:32 install").arg(20 - age);
+}
+
 QByteArray stub_readAllStandardOutput(){
     return "2021-03-10, 11:33:23.48.9 [Warning] [                                                         0] QFSFileEngine::open: No file name specified";
 }
@@ -123,3 +139,20 @@ TEST_F(LogApplicationParseThread_UT, UT_GetIndex_001){
     int index= m_logAppThread->getIndex();
     EXPECT_EQ(index, 6);
 }
+
+TEST_F(LogApplicationParseThread_UT, UT_DoWork_002)
+{
+    Stub stub;
+    stub.set(ADDR(DLDBusHandler, getFileInfo), stub_getRotatedAppFileInfo);
+    stub.set(ADDR(DLDBusHandler, readLog), stub_readRotatedAppLog);
+    QStringList dates;
+    QObject::connect(m_logAppThread, &LogApplicationParseThread::appData, [&dates](int, QList<LOG_MSG_APPLICATOIN> list) {
+        for (const LOG_MSG_APPLICATOIN &msg : list)
+            dates.append(msg.dateTime.left(10));
+    });
+    m_logAppThread->m_AppFiler.path = "app";
+    m_logAppThread->m_AppFiler.lvlFilter = LVALL;
+    m_logAppThread->doWork();
+    //转储文件并行解析后仍按文件顺序发出
+    EXPECT_EQ(dates, QStringList() << "2021-04-20" << "2021-04-19" << "2021-04-18" << "2021-04-17" << "2021-04-16" << "2021-04-15");
+}
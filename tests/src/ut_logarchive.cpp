@@ -0,0 +1,114 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logarchive.h"
+#include "logzipwriter.h"
+
+#include <QFile>
+#include <QTemporaryDir>
+
+#include <gtest/gtest.h>
+
+#include <zlib.h>
+
+namespace {
+void writeFile(const QString &path, const QByteArray &data)
+{
+    QFile file(path);
+    file.open(QIODevice::WriteOnly);
+    file.write(data);
+}
+
+QByteArray gzip(const QByteArray &data)
+{
+    QByteArray out(static_cast<int>(compressBound(static_cast<uLong>(data.size()))) + 64, 0);
+    z_stream stream = {};
+    deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY);
+    stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data.constData()));
+    stream.avail_in = static_cast<uInt>(data.size());
+    stream.next_out = reinterpret_cast<Bytef *>(out.data());
+    stream.avail_out = static_cast<uInt>(out.size());
+    deflate(&stream, Z_FINISH);
+    out.resize(static_cast<int>(stream.total_out));
+    deflateEnd(&stream);
+    return out;
+}
+}
+
+TEST(LogArchive_index_UT, LogArchive_index_UT_001)
+{
+    QTemporaryDir source;
+    ASSERT_TRUE(source.isValid());
+    writeFile(source.filePath("kern.log"), "line1\nline2\n");
+    writeFile(source.filePath("kern.log.1.gz"), gzip("old1\nold2\nold3\n"));
+    writeFile(source.filePath("dpkg.log"), "install");
+    const QString zipPath = source.filePath("all_logs.zip");
+    {
+        LogZipWriter zip(zipPath);
+        ASSERT_EQ(zip.isOpen(), true);
+        zip.addFile(source.filePath("kern.log"), "kernel/kern.log");
+        zip.addFile(source.filePath("kern.log.1.gz"), "kernel/kern.log.1.gz");
+        zip.addFile(source.filePath("dpkg.log"), "dpkg/dpkg.log");
+        ASSERT_EQ(zip.write(), true);
+        ASSERT_EQ(zip.close(), true);
+    }
+
+    LogArchive archive(zipPath);
+    ASSERT_EQ(archive.open(), true);
+    EXPECT_EQ(archive.categories(), QStringList() << "kernel" << "dpkg");
+    ASSERT_EQ(archive.members("kernel").size(), 2);
+    EXPECT_EQ(archive.members("kernel").at(1).name, QString("kernel/kern.log.1.gz"));
+
+    std::atomic_bool canRun {true};
+    const QList<LogTextSourcePtr> sources = archive.index("kernel", canRun);
+    ASSERT_EQ(sources.size(), 2);
+    EXPECT_EQ(sources.at(0)->lineCount(), 2);
+    EXPECT_EQ(sources.at(0)->filePath(), LogArchive::sourcePath(zipPath, "kernel/kern.log"));
+    //.gz轮转日志在内存中再解压一层
+    ASSERT_EQ(sources.at(1)->lineCount(), 3);
+    EXPECT_EQ(sources.at(1)->line(2), QString("old3"));
+    //再次查看沿用已建立的索引
+    EXPECT_EQ(archive.index("kernel", canRun).at(0).get(), sources.at(0).get());
+
+    QByteArray data;
+    EXPECT_EQ(LogArchive::read(zipPath, "dpkg/dpkg.log", data), true);
+    EXPECT_EQ(data, QByteArray("install"));
+    EXPECT_EQ(LogArchive::read(zipPath, "dpkg/missing.log", data), false);
+}
+
+TEST(LogArchive_open_UT, LogArchive_open_UT_001)
+{
+    QTemporaryDir source;
+    ASSERT_TRUE(source.isValid());
+    writeFile(source.filePath("bad.zip"), "not a zip");
+    LogArchive archive(source.filePath("bad.zip"));
+    EXPECT_EQ(archive.open(), false);
+    EXPECT_EQ(archive.categories().isEmpty(), true);
+}
+
+TEST(LogArchive_read_UT, LogArchive_read_UT_001)
+{
+    QTemporaryDir source;
+    ASSERT_TRUE(source.isValid());
+    writeFile(source.filePath("kern.log"), QByteArray(4096, 'a'));
+    writeFile(source.filePath("kern.log.1.gz"), gzip(QByteArray(4096, 'b')));
+    const QString zipPath = source.filePath("all_logs.zip");
+    {
+        LogZipWriter zip(zipPath);
+        ASSERT_EQ(zip.isOpen(), true);
+        zip.addFile(source.filePath("kern.log"), "kernel/kern.log");
+        zip.addFile(source.filePath("kern.log.1.gz"), "kernel/kern.log.1.gz");
+        ASSERT_EQ(zip.write(), true);
+        ASSERT_EQ(zip.close(), true);
+    }
+
+    //解压后超过上限的成员跳过,.gz成员按再解压一层后的大小检查
+    QByteArray data;
+    EXPECT_EQ(LogArchive::read(zipPath, "kernel/kern.log", data, 1024), false);
+    EXPECT_EQ(data.isEmpty(), true);
+    EXPECT_EQ(LogArchive::read(zipPath, "kernel/kern.log.1.gz", data, 1024), false);
+    EXPECT_EQ(data.isEmpty(), true);
+    EXPECT_EQ(LogArchive::read(zipPath, "kernel/kern.log.1.gz", data, 4096), true);
+    EXPECT_EQ(data.size(), 4096);
+}
@@ -0,0 +1,112 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logauditparser.h"
+#include "utils.h"
+
+#include <gtest/gtest.h>
+
+TEST(LogAuditParser_parseLine_UT, LogAuditParser_parseLine_UT_001)
+{
+    LogAuditRecord record;
+    QString line = "type=SYSCALL msg=audit(1688526389.214:61): arch=c000003e syscall=59 success=yes exit=0 "
+                   "comm=\"ls\" exe=\"/usr/bin/ls\" key=\"exec\"";
+    EXPECT_EQ(LogAuditParser::parseLine(line, record), true);
+    EXPECT_EQ(record.type, QString("SYSCALL"));
+    EXPECT_EQ(record.eventId, QString("1688526389.214:61"));
+    EXPECT_EQ(record.time, 1688526389u);
+    EXPECT_EQ(record.success, QString("yes"));
+    EXPECT_EQ(record.comm, QString("ls"));
+    EXPECT_EQ(record.exe, QString("/usr/bin/ls"));
+    EXPECT_EQ(record.key, QString("exec"));
+    EXPECT_EQ(record.origin.midRef(record.detailBegin).startsWith("arch="), true);
+    EXPECT_EQ(record.origin, line);
+}
+
+TEST(LogAuditParser_parseLine_UT, LogAuditParser_parseLine_UT_002)
+{
+    //msg='...'中的字段和十六进制编码的进程名
+    LogAuditRecord record;
+    QString line = "node=host type=USER_LOGIN msg=audit(1688526390.100:62): pid=100 uid=0 "
+                   "msg='op=login acct=\"root\" exe=\"/usr/sbin/sshd\" addr=192.168.1.2 res=failed' comm=6D7920617070";
+    EXPECT_EQ(LogAuditParser::parseLine(line, record), true);
+    EXPECT_EQ(record.type, QString("USER_LOGIN"));
+    EXPECT_EQ(record.addr, QString("192.168.1.2"));
+    EXPECT_EQ(record.res, QString("failed"));
+    EXPECT_EQ(record.exe, QString("/usr/sbin/sshd"));
+    EXPECT_EQ(record.comm, QString("my app"));
+
+    EXPECT_EQ(LogAuditParser::parseLine("no audit record here", record), false);
+}
+
+TEST(LogAuditParser_buildEvent_UT, LogAuditParser_buildEvent_UT_001)
+{
+    //按从新到旧读取到的同一事件的三行记录
+    QStringList lines;
+    lines << "type=PROCTITLE msg=audit(1688526389.214:61): proctitle=6C73"
+          << "type=PATH msg=audit(1688526389.214:61): item=0 name=\"/usr/bin/ls\""
+          << "type=SYSCALL msg=audit(1688526389.214:61): syscall=59 success=no comm=\"ls\"";
+    QList<LogAuditRecord> records;
+    for (const QString &line : lines) {
+        LogAuditRecord record;
+        EXPECT_EQ(LogAuditParser::parseLine(line, record), true);
+        records.append(record);
+    }
+
+    LOG_MSG_AUDIT msg = LogAuditParser::buildEvent(records);
+    EXPECT_EQ(msg.eventType, QString("SYSCALL"));
+    EXPECT_EQ(msg.processName, QString("ls"));
+    EXPECT_EQ(msg.status, QString("Failed"));
+    EXPECT_EQ(msg.origin.split("\n").size(), 3);
+    EXPECT_EQ(msg.origin.split("\n").first(), lines.last());
+    //信息列从原文截取,按文件中的顺序每行去掉"msg=audit(...): "之前的部分
+    EXPECT_EQ(msg.message(), QString("syscall=59 success=no comm=\"ls\"\nitem=0 name=\"/usr/bin/ls\"\nproctitle=6C73"));
+    EXPECT_EQ(msg.contains("item=0"), true);
+    EXPECT_EQ(msg.contains("type=PATH"), false);
+    EXPECT_EQ(msg.auditType.isEmpty(), false);
+    EXPECT_EQ(LogAuditParser::buildEvent(QList<LogAuditRecord>()).eventType.isEmpty(), true);
+}
+
+TEST(LogAuditParser_buildEvent_UT, LogAuditParser_buildEvent_UT_002)
+{
+    QMap<QString, QStringList> auditMap;
+    auditMap.insert(Audit_IdentAuth, QStringList() << "USER_LOGIN" << "USER_AUTH");
+    auditMap.insert(Audit_DAC, QStringList() << "SYSCALL");
+    Utils::setAuditMap(auditMap);
+
+    LogAuditRecord record;
+    ASSERT_EQ(LogAuditParser::parseLine("type=USER_LOGIN msg=audit(1688526389.214:62): pid=1 res=success", record), true);
+    const LOG_MSG_AUDIT msg = LogAuditParser::buildEvent(QList<LogAuditRecord>() << record);
+    EXPECT_EQ(msg.auditType, QString(Audit_IdentAuth));
+    EXPECT_EQ(msg.status, QString("OK"));
+    EXPECT_EQ(msg.message(), QString("pid=1 res=success"));
+    //解析时设置类型位,按类型筛选不再比较文本
+    EXPECT_EQ(msg.auditTypeBit, LOG_MSG_AUDIT::auditTypeMask(IDENTAUTH));
+    EXPECT_EQ(msg.filterAuditType(IDENTAUTH), true);
+    EXPECT_EQ(msg.filterAuditType(DAC), false);
+
+    //没有类型位的记录仍按文本比较
+    LOG_MSG_AUDIT legacy;
+    legacy.auditType = Audit_DAC;
+    EXPECT_EQ(legacy.filterAuditType(DAC), true);
+    EXPECT_EQ(LOG_MSG_AUDIT::auditStr2Type("custom"), AUDITLVALL);
+    Utils::setAuditMap(QMap<QString, QStringList>());
+}
+
+TEST(LogAuditParser_isIPv4_UT, LogAuditParser_isIPv4_UT_001)
+{
+    EXPECT_EQ(LogAuditParser::isIPv4("192.168.1.1"), true);
+    EXPECT_EQ(LogAuditParser::isIPv4("192.168.1.1:22"), false);
+    EXPECT_EQ(LogAuditParser::isIPv4("256.1.1.1"), false);
+    EXPECT_EQ(LogAuditParser::isIPv4("1.1.1"), false);
+    EXPECT_EQ(LogAuditParser::isIPv4("?"), false);
+}
+
+TEST(LogAuditParser_eventKey_UT, LogAuditParser_eventKey_UT_001)
+{
+    const QByteArray line("type=SYSCALL msg=audit(1688526389.214:61): arch=c000003e");
+    EXPECT_EQ(LogAuditParser::eventKey(line.constData(), line.size()), QByteArray("1688526389.214:61"));
+    const QByteArray other("type=SYSCALL arch=c000003e");
+    EXPECT_TRUE(LogAuditParser::eventKey(other.constData(), other.size()).isEmpty());
+}
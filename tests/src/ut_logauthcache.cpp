@@ -0,0 +1,53 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logauthcache.h"
+
+#include <QTemporaryDir>
+
+#include <gtest/gtest.h>
+
+TEST(LogAuthCache_authorize_UT, LogAuthCache_authorize_UT_001)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    LogAuthCache *cache = LogAuthCache::instance();
+    cache->clear();
+
+    int elevations = 0;
+    const LogAuthCache::Elevate elevate = [&elevations]() {
+        ++elevations;
+        return true;
+    };
+    //同一目录下的轮转文件只提权一次
+    EXPECT_TRUE(cache->authorize(dir.filePath("app.log"), elevate));
+    EXPECT_TRUE(cache->authorize(dir.filePath("app.log.1"), elevate));
+    EXPECT_TRUE(cache->authorize(dir.path(), elevate));
+    EXPECT_EQ(elevations, 1);
+    EXPECT_TRUE(cache->isAuthorized(dir.filePath("app.log.2.gz")));
+    EXPECT_FALSE(cache->isAuthorized("/var/log/other/app.log"));
+    cache->clear();
+    EXPECT_FALSE(cache->isAuthorized(dir.filePath("app.log")));
+}
+
+TEST(LogAuthCache_authorize_UT, LogAuthCache_authorize_UT_002)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    LogAuthCache *cache = LogAuthCache::instance();
+    cache->clear();
+
+    //提权失败不记住,下次重新提权
+    int elevations = 0;
+    EXPECT_FALSE(cache->authorize(dir.filePath("app.log"), [&elevations]() {
+        ++elevations;
+        return false;
+    }));
+    EXPECT_TRUE(cache->authorize(dir.filePath("app.log"), [&elevations]() {
+        ++elevations;
+        return true;
+    }));
+    EXPECT_EQ(elevations, 2);
+    cache->clear();
+}
@@ -7,11 +7,13 @@
 #include "sharedmemorymanager.h"
 #include "wtmpparse.h"
 #include "dldbushandler.h"
+#include "utils.h"
 
 #include <stub.h>
 
 #include <QDebug>
 #include <QDateTime>
+#include <QTemporaryDir>
 
 #include <gtest/gtest.h>
 bool stub_isAttached()
@@ -237,13 +239,6 @@ TEST_F(LogAuthThread_UT, UT_GetIndex_001){
      EXPECT_EQ(index,1);
 }
 
-TEST_F(LogAuthThread_UT, UT_FormatDateTime_001){
-   qint64 timeMesc= m_logAuthThread->formatDateTime("2021", "08-30", "14:25");
-   qint64 timeMesc1= m_logAuthThread->formatDateTime("Aug 30" ,"19:04:43");
-   EXPECT_NE(timeMesc,-1);
-   EXPECT_NE(timeMesc1,-1);
-}
-
 TEST_F(LogAuthThread_UT, UT_SetFileterParam_001){
     KWIN_FILTERS kwin;
     m_logAuthThread->setFileterParam(kwin);
@@ -334,7 +329,7 @@ TEST_F(LogAuthThread_UT, UT_HandleKern_001)
     stub.set(wtmp_close, stub_wtmp_close);
     stub.set(ADDR(QProcess, setProcessChannelMode), stub_setProcessChannelMode);
     stub.set(ADDR(QProcess, exitCode), stub_exitCode);
-    stub.set(ADDR(DLDBusHandler, openLogStream), stub_dnfReadLog);
+    stub.set(ADDR(DLDBusHandler, openReverseLogStream), stub_dnfReadLog);
     stub.set(ADDR(DLDBusHandler, readLogInStream), stub_dnfReadStream);
     stub.set((QByteArray(QIODevice::*)(qint64))ADDR(QIODevice, readLine), fileReadLine);
     stub.set(ADDR(QDateTime, toMSecsSinceEpoch), dnfToMSecsSinceEpoch);
@@ -536,25 +531,6 @@ TEST_F(LogAuthThread_UT, UT_Run_001)
     EXPECT_EQ(m_logAuthThread->m_canRun,false);
 }
 
-TEST(LogAuthThread_initDnfLevelMap_UT, LogAuthThread_initDnfLevelMap_UT_001)
-{
-    LogAuthThread *p = new LogAuthThread();
-    ASSERT_TRUE(p);
-    p->initDnfLevelMap();
-    EXPECT_TRUE(p->m_dnfLevelDict.size());
-    EXPECT_TRUE(p->m_transDnfDict.size());
-    delete p;
-}
-
-TEST(LogAuthThread_initLevelMap_UT, LogAuthThread_initLevelMap_UT_001)
-{
-    LogAuthThread *p = new LogAuthThread();
-    ASSERT_TRUE(p);
-    p->initLevelMap();
-    EXPECT_TRUE(p->m_levelMap.size());
-    delete p;
-}
-
 TEST(LogAuthThread_stopProccess_UT, LogAuthThread_stopProccess_UT_001)
 {
     LogAuthThread *p = new LogAuthThread();
@@ -693,3 +669,108 @@ TEST(LogAuthThread_run_UT, LogAuthThread_run_UT_008)
 
 
 
+namespace {
+
+QStringList readKwinLines(const std::shared_ptr<LogTailPosition> &tail)
+{
+    LogAuthThread thread;
+    thread.m_canRun = true;
+    thread.m_kwinFilters.tail = tail;
+    QStringList lines;
+    QObject::connect(&thread, &LogAuthThread::kwinData, [&lines](int, QList<LOG_MSG_KWIN> list) {
+        for (const LOG_MSG_KWIN &msg : list)
+            lines << msg.msg;
+    });
+    thread.handleKwin();
+    return lines;
+}
+
+void writeKwinLog(const QString &path, const QByteArray &data, QIODevice::OpenMode mode)
+{
+    QFile file(path);
+    ASSERT_TRUE(file.open(mode));
+    file.write(data);
+}
+
+} // namespace
+
+TEST(LogAuthThread_handleKwin_UT, LogAuthThread_handleKwin_UT_001)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    const QString savedHome = Utils::homePath;
+    Utils::homePath = dir.path();
+    const QString path = KWIN_TREE_DATA;
+    auto tail = std::make_shared<LogTailPosition>();
+
+    writeKwinLog(path, "a\nb\n", QIODevice::WriteOnly);
+    EXPECT_EQ(readKwinLines(tail), QStringList() << "b" << "a");
+    EXPECT_TRUE(tail->rescanned);
+    EXPECT_EQ(tail->offset, 4);
+
+    //只读取新追加的完整行,没有换行的一行留到下次
+    writeKwinLog(path, "c\npart", QIODevice::Append);
+    EXPECT_EQ(readKwinLines(tail), QStringList() << "c");
+    EXPECT_FALSE(tail->rescanned);
+    EXPECT_EQ(tail->offset, 6);
+    writeKwinLog(path, "ial\n", QIODevice::Append);
+    EXPECT_EQ(readKwinLines(tail), QStringList() << "partial");
+    EXPECT_FALSE(tail->rescanned);
+
+    //截断后重写超过原长度,内容对不上时从头读取
+    writeKwinLog(path, "0123456789\nxyz\n", QIODevice::WriteOnly | QIODevice::Truncate);
+    EXPECT_EQ(readKwinLines(tail), QStringList() << "xyz" << "0123456789");
+    EXPECT_TRUE(tail->rescanned);
+
+    Utils::homePath = savedHome;
+}
+
+TEST(LogAuthThread_parseXorgLine_UT, LogAuthThread_parseXorgLine_UT_001)
+{
+    LOG_MSG_XORG msg;
+    EXPECT_TRUE(LogAuthThread::parseXorgLine("[  1234.567] (II) Loading [drm]", msg));
+    EXPECT_EQ(msg.offset, QString("1234.567"));
+    EXPECT_EQ(msg.offsetUsec, 1234567000);
+    EXPECT_EQ(msg.msg, QString("(II) Loading [drm]"));
+    EXPECT_FALSE(LogAuthThread::parseXorgLine("[  1234.567]", msg));
+    EXPECT_TRUE(LogAuthThread::parseXorgLine("[ abc] text", msg));
+    EXPECT_EQ(msg.offsetUsec, -1);
+
+    const QByteArray head = "\n[    10.500] (==) Log file: \"/var/log/Xorg.0.log\", Time: Mon Oct 12 09:00:00 2026\n[    11.000] next\n";
+    const qint64 start = QDateTime(QDate(2026, 10, 12), QTime(9, 0)).toMSecsSinceEpoch() - 10500;
+    EXPECT_EQ(LogAuthThread::xorgStartTime(head.constData(), head.size()), start);
+    EXPECT_EQ(LogAuthThread::xorgStartTime("[ 1.0] no header\n", 17), -1);
+}
+
+TEST(LogAuthThread_handleXorg_UT, LogAuthThread_handleXorg_UT_002)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    const QString path = dir.filePath("Xorg.0.log");
+    QFile file(path);
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    file.write("[     1.000] (==) Log file: \"/var/log/Xorg.0.log\", Time: Mon Oct 12 09:00:00 2026\n"
+               "[    30.000] early\n"
+               "[    90.000] inside\n"
+               "continued\n"
+               "[   200.000] late\n");
+    file.close();
+
+    //时间范围换算为偏移量[60s, 120s]
+    const qint64 start = QDateTime(QDate(2026, 10, 12), QTime(9, 0)).toMSecsSinceEpoch() - 1000;
+    LogAuthThread thread;
+    thread.m_canRun = true;
+    thread.m_FilePath = QStringList() << path;
+    XORG_FILTERS filter;
+    filter.timeFilterBegin = start + 60000;
+    filter.timeFilterEnd = start + 120000;
+    thread.setFileterParam(filter);
+    QList<LOG_MSG_XORG> records;
+    QObject::connect(&thread, &LogAuthThread::xorgData, [&records](int, QList<LOG_MSG_XORG> list) {
+        records.append(list);
+    });
+    thread.handleXorg();
+    ASSERT_EQ(records.size(), 1);
+    EXPECT_EQ(records.first().offsetUsec, 90000000);
+    EXPECT_EQ(records.first().msg, QString("inside continued"));
+}
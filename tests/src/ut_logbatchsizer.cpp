@@ -0,0 +1,64 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logbatchsizer.h"
+#include "structdef.h"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+/**
+ * @brief fillBatch 追加记录直到批次读满,返回读满时的条数
+ */
+int fillBatch(LogBatchSizer &sizer, QList<LOG_MSG_JOURNAL> &batch, const QString &msg, int limit = 100000)
+{
+    LOG_MSG_JOURNAL record;
+    record.msg = msg;
+    while (batch.size() < limit) {
+        batch.append(record);
+        if (sizer.isFull(batch))
+            break;
+    }
+    return batch.size();
+}
+
+} // namespace
+
+TEST(LogBatchSizer_isFull_UT, LogBatchSizer_isFull_UT_001)
+{
+    LogBatchSizer sizer(1000);
+    QList<LOG_MSG_JOURNAL> batch;
+    //第一批很小,尽快显示
+    EXPECT_EQ(fillBatch(sizer, batch, "a"), LOG_BATCH_FIRST_RECORDS);
+    batch.clear();
+    sizer.delivered();
+
+    //读取很快时批次变大,每次最多放大LOG_BATCH_MAX_GROWTH倍,不超过上限
+    EXPECT_EQ(sizer.target(), LOG_BATCH_FIRST_RECORDS * LOG_BATCH_MAX_GROWTH);
+    for (int i = 0; i < 4; ++i) {
+        fillBatch(sizer, batch, "a");
+        batch.clear();
+        sizer.delivered();
+    }
+    EXPECT_EQ(sizer.target(), 1000);
+
+    sizer.reset();
+    EXPECT_EQ(sizer.target(), LOG_BATCH_FIRST_RECORDS);
+}
+
+TEST(LogBatchSizer_isFull_UT, LogBatchSizer_isFull_UT_002)
+{
+    //每条记录约1KB,内存上限16KB时不到第一批的条数就发出
+    const QString msg(512, QChar('x'));
+    const qint64 bytes = LogBatchSizer::recordBytes(LOG_MSG_JOURNAL());
+    LogBatchSizer sizer(1000, 16 * (bytes + 1024));
+    QList<LOG_MSG_JOURNAL> batch;
+    EXPECT_EQ(fillBatch(sizer, batch, msg), 16);
+    batch.clear();
+    sizer.delivered();
+    //之后的批次也按平均大小限制在内存上限内
+    EXPECT_LE(sizer.target(), LOG_BATCH_FIRST_RECORDS);
+    EXPECT_LE(fillBatch(sizer, batch, msg), 16);
+}
@@ -0,0 +1,59 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logbenchmark.h"
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+
+#include <gtest/gtest.h>
+
+TEST(LogBenchmark_typeForFile_UT, LogBenchmark_typeForFile_UT_001)
+{
+    EXPECT_EQ(LogBenchmark::typeForFile("kern.log"), KERN);
+    EXPECT_EQ(LogBenchmark::typeForFile("kern.log.2.gz"), KERN);
+    EXPECT_EQ(LogBenchmark::typeForFile("dpkg.log.1"), DPKG);
+    EXPECT_EQ(LogBenchmark::typeForFile("Xorg.0.log"), XORG);
+    EXPECT_EQ(LogBenchmark::typeForFile("audit.log"), Audit);
+    EXPECT_EQ(LogBenchmark::typeForFile("deepin-terminal.log"), APP);
+    EXPECT_EQ(LogBenchmark::typeForFile("wtmp"), NONE);
+}
+
+TEST(LogBenchmark_countLines_UT, LogBenchmark_countLines_UT_001)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    const QString path = dir.filePath("kern.log");
+    QFile file(path);
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    file.write("a\nb\nc");
+    file.close();
+    //最后一行没有换行符也计入
+    EXPECT_EQ(LogBenchmark::countLines(path), 3);
+    EXPECT_EQ(LogBenchmark::countLines(dir.filePath("missing.log")), -1);
+}
+
+TEST(LogBenchmark_toJson_UT, LogBenchmark_toJson_UT_001)
+{
+    LogBenchResult result;
+    result.stage = "parse";
+    result.name = "kern";
+    result.bytes = 2 * 1048576;
+    result.lines = 1000;
+    result.records = 900;
+    result.elapsedMs = 500;
+    result.ok = true;
+
+    const QJsonObject root = QJsonDocument::fromJson(LogBenchmark::toJson(QList<LogBenchResult>() << result)).object();
+    EXPECT_EQ(root.value("version").toInt(), 1);
+    const QJsonObject obj = root.value("results").toArray().at(0).toObject();
+    EXPECT_EQ(obj.value("name").toString(), QString("kern"));
+    EXPECT_DOUBLE_EQ(obj.value("linesPerSec").toDouble(), 2000.0);
+    EXPECT_DOUBLE_EQ(obj.value("mbPerSec").toDouble(), 4.0);
+    //没有分批交出时为null
+    EXPECT_EQ(obj.value("firstBatchMs").isNull(), true);
+}
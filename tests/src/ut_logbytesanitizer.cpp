@@ -0,0 +1,42 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logbytesanitizer.h"
+
+#include <gtest/gtest.h>
+
+TEST(LogByteSanitizer_sanitize_UT, LogByteSanitizer_sanitize_UT_001)
+{
+    //干净的数据不改写,也不分离共享的数据
+    QByteArray clean("kernel: usb 1-1\n");
+    const QByteArray shared = clean;
+    EXPECT_EQ(LogByteSanitizer::sanitize(clean, LogByteSanitizer::RemoveNulAndSoh), false);
+    EXPECT_EQ(clean.constData(), shared.constData());
+    EXPECT_EQ(LogByteSanitizer::isClean(clean.constData(), clean.size(), LogByteSanitizer::ReplaceNul), true);
+
+    QByteArray data("a\0b\x01" "c\0", 6);
+    QByteArray replaced = data;
+    EXPECT_EQ(LogByteSanitizer::sanitize(replaced, LogByteSanitizer::ReplaceNul), true);
+    EXPECT_EQ(replaced, QByteArray("a b\x01" "c "));
+
+    QByteArray removed = data;
+    EXPECT_EQ(LogByteSanitizer::sanitize(removed, LogByteSanitizer::RemoveNulAndSoh), true);
+    EXPECT_EQ(removed, QByteArray("abc"));
+
+    QByteArray line = data;
+    EXPECT_EQ(LogByteSanitizer::sanitize(line, LogByteSanitizer::ReplaceNulRemoveSoh), true);
+    EXPECT_EQ(line, QByteArray("a bc "));
+    EXPECT_EQ(data.size(), 6);
+}
+
+TEST(LogByteSanitizer_sanitize_UT, LogByteSanitizer_sanitize_UT_002)
+{
+    //只有0x01时也要处理
+    QByteArray soh("proc\x01: msg");
+    EXPECT_EQ(LogByteSanitizer::isClean(soh.constData(), soh.size(), LogByteSanitizer::ReplaceNul), true);
+    EXPECT_EQ(LogByteSanitizer::sanitize(soh, LogByteSanitizer::RemoveNulAndSoh), true);
+    EXPECT_EQ(soh, QByteArray("proc: msg"));
+    QByteArray empty;
+    EXPECT_EQ(LogByteSanitizer::sanitize(empty, LogByteSanitizer::ReplaceNul), false);
+}
@@ -0,0 +1,126 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logcanceltoken.h"
+
+#include <QBuffer>
+#include <QElapsedTimer>
+#include <QProcess>
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+TEST(LogCancelScope_current_UT, LogCancelScope_current_UT_001)
+{
+    //没有安装令牌时永远不会取消
+    EXPECT_FALSE(LogCancelToken::current().isCancellable());
+    std::atomic_bool canRun(true);
+    {
+        LogCancelScope scope(canRun);
+        EXPECT_TRUE(LogCancelToken::current().isCancellable());
+        EXPECT_FALSE(LogCancelToken::current().isCancelled());
+        canRun = false;
+        EXPECT_TRUE(LogCancelToken::current().isCancelled());
+    }
+    EXPECT_FALSE(LogCancelToken::current().isCancellable());
+}
+
+TEST(LogCancelScope_current_UT, LogCancelScope_current_UT_002)
+{
+    //工作线程安装调用者的令牌后随调用者取消
+    std::atomic_bool canRun(true);
+    LogCancelScope scope(canRun);
+    const LogCancelToken token = LogCancelToken::current();
+    bool cancellable = false;
+    bool cancelled = false;
+    canRun = false;
+    std::thread worker([&]() {
+        LogCancelScope workerScope(token);
+        cancellable = LogCancelToken::current().isCancellable();
+        cancelled = LogCancelToken::current().isCancelled();
+    });
+    worker.join();
+    EXPECT_TRUE(cancellable);
+    EXPECT_TRUE(cancelled);
+
+    //不可取消的令牌安装后仍不可取消
+    std::thread plain([&]() {
+        LogCancelScope workerScope((LogCancelToken()));
+        cancellable = LogCancelToken::current().isCancellable();
+    });
+    plain.join();
+    EXPECT_FALSE(cancellable);
+}
+
+TEST(LogCancelToken_readAll_UT, LogCancelToken_readAll_UT_001)
+{
+    QByteArray content(LOG_CANCEL_READ_CHUNK + 10, 'a');
+    QBuffer buffer(&content);
+    ASSERT_TRUE(buffer.open(QIODevice::ReadOnly));
+    std::atomic_bool canRun(true);
+    QByteArray data;
+    EXPECT_TRUE(LogCancelToken(canRun).readAll(&buffer, data));
+    EXPECT_EQ(data.size(), content.size());
+
+    buffer.seek(0);
+    canRun = false;
+    EXPECT_FALSE(LogCancelToken(canRun).readAll(&buffer, data));
+    EXPECT_TRUE(data.isEmpty());
+}
+
+TEST(LogCancelToken_waitForProcess_UT, LogCancelToken_waitForProcess_UT_001)
+{
+    QProcess process;
+    process.start("sleep", QStringList() << "30");
+    if (!process.waitForStarted())
+        return;
+    std::atomic_bool canRun(true);
+    std::thread stopper([&canRun]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        canRun = false;
+    });
+    QElapsedTimer timer;
+    timer.start();
+    //取消后结束子进程并很快返回,不等待子进程自己退出
+    EXPECT_FALSE(LogCancelToken(canRun).waitForProcess(&process));
+    EXPECT_LT(timer.elapsed(), 5000);
+    stopper.join();
+    process.waitForFinished(1000);
+    EXPECT_EQ(process.state(), QProcess::NotRunning);
+}
+
+TEST(LogCancelToken_readLines_UT, LogCancelToken_readLines_UT_001)
+{
+    //逐行交出输出,最后一行没有换行符也交出
+    QProcess process;
+    process.start("sh", QStringList() << "-c" << "printf 'a\\nb\\nc'");
+    if (!process.waitForStarted())
+        return;
+    std::atomic_bool canRun(true);
+    QList<QByteArray> lines;
+    EXPECT_TRUE(LogCancelToken(canRun).readLines(&process, [&lines](const QByteArray &line) {
+        lines << line;
+        return true;
+    }));
+    EXPECT_EQ(lines, QList<QByteArray>() << "a" << "b" << "c");
+}
+
+TEST(LogCancelToken_readLines_UT, LogCancelToken_readLines_UT_002)
+{
+    //子进程退出前就能读到输出,回调返回false时结束子进程
+    QProcess process;
+    process.start("yes");
+    if (!process.waitForStarted())
+        return;
+    std::atomic_bool canRun(true);
+    int count = 0;
+    EXPECT_FALSE(LogCancelToken(canRun).readLines(&process, [&count](const QByteArray &line) {
+        EXPECT_EQ(line, QByteArray("y"));
+        return ++count < 10;
+    }));
+    EXPECT_EQ(count, 10);
+    process.waitForFinished(1000);
+    EXPECT_EQ(process.state(), QProcess::NotRunning);
+}
@@ -0,0 +1,58 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logcasematcher.h"
+
+#include <gtest/gtest.h>
+
+TEST(LogCaseMatcher_indexIn_UT, LogCaseMatcher_indexIn_UT_001)
+{
+    const QString text = QString("kernel: usb 1-1: new high-speed USB device number 2 using xhci_hcd");
+    LogCaseMatcher matcher("usb DEVICE");
+    EXPECT_TRUE(matcher.isVectorized());
+    EXPECT_EQ(matcher.indexIn(text), text.indexOf("USB device"));
+    EXPECT_EQ(matcher.indexIn(text, 30), -1);
+    EXPECT_EQ(LogCaseMatcher("USB").indexIn(text, 10), text.indexOf("USB"));
+    //关键字比文本长
+    EXPECT_EQ(LogCaseMatcher(text + "x").indexIn(text), -1);
+}
+
+TEST(LogCaseMatcher_indexIn_UT, LogCaseMatcher_indexIn_UT_002)
+{
+    //开尔文符号和长s按foldCase与k、s相等
+    const QString text = QString("mar") + QChar(0x212a) + QString("ed as ") + QChar(0x017f) + QString("ent");
+    EXPECT_EQ(LogCaseMatcher("rk").indexIn(text), 2);
+    EXPECT_EQ(LogCaseMatcher("Sent").indexIn(text), text.length() - 4);
+
+    //首字符不是ASCII时退回QStringMatcher
+    const QString chinese = QString::fromUtf8("系统日志 System Log");
+    LogCaseMatcher fallback(QString::fromUtf8("日志 sys"));
+    EXPECT_FALSE(fallback.isVectorized());
+    EXPECT_EQ(fallback.indexIn(chinese), 2);
+}
+
+TEST(LogCaseMatcher_indexIn_UT, LogCaseMatcher_indexIn_UT_003)
+{
+    //和QString::indexOf(Qt::CaseInsensitive)的结果一致,覆盖向量处理的各个位置和结尾
+    const char alphabet[] = "abAB c:";
+    quint32 seed = 1;
+    for (int round = 0; round < 2000; ++round) {
+        QString text;
+        QString pattern;
+        seed = seed * 1103515245 + 12345;
+        const int textLength = static_cast<int>(seed >> 16) % 48;
+        for (int i = 0; i < textLength; ++i) {
+            seed = seed * 1103515245 + 12345;
+            text += QLatin1Char(alphabet[(seed >> 16) % 7]);
+        }
+        seed = seed * 1103515245 + 12345;
+        const int patternLength = 1 + static_cast<int>(seed >> 16) % 4;
+        for (int i = 0; i < patternLength; ++i) {
+            seed = seed * 1103515245 + 12345;
+            pattern += QLatin1Char(alphabet[(seed >> 16) % 7]);
+        }
+        ASSERT_EQ(LogCaseMatcher(pattern).indexIn(text), text.indexOf(pattern, 0, Qt::CaseInsensitive))
+                << text.toStdString() << " / " << pattern.toStdString();
+    }
+}
@@ -0,0 +1,307 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logcategorycache.h"
+
+#include <gtest/gtest.h>
+
+namespace {
+QList<LOG_MSG_DPKG> dpkgBatch(int count, const QString &msg = "msg")
+{
+    QList<LOG_MSG_DPKG> batch;
+    for (int i = 0; i < count; ++i) {
+        LOG_MSG_DPKG record;
+        record.dateTime = "2023-01-01 00:00:00";
+        record.action = "install";
+        record.msg = msg + QString::number(i);
+        batch.append(record);
+    }
+    return batch;
+}
+
+LogCacheValidity fileValidity(qint64 size)
+{
+    LogFileStat stat;
+    stat.path = "/var/log/dpkg.log";
+    stat.exists = true;
+    stat.size = size;
+    stat.mtime = 1000;
+    stat.inode = 7;
+    LogCacheValidity validity;
+    validity.files.append(stat);
+    return validity;
+}
+}
+
+TEST(LogCategoryCache_find_UT, LogCategoryCache_find_UT_001)
+{
+    LogCategoryCache cache;
+    cache.begin("dpkg", 1, fileValidity(100));
+    cache.collect(1, dpkgBatch(2));
+    //其他标号的数据不收集
+    cache.collect(2, dpkgBatch(5));
+    cache.collect(1, dpkgBatch(1, "tail"));
+    cache.finish(1);
+    EXPECT_EQ(cache.size(), 1);
+    EXPECT_GT(cache.cost(), 0);
+
+    QVector<QList<LOG_MSG_DPKG>> batches;
+    ASSERT_EQ(cache.find("dpkg", fileValidity(100), &batches), true);
+    ASSERT_EQ(batches.size(), 2);
+    EXPECT_EQ(batches.at(0).size(), 2);
+    EXPECT_EQ(batches.at(1).first().msg, QString("tail0"));
+
+    //类型不同不命中
+    QVector<QList<LOG_MSG_BOOT>> bootBatches;
+    EXPECT_EQ(cache.find("boot", fileValidity(100), &bootBatches), false);
+}
+
+TEST(LogCategoryCache_find_UT, LogCategoryCache_find_UT_002)
+{
+    LogCategoryCache cache;
+    cache.begin("dpkg", 1, fileValidity(100));
+    cache.collect(1, dpkgBatch(2));
+    cache.finish(1);
+
+    //文件变化后缓存失效并被移除
+    QVector<QList<LOG_MSG_DPKG>> batches;
+    EXPECT_EQ(cache.find("dpkg", fileValidity(200), &batches), false);
+    EXPECT_EQ(cache.size(), 0);
+    EXPECT_EQ(cache.cost(), 0);
+}
+
+TEST(LogCategoryCache_finish_UT, LogCategoryCache_finish_UT_001)
+{
+    LogCategoryCache cache;
+    //没有数据的结果不缓存
+    cache.begin("empty", 1, fileValidity(0));
+    cache.finish(1);
+    EXPECT_EQ(cache.size(), 0);
+
+    //中途停止的结果不缓存
+    cache.begin("dpkg", 2, fileValidity(100));
+    cache.collect(2, dpkgBatch(2));
+    cache.abort();
+    cache.finish(2);
+    EXPECT_EQ(cache.size(), 0);
+
+    //上限为0时不缓存
+    cache.setBudget(0);
+    cache.begin("dpkg", 3, fileValidity(100));
+    cache.collect(3, dpkgBatch(2));
+    cache.finish(3);
+    EXPECT_EQ(cache.size(), 0);
+}
+
+TEST(LogCategoryCache_evict_UT, LogCategoryCache_evict_UT_001)
+{
+    LogCategoryCache cache;
+    cache.begin("a", 1, fileValidity(1));
+    cache.collect(1, dpkgBatch(10));
+    cache.finish(1);
+    const qint64 oneCost = cache.cost();
+    cache.begin("b", 2, fileValidity(1));
+    cache.collect(2, dpkgBatch(10));
+    cache.finish(2);
+    ASSERT_EQ(cache.size(), 2);
+
+    //最近使用过a,超出上限时先压缩b
+    QVector<QList<LOG_MSG_DPKG>> batches;
+    EXPECT_EQ(cache.find("a", fileValidity(1), &batches), true);
+    cache.setBudget(oneCost + oneCost / 2);
+    EXPECT_EQ(cache.size(), 2);
+    EXPECT_EQ(cache.compressedCount(), 1);
+    EXPECT_LE(cache.cost(), oneCost + oneCost / 2);
+    //压缩后仍超出时淘汰最久未使用的
+    cache.setBudget(oneCost);
+    EXPECT_EQ(cache.size(), 1);
+    EXPECT_EQ(cache.find("a", fileValidity(1), &batches), true);
+    EXPECT_EQ(cache.find("b", fileValidity(1), &batches), false);
+
+    //单次结果超过上限时不缓存
+    cache.begin("c", 3, fileValidity(1));
+    cache.collect(3, dpkgBatch(100));
+    cache.finish(3);
+    EXPECT_EQ(cache.find("c", fileValidity(1), &batches), false);
+    EXPECT_EQ(cache.size(), 1);
+}
+
+TEST(LogCategoryCache_evict_UT, LogCategoryCache_evict_UT_002)
+{
+    LogCategoryCache cache;
+    cache.begin("a", 1, fileValidity(1));
+    cache.collect(1, dpkgBatch(10));
+    cache.collect(1, dpkgBatch(5, "tail"));
+    cache.finish(1);
+    const qint64 oneCost = cache.cost();
+    cache.begin("b", 2, fileValidity(1));
+    cache.collect(2, dpkgBatch(15));
+    cache.finish(2);
+    cache.setBudget(oneCost + oneCost / 2);
+    ASSERT_EQ(cache.compressedCount(), 1);
+
+    //取出压缩的a时解压,内容和批次不变,之后压缩最久未使用的b
+    QVector<QList<LOG_MSG_DPKG>> batches;
+    ASSERT_EQ(cache.find("a", fileValidity(1), &batches), true);
+    ASSERT_EQ(batches.size(), 2);
+    ASSERT_EQ(batches.at(0).size(), 10);
+    EXPECT_EQ(batches.at(0).at(3).msg, QString("msg3"));
+    EXPECT_EQ(batches.at(0).at(3).action, QString("install"));
+    EXPECT_EQ(batches.at(1).last().msg, QString("tail4"));
+    EXPECT_EQ(cache.size(), 2);
+    EXPECT_EQ(cache.compressedCount(), 1);
+    ASSERT_EQ(cache.find("b", fileValidity(1), &batches), true);
+    EXPECT_EQ(batches.at(0).size(), 15);
+}
+
+TEST(LogCategoryCache_cursor_UT, LogCategoryCache_cursor_UT_001)
+{
+    LogCategoryCache cache;
+    cache.begin("journal", 1, LogCacheValidity());
+    QList<LOG_MSG_JOURNAL> batch;
+    LOG_MSG_JOURNAL record;
+    record.msg = "journal";
+    batch.append(record);
+    cache.collect(1, batch);
+    cache.setCursor(1, "s=cursor");
+    cache.finish(1);
+
+    QVector<QList<LOG_MSG_JOURNAL>> batches;
+    QString cursor;
+    ASSERT_EQ(cache.find("journal", LogCacheValidity(), &batches, &cursor), true);
+    EXPECT_EQ(cursor, QString("s=cursor"));
+    cache.clear();
+    EXPECT_EQ(cache.size(), 0);
+}
+
+TEST(LogCacheRange_covers_UT, LogCacheRange_covers_UT_001)
+{
+    LogCacheRange all;
+    LogCacheRange month;
+    month.begin = 100;
+    month.end = 200;
+    LogCacheRange today;
+    today.begin = 180;
+    today.end = 200;
+    today.match = "PRIORITY=3";
+    EXPECT_EQ(all.covers(month), true);
+    EXPECT_EQ(all.covers(today), true);
+    EXPECT_EQ(month.covers(today), true);
+    EXPECT_EQ(today.covers(month), false);
+    EXPECT_EQ(month.covers(all), false);
+
+    //只缓存了某一等级时不能筛出其他等级
+    LogCacheRange error = all;
+    error.match = "PRIORITY=3";
+    LogCacheRange warning = all;
+    warning.match = "PRIORITY=4";
+    EXPECT_EQ(error.covers(today), true);
+    EXPECT_EQ(error.covers(warning), false);
+    EXPECT_EQ(error.covers(all), false);
+}
+
+TEST(LogCategoryCache_findCovering_UT, LogCategoryCache_findCovering_UT_001)
+{
+    LogCategoryCache cache;
+    LogCacheRange month;
+    month.begin = 100;
+    month.end = 200;
+    cache.begin("kern:100:200", 1, fileValidity(1), "kern", month);
+    cache.collect(1, dpkgBatch(10));
+    cache.finish(1);
+    LogCacheRange week;
+    week.begin = 150;
+    week.end = 200;
+    cache.begin("kern:150:200", 2, fileValidity(1), "kern", week);
+    cache.collect(2, dpkgBatch(3));
+    cache.finish(2);
+
+    //有多个包含新范围的结果时取记录最少的
+    LogCacheRange today;
+    today.begin = 180;
+    today.end = 200;
+    QVector<QList<LOG_MSG_DPKG>> batches;
+    ASSERT_EQ(cache.findCovering("kern", today, fileValidity(1), &batches), true);
+    ASSERT_EQ(batches.size(), 1);
+    EXPECT_EQ(batches.first().size(), 3);
+
+    LogCacheRange older;
+    older.begin = 120;
+    older.end = 200;
+    ASSERT_EQ(cache.findCovering("kern", older, fileValidity(1), &batches), true);
+    EXPECT_EQ(batches.first().size(), 10);
+
+    //其他类别、文件变化或没有类别时不命中
+    EXPECT_EQ(cache.findCovering("dpkg", today, fileValidity(1), &batches), false);
+    EXPECT_EQ(cache.findCovering("kern", today, fileValidity(2), &batches), false);
+    EXPECT_EQ(cache.findCovering(QString(), today, fileValidity(1), &batches), false);
+    LogCacheRange all;
+    EXPECT_EQ(cache.findCovering("kern", all, fileValidity(1), &batches), false);
+}
+
+TEST(LogCategoryCache_finish_UT, LogCategoryCache_finish_UT_002)
+{
+    //后台预取和界面加载按标号分别收集
+    LogCategoryCache cache;
+    cache.begin("dpkg", 1, fileValidity(1));
+    cache.begin("xorg", -1, fileValidity(2));
+    cache.collect(1, dpkgBatch(2));
+    cache.collect(-1, dpkgBatch(3));
+    cache.abort(1);
+    cache.finish(1);
+    cache.finish(-1);
+    EXPECT_EQ(cache.size(), 1);
+    EXPECT_EQ(cache.contains("dpkg", fileValidity(1)), false);
+    EXPECT_EQ(cache.contains("xorg", fileValidity(2)), true);
+    EXPECT_EQ(cache.contains("xorg", fileValidity(3)), false);
+}
+
+TEST(LogCategoryCache_removeFiles_UT, LogCategoryCache_removeFiles_UT_001)
+{
+    LogCategoryCache cache;
+    cache.begin("dpkg", 1, fileValidity(100));
+    cache.collect(1, dpkgBatch(2));
+    cache.finish(1);
+    //没有来源文件的类别(如系统日志)不受影响
+    cache.begin("journal", 2, LogCacheValidity());
+    cache.collect(2, dpkgBatch(3));
+    cache.finish(2);
+    ASSERT_EQ(cache.size(), 2);
+
+    EXPECT_EQ(cache.removeFiles(QStringList() << "/var/log/kern.log"), 0);
+    EXPECT_EQ(cache.removeFiles(QStringList() << "/var/log/dpkg.log"), 1);
+    EXPECT_EQ(cache.size(), 1);
+    EXPECT_EQ(cache.contains("journal", LogCacheValidity()), true);
+}
+
+TEST(LogCategoryCache_importSnapshot_UT, LogCategoryCache_importSnapshot_UT_001)
+{
+    QList<LOG_MSG_DNF> batch;
+    LOG_MSG_DNF record;
+    record.dateTime = "2023-01-01 00:00:00";
+    record.level = WARNING;
+    record.msg = "dnf msg";
+    batch.append(record);
+    record.level = DNFINVALID;
+    batch.append(record);
+
+    LogCategoryCache cache;
+    cache.begin("dnf:0:1", 1, fileValidity(100), "dnf");
+    cache.collect(1, batch);
+    cache.finish(1);
+    const QList<LogCategoryCache::SnapshotEntry> entries = cache.snapshotEntries();
+    ASSERT_EQ(entries.size(), 1);
+    EXPECT_EQ(entries.first().type, QByteArray("dnf"));
+
+    //等级按原值写入快照,无法识别的等级也保留
+    LogCategoryCache opened;
+    EXPECT_EQ(opened.importSnapshot(entries), 1);
+    QVector<QList<LOG_MSG_DNF>> batches;
+    ASSERT_EQ(opened.find("dnf:0:1", LogCacheValidity(), &batches), true);
+    ASSERT_EQ(batches.size(), 1);
+    ASSERT_EQ(batches.first().size(), 2);
+    EXPECT_EQ(batches.first().at(0).level, static_cast<int>(WARNING));
+    EXPECT_EQ(batches.first().at(1).level, static_cast<int>(DNFINVALID));
+    EXPECT_EQ(batches.first().at(1).msg, QString("dnf msg"));
+}
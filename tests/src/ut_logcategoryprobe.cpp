@@ -0,0 +1,68 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logcategoryprobe.h"
+#include "structdef.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryDir>
+
+#include <gtest/gtest.h>
+
+static void writeFile(const QString &path, const QByteArray &data)
+{
+    QFile file(path);
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    file.write(data);
+}
+
+TEST(LogCategoryProbe_approximateSize_UT, LogCategoryProbe_approximateSize_UT_001)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    QDir(dir.path()).mkpath("machine");
+    writeFile(dir.filePath("system.journal"), QByteArray(100, 'a'));
+    writeFile(dir.filePath("machine/user-1000.journal"), QByteArray(28, 'b'));
+
+    //目录为其中所有文件大小之和,包括子目录
+    EXPECT_EQ(LogCategoryProbe::approximateSize(dir.path()), 128);
+    EXPECT_EQ(LogCategoryProbe::approximateSize(dir.filePath("system.journal")), 100);
+    EXPECT_EQ(LogCategoryProbe::approximateSize(dir.filePath("missing.log")), 0);
+}
+
+TEST(LogCategoryProbe_isStampValid_UT, LogCategoryProbe_isStampValid_UT_001)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    QMap<QString, qint64> stamps;
+    stamps.insert(dir.path(), QFileInfo(dir.path()).lastModified().toMSecsSinceEpoch());
+    stamps.insert(dir.filePath("missing"), -1);
+    EXPECT_EQ(LogCategoryProbe::isStampValid(stamps), true);
+    EXPECT_EQ(LogCategoryProbe::isStampValid(QMap<QString, qint64>()), false);
+
+    //目录不存在的路径出现时失效
+    QDir(dir.path()).mkpath("missing");
+    EXPECT_EQ(LogCategoryProbe::isStampValid(stamps), false);
+}
+
+TEST(LogCategoryProbeResult_state_UT, LogCategoryProbeResult_state_UT_001)
+{
+    LogCategoryProbeResult result;
+    LogCategoryState dpkg;
+    dpkg.type = DPKG_TREE_DATA;
+    dpkg.available = true;
+    dpkg.size = 42;
+    result.states.append(dpkg);
+
+    EXPECT_EQ(result.state(DPKG_TREE_DATA).available, true);
+    EXPECT_EQ(result.state(DPKG_TREE_DATA).size, 42);
+    //没有探测结果的类别按不可用、大小未知处理
+    EXPECT_EQ(result.state(LAST_TREE_DATA).type, QString(LAST_TREE_DATA));
+    EXPECT_EQ(result.state(LAST_TREE_DATA).available, false);
+    EXPECT_EQ(result.state(LAST_TREE_DATA).size, -1);
+    EXPECT_EQ(LogCategoryProbe::probedTypes().contains(AUDIT_TREE_DATA), true);
+}
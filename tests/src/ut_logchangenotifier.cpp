@@ -0,0 +1,50 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logchangenotifier.h"
+
+#include <QFile>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+
+#include <gtest/gtest.h>
+
+TEST(LogChangeNotifier_inRotationSet_UT, LogChangeNotifier_inRotationSet_UT_001)
+{
+    EXPECT_TRUE(LogChangeNotifier::inRotationSet("kern.log", "kern.log"));
+    EXPECT_TRUE(LogChangeNotifier::inRotationSet("kern.log.1", "kern.log"));
+    EXPECT_TRUE(LogChangeNotifier::inRotationSet("kern.log.2.gz", "kern.log"));
+    EXPECT_FALSE(LogChangeNotifier::inRotationSet("kern.log.bak", "kern.log"));
+    EXPECT_FALSE(LogChangeNotifier::inRotationSet("kern.logx", "kern.log"));
+    EXPECT_FALSE(LogChangeNotifier::inRotationSet("dpkg.log", "kern.log"));
+}
+
+TEST(LogChangeNotifier_changed_UT, LogChangeNotifier_changed_UT_001)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    const QString path = dir.filePath("test.log");
+    LogChangeNotifier notifier;
+    notifier.setPaths(QStringList() << path);
+    ASSERT_TRUE(notifier.isActive());
+    QSignalSpy spy(&notifier, &LogChangeNotifier::changed);
+
+    //其他文件的变化不通知
+    QFile other(dir.filePath("other.log"));
+    ASSERT_TRUE(other.open(QIODevice::WriteOnly));
+    other.write("x\n");
+    other.close();
+    EXPECT_FALSE(spy.wait(LOG_CHANGE_NOTIFY_DELAY * 2));
+
+    //轮转文件的变化归到当前文件
+    QFile rotated(path + ".1");
+    ASSERT_TRUE(rotated.open(QIODevice::WriteOnly));
+    rotated.write("a\n");
+    rotated.close();
+    ASSERT_TRUE(spy.wait(LOG_CHANGE_NOTIFY_DELAY * 4));
+    EXPECT_EQ(spy.takeFirst().at(0).toStringList(), QStringList() << path);
+
+    notifier.setPaths(QStringList());
+    EXPECT_FALSE(notifier.isActive());
+}
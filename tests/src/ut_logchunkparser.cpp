@@ -0,0 +1,89 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logchunkparser.h"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+TEST(LogChunkParser_run_UT, LogChunkParser_run_UT_001)
+{
+    //块的耗时不均时空闲线程窃取其它队列的块,交付仍按顺序号
+    std::atomic_bool canRun(true);
+    LogChunkParser<int> parser(canRun);
+    QList<int> delivered;
+    bool completed = parser.run(40, 4, [](int index, QList<int> &records) {
+        if (index % 4 == 0)
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        records << index;
+        return true;
+    }, [&delivered](QList<int> &records) {
+        delivered.append(records);
+        return true;
+    });
+    EXPECT_TRUE(completed);
+    ASSERT_EQ(delivered.size(), 40);
+    for (int i = 0; i < delivered.size(); ++i)
+        EXPECT_EQ(delivered.at(i), i);
+    EXPECT_GT(parser.stolen(), 0);
+}
+
+TEST(LogChunkParser_run_UT, LogChunkParser_run_UT_002)
+{
+    //交付慢时只解析窗口内的块
+    std::atomic_bool canRun(true);
+    LogChunkParser<int> parser(canRun);
+    std::atomic<int> parsed(0);
+    int delivered = 0;
+    int maxAhead = 0;
+    bool completed = parser.run(30, 2, [&parsed](int index, QList<int> &records) {
+        ++parsed;
+        records << index;
+        return true;
+    }, [&parsed, &delivered, &maxAhead](QList<int> &) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        maxAhead = qMax(maxAhead, parsed - delivered);
+        ++delivered;
+        return true;
+    });
+    EXPECT_TRUE(completed);
+    EXPECT_EQ(delivered, 30);
+    EXPECT_LE(maxAhead, 2 + LOG_CHUNK_WINDOW_EXTRA);
+}
+
+TEST(LogChunkParser_run_UT, LogChunkParser_run_UT_003)
+{
+    //解析失败或被停止时返回false
+    std::atomic_bool canRun(true);
+    LogChunkParser<int> parser(canRun);
+    EXPECT_FALSE(parser.run(10, 3, [](int index, QList<int> &records) {
+        records << index;
+        return index != 5;
+    }, [](QList<int> &) { return true; }));
+
+    canRun = false;
+    EXPECT_FALSE(parser.run(10, 1, [](int index, QList<int> &records) {
+        records << index;
+        return true;
+    }, [](QList<int> &) { return true; }));
+}
+
+TEST(LogChunkParser_run_UT, LogChunkParser_run_UT_004)
+{
+    //工作线程中的总线调用等通过调用者的取消令牌等待
+    std::atomic_bool canRun(true);
+    LogCancelScope scope(canRun);
+    LogChunkParser<int> parser(canRun);
+    std::atomic_int cancellable(0);
+    parser.run(8, 2, [&cancellable](int index, QList<int> &records) {
+        if (LogCancelToken::current().isCancellable())
+            ++cancellable;
+        records << index;
+        return true;
+    }, [](QList<int> &) {
+        return true;
+    });
+    EXPECT_EQ(cancellable.load(), 8);
+}
@@ -164,6 +164,7 @@ TEST(LogCollectorMain_initShortCut_UT, LogCollectorMain_initShortCut_UT_002)
     stub.set(ADDR(LogApplicationHelper, getCustomLogList), LogApplicationHelper_getCustomLogList);
     LogCollectorMain *p = new LogCollectorMain(nullptr);
     EXPECT_NE(p, nullptr);
+    p->initShortCut();
     p->m_scWndReize->deleteLater();
     p->m_scWndReize = nullptr;
     p->m_scFindFont->deleteLater();
@@ -177,6 +178,33 @@ TEST(LogCollectorMain_initShortCut_UT, LogCollectorMain_initShortCut_UT_002)
     p->deleteLater();
 }
 
+TEST(LogCollectorMain_initDeferred_UT, LogCollectorMain_initDeferred_UT_001)
+{
+    Stub stub;
+    stub.set(ADDR(DebugTimeManager, beginPointLinux), Log_beginPointLinux);
+    stub.set(ADDR(LogFileParser, parseByJournal), LogFileParser_parseByJournal);
+    stub.set(ADDR(LogFileParser, parseByJournalBoot), LogFileParser_parseByJournalBoot);
+    stub.set(ADDR(LogFileParser, parseByDpkg), LogFileParser_parseByDpkg);
+    stub.set(ADDR(LogFileParser, parseByXlog), LogFileParser_parseByXlog);
+    stub.set(ADDR(LogFileParser, parseByBoot), LogFileParser_parseByBoot);
+    stub.set(ADDR(LogFileParser, parseByKern), LogFileParser_parseByKern);
+    stub.set(ADDR(LogFileParser, parseByApp), LogFileParser_parseByApp);
+    stub.set(ADDR(LogFileParser, parseByNormal), LogFileParser_parseByNormal);
+    stub.set(ADDR(LogFileParser, parseByKwin), LogFileParser_parseByKwin);
+    stub.set(ADDR(LogApplicationHelper, getCustomLogList), LogApplicationHelper_getCustomLogList);
+    LogCollectorMain *p = new LogCollectorMain(nullptr);
+    //快捷键和刷新菜单不在构造时创建
+    EXPECT_EQ(p->m_scFindFont, nullptr);
+    EXPECT_EQ(p->m_refreshActions.isEmpty(), true);
+    p->initDeferred();
+    EXPECT_NE(p->m_scFindFont, nullptr);
+    EXPECT_EQ(p->m_refreshActions.size(), 5);
+    //只执行一次
+    p->initDeferred();
+    EXPECT_EQ(p->m_refreshActions.size(), 5);
+    p->deleteLater();
+}
+
 TEST(LogCollectorMain_initConnection_UT, LogCollectorMain_initConnection_UT)
 {
     Stub stub;
@@ -0,0 +1,87 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logcompactrecords.h"
+#include "journalreader.h"
+
+#include <gtest/gtest.h>
+
+static LOG_MSG_JOURNAL journalRecord(int i)
+{
+    LOG_MSG_JOURNAL record;
+    record.timestamp = (1688000000LL + i) * 1000000;
+    record.dateTime = JournalReaderBase::formatTime(static_cast<quint64>(record.timestamp));
+    record.hostName = "uos-PC";
+    record.daemonName = QString("daemon%1").arg(i % 3);
+    record.daemonId = QString::number(100 + i);
+    record.level = i % 2 ? INF : WARN;
+    record.msg = QString("消息%1").arg(i);
+    return record;
+}
+
+TEST(LogStringArena_add_UT, LogStringArena_add_UT_001)
+{
+    LogStringArena arena;
+    LogArenaString first = arena.add(QString("kernel"));
+    LogArenaString second = arena.add(QString("内核"));
+    EXPECT_EQ(arena.text(first), QString("kernel"));
+    EXPECT_EQ(arena.text(second), QString("内核"));
+    EXPECT_EQ(second.offset, first.length);
+    EXPECT_EQ(arena.text(arena.add(QString())).isEmpty(), true);
+    EXPECT_EQ(arena.size(), QString("kernel内核").toUtf8().size());
+    //view直接指向字符区,不复制
+    EXPECT_EQ(arena.view(second).toString(), QString("内核"));
+    EXPECT_EQ(arena.view(second).size, 6);
+}
+
+TEST(LogCompactJournalList_at_UT, LogCompactJournalList_at_UT_001)
+{
+    LogCompactJournalList list;
+    const int count = LOG_COMPACT_BATCH_SIZE + 10;
+    for (int i = 0; i < count; ++i)
+        list.append(journalRecord(i));
+    ASSERT_EQ(list.size(), count);
+
+    //跨批次取出的记录和追加时一致
+    for (int i : {0, 1, LOG_COMPACT_BATCH_SIZE - 1, LOG_COMPACT_BATCH_SIZE, count - 1}) {
+        const LOG_MSG_JOURNAL expected = journalRecord(i);
+        const LOG_MSG_JOURNAL record = list.at(i);
+        EXPECT_EQ(record.timestamp, expected.timestamp);
+        EXPECT_EQ(record.dateTime, expected.dateTime);
+        EXPECT_EQ(record.hostName, expected.hostName);
+        EXPECT_EQ(record.daemonName, expected.daemonName);
+        EXPECT_EQ(record.daemonId, expected.daemonId);
+        EXPECT_EQ(record.level, expected.level);
+        EXPECT_EQ(record.msg, expected.msg);
+        EXPECT_EQ(list.level(i), expected.level);
+    }
+    EXPECT_EQ(list.toList().size(), count);
+}
+
+TEST(LogCompactJournalList_at_UT, LogCompactJournalList_at_UT_002)
+{
+    //内核日志没有时间戳,时间文本原样保存
+    LogCompactJournalList list;
+    LOG_MSG_JOURNAL record;
+    record.dateTime = "Jul  3 10:00:00";
+    record.msg = "usb 1-1: new device";
+    record.cursor = "s=abc";
+    list.append(record);
+    EXPECT_EQ(list.at(0).dateTime, record.dateTime);
+    EXPECT_EQ(list.at(0).cursor, record.cursor);
+    EXPECT_EQ(list.at(0).level, -1);
+
+    list.clear();
+    EXPECT_EQ(list.isEmpty(), true);
+    EXPECT_EQ(list.arenaSize(), 0);
+}
+
+TEST(LogCompactJournalList_message_UT, LogCompactJournalList_message_UT_001)
+{
+    LogCompactJournalList list;
+    list.append(journalRecord(1));
+    list.append(journalRecord(2));
+    EXPECT_EQ(list.message(1).toString(), QString("消息2"));
+    EXPECT_EQ(LogUtf8Matcher("消息1").matches(list.message(0)), true);
+}
@@ -0,0 +1,112 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logcoredumpdetail.h"
+#include "logcoredumpstackwork.h"
+
+#include <QTemporaryDir>
+
+#include <gtest/gtest.h>
+
+TEST(LogCoredumpDetail_stackTrace_UT, LogCoredumpDetail_stackTrace_UT_001)
+{
+    const QString message = "Process 1234 (deepin-demo) of user 1000 dumped core.\n\n"
+                            "Stack trace of thread 1234:\n#0  0x00007f raise (libc.so.6)\n\n"
+                            "Stack trace of thread 1235:\n#0  0x00007e poll (libc.so.6)\n";
+    //只取第一个线程的堆栈
+    EXPECT_EQ(LogCoredumpDetail::stackTrace(message), QString("Stack trace of thread 1234:\n#0  0x00007f raise (libc.so.6)\n\n"));
+    EXPECT_EQ(LogCoredumpDetail::stackTrace("Stack trace of thread 1:\n#0 main"), QString("Stack trace of thread 1:\n#0 main"));
+    EXPECT_EQ(LogCoredumpDetail::stackTrace("Process 1234 (deepin-demo) of user 1000 dumped core.").isEmpty(), true);
+}
+
+TEST(LogCoredumpDetail_load_UT, LogCoredumpDetail_load_UT_001)
+{
+    //已读取过详情的记录不再读取
+    LOG_MSG_COREDUMP record;
+    record.coreFile = "present";
+    record.stackInfo = "Stack trace of thread 1:";
+    LogCoredumpDetail detail;
+    detail.load(record);
+    EXPECT_EQ(record.stackInfo, QString("Stack trace of thread 1:"));
+    EXPECT_EQ(record.maps.isEmpty(), true);
+    EXPECT_EQ(detail.stack(QByteArray()).isEmpty(), true);
+}
+
+TEST(LogCoredumpDetailCache_lookup_UT, LogCoredumpDetailCache_lookup_UT_001)
+{
+    QTemporaryDir dir;
+    const QString path = dir.path() + "/coredump/details.dat";
+    LOG_MSG_COREDUMP record;
+    record.coreFile = "present";
+    record.timestamp = 100;
+    record.stackInfo = "Stack trace of thread 1:";
+    record.maps = "00400000 r-xp /usr/bin/demo";
+    LOG_MSG_COREDUMP missing = record;
+    missing.maps.clear();
+    {
+        LogCoredumpDetailCache cache(path);
+        cache.insert("s=1", record);
+        //需要maps但没有读到的记录不缓存,下次重新读取
+        cache.insert("s=2", missing);
+        missing.coreFile = "missing";
+        cache.insert("s=3", missing);
+        EXPECT_EQ(cache.size(), 2);
+        EXPECT_EQ(cache.save(), true);
+    }
+
+    LogCoredumpDetailCache cache(path);
+    EXPECT_EQ(cache.size(), 2);
+    LOG_MSG_COREDUMP found;
+    found.cursor = "s=1";
+    EXPECT_EQ(cache.lookup(found), true);
+    EXPECT_EQ(found.stackInfo, record.stackInfo);
+    EXPECT_EQ(found.maps, record.maps);
+    EXPECT_EQ(found.cursor.isEmpty(), true);
+    found.cursor = "s=2";
+    EXPECT_EQ(cache.lookup(found), false);
+    EXPECT_EQ(found.cursor, QByteArray("s=2"));
+}
+
+TEST(LogCoredumpDetail_loadAll_UT, LogCoredumpDetail_loadAll_UT_001)
+{
+    //命中缓存和已读取过的记录不再读取journal
+    QTemporaryDir dir;
+    LogCoredumpDetailCache cache(dir.path() + "/details.dat");
+    LOG_MSG_COREDUMP cached;
+    cached.coreFile = "missing";
+    cached.stackInfo = "Stack trace of thread 1:";
+    cache.insert("s=1", cached);
+    QList<LOG_MSG_COREDUMP> records;
+    LOG_MSG_COREDUMP record;
+    record.cursor = "s=1";
+    records << record;
+    record.cursor.clear();
+    record.stackInfo = "loaded";
+    records << record;
+    std::atomic_bool canRun(true);
+    LogCoredumpDetail::loadAll(records, cache, canRun);
+    EXPECT_EQ(records.at(0).stackInfo, cached.stackInfo);
+    EXPECT_EQ(records.at(0).cursor.isEmpty(), true);
+    EXPECT_EQ(records.at(1).stackInfo, QString("loaded"));
+}
+
+TEST(LogCoredumpStackWork_buildSource_UT, LogCoredumpStackWork_buildSource_UT_001)
+{
+    std::atomic_bool canRun(true);
+    LogTextSourcePtr source = LogCoredumpStackWork::buildSource("/var/lib/systemd/coredump/core.demo",
+                                                                "Stack trace of thread 1234:\n#0  0x00007f raise (libc.so.6)\n", canRun);
+    ASSERT_TRUE(source);
+    ASSERT_EQ(source->lineCount(), 4);
+    EXPECT_EQ(source->line(0), QString("/var/lib/systemd/coredump/core.demo"));
+    EXPECT_EQ(source->line(1), QString());
+    EXPECT_EQ(source->line(3), QString("#0  0x00007f raise (libc.so.6)"));
+
+    //没有堆栈时只有标题
+    source = LogCoredumpStackWork::buildSource("core.demo", QString(), canRun);
+    ASSERT_TRUE(source);
+    EXPECT_EQ(source->lineCount(), 1);
+
+    canRun = false;
+    EXPECT_FALSE(LogCoredumpStackWork::buildSource("core.demo", "Stack trace of thread 1:", canRun));
+}
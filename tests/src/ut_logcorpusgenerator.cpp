@@ -0,0 +1,66 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "corpus/logcorpusgenerator.h"
+#include "loggzipinflater.h"
+#include "logparsematchers.h"
+
+#include <QFile>
+#include <QTemporaryDir>
+
+#include <gtest/gtest.h>
+
+#include <utmp.h>
+
+TEST(LogCorpusGenerator_generate_UT, LogCorpusGenerator_generate_UT_001)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    LogCorpusOptions options;
+    options.records = 300;
+    options.rotations = 2;
+    LogCorpusGenerator generator(options);
+    const QStringList files = generator.generate(LogCorpusGenerator::App, dir.path());
+    //从新到旧,第二个轮转文件压缩
+    ASSERT_EQ(files.size(), 3);
+    EXPECT_EQ(files.at(0), dir.filePath("deepin-corpus.log"));
+    EXPECT_EQ(files.at(2), dir.filePath("deepin-corpus.log.2.gz"));
+
+    QFile file(files.at(2));
+    ASSERT_TRUE(file.open(QIODevice::ReadOnly));
+    QByteArray data;
+    ASSERT_EQ(LogGzipInflater::inflateDevice(&file, data), true);
+    const QList<QByteArray> lines = data.split('\n');
+    //每个文件100行,最后一个换行后为空
+    ASSERT_EQ(lines.size(), 101);
+    LogLinePrefix prefix;
+    EXPECT_EQ(LogParseMatchers::scanAppLine(QString::fromUtf8(lines.first()), prefix), true);
+}
+
+TEST(LogCorpusGenerator_generate_UT, LogCorpusGenerator_generate_UT_002)
+{
+    //同一个种子生成的内容相同,wtmp按记录大小写入
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    LogCorpusOptions options;
+    options.records = 50;
+    const QString path = LogCorpusGenerator(options).generate(LogCorpusGenerator::Wtmp, dir.path()).value(0);
+    QFile file(path);
+    ASSERT_TRUE(file.open(QIODevice::ReadOnly));
+    const QByteArray first = file.readAll();
+    EXPECT_EQ(first.size(), static_cast<int>(50 * sizeof(struct utmp)));
+    file.close();
+
+    LogCorpusGenerator(options).generate(LogCorpusGenerator::Wtmp, dir.path());
+    ASSERT_TRUE(file.open(QIODevice::ReadOnly));
+    EXPECT_EQ(file.readAll(), first);
+}
+
+TEST(LogCorpusGenerator_parseSize_UT, LogCorpusGenerator_parseSize_UT_001)
+{
+    EXPECT_EQ(LogCorpusGenerator::parseSize("512"), 512);
+    EXPECT_EQ(LogCorpusGenerator::parseSize("1M"), 1024 * 1024);
+    EXPECT_EQ(LogCorpusGenerator::parseSize("10g"), 10LL * 1024 * 1024 * 1024);
+    EXPECT_EQ(LogCorpusGenerator::parseSize("abc"), -1);
+}
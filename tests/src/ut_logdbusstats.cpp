@@ -0,0 +1,94 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logdbusstats.h"
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+
+#include <gtest/gtest.h>
+
+namespace {
+LogDBusMethodSnapshot findMethod(const QString &method)
+{
+    for (const LogDBusMethodSnapshot &item : LogDBusStats::snapshot()) {
+        if (item.method == method)
+            return item;
+    }
+    return LogDBusMethodSnapshot();
+}
+}
+
+TEST(LogDBusHistogram_quantile_UT, LogDBusHistogram_quantile_UT_001)
+{
+    EXPECT_EQ(LogDBusHistogram::bucketOf(0), 0);
+    EXPECT_EQ(LogDBusHistogram::bucketOf(1), 1);
+    EXPECT_EQ(LogDBusHistogram::bucketOf(3), 2);
+    EXPECT_EQ(LogDBusHistogram::bucketOf(4), 3);
+    EXPECT_EQ(LogDBusHistogram::bucketOf(~quint64(0)), LOG_DBUS_HISTOGRAM_BUCKETS - 1);
+
+    LogDBusHistogram histogram;
+    EXPECT_EQ(LogDBusHistogram::quantile(histogram.buckets(), 0.5), quint64(0));
+    for (int i = 0; i < 99; ++i)
+        histogram.add(10);
+    histogram.add(5000);
+    EXPECT_EQ(histogram.sum(), quint64(99 * 10 + 5000));
+    EXPECT_EQ(histogram.max(), quint64(5000));
+    //分位数取桶的上界
+    EXPECT_EQ(LogDBusHistogram::quantile(histogram.buckets(), 0.5), quint64(15));
+    EXPECT_EQ(LogDBusHistogram::quantile(histogram.buckets(), 1.0), quint64(8191));
+}
+
+TEST(LogDBusCallScope_record_UT, LogDBusCallScope_record_UT_001)
+{
+    LogDBusStats::reset();
+    LogDBusStats::setSlowThresholdMs(0);
+    LogDBusMethodStats *method = LogDBusStats::method("ut.readLog");
+    EXPECT_EQ(LogDBusStats::method("ut.readLog"), method);
+    {
+        LogDBusCallScope call(method, "/var/log/ut.log");
+        call.setPayload(1024);
+    }
+    LogDBusStats::setSlowThresholdMs(-1);
+    {
+        LogDBusCallScope call(method);
+    }
+
+    const LogDBusMethodSnapshot item = findMethod("ut.readLog");
+    EXPECT_EQ(item.calls, quint64(2));
+    EXPECT_EQ(item.slowCalls, quint64(1));
+    EXPECT_EQ(item.payloadSum, quint64(1024));
+    EXPECT_EQ(item.payloadMax, quint64(1024));
+    EXPECT_TRUE(LogDBusStats::format(LogDBusStats::snapshot()).contains("dbus method=ut.readLog calls=2 slow=1"));
+
+    //没有调用过的接口不出现在统计中
+    LogDBusStats::method("ut.unused");
+    EXPECT_EQ(findMethod("ut.unused").method, QString());
+}
+
+TEST(LogDBusStats_appendMetricsFile_UT, LogDBusStats_appendMetricsFile_UT_001)
+{
+    LogDBusStats::reset();
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    const QString path = dir.path() + "/metrics.ndjson";
+    EXPECT_FALSE(LogDBusStats::appendMetricsFile(path));
+
+    {
+        LogDBusCallScope call(LogDBusStats::method("ut.getFileInfo"));
+        call.setPayload(10);
+    }
+    ASSERT_TRUE(LogDBusStats::appendMetricsFile(path));
+    QFile file(path);
+    ASSERT_TRUE(file.open(QIODevice::ReadOnly));
+    const QJsonArray methods = QJsonDocument::fromJson(file.readLine()).object().value("dbus").toArray();
+    ASSERT_EQ(methods.size(), 1);
+    const QJsonObject obj = methods.at(0).toObject();
+    EXPECT_EQ(obj.value("method").toString(), QString("ut.getFileInfo"));
+    EXPECT_EQ(obj.value("calls").toInt(), 1);
+    EXPECT_EQ(obj.value("payloadBytes").toObject().value("sum").toInt(), 10);
+}
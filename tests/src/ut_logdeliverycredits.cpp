@@ -0,0 +1,63 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logdeliverycredits.h"
+
+#include <QElapsedTimer>
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+TEST(LogDeliveryCredits_acquire_UT, LogDeliveryCredits_acquire_UT_001)
+{
+    std::atomic_bool canRun(true);
+    LogDeliveryCredits credits(2);
+    EXPECT_TRUE(credits.acquire(canRun));
+    EXPECT_TRUE(credits.acquire(canRun));
+    EXPECT_EQ(credits.available(), 0);
+
+    //界面归还后等待的线程继续
+    std::thread consumer([&credits]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        credits.release();
+    });
+    EXPECT_TRUE(credits.acquire(canRun, 5000));
+    consumer.join();
+    EXPECT_EQ(credits.available(), 0);
+}
+
+TEST(LogDeliveryCredits_acquire_UT, LogDeliveryCredits_acquire_UT_002)
+{
+    //界面不处理时超时后仍然扣除额度,归还后保持平衡
+    std::atomic_bool canRun(true);
+    LogDeliveryCredits credits(1);
+    EXPECT_TRUE(credits.acquire(canRun));
+    QElapsedTimer timer;
+    timer.start();
+    EXPECT_FALSE(credits.acquire(canRun, 30));
+    EXPECT_GE(timer.elapsed(), 30);
+    EXPECT_EQ(credits.available(), -1);
+    credits.release();
+    credits.release();
+    EXPECT_EQ(credits.available(), 1);
+}
+
+TEST(LogDeliveryCredits_abort_UT, LogDeliveryCredits_abort_UT_001)
+{
+    //停止加载时立即唤醒等待的线程,之后不再等待
+    std::atomic_bool canRun(true);
+    LogDeliveryCredits credits(1);
+    EXPECT_TRUE(credits.acquire(canRun));
+    std::thread stopper([&credits]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        credits.abort();
+    });
+    QElapsedTimer timer;
+    timer.start();
+    EXPECT_FALSE(credits.acquire(canRun, 5000));
+    stopper.join();
+    EXPECT_LT(timer.elapsed(), 2000);
+    EXPECT_FALSE(credits.acquire(canRun, 5000));
+}
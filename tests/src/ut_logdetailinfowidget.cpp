@@ -26,6 +26,18 @@ TEST(logDetailInfoWidget_cleanText_UT, logDetailInfoWidget_cleanText_UT)
     EXPECT_NE(p, nullptr);
     p->cleanText();
     EXPECT_EQ(p->m_dateTime->isHidden(), true);
+    //字段控件和分页显示控件在第一次使用前不创建
+    EXPECT_EQ(p->m_userName, nullptr);
+    EXPECT_EQ(p->m_pidLabel, nullptr);
+    EXPECT_EQ(p->m_eventLabel, nullptr);
+    EXPECT_EQ(p->m_oocView, nullptr);
+
+    EXPECT_EQ(p->m_level->isHidden(), true);
+    EXPECT_EQ(p->m_daemonName->isHidden(), true);
+    EXPECT_EQ(p->m_textBrowser->toPlainText().isEmpty(), true);
+
+    p->fillDetailInfo("aa", "aa", "aa", "aa", QModelIndex(), "aa", "aa", "aa", "aa", "aa");
+    p->cleanText();
     EXPECT_EQ(p->m_userName->isHidden(), true);
     EXPECT_EQ(p->m_userLabel->isHidden(), true);
     EXPECT_EQ(p->m_pid->isHidden(), true);
@@ -34,10 +46,6 @@ TEST(logDetailInfoWidget_cleanText_UT, logDetailInfoWidget_cleanText_UT)
     EXPECT_EQ(p->m_actionLabel->isHidden(), true);
     EXPECT_EQ(p->m_status->isHidden(), true);
     EXPECT_EQ(p->m_statusLabel->isHidden(), true);
-
-    EXPECT_EQ(p->m_level->isHidden(), true);
-    EXPECT_EQ(p->m_daemonName->isHidden(), true);
-    EXPECT_EQ(p->m_textBrowser->toPlainText().isEmpty(), true);
     EXPECT_EQ(p->m_name->isHidden(), true);
     EXPECT_EQ(p->m_nameLabel->isHidden(), true);
     EXPECT_EQ(p->m_event->isHidden(), true);
@@ -85,6 +93,14 @@ TEST(logDetailInfoWidget_fillDetailInfo_UT, logDetailInfoWidget_fillDetailInfo_U
     logDetailInfoWidget *p = new logDetailInfoWidget(nullptr);
     EXPECT_NE(p, nullptr);
     p->fillDetailInfo("aa", "aa", "aa", "aa", QModelIndex(), "aa", "aa", "aa", "aa", "aa");
+    ASSERT_NE(p->m_userName, nullptr);
+    EXPECT_EQ(p->m_userName->text(), QString("aa"));
+    //再次显示时复用已创建的控件
+    Dtk::Widget::DLabel *userName = p->m_userName;
+    p->fillDetailInfo("bb", "bb", "", "", QModelIndex(), "bb");
+    EXPECT_EQ(p->m_userName, userName);
+    EXPECT_EQ(p->m_userName->text(), QString("bb"));
+    EXPECT_EQ(p->m_pid->isHidden(), true);
     p->deleteLater();
 }
 
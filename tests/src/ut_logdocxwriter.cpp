@@ -0,0 +1,117 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logdocxwriter.h"
+
+#include "minizip/unzip.h"
+
+#include <QDir>
+#include <QFile>
+
+#include <gtest/gtest.h>
+
+namespace {
+QByteArray readEntry(const QString &fileName, const char *entry)
+{
+    QByteArray data;
+    unzFile file = unzOpen64(fileName.toLocal8Bit().constData());
+    if (!file)
+        return data;
+    if (unzLocateFile(file, entry, 1) == UNZ_OK && unzOpenCurrentFile(file) == UNZ_OK) {
+        char block[4096];
+        int read = 0;
+        while ((read = unzReadCurrentFile(file, block, sizeof(block))) > 0)
+            data.append(block, read);
+        unzCloseCurrentFile(file);
+    }
+    unzClose(file);
+    return data;
+}
+}
+
+TEST(LogDocxWriter_appendEscaped_UT, LogDocxWriter_appendEscaped_UT_001)
+{
+    QByteArray out;
+    LogDocxWriter::appendEscaped(out, QString("a<b>&c 等级\tx") + QChar(0x01) + QChar(0xD800));
+    EXPECT_EQ(out, QString("a&lt;b&gt;&amp;c 等级\tx").toUtf8() + QString(QChar(QChar::ReplacementCharacter)).toUtf8());
+}
+
+TEST(LogDocxWriter_endRow_UT, LogDocxWriter_endRow_UT_001)
+{
+    const QString fileName = QDir::tempPath() + "/ut_logdocxwriter.docx";
+    QFile::remove(fileName);
+    {
+        LogDocxWriter docx(fileName, QString(), QStringList() << "Time" << "Info");
+        ASSERT_EQ(docx.isOpen(), true);
+        docx << "10:00" << "usb <connected>";
+        docx.endRow();
+        //少于列数的行补空单元格
+        docx << "10:01";
+        docx.endRow();
+        EXPECT_EQ(docx.close(), true);
+        EXPECT_EQ(docx.isOpen(), false);
+    }
+    const QByteArray document = readEntry(fileName, "word/document.xml");
+    EXPECT_EQ(document.count("<w:tr>"), 3);
+    EXPECT_EQ(document.count("<w:tc>"), 6);
+    EXPECT_EQ(document.count("<w:b/>"), 2);
+    EXPECT_TRUE(document.contains("usb &lt;connected&gt;"));
+    EXPECT_TRUE(document.endsWith("</w:document>"));
+    EXPECT_FALSE(readEntry(fileName, "[Content_Types].xml").isEmpty());
+    QFile::remove(fileName);
+}
+
+TEST(LogDocxWriter_open_UT, LogDocxWriter_open_UT_001)
+{
+    //模板不存在时不生成文档
+    const QString fileName = QDir::tempPath() + "/ut_logdocxwriter_template.docx";
+    LogDocxWriter docx(fileName, "/nonexistent/4column.dfw", QStringList() << "Time");
+    EXPECT_EQ(docx.isOpen(), false);
+    EXPECT_THROW(docx.endRow(), QString);
+    QFile::remove(fileName);
+}
+
+TEST(LogDocxWriter_writeRows_UT, LogDocxWriter_writeRows_UT_001)
+{
+    const QString cellsName = QDir::tempPath() + "/ut_logdocxwriter_cells.docx";
+    const QString rowsName = QDir::tempPath() + "/ut_logdocxwriter_rows.docx";
+    const QStringList labels = QStringList() << "Time" << "Info";
+    {
+        LogDocxWriter docx(cellsName, QString(), labels);
+        docx << "10:00" << "usb <connected>";
+        docx.endRow();
+        docx << "10:01";
+        docx.endRow();
+        EXPECT_EQ(docx.close(), true);
+    }
+    {
+        //预先生成的行和逐个单元格写入的正文一致
+        LogDocxWriter docx(rowsName, QString(), labels);
+        LogDocxWriter::Rows rows(docx.columnCount());
+        rows << "10:00" << "usb <connected>";
+        rows.endRow();
+        rows << "10:01";
+        rows.endRow();
+        docx.writeRows(rows);
+        EXPECT_EQ(docx.close(), true);
+    }
+    EXPECT_FALSE(readEntry(rowsName, "word/document.xml").isEmpty());
+    EXPECT_EQ(readEntry(rowsName, "word/document.xml"), readEntry(cellsName, "word/document.xml"));
+    QFile::remove(cellsName);
+    QFile::remove(rowsName);
+}
+
+TEST(LogDocxWriter_appendEscaped_UT, LogDocxWriter_appendEscaped_UT_002)
+{
+    //已转义的单元格和逐个单元格转义写入的xml一致
+    LogDocxWriter::Rows cells(2);
+    cells << "a&b" << "c";
+    cells.endRow();
+    QByteArray escaped;
+    LogDocxWriter::appendEscaped(escaped, "a&b");
+    LogDocxWriter::Rows rows(2);
+    rows.appendEscaped(escaped) << "c";
+    rows.endRow();
+    EXPECT_EQ(rows.xml, cells.xml);
+}
@@ -0,0 +1,72 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logdpkgtransactions.h"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+LOG_MSG_DPKG dpkgRecord(qint64 secs, const QString &action, const QString &msg)
+{
+    LOG_MSG_DPKG record;
+    record.timestamp = secs * 1000;
+    record.dateTime = QString::number(secs);
+    record.action = action;
+    record.msg = msg;
+    return record;
+}
+
+} // namespace
+
+TEST(LogDpkgTransactions_update_UT, LogDpkgTransactions_update_UT_001)
+{
+    //从新到旧:第二次apt升级的两次dpkg调用,之后是一小时前的一次安装
+    QList<LOG_MSG_DPKG> newer {
+        dpkgRecord(3702, "status", "installed b:amd64 2.0"),
+        dpkgRecord(3702, "configure", "b:amd64 2.0 <none>"),
+        dpkgRecord(3701, "startup", "packages configure"),
+        dpkgRecord(3700, "upgrade", "b:amd64 1.0 2.0"),
+        dpkgRecord(3700, "upgrade", "a:amd64 1.0 2.0"),
+    };
+    QList<LOG_MSG_DPKG> older {
+        dpkgRecord(3700, "upgrade", "a:amd64 1.0 2.0"),
+        dpkgRecord(3699, "startup", "archives unpack"),
+        dpkgRecord(100, "install", "c:amd64 <none> 1.0"),
+        dpkgRecord(99, "startup", "archives unpack"),
+    };
+    LogRecordStore<LOG_MSG_DPKG> store;
+    store.append(newer);
+    LogRecordView<LOG_MSG_DPKG> view = LogRecordView<LOG_MSG_DPKG>::all(&store);
+
+    LogDpkgTransactions transactions;
+    EXPECT_EQ(transactions.update(view), 0);
+    ASSERT_EQ(transactions.size(), 1);
+
+    //后续批次继续扩展最后一个事务
+    const int begin = store.size();
+    store.append(older);
+    view.appendRange(begin, store.size());
+    EXPECT_EQ(transactions.update(view), 0);
+    ASSERT_EQ(transactions.size(), 2);
+
+    const LogDpkgTransaction &upgrade = transactions.transactions().at(0);
+    EXPECT_EQ(upgrade.first, 0);
+    EXPECT_EQ(upgrade.count, 7);
+    EXPECT_EQ(upgrade.beginTime, 3699000);
+    EXPECT_EQ(upgrade.endTime, 3702000);
+    EXPECT_EQ(upgrade.packageCount, 2);
+    EXPECT_EQ(upgrade.actions.value("upgrade"), 2);
+
+    const LogDpkgTransaction &install = transactions.transactions().at(1);
+    EXPECT_EQ(install.first, 7);
+    EXPECT_EQ(install.count, 2);
+    EXPECT_EQ(install.packages, QStringList() << "c:amd64");
+
+    //没有新行时没有变化的事务
+    EXPECT_EQ(transactions.update(view), 2);
+    transactions.clear();
+    EXPECT_EQ(transactions.size(), 0);
+    EXPECT_EQ(transactions.rows(), 0);
+}
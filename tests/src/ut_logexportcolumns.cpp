@@ -0,0 +1,44 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logexportcolumns.h"
+
+#include <gtest/gtest.h>
+
+TEST(LogExportTraits_columns_UT, LogExportTraits_columns_UT_001)
+{
+    //列数和doc模板、界面表头的列数一致
+    EXPECT_EQ((LogExportTraits<LOG_MSG_JOURNAL, JOURNAL>::columnCount), 6);
+    EXPECT_EQ((LogExportTraits<LOG_MSG_JOURNAL, KERN>::columnCount), 4);
+    EXPECT_EQ(LogExportTraits<LOG_MSG_APPLICATOIN>::columnCount, 4);
+    EXPECT_EQ(LogExportTraits<LOG_MSG_DPKG>::columnCount, 3);
+    EXPECT_EQ(LogExportTraits<LOG_MSG_BOOT>::columnCount, 2);
+    EXPECT_EQ(LogExportTraits<LOG_MSG_XORG>::columnCount, 2);
+    EXPECT_EQ(LogExportTraits<LOG_MSG_NORMAL>::columnCount, 4);
+    EXPECT_EQ(LogExportTraits<LOG_MSG_KWIN>::columnCount, 1);
+    EXPECT_EQ(LogExportTraits<LOG_MSG_DNF>::columnCount, 3);
+    EXPECT_EQ(LogExportTraits<LOG_MSG_DMESG>::columnCount, 3);
+    EXPECT_EQ(LogExportTraits<LOG_MSG_AUDIT>::columnCount, 5);
+}
+
+TEST(LogExportTraits_columns_UT, LogExportTraits_columns_UT_002)
+{
+    //dnf日志各格式都按等级、时间、信息的顺序导出
+    LOG_MSG_DNF record;
+    record.level = INFO;
+    record.dateTime = "2023-01-01 10:00:00";
+    record.msg = "line1\nline2";
+    const auto &columns = LogExportTraits<LOG_MSG_DNF>::columns;
+    EXPECT_EQ(columns[0].kind, ExportDnfLevel);
+    EXPECT_EQ(record.*columns[0].level, record.level);
+    EXPECT_EQ(record.*columns[1].field, record.dateTime);
+    EXPECT_EQ(record.*columns[2].field, record.msg);
+    EXPECT_TRUE(columns[2].flags & ExportPreLine);
+
+    //应用名称列不读记录
+    const auto &appColumns = LogExportTraits<LOG_MSG_APPLICATOIN>::columns;
+    EXPECT_EQ(appColumns[0].kind, ExportLevel);
+    EXPECT_EQ(appColumns[2].kind, ExportAppName);
+    EXPECT_EQ(appColumns[2].field, nullptr);
+}
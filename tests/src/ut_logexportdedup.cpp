@@ -0,0 +1,90 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logexportdedup.h"
+
+#include <QTemporaryDir>
+#include <QFile>
+
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+
+namespace {
+LogFileStat writeFile(const QTemporaryDir &dir, const QString &name, const QByteArray &content)
+{
+    QFile file(dir.filePath(name));
+    file.open(QIODevice::WriteOnly);
+    file.write(content);
+    file.close();
+    return LogFileStat::fromPath(file.fileName());
+}
+
+QStringList hashAll(const QList<LogFileStat> &stats, int *calls)
+{
+    QStringList hashes;
+    for (const LogFileStat &stat : stats) {
+        hashes.append(LogFileStat::contentHash(stat.path));
+        ++*calls;
+    }
+    return hashes;
+}
+}
+
+TEST(LogFileStat_contentHash_UT, LogFileStat_contentHash_UT_001)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    const LogFileStat a = writeFile(dir, "a", "core payload");
+    const LogFileStat b = writeFile(dir, "b", "core payload");
+    const LogFileStat c = writeFile(dir, "c", "core pay1oad");
+    EXPECT_EQ(LogFileStat::contentHash(a.path).size(), 40);
+    EXPECT_EQ(LogFileStat::contentHash(a.path), LogFileStat::contentHash(b.path));
+    EXPECT_NE(LogFileStat::contentHash(a.path), LogFileStat::contentHash(c.path));
+    EXPECT_TRUE(LogFileStat::contentHash(dir.filePath("missing")).isEmpty());
+}
+
+TEST(LogExportDedup_payloads_UT, LogExportDedup_payloads_UT_001)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    QList<LogFileStat> stats;
+    stats << writeFile(dir, "core.a.1", "same crash")
+          << writeFile(dir, "core.b.1", "other size of core")
+          << writeFile(dir, "core.a.2", "same crash")
+          << writeFile(dir, "core.c.1", "diff crash")
+          << LogFileStat::fromPath(dir.filePath("core.gone"));
+    //硬链接到第三个文件,不需要读取
+    ASSERT_EQ(::link(QFile::encodeName(stats.at(2).path).constData(), QFile::encodeName(dir.filePath("core.hard")).constData()), 0);
+    stats << LogFileStat::fromPath(dir.filePath("core.hard"));
+
+    int calls = 0;
+    const QVector<int> payloads = LogExportDedup::payloads(stats, [&calls](const QList<LogFileStat> &candidates) {
+        return hashAll(candidates, &calls);
+    });
+    EXPECT_EQ(payloads, QVector<int>({0, 1, 0, 3, -1, 0}));
+    //大小唯一的文件和硬链接不计算摘要
+    EXPECT_EQ(calls, 3);
+    EXPECT_TRUE(LogExportDedup::hasDuplicates(payloads));
+
+    const QStringList lines = LogExportDedup::manifest(stats, payloads).split('\n', QString::SkipEmptyParts);
+    ASSERT_EQ(lines.size(), 6);
+    EXPECT_EQ(lines.at(3), QString("core.a.2\tcore.a.1"));
+    EXPECT_EQ(lines.at(5), QString("core.hard\tcore.a.1"));
+}
+
+TEST(LogExportDedup_payloads_UT, LogExportDedup_payloads_UT_002)
+{
+    //摘要无法计算时按内容不同导出,和去重之前一致
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    QList<LogFileStat> stats;
+    stats << writeFile(dir, "a", "same") << writeFile(dir, "b", "same");
+    const QVector<int> payloads = LogExportDedup::payloads(stats, [](const QList<LogFileStat> &candidates) {
+        Q_UNUSED(candidates);
+        return QStringList() << QString() << QString("only one");
+    });
+    EXPECT_EQ(payloads, QVector<int>({0, 1}));
+    EXPECT_FALSE(LogExportDedup::hasDuplicates(payloads));
+}
@@ -0,0 +1,71 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logexportipc.h"
+
+#include <gtest/gtest.h>
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QtConcurrent>
+
+namespace {
+LOG_MSG_JOURNAL journalRecord(const QString &msg)
+{
+    LOG_MSG_JOURNAL record;
+    record.dateTime = "2023-01-01 00:00:00";
+    record.hostName = "host";
+    record.daemonName = "daemon";
+    record.msg = msg;
+    record.level = 6;
+    return record;
+}
+
+LogExportServer::Status sendAndWait(const LogExportRequest &request)
+{
+    QFuture<LogExportServer::Status> future = QtConcurrent::run([request]() { return LogExportServer::send(request); });
+    while (!future.isFinished())
+        QCoreApplication::processEvents();
+    return future.result();
+}
+}
+
+TEST(LogExportServer_exportJournal_UT, LogExportServer_exportJournal_UT_001)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    LogExportRequest request;
+    request.fileName = dir.path() + "/system.txt";
+    request.keyword = "absent";
+
+    const QList<LOG_MSG_JOURNAL> records = QList<LOG_MSG_JOURNAL>() << journalRecord("first") << journalRecord("second");
+    //关键字筛选后没有数据时不生成文件
+    EXPECT_EQ(LogExportServer::exportJournal(request, records, QString()), LogExportServer::NoData);
+    EXPECT_FALSE(QFile::exists(request.fileName));
+
+    request.keyword.clear();
+    EXPECT_EQ(LogExportServer::exportJournal(request, records, QString()), LogExportServer::Exported);
+    EXPECT_TRUE(QFile::exists(request.fileName));
+}
+
+TEST(LogExportServer_send_UT, LogExportServer_send_UT_001)
+{
+    LogExportRequest request;
+    request.arg << "all";
+    request.fileName = "/tmp/system.txt";
+
+    LogExportServer server;
+    QStringList received;
+    ASSERT_TRUE(server.listen([&received](const LogExportRequest &request, const LogExportServer::Reply &reply) {
+        received = request.arg;
+        reply(LogExportServer::NoData);
+    }));
+    EXPECT_EQ(sendAndWait(request), LogExportServer::NoData);
+    EXPECT_EQ(received, QStringList() << "all");
+
+    //处理函数不能满足时由命令行自行解析
+    server.listen([](const LogExportRequest &, const LogExportServer::Reply &reply) { reply(LogExportServer::Unanswerable); });
+    EXPECT_EQ(sendAndWait(request), LogExportServer::Unanswerable);
+}
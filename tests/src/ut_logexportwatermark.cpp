@@ -0,0 +1,54 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logexportwatermark.h"
+
+#include <QDateTime>
+#include <QTemporaryDir>
+
+#include <gtest/gtest.h>
+
+namespace {
+LogFileStat makeStat(const QString &path, quint64 inode, qint64 size, qint64 mtime)
+{
+    LogFileStat stat;
+    stat.path = path;
+    stat.exists = true;
+    stat.inode = inode;
+    stat.size = size;
+    stat.mtime = mtime;
+    return stat;
+}
+}
+
+TEST(LogExportWatermark_fileOffset_UT, LogExportWatermark_fileOffset_UT_001)
+{
+    QTemporaryDir dir;
+    const QString path = dir.filePath("export-watermark.conf");
+    const qint64 old = QDateTime::currentMSecsSinceEpoch() - 60 * 1000;
+    {
+        LogExportWatermark watermark(path);
+        EXPECT_EQ(watermark.isEmpty(), true);
+        //没有导出过时从头导出
+        EXPECT_EQ(watermark.fileOffset(makeStat("/var/log/kern.log", 10, 100, old)), 0);
+        watermark.setFileOffset(makeStat("/var/log/kern.log", 10, 100, old), 100);
+        watermark.setJournalCursor("journalctl_system", "s=1;i=2");
+        EXPECT_EQ(watermark.save(), true);
+    }
+
+    LogExportWatermark watermark(path);
+    EXPECT_EQ(watermark.isEmpty(), false);
+    //轮转改名后inode不变,只导出新增部分
+    EXPECT_EQ(watermark.fileOffset(makeStat("/var/log/kern.log.1", 10, 150, old)), 100);
+    //被截断时从头导出
+    EXPECT_EQ(watermark.fileOffset(makeStat("/var/log/kern.log", 10, 50, old)), 0);
+    //上次导出之前压缩的轮转文件已经导出过
+    EXPECT_EQ(watermark.fileOffset(makeStat("/var/log/kern.log.2.gz", 11, 30, old)), 30);
+    //新建的文件从头导出
+    EXPECT_EQ(watermark.fileOffset(makeStat("/var/log/kern.log", 12, 20, QDateTime::currentMSecsSinceEpoch() + 1000)), 0);
+    //上次没有导出过的目录从头导出
+    EXPECT_EQ(watermark.fileOffset(makeStat("/var/log/apt/history.log", 13, 20, old)), 0);
+    EXPECT_EQ(watermark.journalCursor("journalctl_system"), QString("s=1;i=2"));
+    EXPECT_EQ(watermark.journalCursor("journalctl_boot"), QString());
+}
@@ -0,0 +1,91 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logexportwriter.h"
+
+#include <QBuffer>
+
+#include <gtest/gtest.h>
+
+TEST(LogExportWriter_write_UT, LogExportWriter_write_UT_001)
+{
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+    {
+        LogExportWriter out(&buffer, 16);
+        out << QString("等级:") << "info" << " ";
+        //攒满一块后才写入
+        EXPECT_EQ(buffer.data().size(), 0);
+        out << QString("信息:") << "boot" << "\n";
+        EXPECT_GT(buffer.data().size(), 0);
+        EXPECT_EQ(out.written(), buffer.data().size());
+    }
+    //析构时写入剩余内容
+    EXPECT_EQ(QString::fromUtf8(buffer.data()), QString("等级:info 信息:boot\n"));
+}
+
+TEST(LogExportWriter_write_UT, LogExportWriter_write_UT_002)
+{
+    //设备不可写时抛出,由导出函数按失败处理
+    QBuffer buffer;
+    buffer.open(QIODevice::ReadOnly);
+    LogExportWriter out(&buffer, 4);
+    bool thrown = false;
+    try {
+        out << QString("too long");
+    } catch (const QString &) {
+        thrown = true;
+    }
+    EXPECT_EQ(thrown, true);
+    EXPECT_EQ(out.flush(), true);
+}
+
+TEST(LogExportWriter_writeUtf8_UT, LogExportWriter_writeUtf8_UT_001)
+{
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+    {
+        LogExportWriter out(&buffer);
+        //先写出缓冲中已有的文字,保持顺序
+        out << "<tr>";
+        out.writeUtf8(QString("等级").toUtf8());
+        out << "</tr>";
+        EXPECT_EQ(out.written(), buffer.data().size());
+    }
+    EXPECT_EQ(QString::fromUtf8(buffer.data()), QString("<tr>等级</tr>"));
+}
+
+TEST(LogExportWriter_appendHtmlEscaped_UT, LogExportWriter_appendHtmlEscaped_UT_001)
+{
+    QString out("x");
+    LogExportWriter::appendHtmlEscaped(out, QString("<a href=\"b\">&'等级'"));
+    EXPECT_EQ(out, QString("x&lt;a href=&quot;b&quot;&gt;&amp;&#39;等级&#39;"));
+
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+    {
+        LogExportWriter writer(&buffer);
+        writer << "<td>";
+        writer.writeHtmlEscaped("1 < 2");
+        writer << "</td>";
+    }
+    EXPECT_EQ(buffer.data(), QByteArray("<td>1 &lt; 2</td>"));
+}
+
+TEST(LogExportWriter_appendJsonEscaped_UT, LogExportWriter_appendJsonEscaped_UT_001)
+{
+    QString out("x");
+    LogExportWriter::appendJsonEscaped(out, QString("a\"b\\c\n\t") + QChar(0x1) + QString("等级"));
+    EXPECT_EQ(out, QString("xa\\\"b\\\\c\\n\\t\\u0001等级"));
+
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+    {
+        LogExportWriter writer(&buffer);
+        writer << "{\"message\":\"";
+        writer.writeJsonEscaped("line1\r\nline2");
+        writer << "\"}";
+    }
+    EXPECT_EQ(buffer.data(), QByteArray("{\"message\":\"line1\\r\\nline2\"}"));
+}
@@ -0,0 +1,77 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logfilefollower.h"
+
+#include <QFile>
+#include <QTemporaryDir>
+
+#include <gtest/gtest.h>
+
+static void appendText(const QString &path, const QByteArray &text)
+{
+    QFile file(path);
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly | QIODevice::Append));
+    file.write(text);
+}
+
+TEST(LogFileFollower_readLines_UT, LogFileFollower_readLines_UT_001)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    const QString path = dir.filePath("kern.log");
+    appendText(path, "old line\n");
+
+    //从末尾开始,只交出之后追加的完整行
+    LogFileFollower follower(path);
+    ASSERT_EQ(follower.open(LogFileFollower::FromEnd), true);
+    QStringList lines;
+    EXPECT_EQ(follower.readLines(lines), false);
+    EXPECT_EQ(follower.errorString().isEmpty(), true);
+
+    appendText(path, "first\r\nsecond\nthi");
+    EXPECT_EQ(follower.readLines(lines), true);
+    EXPECT_EQ(lines, QStringList() << "first" << "second");
+
+    appendText(path, "rd\n");
+    EXPECT_EQ(follower.readLines(lines), true);
+    EXPECT_EQ(lines, QStringList() << "third");
+    EXPECT_EQ(follower.offset(), QFile(path).size());
+}
+
+TEST(LogFileFollower_readLines_UT, LogFileFollower_readLines_UT_002)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    const QString path = dir.filePath("kern.log");
+    appendText(path, "a\nb\n");
+
+    LogFileFollower follower(path);
+    ASSERT_EQ(follower.open(LogFileFollower::FromStart), true);
+    QStringList lines;
+    EXPECT_EQ(follower.readLines(lines), true);
+    EXPECT_EQ(lines, QStringList() << "a" << "b");
+
+    //被截断后从开头重新读取
+    QFile file(path);
+    ASSERT_TRUE(file.resize(0));
+    appendText(path, "c\n");
+    EXPECT_EQ(follower.readLines(lines), true);
+    EXPECT_EQ(lines, QStringList() << "c");
+
+    //被轮转时先读完旧文件剩余的内容,再从新文件开头读取
+    appendText(path, "d\ne");
+    ASSERT_TRUE(QFile::rename(path, dir.filePath("kern.log.1")));
+    appendText(path, "f\n");
+    EXPECT_EQ(follower.readLines(lines), true);
+    EXPECT_EQ(lines, QStringList() << "d" << "e" << "f");
+
+    //文件被删除后等待重建
+    ASSERT_TRUE(QFile::remove(path));
+    EXPECT_EQ(follower.readLines(lines), false);
+    EXPECT_EQ(follower.errorString().isEmpty(), true);
+    appendText(path, "g\n");
+    EXPECT_EQ(follower.readLines(lines), true);
+    EXPECT_EQ(lines, QStringList() << "g");
+}
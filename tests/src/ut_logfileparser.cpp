@@ -8,6 +8,7 @@
 #include "structdef.h"
 #include "sharedmemorymanager.h"
 #include "wtmpparse.h"
+#include "utils.h"
 
 #include <stub.h>
 
@@ -482,3 +483,17 @@ TEST_F(LogFileParser_UT, UT_parseByOOC_001)
     m_parser->parseByOOC(path);
     EXPECT_EQ(m_parser->m_isOOCLoading,true)<<"check the status after parseByJournal()";
 }
+
+TEST(LogFileParser_kernFromJournal_UT, LogFileParser_kernFromJournal_UT_001)
+{
+    const QString source = Utils::kernLogSource;
+    const QStringList files {"/var/log/kern.log"};
+    Utils::kernLogSource = "auto";
+    EXPECT_EQ(LogFileParser::kernFromJournal(files), false);
+    EXPECT_EQ(LogFileParser::kernFromJournal(QStringList()), true);
+    Utils::kernLogSource = "journal";
+    EXPECT_EQ(LogFileParser::kernFromJournal(files), true);
+    Utils::kernLogSource = "file";
+    EXPECT_EQ(LogFileParser::kernFromJournal(QStringList()), false);
+    Utils::kernLogSource = source;
+}
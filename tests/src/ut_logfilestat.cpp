@@ -0,0 +1,34 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logfilestat.h"
+
+#include <gtest/gtest.h>
+
+#include <QTemporaryFile>
+
+TEST(LogFileStat_fromPath_UT, LogFileStat_fromPath_UT_001)
+{
+    QTemporaryFile file;
+    ASSERT_EQ(file.open(), true);
+    file.write("kern log\n");
+    file.flush();
+
+    LogFileStat stat = LogFileStat::fromPath(file.fileName());
+    EXPECT_EQ(stat.path, file.fileName());
+    EXPECT_EQ(stat.exists, true);
+    EXPECT_EQ(stat.size, 9);
+    EXPECT_EQ(stat.readable, true);
+    EXPECT_NE(stat.inode, 0u);
+    EXPECT_GT(stat.mtime, 0);
+}
+
+TEST(LogFileStat_fromPath_UT, LogFileStat_fromPath_UT_002)
+{
+    LogFileStat stat = LogFileStat::fromPath("/not/exist/kern.log");
+    EXPECT_EQ(stat.path, QString("/not/exist/kern.log"));
+    EXPECT_EQ(stat.exists, false);
+    EXPECT_EQ(stat.size, 0);
+    EXPECT_EQ(stat.readable, false);
+}
@@ -0,0 +1,91 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logglobalsearch.h"
+
+#include <QDateTime>
+#include <QTemporaryFile>
+
+#include <gtest/gtest.h>
+
+namespace {
+LogGlobalSearchSource textSource(const QString &filePath)
+{
+    LogGlobalSearchSource source;
+    source.name = "ut";
+    source.kind = LogGlobalSearchSource::TextFile;
+    source.files << filePath;
+    return source;
+}
+}
+
+TEST(LogGlobalSearchWork_run_UT, LogGlobalSearchWork_run_UT_001)
+{
+    QTemporaryFile file;
+    ASSERT_TRUE(file.open());
+    file.write("2023-05-01 10:00:00 start\n2023-05-01 10:00:01 Disk ERROR one\n2023-05-01 10:00:02 ok\n2023-05-01 10:00:03 error two\n");
+    file.flush();
+
+    std::shared_ptr<std::atomic_bool> canRun = std::make_shared<std::atomic_bool>(true);
+    LogGlobalSearchWork work(3, 1, textSource(file.fileName()), "error", canRun);
+    work.setAutoDelete(false);
+    QList<LogGlobalSearchHit> hits;
+    int finishedTotal = -1;
+    bool finishedTruncated = true;
+    QObject::connect(&work, &LogGlobalSearchWork::hitsReady, [&](int search, int source, QList<LogGlobalSearchHit> batch) {
+        EXPECT_EQ(search, 3);
+        EXPECT_EQ(source, 1);
+        hits << batch;
+    });
+    QObject::connect(&work, &LogGlobalSearchWork::sourceFinished, [&](int, int, int total, bool truncated) {
+        finishedTotal = total;
+        finishedTruncated = truncated;
+    });
+    work.run();
+
+    //从新到旧,不区分大小写
+    ASSERT_EQ(hits.size(), 2);
+    EXPECT_EQ(hits.at(0).message, QString("2023-05-01 10:00:03 error two"));
+    EXPECT_EQ(hits.at(1).message, QString("2023-05-01 10:00:01 Disk ERROR one"));
+    EXPECT_EQ(hits.at(0).time, QDateTime::fromString("2023-05-01 10:00:03", "yyyy-MM-dd hh:mm:ss").toMSecsSinceEpoch());
+    EXPECT_EQ(hits.at(0).dateTime, QString("2023-05-01 10:00:03"));
+    EXPECT_EQ(finishedTotal, 2);
+    EXPECT_FALSE(finishedTruncated);
+}
+
+TEST(LogGlobalSearchWork_run_UT, LogGlobalSearchWork_run_UT_002)
+{
+    QTemporaryFile file;
+    ASSERT_TRUE(file.open());
+    for (int i = 0; i < 10; ++i)
+        file.write(QString("2023-05-01 10:00:0%1 error %1\n").arg(i).toUtf8());
+    file.flush();
+
+    //达到上限后停止并标记截断
+    std::shared_ptr<std::atomic_bool> canRun = std::make_shared<std::atomic_bool>(true);
+    LogGlobalSearchWork work(0, 0, textSource(file.fileName()), "error", canRun);
+    work.setAutoDelete(false);
+    work.setLimit(3);
+    int hitCount = 0;
+    bool finishedTruncated = false;
+    QObject::connect(&work, &LogGlobalSearchWork::hitsReady, [&](int, int, QList<LogGlobalSearchHit> batch) {
+        hitCount += batch.size();
+    });
+    QObject::connect(&work, &LogGlobalSearchWork::sourceFinished, [&](int, int, int, bool truncated) {
+        finishedTruncated = truncated;
+    });
+    work.run();
+    EXPECT_EQ(hitCount, 3);
+    EXPECT_TRUE(finishedTruncated);
+
+    //被取消的搜索不发出任何结果
+    *canRun = false;
+    LogGlobalSearchWork cancelled(1, 0, textSource(file.fileName()), "error", canRun);
+    cancelled.setAutoDelete(false);
+    bool emitted = false;
+    QObject::connect(&cancelled, &LogGlobalSearchWork::hitsReady, [&]() { emitted = true; });
+    QObject::connect(&cancelled, &LogGlobalSearchWork::sourceFinished, [&]() { emitted = true; });
+    cancelled.run();
+    EXPECT_FALSE(emitted);
+}
@@ -0,0 +1,102 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "loggzipinflater.h"
+#include "loglinestream.h"
+
+#include <gtest/gtest.h>
+
+#include <QBuffer>
+#include <QTemporaryFile>
+
+#include <string.h>
+
+static QByteArray gzipData(const QByteArray &data)
+{
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    //15 + 16: 输出gzip格式
+    deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY);
+    QByteArray out(static_cast<int>(deflateBound(&stream, static_cast<uLong>(data.size()))) + 32, '\0');
+    stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data.constData()));
+    stream.avail_in = static_cast<uInt>(data.size());
+    stream.next_out = reinterpret_cast<Bytef *>(out.data());
+    stream.avail_out = static_cast<uInt>(out.size());
+    deflate(&stream, Z_FINISH);
+    out.resize(static_cast<int>(stream.total_out));
+    deflateEnd(&stream);
+    return out;
+}
+
+TEST(LogGzipInflater_readChunk_UT, LogGzipInflater_readChunk_UT_001)
+{
+    //多个gzip成员拼接的文件全部解压
+    QByteArray compressed = gzipData("line1\nline2\n") + gzipData("line3\n");
+    QBuffer buffer(&compressed);
+    buffer.open(QIODevice::ReadOnly);
+    LogGzipInflater inflater(&buffer);
+    QByteArray out;
+    QByteArray chunk;
+    while (inflater.readChunk(chunk))
+        out.append(chunk);
+    EXPECT_EQ(out, QByteArray("line1\nline2\nline3\n"));
+    EXPECT_EQ(inflater.errorString().isEmpty(), true);
+}
+
+TEST(LogGzipInflater_readChunk_UT, LogGzipInflater_readChunk_UT_002)
+{
+    //截断的数据报错,保留已经解压的内容
+    QByteArray compressed = gzipData(QByteArray(100000, 'a'));
+    compressed.chop(compressed.size() / 2);
+    QBuffer buffer(&compressed);
+    buffer.open(QIODevice::ReadOnly);
+    LogGzipInflater inflater(&buffer);
+    QByteArray chunk;
+    while (inflater.readChunk(chunk)) {
+    }
+    EXPECT_EQ(inflater.errorString().isEmpty(), false);
+}
+
+TEST(LogGzipInflater_isGzipFile_UT, LogGzipInflater_isGzipFile_UT_001)
+{
+    EXPECT_EQ(LogGzipInflater::isGzipFile("/var/log/kern.log.2.gz"), true);
+    EXPECT_EQ(LogGzipInflater::isGzipFile("/var/log/kern.log.1"), false);
+}
+
+TEST(LogGzipInflater_inflateFile_UT, LogGzipInflater_inflateFile_UT_001)
+{
+    //可读的压缩日志由LogLineStream在进程内解压并倒序读取
+    QTemporaryFile file("XXXXXX.log.1.gz");
+    ASSERT_EQ(file.open(), true);
+    file.write(gzipData("line1\nline2\nline3\n"));
+    file.flush();
+
+    QByteArray out;
+    EXPECT_EQ(LogGzipInflater::inflateFile(file.fileName(), out), true);
+    EXPECT_EQ(out, QByteArray("line1\nline2\nline3\n"));
+
+    LogLineStream stream(file.fileName());
+    QStringList lines;
+    EXPECT_EQ(stream.readChunk(lines), true);
+    EXPECT_EQ(stream.isLocal(), true);
+    EXPECT_EQ(lines, QStringList() << "line3" << "line2" << "line1");
+    EXPECT_EQ(stream.readChunk(lines), false);
+}
+
+TEST(LogGzipInflater_inflateDevice_UT, LogGzipInflater_inflateDevice_UT_001)
+{
+    //解压后超过上限时停止并报错,不保留已解压的部分
+    QByteArray compressed = gzipData(QByteArray(3 * LOG_GZIP_OUTPUT_CHUNK, 'a'));
+    QBuffer buffer(&compressed);
+    buffer.open(QIODevice::ReadOnly);
+    QByteArray out;
+    QString error;
+    EXPECT_EQ(LogGzipInflater::inflateDevice(&buffer, out, &error, 2 * LOG_GZIP_OUTPUT_CHUNK), false);
+    EXPECT_EQ(error, LogGzipInflater::sizeLimitError());
+    EXPECT_EQ(out.isEmpty(), true);
+
+    buffer.seek(0);
+    EXPECT_EQ(LogGzipInflater::inflateDevice(&buffer, out, &error, 3 * LOG_GZIP_OUTPUT_CHUNK), true);
+    EXPECT_EQ(out.size(), 3 * LOG_GZIP_OUTPUT_CHUNK);
+}
@@ -0,0 +1,54 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "loggzipwriter.h"
+#include "loggzipinflater.h"
+#include "logexportwriter.h"
+
+#include <QBuffer>
+
+#include <gtest/gtest.h>
+
+TEST(LogGzipWriter_finish_UT, LogGzipWriter_finish_UT_001)
+{
+    QByteArray compressed;
+    QBuffer target(&compressed);
+    target.open(QIODevice::WriteOnly);
+    QString expected;
+    {
+        LogGzipWriter gzip(&target);
+        ASSERT_EQ(gzip.open(QIODevice::WriteOnly), true);
+        //小块缓冲使写入分成多个数据块经过队列
+        LogExportWriter out(&gzip, 64);
+        for (int i = 0; i < 5000; ++i) {
+            const QString line = QString("Level:Info Info:usb device %1 connected 等级\n").arg(i);
+            expected += line;
+            out << line;
+        }
+        EXPECT_EQ(out.flush(), true);
+        EXPECT_EQ(gzip.finish(), true);
+        EXPECT_EQ(gzip.isOpen(), false);
+    }
+    EXPECT_LT(compressed.size(), expected.toUtf8().size());
+
+    QBuffer source(&compressed);
+    source.open(QIODevice::ReadOnly);
+    QByteArray inflated;
+    EXPECT_EQ(LogGzipInflater::inflateDevice(&source, inflated), true);
+    EXPECT_EQ(QString::fromUtf8(inflated), expected);
+}
+
+TEST(LogGzipWriter_finish_UT, LogGzipWriter_finish_UT_002)
+{
+    //目标设备不可写时不能打开
+    QByteArray data;
+    QBuffer target(&data);
+    target.open(QIODevice::ReadOnly);
+    LogGzipWriter gzip(&target);
+    EXPECT_EQ(gzip.open(QIODevice::WriteOnly), false);
+    EXPECT_EQ(gzip.finish(), false);
+
+    EXPECT_EQ(LogGzipWriter::isGzipFileName("/tmp/system.txt.gz"), true);
+    EXPECT_EQ(LogGzipWriter::isGzipFileName("/tmp/system.txt"), false);
+}
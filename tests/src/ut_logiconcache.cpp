@@ -0,0 +1,37 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logiconcache.h"
+#include "structdef.h"
+
+#include <gtest/gtest.h>
+
+TEST(LogIconCache_icon_UT, LogIconCache_icon_UT_001)
+{
+    LogIconCache *cache = LogIconCache::instance();
+    cache->clear();
+    //同一图标只构造一次,各处取到的是同一个QIcon
+    const QIcon first = cache->icon(ICONPREFIX, "warning2.svg");
+    const QIcon second = cache->icon(ICONPREFIX, "warning2.svg");
+    EXPECT_EQ(first.cacheKey(), second.cacheKey());
+    EXPECT_EQ(cache->icon(ICONPREFIX, "").isNull(), true);
+    EXPECT_EQ(cache->iconCount(), 1);
+}
+
+TEST(LogIconCache_pixmap_UT, LogIconCache_pixmap_UT_001)
+{
+    LogIconCache *cache = LogIconCache::instance();
+    cache->clear();
+    QPixmap source(8, 8);
+    source.fill(Qt::red);
+    const QIcon icon(source);
+    const QPixmap pixmap = cache->pixmap(icon, QSize(8, 8), 2.0);
+    EXPECT_EQ(pixmap.devicePixelRatio(), 2.0);
+    cache->pixmap(icon, QSize(8, 8), 2.0);
+    EXPECT_EQ(cache->pixmapCount(), 1);
+    cache->pixmap(icon, QSize(8, 8), 1.0);
+    EXPECT_EQ(cache->pixmapCount(), 2);
+    cache->clear();
+    EXPECT_EQ(cache->pixmapCount(), 0);
+}
@@ -0,0 +1,82 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logingestmetrics.h"
+
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+TEST(LogIngestSession_finish_UT, LogIngestSession_finish_UT_001)
+{
+    LogIngestSession session;
+    session.begin("kern");
+    EXPECT_TRUE(session.isActive());
+    LogIngestCountersPtr counters = LogIngestMetrics::current();
+    ASSERT_TRUE(counters != nullptr);
+
+    //解析线程安装构造时取得的计数
+    std::thread worker([counters]() {
+        LogIngestScope scope(counters, true);
+        LogIngestMetrics::addRead(100, 3);
+        LogIngestDBusScope dbus;
+        //嵌套的总线调用只计一次
+        LogIngestDBusScope nested;
+    });
+    worker.join();
+    {
+        LogIngestSession::InsertScope insert(session, 0);
+    }
+    {
+        LogIngestSession::InsertScope insert(session, 2);
+    }
+
+    const LogIngestReport report = session.finish(2);
+    EXPECT_FALSE(session.isActive());
+    EXPECT_TRUE(LogIngestMetrics::current() == nullptr);
+    EXPECT_EQ(report.type, QString("kern"));
+    EXPECT_EQ(report.bytesRead, 100);
+    EXPECT_EQ(report.linesParsed, 3);
+    EXPECT_EQ(report.linesKept, 2);
+    EXPECT_EQ(report.dbusCalls, 1);
+    EXPECT_GE(report.firstRowMs, 0);
+    EXPECT_TRUE(report.toLogLine().contains("type=kern bytes=100 lines=3 kept=2"));
+}
+
+TEST(LogIngestMetrics_addRead_UT, LogIngestMetrics_addRead_UT_001)
+{
+    //没有在加载中时不计数
+    LogIngestMetrics::setCurrent(LogIngestCountersPtr());
+    LogIngestMetrics::addRead(10, 1);
+    LogIngestMetrics::addDBus(10);
+    LogIngestSession session;
+    EXPECT_EQ(session.finish(0).type, QString());
+}
+
+TEST(LogIngestMetrics_appendMetricsFile_UT, LogIngestMetrics_appendMetricsFile_UT_001)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    const QString path = dir.filePath("metrics.ndjson");
+    LogIngestReport report;
+    report.type = "dpkg";
+    report.linesKept = 5;
+    EXPECT_TRUE(LogIngestMetrics::appendMetricsFile(report, path));
+    EXPECT_TRUE(LogIngestMetrics::appendMetricsFile(report, path));
+
+    QFile file(path);
+    ASSERT_TRUE(file.open(QIODevice::ReadOnly));
+    const QList<QByteArray> lines = file.readAll().split('\n');
+    //每次追加一行,最后是换行符
+    ASSERT_EQ(lines.size(), 3);
+    const QJsonObject obj = QJsonDocument::fromJson(lines.at(0)).object();
+    EXPECT_EQ(obj.value("type").toString(), QString("dpkg"));
+    EXPECT_EQ(obj.value("kept").toInt(), 5);
+    EXPECT_TRUE(obj.value("firstRowMs").isNull());
+}
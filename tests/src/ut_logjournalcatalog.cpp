@@ -0,0 +1,34 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logjournalcatalog.h"
+#include "journalreader.h"
+
+#include <gtest/gtest.h>
+
+TEST(LogJournalCatalog_match_UT, LogJournalCatalog_match_UT_001)
+{
+    EXPECT_EQ(LogJournalCatalog::match(LogJournalCatalog::Unit, "sshd.service"), QString("_SYSTEMD_UNIT=sshd.service"));
+    EXPECT_EQ(LogJournalCatalog::match(LogJournalCatalog::Identifier, "kernel"), QString("SYSLOG_IDENTIFIER=kernel"));
+    EXPECT_EQ(LogJournalCatalog::match(LogJournalCatalog::Command, "Xorg"), QString("_COMM=Xorg"));
+    EXPECT_EQ(LogJournalCatalog::match(LogJournalCatalog::Command, QString()), QString());
+}
+
+TEST(LogJournalCatalog_applyMatch_UT, LogJournalCatalog_applyMatch_UT_001)
+{
+    const QString match = "_COMM=sshd";
+    EXPECT_EQ(LogJournalCatalog::applyMatch(QStringList(), QString()), QStringList());
+    EXPECT_EQ(LogJournalCatalog::applyMatch(QStringList(), match), QStringList() << match);
+    //字段匹配加入析取范式的每一项
+    const QStringList args = QStringList() << "_SYSTEMD_UNIT=a.service" << "PRIORITY=3" << "+" << "_SYSTEMD_USER_UNIT=a.service" << "PRIORITY=3";
+    const QStringList applied = LogJournalCatalog::applyMatch(args, match);
+    EXPECT_EQ(applied, QStringList() << "_SYSTEMD_UNIT=a.service" << "PRIORITY=3" << match << "+"
+                                     << "_SYSTEMD_USER_UNIT=a.service" << "PRIORITY=3" << match);
+
+    //和等级筛选一起转换为读取参数后,每一项都带有等级和来源
+    const JournalReadOptions options = JournalReadOptions::fromArgs(QStringList() << "PRIORITY=6" << LogJournalCatalog::applyMatch(QStringList(), match));
+    ASSERT_EQ(options.matches.size(), 1);
+    EXPECT_TRUE(options.matches.at(0).contains("_COMM=sshd"));
+    EXPECT_TRUE(options.matches.at(0).contains("PRIORITY=6"));
+}
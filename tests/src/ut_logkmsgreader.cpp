@@ -0,0 +1,101 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logkmsgreader.h"
+
+#include <QDateTime>
+#include <QVector>
+
+#include <gtest/gtest.h>
+
+#include <errno.h>
+#include <string.h>
+
+TEST(LogKmsgReader_parseRecord_UT, LogKmsgReader_parseRecord_UT_001)
+{
+    const char *data = "30,1234,5678901,-;usb 1-1: new device\n SUBSYSTEM=usb\n DEVICE=c189:1\n";
+    LogKmsgRecord record;
+    EXPECT_EQ(LogKmsgReader::parseRecord(data, static_cast<int>(strlen(data)), record), true);
+    EXPECT_EQ(record.level, 6);
+    EXPECT_EQ(record.facility, 3);
+    EXPECT_EQ(record.sequence, 1234u);
+    EXPECT_EQ(record.timestamp, 5678901u);
+    EXPECT_EQ(record.message, QString("usb 1-1: new device"));
+}
+
+TEST(LogKmsgReader_parseRecord_UT, LogKmsgReader_parseRecord_UT_002)
+{
+    //不可打印字符被转义为\xNN
+    const char *data = "4,1,2,c;tab\\x09end\\x";
+    LogKmsgRecord record;
+    EXPECT_EQ(LogKmsgReader::parseRecord(data, static_cast<int>(strlen(data)), record), true);
+    EXPECT_EQ(record.level, 4);
+    EXPECT_EQ(record.message, QString("tab\tend\\x"));
+
+    const char *invalid = "abc,1,2;msg";
+    EXPECT_EQ(LogKmsgReader::parseRecord(invalid, static_cast<int>(strlen(invalid)), record), false);
+    const char *noHeader = "6,1;msg";
+    EXPECT_EQ(LogKmsgReader::parseRecord(noHeader, static_cast<int>(strlen(noHeader)), record), false);
+    const char *noSeparator = "6,1,2,-";
+    EXPECT_EQ(LogKmsgReader::parseRecord(noSeparator, static_cast<int>(strlen(noSeparator)), record), false);
+}
+
+TEST(LogKmsgReader_open_UT, LogKmsgReader_open_UT_001)
+{
+    LogKmsgReader reader;
+    EXPECT_EQ(reader.open(LogKmsgReader::FromOldest, "/dev/not-exist-kmsg"), false);
+    EXPECT_EQ(reader.isOpen(), false);
+    EXPECT_EQ(reader.errorString().isEmpty(), false);
+    LogKmsgRecord record;
+    EXPECT_EQ(reader.readRecord(record), false);
+    std::atomic_bool canRun(true);
+    EXPECT_EQ(reader.follow(0, canRun, [](const LogKmsgRecord &) {}), -EBADF);
+}
+
+TEST(LogKmsgReader_textTimestamp_UT, LogKmsgReader_textTimestamp_UT_001)
+{
+    EXPECT_EQ(LogKmsgReader::textTimestamp("<6>[    1.500000] usb 1-1: new device"), 1500000);
+    EXPECT_EQ(LogKmsgReader::textTimestamp("<4>[12345.1] short fraction"), Q_INT64_C(12345100000));
+    EXPECT_EQ(LogKmsgReader::textTimestamp("<4>[3.12345678] long fraction"), 3123456);
+    EXPECT_EQ(LogKmsgReader::textTimestamp("<6>[    7] no fraction"), 7000000);
+    EXPECT_EQ(LogKmsgReader::textTimestamp("<6>[   -0.000001] before boot"), 0);
+    //续行和格式不对的行
+    EXPECT_EQ(LogKmsgReader::textTimestamp(" continuation"), -1);
+    EXPECT_EQ(LogKmsgReader::textTimestamp("<6>[ abc] msg"), -1);
+    EXPECT_EQ(LogKmsgReader::textTimestamp("<6>[ 1.5 msg"), -1);
+    EXPECT_EQ(LogKmsgReader::textTimestamp(QByteArray()), -1);
+}
+
+TEST(LogKmsgReader_lowerBound_UT, LogKmsgReader_lowerBound_UT_001)
+{
+    const QVector<qint64> times {10, 20, -1, -1, 30, 40, -1, 50};
+    auto timeOf = [&times](int i) { return times.at(i); };
+    EXPECT_EQ(LogKmsgReader::lowerBound(times.size(), 0, timeOf), 0);
+    EXPECT_EQ(LogKmsgReader::lowerBound(times.size(), 20, timeOf), 1);
+    //起点是有时间的记录,前一条记录的续行不包括在内
+    EXPECT_EQ(LogKmsgReader::lowerBound(times.size(), 25, timeOf), 4);
+    EXPECT_EQ(LogKmsgReader::lowerBound(times.size(), 45, timeOf), 7);
+    EXPECT_EQ(LogKmsgReader::lowerBound(times.size(), 60, timeOf), times.size());
+    EXPECT_EQ(LogKmsgReader::lowerBound(0, 0, timeOf), 0);
+
+    //和逐条判断的结果一致
+    for (qint64 since = 0; since <= 60; ++since) {
+        int expected = times.size();
+        for (int i = 0; i < times.size(); ++i) {
+            if (times.at(i) >= since) {
+                expected = i;
+                break;
+            }
+        }
+        EXPECT_EQ(LogKmsgReader::lowerBound(times.size(), since, timeOf), expected);
+    }
+}
+
+TEST(LogKmsgReader_bootMSecs_UT, LogKmsgReader_bootMSecs_UT_001)
+{
+    //开机时刻在当前时间之前,两次计算基本一致
+    const qint64 boot = LogKmsgReader::bootMSecs();
+    EXPECT_LE(boot, QDateTime::currentMSecsSinceEpoch());
+    EXPECT_LE(qAbs(LogKmsgReader::bootMSecs() - boot), 10);
+}
@@ -0,0 +1,44 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "loglevel.h"
+
+#include <QVector>
+
+#include <gtest/gtest.h>
+
+TEST(LogLevel_fromName_UT, LogLevel_fromName_UT_001)
+{
+    const QString line = "2023-07-03 10:00:00.123 [Warning] msg";
+    EXPECT_EQ(LogLevel::fromName(line.midRef(25, 7)), WARN);
+    EXPECT_EQ(LogLevel::fromName(line.midRef(24, 7)), -1);
+    EXPECT_EQ(LogLevel::fromText("Debug"), DEB);
+    EXPECT_EQ(LogLevel::fromText(LogLevel::text(ERR)), ERR);
+    EXPECT_EQ(LogLevel::fromText("Fatal"), -1);
+
+    const QString dnf = "SUBDEBUG";
+    EXPECT_EQ(LogLevel::fromDnfName(QStringRef(&dnf)), DEBUG);
+    EXPECT_EQ(LogLevel::fromDnfName(dnf.midRef(3)), DNFINVALID);
+}
+
+TEST(LogLevel_fromDnfName_UT, LogLevel_fromDnfName_UT_001)
+{
+    //长度和首字母相同的等级名也要逐字比较
+    const QStringList names {"TRACE", "SUBDEBUG", "DDEBUG", "DEBUG", "INFO", "WARNING", "ERROR", "CRITICAL", "SUPERCRITICAL",
+                             "TRACX", "DEBUX", "ERRORS", "SUBDEBUX", "CRITICAX", "", "info"};
+    const QVector<int> levels {TRACE, DEBUG, DEBUG, DEBUG, INFO, WARNING, ERROR, CRITICAL, SUPERCRITICAL,
+                               DNFINVALID, DNFINVALID, DNFINVALID, DNFINVALID, DNFINVALID, DNFINVALID, DNFINVALID};
+    for (int i = 0; i < names.size(); ++i)
+        EXPECT_EQ(LogLevel::fromDnfName(QStringRef(&names.at(i))), levels.at(i)) << names.at(i).toStdString();
+}
+
+TEST(LogLevel_text_UT, LogLevel_text_UT_001)
+{
+    EXPECT_EQ(LogLevel::text(-1).isEmpty(), true);
+    EXPECT_EQ(LogLevel::text(LogLevel::SyslogCount).isEmpty(), true);
+    EXPECT_EQ(LogLevel::text(INF).isEmpty(), false);
+    EXPECT_EQ(LogLevel::dnfText(DNFINVALID).isEmpty(), true);
+    EXPECT_EQ(LogLevel::dnfText(SUPERCRITICAL), QCoreApplication::translate("Level", "Super critical"));
+    EXPECT_EQ(LogLevel::dnfSyslog[WARNING - TRACE], WARN);
+}
@@ -0,0 +1,71 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "loglinefilter.h"
+
+#include <gtest/gtest.h>
+
+#include <QDateTime>
+
+TEST(LogLineFilter_lineTime_UT, LogLineFilter_lineTime_UT_001)
+{
+    EXPECT_EQ(LogLineFilter::lineTime("type=USER_AUTH msg=audit(1688000000.123:456): pid=1"), 1688000000000LL);
+    EXPECT_EQ(LogLineFilter::lineTime("2023-07-03 10:00:00 status installed bash:amd64"),
+              QDateTime::fromString("2023-07-03 10:00:00", "yyyy-MM-dd hh:mm:ss").toMSecsSinceEpoch());
+
+    const int year = QDate::currentDate().year();
+    EXPECT_EQ(LogLineFilter::lineTime("Sep  9 15:53:34 host kernel: usb 1-1"),
+              QDateTime(QDate(year, 9, 9), QTime(15, 53, 34)).toMSecsSinceEpoch());
+    EXPECT_EQ(LogLineFilter::lineTime("Sep 29 15:53:34 host kernel: usb 1-1"),
+              QDateTime(QDate(year, 9, 29), QTime(15, 53, 34)).toMSecsSinceEpoch());
+
+    //续行等取不到时间的行
+    EXPECT_EQ(LogLineFilter::lineTime("    at main.c:10"), -1);
+    EXPECT_EQ(LogLineFilter::lineTime("Foo 29 15:53:34 host"), -1);
+    EXPECT_EQ(LogLineFilter::lineTime(""), -1);
+}
+
+TEST(LogLineFilter_matches_UT, LogLineFilter_matches_UT_001)
+{
+    LogLineFilter filter = LogLineFilter::timeRange(1688000000000LL, 1688003600000LL);
+    EXPECT_EQ(filter.isEmpty(), false);
+    EXPECT_EQ(filter.matches("type=USER_AUTH msg=audit(1688000100.000:1): ok"), true);
+    EXPECT_EQ(filter.matches("type=USER_AUTH msg=audit(1687000000.000:1): ok"), false);
+    EXPECT_EQ(filter.matches("no time here"), true);
+
+    //没有时间范围时不筛选
+    EXPECT_EQ(LogLineFilter::timeRange(-1, -1).isEmpty(), true);
+
+    LogLineFilter levelFilter;
+    levelFilter.levels << "ERROR";
+    levelFilter.keyword = "disk";
+    EXPECT_EQ(levelFilter.matches("2023-07-03T10:00:00Z error Disk full"), true);
+    EXPECT_EQ(levelFilter.matches("2023-07-03T10:00:00Z errors Disk full"), false);
+    EXPECT_EQ(levelFilter.matches("2023-07-03T10:00:00Z ERROR network down"), false);
+}
+
+TEST(LogLineFilter_toVariantMap_UT, LogLineFilter_toVariantMap_UT_001)
+{
+    LogLineFilter filter = LogLineFilter::timeRange(1, 2);
+    filter.levels << "INFO";
+    filter.keyword = "dnf";
+    LogLineFilter copy = LogLineFilter::fromVariantMap(filter.toVariantMap());
+    EXPECT_EQ(copy.timeBegin, 1);
+    EXPECT_EQ(copy.timeEnd, 2);
+    EXPECT_EQ(copy.levels, QStringList() << "INFO");
+    EXPECT_EQ(copy.keyword, QString("dnf"));
+    EXPECT_EQ(LogLineFilter::fromVariantMap(QVariantMap()).isEmpty(), true);
+}
+
+TEST(LogLineFilter_matchesTime_UT, LogLineFilter_matchesTime_UT_001)
+{
+    const qint64 begin = QDateTime(QDate(2023, 7, 3), QTime(9, 0, 0)).toMSecsSinceEpoch();
+    const qint64 end = QDateTime(QDate(2023, 7, 3), QTime(11, 0, 0)).toMSecsSinceEpoch();
+    LogLineFilter filter = LogLineFilter::timeRange(begin, end);
+    EXPECT_EQ(filter.matchesTime("2023-07-03 10:00:00 uos systemd[1]: started"), true);
+    EXPECT_EQ(filter.matchesTime("2023-07-03 12:00:00 uos systemd[1]: started"), false);
+    //取不到时间的行保留
+    EXPECT_EQ(filter.matchesTime("    continued line"), true);
+    EXPECT_EQ(LogLineFilter().matchesTime("2023-07-03 12:00:00 uos"), true);
+}
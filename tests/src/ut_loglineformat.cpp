@@ -0,0 +1,122 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "loglineformat.h"
+#include "logcustomrecordwork.h"
+#include "logrecordreader.h"
+#include "structdef.h"
+
+#include <QDateTime>
+#include <QTemporaryFile>
+
+#include <gtest/gtest.h>
+
+TEST(LogLineFormat_compile_UT, LogLineFormat_compile_UT_001)
+{
+    QString error;
+    EXPECT_FALSE(LogLineFormat::compile("%{module}%{message}", &error));
+    EXPECT_FALSE(error.isEmpty());
+    EXPECT_FALSE(LogLineFormat::compile("%{message} %{module}", &error));
+    EXPECT_FALSE(LogLineFormat::compile("%{time}", &error));
+    EXPECT_FALSE(LogLineFormat::compile("%{time:yyy-MM-dd}", &error));
+    EXPECT_FALSE(LogLineFormat::compile("%{level", &error));
+    EXPECT_FALSE(LogLineFormat::compile("plain text", &error));
+
+    LogLineFormatPtr format = LogLineFormat::compile("%{time:yyyy-MM-dd hh:mm:ss} [%{level}] %{module}: %{message}", &error);
+    ASSERT_TRUE(format);
+    EXPECT_TRUE(format->hasTime());
+    EXPECT_TRUE(format->hasLevel());
+    EXPECT_EQ(format->fieldNames(), QStringList() << "module");
+    EXPECT_EQ(format->columnCount(), 4);
+    EXPECT_EQ(format->messageColumn(), 3);
+}
+
+TEST(LogLineFormat_parse_UT, LogLineFormat_parse_UT_001)
+{
+    LogLineFormatPtr format = LogLineFormat::compile("%{time:yyyy-MM-dd hh:mm:ss.zzz} [%{level}] %{module}: %{message}");
+    ASSERT_TRUE(format);
+    qint64 time = 0;
+    QStringList columns;
+    ASSERT_TRUE(format->parse("2023-05-01 10:20:30.456  [WARN] net: link down: eth0", time, columns));
+    EXPECT_EQ(time, QDateTime(QDate(2023, 5, 1), QTime(10, 20, 30, 456)).toMSecsSinceEpoch());
+    EXPECT_EQ(columns, QStringList() << "2023-05-01 10:20:30.456" << "WARN" << "net" << "link down: eth0");
+    EXPECT_EQ(format->timeOf("2023-05-01 10:20:30.456 [WARN] net: x"), time);
+
+    //续行不是记录行,columns不变
+    EXPECT_FALSE(format->parse("    at frame 1", time, columns));
+    EXPECT_EQ(columns.value(2), "net");
+    EXPECT_EQ(format->timeOf("    at frame 1"), -1);
+    EXPECT_FALSE(format->parse("2023-13-01 10:20:30.456 [WARN] net: x", time, columns));
+}
+
+TEST(LogLineFormat_parse_UT, LogLineFormat_parse_UT_002)
+{
+    LogLineFormatPtr format = LogLineFormat::compile("%{time:MMM d hh:mm:ss.z} %{host} %{message}");
+    ASSERT_TRUE(format);
+    EXPECT_FALSE(format->hasLevel());
+    qint64 time = 0;
+    QStringList columns;
+    ASSERT_TRUE(format->parse("Mar  7 08:09:10.5 box started", time, columns));
+    const int year = QDate::currentDate().year();
+    EXPECT_EQ(time, QDateTime(QDate(year, 3, 7), QTime(8, 9, 10, 500)).toMSecsSinceEpoch());
+    EXPECT_EQ(columns.value(2), "box");
+    EXPECT_EQ(columns.value(3), "started");
+
+    format = LogLineFormat::compile("%{time:epoch} %{level}|%{message}");
+    ASSERT_TRUE(format);
+    ASSERT_TRUE(format->parse("1682900000.25 3|failed", time, columns));
+    EXPECT_EQ(time, Q_INT64_C(1682900000250));
+    EXPECT_EQ(columns.value(LogLineFormat::LevelColumn), "3");
+    EXPECT_EQ(columns.value(2), "failed");
+
+    //格式说明中的%%为字面的%
+    format = LogLineFormat::compile("%%%{level}%% %{message}");
+    ASSERT_TRUE(format);
+    ASSERT_TRUE(format->parse("%E% disk full", time, columns));
+    EXPECT_EQ(time, -1);
+    EXPECT_EQ(columns.value(LogLineFormat::LevelColumn), "E");
+    EXPECT_EQ(columns.value(2), "disk full");
+}
+
+TEST(LogLineFormat_levelOf_UT, LogLineFormat_levelOf_UT_001)
+{
+    const QString tokens[] = {"ERROR", "warn", "I", "Debug", "trace", "crit", "fatal", "5", "8", "x", ""};
+    const int levels[] = {ERR, WARN, INF, DEB, DEB, CRI, EMER, NOTICE, -1, -1, -1};
+    for (int i = 0; i < 11; ++i)
+        EXPECT_EQ(LogLineFormat::levelOf(QStringRef(&tokens[i])), levels[i]) << tokens[i].toStdString();
+}
+
+TEST(LogCustomRecordWork_matchesLevel_UT, LogCustomRecordWork_matchesLevel_UT_001)
+{
+    EXPECT_TRUE(LogCustomRecordWork::matchesLevel(-1, -1));
+    EXPECT_TRUE(LogCustomRecordWork::matchesLevel(ERR, WARN));
+    EXPECT_FALSE(LogCustomRecordWork::matchesLevel(INF, WARN));
+    EXPECT_FALSE(LogCustomRecordWork::matchesLevel(-1, WARN));
+}
+
+TEST(LogRecordReader_readCustom_UT, LogRecordReader_readCustom_UT_001)
+{
+    QTemporaryFile file;
+    ASSERT_TRUE(file.open());
+    file.write("junk before\n"
+               "2023-05-01 10:00:00 [E] boot failed\n"
+               "  at step 1\n"
+               "  at step 2\n"
+               "2023-05-02 10:00:00 [I] ok\n");
+    file.flush();
+
+    LogLineFormatPtr format = LogLineFormat::compile("%{time:yyyy-MM-dd hh:mm:ss} [%{level}] %{message}");
+    ASSERT_TRUE(format);
+    LogRecordReader reader(file.fileName(), format);
+    std::atomic_bool canRun(true);
+    QList<QStringList> records;
+    EXPECT_TRUE(reader.read(canRun, [&records](qint64, const QStringList &columns) {
+        records << columns;
+        return true;
+    }));
+    ASSERT_EQ(records.size(), 2);
+    //从新到旧,续行并入上一条记录的信息,第一条记录之前的行丢弃
+    EXPECT_EQ(records.at(0).value(2), "ok");
+    EXPECT_EQ(records.at(1).value(2), "boot failed\n  at step 1\n  at step 2");
+}
@@ -0,0 +1,99 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "loglineindexer.h"
+#include "loglinestream.h"
+
+#include <QByteArray>
+#include <QStringList>
+#include <QVector>
+
+#include <gtest/gtest.h>
+
+namespace {
+//逐字节查找的结果,作为对照
+QVector<qint64> newlinesOf(const QByteArray &data, qint64 begin, qint64 end)
+{
+    QVector<qint64> result;
+    for (qint64 i = begin; i < end; ++i) {
+        if (data.at(static_cast<int>(i)) == '\n')
+            result.append(i);
+    }
+    return result;
+}
+}
+
+TEST(LogLineIndexer_forEachNewline_UT, LogLineIndexer_forEachNewline_UT_001)
+{
+    //换行符落在16字节块的首尾和块之间,起止位置不对齐
+    QByteArray data(100, 'x');
+    for (int i : {0, 15, 16, 17, 31, 32, 47, 63, 64, 80, 99})
+        data[i] = '\n';
+    for (qint64 begin : {0, 1, 15, 16, 33}) {
+        for (qint64 end : {begin, begin + 1, qint64(64), qint64(65), qint64(99), qint64(100)}) {
+            if (end < begin)
+                continue;
+            QVector<qint64> found;
+            EXPECT_TRUE(LogLineIndexer::forEachNewline(data.constData(), begin, end, [&found](qint64 at) {
+                found.append(at);
+                return true;
+            }));
+            EXPECT_EQ(found, newlinesOf(data, begin, end)) << begin << " " << end;
+        }
+    }
+
+    //visit返回false时停止
+    int visited = 0;
+    EXPECT_FALSE(LogLineIndexer::forEachNewline(data.constData(), 0, data.size(), [&visited](qint64) {
+        return ++visited < 3;
+    }));
+    EXPECT_EQ(visited, 3);
+}
+
+TEST(LogLineIndexer_index_UT, LogLineIndexer_index_UT_001)
+{
+    const QByteArray data("first\n\nsecond line that is longer than one block\nthird");
+    QVector<LogLineSpan> spans(5, {0, 0});
+    ASSERT_EQ(LogLineIndexer::index(data.constData(), 0, data.size(), spans), 3);
+    EXPECT_EQ(QByteArray(data.constData() + spans.at(0).offset, spans.at(0).length), "first");
+    EXPECT_EQ(QByteArray(data.constData() + spans.at(1).offset, spans.at(1).length), "second line that is longer than one block");
+    EXPECT_EQ(QByteArray(data.constData() + spans.at(2).offset, spans.at(2).length), "third");
+
+    EXPECT_EQ(LogLineIndexer::index(data.constData(), 0, 0, spans), 0);
+    EXPECT_TRUE(spans.isEmpty());
+    EXPECT_EQ(LogLineIndexer::index("\n\n\n", 0, 3, spans), 0);
+}
+
+TEST(LogLineIndexer_count_UT, LogLineIndexer_count_UT_001)
+{
+    QByteArray data;
+    qint64 expected = 0;
+    for (int i = 0; i < 1000; ++i) {
+        data.append(QByteArray(i % 37, 'a'));
+        data.append('\n');
+        ++expected;
+    }
+    data.append("tail");
+    EXPECT_EQ(LogLineIndexer::count(data.constData(), data.size()), expected);
+    EXPECT_EQ(LogLineIndexer::count(data.constData(), 0), 0);
+    EXPECT_EQ(LogLineIndexer::count("\n", 1), 1);
+}
+
+TEST(LogLineIndexer_findNewline_UT, LogLineIndexer_findNewline_UT_001)
+{
+    const char data[] = "ab\ncd\nef";
+    EXPECT_EQ(LogLineIndexer::findNewline(data, data + 8), data + 2);
+    EXPECT_EQ(LogLineIndexer::findLastNewline(data, data + 8), data + 5);
+    EXPECT_EQ(LogLineIndexer::findNewline(data + 6, data + 8), nullptr);
+    EXPECT_EQ(LogLineIndexer::findLastNewline(data, data), nullptr);
+}
+
+TEST(LogLineStream_decodeRange_UT, LogLineStream_decodeRange_UT_001)
+{
+    //从新到旧解码,跳过空行
+    const QByteArray data("one\ntwo\n\nthree\n");
+    QStringList lines;
+    EXPECT_EQ(LogLineStream::decodeRange(data.constData(), 0, data.size(), lines), 3);
+    EXPECT_EQ(lines, QStringList() << "three" << "two" << "one");
+}
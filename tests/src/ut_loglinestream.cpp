@@ -0,0 +1,311 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "loglinestream.h"
+#include "dbusproxy/dldbushandler.h"
+
+#include <stub.h>
+
+#include <gtest/gtest.h>
+
+#include <QTemporaryFile>
+
+static int s_streamReadCount = 0;
+static int s_descriptorHandle = -1;
+static QString s_closedToken;
+
+QDBusUnixFileDescriptor stub_openLogFileFail(const QString &filePath)
+{
+    Q_UNUSED(filePath)
+    return QDBusUnixFileDescriptor();
+}
+
+QDBusUnixFileDescriptor stub_openLogFile(const QString &filePath)
+{
+    Q_UNUSED(filePath)
+    return QDBusUnixFileDescriptor(s_descriptorHandle);
+}
+
+QString stub_openReverseLogStream(const QString &filePath)
+{
+    Q_UNUSED(filePath)
+    return "token";
+}
+
+QString stub_openReverseLogStreamFail(const QString &filePath)
+{
+    Q_UNUSED(filePath)
+    return "";
+}
+
+QString stub_readLogInStream(const QString &token)
+{
+    Q_UNUSED(token)
+    //服务端返回的块已经是从新到旧的顺序
+    return s_streamReadCount++ == 0 ? QString("line3\nline2\n\nline1\n") : QString();
+}
+
+void stub_closeLogStream(const QString &token)
+{
+    s_closedToken = token;
+}
+
+QString stub_lineStreamReadLog(const QString &filePath)
+{
+    Q_UNUSED(filePath)
+    return QString("line1\nline2\x01\nline3\n");
+}
+
+TEST(LogLineStream_readChunk_UT, LogLineStream_readChunk_UT_001)
+{
+    Stub stub;
+    stub.set(ADDR(DLDBusHandler, openLogFile), stub_openLogFileFail);
+    stub.set(ADDR(DLDBusHandler, openReverseLogStream), stub_openReverseLogStream);
+    stub.set(ADDR(DLDBusHandler, readLogInStream), stub_readLogInStream);
+    s_streamReadCount = 0;
+    LogLineStream stream("/var/log/not-exist-kern.log");
+    QStringList lines;
+    EXPECT_EQ(stream.readChunk(lines), true);
+    EXPECT_EQ(stream.isLocal(), false);
+    EXPECT_EQ(lines, QStringList() << "line3" << "line2" << "line1");
+    EXPECT_EQ(stream.readChunk(lines), false);
+    EXPECT_EQ(lines.isEmpty(), true);
+    //读取结束后不再访问服务
+    EXPECT_EQ(stream.readChunk(lines), false);
+    EXPECT_EQ(s_streamReadCount, 2);
+}
+
+TEST(LogLineStream_readChunk_UT, LogLineStream_readChunk_UT_002)
+{
+    //服务不支持倒序通道时整个文件作为一块,并转换成从新到旧的顺序
+    Stub stub;
+    stub.set(ADDR(DLDBusHandler, openLogFile), stub_openLogFileFail);
+    stub.set(ADDR(DLDBusHandler, openReverseLogStream), stub_openReverseLogStreamFail);
+    stub.set(ADDR(DLDBusHandler, readLog), stub_lineStreamReadLog);
+    LogLineStream stream("/var/log/not-exist-kern.log");
+    QStringList lines;
+    EXPECT_EQ(stream.readChunk(lines), true);
+    EXPECT_EQ(lines, QStringList() << "line3" << "line2" << "line1");
+    EXPECT_EQ(stream.readChunk(lines), false);
+}
+
+TEST(LogLineStream_readChunk_UT, LogLineStream_readChunk_UT_003)
+{
+    //可读的文件在进程内映射读取,不访问服务
+    QTemporaryFile file;
+    ASSERT_EQ(file.open(), true);
+    const char data[] = "line1\nline2\x01\n\nli\0ne3";
+    file.write(data, sizeof(data) - 1);
+    file.flush();
+    LogLineStream stream(file.fileName());
+    QStringList lines;
+    EXPECT_EQ(stream.readChunk(lines), true);
+    EXPECT_EQ(stream.isLocal(), true);
+    EXPECT_EQ(lines, QStringList() << "li ne3" << "line2" << "line1");
+    EXPECT_EQ(stream.readChunk(lines), false);
+}
+
+TEST(LogLineStream_readChunk_UT, LogLineStream_readChunk_UT_004)
+{
+    //没有读权限时映射服务传来的描述符,不走流式通道
+    QTemporaryFile file;
+    ASSERT_EQ(file.open(), true);
+    file.write("line1\nline2\n");
+    file.flush();
+    s_descriptorHandle = file.handle();
+    Stub stub;
+    stub.set(ADDR(DLDBusHandler, openLogFile), stub_openLogFile);
+    stub.set(ADDR(DLDBusHandler, openReverseLogStream), stub_openReverseLogStreamFail);
+    LogLineStream stream("/var/log/not-exist-kern.log");
+    QStringList lines;
+    EXPECT_EQ(stream.readChunk(lines), true);
+    EXPECT_EQ(stream.isLocal(), true);
+    EXPECT_EQ(lines, QStringList() << "line2" << "line1");
+    EXPECT_EQ(stream.readChunk(lines), false);
+}
+
+TEST(LogLineStream_readChunk_UT, LogLineStream_readChunk_UT_005)
+{
+    //没有读完就销毁时关闭服务端的通道,读完的通道由服务端自己关闭
+    Stub stub;
+    stub.set(ADDR(DLDBusHandler, openLogFile), stub_openLogFileFail);
+    stub.set(ADDR(DLDBusHandler, openReverseLogStream), stub_openReverseLogStream);
+    stub.set(ADDR(DLDBusHandler, readLogInStream), stub_readLogInStream);
+    stub.set(ADDR(DLDBusHandler, closeLogStream), stub_closeLogStream);
+    s_closedToken.clear();
+    s_streamReadCount = 0;
+    {
+        LogLineStream stream("/var/log/not-exist-kern.log");
+        QStringList lines;
+        EXPECT_EQ(stream.readChunk(lines), true);
+    }
+    EXPECT_EQ(s_closedToken, QString("token"));
+
+    s_closedToken.clear();
+    s_streamReadCount = 0;
+    {
+        LogLineStream stream("/var/log/not-exist-kern.log");
+        QStringList lines;
+        while (stream.readChunk(lines)) {
+        }
+    }
+    EXPECT_EQ(s_closedToken.isEmpty(), true);
+}
+
+TEST(LogLineStream_readChunk_UT, LogLineStream_readChunk_UT_006)
+{
+    //映射的文件按块读取,块边界上的行和超过一块的行都完整读出
+    QTemporaryFile file;
+    ASSERT_EQ(file.open(), true);
+    const QByteArray longLine(LOG_LINE_STREAM_CHUNK + 10, 'a');
+    QByteArray data;
+    for (int i = 0; data.size() < LOG_LINE_STREAM_CHUNK; ++i)
+        data += "line" + QByteArray::number(i) + "\n";
+    data += longLine + "\nlast";
+    file.write(data);
+    file.flush();
+    LogLineStream stream(file.fileName());
+    QStringList all;
+    QStringList lines;
+    while (stream.readChunk(lines))
+        all += lines;
+    ASSERT_EQ(all.size(), data.count('\n') + 1);
+    EXPECT_EQ(all.at(0), QString("last"));
+    EXPECT_EQ(all.at(1), QString(longLine));
+    EXPECT_EQ(all.last(), QString("line0"));
+}
+
+TEST(LogLineStream_readChunk_UT, LogLineStream_readChunk_UT_007)
+{
+    //映射后文件被截断时停止读取,不访问映射越界的部分
+    QTemporaryFile file;
+    ASSERT_EQ(file.open(), true);
+    file.write("line1\nline2\n");
+    file.flush();
+    LogLineStream stream(file.fileName());
+    ASSERT_EQ(stream.openDirect(), true);
+    ASSERT_EQ(file.resize(0), true);
+    QStringList lines;
+    EXPECT_EQ(stream.readChunk(lines), false);
+    EXPECT_EQ(lines.isEmpty(), true);
+}
+
+TEST(LogLineStream_seekTimeRange_UT, LogLineStream_seekTimeRange_UT_001)
+{
+    //每行开头是序号作为时间,按时间顺序写入,总长度远大于停止查找的范围
+    QTemporaryFile file;
+    ASSERT_TRUE(file.open());
+    const int count = 20000;
+    for (int i = 0; i < count; ++i)
+        file.write(QString("%1 message padding padding\n").arg(i, 6, 10, QChar('0')).toUtf8());
+    file.flush();
+
+    const LogLineStream::LineTimeFunc lineTime = [](const QString &line) {
+        bool ok = false;
+        const qint64 time = line.leftRef(6).toLongLong(&ok);
+        return ok ? time : qint64(-1);
+    };
+    LogLineStream stream(file.fileName());
+    ASSERT_EQ(stream.openDirect(), true);
+    EXPECT_EQ(stream.seekTimeRange(10000, 10010, lineTime), true);
+
+    QStringList lines;
+    QStringList all;
+    while (stream.readChunk(lines))
+        all.append(lines);
+    //只读取了时间段附近的部分,且时间段内的行都在其中
+    EXPECT_LT(all.size(), count / 3);
+    for (int i = 10000; i <= 10010; ++i)
+        EXPECT_EQ(all.contains(QString("%1 message padding padding").arg(i, 6, 10, QChar('0'))), true);
+}
+
+TEST(LogLineStream_seekTimeRange_UT, LogLineStream_seekTimeRange_UT_002)
+{
+    //时间不是顺序的文件不做定位
+    QTemporaryFile file;
+    ASSERT_TRUE(file.open());
+    const int count = 20000;
+    for (int i = count; i > 0; --i)
+        file.write(QString("%1 message padding padding\n").arg(i, 6, 10, QChar('0')).toUtf8());
+    file.flush();
+
+    LogLineStream stream(file.fileName());
+    ASSERT_EQ(stream.openDirect(), true);
+    EXPECT_EQ(stream.seekTimeRange(100, 200, [](const QString &line) { return line.leftRef(6).toLongLong(); }), false);
+}
+
+TEST(LogLineStream_splitRange_UT, LogLineStream_splitRange_UT_001)
+{
+    //切分点都在行首,各块解码后拼接和整体解码一致
+    QByteArray data;
+    for (int i = 0; i < 1000; ++i)
+        data.append(QString("line %1\n").arg(i).toUtf8());
+    const QVector<qint64> bounds = LogLineStream::splitRange(data.constData(), 0, data.size(), 512);
+    ASSERT_GT(bounds.size(), 2);
+    EXPECT_EQ(bounds.first(), data.size());
+    EXPECT_EQ(bounds.last(), 0);
+    QStringList all;
+    QStringList lines;
+    for (int i = 0; i + 1 < bounds.size(); ++i) {
+        EXPECT_GT(bounds.at(i), bounds.at(i + 1));
+        EXPECT_TRUE(bounds.at(i + 1) == 0 || data.at(static_cast<int>(bounds.at(i + 1)) - 1) == '\n');
+        LogLineStream::decodeRange(data.constData(), bounds.at(i + 1), bounds.at(i), lines);
+        all.append(lines);
+    }
+    ASSERT_EQ(all.size(), 1000);
+    EXPECT_EQ(all.first(), QString("line 999"));
+    EXPECT_EQ(all.last(), QString("line 0"));
+}
+
+TEST(LogLineStream_splitRange_UT, LogLineStream_splitRange_UT_002)
+{
+    //同一分组的相邻行留在同一块
+    QByteArray data;
+    for (int i = 0; i < 200; ++i) {
+        for (int j = 0; j < 3; ++j)
+            data.append(QString("group=%1 record %2\n").arg(i).arg(j).toUtf8());
+    }
+    auto key = [](const char *line, int length) {
+        const QByteArray text(line, length);
+        return text.left(text.indexOf(' '));
+    };
+    const QVector<qint64> bounds = LogLineStream::splitRange(data.constData(), 0, data.size(), 700, key);
+    ASSERT_GT(bounds.size(), 2);
+    for (int i = 1; i + 1 < bounds.size(); ++i) {
+        const int cut = static_cast<int>(bounds.at(i));
+        EXPECT_TRUE(data.mid(cut, data.indexOf('\n', cut) - cut).endsWith("record 0"));
+    }
+}
+
+TEST(LogLineStream_splitRange_UT, LogLineStream_splitRange_UT_003)
+{
+    //映射的文件在切分点附近用pread读取,切分结果和在整个内容上切分一致
+    QTemporaryFile file;
+    ASSERT_EQ(file.open(), true);
+    QByteArray data;
+    for (int i = 0; data.size() < 4 * LOG_LINE_SPLIT_WINDOW; ++i) {
+        for (int j = 0; j < 3; ++j)
+            data.append(QString("group=%1 record %2\n").arg(i).arg(j).toUtf8());
+    }
+    //超过一个窗口的长行
+    data.append(QByteArray(2 * LOG_LINE_SPLIT_WINDOW, 'a') + "\n");
+    file.write(data);
+    file.flush();
+    auto key = [](const char *line, int length) {
+        const QByteArray text(line, length);
+        return text.left(text.indexOf(' '));
+    };
+
+    LogLineStream stream(file.fileName());
+    ASSERT_EQ(stream.openDirect(), true);
+    const qint64 chunkBytes = LOG_LINE_SPLIT_WINDOW / 2 + 7;
+    const QVector<qint64> bounds = stream.splitRange(chunkBytes, key);
+    ASSERT_GT(bounds.size(), 2);
+    EXPECT_EQ(bounds, LogLineStream::splitRange(data.constData(), 0, data.size(), chunkBytes, key));
+
+    QByteArray chunk;
+    ASSERT_EQ(stream.readRange(bounds.at(1), bounds.at(0), chunk), true);
+    EXPECT_EQ(chunk, data.mid(static_cast<int>(bounds.at(1))));
+    EXPECT_EQ(stream.readRange(0, data.size() + 1, chunk), false);
+}
@@ -0,0 +1,42 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "loglocaltime.h"
+
+#include <QDateTime>
+
+#include <gtest/gtest.h>
+
+TEST(LogLocalTime_format_UT, LogLocalTime_format_UT_001)
+{
+    //跨越几年每隔约7小时取一个时间,和QDateTime的结果一致,包括夏令时切换前后
+    const qint64 begin = QDateTime(QDate(2021, 1, 1), QTime(0, 0)).toMSecsSinceEpoch();
+    for (qint64 msecs = begin; msecs < begin + 3 * 366 * 86400000LL; msecs += 25200123LL) {
+        const QDateTime dt = QDateTime::fromMSecsSinceEpoch(msecs);
+        EXPECT_EQ(LogLocalTime::format(msecs), dt.toString("yyyy-MM-dd hh:mm:ss"));
+        EXPECT_EQ(LogLocalTime::format(msecs, true), dt.toString("yyyy-MM-dd hh:mm:ss.zzz"));
+        EXPECT_EQ(LogLocalTime::dateOf(msecs), dt.date());
+    }
+    EXPECT_EQ(LogLocalTime::formatSecs(0), QDateTime::fromSecsSinceEpoch(0).toString("yyyy-MM-dd hh:mm:ss"));
+}
+
+TEST(LogLocalTime_toMSecs_UT, LogLocalTime_toMSecs_UT_001)
+{
+    for (QDate date(2021, 1, 1); date < QDate(2024, 1, 1); date = date.addDays(1)) {
+        const QTime time(date.day() % 24, date.month() * 4, 30, 250);
+        EXPECT_EQ(LogLocalTime::toMSecs(date, time.hour(), time.minute(), time.second(), time.msec()),
+                  QDateTime(date, time).toMSecsSinceEpoch());
+    }
+}
+
+TEST(LogLocalTime_parse_UT, LogLocalTime_parse_UT_001)
+{
+    const qint64 expected = QDateTime(QDate(2023, 5, 1), QTime(10, 20, 30, 456)).toMSecsSinceEpoch();
+    EXPECT_EQ(LogLocalTime::parse("2023-05-01 10:20:30.456"), expected);
+    EXPECT_EQ(LogLocalTime::parse("2023-05-01 10:20:30 trailing"), expected - 456);
+    EXPECT_EQ(LogLocalTime::parse("2023-02-29 10:20:30"), -1);
+    EXPECT_EQ(LogLocalTime::parse("2023-05-01 24:20:30"), -1);
+    EXPECT_EQ(LogLocalTime::parse("2023-05-01T10:20:30"), -1);
+    EXPECT_EQ(LogLocalTime::parse("May  1 10:20:30"), -1);
+}
@@ -0,0 +1,72 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "loglongmessage.h"
+#include "loglinestream.h"
+
+#include <gtest/gtest.h>
+
+#include <QTemporaryFile>
+
+TEST(LogLongMessage_shorten_UT, LogLongMessage_shorten_UT_001)
+{
+    LOG_MSG_APPLICATOIN record;
+    record.msg = "short";
+    EXPECT_EQ(LogLongMessage::shorten(record, LOG_MESSAGE_REF()), false);
+    EXPECT_EQ(record.msg, QString("short"));
+
+    //没有引用时完整信息保存在detailInfo中
+    const QString full(LOG_LONG_MESSAGE_PREFIX + 10, 'a');
+    record.msg = full;
+    EXPECT_EQ(LogLongMessage::shorten(record, LOG_MESSAGE_REF()), true);
+    EXPECT_EQ(record.msg.size(), LOG_LONG_MESSAGE_PREFIX);
+    EXPECT_EQ(record.detailInfo, full);
+    EXPECT_EQ(LogLongMessage().fullText(record), full);
+
+    LOG_MESSAGE_REF ref;
+    ref.cursor = "s=1";
+    LOG_MSG_APPLICATOIN refRecord;
+    refRecord.msg = full;
+    EXPECT_EQ(LogLongMessage::shorten(refRecord, ref), true);
+    EXPECT_EQ(refRecord.detailInfo.isEmpty(), true);
+    EXPECT_EQ(refRecord.fullRef.cursor, QByteArray("s=1"));
+}
+
+TEST(LogLongMessage_fullText_UT, LogLongMessage_fullText_UT_001)
+{
+    const QString full = "[main] " + QString(LOG_LONG_MESSAGE_PREFIX + 10, 'b');
+    QTemporaryFile file;
+    ASSERT_EQ(file.open(), true);
+    file.write("2023-01-01 10:00:00.000 [Info] " + full.toUtf8() + "\nnext line\n");
+    file.flush();
+
+    //按读取时记下的行位置重新读取完整内容
+    LogLineStream stream(file.fileName());
+    stream.setRecordSpans(true);
+    QStringList lines;
+    ASSERT_EQ(stream.readChunk(lines), true);
+    ASSERT_EQ(stream.lineSpans().size(), lines.size());
+    ASSERT_EQ(lines.size(), 2);
+    const int skip = lines.at(1).indexOf('[', 1);
+    LOG_MSG_APPLICATOIN record;
+    record.msg = lines.at(1).mid(skip);
+    LOG_MESSAGE_REF ref;
+    ref.path = file.fileName();
+    ref.offset = stream.lineSpans().at(1).offset;
+    ref.length = stream.lineSpans().at(1).length;
+    ref.skip = skip;
+    ASSERT_EQ(LogLongMessage::shorten(record, ref), true);
+    LogLongMessage message;
+    EXPECT_EQ(message.fullText(record), full);
+
+    message.resolve(record);
+    EXPECT_EQ(record.msg, full);
+    EXPECT_EQ(record.fullRef.isNull(), true);
+
+    //位置上的内容和前缀不一致时只返回前缀
+    LOG_MSG_APPLICATOIN changed;
+    changed.msg = "other";
+    changed.fullRef = ref;
+    EXPECT_EQ(message.fullText(changed), QString("other"));
+}
@@ -0,0 +1,50 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logmatchnavigator.h"
+
+#include <gtest/gtest.h>
+
+TEST(LogMatchNavigator_next_UT, LogMatchNavigator_next_UT_001)
+{
+    LogMatchNavigator navigator;
+    EXPECT_EQ(navigator.next(-1), -1);
+    EXPECT_EQ(navigator.previous(-1), -1);
+
+    navigator.add({3, 10});
+    navigator.add({25, 40});
+    ASSERT_EQ(navigator.size(), 4);
+    EXPECT_EQ(navigator.next(-1), 3);
+    EXPECT_EQ(navigator.next(3), 10);
+    EXPECT_EQ(navigator.next(11), 25);
+    //到末尾后回到第一个
+    EXPECT_EQ(navigator.next(40), 3);
+    EXPECT_EQ(navigator.next(40, false), -1);
+
+    EXPECT_EQ(navigator.previous(-1), 40);
+    EXPECT_EQ(navigator.previous(25), 10);
+    EXPECT_EQ(navigator.previous(26), 25);
+    EXPECT_EQ(navigator.previous(3), 40);
+    EXPECT_EQ(navigator.previous(3, false), -1);
+
+    EXPECT_EQ(navigator.countBefore(3), 0);
+    EXPECT_EQ(navigator.countBefore(25), 2);
+    EXPECT_EQ(navigator.countBefore(100), 4);
+}
+
+TEST(LogMatchNavigator_add_UT, LogMatchNavigator_add_UT_001)
+{
+    LogMatchNavigator navigator;
+    navigator.add({5, 20, 30});
+    //和已有的行交叉时合并去重
+    navigator.add({1, 20, 25});
+    EXPECT_EQ(navigator.rows(), QVector<int>({1, 5, 20, 25, 30}));
+    navigator.add(QVector<int>());
+    EXPECT_EQ(navigator.size(), 5);
+
+    navigator.clear();
+    EXPECT_TRUE(navigator.isEmpty());
+    navigator.add({8, 2});
+    EXPECT_EQ(navigator.rows(), QVector<int>({2, 8}));
+}
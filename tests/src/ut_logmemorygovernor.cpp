@@ -0,0 +1,57 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logmemorygovernor.h"
+
+#include <gtest/gtest.h>
+
+TEST(LogMemoryGovernor_parse_UT, LogMemoryGovernor_parse_UT_001)
+{
+    double some = -1;
+    double full = -1;
+    const QByteArray pressure = "some avg10=12.50 avg60=3.00 avg300=1.00 total=123456\n"
+                                "full avg10=0.75 avg60=0.10 avg300=0.00 total=2345\n";
+    EXPECT_EQ(LogMemoryGovernor::parsePressure(pressure, &some, &full), true);
+    EXPECT_DOUBLE_EQ(some, 12.5);
+    EXPECT_DOUBLE_EQ(full, 0.75);
+    EXPECT_EQ(LogMemoryGovernor::parsePressure("", &some, &full), false);
+
+    const QByteArray meminfo = "MemTotal:        4028416 kB\nMemFree:          123456 kB\nMemAvailable:     402841 kB\n";
+    EXPECT_EQ(LogMemoryGovernor::parseMemInfo(meminfo, "MemTotal"), 4028416LL * 1024);
+    EXPECT_EQ(LogMemoryGovernor::parseMemInfo(meminfo, "MemAvailable"), 402841LL * 1024);
+    EXPECT_EQ(LogMemoryGovernor::parseMemInfo(meminfo, "SwapTotal"), -1);
+
+    //只认cgroup v2的统一层级
+    EXPECT_EQ(LogMemoryGovernor::cgroupPath("0::/user.slice/user-1000.slice/session-2.scope\n"),
+              QString("/sys/fs/cgroup/user.slice/user-1000.slice/session-2.scope"));
+    EXPECT_EQ(LogMemoryGovernor::cgroupPath("4:memory:/user.slice\n"), QString());
+}
+
+TEST(LogMemoryGovernor_classify_UT, LogMemoryGovernor_classify_UT_001)
+{
+    const qint64 mb = 1024 * 1024;
+    LogMemoryGovernor::Sample sample;
+    //读取失败的项不参与
+    EXPECT_EQ(LogMemoryGovernor::classify(sample), LogMemoryGovernor::Normal);
+
+    sample.limit = 1000 * mb;
+    sample.used = 500 * mb;
+    sample.rss = 100 * mb;
+    sample.someAvg10 = 1;
+    sample.fullAvg10 = 0;
+    EXPECT_EQ(LogMemoryGovernor::classify(sample), LogMemoryGovernor::Normal);
+
+    sample.used = 850 * mb;
+    EXPECT_EQ(LogMemoryGovernor::classify(sample), LogMemoryGovernor::Pressure);
+    sample.someAvg10 = 30;
+    EXPECT_EQ(LogMemoryGovernor::classify(sample), LogMemoryGovernor::Severe);
+    //本进程占用过多时即使整体还有余量也截断加载
+    sample.used = 700 * mb;
+    sample.someAvg10 = 0;
+    sample.rss = 650 * mb;
+    EXPECT_EQ(LogMemoryGovernor::classify(sample), LogMemoryGovernor::Critical);
+    sample.rss = 100 * mb;
+    sample.fullAvg10 = 20;
+    EXPECT_EQ(LogMemoryGovernor::classify(sample), LogMemoryGovernor::Critical);
+}
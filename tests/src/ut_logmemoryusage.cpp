@@ -0,0 +1,71 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logmemoryusage.h"
+#include "logtablemodel.h"
+
+#include <gtest/gtest.h>
+
+TEST(LogMemoryAccounting_measure_UT, LogMemoryAccounting_measure_UT_001)
+{
+    QList<LOG_MSG_DPKG> list;
+    const QString action = "install";
+    for (int i = 0; i < 10; ++i) {
+        LOG_MSG_DPKG record;
+        record.dateTime = QString("2023-01-01 00:00:%1").arg(i, 2, 10, QChar('0'));
+        //所有记录共享同一个字符串,只算一次
+        record.action = action;
+        record.msg = QString("message %1").arg(i);
+        list.append(record);
+    }
+    LogRecordStore<LOG_MSG_DPKG> store(list);
+    const LogMemoryUsage usage = LogMemoryAccounting::measure("dpkg", store);
+    EXPECT_EQ(usage.records, 10);
+    EXPECT_EQ(usage.batches, 1);
+    EXPECT_FALSE(usage.sampled);
+    ASSERT_EQ(usage.columnNames.size(), 3);
+    EXPECT_EQ(usage.columnNames.at(1), QString("action"));
+    QSet<const void *> seen;
+    EXPECT_EQ(usage.columnBytes.at(1), LogMemoryAccounting::textBytes(action, seen));
+    EXPECT_GT(usage.columnBytes.at(2), usage.columnBytes.at(1) * 9);
+    EXPECT_GT(usage.recordBytes, 10 * static_cast<qint64>(sizeof(LOG_MSG_DPKG)));
+    EXPECT_EQ(usage.total(), usage.recordBytes + usage.columnTotal());
+}
+
+TEST(LogMemoryAccounting_addView_UT, LogMemoryAccounting_addView_UT_001)
+{
+    QList<LOG_MSG_KWIN> list;
+    for (int i = 0; i < 4; ++i) {
+        LOG_MSG_KWIN record;
+        record.msg = QString::number(i);
+        list.append(record);
+    }
+    LogRecordStore<LOG_MSG_KWIN> store(list);
+    const LogRecordView<LOG_MSG_KWIN> view = LogRecordView<LOG_MSG_KWIN>(&store).withRows(QVector<quint32>() << 1 << 3);
+    LogTableModel model;
+    model.setColumns<LOG_MSG_KWIN>("kwin", QVector<LogTableModel::Column<LOG_MSG_KWIN>>());
+    model.appendRecords(view);
+
+    QSet<const void *> seen;
+    LogMemoryUsage usage = LogMemoryAccounting::measure("kwin", store);
+    LogMemoryAccounting::addView(usage, view, seen);
+    EXPECT_GT(usage.viewBytes, 0);
+    //model和视图共享下标数组,不再重复计算
+    QSet<const void *> fresh;
+    EXPECT_LT(model.memoryBytes(seen), model.memoryBytes(fresh));
+}
+
+TEST(LogMemoryAccounting_format_UT, LogMemoryAccounting_format_UT_001)
+{
+    LogMemoryUsage small;
+    small.category = "kwin";
+    small.recordBytes = 10;
+    LogMemoryUsage large;
+    large.category = "journal";
+    large.recordBytes = 100;
+    const QString text = LogMemoryAccounting::format(QList<LogMemoryUsage>() << small << large);
+    //占用大的排在前面
+    EXPECT_LT(text.indexOf("journal"), text.indexOf("kwin"));
+    EXPECT_TRUE(text.contains("total: 110 bytes"));
+}
@@ -0,0 +1,61 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logminimap.h"
+
+#include <QDateTime>
+
+#include <gtest/gtest.h>
+
+TEST(LogMinimap_appendTimes_UT, LogMinimap_appendTimes_UT_001)
+{
+    LogMinimap minimap;
+    QVector<qint64> times;
+    for (int i = 0; i < LOG_MINIMAP_BUCKETS * 3; ++i)
+        times.append(i * 1000);
+    minimap.appendTimes(times);
+    EXPECT_EQ(minimap.rowCount(), LOG_MINIMAP_BUCKETS * 3);
+    //超过桶数时每桶的行数加倍
+    EXPECT_EQ(minimap.rowsPerBucket(), 2);
+    ASSERT_LE(minimap.buckets().size(), LOG_MINIMAP_BUCKETS);
+    EXPECT_EQ(minimap.buckets().first().rows, 2);
+    EXPECT_EQ(minimap.buckets().first().minTime, 0);
+    EXPECT_EQ(minimap.buckets().first().maxTime, 1000);
+
+    minimap.clear();
+    EXPECT_EQ(minimap.rowCount(), 0);
+    EXPECT_EQ(minimap.rowsPerBucket(), 1);
+}
+
+TEST(LogMinimap_density_UT, LogMinimap_density_UT_001)
+{
+    LogMinimap minimap;
+    QVector<qint64> times;
+    //前一半每秒一条,后一半每毫秒一条
+    for (int i = 0; i < 100; ++i)
+        times.append(i * 1000);
+    for (int i = 0; i < 100; ++i)
+        times.append(100000 + i);
+    minimap.appendTimes(times);
+    const QVector<float> density = minimap.density(2);
+    ASSERT_EQ(density.size(), 2);
+    EXPECT_FLOAT_EQ(density.at(1), 1.0f);
+    EXPECT_LT(density.at(0), density.at(1));
+
+    minimap.addHits({5, 150, 199, 500});
+    EXPECT_EQ(minimap.hits(2), QVector<int>({1, 2}));
+    minimap.clearHits();
+    EXPECT_EQ(minimap.hits(2), QVector<int>({0, 0}));
+}
+
+TEST(LogMinimap_keyTime_UT, LogMinimap_keyTime_UT_001)
+{
+    const qint64 expected = QDateTime::fromString("2023-05-01 12:30:45", "yyyy-MM-dd hh:mm:ss").toUTC().toMSecsSinceEpoch();
+    const qint64 local = QDateTime::fromString("2023-05-01 12:30:45", "yyyy-MM-dd hh:mm:ss").offsetFromUtc() * 1000LL;
+    EXPECT_EQ(LogMinimap::keyTime(20230501123045LL), expected + local);
+    EXPECT_EQ(LogMinimap::keyTime(20230501123045123LL), expected + local + 123);
+    //位数不够时原样返回
+    EXPECT_EQ(LogMinimap::keyTime(123456), 123456);
+    EXPECT_EQ(LogMinimap::keyTime(-1), -1);
+}
@@ -79,12 +79,14 @@ TEST_F(LogOOCFileParseThread_UT, UT_DoWork_001)
     QString path("test");
     m_logThread->setParam(path);
     m_logThread->doWork();
-    EXPECT_EQ(m_logThread->getFileData().length(),stub_ooc_readLog("").length());
+    ASSERT_EQ(m_logThread->getSources().size(), 1);
+    ASSERT_EQ(m_logThread->getSources().first()->lineCount(), 1);
+    EXPECT_EQ(m_logThread->getSources().first()->line(0), stub_ooc_readLog(""));
 }
 
-TEST_F(LogOOCFileParseThread_UT, UT_getFileData)
+TEST_F(LogOOCFileParseThread_UT, UT_getSources)
 {
-    m_logThread->getFileData();
+    EXPECT_EQ(m_logThread->getSources().isEmpty(), true);
 }
 
 TEST_F(LogOOCFileParseThread_UT, UT_stopProcess)
@@ -0,0 +1,78 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logorderedparser.h"
+
+#include <gtest/gtest.h>
+
+#include <QThread>
+
+static void orderedTask(int index, const LogOrderedParser<int>::Sink &sink)
+{
+    //前面的任务更慢,交付顺序仍然按顺序号
+    QThread::msleep(static_cast<unsigned long>((4 - index) * 10));
+    QList<int> records;
+    for (int i = 0; i < 20; ++i) {
+        records.append(index * 100 + i);
+        if (records.count() == 3 && !sink(records))
+            return;
+    }
+    if (!records.isEmpty())
+        sink(records);
+}
+
+TEST(LogOrderedParser_run_UT, LogOrderedParser_run_UT_001)
+{
+    std::atomic_bool canRun(true);
+    LogOrderedParser<int> parser(canRun);
+    QList<int> result;
+    EXPECT_EQ(parser.run(5, 4, orderedTask, [&result](QList<int> &records) {
+        result.append(records);
+    }), true);
+
+    QList<int> expected;
+    for (int index = 0; index < 5; ++index) {
+        for (int i = 0; i < 20; ++i)
+            expected.append(index * 100 + i);
+    }
+    EXPECT_EQ(result, expected);
+}
+
+TEST(LogOrderedParser_run_UT, LogOrderedParser_run_UT_002)
+{
+    //单线程时串行解析,结果和并行一致
+    std::atomic_bool canRun(true);
+    LogOrderedParser<int> parser(canRun);
+    QList<int> serial;
+    QList<int> parallel;
+    EXPECT_EQ(parser.run(3, 1, orderedTask, [&serial](QList<int> &records) {
+        serial.append(records);
+    }), true);
+    EXPECT_EQ(parser.run(3, 3, orderedTask, [&parallel](QList<int> &records) {
+        parallel.append(records);
+    }), true);
+    EXPECT_EQ(serial.count(), 60);
+    EXPECT_EQ(serial, parallel);
+}
+
+TEST(LogOrderedParser_run_UT, LogOrderedParser_run_UT_003)
+{
+    //交付时被停止,返回false且不再交付
+    std::atomic_bool canRun(true);
+    LogOrderedParser<int> parser(canRun);
+    int delivered = 0;
+    EXPECT_EQ(parser.run(4, 2, orderedTask, [&canRun, &delivered](QList<int> &records) {
+        Q_UNUSED(records)
+        ++delivered;
+        canRun = false;
+    }), false);
+    EXPECT_EQ(delivered, 1);
+}
+
+TEST(LogOrderedParser_idealThreadCount_UT, LogOrderedParser_idealThreadCount_UT_001)
+{
+    EXPECT_EQ(LogOrderedParser<int>::idealThreadCount(1), 1);
+    EXPECT_EQ(LogOrderedParser<int>::idealThreadCount(0), 1);
+    EXPECT_LE(LogOrderedParser<int>::idealThreadCount(100), LOG_PARSE_MAX_THREADS);
+}
@@ -0,0 +1,39 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logpagedtextview.h"
+
+#include <gtest/gtest.h>
+
+#include <QKeyEvent>
+
+static LogTextSourcePtr textSource(const QByteArray &data)
+{
+    std::shared_ptr<LogTextSource> source = std::make_shared<LogTextSource>("data");
+    source->setData(data);
+    std::atomic_bool canRun(true);
+    source->buildIndex(canRun);
+    return source;
+}
+
+TEST(LogPagedTextView_appendSource_UT, LogPagedTextView_appendSource_UT_001)
+{
+    LogPagedTextView view;
+    view.appendSource(textSource("a\nb\n"));
+    view.appendSource(textSource(""));
+    view.appendSource(textSource("c"));
+    //多个文件的行连续编号
+    ASSERT_EQ(view.lineCount(), 3);
+    EXPECT_EQ(view.lineText(1), QString("b"));
+    EXPECT_EQ(view.lineText(2), QString("c"));
+    EXPECT_EQ(view.lineText(3), QString());
+
+    QKeyEvent selectAll(QEvent::KeyPress, Qt::Key_A, Qt::ControlModifier);
+    QCoreApplication::sendEvent(&view, &selectAll);
+    EXPECT_EQ(view.selectedText(), QString("a\nb\nc"));
+
+    view.clear();
+    EXPECT_EQ(view.lineCount(), 0);
+    EXPECT_EQ(view.selectedText(), QString());
+}
@@ -0,0 +1,53 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logparsecontext.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+TEST(LogParseContextPool_acquire_UT, LogParseContextPool_acquire_UT_001)
+{
+    LogParseContextPool pool;
+    QString host;
+    {
+        LogParseContextPool::Lease lease = pool.acquire("kern");
+        lease->lines << "line";
+        host = lease->strings.intern(QString("host"));
+        EXPECT_EQ(pool.idleCount("kern"), 0);
+    }
+    EXPECT_EQ(pool.idleCount("kern"), 1);
+
+    //再次取出的是同一个上下文,行已清空,字符串池保留上次收录的值
+    LogParseContextPool::Lease lease = pool.acquire("kern");
+    EXPECT_EQ(pool.idleCount("kern"), 0);
+    EXPECT_TRUE(lease->lines.isEmpty());
+    EXPECT_EQ(lease->strings.intern(QString("ho") + "st").constData(), host.constData());
+    //不同种类的上下文互不复用
+    LogParseContextPool::Lease other = pool.acquire("dpkg");
+    EXPECT_EQ(other->strings.size(), 0);
+}
+
+TEST(LogParseContextPool_acquire_UT, LogParseContextPool_acquire_UT_002)
+{
+    LogParseContextPool pool;
+    {
+        //移动后只归还一次
+        LogParseContextPool::Lease lease = pool.acquire("audit");
+        LogParseContextPool::Lease moved = std::move(lease);
+        EXPECT_EQ(moved->lines.size(), 0);
+    }
+    EXPECT_EQ(pool.idleCount("audit"), 1);
+
+    //空闲的上下文个数有上限
+    {
+        std::vector<LogParseContextPool::Lease> leases;
+        for (int i = 0; i < LOG_PARSE_CONTEXT_IDLE_MAX + 2; ++i)
+            leases.push_back(pool.acquire("audit"));
+    }
+    EXPECT_EQ(pool.idleCount("audit"), LOG_PARSE_CONTEXT_IDLE_MAX);
+    pool.clear();
+    EXPECT_EQ(pool.idleCount("audit"), 0);
+}
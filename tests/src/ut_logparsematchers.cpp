@@ -0,0 +1,164 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logparsematchers.h"
+#include "structdef.h"
+
+#include <gtest/gtest.h>
+
+#include <QDateTime>
+#include <QLocale>
+
+TEST(LogParseMatchers_stripColorSequences_UT, LogParseMatchers_stripColorSequences_UT_001)
+{
+    QString line = "\033[40;37mtest\033[0m #033[1;31mred#033[0m";
+    LogParseMatchers::stripColorSequences(line);
+    EXPECT_EQ(line, QString("test red"));
+}
+
+TEST(LogParseMatchers_stripColorSequences_UT, LogParseMatchers_stripColorSequences_UT_002)
+{
+    //不完整或超过三组参数的序列不是颜色序列,保留原样
+    QString line = "\033[1;2;3;4mx #033[m #1 \033[12";
+    const QString origin = line;
+    LogParseMatchers::stripColorSequences(line);
+    EXPECT_EQ(line, origin);
+
+    QString plain = "no escape here";
+    LogParseMatchers::stripColorSequences(plain);
+    EXPECT_EQ(plain, QString("no escape here"));
+}
+
+TEST(LogParseMatchers_instance_UT, LogParseMatchers_instance_UT_001)
+{
+    const LogParseMatchers &matchers = LogParseMatchers::instance();
+    EXPECT_EQ(&matchers, &LogParseMatchers::instance());
+
+    QRegularExpressionMatch match = matchers.dmesgLine.match("<6>[   12.345678] usb 1-1: new device");
+    EXPECT_EQ(match.hasMatch(), true);
+    EXPECT_EQ(match.captured(1), QString("6"));
+    EXPECT_EQ(match.captured(3) + match.captured(4), QString("12.345678"));
+}
+
+TEST(LogParseMatchers_scanDnfPrefix_UT, LogParseMatchers_scanDnfPrefix_UT_001)
+{
+    //按位置取出的等级和信息与正则的分组一致
+    const QStringList lines {
+        "2023-07-03T10:00:00Z INFO Loaded plugins: debuginfo-install",
+        "2023-07-03T10:00:00+0800 DDEBUG   Command: dnf makecache",
+        "2023-07-03 10:00:00 ERROR",
+        "2023-07-03T10:00:00Z  bad-level"
+    };
+    const QRegularExpression &re = LogParseMatchers::instance().dnfLine;
+    for (const QString &line : lines) {
+        LogLinePrefix prefix;
+        ASSERT_EQ(LogParseMatchers::scanDnfPrefix(line, prefix), true);
+        QRegularExpressionMatch match = re.match(line);
+        ASSERT_EQ(match.hasMatch(), true);
+        EXPECT_EQ(prefix.level(line).toString(), match.captured(3));
+        EXPECT_EQ(line.mid(prefix.restBegin), match.captured(4));
+        EXPECT_EQ(prefix.time, QDateTime::fromString(match.captured(1) + match.captured(2), "yyyy-MM-ddhh:mm:ss").toMSecsSinceEpoch());
+    }
+
+    //续行和日期无效的行作为上一条记录的多行信息
+    LogLinePrefix prefix;
+    EXPECT_EQ(LogParseMatchers::scanDnfPrefix("  File \"/usr/lib/python3\", line 1", prefix), false);
+    EXPECT_EQ(LogParseMatchers::scanDnfPrefix("2023-02-30T10:00:00Z INFO x", prefix), false);
+    EXPECT_EQ(LogParseMatchers::scanDnfPrefix("2023-07-03", prefix), false);
+}
+
+TEST(LogParseMatchers_scanAppPrefix_UT, LogParseMatchers_scanAppPrefix_UT_001)
+{
+    LogLinePrefix prefix;
+    const QString line = "2023-07-03, 10:00:00.123 [Warning] [app.cpp main 10] started";
+    ASSERT_EQ(LogParseMatchers::scanAppPrefix(line, prefix), true);
+    EXPECT_EQ(prefix.level(line).toString(), QString("Warning"));
+    EXPECT_EQ(prefix.time, QDateTime(QDate(2023, 7, 3), QTime(10, 0, 0, 123)).toMSecsSinceEpoch());
+
+    //毫秒不是三位时不换算时间,只识别等级
+    const QString noMsecs = "2023-07-03 10:00:00,5 Info msg";
+    ASSERT_EQ(LogParseMatchers::scanAppPrefix(noMsecs, prefix), true);
+    EXPECT_EQ(prefix.time, -1);
+    EXPECT_EQ(prefix.level(noMsecs).toString(), QString("Info"));
+
+    EXPECT_EQ(LogParseMatchers::scanAppPrefix("2023-07-03 10:00:00", prefix), false);
+    EXPECT_EQ(LogParseMatchers::scanAppPrefix("started without time", prefix), false);
+}
+
+TEST(LogParseMatchers_scanAppLine_UT, LogParseMatchers_scanAppLine_UT_001)
+{
+    //和应用日志解析线程中的正则比较信息的开始位置
+    const QRegularExpression re("^(\\d{4}-[0-2]\\d-[0-3]\\d)\\D*([0-2]\\d:[0-5]\\d:[0-5]\\d.\\d*)[^A-Za-z]*([A-Za-z]*)[^\\[]*[^\\]]*\\]*\\s*(.*)$");
+    const QStringList lines {
+        "2023-07-03, 10:00:00.123 [Warning] [app.cpp main 10] started",
+        "2023-07-03 10:00:00.123 [Info ] [] ]]  a [b] c",
+        "2023-07-03 10:00:00.123 Debug no brackets",
+        "2023-07-03 10:00:00.123 Debug [unclosed"
+    };
+    for (const QString &line : lines) {
+        LogLinePrefix prefix;
+        ASSERT_EQ(LogParseMatchers::scanAppLine(line, prefix), true);
+        const QRegularExpressionMatch match = re.match(line);
+        ASSERT_EQ(match.hasMatch(), true);
+        EXPECT_EQ(line.mid(prefix.timeBegin, prefix.timeEnd - prefix.timeBegin), match.captured(2));
+        EXPECT_EQ(prefix.level(line).toString(), match.captured(3));
+        EXPECT_EQ(line.mid(prefix.restBegin), match.captured(4));
+        EXPECT_EQ(prefix.time, QDateTime::fromString(match.captured(1) + " " + match.captured(2), "yyyy-MM-dd hh:mm:ss.zzz").toMSecsSinceEpoch());
+    }
+
+    //时间不能按固定格式换算时由调用者按正则处理
+    LogLinePrefix prefix;
+    EXPECT_EQ(LogParseMatchers::scanAppLine("2023-07-03 10:00:00,5 Info msg", prefix), false);
+    EXPECT_EQ(LogParseMatchers::scanAppLine("2023-02-30 10:00:00.123 Info msg", prefix), false);
+}
+
+TEST(LogParseMatchers_scanBootStatus_UT, LogParseMatchers_scanBootStatus_UT_001)
+{
+    int msgBegin = -1;
+    const QString ok = "[  OK  ] Started Journal Service.";
+    EXPECT_EQ(LogParseMatchers::scanBootStatus(ok, msgBegin), static_cast<int>(BootStatusOk));
+    EXPECT_EQ(ok.mid(msgBegin), QString("Started Journal Service."));
+    //状态和信息的第一个词不再混淆
+    const QString failed = "[FAILED] Failed to start Load Kernel Modules.";
+    EXPECT_EQ(LogParseMatchers::scanBootStatus(failed, msgBegin), static_cast<int>(BootStatusFailed));
+    EXPECT_EQ(failed.mid(msgBegin), QString("Failed to start Load Kernel Modules."));
+    const QString other = "  See 'systemctl status systemd-modules-load.service' for details.";
+    EXPECT_EQ(LogParseMatchers::scanBootStatus(other, msgBegin), static_cast<int>(BootStatusNone));
+    EXPECT_EQ(msgBegin, 2);
+    EXPECT_EQ(LogParseMatchers::scanBootStatus("[DEPEND] Dependency failed", msgBegin), static_cast<int>(BootStatusNone));
+    EXPECT_EQ(LogParseMatchers::scanBootStatus("[", msgBegin), static_cast<int>(BootStatusNone));
+
+    EXPECT_EQ(LogParseMatchers::bootStatusText(BootStatusFailed), QString("Failed"));
+    EXPECT_EQ(LogParseMatchers::bootStatusText(BootStatusNone), QString());
+    EXPECT_EQ(LogParseMatchers::bootStatusFilter(""), -1);
+    EXPECT_EQ(LogParseMatchers::bootStatusFilter("ok"), static_cast<int>(BootStatusOk));
+    EXPECT_EQ(LogParseMatchers::bootStatusFilter("Failed"), static_cast<int>(BootStatusFailed));
+}
+
+TEST(LogParseMatchers_parseIsoDateTime_UT, LogParseMatchers_parseIsoDateTime_UT_001)
+{
+    //按天缓存的结果和QDateTime逐条解析一致,包括跨天
+    const char *const times[] = {"2020-01-05 00:00:00", "2020-01-05 23:59:59", "2020-01-06 08:30:15", "2020-03-29 02:30:00",
+                                 "2020-10-25 02:30:00", "2020-02-29 12:00:00"};
+    for (const char *text : times) {
+        const QString str(text);
+        EXPECT_EQ(LogParseMatchers::parseIsoDateTime(str.left(10), str.mid(11)),
+                  QDateTime::fromString(str, "yyyy-MM-dd hh:mm:ss").toMSecsSinceEpoch());
+    }
+    EXPECT_EQ(LogParseMatchers::parseIsoDateTime("2020-02-30", "12:00:00"), -1);
+    EXPECT_EQ(LogParseMatchers::parseIsoDateTime("2020-1-5", "12:00:00"), -1);
+    EXPECT_EQ(LogParseMatchers::parseIsoDateTime("2020-01-05", "12:00"), -1);
+}
+
+TEST(LogParseMatchers_parseSyslogDateTime_UT, LogParseMatchers_parseSyslogDateTime_UT_001)
+{
+    const QLocale locale(QLocale::English, QLocale::UnitedStates);
+    EXPECT_EQ(LogParseMatchers::parseSyslogDateTime("Sep", "29", "15:53:34", 2021),
+              locale.toDateTime("Sep 29 2021 15:53:34", "MMM d yyyy hh:mm:ss").toMSecsSinceEpoch());
+    EXPECT_EQ(LogParseMatchers::parseSyslogDateTime("jan", "5", "00:00:01", 2021),
+              locale.toDateTime("Jan 5 2021 00:00:01", "MMM d yyyy hh:mm:ss").toMSecsSinceEpoch());
+    EXPECT_EQ(LogParseMatchers::parseSyslogDateTime("Foo", "5", "00:00:01", 2021), -1);
+    EXPECT_EQ(LogParseMatchers::parseSyslogDateTime("Feb", "30", "00:00:01", 2021), -1);
+    EXPECT_EQ(LogParseMatchers::parseSyslogDateTime("Feb", "3x", "00:00:01", 2021), -1);
+}
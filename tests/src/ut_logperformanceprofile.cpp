@@ -0,0 +1,62 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logperformanceprofile.h"
+
+#include <gtest/gtest.h>
+
+TEST(LogPerformanceProfile_preset_UT, LogPerformanceProfile_preset_UT_001)
+{
+    bool ok = false;
+    const LogPerformanceProfile balanced = LogPerformanceProfile::preset("balanced", &ok);
+    EXPECT_TRUE(ok);
+    //balanced和之前写死的值一致
+    EXPECT_EQ(balanced.readBatchSize, 500);
+    EXPECT_EQ(balanced.journalReadThreads, 0);
+    EXPECT_EQ(balanced.categoryCacheMB, 256);
+
+    const LogPerformanceProfile low = LogPerformanceProfile::preset("low-memory", &ok);
+    EXPECT_TRUE(ok);
+    EXPECT_LT(low.readBatchSize, balanced.readBatchSize);
+    EXPECT_EQ(low.journalReadThreads, 1);
+    EXPECT_LT(low.categoryCacheMB, balanced.categoryCacheMB);
+
+    const LogPerformanceProfile high = LogPerformanceProfile::preset("throughput", &ok);
+    EXPECT_TRUE(ok);
+    EXPECT_GT(high.readBatchSize, balanced.readBatchSize);
+    EXPECT_GT(high.searchThreads, balanced.searchThreads);
+
+    //不认识的名称使用balanced
+    const LogPerformanceProfile unknown = LogPerformanceProfile::preset("fast", &ok);
+    EXPECT_FALSE(ok);
+    EXPECT_EQ(unknown.name, QString("balanced"));
+    EXPECT_EQ(unknown.readBatchSize, 500);
+}
+
+TEST(LogPerformanceProfile_fromConfig_UT, LogPerformanceProfile_fromConfig_UT_001)
+{
+    QVariantMap overrides;
+    overrides.insert("readBatchSize", 1000);
+    overrides.insert("journalReadThreads", "8");
+    //非法值保持档位的值
+    overrides.insert("searchThreads", 0);
+    overrides.insert("categoryCacheMB", "abc");
+
+    const LogPerformanceProfile profile = LogPerformanceProfile::fromConfig("low-memory", overrides);
+    EXPECT_EQ(profile.name, QString("low-memory"));
+    EXPECT_EQ(profile.readBatchSize, 1000);
+    EXPECT_EQ(profile.journalReadThreads, 8);
+    EXPECT_EQ(profile.searchThreads, 1);
+    EXPECT_EQ(profile.categoryCacheMB, 32);
+    EXPECT_EQ(profile.searchIndexMB, 32);
+}
+
+TEST(LogPerformanceProfile_setCurrent_UT, LogPerformanceProfile_setCurrent_UT_001)
+{
+    const LogPerformanceProfile saved = LogPerformanceProfile::current();
+    LogPerformanceProfile::setCurrent(LogPerformanceProfile::preset("throughput"));
+    EXPECT_EQ(LogPerformanceProfile::current().readBatchSize, 2000);
+    LogPerformanceProfile::setCurrent(saved);
+    EXPECT_EQ(LogPerformanceProfile::current().readBatchSize, saved.readBatchSize);
+}
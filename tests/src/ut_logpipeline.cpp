@@ -0,0 +1,108 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logpipeline.h"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+TEST(LogPipeline_run_UT, LogPipeline_run_UT_001)
+{
+    //解析耗时不同,交付仍按读取顺序
+    std::atomic_bool canRun(true);
+    LogPipeline<int, int> pipeline(canRun, 4);
+    int next = 0;
+    QList<int> delivered;
+    bool completed = pipeline.run([&next](int &chunk) {
+        if (next >= 50)
+            return false;
+        chunk = next++;
+        return true;
+    }, [](const int &chunk, QList<int> &records) {
+        std::this_thread::sleep_for(std::chrono::microseconds((chunk % 3) * 500));
+        records << chunk * 2 << chunk * 2 + 1;
+        return true;
+    }, [&delivered](QList<int> &records) {
+        delivered.append(records);
+        return true;
+    });
+    EXPECT_TRUE(completed);
+    ASSERT_EQ(delivered.size(), 100);
+    for (int i = 0; i < delivered.size(); ++i)
+        EXPECT_EQ(delivered.at(i), i);
+}
+
+TEST(LogPipeline_run_UT, LogPipeline_run_UT_002)
+{
+    //交付慢时读取随之等待,已读取未交付的块数不超过上限
+    std::atomic_bool canRun(true);
+    LogPipeline<int, int> pipeline(canRun, 2, 3);
+    std::atomic<int> read(0);
+    std::atomic<int> delivered(0);
+    int maxInFlight = 0;
+    bool completed = pipeline.run([&read](int &chunk) {
+        if (read >= 20)
+            return false;
+        chunk = read++;
+        return true;
+    }, [](const int &chunk, QList<int> &records) {
+        records << chunk;
+        return true;
+    }, [&read, &delivered, &maxInFlight](QList<int> &) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        maxInFlight = qMax(maxInFlight, read - delivered);
+        ++delivered;
+        return true;
+    });
+    EXPECT_TRUE(completed);
+    EXPECT_EQ(delivered.load(), 20);
+    EXPECT_LE(maxInFlight, 3);
+}
+
+TEST(LogPipeline_run_UT, LogPipeline_run_UT_003)
+{
+    //交付返回false时停止,读取线程不再读完整个输入
+    std::atomic_bool canRun(true);
+    LogPipeline<int, int> pipeline(canRun, 2);
+    std::atomic<int> read(0);
+    int delivered = 0;
+    bool completed = pipeline.run([&read](int &chunk) {
+        chunk = read++;
+        return read < 100000;
+    }, [](const int &chunk, QList<int> &records) {
+        records << chunk;
+        return true;
+    }, [&delivered](QList<int> &) {
+        return ++delivered < 5;
+    });
+    EXPECT_FALSE(completed);
+    EXPECT_EQ(delivered, 5);
+    EXPECT_LT(read.load(), 100);
+}
+
+TEST(LogPipeline_run_UT, LogPipeline_run_UT_004)
+{
+    //单线程时在调用线程中依次解析和交付
+    std::atomic_bool canRun(true);
+    LogPipeline<int, int> pipeline(canRun, 1);
+    int next = 0;
+    QList<int> delivered;
+    EXPECT_TRUE(pipeline.run([&next](int &chunk) {
+        chunk = next++;
+        return next <= 3;
+    }, [](const int &chunk, QList<int> &records) {
+        records << chunk;
+        return true;
+    }, [&delivered](QList<int> &records) {
+        delivered.append(records);
+        return true;
+    }));
+    EXPECT_EQ(delivered, QList<int>() << 0 << 1 << 2);
+
+    canRun = false;
+    EXPECT_FALSE(pipeline.run([](int &) { return true; },
+                              [](const int &, QList<int> &) { return true; },
+                              [](QList<int> &) { return true; }));
+}
@@ -0,0 +1,44 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logprefetcher.h"
+#include "logfileparser.h"
+
+#include <gtest/gtest.h>
+
+TEST(LogPrefetcher_categoryName_UT, LogPrefetcher_categoryName_UT_001)
+{
+    for (LOG_FLAG flag : {JOURNAL, KERN, BOOT, XORG, DPKG}) {
+        const QString name = LogPrefetcher::categoryName(flag);
+        EXPECT_EQ(name.isEmpty(), false);
+        EXPECT_EQ(LogPrefetcher::categoryFlag(name), flag);
+    }
+    //需要鉴权或不缓存的类别不预取
+    EXPECT_EQ(LogPrefetcher::categoryName(Audit).isEmpty(), true);
+    EXPECT_EQ(LogPrefetcher::categoryName(APP).isEmpty(), true);
+    EXPECT_EQ(LogPrefetcher::categoryFlag("unknown"), NONE);
+}
+
+TEST(LogPrefetcher_setPaused_UT, LogPrefetcher_setPaused_UT_001)
+{
+    LogFileParser parser;
+    LogPrefetcher prefetcher(&parser);
+    EXPECT_EQ(prefetcher.isPaused(), false);
+    prefetcher.setPaused(true);
+    EXPECT_EQ(prefetcher.isPaused(), true);
+    EXPECT_EQ(parser.isPrefetching(), false);
+    prefetcher.setPaused(false);
+    EXPECT_EQ(prefetcher.isPaused(), false);
+}
+
+TEST(LogFileParser_prefetch_UT, LogFileParser_prefetch_UT_001)
+{
+    LogFileParser parser;
+    //不支持的类别不预取
+    EXPECT_EQ(parser.prefetch(Audit), false);
+    EXPECT_EQ(parser.prefetch(APP), false);
+    EXPECT_EQ(parser.isPrefetching(), false);
+    parser.cancelPrefetch();
+    EXPECT_EQ(parser.isPrefetching(), false);
+}
@@ -0,0 +1,35 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logprogressreporter.h"
+
+#include <QVector>
+
+#include <gtest/gtest.h>
+
+TEST(LogProgressReporter_report_UT, LogProgressReporter_report_UT_001)
+{
+    QVector<int> reported;
+    LogProgressReporter progress([&reported](int current, int) { reported.append(current); }, 60 * 1000);
+    for (int i = 1; i <= 100000; ++i)
+        progress.report(i, 100000);
+    //间隔内只有第一次和完成时通知
+    EXPECT_EQ(reported, QVector<int>() << 1 << 100000);
+
+    progress.report(100000, 100000);
+    EXPECT_EQ(reported.size(), 2);
+    progress.reset();
+    progress.report(5, 10);
+    EXPECT_EQ(reported.last(), 5);
+}
+
+TEST(LogProgressReporter_report_UT, LogProgressReporter_report_UT_002)
+{
+    //间隔为0时每次变化都通知
+    int count = 0;
+    LogProgressReporter progress([&count](int, int) { ++count; }, 0);
+    for (int i = 1; i <= 10; ++i)
+        progress.report(i, 10);
+    EXPECT_EQ(count, 10);
+}
@@ -0,0 +1,122 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logquery.h"
+
+#include <gtest/gtest.h>
+
+TEST(LogQuery_parse_UT, LogQuery_parse_UT_001)
+{
+    //没有字段条件时整个输入是一个关键字
+    LogQuery query("failed password: root");
+    EXPECT_EQ(query.isStructured(), false);
+    EXPECT_EQ(query.texts(), QStringList() << "failed password: root");
+    EXPECT_EQ(query.journalMatches().isEmpty(), true);
+    EXPECT_EQ(LogQuery("").texts(), QStringList() << "");
+}
+
+TEST(LogQuery_parse_UT, LogQuery_parse_UT_002)
+{
+    LogQuery query("unit:sshd level<=err failed \"bad password\" root");
+    EXPECT_EQ(query.isStructured(), true);
+    ASSERT_EQ(query.terms().size(), 2);
+    EXPECT_EQ(query.terms().at(0).field, LogQuery::FieldUnit);
+    EXPECT_EQ(query.terms().at(0).value, QString("sshd"));
+    EXPECT_EQ(query.terms().at(1).field, LogQuery::FieldLevel);
+    EXPECT_EQ(query.terms().at(1).op, LogQuery::OpLessEqual);
+    EXPECT_EQ(query.texts(), QStringList() << "failed root" << "bad password");
+    EXPECT_EQ(query.levelMask(), 0x0f);
+}
+
+TEST(LogQuery_parse_UT, LogQuery_parse_UT_003)
+{
+    //不认识的字段、非法的等级和非等级字段的比较都按普通词处理
+    EXPECT_EQ(LogQuery("foo:bar").isStructured(), false);
+    EXPECT_EQ(LogQuery("level:loud").isStructured(), false);
+    EXPECT_EQ(LogQuery("pid>3").isStructured(), false);
+    LogQuery query("host=\"my \\\"box\\\"\" level:warn level:3 level!=err");
+    ASSERT_EQ(query.terms().size(), 4);
+    EXPECT_EQ(query.terms().at(0).value, QString("my \"box\""));
+    EXPECT_EQ(query.levelMask(), 1 << 4);
+    EXPECT_EQ(query.texts().isEmpty(), true);
+}
+
+TEST(LogQuery_parseLevel_UT, LogQuery_parseLevel_UT_001)
+{
+    EXPECT_EQ(LogQuery::parseLevel("emerg"), 0);
+    EXPECT_EQ(LogQuery::parseLevel("ERROR"), 3);
+    EXPECT_EQ(LogQuery::parseLevel("Warning"), 4);
+    EXPECT_EQ(LogQuery::parseLevel("7"), 7);
+    EXPECT_EQ(LogQuery::parseLevel("8"), -1);
+    EXPECT_EQ(LogQuery::parseLevel("loud"), -1);
+    EXPECT_EQ(LogQuery::levelPriority("Critical"), 2);
+}
+
+TEST(LogQuery_journalMatches_UT, LogQuery_journalMatches_UT_001)
+{
+    EXPECT_EQ(LogQuery("ident:sshd pid:12 level<crit").journalMatches(),
+              QStringList() << "SYSLOG_IDENTIFIER=sshd" << "_PID=12" << "PRIORITY=0" << "PRIORITY=1");
+    //unit同时匹配系统和用户单元
+    EXPECT_EQ(LogQuery("unit:sshd host:a").journalMatches(),
+              QStringList() << "_SYSTEMD_UNIT=sshd.service" << "_HOSTNAME=a"
+                            << "+" << "_SYSTEMD_USER_UNIT=sshd.service" << "_HOSTNAME=a");
+    EXPECT_EQ(LogQuery("unit:a.socket").journalMatches().at(0), QString("_SYSTEMD_UNIT=a.socket"));
+    //不等于和user不下推
+    EXPECT_EQ(LogQuery("ident!=sshd user:root").journalMatches().isEmpty(), true);
+}
+
+TEST(LogQuery_matchesColumns_UT, LogQuery_matchesColumns_UT_001)
+{
+    const QString ident = "sshd";
+    const QString exe = "/usr/sbin/sshd";
+    LogQueryColumns columns;
+    columns.ident = &ident;
+    columns.level = ERR;
+    EXPECT_EQ(LogQuery("unit:sshd.service level<=err").matchesColumns(columns), true);
+    EXPECT_EQ(LogQuery("ident:cron ident:SSHD").matchesColumns(columns), true);
+    EXPECT_EQ(LogQuery("ident!=sshd").matchesColumns(columns), false);
+    EXPECT_EQ(LogQuery("level:warning").matchesColumns(columns), false);
+    //没有该列的记录不匹配
+    EXPECT_EQ(LogQuery("host:a").matchesColumns(columns), false);
+    //已下推的条件不再判断
+    EXPECT_EQ(LogQuery("host:a").matchesColumns(columns, true), true);
+    columns.ident = &exe;
+    EXPECT_EQ(LogQuery("ident:sshd").matchesColumns(columns), true);
+}
+
+TEST(LogQuery_predicate_UT, LogQuery_predicate_UT_001)
+{
+    LOG_MSG_APPLICATOIN msg;
+    msg.src = "dde-dock";
+    msg.level = WARN;
+    msg.msg = "plugin loaded: bad tray";
+    const std::function<bool(const LogRecordFilter::TextMatcher &, const LOG_MSG_APPLICATOIN &)> textMatch = &LogRecordFilter::matchApp;
+    const LogRecordFilter::TextMatcher::Mode mode = LogRecordFilter::TextMatcher::Keyword;
+    EXPECT_EQ(LogQuery("app:dde-dock \"bad tray\" plugin").predicate<LOG_MSG_APPLICATOIN>(textMatch, mode)(msg), true);
+    EXPECT_EQ(LogQuery("app:dde-dock plugin missing").predicate<LOG_MSG_APPLICATOIN>(textMatch, mode)(msg), false);
+    EXPECT_EQ(LogQuery("app:dde-dock level:err").predicate<LOG_MSG_APPLICATOIN>(textMatch, mode)(msg), false);
+    EXPECT_EQ(LogQuery("level>=warning").predicate<LOG_MSG_APPLICATOIN>(textMatch, mode)(msg), true);
+}
+
+TEST(LogQuery_matchesColumns_UT, LogQuery_matchesColumns_UT_002)
+{
+    const qint64 begin = LogQuery::parseHour("2023-05-01T13");
+    ASSERT_GE(begin, 0);
+    EXPECT_EQ(LogQuery::hourText(begin), QString("2023-05-01T13"));
+    EXPECT_EQ(LogQuery("hour:2023-05-01").isStructured(), false);
+    EXPECT_EQ(LogQuery("hour>2023-05-01T13").isStructured(), false);
+    //小时条件不下推到journal
+    EXPECT_EQ(LogQuery("hour:2023-05-01T13").journalMatches().isEmpty(), true);
+
+    LogQueryColumns columns;
+    columns.msecs = begin + 59 * 60 * 1000;
+    EXPECT_EQ(LogQuery("hour:2023-05-01T13").matchesColumns(columns, true), true);
+    EXPECT_EQ(LogQuery("hour:2023-05-01T12 hour:2023-05-01T13").matchesColumns(columns), true);
+    EXPECT_EQ(LogQuery("hour!=2023-05-01T13").matchesColumns(columns), false);
+    columns.msecs = begin + 60 * 60 * 1000;
+    EXPECT_EQ(LogQuery("hour:2023-05-01T13").matchesColumns(columns), false);
+    //没有时间的记录不匹配
+    columns.msecs = -1;
+    EXPECT_EQ(LogQuery("hour:2023-05-01T13").matchesColumns(columns), false);
+}
@@ -0,0 +1,101 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logrecordbatch.h"
+#include "logrecordparser.h"
+#include "logrecordreader.h"
+
+#include <gtest/gtest.h>
+
+#include <QDateTime>
+#include <QTemporaryFile>
+
+TEST(LogRecordBatch_append_UT, LogRecordBatch_append_UT_001)
+{
+    LogRecordBatch batch;
+    batch.reset(LogRecordBatch::DpkgFormat);
+    EXPECT_EQ(batch.isValid(), true);
+    EXPECT_EQ(batch.size(), 0);
+    EXPECT_EQ(batch.columnCount, 3);
+
+    batch.append(1000, 6, QStringList() << "2023-07-03 10:00:00" << "status" << QString::fromUtf8("已安装 bash"));
+    //列数不对的记录补齐为空
+    batch.append(2000, 6, QStringList() << "2023-07-03 10:00:01");
+    ASSERT_EQ(batch.size(), 2);
+    EXPECT_EQ(batch.timestamps.at(1), 2000);
+    EXPECT_EQ(batch.column(0, 2), QString::fromUtf8("已安装 bash"));
+    EXPECT_EQ(batch.column(1, 0), QString("2023-07-03 10:00:01"));
+    EXPECT_EQ(batch.column(1, 2), QString());
+
+    //版本不一致或偏移被截断都不能按列读取
+    LogRecordBatch invalid = batch;
+    invalid.version = 0;
+    EXPECT_EQ(invalid.isValid(), false);
+    invalid = batch;
+    invalid.offsets.removeLast();
+    EXPECT_EQ(invalid.isValid(), false);
+}
+
+TEST(LogRecordParser_parseLine_UT, LogRecordParser_parseLine_UT_001)
+{
+    qint64 time = 0;
+    QStringList columns;
+    ASSERT_EQ(LogRecordParser::parseLine(LogRecordBatch::KernFormat, "Sep 29 15:53:34 uos kernel: [ 0.1] usb 1-1", time, columns), true);
+    ASSERT_EQ(columns.size(), 5);
+    EXPECT_EQ(columns.at(0), QString("Sep 29 15:53:34"));
+    EXPECT_EQ(columns.at(1), QString("uos"));
+    EXPECT_EQ(columns.at(2), QString("kernel"));
+    EXPECT_EQ(time, QDateTime(QDate(QDate::currentDate().year(), 9, 29), QTime(15, 53, 34)).toMSecsSinceEpoch());
+
+    //带年份的内核日志
+    ASSERT_EQ(LogRecordParser::parseLine(LogRecordBatch::KernFormat, "2023-07-03 10:00:00 uos systemd[1]: started", time, columns), true);
+    EXPECT_EQ(columns.at(1), QString("uos"));
+    EXPECT_EQ(columns.at(2), QString("systemd"));
+    EXPECT_EQ(columns.at(3), QString("1"));
+    EXPECT_EQ(time, QDateTime(QDate(2023, 7, 3), QTime(10, 0, 0)).toMSecsSinceEpoch());
+
+    ASSERT_EQ(LogRecordParser::parseLine(LogRecordBatch::DpkgFormat, "2023-07-03 10:00:00 status installed bash:amd64", time, columns), true);
+    EXPECT_EQ(columns.at(1), QString("status"));
+    EXPECT_EQ(columns.at(2), QString("installed bash:amd64 "));
+
+    EXPECT_EQ(LogRecordParser::parseLine(LogRecordBatch::DpkgFormat, "short line", time, columns), false);
+    EXPECT_EQ(LogRecordParser::parseLine(LogRecordBatch::InvalidFormat, "2023-07-03 10:00:00 status installed", time, columns), false);
+}
+
+TEST(LogRecordParser_formatDateTime_UT, LogRecordParser_formatDateTime_UT_001)
+{
+    //原LogAuthThread的UT_FormatDateTime_001,时间换算移到了LogRecordParser
+    qint64 timeMesc = LogRecordParser::formatDateTime("2021", "08-30", "14:25");
+    qint64 timeMesc1 = LogRecordParser::formatDateTime("Aug 30", "19:04:43");
+    EXPECT_NE(timeMesc, -1);
+    EXPECT_NE(timeMesc1, -1);
+
+    EXPECT_EQ(LogRecordParser::formatDateTime("Aug", "30", "19:04:43"),
+              QDateTime(QDate(QDate::currentDate().year(), 8, 30), QTime(19, 4, 43)).toMSecsSinceEpoch());
+    EXPECT_EQ(LogRecordParser::formatDateTime("2021-08-30", "14:25:00"), QDateTime(QDate(2021, 8, 30), QTime(14, 25, 0)).toMSecsSinceEpoch());
+}
+
+TEST(LogRecordReader_read_UT, LogRecordReader_read_UT_001)
+{
+    QTemporaryFile file;
+    ASSERT_EQ(file.open(), true);
+    file.write("2023-07-03 10:00:00 status installed a\n2023-07-03 10:00:01 status installed b\n");
+    file.flush();
+
+    LogRecordReader reader(file.fileName(), LogRecordBatch::DpkgFormat);
+    std::atomic_bool canRun(true);
+    QStringList messages;
+    EXPECT_EQ(reader.read(canRun, [&messages](qint64, const QStringList &columns) {
+        messages.append(columns.at(2));
+        return true;
+    }), true);
+    //本地可读,不经过服务
+    EXPECT_EQ(reader.isBatched(), false);
+    //从新到旧
+    ASSERT_EQ(messages.size(), 2);
+    EXPECT_EQ(messages.at(0), QString("installed b "));
+
+    //回调要求停止
+    EXPECT_EQ(reader.read(canRun, [](qint64, const QStringList &) { return false; }), false);
+}
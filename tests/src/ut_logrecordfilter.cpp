@@ -0,0 +1,90 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logrecordfilter.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+
+TEST(LogRecordFilter_TextMatcher_UT, LogRecordFilter_TextMatcher_UT_001)
+{
+    LogRecordFilter::TextMatcher empty;
+    EXPECT_EQ(empty.isEmpty(), true);
+    EXPECT_EQ(empty.matches(QString()), true);
+
+    LogRecordFilter::TextMatcher text("Error");
+    EXPECT_EQ(text.matches("kernel: some ERROR happened"), true);
+    EXPECT_EQ(text.matches("err"), false);
+    EXPECT_EQ(text.matches(QString()), false);
+}
+
+TEST(LogRecordFilter_filter_UT, LogRecordFilter_filter_UT_001)
+{
+    //足够多的记录才会分段并行筛选,结果仍按原顺序
+    QList<LOG_MSG_DPKG> list;
+    for (int i = 0; i < 50000; ++i) {
+        LOG_MSG_DPKG dpkg;
+        dpkg.dateTime = QString::number(i);
+        dpkg.msg = i % 3 == 0 ? QString("Install pkg%1").arg(i) : QString("status pkg%1").arg(i);
+        list.append(dpkg);
+    }
+    const LogRecordFilter::TextMatcher text("install");
+    std::atomic_int chunks(0);
+    QList<LOG_MSG_DPKG> result = LogRecordFilter::filterWith(list, [&chunks, text]() {
+        ++chunks;
+        return [text](const LOG_MSG_DPKG &msg) { return LogRecordFilter::matchDpkg(text, msg); };
+    });
+
+    ASSERT_EQ(result.size(), 16667);
+    for (int i = 0; i < result.size(); ++i)
+        ASSERT_EQ(result.at(i).dateTime, QString::number(i * 3));
+    EXPECT_EQ(chunks.load(), LogRecordFilter::chunkCount(list.size()));
+}
+
+TEST(LogRecordFilter_filter_UT, LogRecordFilter_filter_UT_002)
+{
+    //筛选视图得到同一存储上的下标
+    QList<LOG_MSG_DPKG> list;
+    for (int i = 0; i < 20000; ++i) {
+        LOG_MSG_DPKG dpkg;
+        dpkg.msg = i % 4 == 0 ? QString("Install pkg%1").arg(i) : QString("status pkg%1").arg(i);
+        list.append(dpkg);
+    }
+    const LogRecordFilter::TextMatcher text("install");
+    const LogRecordStore<LOG_MSG_DPKG> store(list);
+    LogRecordView<LOG_MSG_DPKG> view = LogRecordFilter::filter(LogRecordView<LOG_MSG_DPKG>::all(&store), [text](const LOG_MSG_DPKG &msg) {
+        return LogRecordFilter::matchDpkg(text, msg);
+    });
+
+    ASSERT_EQ(view.size(), 5000);
+    EXPECT_EQ(view.store(), &store);
+    for (int i = 0; i < view.size(); ++i)
+        ASSERT_EQ(view.row(i), static_cast<quint32>(i * 4));
+}
+
+TEST(LogRecordFilter_chunkCount_UT, LogRecordFilter_chunkCount_UT_001)
+{
+    EXPECT_EQ(LogRecordFilter::chunkCount(0), 1);
+    EXPECT_EQ(LogRecordFilter::chunkCount(100), 1);
+    EXPECT_LE(LogRecordFilter::chunkCount(10000000), qMax(1, QThread::idealThreadCount()));
+}
+
+TEST(LogRecordFilter_matchNormal_UT, LogRecordFilter_matchNormal_UT_001)
+{
+    LOG_MSG_NORMAL boot;
+    boot.eventType = "Boot";
+    boot.userName = "root";
+    LOG_MSG_NORMAL login;
+    login.eventType = "Login";
+    login.userName = "uos";
+    const LogRecordFilter::TextMatcher text;
+
+    EXPECT_EQ(LogRecordFilter::matchNormal(0, text, boot), true);
+    EXPECT_EQ(LogRecordFilter::matchNormal(1, text, boot), false);
+    EXPECT_EQ(LogRecordFilter::matchNormal(1, text, login), true);
+    EXPECT_EQ(LogRecordFilter::matchNormal(2, text, boot), true);
+    EXPECT_EQ(LogRecordFilter::matchNormal(3, text, boot), false);
+    EXPECT_EQ(LogRecordFilter::matchNormal(0, LogRecordFilter::TextMatcher("UOS"), boot), false);
+}
@@ -0,0 +1,82 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logrecordformatter.h"
+#include "logdocxwriter.h"
+
+#include <QBuffer>
+
+#include <gtest/gtest.h>
+
+TEST(LogRecordFormatter_writeTextLine_UT, LogRecordFormatter_writeTextLine_UT_001)
+{
+    LogRecordFormatter formatter;
+    LOG_MSG_DPKG record;
+    record.dateTime = "2023-05-01 10:00:00";
+    record.msg = "install \"vim\"";
+    record.action = "install";
+
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+    {
+        LogExportWriter out(&buffer);
+        formatter.writeTextLine<LogExportTraits<LOG_MSG_DPKG>>(out, record, QStringList() << "Date" << "Info" << "Action", QString());
+        formatter.writeJsonLine<LogExportTraits<LOG_MSG_DPKG>>(out, record, QString());
+    }
+    const QList<QByteArray> lines = buffer.data().split('\n');
+    ASSERT_EQ(lines.size(), 3);
+    EXPECT_EQ(lines.at(0), QByteArray("Date:2023-05-01 10:00:00 Info:install \"vim\" Action:install "));
+    EXPECT_EQ(lines.at(1).startsWith("{\"datetime\":\"2023-05-01 10:00:00\",\"timestamp\":"), true);
+    EXPECT_EQ(lines.at(1).endsWith(",\"message\":\"install \\\"vim\\\"\",\"action\":\"install\"}"), true);
+}
+
+TEST(LogRecordFormatter_writeJsonLine_UT, LogRecordFormatter_writeJsonLine_UT_001)
+{
+    LogRecordFormatter formatter;
+    LOG_MSG_DNF record;
+    record.level = WARNING;
+    record.dateTime = "2023-05-01 10:00:00";
+    record.msg = "msg";
+    LOG_MSG_DNF trace = record;
+    trace.level = TRACE;
+
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+    {
+        LogExportWriter out(&buffer);
+        formatter.writeJsonLine<LogExportTraits<LOG_MSG_DNF>>(out, record, QString());
+        formatter.writeJsonLine<LogExportTraits<LOG_MSG_DNF>>(out, trace, QString());
+    }
+    //dnf等级换算为syslog的priority,没有对应的不写
+    const QList<QByteArray> lines = buffer.data().split('\n');
+    ASSERT_EQ(lines.size(), 3);
+    EXPECT_EQ(lines.at(0).startsWith("{\"level\":\"" + LogLevel::dnfText(WARNING).toUtf8() + "\",\"priority\":4,"), true);
+    EXPECT_EQ(lines.at(1).contains("\"priority\""), false);
+}
+
+TEST(LogRecordFormatter_codeCell_UT, LogRecordFormatter_codeCell_UT_001)
+{
+    LogRecordFormatter formatter;
+    LOG_MSG_JOURNAL record;
+    record.level = WARN;
+    const LogExportColumn<LOG_MSG_JOURNAL> &level = LogExportTraits<LOG_MSG_JOURNAL, JOURNAL>::columns[0];
+    const LogRecordFormatter::CodeCell *cell = formatter.codeCell(level, record);
+    ASSERT_TRUE(cell);
+    //预先生成的各种形式和逐行转换的结果一致
+    EXPECT_EQ(cell->text, LogLevel::text(WARN));
+    EXPECT_EQ(formatter.cellText(level, record, QString()), LogLevel::text(WARN));
+    QByteArray xml;
+    LogDocxWriter::appendEscaped(xml, LogLevel::text(WARN));
+    EXPECT_EQ(cell->xml, xml);
+    EXPECT_EQ(cell->utf8, LogLevel::text(WARN).toUtf8());
+    QString html;
+    LogExportWriter::appendHtmlEscaped(html, LogLevel::text(WARN));
+    EXPECT_EQ(cell->html, html);
+
+    //超出范围的等级为空文字,其他列没有预先生成的形式
+    record.level = -1;
+    ASSERT_TRUE(formatter.codeCell(level, record));
+    EXPECT_TRUE(formatter.codeCell(level, record)->text.isEmpty());
+    EXPECT_FALSE(formatter.codeCell(LogExportTraits<LOG_MSG_JOURNAL, JOURNAL>::columns[1], record));
+}
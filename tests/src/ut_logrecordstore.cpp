@@ -0,0 +1,80 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logrecordstore.h"
+#include "structdef.h"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+qint64 timeOf(const LOG_MSG_JOURNAL &msg)
+{
+    return msg.timestamp;
+}
+
+QList<LOG_MSG_JOURNAL> journalRun(const QList<qint64> &times)
+{
+    QList<LOG_MSG_JOURNAL> list;
+    for (qint64 time : times) {
+        LOG_MSG_JOURNAL msg;
+        msg.timestamp = time;
+        msg.msg = QString::number(time);
+        list.append(msg);
+    }
+    return list;
+}
+
+QList<qint64> storeTimes(const LogRecordStore<LOG_MSG_JOURNAL> &store)
+{
+    QList<qint64> times;
+    for (int i = 0; i < store.size(); ++i)
+        times.append(store.at(i).timestamp);
+    return times;
+}
+
+} // namespace
+
+TEST(LogRecordStore_ingest_UT, LogRecordStore_ingest_UT_001)
+{
+    typedef LogRecordStore<LOG_MSG_JOURNAL> Store;
+    Store store;
+    EXPECT_EQ(store.ingest(QList<LOG_MSG_JOURNAL>(), Store::NewestFirst, timeOf), Store::Ignored);
+    EXPECT_EQ(store.ingest(journalRun({90, 80}), Store::NewestFirst, timeOf), Store::Appended);
+    //从旧到新的批次不翻转,按倒序访问
+    const QList<LOG_MSG_JOURNAL> ascending = journalRun({50, 60, 70});
+    EXPECT_EQ(store.ingest(ascending, Store::OldestFirst, timeOf), Store::Appended);
+    EXPECT_EQ(&store.at(2), &ascending.at(2));
+    EXPECT_EQ(store.ingest(journalRun({100, 95}), Store::NewestFirst, timeOf), Store::Prepended);
+    EXPECT_EQ(storeTimes(store), QList<qint64>({100, 95, 90, 80, 70, 60, 50}));
+    EXPECT_EQ(store.batchCount(), 3);
+
+    //追加单条记录写到倒序批次的末尾
+    store.append(journalRun({40}).first());
+    EXPECT_EQ(store.at(7).timestamp, 40);
+    EXPECT_EQ(store.toList().last().timestamp, 40);
+}
+
+TEST(LogRecordStore_ingest_UT, LogRecordStore_ingest_UT_002)
+{
+    typedef LogRecordStore<LOG_MSG_JOURNAL> Store;
+    Store store;
+    store.ingest(journalRun({100, 90}), Store::NewestFirst, timeOf);
+    store.ingest(journalRun({50, 70, 80}), Store::OldestFirst, timeOf);
+
+    //时间重叠的批次只和重叠的尾部归并,时间相同时已有的在前
+    int mergedFrom = -1;
+    EXPECT_EQ(store.ingest(journalRun({60, 75, 90}), Store::OldestFirst, timeOf, &mergedFrom), Store::Merged);
+    EXPECT_EQ(mergedFrom, 2);
+    EXPECT_EQ(storeTimes(store), QList<qint64>({100, 90, 90, 80, 75, 70, 60, 50}));
+    EXPECT_EQ(store.at(1).msg, QString("90"));
+    EXPECT_EQ(store.batchCount(), 2);
+    EXPECT_EQ(store.toList().size(), 8);
+
+    //重叠从第一条开始时整个存储归并为一个批次
+    EXPECT_EQ(store.ingest(journalRun({110, 55}), Store::NewestFirst, timeOf, &mergedFrom), Store::Merged);
+    EXPECT_EQ(mergedFrom, 0);
+    EXPECT_EQ(storeTimes(store), QList<qint64>({110, 100, 90, 90, 80, 75, 70, 60, 55, 50}));
+    EXPECT_EQ(store.batchCount(), 1);
+}
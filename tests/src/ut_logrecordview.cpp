@@ -0,0 +1,109 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logrecordview.h"
+#include "structdef.h"
+
+#include <gtest/gtest.h>
+
+static QList<LOG_MSG_DPKG> dpkgStore(int count)
+{
+    QList<LOG_MSG_DPKG> list;
+    for (int i = 0; i < count; ++i) {
+        LOG_MSG_DPKG dpkg;
+        dpkg.msg = QString("msg%1").arg(i);
+        list.append(dpkg);
+    }
+    return list;
+}
+
+TEST(LogRecordView_range_UT, LogRecordView_range_UT_001)
+{
+    LogRecordStore<LOG_MSG_DPKG> store(dpkgStore(10));
+    LogRecordView<LOG_MSG_DPKG> view = LogRecordView<LOG_MSG_DPKG>::range(&store, 2, 5);
+    ASSERT_EQ(view.size(), 3);
+    EXPECT_EQ(view.store(), &store);
+    EXPECT_EQ(view.at(0).msg, QString("msg2"));
+    //视图直接引用存储中的记录
+    EXPECT_EQ(&view.at(2), &store.at(4));
+
+    LogRecordView<LOG_MSG_DPKG> odd = view.withRows(QVector<quint32>() << 1 << 3);
+    view.append(odd);
+    ASSERT_EQ(view.size(), 5);
+    EXPECT_EQ(view.at(3).msg, QString("msg1"));
+    EXPECT_EQ(view.mid(3).toList().size(), 2);
+
+    //存储头部插入后修正下标
+    store.prepend(QList<LOG_MSG_DPKG>() << LOG_MSG_DPKG());
+    view.offsetRows(1);
+    EXPECT_EQ(view.at(0).msg, QString("msg2"));
+    store.clear();
+    EXPECT_EQ(view.isValid(0), false);
+}
+
+TEST(LogRecordView_insert_UT, LogRecordView_insert_UT_001)
+{
+    //从QList构造的视图持有自己的存储
+    LogRecordView<LOG_MSG_DPKG> view(dpkgStore(3));
+    ASSERT_EQ(view.size(), 3);
+    view.insert(1, LogRecordView<LOG_MSG_DPKG>(dpkgStore(2)), 0, 2);
+
+    //存储不同时合并为一份
+    const QList<LOG_MSG_DPKG> list = view.toList();
+    ASSERT_EQ(list.size(), 5);
+    EXPECT_EQ(list.at(0).msg, QString("msg0"));
+    EXPECT_EQ(list.at(1).msg, QString("msg0"));
+    EXPECT_EQ(list.at(2).msg, QString("msg1"));
+    EXPECT_EQ(list.at(3).msg, QString("msg1"));
+    EXPECT_EQ(list.at(4).msg, QString("msg2"));
+
+    view.remove(0, 4);
+    ASSERT_EQ(view.size(), 1);
+    EXPECT_EQ(view.at(0).msg, QString("msg2"));
+}
+
+TEST(LogRecordView_snapshot_UT, LogRecordView_snapshot_UT_001)
+{
+    LogRecordStore<LOG_MSG_DPKG> store(dpkgStore(4));
+    const LogRecordView<LOG_MSG_DPKG> view = LogRecordView<LOG_MSG_DPKG>::range(&store, 1, 3);
+    const LogRecordView<LOG_MSG_DPKG> snapshot = view.snapshot();
+    ASSERT_EQ(snapshot.size(), 2);
+    EXPECT_NE(snapshot.store(), &store);
+    //和原存储共享批次,记录没有复制
+    EXPECT_EQ(&snapshot.at(0), &store.at(1));
+
+    //原存储清空后快照不受影响
+    store.clear();
+    EXPECT_EQ(snapshot.isValid(1), true);
+    EXPECT_EQ(snapshot.at(1).msg, QString("msg2"));
+}
+
+TEST(LogRecordStore_append_UT, LogRecordStore_append_UT_001)
+{
+    LogRecordStore<LOG_MSG_DPKG> store;
+    const QList<LOG_MSG_DPKG> first = dpkgStore(3);
+    const QList<LOG_MSG_DPKG> second = dpkgStore(2);
+    store.append(first);
+    store.append(QList<LOG_MSG_DPKG>());
+    store.append(second);
+    ASSERT_EQ(store.size(), 5);
+    EXPECT_EQ(store.batchCount(), 2);
+    //整批收下,和发送方共享记录
+    EXPECT_EQ(&store.at(0), &first.at(0));
+    EXPECT_EQ(&store.at(4), &second.at(1));
+    EXPECT_EQ(store.at(3).msg, QString("msg0"));
+
+    store.prepend(dpkgStore(1));
+    ASSERT_EQ(store.size(), 6);
+    EXPECT_EQ(store.at(1).msg, QString("msg0"));
+    EXPECT_EQ(&store.at(5), &second.at(1));
+
+    LOG_MSG_DPKG single;
+    single.msg = "single";
+    store.append(single);
+    EXPECT_EQ(store.at(6).msg, QString("single"));
+    EXPECT_EQ(store.toList().size(), 7);
+    store.clear();
+    EXPECT_EQ(store.isEmpty(), true);
+}
@@ -0,0 +1,89 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logregex.h"
+
+#include <QRegularExpression>
+
+#include <gtest/gtest.h>
+
+TEST(LogRegex_indexIn_UT, LogRegex_indexIn_UT_001)
+{
+    const QString text = "kernel: app[1234]: SEGFAULT at 7f3a9c ip 00007f error 4";
+    LogRegex regex("segfault at [0-9a-f]+");
+    ASSERT_TRUE(regex.isValid());
+    int length = 0;
+    EXPECT_EQ(regex.indexIn(text, 0, &length), text.indexOf("SEGFAULT"));
+    EXPECT_EQ(length, QString("SEGFAULT at 7f3a9c").length());
+    EXPECT_EQ(regex.indexIn(text, 25), -1);
+
+    //分支按书写顺序优先,贪婪和非贪婪重复
+    EXPECT_EQ(LogRegex("a|ab").indexIn("ab", 0, &length), 0);
+    EXPECT_EQ(length, 1);
+    EXPECT_EQ(LogRegex("a+?").indexIn("baaa", 0, &length), 1);
+    EXPECT_EQ(length, 1);
+    EXPECT_EQ(LogRegex("(?:err|warn)ing\\b").indexIn("x WARNING", 0, &length), 2);
+    EXPECT_EQ(length, 7);
+    EXPECT_EQ(LogRegex("^ab").indexIn("cab"), -1);
+    EXPECT_EQ(LogRegex("ab$").indexIn("abab"), 2);
+    //不是合法重复次数的{按字面字符处理
+    EXPECT_EQ(LogRegex("a{,2}").indexIn("xa{,2}"), 1);
+}
+
+TEST(LogRegex_indexIn_UT, LogRegex_indexIn_UT_002)
+{
+    //回溯引擎在这里是指数时间,线性引擎直接返回
+    const QString text = QString(5000, QChar('a'));
+    EXPECT_EQ(LogRegex("(a+)+b").indexIn(text), -1);
+    EXPECT_EQ(LogRegex("(a|aa)*$").matches(text), true);
+}
+
+TEST(LogRegex_indexIn_UT, LogRegex_indexIn_UT_003)
+{
+    //和QRegularExpression的最左匹配一致
+    const char *atoms[] = {"a", "b", "c", ".", "[ab]", "[^a]", "(a|b)", "(ab|c)", "\\d", "x"};
+    const char *repeats[] = {"", "*", "+", "?", "{1,2}", "*?", "{2}"};
+    const char alphabet[] = "abcx1A";
+    quint32 seed = 7;
+    auto next = [&seed]() {
+        seed = seed * 1103515245u + 12345u;
+        return static_cast<int>((seed >> 16) & 0x7fff);
+    };
+    for (int round = 0; round < 3000; ++round) {
+        QString pattern;
+        for (int i = 1 + next() % 4; i > 0; --i)
+            pattern += QString(atoms[next() % 10]) + repeats[next() % 7];
+        QString text;
+        for (int i = next() % 12; i > 0; --i)
+            text += QChar(alphabet[next() % 6]);
+        const QRegularExpressionMatch expected = QRegularExpression(pattern, QRegularExpression::CaseInsensitiveOption).match(text);
+        int length = -1;
+        const int pos = LogRegex(pattern).indexIn(text, 0, &length);
+        ASSERT_EQ(pos, expected.hasMatch() ? expected.capturedStart() : -1) << pattern.toStdString() << " " << text.toStdString();
+        if (pos >= 0)
+            ASSERT_EQ(length, expected.capturedLength()) << pattern.toStdString() << " " << text.toStdString();
+    }
+}
+
+TEST(LogRegex_isValid_UT, LogRegex_isValid_UT_001)
+{
+    const QStringList invalid {"(a", "a)", "*a", "[a", "a{3,2}", "\\q", "\\", "(?=a)", "a{2000}"};
+    for (const QString &pattern : invalid) {
+        LogRegex regex(pattern);
+        EXPECT_FALSE(regex.isValid()) << pattern.toStdString();
+        EXPECT_FALSE(regex.errorString().isEmpty());
+        EXPECT_EQ(regex.indexIn("a(aaa"), -1);
+    }
+}
+
+TEST(LogRegex_literals_UT, LogRegex_literals_UT_001)
+{
+    //每个匹配都必须包含的字面量,长的在前
+    LogRegex regex("segfault at [0-9a-f]+ ip");
+    EXPECT_EQ(regex.literals(), QStringList() << "segfault at " << " ip");
+    EXPECT_EQ(regex.prefix(), QString("segfault at "));
+    EXPECT_EQ(LogRegex("(foo|foobar)baz").literals(), QStringList() << "foo" << "baz");
+    //可以不出现的部分不能作为预筛选条件
+    EXPECT_EQ(LogRegex("(usb)?error|warn").literals().isEmpty(), true);
+}
@@ -3,6 +3,8 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "logscrollbar.h"
+#include "logtablemodel.h"
+#include "structdef.h"
 #include <gtest/gtest.h>
 #include <stub.h>
 
@@ -33,3 +35,41 @@ TEST(LogScrollBar_mousePressEvent_UT, LogScrollBar_mousePressEvent_UT_002)
     EXPECT_EQ(p->m_isOnPress, true);
     p->deleteLater();
 }
+
+TEST(LogScrollBar_setMinimapModel_UT, LogScrollBar_setMinimapModel_UT_001)
+{
+    LogTableModel model;
+    QList<LOG_MSG_DPKG> list;
+    for (int i = 0; i < 10; ++i) {
+        LOG_MSG_DPKG msg;
+        msg.dateTime = QString("2023-05-01 12:30:%1").arg(i, 2, 10, QLatin1Char('0'));
+        list.append(msg);
+    }
+    LogRecordStore<LOG_MSG_DPKG> store(list);
+    QVector<LogTableModel::Column<LOG_MSG_DPKG>> columns;
+    columns << LogTableModel::sortKeyColumn<LOG_MSG_DPKG>([](const LOG_MSG_DPKG &msg, int role) -> QVariant {
+        return role == Qt::DisplayRole ? QVariant(msg.dateTime) : QVariant();
+    }, [](const LOG_MSG_DPKG &msg) { return LogTableModel::dateTimeKey(msg.dateTime); });
+    model.setColumns<LOG_MSG_DPKG>("ut", columns);
+
+    LogScrollBar bar(Qt::Vertical, nullptr);
+    bar.resize(12, 200);
+    bar.setMinimapModel(&model, []() { return 0; });
+    model.appendRecords(LogRecordView<LOG_MSG_DPKG>::range(&store, 0, 5));
+    bar.setMinimapHits({2, 7});
+    bar.syncMinimap();
+    EXPECT_EQ(bar.minimap().rowCount(), 5);
+    //追加的行只补齐新增部分,之前记下的命中随之计入
+    model.appendRecords(LogRecordView<LOG_MSG_DPKG>::range(&store, 5, 10));
+    bar.syncMinimap();
+    EXPECT_EQ(bar.minimap().rowCount(), 10);
+    int hits = 0;
+    for (const LogMinimap::Bucket &bucket : bar.minimap().buckets())
+        hits += bucket.hits;
+    EXPECT_EQ(hits, 2);
+    EXPECT_EQ(bar.minimap().buckets().at(1).minTime - bar.minimap().buckets().at(0).minTime, 1000);
+
+    bar.renderMinimap();
+    EXPECT_FALSE(bar.m_minimapCache.isNull());
+    EXPECT_FALSE(bar.m_minimapDirty);
+}
@@ -0,0 +1,62 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logsearchhits.h"
+#include "structdef.h"
+
+#include <gtest/gtest.h>
+
+TEST(LogSearchHits_markText_UT, LogSearchHits_markText_UT_001)
+{
+    LogSearchHits hits;
+    const LogRecordFilter::TextMatcher matcher("ab");
+    hits.markText(3, 1, "xAbyabab", matcher);
+    hits.markText(3, 2, "none", matcher);
+    hits.markText(7, 0, "ab", matcher);
+
+    //不区分大小写,没有命中的记录和列不占空间
+    EXPECT_EQ(hits.rowCount(), 2);
+    EXPECT_EQ(hits.spanCount(), 4);
+    EXPECT_EQ(hits.find(3, 1), QVector<int>() << 1 << 2 << 4 << 2 << 6 << 2);
+    EXPECT_EQ(hits.find(3, 2).isEmpty(), true);
+    EXPECT_EQ(hits.find(7, 0), QVector<int>() << 0 << 2);
+    EXPECT_EQ(hits.find(5, 0).isEmpty(), true);
+
+    //关键字为空时不记录
+    LogSearchHits empty;
+    empty.markText(0, 0, "ab", LogRecordFilter::TextMatcher());
+    EXPECT_EQ(empty.isEmpty(), true);
+}
+
+TEST(LogSearchHits_markText_UT, LogSearchHits_markText_UT_002)
+{
+    //正则模式下每处命中的长度不同,空匹配不记录
+    LogSearchHits hits;
+    hits.markText(0, 1, "id=12 id=3456", LogRecordFilter::TextMatcher("id=\\d+", LogRecordFilter::TextMatcher::Regex));
+    hits.markText(1, 1, "abc", LogRecordFilter::TextMatcher("x*", LogRecordFilter::TextMatcher::Regex));
+    EXPECT_EQ(hits.find(0, 1), QVector<int>() << 0 << 5 << 6 << 7);
+    EXPECT_EQ(hits.find(1, 1).isEmpty(), true);
+}
+
+TEST(LogSearchHits_append_UT, LogSearchHits_append_UT_001)
+{
+    const LogRecordFilter::TextMatcher matcher("msg");
+    const LogSearchHits::Fields<LOG_MSG_DPKG> fields {{0, &LOG_MSG_DPKG::dateTime}, {1, &LOG_MSG_DPKG::msg}};
+    LOG_MSG_DPKG record;
+    record.dateTime = "2023-01-01";
+    record.msg = "first msg, second msg";
+
+    LogSearchHits first;
+    first.markRecord(2, record, fields, matcher);
+    LogSearchHits second;
+    second.markRecord(10, record, fields, matcher);
+    first.append(second);
+
+    EXPECT_EQ(first.rowCount(), 2);
+    EXPECT_EQ(first.find(2, 1), QVector<int>() << 6 << 3 << 18 << 3);
+    EXPECT_EQ(first.find(10, 1), QVector<int>() << 6 << 3 << 18 << 3);
+    EXPECT_EQ(first.find(10, 0).isEmpty(), true);
+    first.clear();
+    EXPECT_EQ(first.isEmpty(), true);
+}
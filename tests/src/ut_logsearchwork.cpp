@@ -0,0 +1,108 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logsearchwork.h"
+
+#include <gtest/gtest.h>
+
+TEST(LogSearchWork_run_UT, LogSearchWork_run_UT_001)
+{
+    std::shared_ptr<std::atomic_bool> canRun = std::make_shared<std::atomic_bool>(true);
+    LogSearchWork work(5000, [](int row) { return row % 2 == 0; }, canRun);
+    work.setAutoDelete(false);
+
+    QVector<int> rows;
+    int batches = 0;
+    bool finished = false;
+    QObject::connect(&work, &LogSearchWork::searchData, [&](int index, QVector<int> batch, int scanned) {
+        EXPECT_EQ(index, work.getIndex());
+        EXPECT_GT(scanned, batch.last());
+        rows += batch;
+        ++batches;
+    });
+    QObject::connect(&work, &LogSearchWork::searchFinished, [&](int index) {
+        EXPECT_EQ(index, work.getIndex());
+        finished = true;
+    });
+    work.run();
+
+    //匹配结果分批发出,合起来按顺序覆盖所有匹配
+    ASSERT_EQ(rows.size(), 2500);
+    EXPECT_EQ(rows.first(), 0);
+    EXPECT_EQ(rows.last(), 4998);
+    EXPECT_GE(batches, 3);
+    EXPECT_EQ(finished, true);
+}
+
+TEST(LogSearchWork_run_UT, LogSearchWork_run_UT_002)
+{
+    std::shared_ptr<std::atomic_bool> canRun = std::make_shared<std::atomic_bool>(true);
+    int scanned = 0;
+    //扫描中途被新的搜索取消
+    LogSearchWork work(10000, [&](int row) {
+        ++scanned;
+        if (row == 10)
+            *canRun = false;
+        return true;
+    }, canRun);
+    work.setAutoDelete(false);
+
+    bool finished = false;
+    QObject::connect(&work, &LogSearchWork::searchFinished, [&](int) { finished = true; });
+    work.run();
+
+    EXPECT_EQ(scanned, 11);
+    EXPECT_EQ(finished, false);
+
+    LogSearchWork next(0, LogSearchWork::Matcher(), canRun);
+    EXPECT_GT(next.getIndex(), work.getIndex());
+}
+
+TEST(LogSearchWork_run_UT, LogSearchWork_run_UT_003)
+{
+    std::shared_ptr<std::atomic_bool> canRun = std::make_shared<std::atomic_bool>(true);
+    QVector<int> checked;
+    LogSearchWork work(100, [&](int row) {
+        checked.append(row);
+        return row > 50;
+    }, canRun);
+    work.setAutoDelete(false);
+    //只在候选下标中搜索
+    work.setCandidates(QVector<int>() << 3 << 40 << 60 << 99);
+
+    QVector<int> rows;
+    int lastScanned = 0;
+    QObject::connect(&work, &LogSearchWork::searchData, [&](int, QVector<int> batch, int scanned) {
+        rows += batch;
+        lastScanned = scanned;
+    });
+    work.run();
+
+    EXPECT_EQ(checked, QVector<int>() << 3 << 40 << 60 << 99);
+    EXPECT_EQ(rows, QVector<int>() << 60 << 99);
+    EXPECT_EQ(lastScanned, 4);
+}
+
+TEST(LogSearchWork_run_UT, LogSearchWork_run_UT_004)
+{
+    std::shared_ptr<std::atomic_bool> canRun = std::make_shared<std::atomic_bool>(true);
+    LogSearchWork work(10, [](int row) { return row % 5 == 0; }, canRun);
+    work.setAutoDelete(false);
+    //只对匹配的记录记下位置
+    QVector<int> marked;
+    work.setMarker([&](int row, LogSearchHits &hits) {
+        marked.append(row);
+        hits.markText(row, 0, "key", LogRecordFilter::TextMatcher("key"));
+    });
+
+    LogSearchHits hits;
+    QObject::connect(&work, &LogSearchWork::searchData, [&](int, QVector<int>, int, LogSearchHits batch) {
+        hits.append(batch);
+    });
+    work.run();
+
+    EXPECT_EQ(marked, QVector<int>() << 0 << 5);
+    EXPECT_EQ(hits.rowCount(), 2);
+    EXPECT_EQ(hits.find(5, 0), QVector<int>() << 0 << 3);
+}
@@ -0,0 +1,162 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logsegmentcache.h"
+#include "logrecordbatch.h"
+
+#include <QFile>
+#include <QTemporaryDir>
+
+#include <gtest/gtest.h>
+
+class LogSegmentCache_UT : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        ASSERT_TRUE(m_dir.isValid());
+        m_path = m_dir.filePath("kern.log");
+        QFile file(m_path);
+        ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+        while (file.size() < LOG_SEGMENT_MIN_SIZE)
+            file.write("Jul 01 00:00:00 host kernel: padding padding padding padding\n");
+        file.close();
+        m_content = readContent();
+    }
+    void TearDown() override
+    {
+        QFile::remove(LogSegmentCache(m_path, LogRecordBatch::KernFormat).segmentPath());
+    }
+
+    QByteArray readContent() const
+    {
+        QFile file(m_path);
+        return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+    }
+
+    //写入两条记录,时间分别为2000和1000
+    void writeSegment()
+    {
+        LogSegmentCache cache(m_path, LogRecordBatch::KernFormat);
+        EXPECT_FALSE(cache.open());
+        ASSERT_TRUE(cache.shouldWrite(m_content.size()));
+        ASSERT_TRUE(cache.beginWrite(m_content.constData(), m_content.size()));
+        cache.append(2000, QStringList() << "Jul 01 00:00:02" << "host" << "kernel" << "" << "newer");
+        cache.append(1000, QStringList() << "Jul 01 00:00:01" << "host" << "kernel" << "" << "older");
+        ASSERT_TRUE(cache.finishWrite());
+    }
+
+    QTemporaryDir m_dir;
+    QString m_path;
+    QByteArray m_content;
+};
+
+TEST_F(LogSegmentCache_UT, LogSegmentCache_replay_UT_001)
+{
+    writeSegment();
+    LogSegmentCache cache(m_path, LogRecordBatch::KernFormat);
+    ASSERT_TRUE(cache.open());
+    EXPECT_FALSE(cache.isImmutable());
+    ASSERT_TRUE(cache.matches(m_content.constData(), m_content.size()));
+    EXPECT_EQ(cache.coveredBytes(), m_content.size());
+    EXPECT_EQ(cache.recordCount(), 2);
+
+    std::atomic_bool canRun(true);
+    QStringList messages;
+    EXPECT_TRUE(cache.replay(canRun, LogLineFilter(), [&messages](qint64, const QStringList &columns) {
+        messages.append(columns.last());
+        return true;
+    }));
+    EXPECT_EQ(messages, QStringList() << "newer" << "older");
+
+    //有时间段筛选时跳过范围外的记录
+    LogLineFilter filter;
+    filter.timeBegin = 1500;
+    filter.timeEnd = 2500;
+    messages.clear();
+    EXPECT_TRUE(cache.replay(canRun, filter, [&messages](qint64, const QStringList &columns) {
+        messages.append(columns.last());
+        return true;
+    }));
+    EXPECT_EQ(messages, QStringList() << "newer");
+}
+
+TEST_F(LogSegmentCache_UT, LogSegmentCache_matches_UT_001)
+{
+    writeSegment();
+    LogSegmentCache cache(m_path, LogRecordBatch::KernFormat);
+    ASSERT_TRUE(cache.open());
+    //尾部新增的内容不多时不重写
+    const QByteArray grown = m_content + "Jul 01 00:00:01 host kernel: tail\n";
+    EXPECT_TRUE(cache.matches(grown.constData(), grown.size()));
+    EXPECT_FALSE(cache.shouldWrite(grown.size()));
+
+    //开头被改写时段失效并被删除
+    QByteArray rewritten = m_content;
+    rewritten[0] = 'A';
+    EXPECT_FALSE(cache.matches(rewritten.constData(), rewritten.size()));
+    EXPECT_FALSE(cache.isValid());
+    EXPECT_FALSE(QFile::exists(cache.segmentPath()));
+}
+
+TEST_F(LogSegmentCache_UT, LogSegmentCache_matches_UT_002)
+{
+    //只给出开头的字节和内容长度时和整段内容的结果一致
+    writeSegment();
+    LogSegmentCache cache(m_path, LogRecordBatch::KernFormat);
+    ASSERT_TRUE(cache.open());
+    const QByteArray grown = m_content + "Jul 01 00:00:01 host kernel: tail\n";
+    EXPECT_TRUE(cache.matches(grown.left(LOG_SEGMENT_HEAD_SIZE), grown.size()));
+    //开头的字节数不对时不匹配
+    EXPECT_FALSE(cache.matches(grown.left(1), grown.size()));
+    EXPECT_FALSE(cache.isValid());
+
+    LogSegmentCache writer(m_path, LogRecordBatch::KernFormat);
+    EXPECT_FALSE(writer.beginWrite(grown.left(LOG_SEGMENT_HEAD_SIZE), grown.size(), false));
+    EXPECT_TRUE(writer.beginWrite(grown.left(LOG_SEGMENT_HEAD_SIZE), grown.size(), true));
+    writer.abortWrite();
+}
+
+TEST_F(LogSegmentCache_UT, LogSegmentCache_replay_UT_002)
+{
+    LogSegmentCache cache(m_path, LogRecordBatch::KernFormat);
+    ASSERT_TRUE(cache.beginWrite(m_content.constData(), m_content.size()));
+    //第一块只有普通记录,第二块有要查找的记录
+    for (int i = 0; i < LOG_SEGMENT_BLOCK_ROWS; ++i)
+        cache.append(i, QStringList() << "Jul 01 00:00:00" << "host" << "kernel" << "" << "usb device connected");
+    cache.append(-1, QStringList() << "Jul 01 00:00:00" << "host" << "kernel" << "" << "mount 3f2b9c1e failed");
+    ASSERT_TRUE(cache.finishWrite());
+
+    LogSegmentCache reader(m_path, LogRecordBatch::KernFormat);
+    ASSERT_TRUE(reader.open());
+    ASSERT_TRUE(reader.matches(m_content.constData(), m_content.size()));
+    EXPECT_EQ(reader.blockCount(), 2);
+
+    std::atomic_bool canRun(true);
+    LogLineFilter filter;
+    filter.keyword = "3F2B9C1E";
+    int count = 0;
+    EXPECT_TRUE(reader.replay(canRun, filter, [&count](qint64, const QStringList &) {
+        ++count;
+        return true;
+    }));
+    EXPECT_EQ(reader.skippedBlocks(), 1);
+    EXPECT_EQ(count, 1);
+}
+
+TEST(LogSegmentCache_beginWrite_UT, LogSegmentCache_beginWrite_UT_001)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    const QString path = dir.filePath("dpkg.log");
+    QFile file(path);
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    file.write("2023-07-01 00:00:00 status installed\npartial");
+    file.close();
+
+    //最后一行没有写完时不写入
+    const QByteArray content("2023-07-01 00:00:00 status installed\npartial");
+    LogSegmentCache cache(path, LogRecordBatch::DpkgFormat);
+    EXPECT_FALSE(cache.beginWrite(content.constData(), content.size()));
+}
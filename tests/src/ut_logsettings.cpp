@@ -32,3 +32,16 @@ TEST(LogSettings_saveConfigWinSize_UT, LogSettings_saveConfigWinSize_UT_001)
     p->saveConfigWinSize(100, 200);
     p->deleteLater();
 }
+
+TEST(LogSettings_frequentCategories_UT, LogSettings_frequentCategories_UT_001)
+{
+    LogSettings *p = new LogSettings(nullptr);
+    p->addCategoryVisit("ut_rare");
+    for (int i = 0; i < 1000; ++i)
+        p->addCategoryVisit("ut_frequent");
+    const QStringList categories = p->frequentCategories(100);
+    EXPECT_EQ(categories.contains("ut_rare"), true);
+    EXPECT_LT(categories.indexOf("ut_frequent"), categories.indexOf("ut_rare"));
+    EXPECT_LE(p->frequentCategories(1).size(), 1);
+    p->deleteLater();
+}
@@ -0,0 +1,110 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logsharedring.h"
+
+#include <QList>
+#include <QSharedMemory>
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+TEST(LogSharedRing_readLines_UT, LogSharedRing_readLines_UT_001)
+{
+    LogSharedRing reader(LogSharedRing::uniqueKey());
+    //数据区比一行还小,行会跨越缓冲区末尾
+    ASSERT_TRUE(reader.create(16));
+
+    QList<QByteArray> expected;
+    QByteArray data;
+    for (int i = 0; i < 100; ++i) {
+        const QByteArray line = "line " + QByteArray::number(i) + QByteArray(i % 23, 'x');
+        expected << line;
+        data += line + '\n';
+    }
+    data += "last";
+    expected << "last";
+
+    std::thread writer([&]() {
+        LogSharedRing ring(reader.key());
+        ASSERT_TRUE(ring.attach());
+        const char *pos = data.constData();
+        qint64 left = data.size();
+        while (left > 0) {
+            //每次只提交几个字节,模拟分多次read
+            const qint64 count = qMin<qint64>(left, 7);
+            ASSERT_TRUE(ring.write(pos, count, LogSharedRing::CanRun()));
+            pos += count;
+            left -= count;
+        }
+        ring.finish(true);
+    });
+
+    QList<QByteArray> lines;
+    const bool completed = reader.readLines([&](const QByteArray &line) {
+        lines << QByteArray(line.constData(), line.size());
+        return true;
+    }, LogSharedRing::CanRun());
+    writer.join();
+
+    EXPECT_TRUE(completed);
+    EXPECT_EQ(lines, expected);
+    EXPECT_EQ(reader.state(), LogSharedRing::Finished);
+}
+
+TEST(LogSharedRing_cancel_UT, LogSharedRing_cancel_UT_001)
+{
+    LogSharedRing reader(LogSharedRing::uniqueKey());
+    ASSERT_TRUE(reader.create(8));
+
+    bool written = true;
+    std::thread writer([&]() {
+        LogSharedRing ring(reader.key());
+        ASSERT_TRUE(ring.attach());
+        const QByteArray data(1024, 'a');
+        written = ring.write(data.constData(), data.size(), LogSharedRing::CanRun());
+    });
+
+    //读取方停止后写入方不再等待空间
+    int chunks = 0;
+    EXPECT_FALSE(reader.read([&](const char *, qint64) {
+        return ++chunks < 2;
+    }, LogSharedRing::CanRun()));
+    writer.join();
+    EXPECT_FALSE(written);
+    EXPECT_EQ(reader.state(), LogSharedRing::Cancelled);
+}
+
+TEST(LogSharedRing_attach_UT, LogSharedRing_attach_UT_001)
+{
+    //没有创建的通道连接失败
+    LogSharedRing ring(LogSharedRing::uniqueKey());
+    EXPECT_FALSE(ring.attach());
+    EXPECT_FALSE(ring.read(LogSharedRing::ChunkHandler(), LogSharedRing::CanRun()));
+}
+
+TEST(LogSharedRing_writeBuffer_UT, LogSharedRing_writeBuffer_UT_001)
+{
+    LogSharedRing reader(LogSharedRing::uniqueKey());
+    ASSERT_TRUE(reader.create(16));
+    LogSharedRing writer(reader.key());
+    ASSERT_TRUE(writer.attach());
+
+    //attach之后改写共享内存中的容量,写入方仍按attach时的容量写入
+    QSharedMemory raw(reader.key());
+    ASSERT_TRUE(raw.attach());
+    qint64 *fields = reinterpret_cast<qint64 *>(static_cast<char *>(raw.data()) + 8);
+    fields[0] = 1 << 30;
+    qint64 available = 0;
+    ASSERT_NE(writer.writeBuffer(available, LogSharedRing::CanRun()), nullptr);
+    EXPECT_EQ(available, 16);
+    EXPECT_EQ(writer.capacity(), 16);
+    writer.commit(4);
+
+    //读取位置超过写入位置时按通道损坏结束
+    fields[2] = 100;
+    EXPECT_EQ(writer.writeBuffer(available, LogSharedRing::CanRun()), nullptr);
+    EXPECT_EQ(reader.state(), LogSharedRing::Failed);
+}
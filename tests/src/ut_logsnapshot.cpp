@@ -0,0 +1,100 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logsnapshot.h"
+
+#include <gtest/gtest.h>
+
+#include <QFile>
+#include <QTemporaryDir>
+
+namespace {
+QList<LOG_MSG_DPKG> dpkgBatch(int count, const QString &msg = "msg")
+{
+    QList<LOG_MSG_DPKG> batch;
+    for (int i = 0; i < count; ++i) {
+        LOG_MSG_DPKG record;
+        record.dateTime = "2023-01-01 00:00:00";
+        record.action = "install";
+        record.msg = msg + QString::number(i);
+        batch.append(record);
+    }
+    return batch;
+}
+
+LogCacheValidity fileValidity()
+{
+    LogFileStat stat;
+    stat.path = "/var/log/dpkg.log";
+    stat.exists = true;
+    stat.size = 100;
+    LogCacheValidity validity;
+    validity.files.append(stat);
+    return validity;
+}
+}
+
+TEST(LogSnapshot_save_UT, LogSnapshot_save_UT_001)
+{
+    QTemporaryDir dir;
+    ASSERT_EQ(dir.isValid(), true);
+    const QString path = dir.filePath("test" LOG_SNAPSHOT_SUFFIX);
+
+    LogCacheRange range;
+    range.begin = 10;
+    range.end = 20;
+    LogCategoryCache cache;
+    cache.begin("dpkg:10:20", 1, fileValidity(), "dpkg", range);
+    cache.collect(1, dpkgBatch(2));
+    cache.collect(1, dpkgBatch(1, "tail"));
+    cache.finish(1);
+    ASSERT_EQ(LogSnapshot::save(path, cache.snapshotEntries()), true);
+    //导出时压缩的是副本,缓存本身不变
+    EXPECT_EQ(cache.compressedCount(), 0);
+
+    QList<LogCategoryCache::SnapshotEntry> entries;
+    ASSERT_EQ(LogSnapshot::load(path, &entries), true);
+    ASSERT_EQ(entries.size(), 1);
+    EXPECT_EQ(entries.first().type, QByteArray("dpkg"));
+    EXPECT_EQ(entries.first().count, 3);
+    EXPECT_EQ(entries.first().range.end, 20);
+
+    //导入的类别保持压缩,不校验来源文件
+    LogCategoryCache opened;
+    EXPECT_EQ(opened.importSnapshot(entries), 1);
+    EXPECT_EQ(opened.compressedCount(), 1);
+    QVector<QList<LOG_MSG_DPKG>> batches;
+    ASSERT_EQ(opened.find("dpkg:10:20", LogCacheValidity(), &batches), true);
+    ASSERT_EQ(batches.size(), 2);
+    EXPECT_EQ(batches.at(0).at(1).msg, QString("msg1"));
+    EXPECT_EQ(batches.at(1).first().msg, QString("tail0"));
+    EXPECT_EQ(opened.compressedCount(), 0);
+}
+
+TEST(LogSnapshot_load_UT, LogSnapshot_load_UT_001)
+{
+    QTemporaryDir dir;
+    ASSERT_EQ(dir.isValid(), true);
+    const QString path = dir.filePath("bad" LOG_SNAPSHOT_SUFFIX);
+    QList<LogCategoryCache::SnapshotEntry> entries;
+    EXPECT_EQ(LogSnapshot::load(path, &entries), false);
+
+    QFile file(path);
+    ASSERT_EQ(file.open(QIODevice::WriteOnly), true);
+    file.write("not a snapshot file at all");
+    file.close();
+    EXPECT_EQ(LogSnapshot::load(path, &entries), false);
+    EXPECT_EQ(entries.isEmpty(), true);
+
+    //类别表被截断
+    LogCategoryCache cache;
+    cache.begin("dpkg", 1, fileValidity());
+    cache.collect(1, dpkgBatch(2));
+    cache.finish(1);
+    ASSERT_EQ(LogSnapshot::save(path, cache.snapshotEntries()), true);
+    ASSERT_EQ(file.open(QIODevice::ReadWrite), true);
+    file.resize(file.size() - 4);
+    file.close();
+    EXPECT_EQ(LogSnapshot::load(path, &entries), false);
+}
@@ -0,0 +1,57 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logstringpool.h"
+
+#include <gtest/gtest.h>
+
+#include <string.h>
+
+static QString upperDecoder(const char *data, size_t length)
+{
+    return QString::fromUtf8(data, static_cast<int>(length)).toUpper();
+}
+
+TEST(LogStringPool_intern_UT, LogStringPool_intern_UT_001)
+{
+    LogStringPool pool;
+    QString first = pool.intern(QString("systemd"));
+    QString second = pool.intern(QString("system") + "d");
+    EXPECT_EQ(second, QString("systemd"));
+    //相同的值共用同一份字符数据
+    EXPECT_EQ(first.constData(), second.constData());
+    EXPECT_EQ(pool.size(), 1);
+    EXPECT_EQ(pool.intern(QString()).isEmpty(), true);
+    EXPECT_EQ(pool.size(), 1);
+}
+
+TEST(LogStringPool_intern_UT, LogStringPool_intern_UT_002)
+{
+    LogStringPool pool;
+    char buffer[] = "kernel";
+    QString first = pool.intern(buffer, strlen(buffer), upperDecoder);
+    EXPECT_EQ(first, QString("KERNEL"));
+    //原始字节被深拷贝,调用方的缓冲区可以复用
+    memcpy(buffer, "dbusd!", sizeof(buffer));
+    EXPECT_EQ(pool.intern(buffer, strlen(buffer), upperDecoder), QString("DBUSD!"));
+    memcpy(buffer, "kernel", sizeof(buffer));
+    QString second = pool.intern(buffer, strlen(buffer), upperDecoder);
+    EXPECT_EQ(first.constData(), second.constData());
+    //解码结果和按字符串收录的值共用
+    EXPECT_EQ(pool.intern(QString("KERNEL")).constData(), first.constData());
+    EXPECT_EQ(pool.intern("dbus", 4, nullptr), QString("dbus"));
+}
+
+TEST(LogStringPool_intern_UT, LogStringPool_intern_UT_003)
+{
+    //超过上限后不再收录,但仍返回正确的值
+    LogStringPool pool(2);
+    pool.intern(QString("a"));
+    pool.intern(QString("b"));
+    QString c = pool.intern(QString("c"));
+    EXPECT_EQ(c, QString("c"));
+    EXPECT_EQ(pool.size(), 2);
+    pool.clear();
+    EXPECT_EQ(pool.size(), 0);
+}
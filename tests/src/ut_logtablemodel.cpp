@@ -0,0 +1,198 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logtablemodel.h"
+#include "structdef.h"
+
+#include <gtest/gtest.h>
+
+static QVector<LogTableModel::Column<LOG_MSG_DPKG>> dpkgColumns()
+{
+    return {
+        [](const LOG_MSG_DPKG &record, int role) -> QVariant {
+            return role == Qt::DisplayRole ? QVariant(record.dateTime) : QVariant();
+        },
+        [](const LOG_MSG_DPKG &record, int role) -> QVariant {
+            return role == Qt::DisplayRole ? QVariant(record.msg) : QVariant();
+        }
+    };
+}
+
+static QList<LOG_MSG_DPKG> dpkgList(int count)
+{
+    QList<LOG_MSG_DPKG> list;
+    for (int i = 0; i < count; ++i) {
+        LOG_MSG_DPKG dpkg;
+        dpkg.dateTime = QString::number(i);
+        dpkg.msg = QString("msg%1").arg(i);
+        list.append(dpkg);
+    }
+    return list;
+}
+
+TEST(LogTableModel_data_UT, LogTableModel_data_UT_001)
+{
+    LogTableModel model;
+    model.setHorizontalHeaderLabels(QStringList() << "Date and Time" << "Info");
+    model.setColumns(DPKG_TABLE_DATA, dpkgColumns());
+    model.appendRecords(dpkgList(3));
+
+    ASSERT_EQ(model.rowCount(), 3);
+    EXPECT_EQ(model.columnCount(), 2);
+    EXPECT_EQ(model.headerData(1, Qt::Horizontal).toString(), QString("Info"));
+    EXPECT_EQ(model.index(2, 1).data().toString(), QString("msg2"));
+    EXPECT_EQ(model.index(0, 0).data(Qt::UserRole + 1).toString(), QString(DPKG_TABLE_DATA));
+    EXPECT_EQ(model.index(1, 1).data(Qt::AccessibleTextRole).toString(), QString("treeview_context_1_1"));
+    EXPECT_EQ(model.index(1, 1).data(Qt::DecorationRole).isValid(), false);
+}
+
+TEST(LogTableModel_setData_UT, LogTableModel_setData_UT_001)
+{
+    LogTableModel model;
+    model.setHorizontalHeaderLabels(QStringList() << "Date and Time" << "Info");
+    model.setColumns(DPKG_TABLE_DATA, dpkgColumns());
+    model.appendRecords(dpkgList(3));
+
+    EXPECT_EQ(model.setData(model.index(1, 1), "full msg1"), true);
+    EXPECT_EQ(model.index(1, 1).data().toString(), QString("full msg1"));
+
+    //插入和删除行后覆盖的数据跟随所在的记录
+    model.insertRecords(0, dpkgList(2));
+    EXPECT_EQ(model.index(3, 1).data().toString(), QString("full msg1"));
+    EXPECT_EQ(model.removeRows(0, 3), true);
+    EXPECT_EQ(model.rowCount(), 2);
+    EXPECT_EQ(model.index(0, 1).data().toString(), QString("full msg1"));
+
+    EXPECT_EQ(model.setData(model.index(0, 1), QVariant()), true);
+    EXPECT_EQ(model.index(0, 1).data().toString(), QString("msg1"));
+}
+
+TEST(LogTableModel_setColumns_UT, LogTableModel_setColumns_UT_001)
+{
+    LogTableModel model;
+    model.setHorizontalHeaderLabels(QStringList() << "Date and Time" << "Info");
+    model.setColumns(DPKG_TABLE_DATA, dpkgColumns());
+    model.appendRecords(dpkgList(2));
+
+    //同类型同表格标记时保留记录,便于分页追加
+    model.setColumns(DPKG_TABLE_DATA, dpkgColumns());
+    model.insertRecords(-1, dpkgList(5), 2, 4);
+    ASSERT_EQ(model.rowCount(), 4);
+    EXPECT_EQ(model.index(3, 0).data().toString(), QString("3"));
+
+    model.setColumns(KERN_TABLE_DATA, dpkgColumns());
+    EXPECT_EQ(model.rowCount(), 0);
+
+    //记录类型不一致时忽略
+    model.insertRecords(-1, QList<LOG_MSG_BOOT>() << LOG_MSG_BOOT());
+    EXPECT_EQ(model.rowCount(), 0);
+
+    model.clear();
+    EXPECT_EQ(model.columnCount(), 0);
+    EXPECT_EQ(model.index(0, 0).isValid(), false);
+}
+
+TEST(LogTableModel_insertRecords_UT, LogTableModel_insertRecords_UT_001)
+{
+    LogTableModel model;
+    model.setHorizontalHeaderLabels(QStringList() << "Date and Time" << "Info");
+    model.setColumns(DPKG_TABLE_DATA, dpkgColumns());
+
+    //整表加载后再追加后续批次
+    model.insertRecords(0, dpkgList(1000));
+    model.appendRecords(dpkgList(2));
+    ASSERT_EQ(model.rowCount(), 1002);
+    EXPECT_EQ(model.index(999, 1).data().toString(), QString("msg999"));
+    EXPECT_EQ(model.index(1001, 1).data().toString(), QString("msg1"));
+
+    //部分范围的插入
+    model.insertRecords(0, dpkgList(10), 8, 10);
+    ASSERT_EQ(model.rowCount(), 1004);
+    EXPECT_EQ(model.index(0, 1).data().toString(), QString("msg8"));
+    EXPECT_EQ(model.index(2, 1).data().toString(), QString("msg0"));
+}
+
+TEST(LogTableModel_insertRecords_UT, LogTableModel_insertRecords_UT_002)
+{
+    LogTableModel model;
+    model.setHorizontalHeaderLabels(QStringList() << "Date and Time" << "Info");
+    model.setColumns(DPKG_TABLE_DATA, dpkgColumns());
+
+    //按下标引用调用方的存储
+    LogRecordStore<LOG_MSG_DPKG> store(dpkgList(4));
+    model.appendRecords(LogRecordView<LOG_MSG_DPKG>::range(&store, 1, 4));
+    ASSERT_EQ(model.rowCount(), 3);
+    EXPECT_EQ(model.index(0, 1).data().toString(), QString("msg1"));
+
+    store.prepend(dpkgList(2));
+    model.offsetRecords<LOG_MSG_DPKG>(2);
+    model.insertRecords(0, LogRecordView<LOG_MSG_DPKG>::range(&store, 0, 2));
+    ASSERT_EQ(model.rowCount(), 5);
+    EXPECT_EQ(model.index(1, 1).data().toString(), QString("msg1"));
+    EXPECT_EQ(model.index(2, 1).data().toString(), QString("msg1"));
+    EXPECT_EQ(model.index(4, 1).data().toString(), QString("msg3"));
+
+    //存储被清空后不再读取记录
+    store.clear();
+    EXPECT_EQ(model.index(0, 1).data().isValid(), false);
+}
+
+TEST(LogTableModel_sort_UT, LogTableModel_sort_UT_001)
+{
+    LogTableModel model;
+    model.setHorizontalHeaderLabels(QStringList() << "Date and Time" << "Info");
+    QVector<LogTableModel::Column<LOG_MSG_DPKG>> columns = dpkgColumns();
+    //时间列按数值排序,奇偶相同的记录键相等
+    columns[0] = LogTableModel::sortKeyColumn<LOG_MSG_DPKG>(columns[0], [](const LOG_MSG_DPKG &record) -> qint64 {
+        return record.dateTime.toInt() % 2;
+    });
+    model.setColumns(DPKG_TABLE_DATA, columns);
+    model.appendRecords(dpkgList(5));
+    EXPECT_EQ(model.setData(model.index(1, 1), "full msg1"), true);
+
+    model.sort(0, Qt::AscendingOrder);
+    ASSERT_EQ(model.rowCount(), 5);
+    //键相等的记录保持原有顺序
+    QStringList order;
+    for (int row = 0; row < model.rowCount(); ++row)
+        order << model.index(row, 0).data().toString();
+    EXPECT_EQ(order, QStringList() << "0" << "2" << "4" << "1" << "3");
+    //覆盖的数据跟随记录移动
+    EXPECT_EQ(model.index(3, 1).data().toString(), QString("full msg1"));
+
+    model.sort(0, Qt::DescendingOrder);
+    EXPECT_EQ(model.index(0, 0).data().toString(), QString("1"));
+    EXPECT_EQ(model.index(2, 0).data().toString(), QString("0"));
+
+    //没有排序键的列按显示文字排序
+    model.sort(1, Qt::DescendingOrder);
+    EXPECT_EQ(model.index(0, 1).data().toString(), QString("msg4"));
+    EXPECT_EQ(model.index(4, 1).data().toString(), QString("full msg1"));
+
+    EXPECT_EQ(LogTableModel::dateTimeKey("2023-01-02 03:04:05"), 20230102030405);
+    EXPECT_EQ(LogTableModel::dateTimeKey(""), -1);
+}
+
+TEST(LogTableModel_setSearchHits_UT, LogTableModel_setSearchHits_UT_001)
+{
+    LogTableModel model;
+    model.setHorizontalHeaderLabels(QStringList() << "Date and Time" << "Info");
+    model.setColumns(DPKG_TABLE_DATA, dpkgColumns());
+    model.appendRecords(dpkgList(3));
+    EXPECT_EQ(model.index(2, 1).data(LogTableModel::SearchHitsRole).isValid(), false);
+
+    std::shared_ptr<LogSearchHits> hits = std::make_shared<LogSearchHits>();
+    hits->markText(2, 1, "msg2", LogRecordFilter::TextMatcher("2"));
+    model.setSearchHits(hits);
+    EXPECT_EQ(model.index(2, 1).data(LogTableModel::SearchHitsRole).value<QVector<int>>(), QVector<int>() << 3 << 1);
+    EXPECT_EQ(model.index(2, 0).data(LogTableModel::SearchHitsRole).isValid(), false);
+
+    //按记录下标查找,排序后跟随记录
+    model.sort(1, Qt::DescendingOrder);
+    EXPECT_EQ(model.index(0, 1).data(LogTableModel::SearchHitsRole).value<QVector<int>>(), QVector<int>() << 3 << 1);
+    EXPECT_EQ(model.index(2, 1).data(LogTableModel::SearchHitsRole).isValid(), false);
+
+    model.clear();
+    EXPECT_EQ(model.rowCount(), 0);
+}
@@ -0,0 +1,88 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logtemplateminer.h"
+
+#include <gtest/gtest.h>
+
+TEST(LogTemplateMiner_add_UT, LogTemplateMiner_add_UT_001)
+{
+    LogTemplateMiner miner;
+    QStringList params;
+    const int first = miner.add("Accepted password for root from 10.0.0.1 port 22 ssh2", &params);
+    //含数字的词直接作为参数
+    EXPECT_EQ(miner.templateText(first), QString("Accepted password for root from <*> port <*> <*>"));
+    EXPECT_EQ(params, QStringList() << "10.0.0.1" << "22" << "ssh2");
+
+    //不同的词改为参数,生成新的模板,旧模板不变
+    const int second = miner.add("Accepted password for admin from 10.0.0.2 port 2222 ssh2", &params);
+    EXPECT_NE(second, first);
+    EXPECT_EQ(miner.templateText(second), QString("Accepted password for <*> from <*> port <*> <*>"));
+    EXPECT_EQ(miner.templateText(first), QString("Accepted password for root from <*> port <*> <*>"));
+    EXPECT_EQ(miner.groupOf(first), miner.groupOf(second));
+    EXPECT_EQ(miner.render(second, params), QString("Accepted password for admin from 10.0.0.2 port 2222 ssh2"));
+
+    //词数不同或相同的词太少时是另一组
+    miner.add("Accepted password for root");
+    miner.add("Failed publickey of nobody to 10.0.0.3 port 22 abc");
+    EXPECT_EQ(miner.groupCount(), 3);
+}
+
+TEST(LogTemplateMiner_groups_UT, LogTemplateMiner_groups_UT_001)
+{
+    LogTemplateMiner miner;
+    miner.add("usb 1-1: new high-speed USB device number 3");
+    miner.add("eth0: link up");
+    miner.add("usb 1-2: new high-speed USB device number 4");
+    miner.add("usb 1-1: new high-speed USB device number 5");
+    //全部是参数的信息也归为一组
+    miner.add("12 34");
+    miner.add("56 78");
+
+    const QVector<LogTemplateGroup> groups = miner.groups();
+    ASSERT_EQ(groups.size(), 3);
+    EXPECT_EQ(groups.at(0).pattern, QString("usb <*> new high-speed USB device number <*>"));
+    EXPECT_EQ(groups.at(0).count, 3);
+    EXPECT_EQ(groups.at(0).first, 0);
+    EXPECT_EQ(groups.at(1).count, 1);
+    EXPECT_EQ(groups.at(1).first, 1);
+    EXPECT_EQ(groups.at(2).count, 2);
+    EXPECT_EQ(groups.at(2).first, 4);
+}
+
+TEST(LogTemplatedMessages_text_UT, LogTemplatedMessages_text_UT_001)
+{
+    LogTemplatedMessages messages;
+    const QStringList samples {
+        "Started Session 12 of user uos.",
+        "Started Session 13 of user uos.",
+        "  leading  spaces <*> kept ",
+        "",
+        "Started Session 14 of user root."
+    };
+    for (const QString &sample : samples)
+        messages.append(sample);
+
+    //按模板和参数可以还原出原文,包括连续空格
+    ASSERT_EQ(messages.size(), samples.size());
+    for (int i = 0; i < samples.size(); ++i)
+        EXPECT_EQ(messages.text(i), samples.at(i));
+    EXPECT_EQ(messages.group(0), messages.group(4));
+    EXPECT_NE(messages.group(0), messages.group(2));
+}
+
+TEST(LogTemplatedMessages_memoryBytes_UT, LogTemplatedMessages_memoryBytes_UT_001)
+{
+    LogTemplatedMessages messages;
+    qint64 raw = 0;
+    for (int i = 0; i < 2000; ++i) {
+        const QString message = QString("audit: type=1400 apparmor=\"DENIED\" operation=\"open\" profile=\"snap.app\" pid=%1 comm=\"worker\"").arg(i);
+        raw += static_cast<qint64>(sizeof(QString)) + message.size() * static_cast<qint64>(sizeof(QChar));
+        messages.append(message);
+    }
+    //重复的模板只保存一份
+    EXPECT_EQ(messages.miner().groupCount(), 1);
+    EXPECT_LT(messages.memoryBytes() * 3, raw);
+    EXPECT_EQ(messages.text(1999).endsWith("pid=1999 comm=\"worker\""), true);
+}
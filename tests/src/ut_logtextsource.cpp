@@ -0,0 +1,81 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logtextsource.h"
+
+#include <gtest/gtest.h>
+
+#include <QFile>
+#include <QTemporaryDir>
+
+TEST(LogTextSource_buildIndex_UT, LogTextSource_buildIndex_UT_001)
+{
+    LogTextSource source("data");
+    source.setData(QByteArray("first\r\nsec\x01ond\n\nfou\0rth\n", 24));
+    std::atomic_bool canRun(true);
+    EXPECT_EQ(source.buildIndex(canRun), true);
+    //末尾的换行符不产生空行,中间的空行保留
+    ASSERT_EQ(source.lineCount(), 4);
+    EXPECT_EQ(source.line(0), QString("first"));
+    EXPECT_EQ(source.line(1), QString("second"));
+    EXPECT_EQ(source.line(2), QString());
+    EXPECT_EQ(source.line(3), QString("fou rth"));
+
+    source.setData("last line without newline");
+    EXPECT_EQ(source.buildIndex(canRun), true);
+    ASSERT_EQ(source.lineCount(), 1);
+    EXPECT_EQ(source.line(0), QString("last line without newline"));
+
+    canRun = false;
+    EXPECT_EQ(source.buildIndex(canRun), false);
+}
+
+TEST(LogTextSource_open_UT, LogTextSource_open_UT_001)
+{
+    QTemporaryDir dir;
+    ASSERT_EQ(dir.isValid(), true);
+    const QString path = dir.filePath("custom.log");
+    QFile file(path);
+    ASSERT_EQ(file.open(QIODevice::WriteOnly), true);
+    file.write("line 1\nline 2\n");
+    file.close();
+
+    //可读的文件直接映射
+    LogTextSource source(path);
+    ASSERT_EQ(source.open(), true);
+    std::atomic_bool canRun(true);
+    EXPECT_EQ(source.buildIndex(canRun), true);
+    ASSERT_EQ(source.lineCount(), 2);
+    EXPECT_EQ(source.line(1), QString("line 2"));
+    EXPECT_EQ(source.isValid(), true);
+
+    //映射期间文件被截断后不再访问内容
+    ASSERT_EQ(file.open(QIODevice::WriteOnly | QIODevice::Truncate), true);
+    file.close();
+    EXPECT_EQ(source.isValid(), false);
+    EXPECT_EQ(source.line(1), QString());
+}
+
+TEST(LogTextSource_buildIndex_UT, LogTextSource_buildIndex_UT_002)
+{
+    //打开的文件按块读取建立索引,跨块的行完整
+    QTemporaryDir dir;
+    ASSERT_EQ(dir.isValid(), true);
+    const QString path = dir.filePath("large.log");
+    QFile file(path);
+    ASSERT_EQ(file.open(QIODevice::WriteOnly), true);
+    int count = 0;
+    for (qint64 written = 0; written < 2 * LOG_TEXT_INDEX_BLOCK + 100; ++count)
+        written += file.write(QString("line %1\n").arg(count).toUtf8());
+    file.close();
+
+    LogTextSource source(path);
+    ASSERT_EQ(source.open(), true);
+    std::atomic_bool canRun(true);
+    EXPECT_EQ(source.buildIndex(canRun), true);
+    ASSERT_EQ(source.lineCount(), count);
+    for (int i = 0; i < count; i += 997)
+        EXPECT_EQ(source.line(i), QString("line %1").arg(i));
+    EXPECT_EQ(source.line(count - 1), QString("line %1").arg(count - 1));
+}
@@ -0,0 +1,158 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logtimeindex.h"
+#include "loglinefilter.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+
+#include <gtest/gtest.h>
+
+namespace {
+//第i行的时间为2023-07-01 00:00:00之后i秒
+QByteArray indexLine(int i)
+{
+    const QDateTime time = QDateTime(QDate(2023, 7, 1), QTime(0, 0)).addSecs(i);
+    return time.toString("yyyy-MM-dd hh:mm:ss").toUtf8() + " status installed padding padding padding\n";
+}
+
+qint64 indexLineTime(int i)
+{
+    return QDateTime(QDate(2023, 7, 1), QTime(0, 0)).addSecs(i).toMSecsSinceEpoch();
+}
+
+QByteArray readAllFile(const QString &path)
+{
+    QFile file(path);
+    return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+}
+}
+
+class LogTimeIndex_UT : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        //索引写到测试专用的缓存目录
+        QStandardPaths::setTestModeEnabled(true);
+        QDir(LogTimeIndex::indexDir()).removeRecursively();
+        ASSERT_TRUE(m_dir.isValid());
+        m_path = m_dir.filePath("dpkg.log");
+        QFile file(m_path);
+        ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+        for (m_lines = 0; file.size() < 2 * LOG_TIME_INDEX_MIN_SIZE; ++m_lines)
+            file.write(indexLine(m_lines));
+    }
+    void TearDown() override
+    {
+        QDir(LogTimeIndex::indexDir()).removeRecursively();
+        QStandardPaths::setTestModeEnabled(false);
+    }
+
+    QTemporaryDir m_dir;
+    QString m_path;
+    int m_lines = 0;
+};
+
+TEST_F(LogTimeIndex_UT, LogTimeIndex_update_UT_001)
+{
+    QByteArray data = readAllFile(m_path);
+    LogTimeIndex index(m_path, LOG_TIME_INDEX_LINE);
+    ASSERT_TRUE(index.update(data.constData(), data.size(), &LogLineFilter::prefixTime));
+    EXPECT_FALSE(index.isReused());
+    EXPECT_TRUE(index.isSorted());
+    EXPECT_EQ(index.entries().size(), static_cast<int>((data.size() + LOG_TIME_INDEX_SPAN - 1) / LOG_TIME_INDEX_SPAN));
+
+    //范围包括时间段内的所有行,两端都在行首
+    const int from = m_lines / 2;
+    const int to = from + 100;
+    qint64 begin = 0;
+    qint64 end = 0;
+    ASSERT_TRUE(index.range(indexLineTime(from), indexLineTime(to), begin, end));
+    EXPECT_GT(begin, 0);
+    EXPECT_LT(end, data.size());
+    EXPECT_EQ(data.at(static_cast<int>(begin) - 1), '\n');
+    const QByteArray part = data.mid(static_cast<int>(begin), static_cast<int>(end - begin));
+    EXPECT_TRUE(part.contains(indexLine(from)));
+    EXPECT_TRUE(part.contains(indexLine(to)));
+    EXPECT_LT(part.size(), data.size() / 4);
+}
+
+TEST_F(LogTimeIndex_UT, LogTimeIndex_update_UT_002)
+{
+    QByteArray data = readAllFile(m_path);
+    {
+        LogTimeIndex index(m_path, LOG_TIME_INDEX_LINE);
+        ASSERT_TRUE(index.update(data.constData(), data.size(), &LogLineFilter::prefixTime));
+    }
+    //文件没有变化时直接使用保存的索引
+    LogTimeIndex reused(m_path, LOG_TIME_INDEX_LINE);
+    ASSERT_TRUE(reused.update(data.constData(), data.size(), &LogLineFilter::prefixTime));
+    EXPECT_TRUE(reused.isReused());
+    const int count = reused.entries().size();
+
+    //追加内容后从上次的结尾继续建立
+    QFile file(m_path);
+    ASSERT_TRUE(file.open(QIODevice::Append));
+    for (int i = 0; i < 5000; ++i)
+        file.write(indexLine(m_lines + i));
+    file.close();
+    data = readAllFile(m_path);
+    LogTimeIndex extended(m_path, LOG_TIME_INDEX_LINE);
+    ASSERT_TRUE(extended.update(data.constData(), data.size(), &LogLineFilter::prefixTime));
+    EXPECT_TRUE(extended.isReused());
+    EXPECT_GT(extended.entries().size(), count);
+    EXPECT_EQ(extended.entries().last().time >= indexLineTime(m_lines), true);
+}
+
+TEST_F(LogTimeIndex_UT, LogTimeIndex_update_UT_003)
+{
+    QByteArray data = readAllFile(m_path);
+    {
+        LogTimeIndex index(m_path, LOG_TIME_INDEX_LINE);
+        ASSERT_TRUE(index.update(data.constData(), data.size(), &LogLineFilter::prefixTime));
+    }
+    //开头被改写时重新建立
+    data.replace(0, 4, "2022");
+    LogTimeIndex rebuilt(m_path, LOG_TIME_INDEX_LINE);
+    ASSERT_TRUE(rebuilt.update(data.constData(), data.size(), &LogLineFilter::prefixTime));
+    EXPECT_FALSE(rebuilt.isReused());
+
+    //小文件不建立索引
+    LogTimeIndex small(m_path, LOG_TIME_INDEX_LINE);
+    EXPECT_FALSE(small.update(data.constData(), 100, &LogLineFilter::prefixTime));
+}
+
+TEST_F(LogTimeIndex_UT, LogTimeIndex_update_UT_004)
+{
+    const QByteArray data = readAllFile(m_path);
+    //按块读取的结果和内存中的内容一致
+    LogTimeIndex whole(m_path, LOG_TIME_INDEX_LINE);
+    ASSERT_TRUE(whole.update(data.constData(), data.size(), &LogLineFilter::prefixTime));
+    QDir(LogTimeIndex::indexDir()).removeRecursively();
+    LogTimeIndex paged(m_path, LOG_TIME_INDEX_LINE);
+    ASSERT_TRUE(paged.update([&data](qint64 begin, qint64 end, QByteArray &out) {
+        out = data.mid(static_cast<int>(begin), static_cast<int>(end - begin));
+        return true;
+    }, data.size(), &LogLineFilter::prefixTime));
+    ASSERT_EQ(paged.entries().size(), whole.entries().size());
+    for (int i = 0; i < paged.entries().size(); ++i)
+        EXPECT_EQ(paged.entries().at(i).offset, whole.entries().at(i).offset);
+
+    //读到一半文件被截断时索引不可用,也不保存
+    QDir(LogTimeIndex::indexDir()).removeRecursively();
+    const qint64 truncated = data.size() / 2;
+    LogTimeIndex broken(m_path, LOG_TIME_INDEX_LINE);
+    EXPECT_FALSE(broken.update([&data, truncated](qint64 begin, qint64 end, QByteArray &out) {
+        if (end > truncated)
+            return false;
+        out = data.mid(static_cast<int>(begin), static_cast<int>(end - begin));
+        return true;
+    }, data.size(), &LogLineFilter::prefixTime));
+    EXPECT_FALSE(QFile::exists(broken.indexPath()));
+}
@@ -0,0 +1,114 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logtimeline.h"
+#include "structdef.h"
+
+#include <QDateTime>
+
+#include <gtest/gtest.h>
+
+namespace {
+LOG_MSG_JOURNAL kernRecord(qint64 msecs, const QString &msg)
+{
+    LOG_MSG_JOURNAL record;
+    record.timestamp = msecs * 1000;
+    record.dateTime = QDateTime::fromMSecsSinceEpoch(msecs).toString("yyyy-MM-dd hh:mm:ss");
+    record.level = ERR;
+    record.msg = msg;
+    return record;
+}
+
+LOG_MSG_DPKG dpkgRecord(qint64 msecs, const QString &msg)
+{
+    LOG_MSG_DPKG record;
+    record.dateTime = QDateTime::fromMSecsSinceEpoch(msecs).toString("yyyy-MM-dd hh:mm:ss");
+    record.msg = msg;
+    return record;
+}
+
+template <typename T>
+LogTimeline::Fields<T> fields()
+{
+    return {
+        LogTableModel::Column<T>(),
+        [](const T &record, int role) { return role == Qt::DisplayRole ? QVariant(record.dateTime) : QVariant(); },
+        [](const T &record, int role) { return role == Qt::DisplayRole ? QVariant(record.msg) : QVariant(); }
+    };
+}
+
+qint64 kernTime(const LOG_MSG_JOURNAL &record)
+{
+    return record.timestamp / 1000;
+}
+
+qint64 dpkgTime(const LOG_MSG_DPKG &record)
+{
+    return LogTimeline::dateTimeMSecs(record.dateTime);
+}
+}
+
+TEST(LogTimeline_rebuild_UT, LogTimeline_rebuild_UT_001)
+{
+    const qint64 base = QDateTime(QDate(2023, 5, 1), QTime(10, 0)).toMSecsSinceEpoch();
+    LogRecordStore<LOG_MSG_JOURNAL> kern(QList<LOG_MSG_JOURNAL>() << kernRecord(base + 5000, "oops") << kernRecord(base + 1000, "boot"));
+    //dpkg按文件顺序从旧到新,合并前会先在来源内排好
+    LogRecordStore<LOG_MSG_DPKG> dpkg(QList<LOG_MSG_DPKG>() << dpkgRecord(base, "install") << dpkgRecord(base + 3000, "upgrade") << dpkgRecord(base + 5000, "configure"));
+
+    LogTimeline timeline;
+    const int kernSource = timeline.addSource<LOG_MSG_JOURNAL>("kern", LogRecordView<LOG_MSG_JOURNAL>::all(&kern), kernTime, fields<LOG_MSG_JOURNAL>());
+    const int dpkgSource = timeline.addSource<LOG_MSG_DPKG>("dpkg", LogRecordView<LOG_MSG_DPKG>::all(&dpkg), dpkgTime, fields<LOG_MSG_DPKG>());
+    timeline.rebuild();
+
+    ASSERT_EQ(timeline.size(), 5);
+    //从新到旧,时间相同时先加入的来源在前
+    QStringList messages;
+    for (int i = 0; i < timeline.size(); ++i)
+        messages << timeline.data(timeline.at(i), LogTimeline::MessageColumn, Qt::DisplayRole).toString();
+    EXPECT_EQ(messages, QStringList() << "oops" << "configure" << "upgrade" << "boot" << "install");
+    EXPECT_EQ(timeline.at(0).source, kernSource);
+    EXPECT_EQ(timeline.at(1).source, dpkgSource);
+    EXPECT_EQ(timeline.at(1).row, 2u);
+    EXPECT_EQ(timeline.data(timeline.at(1), LogTimeline::SourceColumn, Qt::DisplayRole).toString(), QString("dpkg"));
+    EXPECT_EQ(timeline.data(timeline.at(2), LogTimeline::DateTimeColumn, LogTableModel::SortKeyRole).toLongLong(), base + 3000);
+    EXPECT_EQ(timeline.data(timeline.at(0), LogTimeline::LevelColumn, Qt::DisplayRole).isValid(), false);
+}
+
+TEST(LogTimeline_filter_UT, LogTimeline_filter_UT_001)
+{
+    const qint64 base = QDateTime(QDate(2023, 5, 1), QTime(10, 0)).toMSecsSinceEpoch();
+    LogRecordStore<LOG_MSG_JOURNAL> kern(QList<LOG_MSG_JOURNAL>() << kernRecord(base + 2000, "usb") << kernRecord(base + 1000, "oops"));
+    LogRecordStore<LOG_MSG_DPKG> dpkg(QList<LOG_MSG_DPKG>() << dpkgRecord(base + 1500, "upgrade"));
+
+    LogTimeline timeline;
+    const int kernSource = timeline.addSource<LOG_MSG_JOURNAL>("kern", LogRecordView<LOG_MSG_JOURNAL>::all(&kern), kernTime, fields<LOG_MSG_JOURNAL>());
+    const int dpkgSource = timeline.addSource<LOG_MSG_DPKG>("dpkg", LogRecordView<LOG_MSG_DPKG>::all(&dpkg), dpkgTime, fields<LOG_MSG_DPKG>());
+
+    //筛选只作用于对应来源
+    timeline.setSourceFilter<LOG_MSG_JOURNAL>(kernSource, [](const LOG_MSG_JOURNAL &record) { return record.msg.contains("oops"); });
+    timeline.rebuild();
+    ASSERT_EQ(timeline.size(), 2);
+    EXPECT_EQ(timeline.at(0).source, dpkgSource);
+    EXPECT_EQ(timeline.at(1).row, 1u);
+
+    //类型不符的筛选被忽略
+    timeline.setSourceFilter<LOG_MSG_DPKG>(kernSource, [](const LOG_MSG_DPKG &) { return false; });
+    timeline.setSourceEnabled(dpkgSource, false);
+    timeline.rebuild();
+    ASSERT_EQ(timeline.size(), 1);
+    EXPECT_EQ(timeline.at(0).source, kernSource);
+
+    timeline.clear();
+    EXPECT_EQ(timeline.size(), 0);
+    EXPECT_EQ(timeline.sourceCount(), 0);
+}
+
+TEST(LogTimeline_dateTimeMSecs_UT, LogTimeline_dateTimeMSecs_UT_001)
+{
+    const qint64 expected = QDateTime(QDate(2023, 5, 1), QTime(10, 20, 30, 456)).toMSecsSinceEpoch();
+    EXPECT_EQ(LogTimeline::dateTimeMSecs("2023-05-01 10:20:30.456"), expected);
+    EXPECT_EQ(LogTimeline::dateTimeMSecs("2023-05-01 10:20:30"), expected - 456);
+    EXPECT_EQ(LogTimeline::dateTimeMSecs("2023-13-01 10:20:30"), -1);
+    EXPECT_EQ(LogTimeline::dateTimeMSecs("May  1 10:20:30"), -1);
+}
@@ -0,0 +1,91 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logtracer.h"
+#include "DebugTimeManager.h"
+
+#include <QDir>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+namespace {
+int countEvents(const QByteArray &json, const QString &name)
+{
+    int count = 0;
+    const QJsonArray events = QJsonDocument::fromJson(json).object().value("traceEvents").toArray();
+    for (const QJsonValue &value : events) {
+        if (value.toObject().value("name").toString() == name)
+            ++count;
+    }
+    return count;
+}
+}
+
+TEST(LogTraceBuffer_append_UT, LogTraceBuffer_append_UT_001)
+{
+    LogTraceBuffer buffer(1, "test");
+    LogTraceEvent event;
+    event.category = "test";
+    event.name[0] = '\0';
+    event.args[0] = '\0';
+    event.begin = 0;
+    event.duration = 1;
+    const int capacity = LOG_TRACE_CHUNK_SIZE * LOG_TRACE_MAX_CHUNKS;
+    for (int i = 0; i < capacity + 3; ++i) {
+        event.begin = i;
+        buffer.append(event);
+    }
+    //跨块的事件都能读取,写满后丢弃
+    EXPECT_EQ(buffer.size(), capacity);
+    EXPECT_EQ(buffer.dropped(), 3);
+    EXPECT_EQ(buffer.at(LOG_TRACE_CHUNK_SIZE + 1).begin, LOG_TRACE_CHUNK_SIZE + 1);
+}
+
+TEST(LogTracer_record_UT, LogTracer_record_UT_001)
+{
+    const bool enabled = LogTracer::isEnabled();
+    LogTracer::setEnabled(false);
+    {
+        PERF_TRACE_SCOPE("test", "ut-disabled-span");
+    }
+    EXPECT_EQ(countEvents(LogTracer::instance()->toJson(), "ut-disabled-span"), 0);
+
+    LogTracer::setEnabled(true);
+    {
+        PERF_TRACE_SCOPE_ARGS("test", "ut-span", QString("count=%1").arg(3));
+    }
+    std::thread worker([]() {
+        PERF_TRACE_SCOPE("test", "ut-span");
+    });
+    worker.join();
+    const QByteArray json = LogTracer::instance()->toJson();
+    //不同线程的耗时分别记录
+    EXPECT_EQ(countEvents(json, "ut-span"), 2);
+    EXPECT_GE(countEvents(json, "thread_name"), 2);
+
+    const QString path = QDir::temp().filePath("deepin-log-viewer-ut-trace.json");
+    EXPECT_EQ(LogTracer::instance()->dump(path), true);
+    QFile file(path);
+    ASSERT_EQ(file.open(QIODevice::ReadOnly), true);
+    EXPECT_EQ(countEvents(file.readAll(), "ut-span"), 2);
+    file.remove();
+    LogTracer::setEnabled(enabled);
+}
+
+TEST(LogTracer_record_UT, LogTracer_record_UT_002)
+{
+    const bool enabled = LogTracer::isEnabled();
+    LogTracer::setEnabled(true);
+    //打点的开始和结束合并为一段耗时
+    PERF_PRINT_BEGIN("POINT-UT", "begin");
+    PERF_PRINT_END("POINT-UT", "end");
+    EXPECT_EQ(countEvents(LogTracer::instance()->toJson(), "POINT-UT"), 1);
+    LogTracer::setEnabled(enabled);
+}
@@ -0,0 +1,29 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logtrigrambloom.h"
+
+#include <gtest/gtest.h>
+
+TEST(LogTrigramBloom_trigrams_UT, LogTrigramBloom_trigrams_UT_001)
+{
+    //不足3字节时为空,重复的三元组只保留一个
+    EXPECT_TRUE(LogTrigramBloom::trigrams("ab").isEmpty());
+    EXPECT_EQ(LogTrigramBloom::trigrams("abcabc").size(), 3);
+}
+
+TEST(LogTrigramBloom_mayContain_UT, LogTrigramBloom_mayContain_UT_001)
+{
+    LogTrigramBloom bloom;
+    bloom.add("usb 1-1: new high-speed USB device number 5");
+    const uchar *bits = reinterpret_cast<const uchar *>(bloom.bits().constData());
+    //不区分大小写
+    EXPECT_TRUE(LogTrigramBloom::mayContain(bits, LogTrigramBloom::trigrams("usb DEVICE")));
+    EXPECT_FALSE(LogTrigramBloom::mayContain(bits, LogTrigramBloom::trigrams("3f2b9c1e-uuid")));
+    //空关键字总是可能匹配
+    EXPECT_TRUE(LogTrigramBloom::mayContain(bits, LogTrigramBloom::trigrams("")));
+
+    bloom.clear();
+    EXPECT_FALSE(LogTrigramBloom::mayContain(bits, LogTrigramBloom::trigrams("usb")));
+}
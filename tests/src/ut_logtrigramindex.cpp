@@ -0,0 +1,94 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logtrigramindex.h"
+
+#include <gtest/gtest.h>
+
+namespace {
+QStringList indexRows()
+{
+    return QStringList() << "usb 1-1: new high-speed USB device"
+                         << "EXT4-fs (sda1): mounted filesystem"
+                         << "usb 1-2: device descriptor read error"
+                         << "Out of memory: Killed process 1234";
+}
+}
+
+TEST(LogTrigramIndex_candidates_UT, LogTrigramIndex_candidates_UT_001)
+{
+    const QStringList rows = indexRows();
+    LogTrigramIndex index;
+    std::atomic_bool canRun(true);
+    ASSERT_TRUE(index.build(rows.size(), [&rows](int row, QStringList &fields) {
+        fields << rows.at(row);
+        return true;
+    }, canRun));
+    EXPECT_EQ(index.rowCount(), rows.size());
+    EXPECT_GT(index.memoryBytes(), 0);
+
+    QVector<int> candidates;
+    //不区分大小写,候选只包含有全部三元组的记录
+    EXPECT_TRUE(index.candidates("DEVICE", candidates));
+    EXPECT_EQ(candidates, QVector<int>() << 0 << 2);
+    EXPECT_TRUE(index.candidates("uuid-not-there", candidates));
+    EXPECT_TRUE(candidates.isEmpty());
+    //不足3字节时不能缩小范围
+    EXPECT_FALSE(index.candidates("us", candidates));
+}
+
+TEST(LogTrigramIndex_candidates_UT, LogTrigramIndex_candidates_UT_002)
+{
+    const QStringList rows = indexRows();
+    LogTrigramIndex index;
+    std::atomic_bool canRun(true);
+    //第3条记录还有不在内存中的文本,总是作为候选
+    ASSERT_TRUE(index.build(rows.size(), [&rows](int row, QStringList &fields) {
+        fields << rows.at(row);
+        return row != 3;
+    }, canRun));
+    QVector<int> candidates;
+    EXPECT_TRUE(index.candidates("mounted", candidates));
+    EXPECT_EQ(candidates, QVector<int>() << 1 << 3);
+}
+
+TEST(LogTrigramIndex_candidates_UT, LogTrigramIndex_candidates_UT_003)
+{
+    const QStringList rows = indexRows();
+    LogTrigramIndex index;
+    std::atomic_bool canRun(true);
+    ASSERT_TRUE(index.build(rows.size(), [&rows](int row, QStringList &fields) {
+        fields << rows.at(row);
+        return true;
+    }, canRun));
+
+    //正则的各个字面量求交集,不足3字节的字面量被跳过
+    QVector<int> candidates;
+    EXPECT_TRUE(index.candidates(QStringList() << "usb " << "device" << "1-", candidates));
+    EXPECT_EQ(candidates, QVector<int>() << 0 << 2);
+    EXPECT_TRUE(index.candidates(QStringList() << "usb" << "error", candidates));
+    EXPECT_EQ(candidates, QVector<int>() << 2);
+    EXPECT_FALSE(index.candidates(QStringList() << "us", candidates));
+}
+
+TEST(LogTrigramIndex_build_UT, LogTrigramIndex_build_UT_001)
+{
+    const QStringList rows = indexRows();
+    std::atomic_bool canRun(true);
+    //超过内存上限时放弃
+    LogTrigramIndex small(64);
+    EXPECT_FALSE(small.build(rows.size(), [&rows](int row, QStringList &fields) {
+        fields << rows.at(row);
+        return true;
+    }, canRun));
+    EXPECT_TRUE(small.isOverBudget());
+    EXPECT_EQ(small.rowCount(), 0);
+
+    canRun = false;
+    LogTrigramIndex canceled;
+    EXPECT_FALSE(canceled.build(rows.size(), [&rows](int row, QStringList &fields) {
+        fields << rows.at(row);
+        return true;
+    }, canRun));
+}
@@ -0,0 +1,78 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logtruncator.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryDir>
+
+#include <gtest/gtest.h>
+
+namespace {
+void writeFile(const QString &path, const QByteArray &data)
+{
+    QFile file(path);
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    file.write(data);
+}
+}
+
+TEST(LogTruncator_truncate_UT, LogTruncator_truncate_UT_001)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    writeFile(dir.filePath("kern.log"), "0123456789");
+    writeFile(dir.filePath("kern.log.1"), "01234");
+    writeFile(dir.filePath("other.log"), "keep");
+
+    //通配符展开为整组轮转日志,重复的目标只处理一次
+    const QList<LogTruncateResult> results = LogTruncator::truncate(QStringList() << dir.filePath("kern.log*") << dir.filePath("kern.log"));
+    ASSERT_EQ(results.size(), 2);
+    qint64 freed = 0;
+    for (const LogTruncateResult &result : results) {
+        EXPECT_TRUE(result.ok);
+        freed += result.freed;
+    }
+    EXPECT_EQ(freed, 15);
+    EXPECT_EQ(QFileInfo(dir.filePath("kern.log")).size(), 0);
+    EXPECT_EQ(QFileInfo(dir.filePath("kern.log.1")).size(), 0);
+    EXPECT_EQ(QFileInfo(dir.filePath("other.log")).size(), 4);
+
+    //没有匹配的通配符不产生结果
+    EXPECT_TRUE(LogTruncator::truncate(QStringList() << dir.filePath("missing*")).isEmpty());
+}
+
+TEST(LogTruncator_truncateFile_UT, LogTruncator_truncateFile_UT_001)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    writeFile(dir.filePath("target.log"), "secret");
+    ASSERT_TRUE(QFile::link(dir.filePath("target.log"), dir.filePath("link.log")));
+
+    //不跟随符号链接
+    EXPECT_FALSE(LogTruncator::truncateFile(dir.filePath("link.log")).ok);
+    EXPECT_EQ(QFileInfo(dir.filePath("target.log")).size(), 6);
+    //目录不是普通文件
+    EXPECT_FALSE(LogTruncator::truncateFile(dir.path()).ok);
+}
+
+TEST(LogTruncator_fromText_UT, LogTruncator_fromText_UT_001)
+{
+    LogTruncateResult ok;
+    ok.path = "/var/log/kern.log";
+    ok.freed = 42;
+    ok.ok = true;
+    LogTruncateResult failed;
+    failed.path = "/var/log/kern.log.1";
+    failed.error = "Permission denied";
+
+    const QList<LogTruncateResult> results = LogTruncator::fromText(LogTruncator::toText(QList<LogTruncateResult>() << ok << failed) + "garbage\n");
+    ASSERT_EQ(results.size(), 2);
+    EXPECT_TRUE(results.at(0).ok);
+    EXPECT_EQ(results.at(0).freed, 42);
+    EXPECT_EQ(results.at(0).path, ok.path);
+    EXPECT_FALSE(results.at(1).ok);
+    EXPECT_EQ(results.at(1).error, failed.error);
+}
@@ -0,0 +1,64 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <stub.h>
+#include "logusernames.h"
+#include "logauditparser.h"
+
+#include <gtest/gtest.h>
+
+#include <pwd.h>
+#include <string.h>
+
+namespace {
+
+int s_lookups = 0;
+
+int stub_getpwuid_r(uid_t uid, struct passwd *pwd, char *buf, size_t buflen, struct passwd **result)
+{
+    ++s_lookups;
+    *result = nullptr;
+    if (uid != 1000 || buflen < 5)
+        return 0;
+    memset(pwd, 0, sizeof(*pwd));
+    strcpy(buf, "test");
+    pwd->pw_name = buf;
+    *result = pwd;
+    return 0;
+}
+
+} // namespace
+
+TEST(LogUserNames_userName_UT, LogUserNames_userName_UT_001)
+{
+    Stub stub;
+    stub.set(getpwuid_r, stub_getpwuid_r);
+    LogUserNames::clear();
+    s_lookups = 0;
+
+    EXPECT_EQ(LogUserNames::userName(1000), QString("test"));
+    EXPECT_EQ(LogUserNames::userName(1000), QString("test"));
+    EXPECT_EQ(s_lookups, 1);
+    //查询不到的uid同样缓存
+    EXPECT_EQ(LogUserNames::userName(1234).isEmpty(), true);
+    EXPECT_EQ(LogUserNames::userName(1234).isEmpty(), true);
+    EXPECT_EQ(s_lookups, 2);
+
+    LogUserNames::clear();
+    EXPECT_EQ(LogUserNames::userName(1000), QString("test"));
+    EXPECT_EQ(s_lookups, 3);
+    LogUserNames::clear();
+}
+
+TEST(LogAuditParser_userText_UT, LogAuditParser_userText_UT_001)
+{
+    Stub stub;
+    stub.set(getpwuid_r, stub_getpwuid_r);
+    LogUserNames::clear();
+
+    EXPECT_EQ(LogAuditParser::userText("pid=12 uid=1000 auid=4294967295 ses=1 msg='op=login acct=\"x\"'"),
+              QString("auid=unset uid=1000(test)"));
+    EXPECT_EQ(LogAuditParser::userText("pid=12 ouid=1000 res=success"), QString());
+    LogUserNames::clear();
+}
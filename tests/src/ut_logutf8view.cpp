@@ -0,0 +1,28 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logutf8view.h"
+
+#include <gtest/gtest.h>
+
+TEST(LogUtf8View_isAscii_UT, LogUtf8View_isAscii_UT_001)
+{
+    EXPECT_EQ(LogUtf8View(QByteArray("usb 1-1: new device")).isAscii(), true);
+    EXPECT_EQ(LogUtf8View(QString("设备").toUtf8()).isAscii(), false);
+    EXPECT_EQ(LogUtf8View().isAscii(), true);
+    EXPECT_EQ(LogUtf8View(QString("设备 ok").toUtf8()).toString(), QString("设备 ok"));
+}
+
+TEST(LogUtf8Matcher_matches_UT, LogUtf8Matcher_matches_UT_001)
+{
+    LogUtf8Matcher matcher("Failed");
+    EXPECT_EQ(matcher.matches(QByteArray("sshd: FAILED password")), true);
+    EXPECT_EQ(matcher.matches(QByteArray("sshd: faile")), false);
+    EXPECT_EQ(matcher.matches(QByteArray("")), false);
+    //非ASCII的文本和关键字按QString比较
+    EXPECT_EQ(matcher.matches(QString("登录 failed").toUtf8()), true);
+    EXPECT_EQ(LogUtf8Matcher("登录").matches(QString("用户登录失败").toUtf8()), true);
+    EXPECT_EQ(LogUtf8Matcher("登录").matches(QByteArray("login")), false);
+    EXPECT_EQ(LogUtf8Matcher().matches(QByteArray("any")), true);
+}
@@ -83,3 +83,17 @@ DWIDGET_USE_NAMESPACE
 //    p->initStyleOption(new QStyleOptionViewItem(), QModelIndex());
 //    p->deleteLater();
 //}
+
+TEST(LogViewItemDelegate_elidedText_UT, LogViewItemDelegate_elidedText_UT_001)
+{
+    LogViewItemDelegate delegate(nullptr);
+    QFont font;
+    QString text("a long log message that does not fit into a narrow column");
+    QString elided = delegate.elidedText(text, font, 60, Qt::ElideRight);
+    EXPECT_EQ(elided, QFontMetrics(font).elidedText(text, Qt::ElideRight, 60));
+    //再次获取时和缓存的结果一致
+    EXPECT_EQ(delegate.elidedText(text, font, 60, Qt::ElideRight), elided);
+    //宽度足够时不省略
+    EXPECT_EQ(delegate.elidedText(text, font, 10000, Qt::ElideRight), text);
+    delegate.invalidateStyle();
+}
@@ -0,0 +1,96 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logvolumehistogram.h"
+#include "loglinestream.h"
+
+#include <QBuffer>
+#include <QDateTime>
+#include <QFile>
+#include <QTemporaryDir>
+
+#include <gtest/gtest.h>
+
+#include <string.h>
+
+namespace {
+qint64 volumeTime(int hour, int minute)
+{
+    return QDateTime(QDate(2023, 7, 1), QTime(hour, minute)).toMSecsSinceEpoch();
+}
+}
+
+TEST(LogVolumeHistogram_count_UT, LogVolumeHistogram_count_UT_001)
+{
+    LogVolumeHistogram histogram;
+    histogram.add(volumeTime(1, 10), 3);
+    histogram.add(volumeTime(1, 50), 6);
+    histogram.add(volumeTime(5, 0), 3);
+    //没有时间的条目不计入
+    histogram.add(-1);
+
+    EXPECT_EQ(histogram.count(-1, -1), 3);
+    EXPECT_EQ(histogram.count(-1, -1, 3), 2);
+    //按小时统计,开始时间所在的整个小时都计入
+    EXPECT_EQ(histogram.count(volumeTime(1, 30), volumeTime(2, 0)), 2);
+    EXPECT_EQ(histogram.count(volumeTime(2, 0), -1), 1);
+
+    histogram.dropBefore(volumeTime(2, 0));
+    EXPECT_EQ(histogram.count(-1, -1), 1);
+}
+
+TEST(LogVolumeHistogram_stream_UT, LogVolumeHistogram_stream_UT_001)
+{
+    LogVolumeHistogram histogram;
+    histogram.add(volumeTime(1, 10), 3);
+    LogVolumeHistogram other;
+    other.add(volumeTime(1, 20), 3);
+    histogram.merge(other);
+
+    QBuffer buffer;
+    ASSERT_TRUE(buffer.open(QIODevice::ReadWrite));
+    QDataStream out(&buffer);
+    out << histogram;
+    buffer.seek(0);
+    QDataStream in(&buffer);
+    LogVolumeHistogram loaded;
+    in >> loaded;
+    EXPECT_EQ(loaded.count(-1, -1, 3), 2);
+}
+
+TEST(LogVolumeCounter_countLines_UT, LogVolumeCounter_countLines_UT_001)
+{
+    const QByteArray data("2023-07-01 01:00:00 status installed a\n"
+                          "no time line\n"
+                          "2023-07-01 02:00:00 status installed b\n"
+                          "2023-07-01 03:00:00 partial");
+    LogVolumeHistogram histogram;
+    //没有写完的最后一行留到下次统计
+    const qint64 end = LogVolumeCounter::countLines(data.constData(), 0, data.size(), histogram);
+    EXPECT_EQ(end, data.indexOf("2023-07-01 03"));
+    EXPECT_EQ(histogram.count(-1, -1), 2);
+}
+
+TEST(LogVolumeCounter_countLines_UT, LogVolumeCounter_countLines_UT_002)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    const QString path = dir.filePath("dpkg.log");
+    QFile file(path);
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    //超过一个读取块的行和跨块的行都完整统计
+    file.write("2023-07-01 01:00:00 status installed " + QByteArray(3 * 1024 * 1024, 'a') + "\n");
+    int lines = 1;
+    for (; file.size() < 3 * 1024 * 1024 + 2 * 1024 * 1024; ++lines)
+        file.write("2023-07-01 02:00:00 status installed b\n");
+    file.write("2023-07-01 03:00:00 partial");
+    file.close();
+
+    LogLineStream stream(path);
+    ASSERT_TRUE(stream.openDirect());
+    LogVolumeHistogram histogram;
+    const qint64 end = LogVolumeCounter::countLines(stream, 0, stream.mappedSize(), histogram);
+    EXPECT_EQ(end, stream.mappedSize() - static_cast<qint64>(strlen("2023-07-01 03:00:00 partial")));
+    EXPECT_EQ(histogram.count(-1, -1), lines);
+}
@@ -0,0 +1,75 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logworkscheduler.h"
+
+#include <QRunnable>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+
+namespace {
+class PriorityProbe : public QRunnable
+{
+public:
+    PriorityProbe(std::atomic<int> &priority, std::atomic<int> &deleted)
+        : m_priority(priority)
+        , m_deleted(deleted)
+    {
+    }
+    ~PriorityProbe() override { ++m_deleted; }
+    void run() override { m_priority = QThread::currentThread()->priority(); }
+
+private:
+    std::atomic<int> &m_priority;
+    std::atomic<int> &m_deleted;
+};
+}
+
+TEST(LogWorkScheduler_start_UT, LogWorkScheduler_start_UT_001)
+{
+    LogWorkScheduler *scheduler = LogWorkScheduler::instance();
+    std::atomic<int> priority(-1);
+    std::atomic<int> deleted(0);
+    //导出以低优先级运行,运行结束后任务随包装释放
+    scheduler->start(new PriorityProbe(priority, deleted), LogWorkScheduler::Export);
+    ASSERT_TRUE(scheduler->waitForDone(LogWorkScheduler::Export, 5000));
+    EXPECT_EQ(priority.load(), static_cast<int>(QThread::LowPriority));
+    EXPECT_EQ(deleted.load(), 1);
+
+    scheduler->start(new PriorityProbe(priority, deleted), LogWorkScheduler::Interactive);
+    ASSERT_TRUE(scheduler->waitForDone(LogWorkScheduler::Interactive, 5000));
+    EXPECT_EQ(priority.load(), static_cast<int>(QThread::NormalPriority));
+    EXPECT_EQ(deleted.load(), 2);
+}
+
+TEST(LogWorkScheduler_maxThreads_UT, LogWorkScheduler_maxThreads_UT_001)
+{
+    LogWorkScheduler *scheduler = LogWorkScheduler::instance();
+    //各类别的并发上限相互独立,后台类别不会占用界面加载的线程
+    EXPECT_GE(scheduler->maxThreads(LogWorkScheduler::Interactive), 2);
+    EXPECT_EQ(scheduler->maxThreads(LogWorkScheduler::Prefetch), LOG_WORK_PREFETCH_THREADS);
+    scheduler->setMaxThreads(LogWorkScheduler::Export, 0);
+    EXPECT_EQ(scheduler->maxThreads(LogWorkScheduler::Export), 1);
+    scheduler->setMaxThreads(LogWorkScheduler::Export, LOG_WORK_EXPORT_THREADS);
+    EXPECT_EQ(LogWorkScheduler::threadPriority(LogWorkScheduler::Prefetch), QThread::IdlePriority);
+    EXPECT_EQ(LogWorkScheduler::className(LogWorkScheduler::Follow), QString("follow"));
+}
+
+TEST(LogWorkScheduler_run_UT, LogWorkScheduler_run_UT_001)
+{
+    LogWorkScheduler *scheduler = LogWorkScheduler::instance();
+    QFuture<int> low = scheduler->run(LogWorkScheduler::Export, []() {
+        return static_cast<int>(QThread::currentThread()->priority());
+    });
+    EXPECT_EQ(low.result(), static_cast<int>(QThread::LowPriority));
+
+    //结果按提交顺序取出,与任务完成的先后无关
+    QVector<QFuture<int>> futures;
+    for (int i = 0; i < 8; ++i)
+        futures.append(scheduler->run(LogWorkScheduler::Interactive, [i]() { return i * i; }));
+    for (int i = 0; i < futures.size(); ++i)
+        EXPECT_EQ(futures[i].result(), i * i);
+}
@@ -0,0 +1,66 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logxlsxwriter.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+
+#include <gtest/gtest.h>
+
+TEST(LogXlsxWriter_appendUtf8_UT, LogXlsxWriter_appendUtf8_UT_001)
+{
+    const QString text = QString("level 等级 ") + QString::fromUcs4(U"\U0001F600");
+    QByteArray out("x");
+    LogXlsxWriter::appendUtf8(out, text);
+    EXPECT_EQ(out, QByteArray("x") + text.toUtf8());
+
+    //落单的代理项写为替换字符
+    QByteArray lone;
+    LogXlsxWriter::appendUtf8(lone, QString(QChar(0xD800)));
+    EXPECT_EQ(lone, QString(QChar(QChar::ReplacementCharacter)).toUtf8());
+}
+
+TEST(LogXlsxWriter_endRow_UT, LogXlsxWriter_endRow_UT_001)
+{
+    const QString fileName = QDir::tempPath() + "/ut_logxlsxwriter.xlsx";
+    QFile::remove(fileName);
+    {
+        //每个工作表3行,含表头
+        LogXlsxWriter xlsx(fileName, QStringList() << "Time" << "Info", 3);
+        ASSERT_EQ(xlsx.isOpen(), true);
+        EXPECT_EQ(xlsx.sheetCount(), 1);
+        for (int i = 0; i < 5; ++i) {
+            xlsx << QString::number(i) << QString("msg%1").arg(i);
+            xlsx.endRow();
+        }
+        EXPECT_EQ(xlsx.sheetCount(), 3);
+        EXPECT_EQ(xlsx.close(), true);
+        EXPECT_EQ(xlsx.isOpen(), false);
+    }
+    EXPECT_GT(QFileInfo(fileName).size(), 0);
+    QFile::remove(fileName);
+}
+
+TEST(LogXlsxWriter_writeRows_UT, LogXlsxWriter_writeRows_UT_001)
+{
+    const QString fileName = QDir::tempPath() + "/ut_logxlsxwriter_rows.xlsx";
+    QFile::remove(fileName);
+    {
+        LogXlsxWriter xlsx(fileName, QStringList() << "Time" << "Info", 3);
+        LogXlsxWriter::Rows rows;
+        for (int i = 0; i < 5; ++i) {
+            rows << QString::number(i) << QString("msg%1").arg(i);
+            rows.endRow();
+        }
+        EXPECT_EQ(rows.rowEnds, QVector<int>() << 2 << 4 << 6 << 8 << 10);
+        //预先编码的行同样按工作表的行数上限换表
+        xlsx.writeRows(rows);
+        EXPECT_EQ(xlsx.sheetCount(), 3);
+        EXPECT_EQ(xlsx.close(), true);
+    }
+    EXPECT_GT(QFileInfo(fileName).size(), 0);
+    QFile::remove(fileName);
+}
@@ -0,0 +1,99 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logzipwriter.h"
+
+#include "minizip/unzip.h"
+
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+
+#include <gtest/gtest.h>
+
+namespace {
+void writeFile(const QString &path, const QByteArray &data)
+{
+    QFile file(path);
+    file.open(QIODevice::WriteOnly);
+    file.write(data);
+}
+
+QByteArray readEntry(const QString &fileName, const char *entry)
+{
+    QByteArray data;
+    unzFile file = unzOpen64(fileName.toLocal8Bit().constData());
+    if (!file)
+        return data;
+    if (unzLocateFile(file, entry, 1) == UNZ_OK && unzOpenCurrentFile(file) == UNZ_OK) {
+        char block[4096];
+        int read = 0;
+        while ((read = unzReadCurrentFile(file, block, sizeof(block))) > 0)
+            data.append(block, read);
+        //读完整个文件时才校验crc
+        if (unzCloseCurrentFile(file) != UNZ_OK)
+            data = "crc error";
+    }
+    unzClose(file);
+    return data;
+}
+}
+
+TEST(LogZipWriter_write_UT, LogZipWriter_write_UT_001)
+{
+    QTemporaryDir source;
+    ASSERT_TRUE(source.isValid());
+    QDir(source.path()).mkpath("kernel/sub");
+    QByteArray large;
+    for (int i = 0; i < 20000; ++i)
+        large += QByteArray::number(i) + " kernel: usb device connected\n";
+    writeFile(source.filePath("kernel/kern.log"), large);
+    writeFile(source.filePath("kernel/sub/.hidden"), "hidden");
+    writeFile(source.filePath("empty.log"), QByteArray());
+    writeFile(source.filePath("dpkg.log"), "install");
+
+    const QString fileName = source.filePath("out.zip");
+    qint64 lastDone = -1;
+    qint64 lastTotal = 0;
+    {
+        LogZipWriter zip(fileName);
+        ASSERT_EQ(zip.isOpen(), true);
+        zip.addFile(source.filePath("dpkg.log"), "dpkg/dpkg.log");
+        zip.addFile(source.filePath("empty.log"), "empty.log");
+        zip.addDirectory(source.filePath("kernel"), "kernel");
+        EXPECT_EQ(zip.entryCount(), 4);
+        EXPECT_EQ(zip.totalBytes(), large.size() + 6 + 7);
+        EXPECT_EQ(zip.write([&](qint64 done, qint64 total) {
+            EXPECT_GE(done, lastDone);
+            lastDone = done;
+            lastTotal = total;
+            return true;
+        }), true);
+        EXPECT_EQ(zip.close(), true);
+    }
+    EXPECT_EQ(lastDone, lastTotal);
+    EXPECT_EQ(readEntry(fileName, "kernel/kern.log"), large);
+    EXPECT_EQ(readEntry(fileName, "kernel/sub/.hidden"), QByteArray("hidden"));
+    EXPECT_EQ(readEntry(fileName, "dpkg/dpkg.log"), QByteArray("install"));
+    EXPECT_EQ(readEntry(fileName, "empty.log"), QByteArray());
+}
+
+TEST(LogZipWriter_write_UT, LogZipWriter_write_UT_002)
+{
+    QTemporaryDir source;
+    ASSERT_TRUE(source.isValid());
+    writeFile(source.filePath("a.log"), "a");
+    writeFile(source.filePath("b.log"), "b");
+
+    LogZipWriter zip(source.filePath("out.zip"));
+    //打不开的文件跳过
+    zip.addFile(source.filePath("missing.log"), "missing.log");
+    zip.addFile(source.filePath("a.log"), "a.log");
+    zip.addFile(source.filePath("b.log"), "b.log");
+    //进度回调返回false时停止
+    int calls = 0;
+    EXPECT_EQ(zip.write([&calls](qint64, qint64) { return ++calls < 2; }), false);
+    EXPECT_EQ(calls, 2);
+    EXPECT_EQ(zip.entryCount(), 0);
+}
@@ -0,0 +1,88 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "wtmpsessionreader.h"
+
+#include <gtest/gtest.h>
+
+#include <QTemporaryFile>
+
+#include <string.h>
+
+static struct utmp makeRecord(short type, const char *name, const char *line, qint64 time)
+{
+    struct utmp record;
+    memset(&record, 0, sizeof(record));
+    record.ut_type = type;
+    strncpy(record.ut_name, name, sizeof(record.ut_name));
+    strncpy(record.ut_line, line, sizeof(record.ut_line));
+    record.ut_tv.tv_sec = static_cast<int32_t>(time);
+    return record;
+}
+
+TEST(WtmpSessionReader_build_UT, WtmpSessionReader_build_UT_001)
+{
+    const qint64 base = 1688000000;
+    struct utmp records[] = {
+        makeRecord(BOOT_TIME, "reboot", "~", base),
+        makeRecord(USER_PROCESS, "uos", "tty1", base + 60),
+        makeRecord(DEAD_PROCESS, "", "tty1", base + 60 + 2 * 3600),
+        makeRecord(USER_PROCESS, "uos", "pts/0", base + 3 * 3600),
+        makeRecord(RUN_LVL, "shutdown", "~", base + 4 * 3600),
+        makeRecord(BOOT_TIME, "reboot", "~", base + 5 * 3600),
+        makeRecord(USER_PROCESS, "root", "tty2", base + 6 * 3600),
+    };
+    std::atomic_bool canRun(true);
+    QList<WtmpSession> sessions = WtmpSessionReader::build(records, sizeof(records) / sizeof(records[0]), canRun);
+
+    //从新到旧
+    ASSERT_EQ(sessions.size(), 6);
+    EXPECT_EQ(sessions.at(0).eventType, QString("Login"));
+    EXPECT_EQ(sessions.at(0).userName, QString("root"));
+    EXPECT_EQ(sessions.at(0).msg.endsWith("still logged in"), true);
+    EXPECT_EQ(sessions.at(1).eventType, QString("Boot"));
+    EXPECT_EQ(sessions.at(1).msg.endsWith("still running"), true);
+    EXPECT_EQ(sessions.at(2).eventType, QString("shutdown"));
+    EXPECT_EQ(sessions.at(2).userName, QString("uos"));
+    //关机时仍在登录的会话
+    EXPECT_EQ(sessions.at(3).msg.endsWith("- down (01:00)"), true);
+    //注销配对的会话
+    EXPECT_EQ(sessions.at(4).msg.endsWith("(02:00)"), true);
+    EXPECT_EQ(sessions.at(4).msg.contains("down"), false);
+    EXPECT_EQ(sessions.at(5).eventType, QString("Boot"));
+    EXPECT_EQ(sessions.at(5).userName, QString("root"));
+    EXPECT_EQ(sessions.at(5).msg.endsWith("(04:00)"), true);
+}
+
+TEST(WtmpSessionReader_build_UT, WtmpSessionReader_build_UT_002)
+{
+    //两次开机之间没有关机记录
+    const qint64 base = 1688000000;
+    struct utmp records[] = {
+        makeRecord(BOOT_TIME, "reboot", "~", base),
+        makeRecord(USER_PROCESS, "uos", "tty1", base + 60),
+        makeRecord(BOOT_TIME, "reboot", "~", base + 86400 + 3600 + 60),
+    };
+    std::atomic_bool canRun(true);
+    QList<WtmpSession> sessions = WtmpSessionReader::build(records, 3, canRun);
+    ASSERT_EQ(sessions.size(), 3);
+    EXPECT_EQ(sessions.at(1).msg.endsWith("- crash (1+01:00)"), true);
+    EXPECT_EQ(sessions.at(2).msg.contains("- crash"), true);
+}
+
+TEST(WtmpSessionReader_open_UT, WtmpSessionReader_open_UT_001)
+{
+    WtmpSessionReader reader;
+    std::atomic_bool canRun(true);
+    EXPECT_EQ(reader.open("/not/exist/wtmp"), false);
+    EXPECT_EQ(reader.sessions(canRun).isEmpty(), true);
+
+    QTemporaryFile file;
+    ASSERT_EQ(file.open(), true);
+    struct utmp record = makeRecord(USER_PROCESS, "uos", "tty1", 1688000000);
+    file.write(reinterpret_cast<const char *>(&record), sizeof(record));
+    file.flush();
+    EXPECT_EQ(reader.open(file.fileName()), true);
+    EXPECT_EQ(reader.sessions(canRun).size(), 1);
+}
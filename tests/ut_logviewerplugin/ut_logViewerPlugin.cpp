@@ -70,6 +70,57 @@ TEST_F(LogViewerPlugin_UT, exportLogFile_UT001)
     connect(p, &LogViewerPlugin::sigExportResult, p, &LogViewerPlugin::deleteLater);
 }
 
+TEST_F(LogViewerPlugin_UT, streamAppLog_UT001)
+{
+    Stub stub;
+    stub.set((void (QThreadPool::*)(QRunnable *, int))ADDR(QThreadPool, start), QThreadPool_start);
+    stub.set(ADDR(QThread, start), QThread_start);
+
+    LogViewerPluginInterfaceV2 *v2 = qobject_cast<LogViewerPluginInterfaceV2 *>(m_instance);
+    ASSERT_NE(v2, nullptr);
+    auto sink = [](const QList<LOG_MSG_APPLICATOIN> &) { return true; };
+    bool finishedCalled = false;
+    auto finished = [&finishedCalled](bool) { finishedCalled = true; };
+
+    //路径为空或时间筛选无效时不启动读取
+    LogViewerAppQuery query;
+    EXPECT_FALSE(v2->streamAppLog(query, LogViewerCancelTokenPtr(), sink, finished));
+    query.path = Utils::homePath + "/.cache/deepin/deepin-log-viewer/deepin-log-viewer.log";
+    query.period = INVALID;
+    EXPECT_FALSE(v2->streamAppLog(query, LogViewerCancelTokenPtr(), sink, finished));
+    EXPECT_FALSE(finishedCalled);
+
+    query.period = ONE_WEEK;
+    LogViewerCancelTokenPtr token(new LogViewerCancelToken);
+    EXPECT_TRUE(v2->streamAppLog(query, token, sink, finished));
+    token->cancel();
+    EXPECT_TRUE(token->isCanceled());
+}
+
+TEST_F(LogViewerPlugin_UT, exportAppLog_UT001)
+{
+    Stub stub;
+    stub.set((void (QThreadPool::*)(QRunnable *, int))ADDR(QThreadPool, start), QThreadPool_start);
+    stub.set(ADDR(QThread, start), QThread_start);
+
+    LogViewerPluginInterfaceV2 *v2 = qobject_cast<LogViewerPluginInterfaceV2 *>(m_instance);
+    ASSERT_NE(v2, nullptr);
+    LogViewerAppQuery query;
+    query.path = Utils::homePath + "/.cache/deepin/deepin-log-viewer/deepin-log-viewer.log";
+
+    //不支持的格式直接结束,结果为false
+    QFuture<bool> future = v2->exportAppLog(query, "/tmp/test-plugin.pdf");
+    EXPECT_TRUE(future.isFinished());
+    EXPECT_FALSE(future.result());
+
+    //异步导出立即返回,可以取消
+    future = v2->exportAppLog(query, "/tmp/test-plugin.txt");
+    EXPECT_FALSE(future.isFinished());
+    EXPECT_EQ(future.progressMaximum(), 100);
+    future.cancel();
+    EXPECT_TRUE(future.isCanceled());
+}
+
 class LogViewerPlugin_generateAppFile_UT_Param
 {
 public: